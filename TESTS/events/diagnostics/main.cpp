@@ -0,0 +1,107 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#if !MBED_CONF_EVENTS_DIAGNOSTICS_ENABLED || !MBED_CONF_RTOS_PRESENT
+#error [NOT_SUPPORTED] Set events.diagnostics-enabled to test the diagnostics
+#endif
+
+#include "mbed_events.h"
+#include "mbed.h"
+#include "rtos.h"
+#include "greentea-client/test_env.h"
+#include "unity.h"
+#include "utest.h"
+
+using namespace utest::v1;
+
+#define REPLY_SIZE 1024
+
+static char reply[REPLY_SIZE];
+
+void queue_registry_test() {
+    EventQueue queue(512);
+    queue.set_name("diag-test");
+    Thread thread(osPriorityNormal, 1024, NULL, "diag-thread");
+    thread.start(callback(&queue, &EventQueue::dispatch_forever));
+    wait_ms(10);
+
+    EventQueue::queue_stats stats[8];
+    unsigned n = EventQueue::get_all_stats(stats, 8);
+    TEST_ASSERT_TRUE(n > 0);
+    bool found = false;
+    for (unsigned i = 0; i < n && i < 8; i++) {
+        if (stats[i].name && strcmp(stats[i].name, "diag-test") == 0) {
+            TEST_ASSERT_NOT_EQUAL(0, stats[i].thread_id);
+            TEST_ASSERT_EQUAL(512, stats[i].stats.buffer_size);
+            found = true;
+        }
+    }
+    TEST_ASSERT_TRUE(found);
+
+    int len = mbed_diag_command("queues", reply, REPLY_SIZE);
+    TEST_ASSERT_TRUE(len > 0 && len < REPLY_SIZE);
+    TEST_ASSERT_NOT_NULL(strstr(reply, "diag-test"));
+
+    queue.break_dispatch();
+    thread.join();
+}
+
+void priority_test() {
+    EventQueue queue(512);
+    queue.set_name("diag-prio");
+    Thread thread(osPriorityNormal, 1024, NULL, "diag-thread");
+    thread.start(callback(&queue, &EventQueue::dispatch_forever));
+    wait_ms(10);
+
+    int len = mbed_diag_command("threads", reply, REPLY_SIZE);
+    TEST_ASSERT_TRUE(len > 0 && len < REPLY_SIZE);
+    TEST_ASSERT_NOT_NULL(strstr(reply, "diag-thread"));
+
+    // by thread name, then by the name of the queue it dispatches
+    mbed_diag_command("prio diag-thread 32", reply, REPLY_SIZE);
+    TEST_ASSERT_EQUAL(osPriorityAboveNormal, thread.get_priority());
+    mbed_diag_command("prio diag-prio 16", reply, REPLY_SIZE);
+    TEST_ASSERT_EQUAL(osPriorityBelowNormal, thread.get_priority());
+
+    len = mbed_diag_command("prio no-such-thread 24", reply, REPLY_SIZE);
+    TEST_ASSERT_NOT_NULL(strstr(reply, "no thread"));
+
+    queue.break_dispatch();
+    thread.join();
+}
+
+void reply_cut_test() {
+    char small[16];
+    int len = mbed_diag_command("help", small, sizeof small);
+    TEST_ASSERT_TRUE(len >= (int)sizeof small);
+    TEST_ASSERT_EQUAL(sizeof small - 1, strlen(small));
+}
+
+utest::v1::status_t test_setup(const size_t number_of_cases) {
+    GREENTEA_SETUP(20, "default_auto");
+    return verbose_test_setup_handler(number_of_cases);
+}
+
+const Case cases[] = {
+    Case("Testing the event queue registry", queue_registry_test),
+    Case("Testing priority changes", priority_test),
+    Case("Testing cut replies", reply_cut_test),
+};
+
+Specification specification(test_setup, cases);
+
+int main() {
+    return !Harness::run(specification);
+}
@@ -247,6 +247,31 @@ void event_inference_test() {
     TEST_ASSERT_EQUAL(counter, 60);
 }
 
+void static_event_test() {
+    counter = 0;
+    EventQueue queue(TEST_EQUEUE_SIZE);
+
+    // use up the queue's memory, static events don't need any
+    while (queue.call_in(10000, func0));
+
+    StaticEvent<Callback<void()> > e(&queue, callback(count1, 1u));
+    for (int i = 0; i < 5; i++) {
+        TEST_ASSERT(e.post());
+        TEST_ASSERT(!e.post());
+        TEST_ASSERT(e.pending());
+        queue.dispatch(0);
+        TEST_ASSERT(!e.pending());
+    }
+
+    TEST_ASSERT_EQUAL(counter, 5);
+
+    e.delay(100);
+    TEST_ASSERT(e.post());
+    TEST_ASSERT(e.cancel());
+    queue.dispatch(0);
+    TEST_ASSERT_EQUAL(counter, 5);
+}
+
 
 // Test setup
 utest::v1::status_t test_setup(const size_t number_of_cases) {
@@ -271,6 +296,7 @@ const Case cases[] = {
     Case("Testing the event class", event_class_test),
     Case("Testing the event class helpers", event_class_helper_test),
     Case("Testing the event inference", event_inference_test),
+    Case("Testing static events", static_event_test),
 };
 
 Specification specification(test_setup, cases);
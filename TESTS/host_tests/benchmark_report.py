@@ -0,0 +1,85 @@
+"""
+mbed SDK
+Copyright (c) 2017 ARM Limited
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+"""
+
+from mbed_host_tests import BaseHostTest
+import csv
+import os
+
+
+class BenchmarkReport(BaseHostTest):
+    """
+    Collects benchmark results sent by the device and reports them per target
+
+    The device sends each result as a "bench" key with the value
+    "<name>,<unit>,<min>,<avg>,<max>". The results are logged as a table
+    when the test ends, and appended to benchmark_<target>.csv in the
+    directory given by the MBED_BENCHMARK_DIR environment variable, so
+    results from several targets and runs can be compared.
+
+    The pass or fail result of the test is left to the device.
+    """
+
+    def __init__(self):
+        BaseHostTest.__init__(self)
+        self.results = []
+        self.clock = None
+
+    def _callback_bench(self, key, value, timestamp):
+        fields = value.split(',')
+        if len(fields) != 5:
+            self.log("Malformed benchmark result '{}'".format(value))
+            return
+        self.results.append(fields)
+        self.log("{}: min {} avg {} max {} {}".format(
+            fields[0], fields[2], fields[3], fields[4], fields[1]))
+
+    def _callback_bench_clock(self, key, value, timestamp):
+        self.clock = value
+
+    def setup(self):
+        self.register_callback('bench', self._callback_bench)
+        self.register_callback('bench_clock', self._callback_bench_clock)
+
+    def _target(self):
+        try:
+            return self.get_config_item('platform_name') or 'unknown'
+        except Exception:
+            return 'unknown'
+
+    def result(self):
+        return None
+
+    def teardown(self):
+        if not self.results:
+            return
+
+        target = self._target()
+        self.log("Benchmark results for {} (core clock {} Hz)".format(target, self.clock))
+        self.log("{:<28} {:>10} {:>10} {:>10} {:>6}".format("name", "min", "avg", "max", "unit"))
+        for name, unit, lo, avg, hi in self.results:
+            self.log("{:<28} {:>10} {:>10} {:>10} {:>6}".format(name, lo, avg, hi, unit))
+
+        directory = os.environ.get('MBED_BENCHMARK_DIR')
+        if directory:
+            path = os.path.join(directory, "benchmark_{}.csv".format(target))
+            new_file = not os.path.exists(path)
+            with open(path, 'a') as f:
+                writer = csv.writer(f)
+                if new_file:
+                    writer.writerow(['target', 'clock', 'name', 'unit', 'min', 'avg', 'max'])
+                for name, unit, lo, avg, hi in self.results:
+                    writer.writerow([target, self.clock, name, unit, lo, avg, hi])
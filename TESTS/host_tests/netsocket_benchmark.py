@@ -0,0 +1,185 @@
+"""
+mbed SDK
+Copyright (c) 2017 ARM Limited
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+"""
+
+import os
+import sys
+import socket
+import threading
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import benchmark_report
+
+BUFFER_SIZE = 4096
+
+
+class NetsocketBenchmark(benchmark_report.BenchmarkReport):
+    """
+    Serves the targets of the netsocket benchmark and collects its results
+
+    Once the device sends its "target_ip", TCP discard, chargen and echo
+    servers and UDP echo and discard servers are started on the interface
+    that reaches it. A "bench_server" request is answered with
+    "<ip>,<tcp discard>,<tcp chargen>,<tcp echo>,<udp echo>,<udp discard>"
+    ports, and a "udp_received" request with the bytes the UDP discard
+    server received since the last request.
+
+    The results are reported as by benchmark_report.
+    """
+
+    def __init__(self):
+        benchmark_report.BenchmarkReport.__init__(self)
+        self.server_ip = None
+        self.sockets = []
+        self.threads = []
+        self.running = False
+        self.udp_received = 0
+        self.lock = threading.Lock()
+
+    @staticmethod
+    def find_interface_to_target_addr(target_ip):
+        s = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        try:
+            s.connect((target_ip, 0))
+        except socket.error:
+            s.connect((target_ip, 8000))
+        ip = s.getsockname()[0]
+        s.close()
+        return ip
+
+    def _start(self, function, *args):
+        thread = threading.Thread(target=function, args=args)
+        thread.daemon = True
+        thread.start()
+        self.threads.append(thread)
+
+    def _listen(self, kind, handler):
+        s = socket.socket(socket.AF_INET, kind)
+        s.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+        s.bind((self.server_ip, 0))
+        s.settimeout(1)
+        self.sockets.append(s)
+        if kind == socket.SOCK_STREAM:
+            s.listen(4)
+            self._start(self._accept, s, handler)
+        else:
+            self._start(handler, s)
+        return s.getsockname()[1]
+
+    def _accept(self, s, handler):
+        while self.running:
+            try:
+                connection, _ = s.accept()
+            except socket.timeout:
+                continue
+            except socket.error:
+                break
+            connection.settimeout(1)
+            self._start(self._serve, connection, handler)
+
+    def _serve(self, connection, handler):
+        try:
+            handler(connection)
+        except socket.error:
+            pass
+        connection.close()
+
+    def _discard(self, connection):
+        while self.running:
+            try:
+                if not connection.recv(BUFFER_SIZE):
+                    break
+            except socket.timeout:
+                continue
+
+    def _chargen(self, connection):
+        data = bytearray(32 + i % 95 for i in range(BUFFER_SIZE))
+        while self.running:
+            try:
+                connection.sendall(data)
+            except socket.timeout:
+                continue
+
+    def _echo(self, connection):
+        while self.running:
+            try:
+                data = connection.recv(BUFFER_SIZE)
+            except socket.timeout:
+                continue
+            if not data:
+                break
+            connection.sendall(data)
+
+    def _udp_echo(self, s):
+        while self.running:
+            try:
+                data, address = s.recvfrom(BUFFER_SIZE)
+                s.sendto(data, address)
+            except socket.timeout:
+                continue
+            except socket.error:
+                break
+
+    def _udp_discard(self, s):
+        while self.running:
+            try:
+                data, _ = s.recvfrom(BUFFER_SIZE)
+            except socket.timeout:
+                continue
+            except socket.error:
+                break
+            with self.lock:
+                self.udp_received += len(data)
+
+    def _callback_target_ip(self, key, value, timestamp):
+        if self.running:
+            return
+        self.server_ip = self.find_interface_to_target_addr(value)
+        self.running = True
+        self.ports = [
+            self._listen(socket.SOCK_STREAM, self._discard),
+            self._listen(socket.SOCK_STREAM, self._chargen),
+            self._listen(socket.SOCK_STREAM, self._echo),
+            self._listen(socket.SOCK_DGRAM, self._udp_echo),
+            self._listen(socket.SOCK_DGRAM, self._udp_discard),
+        ]
+        self.log("Serving the benchmark on {} ports {}".format(self.server_ip, self.ports))
+
+    def _callback_bench_server(self, key, value, timestamp):
+        if not self.running:
+            self.log("bench_server requested before target_ip")
+            self.notify_complete(False)
+            return
+        self.send_kv("bench_server", ",".join([self.server_ip] + [str(p) for p in self.ports]))
+
+    def _callback_udp_received(self, key, value, timestamp):
+        with self.lock:
+            received, self.udp_received = self.udp_received, 0
+        self.send_kv("udp_received", received)
+
+    def setup(self):
+        benchmark_report.BenchmarkReport.setup(self)
+        self.register_callback('target_ip', self._callback_target_ip)
+        self.register_callback('bench_server', self._callback_bench_server)
+        self.register_callback('udp_received', self._callback_udp_received)
+
+    def teardown(self):
+        self.running = False
+        for thread in self.threads:
+            thread.join(2)
+        for s in self.sockets:
+            s.close()
+        benchmark_report.BenchmarkReport.teardown(self)
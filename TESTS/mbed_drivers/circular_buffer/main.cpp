@@ -0,0 +1,169 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "utest/utest.h"
+#include "unity/unity.h"
+#include "greentea-client/test_env.h"
+
+#include "mbed.h"
+#include "platform/CircularBuffer.h"
+#include "platform/SPSCCircularBuffer.h"
+
+using namespace utest::v1;
+
+#define BUFFER_SIZE 10
+#define STREAM_LENGTH 2000
+
+void test_bulk_push_pop_wraps() {
+    CircularBuffer<uint8_t, BUFFER_SIZE> buf;
+    uint8_t in[BUFFER_SIZE];
+    uint8_t out[BUFFER_SIZE];
+    uint8_t next = 0;
+    uint8_t expected = 0;
+
+    // odd sizes move the head and tail across the end of the pool
+    for (int round = 0; round < 20; round++) {
+        uint32_t n = 1 + round % 7;
+        for (uint32_t i = 0; i < n; i++) {
+            in[i] = next++;
+        }
+        buf.push(in, n);
+        TEST_ASSERT_EQUAL(n, buf.size());
+
+        TEST_ASSERT_EQUAL(n, buf.pop(out, BUFFER_SIZE));
+        for (uint32_t i = 0; i < n; i++) {
+            TEST_ASSERT_EQUAL(expected++, out[i]);
+        }
+        TEST_ASSERT_TRUE(buf.empty());
+    }
+
+    TEST_ASSERT_EQUAL(0, buf.pop(out, BUFFER_SIZE));
+}
+
+void test_bulk_push_overwrites() {
+    CircularBuffer<uint8_t, BUFFER_SIZE> buf;
+    uint8_t in[BUFFER_SIZE + 5];
+    uint8_t out[BUFFER_SIZE];
+
+    for (uint8_t i = 0; i < sizeof(in); i++) {
+        in[i] = i;
+    }
+
+    // pushing more than fits keeps the newest elements, like single pushes
+    buf.push(in, 4);
+    buf.push(in + 4, BUFFER_SIZE);
+    TEST_ASSERT_TRUE(buf.full());
+    TEST_ASSERT_EQUAL(BUFFER_SIZE, buf.size());
+    TEST_ASSERT_EQUAL(BUFFER_SIZE, buf.pop(out, BUFFER_SIZE));
+    for (uint8_t i = 0; i < BUFFER_SIZE; i++) {
+        TEST_ASSERT_EQUAL(i + 4, out[i]);
+    }
+
+    buf.push(in, sizeof(in));
+    TEST_ASSERT_EQUAL(BUFFER_SIZE, buf.pop(out, BUFFER_SIZE));
+    for (uint8_t i = 0; i < BUFFER_SIZE; i++) {
+        TEST_ASSERT_EQUAL(i + 5, out[i]);
+    }
+}
+
+void test_spsc_full_and_empty() {
+    SPSCCircularBuffer<uint8_t, BUFFER_SIZE> buf;
+    uint8_t in[BUFFER_SIZE + 5] = { 0 };
+    uint8_t data;
+
+    TEST_ASSERT_TRUE(buf.empty());
+    TEST_ASSERT_FALSE(buf.pop(data));
+
+    // a full buffer rejects data instead of overwriting it
+    TEST_ASSERT_EQUAL(BUFFER_SIZE, buf.push(in, sizeof(in)));
+    TEST_ASSERT_TRUE(buf.full());
+    TEST_ASSERT_FALSE(buf.push(data));
+    TEST_ASSERT_EQUAL(0, buf.push(in, 1));
+
+    TEST_ASSERT_TRUE(buf.pop(data));
+    TEST_ASSERT_FALSE(buf.full());
+    TEST_ASSERT_TRUE(buf.push(data));
+    TEST_ASSERT_EQUAL(BUFFER_SIZE, buf.size());
+
+    buf.reset();
+    TEST_ASSERT_TRUE(buf.empty());
+}
+
+void test_spsc_caller_storage() {
+    uint8_t storage[BUFFER_SIZE / 2];
+    SPSCRingBuffer<uint8_t> buf(storage, sizeof(storage));
+    uint8_t in[BUFFER_SIZE] = { 0 };
+
+    // one slot of the storage tells full from empty
+    TEST_ASSERT_EQUAL(sizeof(storage) - 1, buf.capacity());
+    TEST_ASSERT_EQUAL(sizeof(storage) - 1, buf.push(in, sizeof(in)));
+    TEST_ASSERT_TRUE(buf.full());
+}
+
+static SPSCCircularBuffer<uint8_t, BUFFER_SIZE> stream;
+static volatile uint32_t produced;
+
+void produce() {
+    while (produced < STREAM_LENGTH && stream.push((uint8_t)produced)) {
+        produced++;
+    }
+}
+
+void test_spsc_interrupt_producer() {
+    Ticker ticker;
+    uint8_t out[3];
+    uint32_t consumed = 0;
+    Timer timer;
+
+    produced = 0;
+    timer.start();
+    ticker.attach_us(produce, 100);
+
+    while (consumed < STREAM_LENGTH && timer.read_ms() < 5000) {
+        uint32_t n = stream.pop(out, sizeof(out));
+        for (uint32_t i = 0; i < n; i++) {
+            TEST_ASSERT_EQUAL((uint8_t)consumed, out[i]);
+            consumed++;
+        }
+    }
+
+    ticker.detach();
+    TEST_ASSERT_EQUAL(STREAM_LENGTH, consumed);
+}
+
+utest::v1::status_t greentea_failure_handler(const Case *const source, const failure_t reason) {
+    greentea_case_failure_abort_handler(source, reason);
+    return STATUS_CONTINUE;
+}
+
+Case cases[] = {
+    Case("Bulk push and pop wrap around", test_bulk_push_pop_wraps, greentea_failure_handler),
+    Case("Bulk push overwrites the oldest data", test_bulk_push_overwrites, greentea_failure_handler),
+    Case("SPSC buffer full and empty", test_spsc_full_and_empty, greentea_failure_handler),
+    Case("SPSC buffer in caller storage", test_spsc_caller_storage, greentea_failure_handler),
+    Case("SPSC buffer with an interrupt producer", test_spsc_interrupt_producer, greentea_failure_handler),
+};
+
+utest::v1::status_t greentea_test_setup(const size_t number_of_cases) {
+    GREENTEA_SETUP(20, "default_auto");
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+Specification specification(greentea_test_setup, cases, greentea_test_teardown_handler);
+
+int main() {
+    Harness::run(specification);
+}
@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2017, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity/unity.h"
+#include "utest/utest.h"
+#include "mbed_stats.h"
+
+#if !defined(MBED_CPU_STATS_ENABLED) || !MBED_CPU_STATS_ENABLED || !defined(MBED_CONF_RTOS_PRESENT)
+  #error [NOT_SUPPORTED] test not supported
+#endif
+
+using namespace utest::v1;
+
+#define MAX_THREADS     16
+#define BUSY_TIME_MS    100
+#define DELTA_MS        20
+
+static void busy_loop()
+{
+    Timer timer;
+    timer.start();
+    while (timer.read_ms() < BUSY_TIME_MS);
+}
+
+static uint64_t thread_runtime(osThreadId_t id)
+{
+    mbed_stats_thread_cpu_t stats[MAX_THREADS];
+    size_t count = mbed_stats_thread_cpu_get_each(stats, MAX_THREADS);
+
+    for (size_t i = 0; i < count; i++) {
+        if (stats[i].thread_id == (uint32_t)id) {
+            return stats[i].runtime;
+        }
+    }
+
+    TEST_FAIL_MESSAGE("thread not found");
+    return 0;
+}
+
+void test_case_busy_thread()
+{
+    Thread thread;
+    thread.start(busy_loop);
+    osThreadId_t id = thread.gettid();
+
+    Thread::wait(BUSY_TIME_MS / 2);
+    uint64_t runtime = thread_runtime(id);
+    TEST_ASSERT_UINT64_WITHIN(DELTA_MS * 1000, BUSY_TIME_MS / 2 * 1000, runtime);
+
+    thread.join();
+}
+
+void test_case_idle()
+{
+    mbed_stats_cpu_t before, after;
+
+    mbed_stats_cpu_get(&before);
+    Thread::wait(BUSY_TIME_MS);
+    mbed_stats_cpu_get(&after);
+
+    uint64_t uptime = after.uptime - before.uptime;
+    uint64_t idle = after.idle_time - before.idle_time;
+    TEST_ASSERT_UINT64_WITHIN(DELTA_MS * 1000, BUSY_TIME_MS * 1000, uptime);
+    TEST_ASSERT_UINT64_WITHIN(DELTA_MS * 1000, BUSY_TIME_MS * 1000, idle);
+
+    mbed_stats_cpu_get(&before);
+    busy_loop();
+    mbed_stats_cpu_get(&after);
+
+    idle = after.idle_time - before.idle_time;
+    TEST_ASSERT_UINT64_WITHIN(DELTA_MS * 1000, 0, idle);
+}
+
+Case cases[] = {
+    Case("busy thread runtime", test_case_busy_thread),
+    Case("idle thread share", test_case_idle),
+};
+
+utest::v1::status_t greentea_test_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(20, "default_auto");
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+Specification specification(greentea_test_setup, cases, greentea_test_teardown_handler);
+
+int main()
+{
+    Harness::run(specification);
+}
@@ -0,0 +1,161 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity/unity.h"
+#include "utest/utest.h"
+
+using namespace utest::v1;
+
+// Check values are the CRCs of the ASCII string "123456789"
+static const char check_data[] = "123456789";
+static const size_t check_size = sizeof(check_data) - 1;
+
+static uint8_t buffer[1024];
+
+static void fill_buffer()
+{
+    for (size_t i = 0; i < sizeof(buffer); i++) {
+        buffer[i] = (uint8_t)(i * 7 + 3);
+    }
+}
+
+template <uint32_t polynomial, int width>
+static uint32_t crc_of(MbedCRC<polynomial, width> &ct, const void *data, size_t size)
+{
+    uint32_t crc = 0;
+    TEST_ASSERT_EQUAL(0, ct.compute(data, size, &crc));
+    return crc;
+}
+
+void test_crc_32bit_ansi()
+{
+    MbedCRC<POLY_32BIT_ANSI, 32> ct;
+    TEST_ASSERT_EQUAL_HEX32(0xCBF43926, crc_of(ct, check_data, check_size));
+
+    MbedCRC<POLY_32BIT_ANSI, 32> bzip2(0xFFFFFFFF, 0xFFFFFFFF, false, false);
+    TEST_ASSERT_EQUAL_HEX32(0xFC891918, crc_of(bzip2, check_data, check_size));
+}
+
+void test_crc_16bit()
+{
+    MbedCRC<POLY_16BIT_CCITT, 16> ccitt;
+    TEST_ASSERT_EQUAL_HEX32(0x29B1, crc_of(ccitt, check_data, check_size));
+
+    MbedCRC<POLY_16BIT_CCITT, 16> xmodem(0, 0, false, false);
+    TEST_ASSERT_EQUAL_HEX32(0x31C3, crc_of(xmodem, check_data, check_size));
+
+    MbedCRC<POLY_16BIT_IBM, 16> arc;
+    TEST_ASSERT_EQUAL_HEX32(0xBB3D, crc_of(arc, check_data, check_size));
+
+    MbedCRC<POLY_16BIT_CCITT, 16> kermit(0, 0, true, true);
+    TEST_ASSERT_EQUAL_HEX32(0x2189, crc_of(kermit, check_data, check_size));
+}
+
+void test_crc_8bit_7bit()
+{
+    MbedCRC<POLY_8BIT_CCITT, 8> crc8;
+    TEST_ASSERT_EQUAL_HEX32(0xF4, crc_of(crc8, check_data, check_size));
+
+    MbedCRC<POLY_7BIT_SD, 7> crc7;
+    TEST_ASSERT_EQUAL_HEX32(0x75, crc_of(crc7, check_data, check_size));
+}
+
+void test_crc_other_polynomial()
+{
+    // CRC-32C, computed bit by bit
+    MbedCRC<0x1EDC6F41, 32> castagnoli(0xFFFFFFFF, 0xFFFFFFFF, true, true);
+    TEST_ASSERT_EQUAL_HEX32(0xE3069283, crc_of(castagnoli, check_data, check_size));
+
+    // CRC-12/UMTS, reflecting only the remainder
+    MbedCRC<0x80F, 12> umts(0, 0, false, true);
+    TEST_ASSERT_EQUAL_HEX32(0xDAF, crc_of(umts, check_data, check_size));
+}
+
+void test_crc_partial()
+{
+    fill_buffer();
+    MbedCRC<POLY_32BIT_ANSI, 32> ct;
+    uint32_t expected = crc_of(ct, buffer, sizeof(buffer));
+
+    // Pieces of odd sizes, to go through the unaligned paths
+    uint32_t crc;
+    TEST_ASSERT_EQUAL(0, ct.compute_partial_start(&crc));
+    size_t offset = 0;
+    for (size_t piece = 1; offset < sizeof(buffer); piece += 3) {
+        size_t size = (sizeof(buffer) - offset < piece) ? sizeof(buffer) - offset : piece;
+        TEST_ASSERT_EQUAL(0, ct.compute_partial(buffer + offset, size, &crc));
+        offset += size;
+    }
+    TEST_ASSERT_EQUAL(0, ct.compute_partial_stop(&crc));
+    TEST_ASSERT_EQUAL_HEX32(expected, crc);
+}
+
+void test_crc_concurrent()
+{
+    // The second computation is done in software while the first one may
+    // hold the peripheral
+    fill_buffer();
+    MbedCRC<POLY_32BIT_ANSI, 32> first;
+    MbedCRC<POLY_32BIT_ANSI, 32> second;
+    uint32_t expected = crc_of(first, buffer, sizeof(buffer));
+
+    uint32_t crc1, crc2;
+    TEST_ASSERT_EQUAL(0, first.compute_partial_start(&crc1));
+    TEST_ASSERT_EQUAL(0, second.compute_partial_start(&crc2));
+    TEST_ASSERT_EQUAL(0, first.compute_partial(buffer, sizeof(buffer) / 2, &crc1));
+    TEST_ASSERT_EQUAL(0, second.compute_partial(buffer, sizeof(buffer), &crc2));
+    TEST_ASSERT_EQUAL(0, first.compute_partial(buffer + sizeof(buffer) / 2, sizeof(buffer) / 2, &crc1));
+    TEST_ASSERT_EQUAL(0, second.compute_partial_stop(&crc2));
+    TEST_ASSERT_EQUAL(0, first.compute_partial_stop(&crc1));
+    TEST_ASSERT_EQUAL_HEX32(expected, crc1);
+    TEST_ASSERT_EQUAL_HEX32(expected, crc2);
+}
+
+void test_crc_null()
+{
+    MbedCRC<POLY_32BIT_ANSI, 32> ct;
+    TEST_ASSERT_EQUAL(-1, ct.compute(check_data, check_size, NULL));
+}
+
+utest::v1::status_t greentea_failure_handler(const Case *const source, const failure_t reason)
+{
+    greentea_case_failure_abort_handler(source, reason);
+    return STATUS_CONTINUE;
+}
+
+Case cases[] = {
+    Case("CRC: 32-bit ANSI", test_crc_32bit_ansi, greentea_failure_handler),
+    Case("CRC: 16-bit CCITT and IBM", test_crc_16bit, greentea_failure_handler),
+    Case("CRC: 8-bit and 7-bit", test_crc_8bit_7bit, greentea_failure_handler),
+    Case("CRC: other polynomials", test_crc_other_polynomial, greentea_failure_handler),
+    Case("CRC: partial computation", test_crc_partial, greentea_failure_handler),
+    Case("CRC: concurrent computations", test_crc_concurrent, greentea_failure_handler),
+    Case("CRC: NULL result", test_crc_null, greentea_failure_handler),
+};
+
+utest::v1::status_t greentea_test_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(10, "default_auto");
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+Specification specification(greentea_test_setup, cases, greentea_test_teardown_handler);
+
+int main()
+{
+    Harness::run(specification);
+}
@@ -0,0 +1,86 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "utest/utest.h"
+#include "unity/unity.h"
+#include "greentea-client/test_env.h"
+
+#include "mbed.h"
+
+using namespace utest::v1;
+
+#define WAIT_US     10000
+
+void test_frequency() {
+    uint32_t frequency = CycleCounter::frequency();
+    if (CycleCounter::precise()) {
+        // the counter and the us_ticker agree to within 1%
+        TEST_ASSERT_TRUE(frequency >= 1000000);
+        uint32_t start_us = us_ticker_read();
+        uint32_t start = CycleCounter::read();
+        while (us_ticker_read() - start_us < WAIT_US);
+        uint32_t cycles = CycleCounter::read() - start;
+        uint32_t expected = (uint64_t)frequency * WAIT_US / 1000000;
+        TEST_ASSERT_UINT32_WITHIN(expected / 100, expected, cycles);
+    } else {
+        TEST_ASSERT_EQUAL_UINT32(1000000, frequency);
+    }
+}
+
+void test_conversion() {
+    uint32_t frequency = CycleCounter::frequency();
+    TEST_ASSERT_UINT32_WITHIN(1, frequency / 1000, mbed_cycle_counter_from_ns(1000000));
+    TEST_ASSERT_EQUAL_UINT32(1, mbed_cycle_counter_from_ns(1));
+    TEST_ASSERT_EQUAL_UINT32(0, mbed_cycle_counter_from_ns(0));
+    TEST_ASSERT_UINT32_WITHIN(1000, 1000000, mbed_cycle_counter_to_ns(frequency / 1000));
+}
+
+void test_wait_ns() {
+    CycleCounter cc;
+    cc.start();
+    wait_ns(500);
+    cc.stop();
+    TEST_ASSERT_TRUE(cc.elapsed_ns() >= 500);
+
+    cc.reset();
+    cc.start();
+    wait_us(100);
+    cc.stop();
+    TEST_ASSERT_TRUE(cc.elapsed_ns() >= 100000);
+    TEST_ASSERT_TRUE(cc.elapsed_ns() < 150000);
+}
+
+utest::v1::status_t greentea_failure_handler(const Case *const source, const failure_t reason) {
+    greentea_case_failure_abort_handler(source, reason);
+    return STATUS_CONTINUE;
+}
+
+Case cases[] = {
+    Case("Cycle counter frequency matches the us_ticker", test_frequency, greentea_failure_handler),
+    Case("Cycle counter converts nanoseconds", test_conversion, greentea_failure_handler),
+    Case("wait_ns and wait_us on the cycle counter", test_wait_ns, greentea_failure_handler),
+};
+
+utest::v1::status_t greentea_test_setup(const size_t number_of_cases) {
+    GREENTEA_SETUP(20, "default_auto");
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+Specification specification(greentea_test_setup, cases, greentea_test_teardown_handler);
+
+int main() {
+    Harness::run(specification);
+}
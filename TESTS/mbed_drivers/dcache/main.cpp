@@ -0,0 +1,98 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "utest/utest.h"
+#include "unity/unity.h"
+#include "greentea-client/test_env.h"
+
+#include "mbed.h"
+
+using namespace utest::v1;
+
+#define BUFFER_SIZE 100
+
+MBED_DCACHE_ALIGNED static uint8_t aligned[MBED_DCACHE_ROUND_UP(BUFFER_SIZE)];
+
+void test_dma_alloc_alignment() {
+    for (size_t size = 1; size < 4 * MBED_DCACHE_LINE_SIZE; size += 7) {
+        uint8_t *buffer = (uint8_t *)mbed_dma_alloc(size);
+        TEST_ASSERT_NOT_NULL(buffer);
+        TEST_ASSERT_EQUAL(0, (uintptr_t)buffer % MBED_DCACHE_LINE_SIZE);
+        memset(buffer, 0xa5, size);
+        mbed_dma_free(buffer);
+    }
+
+    mbed_dma_free(NULL);
+}
+
+void test_static_alignment() {
+    TEST_ASSERT_EQUAL(0, (uintptr_t)aligned % MBED_DCACHE_LINE_SIZE);
+    TEST_ASSERT_EQUAL(0, sizeof(aligned) % MBED_DCACHE_LINE_SIZE);
+}
+
+void test_is_aligned() {
+    TEST_ASSERT_TRUE(mbed_dcache_is_aligned(aligned, sizeof(aligned)));
+    TEST_ASSERT_TRUE(mbed_dcache_is_aligned(aligned, MBED_DCACHE_LINE_SIZE));
+    TEST_ASSERT_TRUE(mbed_dcache_is_aligned(aligned, 0));
+    TEST_ASSERT_FALSE(mbed_dcache_is_aligned(aligned + 1, MBED_DCACHE_LINE_SIZE));
+    TEST_ASSERT_FALSE(mbed_dcache_is_aligned(aligned, MBED_DCACHE_LINE_SIZE + 1));
+    TEST_ASSERT_FALSE(mbed_dcache_is_aligned(aligned, MBED_DCACHE_ROUND_UP(BUFFER_SIZE) - 1));
+
+    void *buffer = mbed_dma_alloc(BUFFER_SIZE);
+    TEST_ASSERT_NOT_NULL(buffer);
+    TEST_ASSERT_TRUE(mbed_dcache_is_aligned(buffer, MBED_DCACHE_ROUND_UP(BUFFER_SIZE)));
+    mbed_dma_free(buffer);
+}
+
+void test_maintenance_keeps_data() {
+    uint8_t buffer[3 * MBED_DCACHE_LINE_SIZE];
+    for (size_t i = 0; i < sizeof(buffer); i++) {
+        buffer[i] = (uint8_t)i;
+    }
+
+    // unaligned ranges must not lose data the CPU wrote around them
+    mbed_dcache_clean(buffer + 1, sizeof(buffer) - 2);
+    mbed_dcache_invalidate(buffer + 3, MBED_DCACHE_LINE_SIZE);
+    mbed_dcache_clean_invalidate(buffer + 5, 2);
+    mbed_dcache_invalidate(buffer, 0);
+
+    for (size_t i = 0; i < sizeof(buffer); i++) {
+        TEST_ASSERT_EQUAL((uint8_t)i, buffer[i]);
+    }
+}
+
+utest::v1::status_t greentea_failure_handler(const Case *const source, const failure_t reason) {
+    greentea_case_failure_abort_handler(source, reason);
+    return STATUS_CONTINUE;
+}
+
+Case cases[] = {
+    Case("DMA buffers are cache line aligned", test_dma_alloc_alignment, greentea_failure_handler),
+    Case("MBED_DCACHE_ALIGNED aligns static buffers", test_static_alignment, greentea_failure_handler),
+    Case("Aligned ranges are recognised", test_is_aligned, greentea_failure_handler),
+    Case("Cache maintenance keeps CPU data", test_maintenance_keeps_data, greentea_failure_handler),
+};
+
+utest::v1::status_t greentea_test_setup(const size_t number_of_cases) {
+    GREENTEA_SETUP(20, "default_auto");
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+Specification specification(greentea_test_setup, cases, greentea_test_teardown_handler);
+
+int main() {
+    Harness::run(specification);
+}
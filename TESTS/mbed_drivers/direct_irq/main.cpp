@@ -0,0 +1,88 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "utest/utest.h"
+#include "unity/unity.h"
+#include "greentea-client/test_env.h"
+
+#include "mbed.h"
+
+#if !defined(NVIC_RAM_VECTOR_ADDRESS) || defined(__CORTEX_A9)
+    #error [NOT_SUPPORTED] Vector table is not relocated to RAM on this target
+#endif
+
+using namespace utest::v1;
+
+// any peripheral interrupt can be pended by software, whatever drives it
+#define TEST_IRQ ((IRQn_Type)0)
+
+static volatile uint32_t direct_count;
+
+static void direct_handler(void) {
+    direct_count++;
+}
+
+void test_bind_direct_handler() {
+    uint32_t vector = NVIC_GetVector(TEST_IRQ);
+    uint32_t enabled = NVIC_GetEnableIRQ(TEST_IRQ);
+
+    direct_count = 0;
+    TEST_ASSERT_EQUAL(0, mbed_irq_bind(TEST_IRQ, direct_handler, 0));
+    TEST_ASSERT_EQUAL((uint32_t)direct_handler, NVIC_GetVector(TEST_IRQ));
+
+    for (int i = 0; i < 10; i++) {
+        NVIC_SetPendingIRQ(TEST_IRQ);
+        __DSB();
+        __ISB();
+    }
+    wait_us(10);
+    TEST_ASSERT_TRUE(direct_count > 0);
+
+    TEST_ASSERT_EQUAL(0, mbed_irq_unbind(TEST_IRQ));
+    TEST_ASSERT_EQUAL(vector, NVIC_GetVector(TEST_IRQ));
+    TEST_ASSERT_EQUAL(enabled, NVIC_GetEnableIRQ(TEST_IRQ));
+}
+
+void test_bind_errors() {
+    TEST_ASSERT_EQUAL(-1, mbed_irq_unbind(TEST_IRQ));
+
+    TEST_ASSERT_EQUAL(0, mbed_irq_bind(TEST_IRQ, direct_handler, 0));
+    TEST_ASSERT_EQUAL(-1, mbed_irq_bind(TEST_IRQ, direct_handler, 0));
+    TEST_ASSERT_EQUAL(0, mbed_irq_unbind(TEST_IRQ));
+
+    TEST_ASSERT_EQUAL(-1, mbed_irq_bind(SysTick_IRQn, direct_handler, 0));
+}
+
+utest::v1::status_t greentea_failure_handler(const Case *const source, const failure_t reason) {
+    greentea_case_failure_abort_handler(source, reason);
+    return STATUS_CONTINUE;
+}
+
+Case cases[] = {
+    Case("Direct handler runs and unbind restores the vector", test_bind_direct_handler, greentea_failure_handler),
+    Case("Binding twice and unbinding unbound interrupts fail", test_bind_errors, greentea_failure_handler),
+};
+
+utest::v1::status_t greentea_test_setup(const size_t number_of_cases) {
+    GREENTEA_SETUP(20, "default_auto");
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+Specification specification(greentea_test_setup, cases, greentea_test_teardown_handler);
+
+int main() {
+    Harness::run(specification);
+}
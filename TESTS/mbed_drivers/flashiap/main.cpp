@@ -123,10 +123,211 @@ void flashiap_program_error_test()
     TEST_ASSERT_EQUAL_INT32(0, ret);
 }
 
+void flashiap_writer_test()
+{
+    FlashIAP flash_device;
+    uint32_t ret = flash_device.init();
+    TEST_ASSERT_EQUAL_INT32(0, ret);
+
+    // write the last sector in odd sized chunks
+    uint32_t sector_size = flash_device.get_sector_size(flash_device.get_flash_start() + flash_device.get_flash_size() - 1UL);
+    uint32_t address = (flash_device.get_flash_start() + flash_device.get_flash_size()) - (sector_size);
+    uint32_t size = sector_size - 3;
+    uint8_t chunk[37];
+
+    FlashIAPWriter writer(flash_device);
+    ret = writer.begin(address, size);
+    TEST_ASSERT_EQUAL_INT32(0, ret);
+
+    for (uint32_t offset = 0; offset < size; offset += sizeof(chunk)) {
+        uint32_t n = size - offset < sizeof(chunk) ? size - offset : sizeof(chunk);
+        for (uint32_t i = 0; i < n; i++) {
+            chunk[i] = (uint8_t)(offset + i);
+        }
+        ret = writer.write(chunk, n);
+        TEST_ASSERT_EQUAL_INT32(0, ret);
+    }
+    TEST_ASSERT_EQUAL_UINT32(size, writer.written());
+
+    // the region is full
+    TEST_ASSERT_NOT_EQUAL(0, writer.write(chunk, 4));
+
+    ret = writer.finish();
+    TEST_ASSERT_EQUAL_INT32(0, ret);
+    TEST_ASSERT_TRUE(writer.programmed() >= size);
+
+    for (uint32_t offset = 0; offset < size; offset += sizeof(chunk)) {
+        uint32_t n = size - offset < sizeof(chunk) ? size - offset : sizeof(chunk);
+        ret = flash_device.read(chunk, address + offset, n);
+        TEST_ASSERT_EQUAL_INT32(0, ret);
+        for (uint32_t i = 0; i < n; i++) {
+            TEST_ASSERT_EQUAL_UINT8((uint8_t)(offset + i), chunk[i]);
+        }
+    }
+
+    ret = flash_device.deinit();
+    TEST_ASSERT_EQUAL_INT32(0, ret);
+}
+
+static void put_le32(uint8_t *p, uint32_t value)
+{
+    p[0] = value;
+    p[1] = value >> 8;
+    p[2] = value >> 16;
+    p[3] = value >> 24;
+}
+
+void flashiap_delta_update_test()
+{
+    FlashIAP flash_device;
+    uint32_t ret = flash_device.init();
+    TEST_ASSERT_EQUAL_INT32(0, ret);
+
+    // the current image is in the sector before the last, the new one goes in the last
+    uint32_t end = flash_device.get_flash_start() + flash_device.get_flash_size();
+    uint32_t sector_size = flash_device.get_sector_size(end - 1UL);
+    uint32_t new_addr = end - sector_size;
+    uint32_t old_addr = new_addr - sector_size;
+    if (flash_device.get_sector_size(old_addr) != sector_size) {
+        TEST_IGNORE_MESSAGE("last sectors differ in size");
+    }
+    uint32_t page_size = flash_device.get_page_size();
+    const uint32_t image_size = 256;
+    uint32_t program_size = (image_size + page_size - 1) / page_size * page_size;
+
+    uint8_t *old_image = new uint8_t[program_size];
+    uint8_t new_image[image_size];
+    for (uint32_t i = 0; i < program_size; i++) {
+        old_image[i] = (uint8_t)i;
+    }
+    memcpy(new_image, old_image, image_size);
+    new_image[100] += 0x10;
+
+    ret = flash_device.erase(old_addr, sector_size);
+    TEST_ASSERT_EQUAL_INT32(0, ret);
+    for (uint32_t i = 0; i < program_size; i += page_size) {
+        ret = flash_device.program(&old_image[i], old_addr + i, page_size);
+        TEST_ASSERT_EQUAL_INT32(0, ret);
+    }
+
+    // one record: 100 bytes as they are, one byte changed, the rest as they are
+    MbedCRC<POLY_32BIT_ANSI, 32> ct;
+    uint32_t old_crc, new_crc;
+    ct.compute(old_image, image_size, &old_crc);
+    ct.compute(new_image, image_size, &new_crc);
+    uint8_t patch[20 + 12 + 6];
+    memcpy(patch, "MDP1", 4);
+    put_le32(&patch[4], image_size);
+    put_le32(&patch[8], old_crc);
+    put_le32(&patch[12], image_size);
+    put_le32(&patch[16], new_crc);
+    put_le32(&patch[20], image_size);
+    put_le32(&patch[24], 0);
+    put_le32(&patch[28], 0);
+    const uint8_t tokens[] = { 0xC8, 0x01, 0x03, 0x10, 0xB6, 0x02 };
+    memcpy(&patch[32], tokens, sizeof(tokens));
+
+    DeltaUpdate delta(flash_device);
+    ret = delta.begin(old_addr, sector_size, new_addr, sector_size);
+    TEST_ASSERT_EQUAL_INT32(0, ret);
+    for (uint32_t i = 0; i < sizeof(patch); i += 5) {
+        ret = delta.write(&patch[i], sizeof(patch) - i < 5 ? sizeof(patch) - i : 5);
+        TEST_ASSERT_EQUAL_INT32(0, ret);
+    }
+    ret = delta.finish();
+    TEST_ASSERT_EQUAL_INT32(0, ret);
+    TEST_ASSERT_EQUAL_UINT32(image_size, delta.size());
+
+    uint8_t data_flashed[image_size];
+    ret = flash_device.read(data_flashed, new_addr, image_size);
+    TEST_ASSERT_EQUAL_INT32(0, ret);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(new_image, data_flashed, image_size);
+
+    // the patch is refused once the current image has changed
+    ret = delta.begin(new_addr, sector_size, old_addr, sector_size);
+    TEST_ASSERT_EQUAL_INT32(0, ret);
+    TEST_ASSERT_EQUAL_INT32(DeltaUpdate::DELTA_UPDATE_ERROR_SOURCE, delta.write(patch, sizeof(patch)));
+
+    delete[] old_image;
+    ret = flash_device.deinit();
+    TEST_ASSERT_EQUAL_INT32(0, ret);
+}
+
+#if DEVICE_FLASH_ASYNCH
+static volatile int async_event;
+
+static void async_done(int event)
+{
+    async_event = event;
+}
+
+static int wait_async(FlashIAP &flash_device)
+{
+    Timer timer;
+    timer.start();
+    while (!async_event && timer.read_ms() < 10000);
+    TEST_ASSERT_FALSE(flash_device.busy());
+    int event = async_event;
+    async_event = 0;
+    return event;
+}
+
+void flashiap_async_test()
+{
+    FlashIAP flash_device;
+    uint32_t ret = flash_device.init();
+    TEST_ASSERT_EQUAL_INT32(0, ret);
+
+    uint32_t sector_size = flash_device.get_sector_size(flash_device.get_flash_start() + flash_device.get_flash_size() - 1UL);
+    uint32_t page_size = flash_device.get_page_size();
+    const uint8_t test_value = 0x5A;
+    uint8_t *data = new uint8_t[page_size];
+    for (uint32_t i = 0; i < page_size; i++) {
+        data[i] = test_value;
+    }
+
+    uint32_t address = (flash_device.get_flash_start() + flash_device.get_flash_size()) - (sector_size);
+    async_event = 0;
+    ret = flash_device.erase_async(address, sector_size, async_done);
+    TEST_ASSERT_EQUAL_INT32(0, ret);
+
+    // blocking access fails while the erase is running
+    if (flash_device.busy()) {
+        TEST_ASSERT_EQUAL_INT32(-1, flash_device.erase(address, sector_size));
+    }
+    TEST_ASSERT_EQUAL(FLASH_EVENT_COMPLETE, wait_async(flash_device));
+
+    for (uint32_t i = 0; i < sector_size / page_size; i++) {
+        uint32_t page_addr = address + i * page_size;
+        ret = flash_device.program_async(data, page_addr, page_size, async_done);
+        TEST_ASSERT_EQUAL_INT32(0, ret);
+        TEST_ASSERT_EQUAL(FLASH_EVENT_COMPLETE, wait_async(flash_device));
+    }
+
+    uint8_t *data_flashed = new uint8_t[page_size];
+    for (uint32_t i = 0; i < sector_size / page_size; i++) {
+        uint32_t page_addr = address + i * page_size;
+        ret = flash_device.read(data_flashed, page_addr, page_size);
+        TEST_ASSERT_EQUAL_INT32(0, ret);
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(data, data_flashed, page_size);
+    }
+    delete[] data;
+    delete[] data_flashed;
+
+    ret = flash_device.deinit();
+    TEST_ASSERT_EQUAL_INT32(0, ret);
+}
+#endif
+
 Case cases[] = {
     Case("FlashIAP - init", flashiap_init_test),
     Case("FlashIAP - program", flashiap_program_test),
     Case("FlashIAP - program errors", flashiap_program_error_test),
+    Case("FlashIAP - streaming writer", flashiap_writer_test),
+    Case("FlashIAP - delta update", flashiap_delta_update_test),
+#if DEVICE_FLASH_ASYNCH
+    Case("FlashIAP - asynchronous erase and program", flashiap_async_test),
+#endif
 };
 
 utest::v1::status_t greentea_test_setup(const size_t number_of_cases) {
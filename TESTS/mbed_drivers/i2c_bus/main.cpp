@@ -0,0 +1,179 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#if !DEVICE_I2C_ASYNCH
+#error [NOT_SUPPORTED] Asynchronous I2C not supported for this target
+#endif
+
+#if !defined(MBED_CONF_APP_I2C_SDA) || !defined(MBED_CONF_APP_I2C_SCL)
+#error [NOT_SUPPORTED] Pull up an I2C bus and set i2c-sda and i2c-scl
+#endif
+
+#include "utest/utest.h"
+#include "unity/unity.h"
+#include "greentea-client/test_env.h"
+
+#include "mbed.h"
+
+using namespace utest::v1;
+
+// 7-bit 0x7c is reserved, no slave acknowledges it
+#define ABSENT_ADDRESS  0xf8
+#define SLOW_HZ         10000
+#define WAIT_MS         500
+
+namespace {
+    int order[MBED_CONF_DRIVERS_I2C_BUS_QUEUE_SIZE + 1];
+    int results[MBED_CONF_DRIVERS_I2C_BUS_QUEUE_SIZE + 1];
+    volatile int done;
+    char tx[2] = { 0x00, 0x01 };
+    char rx[2];
+}
+
+// Waits for count callbacks, or at most WAIT_MS
+static void wait_done(int count) {
+    for (int i = 0; i < WAIT_MS && done < count; i++) {
+        wait_ms(1);
+    }
+    TEST_ASSERT_EQUAL(count, done);
+}
+
+static void record(int id, int event) {
+    order[done] = id;
+    results[done] = event;
+    done++;
+}
+
+static void record_0(int event) { record(0, event); }
+static void record_1(int event) { record(1, event); }
+static void record_2(int event) { record(2, event); }
+
+void test_i2c_bus_no_slave() {
+    I2CBus bus(MBED_CONF_APP_I2C_SDA, MBED_CONF_APP_I2C_SCL);
+
+    done = 0;
+    TEST_ASSERT_EQUAL(0, bus.transfer(ABSENT_ADDRESS, tx, 1, rx, 1, record_0));
+    wait_done(1);
+    TEST_ASSERT_TRUE(results[0] & I2C_EVENT_ERROR_NO_SLAVE);
+    TEST_ASSERT_EQUAL(0, bus.pending());
+
+    // callbacks only come for the events asked for
+    done = 0;
+    TEST_ASSERT_EQUAL(0, bus.transfer(ABSENT_ADDRESS, tx, 1, rx, 1, record_1, I2C_EVENT_TRANSFER_COMPLETE));
+    TEST_ASSERT_EQUAL(0, bus.transfer(ABSENT_ADDRESS, tx, 1, rx, 1, record_2));
+    wait_done(1);
+    TEST_ASSERT_EQUAL(2, order[0]);
+}
+
+void test_i2c_bus_sequence() {
+    I2CBus bus(MBED_CONF_APP_I2C_SDA, MBED_CONF_APP_I2C_SCL);
+    const I2CBus::Step steps[3] = {
+        { ABSENT_ADDRESS, tx, 2, NULL, 0, true },
+        { ABSENT_ADDRESS, tx, 1, rx, 2, false },
+        { ABSENT_ADDRESS, NULL, 0, rx, 1, false },
+    };
+
+    TEST_ASSERT_EQUAL(-1, bus.sequence(steps, 0, record_0));
+
+    // a sequence stops at its first failing step, with one callback
+    done = 0;
+    TEST_ASSERT_EQUAL(0, bus.sequence(steps, 3, record_0));
+    TEST_ASSERT_EQUAL(0, bus.transfer(ABSENT_ADDRESS, tx, 1, NULL, 0, record_1));
+    wait_done(2);
+    wait_ms(20);
+    TEST_ASSERT_EQUAL(2, done);
+    TEST_ASSERT_EQUAL(0, order[0]);
+    TEST_ASSERT_TRUE(results[0] & I2C_EVENT_ERROR_NO_SLAVE);
+    TEST_ASSERT_EQUAL(1, order[1]);
+}
+
+void test_i2c_bus_queue() {
+    I2CBus bus(MBED_CONF_APP_I2C_SDA, MBED_CONF_APP_I2C_SCL);
+    bus.frequency(SLOW_HZ);
+
+    // transactions run in the order they were queued
+    done = 0;
+    for (int i = 0; i < MBED_CONF_DRIVERS_I2C_BUS_QUEUE_SIZE; i++) {
+        TEST_ASSERT_EQUAL(0, bus.transfer(ABSENT_ADDRESS, tx, 1, NULL, 0, i % 2 ? record_1 : record_0));
+    }
+    TEST_ASSERT_EQUAL(-1, bus.transfer(ABSENT_ADDRESS, tx, 1, NULL, 0, record_2));
+    TEST_ASSERT_EQUAL(MBED_CONF_DRIVERS_I2C_BUS_QUEUE_SIZE, bus.pending());
+
+    wait_done(MBED_CONF_DRIVERS_I2C_BUS_QUEUE_SIZE);
+    for (int i = 0; i < MBED_CONF_DRIVERS_I2C_BUS_QUEUE_SIZE; i++) {
+        TEST_ASSERT_EQUAL(i % 2, order[i]);
+    }
+    TEST_ASSERT_EQUAL(0, bus.pending());
+}
+
+void test_i2c_bus_abort() {
+    I2CBus bus(MBED_CONF_APP_I2C_SDA, MBED_CONF_APP_I2C_SCL);
+    bus.frequency(SLOW_HZ);
+
+    done = 0;
+    TEST_ASSERT_EQUAL(0, bus.transfer(ABSENT_ADDRESS, tx, 2, NULL, 0, record_0));
+    TEST_ASSERT_EQUAL(0, bus.transfer(ABSENT_ADDRESS, tx, 2, NULL, 0, record_1));
+    bus.abort_all();
+    TEST_ASSERT_EQUAL(0, bus.pending());
+
+    // dropped transactions are not called back, and the bus is usable again
+    wait_ms(20);
+    TEST_ASSERT_EQUAL(0, done);
+    TEST_ASSERT_EQUAL(0, bus.transfer(ABSENT_ADDRESS, tx, 1, NULL, 0, record_2));
+    wait_done(1);
+    TEST_ASSERT_EQUAL(2, order[0]);
+}
+
+#ifdef MBED_CONF_APP_I2C_SLAVE_ADDRESS
+void test_i2c_bus_slave() {
+    I2CBus bus(MBED_CONF_APP_I2C_SDA, MBED_CONF_APP_I2C_SCL);
+    const I2CBus::Step steps[2] = {
+        { MBED_CONF_APP_I2C_SLAVE_ADDRESS, tx, 1, rx, 1, false },
+        { MBED_CONF_APP_I2C_SLAVE_ADDRESS, tx, 1, rx, 2, false },
+    };
+
+    // a slave that is there completes every step
+    done = 0;
+    TEST_ASSERT_EQUAL(0, bus.sequence(steps, 2, record_0));
+    TEST_ASSERT_EQUAL(0, bus.transfer(MBED_CONF_APP_I2C_SLAVE_ADDRESS, tx, 1, rx, 1, record_1));
+    wait_done(2);
+    TEST_ASSERT_EQUAL(I2C_EVENT_TRANSFER_COMPLETE, results[0]);
+    TEST_ASSERT_EQUAL(I2C_EVENT_TRANSFER_COMPLETE, results[1]);
+    TEST_ASSERT_EQUAL(1, order[1]);
+}
+#endif
+
+
+// Test setup
+utest::v1::status_t test_setup(const size_t number_of_cases) {
+    GREENTEA_SETUP(20, "default_auto");
+    return verbose_test_setup_handler(number_of_cases);
+}
+
+Case cases[] = {
+    Case("I2CBus missing slave", test_i2c_bus_no_slave),
+    Case("I2CBus sequence", test_i2c_bus_sequence),
+    Case("I2CBus queue", test_i2c_bus_queue),
+    Case("I2CBus abort", test_i2c_bus_abort),
+#ifdef MBED_CONF_APP_I2C_SLAVE_ADDRESS
+    Case("I2CBus slave", test_i2c_bus_slave),
+#endif
+};
+
+Specification specification(test_setup, cases);
+
+int main() {
+    return !Harness::run(specification);
+}
@@ -0,0 +1,115 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#if !DEVICE_INTERRUPTIN || !DEVICE_PWMOUT
+#error [NOT_SUPPORTED] InterruptIn not supported for this target
+#endif
+
+#if !defined(MBED_CONF_APP_EDGE_OUT) || !defined(MBED_CONF_APP_EDGE_IN)
+#error [NOT_SUPPORTED] Connect a PwmOut pin to an InterruptIn pin and set edge-out and edge-in
+#endif
+
+#include "utest/utest.h"
+#include "unity/unity.h"
+#include "greentea-client/test_env.h"
+
+#include "mbed.h"
+
+using namespace utest::v1;
+
+#define PERIOD_US       1000
+#define PULSE_US        250
+#define RUN_MS          100
+#define TOLERANCE_US    50
+
+void test_buffer() {
+    PwmOut pwm(MBED_CONF_APP_EDGE_OUT);
+    pwm.period_us(PERIOD_US);
+    pwm.pulsewidth_us(PULSE_US);
+    InterruptIn in(MBED_CONF_APP_EDGE_IN);
+    in.timestamp_edges();
+
+    wait_ms(RUN_MS);
+    TEST_ASSERT_TRUE(in.dropped_edges() > 0);
+
+    // the buffered edges alternate and are spaced by the pulse and the rest of the period
+    InterruptIn::Edge edges[MBED_CONF_DRIVERS_INTERRUPT_IN_EDGE_BUFFER_SIZE];
+    int n = in.read_edges(edges, MBED_CONF_DRIVERS_INTERRUPT_IN_EDGE_BUFFER_SIZE);
+    TEST_ASSERT_EQUAL(MBED_CONF_DRIVERS_INTERRUPT_IN_EDGE_BUFFER_SIZE, n);
+    for (int i = 1; i < n; i++) {
+        TEST_ASSERT_TRUE(edges[i].rising != edges[i - 1].rising);
+        uint32_t expected = edges[i].rising ? PERIOD_US - PULSE_US : PULSE_US;
+        TEST_ASSERT_UINT32_WITHIN(TOLERANCE_US, expected, edges[i].timestamp - edges[i - 1].timestamp);
+    }
+
+    in.stop_timestamps();
+    TEST_ASSERT_EQUAL(0, in.read_edges(edges, MBED_CONF_DRIVERS_INTERRUPT_IN_EDGE_BUFFER_SIZE));
+}
+
+static int rising_edges;
+static int drained;
+
+static void count_edges(const InterruptIn::Edge *edges, int count) {
+    for (int i = 0; i < count; i++) {
+        rising_edges += edges[i].rising;
+    }
+    drained += count;
+}
+
+static void count_rise() {
+    rising_edges--;
+}
+
+void test_queue() {
+    PwmOut pwm(MBED_CONF_APP_EDGE_OUT);
+    pwm.period_us(PERIOD_US);
+    pwm.pulsewidth_us(PULSE_US);
+    EventQueue queue;
+    InterruptIn in(MBED_CONF_APP_EDGE_IN);
+
+    // the rise callback still runs alongside the timestamps, only rising edges are kept
+    rising_edges = 0;
+    drained = 0;
+    in.rise(count_rise);
+    in.timestamp_edges(&queue, count_edges, true, false);
+    queue.dispatch(RUN_MS);
+    in.stop_timestamps();
+    in.rise(NULL);
+
+    TEST_ASSERT_UINT32_WITHIN(2, RUN_MS * 1000 / PERIOD_US, drained);
+    TEST_ASSERT_EQUAL(0, in.dropped_edges());
+    TEST_ASSERT_INT_WITHIN(1, 0, rising_edges);
+}
+
+utest::v1::status_t greentea_failure_handler(const Case *const source, const failure_t reason) {
+    greentea_case_failure_abort_handler(source, reason);
+    return STATUS_CONTINUE;
+}
+
+Case cases[] = {
+    Case("InterruptIn buffers timestamped edges", test_buffer, greentea_failure_handler),
+    Case("InterruptIn drains edges on an event queue", test_queue, greentea_failure_handler),
+};
+
+utest::v1::status_t greentea_test_setup(const size_t number_of_cases) {
+    GREENTEA_SETUP(20, "default_auto");
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+Specification specification(greentea_test_setup, cases, greentea_test_teardown_handler);
+
+int main() {
+    Harness::run(specification);
+}
@@ -266,12 +266,63 @@ static void test_case_new_delete() {
     check_free_op(pmem ++, p_int_array);
 }
 
+// Allocations made from one call site, for the aggregation test
+static MBED_NOINLINE void *test_alloc_site(size_t size) {
+    return malloc(size);
+}
+
+// Find the statistics of the call site with the given number of allocations
+static bool test_find_site(uint32_t alloc_cnt, mbed_mem_trace_site_t *site) {
+    static mbed_mem_trace_site_t sites[8];
+    size_t count = mbed_mem_trace_aggregate_get(sites, 8);
+    for (size_t i = 0; i < count; i++) {
+        if (sites[i].alloc_cnt == alloc_cnt) {
+            *site = sites[i];
+            return true;
+        }
+    }
+    return false;
+}
+
+// Test the per call site statistics of the aggregating tracer
+static void test_case_aggregate() {
+    const size_t block_size = 24;
+    void *blocks[5];
+    mbed_mem_trace_site_t site;
+
+    mbed_mem_trace_aggregate_reset();
+    // Start tracing
+    mbed_mem_trace_set_callback(mbed_mem_trace_aggregate_callback);
+    for (int i = 0; i < 5; i++) {
+        blocks[i] = test_alloc_site(block_size);
+        TEST_ASSERT_NOT_EQUAL(blocks[i], NULL);
+    }
+    free(blocks[0]);
+    free(blocks[1]);
+    // Stop tracing
+    mbed_mem_trace_set_callback(NULL);
+    free(blocks[2]);
+    free(blocks[3]);
+    free(blocks[4]);
+    // Check tracer result
+    TEST_ASSERT_TRUE(test_find_site(5, &site));
+    TEST_ASSERT_EQUAL_UINT32(2, site.free_cnt);
+    TEST_ASSERT_EQUAL_UINT32(0, site.alloc_fail_cnt);
+    TEST_ASSERT_EQUAL_UINT32(5 * block_size, site.total_size);
+    TEST_ASSERT_EQUAL_UINT32(3 * block_size, site.current_size);
+    TEST_ASSERT_EQUAL_UINT32(5 * block_size, site.max_size);
+
+    mbed_mem_trace_aggregate_reset();
+    TEST_ASSERT_EQUAL(0, mbed_mem_trace_aggregate_get(&site, 1));
+}
+
 static Case cases[] = {
     Case("single malloc/free", test_case_single_malloc_free),
     Case("all memory operations", test_case_all_memory_ops),
     Case("trace off", test_case_trace_off),
     Case("partial trace", test_case_partial_trace),
-    Case("test new/delete", test_case_new_delete)
+    Case("test new/delete", test_case_new_delete),
+    Case("aggregate per call site", test_case_aggregate)
 };
 
 static status_t greentea_test_setup(const size_t number_of_cases) {
@@ -0,0 +1,124 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#if !MBED_CONF_PLATFORM_PERF_COUNTERS_ENABLED
+#error [NOT_SUPPORTED] Set platform.perf-counters-enabled to test the performance counters
+#endif
+
+#include "utest/utest.h"
+#include "unity/unity.h"
+#include "greentea-client/test_env.h"
+
+#include "mbed.h"
+#include "platform/mbed_perf_counters.h"
+
+using namespace utest::v1;
+
+static MBED_PERF_COUNTER(test_count, "test.count");
+static MBED_PERF_COUNTER(test_gauge, "test.gauge");
+
+static const uint32_t test_bounds[] = { 10, 100 };
+static MBED_PERF_HISTOGRAM(test_histogram, "test.histogram", test_bounds);
+
+static uint32_t hook_calls;
+
+static void test_update() {
+    hook_calls++;
+    mbed_perf_counter_set(&test_gauge, hook_calls);
+}
+
+static MBED_PERF_HOOK(test_hook, test_update);
+
+static char json[512];
+static uint8_t binary[512];
+
+void test_json() {
+    mbed_perf_hook_register(&test_hook);
+    mbed_perf_counter_add(&test_count, 41);
+    mbed_perf_counter_add(&test_count, 1);
+    mbed_perf_histogram_add(&test_histogram, 10);
+    mbed_perf_histogram_add(&test_histogram, 11);
+    mbed_perf_histogram_add(&test_histogram, 1000);
+
+    int len = mbed_perf_export_json(json, sizeof json);
+    TEST_ASSERT_TRUE(len > 0 && len < (int)sizeof json);
+    TEST_ASSERT_EQUAL(len, strlen(json));
+    TEST_ASSERT_EQUAL('{', json[0]);
+    TEST_ASSERT_EQUAL('}', json[len - 1]);
+    TEST_ASSERT_NOT_NULL(strstr(json, "\"test.count\":42"));
+    TEST_ASSERT_NOT_NULL(strstr(json, "\"test.gauge\":1"));
+    TEST_ASSERT_NOT_NULL(strstr(json, "\"test.histogram\":{\"bounds\":[10,100],\"buckets\":[1,1,1]}"));
+
+    // a short buffer is cut and still terminated
+    char small[8];
+    TEST_ASSERT_EQUAL(len, mbed_perf_export_json(small, sizeof small));
+    TEST_ASSERT_EQUAL(sizeof small - 1, strlen(small));
+    TEST_ASSERT_EQUAL(2, hook_calls);
+}
+
+void test_binary() {
+    int len = mbed_perf_export_binary(binary, sizeof binary);
+    TEST_ASSERT_TRUE(len > 5 && len < (int)sizeof binary);
+    TEST_ASSERT_EQUAL('P', binary[0]);
+    TEST_ASSERT_EQUAL('C', binary[1]);
+    TEST_ASSERT_EQUAL(1, binary[2]);
+
+    // walk the entries to find the counter
+    unsigned count = binary[3] | binary[4] << 8;
+    int pos = 5;
+    bool found = false;
+    for (unsigned i = 0; i < count; i++) {
+        uint8_t type = binary[pos];
+        uint8_t name_len = binary[pos + 1];
+        const char *name = (const char *)&binary[pos + 2];
+        pos += 2 + name_len;
+        if (type == 0) {
+            uint32_t value = binary[pos] | binary[pos + 1] << 8 |
+                    binary[pos + 2] << 16 | (uint32_t)binary[pos + 3] << 24;
+            if (name_len == strlen("test.count") && memcmp(name, "test.count", name_len) == 0) {
+                TEST_ASSERT_EQUAL(42, value);
+                found = true;
+            }
+            pos += 4;
+        } else {
+            TEST_ASSERT_EQUAL(1, type);
+            uint8_t buckets = binary[pos];
+            pos += 1 + (2 * buckets - 1) * 4;
+        }
+    }
+    TEST_ASSERT_TRUE(found);
+    TEST_ASSERT_EQUAL(len, pos);
+}
+
+utest::v1::status_t greentea_failure_handler(const Case *const source, const failure_t reason) {
+    greentea_case_failure_abort_handler(source, reason);
+    return STATUS_CONTINUE;
+}
+
+Case cases[] = {
+    Case("Performance counters export as JSON", test_json, greentea_failure_handler),
+    Case("Performance counters export in binary", test_binary, greentea_failure_handler),
+};
+
+utest::v1::status_t greentea_test_setup(const size_t number_of_cases) {
+    GREENTEA_SETUP(20, "default_auto");
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+Specification specification(greentea_test_setup, cases, greentea_test_teardown_handler);
+
+int main() {
+    Harness::run(specification);
+}
@@ -0,0 +1,85 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#if !DEVICE_LOWPOWERTIMER || !DEVICE_SLEEP
+    #error [NOT_SUPPORTED] Low power timer not supported for this target
+#endif
+
+#include "utest/utest.h"
+#include "unity/unity.h"
+#include "greentea-client/test_env.h"
+
+#include "mbed.h"
+
+using namespace utest::v1;
+
+#define COARSE_US   MBED_CONF_PLATFORM_LP_TICKER_RESOLUTION_US
+#define TIMEOUT_US  (100 * COARSE_US)
+
+volatile static bool complete;
+
+void cb_done() {
+    complete = true;
+}
+
+void resolution_timer_coarse() {
+    ResolutionTimer<COARSE_US> timer;
+    timer.start();
+    TEST_ASSERT_TRUE(sleep_manager_can_deep_sleep());
+    wait_ms(10);
+    timer.stop();
+    TEST_ASSERT_INT_WITHIN(2 * COARSE_US, 10000, timer.read_us());
+}
+
+void resolution_timer_fine() {
+    ResolutionTimer<1> timer;
+    timer.start();
+    TEST_ASSERT_FALSE(sleep_manager_can_deep_sleep());
+    timer.stop();
+    TEST_ASSERT_TRUE(sleep_manager_can_deep_sleep());
+}
+
+void resolution_timeout_coarse() {
+    ResolutionTimeout<COARSE_US> timeout;
+    complete = false;
+
+    timeout.attach_us(cb_done, TIMEOUT_US);
+    TEST_ASSERT_TRUE(sleep_manager_can_deep_sleep());
+    wait_us(TIMEOUT_US + 2 * COARSE_US);
+    TEST_ASSERT_TRUE(complete);
+}
+
+utest::v1::status_t greentea_failure_handler(const Case *const source, const failure_t reason) {
+    greentea_case_failure_abort_handler(source, reason);
+    return STATUS_CONTINUE;
+}
+
+Case cases[] = {
+    Case("Coarse ResolutionTimer allows deep sleep", resolution_timer_coarse, greentea_failure_handler),
+    Case("Fine ResolutionTimer locks deep sleep", resolution_timer_fine, greentea_failure_handler),
+    Case("Coarse ResolutionTimeout allows deep sleep", resolution_timeout_coarse, greentea_failure_handler),
+};
+
+utest::v1::status_t greentea_test_setup(const size_t number_of_cases) {
+    GREENTEA_SETUP(20, "default_auto");
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+Specification specification(greentea_test_setup, cases, greentea_test_teardown_handler);
+
+int main() {
+    Harness::run(specification);
+}
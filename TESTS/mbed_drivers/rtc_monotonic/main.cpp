@@ -0,0 +1,112 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity/unity.h"
+#include "utest/utest.h"
+#include "hal/rtc_api.h"
+#if defined(TOOLCHAIN_GCC)
+#include <sys/time.h>
+#endif
+
+using namespace utest::v1;
+
+#ifndef MBED_CONF_PLATFORM_RTC_RESYNC_INTERVAL
+#define MBED_CONF_PLATFORM_RTC_RESYNC_INTERVAL 0
+#endif
+
+// Long enough to see several resyncs
+#define TEST_SECONDS (3 * MBED_CONF_PLATFORM_RTC_RESYNC_INTERVAL + 3)
+
+#define SLOW_RTC_START 1256729737
+
+// An RTC that runs 10% slower than the us ticker, so the time extrapolated
+// between resyncs is always ahead of it
+static uint32_t slow_rtc_start_us;
+
+static void slow_rtc_init(void)
+{
+}
+
+static int slow_rtc_isenabled(void)
+{
+    return 1;
+}
+
+static time_t slow_rtc_read(void)
+{
+    uint32_t elapsed = us_ticker_read() - slow_rtc_start_us;
+    return SLOW_RTC_START + (time_t)((uint64_t)elapsed * 9 / 10 / 1000000);
+}
+
+static void slow_rtc_write(time_t t)
+{
+    (void)t;
+    slow_rtc_start_us = us_ticker_read();
+}
+
+void test_time_monotonic() {
+    attach_rtc(slow_rtc_read, slow_rtc_write, slow_rtc_init, slow_rtc_isenabled);
+    set_time(SLOW_RTC_START);
+
+    Timer timer;
+    timer.start();
+    time_t last = time(NULL);
+    TEST_ASSERT_EQUAL(SLOW_RTC_START, last);
+#if defined(TOOLCHAIN_GCC)
+    struct timeval last_tv;
+    gettimeofday(&last_tv, NULL);
+#endif
+
+    while (timer.read() < TEST_SECONDS) {
+        time_t t = time(NULL);
+        TEST_ASSERT(t >= last);
+        last = t;
+#if defined(TOOLCHAIN_GCC)
+        struct timeval tv;
+        gettimeofday(&tv, NULL);
+        TEST_ASSERT(tv.tv_sec > last_tv.tv_sec ||
+                (tv.tv_sec == last_tv.tv_sec && tv.tv_usec >= last_tv.tv_usec));
+        last_tv = tv;
+#endif
+        wait_ms(10);
+    }
+
+    // set_time is allowed to move it back
+    set_time(SLOW_RTC_START);
+    TEST_ASSERT(time(NULL) <= SLOW_RTC_START + 1);
+
+#if DEVICE_RTC
+    attach_rtc(rtc_read, rtc_write, rtc_init, rtc_isenabled);
+#else
+    attach_rtc(NULL, NULL, NULL, NULL);
+#endif
+}
+
+Case cases[] = {
+    Case("Time does not go back on resync", test_time_monotonic),
+};
+
+utest::v1::status_t greentea_test_setup(const size_t number_of_cases) {
+    GREENTEA_SETUP(TEST_SECONDS + 20, "default_auto");
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+Specification specification(greentea_test_setup, cases, greentea_test_teardown_handler);
+
+int main() {
+    Harness::run(specification);
+}
@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2017, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity/unity.h"
+#include "utest/utest.h"
+#include "mbed_stats.h"
+#include <string.h>
+
+#if !defined(MBED_SLEEP_STATS_ENABLED) || !MBED_SLEEP_STATS_ENABLED || !DEVICE_SLEEP || !defined(MBED_CONF_RTOS_PRESENT)
+  #error [NOT_SUPPORTED] test not supported
+#endif
+
+using namespace utest::v1;
+
+#define MAX_LOCKS       8
+#define MAX_WAKEUPS     8
+#define SLEEP_TIME_MS   100
+
+static uint32_t lock_count(const char *name)
+{
+    mbed_stats_sleep_lock_t locks[MAX_LOCKS];
+    size_t count = mbed_stats_sleep_locks_get_each(locks, MAX_LOCKS);
+    for (size_t i = 0; i < count; i++) {
+        if (strcmp(locks[i].name, name) == 0) {
+            return locks[i].lock_cnt;
+        }
+    }
+    return 0;
+}
+
+void test_case_named_lock()
+{
+    TEST_ASSERT_EQUAL(0, lock_count("test"));
+
+    sleep_manager_lock_deep_sleep_named("test");
+    sleep_manager_lock_deep_sleep_named("test");
+    TEST_ASSERT_EQUAL(2, lock_count("test"));
+    TEST_ASSERT_FALSE(sleep_manager_can_deep_sleep());
+
+    sleep_manager_unlock_deep_sleep_named("test");
+    TEST_ASSERT_EQUAL(1, lock_count("test"));
+    sleep_manager_unlock_deep_sleep_named("test");
+    TEST_ASSERT_EQUAL(0, lock_count("test"));
+}
+
+void test_case_unnamed_lock()
+{
+    TEST_ASSERT_EQUAL(0, lock_count("unnamed"));
+
+    sleep_manager_lock_deep_sleep();
+    TEST_ASSERT_EQUAL(1, lock_count("unnamed"));
+
+    // a lock taken in one file can be released in another
+    sleep_manager_unlock_deep_sleep_named(NULL);
+    TEST_ASSERT_EQUAL(0, lock_count("unnamed"));
+}
+
+static void ticker_cb()
+{
+}
+
+void test_case_driver_lock()
+{
+    Ticker ticker;
+    ticker.attach_us(ticker_cb, 1000000);
+    TEST_ASSERT_EQUAL(1, lock_count("Ticker"));
+    ticker.detach();
+    TEST_ASSERT_EQUAL(0, lock_count("Ticker"));
+}
+
+void test_case_sleep_time()
+{
+    mbed_stats_sleep_t before;
+    mbed_stats_sleep_t after;
+
+    mbed_stats_sleep_get(&before);
+    Thread::wait(SLEEP_TIME_MS);
+    mbed_stats_sleep_get(&after);
+
+    uint64_t slept = (after.sleep_time - before.sleep_time) +
+                     (after.deep_sleep_time - before.deep_sleep_time);
+    TEST_ASSERT(after.sleep_cnt + after.deep_sleep_cnt > before.sleep_cnt + before.deep_sleep_cnt);
+    TEST_ASSERT(slept > 0);
+    TEST_ASSERT(slept <= SLEEP_TIME_MS * 1000);
+
+    mbed_stats_wakeup_t wakeups[MAX_WAKEUPS];
+    TEST_ASSERT(mbed_stats_wakeup_get_each(wakeups, MAX_WAKEUPS) > 0 || after.unknown_wakeup_cnt > 0);
+}
+
+Case cases[] = {
+    Case("named deep sleep lock", test_case_named_lock),
+    Case("unnamed deep sleep lock", test_case_unnamed_lock),
+    Case("driver deep sleep lock", test_case_driver_lock),
+    Case("sleep time", test_case_sleep_time),
+};
+
+utest::v1::status_t greentea_test_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(20, "default_auto");
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+Specification specification(greentea_test_setup, cases, greentea_test_teardown_handler);
+
+int main()
+{
+    Harness::run(specification);
+}
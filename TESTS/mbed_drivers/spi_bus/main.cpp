@@ -0,0 +1,165 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#if !DEVICE_SPI_ASYNCH
+#error [NOT_SUPPORTED] Asynchronous SPI not supported for this target
+#endif
+
+#if !defined(MBED_CONF_APP_SPI_MOSI) || !defined(MBED_CONF_APP_SPI_MISO) || !defined(MBED_CONF_APP_SPI_SCLK)
+#error [NOT_SUPPORTED] Connect spi-mosi to spi-miso and set spi-mosi, spi-miso and spi-sclk
+#endif
+
+#include "utest/utest.h"
+#include "unity/unity.h"
+#include "greentea-client/test_env.h"
+
+#include "mbed.h"
+
+using namespace utest::v1;
+
+#define BUFFER_SIZE     16
+#define BURST_SIZE      1024
+#define WAIT_MS         500
+
+namespace {
+    int order[MBED_CONF_DRIVERS_SPI_BUS_QUEUE_SIZE + 1];
+    volatile int done;
+    volatile int last_event;
+    uint8_t burst_buffer[BURST_SIZE];
+}
+
+// Waits for count callbacks, or at most WAIT_MS
+static void wait_done(int count) {
+    for (int i = 0; i < WAIT_MS && done < count; i++) {
+        wait_ms(1);
+    }
+    TEST_ASSERT_EQUAL(count, done);
+}
+
+static void record(int id, int event) {
+    order[done++] = id;
+    last_event = event;
+}
+
+static void record_0(int event) { record(0, event); }
+static void record_1(int event) { record(1, event); }
+static void record_2(int event) { record(2, event); }
+
+void test_spi_bus_devices() {
+    SPIBus bus(MBED_CONF_APP_SPI_MOSI, MBED_CONF_APP_SPI_MISO, MBED_CONF_APP_SPI_SCLK);
+
+    for (int i = 0; i < MBED_CONF_DRIVERS_SPI_BUS_DEVICES; i++) {
+        TEST_ASSERT_EQUAL(i, bus.add_device(NC));
+    }
+    TEST_ASSERT_EQUAL(-1, bus.add_device(NC));
+
+    char tx = 0x5a;
+    TEST_ASSERT_EQUAL(-1, bus.transfer(-1, &tx, 1, NULL, 0, NULL));
+    TEST_ASSERT_EQUAL(-1, bus.transfer(MBED_CONF_DRIVERS_SPI_BUS_DEVICES, &tx, 1, NULL, 0, NULL));
+    TEST_ASSERT_EQUAL(0, bus.pending());
+}
+
+void test_spi_bus_formats() {
+    SPIBus bus(MBED_CONF_APP_SPI_MOSI, MBED_CONF_APP_SPI_MISO, MBED_CONF_APP_SPI_SCLK);
+    int bytes = bus.add_device(NC, 8, 0, 1000000);
+    int words = bus.add_device(NC, 16, 3, 2000000);
+
+    static const uint8_t tx8[BUFFER_SIZE] = {
+        0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0xff, 0x55, 0xaa, 0x5a, 0xa5, 0x12, 0x34,
+    };
+    static const uint16_t tx16[BUFFER_SIZE / 2] = {
+        0x0001, 0x8000, 0xffff, 0x5555, 0xaaaa, 0x1234, 0xfedc, 0x0f0f,
+    };
+    uint8_t rx8[2][BUFFER_SIZE];
+    uint16_t rx16[BUFFER_SIZE / 2];
+
+    // alternating devices, the bus reconfigured in between, loop back their data
+    done = 0;
+    TEST_ASSERT_EQUAL(0, bus.transfer(bytes, tx8, BUFFER_SIZE, rx8[0], BUFFER_SIZE, record_0));
+    TEST_ASSERT_EQUAL(0, bus.transfer(words, tx16, BUFFER_SIZE, rx16, BUFFER_SIZE, record_1));
+    TEST_ASSERT_EQUAL(0, bus.transfer(bytes, tx8, BUFFER_SIZE, rx8[1], BUFFER_SIZE, record_2));
+    wait_done(3);
+
+    for (int i = 0; i < 3; i++) {
+        TEST_ASSERT_EQUAL(i, order[i]);
+    }
+    TEST_ASSERT_EQUAL(SPI_EVENT_COMPLETE, last_event);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(tx8, rx8[0], BUFFER_SIZE);
+    TEST_ASSERT_EQUAL_UINT16_ARRAY(tx16, rx16, BUFFER_SIZE / 2);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(tx8, rx8[1], BUFFER_SIZE);
+    TEST_ASSERT_EQUAL(0, bus.pending());
+}
+
+void test_spi_bus_queue() {
+    SPIBus bus(MBED_CONF_APP_SPI_MOSI, MBED_CONF_APP_SPI_MISO, MBED_CONF_APP_SPI_SCLK);
+    int device = bus.add_device(NC, 8, 0, 1000000);
+    char tx = 0xa5;
+
+    // a burst keeps the bus busy while the queue fills up
+    done = 0;
+    TEST_ASSERT_EQUAL(0, bus.burst(device, burst_buffer, BURST_SIZE, record_0));
+    for (int i = 1; i < MBED_CONF_DRIVERS_SPI_BUS_QUEUE_SIZE; i++) {
+        TEST_ASSERT_EQUAL(0, bus.transfer(device, &tx, 1, NULL, 0, record_1));
+    }
+    TEST_ASSERT_EQUAL(-1, bus.transfer(device, &tx, 1, NULL, 0, record_2));
+    TEST_ASSERT_EQUAL(MBED_CONF_DRIVERS_SPI_BUS_QUEUE_SIZE, bus.pending());
+
+    // the burst completes once, before the transfers queued after it
+    wait_done(MBED_CONF_DRIVERS_SPI_BUS_QUEUE_SIZE);
+    TEST_ASSERT_EQUAL(0, order[0]);
+    for (int i = 1; i < MBED_CONF_DRIVERS_SPI_BUS_QUEUE_SIZE; i++) {
+        TEST_ASSERT_EQUAL(1, order[i]);
+    }
+    TEST_ASSERT_EQUAL(0, bus.pending());
+}
+
+void test_spi_bus_abort() {
+    SPIBus bus(MBED_CONF_APP_SPI_MOSI, MBED_CONF_APP_SPI_MISO, MBED_CONF_APP_SPI_SCLK);
+    int device = bus.add_device(NC, 8, 0, 1000000);
+    char tx = 0xa5;
+
+    done = 0;
+    TEST_ASSERT_EQUAL(0, bus.burst(device, burst_buffer, BURST_SIZE, record_0));
+    TEST_ASSERT_EQUAL(0, bus.transfer(device, &tx, 1, NULL, 0, record_1));
+    bus.abort_all();
+    TEST_ASSERT_EQUAL(0, bus.pending());
+
+    // dropped transfers are not called back, and the bus is usable again
+    wait_ms(20);
+    TEST_ASSERT_EQUAL(0, done);
+    TEST_ASSERT_EQUAL(0, bus.transfer(device, &tx, 1, NULL, 0, record_2));
+    wait_done(1);
+    TEST_ASSERT_EQUAL(2, order[0]);
+}
+
+
+// Test setup
+utest::v1::status_t test_setup(const size_t number_of_cases) {
+    GREENTEA_SETUP(20, "default_auto");
+    return verbose_test_setup_handler(number_of_cases);
+}
+
+Case cases[] = {
+    Case("SPIBus devices", test_spi_bus_devices),
+    Case("SPIBus formats", test_spi_bus_formats),
+    Case("SPIBus queue", test_spi_bus_queue),
+    Case("SPIBus abort", test_spi_bus_abort),
+};
+
+Specification specification(test_setup, cases);
+
+int main() {
+    return !Harness::run(specification);
+}
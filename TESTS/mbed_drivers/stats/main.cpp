@@ -181,11 +181,69 @@ void test_case_realloc_size()
     TEST_ASSERT_EQUAL_UINT32(stats_start.current_size, stats_current.current_size);
 }
 
+void test_case_size_histogram()
+{
+    mbed_stats_heap_t stats_start;
+    mbed_stats_heap_t stats_current;
+
+    mbed_stats_heap_get(&stats_start);
+
+    void *small = malloc(10);
+    void *medium = malloc(ALLOCATION_SIZE_SMALL);
+    void *large = malloc(2048);
+    TEST_ASSERT(small != NULL && medium != NULL && large != NULL);
+    mbed_stats_heap_get(&stats_current);
+    // up to 16, 128 and over 1024 bytes
+    TEST_ASSERT_EQUAL_UINT32(stats_start.alloc_size_hist[0] + 1, stats_current.alloc_size_hist[0]);
+    TEST_ASSERT_EQUAL_UINT32(stats_start.alloc_size_hist[3] + 1, stats_current.alloc_size_hist[3]);
+    TEST_ASSERT_EQUAL_UINT32(stats_start.alloc_size_hist[MBED_STATS_HEAP_HIST_BUCKETS - 1] + 1,
+                             stats_current.alloc_size_hist[MBED_STATS_HEAP_HIST_BUCKETS - 1]);
+
+    free(small);
+    free(medium);
+    free(large);
+}
+
+#if MBED_CONF_PLATFORM_HEAP_STATS_FRAGMENTATION
+void test_case_free_blocks()
+{
+    mbed_stats_heap_t stats;
+    void *data[8];
+
+    for (uint32_t i = 0; i < 8; i++) {
+        data[i] = malloc(ALLOCATION_SIZE_SMALL);
+        TEST_ASSERT(data[i] != NULL);
+    }
+    // free every other block, the blocks in between keep them apart
+    for (uint32_t i = 0; i < 8; i += 2) {
+        free(data[i]);
+    }
+
+    mbed_stats_heap_get(&stats);
+    TEST_ASSERT(stats.largest_free_size >= ALLOCATION_SIZE_SMALL);
+    TEST_ASSERT(stats.free_size == 0 || stats.free_size >= stats.largest_free_size);
+    TEST_ASSERT(stats.free_size == 0 || stats.free_block_cnt >= 4);
+
+    // the largest free block can be allocated, within the allocator overhead
+    void *largest = malloc(stats.largest_free_size - 64);
+    TEST_ASSERT(largest != NULL);
+    free(largest);
+
+    for (uint32_t i = 1; i < 8; i += 2) {
+        free(data[i]);
+    }
+}
+#endif
+
 Case cases[] = {
     Case("malloc and free size", test_case_malloc_free_size),
     Case("allocate size zero", test_case_allocate_zero),
     Case("allocation failure", test_case_allocate_fail),
     Case("realloc size", test_case_realloc_size),
+    Case("allocation size histogram", test_case_size_histogram),
+#if MBED_CONF_PLATFORM_HEAP_STATS_FRAGMENTATION
+    Case("free blocks", test_case_free_blocks),
+#endif
 };
 
 utest::v1::status_t greentea_test_setup(const size_t number_of_cases)
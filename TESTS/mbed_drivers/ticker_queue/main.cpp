@@ -0,0 +1,114 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "mbed.h"
+#include "mbed_events.h"
+#include "greentea-client/test_env.h"
+#include "unity.h"
+#include "utest.h"
+
+#if !MBED_CONF_EVENTS_PRESENT
+#error [NOT_SUPPORTED] Event queues are not supported
+#endif
+
+using namespace utest::v1;
+
+static volatile int calls;
+static volatile bool in_isr;
+
+static void count() {
+    calls++;
+    in_isr = in_isr || core_util_is_isr_active();
+}
+
+
+void test_ticker_queue() {
+    EventQueue queue;
+    Ticker ticker;
+    calls = 0;
+    in_isr = false;
+
+    ticker.attach_deferred_us(&queue, count, 10000);
+    queue.dispatch(105);
+    ticker.detach();
+
+    TEST_ASSERT_INT_WITHIN(1, 10, calls);
+    TEST_ASSERT(!in_isr);
+}
+
+void test_ticker_overrun() {
+    EventQueue queue;
+    Ticker ticker;
+    calls = 0;
+
+    // the ticker fires many times before the queue runs
+    ticker.attach_deferred_us(&queue, count, 1000);
+    wait_ms(50);
+    queue.dispatch(0);
+    TEST_ASSERT_EQUAL(1, calls);
+
+    ticker.detach();
+}
+
+void test_timeout_queue() {
+    EventQueue queue;
+    Timeout timeout;
+    calls = 0;
+    in_isr = false;
+
+    timeout.attach_deferred_us(&queue, count, 5000);
+    queue.dispatch(50);
+
+    TEST_ASSERT_EQUAL(1, calls);
+    TEST_ASSERT(!in_isr);
+}
+
+void test_detach_cancels() {
+    EventQueue queue;
+    Ticker ticker;
+    calls = 0;
+
+    ticker.attach_deferred_us(&queue, count, 1000);
+    wait_ms(10);
+    ticker.detach();
+    queue.dispatch(0);
+    TEST_ASSERT_EQUAL(0, calls);
+
+    // attaching again replaces the function
+    ticker.attach_deferred(&queue, count, 0.001f);
+    wait_ms(10);
+    queue.dispatch(0);
+    TEST_ASSERT_EQUAL(1, calls);
+}
+
+
+// Test setup
+utest::v1::status_t test_setup(const size_t number_of_cases) {
+    GREENTEA_SETUP(20, "default_auto");
+    return verbose_test_setup_handler(number_of_cases);
+}
+
+Case cases[] = {
+    Case("Testing Ticker on an event queue", test_ticker_queue),
+    Case("Testing Ticker overruns", test_ticker_overrun),
+    Case("Testing Timeout on an event queue", test_timeout_queue),
+    Case("Testing detach", test_detach_cancels),
+};
+
+Specification specification(test_setup, cases);
+
+int main() {
+    return !Harness::run(specification);
+}
@@ -0,0 +1,120 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity.h"
+#include "utest.h"
+
+using namespace utest::v1;
+
+#define ISR_ADDS        1000
+#define THREAD_ADDS     100000
+
+
+template <typename T>
+void test_operations() {
+    Atomic<T> value(5);
+    TEST_ASSERT_EQUAL(5, value.fetch_add(3));
+    TEST_ASSERT_EQUAL(8, value.load());
+    TEST_ASSERT_EQUAL(8, value.fetch_sub(2));
+    TEST_ASSERT_EQUAL(6, value.exchange(0x13));
+    TEST_ASSERT_EQUAL(0x13, value.fetch_and(0x11));
+    TEST_ASSERT_EQUAL(0x11, value.fetch_or(0x02));
+    TEST_ASSERT_EQUAL(0x13, value.fetch_xor(0x01));
+    TEST_ASSERT_EQUAL(0x12, (T)value);
+
+    T expected = 0;
+    TEST_ASSERT_FALSE(value.compare_exchange(expected, 7));
+    TEST_ASSERT_EQUAL(0x12, expected);
+    TEST_ASSERT_TRUE(value.compare_exchange(expected, 7));
+    TEST_ASSERT_EQUAL(7, value.load());
+
+    value = 1;
+    TEST_ASSERT_EQUAL(2, ++value);
+    TEST_ASSERT_EQUAL(2, value++);
+    TEST_ASSERT_EQUAL(2, --value);
+    TEST_ASSERT_EQUAL(2, value--);
+    TEST_ASSERT_EQUAL(1, value.load());
+}
+
+void test_pointer() {
+    int array[4] = { 0, 1, 2, 3 };
+    Atomic<int *> ptr(array);
+    TEST_ASSERT_EQUAL_PTR(array, ptr.fetch_add(2));
+    TEST_ASSERT_EQUAL(2, *ptr.load());
+    TEST_ASSERT_EQUAL_PTR(array + 3, ++ptr);
+    ptr -= 3;
+    TEST_ASSERT_EQUAL_PTR(array, ptr.load());
+    TEST_ASSERT_EQUAL_PTR(array, ptr.exchange(array + 1));
+
+    int *expected = array;
+    TEST_ASSERT_FALSE(ptr.compare_exchange(expected, array + 2));
+    TEST_ASSERT_EQUAL_PTR(array + 1, expected);
+}
+
+static Atomic<uint32_t> shared;
+static volatile int isr_count;
+static Ticker *ticker;
+
+void isr_add() {
+    if (isr_count < ISR_ADDS) {
+        shared.fetch_or(0);
+        shared += 1;
+        isr_count++;
+    } else {
+        ticker->detach();
+    }
+}
+
+void test_isr_race() {
+    Ticker adder;
+    ticker = &adder;
+    shared = 0;
+    isr_count = 0;
+
+    adder.attach_us(isr_add, 50);
+    for (int i = 0; i < THREAD_ADDS; i++) {
+        shared += 1;
+    }
+    while (isr_count < ISR_ADDS) {
+        shared += 1;
+        shared -= 1;
+    }
+
+    TEST_ASSERT_EQUAL(ISR_ADDS + THREAD_ADDS, shared.load());
+}
+
+
+// Test setup
+utest::v1::status_t test_setup(const size_t number_of_cases) {
+    GREENTEA_SETUP(20, "default_auto");
+    return verbose_test_setup_handler(number_of_cases);
+}
+
+Case cases[] = {
+    Case("Testing 8-bit atomics", test_operations<uint8_t>),
+    Case("Testing 16-bit atomics", test_operations<uint16_t>),
+    Case("Testing 32-bit atomics", test_operations<uint32_t>),
+    Case("Testing 64-bit atomics", test_operations<uint64_t>),
+    Case("Testing atomic pointers", test_pointer),
+    Case("Testing atomics shared with an interrupt", test_isr_race),
+};
+
+Specification specification(test_setup, cases);
+
+int main() {
+    return !Harness::run(specification);
+}
@@ -0,0 +1,132 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "mbed.h"
+#include "platform/mbed_bin_trace.h"
+#include "greentea-client/test_env.h"
+#include "unity.h"
+#include "utest.h"
+
+using namespace utest::v1;
+
+#define TRACE_WORDS     (MBED_CONF_PLATFORM_BIN_TRACE_BUFFER_SIZE / 4)
+#define ISR_TRACES      100
+
+static const char format[] = "value %d %x";
+static uint32_t records[TRACE_WORDS];
+
+
+void test_record() {
+    mbed_bin_trace_clear();
+    uint32_t args[2] = { 0xFFFFFFFF, 0x1234 };
+    mbed_bin_trace_write(format, args, 2);
+    mbed_bin_trace_write(format, NULL, 0);
+
+    TEST_ASSERT_EQUAL(8 * 4, mbed_bin_trace_read(records, sizeof(records)));
+    TEST_ASSERT_EQUAL_HEX32(MBED_BIN_TRACE_MAGIC << 24 | 2 << 16, records[0] & 0xFFFF0000);
+    TEST_ASSERT_EQUAL_HEX32((uint32_t)format, records[1]);
+    TEST_ASSERT_EQUAL_HEX32(0xFFFFFFFF, records[3]);
+    TEST_ASSERT_EQUAL_HEX32(0x1234, records[4]);
+    TEST_ASSERT_EQUAL_HEX32(MBED_BIN_TRACE_MAGIC << 24, records[5] & 0xFFFF0000);
+    TEST_ASSERT_EQUAL(1, (records[5] - records[0]) & 0xFFFF);
+    TEST_ASSERT_TRUE(records[7] - records[2] < 1000);
+
+    TEST_ASSERT_EQUAL(0, mbed_bin_trace_read(records, sizeof(records)));
+}
+
+void test_partial_read() {
+    mbed_bin_trace_clear();
+    uint32_t args[1] = { 7 };
+    mbed_bin_trace_write(format, args, 1);
+    mbed_bin_trace_write(format, args, 1);
+
+    // only whole records are read
+    TEST_ASSERT_EQUAL(4 * 4, mbed_bin_trace_read(records, 7 * 4));
+    TEST_ASSERT_EQUAL(4 * 4, mbed_bin_trace_read(records, 7 * 4));
+    TEST_ASSERT_EQUAL(0, mbed_bin_trace_read(records, 7 * 4));
+}
+
+void test_full() {
+    mbed_bin_trace_clear();
+    int written = 0;
+    while (TRACE_WORDS - written * 3 >= 3) {
+        mbed_bin_trace_write(format, NULL, 0);
+        written++;
+    }
+    TEST_ASSERT_EQUAL(0, mbed_bin_trace_dropped());
+    mbed_bin_trace_write(format, NULL, 0);
+    mbed_bin_trace_write(format, NULL, 0);
+    TEST_ASSERT_EQUAL(2, mbed_bin_trace_dropped());
+
+    TEST_ASSERT_EQUAL(written * 3 * 4, mbed_bin_trace_read(records, sizeof(records)));
+    mbed_bin_trace_clear();
+    TEST_ASSERT_EQUAL(0, mbed_bin_trace_dropped());
+}
+
+static size_t drained;
+
+void drain_count(const void *data, size_t size) {
+    drained += size;
+}
+
+static volatile int isr_count;
+static Ticker *ticker;
+
+void isr_trace() {
+    if (isr_count < ISR_TRACES) {
+        uint32_t args[1] = { (uint32_t)isr_count };
+        mbed_bin_trace_write(format, args, 1);
+        isr_count++;
+    } else {
+        ticker->detach();
+    }
+}
+
+void test_isr_drain() {
+    Ticker tracer;
+    ticker = &tracer;
+    mbed_bin_trace_clear();
+    drained = 0;
+    isr_count = 0;
+
+    tracer.attach_us(isr_trace, 100);
+    while (isr_count < ISR_TRACES) {
+        mbed_bin_trace_drain(drain_count);
+    }
+    mbed_bin_trace_drain(drain_count);
+
+    TEST_ASSERT_EQUAL(0, mbed_bin_trace_dropped());
+    TEST_ASSERT_EQUAL(ISR_TRACES * 4 * 4, drained);
+}
+
+
+// Test setup
+utest::v1::status_t test_setup(const size_t number_of_cases) {
+    GREENTEA_SETUP(20, "default_auto");
+    return verbose_test_setup_handler(number_of_cases);
+}
+
+Case cases[] = {
+    Case("Testing trace records", test_record),
+    Case("Testing reads of whole records", test_partial_read),
+    Case("Testing a full trace buffer", test_full),
+    Case("Testing draining traces from an interrupt", test_isr_drain),
+};
+
+Specification specification(test_setup, cases);
+
+int main() {
+    return !Harness::run(specification);
+}
@@ -0,0 +1,104 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity.h"
+#include "utest.h"
+
+using namespace utest::v1;
+
+
+// function object holding two pointers, like a lambda capturing two variables
+struct Adder {
+    int *a;
+    int *b;
+
+    int operator()(int x) const { return *a + *b + x; }
+};
+
+// function object counting its copies and destructions
+static int live;
+
+struct Counted {
+    int *value;
+
+    Counted(int *value) : value(value) { live++; }
+    Counted(const Counted &that) : value(that.value) { live++; }
+    ~Counted() { live--; }
+
+    int operator()() { return *value; }
+};
+
+void test_two_words() {
+    int a = 1, b = 2;
+    Adder adder = { &a, &b };
+
+    Callback<int(int)> cb(adder);
+    TEST_ASSERT_EQUAL(6, cb(3));
+    b = 10;
+    TEST_ASSERT_EQUAL(14, cb(3));
+}
+
+void test_copies_compare_equal() {
+    int a = 1, b = 2;
+    Adder adder = { &a, &b };
+
+    Callback<int(int)> cb(adder);
+    Callback<int(int)> copy(cb);
+    TEST_ASSERT_TRUE(copy == cb);
+
+    Callback<int(int)> assigned;
+    assigned = cb;
+    TEST_ASSERT_TRUE(assigned == cb);
+
+    Callback<int(int)> empty1, empty2;
+    TEST_ASSERT_TRUE(empty1 == empty2);
+    TEST_ASSERT_TRUE(empty1 != cb);
+}
+
+void test_lifetime() {
+    int value = 5;
+    live = 0;
+    {
+        Callback<int()> cb((Counted(&value)));
+        TEST_ASSERT_EQUAL(1, live);
+        Callback<int()> copy(cb);
+        TEST_ASSERT_EQUAL(2, live);
+        TEST_ASSERT_EQUAL(5, copy());
+        cb = NULL;
+        TEST_ASSERT_EQUAL(1, live);
+    }
+    TEST_ASSERT_EQUAL(0, live);
+}
+
+
+// Test setup
+utest::v1::status_t test_setup(const size_t number_of_cases) {
+    GREENTEA_SETUP(10, "default_auto");
+    return verbose_test_setup_handler(number_of_cases);
+}
+
+Case cases[] = {
+    Case("Testing function objects of two words", test_two_words),
+    Case("Testing copies of function objects compare equal", test_copies_compare_equal),
+    Case("Testing function objects are destroyed", test_lifetime),
+};
+
+Specification specification(test_setup, cases);
+
+int main() {
+    return !Harness::run(specification);
+}
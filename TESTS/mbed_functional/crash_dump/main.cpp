@@ -0,0 +1,74 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "mbed.h"
+#include "platform/mbed_crash_dump.h"
+#include "greentea-client/test_env.h"
+#include "unity.h"
+#include "utest.h"
+
+using namespace utest::v1;
+
+static mbed_crash_dump_t dump;
+
+
+void test_layout() {
+    // The checksum is computed over whole words
+    TEST_ASSERT_EQUAL(0, sizeof(mbed_crash_dump_t) % 4);
+    TEST_ASSERT_EQUAL(0, MBED_CONF_PLATFORM_CRASH_DUMP_TRACE_SIZE % 4);
+}
+
+void test_print() {
+    memset(&dump, 0, sizeof(dump));
+    dump.magic = MBED_CRASH_DUMP_MAGIC;
+    dump.size = sizeof(dump);
+    dump.reason = MBED_CRASH_DUMP_HARD_FAULT;
+    dump.pc = 0x1234;
+    dump.exc_return = 0xFFFFFFFD;
+    dump.current_thread = 0x20000100;
+    dump.thread_count = 1;
+    dump.threads[0].id = 0x20000100;
+    strcpy(dump.threads[0].name, "main");
+    dump.stack_count = 2;
+    dump.stack[0] = 0xDEADBEEF;
+    dump.trace_size = 3;
+
+    // Out of range counts and reasons are printed within the dump
+    mbed_crash_dump_print(&dump);
+    dump.reason = 100;
+    dump.thread_count = 100;
+    dump.stack_count = 1000;
+    dump.trace_size = 10000;
+    mbed_crash_dump_print(&dump);
+}
+
+
+
+// Test setup
+utest::v1::status_t test_setup(const size_t number_of_cases) {
+    GREENTEA_SETUP(20, "default_auto");
+    return verbose_test_setup_handler(number_of_cases);
+}
+
+Case cases[] = {
+    Case("Testing the crash dump layout", test_layout),
+    Case("Testing printing a crash dump", test_print),
+};
+
+Specification specification(test_setup, cases);
+
+int main() {
+    return !Harness::run(specification);
+}
@@ -0,0 +1,164 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "mbed.h"
+#include "platform/mbed_heap_regions.h"
+#include "platform/mbed_tlsf.h"
+#include "greentea-client/test_env.h"
+#include "unity.h"
+#include "utest.h"
+
+#if !defined(MBED_CONF_PLATFORM_HEAP_REGIONS) || MBED_CONF_PLATFORM_HEAP_REGIONS < 2
+#error [NOT_SUPPORTED] platform.heap-regions must be at least 2 for this test
+#endif
+
+using namespace utest::v1;
+
+#define FAST_SIZE   2048
+#define DMA_SIZE    4096
+
+static uint64_t fast_mem[FAST_SIZE / sizeof(uint64_t)];
+static uint64_t dma_mem[DMA_SIZE / sizeof(uint64_t)];
+static int fast_index = -1;
+static int dma_index = -1;
+
+static bool in_region(void *ptr, void *mem, size_t size) {
+    return (char *)ptr >= (char *)mem && (char *)ptr < (char *)mem + size;
+}
+
+static uint32_t region_free(int index) {
+    mbed_heap_region_info_t info;
+    TEST_ASSERT_EQUAL(0, mbed_heap_region_info(index, &info));
+    return info.free_size;
+}
+
+// the main heap is used first for attributes it has
+static bool main_heap_has(uint32_t attributes) {
+    return (MBED_CONF_PLATFORM_HEAP_ATTRIBUTES & attributes) == attributes;
+}
+
+
+void test_add() {
+    uint64_t tiny;
+    TEST_ASSERT_EQUAL(-1, mbed_heap_region_add(&tiny, sizeof(tiny), MBED_HEAP_FAST));
+
+    fast_index = mbed_heap_region_add(fast_mem, sizeof(fast_mem), MBED_HEAP_FAST | MBED_HEAP_DMA);
+    dma_index = mbed_heap_region_add(dma_mem, sizeof(dma_mem), MBED_HEAP_DMA);
+    TEST_ASSERT(fast_index >= 0);
+    TEST_ASSERT_EQUAL(fast_index + 1, dma_index);
+
+    mbed_heap_region_info_t info;
+    TEST_ASSERT_EQUAL(0, mbed_heap_region_info(dma_index, &info));
+    TEST_ASSERT_EQUAL_PTR(dma_mem, info.start);
+    TEST_ASSERT_EQUAL(DMA_SIZE, info.size);
+    TEST_ASSERT_EQUAL(MBED_HEAP_DMA, info.attributes);
+    TEST_ASSERT(info.free_size >= DMA_SIZE - MBED_TLSF_POOL_OVERHEAD);
+    TEST_ASSERT_EQUAL(info.free_size, info.largest_free_size);
+    TEST_ASSERT_EQUAL(-1, mbed_heap_region_info(MBED_CONF_PLATFORM_HEAP_REGIONS, &info));
+}
+
+void test_attributes() {
+    if (main_heap_has(MBED_HEAP_FAST)) {
+        TEST_IGNORE_MESSAGE("The main heap is fast memory");
+    }
+    uint32_t fast_initial = region_free(fast_index);
+    uint32_t dma_initial = region_free(dma_index);
+
+    // regions are tried in the order they were added
+    void *fast = mbed_heap_alloc(100, MBED_HEAP_FAST);
+    TEST_ASSERT(in_region(fast, fast_mem, sizeof(fast_mem)));
+    void *fast_dma = mbed_heap_alloc(100, MBED_HEAP_FAST | MBED_HEAP_DMA);
+    TEST_ASSERT(in_region(fast_dma, fast_mem, sizeof(fast_mem)));
+    TEST_ASSERT_NULL(mbed_heap_alloc(FAST_SIZE, MBED_HEAP_FAST));
+
+    if (!main_heap_has(MBED_HEAP_DMA)) {
+        // too large for the fast region, so it goes to the next with the attribute
+        void *dma = mbed_heap_memalign(64, FAST_SIZE, MBED_HEAP_DMA);
+        TEST_ASSERT(in_region(dma, dma_mem, sizeof(dma_mem)));
+        TEST_ASSERT_EQUAL(0, (uintptr_t)dma % 64);
+        mbed_heap_free(dma);
+    }
+    if (!main_heap_has(MBED_HEAP_LARGE)) {
+        TEST_ASSERT_NULL(mbed_heap_alloc(16, MBED_HEAP_LARGE));
+    }
+
+    mbed_heap_free(fast);
+    mbed_heap_free(fast_dma);
+    TEST_ASSERT_EQUAL(fast_initial, region_free(fast_index));
+    TEST_ASSERT_EQUAL(dma_initial, region_free(dma_index));
+}
+
+void test_main_heap() {
+    void *ptr = mbed_heap_alloc(100, 0);
+    TEST_ASSERT_NOT_NULL(ptr);
+    TEST_ASSERT(!in_region(ptr, fast_mem, sizeof(fast_mem)));
+    TEST_ASSERT(!in_region(ptr, dma_mem, sizeof(dma_mem)));
+    mbed_heap_free(ptr);
+    mbed_heap_free(NULL);
+}
+
+void test_free_realloc() {
+#if defined(TOOLCHAIN_GCC) || defined(TOOLCHAIN_ARM)
+    if (main_heap_has(MBED_HEAP_DMA)) {
+        TEST_IGNORE_MESSAGE("The main heap is DMA memory");
+    }
+    uint32_t fast_initial = region_free(fast_index);
+    uint32_t dma_initial = region_free(dma_index);
+
+    // realloc and free take memory of regions
+    char *ptr = static_cast<char *>(mbed_heap_alloc(64, MBED_HEAP_DMA));
+    TEST_ASSERT(in_region(ptr, fast_mem, sizeof(fast_mem)));
+    memset(ptr, 0x5a, 64);
+    ptr = static_cast<char *>(realloc(ptr, 1024));
+    TEST_ASSERT(in_region(ptr, fast_mem, sizeof(fast_mem)));
+    for (int i = 0; i < 64; i++) {
+        TEST_ASSERT_EQUAL(0x5a, ptr[i]);
+    }
+    // memory only moves to regions with the same attributes
+    TEST_ASSERT_NULL(realloc(ptr, 3000));
+    free(ptr);
+
+    ptr = static_cast<char *>(mbed_heap_alloc(3000, MBED_HEAP_DMA));
+    TEST_ASSERT(in_region(ptr, dma_mem, sizeof(dma_mem)));
+    ptr = static_cast<char *>(realloc(ptr, 100));
+    TEST_ASSERT(in_region(ptr, dma_mem, sizeof(dma_mem)));
+    free(ptr);
+
+    TEST_ASSERT_EQUAL(fast_initial, region_free(fast_index));
+    TEST_ASSERT_EQUAL(dma_initial, region_free(dma_index));
+#else
+    TEST_IGNORE_MESSAGE("free only takes memory of regions with GCC and ARMCC");
+#endif
+}
+
+
+// Test setup
+utest::v1::status_t test_setup(const size_t number_of_cases) {
+    GREENTEA_SETUP(20, "default_auto");
+    return verbose_test_setup_handler(number_of_cases);
+}
+
+Case cases[] = {
+    Case("Testing adding regions", test_add),
+    Case("Testing allocation with attributes", test_attributes),
+    Case("Testing the main heap", test_main_heap),
+    Case("Testing free and realloc of regions", test_free_realloc),
+};
+
+Specification specification(test_setup, cases);
+
+int main() {
+    return !Harness::run(specification);
+}
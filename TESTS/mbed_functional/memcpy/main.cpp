@@ -0,0 +1,121 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "mbed.h"
+#include "platform/mbed_memcpy.h"
+#include "greentea-client/test_env.h"
+#include "unity.h"
+#include "utest.h"
+
+using namespace utest::v1;
+
+#define BUFFER_SIZE     160
+#define MAX_OFFSET      8
+#define MAX_LENGTH      (BUFFER_SIZE - 2 * MAX_OFFSET)
+
+static uint8_t src[BUFFER_SIZE];
+static uint8_t dst[BUFFER_SIZE];
+static uint8_t expected[BUFFER_SIZE];
+
+static void fill_pattern(uint8_t *buf, uint8_t seed) {
+    for (int i = 0; i < BUFFER_SIZE; i++) {
+        buf[i] = (uint8_t)(seed + i * 7);
+    }
+}
+
+
+void test_memcpy() {
+    fill_pattern(src, 1);
+    for (int d = 0; d < MAX_OFFSET; d++) {
+        for (int s = 0; s < MAX_OFFSET; s++) {
+            for (int n = 0; n < MAX_LENGTH; n++) {
+                fill_pattern(dst, 0x80);
+                fill_pattern(expected, 0x80);
+                for (int i = 0; i < n; i++) {
+                    expected[d + i] = src[s + i];
+                }
+                TEST_ASSERT_EQUAL_PTR(dst + d, mbed_memcpy(dst + d, src + s, n));
+                TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, dst, BUFFER_SIZE);
+            }
+        }
+    }
+}
+
+void test_memmove() {
+    for (int d = 0; d < 2 * MAX_OFFSET; d++) {
+        for (int s = 0; s < 2 * MAX_OFFSET; s++) {
+            for (int n = 0; n < MAX_LENGTH; n += 3) {
+                fill_pattern(dst, 3);
+                fill_pattern(expected, 3);
+                for (int i = 0; i < n; i++) {
+                    expected[d + i] = (uint8_t)(3 + (s + i) * 7);
+                }
+                TEST_ASSERT_EQUAL_PTR(dst + d, mbed_memmove(dst + d, dst + s, n));
+                TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, dst, BUFFER_SIZE);
+            }
+        }
+    }
+}
+
+void test_memset() {
+    for (int d = 0; d < MAX_OFFSET; d++) {
+        for (int n = 0; n < MAX_LENGTH; n++) {
+            fill_pattern(dst, 5);
+            fill_pattern(expected, 5);
+            for (int i = 0; i < n; i++) {
+                expected[d + i] = 0xA5;
+            }
+            TEST_ASSERT_EQUAL_PTR(dst + d, mbed_memset(dst + d, 0x1A5, n));
+            TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, dst, BUFFER_SIZE);
+        }
+    }
+}
+
+// Both copies of a block, so that their times can be compared in the log
+void test_copy_speed() {
+    Timer timer;
+    timer.start();
+    for (int i = 0; i < 1000; i++) {
+        mbed_memcpy(dst + 1, src + 2, MAX_LENGTH);
+    }
+    int mbed_time = timer.read_us();
+    timer.reset();
+    for (int i = 0; i < 1000; i++) {
+        memcpy(dst + 1, src + 2, MAX_LENGTH);
+    }
+    int libc_time = timer.read_us();
+    printf("1000 unaligned copies of %d bytes: mbed_memcpy %d us, memcpy %d us\r\n",
+           MAX_LENGTH, mbed_time, libc_time);
+}
+
+
+// Test setup
+utest::v1::status_t test_setup(const size_t number_of_cases) {
+    GREENTEA_SETUP(30, "default_auto");
+    return verbose_test_setup_handler(number_of_cases);
+}
+
+Case cases[] = {
+    Case("Testing mbed_memcpy", test_memcpy),
+    Case("Testing mbed_memmove", test_memmove),
+    Case("Testing mbed_memset", test_memset),
+    Case("Testing copy speed", test_copy_speed),
+};
+
+Specification specification(test_setup, cases);
+
+int main() {
+    return !Harness::run(specification);
+}
@@ -0,0 +1,120 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "mbed.h"
+#include "platform/mbed_printf.h"
+#include "greentea-client/test_env.h"
+#include "unity.h"
+#include "utest.h"
+
+using namespace utest::v1;
+
+static char buffer[128];
+
+#define TEST_FORMAT(expected, ...) do {                                         \
+        int count = mbed_snprintf(buffer, sizeof(buffer), __VA_ARGS__);         \
+        TEST_ASSERT_EQUAL_STRING(expected, buffer);                             \
+        TEST_ASSERT_EQUAL(strlen(expected), count);                             \
+    } while (0)
+
+
+void test_integers() {
+    TEST_FORMAT("0 -5 42", "%d %i %u", 0, -5, 42u);
+    TEST_FORMAT("   42|42   |00042|+42| 42", "%5d|%-5d|%05d|%+d|% d", 42, 42, 42, 42, 42);
+    TEST_FORMAT("007|    -007|  007", "%.3d|%8.3d|%*.3d", 7, -7, 5, 7);
+    TEST_FORMAT("ff FF 0xff 010 0", "%x %X %#x %#o %o", 255u, 255u, 255u, 8u, 0u);
+    TEST_FORMAT("|0", "%.0d|%#.0o", 0, 0u);
+    TEST_FORMAT("-3 -300 -70000", "%hhd %hd %ld", -3, -300, -70000L);
+    TEST_FORMAT("-5000000000 18446744073709551615", "%lld %llu", -5000000000LL, 18446744073709551615ULL);
+    TEST_FORMAT("123456789abcdef", "%llx", 0x123456789abcdefULL);
+    TEST_FORMAT("77 -9", "%zu %td", (size_t)77, (ptrdiff_t)-9);
+    TEST_FORMAT("0x1234", "%p", (void *)0x1234);
+}
+
+void test_strings() {
+    TEST_FORMAT("abc|       abc|abc       |ab", "%s|%10s|%-10s|%.2s", "abc", "abc", "abc", "abc");
+    TEST_FORMAT("    xy|xy    |x", "%*s|%-*s|%.*s", 6, "xy", 6, "xy", 1, "xy");
+    TEST_FORMAT("(null)", "%s", (const char *)NULL);
+    TEST_FORMAT("a|  b|c  |", "%c|%3c|%-3c|", 'a', 'b', 'c');
+    TEST_FORMAT("100%", "100%%");
+}
+
+void test_floating_point() {
+#if MBED_CONF_PLATFORM_MINIMAL_PRINTF_FLOATING_POINT
+    TEST_FORMAT("3.141590 2.35 2 2.", "%f %.2f %.0f %#.0f", 3.14159, 2.345, 2.5, 2.0);
+    TEST_FORMAT("    -1.500|-00001.500|+1.000000", "%10.3f|%010.3f|%+f", -1.5, -1.5, 1.0);
+    TEST_FORMAT("1.234568e+04 1.23e-04 1E+100", "%e %.2e %.0E", 12345.678, 0.000123, 1e100);
+    TEST_FORMAT("0.0001 100000 1e+06 1e-05 123.456", "%g %g %g %g %g", 0.0001, 100000.0, 1000000.0, 1e-5, 123.456);
+    TEST_FORMAT("inf -inf nan", "%f %f %f", INFINITY, -INFINITY, NAN);
+    // Exact ties go to even, values just off a tie round on their exact digits
+    TEST_FORMAT("0.12 0.38 0 2", "%.2f %.2f %.0f %.0f", 0.125, 0.375, 0.5, 1.5);
+    TEST_FORMAT("0.14 1.00 2.67 0.3 0.01", "%.2f %.2f %.2f %.1f %.2f", 0.145, 1.005, 2.675, 0.35, 0.005);
+    // 2^64 and more stay in fixed point, with the digits of the binary value
+    TEST_FORMAT("18446744073709551616.000000", "%f", 18446744073709551616.0);
+    TEST_FORMAT("-123456789012345677877719597056.0", "%.1f", -123456789012345678901234567890.0);
+    TEST_FORMAT("10000000000000000159028911097599180468360808563945281389781327557747838772170381060813469985856815104",
+                "%.0f", 1e100);
+    TEST_FORMAT("20000000000000000000", "%.25g", 2e19);
+    // The sign of negative zero is kept
+    TEST_FORMAT("-0.000000 -0 -0e+00 +0", "%f %+g %.0e %+g", -0.0, -0.0, -0.0, 0.0);
+    // Exponents are found with a single scaling, so near ties round right
+    TEST_FORMAT("9.999999e-05 8.578324e+09 1.70e+03", "%e %e %.2e", 0.000099999995, 8578323500.0, 1695.0);
+#else
+    // Skipped and printed as they are, the arguments after them still work
+    TEST_FORMAT("%f 1 %.2e 2", "%f %d %.2e %d", 1.0, 1, 2.0, 2);
+#endif
+}
+
+void test_truncation() {
+    char small[5];
+    TEST_ASSERT_EQUAL(8, mbed_snprintf(small, sizeof(small), "%s", "abcdefgh"));
+    TEST_ASSERT_EQUAL_STRING("abcd", small);
+
+    small[0] = 'x';
+    TEST_ASSERT_EQUAL(3, mbed_snprintf(small, 0, "abc"));
+    TEST_ASSERT_EQUAL('x', small[0]);
+
+    // Longer than a chunk of the output buffer
+    char line[100];
+    memset(line, 'z', sizeof(line) - 1);
+    line[sizeof(line) - 1] = '\0';
+    TEST_FORMAT(line, "%s", line);
+}
+
+void test_stdout() {
+    int count = mbed_printf("mbed_printf %d %s\r\n", 42, "ok");
+    TEST_ASSERT_EQUAL(strlen("mbed_printf 42 ok\r\n"), count);
+}
+
+
+// Test setup
+utest::v1::status_t test_setup(const size_t number_of_cases) {
+    GREENTEA_SETUP(20, "default_auto");
+    return verbose_test_setup_handler(number_of_cases);
+}
+
+Case cases[] = {
+    Case("Testing integer conversions", test_integers),
+    Case("Testing string conversions", test_strings),
+    Case("Testing floating point conversions", test_floating_point),
+    Case("Testing truncation", test_truncation),
+    Case("Testing stdout", test_stdout),
+};
+
+Specification specification(test_setup, cases);
+
+int main() {
+    return !Harness::run(specification);
+}
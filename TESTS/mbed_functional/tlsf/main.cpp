@@ -0,0 +1,192 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "mbed.h"
+#include "platform/mbed_tlsf.h"
+#include "greentea-client/test_env.h"
+#include "unity.h"
+#include "utest.h"
+
+using namespace utest::v1;
+
+#define POOL_SIZE       8192
+#define STRESS_BLOCKS   32
+#define STRESS_ROUNDS   5000
+
+static mbed_tlsf_t tlsf;
+static uint64_t pool[POOL_SIZE / sizeof(uint64_t)];
+
+static void pool_setup(size_t size) {
+    mbed_tlsf_init(&tlsf);
+    TEST_ASSERT_EQUAL(0, mbed_tlsf_add_pool(&tlsf, pool, size));
+}
+
+static uint32_t free_size() {
+    uint32_t size, count, largest;
+    mbed_tlsf_stats(&tlsf, &size, &count, &largest);
+    return size;
+}
+
+static uint32_t free_count() {
+    uint32_t size, count, largest;
+    mbed_tlsf_stats(&tlsf, &size, &count, &largest);
+    return count;
+}
+
+
+void test_malloc_free() {
+    pool_setup(POOL_SIZE);
+    uint32_t initial = free_size();
+    TEST_ASSERT(initial >= POOL_SIZE - MBED_TLSF_POOL_OVERHEAD);
+    TEST_ASSERT_EQUAL(1, free_count());
+
+    void *a = mbed_tlsf_malloc(&tlsf, 100);
+    void *b = mbed_tlsf_malloc(&tlsf, 200);
+    void *c = mbed_tlsf_malloc(&tlsf, 0);
+    TEST_ASSERT(a != NULL && b != NULL && c != NULL);
+    TEST_ASSERT_EQUAL(0, (uintptr_t)a % 8);
+    TEST_ASSERT(mbed_tlsf_block_size(a) >= 100);
+    TEST_ASSERT_NULL(mbed_tlsf_malloc(&tlsf, POOL_SIZE));
+
+    // freed neighbours merge back into one block
+    mbed_tlsf_free(&tlsf, b);
+    mbed_tlsf_free(&tlsf, a);
+    mbed_tlsf_free(&tlsf, c);
+    TEST_ASSERT_EQUAL(initial, free_size());
+    TEST_ASSERT_EQUAL(1, free_count());
+}
+
+void test_realloc() {
+    pool_setup(POOL_SIZE);
+    uint32_t initial = free_size();
+
+    char *a = static_cast<char *>(mbed_tlsf_malloc(&tlsf, 64));
+    memset(a, 0x5a, 64);
+    // grows in place into the free space after it
+    TEST_ASSERT_EQUAL_PTR(a, mbed_tlsf_realloc(&tlsf, a, 1024));
+    void *b = mbed_tlsf_malloc(&tlsf, 16);
+    TEST_ASSERT_EQUAL_PTR(a, mbed_tlsf_realloc(&tlsf, a, 32));
+
+    // moves when the next block is used
+    char *moved = static_cast<char *>(mbed_tlsf_realloc(&tlsf, a, 2048));
+    TEST_ASSERT(moved != NULL && moved != a);
+    for (int i = 0; i < 32; i++) {
+        TEST_ASSERT_EQUAL(0x5a, moved[i]);
+    }
+
+    TEST_ASSERT_NULL(mbed_tlsf_realloc(&tlsf, moved, 0));
+    mbed_tlsf_free(&tlsf, b);
+    TEST_ASSERT_EQUAL(initial, free_size());
+}
+
+void test_memalign() {
+    pool_setup(POOL_SIZE);
+    uint32_t initial = free_size();
+
+    void *blocks[6];
+    for (int i = 0; i < 6; i++) {
+        size_t align = 16 << i;
+        blocks[i] = mbed_tlsf_memalign(&tlsf, align, 24);
+        TEST_ASSERT(blocks[i] != NULL);
+        TEST_ASSERT_EQUAL(0, (uintptr_t)blocks[i] % align);
+    }
+    for (int i = 0; i < 6; i++) {
+        mbed_tlsf_free(&tlsf, blocks[i]);
+    }
+    TEST_ASSERT_EQUAL(initial, free_size());
+}
+
+void test_pool_growth() {
+    // a pool continuing the last one is merged with it
+    pool_setup(POOL_SIZE / 2);
+    uint32_t half = free_size();
+    TEST_ASSERT_EQUAL(0, mbed_tlsf_add_pool(&tlsf, (char *)pool + POOL_SIZE / 2, POOL_SIZE / 2));
+    TEST_ASSERT_EQUAL(1, free_count());
+    TEST_ASSERT_EQUAL(half + POOL_SIZE / 2, free_size());
+    TEST_ASSERT(mbed_tlsf_malloc(&tlsf, POOL_SIZE * 3 / 4) != NULL);
+
+    TEST_ASSERT_EQUAL(-1, mbed_tlsf_add_pool(&tlsf, pool, 8));
+}
+
+void test_pool_size() {
+    // a pool of the given size holds the allocation, whatever its size class
+    const size_t sizes[] = { 1, 100, 1000, 4000, 5000 };
+    for (size_t align = 0; align <= 256; align = align ? align * 4 : 16) {
+        for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+            size_t size = mbed_tlsf_pool_size(align, sizes[i]);
+            TEST_ASSERT(size >= sizes[i] && size <= POOL_SIZE);
+            pool_setup(size);
+            TEST_ASSERT(mbed_tlsf_memalign(&tlsf, align, sizes[i]) != NULL);
+        }
+    }
+
+    TEST_ASSERT_EQUAL(0, mbed_tlsf_pool_size(0, (size_t)1 << MBED_TLSF_FL_MAX));
+}
+
+void test_stress() {
+    static uint8_t *blocks[STRESS_BLOCKS];
+    static size_t sizes[STRESS_BLOCKS];
+    pool_setup(POOL_SIZE);
+    uint32_t initial = free_size();
+    memset(blocks, 0, sizeof(blocks));
+
+    uint32_t seed = 1;
+    for (int round = 0; round < STRESS_ROUNDS; round++) {
+        seed = seed * 1103515245 + 12345;
+        int i = (seed >> 16) % STRESS_BLOCKS;
+        size_t size = (seed >> 8) % 400;
+        if (blocks[i]) {
+            for (size_t j = 0; j < sizes[i]; j++) {
+                TEST_ASSERT_EQUAL(i, blocks[i][j]);
+            }
+            mbed_tlsf_free(&tlsf, blocks[i]);
+            blocks[i] = NULL;
+        } else {
+            blocks[i] = static_cast<uint8_t *>(mbed_tlsf_malloc(&tlsf, size));
+            if (blocks[i]) {
+                sizes[i] = size;
+                memset(blocks[i], i, size);
+            }
+        }
+    }
+
+    for (int i = 0; i < STRESS_BLOCKS; i++) {
+        mbed_tlsf_free(&tlsf, blocks[i]);
+    }
+    TEST_ASSERT_EQUAL(initial, free_size());
+    TEST_ASSERT_EQUAL(1, free_count());
+}
+
+
+// Test setup
+utest::v1::status_t test_setup(const size_t number_of_cases) {
+    GREENTEA_SETUP(20, "default_auto");
+    return verbose_test_setup_handler(number_of_cases);
+}
+
+Case cases[] = {
+    Case("Testing malloc and free", test_malloc_free),
+    Case("Testing realloc", test_realloc),
+    Case("Testing memalign", test_memalign),
+    Case("Testing contiguous pools", test_pool_growth),
+    Case("Testing pool sizes", test_pool_size),
+    Case("Testing random allocations", test_stress),
+};
+
+Specification specification(test_setup, cases);
+
+int main() {
+    return !Harness::run(specification);
+}
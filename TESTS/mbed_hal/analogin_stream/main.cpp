@@ -0,0 +1,100 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#if !DEVICE_ANALOGIN || !DEVICE_ANALOGIN_ASYNCH
+#error [NOT_SUPPORTED] Analog input streaming not supported for this target
+#endif
+
+#include "utest/utest.h"
+#include "unity/unity.h"
+#include "greentea-client/test_env.h"
+
+#include "mbed.h"
+
+using namespace utest::v1;
+
+#define SAMPLE_RATE_HZ  10000
+#define BUFFER_LENGTH   256
+#define RUN_MS          500
+
+MBED_DCACHE_ALIGNED static uint16_t samples[BUFFER_LENGTH];
+static volatile int halves;
+static volatile int overruns;
+static volatile int wrong_half;
+static AnalogInStream *current;
+
+void count_halves(int event) {
+    if (event & ANALOGIN_EVENT_OVERRUN) {
+        overruns++;
+    }
+    const uint16_t *half = current->half(event);
+    if (half != samples && half != samples + BUFFER_LENGTH / 2) {
+        wrong_half++;
+    }
+    halves++;
+}
+
+void test_sample_rate() {
+    AnalogInStream adc(A0);
+    current = &adc;
+    halves = 0;
+    overruns = 0;
+    wrong_half = 0;
+
+    TEST_ASSERT_EQUAL(0, adc.start(samples, BUFFER_LENGTH, SAMPLE_RATE_HZ, count_halves, ANALOGIN_EVENT_ALL));
+    TEST_ASSERT_TRUE(adc.active());
+    TEST_ASSERT_EQUAL(-1, adc.start(samples, BUFFER_LENGTH, SAMPLE_RATE_HZ, count_halves));
+    wait_ms(RUN_MS);
+    adc.stop();
+    TEST_ASSERT_FALSE(adc.active());
+
+    // each half holds BUFFER_LENGTH / 2 samples
+    int expected = SAMPLE_RATE_HZ * RUN_MS / 1000 / (BUFFER_LENGTH / 2);
+    TEST_ASSERT_INT_WITHIN(expected / 10 + 1, expected, halves);
+    TEST_ASSERT_EQUAL(0, overruns);
+    TEST_ASSERT_EQUAL(0, wrong_half);
+}
+
+void test_invalid_length() {
+    AnalogInStream adc(A0);
+    TEST_ASSERT_EQUAL(-1, adc.start(samples, 0, SAMPLE_RATE_HZ, count_halves));
+    TEST_ASSERT_EQUAL(-1, adc.start(samples, BUFFER_LENGTH - 1, SAMPLE_RATE_HZ, count_halves));
+#if MBED_DCACHE_PRESENT
+    // halves sharing cache lines with other data are refused
+    TEST_ASSERT_EQUAL(-1, adc.start(samples + 1, BUFFER_LENGTH - 2, SAMPLE_RATE_HZ, count_halves));
+#endif
+    TEST_ASSERT_FALSE(adc.active());
+}
+
+utest::v1::status_t greentea_failure_handler(const Case *const source, const failure_t reason) {
+    greentea_case_failure_abort_handler(source, reason);
+    return STATUS_CONTINUE;
+}
+
+Case cases[] = {
+    Case("Stream runs at the sample rate", test_sample_rate, greentea_failure_handler),
+    Case("Stream rejects odd buffers", test_invalid_length, greentea_failure_handler),
+};
+
+utest::v1::status_t greentea_test_setup(const size_t number_of_cases) {
+    GREENTEA_SETUP(20, "default_auto");
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+Specification specification(greentea_test_setup, cases, greentea_test_teardown_handler);
+
+int main() {
+    Harness::run(specification);
+}
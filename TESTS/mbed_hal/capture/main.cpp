@@ -0,0 +1,98 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#if !DEVICE_CAPTURE || !DEVICE_PWMOUT
+#error [NOT_SUPPORTED] Input capture not supported for this target
+#endif
+
+#if !defined(MBED_CONF_APP_CAPTURE_OUT) || !defined(MBED_CONF_APP_CAPTURE_IN)
+#error [NOT_SUPPORTED] Connect a PwmOut pin to a capture pin and set capture-out and capture-in
+#endif
+
+#include "utest/utest.h"
+#include "unity/unity.h"
+#include "greentea-client/test_env.h"
+
+#include "mbed.h"
+
+using namespace utest::v1;
+
+#define PERIOD_US       100
+#define PULSE_US        25
+#define RUN_MS          100
+
+void test_frequency() {
+    PwmOut pwm(MBED_CONF_APP_CAPTURE_OUT);
+    pwm.period_us(PERIOD_US);
+    pwm.pulsewidth_us(PULSE_US);
+    InputCapture capture(MBED_CONF_APP_CAPTURE_IN);
+
+    wait_ms(RUN_MS);
+    capture.frequency();
+    capture.reset();
+    wait_ms(RUN_MS);
+
+    float expected = 1000000.0f / PERIOD_US;
+    TEST_ASSERT_FLOAT_WITHIN(expected / 100, expected, capture.frequency());
+    TEST_ASSERT_FLOAT_WITHIN(0.02f, (float)PULSE_US / PERIOD_US, capture.duty_cycle());
+    TEST_ASSERT_UINT32_WITHIN(2, RUN_MS * 1000 / PERIOD_US, capture.count());
+
+    uint32_t ticks_per_period = (uint64_t)capture.tick_frequency() * PERIOD_US / 1000000;
+    TEST_ASSERT_UINT32_WITHIN(ticks_per_period / 100 + 1, ticks_per_period, capture.period_ticks());
+}
+
+void test_buffer() {
+    PwmOut pwm(MBED_CONF_APP_CAPTURE_OUT);
+    pwm.period_us(PERIOD_US);
+    pwm.pulsewidth_us(PULSE_US);
+    InputCapture capture(MBED_CONF_APP_CAPTURE_IN);
+
+    wait_ms(RUN_MS);
+    TEST_ASSERT_EQUAL(MBED_CONF_DRIVERS_INPUT_CAPTURE_BUFFER_SIZE - 1, capture.available());
+    TEST_ASSERT_TRUE(capture.dropped() > 0);
+
+    // the buffered edges alternate and are spaced by the pulse and the rest of the period
+    InputCapture::Edge edges[MBED_CONF_DRIVERS_INPUT_CAPTURE_BUFFER_SIZE];
+    int n = capture.read(edges, MBED_CONF_DRIVERS_INPUT_CAPTURE_BUFFER_SIZE);
+    TEST_ASSERT_EQUAL(MBED_CONF_DRIVERS_INPUT_CAPTURE_BUFFER_SIZE - 1, n);
+    TEST_ASSERT_EQUAL(0, capture.available());
+    uint32_t ticks_per_period = (uint64_t)capture.tick_frequency() * PERIOD_US / 1000000;
+    for (int i = 2; i < n; i++) {
+        TEST_ASSERT_TRUE(edges[i].rising != edges[i - 1].rising);
+        TEST_ASSERT_UINT32_WITHIN(ticks_per_period / 100 + 1, ticks_per_period,
+                                  edges[i].timestamp - edges[i - 2].timestamp);
+    }
+}
+
+utest::v1::status_t greentea_failure_handler(const Case *const source, const failure_t reason) {
+    greentea_case_failure_abort_handler(source, reason);
+    return STATUS_CONTINUE;
+}
+
+Case cases[] = {
+    Case("Capture measures a PWM signal", test_frequency, greentea_failure_handler),
+    Case("Capture buffers edges", test_buffer, greentea_failure_handler),
+};
+
+utest::v1::status_t greentea_test_setup(const size_t number_of_cases) {
+    GREENTEA_SETUP(20, "default_auto");
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+Specification specification(greentea_test_setup, cases, greentea_test_teardown_handler);
+
+int main() {
+    Harness::run(specification);
+}
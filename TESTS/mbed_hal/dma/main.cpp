@@ -0,0 +1,115 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "utest/utest.h"
+#include "unity/unity.h"
+#include "greentea-client/test_env.h"
+
+#include "mbed.h"
+#include "dma_api.h"
+
+using namespace utest::v1;
+
+#define COPY_SIZE   1024
+#define MAX_CHANNELS 32
+
+static uint8_t src[COPY_SIZE];
+static uint8_t dst[COPY_SIZE];
+static volatile int completed_event;
+
+static void fill_buffers() {
+    for (int i = 0; i < COPY_SIZE; i++) {
+        src[i] = (uint8_t)(i * 7 + 3);
+        dst[i] = 0;
+    }
+}
+
+static void copy_done(int channelid, int event, void *context) {
+    (void)channelid;
+    *(volatile int *)context = event;
+}
+
+void dma_test_memcpy_blocking() {
+    fill_buffers();
+    TEST_ASSERT_EQUAL(0, dma_memcpy(dst, src, COPY_SIZE, NULL, NULL));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(src, dst, COPY_SIZE);
+}
+
+void dma_test_memcpy_async() {
+    fill_buffers();
+    completed_event = 0;
+    TEST_ASSERT_EQUAL(0, dma_memcpy(dst, src, COPY_SIZE, copy_done, (void *)&completed_event));
+
+    Timer timer;
+    timer.start();
+    while (!completed_event && timer.read_ms() < 1000);
+
+    TEST_ASSERT_EQUAL(DMA_EVENT_COMPLETE, completed_event);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(src, dst, COPY_SIZE);
+}
+
+void dma_test_channel_allocation() {
+    int channels[MAX_CHANNELS];
+    int count = 0;
+
+    while (count < MAX_CHANNELS) {
+        int channelid = dma_channel_allocate(0);
+        if (channelid == DMA_ERROR_OUT_OF_CHANNELS) {
+            break;
+        }
+        TEST_ASSERT(channelid >= 0);
+        for (int i = 0; i < count; i++) {
+            TEST_ASSERT_NOT_EQUAL(channels[i], channelid);
+        }
+        channels[count++] = channelid;
+    }
+
+    for (int i = 0; i < count; i++) {
+        TEST_ASSERT_EQUAL(0, dma_channel_free(channels[i]));
+    }
+
+    // every channel is available again once freed
+    int again = 0;
+    while (again < count) {
+        int channelid = dma_channel_allocate(0);
+        if (channelid < 0) {
+            break;
+        }
+        channels[again++] = channelid;
+    }
+    TEST_ASSERT_EQUAL(count, again);
+
+    for (int i = 0; i < again; i++) {
+        dma_channel_free(channels[i]);
+    }
+}
+
+Case cases[] = {
+    Case("DMA - blocking memcpy", dma_test_memcpy_blocking),
+    Case("DMA - memcpy with completion handler", dma_test_memcpy_async),
+    Case("DMA - channel allocation", dma_test_channel_allocation),
+};
+
+utest::v1::status_t greentea_test_setup(const size_t number_of_cases) {
+    GREENTEA_SETUP(20, "default_auto");
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+Specification specification(greentea_test_setup, cases, greentea_test_teardown_handler);
+
+int main() {
+    Harness::run(specification);
+}
@@ -0,0 +1,334 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "utest/utest.h"
+#include "unity/unity.h"
+#include "greentea-client/test_env.h"
+
+#include "mbed.h"
+#include "TimerEvent.h"
+
+using namespace utest::v1;
+
+/* Results are sent to the benchmark_report host test as "bench" key-value
+ * pairs, formatted as "<name>,<unit>,<min>,<avg>,<max>", which collects
+ * them per target.
+ *
+ * To measure GPIO interrupt latency, connect two pins and set them in
+ * mbed_app.json as irq-latency-out and irq-latency-in.
+ */
+
+#define SAMPLES             64
+#define CALLS               1000
+#define TICKER_DELAY_US     1000
+#define SLEEP_DELAY_US      10000
+
+/* Timestamps come from the DWT cycle counter where the core has one, and
+ * from the us ticker otherwise, and are converted to nanoseconds.
+ */
+static bool cycle_counter;
+
+static void stamp_init()
+{
+#ifdef DWT
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    if (!(DWT->CTRL & DWT_CTRL_NOCYCCNT_Msk)) {
+        DWT->CYCCNT = 0;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+        cycle_counter = true;
+    }
+#endif
+}
+
+static inline uint32_t stamp()
+{
+#ifdef DWT
+    if (cycle_counter) {
+        return DWT->CYCCNT;
+    }
+#endif
+    return us_ticker_read();
+}
+
+static uint32_t stamp_to_ns(uint32_t delta)
+{
+    if (cycle_counter) {
+        return (uint64_t)delta * 1000000000 / SystemCoreClock;
+    }
+    return delta * 1000;
+}
+
+static volatile uint32_t irq_stamp;
+static volatile bool irq_done;
+
+static void stamp_handler()
+{
+    irq_stamp = stamp();
+    irq_done = true;
+}
+
+/* A timer event that fires straight away, so the us ticker interrupt
+ * is raised with fire_interrupt rather than a compare match */
+class ImmediateEvent : public TimerEvent {
+public:
+    void fire()
+    {
+        insert_absolute(ticker_read_us(_ticker_data));
+    }
+
+protected:
+    virtual void handler()
+    {
+        stamp_handler();
+    }
+};
+
+class Target {
+public:
+    void method()
+    {
+        count++;
+    }
+
+    volatile uint32_t count;
+};
+
+static volatile uint32_t function_count;
+
+static void function()
+{
+    function_count++;
+}
+
+static void call_function_pointer(void *p)
+{
+    (*(void (*volatile *)())p)();
+}
+
+static void call_callback(void *p)
+{
+    (*(Callback<void()> *)p)();
+}
+
+static void wait_irq()
+{
+    Timer timeout;
+    timeout.start();
+    while (!irq_done && timeout.read_ms() < 100);
+    TEST_ASSERT_TRUE(irq_done);
+}
+
+/** Measure ticker interrupt dispatch
+
+    Given a timer event inserted at the current time
+    When the us ticker interrupt fires and dispatches it
+    Then the time from the insert to the event handler is reported
+ */
+void test_ticker_irq_dispatch()
+{
+    bench_result_t r;
+    bench_reset(&r);
+
+    ImmediateEvent event;
+    for (uint32_t i = 0; i < SAMPLES; i++) {
+        irq_done = false;
+        uint32_t start = stamp();
+        event.fire();
+        wait_irq();
+        bench_add(&r, stamp_to_ns(irq_stamp - start));
+    }
+
+    bench_report("ticker_irq_dispatch", "ns", &r);
+}
+
+/** Measure callback dispatch overhead
+
+    Given a plain function pointer, a Callback to a function, a Callback to
+    a method and a CThunk to a method
+    When each is called many times in a row
+    Then the cost of one call through each is reported
+ */
+void test_callback_overhead()
+{
+    Target target;
+    void (*volatile direct)() = function;
+    Callback<void()> function_callback(function);
+    Callback<void()> method_callback(&target, &Target::method);
+    CThunk<Target> thunk(&target, &Target::method);
+    void (*volatile thunk_entry)() = (void (*)())thunk.entry();
+
+    struct {
+        const char *name;
+        void (*call)(void *);
+        void *context;
+    } cases[] = {
+        { "call_direct", call_function_pointer, (void *)&direct },
+        { "call_callback_function", call_callback, &function_callback },
+        { "call_callback_method", call_callback, &method_callback },
+        { "call_cthunk", call_function_pointer, (void *)&thunk_entry },
+    };
+
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+        bench_result_t r;
+        bench_reset(&r);
+        for (uint32_t i = 0; i < SAMPLES / 8; i++) {
+            uint32_t start = stamp();
+            for (uint32_t j = 0; j < CALLS; j++) {
+                cases[c].call(cases[c].context);
+            }
+            bench_add(&r, stamp_to_ns(stamp() - start) / CALLS);
+        }
+        bench_report(cases[c].name, "ns", &r);
+    }
+
+    TEST_ASSERT_EQUAL(CALLS * (SAMPLES / 8) * 2, function_count);
+}
+
+#if defined(MBED_CONF_APP_IRQ_LATENCY_OUT) && defined(MBED_CONF_APP_IRQ_LATENCY_IN)
+/** Measure GPIO interrupt latency
+
+    Given an output pin connected to an InterruptIn
+    When the output is raised
+    Then the time until the rise callback runs is reported
+ */
+void test_gpio_irq_latency()
+{
+    bench_result_t r;
+    bench_reset(&r);
+
+    DigitalOut out(MBED_CONF_APP_IRQ_LATENCY_OUT, 0);
+    InterruptIn in(MBED_CONF_APP_IRQ_LATENCY_IN);
+    in.rise(stamp_handler);
+
+    for (uint32_t i = 0; i < SAMPLES; i++) {
+        irq_done = false;
+        uint32_t start = stamp();
+        out = 1;
+        wait_irq();
+        bench_add(&r, stamp_to_ns(irq_stamp - start));
+        out = 0;
+        wait_us(100);
+    }
+
+    in.rise(NULL);
+    bench_report("gpio_irq_latency", "ns", &r);
+}
+#endif
+
+static volatile uint32_t timeout_stamp;
+
+static void timeout_handler()
+{
+    timeout_stamp = us_ticker_read();
+    irq_done = true;
+}
+
+/** Measure ticker interrupt accuracy
+
+    Given a Timeout attached some time ahead
+    When it fires
+    Then how late its handler runs is reported
+ */
+void test_ticker_accuracy()
+{
+    bench_result_t r;
+    bench_reset(&r);
+
+    Timeout timeout;
+    for (uint32_t i = 0; i < SAMPLES; i++) {
+        irq_done = false;
+        uint32_t deadline = us_ticker_read() + TICKER_DELAY_US;
+        timeout.attach_us(timeout_handler, TICKER_DELAY_US);
+        wait_irq();
+        int32_t late = (int32_t)(timeout_stamp - deadline);
+        bench_add(&r, late > 0 ? late : 0);
+    }
+
+    bench_report("ticker_lateness", "us", &r);
+}
+
+#if DEVICE_LOWPOWERTIMER && DEVICE_SLEEP
+static volatile us_timestamp_t wakeup_stamp;
+
+static void wakeup_handler()
+{
+    wakeup_stamp = ticker_read_us(get_lp_ticker_data());
+    irq_done = true;
+}
+
+/** Measure wakeup from deep sleep
+
+    Given a LowPowerTimeout attached while nothing holds the deep sleep lock
+    When the target sleeps until it fires
+    Then the time from its deadline to its handler is reported
+ */
+void test_deep_sleep_wakeup()
+{
+    bench_result_t r;
+    bench_reset(&r);
+
+    // let the console finish sending before it stops in deep sleep
+    wait_ms(20);
+    TEST_ASSERT_TRUE_MESSAGE(sleep_manager_can_deep_sleep(), "deep sleep is locked");
+
+    LowPowerTimeout timeout;
+    for (uint32_t i = 0; i < SAMPLES / 4; i++) {
+        irq_done = false;
+        us_timestamp_t deadline = ticker_read_us(get_lp_ticker_data()) + SLEEP_DELAY_US;
+        timeout.attach_us(wakeup_handler, SLEEP_DELAY_US);
+        while (!irq_done) {
+            sleep();
+        }
+        int64_t late = (int64_t)(wakeup_stamp - deadline);
+        bench_add(&r, late > 0 ? (uint32_t)late : 0);
+    }
+
+    bench_report("deep_sleep_wakeup", "us", &r);
+}
+#endif
+
+utest::v1::status_t greentea_failure_handler(const Case *const source, const failure_t reason)
+{
+    greentea_case_failure_abort_handler(source, reason);
+    return STATUS_CONTINUE;
+}
+
+Case cases[] = {
+    Case("Measure ticker interrupt dispatch", test_ticker_irq_dispatch, greentea_failure_handler),
+    Case("Measure callback dispatch overhead", test_callback_overhead, greentea_failure_handler),
+#if defined(MBED_CONF_APP_IRQ_LATENCY_OUT) && defined(MBED_CONF_APP_IRQ_LATENCY_IN)
+    Case("Measure GPIO interrupt latency", test_gpio_irq_latency, greentea_failure_handler),
+#endif
+    Case("Measure ticker interrupt accuracy", test_ticker_accuracy, greentea_failure_handler),
+#if DEVICE_LOWPOWERTIMER && DEVICE_SLEEP
+    Case("Measure wakeup from deep sleep", test_deep_sleep_wakeup, greentea_failure_handler),
+#endif
+};
+
+utest::v1::status_t greentea_test_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(60, "benchmark_report");
+    stamp_init();
+    greentea_send_kv("bench_clock", (int)SystemCoreClock);
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+Specification specification(greentea_test_setup, cases, greentea_test_teardown_handler);
+
+int main()
+{
+    Harness::run(specification);
+}
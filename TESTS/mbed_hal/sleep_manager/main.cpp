@@ -16,6 +16,7 @@
 #include "utest/utest.h"
 #include "unity/unity.h"
 #include "greentea-client/test_env.h"
+#include "mbed.h"
 
 #if !DEVICE_SLEEP
 #error [NOT_SUPPORTED] test not supported
@@ -37,6 +38,32 @@ void sleep_manager_deepsleep_counter_test()
     TEST_ASSERT_TRUE(deep_sleep_allowed);
 }
 
+#if DEVICE_LOWPOWERTIMER
+void sleep_manager_lowpower_timers_test()
+{
+    TEST_ASSERT_TRUE(sleep_manager_can_deep_sleep());
+
+    // the low power timers keep running in deep sleep
+    LowPowerTimer timer;
+    timer.start();
+    TEST_ASSERT_TRUE(sleep_manager_can_deep_sleep());
+
+    LowPowerTimeout timeout;
+    timeout.attach_us(callback(&timer, &LowPowerTimer::stop), 1000000);
+    TEST_ASSERT_TRUE(sleep_manager_can_deep_sleep());
+
+    timeout.detach();
+    timer.stop();
+
+    // the microsecond ticker does not
+    Timer us_timer;
+    us_timer.start();
+    TEST_ASSERT_FALSE(sleep_manager_can_deep_sleep());
+    us_timer.stop();
+    TEST_ASSERT_TRUE(sleep_manager_can_deep_sleep());
+}
+#endif
+
 utest::v1::status_t greentea_failure_handler(const Case *const source, const failure_t reason) 
 {
     greentea_case_failure_abort_handler(source, reason);
@@ -51,6 +78,9 @@ utest::v1::status_t greentea_test_setup(const size_t number_of_cases)
 
 Case cases[] = {
     Case("sleep manager -  deep sleep counter", sleep_manager_deepsleep_counter_test, greentea_failure_handler),
+#if DEVICE_LOWPOWERTIMER
+    Case("sleep manager -  low power timers", sleep_manager_lowpower_timers_test, greentea_failure_handler),
+#endif
 };
 
 Specification specification(greentea_test_setup, cases, greentea_test_teardown_handler);
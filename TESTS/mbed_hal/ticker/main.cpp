@@ -31,6 +31,10 @@ using namespace utest::v1;
 
 #define TIMESTAMP_MAX_DELTA MBED_TICKER_INTERRUPT_TIMESTAMP_MAX_DELTA
 
+#ifndef MBED_CONF_PLATFORM_TICKER_BATCH_TOLERANCE_US
+#define MBED_CONF_PLATFORM_TICKER_BATCH_TOLERANCE_US 0
+#endif
+
 struct ticker_interface_stub_t { 
     ticker_interface_t interface;
     bool initialized; 
@@ -2038,6 +2042,61 @@ static void test_set_interrupt_past_time_with_delay()
     TEST_ASSERT_EQUAL(1, interface_stub.fire_interrupt_call);
 }
 
+/**
+ * Given an initialized ticker which takes longer to program the interrupt than
+ * the time left before an event.
+ * When the event is inserted and ticker_irq_handler is called.
+ * Then:
+ *   - The interrupt should be fired immediately rather than set.
+ *   - The IRQ handler should run the event although it is not due yet.
+ *   - The interrupt should not be fired again for it.
+ *   - An event further away than the latency should still be scheduled.
+ */
+static void test_irq_handler_event_within_latency()
+{
+    static const timestamp_t set_latency = 50;
+
+    uint32_t handler_call = 0;
+    struct irq_handler_stub_t {
+        static void event_handler(uint32_t id) {
+            ++ (*((uint32_t*) id));
+        }
+    };
+
+    interface_stub.timestamp = 0xAAAAAAAA;
+    ticker_set_handler(&ticker_stub, irq_handler_stub_t::event_handler);
+    queue_stub.set_latency = set_latency;
+    interface_stub.set_interrupt_call = 0;
+    interface_stub.fire_interrupt_call = 0;
+
+    ticker_event_t near_event;
+    ticker_insert_event(
+        &ticker_stub, &near_event, interface_stub.timestamp + set_latency - 1,
+        (uint32_t) &handler_call
+    );
+    TEST_ASSERT_EQUAL(1, interface_stub.fire_interrupt_call);
+    TEST_ASSERT_EQUAL(0, interface_stub.set_interrupt_call);
+
+    ticker_event_t far_event;
+    const timestamp_t far_timestamp = interface_stub.timestamp + 2 * set_latency +
+        MBED_CONF_PLATFORM_TICKER_BATCH_TOLERANCE_US;
+    ticker_insert_event(
+        &ticker_stub, &far_event, far_timestamp, (uint32_t) &handler_call
+    );
+
+    interface_stub.fire_interrupt_call = 0;
+    interface_stub.set_interrupt_call = 0;
+    ticker_irq_handler(&ticker_stub);
+
+    TEST_ASSERT_EQUAL(1, handler_call);
+    TEST_ASSERT_EQUAL_PTR(&far_event, queue_stub.head);
+    TEST_ASSERT_EQUAL(0, interface_stub.fire_interrupt_call);
+    TEST_ASSERT_EQUAL(1, interface_stub.set_interrupt_call);
+    TEST_ASSERT_EQUAL_UINT32(far_timestamp, interface_stub.interrupt_timestamp);
+
+    TEST_ASSERT_EQUAL(0, interface_stub.disable_interrupt_call);
+}
+
 static const case_t cases[] = {
     MAKE_TEST_CASE("ticker initialization", test_ticker_initialization),
     MAKE_TEST_CASE(
@@ -2130,6 +2189,10 @@ static const case_t cases[] = {
     MAKE_TEST_CASE(
         "test_set_interrupt_past_time_with_delay", 
         test_set_interrupt_past_time_with_delay
+    ),
+    MAKE_TEST_CASE(
+        "test_irq_handler_event_within_latency",
+        test_irq_handler_event_within_latency
     )
 };
 
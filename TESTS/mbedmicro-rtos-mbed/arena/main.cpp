@@ -0,0 +1,136 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity.h"
+#include "utest.h"
+#include "rtos.h"
+
+#if defined(MBED_RTOS_SINGLE_THREAD)
+  #error [NOT_SUPPORTED] test not supported
+#endif
+
+using namespace utest::v1;
+
+#define THREAD_STACK_SIZE   512
+#define ARENA_SIZE          256
+#define WORK_ITEMS          10
+
+static uint64_t scratch[ARENA_SIZE / sizeof(uint64_t)];
+
+void work_loop(uint32_t *done)
+{
+    Arena *arena = Thread::arena();
+    TEST_ASSERT_NOT_NULL(arena);
+
+    for (uint32_t i = 0; i < WORK_ITEMS; i++) {
+        Arena::Scope scope(Thread::arena());
+        for (uint32_t j = 0; j < 4; j++) {
+            TEST_ASSERT_NOT_NULL(arena->alloc(ARENA_SIZE / 8));
+        }
+        TEST_ASSERT_EQUAL(ARENA_SIZE / 2, arena->used());
+        (*done)++;
+    }
+
+    TEST_ASSERT_EQUAL(0, arena->used());
+}
+
+/** Test allocations are aligned and released by reset
+
+    Given an arena
+    When odd sized blocks are allocated until it is exhausted
+    Then every block is 8 byte aligned, the failed allocation is counted and reset releases everything
+ */
+void test_alloc_reset(void)
+{
+    Arena arena(scratch, sizeof(scratch));
+
+    while (void *p = arena.alloc(3)) {
+        TEST_ASSERT_EQUAL(0, (uintptr_t)p % 8);
+    }
+    TEST_ASSERT_EQUAL(1, arena.fail_count());
+    TEST_ASSERT_EQUAL(arena.size(), arena.used());
+
+    arena.reset();
+    TEST_ASSERT_EQUAL(0, arena.used());
+    TEST_ASSERT_EQUAL(arena.size(), arena.max_used());
+}
+
+/** Test nested scopes
+
+    Given an arena and two nested scopes
+    When each scope ends
+    Then only the allocations made within it are released
+ */
+void test_scope(void)
+{
+    Arena arena(scratch, sizeof(scratch));
+
+    arena.alloc(8);
+    {
+        Arena::Scope outer(&arena);
+        arena.alloc(8);
+        {
+            Arena::Scope inner(&arena);
+            arena.calloc(16);
+            TEST_ASSERT_EQUAL(32, arena.used());
+        }
+        TEST_ASSERT_EQUAL(16, arena.used());
+    }
+    TEST_ASSERT_EQUAL(8, arena.used());
+}
+
+/** Test an arena attached to a thread
+
+    Given a thread with an attached arena
+    When the thread allocates from Thread::arena in per work item scopes
+    Then it finds its arena and every work item starts with an empty arena
+ */
+void test_thread_arena(void)
+{
+    Arena arena(scratch, sizeof(scratch));
+    uint32_t done = 0;
+
+    TEST_ASSERT_NULL(Thread::arena());
+
+    Thread thread(osPriorityNormal, THREAD_STACK_SIZE);
+    thread.set_arena(&arena);
+    TEST_ASSERT_EQUAL(&arena, thread.get_arena());
+    thread.start(callback(work_loop, &done));
+    thread.join();
+
+    TEST_ASSERT_EQUAL(WORK_ITEMS, done);
+    TEST_ASSERT_EQUAL(ARENA_SIZE / 2, arena.max_used());
+}
+
+utest::v1::status_t test_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(10, "default_auto");
+    return verbose_test_setup_handler(number_of_cases);
+}
+
+Case cases[] = {
+    Case("Test alloc and reset", test_alloc_reset),
+    Case("Test nested scopes", test_scope),
+    Case("Test arena attached to a thread", test_thread_arena),
+};
+
+Specification specification(test_setup, cases);
+
+int main()
+{
+    return !Harness::run(specification);
+}
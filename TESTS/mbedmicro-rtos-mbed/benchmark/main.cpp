@@ -0,0 +1,201 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity.h"
+#include "utest.h"
+#include "rtos.h"
+
+#if defined(MBED_RTOS_SINGLE_THREAD)
+  #error [NOT_SUPPORTED] test not supported
+#endif
+
+using namespace utest::v1;
+
+/* Results are sent to the benchmark_report host test as "bench" key-value
+ * pairs, formatted as "<name>,<unit>,<min>,<avg>,<max>", so they can be
+ * collected and compared between targets and releases.
+ */
+
+#define THREAD_STACK_SIZE   512
+#define SAMPLES             32
+#define BATCH               100
+#define QUEUE_SIZE          16
+#define QUEUE_MSGS          2000
+
+Semaphore ping(0);
+Semaphore pong(0);
+Semaphore wakeup(0);
+volatile bool running;
+volatile uint32_t isr_time;
+
+void yield_loop()
+{
+    while (running) {
+        Thread::yield();
+    }
+}
+
+void pong_loop()
+{
+    while (running) {
+        ping.wait();
+        pong.release();
+    }
+}
+
+void isr_wakeup()
+{
+    isr_time = us_ticker_read();
+    wakeup.release();
+}
+
+void queue_producer(Queue<uint32_t, QUEUE_SIZE> *queue)
+{
+    static uint32_t msg;
+    for (uint32_t i = 0; i < QUEUE_MSGS; i++) {
+        queue->put(&msg, osWaitForever);
+    }
+}
+
+/** Benchmark context switches
+
+    Given two threads of the same priority that yield to each other
+    When the time of a batch of yields is measured
+    Then the time of a single context switch is reported
+ */
+void test_context_switch(void)
+{
+    bench_result_t r;
+    bench_reset(&r);
+
+    running = true;
+    Thread thread(osPriorityNormal, THREAD_STACK_SIZE);
+    TEST_ASSERT_EQUAL(osOK, thread.start(yield_loop));
+
+    for (uint32_t i = 0; i < SAMPLES; i++) {
+        uint32_t start = us_ticker_read();
+        for (uint32_t j = 0; j < BATCH; j++) {
+            Thread::yield();
+        }
+        // every yield switches to the other thread and back
+        bench_add(&r, (uint64_t)(us_ticker_read() - start) * 1000 / (2 * BATCH));
+    }
+
+    running = false;
+    thread.join();
+    bench_report("context_switch", "ns", &r);
+}
+
+/** Benchmark semaphore ping-pong
+
+    Given a thread that releases one semaphore each time another is released
+    When the round trip of a batch of releases is measured
+    Then the latency of one release to wakeup is reported
+ */
+void test_semaphore_ping_pong(void)
+{
+    bench_result_t r;
+    bench_reset(&r);
+
+    running = true;
+    Thread thread(osPriorityNormal, THREAD_STACK_SIZE);
+    TEST_ASSERT_EQUAL(osOK, thread.start(pong_loop));
+
+    for (uint32_t i = 0; i < SAMPLES; i++) {
+        uint32_t start = us_ticker_read();
+        for (uint32_t j = 0; j < BATCH; j++) {
+            ping.release();
+            pong.wait();
+        }
+        bench_add(&r, (uint64_t)(us_ticker_read() - start) * 1000 / (2 * BATCH));
+    }
+
+    running = false;
+    ping.release();
+    thread.join();
+    bench_report("semaphore_ping_pong", "ns", &r);
+}
+
+/** Benchmark ISR to thread wakeup
+
+    Given a thread waiting on a semaphore released from a timer interrupt
+    When the time from the interrupt to the thread running is measured
+    Then the minimum, average and maximum wakeup latency is reported
+ */
+void test_isr_wakeup(void)
+{
+    bench_result_t r;
+    bench_reset(&r);
+
+    Timeout timeout;
+
+    for (uint32_t i = 0; i < SAMPLES; i++) {
+        timeout.attach_us(isr_wakeup, 1000);
+        TEST_ASSERT_EQUAL(1, wakeup.wait(100));
+        bench_add(&r, us_ticker_read() - isr_time);
+    }
+
+    bench_report("isr_wakeup", "us", &r);
+}
+
+/** Benchmark Queue throughput
+
+    Given a thread that puts messages into a Queue as fast as it can
+    When another thread gets all of them
+    Then the number of messages passed per second is reported
+ */
+void test_queue_throughput(void)
+{
+    bench_result_t r;
+    bench_reset(&r);
+
+    Queue<uint32_t, QUEUE_SIZE> queue;
+
+    for (uint32_t i = 0; i < SAMPLES / 8; i++) {
+        Thread thread(osPriorityNormal, THREAD_STACK_SIZE);
+        uint32_t start = us_ticker_read();
+        TEST_ASSERT_EQUAL(osOK, thread.start(callback(queue_producer, &queue)));
+        for (uint32_t j = 0; j < QUEUE_MSGS; j++) {
+            TEST_ASSERT_EQUAL(osEventMessage, queue.get().status);
+        }
+        uint32_t elapsed = us_ticker_read() - start;
+        thread.join();
+        bench_add(&r, (uint64_t)QUEUE_MSGS * 1000000 / elapsed);
+    }
+
+    bench_report("queue_throughput", "msg/s", &r);
+}
+
+utest::v1::status_t test_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(30, "benchmark_report");
+    return verbose_test_setup_handler(number_of_cases);
+}
+
+Case cases[] = {
+    Case("Benchmark context switch", test_context_switch),
+    Case("Benchmark semaphore ping-pong", test_semaphore_ping_pong),
+    Case("Benchmark ISR to thread wakeup", test_isr_wakeup),
+    Case("Benchmark Queue throughput", test_queue_throughput),
+};
+
+Specification specification(test_setup, cases);
+
+int main()
+{
+    return !Harness::run(specification);
+}
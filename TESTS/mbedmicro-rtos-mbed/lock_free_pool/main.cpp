@@ -0,0 +1,163 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity.h"
+#include "utest.h"
+#include "rtos.h"
+
+#if defined(MBED_RTOS_SINGLE_THREAD)
+  #error [NOT_SUPPORTED] test not supported
+#endif
+
+using namespace utest::v1;
+
+#define POOL_SIZE           8
+#define THREAD_STACK_SIZE   512
+#define ALLOC_COUNT         1000
+#define TICKER_US           100
+
+typedef struct {
+    uint32_t owner;
+    uint32_t data[3];
+} block_t;
+
+static LockFreeMemoryPool<block_t, POOL_SIZE> pool;
+
+static volatile uint32_t isr_allocs;
+
+void alloc_free_loop(uint32_t owner)
+{
+    for (uint32_t i = 0; i < ALLOC_COUNT; i++) {
+        block_t *block = pool.alloc();
+        if (!block) {
+            continue;
+        }
+
+        block->owner = owner;
+        Thread::yield();
+        TEST_ASSERT_EQUAL(owner, block->owner);
+        TEST_ASSERT_EQUAL(osOK, pool.free(block));
+    }
+}
+
+void isr_alloc_free()
+{
+    block_t *block = pool.alloc();
+    if (block) {
+        block->owner = 0xffffffff;
+        pool.free(block);
+        isr_allocs++;
+    }
+}
+
+/** Test the pool can be exhausted and refilled
+
+    Given an empty pool
+    When every block is allocated
+    Then further allocations fail until a block is freed
+ */
+void test_exhaust(void)
+{
+    block_t *blocks[POOL_SIZE];
+
+    for (uint32_t i = 0; i < POOL_SIZE; i++) {
+        blocks[i] = pool.calloc();
+        TEST_ASSERT_NOT_NULL(blocks[i]);
+        TEST_ASSERT_EQUAL(0, blocks[i]->owner);
+    }
+    TEST_ASSERT_NULL(pool.alloc());
+
+    TEST_ASSERT_EQUAL(osOK, pool.free(blocks[0]));
+    TEST_ASSERT_EQUAL(blocks[0], pool.alloc());
+
+    for (uint32_t i = 0; i < POOL_SIZE; i++) {
+        TEST_ASSERT_EQUAL(osOK, pool.free(blocks[i]));
+    }
+}
+
+/** Test free rejects blocks that do not belong to the pool
+
+    Given a pool
+    When NULL, a misaligned block or a block outside the pool is freed
+    Then free fails with osErrorParameter
+ */
+void test_free_invalid(void)
+{
+    block_t block;
+    TEST_ASSERT_EQUAL(osErrorParameter, pool.free(NULL));
+    TEST_ASSERT_EQUAL(osErrorParameter, pool.free(&block));
+
+    block_t *valid = pool.alloc();
+    TEST_ASSERT_EQUAL(osErrorParameter, pool.free((block_t*)((char*)valid + 1)));
+    TEST_ASSERT_EQUAL(osOK, pool.free(valid));
+
+#if MBED_CONF_RTOS_LOCK_FREE_POOL_DEBUG
+    TEST_ASSERT_EQUAL(osErrorResource, pool.free(valid));
+#endif
+}
+
+/** Test concurrent use from threads and an interrupt
+
+    Given two threads and a ticker interrupt allocating and freeing blocks
+    When they run concurrently
+    Then no block is handed out twice
+ */
+void test_concurrent(void)
+{
+    Ticker ticker;
+    isr_allocs = 0;
+    ticker.attach_us(isr_alloc_free, TICKER_US);
+
+    Thread thread1(osPriorityNormal, THREAD_STACK_SIZE);
+    Thread thread2(osPriorityNormal, THREAD_STACK_SIZE);
+    thread1.start(callback(alloc_free_loop, 1));
+    thread2.start(callback(alloc_free_loop, 2));
+    alloc_free_loop(3);
+    thread1.join();
+    thread2.join();
+
+    ticker.detach();
+    TEST_ASSERT_TRUE(isr_allocs > 0);
+
+    block_t *blocks[POOL_SIZE];
+    for (uint32_t i = 0; i < POOL_SIZE; i++) {
+        blocks[i] = pool.alloc();
+        TEST_ASSERT_NOT_NULL(blocks[i]);
+    }
+    for (uint32_t i = 0; i < POOL_SIZE; i++) {
+        pool.free(blocks[i]);
+    }
+}
+
+utest::v1::status_t test_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(20, "default_auto");
+    return verbose_test_setup_handler(number_of_cases);
+}
+
+Case cases[] = {
+    Case("Test pool exhaustion", test_exhaust),
+    Case("Test invalid block free", test_free_invalid),
+    Case("Test concurrent alloc and free from threads and isr", test_concurrent),
+};
+
+Specification specification(test_setup, cases);
+
+int main()
+{
+    return !Harness::run(specification);
+}
@@ -0,0 +1,182 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity.h"
+#include "utest.h"
+#include "rtos.h"
+
+#if defined(MBED_RTOS_SINGLE_THREAD)
+  #error [NOT_SUPPORTED] test not supported
+#endif
+
+using namespace utest::v1;
+
+#define THREAD_STACK_SIZE   384
+#define QUEUE_SIZE          8
+#define BATCH_SIZE          4
+#define SEND_COUNT          100
+#define TIMEOUT_MS          50
+
+
+void send_thread(MailRing<uint32_t, QUEUE_SIZE> *m)
+{
+    for (uint32_t i = 0; i < SEND_COUNT; ) {
+        uint32_t *mail = m->alloc();
+        if (!mail) {
+            Thread::yield();
+            continue;
+        }
+
+        *mail = i++;
+        m->put(mail);
+    }
+}
+
+/** Test messages put into the ring are received in order
+
+    Given a ring filled to its maximum size
+    When the messages are received
+    Then they are received in the order they were allocated and the ring is full until one is freed
+ */
+void test_order(void)
+{
+    MailRing<uint32_t, QUEUE_SIZE> mail_box;
+
+    for (uint32_t i = 0; i < QUEUE_SIZE; i++) {
+        uint32_t *mail = mail_box.alloc();
+        TEST_ASSERT_NOT_NULL(mail);
+        *mail = i;
+        TEST_ASSERT_EQUAL(osOK, mail_box.put(mail));
+    }
+    TEST_ASSERT_NULL(mail_box.alloc());
+
+    for (uint32_t i = 0; i < QUEUE_SIZE; i++) {
+        osEvent evt = mail_box.get(0);
+        TEST_ASSERT_EQUAL(osEventMail, evt.status);
+        TEST_ASSERT_EQUAL(i, *(uint32_t*)evt.value.p);
+        TEST_ASSERT_NULL(mail_box.alloc());
+        TEST_ASSERT_EQUAL(osOK, mail_box.free((uint32_t*)evt.value.p));
+        TEST_ASSERT_NOT_NULL(mail_box.calloc());
+    }
+}
+
+/** Test a slot put out of order holds back later slots
+
+    Given two allocated slots
+    When the second slot is put before the first
+    Then no message is received until the first slot is put too
+ */
+void test_put_out_of_order(void)
+{
+    MailRing<uint32_t, QUEUE_SIZE> mail_box;
+
+    uint32_t *first = mail_box.alloc();
+    uint32_t *second = mail_box.alloc();
+    *first = 1;
+    *second = 2;
+
+    mail_box.put(second);
+    TEST_ASSERT_EQUAL(osOK, mail_box.get(0).status);
+
+    mail_box.put(first);
+    uint32_t *mails[BATCH_SIZE];
+    TEST_ASSERT_EQUAL(2, mail_box.get(mails, BATCH_SIZE, 0));
+    TEST_ASSERT_EQUAL(first, mails[0]);
+    TEST_ASSERT_EQUAL(second, mails[1]);
+}
+
+/** Test batched get from another thread
+
+    Given a ring and a thread sending messages into it
+    When messages are received in batches
+    Then every message is received once and in order
+ */
+void test_batch_get(void)
+{
+    MailRing<uint32_t, QUEUE_SIZE> mail_box;
+
+    Thread thread(osPriorityNormal, THREAD_STACK_SIZE);
+    thread.start(callback(send_thread, &mail_box));
+
+    uint32_t expected = 0;
+    while (expected < SEND_COUNT) {
+        uint32_t *mails[BATCH_SIZE];
+        size_t count = mail_box.get(mails, BATCH_SIZE, TIMEOUT_MS);
+        TEST_ASSERT_TRUE(count > 0 && count <= BATCH_SIZE);
+
+        for (size_t i = 0; i < count; i++) {
+            TEST_ASSERT_EQUAL(expected++, *mails[i]);
+            TEST_ASSERT_EQUAL(osOK, mail_box.free(mails[i]));
+        }
+    }
+
+    thread.join();
+}
+
+/** Test get with timeout on an empty ring
+
+    Given an empty ring
+    When a message is received with a timeout
+    Then the get times out after the timeout elapses
+ */
+void test_get_empty_timeout(void)
+{
+    MailRing<uint32_t, QUEUE_SIZE> mail_box;
+    Timer timer;
+
+    timer.start();
+    osEvent evt = mail_box.get(TIMEOUT_MS);
+    TEST_ASSERT_EQUAL(osEventTimeout, evt.status);
+    TEST_ASSERT_UINT32_WITHIN(5000, TIMEOUT_MS * 1000, timer.read_us());
+}
+
+/** Test freeing a slot twice
+
+    Given a received message
+    When it is freed twice
+    Then the second free is rejected
+ */
+void test_free_twice(void)
+{
+    MailRing<uint32_t, QUEUE_SIZE> mail_box;
+
+    mail_box.put(mail_box.alloc());
+    uint32_t *mail = (uint32_t*)mail_box.get(0).value.p;
+    TEST_ASSERT_EQUAL(osOK, mail_box.free(mail));
+    TEST_ASSERT_EQUAL(osErrorParameter, mail_box.free(mail));
+}
+
+utest::v1::status_t test_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(10, "default_auto");
+    return verbose_test_setup_handler(number_of_cases);
+}
+
+Case cases[] = {
+    Case("Test message order", test_order),
+    Case("Test put out of order", test_put_out_of_order),
+    Case("Test batched get", test_batch_get),
+    Case("Test get with timeout on empty ring", test_get_empty_timeout),
+    Case("Test message free twice", test_free_twice),
+};
+
+Specification specification(test_setup, cases);
+
+int main()
+{
+    return !Harness::run(specification);
+}
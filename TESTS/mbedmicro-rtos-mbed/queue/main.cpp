@@ -278,6 +278,59 @@ void test_msg_prio()
     TEST_ASSERT_EQUAL(TEST_UINT_MSG, evt.value.v);
 }
 
+/** Test batched put and get
+
+    Given a queue of uint32_t data
+    When messages are put with put_many and taken with get_many
+    Then every message is returned in order in a single get_many call
+ */
+void test_put_get_many()
+{
+    Queue<uint32_t, 4> q;
+    uint32_t *in[5] = {(uint32_t*)1, (uint32_t*)2, (uint32_t*)3, (uint32_t*)4, (uint32_t*)5};
+    uint32_t *out[5];
+
+    TEST_ASSERT_EQUAL(4, q.put_many(in, 5));
+    TEST_ASSERT_EQUAL(4, q.get_many(out, 5, 0));
+    for (uint32_t i = 0; i < 4; i++) {
+        TEST_ASSERT_EQUAL(in[i], out[i]);
+    }
+
+    uint32_t start = us_ticker_read();
+    TEST_ASSERT_EQUAL(0, q.get_many(out, 5, TEST_TIMEOUT));
+    TEST_ASSERT_UINT32_WITHIN(5000, TEST_TIMEOUT * 1000, us_ticker_read() - start);
+}
+
+void thread_put_msgs(Queue<uint32_t, 4> *q)
+{
+    for (uint32_t i = 0; i < 3; i++) {
+        Thread::wait(TEST_TIMEOUT / 5);
+        q->put((uint32_t*) TEST_UINT_MSG);
+    }
+}
+
+/** Test waiting for a minimum number of messages
+
+    Given a queue of uint32_t data and a thread putting three messages over time
+    When get_many waits for three messages
+    Then it returns once all three have arrived, or with fewer once the timeout expires
+ */
+void test_get_many_min_count()
+{
+    Queue<uint32_t, 4> q;
+    uint32_t *out[4];
+
+    Thread t(osPriorityNormal, THREAD_STACK_SIZE);
+    t.start(callback(thread_put_msgs, &q));
+    TEST_ASSERT_EQUAL(3, q.get_many(out, 4, TEST_TIMEOUT * 2, 3));
+    t.join();
+
+    q.put((uint32_t*) TEST_UINT_MSG);
+    uint32_t start = us_ticker_read();
+    TEST_ASSERT_EQUAL(1, q.get_many(out, 4, TEST_TIMEOUT, 2));
+    TEST_ASSERT_UINT32_WITHIN(5000, TEST_TIMEOUT * 1000, us_ticker_read() - start);
+}
+
 utest::v1::status_t test_setup(const size_t number_of_cases)
 {
     GREENTEA_SETUP(5, "default_auto");
@@ -295,7 +348,9 @@ Case cases[] = {
     Case("Test put full timeout", test_put_full_timeout),
     Case("Test put full wait forever", test_put_full_waitforever),
     Case("Test message ordering", test_msg_order),
-    Case("Test message priority", test_msg_prio)
+    Case("Test message priority", test_msg_prio),
+    Case("Test batched put and get", test_put_get_many),
+    Case("Test get many with minimum count", test_get_many_min_count)
 };
 
 Specification specification(test_setup, cases);
@@ -0,0 +1,140 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity.h"
+#include "utest.h"
+#include "rtos.h"
+
+#if defined(MBED_RTOS_SINGLE_THREAD)
+  #error [NOT_SUPPORTED] test not supported
+#endif
+
+using namespace utest::v1;
+
+#define THREAD_STACK_SIZE   512
+#define READER_COUNT        3
+#define ITERATIONS          100
+
+static RWLock rwlock;
+static volatile uint32_t value_a;
+static volatile uint32_t value_b;
+static volatile bool writing;
+
+void reader_loop()
+{
+    for (uint32_t i = 0; i < ITERATIONS; i++) {
+        rwlock.read_lock();
+        TEST_ASSERT_FALSE(writing);
+        TEST_ASSERT_EQUAL(value_a, value_b);
+        Thread::yield();
+        rwlock.read_unlock();
+    }
+}
+
+void writer_loop()
+{
+    for (uint32_t i = 0; i < ITERATIONS; i++) {
+        rwlock.write_lock();
+        writing = true;
+        value_a++;
+        Thread::yield();
+        value_b++;
+        writing = false;
+        rwlock.write_unlock();
+        Thread::yield();
+    }
+}
+
+/** Test readers share the lock
+
+    Given a read lock
+    When more read locks are taken
+    Then they succeed while write locks fail until every reader unlocks
+ */
+void test_shared_read(void)
+{
+    rwlock.read_lock();
+    TEST_ASSERT_TRUE(rwlock.read_trylock());
+    TEST_ASSERT_FALSE(rwlock.write_trylock());
+
+    rwlock.read_unlock();
+    TEST_ASSERT_FALSE(rwlock.write_trylock());
+    rwlock.read_unlock();
+
+    TEST_ASSERT_TRUE(rwlock.write_trylock());
+    rwlock.write_unlock();
+}
+
+/** Test writers are exclusive
+
+    Given a write lock
+    When read or write locks are tried
+    Then they fail until the writer unlocks
+ */
+void test_exclusive_write(void)
+{
+    rwlock.write_lock();
+    TEST_ASSERT_FALSE(rwlock.read_trylock());
+    rwlock.write_unlock();
+
+    TEST_ASSERT_TRUE(rwlock.read_trylock());
+    rwlock.read_unlock();
+}
+
+/** Test concurrent readers and a writer
+
+    Given several reader threads and a writer thread
+    When they access shared data under the lock
+    Then readers never observe a partial write
+ */
+void test_concurrent(void)
+{
+    Thread readers[READER_COUNT];
+    Thread writer(osPriorityNormal, THREAD_STACK_SIZE);
+
+    for (uint32_t i = 0; i < READER_COUNT; i++) {
+        readers[i].start(reader_loop);
+    }
+    writer.start(writer_loop);
+
+    for (uint32_t i = 0; i < READER_COUNT; i++) {
+        readers[i].join();
+    }
+    writer.join();
+
+    TEST_ASSERT_EQUAL(ITERATIONS, value_a);
+    TEST_ASSERT_EQUAL(ITERATIONS, value_b);
+}
+
+utest::v1::status_t test_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(10, "default_auto");
+    return verbose_test_setup_handler(number_of_cases);
+}
+
+Case cases[] = {
+    Case("Test shared read locks", test_shared_read),
+    Case("Test exclusive write lock", test_exclusive_write),
+    Case("Test concurrent readers and writer", test_concurrent),
+};
+
+Specification specification(test_setup, cases);
+
+int main()
+{
+    return !Harness::run(specification);
+}
@@ -0,0 +1,151 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity.h"
+#include "utest.h"
+#include "rtos.h"
+#include "mbed_events.h"
+
+#if defined(MBED_RTOS_SINGLE_THREAD)
+  #error [NOT_SUPPORTED] test not supported
+#endif
+
+using namespace utest::v1;
+
+#define WORKERS             2
+#define QUEUE_SIZE          4
+#define THREAD_STACK_SIZE   512
+#define WORK_COUNT          (WORKERS * QUEUE_SIZE)
+#define EVENT_DELAY_MS      10
+
+typedef ThreadPool<WORKERS, QUEUE_SIZE> pool_t;
+
+static volatile uint32_t work_done;
+static Semaphore blocked_sem(0);
+
+void work()
+{
+    core_util_atomic_incr_u32((uint32_t*)&work_done, 1);
+}
+
+void blocking_work()
+{
+    blocked_sem.wait();
+    work();
+}
+
+/** Test drain waits for all queued work
+
+    Given a pool with every deque full
+    When the pool is drained
+    Then every work item has run
+ */
+void test_drain(void)
+{
+    pool_t pool(osPriorityNormal, THREAD_STACK_SIZE);
+    work_done = 0;
+
+    uint32_t queued = 0;
+    while (queued < WORK_COUNT) {
+        if (pool.call(callback(work))) {
+            queued++;
+        }
+    }
+
+    pool.drain();
+    TEST_ASSERT_EQUAL(WORK_COUNT, work_done);
+}
+
+/** Test idle workers steal work
+
+    Given a pool with one worker blocked on a work item
+    When more work items are queued behind it
+    Then the other worker runs them before the blocked item completes
+ */
+void test_steal(void)
+{
+    pool_t pool(osPriorityNormal, THREAD_STACK_SIZE);
+    work_done = 0;
+
+    TEST_ASSERT_TRUE(pool.call(callback(blocking_work)));
+    Thread::wait(EVENT_DELAY_MS);
+    for (uint32_t i = 0; i < WORK_COUNT - 1; i++) {
+        TEST_ASSERT_TRUE(pool.call(callback(work)));
+    }
+
+    Thread::wait(EVENT_DELAY_MS);
+    TEST_ASSERT_EQUAL(WORK_COUNT - 1, work_done);
+
+    blocked_sem.release();
+    pool.drain();
+    TEST_ASSERT_EQUAL(WORK_COUNT, work_done);
+}
+
+/** Test join
+
+    Given a pool with queued work
+    When the pool is joined
+    Then the queued work runs and no more work can be queued
+ */
+void test_join(void)
+{
+    pool_t pool(osPriorityNormal, THREAD_STACK_SIZE);
+    work_done = 0;
+
+    TEST_ASSERT_TRUE(pool.call(callback(work)));
+    pool.join();
+    TEST_ASSERT_EQUAL(1, work_done);
+    TEST_ASSERT_FALSE(pool.call(callback(work)));
+}
+
+/** Test forwarding timed work from an EventQueue
+
+    Given an EventQueue and a pool
+    When work is forwarded into the pool with call_in
+    Then it runs in the pool once the delay has passed
+ */
+void test_event_queue(void)
+{
+    pool_t pool(osPriorityNormal, THREAD_STACK_SIZE);
+    EventQueue queue;
+    work_done = 0;
+
+    queue.call_in(EVENT_DELAY_MS, &pool, &pool_t::call, callback(work));
+    queue.dispatch(2 * EVENT_DELAY_MS);
+    pool.drain();
+    TEST_ASSERT_EQUAL(1, work_done);
+}
+
+utest::v1::status_t test_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(10, "default_auto");
+    return verbose_test_setup_handler(number_of_cases);
+}
+
+Case cases[] = {
+    Case("Test drain", test_drain),
+    Case("Test work stealing", test_steal),
+    Case("Test join", test_join),
+    Case("Test forwarding work from an EventQueue", test_event_queue),
+};
+
+Specification specification(test_setup, cases);
+
+int main()
+{
+    return !Harness::run(specification);
+}
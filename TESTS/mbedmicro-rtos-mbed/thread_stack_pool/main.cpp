@@ -0,0 +1,127 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity.h"
+#include "utest.h"
+#include "rtos.h"
+
+#if defined(MBED_RTOS_SINGLE_THREAD)
+  #error [NOT_SUPPORTED] test not supported
+#endif
+
+#if !MBED_CONF_RTOS_THREAD_STACK_POOL_SIZE
+  #error [NOT_SUPPORTED] thread stack pool not enabled
+#endif
+
+using namespace utest::v1;
+
+#define POOL_SIZE           MBED_CONF_RTOS_THREAD_STACK_POOL_SIZE
+#define POOL_STACK_SIZE     MBED_CONF_RTOS_THREAD_STACK_POOL_STACK_SIZE
+#define CYCLES              50
+
+volatile uint32_t counter;
+
+void increment()
+{
+    core_util_atomic_incr_u32((uint32_t *)&counter, 1);
+}
+
+void wait_on(Semaphore *sem)
+{
+    sem->wait();
+    increment();
+}
+
+/** Test pooled stacks are reused after join
+
+    Given the thread stack pool
+    When threads are repeatedly started and joined
+    Then every thread runs and stacks are returned to the pool for the next thread
+ */
+void test_start_join_cycle(void)
+{
+    counter = 0;
+    for (uint32_t i = 0; i < CYCLES; i++) {
+        Thread t(osPriorityNormal, POOL_STACK_SIZE);
+        TEST_ASSERT_EQUAL(osOK, t.start(increment));
+        TEST_ASSERT_EQUAL(osOK, t.join());
+    }
+    TEST_ASSERT_EQUAL(CYCLES, counter);
+}
+
+/** Test threads fall back to the heap once the pool is empty
+
+    Given the thread stack pool
+    When more threads than pooled stacks are running at once
+    Then the extra threads get heap stacks and all of them run
+ */
+void test_pool_exhausted(void)
+{
+    Semaphore sem(0);
+    Thread *threads[POOL_SIZE + 1];
+
+    counter = 0;
+    for (uint32_t i = 0; i < POOL_SIZE + 1; i++) {
+        threads[i] = new Thread(osPriorityNormal, POOL_STACK_SIZE);
+        TEST_ASSERT_EQUAL(osOK, threads[i]->start(callback(wait_on, &sem)));
+    }
+
+    for (uint32_t i = 0; i < POOL_SIZE + 1; i++) {
+        sem.release();
+    }
+
+    for (uint32_t i = 0; i < POOL_SIZE + 1; i++) {
+        TEST_ASSERT_EQUAL(osOK, threads[i]->join());
+        delete threads[i];
+    }
+    TEST_ASSERT_EQUAL(POOL_SIZE + 1, counter);
+}
+
+/** Test threads with larger stacks bypass the pool
+
+    Given the thread stack pool
+    When a thread needs a larger stack than the pooled ones
+    Then it is started with a heap stack of the requested size
+ */
+void test_large_stack(void)
+{
+    counter = 0;
+    Thread t(osPriorityNormal, POOL_STACK_SIZE + 512);
+    TEST_ASSERT_EQUAL(osOK, t.start(increment));
+    TEST_ASSERT_EQUAL(osOK, t.join());
+    TEST_ASSERT_EQUAL(POOL_STACK_SIZE + 512, t.stack_size());
+    TEST_ASSERT_EQUAL(1, counter);
+}
+
+utest::v1::status_t test_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(10, "default_auto");
+    return verbose_test_setup_handler(number_of_cases);
+}
+
+Case cases[] = {
+    Case("Test start/join cycle", test_start_join_cycle),
+    Case("Test pool exhausted", test_pool_exhausted),
+    Case("Test large stack", test_large_stack),
+};
+
+Specification specification(test_setup, cases);
+
+int main()
+{
+    return !Harness::run(specification);
+}
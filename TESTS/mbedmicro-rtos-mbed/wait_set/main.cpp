@@ -0,0 +1,147 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity.h"
+#include "utest.h"
+#include "rtos.h"
+
+#if defined(MBED_RTOS_SINGLE_THREAD)
+  #error [NOT_SUPPORTED] test not supported
+#endif
+
+using namespace utest::v1;
+
+#define THREAD_STACK_SIZE   512
+#define MSG_COUNT           20
+
+Queue<uint32_t, MSG_COUNT> queue;
+Semaphore sem(0);
+EventFlags flags;
+uint32_t msg;
+
+void producer()
+{
+    for (uint32_t i = 0; i < MSG_COUNT; i++) {
+        TEST_ASSERT_EQUAL(osOK, queue.put(&msg));
+        TEST_ASSERT_EQUAL(osOK, sem.release());
+        Thread::wait(1);
+    }
+}
+
+/** Test an empty wait set times out
+
+    Given a wait set with no ready sources
+    When a thread waits on it with a timeout
+    Then -1 is returned, and an empty wait set returns -1 immediately
+ */
+void test_timeout(void)
+{
+    WaitSet set;
+    TEST_ASSERT_EQUAL(-1, set.wait_any(0));
+
+    int id = set.add(sem);
+    TEST_ASSERT_NOT_EQUAL(-1, id);
+    TEST_ASSERT_EQUAL(-1, set.wait_any(0));
+    TEST_ASSERT_EQUAL(-1, set.wait_any(10));
+    set.remove(id);
+}
+
+/** Test each kind of source wakes the waiting thread
+
+    Given a wait set with a queue, a semaphore, event flags and a signal source
+    When each source becomes ready in turn
+    Then wait_any returns the id of that source
+ */
+void test_sources(void)
+{
+    WaitSet set;
+    int queue_id = set.add(queue);
+    int sem_id = set.add(sem);
+    int flags_id = set.add(flags, 0x2);
+    int signal_id = set.add();
+
+    TEST_ASSERT_EQUAL(-1, set.add(queue));
+
+    TEST_ASSERT_EQUAL(osOK, queue.put(&msg));
+    TEST_ASSERT_EQUAL(queue_id, set.wait_any(0));
+    TEST_ASSERT_EQUAL(osEventMessage, queue.get(0).status);
+
+    TEST_ASSERT_EQUAL(osOK, sem.release());
+    TEST_ASSERT_EQUAL(sem_id, set.wait_any(0));
+    TEST_ASSERT_EQUAL(1, sem.wait(0));
+
+    flags.set(0x1);
+    TEST_ASSERT_EQUAL(-1, set.wait_any(0));
+    flags.set(0x2);
+    TEST_ASSERT_EQUAL(flags_id, set.wait_any(0));
+    flags.clear();
+
+    set.signal_callback(signal_id).call();
+    TEST_ASSERT_EQUAL(signal_id, set.wait_any(0));
+    TEST_ASSERT_EQUAL(-1, set.wait_any(0));
+}
+
+/** Test a thread blocks on several sources at once
+
+    Given a wait set with a queue and a semaphore fed by another thread
+    When the waiting thread handles whichever source is ready
+    Then every message and every token is received
+ */
+void test_multi_wait(void)
+{
+    WaitSet set;
+    int queue_id = set.add(queue);
+    int sem_id = set.add(sem);
+
+    Thread thread(osPriorityNormal, THREAD_STACK_SIZE);
+    thread.start(producer);
+
+    uint32_t msgs = 0, tokens = 0;
+    while (msgs < MSG_COUNT || tokens < MSG_COUNT) {
+        int id = set.wait_any(1000);
+        if (id == queue_id) {
+            TEST_ASSERT_EQUAL(osEventMessage, queue.get(0).status);
+            msgs++;
+        } else if (id == sem_id) {
+            TEST_ASSERT(sem.wait(0) > 0);
+            tokens++;
+        } else {
+            TEST_FAIL_MESSAGE("wait set timed out");
+        }
+    }
+
+    thread.join();
+}
+
+utest::v1::status_t test_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(10, "default_auto");
+    return verbose_test_setup_handler(number_of_cases);
+}
+
+Case cases[] = {
+    Case("Test timeout", test_timeout),
+    Case("Test each source", test_sources),
+    Case("Test waiting on several sources", test_multi_wait),
+};
+
+Specification specification(test_setup, cases);
+
+int main()
+{
+    return !Harness::run(specification);
+}
@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2017, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity/unity.h"
+#include "utest/utest.h"
+
+#include "mbedtls/config.h"
+#include "mbedtls/platform.h"
+#include "mbedtls/bignum.h"
+
+#if !defined(MBED_TLS_ARENA)
+#error [NOT_SUPPORTED] mbedtls.arena is not enabled
+#endif
+
+using namespace utest::v1;
+
+#define ARENA_SIZE  2048
+
+static uint64_t arena_buf[ARENA_SIZE / 8];
+
+static bool in_arena(void *ptr)
+{
+    return (unsigned char *)ptr >= (unsigned char *)arena_buf
+        && (unsigned char *)ptr < (unsigned char *)arena_buf + sizeof(arena_buf);
+}
+
+/* Allocations come from the arena only while it is entered */
+void test_arena_enter_leave()
+{
+    mbed_tls_arena_t arena;
+    mbed_tls_arena_init(&arena, arena_buf, sizeof(arena_buf));
+
+    void *heap = mbedtls_calloc(1, 16);
+    TEST_ASSERT_NOT_NULL(heap);
+    TEST_ASSERT_FALSE(in_arena(heap));
+
+    mbed_tls_arena_enter(&arena);
+    void *a = mbedtls_calloc(4, 8);
+    mbed_tls_arena_enter(&arena);
+    void *b = mbedtls_calloc(1, 100);
+    mbed_tls_arena_leave(&arena);
+    void *c = mbedtls_calloc(1, 1);
+    // Heap memory is freed to the heap from within the arena
+    mbedtls_free(heap);
+    mbed_tls_arena_leave(&arena);
+
+    TEST_ASSERT_TRUE(in_arena(a));
+    TEST_ASSERT_TRUE(in_arena(b));
+    TEST_ASSERT_TRUE(in_arena(c));
+
+    void *d = mbedtls_calloc(1, 16);
+    TEST_ASSERT_FALSE(in_arena(d));
+    mbedtls_free(d);
+
+    mbed_tls_arena_stats_t stats;
+    mbed_tls_arena_stats_get(&arena, &stats);
+    TEST_ASSERT_EQUAL(3, stats.alloc_cnt);
+
+    // Arena memory is freed to the arena from outside of it
+    mbedtls_free(a);
+    mbedtls_free(b);
+    mbedtls_free(c);
+
+    mbed_tls_arena_stats_get(&arena, &stats);
+    TEST_ASSERT_EQUAL(0, stats.alloc_cnt);
+    TEST_ASSERT_EQUAL(0, stats.current_size);
+    TEST_ASSERT_TRUE(stats.max_size >= 4 * 8 + 100 + 1);
+    mbed_tls_arena_free(&arena);
+}
+
+/* Freed blocks merge back into one, and a full arena fails allocations */
+void test_arena_exhaust()
+{
+    mbed_tls_arena_t arena;
+    mbed_tls_arena_init(&arena, arena_buf, sizeof(arena_buf));
+    mbed_tls_arena_enter(&arena);
+
+    void *blocks[ARENA_SIZE / 64];
+    unsigned count = 0;
+    while (count < sizeof(blocks) / sizeof(blocks[0])) {
+        blocks[count] = mbedtls_calloc(1, 48);
+        if (!blocks[count]) {
+            break;
+        }
+        memset(blocks[count], count, 48);
+        count++;
+    }
+    TEST_ASSERT_TRUE(count > 0);
+    TEST_ASSERT_NULL(mbedtls_calloc(1, 48));
+
+    // Free every other block first so that the merges happen on both sides
+    for (unsigned i = 0; i < count; i += 2) {
+        mbedtls_free(blocks[i]);
+    }
+    for (unsigned i = 1; i < count; i += 2) {
+        TEST_ASSERT_EQUAL_UINT8(i, ((unsigned char *)blocks[i])[47]);
+        mbedtls_free(blocks[i]);
+    }
+
+    mbed_tls_arena_stats_t stats;
+    mbed_tls_arena_stats_get(&arena, &stats);
+    TEST_ASSERT_EQUAL(0, stats.current_size);
+    TEST_ASSERT_TRUE(stats.alloc_fail_cnt >= 1);
+
+    void *all = mbedtls_calloc(1, stats.reserved_size - 64);
+    TEST_ASSERT_NOT_NULL(all);
+    TEST_ASSERT_TRUE(in_arena(all));
+    mbedtls_free(all);
+
+    mbed_tls_arena_leave(&arena);
+    mbed_tls_arena_free(&arena);
+}
+
+/* mbed TLS computations run within an arena and give all of it back */
+void test_arena_mbedtls()
+{
+    mbed_tls_arena_t arena;
+    mbed_tls_arena_init(&arena, arena_buf, sizeof(arena_buf));
+    mbed_tls_arena_enter(&arena);
+
+    mbedtls_mpi x, y, z;
+    mbedtls_mpi_init(&x);
+    mbedtls_mpi_init(&y);
+    mbedtls_mpi_init(&z);
+    TEST_ASSERT_EQUAL(0, mbedtls_mpi_read_string(&x, 16, "EFE021C2645FD1DC586E69184AF4A31ED5F53E93B5F123FA41680867BA110131944FE7952E2517337780CB0DB80E61AAE7C8DDC6C5C6AADEB34EB38A2F40D5E6"));
+    TEST_ASSERT_EQUAL(0, mbedtls_mpi_read_string(&y, 16, "B2E7EFD37075B9F03FF989C7C5051C2034D2A323810251127E7BF8625A4F49A5F3E27F4DA8BD59C47D6DAABA4C8127BD5B5C25763222FEFCCFC38B832366C29E"));
+    TEST_ASSERT_EQUAL(0, mbedtls_mpi_mul_mpi(&z, &x, &y));
+    TEST_ASSERT_EQUAL(0, mbedtls_mpi_div_mpi(&x, NULL, &z, &y));
+    TEST_ASSERT_EQUAL(0, mbedtls_mpi_read_string(&y, 16, "EFE021C2645FD1DC586E69184AF4A31ED5F53E93B5F123FA41680867BA110131944FE7952E2517337780CB0DB80E61AAE7C8DDC6C5C6AADEB34EB38A2F40D5E6"));
+    TEST_ASSERT_EQUAL(0, mbedtls_mpi_cmp_mpi(&x, &y));
+    mbedtls_mpi_free(&x);
+    mbedtls_mpi_free(&y);
+    mbedtls_mpi_free(&z);
+
+    mbed_tls_arena_leave(&arena);
+
+    mbed_tls_arena_stats_t stats;
+    mbed_tls_arena_stats_get(&arena, &stats);
+    TEST_ASSERT_EQUAL(0, stats.alloc_cnt);
+    TEST_ASSERT_EQUAL(0, stats.alloc_fail_cnt);
+    TEST_ASSERT_TRUE(stats.max_size > 0);
+    mbed_tls_arena_free(&arena);
+}
+
+utest::v1::status_t greentea_failure_handler(const Case *const source, const failure_t reason) {
+    greentea_case_failure_abort_handler(source, reason);
+    return STATUS_CONTINUE;
+}
+
+Case cases[] = {
+    Case("Arena: enter and leave", test_arena_enter_leave, greentea_failure_handler),
+    Case("Arena: exhaust and merge", test_arena_exhaust, greentea_failure_handler),
+    Case("Arena: mbed TLS", test_arena_mbedtls, greentea_failure_handler),
+};
+
+utest::v1::status_t greentea_test_setup(const size_t number_of_cases) {
+    GREENTEA_SETUP(10, "default_auto");
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+Specification specification(greentea_test_setup, cases, greentea_test_teardown_handler);
+
+int main() {
+    Harness::run(specification);
+}
@@ -0,0 +1,572 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity.h"
+#include "utest.h"
+
+#include "mbedtls/config.h"
+#include "mbedtls/aes.h"
+#include "mbedtls/gcm.h"
+#include "mbedtls/ccm.h"
+#include "mbedtls/sha256.h"
+#include "mbedtls/sha512.h"
+#include "mbedtls/ecdsa.h"
+#include "mbedtls/ecdh.h"
+#include "mbedtls/rsa.h"
+
+using namespace utest::v1;
+
+/* Results are sent to the benchmark_report host test as "bench" key-value
+ * pairs, formatted as "<name>,<unit>,<min>,<avg>,<max>", with two decimals.
+ * Ciphers and hashes are reported in cycles per byte, public key
+ * operations in operations per second.
+ *
+ * Names end in "_alt" when mbed TLS was built with the target's hardware
+ * implementation (MBEDTLS_*_ALT), and in "_fast" for the dedicated curve
+ * implementations, so a run with and one without the target's
+ * mbedtls_device.h (the MBEDTLS_CONFIG_HW_SUPPORT macro) compare the two.
+ */
+
+#define BUFFER_SIZE     1024
+#define SAMPLES         8
+#define PK_SAMPLES      4
+
+#if defined(MBEDTLS_AES_ALT)
+#define AES_IMPL        "_alt"
+#else
+#define AES_IMPL        ""
+#endif
+
+#if defined(MBEDTLS_SHA256_ALT)
+#define SHA256_IMPL     "_alt"
+#else
+#define SHA256_IMPL     ""
+#endif
+
+#if defined(MBEDTLS_SHA512_ALT)
+#define SHA512_IMPL     "_alt"
+#else
+#define SHA512_IMPL     ""
+#endif
+
+#if defined(MBEDTLS_ECP_FAST_SECP256R1)
+#define P256_IMPL       "_fast"
+#elif defined(MBEDTLS_ECP_INTERNAL_ALT) || defined(MBEDTLS_ECP_ALT)
+#define P256_IMPL       "_alt"
+#else
+#define P256_IMPL       ""
+#endif
+
+#if defined(MBEDTLS_ECP_FAST_CURVE25519)
+#define X25519_IMPL     "_fast"
+#elif defined(MBEDTLS_ECP_INTERNAL_ALT) || defined(MBEDTLS_ECP_ALT)
+#define X25519_IMPL     "_alt"
+#else
+#define X25519_IMPL     ""
+#endif
+
+#if defined(MBEDTLS_MPI_EXP_MOD_ALT) || defined(MBEDTLS_RSA_ALT)
+#define RSA_IMPL        "_alt"
+#else
+#define RSA_IMPL        ""
+#endif
+
+/* Timestamps come from the DWT cycle counter where the core has one, and
+ * from the us ticker otherwise, and are converted to core cycles.
+ */
+static bool cycle_counter;
+
+static void stamp_init()
+{
+#ifdef DWT
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    if (!(DWT->CTRL & DWT_CTRL_NOCYCCNT_Msk)) {
+        DWT->CYCCNT = 0;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+        cycle_counter = true;
+    }
+#endif
+}
+
+static inline uint32_t stamp()
+{
+#ifdef DWT
+    if (cycle_counter) {
+        return DWT->CYCCNT;
+    }
+#endif
+    return us_ticker_read();
+}
+
+static uint64_t stamp_to_cycles(uint32_t delta)
+{
+    if (cycle_counter) {
+        return delta;
+    }
+    return (uint64_t)delta * SystemCoreClock / 1000000;
+}
+
+typedef int (*bench_op)(void *ctx);
+
+static unsigned char buffer[BUFFER_SIZE];
+static unsigned char iv[16];
+static unsigned char tag[16];
+static const unsigned char key[32] = {
+    0x60, 0x3d, 0xeb, 0x10, 0x15, 0xca, 0x71, 0xbe,
+    0x2b, 0x73, 0xae, 0xf0, 0x85, 0x7d, 0x77, 0x81,
+    0x1f, 0x35, 0x2c, 0x07, 0x3b, 0x61, 0x08, 0xd7,
+    0x2d, 0x98, 0x10, 0xa3, 0x09, 0x14, 0xdf, 0xf4,
+};
+
+/* Runs op over the buffer and reports cycles per byte */
+static void bench_bytes(const char *name, bench_op op, void *ctx)
+{
+    bench_result_t r;
+    bench_reset(&r);
+
+    // The first run warms up caches and lazily initialized hardware
+    TEST_ASSERT_EQUAL(0, op(ctx));
+
+    for (uint32_t i = 0; i < SAMPLES; i++) {
+        uint32_t start = stamp();
+        int err = op(ctx);
+        uint64_t cycles = stamp_to_cycles(stamp() - start);
+        TEST_ASSERT_EQUAL(0, err);
+        bench_add(&r, cycles * 100 / BUFFER_SIZE);
+    }
+
+    bench_report(name, "cycles/B", &r, 2);
+}
+
+/* Runs op once per sample and reports operations per second */
+static void bench_ops(const char *name, bench_op op, void *ctx)
+{
+    bench_result_t r;
+    bench_reset(&r);
+
+    for (uint32_t i = 0; i < PK_SAMPLES; i++) {
+        uint32_t start = stamp();
+        int err = op(ctx);
+        uint64_t cycles = stamp_to_cycles(stamp() - start);
+        TEST_ASSERT_EQUAL(0, err);
+        bench_add(&r, cycles ? (uint64_t)SystemCoreClock * 100 / cycles : UINT32_MAX);
+    }
+
+    bench_report(name, "ops/s", &r, 2);
+}
+
+/* A deterministic generator is enough to measure with */
+static int bench_rng(void *ctx, unsigned char *output, size_t len)
+{
+    static uint32_t state = 0x2545F491;
+    for (size_t i = 0; i < len; i++) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        output[i] = state;
+    }
+    return 0;
+}
+
+#if defined(MBEDTLS_AES_C)
+static int aes_ecb(void *ctx)
+{
+    for (size_t i = 0; i < BUFFER_SIZE; i += 16) {
+        int err = mbedtls_aes_crypt_ecb((mbedtls_aes_context *)ctx, MBEDTLS_AES_ENCRYPT,
+                                        buffer + i, buffer + i);
+        if (err) {
+            return err;
+        }
+    }
+    return 0;
+}
+
+#if defined(MBEDTLS_CIPHER_MODE_CBC)
+static int aes_cbc(void *ctx)
+{
+    return mbedtls_aes_crypt_cbc((mbedtls_aes_context *)ctx, MBEDTLS_AES_ENCRYPT,
+                                 BUFFER_SIZE, iv, buffer, buffer);
+}
+#endif
+
+#if defined(MBEDTLS_CIPHER_MODE_CTR)
+static int aes_ctr(void *ctx)
+{
+    size_t offset = 0;
+    unsigned char stream_block[16];
+    return mbedtls_aes_crypt_ctr((mbedtls_aes_context *)ctx, BUFFER_SIZE, &offset,
+                                 iv, stream_block, buffer, buffer);
+}
+#endif
+
+/** Benchmark AES
+
+    Given a 128-bit and a 256-bit AES key
+    When a buffer is encrypted in each mode
+    Then the cycles per byte are reported
+ */
+void test_aes()
+{
+    mbedtls_aes_context aes;
+    const char *names[][3] = {
+        { "aes128_ecb" AES_IMPL, "aes128_cbc" AES_IMPL, "aes128_ctr" AES_IMPL },
+        { "aes256_ecb" AES_IMPL, "aes256_cbc" AES_IMPL, "aes256_ctr" AES_IMPL },
+    };
+
+    for (int k = 0; k < 2; k++) {
+        mbedtls_aes_init(&aes);
+        TEST_ASSERT_EQUAL(0, mbedtls_aes_setkey_enc(&aes, key, k ? 256 : 128));
+        bench_bytes(names[k][0], aes_ecb, &aes);
+#if defined(MBEDTLS_CIPHER_MODE_CBC)
+        bench_bytes(names[k][1], aes_cbc, &aes);
+#endif
+#if defined(MBEDTLS_CIPHER_MODE_CTR)
+        bench_bytes(names[k][2], aes_ctr, &aes);
+#endif
+        mbedtls_aes_free(&aes);
+    }
+}
+#endif
+
+#if defined(MBEDTLS_GCM_C)
+static int gcm(void *ctx)
+{
+    return mbedtls_gcm_crypt_and_tag((mbedtls_gcm_context *)ctx, MBEDTLS_GCM_ENCRYPT,
+                                     BUFFER_SIZE, iv, 12, NULL, 0, buffer, buffer,
+                                     sizeof(tag), tag);
+}
+
+/** Benchmark AES-GCM
+
+    Given a 128-bit AES key
+    When a buffer is encrypted and authenticated with GCM
+    Then the cycles per byte are reported
+ */
+void test_gcm()
+{
+    mbedtls_gcm_context ctx;
+    mbedtls_gcm_init(&ctx);
+    TEST_ASSERT_EQUAL(0, mbedtls_gcm_setkey(&ctx, MBEDTLS_CIPHER_ID_AES, key, 128));
+    bench_bytes("aes128_gcm" AES_IMPL, gcm, &ctx);
+    mbedtls_gcm_free(&ctx);
+}
+#endif
+
+#if defined(MBEDTLS_CCM_C)
+static int ccm(void *ctx)
+{
+    return mbedtls_ccm_encrypt_and_tag((mbedtls_ccm_context *)ctx, BUFFER_SIZE,
+                                       iv, 12, NULL, 0, buffer, buffer, tag, sizeof(tag));
+}
+
+/** Benchmark AES-CCM
+
+    Given a 128-bit AES key
+    When a buffer is encrypted and authenticated with CCM
+    Then the cycles per byte are reported
+ */
+void test_ccm()
+{
+    mbedtls_ccm_context ctx;
+    mbedtls_ccm_init(&ctx);
+    TEST_ASSERT_EQUAL(0, mbedtls_ccm_setkey(&ctx, MBEDTLS_CIPHER_ID_AES, key, 128));
+    bench_bytes("aes128_ccm" AES_IMPL, ccm, &ctx);
+    mbedtls_ccm_free(&ctx);
+}
+#endif
+
+#if defined(MBEDTLS_SHA256_C)
+static int sha256(void *ctx)
+{
+    mbedtls_sha256(buffer, BUFFER_SIZE, (unsigned char *)ctx, 0);
+    return 0;
+}
+
+/** Benchmark SHA-256
+
+    Given a buffer
+    When its SHA-256 digest is computed
+    Then the cycles per byte are reported
+ */
+void test_sha256()
+{
+    unsigned char digest[32];
+    bench_bytes("sha256" SHA256_IMPL, sha256, digest);
+}
+#endif
+
+#if defined(MBEDTLS_SHA512_C)
+static int sha512(void *ctx)
+{
+    mbedtls_sha512(buffer, BUFFER_SIZE, (unsigned char *)ctx, 0);
+    return 0;
+}
+
+/** Benchmark SHA-512
+
+    Given a buffer
+    When its SHA-512 digest is computed
+    Then the cycles per byte are reported
+ */
+void test_sha512()
+{
+    unsigned char digest[64];
+    bench_bytes("sha512" SHA512_IMPL, sha512, digest);
+}
+#endif
+
+#if defined(MBEDTLS_ECP_C)
+struct ecp_bench {
+    mbedtls_ecp_group grp;
+    mbedtls_mpi d;
+    mbedtls_ecp_point Q;
+    mbedtls_mpi r;
+    mbedtls_mpi s;
+    mbedtls_mpi z;
+    mbedtls_mpi peer_d;
+    mbedtls_ecp_point peer_Q;
+};
+
+static void ecp_bench_init(ecp_bench *b, mbedtls_ecp_group_id id)
+{
+    mbedtls_ecp_group_init(&b->grp);
+    mbedtls_mpi_init(&b->d);
+    mbedtls_ecp_point_init(&b->Q);
+    mbedtls_mpi_init(&b->r);
+    mbedtls_mpi_init(&b->s);
+    mbedtls_mpi_init(&b->z);
+    mbedtls_mpi_init(&b->peer_d);
+    mbedtls_ecp_point_init(&b->peer_Q);
+
+    TEST_ASSERT_EQUAL(0, mbedtls_ecp_group_load(&b->grp, id));
+    TEST_ASSERT_EQUAL(0, mbedtls_ecp_gen_keypair(&b->grp, &b->d, &b->Q, bench_rng, NULL));
+    TEST_ASSERT_EQUAL(0, mbedtls_ecp_gen_keypair(&b->grp, &b->peer_d, &b->peer_Q, bench_rng, NULL));
+}
+
+static void ecp_bench_free(ecp_bench *b)
+{
+    mbedtls_ecp_point_free(&b->peer_Q);
+    mbedtls_mpi_free(&b->peer_d);
+    mbedtls_mpi_free(&b->z);
+    mbedtls_mpi_free(&b->s);
+    mbedtls_mpi_free(&b->r);
+    mbedtls_ecp_point_free(&b->Q);
+    mbedtls_mpi_free(&b->d);
+    mbedtls_ecp_group_free(&b->grp);
+}
+
+#if defined(MBEDTLS_ECDH_C)
+/* A full exchange: an ephemeral key pair and the shared secret */
+static int ecdh(void *ctx)
+{
+    ecp_bench *b = (ecp_bench *)ctx;
+    int err = mbedtls_ecdh_gen_public(&b->grp, &b->d, &b->Q, bench_rng, NULL);
+    if (!err) {
+        err = mbedtls_ecdh_compute_shared(&b->grp, &b->z, &b->peer_Q, &b->d, bench_rng, NULL);
+    }
+    return err;
+}
+#endif
+
+#if defined(MBEDTLS_ECDSA_C)
+static int ecdsa_sign(void *ctx)
+{
+    ecp_bench *b = (ecp_bench *)ctx;
+    return mbedtls_ecdsa_sign(&b->grp, &b->r, &b->s, &b->d, buffer, 32, bench_rng, NULL);
+}
+
+static int ecdsa_verify(void *ctx)
+{
+    ecp_bench *b = (ecp_bench *)ctx;
+    return mbedtls_ecdsa_verify(&b->grp, buffer, 32, &b->Q, &b->r, &b->s);
+}
+#endif
+
+#if defined(MBEDTLS_ECP_DP_SECP256R1_ENABLED)
+/** Benchmark secp256r1
+
+    Given secp256r1 key pairs
+    When ECDSA signatures are made and verified and ECDH exchanges run
+    Then the operations per second are reported
+ */
+void test_secp256r1()
+{
+    ecp_bench b;
+    ecp_bench_init(&b, MBEDTLS_ECP_DP_SECP256R1);
+#if defined(MBEDTLS_ECDSA_C)
+    bench_ops("ecdsa_p256_sign" P256_IMPL, ecdsa_sign, &b);
+    bench_ops("ecdsa_p256_verify" P256_IMPL, ecdsa_verify, &b);
+#endif
+#if defined(MBEDTLS_ECDH_C)
+    bench_ops("ecdh_p256" P256_IMPL, ecdh, &b);
+#endif
+    ecp_bench_free(&b);
+}
+#endif
+
+#if defined(MBEDTLS_ECP_DP_CURVE25519_ENABLED) && defined(MBEDTLS_ECDH_C)
+/** Benchmark X25519
+
+    Given Curve25519 key pairs
+    When ECDH exchanges run
+    Then the operations per second are reported
+ */
+void test_x25519()
+{
+    ecp_bench b;
+    ecp_bench_init(&b, MBEDTLS_ECP_DP_CURVE25519);
+    bench_ops("ecdh_x25519" X25519_IMPL, ecdh, &b);
+    ecp_bench_free(&b);
+}
+#endif
+#endif
+
+#if defined(MBEDTLS_RSA_C)
+/* A fixed RSA-2048 key, generating one on the target takes too long */
+#define RSA_N \
+    "A5C4678A7CD5A881DD0E6847B6E97EBBCE41734B649725B5774BEA063AF4EA02" \
+    "1546D70E502FA8D3E37DF8C9DD3BED174AD966386D51702CE3F431BD0A08CB3A" \
+    "B719020751156F2C6E666F171897A5D7B28E8B7513DEF9BBE512F5D88EE482CD" \
+    "740612BDF2E82DCFCE4EBFECC7EB96C7FE0462CA467E0BF5AB6E98245E1048CD" \
+    "A36B9D5245BDCE0AC0F1652A2F8FD91982544520BE67ADEF3CCE59006E4DACF1" \
+    "9033FB7AEF3154A661E09962A307898F7235DF9D6F8BA7A4DAB6A7653E90EC75" \
+    "F780E70A2B5644116A31484D75054935F7C0E71A827B871C4227A27E178CE1E6" \
+    "3C07EABF4A79CD706F0BAB645F8C103B01B0F77AD1E169E605FC9AF0C6FA9FE9"
+
+#define RSA_D \
+    "4CBC68BA0123DF078ECF5692AC27D6D5159BD2C579E1464184E20D89A8CD2B6E" \
+    "9F6ED5AAF88FB775AEFFE7A57AD67CE0A573921058FAB414F3C95D25077A1EAA" \
+    "258C5C160B01031FEC535AE5B42AAF48F48D6C1D5C7F81D7EB2925C9840C6048" \
+    "BF86F8321A3A44CAC7D448A051C3CB5EF5460E7D58B88CCCC2F94550C0828550" \
+    "7D7B2D327FCD42B706AF613AF4764B5CB9EECFF291E8C09476DCE65DB065D3CE" \
+    "948EE19DC802BCA9912981F9D720C520EDB579DD86D496E91A17F6377A210B23" \
+    "AE60595438007F4A01F27AD4865B8AE3146BF721B13657299D3B3A5CC2D6D32F" \
+    "481750AE2DDCBAB1C3360E4554391C7ED849077108A3C6C840F5CF4E725E841"
+
+#define RSA_P \
+    "D86C2FCC8AF9B01C2BFE432548A16E2465F8EDDB4F450A4B52DF8F4F1C91FEC5" \
+    "5311D54A862F8FAAD99B39FF6EE1BAD889AD0E820B3D03A50F6288421E32A811" \
+    "6F5D487B68F697D3E6D197530545D2ED43B7FA5260DD375AAD3A3D5605145A74" \
+    "5787B5132EE8385758CD31DCF61AA92BA95DB0D498C95D31AB13418F4F5E06A9"
+
+#define RSA_Q \
+    "C414C9ABC2C4802F464D3CC3FF5FF6EC3908AE420F5DE3795278A8A0670D60BD" \
+    "685782E2E1F0910D08E510C83BF0825E1D26EB715ADF4A9FAC896E946A66B1D9" \
+    "0484D4A4623D2EE4E255797680B0FD055AD9B99D729BCB3555A21CC5F1205508" \
+    "A81C906BF045D1A9E7B78D20B6CD1ED42B59B54EE2E610F50734137E2D4BD741"
+
+#define RSA_DP \
+    "C7AB88ADFDCA3F60BE75E71D0ED560F8D3DBC617001B8253DC31C5D60755EAE7" \
+    "C2AC414C706090FBDFA806EA53328F60182541AD591101BBD765E0B09F8BBCE3" \
+    "D90B074454A2AD9122F35BD98C93CEF677F3D54F0B6F0D12EB9F3FD78CF82A3C" \
+    "0C45781A2ABCB4BE617F6EF19D5D1B96DCBB43D9E0DC66CEDC36F7D570341F9"
+
+#define RSA_DQ \
+    "BE60EC9A1F0608EB5D97BA6B1675875A3DDA06CF4EFA3AD55DD496ECFE8187AE" \
+    "FF33107AD7226AC33C22A413B5D6C3CD3B02C1D09289807BDDDAA609E5F105B6" \
+    "8EE3A54E61AFC3EB2932123793A5C454C1ABE9C34C36A5AB881459597ACF88A0" \
+    "5A1139CC0342D6D9DF8860B725A5ACCC15B70909A9D5F51AE2BE963A89223CC1"
+
+#define RSA_QP \
+    "D024A4B4FB62F8C4C5B0BC311D7AB16E5D1C9BC41F8B48662B50184722B65134" \
+    "1BE0387D27BD0DBC556C1C8DB162DE2F3A3D3272F8FBD57338EF6F2458E3D13E" \
+    "1ECD7E69F007B25853A714E439958D5A271E8CF92905B58C1F0E6ACF3AA949FC" \
+    "BB411B091EAABDFC7570853B57DBA62EE6BF34928A9E44926D63920D16372680"
+
+static int rsa_private(void *ctx)
+{
+    return mbedtls_rsa_private((mbedtls_rsa_context *)ctx, bench_rng, NULL, buffer, buffer);
+}
+
+static int rsa_public(void *ctx)
+{
+    return mbedtls_rsa_public((mbedtls_rsa_context *)ctx, buffer, buffer);
+}
+
+/** Benchmark RSA-2048
+
+    Given an RSA-2048 key
+    When private (signing, decryption) and public key operations run
+    Then the operations per second are reported
+ */
+void test_rsa()
+{
+    mbedtls_rsa_context rsa;
+    mbedtls_rsa_init(&rsa, MBEDTLS_RSA_PKCS_V15, 0);
+
+    TEST_ASSERT_EQUAL(0, mbedtls_mpi_read_string(&rsa.N, 16, RSA_N));
+    TEST_ASSERT_EQUAL(0, mbedtls_mpi_lset(&rsa.E, 65537));
+    TEST_ASSERT_EQUAL(0, mbedtls_mpi_read_string(&rsa.D, 16, RSA_D));
+    TEST_ASSERT_EQUAL(0, mbedtls_mpi_read_string(&rsa.P, 16, RSA_P));
+    TEST_ASSERT_EQUAL(0, mbedtls_mpi_read_string(&rsa.Q, 16, RSA_Q));
+    TEST_ASSERT_EQUAL(0, mbedtls_mpi_read_string(&rsa.DP, 16, RSA_DP));
+    TEST_ASSERT_EQUAL(0, mbedtls_mpi_read_string(&rsa.DQ, 16, RSA_DQ));
+    TEST_ASSERT_EQUAL(0, mbedtls_mpi_read_string(&rsa.QP, 16, RSA_QP));
+    rsa.len = mbedtls_mpi_size(&rsa.N);
+    TEST_ASSERT_EQUAL(0, mbedtls_rsa_check_privkey(&rsa));
+
+    // Any input below the modulus will do
+    memset(buffer, 0x5a, rsa.len);
+    buffer[0] = 0;
+
+    bench_ops("rsa2048_private" RSA_IMPL, rsa_private, &rsa);
+    bench_ops("rsa2048_public" RSA_IMPL, rsa_public, &rsa);
+    mbedtls_rsa_free(&rsa);
+}
+#endif
+
+utest::v1::status_t test_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(300, "benchmark_report");
+    stamp_init();
+    greentea_send_kv("bench_clock", (int)SystemCoreClock);
+    return verbose_test_setup_handler(number_of_cases);
+}
+
+Case cases[] = {
+#if defined(MBEDTLS_AES_C)
+    Case("Benchmark AES", test_aes),
+#endif
+#if defined(MBEDTLS_GCM_C)
+    Case("Benchmark AES-GCM", test_gcm),
+#endif
+#if defined(MBEDTLS_CCM_C)
+    Case("Benchmark AES-CCM", test_ccm),
+#endif
+#if defined(MBEDTLS_SHA256_C)
+    Case("Benchmark SHA-256", test_sha256),
+#endif
+#if defined(MBEDTLS_SHA512_C)
+    Case("Benchmark SHA-512", test_sha512),
+#endif
+#if defined(MBEDTLS_ECP_C) && defined(MBEDTLS_ECP_DP_SECP256R1_ENABLED)
+    Case("Benchmark secp256r1", test_secp256r1),
+#endif
+#if defined(MBEDTLS_ECP_C) && defined(MBEDTLS_ECP_DP_CURVE25519_ENABLED) && defined(MBEDTLS_ECDH_C)
+    Case("Benchmark X25519", test_x25519),
+#endif
+#if defined(MBEDTLS_RSA_C)
+    Case("Benchmark RSA-2048", test_rsa),
+#endif
+};
+
+Specification specification(test_setup, cases);
+
+int main()
+{
+    return !Harness::run(specification);
+}
@@ -0,0 +1,347 @@
+/*
+ * Copyright (c) 2017, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity/unity.h"
+#include "utest/utest.h"
+
+#include "mbedtls/config.h"
+#include "mbedtls/ecp.h"
+
+#if !defined(MBEDTLS_ECP_C) || !defined(MBEDTLS_ECP_DP_SECP256R1_ENABLED) || \
+    !defined(MBEDTLS_ECP_DP_CURVE25519_ENABLED)
+#error [NOT_SUPPORTED] secp256r1 and Curve25519 are not enabled
+#endif
+
+using namespace utest::v1;
+
+static void read_hex(unsigned char *buf, const char *hex, size_t len)
+{
+    for (size_t i = 0; i < len; i++) {
+        unsigned int byte;
+        sscanf(hex + 2 * i, "%2x", &byte);
+        buf[i] = byte;
+    }
+}
+
+static void assert_mpi_hex(const char *hex, const mbedtls_mpi *X)
+{
+    unsigned char expected[32];
+    unsigned char actual[32];
+    read_hex(expected, hex, sizeof(expected));
+    TEST_ASSERT_EQUAL(0, mbedtls_mpi_write_binary(X, actual, sizeof(actual)));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, actual, sizeof(actual));
+}
+
+/* Loads a group, or with generic set one whose id does not match the
+ * dedicated implementations, so mbedtls_ecp_mul uses the bignum code */
+static void load_group(mbedtls_ecp_group *grp, mbedtls_ecp_group_id id, bool generic)
+{
+    mbedtls_ecp_group_init(grp);
+    TEST_ASSERT_EQUAL(0, mbedtls_ecp_group_load(grp, id));
+    if (generic) {
+        grp->id = MBEDTLS_ECP_DP_NONE;
+    }
+}
+
+/* Little-endian X25519 scalars and u-coordinates, decoded as RFC 7748 does */
+static void read_x25519_scalar(mbedtls_mpi *k, const unsigned char le[32])
+{
+    unsigned char be[32];
+    for (int i = 0; i < 32; i++) {
+        be[i] = le[31 - i];
+    }
+    be[31] &= 248;
+    be[0] &= 127;
+    be[0] |= 64;
+    TEST_ASSERT_EQUAL(0, mbedtls_mpi_read_binary(k, be, sizeof(be)));
+}
+
+static void read_x25519_u(mbedtls_ecp_point *P, const unsigned char le[32])
+{
+    unsigned char be[32];
+    for (int i = 0; i < 32; i++) {
+        be[i] = le[31 - i];
+    }
+    be[0] &= 127;
+    TEST_ASSERT_EQUAL(0, mbedtls_mpi_read_binary(&P->X, be, sizeof(be)));
+    TEST_ASSERT_EQUAL(0, mbedtls_mpi_lset(&P->Z, 1));
+    mbedtls_mpi_free(&P->Y);
+}
+
+static void write_x25519_u(unsigned char le[32], const mbedtls_ecp_point *P)
+{
+    unsigned char be[32];
+    TEST_ASSERT_EQUAL(0, mbedtls_mpi_write_binary(&P->X, be, sizeof(be)));
+    for (int i = 0; i < 32; i++) {
+        le[i] = be[31 - i];
+    }
+}
+
+static int x25519(const mbedtls_ecp_group *grp, unsigned char out[32],
+                  const unsigned char k[32], const unsigned char u[32])
+{
+    mbedtls_mpi m;
+    mbedtls_ecp_point P;
+    mbedtls_mpi_init(&m);
+    mbedtls_ecp_point_init(&P);
+
+    read_x25519_scalar(&m, k);
+    read_x25519_u(&P, u);
+    int ret = mbedtls_ecp_mul((mbedtls_ecp_group *)grp, &P, &m, &P, NULL, NULL);
+    if (ret == 0) {
+        write_x25519_u(out, &P);
+    }
+
+    mbedtls_mpi_free(&m);
+    mbedtls_ecp_point_free(&P);
+    return ret;
+}
+
+/* Deterministic test scalars */
+static int test_rng(void *state, unsigned char *out, size_t len)
+{
+    uint32_t *x = (uint32_t *)state;
+    for (size_t i = 0; i < len; i++) {
+        *x = *x * 1103515245 + 12345;
+        out[i] = *x >> 16;
+    }
+    return 0;
+}
+
+/* Multiples of the base point, and the NIST CAVS ECDH primitive vector */
+void test_secp256r1_vectors()
+{
+    mbedtls_ecp_group grp;
+    mbedtls_ecp_point R, Q;
+    mbedtls_mpi m;
+    load_group(&grp, MBEDTLS_ECP_DP_SECP256R1, false);
+    mbedtls_ecp_point_init(&R);
+    mbedtls_ecp_point_init(&Q);
+    mbedtls_mpi_init(&m);
+
+    TEST_ASSERT_EQUAL(0, mbedtls_mpi_lset(&m, 2));
+    TEST_ASSERT_EQUAL(0, mbedtls_ecp_mul(&grp, &R, &m, &grp.G, NULL, NULL));
+    assert_mpi_hex("7cf27b188d034f7e8a52380304b51ac3c08969e277f21b35a60b48fc47669978", &R.X);
+    assert_mpi_hex("07775510db8ed040293d9ac69f7430dbba7dade63ce982299e04b79d227873d1", &R.Y);
+
+    TEST_ASSERT_EQUAL(0, mbedtls_mpi_lset(&m, 3));
+    TEST_ASSERT_EQUAL(0, mbedtls_ecp_mul(&grp, &R, &m, &grp.G, NULL, NULL));
+    assert_mpi_hex("5ecbe4d1a6330a44c8f7ef951d4bf165e6c6b721efada985fb41661bc6e7fd6c", &R.X);
+    assert_mpi_hex("8734640c4998ff7e374b06ce1a64a2ecd82ab036384fb83d9a79b127a27d5032", &R.Y);
+
+    // (n - 1)G is -G
+    TEST_ASSERT_EQUAL(0, mbedtls_mpi_sub_int(&m, &grp.N, 1));
+    TEST_ASSERT_EQUAL(0, mbedtls_ecp_mul(&grp, &R, &m, &grp.G, NULL, NULL));
+    assert_mpi_hex("6b17d1f2e12c4247f8bce6e563a440f277037d812deb33a0f4a13945d898c296", &R.X);
+    assert_mpi_hex("b01cbd1c01e58065711814b583f061e9d431cca994cea1313449bf97c840ae0a", &R.Y);
+
+    // KAS ECC CDH primitive, P-256 count 0
+    TEST_ASSERT_EQUAL(0, mbedtls_mpi_read_string(&m, 16,
+            "7d7dc5f71eb29ddaf80d6214632eeae03d9058af1fb6d22ed80badb62bc1a534"));
+    TEST_ASSERT_EQUAL(0, mbedtls_ecp_mul(&grp, &R, &m, &grp.G, NULL, NULL));
+    assert_mpi_hex("ead218590119e8876b29146ff89ca61770c4edbbf97d38ce385ed281d8a6b230", &R.X);
+    assert_mpi_hex("28af61281fd35e2fa7002523acc85a429cb06ee6648325389f59edfce1405141", &R.Y);
+
+    TEST_ASSERT_EQUAL(0, mbedtls_mpi_read_string(&Q.X, 16,
+            "700c48f77f56584c5cc632ca65640db91b6bacce3a4df6b42ce7cc838833d287"));
+    TEST_ASSERT_EQUAL(0, mbedtls_mpi_read_string(&Q.Y, 16,
+            "db71e509e3fd9b060ddb20ba5c51dcc5948d46fbf640dfe0441782cab85fa4ac"));
+    TEST_ASSERT_EQUAL(0, mbedtls_mpi_lset(&Q.Z, 1));
+    TEST_ASSERT_EQUAL(0, mbedtls_ecp_mul(&grp, &R, &m, &Q, NULL, NULL));
+    assert_mpi_hex("46fc62106420ff012e54a434fbdd2d25ccc5852060561e68040dd7778997bd7b", &R.X);
+
+    // Invalid scalars are still rejected
+    TEST_ASSERT_EQUAL(0, mbedtls_mpi_lset(&m, 0));
+    TEST_ASSERT_EQUAL(MBEDTLS_ERR_ECP_INVALID_KEY, mbedtls_ecp_mul(&grp, &R, &m, &grp.G, NULL, NULL));
+
+    mbedtls_mpi_free(&m);
+    mbedtls_ecp_point_free(&R);
+    mbedtls_ecp_point_free(&Q);
+    mbedtls_ecp_group_free(&grp);
+}
+
+/* RFC 7748 section 5.2 and 6.1 */
+void test_x25519_vectors()
+{
+    mbedtls_ecp_group grp;
+    load_group(&grp, MBEDTLS_ECP_DP_CURVE25519, false);
+    unsigned char k[32], u[32], out[32], expected[32];
+
+    read_hex(k, "a546e36bf0527c9d3b16154b82465edd62144c0ac1fc5a18506a2244ba449ac4", 32);
+    read_hex(u, "e6db6867583030db3594c1a424b15f7c726624ec26b3353b10a903a6d0ab1c4c", 32);
+    read_hex(expected, "c3da55379de9c6908e94ea4df28d084f32eccf03491c71f754b4075577a28552", 32);
+    TEST_ASSERT_EQUAL(0, x25519(&grp, out, k, u));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, out, 32);
+
+    // The u-coordinate has bit 255 set, which is masked when decoding it
+    read_hex(k, "4b66e9d4d1b4673c5ad22691957d6af5c11b6421e0ea01d42ca4169e7918ba0d", 32);
+    read_hex(u, "e5210f12786811d3f4b7959d0538ae2c31dbe7106fc03c3efc4cd549c715a493", 32);
+    read_hex(expected, "95cbde9476e8907d7aade45cb4b873f88b595a68799fa152e6f8f7647aac7957", 32);
+    TEST_ASSERT_EQUAL(0, x25519(&grp, out, k, u));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, out, 32);
+
+    // Diffie-Hellman
+    unsigned char alice[32], bob[32], alice_pub[32], bob_pub[32], base[32] = {9};
+    read_hex(alice, "77076d0a7318a57d3c16c17251b26645df4c2f87ebc0992ab177fba51db92c2a", 32);
+    read_hex(bob, "5dab087e624a8a4b79e17f8b83800ee66f3bb1292618b6fd1c2f8b27ff88e0eb", 32);
+    TEST_ASSERT_EQUAL(0, x25519(&grp, alice_pub, alice, base));
+    read_hex(expected, "8520f0098930a754748b7ddcb43ef75a0dbf3a0d26381af4eba4a98eaa9b4e6a", 32);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, alice_pub, 32);
+    TEST_ASSERT_EQUAL(0, x25519(&grp, bob_pub, bob, base));
+    read_hex(expected, "de9edb7d7b7dc1b4d35b61c2ece435373f8343c85b78674dadfc7e146f882b4f", 32);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, bob_pub, 32);
+
+    read_hex(expected, "4a5d9d5ba4ce2de1728e3bf480350f25e07e21c947d19e3376f09b3c1e161742", 32);
+    TEST_ASSERT_EQUAL(0, x25519(&grp, out, alice, bob_pub));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, out, 32);
+    TEST_ASSERT_EQUAL(0, x25519(&grp, out, bob, alice_pub));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, out, 32);
+
+    mbedtls_ecp_group_free(&grp);
+}
+
+/* RFC 7748 section 5.2, k and u start at 9 and each result becomes k, the
+ * 1000 iterations only with the dedicated implementation as the generic
+ * one takes too long */
+void test_x25519_iterated()
+{
+    mbedtls_ecp_group grp;
+    load_group(&grp, MBEDTLS_ECP_DP_CURVE25519, false);
+    unsigned char k[32] = {9}, u[32] = {9}, out[32], expected[32];
+
+#if defined(MBEDTLS_ECP_FAST_CURVE25519)
+    const int iterations = 1000;
+#else
+    const int iterations = 1;
+#endif
+    for (int i = 1; i <= iterations; i++) {
+        TEST_ASSERT_EQUAL(0, x25519(&grp, out, k, u));
+        memcpy(u, k, 32);
+        memcpy(k, out, 32);
+
+        if (i == 1) {
+            read_hex(expected, "422c8e7a6227d7bca1350b3e2bb7279f7897b87bb6854b783c60e80311ae3079", 32);
+            TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, k, 32);
+        } else if (i == 1000) {
+            read_hex(expected, "684cf59ba83309552800ef566f2f4d3c1c3887c49360e3875f2eb94d99532c51", 32);
+            TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, k, 32);
+        }
+    }
+
+    mbedtls_ecp_group_free(&grp);
+}
+
+/* u-coordinates of 2^255 and more are rejected by both implementations */
+void test_x25519_large_u()
+{
+    for (int generic = 0; generic < 2; generic++) {
+        mbedtls_ecp_group grp;
+        mbedtls_ecp_point P;
+        mbedtls_mpi m;
+        load_group(&grp, MBEDTLS_ECP_DP_CURVE25519, generic);
+        mbedtls_ecp_point_init(&P);
+        mbedtls_mpi_init(&m);
+
+        unsigned char k[32] = {9};
+        read_x25519_scalar(&m, k);
+        TEST_ASSERT_EQUAL(0, mbedtls_mpi_lset(&P.Z, 1));
+
+        TEST_ASSERT_EQUAL(0, mbedtls_mpi_lset(&P.X, 9));
+        TEST_ASSERT_EQUAL(0, mbedtls_mpi_set_bit(&P.X, 255, 1));
+        TEST_ASSERT_EQUAL(MBEDTLS_ERR_ECP_INVALID_KEY, mbedtls_ecp_mul(&grp, &P, &m, &P, NULL, NULL));
+
+        // p + 9 is below 2^255 and taken as 9
+        TEST_ASSERT_EQUAL(0, mbedtls_mpi_add_int(&P.X, &grp.P, 9));
+        TEST_ASSERT_EQUAL(0, mbedtls_ecp_mul(&grp, &P, &m, &P, NULL, NULL));
+
+        mbedtls_mpi_free(&m);
+        mbedtls_ecp_point_free(&P);
+        mbedtls_ecp_group_free(&grp);
+    }
+}
+
+/* The dedicated implementations give the results of the generic code */
+static void compare_generic(mbedtls_ecp_group_id id)
+{
+    mbedtls_ecp_group grp, generic;
+    mbedtls_ecp_point R, S, P;
+    mbedtls_mpi m;
+    load_group(&grp, id, false);
+    load_group(&generic, id, true);
+    mbedtls_ecp_point_init(&R);
+    mbedtls_ecp_point_init(&S);
+    mbedtls_ecp_point_init(&P);
+    mbedtls_mpi_init(&m);
+    uint32_t state = 1;
+
+    for (int i = 0; i < 8; i++) {
+        // A random point, then the random scalar of another key pair
+        TEST_ASSERT_EQUAL(0, mbedtls_ecp_gen_keypair(&generic, &m, &P, test_rng, &state));
+        TEST_ASSERT_EQUAL(0, mbedtls_ecp_gen_keypair(&generic, &m, &S, test_rng, &state));
+
+        TEST_ASSERT_EQUAL(0, mbedtls_ecp_mul(&grp, &R, &m, &grp.G, NULL, NULL));
+        TEST_ASSERT_EQUAL(0, mbedtls_ecp_mul(&generic, &S, &m, &generic.G, NULL, NULL));
+        TEST_ASSERT_EQUAL(0, mbedtls_ecp_point_cmp(&R, &S));
+
+        TEST_ASSERT_EQUAL(0, mbedtls_ecp_mul(&grp, &R, &m, &P, NULL, NULL));
+        TEST_ASSERT_EQUAL(0, mbedtls_ecp_mul(&generic, &S, &m, &P, NULL, NULL));
+        TEST_ASSERT_EQUAL(0, mbedtls_ecp_point_cmp(&R, &S));
+    }
+
+    mbedtls_mpi_free(&m);
+    mbedtls_ecp_point_free(&R);
+    mbedtls_ecp_point_free(&S);
+    mbedtls_ecp_point_free(&P);
+    mbedtls_ecp_group_free(&grp);
+    mbedtls_ecp_group_free(&generic);
+}
+
+void test_secp256r1_generic()
+{
+    compare_generic(MBEDTLS_ECP_DP_SECP256R1);
+}
+
+void test_x25519_generic()
+{
+    compare_generic(MBEDTLS_ECP_DP_CURVE25519);
+}
+
+utest::v1::status_t greentea_failure_handler(const Case *const source, const failure_t reason) {
+    greentea_case_failure_abort_handler(source, reason);
+    return STATUS_CONTINUE;
+}
+
+Case cases[] = {
+    Case("ECP: secp256r1 vectors", test_secp256r1_vectors, greentea_failure_handler),
+    Case("ECP: X25519 vectors", test_x25519_vectors, greentea_failure_handler),
+    Case("ECP: X25519 iterated", test_x25519_iterated, greentea_failure_handler),
+    Case("ECP: X25519 u of 2^255 and more", test_x25519_large_u, greentea_failure_handler),
+    Case("ECP: secp256r1 against the generic code", test_secp256r1_generic, greentea_failure_handler),
+    Case("ECP: X25519 against the generic code", test_x25519_generic, greentea_failure_handler),
+};
+
+utest::v1::status_t greentea_test_setup(const size_t number_of_cases) {
+    GREENTEA_SETUP(120, "default_auto");
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+Specification specification(greentea_test_setup, cases, greentea_test_teardown_handler);
+
+int main() {
+    Harness::run(specification);
+}
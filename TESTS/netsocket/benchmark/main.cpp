@@ -0,0 +1,484 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity.h"
+#include "utest.h"
+#include "mbed_stats.h"
+
+using namespace utest::v1;
+
+/* Measures the network stack through the NetworkStack API: TCP and UDP
+ * throughput, TCP connection setup, round trip and DNS latency, and, with
+ * MBED_CPU_STATS_ENABLED, the cpu time spent per byte moved.
+ *
+ * The netsocket_benchmark host test runs discard, chargen and echo servers
+ * the target connects to, and collects the results like benchmark_report.
+ * Targets that cannot reach the host, such as cellular ones, can be given
+ * the address of a server running the standard discard (9), chargen (19)
+ * and echo (7) services with benchmark-server. The upload tests
+ * only send zeros, so an iperf 2 server ("iperf -s") can stand in for the
+ * discard service.
+ *
+ * The interface is chosen with network-interface, see template_mbed_app.txt.
+ */
+
+#define ETHERNET            1
+#define WIFI                2
+#define CELLULAR_ONBOARD    3
+
+#ifndef MBED_CONF_APP_NETWORK_INTERFACE
+#define MBED_CONF_APP_NETWORK_INTERFACE ETHERNET
+#endif
+
+#if MBED_CONF_APP_NETWORK_INTERFACE == ETHERNET
+#if !FEATURE_LWIP || DEVICE_EMAC
+#error [NOT_SUPPORTED] The target has no supported Ethernet interface
+#endif
+#include "EthernetInterface.h"
+#elif MBED_CONF_APP_NETWORK_INTERFACE == WIFI
+#if !TARGET_UBLOX_EVK_ODIN_W2
+#error [NOT_SUPPORTED] Only built in WiFi modules are supported at this time.
+#endif
+#if !defined(MBED_CONF_APP_WIFI_SSID) || !defined(MBED_CONF_APP_WIFI_PASSWORD)
+#error [NOT_SUPPORTED] MBED_CONF_APP_WIFI_SSID and MBED_CONF_APP_WIFI_PASSWORD have to be defined for this test.
+#endif
+#include "OdinWiFiInterface.h"
+#elif MBED_CONF_APP_NETWORK_INTERFACE == CELLULAR_ONBOARD
+#if !MODEM_ON_BOARD
+#error [NOT_SUPPORTED] MODEM_ON_BOARD should be set for this test to be functional
+#endif
+#include "OnboardCellularInterface.h"
+#else
+#error [NOT_SUPPORTED] Unknown network-interface
+#endif
+
+#ifndef MBED_CONF_APP_BENCHMARK_TCP_BYTES
+#define MBED_CONF_APP_BENCHMARK_TCP_BYTES   (256 * 1024)
+#endif
+
+#ifndef MBED_CONF_APP_BENCHMARK_UDP_DATAGRAMS
+#define MBED_CONF_APP_BENCHMARK_UDP_DATAGRAMS   256
+#endif
+
+#ifndef MBED_CONF_APP_BENCHMARK_UDP_SIZE
+#define MBED_CONF_APP_BENCHMARK_UDP_SIZE    512
+#endif
+
+#ifndef MBED_CONF_APP_BENCHMARK_DNS_HOST
+#define MBED_CONF_APP_BENCHMARK_DNS_HOST    "connector.mbed.com"
+#endif
+
+#define BUFFER_SIZE         1024
+#define ROUNDS              3
+#define SAMPLES             16
+#define ECHO_SIZE           64
+#define RECV_TIMEOUT_MS     5000
+
+/* Cpu time spent outside the idle thread, zero without cpu statistics */
+static uint64_t busy_us()
+{
+    mbed_stats_cpu_t stats;
+    mbed_stats_cpu_get(&stats);
+    return stats.uptime - stats.idle_time;
+}
+
+static uint32_t kbit_per_s(uint64_t bytes, uint32_t us)
+{
+    return us ? bytes * 8000 / us : 0;
+}
+
+static NetworkInterface *net;
+static bool host_server;
+static char server_ip[64];
+static uint16_t discard_port;
+static uint16_t chargen_port;
+static uint16_t echo_port;
+static uint16_t udp_echo_port;
+static uint16_t udp_discard_port;
+static uint8_t buffer[BUFFER_SIZE];
+
+static NetworkInterface *get_network()
+{
+#if MBED_CONF_APP_NETWORK_INTERFACE == ETHERNET
+    static EthernetInterface eth;
+    return &eth;
+#elif MBED_CONF_APP_NETWORK_INTERFACE == WIFI
+    static OdinWiFiInterface wifi;
+    wifi.set_credentials(MBED_CONF_APP_WIFI_SSID, MBED_CONF_APP_WIFI_PASSWORD, NSAPI_SECURITY_WPA_WPA2);
+    return &wifi;
+#elif MBED_CONF_APP_NETWORK_INTERFACE == CELLULAR_ONBOARD
+    static OnboardCellularInterface cellular;
+#ifdef MBED_CONF_APP_DEFAULT_PIN
+    cellular.set_sim_pin(MBED_CONF_APP_DEFAULT_PIN);
+#endif
+#ifdef MBED_CONF_APP_APN
+    cellular.set_credentials(MBED_CONF_APP_APN, MBED_CONF_APP_USERNAME, MBED_CONF_APP_PASSWORD);
+#endif
+    return &cellular;
+#endif
+}
+
+static int tcp_open(TCPSocket *sock, uint16_t port)
+{
+    int err = sock->open(net);
+    if (err) {
+        return err;
+    }
+    sock->set_timeout(RECV_TIMEOUT_MS);
+    return sock->connect(SocketAddress(server_ip, port));
+}
+
+/** Connect to the network
+
+    Given the configured network interface
+    When it is brought up
+    Then the time taken is reported and the benchmark servers are known
+ */
+void test_connect()
+{
+    net = get_network();
+    Timer timer;
+    timer.start();
+    int err = net->connect();
+    timer.stop();
+    TEST_ASSERT_EQUAL(0, err);
+    printf("MBED: IP address is '%s'\r\n", net->get_ip_address());
+
+    bench_result_t r;
+    bench_reset(&r);
+    bench_add(&r, timer.read_ms());
+    bench_report("net_connect", "ms", &r);
+
+#ifdef MBED_CONF_APP_BENCHMARK_SERVER
+    SocketAddress address;
+    TEST_ASSERT_EQUAL(0, net->gethostbyname(MBED_CONF_APP_BENCHMARK_SERVER, &address));
+    strncpy(server_ip, address.get_ip_address(), sizeof(server_ip) - 1);
+    discard_port = 9;
+    chargen_port = 19;
+    echo_port = 7;
+    udp_echo_port = 7;
+    udp_discard_port = 9;
+    host_server = false;
+#else
+    char key[16];
+    char value[96];
+    unsigned ports[5];
+    greentea_send_kv("target_ip", net->get_ip_address());
+    greentea_send_kv("bench_server", " ");
+    greentea_parse_kv(key, value, sizeof(key), sizeof(value));
+    TEST_ASSERT_EQUAL_STRING("bench_server", key);
+    TEST_ASSERT_EQUAL(6, sscanf(value, "%63[^,],%u,%u,%u,%u,%u", server_ip,
+                                &ports[0], &ports[1], &ports[2], &ports[3], &ports[4]));
+    discard_port = ports[0];
+    chargen_port = ports[1];
+    echo_port = ports[2];
+    udp_echo_port = ports[3];
+    udp_discard_port = ports[4];
+    host_server = true;
+#endif
+    printf("MBED: Benchmark server is %s\r\n", server_ip);
+}
+
+/** Measure TCP connection setup
+
+    Given the discard server
+    When connections are opened and closed in a row
+    Then the time each connect takes is reported
+ */
+void test_tcp_connect()
+{
+    bench_result_t r;
+    bench_reset(&r);
+
+    for (int i = 0; i < SAMPLES; i++) {
+        TCPSocket sock;
+        TEST_ASSERT_EQUAL(0, sock.open(net));
+        Timer timer;
+        timer.start();
+        TEST_ASSERT_EQUAL(0, sock.connect(SocketAddress(server_ip, discard_port)));
+        timer.stop();
+        bench_add(&r, timer.read_us());
+        sock.close();
+    }
+
+    bench_report("tcp_connect", "us", &r);
+}
+
+/** Measure TCP upload throughput
+
+    Given a connection to the discard server
+    When benchmark-tcp-bytes are sent through it
+    Then the throughput and the cpu time per byte are reported
+ */
+void test_tcp_upload()
+{
+    bench_result_t rate, cpu;
+    bench_reset(&rate);
+    bench_reset(&cpu);
+    memset(buffer, 0, sizeof(buffer));
+
+    for (int round = 0; round < ROUNDS; round++) {
+        TCPSocket sock;
+        TEST_ASSERT_EQUAL(0, tcp_open(&sock, discard_port));
+
+        Timer timer;
+        uint64_t busy = busy_us();
+        timer.start();
+        uint32_t sent = 0;
+        while (sent < MBED_CONF_APP_BENCHMARK_TCP_BYTES) {
+            int ret = sock.send(buffer, sizeof(buffer));
+            TEST_ASSERT(ret > 0);
+            sent += ret;
+        }
+        timer.stop();
+        busy = busy_us() - busy;
+        sock.close();
+
+        bench_add(&rate, kbit_per_s(sent, timer.read_us()));
+        bench_add(&cpu, busy * 1000 / sent);
+    }
+
+    bench_report("tcp_upload", "kbit/s", &rate);
+    bench_report("tcp_upload_cpu", "ns/B", &cpu);
+}
+
+/** Measure TCP download throughput
+
+    Given a connection to the chargen server
+    When benchmark-tcp-bytes are received from it
+    Then the throughput and the cpu time per byte are reported
+ */
+void test_tcp_download()
+{
+    bench_result_t rate, cpu;
+    bench_reset(&rate);
+    bench_reset(&cpu);
+
+    for (int round = 0; round < ROUNDS; round++) {
+        TCPSocket sock;
+        TEST_ASSERT_EQUAL(0, tcp_open(&sock, chargen_port));
+
+        Timer timer;
+        uint64_t busy = busy_us();
+        timer.start();
+        uint32_t received = 0;
+        while (received < MBED_CONF_APP_BENCHMARK_TCP_BYTES) {
+            int ret = sock.recv(buffer, sizeof(buffer));
+            TEST_ASSERT(ret > 0);
+            received += ret;
+        }
+        timer.stop();
+        busy = busy_us() - busy;
+        sock.close();
+
+        bench_add(&rate, kbit_per_s(received, timer.read_us()));
+        bench_add(&cpu, busy * 1000 / received);
+    }
+
+    bench_report("tcp_download", "kbit/s", &rate);
+    bench_report("tcp_download_cpu", "ns/B", &cpu);
+}
+
+/** Measure TCP round trip latency
+
+    Given a connection to the echo server
+    When small messages are sent and their echo awaited one at a time
+    Then the round trip time is reported
+ */
+void test_tcp_round_trip()
+{
+    bench_result_t r;
+    bench_reset(&r);
+
+    TCPSocket sock;
+    TEST_ASSERT_EQUAL(0, tcp_open(&sock, echo_port));
+    for (int i = 0; i < ECHO_SIZE; i++) {
+        buffer[i] = i;
+    }
+
+    for (int i = 0; i < SAMPLES; i++) {
+        Timer timer;
+        timer.start();
+        TEST_ASSERT_EQUAL(ECHO_SIZE, sock.send(buffer, ECHO_SIZE));
+        int received = 0;
+        while (received < ECHO_SIZE) {
+            int ret = sock.recv(buffer + BUFFER_SIZE / 2 + received, ECHO_SIZE - received);
+            TEST_ASSERT(ret > 0);
+            received += ret;
+        }
+        timer.stop();
+        TEST_ASSERT_EQUAL_MEMORY(buffer, buffer + BUFFER_SIZE / 2, ECHO_SIZE);
+        bench_add(&r, timer.read_us());
+    }
+
+    sock.close();
+    bench_report("tcp_round_trip", "us", &r);
+}
+
+/** Measure UDP upload throughput
+
+    Given the UDP discard server
+    When benchmark-udp-datagrams are sent to it as fast as possible
+    Then the rate they are sent at, and with the host test the rate they
+    arrive at and the share that is lost, are reported
+ */
+void test_udp_upload()
+{
+    bench_result_t rate, cpu;
+    bench_reset(&rate);
+    bench_reset(&cpu);
+    memset(buffer, 0, sizeof(buffer));
+
+    UDPSocket sock;
+    TEST_ASSERT_EQUAL(0, sock.open(net));
+    SocketAddress address(server_ip, udp_discard_port);
+
+    Timer timer;
+    uint64_t busy = busy_us();
+    timer.start();
+    uint32_t sent = 0;
+    for (int i = 0; i < MBED_CONF_APP_BENCHMARK_UDP_DATAGRAMS; i++) {
+        int ret = sock.sendto(address, buffer, MBED_CONF_APP_BENCHMARK_UDP_SIZE);
+        if (ret == NSAPI_ERROR_NO_MEMORY || ret == NSAPI_ERROR_WOULD_BLOCK) {
+            continue;
+        }
+        TEST_ASSERT_EQUAL(MBED_CONF_APP_BENCHMARK_UDP_SIZE, ret);
+        sent += ret;
+    }
+    timer.stop();
+    busy = busy_us() - busy;
+    sock.close();
+
+    bench_add(&rate, kbit_per_s(sent, timer.read_us()));
+    bench_add(&cpu, busy * 1000 / MBED_CONF_APP_BENCHMARK_UDP_DATAGRAMS / MBED_CONF_APP_BENCHMARK_UDP_SIZE);
+    bench_report("udp_upload_sent", "kbit/s", &rate);
+    bench_report("udp_upload_cpu", "ns/B", &cpu);
+
+    if (host_server) {
+        char key[16];
+        char value[16];
+        unsigned long received = 0;
+        wait_ms(500);
+        greentea_send_kv("udp_received", " ");
+        greentea_parse_kv(key, value, sizeof(key), sizeof(value));
+        sscanf(value, "%lu", &received);
+
+        bench_result_t loss;
+        bench_reset(&rate);
+        bench_reset(&loss);
+        bench_add(&rate, kbit_per_s(received, timer.read_us()));
+        bench_add(&loss, 100 - received * 100 / (MBED_CONF_APP_BENCHMARK_UDP_DATAGRAMS * MBED_CONF_APP_BENCHMARK_UDP_SIZE));
+        bench_report("udp_upload_received", "kbit/s", &rate);
+        bench_report("udp_upload_loss", "%", &loss);
+    }
+}
+
+/** Measure UDP round trip latency
+
+    Given the UDP echo server
+    When small datagrams are sent and their echo awaited one at a time
+    Then the round trip time of the datagrams that come back is reported
+ */
+void test_udp_round_trip()
+{
+    bench_result_t r;
+    bench_reset(&r);
+
+    UDPSocket sock;
+    TEST_ASSERT_EQUAL(0, sock.open(net));
+    sock.set_timeout(1000);
+    SocketAddress address(server_ip, udp_echo_port);
+
+    for (int i = 0; i < SAMPLES; i++) {
+        memset(buffer, i, ECHO_SIZE);
+        Timer timer;
+        timer.start();
+        TEST_ASSERT_EQUAL(ECHO_SIZE, sock.sendto(address, buffer, ECHO_SIZE));
+        SocketAddress from;
+        int ret = sock.recvfrom(&from, buffer + BUFFER_SIZE / 2, ECHO_SIZE);
+        timer.stop();
+        if (ret == ECHO_SIZE && !memcmp(buffer, buffer + BUFFER_SIZE / 2, ECHO_SIZE)) {
+            bench_add(&r, timer.read_us());
+        }
+    }
+
+    sock.close();
+    TEST_ASSERT(r.count > 0);
+    bench_report("udp_round_trip", "us", &r);
+}
+
+/** Measure DNS latency
+
+    Given benchmark-dns-host
+    When it is looked up once and then again while the stack may cache it
+    Then the time of the first and of the later lookups is reported
+ */
+void test_dns()
+{
+    bench_result_t first, cached;
+    bench_reset(&first);
+    bench_reset(&cached);
+
+    for (int i = 0; i < SAMPLES; i++) {
+        SocketAddress address;
+        Timer timer;
+        timer.start();
+        TEST_ASSERT_EQUAL(0, net->gethostbyname(MBED_CONF_APP_BENCHMARK_DNS_HOST, &address));
+        timer.stop();
+        bench_add(i ? &cached : &first, timer.read_us());
+    }
+
+    bench_report("dns_lookup_first", "us", &first);
+    bench_report("dns_lookup_cached", "us", &cached);
+}
+
+void test_disconnect()
+{
+    TEST_ASSERT_EQUAL(0, net->disconnect());
+}
+
+utest::v1::status_t greentea_failure_handler(const Case *const source, const failure_t reason)
+{
+    greentea_case_failure_abort_handler(source, reason);
+    return STATUS_CONTINUE;
+}
+
+Case cases[] = {
+    Case("Connect to the network", test_connect, greentea_failure_handler),
+    Case("Measure TCP connection setup", test_tcp_connect, greentea_failure_handler),
+    Case("Measure TCP upload throughput", test_tcp_upload, greentea_failure_handler),
+    Case("Measure TCP download throughput", test_tcp_download, greentea_failure_handler),
+    Case("Measure TCP round trip latency", test_tcp_round_trip, greentea_failure_handler),
+    Case("Measure UDP upload throughput", test_udp_upload, greentea_failure_handler),
+    Case("Measure UDP round trip latency", test_udp_round_trip, greentea_failure_handler),
+    Case("Measure DNS latency", test_dns, greentea_failure_handler),
+    Case("Disconnect from the network", test_disconnect, greentea_failure_handler),
+};
+
+utest::v1::status_t greentea_test_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(300, "netsocket_benchmark");
+    greentea_send_kv("bench_clock", (int)SystemCoreClock);
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+Specification specification(greentea_test_setup, cases, greentea_test_teardown_handler);
+
+int main()
+{
+    Harness::run(specification);
+}
@@ -0,0 +1,344 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "mbed.h"
+#include "netsocket/NetworkStack.h"
+#include "netsocket/nsapi_dns.h"
+#include "greentea-client/test_env.h"
+#include "unity.h"
+#include "utest.h"
+
+#if MBED_CONF_NSAPI_DNS_CACHE_SIZE == 0
+#error [NOT_SUPPORTED] DNS cache disabled
+#endif
+
+using namespace utest::v1;
+
+#define PACKET_SIZE     512
+
+/* Stack whose UDP sockets reach a single DNS server, played by the test.
+ * Every question is answered at once with answer_count addresses of the
+ * asked family, 10.0.0.1, 10.0.0.2, ... or 2001:db8::1, ..., with a TTL of
+ * answer_ttl seconds.
+ */
+class DNSServerStack : public NetworkStack {
+public:
+    unsigned queries;
+    char last_host[64];
+    unsigned answer_count;
+    uint32_t answer_ttl;
+
+    DNSServerStack() {
+        reset();
+    }
+
+    void reset() {
+        queries = 0;
+        last_host[0] = '\0';
+        answer_count = 1;
+        answer_ttl = 60;
+        _response_len = 0;
+    }
+
+    virtual const char *get_ip_address() {
+        return "10.0.0.2";
+    }
+
+protected:
+    virtual nsapi_error_t socket_open(nsapi_socket_t *handle, nsapi_protocol_t proto) {
+        *handle = this;
+        return proto == NSAPI_UDP ? NSAPI_ERROR_OK : NSAPI_ERROR_UNSUPPORTED;
+    }
+
+    virtual nsapi_error_t socket_close(nsapi_socket_t handle) {
+        return NSAPI_ERROR_OK;
+    }
+
+    virtual nsapi_error_t socket_bind(nsapi_socket_t handle, const SocketAddress &address) {
+        return NSAPI_ERROR_OK;
+    }
+
+    virtual nsapi_error_t socket_listen(nsapi_socket_t handle, int backlog) {
+        return NSAPI_ERROR_UNSUPPORTED;
+    }
+
+    virtual nsapi_error_t socket_connect(nsapi_socket_t handle, const SocketAddress &address) {
+        return NSAPI_ERROR_UNSUPPORTED;
+    }
+
+    virtual nsapi_error_t socket_accept(nsapi_socket_t server,
+            nsapi_socket_t *handle, SocketAddress *address) {
+        return NSAPI_ERROR_UNSUPPORTED;
+    }
+
+    virtual nsapi_size_or_error_t socket_send(nsapi_socket_t handle,
+            const void *data, nsapi_size_t size) {
+        return NSAPI_ERROR_UNSUPPORTED;
+    }
+
+    virtual nsapi_size_or_error_t socket_recv(nsapi_socket_t handle,
+            void *data, nsapi_size_t size) {
+        return NSAPI_ERROR_UNSUPPORTED;
+    }
+
+    // Answers the question right away
+    virtual nsapi_size_or_error_t socket_sendto(nsapi_socket_t handle, const SocketAddress &address,
+            const void *data, nsapi_size_t size) {
+        const uint8_t *question = (const uint8_t *)data;
+        TEST_ASSERT(size > 12 && size <= PACKET_SIZE);
+        queries++;
+
+        // the host name, from its labels after the header
+        nsapi_size_t end = 12;
+        size_t host_len = 0;
+        while (question[end]) {
+            uint8_t len = question[end++];
+            TEST_ASSERT(host_len + len + 1 < sizeof(last_host));
+            if (host_len) {
+                last_host[host_len++] = '.';
+            }
+            memcpy(last_host + host_len, question + end, len);
+            host_len += len;
+            end += len;
+        }
+        last_host[host_len] = '\0';
+        end += 1;
+        uint16_t type = (question[end] << 8) | question[end + 1];
+        end += 4;
+
+        // header and question of the response
+        uint8_t *p = _response;
+        memcpy(p, question, end);
+        p[2] = 0x81;
+        p[3] = 0x80;
+        p[6] = 0;
+        p[7] = answer_count;
+        p += end;
+
+        for (unsigned i = 0; i < answer_count; i++) {
+            const uint8_t name[] = { 0xc0, 12 };
+            memcpy(p, name, sizeof(name));
+            p += sizeof(name);
+            *p++ = type >> 8;
+            *p++ = type;
+            *p++ = 0;
+            *p++ = 1;
+            *p++ = answer_ttl >> 24;
+            *p++ = answer_ttl >> 16;
+            *p++ = answer_ttl >> 8;
+            *p++ = answer_ttl;
+            if (type == 28) {
+                const uint8_t ipv6[] = { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+                *p++ = 0;
+                *p++ = 16;
+                memcpy(p, ipv6, sizeof(ipv6));
+                p += sizeof(ipv6);
+                *p++ = i + 1;
+            } else {
+                *p++ = 0;
+                *p++ = 4;
+                *p++ = 10;
+                *p++ = 0;
+                *p++ = 0;
+                *p++ = i + 1;
+            }
+        }
+        _response_len = p - _response;
+        return size;
+    }
+
+    virtual nsapi_size_or_error_t socket_recvfrom(nsapi_socket_t handle, SocketAddress *address,
+            void *buffer, nsapi_size_t size) {
+        if (!_response_len) {
+            return NSAPI_ERROR_WOULD_BLOCK;
+        }
+        nsapi_size_t len = _response_len < size ? _response_len : size;
+        memcpy(buffer, _response, len);
+        _response_len = 0;
+        return len;
+    }
+
+    virtual void socket_attach(nsapi_socket_t handle, void (*callback)(void *), void *data) {
+    }
+
+private:
+    uint8_t _response[PACKET_SIZE];
+    nsapi_size_t _response_len;
+};
+
+namespace {
+    DNSServerStack server;
+    NetworkStack *stack = &server;
+
+    nsapi_error_t async_result;
+    SocketAddress async_address;
+    int async_calls;
+}
+
+static void start(unsigned answer_count, uint32_t answer_ttl) {
+    nsapi_dns_cache_clear();
+    server.reset();
+    server.answer_count = answer_count;
+    server.answer_ttl = answer_ttl;
+}
+
+static void query(const char *host, const char *expected, nsapi_version_t version = NSAPI_IPv4) {
+    SocketAddress address;
+    TEST_ASSERT_EQUAL(0, nsapi_dns_query(stack, host, &address, version));
+    TEST_ASSERT_EQUAL_STRING(expected, address.get_ip_address());
+}
+
+static void async_done(nsapi_error_t result, SocketAddress *address) {
+    async_calls++;
+    async_result = result;
+    if (address) {
+        async_address = *address;
+    }
+}
+
+void test_dns_cache_hit() {
+    start(1, 60);
+
+    query("cache.example.com", "10.0.0.1");
+    TEST_ASSERT_EQUAL(1, server.queries);
+    TEST_ASSERT_EQUAL_STRING("cache.example.com", server.last_host);
+
+    // answered from the cache, also for an unspecified family
+    query("cache.example.com", "10.0.0.1");
+    query("cache.example.com", "10.0.0.1", NSAPI_UNSPEC);
+    TEST_ASSERT_EQUAL(1, server.queries);
+
+    // other hosts and families are asked for
+    query("other.example.com", "10.0.0.1");
+    TEST_ASSERT_EQUAL(2, server.queries);
+    query("cache.example.com", "2001:0db8:0000:0000:0000:0000:0000:0001", NSAPI_IPv6);
+    TEST_ASSERT_EQUAL(3, server.queries);
+    query("cache.example.com", "2001:0db8:0000:0000:0000:0000:0000:0001", NSAPI_IPv6);
+    query("cache.example.com", "10.0.0.1");
+    TEST_ASSERT_EQUAL(3, server.queries);
+}
+
+void test_dns_cache_async() {
+    start(1, 60);
+    query("async.example.com", "10.0.0.1");
+
+    // the callback is called before the query returns
+    async_calls = 0;
+    TEST_ASSERT_EQUAL(0, nsapi_dns_query_async(stack, "async.example.com", async_done));
+    TEST_ASSERT_EQUAL(1, async_calls);
+    TEST_ASSERT_EQUAL(0, async_result);
+    TEST_ASSERT_EQUAL_STRING("10.0.0.1", async_address.get_ip_address());
+    TEST_ASSERT_EQUAL(1, server.queries);
+}
+
+void test_dns_cache_ttl() {
+    // a TTL of 0 is not cached
+    start(1, 0);
+    query("ttl.example.com", "10.0.0.1");
+    query("ttl.example.com", "10.0.0.1");
+    TEST_ASSERT_EQUAL(2, server.queries);
+
+    // the address is asked for again once its TTL expired
+    start(1, 1);
+    query("ttl.example.com", "10.0.0.1");
+    query("ttl.example.com", "10.0.0.1");
+    TEST_ASSERT_EQUAL(1, server.queries);
+    wait_ms(1100);
+    query("ttl.example.com", "10.0.0.1");
+    TEST_ASSERT_EQUAL(2, server.queries);
+}
+
+void test_dns_cache_multiple() {
+    SocketAddress addresses[MBED_CONF_NSAPI_DNS_CACHE_ADDRESSES + 1];
+    const nsapi_size_t kept = MBED_CONF_NSAPI_DNS_CACHE_ADDRESSES;
+
+    // the response holds more addresses than were asked for
+    start(kept + 1, 60);
+    TEST_ASSERT_EQUAL(kept, nsapi_dns_query_multiple(stack, "many.example.com", addresses, kept));
+    TEST_ASSERT_EQUAL(1, server.queries);
+    TEST_ASSERT_EQUAL_STRING("10.0.0.1", addresses[0].get_ip_address());
+
+    // the entry answers for as many addresses as it holds
+    TEST_ASSERT_EQUAL(1, nsapi_dns_query_multiple(stack, "many.example.com", addresses, 1));
+    TEST_ASSERT_EQUAL(kept, nsapi_dns_query_multiple(stack, "many.example.com", addresses, kept));
+    TEST_ASSERT_EQUAL(1, server.queries);
+
+    // but not for more
+    TEST_ASSERT_EQUAL(kept + 1, nsapi_dns_query_multiple(stack, "many.example.com", addresses, kept + 1));
+    TEST_ASSERT_EQUAL(2, server.queries);
+    TEST_ASSERT_EQUAL(kept + 1, nsapi_dns_query_multiple(stack, "many.example.com", addresses, kept + 1));
+    TEST_ASSERT_EQUAL(3, server.queries);
+
+    // a complete answer does not depend on the number asked for
+    start(1, 60);
+    TEST_ASSERT_EQUAL(1, nsapi_dns_query_multiple(stack, "one.example.com", addresses, kept + 1));
+    TEST_ASSERT_EQUAL(1, nsapi_dns_query_multiple(stack, "one.example.com", addresses, kept + 1));
+    TEST_ASSERT_EQUAL(1, server.queries);
+}
+
+void test_dns_cache_clear() {
+    start(1, 60);
+    query("clear.example.com", "10.0.0.1");
+    nsapi_dns_cache_clear();
+    query("clear.example.com", "10.0.0.1");
+    TEST_ASSERT_EQUAL(2, server.queries);
+}
+
+void test_dns_cache_replace() {
+    char host[32];
+
+    // fill the cache, the first host expiring first
+    start(1, 10);
+    for (unsigned i = 0; i < MBED_CONF_NSAPI_DNS_CACHE_SIZE; i++) {
+        snprintf(host, sizeof(host), "host%u.example.com", i);
+        query(host, "10.0.0.1");
+        server.answer_ttl = 60;
+    }
+    TEST_ASSERT_EQUAL(MBED_CONF_NSAPI_DNS_CACHE_SIZE, server.queries);
+
+    // a new host takes its place
+    query("new.example.com", "10.0.0.1");
+    for (unsigned i = 1; i < MBED_CONF_NSAPI_DNS_CACHE_SIZE; i++) {
+        snprintf(host, sizeof(host), "host%u.example.com", i);
+        query(host, "10.0.0.1");
+    }
+    query("new.example.com", "10.0.0.1");
+    TEST_ASSERT_EQUAL(MBED_CONF_NSAPI_DNS_CACHE_SIZE + 1, server.queries);
+
+    query("host0.example.com", "10.0.0.1");
+    TEST_ASSERT_EQUAL(MBED_CONF_NSAPI_DNS_CACHE_SIZE + 2, server.queries);
+}
+
+
+// Test setup
+utest::v1::status_t test_setup(const size_t number_of_cases) {
+    GREENTEA_SETUP(20, "default_auto");
+    return verbose_test_setup_handler(number_of_cases);
+}
+
+Case cases[] = {
+    Case("DNS cache hit", test_dns_cache_hit),
+    Case("DNS cache asynchronous hit", test_dns_cache_async),
+    Case("DNS cache TTL", test_dns_cache_ttl),
+    Case("DNS cache multiple addresses", test_dns_cache_multiple),
+    Case("DNS cache clear", test_dns_cache_clear),
+    Case("DNS cache replacement", test_dns_cache_replace),
+};
+
+Specification specification(test_setup, cases);
+
+int main() {
+    return !Harness::run(specification);
+}
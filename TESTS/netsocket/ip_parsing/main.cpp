@@ -47,6 +47,23 @@ void name() {                                       \
 }
 
 
+// IP formatting verification
+void test_ip_format(nsapi_addr_t addr, const char *string) {
+    SocketAddress address(addr);
+    TEST_ASSERT_EQUAL_STRING(string, address.get_ip_address());
+
+    SocketAddress parsed;
+    TEST_ASSERT(parsed.set_ip_address(address.get_ip_address()));
+    TEST_ASSERT(parsed == address);
+}
+
+#define TEST_IP_FORMAT(name, string, ...)           \
+void name() {                                       \
+    nsapi_addr_t addr = __VA_ARGS__;                \
+    test_ip_format(addr, string);                   \
+}
+
+
 // Test cases
 TEST_IP_ACCEPT(test_simple_ipv4_address,
     "12.34.56.78",
@@ -81,6 +98,51 @@ TEST_IP_ACCEPT(test_null_ipv6_address,
     "::",
     {NSAPI_IPv6,{0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
                  0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}})
+TEST_IP_ACCEPT(test_short_ipv6_address,
+    "1:23:456:7::89ab:c:d0",
+    {NSAPI_IPv6,{0x00,0x01,0x00,0x23,0x04,0x56,0x00,0x07,
+                 0x00,0x00,0x89,0xab,0x00,0x0c,0x00,0xd0}})
+TEST_IP_ACCEPT(test_uppercase_ipv6_address,
+    "FE80::ABCD:Ef01",
+    {NSAPI_IPv6,{0xfe,0x80,0x00,0x00,0x00,0x00,0x00,0x00,
+                 0x00,0x00,0x00,0x00,0xab,0xcd,0xef,0x01}})
+
+TEST_IP_FORMAT(test_simple_ipv4_format,
+    "12.34.56.78",
+    {NSAPI_IPv4,{12,34,56,78}})
+TEST_IP_FORMAT(test_wide_ipv4_format,
+    "255.100.10.9",
+    {NSAPI_IPv4,{255,100,10,9}})
+TEST_IP_FORMAT(test_null_ipv4_format,
+    "0.0.0.0",
+    {NSAPI_IPv4,{0,0,0,0}})
+
+TEST_IP_FORMAT(test_simple_ipv6_format,
+    "1234:5678:9abc:def0:1234:5678:9abc:def0",
+    {NSAPI_IPv6,{0x12,0x34,0x56,0x78,0x9a,0xbc,0xde,0xf0,
+                 0x12,0x34,0x56,0x78,0x9a,0xbc,0xde,0xf0}})
+TEST_IP_FORMAT(test_zeroed_ipv6_format,
+    "fe80:0000:0000:0000:0201:02ff:fe03:0405",
+    {NSAPI_IPv6,{0xfe,0x80,0x00,0x00,0x00,0x00,0x00,0x00,
+                 0x02,0x01,0x02,0xff,0xfe,0x03,0x04,0x05}})
+TEST_IP_FORMAT(test_null_ipv6_format,
+    "0000:0000:0000:0000:0000:0000:0000:0000",
+    {NSAPI_IPv6,{0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+                 0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}})
+
+void test_unspec_format() {
+    SocketAddress address;
+    TEST_ASSERT(address.get_ip_address() == NULL);
+}
+
+void test_format_after_set() {
+    SocketAddress address("12.34.56.78");
+    TEST_ASSERT_EQUAL_STRING("12.34.56.78", address.get_ip_address());
+
+    address.set_ip_address("1::2");
+    TEST_ASSERT_EQUAL_STRING("0001:0000:0000:0000:0000:0000:0000:0002",
+            address.get_ip_address());
+}
 
 
 // Test setup
@@ -100,6 +162,17 @@ Case cases[] = {
     Case("Right-weighted IPv6 address", test_right_weighted_ipv6_address),
     Case("Hollowed IPv6 address", test_hollowed_ipv6_address),
     Case("Null IPv6 address", test_null_ipv6_address),
+    Case("Short IPv6 address", test_short_ipv6_address),
+    Case("Uppercase IPv6 address", test_uppercase_ipv6_address),
+
+    Case("Simple IPv4 format", test_simple_ipv4_format),
+    Case("Wide IPv4 format", test_wide_ipv4_format),
+    Case("Null IPv4 format", test_null_ipv4_format),
+    Case("Simple IPv6 format", test_simple_ipv6_format),
+    Case("Zeroed IPv6 format", test_zeroed_ipv6_format),
+    Case("Null IPv6 format", test_null_ipv6_format),
+    Case("Unspecified format", test_unspec_format),
+    Case("Format after set", test_format_after_set),
 };
 
 Specification specification(test_setup, cases);
@@ -0,0 +1,460 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "mbed.h"
+#include "mbed_events.h"
+#include "netsocket/NetworkStack.h"
+#include "netsocket/MQTTClient.h"
+#include "greentea-client/test_env.h"
+#include "unity.h"
+#include "utest.h"
+
+using namespace utest::v1;
+
+#define STREAM_SIZE     1024
+
+/* Stack with a single TCP connection, whose other end the test plays as
+ * the broker. Reads return at most recv_chunk bytes, and sends block once
+ * send_room bytes were taken.
+ */
+class BrokerStack : public NetworkStack {
+public:
+    uint8_t to_client[STREAM_SIZE];
+    nsapi_size_t to_client_len;
+    nsapi_size_t recv_chunk;
+    uint8_t from_client[STREAM_SIZE];
+    nsapi_size_t from_client_len;
+    nsapi_size_t send_room;
+
+    BrokerStack() {
+        reset();
+    }
+
+    void reset() {
+        to_client_len = 0;
+        recv_chunk = STREAM_SIZE;
+        from_client_len = 0;
+        send_room = STREAM_SIZE;
+        _callback = 0;
+        _data = 0;
+    }
+
+    // Queues data for the client and signals its socket
+    void send(const void *data, nsapi_size_t size) {
+        TEST_ASSERT(size <= STREAM_SIZE - to_client_len);
+        memcpy(to_client + to_client_len, data, size);
+        to_client_len += size;
+        signal();
+    }
+
+    // Takes what the client sent, which must be the expected bytes
+    void expect(const void *data, nsapi_size_t size) {
+        TEST_ASSERT_EQUAL(size, from_client_len);
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(data, from_client, size);
+        from_client_len = 0;
+    }
+
+    void signal() {
+        if (_callback) {
+            _callback(_data);
+        }
+    }
+
+    virtual const char *get_ip_address() {
+        return "10.0.0.2";
+    }
+
+protected:
+    virtual nsapi_error_t socket_open(nsapi_socket_t *handle, nsapi_protocol_t proto) {
+        *handle = this;
+        return proto == NSAPI_TCP ? NSAPI_ERROR_OK : NSAPI_ERROR_UNSUPPORTED;
+    }
+
+    virtual nsapi_error_t socket_close(nsapi_socket_t handle) {
+        return NSAPI_ERROR_OK;
+    }
+
+    virtual nsapi_error_t socket_bind(nsapi_socket_t handle, const SocketAddress &address) {
+        return NSAPI_ERROR_UNSUPPORTED;
+    }
+
+    virtual nsapi_error_t socket_listen(nsapi_socket_t handle, int backlog) {
+        return NSAPI_ERROR_UNSUPPORTED;
+    }
+
+    virtual nsapi_error_t socket_connect(nsapi_socket_t handle, const SocketAddress &address) {
+        return NSAPI_ERROR_OK;
+    }
+
+    virtual nsapi_error_t socket_accept(nsapi_socket_t server,
+            nsapi_socket_t *handle, SocketAddress *address) {
+        return NSAPI_ERROR_UNSUPPORTED;
+    }
+
+    virtual nsapi_size_or_error_t socket_send(nsapi_socket_t handle,
+            const void *data, nsapi_size_t size) {
+        if (!send_room) {
+            return NSAPI_ERROR_WOULD_BLOCK;
+        }
+        if (size > send_room) {
+            size = send_room;
+        }
+        TEST_ASSERT(size <= STREAM_SIZE - from_client_len);
+        memcpy(from_client + from_client_len, data, size);
+        from_client_len += size;
+        send_room -= size;
+        return size;
+    }
+
+    virtual nsapi_size_or_error_t socket_recv(nsapi_socket_t handle,
+            void *data, nsapi_size_t size) {
+        if (!to_client_len) {
+            return NSAPI_ERROR_WOULD_BLOCK;
+        }
+        if (size > recv_chunk) {
+            size = recv_chunk;
+        }
+        if (size > to_client_len) {
+            size = to_client_len;
+        }
+        memcpy(data, to_client, size);
+        memmove(to_client, to_client + size, to_client_len - size);
+        to_client_len -= size;
+        return size;
+    }
+
+    virtual nsapi_size_or_error_t socket_sendto(nsapi_socket_t handle, const SocketAddress &address,
+            const void *data, nsapi_size_t size) {
+        return NSAPI_ERROR_UNSUPPORTED;
+    }
+
+    virtual nsapi_size_or_error_t socket_recvfrom(nsapi_socket_t handle, SocketAddress *address,
+            void *buffer, nsapi_size_t size) {
+        return NSAPI_ERROR_UNSUPPORTED;
+    }
+
+    virtual void socket_attach(nsapi_socket_t handle, void (*callback)(void *), void *data) {
+        _callback = callback;
+        _data = data;
+    }
+
+private:
+    void (*_callback)(void *);
+    void *_data;
+};
+
+namespace {
+    BrokerStack broker;
+    EventQueue queue(32 * EVENTS_EVENT_SIZE);
+
+    nsapi_error_t status;
+    int messages;
+    char topic[32];
+    uint8_t payload[MBED_CONF_NSAPI_MQTT_RX_BUFFER_SIZE];
+    nsapi_size_t payload_size;
+    int acks;
+    uint16_t last_ack;
+    int readies;
+}
+
+static void on_status(nsapi_error_t s) {
+    status = s;
+}
+
+static void on_message(const char *t, const void *p, nsapi_size_t size) {
+    messages++;
+    strncpy(topic, t, sizeof(topic) - 1);
+    TEST_ASSERT(size <= sizeof(payload));
+    memcpy(payload, p, size);
+    payload_size = size;
+}
+
+static void on_ack(uint16_t id) {
+    acks++;
+    last_ack = id;
+}
+
+static void on_ready() {
+    readies++;
+}
+
+// Sends data as the broker and lets the client handle it
+static void broker_send(const void *data, nsapi_size_t size) {
+    broker.send(data, size);
+    queue.dispatch(0);
+}
+
+// Connects a client over a fresh socket, as accepted by the broker
+static void connect_client(TCPSocket *socket, MQTTClient *client) {
+    broker.reset();
+    status = 1;
+    messages = 0;
+    memset(topic, 0, sizeof(topic));
+    payload_size = 0;
+    acks = 0;
+    last_ack = 0;
+    readies = 0;
+
+    TEST_ASSERT_EQUAL(0, socket->open(static_cast<NetworkStack *>(&broker)));
+    TEST_ASSERT_EQUAL(0, socket->connect(SocketAddress("10.0.0.1", 1883)));
+    client->on_status(on_status);
+    client->on_message(on_message);
+    client->on_ack(on_ack);
+    client->on_ready(on_ready);
+    TEST_ASSERT_EQUAL(0, client->connect("dev", NULL, NULL, 0));
+    queue.dispatch(0);
+
+    static const uint8_t connect[] = {
+        0x10, 15, 0, 4, 'M', 'Q', 'T', 'T', 4, 0x02, 0, 0, 0, 3, 'd', 'e', 'v'
+    };
+    broker.expect(connect, sizeof(connect));
+
+    static const uint8_t connack[] = { 0x20, 2, 0, 0 };
+    broker_send(connack, sizeof(connack));
+    TEST_ASSERT_EQUAL(0, status);
+    TEST_ASSERT(client->is_connected());
+}
+
+
+void test_mqtt_connect() {
+    TCPSocket socket;
+    MQTTClient client(&queue, &socket);
+    TEST_ASSERT_EQUAL(NSAPI_ERROR_NO_CONNECTION, client.publish("t", "x", 1));
+    connect_client(&socket, &client);
+    TEST_ASSERT_EQUAL(NSAPI_ERROR_IS_CONNECTED, client.connect("dev"));
+
+    static const uint8_t disconnect[] = { 0xe0, 0 };
+    TEST_ASSERT_EQUAL(0, client.disconnect());
+    broker.expect(disconnect, sizeof(disconnect));
+    TEST_ASSERT(!client.is_connected());
+
+    // a refused connection is reported to the status callback
+    TEST_ASSERT_EQUAL(0, client.connect("dev", NULL, NULL, 0));
+    broker.from_client_len = 0;
+    static const uint8_t refused[] = { 0x20, 2, 0, 5 };
+    broker_send(refused, sizeof(refused));
+    TEST_ASSERT_EQUAL(NSAPI_ERROR_AUTH_FAILURE, status);
+    TEST_ASSERT(!client.is_connected());
+}
+
+void test_mqtt_remaining_length() {
+    TCPSocket socket;
+    MQTTClient client(&queue, &socket);
+    connect_client(&socket, &client);
+
+    // 2 + 1 + 197 = 200 bytes take two length bytes, 200 = 0x48 | 0x80, 1
+    uint8_t packet[3 + 200];
+    packet[0] = 0x30;
+    packet[1] = 0xc8;
+    packet[2] = 0x01;
+    packet[3] = 0;
+    packet[4] = 1;
+    packet[5] = 't';
+    for (int i = 0; i < 197; i++) {
+        packet[6 + i] = i;
+    }
+    broker_send(packet, sizeof(packet));
+    TEST_ASSERT_EQUAL(1, messages);
+    TEST_ASSERT_EQUAL_STRING("t", topic);
+    TEST_ASSERT_EQUAL(197, payload_size);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(packet + 6, payload, 197);
+
+    // and so does a publish of them
+    TEST_ASSERT_EQUAL(0, client.publish("t", packet + 6, 197));
+    TEST_ASSERT_EQUAL(sizeof(packet), broker.from_client_len);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(packet, broker.from_client, sizeof(packet));
+    broker.from_client_len = 0;
+
+    // a length continued into a fifth byte is not MQTT
+    static const uint8_t overlong[] = { 0x30, 0x80, 0x80, 0x80, 0x80, 0x01 };
+    broker_send(overlong, sizeof(overlong));
+    TEST_ASSERT_EQUAL(NSAPI_ERROR_CONNECTION_LOST, status);
+    TEST_ASSERT(!client.is_connected());
+}
+
+void test_mqtt_split_reads() {
+    TCPSocket socket;
+    MQTTClient client(&queue, &socket);
+    connect_client(&socket, &client);
+
+    // byte by byte, including the length bytes, 132 = 0x04 | 0x80, 1
+    uint8_t message[3 + 132];
+    message[0] = 0x30;
+    message[1] = 0x84;
+    message[2] = 0x01;
+    message[3] = 0;
+    message[4] = 1;
+    message[5] = 'a';
+    memset(message + 6, 'x', sizeof(message) - 6);
+    for (size_t i = 0; i < sizeof(message); i++) {
+        TEST_ASSERT_EQUAL(0, messages);
+        broker_send(&message[i], 1);
+    }
+    TEST_ASSERT_EQUAL(1, messages);
+    TEST_ASSERT_EQUAL_STRING("a", topic);
+    TEST_ASSERT_EQUAL(129, payload_size);
+
+    // two messages in one read, the second split over the next
+    static const uint8_t messages_split[] = {
+        0x30, 5, 0, 1, 'b', '1', '2',
+        0x30, 4, 0, 1, 'c', '3'
+    };
+    broker_send(messages_split, 10);
+    TEST_ASSERT_EQUAL(2, messages);
+    TEST_ASSERT_EQUAL_STRING("b", topic);
+    TEST_ASSERT_EQUAL(2, payload_size);
+    broker_send(messages_split + 10, sizeof(messages_split) - 10);
+    TEST_ASSERT_EQUAL(3, messages);
+    TEST_ASSERT_EQUAL_STRING("c", topic);
+    TEST_ASSERT_EQUAL(1, payload_size);
+    TEST_ASSERT_EQUAL('3', payload[0]);
+
+    // reads smaller than the packets
+    broker.recv_chunk = 3;
+    broker_send(messages_split, sizeof(messages_split));
+    TEST_ASSERT_EQUAL(5, messages);
+    TEST_ASSERT_EQUAL(0, broker.from_client_len);
+    TEST_ASSERT(client.is_connected());
+}
+
+void test_mqtt_qos1_receive() {
+    TCPSocket socket;
+    MQTTClient client(&queue, &socket);
+    connect_client(&socket, &client);
+
+    static const uint8_t message[] = {
+        0x32, 9, 0, 3, 'a', '/', 'b', 0x12, 0x34, 'h', 'i'
+    };
+    broker_send(message, sizeof(message));
+    TEST_ASSERT_EQUAL(1, messages);
+    TEST_ASSERT_EQUAL_STRING("a/b", topic);
+    TEST_ASSERT_EQUAL(2, payload_size);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY("hi", payload, 2);
+
+    static const uint8_t puback[] = { 0x40, 2, 0x12, 0x34 };
+    broker.expect(puback, sizeof(puback));
+
+    // the acknowledgement waits for the socket to take it
+    broker.send_room = 0;
+    broker_send(message, sizeof(message));
+    TEST_ASSERT_EQUAL(2, messages);
+    TEST_ASSERT_EQUAL(0, broker.from_client_len);
+    broker.send_room = STREAM_SIZE;
+    broker.signal();
+    queue.dispatch(0);
+    broker.expect(puback, sizeof(puback));
+}
+
+void test_mqtt_inflight_window() {
+    TCPSocket socket;
+    MQTTClient client(&queue, &socket);
+    connect_client(&socket, &client);
+
+    int ids[MBED_CONF_NSAPI_MQTT_MAX_INFLIGHT];
+    for (int i = 0; i < MBED_CONF_NSAPI_MQTT_MAX_INFLIGHT; i++) {
+        ids[i] = client.publish("t", "p", 1, MQTTClient::QOS1);
+        TEST_ASSERT(ids[i] > 0);
+    }
+    TEST_ASSERT_EQUAL(MBED_CONF_NSAPI_MQTT_MAX_INFLIGHT, client.in_flight());
+    TEST_ASSERT_EQUAL(MBED_CONF_NSAPI_MQTT_MAX_INFLIGHT * 8, broker.from_client_len);
+    broker.from_client_len = 0;
+
+    // the window is full, QoS 0 still goes
+    TEST_ASSERT_EQUAL(NSAPI_ERROR_WOULD_BLOCK, client.publish("t", "p", 1, MQTTClient::QOS1));
+    TEST_ASSERT_EQUAL(0, client.publish("t", "p", 1));
+    TEST_ASSERT_EQUAL(0, readies);
+
+    uint8_t puback[] = { 0x40, 2, (uint8_t)(ids[0] >> 8), (uint8_t)ids[0] };
+    broker_send(puback, sizeof(puback));
+    TEST_ASSERT_EQUAL(1, acks);
+    TEST_ASSERT_EQUAL(ids[0], last_ack);
+    TEST_ASSERT_EQUAL(1, readies);
+    TEST_ASSERT_EQUAL(MBED_CONF_NSAPI_MQTT_MAX_INFLIGHT - 1, client.in_flight());
+
+    // a duplicate or unknown acknowledgement changes nothing
+    broker_send(puback, sizeof(puback));
+    TEST_ASSERT_EQUAL(1, acks);
+
+    int id = client.publish("t", "p", 1, MQTTClient::QOS1);
+    TEST_ASSERT(id > 0);
+    // ids still in flight are not reused
+    for (int i = 1; i < MBED_CONF_NSAPI_MQTT_MAX_INFLIGHT; i++) {
+        TEST_ASSERT_NOT_EQUAL(ids[i], id);
+    }
+    TEST_ASSERT_EQUAL(MBED_CONF_NSAPI_MQTT_MAX_INFLIGHT, client.in_flight());
+}
+
+void test_mqtt_oversized_message() {
+    TCPSocket socket;
+    MQTTClient client(&queue, &socket);
+    connect_client(&socket, &client);
+
+    // a QoS 1 message twice the receive buffer, in small reads
+    static const nsapi_size_t size = 2 * MBED_CONF_NSAPI_MQTT_RX_BUFFER_SIZE;
+    static uint8_t message[4 + size];
+    nsapi_size_t remaining = size - 3;
+    message[0] = 0x32;
+    message[1] = 0x80 | (remaining & 0x7f);
+    message[2] = remaining >> 7;
+    message[3] = 0;
+    message[4] = 1;
+    message[5] = 'a';
+    message[6] = 0x56;
+    message[7] = 0x78;
+    memset(message + 8, 'x', sizeof(message) - 8);
+    TEST_ASSERT(remaining >= 128 && remaining < 16384);
+
+    broker.recv_chunk = 100;
+    broker_send(message, 3 + remaining);
+    TEST_ASSERT_EQUAL(0, messages);
+    TEST_ASSERT(client.is_connected());
+    static const uint8_t puback[] = { 0x40, 2, 0x56, 0x78 };
+    broker.expect(puback, sizeof(puback));
+
+    // a QoS 0 one is dropped without acknowledgement
+    message[0] = 0x30;
+    broker_send(message, 3 + remaining);
+    TEST_ASSERT_EQUAL(0, messages);
+    TEST_ASSERT_EQUAL(0, broker.from_client_len);
+
+    // the next message is received again
+    static const uint8_t next[] = { 0x30, 5, 0, 1, 'b', 'o', 'k' };
+    broker_send(next, sizeof(next));
+    TEST_ASSERT_EQUAL(1, messages);
+    TEST_ASSERT_EQUAL_STRING("b", topic);
+    TEST_ASSERT_EQUAL(2, payload_size);
+}
+
+
+// Test setup
+utest::v1::status_t test_setup(const size_t number_of_cases) {
+    GREENTEA_SETUP(20, "default_auto");
+    return verbose_test_setup_handler(number_of_cases);
+}
+
+Case cases[] = {
+    Case("MQTT connect and disconnect", test_mqtt_connect),
+    Case("MQTT remaining length", test_mqtt_remaining_length),
+    Case("MQTT packets split across reads", test_mqtt_split_reads),
+    Case("MQTT QoS 1 receive", test_mqtt_qos1_receive),
+    Case("MQTT in-flight window", test_mqtt_inflight_window),
+    Case("MQTT oversized message", test_mqtt_oversized_message),
+};
+
+Specification specification(test_setup, cases);
+
+int main() {
+    return !Harness::run(specification);
+}
@@ -0,0 +1,279 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "mbed.h"
+#include "netsocket/NetworkStack.h"
+#include "netsocket/UDPSocket.h"
+#include "netsocket/SocketSet.h"
+#include "greentea-client/test_env.h"
+#include "unity.h"
+#include "utest.h"
+
+using namespace utest::v1;
+
+#define SOCKET_COUNT    4
+
+/* Stack whose sockets only raise the events the test signals, socket i
+ * being the i-th one opened.
+ */
+class SignalStack : public NetworkStack {
+public:
+    SignalStack() : _count(0) {
+        memset(_slots, 0, sizeof(_slots));
+    }
+
+    void signal(unsigned index) {
+        slot *s = &_slots[index];
+        if (s->callback) {
+            s->callback(s->data);
+        }
+    }
+
+    virtual const char *get_ip_address() {
+        return "10.0.0.2";
+    }
+
+protected:
+    struct slot {
+        void (*callback)(void *);
+        void *data;
+    };
+
+    virtual nsapi_error_t socket_open(nsapi_socket_t *handle, nsapi_protocol_t proto) {
+        if (_count == SOCKET_COUNT) {
+            return NSAPI_ERROR_NO_SOCKET;
+        }
+        *handle = &_slots[_count++];
+        return NSAPI_ERROR_OK;
+    }
+
+    virtual nsapi_error_t socket_close(nsapi_socket_t handle) {
+        return NSAPI_ERROR_OK;
+    }
+
+    virtual nsapi_error_t socket_bind(nsapi_socket_t handle, const SocketAddress &address) {
+        return NSAPI_ERROR_OK;
+    }
+
+    virtual nsapi_error_t socket_listen(nsapi_socket_t handle, int backlog) {
+        return NSAPI_ERROR_UNSUPPORTED;
+    }
+
+    virtual nsapi_error_t socket_connect(nsapi_socket_t handle, const SocketAddress &address) {
+        return NSAPI_ERROR_UNSUPPORTED;
+    }
+
+    virtual nsapi_error_t socket_accept(nsapi_socket_t server,
+            nsapi_socket_t *handle, SocketAddress *address) {
+        return NSAPI_ERROR_UNSUPPORTED;
+    }
+
+    virtual nsapi_size_or_error_t socket_send(nsapi_socket_t handle,
+            const void *data, nsapi_size_t size) {
+        return NSAPI_ERROR_UNSUPPORTED;
+    }
+
+    virtual nsapi_size_or_error_t socket_recv(nsapi_socket_t handle,
+            void *data, nsapi_size_t size) {
+        return NSAPI_ERROR_UNSUPPORTED;
+    }
+
+    virtual nsapi_size_or_error_t socket_sendto(nsapi_socket_t handle, const SocketAddress &address,
+            const void *data, nsapi_size_t size) {
+        return size;
+    }
+
+    virtual nsapi_size_or_error_t socket_recvfrom(nsapi_socket_t handle, SocketAddress *address,
+            void *buffer, nsapi_size_t size) {
+        return NSAPI_ERROR_WOULD_BLOCK;
+    }
+
+    virtual void socket_attach(nsapi_socket_t handle, void (*callback)(void *), void *data) {
+        slot *s = (slot *)handle;
+        s->callback = callback;
+        s->data = data;
+    }
+
+private:
+    slot _slots[SOCKET_COUNT];
+    unsigned _count;
+};
+
+namespace {
+    SignalStack stack;
+    UDPSocket sockets[SOCKET_COUNT];
+    SocketSet::Event ready[SOCKET_COUNT + 1];
+}
+
+static void open_sockets() {
+    for (unsigned i = 0; i < SOCKET_COUNT; i++) {
+        TEST_ASSERT_EQUAL(0, sockets[i].open(static_cast<NetworkStack *>(&stack)));
+        sockets[i].set_blocking(false);
+    }
+}
+
+// Checks that a wait for up to count events returns the sockets listed
+// in order, as digits, and reads them so they raise their next event
+static void expect(SocketSet &set, unsigned count, const char *order) {
+    char buffer[1];
+    int n = set.wait(ready, count, 0);
+    TEST_ASSERT_EQUAL(strlen(order), n);
+    for (int i = 0; i < n; i++) {
+        TEST_ASSERT_EQUAL_PTR(&sockets[order[i] - '0'], ready[i].socket);
+        TEST_ASSERT_EQUAL(NSAPI_ERROR_WOULD_BLOCK, sockets[order[i] - '0'].recvfrom(NULL, buffer, 1));
+    }
+}
+
+void test_socket_set_add() {
+    SocketSet set;
+    int data[SOCKET_COUNT];
+
+    open_sockets();
+    for (unsigned i = 0; i < SOCKET_COUNT; i++) {
+        TEST_ASSERT_EQUAL(0, set.add(&sockets[i], &data[i]));
+    }
+    TEST_ASSERT_EQUAL(NSAPI_ERROR_PARAMETER, set.add(&sockets[0]));
+    TEST_ASSERT_EQUAL(NSAPI_ERROR_PARAMETER, set.add(NULL));
+
+    // every socket is returned once, in the order it was added, with its data
+    TEST_ASSERT_EQUAL(SOCKET_COUNT, set.wait(ready, SOCKET_COUNT + 1, 0));
+    for (unsigned i = 0; i < SOCKET_COUNT; i++) {
+        TEST_ASSERT_EQUAL_PTR(&sockets[i], ready[i].socket);
+        TEST_ASSERT_EQUAL_PTR(&data[i], ready[i].data);
+    }
+    expect(set, SOCKET_COUNT, "");
+}
+
+void test_socket_set_edge() {
+    SocketSet set;
+    for (unsigned i = 0; i < SOCKET_COUNT; i++) {
+        set.add(&sockets[i]);
+    }
+    expect(set, SOCKET_COUNT, "0123");
+
+    // sockets come in the order of their events, once however many they had
+    stack.signal(2);
+    stack.signal(0);
+    stack.signal(2);
+    expect(set, SOCKET_COUNT, "20");
+    expect(set, SOCKET_COUNT, "");
+
+    // events beyond the count wait for the next call
+    stack.signal(3);
+    stack.signal(1);
+    stack.signal(0);
+    expect(set, 2, "31");
+    expect(set, 2, "0");
+    expect(set, 2, "");
+}
+
+void test_socket_set_level() {
+    SocketSet set;
+    set.add(&sockets[0], NULL, SocketSet::TRIGGER_LEVEL);
+    set.add(&sockets[1]);
+    set.add(&sockets[2], NULL, SocketSet::TRIGGER_LEVEL);
+
+    // level triggered sockets are returned until cleared
+    expect(set, SOCKET_COUNT, "012");
+    expect(set, SOCKET_COUNT, "02");
+    expect(set, SOCKET_COUNT, "02");
+
+    // and go behind the others, so they can not starve them
+    stack.signal(1);
+    expect(set, 1, "0");
+    expect(set, 1, "2");
+    expect(set, 1, "1");
+    expect(set, 1, "0");
+
+    set.clear(&sockets[0]);
+    expect(set, SOCKET_COUNT, "2");
+    set.clear(&sockets[2]);
+    expect(set, SOCKET_COUNT, "");
+
+    // until their next event
+    stack.signal(2);
+    expect(set, SOCKET_COUNT, "2");
+    expect(set, SOCKET_COUNT, "2");
+}
+
+void test_socket_set_remove() {
+    SocketSet set;
+    for (unsigned i = 0; i < SOCKET_COUNT; i++) {
+        set.add(&sockets[i]);
+    }
+
+    // pending events of a removed socket are dropped, later ones ignored
+    TEST_ASSERT_EQUAL(0, set.remove(&sockets[1]));
+    TEST_ASSERT_EQUAL(NSAPI_ERROR_NO_SOCKET, set.remove(&sockets[1]));
+    expect(set, SOCKET_COUNT, "023");
+    stack.signal(1);
+    expect(set, SOCKET_COUNT, "");
+
+    // the last queued socket can be removed and events queued after it
+    stack.signal(0);
+    stack.signal(3);
+    TEST_ASSERT_EQUAL(0, set.remove(&sockets[3]));
+    stack.signal(2);
+    expect(set, SOCKET_COUNT, "02");
+
+    // and the socket added again
+    TEST_ASSERT_EQUAL(0, set.add(&sockets[1]));
+    expect(set, SOCKET_COUNT, "1");
+}
+
+static void signal_last() {
+    stack.signal(SOCKET_COUNT - 1);
+}
+
+void test_socket_set_wait() {
+    SocketSet set;
+    set.add(&sockets[SOCKET_COUNT - 1]);
+    expect(set, SOCKET_COUNT, "3");
+
+    // a timeout without events
+    Timer timer;
+    timer.start();
+    TEST_ASSERT_EQUAL(0, set.wait(ready, SOCKET_COUNT, 50));
+    TEST_ASSERT_INT_WITHIN(20, 60, timer.read_ms());
+
+    // an event from an interrupt wakes the wait
+    Timeout timeout;
+    timeout.attach_us(signal_last, 10000);
+    timer.reset();
+    TEST_ASSERT_EQUAL(1, set.wait(ready, SOCKET_COUNT));
+    TEST_ASSERT_EQUAL_PTR(&sockets[SOCKET_COUNT - 1], ready[0].socket);
+    TEST_ASSERT(timer.read_ms() >= 5);
+}
+
+
+// Test setup
+utest::v1::status_t test_setup(const size_t number_of_cases) {
+    GREENTEA_SETUP(20, "default_auto");
+    return verbose_test_setup_handler(number_of_cases);
+}
+
+Case cases[] = {
+    Case("SocketSet add", test_socket_set_add),
+    Case("SocketSet edge triggered", test_socket_set_edge),
+    Case("SocketSet level triggered", test_socket_set_level),
+    Case("SocketSet remove", test_socket_set_remove),
+    Case("SocketSet wait", test_socket_set_wait),
+};
+
+Specification specification(test_setup, cases);
+
+int main() {
+    return !Harness::run(specification);
+}
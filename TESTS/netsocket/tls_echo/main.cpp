@@ -0,0 +1,172 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#if !FEATURE_LWIP
+    #error [NOT_SUPPORTED] LWIP not supported for this target
+#endif
+#if DEVICE_EMAC
+    #error [NOT_SUPPORTED] Not supported for WiFi targets
+#endif
+
+#include "mbedtls/config.h"
+
+#if !defined(MBEDTLS_SSL_CLI_C) || !defined(MBEDTLS_X509_CRT_PARSE_C) || \
+    !defined(MBEDTLS_ENTROPY_C) || !defined(MBEDTLS_CTR_DRBG_C) || \
+    !defined(MBEDTLS_KEY_EXCHANGE_ECDHE_ECDSA_ENABLED) || \
+    !defined(MBEDTLS_ECP_DP_SECP256R1_ENABLED)
+    #error [NOT_SUPPORTED] mbed TLS is not configured for ECDSA TLS clients
+#endif
+
+#include "mbed.h"
+#include "EthernetInterface.h"
+#include "TLSSocket.h"
+#include "greentea-client/test_env.h"
+#include "unity/unity.h"
+#include "utest.h"
+
+using namespace utest::v1;
+
+/* The tls_echo host test runs a TLS echo server with a certificate for its
+ * address, issued by the test authority below.
+ */
+
+static const char test_ca_cert[] =
+    "-----BEGIN CERTIFICATE-----\n"
+    "MIIBqjCCAU+gAwIBAgIUUqbrE78Rex7jySmXeTjtVYzsuKMwCgYIKoZIzj0EAwIw\n"
+    "ITEfMB0GA1UEAwwWbWJlZCBUTFNTb2NrZXQgdGVzdCBDQTAgFw0yNjEwMTUwMjI1\n"
+    "MjFaGA8yMTI2MDkyMTAyMjUyMVowITEfMB0GA1UEAwwWbWJlZCBUTFNTb2NrZXQg\n"
+    "dGVzdCBDQTBZMBMGByqGSM49AgEGCCqGSM49AwEHA0IABFdens/YXAAAv6HD/I+3\n"
+    "PAWafk3FUAPU5YDrFTR1APsyjmHR2jSNSPMgI7+c1IdGJREfHNnUX73p6jhARIHE\n"
+    "s9ajYzBhMB0GA1UdDgQWBBR0HODk0Mlu5Nh715eq0VoYQthPtTAfBgNVHSMEGDAW\n"
+    "gBR0HODk0Mlu5Nh715eq0VoYQthPtTAPBgNVHRMBAf8EBTADAQH/MA4GA1UdDwEB\n"
+    "/wQEAwIBBjAKBggqhkjOPQQDAgNJADBGAiEAguOqW4B1jjeDV4VQMbBx5G3gCl/b\n"
+    "s1qVYcPR8Dwg2w0CIQDktQO0rcprb4sMKR26cZRHaOoXdVmZCzOtbeKqj7NM/g==\n"
+    "-----END CERTIFICATE-----\n";
+
+#define ECHO_BUFFER_SIZE    2048
+#define RECV_TIMEOUT_MS     10000
+
+namespace {
+    EthernetInterface eth;
+    char server_ip[64];
+    uint16_t server_port;
+    TLSSocket sock;
+    uint8_t tx_buffer[ECHO_BUFFER_SIZE];
+    uint8_t rx_buffer[ECHO_BUFFER_SIZE];
+}
+
+static void prep_buffer(uint8_t *buffer, size_t size)
+{
+    for (size_t i = 0; i < size; i++) {
+        buffer[i] = rand();
+    }
+}
+
+void test_tls_handshake() {
+    int err = eth.connect();
+    TEST_ASSERT_EQUAL(0, err);
+    printf("MBED: TLSSocket IP address is '%s'\n", eth.get_ip_address());
+
+    greentea_send_kv("target_ip", eth.get_ip_address());
+    greentea_send_kv("tls_server", " ");
+
+    char key[16] = {0};
+    char value[80] = {0};
+    greentea_parse_kv(key, value, sizeof(key), sizeof(value));
+    TEST_ASSERT_EQUAL_STRING("tls_server", key);
+
+    unsigned int port = 0;
+    char *comma = strchr(value, ',');
+    TEST_ASSERT_NOT_NULL(comma);
+    *comma = '\0';
+    strncpy(server_ip, value, sizeof(server_ip) - 1);
+    sscanf(comma + 1, "%u", &port);
+    server_port = port;
+    printf("MBED: TLS echo server is %s:%u\n", server_ip, port);
+
+    TEST_ASSERT_EQUAL(0, sock.open(&eth));
+    TEST_ASSERT_EQUAL(0, sock.set_root_ca_cert(test_ca_cert, sizeof(test_ca_cert)));
+    sock.set_timeout(RECV_TIMEOUT_MS);
+
+    // the server certificate names the address the host was reached on
+    TEST_ASSERT_EQUAL(0, sock.connect(server_ip, server_port));
+    TEST_ASSERT_EQUAL(NSAPI_ERROR_IS_CONNECTED, sock.connect(server_ip, server_port));
+}
+
+void test_tls_echo() {
+    static const size_t sizes[] = { 1, 100, ECHO_BUFFER_SIZE };
+
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        size_t size = sizes[i];
+        prep_buffer(tx_buffer, size);
+        TEST_ASSERT_EQUAL(size, sock.send(tx_buffer, size));
+
+        // the echo may come back in several records
+        size_t received = 0;
+        while (received < size) {
+            int ret = sock.recv(rx_buffer + received, size - received);
+            TEST_ASSERT(ret > 0);
+            received += ret;
+        }
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(tx_buffer, rx_buffer, size);
+    }
+}
+
+void test_tls_close() {
+    TEST_ASSERT_EQUAL(0, sock.close());
+
+    // the socket is no longer usable, but keeps its certificates
+    TEST_ASSERT_EQUAL(NSAPI_ERROR_NO_CONNECTION, sock.send(tx_buffer, 1));
+    TEST_ASSERT_EQUAL(NSAPI_ERROR_NO_CONNECTION, sock.recv(rx_buffer, 1));
+
+    TEST_ASSERT_EQUAL(0, sock.open(&eth));
+    sock.set_timeout(RECV_TIMEOUT_MS);
+    TEST_ASSERT_EQUAL(0, sock.connect(server_ip, server_port));
+    TEST_ASSERT_EQUAL(1, sock.send(tx_buffer, 1));
+    TEST_ASSERT_EQUAL(1, sock.recv(rx_buffer, 1));
+    TEST_ASSERT_EQUAL(tx_buffer[0], rx_buffer[0]);
+    TEST_ASSERT_EQUAL(0, sock.close());
+}
+
+void test_tls_untrusted() {
+    // without the test authority the server certificate is refused
+    TLSSocket untrusting;
+    TEST_ASSERT_EQUAL(0, untrusting.open(&eth));
+    untrusting.set_timeout(RECV_TIMEOUT_MS);
+    TEST_ASSERT_EQUAL(NSAPI_ERROR_AUTH_FAILURE, untrusting.connect(server_ip, server_port));
+    untrusting.close();
+
+    eth.disconnect();
+}
+
+
+// Test setup
+utest::v1::status_t test_setup(const size_t number_of_cases) {
+    GREENTEA_SETUP(120, "tls_echo");
+    return verbose_test_setup_handler(number_of_cases);
+}
+
+Case cases[] = {
+    Case("TLS handshake", test_tls_handshake),
+    Case("TLS echo", test_tls_echo),
+    Case("TLS close and reconnect", test_tls_close),
+    Case("TLS untrusted server", test_tls_untrusted),
+};
+
+Specification specification(test_setup, cases);
+
+int main() {
+    return !Harness::run(specification);
+}
@@ -0,0 +1,116 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "mbed.h"
+#include "netsocket/WiFiScanCache.h"
+#include "greentea-client/test_env.h"
+#include "unity.h"
+#include "utest.h"
+
+#if MBED_CONF_NSAPI_WIFI_SCAN_CACHE_SIZE < 4
+#error [NOT_SUPPORTED] nsapi.wifi-scan-cache-size must be at least 4 for this test
+#endif
+
+using namespace utest::v1;
+
+
+static WiFiAccessPoint access_point(const char *ssid, uint8_t id, int8_t rssi) {
+    nsapi_wifi_ap_t ap;
+    memset(&ap, 0, sizeof(ap));
+    strcpy(ap.ssid, ssid);
+    ap.bssid[5] = id;
+    ap.rssi = rssi;
+    ap.channel = id;
+    return WiFiAccessPoint(ap);
+}
+
+void test_strongest_first() {
+    WiFiScanCache cache;
+    TEST_ASSERT_EQUAL(0, cache.get(NULL, 0));
+
+    cache.add(access_point("a", 1, -80));
+    cache.add(access_point("b", 2, -40));
+    cache.add(access_point("a", 3, -60));
+
+    WiFiAccessPoint res[2];
+    TEST_ASSERT_EQUAL(3, cache.get(NULL, 0));
+    TEST_ASSERT_EQUAL(2, cache.get(res, 2));
+    TEST_ASSERT_EQUAL(2, res[0].get_bssid()[5]);
+    TEST_ASSERT_EQUAL(3, res[1].get_bssid()[5]);
+
+    WiFiAccessPoint ap;
+    TEST_ASSERT(cache.find("a", &ap));
+    TEST_ASSERT_EQUAL(3, ap.get_channel());
+    TEST_ASSERT(!cache.find("c", &ap));
+}
+
+void test_update() {
+    WiFiScanCache cache;
+    cache.add(access_point("a", 1, -80));
+    cache.add(access_point("a", 1, -50));
+
+    WiFiAccessPoint res[2];
+    TEST_ASSERT_EQUAL(1, cache.get(res, 2));
+    TEST_ASSERT_EQUAL(-50, res[0].get_rssi());
+}
+
+void test_ageing() {
+    WiFiScanCache cache;
+    cache.add(access_point("a", 1, -80));
+    wait_ms(100);
+    cache.add(access_point("a", 2, -90));
+
+    WiFiAccessPoint ap;
+    TEST_ASSERT_EQUAL(2, cache.get(NULL, 0, 1000));
+    TEST_ASSERT_EQUAL(1, cache.get(NULL, 0, 50));
+    TEST_ASSERT(cache.find("a", &ap, 50));
+    TEST_ASSERT_EQUAL(2, ap.get_bssid()[5]);
+
+    cache.clear();
+    TEST_ASSERT_EQUAL(0, cache.get(NULL, 0));
+}
+
+void test_oldest_replaced() {
+    WiFiScanCache cache;
+    for (int i = 0; i <= MBED_CONF_NSAPI_WIFI_SCAN_CACHE_SIZE; i++) {
+        cache.add(access_point("a", i, -90 + i));
+        wait_ms(2);
+    }
+
+    WiFiAccessPoint res[MBED_CONF_NSAPI_WIFI_SCAN_CACHE_SIZE];
+    TEST_ASSERT_EQUAL(MBED_CONF_NSAPI_WIFI_SCAN_CACHE_SIZE, cache.get(res, MBED_CONF_NSAPI_WIFI_SCAN_CACHE_SIZE));
+    TEST_ASSERT_EQUAL(MBED_CONF_NSAPI_WIFI_SCAN_CACHE_SIZE, res[0].get_bssid()[5]);
+    TEST_ASSERT_EQUAL(1, res[MBED_CONF_NSAPI_WIFI_SCAN_CACHE_SIZE - 1].get_bssid()[5]);
+}
+
+
+// Test setup
+utest::v1::status_t test_setup(const size_t number_of_cases) {
+    GREENTEA_SETUP(10, "default_auto");
+    return verbose_test_setup_handler(number_of_cases);
+}
+
+Case cases[] = {
+    Case("Strongest access points first", test_strongest_first),
+    Case("Access points seen again", test_update),
+    Case("Ageing", test_ageing),
+    Case("Oldest access point replaced", test_oldest_replaced),
+};
+
+Specification specification(test_setup, cases);
+
+int main() {
+    return !Harness::run(specification);
+}
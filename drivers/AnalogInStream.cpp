@@ -0,0 +1,150 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "drivers/AnalogInStream.h"
+
+#if DEVICE_ANALOGIN && DEVICE_ANALOGIN_ASYNCH
+
+#include "platform/mbed_assert.h"
+#include "platform/mbed_critical.h"
+#include "platform/mbed_dcache.h"
+#include "platform/mbed_sleep.h"
+
+namespace mbed {
+
+AnalogInStream::AnalogInStream(PinName pin) :
+        _count(1),
+        _irq(this),
+        _event(0),
+        _buffer(NULL),
+        _length(0),
+        _active(false)
+{
+    // No lock needed in the constructor
+    analogin_init(&_adc[0], pin);
+}
+
+AnalogInStream::AnalogInStream(const PinName *pins, int count) :
+        _count(count),
+        _irq(this),
+        _event(0),
+        _buffer(NULL),
+        _length(0),
+        _active(false)
+{
+    MBED_ASSERT(count > 0 && count <= MBED_CONF_DRIVERS_ANALOGIN_STREAM_CHANNELS);
+    for (int i = 0; i < count; i++) {
+        analogin_init(&_adc[i], pins[i]);
+    }
+}
+
+AnalogInStream::~AnalogInStream()
+{
+    stop();
+}
+
+int AnalogInStream::start(uint16_t *buffer, size_t length, uint32_t sample_rate_hz,
+                          const event_callback_t &callback, int event)
+{
+    if (length == 0 || length % (2 * _count)) {
+        return -1;
+    }
+#if MBED_DCACHE_PRESENT
+    if (!mbed_dcache_is_aligned(buffer, length / 2 * sizeof(uint16_t)) ||
+            !mbed_dcache_is_aligned(buffer + length / 2, length / 2 * sizeof(uint16_t))) {
+        return -1;
+    }
+#endif
+
+    analogin_t *channels[MBED_CONF_DRIVERS_ANALOGIN_STREAM_CHANNELS];
+    for (int i = 0; i < _count; i++) {
+        channels[i] = &_adc[i];
+    }
+
+    core_util_critical_section_enter();
+    if (_active) {
+        core_util_critical_section_exit();
+        return -1;
+    }
+    _active = true;
+    core_util_critical_section_exit();
+
+    _callback = callback;
+    _event = event;
+    _buffer = buffer;
+    _length = length;
+    mbed_dcache_invalidate(_buffer, _length * sizeof(uint16_t));
+    _irq.callback(&AnalogInStream::irq_handler_asynch);
+
+    sleep_manager_lock_deep_sleep_named("AnalogIn");
+    if (analogin_stream_start(channels, _count, buffer, length, sample_rate_hz, _irq.entry(), DMA_USAGE_ALWAYS) != 0) {
+        sleep_manager_unlock_deep_sleep_named("AnalogIn");
+        _active = false;
+        return -1;
+    }
+    return 0;
+}
+
+void AnalogInStream::stop()
+{
+    core_util_critical_section_enter();
+    if (_active) {
+        analogin_stream_stop(&_adc[0]);
+        sleep_manager_unlock_deep_sleep_named("AnalogIn");
+        _active = false;
+    }
+    core_util_critical_section_exit();
+}
+
+bool AnalogInStream::active() const
+{
+    return _active;
+}
+
+int AnalogInStream::channels() const
+{
+    return _count;
+}
+
+const uint16_t *AnalogInStream::half(int event) const
+{
+    if (event & ANALOGIN_EVENT_COMPLETE) {
+        return _buffer + _length / 2;
+    } else if (event & ANALOGIN_EVENT_HALF) {
+        return _buffer;
+    }
+    return NULL;
+}
+
+void AnalogInStream::irq_handler_asynch(void)
+{
+    int event = analogin_stream_irq_handler_asynch(&_adc[0]);
+
+    // drop any lines the core fetched while DMA was writing the filled half
+    if (event & ANALOGIN_EVENT_HALF) {
+        mbed_dcache_invalidate(_buffer, _length / 2 * sizeof(uint16_t));
+    }
+    if (event & ANALOGIN_EVENT_COMPLETE) {
+        mbed_dcache_invalidate(_buffer + _length / 2, _length / 2 * sizeof(uint16_t));
+    }
+
+    if (_callback && (event & _event)) {
+        _callback.call(event & _event);
+    }
+}
+
+} // namespace mbed
+
+#endif
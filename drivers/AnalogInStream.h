@@ -0,0 +1,144 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MBED_ANALOGINSTREAM_H
+#define MBED_ANALOGINSTREAM_H
+
+#include "platform/platform.h"
+
+#if (DEVICE_ANALOGIN && DEVICE_ANALOGIN_ASYNCH) || defined(DOXYGEN_ONLY)
+
+#include "hal/analogin_api.h"
+#include "platform/Callback.h"
+#include "platform/CThunk.h"
+#include "platform/NonCopyable.h"
+
+#ifndef MBED_CONF_DRIVERS_ANALOGIN_STREAM_CHANNELS
+#define MBED_CONF_DRIVERS_ANALOGIN_STREAM_CHANNELS  8
+#endif
+
+namespace mbed {
+/** \addtogroup drivers */
+
+/** Continuous sampling of one or more analog inputs
+ *
+ * A hardware timer triggers the conversions and DMA fills a circular
+ * buffer, so sample rates are limited by the converter rather than by
+ * interrupt latency. The buffer is used as two halves: the callback is
+ * called when one half is full and the application processes it while
+ * the other half fills. With more than one channel the inputs are scanned
+ * together and their samples are interleaved in channel order.
+ *
+ * The callback runs in interrupt context and must be done with a half
+ * before the other half fills, or ANALOGIN_EVENT_OVERRUN is reported.
+ *
+ * @note Synchronization level: Interrupt safe
+ *
+ * Example:
+ * @code
+ * #include "mbed.h"
+ *
+ * static const PinName pins[] = { A0, A1 };
+ * AnalogInStream adc(pins, 2);
+ * MBED_DCACHE_ALIGNED static uint16_t samples[2 * 256];
+ *
+ * void filled(int event) {
+ *     // 128 scans of A0 and A1, interleaved
+ *     const uint16_t *half = adc.half(event);
+ *     process(half, 256);
+ * }
+ *
+ * int main() {
+ *     adc.start(samples, 2 * 256, 48000, filled);
+ * }
+ * @endcode
+ * @ingroup drivers
+ */
+class AnalogInStream : private NonCopyable<AnalogInStream> {
+
+public:
+
+    /** Create a stream sampling a single pin
+     *
+     * @param pin AnalogIn pin to connect to
+     */
+    AnalogInStream(PinName pin);
+
+    /** Create a stream scanning several pins of the same converter
+     *
+     * @param pins  AnalogIn pins to connect to, in scan order
+     * @param count Number of pins, at most MBED_CONF_DRIVERS_ANALOGIN_STREAM_CHANNELS
+     */
+    AnalogInStream(const PinName *pins, int count);
+
+    virtual ~AnalogInStream();
+
+    /** Start sampling
+     *
+     * This function locks the deep sleep until stop is called.
+     *
+     * On targets with a data cache, each half of the buffer must cover whole
+     * cache lines (see mbed_dcache_is_aligned), since the halves are
+     * invalidated while DMA keeps writing the buffer.
+     *
+     * @param buffer         The sample buffer, it must stay valid until stop
+     * @param length         The number of samples in the buffer, a multiple of 2 * channels
+     * @param sample_rate_hz The number of scans per second
+     * @param callback       The event callback function
+     * @param event          The logical OR of events to call the callback for
+     * @return Zero if sampling started, or -1 if the stream is running, the
+     *         buffer is not cache line aligned or the target can not sample
+     *         the channels at that rate
+     */
+    int start(uint16_t *buffer, size_t length, uint32_t sample_rate_hz, const event_callback_t &callback,
+              int event = ANALOGIN_EVENT_HALF | ANALOGIN_EVENT_COMPLETE);
+
+    /** Stop sampling
+     */
+    void stop();
+
+    /** Check if the stream is running
+     */
+    bool active() const;
+
+    /** Get the number of channels scanned
+     */
+    int channels() const;
+
+    /** Get the half of the buffer an event reports as filled
+     *
+     * @param event The event passed to the callback
+     * @return The first sample of the filled half, or NULL if no half was filled
+     */
+    const uint16_t *half(int event) const;
+
+protected:
+    void irq_handler_asynch(void);
+
+    analogin_t _adc[MBED_CONF_DRIVERS_ANALOGIN_STREAM_CHANNELS];
+    int _count;
+    CThunk<AnalogInStream> _irq;
+    event_callback_t _callback;
+    int _event;
+    uint16_t *_buffer;
+    size_t _length;
+    bool _active;
+};
+
+} // namespace mbed
+
+#endif
+
+#endif
@@ -22,17 +22,19 @@ BusIn::BusIn(PinName p0, PinName p1, PinName p2, PinName p3, PinName p4, PinName
     PinName pins[16] = {p0, p1, p2, p3, p4, p5, p6, p7, p8, p9, p10, p11, p12, p13, p14, p15};
 
     // No lock needed in the constructor
-    _nc_mask = 0;
-    for (int i=0; i<16; i++) {
-        _pin[i] = (pins[i] != NC) ? new DigitalIn(pins[i]) : 0;
-        if (pins[i] != NC) {
-            _nc_mask |= (1 << i);
-        }
-    }
+    _init(pins);
 }
 
 BusIn::BusIn(PinName pins[16]) {
     // No lock needed in the constructor
+    _init(pins);
+}
+
+void BusIn::_init(const PinName pins[16]) {
+#if DEVICE_PORTIN
+    // set up the ports first, so each DigitalIn applies its own pin configuration
+    _port_mask = _port.init(pins, PIN_INPUT);
+#endif
     _nc_mask = 0;
     for (int i=0; i<16; i++) {
         _pin[i] = (pins[i] != NC) ? new DigitalIn(pins[i]) : 0;
@@ -54,8 +56,13 @@ BusIn::~BusIn() {
 int BusIn::read() {
     int v = 0;
     lock();
+    int pin_mask = _nc_mask;
+#if DEVICE_PORTIN
+    v = _port.read();
+    pin_mask &= ~_port_mask;
+#endif
     for (int i=0; i<16; i++) {
-        if (_pin[i] != 0) {
+        if (pin_mask & (1 << i)) {
             v |= _pin[i]->read() << i;
         }
     }
@@ -18,6 +18,7 @@
 
 #include "platform/platform.h"
 #include "drivers/DigitalIn.h"
+#include "drivers/BusPort.h"
 #include "platform/PlatformMutex.h"
 #include "platform/NonCopyable.h"
 
@@ -114,8 +115,20 @@ protected:
      */
     int _nc_mask;
 
+#if DEVICE_PORTIN
+    /* Bus pins sharing a port are accessed together through _port
+     * If bit[n] is set to 1 - pin is accessed through _port
+     * if bit[n] is cleared - pin is accessed through _pin[n]
+     */
+    BusPort _port;
+    int _port_mask;
+#endif
+
     PlatformMutex _mutex;
 
+private:
+    void _init(const PinName pins[16]);
+
 private:
     virtual void lock();
     virtual void unlock();
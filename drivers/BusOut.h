@@ -17,6 +17,7 @@
 #define MBED_BUSOUT_H
 
 #include "drivers/DigitalOut.h"
+#include "drivers/BusPort.h"
 #include "platform/PlatformMutex.h"
 #include "platform/NonCopyable.h"
 
@@ -119,7 +120,19 @@ protected:
      */
     int _nc_mask;
 
+#if DEVICE_PORTOUT
+    /* Bus pins sharing a port are accessed together through _port
+     * If bit[n] is set to 1 - pin is accessed through _port
+     * if bit[n] is cleared - pin is accessed through _pin[n]
+     */
+    BusPort _port;
+    int _port_mask;
+#endif
+
     PlatformMutex _mutex;
+
+private:
+    void _init(const PinName pins[16]);
 };
 
 } // namespace mbed
@@ -0,0 +1,97 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "drivers/BusPort.h"
+
+#if DEVICE_PORTIN || DEVICE_PORTOUT
+
+namespace mbed {
+
+BusPort::BusPort() : _count(0)
+{
+}
+
+int BusPort::init(const PinName pins[16], PinDirection dir)
+{
+    PortName ports[16];
+    bool mapped[16];
+    int covered = 0;
+
+    for (int i = 0; i < 16; i++) {
+        int pin_n;
+        mapped[i] = pins[i] != NC && pin_port(pins[i], &ports[i], &pin_n);
+        if (mapped[i]) {
+            _port_bit[i] = pin_n;
+        }
+    }
+
+    for (int i = 0; i < 16 && _count < MBED_CONF_DRIVERS_BUS_PORTS; i++) {
+        if (!mapped[i]) {
+            continue;
+        }
+
+        int bus_mask = 0;
+        int port_mask = 0;
+        for (int j = i; j < 16; j++) {
+            if (mapped[j] && ports[j] == ports[i]) {
+                bus_mask |= 1 << j;
+                port_mask |= 1 << _port_bit[j];
+                mapped[j] = false;
+            }
+        }
+
+        // a lone pin gains nothing over its DigitalOut or DigitalIn
+        if (bus_mask & (bus_mask - 1)) {
+            Group &group = _groups[_count++];
+            port_init(&group.port, ports[i], port_mask, dir);
+            group.bus_mask = bus_mask;
+            covered |= bus_mask;
+        }
+    }
+    return covered;
+}
+
+void BusPort::write(int value)
+{
+    for (int g = 0; g < _count; g++) {
+        Group &group = _groups[g];
+        int port_value = 0;
+        for (int i = 0; i < 16; i++) {
+            if ((group.bus_mask & value) & (1 << i)) {
+                port_value |= 1 << _port_bit[i];
+            }
+        }
+        port_write(&group.port, port_value);
+    }
+}
+
+int BusPort::read()
+{
+    int value = 0;
+    for (int g = 0; g < _count; g++) {
+        Group &group = _groups[g];
+        int port_value = port_read(&group.port);
+        for (int i = 0; i < 16; i++) {
+            if ((group.bus_mask & (1 << i)) && (port_value & (1 << _port_bit[i]))) {
+                value |= 1 << i;
+            }
+        }
+    }
+    return value;
+}
+
+} // namespace mbed
+
+#endif
@@ -0,0 +1,77 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MBED_BUSPORT_H
+#define MBED_BUSPORT_H
+
+#include "platform/platform.h"
+
+#if DEVICE_PORTIN || DEVICE_PORTOUT
+
+#include "hal/port_api.h"
+
+#ifndef MBED_CONF_DRIVERS_BUS_PORTS
+#define MBED_CONF_DRIVERS_BUS_PORTS     2
+#endif
+
+namespace mbed {
+
+/** The port accesses backing the pins of a BusOut or BusIn
+ *
+ * The bus pins that share a GPIO port are reached with one port_write or
+ * port_read of that port, so they change together and a 16-bit bus costs
+ * a few register accesses rather than one per bit. Only ports with at
+ * least two bus pins are used, the bus keeps reaching the other pins
+ * one at a time.
+ *
+ * @note Synchronization level: Not protected, the bus holds its mutex
+ */
+class BusPort {
+
+public:
+    BusPort();
+
+    /** Group the bus pins by port and initialize the ports
+     *
+     *  @param pins The bus pins, NC for unused bits
+     *  @param dir  The direction of the bus
+     *  @return The mask of bus bits reached through a port
+     */
+    int init(const PinName pins[16], PinDirection dir);
+
+    /** Write the bus bits reached through a port
+     */
+    void write(int value);
+
+    /** Read the bus bits reached through a port
+     */
+    int read();
+
+private:
+    struct Group {
+        port_t port;
+        int bus_mask;
+    };
+
+    Group _groups[MBED_CONF_DRIVERS_BUS_PORTS];
+    int _count;
+    unsigned char _port_bit[16];    // bit in its port of each bus bit
+};
+
+} // namespace mbed
+
+#endif
+
+#endif
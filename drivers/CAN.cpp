@@ -18,11 +18,17 @@
 #if DEVICE_CAN
 
 #include "cmsis.h"
+#include "hal/us_ticker_api.h"
+#include "platform/mbed_critical.h"
 #include "platform/mbed_sleep.h"
 
 namespace mbed {
 
-CAN::CAN(PinName rd, PinName td) : _can(), _irq() {
+CAN::CAN(PinName rd, PinName td) : _can(), _irq(), _tx_time(0), _tx_time_valid(false)
+#if MBED_CONF_DRIVERS_CAN_RX_BUFFER_SIZE
+        , _rx_dropped(0)
+#endif
+{
     // No lock needed in constructor
 
     for (size_t i = 0; i < sizeof _irq / sizeof _irq[0]; i++) {
@@ -30,10 +36,14 @@ CAN::CAN(PinName rd, PinName td) : _can(), _irq() {
     }
 
     can_init(&_can, rd, td);
-    can_irq_init(&_can, (&CAN::_irq_handler), (uint32_t)this);
+    _init();
 }
 
-CAN::CAN(PinName rd, PinName td, int hz) : _can(), _irq() {
+CAN::CAN(PinName rd, PinName td, int hz) : _can(), _irq(), _tx_time(0), _tx_time_valid(false)
+#if MBED_CONF_DRIVERS_CAN_RX_BUFFER_SIZE
+        , _rx_dropped(0)
+#endif
+{
     // No lock needed in constructor
 
     for (size_t i = 0; i < sizeof _irq / sizeof _irq[0]; i++) {
@@ -41,13 +51,25 @@ CAN::CAN(PinName rd, PinName td, int hz) : _can(), _irq() {
     }
 
     can_init_freq(&_can, rd, td, hz);
+    _init();
+}
+
+void CAN::_init() {
     can_irq_init(&_can, (&CAN::_irq_handler), (uint32_t)this);
+#if MBED_CONF_DRIVERS_CAN_RX_BUFFER_SIZE
+    // frames are buffered from the RX interrupt whether a callback is attached or not
+    sleep_manager_lock_deep_sleep_named("CAN");
+    can_irq_set(&_can, IRQ_RX, 1);
+#endif
 }
 
 CAN::~CAN() {
     // No lock needed in destructor
     can_irq_free(&_can);
     can_free(&_can);
+#if MBED_CONF_DRIVERS_CAN_RX_BUFFER_SIZE
+    sleep_manager_unlock_deep_sleep_named("CAN");
+#endif
 }
 
 int CAN::frequency(int f) {
@@ -66,7 +88,48 @@ int CAN::write(CANMessage msg) {
 
 int CAN::read(CANMessage &msg, int handle) {
     lock();
-    int ret = can_read(&_can, &msg, handle);
+#if MBED_CONF_DRIVERS_CAN_RX_BUFFER_SIZE
+    (void)handle;
+    int ret = _rxbuf.pop(msg) ? 1 : 0;
+#else
+    int ret = can_read_timestamp(&_can, &msg, handle);
+#endif
+    unlock();
+    return ret;
+}
+
+int CAN::read(CANMessage *msgs, int count) {
+    lock();
+#if MBED_CONF_DRIVERS_CAN_RX_BUFFER_SIZE
+    int ret = count > 0 ? _rxbuf.pop(msgs, count) : 0;
+#else
+    int ret = 0;
+    while (ret < count && can_read_timestamp(&_can, &msgs[ret], 0)) {
+        ret++;
+    }
+#endif
+    unlock();
+    return ret;
+}
+
+unsigned int CAN::rx_dropped() {
+#if MBED_CONF_DRIVERS_CAN_RX_BUFFER_SIZE
+    return _rx_dropped;
+#else
+    return 0;
+#endif
+}
+
+int CAN::tx_timestamp(unsigned int &timestamp) {
+    lock();
+    uint32_t time;
+    int ret = can_tx_timestamp(&_can, &time);
+    if (ret) {
+        timestamp = time;
+    } else if (_tx_time_valid) {
+        timestamp = _tx_time;
+        ret = 1;
+    }
     unlock();
     return ret;
 }
@@ -111,19 +174,46 @@ int CAN::filter(unsigned int id, unsigned int mask, CANFormat format, int handle
     return ret;
 }
 
+int CAN::filter_banks() {
+    lock();
+    int ret = can_filter_banks(&_can);
+    unlock();
+    return ret;
+}
+
+int CAN::filter(const Filter *filters, int count) {
+    lock();
+    int ret = count <= can_filter_banks(&_can);
+    for (int i = 0; ret && i < count; i++) {
+        ret = can_filter_bank(&_can, i, filters[i].id, filters[i].mask, filters[i].format);
+    }
+    unlock();
+    return ret;
+}
+
 void CAN::attach(Callback<void()> func, IrqType type) {
     lock();
+#if MBED_CONF_DRIVERS_CAN_RX_BUFFER_SIZE
+    if (type == RxIrq) {
+        // the RX interrupt and its deep sleep lock are held by the buffer
+        core_util_critical_section_enter();
+        _irq[RxIrq] = func;
+        core_util_critical_section_exit();
+        unlock();
+        return;
+    }
+#endif
     if (func) {
         // lock deep sleep only the first time
         if (!_irq[(CanIrqType)type]) {
-            sleep_manager_lock_deep_sleep();
+            sleep_manager_lock_deep_sleep_named("CAN");
         }
         _irq[(CanIrqType)type] = func;
         can_irq_set(&_can, (CanIrqType)type, 1);
     } else {
         // unlock deep sleep only the first time
         if (_irq[(CanIrqType)type]) {
-            sleep_manager_unlock_deep_sleep();
+            sleep_manager_unlock_deep_sleep_named("CAN");
         }
         _irq[(CanIrqType)type] = NULL;
         can_irq_set(&_can, (CanIrqType)type, 0);
@@ -133,6 +223,21 @@ void CAN::attach(Callback<void()> func, IrqType type) {
 
 void CAN::_irq_handler(uint32_t id, CanIrqType type) {
     CAN *handler = (CAN*)id;
+#if MBED_CONF_DRIVERS_CAN_RX_BUFFER_SIZE
+    if (type == IRQ_RX) {
+        // drain the hardware FIFO in one go
+        CANMessage msg;
+        while (can_read_timestamp(&handler->_can, &msg, 0)) {
+            if (!handler->_rxbuf.push(msg)) {
+                handler->_rx_dropped++;
+            }
+        }
+    }
+#endif
+    if (type == IRQ_TX) {
+        handler->_tx_time = us_ticker_read();
+        handler->_tx_time_valid = true;
+    }
     if (handler->_irq[type]) {
         handler->_irq[type].call();
     }
@@ -25,6 +25,14 @@
 #include "platform/PlatformMutex.h"
 #include "platform/NonCopyable.h"
 
+#ifndef MBED_CONF_DRIVERS_CAN_RX_BUFFER_SIZE
+#define MBED_CONF_DRIVERS_CAN_RX_BUFFER_SIZE 0
+#endif
+
+#if MBED_CONF_DRIVERS_CAN_RX_BUFFER_SIZE
+#include "platform/SPSCCircularBuffer.h"
+#endif
+
 namespace mbed {
 /** \addtogroup drivers */
 
@@ -43,6 +51,7 @@ public:
         type   = CANData;
         format = CANStandard;
         id     = 0;
+        timestamp = 0;
         memset(data, 0, 8);
     }
 
@@ -59,6 +68,7 @@ public:
       type   = _type;
       format = _format;
       id     = _id;
+      timestamp = 0;
       memcpy(data, _data, _len);
     }
 
@@ -72,11 +82,18 @@ public:
       type   = CANRemote;
       format = _format;
       id     = _id;
+      timestamp = 0;
       memset(data, 0, 8);
     }
 };
 
 /** A can bus client, used for communicating with can devices
+ *
+ * With drivers.can-rx-buffer-size set, the RX interrupt stays enabled and
+ * moves every received frame into a buffer of that many messages, so
+ * frames are not lost while the application is busy, and read drains the
+ * buffer. The filter handle of read is then ignored.
+ *
  * @ingroup drivers
  */
 class CAN : private NonCopyable<CAN> {
@@ -163,6 +180,36 @@ public:
      */
     int read(CANMessage &msg, int handle = 0);
 
+    /** Read a number of CANMessages from the bus
+     *
+     *  @param msgs  The CANMessages to read to
+     *  @param count The number of messages to read at most
+     *
+     *  @returns
+     *    the number of messages read, 0 if no message arrived
+     */
+    int read(CANMessage *msgs, int count);
+
+    /** Get the number of received messages dropped because the RX buffer was full
+     *
+     *  @returns
+     *    the number of dropped messages, always 0 without drivers.can-rx-buffer-size
+     */
+    unsigned int rx_dropped();
+
+    /** Get the transmission time of the last message sent
+     *
+     *  Without a timestamping peripheral the time is taken in the TX
+     *  interrupt, so a TxIrq callback must be attached.
+     *
+     *  @param timestamp The transmission time in microseconds of the us ticker
+     *
+     *  @returns
+     *    0 if no transmission time is known,
+     *    1 if timestamp was set
+     */
+    int tx_timestamp(unsigned int &timestamp);
+
     /** Reset CAN interface.
      *
      * To use after error overflow.
@@ -207,6 +254,33 @@ public:
      */
     int filter(unsigned int id, unsigned int mask, CANFormat format = CANAny, int handle = 0);
 
+    /** A hardware filter bank */
+    struct Filter {
+        unsigned int id;        /**< the id to filter on */
+        unsigned int mask;      /**< the mask applied to the id */
+        CANFormat format;       /**< format to filter on */
+    };
+
+    /** Get the number of hardware filter banks
+     *
+     *  @returns the number of filters filter(const Filter *, int) accepts
+     */
+    int filter_banks();
+
+    /** Configure several hardware filter banks at once
+     *
+     *  The filters are programmed into banks 0 to count - 1, and the bank
+     *  number is the filter handle of read.
+     *
+     *  @param filters The filters
+     *  @param count The number of filters, at most filter_banks()
+     *
+     *  @returns
+     *    0 if a filter change failed or is unsupported,
+     *    1 if all filters were configured
+     */
+    int filter(const Filter *filters, int count);
+
     /**  Detects read errors - Used to detect read overflow errors.
      *
      *  @returns number of read errors
@@ -286,9 +360,17 @@ public:
 protected:
     virtual void lock();
     virtual void unlock();
+    void _init();
+
     can_t               _can;
     Callback<void()>    _irq[IrqCnt];
     PlatformMutex       _mutex;
+    volatile unsigned int _tx_time;
+    volatile bool       _tx_time_valid;
+#if MBED_CONF_DRIVERS_CAN_RX_BUFFER_SIZE
+    SPSCCircularBuffer<CANMessage, MBED_CONF_DRIVERS_CAN_RX_BUFFER_SIZE> _rxbuf;
+    volatile unsigned int _rx_dropped;
+#endif
 };
 
 } // namespace mbed
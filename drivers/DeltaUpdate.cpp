@@ -0,0 +1,404 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <string.h>
+#include "drivers/DeltaUpdate.h"
+#include "drivers/MbedCRC.h"
+
+#if DEVICE_FLASH
+
+namespace mbed {
+
+// "MDP1", the header is followed by records until the new image is complete
+#define DELTA_UPDATE_MAGIC          0x3150444D
+#define DELTA_UPDATE_HEADER_SIZE    20
+#define DELTA_UPDATE_RECORD_SIZE    12
+
+static uint32_t get_le32(const uint8_t *p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+DeltaUpdate::DeltaUpdate(FlashIAP &flash)
+    : _flash(flash), _writer(flash), _header_len(0), _state(STATE_ERROR), _error(-1),
+      _old_addr(0), _old_size(0), _new_addr(0), _new_region(0), _new_size(0), _new_crc(0),
+      _old_pos(0), _written(0), _diff_left(0), _extra_left(0), _seek(0), _run_left(0),
+      _varint(0), _shift(0)
+{
+}
+
+DeltaUpdate::~DeltaUpdate()
+{
+}
+
+int DeltaUpdate::begin(uint32_t old_addr, uint32_t old_size, uint32_t new_addr, uint32_t new_size)
+{
+    uint32_t flash_start = _flash.get_flash_start();
+    uint32_t flash_end = flash_start + _flash.get_flash_size();
+    if (old_addr < flash_start || old_addr > flash_end || old_size > flash_end - old_addr ||
+            new_addr < flash_start || new_addr > flash_end || new_size > flash_end - new_addr ||
+            new_addr % _flash.get_sector_size(new_addr)) {
+        return -1;
+    }
+
+    // The new image can not be built over the image it is built from
+    if (old_addr < new_addr + new_size && new_addr < old_addr + old_size) {
+        return -1;
+    }
+
+    _old_addr = old_addr;
+    _old_size = old_size;
+    _new_addr = new_addr;
+    _new_region = new_size;
+    _new_size = 0;
+    _new_crc = 0;
+    _old_pos = 0;
+    _written = 0;
+    _header_len = 0;
+    _varint = 0;
+    _shift = 0;
+    _error = 0;
+    _state = STATE_HEADER;
+    return 0;
+}
+
+int DeltaUpdate::write(const void *data, size_t size)
+{
+    if (_state == STATE_ERROR) {
+        return _error;
+    }
+
+    const uint8_t *bytes = static_cast<const uint8_t *>(data);
+    while (size) {
+        int err = 0;
+        uint32_t n;
+
+        switch (_state) {
+            case STATE_HEADER:
+            case STATE_RECORD: {
+                size_t total = _state == STATE_HEADER ? DELTA_UPDATE_HEADER_SIZE : DELTA_UPDATE_RECORD_SIZE;
+                n = total - _header_len;
+                if (n > size) {
+                    n = size;
+                }
+                memcpy(&_header[_header_len], bytes, n);
+                _header_len += n;
+                if (_header_len == total) {
+                    _header_len = 0;
+                    err = _state == STATE_HEADER ? start() : next_record();
+                }
+                break;
+            }
+
+            case STATE_TOKEN: {
+                // A varint, odd for a run of differences that follows and
+                // even for a run of bytes the same as in the current image
+                n = 1;
+                if (_shift > 28) {
+                    err = DELTA_UPDATE_ERROR_FORMAT;
+                    break;
+                }
+                _varint |= (uint32_t)(bytes[0] & 0x7F) << _shift;
+                _shift += 7;
+                if (bytes[0] & 0x80) {
+                    break;
+                }
+
+                uint32_t run = _varint >> 1;
+                bool literal = _varint & 1;
+                _varint = 0;
+                _shift = 0;
+                if (!run || run > _diff_left) {
+                    err = DELTA_UPDATE_ERROR_FORMAT;
+                    break;
+                }
+                _diff_left -= run;
+
+                if (literal) {
+                    _run_left = run;
+                    _state = STATE_LITERAL;
+                } else {
+                    err = copy(NULL, run);
+                    if (!err) {
+                        err = next_run();
+                    }
+                }
+                break;
+            }
+
+            case STATE_LITERAL:
+                n = _run_left < size ? _run_left : size;
+                _run_left -= n;
+                err = copy(bytes, n);
+                if (!err && !_run_left) {
+                    err = next_run();
+                }
+                break;
+
+            case STATE_EXTRA:
+                n = _extra_left < size ? _extra_left : size;
+                _extra_left -= n;
+                _written += n;
+                err = _writer.write(bytes, n);
+                if (!err && !_extra_left) {
+                    err = end_record();
+                }
+                break;
+
+            default:
+                // bytes past the end of the patch
+                n = 0;
+                err = DELTA_UPDATE_ERROR_FORMAT;
+                break;
+        }
+
+        if (err) {
+            return fail(err);
+        }
+        bytes += n;
+        size -= n;
+    }
+
+    return 0;
+}
+
+int DeltaUpdate::apply(FileHandle *patch)
+{
+    while (true) {
+        ssize_t n = patch->read(_input, sizeof(_input));
+        if (n < 0) {
+            return fail(n);
+        }
+        if (n == 0) {
+            break;
+        }
+
+        int err = write(_input, n);
+        if (err) {
+            return err;
+        }
+    }
+
+    return finish();
+}
+
+int DeltaUpdate::finish()
+{
+    if (_state == STATE_ERROR) {
+        return _error;
+    }
+    if (_state != STATE_DONE) {
+        return fail(DELTA_UPDATE_ERROR_FORMAT);
+    }
+
+    int err = _writer.finish();
+    if (err) {
+        _state = STATE_ERROR;
+        _error = err;
+        return err;
+    }
+
+    uint32_t new_crc;
+    err = crc(_new_addr, _new_size, &new_crc);
+    if (!err && new_crc != _new_crc) {
+        err = DELTA_UPDATE_ERROR_CHECK;
+    }
+
+    // a patch is applied once
+    _state = STATE_ERROR;
+    _error = err ? err : -1;
+    return err;
+}
+
+uint32_t DeltaUpdate::size() const
+{
+    return _new_size;
+}
+
+uint32_t DeltaUpdate::written() const
+{
+    return _written;
+}
+
+int DeltaUpdate::fail(int err)
+{
+    if (_state != STATE_HEADER && _state != STATE_ERROR) {
+        // wait for the flash, the partial image is left as it is
+        _writer.finish();
+    }
+
+    _state = STATE_ERROR;
+    _error = err;
+    return err;
+}
+
+int DeltaUpdate::start()
+{
+    if (get_le32(&_header[0]) != DELTA_UPDATE_MAGIC) {
+        return DELTA_UPDATE_ERROR_FORMAT;
+    }
+
+    uint32_t old_size = get_le32(&_header[4]);
+    uint32_t old_crc = get_le32(&_header[8]);
+    _new_size = get_le32(&_header[12]);
+    _new_crc = get_le32(&_header[16]);
+    if (!_new_size || _new_size > _new_region) {
+        return DELTA_UPDATE_ERROR_FORMAT;
+    }
+
+    // Check the source before anything is erased
+    uint32_t crc_old;
+    if (old_size > _old_size) {
+        return DELTA_UPDATE_ERROR_SOURCE;
+    }
+    int err = crc(_old_addr, old_size, &crc_old);
+    if (err) {
+        return err;
+    }
+    if (crc_old != old_crc) {
+        return DELTA_UPDATE_ERROR_SOURCE;
+    }
+    _old_size = old_size;
+
+    err = _writer.begin(_new_addr, _new_size);
+    if (err) {
+        return err;
+    }
+
+    _state = STATE_RECORD;
+    return 0;
+}
+
+int DeltaUpdate::next_record()
+{
+    uint32_t diff_len = get_le32(&_header[0]);
+    uint32_t extra_len = get_le32(&_header[4]);
+    _seek = (int32_t)get_le32(&_header[8]);
+
+    if (diff_len > _old_size - _old_pos ||
+            diff_len > _new_size - _written ||
+            extra_len > _new_size - _written - diff_len) {
+        return DELTA_UPDATE_ERROR_FORMAT;
+    }
+
+    _diff_left = diff_len;
+    _extra_left = extra_len;
+    return next_run();
+}
+
+int DeltaUpdate::next_run()
+{
+    if (_diff_left) {
+        _state = STATE_TOKEN;
+    } else if (_extra_left) {
+        _state = STATE_EXTRA;
+    } else {
+        return end_record();
+    }
+
+    return 0;
+}
+
+int DeltaUpdate::end_record()
+{
+    // Move in the current image to where the next record continues from
+    int64_t pos = (int64_t)_old_pos + _seek;
+    if (pos < 0 || pos > _old_size) {
+        return DELTA_UPDATE_ERROR_FORMAT;
+    }
+    _old_pos = (uint32_t)pos;
+
+    _state = _written == _new_size ? STATE_DONE : STATE_RECORD;
+    return 0;
+}
+
+int DeltaUpdate::copy(const uint8_t *diff, uint32_t size)
+{
+    // New bytes are the bytes of the current image plus the differences
+    while (size) {
+        uint32_t n = size < sizeof(_buffer) ? size : sizeof(_buffer);
+        int err = read_flash(_buffer, _old_addr + _old_pos, n);
+        if (err) {
+            return err;
+        }
+
+        if (diff) {
+            for (uint32_t i = 0; i < n; i++) {
+                _buffer[i] += diff[i];
+            }
+            diff += n;
+        }
+
+        err = _writer.write(_buffer, n);
+        if (err) {
+            return err;
+        }
+
+        _old_pos += n;
+        _written += n;
+        size -= n;
+    }
+
+    return 0;
+}
+
+int DeltaUpdate::read_flash(uint8_t *buffer, uint32_t addr, uint32_t size)
+{
+    while (_flash.read(buffer, addr, size)) {
+#if DEVICE_FLASH_ASYNCH
+        // reads fail while the writer erases or programs, move it on
+        if (_flash.busy()) {
+            int err = _writer.poll();
+            if (err) {
+                return err;
+            }
+            continue;
+        }
+#endif
+        return -1;
+    }
+
+    return 0;
+}
+
+int DeltaUpdate::crc(uint32_t addr, uint32_t size, uint32_t *crc)
+{
+    MbedCRC<POLY_32BIT_ANSI, 32> ct;
+    int err = ct.compute_partial_start(crc);
+    for (uint32_t offset = 0; !err && offset < size; offset += sizeof(_buffer)) {
+        uint32_t n = size - offset < sizeof(_buffer) ? size - offset : sizeof(_buffer);
+        err = read_flash(_buffer, addr + offset, n);
+        if (!err) {
+            err = ct.compute_partial(_buffer, n, crc);
+        }
+    }
+
+    if (err) {
+        // release a CRC peripheral taken by compute_partial_start
+        ct.compute_partial_stop(crc);
+        return err;
+    }
+    return ct.compute_partial_stop(crc);
+}
+
+} // namespace mbed
+
+#endif
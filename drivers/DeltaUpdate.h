@@ -0,0 +1,190 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef MBED_DELTAUPDATE_H
+#define MBED_DELTAUPDATE_H
+
+#include "platform/platform.h"
+
+#if defined (DEVICE_FLASH) || defined(DOXYGEN_ONLY)
+
+#include "drivers/FlashIAP.h"
+#include "drivers/FlashIAPWriter.h"
+#include "platform/FileHandle.h"
+#include "platform/NonCopyable.h"
+
+#ifndef MBED_CONF_DRIVERS_DELTA_UPDATE_BUFFER_SIZE
+#define MBED_CONF_DRIVERS_DELTA_UPDATE_BUFFER_SIZE 256
+#endif
+
+namespace mbed {
+/** \addtogroup drivers */
+
+/** Applier of delta patches to firmware images in flash
+ *
+ * Builds a new image in one region of flash from the current image in
+ * another and a patch made by tools/delta_patch.py. The patch holds the
+ * differences from bytes of the current image, mostly runs of zeros for
+ * code that only moved, and the bytes that have no match in it, so a
+ * small change to a large image gives a small patch.
+ *
+ * The patch is taken in pieces of any size as it arrives, from a file
+ * or a socket. Whatever the size of the images, a DeltaUpdate uses two
+ * buffers of drivers.delta-update-buffer-size bytes and the buffers of
+ * a FlashIAPWriter. The current image is checked against the CRC-32 in
+ * the patch before anything is written, and the new image is read back
+ * and checked once it is complete.
+ *
+ * The regions must not overlap, the current image is read until the end.
+ *
+ * @note Synchronization level: Not protected
+ *
+ * Example:
+ * @code
+ * #include "mbed.h"
+ *
+ * FlashIAP flash;
+ *
+ * int update(FileHandle *patch) {
+ *     DeltaUpdate delta(flash);
+ *     flash.init();
+ *     delta.begin(APP_ADDR, APP_SIZE, SLOT_ADDR, SLOT_SIZE);
+ *     return delta.apply(patch);
+ * }
+ * @endcode
+ * @ingroup drivers
+ */
+class DeltaUpdate : private NonCopyable<DeltaUpdate> {
+public:
+    /** Errors of a DeltaUpdate, besides -1 for failures of the flash
+     */
+    enum delta_update_error {
+        DELTA_UPDATE_ERROR_FORMAT   = -2, /*!< the patch is malformed or truncated */
+        DELTA_UPDATE_ERROR_SOURCE   = -3, /*!< the current image is not the one the patch was made from */
+        DELTA_UPDATE_ERROR_CHECK    = -4, /*!< the new image does not match its CRC-32 */
+    };
+
+    /** Create an applier of delta patches on an initialized flash device
+     *
+     *  @param flash The flash device holding both images
+     */
+    DeltaUpdate(FlashIAP &flash);
+
+    virtual ~DeltaUpdate();
+
+    /** Start applying a patch
+     *
+     *  @param old_addr Address of the current image
+     *  @param old_size Size of the current image in bytes, or of the region it is in
+     *  @param new_addr Address of the region for the new image, must be a multiple of the sector size
+     *  @param new_size Size of the region for the new image in bytes
+     *  @return 0 on success, negative error code if the regions are not
+     *          in flash or overlap
+     */
+    int begin(uint32_t old_addr, uint32_t old_size, uint32_t new_addr, uint32_t new_size);
+
+    /** Apply the next bytes of the patch
+     *
+     *  @param data Bytes of the patch
+     *  @param size Number of bytes, any number
+     *  @return 0 on success, negative error code on failure, after which
+     *          further bytes are refused
+     */
+    int write(const void *data, size_t size);
+
+    /** Apply a whole patch read from a file
+     *
+     *  Reads the file to its end, then calls finish.
+     *
+     *  @param patch The patch file
+     *  @return 0 if the new image is complete and checked, negative error
+     *          code on failure
+     */
+    int apply(FileHandle *patch);
+
+    /** Complete the new image and check it
+     *
+     *  @return 0 if the patch was whole and the new image matches its
+     *          CRC-32, negative error code otherwise
+     */
+    int finish();
+
+    /** Get the size of the new image
+     *
+     *  @return Size in bytes given by the patch, 0 until its header is applied
+     */
+    uint32_t size() const;
+
+    /** Get the number of bytes of the new image built so far
+     *
+     *  @return Bytes passed to the flash since begin
+     */
+    uint32_t written() const;
+
+protected:
+    enum patch_state {
+        STATE_HEADER,
+        STATE_RECORD,
+        STATE_TOKEN,
+        STATE_LITERAL,
+        STATE_EXTRA,
+        STATE_DONE,
+        STATE_ERROR
+    };
+
+    int fail(int err);
+    int start();
+    int next_record();
+    int next_run();
+    int end_record();
+    int copy(const uint8_t *diff, uint32_t size);
+    int read_flash(uint8_t *buffer, uint32_t addr, uint32_t size);
+    int crc(uint32_t addr, uint32_t size, uint32_t *crc);
+
+    FlashIAP &_flash;
+    FlashIAPWriter _writer;
+    uint8_t _buffer[MBED_CONF_DRIVERS_DELTA_UPDATE_BUFFER_SIZE];
+    uint8_t _input[MBED_CONF_DRIVERS_DELTA_UPDATE_BUFFER_SIZE];
+    uint8_t _header[20];
+    size_t _header_len;
+    patch_state _state;
+    int _error;
+    uint32_t _old_addr;
+    uint32_t _old_size;
+    uint32_t _new_addr;
+    uint32_t _new_region;
+    uint32_t _new_size;
+    uint32_t _new_crc;
+    uint32_t _old_pos;
+    uint32_t _written;
+    uint32_t _diff_left;
+    uint32_t _extra_left;
+    int32_t _seek;
+    uint32_t _run_left;
+    uint32_t _varint;
+    unsigned _shift;
+};
+
+} // namespace mbed
+
+#endif
+
+#endif
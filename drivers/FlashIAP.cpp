@@ -23,6 +23,7 @@
 #include <string.h>
 #include "FlashIAP.h"
 #include "mbed_assert.h"
+#include "platform/mbed_sleep.h"
 
 
 #ifdef DEVICE_FLASH
@@ -41,6 +42,9 @@ static inline bool is_aligned(uint32_t number, uint32_t alignment)
 }
 
 FlashIAP::FlashIAP()
+#if DEVICE_FLASH_ASYNCH
+    : _irq(this), _callback(NULL), _erase_addr(0), _erase_size(0)
+#endif
 {
 
 }
@@ -77,6 +81,12 @@ int FlashIAP::read(void *buffer, uint32_t addr, uint32_t size)
 {
     int32_t ret = -1;
     _mutex->lock();
+#if DEVICE_FLASH_ASYNCH
+    if (flash_active(&_flash)) {
+        _mutex->unlock();
+        return -1;
+    }
+#endif
     ret = flash_read(&_flash, addr, (uint8_t *) buffer, size);
     _mutex->unlock();
     return ret;
@@ -97,6 +107,12 @@ int FlashIAP::program(const void *buffer, uint32_t addr, uint32_t size)
 
     int ret = 0;
     _mutex->lock();
+#if DEVICE_FLASH_ASYNCH
+    if (flash_active(&_flash)) {
+        _mutex->unlock();
+        return -1;
+    }
+#endif
     if (flash_program_page(&_flash, addr, (const uint8_t *)buffer, size)) {
         ret = -1;
     }
@@ -125,6 +141,12 @@ int FlashIAP::erase(uint32_t addr, uint32_t size)
 
     int32_t ret = 0;
     _mutex->lock();
+#if DEVICE_FLASH_ASYNCH
+    if (flash_active(&_flash)) {
+        _mutex->unlock();
+        return -1;
+    }
+#endif
     while (size) {
         ret = flash_erase_sector(&_flash, addr);
         if (ret != 0) {
@@ -163,6 +185,109 @@ uint32_t FlashIAP::get_flash_size() const
     return flash_get_size(&_flash);
 }
 
+#if DEVICE_FLASH_ASYNCH
+
+int FlashIAP::program_async(const void *buffer, uint32_t addr, uint32_t size, const event_callback_t &callback)
+{
+    uint32_t page_size = get_page_size();
+    uint32_t current_sector_size = flash_get_sector_size(&_flash, addr);
+    if (!is_aligned(addr, page_size) ||
+        !is_aligned(size, page_size) ||
+        (size < page_size) ||
+        (((addr % current_sector_size) + size) > current_sector_size)) {
+        return -1;
+    }
+
+    int ret = 0;
+    _mutex->lock();
+    if (flash_active(&_flash)) {
+        ret = -1;
+    } else {
+        _callback = callback;
+        _erase_size = 0;
+        _irq.callback(&FlashIAP::irq_handler_asynch);
+        sleep_manager_lock_deep_sleep_named("FlashIAP");
+        if (flash_program_page_asynch(&_flash, addr, (const uint8_t *)buffer, size, _irq.entry())) {
+            sleep_manager_unlock_deep_sleep_named("FlashIAP");
+            ret = -1;
+        }
+    }
+    _mutex->unlock();
+    return ret;
+}
+
+int FlashIAP::erase_async(uint32_t addr, uint32_t size, const event_callback_t &callback)
+{
+    if (!size || !is_aligned_to_sector(addr, size)) {
+        return -1;
+    }
+
+    int ret = 0;
+    _mutex->lock();
+    if (flash_active(&_flash)) {
+        ret = -1;
+    } else {
+        _callback = callback;
+        _erase_addr = addr;
+        _erase_size = size;
+        _irq.callback(&FlashIAP::irq_handler_asynch);
+        sleep_manager_lock_deep_sleep_named("FlashIAP");
+        if (flash_erase_sector_asynch(&_flash, addr, _irq.entry())) {
+            sleep_manager_unlock_deep_sleep_named("FlashIAP");
+            _erase_size = 0;
+            ret = -1;
+        }
+    }
+    _mutex->unlock();
+    return ret;
+}
+
+bool FlashIAP::busy()
+{
+    return flash_active(&_flash);
+}
+
+void FlashIAP::abort_async()
+{
+    _mutex->lock();
+    if (flash_active(&_flash)) {
+        flash_abort_asynch(&_flash);
+        _erase_size = 0;
+        sleep_manager_unlock_deep_sleep_named("FlashIAP");
+    }
+    _mutex->unlock();
+}
+
+void FlashIAP::irq_handler_asynch(void)
+{
+    uint32_t event = flash_irq_handler_asynch(&_flash);
+    if (!event) {
+        return;
+    }
+
+    if ((event & FLASH_EVENT_COMPLETE) && _erase_size) {
+        // move on to the next sector of an erase_async
+        uint32_t current_sector_size = flash_get_sector_size(&_flash, _erase_addr);
+        _erase_size -= current_sector_size < _erase_size ? current_sector_size : _erase_size;
+        _erase_addr += current_sector_size;
+        if (_erase_size) {
+            if (is_aligned_to_sector(_erase_addr, _erase_size) &&
+                flash_erase_sector_asynch(&_flash, _erase_addr, _irq.entry()) == 0) {
+                return;
+            }
+            event = FLASH_EVENT_ERROR;
+        }
+    }
+
+    _erase_size = 0;
+    sleep_manager_unlock_deep_sleep_named("FlashIAP");
+    if (_callback) {
+        _callback.call(event);
+    }
+}
+
+#endif
+
 }
 
 #endif
@@ -29,6 +29,11 @@
 #include "platform/PlatformMutex.h"
 #include "platform/NonCopyable.h"
 
+#if DEVICE_FLASH_ASYNCH
+#include "platform/CThunk.h"
+#include "platform/Callback.h"
+#endif
+
 namespace mbed {
 
 /** \addtogroup drivers */
@@ -116,6 +121,56 @@ public:
      */
     uint32_t get_page_size() const;
 
+#if DEVICE_FLASH_ASYNCH
+
+    /** Start programming data to pages
+     *
+     *  Checks the arguments like program, starts programming and returns
+     *  without waiting for it to finish. The callback is called from
+     *  interrupt context with FLASH_EVENT_COMPLETE or FLASH_EVENT_ERROR.
+     *  The buffer must stay valid until then.
+     *
+     *  @param buffer   Buffer of data to be written
+     *  @param addr     Address of a page to begin writing to
+     *  @param size     Size to write in bytes, must be a multiple of the page size
+     *  @param callback Called once programming is done
+     *  @return         0 if programming started, negative error code on failure
+     */
+    int program_async(const void *buffer, uint32_t addr, uint32_t size, const event_callback_t &callback);
+
+    /** Start erasing sectors
+     *
+     *  Checks the arguments like erase, starts erasing and returns without
+     *  waiting for it to finish. Sectors are erased one after the other
+     *  from the flash interrupt. The callback is called from interrupt
+     *  context with FLASH_EVENT_COMPLETE once the last sector is erased, or
+     *  with FLASH_EVENT_ERROR as soon as one fails.
+     *
+     *  @param addr     Address of a sector to begin erasing, must be a multiple of the sector size
+     *  @param size     Size to erase in bytes, must be a multiple of the sector size
+     *  @param callback Called once erasing is done
+     *  @return         0 if erasing started, negative error code on failure
+     */
+    int erase_async(uint32_t addr, uint32_t size, const event_callback_t &callback);
+
+    /** Check if an asynchronous operation is running
+     *
+     *  While one is running, read, program and erase fail.
+     *
+     *  @return true from the start of program_async or erase_async until
+     *          just before the callback is called
+     */
+    bool busy();
+
+    /** Abort the running asynchronous operation
+     *
+     *  The callback is not called, and the contents of the sectors being
+     *  erased or the pages being programmed are undefined.
+     */
+    void abort_async();
+
+#endif
+
 private:
 
     /* Check if address and size are aligned to a sector
@@ -128,6 +183,15 @@ private:
 
     flash_t _flash;
     static SingletonPtr<PlatformMutex> _mutex;
+
+#if DEVICE_FLASH_ASYNCH
+    void irq_handler_asynch(void);
+
+    CThunk<FlashIAP> _irq;
+    event_callback_t _callback;
+    uint32_t _erase_addr;   // sector being erased by erase_async
+    uint32_t _erase_size;   // bytes left to erase, including the current sector
+#endif
 };
 
 } /* namespace mbed */
@@ -0,0 +1,337 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <string.h>
+#include "drivers/FlashIAPWriter.h"
+
+#if DEVICE_FLASH
+
+#if MBED_CONF_RTOS_PRESENT
+#include "rtos/Thread.h"
+#endif
+
+namespace mbed {
+
+static void wait_flash()
+{
+#if MBED_CONF_RTOS_PRESENT
+    rtos::Thread::yield();
+#endif
+}
+
+FlashIAPWriter::FlashIAPWriter(FlashIAP &flash)
+    : _flash(flash), _buffer_size(0), _fill(0), _program(0), _start(0), _end(0),
+      _erase_end(0), _erased(0), _written(0), _programmed(0), _op(OP_NONE),
+      _op_addr(0), _op_size(0), _busy(false), _result(0), _error(0), _active(false)
+{
+    memset(_buffers, 0, sizeof(_buffers));
+}
+
+FlashIAPWriter::~FlashIAPWriter()
+{
+#if DEVICE_FLASH_ASYNCH
+    if (_busy) {
+        _flash.abort_async();
+    }
+#endif
+}
+
+int FlashIAPWriter::begin(uint32_t addr, uint32_t size)
+{
+    if (_active || _busy) {
+        return -1;
+    }
+
+    uint32_t flash_start = _flash.get_flash_start();
+    uint32_t flash_end = flash_start + _flash.get_flash_size();
+    if (!size || addr < flash_start || addr > flash_end || size > flash_end - addr ||
+            addr % _flash.get_sector_size(addr)) {
+        return -1;
+    }
+
+    // The buffers hold whole pages, so every program starts on a page
+    uint32_t page_size = _flash.get_page_size();
+    _buffer_size = (MBED_CONF_DRIVERS_FLASH_WRITER_BUFFER_SIZE / page_size) * page_size;
+    if (!_buffer_size) {
+        return -1;
+    }
+
+    _start = addr;
+    _end = addr + size;
+    _erase_end = addr;
+    while (_erase_end < _end) {
+        _erase_end = sector_end(_erase_end);
+    }
+    _erased = addr;
+
+    memset(_buffers, 0, sizeof(_buffers));
+    _buffers[0].addr = addr;
+    _fill = 0;
+    _program = 0;
+    _written = 0;
+    _programmed = 0;
+    _op = OP_NONE;
+    _error = 0;
+    _active = true;
+    return 0;
+}
+
+int FlashIAPWriter::write(const void *data, uint32_t size)
+{
+    if (!_active) {
+        return -1;
+    }
+    if (_error) {
+        return _error;
+    }
+    if (size > _end - _start - _written) {
+        return -1;
+    }
+
+    const uint8_t *bytes = static_cast<const uint8_t *>(data);
+    while (size) {
+        buffer &b = _buffers[_fill];
+        uint32_t n = _buffer_size - b.size;
+        if (n > size) {
+            n = size;
+        }
+        memcpy(&_data[_fill][b.size], bytes, n);
+        b.size += n;
+        bytes += n;
+        size -= n;
+        _written += n;
+
+        if (b.size == _buffer_size) {
+            int err = queue();
+            if (err) {
+                return err;
+            }
+        }
+    }
+
+    return run();
+}
+
+int FlashIAPWriter::poll()
+{
+    if (!_active) {
+        return 0;
+    }
+
+    return run();
+}
+
+int FlashIAPWriter::finish()
+{
+    if (!_active) {
+        return -1;
+    }
+
+    // Pad the last buffer to whole pages and program it in place
+    buffer &b = _buffers[_fill];
+    if (b.size) {
+        uint32_t page_size = _flash.get_page_size();
+        uint32_t pad = (page_size - b.size % page_size) % page_size;
+        memset(&_data[_fill][b.size], 0xFF, pad);
+        b.size += pad;
+        b.done = 0;
+        b.state = BUFFER_QUEUED;
+    }
+
+    // Wait for the flash as well on errors, so it can be used again
+    while (_busy || (!_error && (_op != OP_NONE ||
+            _buffers[0].state != BUFFER_FREE || _buffers[1].state != BUFFER_FREE))) {
+        run();
+        wait_flash();
+    }
+
+    _active = false;
+    return _error;
+}
+
+uint32_t FlashIAPWriter::written() const
+{
+    return _written;
+}
+
+uint32_t FlashIAPWriter::programmed() const
+{
+    return _programmed;
+}
+
+int FlashIAPWriter::queue()
+{
+    buffer &b = _buffers[_fill];
+    b.done = 0;
+    b.state = BUFFER_QUEUED;
+
+    // Fill the other buffer once it has been programmed and verified
+    int next = _fill ^ 1;
+    while (_buffers[next].state != BUFFER_FREE) {
+        int err = run();
+        if (err) {
+            return err;
+        }
+        wait_flash();
+    }
+
+    _buffers[next].addr = b.addr + b.size;
+    _buffers[next].size = 0;
+    _buffers[next].done = 0;
+    _fill = next;
+    return 0;
+}
+
+int FlashIAPWriter::run()
+{
+    while (!_error && step());
+    return _error;
+}
+
+bool FlashIAPWriter::step()
+{
+    if (_busy) {
+        return false;
+    }
+
+    // Account for the operation that completed
+    if (_op != OP_NONE) {
+        flash_op op = _op;
+        _op = OP_NONE;
+        if (_result) {
+            _error = -1;
+            return false;
+        }
+
+        if (op == OP_PROGRAM) {
+            buffer &b = _buffers[_program];
+            b.done += _op_size;
+            if (b.done == b.size) {
+                b.state = BUFFER_PROGRAMMED;
+            }
+        } else {
+            _erased = _op_addr + _op_size;
+        }
+        return true;
+    }
+
+    buffer &b = _buffers[_program];
+
+    // Verify while the flash is idle, reading it during an operation may stall or fail
+    if (b.state == BUFFER_PROGRAMMED) {
+        if (verify(b)) {
+            _error = -1;
+            return false;
+        }
+        _programmed = b.addr + b.size - _start;
+        b.state = BUFFER_FREE;
+        _program ^= 1;
+        return true;
+    }
+
+    // Program the oldest buffer, up to the end of a sector, once the sector is erased
+    if (b.state == BUFFER_QUEUED) {
+        uint32_t addr = b.addr + b.done;
+        if (addr < _erased) {
+            uint32_t size = sector_end(addr) - addr;
+            if (size > b.size - b.done) {
+                size = b.size - b.done;
+            }
+            start(OP_PROGRAM, addr, size);
+        } else {
+            start(OP_ERASE, _erased, sector_end(_erased) - _erased);
+        }
+        return true;
+    }
+
+    // Erase the sectors ahead of the data while nothing is waiting to be programmed
+    uint32_t limit = sector_end(_buffers[_fill].addr + _buffers[_fill].size);
+    for (int i = 0; i < MBED_CONF_DRIVERS_FLASH_WRITER_ERASE_AHEAD && limit < _erase_end; i++) {
+        limit = sector_end(limit);
+    }
+    if (limit > _erase_end) {
+        limit = _erase_end;
+    }
+    if (_erased < limit) {
+        start(OP_ERASE, _erased, sector_end(_erased) - _erased);
+        return true;
+    }
+
+    return false;
+}
+
+void FlashIAPWriter::start(flash_op op, uint32_t addr, uint32_t size)
+{
+    const uint8_t *data = op == OP_PROGRAM ? &_data[_program][addr - _buffers[_program].addr] : NULL;
+    _op = op;
+    _op_addr = addr;
+    _op_size = size;
+
+#if DEVICE_FLASH_ASYNCH
+    _busy = true;
+    event_callback_t done(this, &FlashIAPWriter::complete);
+    int err = op == OP_PROGRAM
+            ? _flash.program_async(data, addr, size, done)
+            : _flash.erase_async(addr, size, done);
+    if (err) {
+        // not started, so done is not called
+        _result = err;
+        _busy = false;
+    }
+#else
+    _result = op == OP_PROGRAM
+            ? _flash.program(data, addr, size)
+            : _flash.erase(addr, size);
+#endif
+}
+
+#if DEVICE_FLASH_ASYNCH
+void FlashIAPWriter::complete(int event)
+{
+    _result = (event & FLASH_EVENT_ERROR) ? -1 : 0;
+    _busy = false;
+}
+#endif
+
+int FlashIAPWriter::verify(const buffer &b)
+{
+#if MBED_CONF_DRIVERS_FLASH_WRITER_VERIFY
+    uint8_t chunk[32];
+    for (uint32_t offset = 0; offset < b.size; offset += sizeof(chunk)) {
+        uint32_t n = b.size - offset < sizeof(chunk) ? b.size - offset : sizeof(chunk);
+        if (_flash.read(chunk, b.addr + offset, n) ||
+                memcmp(chunk, &_data[&b - _buffers][offset], n)) {
+            return -1;
+        }
+    }
+#endif
+    return 0;
+}
+
+uint32_t FlashIAPWriter::sector_end(uint32_t addr) const
+{
+    uint32_t sector_size = _flash.get_sector_size(addr);
+    return addr - addr % sector_size + sector_size;
+}
+
+} // namespace mbed
+
+#endif
@@ -0,0 +1,204 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef MBED_FLASHIAPWRITER_H
+#define MBED_FLASHIAPWRITER_H
+
+#include "platform/platform.h"
+
+#if defined (DEVICE_FLASH) || defined(DOXYGEN_ONLY)
+
+#include "drivers/FlashIAP.h"
+#include "platform/NonCopyable.h"
+
+#ifndef MBED_CONF_DRIVERS_FLASH_WRITER_BUFFER_SIZE
+#define MBED_CONF_DRIVERS_FLASH_WRITER_BUFFER_SIZE 1024
+#endif
+
+#ifndef MBED_CONF_DRIVERS_FLASH_WRITER_ERASE_AHEAD
+#define MBED_CONF_DRIVERS_FLASH_WRITER_ERASE_AHEAD 1
+#endif
+
+#ifndef MBED_CONF_DRIVERS_FLASH_WRITER_VERIFY
+#define MBED_CONF_DRIVERS_FLASH_WRITER_VERIFY 1
+#endif
+
+namespace mbed {
+/** \addtogroup drivers */
+
+/** Streaming writer of a region of flash through FlashIAP
+ *
+ * Takes data in chunks of any size, such as the packets of a firmware
+ * download, and collects them into two buffers of whole pages. While
+ * one buffer fills, the other is programmed, and the sectors up to
+ * drivers.flash-writer-erase-ahead past the one being written are erased
+ * ahead of the data. Programmed buffers are read back and compared
+ * before they are reused.
+ *
+ * On targets with DEVICE_FLASH_ASYNCH, erasing and programming run in
+ * the background and are moved on by each call to write or poll, so
+ * the download and the flash overlap. Other targets erase and program
+ * within those calls.
+ *
+ * @note Synchronization level: Not protected
+ *
+ * Example:
+ * @code
+ * #include "mbed.h"
+ *
+ * FlashIAP flash;
+ * FlashIAPWriter writer(flash);
+ *
+ * int store(TCPSocket &socket, uint32_t addr, uint32_t size) {
+ *     char chunk[256];
+ *     writer.begin(addr, size);
+ *     while (writer.written() < size) {
+ *         int n = socket.recv(chunk, sizeof(chunk));
+ *         if (n <= 0 || writer.write(chunk, n)) {
+ *             return -1;
+ *         }
+ *     }
+ *     return writer.finish();
+ * }
+ * @endcode
+ * @ingroup drivers
+ */
+class FlashIAPWriter : private NonCopyable<FlashIAPWriter> {
+public:
+    /** Create a writer on an initialized flash device
+     *
+     *  @param flash The flash device, which must not be used by others between begin and finish
+     */
+    FlashIAPWriter(FlashIAP &flash);
+
+    virtual ~FlashIAPWriter();
+
+    /** Start writing a region of flash
+     *
+     *  Nothing is erased yet, sectors are erased as the data reaches them.
+     *
+     *  @param addr Address of the region, must be a multiple of the sector size
+     *  @param size Size of the region in bytes
+     *  @return 0 on success, negative error code if the region is not in
+     *          flash or a previous region is still being written
+     */
+    int begin(uint32_t addr, uint32_t size);
+
+    /** Write the next bytes of the region
+     *
+     *  Returns as soon as the data is in a buffer. Waits only while both
+     *  buffers are in use.
+     *
+     *  @param data Data to write
+     *  @param size Size of the data in bytes, any size
+     *  @return 0 on success, negative error code if the data does not fit
+     *          in the region or erasing, programming or verifying failed
+     */
+    int write(const void *data, uint32_t size);
+
+    /** Move the background erasing and programming on
+     *
+     *  Starts the next operation if the previous one has completed.
+     *  Calling it while waiting for data keeps the flash busy.
+     *
+     *  @return 0 on success, negative error code if erasing, programming
+     *          or verifying failed
+     */
+    int poll();
+
+    /** Write the buffered data and wait for the flash
+     *
+     *  The last page is padded with 0xFF, which leaves the rest of it
+     *  erased on flash that erases to 0xFF.
+     *
+     *  @return 0 if all the data is programmed and verified, negative
+     *          error code on failure
+     */
+    int finish();
+
+    /** Get the number of bytes written to the region
+     *
+     *  @return Bytes taken by write since begin
+     */
+    uint32_t written() const;
+
+    /** Get the number of bytes programmed and verified
+     *
+     *  @return Bytes from the start of the region known to be in flash
+     */
+    uint32_t programmed() const;
+
+protected:
+    enum buffer_state {
+        BUFFER_FREE,
+        BUFFER_QUEUED,
+        BUFFER_PROGRAMMED
+    };
+
+    enum flash_op {
+        OP_NONE,
+        OP_PROGRAM,
+        OP_ERASE
+    };
+
+    struct buffer {
+        uint32_t addr;
+        uint32_t size;
+        uint32_t done;
+        buffer_state state;
+    };
+
+    bool step();
+    int run();
+    int queue();
+    int verify(const buffer &b);
+    uint32_t sector_end(uint32_t addr) const;
+    void start(flash_op op, uint32_t addr, uint32_t size);
+#if DEVICE_FLASH_ASYNCH
+    void complete(int event);
+#endif
+
+    FlashIAP &_flash;
+    uint8_t _data[2][MBED_CONF_DRIVERS_FLASH_WRITER_BUFFER_SIZE];
+    buffer _buffers[2];
+    uint32_t _buffer_size;
+    int _fill;
+    int _program;
+    uint32_t _start;
+    uint32_t _end;
+    uint32_t _erase_end;
+    uint32_t _erased;
+    uint32_t _written;
+    uint32_t _programmed;
+    flash_op _op;
+    uint32_t _op_addr;
+    uint32_t _op_size;
+    volatile bool _busy;
+    volatile int _result;
+    int _error;
+    bool _active;
+};
+
+} // namespace mbed
+
+#endif
+
+#endif
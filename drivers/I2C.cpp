@@ -133,7 +133,7 @@ int I2C::transfer(int address, const char *tx_buffer, int tx_length, char *rx_bu
         unlock();
         return -1; // transaction ongoing
     }
-    sleep_manager_lock_deep_sleep();
+    sleep_manager_lock_deep_sleep_named("I2C");
     aquire();
 
     _callback = callback;
@@ -148,7 +148,7 @@ void I2C::abort_transfer(void)
 {
     lock();
     i2c_abort_asynch(&_i2c);
-    sleep_manager_unlock_deep_sleep();
+    sleep_manager_unlock_deep_sleep_named("I2C");
     unlock();
 }
 
@@ -159,7 +159,7 @@ void I2C::irq_handler_asynch(void)
         _callback.call(event);
     }
     if (event) {
-        sleep_manager_unlock_deep_sleep();
+        sleep_manager_unlock_deep_sleep_named("I2C");
     }
 
 }
@@ -0,0 +1,154 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "drivers/I2CBus.h"
+#include "platform/mbed_critical.h"
+#include "platform/mbed_sleep.h"
+
+#if DEVICE_I2C_ASYNCH
+
+namespace mbed {
+
+I2CBus::I2CBus(PinName sda, PinName scl) :
+        I2C(sda, scl),
+        _queue_tail(0),
+        _queue_count(0),
+        _running(false),
+        _step(0)
+{
+}
+
+I2CBus::~I2CBus()
+{
+    abort_all();
+}
+
+int I2CBus::transfer(int address, const char *tx_buffer, int tx_length, char *rx_buffer, int rx_length,
+                     const event_callback_t &callback, int event)
+{
+    Job job;
+    job.steps = NULL;
+    job.count = 1;
+    job.step.address = address;
+    job.step.tx_buffer = tx_buffer;
+    job.step.tx_length = tx_length;
+    job.step.rx_buffer = rx_buffer;
+    job.step.rx_length = rx_length;
+    job.step.repeated = false;
+    job.callback = callback;
+    job.event = event;
+    return queue(job);
+}
+
+int I2CBus::sequence(const Step *steps, int count, const event_callback_t &callback, int event)
+{
+    if (count <= 0) {
+        return -1;
+    }
+
+    Job job;
+    job.steps = steps;
+    job.count = count;
+    job.callback = callback;
+    job.event = event;
+    return queue(job);
+}
+
+int I2CBus::pending() const
+{
+    return _queue_count;
+}
+
+void I2CBus::abort_all()
+{
+    core_util_critical_section_enter();
+    if (_running) {
+        i2c_abort_asynch(&_i2c);
+        sleep_manager_unlock_deep_sleep_named("I2C");
+        _running = false;
+    }
+    _queue_count = 0;
+    core_util_critical_section_exit();
+}
+
+int I2CBus::queue(const Job &job)
+{
+    core_util_critical_section_enter();
+    if (_queue_count == MBED_CONF_DRIVERS_I2C_BUS_QUEUE_SIZE) {
+        core_util_critical_section_exit();
+        return -1; // the queue is full
+    }
+    _queue[(_queue_tail + _queue_count) % MBED_CONF_DRIVERS_I2C_BUS_QUEUE_SIZE] = job;
+    _queue_count++;
+    if (!_running) {
+        _running = true;
+        _step = 0;
+        start_step();
+    }
+    core_util_critical_section_exit();
+    return 0;
+}
+
+// Called from queue with interrupts disabled, or from the interrupt handler,
+// so unlike I2C::transfer it can not take the mutex
+void I2CBus::start_step()
+{
+    const Job &job = _queue[_queue_tail];
+    const Step &step = job.steps ? job.steps[_step] : job.step;
+
+    sleep_manager_lock_deep_sleep_named("I2C");
+    if (_owner != this) {
+        i2c_frequency(&_i2c, _hz);
+        _owner = this;
+    }
+
+    // I2C::irq_handler_asynch calls this back and then releases the deep sleep lock
+    _callback = callback(this, &I2CBus::transfer_done);
+    _irq.callback(&I2CBus::irq_handler_asynch);
+    i2c_transfer_asynch(&_i2c, step.tx_buffer, step.tx_length, step.rx_buffer, step.rx_length,
+                        step.address, step.repeated ? 0 : 1, _irq.entry(), I2C_EVENT_ALL, _usage);
+}
+
+void I2CBus::transfer_done(int event)
+{
+    const Job &job = _queue[_queue_tail];
+
+    if (!(event & ~I2C_EVENT_TRANSFER_COMPLETE) && _step + 1 < job.count) {
+        _step++;
+        start_step();
+        return;
+    }
+
+    event_callback_t cb = job.callback;
+    int user_event = event & job.event;
+
+    // start the next transaction before the callback to keep the bus busy
+    _queue_tail = (_queue_tail + 1) % MBED_CONF_DRIVERS_I2C_BUS_QUEUE_SIZE;
+    _queue_count--;
+    _step = 0;
+    if (_queue_count) {
+        start_step();
+    } else {
+        _running = false;
+    }
+
+    if (cb && user_event) {
+        cb.call(user_event);
+    }
+}
+
+} // namespace mbed
+
+#endif
@@ -0,0 +1,156 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MBED_I2CBUS_H
+#define MBED_I2CBUS_H
+
+#include "platform/platform.h"
+
+#if DEVICE_I2C_ASYNCH || defined(DOXYGEN_ONLY)
+
+#include "drivers/I2C.h"
+
+#ifndef MBED_CONF_DRIVERS_I2C_BUS_QUEUE_SIZE
+#define MBED_CONF_DRIVERS_I2C_BUS_QUEUE_SIZE    8
+#endif
+
+namespace mbed {
+/** \addtogroup drivers */
+
+/** An I2C master that queues transactions for the slaves on its bus
+ *
+ * Transactions are queued without blocking and run back to back from the
+ * completion interrupt, so one thread can sample many sensors without
+ * waiting for any of them. A transaction is a single transfer or a
+ * sequence of steps, each writing and then, after a repeated start,
+ * reading, and it completes with one call of its callback.
+ *
+ * Callbacks run in interrupt context. To handle results in a thread, pass
+ * a callback that posts an Event to an EventQueue.
+ *
+ * @note Synchronization level: Interrupt safe
+ *
+ * Example:
+ * @code
+ * #include "mbed.h"
+ *
+ * I2CBus bus(p28, p27);
+ * EventQueue queue;
+ * Event<void(int)> sampled(&queue, on_sampled);
+ *
+ * static const char reg = 0x28;
+ * static char sample[6];
+ *
+ * int main() {
+ *     // write the register address, then read 6 bytes after a repeated start
+ *     bus.transfer(0x32, &reg, 1, sample, sizeof(sample),
+ *                  callback(&sampled, &Event<void(int)>::call));
+ *     queue.dispatch_forever();
+ * }
+ * @endcode
+ * @ingroup drivers
+ */
+class I2CBus : private I2C {
+
+public:
+
+    /** A step of a sequence
+     *
+     *  tx_length bytes are written, then rx_length bytes are read after a
+     *  repeated start. Either length may be zero.
+     */
+    struct Step {
+        int address;            /**< 8-bit slave address */
+        const char *tx_buffer;
+        int tx_length;
+        char *rx_buffer;
+        int rx_length;
+        bool repeated;          /**< Do not send a stop after the step, the next step starts with a repeated start */
+    };
+
+    /** Create an I2C bus, connected to the specified pins
+     *
+     *  @param sda I2C data line pin
+     *  @param scl I2C clock line pin
+     */
+    I2CBus(PinName sda, PinName scl);
+
+    virtual ~I2CBus();
+
+    /** Queue a transfer
+     *
+     *  @param address   8-bit slave address
+     *  @param tx_buffer The TX buffer
+     *  @param tx_length The length of the TX buffer in bytes
+     *  @param rx_buffer The RX buffer, read after a repeated start
+     *  @param rx_length The length of the RX buffer in bytes
+     *  @param callback  The event callback function, may be NULL
+     *  @param event     The logical OR of events to call the callback for
+     *  @return Zero if the transfer was queued, or -1 if the queue is full
+     */
+    int transfer(int address, const char *tx_buffer, int tx_length, char *rx_buffer, int rx_length,
+                 const event_callback_t &callback, int event = I2C_EVENT_ALL);
+
+    /** Queue a sequence of steps
+     *
+     *  The steps run one after another and the callback is called once,
+     *  after the last step or the first step that fails.
+     *
+     *  @param steps     The steps, they must stay valid until the callback
+     *  @param count     The number of steps
+     *  @param callback  The event callback function, may be NULL
+     *  @param event     The logical OR of events to call the callback for
+     *  @return Zero if the sequence was queued, or -1 if the queue is full
+     */
+    int sequence(const Step *steps, int count, const event_callback_t &callback, int event = I2C_EVENT_ALL);
+
+    /** Get the number of queued transactions, including the running one
+     */
+    int pending() const;
+
+    /** Abort the running transaction and drop the queued ones
+     *
+     *  Callbacks of dropped transactions are not called.
+     */
+    void abort_all();
+
+    using I2C::frequency;
+
+private:
+    struct Job {
+        const Step *steps;      // NULL for a single transfer in step
+        int count;
+        Step step;
+        event_callback_t callback;
+        int event;
+    };
+
+    int queue(const Job &job);
+    void start_step();
+    void transfer_done(int event);
+
+    // a ring of jobs, the running one is at _queue_tail
+    Job _queue[MBED_CONF_DRIVERS_I2C_BUS_QUEUE_SIZE];
+    unsigned _queue_tail;
+    volatile unsigned _queue_count;
+    bool _running;
+    int _step;                  // running step of the running job
+};
+
+} // namespace mbed
+
+#endif
+
+#endif
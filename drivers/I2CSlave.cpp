@@ -17,9 +17,22 @@
 
 #if DEVICE_I2CSLAVE
 
+#if DEVICE_I2CSLAVE_ASYNCH
+#include "platform/mbed_critical.h"
+#include "platform/mbed_dcache.h"
+#include "platform/mbed_sleep.h"
+#endif
+
 namespace mbed {
 
-I2CSlave::I2CSlave(PinName sda, PinName scl) : _i2c() {
+I2CSlave::I2CSlave(PinName sda, PinName scl) :
+#if DEVICE_I2CSLAVE_ASYNCH
+    _irq(this),
+    _rx(NULL),
+    _rx_length(0),
+    _transfer_active(false),
+#endif
+    _i2c() {
     i2c_init(&_i2c, sda, scl);
     i2c_frequency(&_i2c, 100000);
     i2c_slave_mode(&_i2c, 1);
@@ -58,6 +71,67 @@ void I2CSlave::stop(void) {
     i2c_stop(&_i2c);
 }
 
+#if DEVICE_I2CSLAVE_ASYNCH
+
+int I2CSlave::transfer(const char *tx, int tx_length, char *rx, int rx_length, const event_callback_t &callback,
+                       int event) {
+    core_util_critical_section_enter();
+    if (_transfer_active) {
+        core_util_critical_section_exit();
+        return -1;
+    }
+    _transfer_active = true;
+    core_util_critical_section_exit();
+
+    _callback = callback;
+    _rx = rx;
+    _rx_length = rx ? rx_length : 0;
+    mbed_dcache_clean(tx, tx ? tx_length : 0);
+    mbed_dcache_invalidate(_rx, _rx_length);
+    _irq.callback(&I2CSlave::irq_handler_asynch);
+
+    sleep_manager_lock_deep_sleep_named("I2CSlave");
+    if (i2c_slave_transfer_asynch(&_i2c, tx, tx_length, rx, rx_length, _irq.entry(), event,
+                                  DMA_USAGE_OPPORTUNISTIC) != 0) {
+        sleep_manager_unlock_deep_sleep_named("I2CSlave");
+        _transfer_active = false;
+        return -1;
+    }
+    return 0;
+}
+
+void I2CSlave::abort_transfer() {
+    core_util_critical_section_enter();
+    if (_transfer_active) {
+        i2c_slave_abort_asynch(&_i2c);
+        sleep_manager_unlock_deep_sleep_named("I2CSlave");
+        _transfer_active = false;
+    }
+    core_util_critical_section_exit();
+}
+
+int I2CSlave::transferred() {
+    return i2c_slave_transfer_count(&_i2c);
+}
+
+void I2CSlave::irq_handler_asynch(void) {
+    int event = i2c_slave_irq_handler_asynch(&_i2c);
+    if (!event) {
+        return;
+    }
+
+    // drop any lines the core fetched while DMA was writing the buffer
+    mbed_dcache_invalidate(_rx, _rx_length);
+    sleep_manager_unlock_deep_sleep_named("I2CSlave");
+    _transfer_active = false;
+
+    if (_callback && (event & I2C_EVENT_SLAVE_ALL)) {
+        _callback.call(event & I2C_EVENT_SLAVE_ALL);
+    }
+}
+
+#endif
+
 }
 
 #endif
@@ -22,6 +22,11 @@
 
 #include "hal/i2c_api.h"
 
+#if DEVICE_I2CSLAVE_ASYNCH
+#include "platform/CThunk.h"
+#include "platform/Callback.h"
+#endif
+
 namespace mbed {
 /** \addtogroup drivers */
 
@@ -147,6 +152,55 @@ public:
      */
     void stop(void);
 
+#if DEVICE_I2CSLAVE_ASYNCH
+
+    /** Arm a non-blocking transfer for the next transaction addressed to this slave
+     *
+     *  The reply is preloaded, so a master read is answered without waiting
+     *  for the application, and the bytes of a master write are received in
+     *  the background. The transfer ends with I2C_EVENT_SLAVE_RECEIVED or
+     *  I2C_EVENT_SLAVE_TRANSMITTED, and the callback may arm the next transfer.
+     *
+     *  This function locks the deep sleep until the transfer has ended.
+     *
+     *  On targets with a data cache, the receive buffer should be declared with
+     *  MBED_DCACHE_ALIGNED and a size rounded with MBED_DCACHE_ROUND_UP, or
+     *  allocated with mbed_dma_alloc, and left alone until the transfer ends,
+     *  so it shares no cache line with data written during the transfer.
+     *
+     *  @param tx        The reply to a master read, may be NULL
+     *  @param tx_length The length of the reply in bytes
+     *  @param rx        The buffer for a master write, may be NULL
+     *  @param rx_length The length of the buffer in bytes
+     *  @param callback  The event callback function
+     *  @param event     The logical OR of events to modify, I2C_EVENT_SLAVE_*
+     *  @return Zero if the transfer is armed, or -1 if a transfer is armed already or the
+     *          target can not transfer as a slave in the background
+     */
+    int transfer(const char *tx, int tx_length, char *rx, int rx_length, const event_callback_t &callback,
+                 int event = I2C_EVENT_SLAVE_ALL);
+
+    /** Disarm or abort the transfer, its callback is not called
+     */
+    void abort_transfer();
+
+    /** Get the number of bytes received or transmitted by the last transfer
+     *
+     *  @return The number of bytes, valid from the callback on
+     */
+    int transferred();
+
+protected:
+    void irq_handler_asynch(void);
+
+    CThunk<I2CSlave> _irq;
+    event_callback_t _callback;
+    char *_rx;
+    int _rx_length;
+    volatile bool _transfer_active;
+
+#endif
+
 protected:
     i2c_t _i2c;
 };
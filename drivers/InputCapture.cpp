@@ -0,0 +1,162 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "drivers/InputCapture.h"
+
+#if DEVICE_CAPTURE
+
+#include "platform/mbed_critical.h"
+#include "platform/mbed_error.h"
+
+namespace mbed {
+
+InputCapture::InputCapture(PinName pin, capture_edge edges) :
+        _edges(edges),
+        _dropped(0),
+        _count(0),
+        _last_start(0),
+        _period(0),
+        _pulse(0),
+        _window_ticks(0),
+        _window_periods(0)
+{
+    // No lock needed in the constructor
+    if (capture_init(&_capture, pin, edges, &InputCapture::_irq_handler, (uint32_t)this) != 0) {
+        error("InputCapture: pin has no capture channel");
+    }
+}
+
+InputCapture::~InputCapture()
+{
+    capture_free(&_capture);
+}
+
+bool InputCapture::read(Edge &edge)
+{
+    return _buffer.pop(edge);
+}
+
+int InputCapture::read(Edge *edges, int count)
+{
+    if (count <= 0) {
+        return 0;
+    }
+    return _buffer.pop(edges, count);
+}
+
+int InputCapture::available() const
+{
+    return _buffer.size();
+}
+
+uint32_t InputCapture::dropped() const
+{
+    return _dropped;
+}
+
+uint32_t InputCapture::tick_frequency() const
+{
+    return capture_frequency(const_cast<capture_t *>(&_capture));
+}
+
+uint32_t InputCapture::count() const
+{
+    return _count;
+}
+
+uint32_t InputCapture::period_ticks() const
+{
+    return _period;
+}
+
+uint32_t InputCapture::pulse_ticks() const
+{
+    return _pulse;
+}
+
+float InputCapture::frequency()
+{
+    core_util_critical_section_enter();
+    uint64_t ticks = _window_ticks;
+    uint32_t periods = _window_periods;
+    _window_ticks = 0;
+    _window_periods = 0;
+    core_util_critical_section_exit();
+
+    if (ticks == 0) {
+        return 0.0f;
+    }
+    return (float)((double)tick_frequency() * periods / ticks);
+}
+
+float InputCapture::duty_cycle() const
+{
+    core_util_critical_section_enter();
+    uint32_t period = _period;
+    uint32_t pulse = _pulse;
+    core_util_critical_section_exit();
+
+    if (period == 0) {
+        return 0.0f;
+    }
+    return (float)pulse / period;
+}
+
+void InputCapture::reset()
+{
+    core_util_critical_section_enter();
+    Edge edge;
+    while (_buffer.pop(edge)) {
+    }
+    _dropped = 0;
+    _count = 0;
+    _period = 0;
+    _pulse = 0;
+    _window_ticks = 0;
+    _window_periods = 0;
+    core_util_critical_section_exit();
+}
+
+void InputCapture::_irq_handler(uint32_t id, uint32_t timestamp, capture_edge edge)
+{
+    InputCapture *handler = (InputCapture *)id;
+    handler->capture(timestamp, edge == CAPTURE_RISE);
+}
+
+void InputCapture::capture(uint32_t timestamp, bool rising)
+{
+    Edge edge = { timestamp, rising };
+    if (!_buffer.push(edge)) {
+        _dropped++;
+    }
+
+    bool starts_period = _edges == CAPTURE_FALL ? !rising : rising;
+    if (starts_period) {
+        // timestamps wrap at 2^32, so the unsigned difference is the period
+        if (_count) {
+            _period = timestamp - _last_start;
+            _window_ticks += _period;
+            _window_periods++;
+        }
+        _last_start = timestamp;
+        _count++;
+    } else if (_count) {
+        _pulse = timestamp - _last_start;
+    }
+}
+
+} // namespace mbed
+
+#endif
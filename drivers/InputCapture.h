@@ -0,0 +1,172 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MBED_INPUTCAPTURE_H
+#define MBED_INPUTCAPTURE_H
+
+#include "platform/platform.h"
+
+#if DEVICE_CAPTURE || defined(DOXYGEN_ONLY)
+
+#include "hal/capture_api.h"
+#include "platform/SPSCCircularBuffer.h"
+#include "platform/NonCopyable.h"
+
+#ifndef MBED_CONF_DRIVERS_INPUT_CAPTURE_BUFFER_SIZE
+#define MBED_CONF_DRIVERS_INPUT_CAPTURE_BUFFER_SIZE     32
+#endif
+
+namespace mbed {
+/** \addtogroup drivers */
+
+/** Timestamps of the edges on a pin, latched by a hardware timer
+ *
+ * Unlike timing an InterruptIn with a Timer, the timestamps do not depend
+ * on the interrupt latency, so pulse widths and frequencies are exact to
+ * a timer tick. The edges are kept in a buffer for read(), and the
+ * frequency, duty cycle and edge count helpers are kept up to date from
+ * the interrupt whether or not the buffer is read.
+ *
+ * Periods are measured between rising edges, or between falling edges if
+ * only those are captured. Pulse widths need both edges.
+ *
+ * @note Synchronization level: Interrupt safe, read() must only be called
+ *       from one context at a time
+ *
+ * Example:
+ * @code
+ * // Report the pulse rate of a flow meter once per second
+ *
+ * #include "mbed.h"
+ *
+ * InputCapture meter(p8, CAPTURE_RISE);
+ *
+ * int main() {
+ *     while (1) {
+ *         wait(1);
+ *         printf("%lu pulses, %.1f Hz\n", meter.count(), meter.frequency());
+ *     }
+ * }
+ * @endcode
+ * @ingroup drivers
+ */
+class InputCapture : private NonCopyable<InputCapture> {
+
+public:
+
+    /** A captured edge
+     */
+    struct Edge {
+        uint32_t timestamp;     /**< Timer ticks, at tick_frequency() */
+        bool rising;
+    };
+
+    /** Create an InputCapture on the specified pin
+     *
+     *  @param pin   A pin of a timer capture channel
+     *  @param edges The edges to capture
+     */
+    InputCapture(PinName pin, capture_edge edges = CAPTURE_BOTH);
+
+    virtual ~InputCapture();
+
+    /** Read the oldest buffered edge
+     *
+     *  @param edge Set to the edge
+     *  @return True if an edge was read, false if none is buffered
+     */
+    bool read(Edge &edge);
+
+    /** Read buffered edges, oldest first
+     *
+     *  @param edges Buffer for the edges
+     *  @param count Maximum number of edges to read
+     *  @return Number of edges read
+     */
+    int read(Edge *edges, int count);
+
+    /** Get the number of buffered edges
+     */
+    int available() const;
+
+    /** Get the number of edges dropped because the buffer was full
+     */
+    uint32_t dropped() const;
+
+    /** Get the rate the timestamps count at
+     *
+     *  @return The frequency of the timestamps in Hz
+     */
+    uint32_t tick_frequency() const;
+
+    /** Get the number of periods started since construction or reset
+     *
+     *  This counts the rising edges, or the falling edges if only those
+     *  are captured, so it is the pulse count of a meter.
+     */
+    uint32_t count() const;
+
+    /** Get the length of the last period
+     *
+     *  @return The period in timer ticks, 0 before two edges were captured
+     */
+    uint32_t period_ticks() const;
+
+    /** Get the length of the last high pulse
+     *
+     *  @return The pulse width in timer ticks, 0 unless both edges are captured
+     */
+    uint32_t pulse_ticks() const;
+
+    /** Get the mean frequency since the previous call
+     *
+     *  The mean covers every period that ended since the previous call, or
+     *  since construction or reset, so no edge is missed between calls.
+     *
+     *  @return The frequency in Hz, 0 if no period ended since the previous call
+     */
+    float frequency();
+
+    /** Get the duty cycle of the last period
+     *
+     *  @return The fraction of the last period the pin was high, 0 unless both edges are captured
+     */
+    float duty_cycle() const;
+
+    /** Drop the buffered edges and restart the count and measurements
+     */
+    void reset();
+
+protected:
+    static void _irq_handler(uint32_t id, uint32_t timestamp, capture_edge edge);
+    void capture(uint32_t timestamp, bool rising);
+
+    capture_t _capture;
+    capture_edge _edges;
+    SPSCCircularBuffer<Edge, MBED_CONF_DRIVERS_INPUT_CAPTURE_BUFFER_SIZE> _buffer;
+    uint32_t _dropped;
+    uint32_t _count;
+    uint32_t _last_start;       // timestamp of the edge starting the last period
+    uint32_t _period;
+    uint32_t _pulse;
+    uint64_t _window_ticks;     // periods ended since the previous frequency()
+    uint32_t _window_periods;
+};
+
+} // namespace mbed
+
+#endif
+
+#endif
@@ -17,14 +17,39 @@
 
 #if DEVICE_INTERRUPTIN
 
+#include "hal/us_ticker_api.h"
+#include "platform/SPSCCircularBuffer.h"
+#if MBED_CONF_EVENTS_PRESENT
+#include "events/StaticEvent.h"
+#endif
+
+#ifndef MBED_CONF_DRIVERS_INTERRUPT_IN_EDGE_BUFFER_SIZE
+#define MBED_CONF_DRIVERS_INTERRUPT_IN_EDGE_BUFFER_SIZE     32
+#endif
+
+// Edges drained from an event queue are passed on in batches of this size
+#define EDGE_BATCH  8
+
 namespace mbed {
 
 static void donothing() {}
 
+struct InterruptIn::EdgeBuffer {
+    SPSCCircularBuffer<Edge, MBED_CONF_DRIVERS_INTERRUPT_IN_EDGE_BUFFER_SIZE> buffer;
+    uint32_t dropped;
+    bool rise;
+    bool fall;
+#if MBED_CONF_EVENTS_PRESENT
+    events::StaticEvent<Callback<void()> > *drain;
+    Callback<void(const Edge *, int)> func;
+#endif
+};
+
 InterruptIn::InterruptIn(PinName pin) : gpio(),
                                         gpio_irq(),
                                         _rise(),
-                                        _fall() {
+                                        _fall(),
+                                        _edges(NULL) {
     // No lock needed in the constructor
 
     _rise = donothing;
@@ -37,6 +62,15 @@ InterruptIn::InterruptIn(PinName pin) : gpio(),
 InterruptIn::~InterruptIn() {
     // No lock needed in the destructor
     gpio_irq_free(&gpio_irq);
+    if (_edges) {
+#if MBED_CONF_EVENTS_PRESENT
+        if (_edges->drain) {
+            _edges->drain->cancel();
+            delete _edges->drain;
+        }
+#endif
+        delete _edges;
+    }
 }
 
 int InterruptIn::read() {
@@ -57,7 +91,9 @@ void InterruptIn::rise(Callback<void()> func) {
         gpio_irq_set(&gpio_irq, IRQ_RISE, 1);
     } else {
         _rise = donothing;
-        gpio_irq_set(&gpio_irq, IRQ_RISE, 0);
+        if (!_edges || !_edges->rise) {
+            gpio_irq_set(&gpio_irq, IRQ_RISE, 0);
+        }
     }
     core_util_critical_section_exit();
 }
@@ -69,13 +105,103 @@ void InterruptIn::fall(Callback<void()> func) {
         gpio_irq_set(&gpio_irq, IRQ_FALL, 1);
     } else {
         _fall = donothing;
-        gpio_irq_set(&gpio_irq, IRQ_FALL, 0);
+        if (!_edges || !_edges->fall) {
+            gpio_irq_set(&gpio_irq, IRQ_FALL, 0);
+        }
+    }
+    core_util_critical_section_exit();
+}
+
+void InterruptIn::timestamp_edges(bool rise, bool fall) {
+    EdgeBuffer *edges = new EdgeBuffer;
+    edges->dropped = 0;
+    edges->rise = rise;
+    edges->fall = fall;
+#if MBED_CONF_EVENTS_PRESENT
+    edges->drain = NULL;
+#endif
+    start_timestamps(edges);
+}
+
+#if MBED_CONF_EVENTS_PRESENT
+void InterruptIn::timestamp_edges(events::EventQueue *queue, Callback<void(const Edge *edges, int count)> func,
+                                  bool rise, bool fall) {
+    EdgeBuffer *edges = new EdgeBuffer;
+    edges->dropped = 0;
+    edges->rise = rise;
+    edges->fall = fall;
+    edges->drain = new events::StaticEvent<Callback<void()> >(queue, callback(this, &InterruptIn::drain_edges));
+    edges->func = func;
+    start_timestamps(edges);
+}
+
+void InterruptIn::drain_edges() {
+    Edge batch[EDGE_BATCH];
+    int count;
+    while ((count = read_edges(batch, EDGE_BATCH)) > 0) {
+        _edges->func(batch, count);
+    }
+}
+#endif
+
+void InterruptIn::stop_timestamps() {
+    start_timestamps(NULL);
+}
+
+void InterruptIn::start_timestamps(EdgeBuffer *edges) {
+    core_util_critical_section_enter();
+    EdgeBuffer *previous = _edges;
+    _edges = edges;
+    // edges stay enabled as long as a function or the timestamps need them
+    bool rise = (edges && edges->rise) || !(_rise == Callback<void()>(donothing));
+    bool fall = (edges && edges->fall) || !(_fall == Callback<void()>(donothing));
+    if (rise || (previous && previous->rise)) {
+        gpio_irq_set(&gpio_irq, IRQ_RISE, rise);
+    }
+    if (fall || (previous && previous->fall)) {
+        gpio_irq_set(&gpio_irq, IRQ_FALL, fall);
+    }
+#if MBED_CONF_EVENTS_PRESENT
+    if (previous && previous->drain) {
+        previous->drain->cancel();
     }
+#endif
     core_util_critical_section_exit();
+
+    if (previous) {
+#if MBED_CONF_EVENTS_PRESENT
+        delete previous->drain;
+#endif
+        delete previous;
+    }
+}
+
+int InterruptIn::read_edges(Edge *edges, int count) {
+    if (!_edges || count <= 0) {
+        return 0;
+    }
+    return _edges->buffer.pop(edges, count);
+}
+
+uint32_t InterruptIn::dropped_edges() const {
+    return _edges ? _edges->dropped : 0;
 }
 
 void InterruptIn::_irq_handler(uint32_t id, gpio_irq_event event) {
     InterruptIn *handler = (InterruptIn*)id;
+    EdgeBuffer *edges = handler->_edges;
+    if (edges && ((event == IRQ_RISE && edges->rise) || (event == IRQ_FALL && edges->fall))) {
+        // timestamp first, so the callbacks do not add to the latency
+        Edge edge = { us_ticker_read(), event == IRQ_RISE };
+        if (!edges->buffer.push(edge)) {
+            edges->dropped++;
+        }
+#if MBED_CONF_EVENTS_PRESENT
+        if (edges->drain) {
+            edges->drain->post();
+        }
+#endif
+    }
     switch (event) {
         case IRQ_RISE: handler->_rise(); break;
         case IRQ_FALL: handler->_fall(); break;
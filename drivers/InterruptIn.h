@@ -27,6 +27,12 @@
 #include "platform/mbed_toolchain.h"
 #include "platform/NonCopyable.h"
 
+#if MBED_CONF_EVENTS_PRESENT
+namespace events {
+class EventQueue;
+}
+#endif
+
 namespace mbed {
 /** \addtogroup drivers */
 
@@ -61,6 +67,13 @@ class InterruptIn : private NonCopyable<InterruptIn> {
 
 public:
 
+    /** An edge timestamped by timestamp_edges
+     */
+    struct Edge {
+        uint32_t timestamp;     /**< Microseconds, read from the us ticker */
+        bool rising;
+    };
+
     /** Create an InterruptIn connected to the specified pin
      *
      *  @param pin InterruptIn pin to connect to
@@ -129,6 +142,54 @@ public:
         core_util_critical_section_exit();
     }
 
+    /** Timestamp edges into a buffer
+     *
+     *  The interrupt handler reads the us ticker as soon as it runs and
+     *  pushes the edge into a lock-free buffer, before calling any rise or
+     *  fall function. Edges are then read with read_edges in batches, so a
+     *  busy thread loses neither edges nor timing accuracy, up to
+     *  drivers.interrupt-in-edge-buffer-size edges behind.
+     *
+     *  @param rise Timestamp the rising edges
+     *  @param fall Timestamp the falling edges
+     */
+    void timestamp_edges(bool rise = true, bool fall = true);
+
+#if MBED_CONF_EVENTS_PRESENT
+    /** Timestamp edges into a buffer drained from an event queue
+     *
+     *  Like timestamp_edges, and each edge also posts an event, at most
+     *  once until it runs, that passes the buffered edges to a function
+     *  in batches.
+     *
+     *  @param queue Event queue to drain the edges from
+     *  @param func  Function called from the queue with edges, oldest first
+     *  @param rise  Timestamp the rising edges
+     *  @param fall  Timestamp the falling edges
+     */
+    void timestamp_edges(events::EventQueue *queue, Callback<void(const Edge *edges, int count)> func,
+                         bool rise = true, bool fall = true);
+#endif
+
+    /** Stop timestamping edges and drop the buffered ones
+     */
+    void stop_timestamps();
+
+    /** Read timestamped edges, oldest first
+     *
+     *  Must only be called from one context at a time, and not while an
+     *  event queue drains the edges.
+     *
+     *  @param edges Buffer for the edges
+     *  @param count Maximum number of edges to read
+     *  @return Number of edges read
+     */
+    int read_edges(Edge *edges, int count);
+
+    /** Get the number of edges dropped because the buffer was full
+     */
+    uint32_t dropped_edges() const;
+
     /** Set the input pin mode
      *
      *  @param pull PullUp, PullDown, PullNone
@@ -153,6 +214,14 @@ protected:
 
     Callback<void()> _rise;
     Callback<void()> _fall;
+
+private:
+    struct EdgeBuffer;
+
+    void start_timestamps(EdgeBuffer *edges);
+    void drain_edges();
+
+    EdgeBuffer *_edges;
 };
 
 } // namespace mbed
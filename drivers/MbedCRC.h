@@ -0,0 +1,329 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MBED_CRC_API_H
+#define MBED_CRC_API_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "hal/crc_api.h"
+#include "platform/mbed_assert.h"
+
+namespace mbed {
+/** \addtogroup drivers */
+/** @{*/
+
+/// @cond
+extern const uint32_t Table_CRC_32bit_ANSI[4][256];
+extern const uint16_t Table_CRC_16bit_CCITT[256];
+extern const uint16_t Table_CRC_16bit_IBM[256];
+extern const uint8_t Table_CRC_8bit_CCITT[256];
+
+#if DEVICE_CRC
+bool mbed_crc_hw_acquire();
+void mbed_crc_hw_release();
+#endif
+/// @endcond
+
+/** Default parameters of the CRCs computed by MbedCRC
+ *
+ * The standard polynomials default to their most common variant: CRC-32
+ * for POLY_32BIT_ANSI, CRC-16/CCITT-FALSE for POLY_16BIT_CCITT and
+ * CRC-16/ARC for POLY_16BIT_IBM. Other CRCs start from zero and are not
+ * reflected.
+ */
+template <uint32_t polynomial, int width>
+struct MbedCRCDefaults {
+    static const uint32_t initial_xor = 0;
+    static const uint32_t final_xor = 0;
+    static const bool reflect_data = false;
+    static const bool reflect_remainder = false;
+};
+
+/// @cond
+template <>
+struct MbedCRCDefaults<POLY_32BIT_ANSI, 32> {
+    static const uint32_t initial_xor = 0xFFFFFFFF;
+    static const uint32_t final_xor = 0xFFFFFFFF;
+    static const bool reflect_data = true;
+    static const bool reflect_remainder = true;
+};
+
+template <>
+struct MbedCRCDefaults<POLY_16BIT_CCITT, 16> {
+    static const uint32_t initial_xor = 0xFFFF;
+    static const uint32_t final_xor = 0;
+    static const bool reflect_data = false;
+    static const bool reflect_remainder = false;
+};
+
+template <>
+struct MbedCRCDefaults<POLY_16BIT_IBM, 16> {
+    static const uint32_t initial_xor = 0;
+    static const uint32_t final_xor = 0;
+    static const bool reflect_data = true;
+    static const bool reflect_remainder = true;
+};
+/// @endcond
+
+/** CRC computation
+ *
+ * When the target has a CRC peripheral supporting the parameters of the CRC
+ * and it is not in use by another computation, the CRC is computed by the
+ * peripheral. Otherwise it is computed in software: from a table in flash
+ * for the standard polynomials, POLY_32BIT_ANSI being processed four bytes
+ * at a time, and bit by bit for the others.
+ *
+ * The CRC of data received in pieces is computed with compute_partial_start,
+ * compute_partial for each piece and compute_partial_stop.
+ *
+ * @tparam polynomial The generator polynomial, in normal representation without the top bit
+ * @tparam width      The width of the CRC in bits, 1 to 32
+ *
+ * Example:
+ * @code
+ * #include "mbed.h"
+ *
+ * int main()
+ * {
+ *     MbedCRC<POLY_32BIT_ANSI, 32> ct;
+ *     const char test[] = "123456789";
+ *     uint32_t crc = 0;
+ *
+ *     ct.compute((void *)test, strlen(test), &crc);
+ *     printf("CRC-32 of %s is 0x%lx\r\n", test, crc);    // 0xcbf43926
+ * }
+ * @endcode
+ *
+ * @note Synchronization level: Not protected, the peripheral is shared safely
+ * @ingroup drivers
+ */
+template <uint32_t polynomial = POLY_32BIT_ANSI, int width = 32>
+class MbedCRC {
+public:
+    /** Create a CRC
+     *
+     * @param initial_xor       Initial value of the remainder
+     * @param final_xor         Value XORed with the remainder to give the CRC
+     * @param reflect_data      Process each byte of data least significant bit first
+     * @param reflect_remainder Reflect the remainder before the final XOR
+     */
+    MbedCRC(uint32_t initial_xor = MbedCRCDefaults<polynomial, width>::initial_xor,
+            uint32_t final_xor = MbedCRCDefaults<polynomial, width>::final_xor,
+            bool reflect_data = MbedCRCDefaults<polynomial, width>::reflect_data,
+            bool reflect_remainder = MbedCRCDefaults<polynomial, width>::reflect_remainder) :
+        _initial_xor(initial_xor & mask()), _final_xor(final_xor & mask()),
+        _reflect_data(reflect_data), _reflect_remainder(reflect_remainder), _hw(false)
+    {
+        MBED_STATIC_ASSERT(width >= 1 && width <= 32, "MbedCRC width must be 1 to 32 bits");
+    }
+
+    /** Compute the CRC of a buffer
+     *
+     * @param buffer The data
+     * @param size   The size of the data in bytes
+     * @param crc    The CRC
+     * @return 0 on success, -1 if crc is NULL
+     */
+    int32_t compute(const void *buffer, size_t size, uint32_t *crc)
+    {
+        if (compute_partial_start(crc) != 0) {
+            return -1;
+        }
+        compute_partial(buffer, size, crc);
+        return compute_partial_stop(crc);
+    }
+
+    /** Start the computation of a CRC
+     *
+     * @param crc The state of the computation, passed to the other compute_partial functions
+     * @return 0 on success, -1 if crc is NULL
+     */
+    int32_t compute_partial_start(uint32_t *crc)
+    {
+        if (crc == NULL) {
+            return -1;
+        }
+#if DEVICE_CRC
+        crc_mbed_config_t config = {
+            polynomial, width, _initial_xor, _final_xor, _reflect_data, _reflect_remainder
+        };
+        _hw = hal_crc_is_supported(&config) && mbed_crc_hw_acquire();
+        if (_hw) {
+            hal_crc_compute_partial_start(&config);
+            *crc = 0;
+            return 0;
+        }
+#endif
+        *crc = _reflect_data ? reflect(_initial_xor, width) : _initial_xor;
+        return 0;
+    }
+
+    /** Feed data to a CRC computation
+     *
+     * @param buffer The data
+     * @param size   The size of the data in bytes
+     * @param crc    The state of the computation
+     * @return 0 on success, -1 if crc is NULL
+     */
+    int32_t compute_partial(const void *buffer, size_t size, uint32_t *crc)
+    {
+        if (crc == NULL) {
+            return -1;
+        }
+        const uint8_t *data = static_cast<const uint8_t *>(buffer);
+#if DEVICE_CRC
+        if (_hw) {
+            hal_crc_compute_partial(data, size);
+            return 0;
+        }
+#endif
+        if (_reflect_data) {
+            *crc = compute_reflected(data, size, *crc);
+        } else {
+            *crc = compute_normal(data, size, *crc);
+        }
+        return 0;
+    }
+
+    /** Finish a CRC computation
+     *
+     * @param crc The state of the computation, replaced by the CRC
+     * @return 0 on success, -1 if crc is NULL
+     */
+    int32_t compute_partial_stop(uint32_t *crc)
+    {
+        if (crc == NULL) {
+            return -1;
+        }
+#if DEVICE_CRC
+        if (_hw) {
+            *crc = hal_crc_get_result();
+            _hw = false;
+            mbed_crc_hw_release();
+            return 0;
+        }
+#endif
+        uint32_t remainder = *crc;
+        if (_reflect_data != _reflect_remainder) {
+            remainder = reflect(remainder, width);
+        }
+        *crc = (remainder ^ _final_xor) & mask();
+        return 0;
+    }
+
+    /** Get the generator polynomial
+     *
+     * @return The polynomial, in normal representation without the top bit
+     */
+    uint32_t get_polynomial() const
+    {
+        return polynomial;
+    }
+
+    /** Get the width of the CRC
+     *
+     * @return The width in bits
+     */
+    uint8_t get_width() const
+    {
+        return width;
+    }
+
+private:
+    static uint32_t mask()
+    {
+        return (width == 32) ? 0xFFFFFFFF : ((1UL << (width & 31)) - 1);
+    }
+
+    static uint32_t reflect(uint32_t data, int bits)
+    {
+        uint32_t reflection = 0;
+        for (int bit = 0; bit < bits; bit++) {
+            reflection = (reflection << 1) | (data & 1);
+            data >>= 1;
+        }
+        return reflection;
+    }
+
+    // Least significant bit first, the remainder being reflected
+    static uint32_t compute_reflected(const uint8_t *data, size_t size, uint32_t crc)
+    {
+        if (polynomial == POLY_32BIT_ANSI && width == 32) {
+            for (; size >= 4; size -= 4, data += 4) {
+                crc ^= data[0] | (data[1] << 8) | (data[2] << 16) | ((uint32_t)data[3] << 24);
+                crc = Table_CRC_32bit_ANSI[3][crc & 0xFF] ^
+                      Table_CRC_32bit_ANSI[2][(crc >> 8) & 0xFF] ^
+                      Table_CRC_32bit_ANSI[1][(crc >> 16) & 0xFF] ^
+                      Table_CRC_32bit_ANSI[0][crc >> 24];
+            }
+            for (; size > 0; size--, data++) {
+                crc = (crc >> 8) ^ Table_CRC_32bit_ANSI[0][(crc ^ *data) & 0xFF];
+            }
+        } else if (polynomial == POLY_16BIT_IBM && width == 16) {
+            for (; size > 0; size--, data++) {
+                crc = (crc >> 8) ^ Table_CRC_16bit_IBM[(crc ^ *data) & 0xFF];
+            }
+        } else {
+            const uint32_t reflected_polynomial = reflect(polynomial, width);
+            for (; size > 0; size--, data++) {
+                for (int bit = 0; bit < 8; bit++) {
+                    uint32_t feedback = (crc ^ (*data >> bit)) & 1;
+                    crc >>= 1;
+                    if (feedback) {
+                        crc ^= reflected_polynomial;
+                    }
+                }
+            }
+        }
+        return crc;
+    }
+
+    // Most significant bit first
+    static uint32_t compute_normal(const uint8_t *data, size_t size, uint32_t crc)
+    {
+        if (polynomial == POLY_16BIT_CCITT && width == 16) {
+            for (; size > 0; size--, data++) {
+                crc = ((crc << 8) ^ Table_CRC_16bit_CCITT[((crc >> 8) ^ *data) & 0xFF]) & 0xFFFF;
+            }
+        } else if (polynomial == POLY_8BIT_CCITT && width == 8) {
+            for (; size > 0; size--, data++) {
+                crc = Table_CRC_8bit_CCITT[(crc ^ *data) & 0xFF];
+            }
+        } else {
+            for (; size > 0; size--, data++) {
+                for (int bit = 7; bit >= 0; bit--) {
+                    uint32_t feedback = ((crc >> (width - 1)) ^ (*data >> bit)) & 1;
+                    crc = (crc << 1) & mask();
+                    if (feedback) {
+                        crc ^= polynomial;
+                    }
+                }
+            }
+        }
+        return crc;
+    }
+
+    uint32_t _initial_xor;
+    uint32_t _final_xor;
+    bool _reflect_data;
+    bool _reflect_remainder;
+    bool _hw;
+};
+
+/** @}*/
+} // namespace mbed
+
+#endif
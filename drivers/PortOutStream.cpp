@@ -0,0 +1,118 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "drivers/PortOutStream.h"
+
+#if DEVICE_PORTOUT && DEVICE_PORTOUT_ASYNCH
+
+#include "platform/mbed_critical.h"
+#include "platform/mbed_dcache.h"
+#include "platform/mbed_sleep.h"
+
+namespace mbed {
+
+PortOutStream::PortOutStream(PortName port, int mask) :
+        _irq(this),
+        _event(0),
+        _circular(false),
+        _active(false)
+{
+    core_util_critical_section_enter();
+    port_init(&_port, port, mask, PIN_OUTPUT);
+    core_util_critical_section_exit();
+}
+
+PortOutStream::~PortOutStream()
+{
+    stop();
+}
+
+uint32_t PortOutStream::word(int value)
+{
+    return port_stream_word(&_port, value);
+}
+
+int PortOutStream::start(const uint32_t *buffer, size_t length, uint32_t rate_hz,
+                         const event_callback_t &callback, bool circular, int event)
+{
+    if (length == 0 || (circular && length % 2)) {
+        return -1;
+    }
+
+    core_util_critical_section_enter();
+    if (_active) {
+        core_util_critical_section_exit();
+        return -1;
+    }
+    _active = true;
+    core_util_critical_section_exit();
+
+    _callback = callback;
+    _event = event;
+    _circular = circular;
+    mbed_dcache_clean(buffer, length * sizeof(uint32_t));
+    _irq.callback(&PortOutStream::irq_handler_asynch);
+
+    sleep_manager_lock_deep_sleep_named("PortOut");
+    if (port_stream_start(&_port, buffer, length, rate_hz, circular, _irq.entry(), DMA_USAGE_ALWAYS) != 0) {
+        sleep_manager_unlock_deep_sleep_named("PortOut");
+        _active = false;
+        return -1;
+    }
+    return 0;
+}
+
+void PortOutStream::stop()
+{
+    core_util_critical_section_enter();
+    if (_active) {
+        port_stream_stop(&_port);
+        sleep_manager_unlock_deep_sleep_named("PortOut");
+        _active = false;
+    }
+    core_util_critical_section_exit();
+}
+
+bool PortOutStream::active() const
+{
+    return _active;
+}
+
+void PortOutStream::write(int value)
+{
+    if (!_active) {
+        port_write(&_port, value);
+    }
+}
+
+void PortOutStream::irq_handler_asynch(void)
+{
+    int event = port_stream_irq_handler_asynch(&_port);
+
+    // a single pass is over, so the stream can be restarted from the callback
+    if (!_circular && (event & PORT_EVENT_COMPLETE)) {
+        port_stream_stop(&_port);
+        sleep_manager_unlock_deep_sleep_named("PortOut");
+        _active = false;
+    }
+
+    if (_callback && (event & _event)) {
+        _callback.call(event & _event);
+    }
+}
+
+} // namespace mbed
+
+#endif
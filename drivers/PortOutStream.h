@@ -0,0 +1,136 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MBED_PORTOUTSTREAM_H
+#define MBED_PORTOUTSTREAM_H
+
+#include "platform/platform.h"
+
+#if (DEVICE_PORTOUT && DEVICE_PORTOUT_ASYNCH) || defined(DOXYGEN_ONLY)
+
+#include "hal/port_api.h"
+#include "platform/Callback.h"
+#include "platform/CThunk.h"
+#include "platform/NonCopyable.h"
+
+namespace mbed {
+/** \addtogroup drivers */
+
+/** A multiple pin digital out driven from a buffer at a fixed rate
+ *
+ * A hardware timer paces the writes and DMA moves each word of the buffer
+ * to the port, so waveforms such as the bit stream of WS2812 LEDs come
+ * out without jitter and without the core. Each word of the buffer sets
+ * the whole masked port and is made with word(), which converts a port
+ * value to the form the target writes.
+ *
+ * A circular stream repeats the buffer until stopped and reports each
+ * half, so the application can refill one half while the other half is
+ * output.
+ *
+ * @note Synchronization level: Interrupt safe
+ *
+ * Example:
+ * @code
+ * // Send one byte to a WS2812 LED, every bit is three steps of 0.4 us
+ *
+ * #include "mbed.h"
+ *
+ * #define LED_MASK (1 << 5)
+ *
+ * PortOutStream data(PortA, LED_MASK);
+ * static uint32_t steps[3 * 8 + 1];
+ *
+ * int main() {
+ *     uint8_t byte = 0x5A;
+ *     for (int i = 0; i < 8; i++) {
+ *         bool one = byte & (0x80 >> i);
+ *         steps[3 * i + 0] = data.word(LED_MASK);
+ *         steps[3 * i + 1] = data.word(one ? LED_MASK : 0);
+ *         steps[3 * i + 2] = data.word(0);
+ *     }
+ *     steps[3 * 8] = data.word(0);
+ *     data.start(steps, sizeof(steps) / sizeof(steps[0]), 2500000, NULL);
+ * }
+ * @endcode
+ * @ingroup drivers
+ */
+class PortOutStream : private NonCopyable<PortOutStream> {
+
+public:
+
+    /** Create a stream driving the specified port
+     *
+     *  @param port Port to connect to
+     *  @param mask A bitmask to identify which bits in the port should be included (0 - ignore)
+     */
+    PortOutStream(PortName port, int mask = 0xFFFFFFFF);
+
+    virtual ~PortOutStream();
+
+    /** Get the buffer word writing a value to the port
+     *
+     *  @param value An integer specifying a bit to write for every corresponding port pin
+     *  @return The word to store in the buffer
+     */
+    uint32_t word(int value);
+
+    /** Start writing the buffer to the port
+     *
+     *  This function locks the deep sleep until the buffer has been output,
+     *  or until stop is called for a circular stream.
+     *
+     *  @param buffer   The words to output, it must stay valid until the stream completes
+     *  @param length   The number of words in the buffer, a multiple of 2 when circular
+     *  @param rate_hz  The number of words output per second
+     *  @param callback The event callback function, may be NULL
+     *  @param circular True to repeat the buffer until stop is called
+     *  @param event    The logical OR of events to call the callback for
+     *  @return Zero if output started, or -1 if the stream is running or
+     *          the target can not drive the port at that rate
+     */
+    int start(const uint32_t *buffer, size_t length, uint32_t rate_hz, const event_callback_t &callback,
+              bool circular = false, int event = PORT_EVENT_ALL);
+
+    /** Stop writing to the port, the port keeps the last word written
+     */
+    void stop();
+
+    /** Check if the stream is running
+     */
+    bool active() const;
+
+    /** Write a value to the port while the stream is not running
+     *
+     *  @param value An integer specifying a bit to write for every corresponding port pin
+     */
+    void write(int value);
+
+protected:
+    void irq_handler_asynch(void);
+
+    port_t _port;
+    CThunk<PortOutStream> _irq;
+    event_callback_t _callback;
+    int _event;
+    bool _circular;
+    volatile bool _active;
+};
+
+} // namespace mbed
+
+#endif
+
+#endif
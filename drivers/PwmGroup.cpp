@@ -0,0 +1,198 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "drivers/PwmGroup.h"
+
+#if DEVICE_PWMOUT
+
+#include "platform/mbed_assert.h"
+#include "platform/mbed_critical.h"
+#include "platform/mbed_dcache.h"
+#include "platform/mbed_sleep.h"
+
+namespace mbed {
+
+PwmGroup::PwmGroup(PinName p0, PinName p1, PinName p2, PinName p3) :
+        _count(0),
+        _synchronized(false),
+        _irq(this),
+        _event(0),
+        _circular(false),
+        _active(false)
+{
+    PinName pins[4] = { p0, p1, p2, p3 };
+    init(pins, 4);
+}
+
+PwmGroup::PwmGroup(const PinName *pins, size_t count) :
+        _count(0),
+        _synchronized(false),
+        _irq(this),
+        _event(0),
+        _circular(false),
+        _active(false)
+{
+    init(pins, count);
+}
+
+void PwmGroup::init(const PinName *pins, size_t count)
+{
+    core_util_critical_section_enter();
+    for (size_t i = 0; i < count; i++) {
+        if (pins[i] == NC) {
+            continue;
+        }
+        MBED_ASSERT(_count < MBED_CONF_DRIVERS_PWM_GROUP_CHANNELS);
+        pwmout_init(&_pwm[_count], pins[i]);
+        _duty[_count] = 0.0f;
+        _count++;
+    }
+    _synchronized = pwmout_group_init(_pwm, _count) == 0;
+    core_util_critical_section_exit();
+}
+
+PwmGroup::~PwmGroup()
+{
+    stop();
+    core_util_critical_section_enter();
+    for (size_t i = 0; i < _count; i++) {
+        pwmout_free(&_pwm[i]);
+    }
+    core_util_critical_section_exit();
+}
+
+size_t PwmGroup::size() const
+{
+    return _count;
+}
+
+bool PwmGroup::synchronized() const
+{
+    return _synchronized;
+}
+
+void PwmGroup::period(float seconds)
+{
+    period_us((int)(seconds * 1000000.0f));
+}
+
+void PwmGroup::period_ms(int ms)
+{
+    period_us(ms * 1000);
+}
+
+void PwmGroup::period_us(int us)
+{
+    core_util_critical_section_enter();
+    pwmout_group_period_us(_pwm, _count, us);
+    core_util_critical_section_exit();
+}
+
+void PwmGroup::write(const float *values)
+{
+    core_util_critical_section_enter();
+    for (size_t i = 0; i < _count; i++) {
+        _duty[i] = values[i];
+    }
+    pwmout_group_write(_pwm, _duty, _count);
+    core_util_critical_section_exit();
+}
+
+void PwmGroup::write(size_t channel, float value)
+{
+    MBED_ASSERT(channel < _count);
+    core_util_critical_section_enter();
+    _duty[channel] = value;
+    pwmout_group_write(_pwm, _duty, _count);
+    core_util_critical_section_exit();
+}
+
+float PwmGroup::read(size_t channel) const
+{
+    MBED_ASSERT(channel < _count);
+    return _duty[channel];
+}
+
+uint32_t PwmGroup::word(size_t channel, float value)
+{
+    MBED_ASSERT(channel < _count);
+    return pwmout_group_word(&_pwm[channel], value);
+}
+
+int PwmGroup::start(const uint32_t *table, size_t periods, const event_callback_t &callback,
+                    bool circular, int event)
+{
+    if (periods == 0 || (circular && periods % 2)) {
+        return -1;
+    }
+
+    core_util_critical_section_enter();
+    if (_active) {
+        core_util_critical_section_exit();
+        return -1;
+    }
+    _active = true;
+    core_util_critical_section_exit();
+
+    _callback = callback;
+    _event = event;
+    _circular = circular;
+    mbed_dcache_clean(table, periods * _count * sizeof(uint32_t));
+    _irq.callback(&PwmGroup::irq_handler_asynch);
+
+    sleep_manager_lock_deep_sleep_named("PwmGroup");
+    if (pwmout_group_stream_start(_pwm, _count, table, periods, circular, _irq.entry(), DMA_USAGE_ALWAYS) != 0) {
+        sleep_manager_unlock_deep_sleep_named("PwmGroup");
+        _active = false;
+        return -1;
+    }
+    return 0;
+}
+
+void PwmGroup::stop()
+{
+    core_util_critical_section_enter();
+    if (_active) {
+        pwmout_group_stream_stop(_pwm, _count);
+        sleep_manager_unlock_deep_sleep_named("PwmGroup");
+        _active = false;
+    }
+    core_util_critical_section_exit();
+}
+
+bool PwmGroup::active() const
+{
+    return _active;
+}
+
+void PwmGroup::irq_handler_asynch(void)
+{
+    int event = pwmout_group_irq_handler_asynch(_pwm, _count);
+
+    // a single pass is over, so the stream can be restarted from the callback
+    if (!_circular && (event & PWMOUT_EVENT_COMPLETE)) {
+        pwmout_group_stream_stop(_pwm, _count);
+        sleep_manager_unlock_deep_sleep_named("PwmGroup");
+        _active = false;
+    }
+
+    if (_callback && (event & _event)) {
+        _callback.call(event & _event);
+    }
+}
+
+} // namespace mbed
+
+#endif
@@ -0,0 +1,188 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MBED_PWMGROUP_H
+#define MBED_PWMGROUP_H
+
+#include "platform/platform.h"
+
+#if defined (DEVICE_PWMOUT) || defined(DOXYGEN_ONLY)
+
+#include "hal/pwmout_api.h"
+#include "platform/Callback.h"
+#include "platform/CThunk.h"
+#include "platform/NonCopyable.h"
+
+#ifndef MBED_CONF_DRIVERS_PWM_GROUP_CHANNELS
+#define MBED_CONF_DRIVERS_PWM_GROUP_CHANNELS 4
+#endif
+
+namespace mbed {
+/** \addtogroup drivers */
+
+/** Pulse-width modulation outputs of one timer updated together
+ *
+ * All channels of a group share the period and take new duty-cycles at the
+ * same period boundary, so the phases of a motor bridge never see a mix of
+ * old and new values. A table of duty-cycles can be streamed to the
+ * channels by DMA, one row per period, without the core.
+ *
+ * The pins must be channels of the same timer. Targets that can not update
+ * channels together set them one at a time in a critical section, which
+ * synchronized() reports.
+ *
+ * @note Synchronization level: Interrupt safe
+ *
+ * Example:
+ * @code
+ * // Drive three phases 120 degrees apart
+ *
+ * #include "mbed.h"
+ *
+ * PwmGroup bridge(PA_8, PA_9, PA_10);
+ *
+ * int main() {
+ *     bridge.period_us(50);
+ *     float duty[3] = { 0.5f, 0.933f, 0.067f };
+ *     bridge.write(duty);
+ * }
+ * @endcode
+ * @ingroup drivers
+ */
+class PwmGroup : private NonCopyable<PwmGroup> {
+
+public:
+
+    /** Create a group of up to four channels
+     *
+     *  @param p0 The first channel
+     *  @param p1 The second channel, NC if unused
+     *  @param p2 The third channel, NC if unused
+     *  @param p3 The fourth channel, NC if unused
+     */
+    PwmGroup(PinName p0, PinName p1 = NC, PinName p2 = NC, PinName p3 = NC);
+
+    /** Create a group of channels
+     *
+     *  @param pins  The channels, NC entries are skipped
+     *  @param count The number of pins, at most drivers.pwm-group-channels
+     */
+    PwmGroup(const PinName *pins, size_t count);
+
+    virtual ~PwmGroup();
+
+    /** Get the number of channels in the group
+     */
+    size_t size() const;
+
+    /** Check if the channels are updated at the same period boundary
+     *
+     *  @return True if the target binds the channels into one group
+     */
+    bool synchronized() const;
+
+    /** Set the PWM period of all channels, keeping the duty-cycles the same
+     *
+     *  @param seconds The period in seconds
+     */
+    void period(float seconds);
+
+    /** Set the PWM period of all channels, keeping the duty-cycles the same
+     *
+     *  @param ms The period in milliseconds
+     */
+    void period_ms(int ms);
+
+    /** Set the PWM period of all channels, keeping the duty-cycles the same
+     *
+     *  @param us The period in microseconds
+     */
+    void period_us(int us);
+
+    /** Set the duty-cycles of all channels together
+     *
+     *  @param values A duty-cycle between 0.0f and 1.0f for each channel
+     */
+    void write(const float *values);
+
+    /** Set the duty-cycle of one channel, the other channels keep theirs
+     *
+     *  @param channel The index of the channel
+     *  @param value   The duty-cycle between 0.0f and 1.0f
+     */
+    void write(size_t channel, float value);
+
+    /** Get the duty-cycle last written to a channel
+     *
+     *  @param channel The index of the channel
+     *  @return The duty-cycle between 0.0f and 1.0f
+     */
+    float read(size_t channel) const;
+
+    /** Get the table word setting a channel to a duty-cycle
+     *
+     *  Words depend on the period, so make the table after setting it.
+     *
+     *  @param channel The index of the channel
+     *  @param value   The duty-cycle between 0.0f and 1.0f
+     *  @return The word to store in the table
+     */
+    uint32_t word(size_t channel, float value);
+
+    /** Start streaming a table of duty-cycles to the channels
+     *
+     *  Each row of the table holds size() words, one for each channel, and
+     *  lasts one period. This function locks the deep sleep until the table
+     *  has been output, or until stop is called for a circular stream.
+     *
+     *  @param table    The words to output, it must stay valid until the stream completes
+     *  @param periods  The number of rows in the table, a multiple of 2 when circular
+     *  @param callback The event callback function, may be NULL
+     *  @param circular True to repeat the table until stop is called
+     *  @param event    The logical OR of events to call the callback for
+     *  @return Zero if output started, or -1 if the stream is running or
+     *          the target can not stream to the group
+     */
+    int start(const uint32_t *table, size_t periods, const event_callback_t &callback,
+              bool circular = false, int event = PWMOUT_EVENT_ALL);
+
+    /** Stop streaming, the channels keep the last duty-cycles written
+     */
+    void stop();
+
+    /** Check if a stream is running
+     */
+    bool active() const;
+
+protected:
+    void init(const PinName *pins, size_t count);
+    void irq_handler_asynch(void);
+
+    pwmout_t _pwm[MBED_CONF_DRIVERS_PWM_GROUP_CHANNELS];
+    float _duty[MBED_CONF_DRIVERS_PWM_GROUP_CHANNELS];
+    size_t _count;
+    bool _synchronized;
+    CThunk<PwmGroup> _irq;
+    event_callback_t _callback;
+    int _event;
+    bool _circular;
+    volatile bool _active;
+};
+
+} // namespace mbed
+
+#endif
+
+#endif
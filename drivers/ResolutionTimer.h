@@ -0,0 +1,116 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MBED_RESOLUTIONTIMER_H
+#define MBED_RESOLUTIONTIMER_H
+
+#include "platform/platform.h"
+#include "drivers/Timer.h"
+#include "drivers/Ticker.h"
+#include "drivers/Timeout.h"
+#include "platform/NonCopyable.h"
+#include "hal/us_ticker_api.h"
+#if DEVICE_LOWPOWERTIMER
+#include "hal/lp_ticker_api.h"
+#endif
+
+/** Coarsest resolution, in microseconds, that the low power ticker is trusted to provide */
+#ifndef MBED_CONF_PLATFORM_LP_TICKER_RESOLUTION_US
+#define MBED_CONF_PLATFORM_LP_TICKER_RESOLUTION_US 1000
+#endif
+
+namespace mbed {
+/** \addtogroup drivers */
+
+/** Get the ticker to time with for a required resolution
+ *
+ *  The low power ticker is used when the target has one and it is precise
+ *  enough for the resolution, so the timing does not prevent deep sleep.
+ *  Otherwise the us ticker is used.
+ *
+ *  @tparam resolution_us   Required resolution in microseconds
+ *  @return                 Ticker to time with
+ */
+template <uint32_t resolution_us>
+inline const ticker_data_t *get_ticker_data_for_resolution()
+{
+#if DEVICE_LOWPOWERTIMER
+    if (resolution_us >= MBED_CONF_PLATFORM_LP_TICKER_RESOLUTION_US) {
+        return get_lp_ticker_data();
+    }
+#endif
+    return get_us_ticker_data();
+}
+
+/** A Timer that picks its ticker from the resolution it needs
+ *
+ *  Timers that only need a coarse resolution run on the low power ticker
+ *  and do not lock deep sleep while running.
+ *
+ *  Example:
+ *  @code
+ *  // measures seconds of uptime without keeping the target out of deep sleep
+ *  ResolutionTimer<10000> uptime;
+ *  @endcode
+ *
+ *  @tparam resolution_us   Required resolution in microseconds
+ *
+ *  @note Synchronization level: Interrupt safe
+ * @ingroup drivers
+ */
+template <uint32_t resolution_us>
+class ResolutionTimer : public Timer, private NonCopyable<ResolutionTimer<resolution_us> > {
+public:
+    ResolutionTimer() : Timer(get_ticker_data_for_resolution<resolution_us>()) {
+    }
+};
+
+/** A Ticker that picks its ticker from the resolution it needs
+ *
+ *  @tparam resolution_us   Required resolution in microseconds
+ *
+ *  @note Synchronization level: Interrupt safe
+ * @ingroup drivers
+ */
+template <uint32_t resolution_us>
+class ResolutionTicker : public Ticker, private NonCopyable<ResolutionTicker<resolution_us> > {
+public:
+    ResolutionTicker() : Ticker(get_ticker_data_for_resolution<resolution_us>()) {
+    }
+};
+
+/** A Timeout that picks its ticker from the resolution it needs
+ *
+ *  Example:
+ *  @code
+ *  // a protocol retransmit timer, a millisecond late is fine
+ *  ResolutionTimeout<1000> retransmit;
+ *  @endcode
+ *
+ *  @tparam resolution_us   Required resolution in microseconds
+ *
+ *  @note Synchronization level: Interrupt safe
+ * @ingroup drivers
+ */
+template <uint32_t resolution_us>
+class ResolutionTimeout : public Timeout, private NonCopyable<ResolutionTimeout<resolution_us> > {
+public:
+    ResolutionTimeout() : Timeout(get_ticker_data_for_resolution<resolution_us>()) {
+    }
+};
+
+} // namespace mbed
+
+#endif
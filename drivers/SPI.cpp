@@ -18,6 +18,7 @@
 
 #if DEVICE_SPI_ASYNCH
 #include "platform/mbed_sleep.h"
+#include "platform/mbed_dcache.h"
 #endif
 
 #if DEVICE_SPI
@@ -33,6 +34,8 @@ SPI::SPI(PinName mosi, PinName miso, PinName sclk, PinName ssel) :
 #if DEVICE_SPI_ASYNCH
         _irq(this),
         _usage(DMA_USAGE_NEVER),
+        _rx_buffer(NULL),
+        _rx_length(0),
 #endif
         _bits(8),
         _mode(0),
@@ -140,7 +143,7 @@ int SPI::transfer(const void *tx_buffer, int tx_length, void *rx_buffer, int rx_
 void SPI::abort_transfer()
 {
     spi_abort_asynch(&_spi);
-    sleep_manager_unlock_deep_sleep();
+    sleep_manager_unlock_deep_sleep_named("SPI");
 #if TRANSACTION_QUEUE_SIZE_SPI
     dequeue_transaction();
 #endif
@@ -200,9 +203,13 @@ int SPI::queue_transfer(const void *tx_buffer, int tx_length, void *rx_buffer, i
 
 void SPI::start_transfer(const void *tx_buffer, int tx_length, void *rx_buffer, int rx_length, unsigned char bit_width, const event_callback_t& callback, int event)
 {
-    sleep_manager_lock_deep_sleep();
+    sleep_manager_lock_deep_sleep_named("SPI");
     _acquire();
     _callback = callback;
+    _rx_buffer = rx_buffer;
+    _rx_length = rx_buffer ? rx_length : 0;
+    mbed_dcache_clean(tx_buffer, tx_buffer ? tx_length : 0);
+    mbed_dcache_invalidate(_rx_buffer, _rx_length);
     _irq.callback(&SPI::irq_handler_asynch);
     spi_master_transfer(&_spi, tx_buffer, tx_length, rx_buffer, rx_length, bit_width, _irq.entry(), event , _usage);
 }
@@ -229,8 +236,12 @@ void SPI::dequeue_transaction()
 void SPI::irq_handler_asynch(void)
 {
     int event = spi_irq_handler_asynch(&_spi);
+    if (event & (SPI_EVENT_ALL | SPI_EVENT_INTERNAL_TRANSFER_COMPLETE)) {
+        // drop any lines the core fetched while DMA was writing the buffer
+        mbed_dcache_invalidate(_rx_buffer, _rx_length);
+    }
     if (_callback && (event & SPI_EVENT_ALL)) {
-        sleep_manager_unlock_deep_sleep();
+        sleep_manager_unlock_deep_sleep_named("SPI");
         _callback.call(event & SPI_EVENT_ALL);
     }
 #if TRANSACTION_QUEUE_SIZE_SPI
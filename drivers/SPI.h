@@ -274,6 +274,8 @@ protected:
     CThunk<SPI> _irq;
     event_callback_t _callback;
     DMAUsage _usage;
+    void *_rx_buffer;       // buffer of the running transfer, invalidated in the data cache when it completes
+    int _rx_length;
 #endif
 
     void aquire(void);
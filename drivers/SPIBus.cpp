@@ -0,0 +1,210 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "drivers/SPIBus.h"
+#include "platform/mbed_critical.h"
+#include "platform/mbed_sleep.h"
+
+#if DEVICE_SPI_ASYNCH
+
+namespace mbed {
+
+SPIBus::SPIBus(PinName mosi, PinName miso, PinName sclk) :
+        SPI(mosi, miso, sclk),
+        _device_count(0),
+        _queue_tail(0),
+        _queue_count(0),
+        _running(false),
+        _burst_offset(0)
+{
+}
+
+SPIBus::~SPIBus()
+{
+    abort_all();
+}
+
+int SPIBus::add_device(PinName cs, int bits, int mode, int hz, bool cs_active_high)
+{
+    lock();
+    if (_device_count >= MBED_CONF_DRIVERS_SPI_BUS_DEVICES) {
+        unlock();
+        return -1;
+    }
+
+    Device &dev = _devices[_device_count];
+    dev.has_cs = cs != NC;
+    dev.cs_active_high = cs_active_high;
+    dev.bits = bits;
+    dev.mode = mode;
+    dev.hz = hz;
+    if (dev.has_cs) {
+        gpio_init_out_ex(&dev.cs, cs, cs_active_high ? 0 : 1);
+    }
+
+    int device = _device_count++;
+    unlock();
+    return device;
+}
+
+int SPIBus::transfer(int device, const void *tx_buffer, int tx_length, void *rx_buffer, int rx_length,
+                     const event_callback_t &callback, int event)
+{
+    Job job;
+    job.device = device;
+    job.tx_buffer = static_cast<const char *>(tx_buffer);
+    job.tx_length = tx_length;
+    job.rx_buffer = static_cast<char *>(rx_buffer);
+    job.rx_length = rx_length;
+    job.burst_length = 0;
+    job.callback = callback;
+    job.event = event;
+    return queue(job);
+}
+
+int SPIBus::burst(int device, const void *buffer, size_t length, const event_callback_t &callback, int event)
+{
+    if (length == 0) {
+        return transfer(device, NULL, 0, NULL, 0, callback, event);
+    }
+
+    Job job;
+    job.device = device;
+    job.tx_buffer = static_cast<const char *>(buffer);
+    job.tx_length = 0;
+    job.rx_buffer = NULL;
+    job.rx_length = 0;
+    job.burst_length = length;
+    job.callback = callback;
+    job.event = event;
+    return queue(job);
+}
+
+int SPIBus::pending() const
+{
+    return _queue_count;
+}
+
+void SPIBus::abort_all()
+{
+    core_util_critical_section_enter();
+    if (_running) {
+        spi_abort_asynch(&_spi);
+        sleep_manager_unlock_deep_sleep_named("SPI");
+        select(_devices[_queue[_queue_tail].device], false);
+        _running = false;
+    }
+    _queue_count = 0;
+    core_util_critical_section_exit();
+}
+
+int SPIBus::queue(const Job &job)
+{
+    if (job.device < 0 || job.device >= _device_count) {
+        return -1;
+    }
+
+    core_util_critical_section_enter();
+    if (_queue_count == MBED_CONF_DRIVERS_SPI_BUS_QUEUE_SIZE) {
+        core_util_critical_section_exit();
+        return -1; // the queue is full
+    }
+    _queue[(_queue_tail + _queue_count) % MBED_CONF_DRIVERS_SPI_BUS_QUEUE_SIZE] = job;
+    _queue_count++;
+    if (!_running) {
+        _running = true;
+        start_job();
+    }
+    core_util_critical_section_exit();
+    return 0;
+}
+
+void SPIBus::select(const Device &dev, bool selected)
+{
+    if (dev.has_cs) {
+        gpio_write(const_cast<gpio_t *>(&dev.cs), selected == dev.cs_active_high ? 1 : 0);
+    }
+}
+
+// Called from queue with interrupts disabled, or from the interrupt handler
+void SPIBus::start_job()
+{
+    const Job &job = _queue[_queue_tail];
+    const Device &dev = _devices[job.device];
+
+    if (dev.bits != _bits || dev.mode != _mode || dev.hz != _hz) {
+        _bits = dev.bits;
+        _mode = dev.mode;
+        _hz = dev.hz;
+        // start_transfer applies the format of whichever SPI is not the owner
+        _owner = NULL;
+    }
+
+    select(dev, true);
+    _burst_offset = 0;
+    start_chunk();
+}
+
+void SPIBus::start_chunk()
+{
+    const Job &job = _queue[_queue_tail];
+    const Device &dev = _devices[job.device];
+    unsigned char width = dev.bits <= 8 ? 8 : dev.bits <= 16 ? 16 : 32;
+
+    if (job.burst_length) {
+        size_t length = job.burst_length - _burst_offset;
+        if (length > MBED_CONF_DRIVERS_SPI_BUS_BURST_CHUNK) {
+            length = MBED_CONF_DRIVERS_SPI_BUS_BURST_CHUNK;
+        }
+        const char *chunk = job.tx_buffer + _burst_offset;
+        _burst_offset += length;
+        start_transfer(chunk, length, NULL, 0, width, callback(this, &SPIBus::transfer_done), SPI_EVENT_ALL);
+    } else {
+        start_transfer(job.tx_buffer, job.tx_length, job.rx_buffer, job.rx_length, width,
+                       callback(this, &SPIBus::transfer_done), SPI_EVENT_ALL);
+    }
+}
+
+void SPIBus::transfer_done(int event)
+{
+    const Job &job = _queue[_queue_tail];
+
+    // the rest of a burst follows with the device still selected
+    if (job.burst_length && (event & SPI_EVENT_COMPLETE) && _burst_offset < job.burst_length) {
+        start_chunk();
+        return;
+    }
+
+    select(_devices[job.device], false);
+    event_callback_t cb = job.callback;
+    int user_event = event & job.event;
+
+    // start the next transfer before the callback to keep the bus busy
+    _queue_tail = (_queue_tail + 1) % MBED_CONF_DRIVERS_SPI_BUS_QUEUE_SIZE;
+    _queue_count--;
+    if (_queue_count) {
+        start_job();
+    } else {
+        _running = false;
+    }
+
+    if (cb && user_event) {
+        cb.call(user_event);
+    }
+}
+
+} // namespace mbed
+
+#endif
@@ -0,0 +1,193 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MBED_SPIBUS_H
+#define MBED_SPIBUS_H
+
+#include "platform/platform.h"
+
+#if DEVICE_SPI_ASYNCH || defined(DOXYGEN_ONLY)
+
+#include "drivers/SPI.h"
+#include "hal/gpio_api.h"
+
+#ifndef MBED_CONF_DRIVERS_SPI_BUS_DEVICES
+#define MBED_CONF_DRIVERS_SPI_BUS_DEVICES       4
+#endif
+
+#ifndef MBED_CONF_DRIVERS_SPI_BUS_QUEUE_SIZE
+#define MBED_CONF_DRIVERS_SPI_BUS_QUEUE_SIZE    8
+#endif
+
+#ifndef MBED_CONF_DRIVERS_SPI_BUS_BURST_CHUNK
+#define MBED_CONF_DRIVERS_SPI_BUS_BURST_CHUNK   32768
+#endif
+
+namespace mbed {
+/** \addtogroup drivers */
+
+/** A SPI master shared by several slave devices
+ *
+ * SPIBus owns the chip select pin and the format of each device on the
+ * bus. Transfers for any device are queued, and when one completes the
+ * interrupt handler releases its chip select and starts the next one
+ * straight away, reconfiguring the peripheral only when the next device
+ * uses a different format, so back-to-back transfers to different
+ * devices run with minimal gaps and no involvement of the caller.
+ *
+ * burst sends a buffer of any size, such as a display framebuffer, with
+ * the chip select held for the whole buffer.
+ *
+ * @note Synchronization level: Interrupt safe
+ *
+ * Example:
+ * @code
+ * #include "mbed.h"
+ *
+ * SPIBus bus(p5, p6, p7); // mosi, miso, sclk
+ * uint16_t framebuffer[240 * 320];
+ *
+ * void flushed(int event) {
+ * }
+ *
+ * int main() {
+ *     int flash = bus.add_device(p8, 8, 0, 20000000);
+ *     int display = bus.add_device(p9, 16, 3, 40000000);
+ *     static const char read_id[4] = { 0x9f };
+ *     static char id[4];
+ *
+ *     bus.transfer(flash, read_id, sizeof(read_id), id, sizeof(id), NULL);
+ *     bus.burst(display, framebuffer, sizeof(framebuffer), flushed);
+ * }
+ * @endcode
+ * @ingroup drivers
+ */
+class SPIBus : private SPI {
+
+public:
+
+    /** Create a SPI bus connected to the specified pins
+     *
+     *  mosi or miso can be specfied as NC if not used
+     *
+     *  @param mosi SPI Master Out, Slave In pin
+     *  @param miso SPI Master In, Slave Out pin
+     *  @param sclk SPI Clock pin
+     */
+    SPIBus(PinName mosi, PinName miso, PinName sclk);
+
+    virtual ~SPIBus();
+
+    /** Add a slave device to the bus
+     *
+     *  @param cs Chip select pin of the device, NC if it has none
+     *  @param bits Number of bits per SPI frame (4 - 32)
+     *  @param mode Clock polarity and phase mode (0 - 3)
+     *  @param hz SCLK frequency in hz
+     *  @param cs_active_high True if the device is selected by a high chip select
+     *  @return The device id to pass to transfer and burst, or -1 if
+     *          MBED_CONF_DRIVERS_SPI_BUS_DEVICES devices are already added
+     */
+    int add_device(PinName cs, int bits = 8, int mode = 0, int hz = 1000000, bool cs_active_high = false);
+
+    /** Queue a transfer to a device
+     *
+     *  The device is selected for the duration of the transfer. The lengths
+     *  are in bytes.
+     *
+     *  @param device    The device id
+     *  @param tx_buffer The TX buffer, or NULL to send the default write value
+     *  @param tx_length The length of the TX buffer in bytes
+     *  @param rx_buffer The RX buffer, or NULL to ignore received data
+     *  @param rx_length The length of the RX buffer in bytes
+     *  @param callback  The event callback function, may be NULL
+     *  @param event     The logical OR of events to call the callback for
+     *  @return Zero if the transfer was queued, -1 if the queue is full or the device is invalid
+     */
+    int transfer(int device, const void *tx_buffer, int tx_length, void *rx_buffer, int rx_length,
+                 const event_callback_t &callback, int event = SPI_EVENT_COMPLETE);
+
+    /** Queue a write of a large buffer to a device
+     *
+     *  The buffer is sent in chunks of at most MBED_CONF_DRIVERS_SPI_BUS_BURST_CHUNK
+     *  bytes, one after the other from the interrupt handler, while the device
+     *  stays selected. The callback is called once, after the last chunk.
+     *
+     *  @param device    The device id
+     *  @param buffer    The data to send
+     *  @param length    The length of the data in bytes
+     *  @param callback  The event callback function, may be NULL
+     *  @param event     The logical OR of events to call the callback for
+     *  @return Zero if the burst was queued, -1 if the queue is full or the device is invalid
+     */
+    int burst(int device, const void *buffer, size_t length,
+              const event_callback_t &callback, int event = SPI_EVENT_COMPLETE);
+
+    /** Get the number of queued transfers, including the running one
+     */
+    int pending() const;
+
+    /** Abort the running transfer and drop the queued ones
+     *
+     *  Callbacks of dropped transfers are not called.
+     */
+    void abort_all();
+
+    using SPI::set_default_write_value;
+    using SPI::set_dma_usage;
+
+private:
+    struct Device {
+        gpio_t cs;
+        bool has_cs;
+        bool cs_active_high;
+        int bits;
+        int mode;
+        int hz;
+    };
+
+    struct Job {
+        int device;
+        const char *tx_buffer;
+        int tx_length;
+        char *rx_buffer;
+        int rx_length;
+        size_t burst_length;        // non-zero for bursts, in which case tx_length is unused
+        event_callback_t callback;
+        int event;
+    };
+
+    int queue(const Job &job);
+    void start_job();
+    void start_chunk();
+    void select(const Device &dev, bool selected);
+    void transfer_done(int event);
+
+    Device _devices[MBED_CONF_DRIVERS_SPI_BUS_DEVICES];
+    int _device_count;
+
+    // a ring of jobs, the running one is at _queue_tail
+    Job _queue[MBED_CONF_DRIVERS_SPI_BUS_QUEUE_SIZE];
+    unsigned _queue_tail;
+    volatile unsigned _queue_count;
+    bool _running;
+    size_t _burst_offset;           // bytes of the running burst already started
+};
+
+} // namespace mbed
+
+#endif
+
+#endif
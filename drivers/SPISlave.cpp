@@ -17,9 +17,21 @@
 
 #if DEVICE_SPISLAVE
 
+#if DEVICE_SPISLAVE_ASYNCH
+#include "platform/mbed_critical.h"
+#include "platform/mbed_dcache.h"
+#include "platform/mbed_sleep.h"
+#endif
+
 namespace mbed {
 
 SPISlave::SPISlave(PinName mosi, PinName miso, PinName sclk, PinName ssel) :
+#if DEVICE_SPISLAVE_ASYNCH
+    _irq(this),
+    _rx_buffer(NULL),
+    _rx_size(0),
+    _transfer_active(false),
+#endif
     _spi(),
     _bits(8),
     _mode(0),
@@ -53,6 +65,68 @@ void SPISlave::reply(int value) {
     spi_slave_write(&_spi, value);
 }
 
+#if DEVICE_SPISLAVE_ASYNCH
+
+int SPISlave::transfer(const void *tx_buffer, int tx_length, void *rx_buffer, int rx_length, unsigned char bit_width,
+                       const event_callback_t &callback, int event) {
+    core_util_critical_section_enter();
+    if (_transfer_active) {
+        core_util_critical_section_exit();
+        return -1;
+    }
+    _transfer_active = true;
+    core_util_critical_section_exit();
+
+    int word_size = bit_width <= 8 ? 1 : bit_width <= 16 ? 2 : 4;
+    _callback = callback;
+    _rx_buffer = rx_buffer;
+    _rx_size = rx_buffer ? rx_length * word_size : 0;
+    mbed_dcache_clean(tx_buffer, tx_buffer ? tx_length * word_size : 0);
+    mbed_dcache_invalidate(_rx_buffer, _rx_size);
+    _irq.callback(&SPISlave::irq_handler_asynch);
+
+    sleep_manager_lock_deep_sleep_named("SPISlave");
+    if (spi_slave_transfer_asynch(&_spi, tx_buffer, tx_length, rx_buffer, rx_length, bit_width,
+                                  _irq.entry(), event, DMA_USAGE_OPPORTUNISTIC) != 0) {
+        sleep_manager_unlock_deep_sleep_named("SPISlave");
+        _transfer_active = false;
+        return -1;
+    }
+    return 0;
+}
+
+void SPISlave::abort_transfer() {
+    core_util_critical_section_enter();
+    if (_transfer_active) {
+        spi_slave_abort_asynch(&_spi);
+        sleep_manager_unlock_deep_sleep_named("SPISlave");
+        _transfer_active = false;
+    }
+    core_util_critical_section_exit();
+}
+
+int SPISlave::transferred() {
+    return spi_slave_transfer_count(&_spi);
+}
+
+void SPISlave::irq_handler_asynch(void) {
+    int event = spi_slave_irq_handler_asynch(&_spi);
+    if (!event) {
+        return;
+    }
+
+    // drop any lines the core fetched while DMA was writing the buffer
+    mbed_dcache_invalidate(_rx_buffer, _rx_size);
+    sleep_manager_unlock_deep_sleep_named("SPISlave");
+    _transfer_active = false;
+
+    if (_callback && (event & (SPI_EVENT_ALL | SPI_EVENT_SLAVE_DESELECTED))) {
+        _callback.call(event & (SPI_EVENT_ALL | SPI_EVENT_SLAVE_DESELECTED));
+    }
+}
+
+#endif
+
 } // namespace mbed
 
 #endif
@@ -23,6 +23,11 @@
 
 #include "hal/spi_api.h"
 
+#if DEVICE_SPISLAVE_ASYNCH
+#include "platform/CThunk.h"
+#include "platform/Callback.h"
+#endif
+
 namespace mbed {
 /** \addtogroup drivers */
 
@@ -112,6 +117,71 @@ public:
      */
     void reply(int value);
 
+#if DEVICE_SPISLAVE_ASYNCH
+
+    /** Arm a non-blocking transfer for the next time the master selects the slave
+     *
+     *  The TX buffer is preloaded, so the master reads tx_buffer[0] in its
+     *  first frame, and frames are moved in the background however fast the
+     *  master clocks them. The transfer ends when rx_length words have been
+     *  received or when the master releases SSEL. The callback may arm the
+     *  next transfer.
+     *
+     *  This function locks the deep sleep until the transfer has ended.
+     *
+     *  @param tx_buffer The words to reply. If NULL is passed, SPI_FILL_WORD is sent
+     *  @param tx_length The length of TX buffer in words
+     *  @param rx_buffer The RX buffer which is used for received data. If NULL is passed,
+     *                   received data are ignored
+     *  @param rx_length The length of RX buffer in words
+     *  @param callback  The event callback function
+     *  @param event     The logical OR of events to modify. Look at spi hal header file for SPI events.
+     *  @return Zero if the transfer is armed, or -1 if a transfer is armed already or the
+     *          target can not transfer as a slave in the background
+     */
+    template<typename Type>
+    int transfer(const Type *tx_buffer, int tx_length, Type *rx_buffer, int rx_length, const event_callback_t &callback,
+                 int event = SPI_EVENT_COMPLETE | SPI_EVENT_SLAVE_DESELECTED) {
+        return transfer(tx_buffer, tx_length, rx_buffer, rx_length, sizeof(Type) * 8, callback, event);
+    }
+
+    /** Disarm or abort the transfer, its callback is not called
+     */
+    void abort_transfer();
+
+    /** Get the number of words the master clocked in the last transfer
+     *
+     *  @return The number of words, valid from the callback on
+     */
+    int transferred();
+
+protected:
+    /** SPI slave IRQ handler
+     */
+    void irq_handler_asynch(void);
+
+    /** Common transfer method
+     *
+     *  @param tx_buffer The TX buffer
+     *  @param tx_length The length of TX buffer in words
+     *  @param rx_buffer The RX buffer
+     *  @param rx_length The length of RX buffer in words
+     *  @param bit_width The buffers element width
+     *  @param callback  The event callback function
+     *  @param event     The logical OR of events to modify
+     *  @return Zero if the transfer is armed, -1 otherwise
+     */
+    int transfer(const void *tx_buffer, int tx_length, void *rx_buffer, int rx_length, unsigned char bit_width,
+                 const event_callback_t &callback, int event);
+
+    CThunk<SPISlave> _irq;
+    event_callback_t _callback;
+    void *_rx_buffer;
+    int _rx_size;
+    volatile bool _transfer_active;
+
+#endif
+
 protected:
     spi_t _spi;
 
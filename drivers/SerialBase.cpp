@@ -17,6 +17,7 @@
 #include "platform/mbed_wait_api.h"
 #include "platform/mbed_critical.h"
 #include "platform/mbed_sleep.h"
+#include "platform/mbed_dcache.h"
 
 #if DEVICE_SERIAL
 
@@ -26,7 +27,8 @@ SerialBase::SerialBase(PinName tx, PinName rx, int baud) :
 #if DEVICE_SERIAL_ASYNCH
                                                  _thunk_irq(this), _tx_usage(DMA_USAGE_NEVER),
                                                  _rx_usage(DMA_USAGE_NEVER), _tx_callback(NULL),
-                                                 _rx_callback(NULL),
+                                                 _rx_callback(NULL), _rx_buffer(NULL),
+                                                 _rx_buffer_size(0), _rx_circular(false),
 #endif
                                                 _serial(), _baud(baud) {
     // No lock needed in the constructor
@@ -75,14 +77,14 @@ void SerialBase::attach(Callback<void()> func, IrqType type) {
     if (func) {
         // lock deep sleep only the first time
         if (!_irq[type]) {
-            sleep_manager_lock_deep_sleep();
+            sleep_manager_lock_deep_sleep_named("Serial");
         } 
         _irq[type] = func;
         serial_irq_set(&_serial, (SerialIrq)type, 1);
     } else {
         // unlock deep sleep only the first time
         if (_irq[type]) {
-            sleep_manager_unlock_deep_sleep();
+            sleep_manager_unlock_deep_sleep_named("Serial");
         } 
         _irq[type] = NULL;
         serial_irq_set(&_serial, (SerialIrq)type, 0);
@@ -183,7 +185,8 @@ void SerialBase::start_write(const void *buffer, int buffer_size, char buffer_wi
     _tx_callback = callback;
 
     _thunk_irq.callback(&SerialBase::interrupt_handler_asynch);
-    sleep_manager_lock_deep_sleep();
+    sleep_manager_lock_deep_sleep_named("Serial");
+    mbed_dcache_clean(buffer, buffer_size * (buffer_width / 8));
     serial_tx_asynch(&_serial, buffer, buffer_size, buffer_width, _thunk_irq.entry(), event, _tx_usage);
 }
 
@@ -191,7 +194,7 @@ void SerialBase::abort_write(void)
 {
     // rx might still be active
     if (_rx_callback) {
-        sleep_manager_unlock_deep_sleep();
+        sleep_manager_unlock_deep_sleep_named("Serial");
     }
     _tx_callback = NULL;
     serial_tx_abort_asynch(&_serial);
@@ -199,9 +202,12 @@ void SerialBase::abort_write(void)
 
 void SerialBase::abort_read(void)
 {
-    // tx might still be active
-    if (_tx_callback) {
-        sleep_manager_unlock_deep_sleep();
+    if (_rx_circular) {
+        _rx_circular = false;
+        sleep_manager_unlock_deep_sleep_named("Serial");
+    } else if (_tx_callback) {
+        // tx might still be active
+        sleep_manager_unlock_deep_sleep_named("Serial");
     }
     _rx_callback = NULL;
     serial_rx_abort_asynch(&_serial);
@@ -248,19 +254,55 @@ int SerialBase::read(uint16_t *buffer, int length, const event_callback_t& callb
 void SerialBase::start_read(void *buffer, int buffer_size, char buffer_width, const event_callback_t& callback, int event, unsigned char char_match)
 {
     _rx_callback = callback;
+    _rx_buffer = buffer;
+    _rx_buffer_size = buffer_size * (buffer_width / 8);
+    mbed_dcache_invalidate(_rx_buffer, _rx_buffer_size);
     _thunk_irq.callback(&SerialBase::interrupt_handler_asynch);
-    sleep_manager_lock_deep_sleep();
+    sleep_manager_lock_deep_sleep_named("Serial");
     serial_rx_asynch(&_serial, buffer, buffer_size, buffer_width, _thunk_irq.entry(), event, char_match, _rx_usage);
 }
 
+int SerialBase::start_read_circular(void *buffer, int buffer_size, const event_callback_t& callback, int event)
+{
+    if (serial_rx_active(&_serial)) {
+        return -1; // transaction ongoing
+    }
+
+    _rx_callback = callback;
+    // the reader invalidates the data as it consumes it, the buffer is never complete
+    _rx_buffer = NULL;
+    _rx_buffer_size = 0;
+    mbed_dcache_invalidate(buffer, buffer_size);
+    _thunk_irq.callback(&SerialBase::interrupt_handler_asynch);
+    sleep_manager_lock_deep_sleep_named("Serial");
+    if (serial_rx_circular_asynch(&_serial, buffer, buffer_size, _thunk_irq.entry(), event, _rx_usage) != 0) {
+        sleep_manager_unlock_deep_sleep_named("Serial");
+        _rx_callback = NULL;
+        return -1;
+    }
+    _rx_circular = true;
+    return 0;
+}
+
+size_t SerialBase::read_circular_position() const
+{
+    return serial_rx_circular_position(const_cast<serial_t *>(&_serial));
+}
+
 void SerialBase::interrupt_handler_asynch(void)
 {
     int event = serial_irq_handler_asynch(&_serial);
     int rx_event = event & SERIAL_EVENT_RX_MASK;
     bool unlock_deepsleep = false;
 
+    if (rx_event) {
+        // drop any lines the core fetched while DMA was writing the buffer
+        mbed_dcache_invalidate(_rx_buffer, _rx_buffer_size);
+    }
+
     if (_rx_callback && rx_event) {
-        unlock_deepsleep = true;
+        // a circular read keeps running after each event
+        unlock_deepsleep = !_rx_circular;
         _rx_callback.call(rx_event);
     }
 
@@ -271,7 +313,7 @@ void SerialBase::interrupt_handler_asynch(void)
     }
     // unlock if tx or rx events are generated
     if (unlock_deepsleep) {
-        sleep_manager_unlock_deep_sleep();
+        sleep_manager_unlock_deep_sleep_named("Serial");
     }
 }
 
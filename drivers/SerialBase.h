@@ -237,6 +237,27 @@ protected:
     void start_read(void *buffer, int buffer_size, char buffer_width, const event_callback_t& callback, int event, unsigned char char_match);
     void start_write(const void *buffer, int buffer_size, char buffer_width, const event_callback_t& callback, int event);
     void interrupt_handler_asynch(void);
+
+    /** Begin continuous reception into a circular buffer
+     *
+     *  The read keeps running, wrapping around the buffer, until abort_read
+     *  is called. The callback is called with SERIAL_EVENT_RX_HALF,
+     *  SERIAL_EVENT_RX_COMPLETE or SERIAL_EVENT_RX_IDLE and the caller
+     *  consumes the data up to read_circular_position, invalidating it in
+     *  the data cache first.
+     *
+     *  @param buffer      The circular buffer
+     *  @param buffer_size The size of the buffer in bytes
+     *  @param callback    The event callback
+     *  @param event       The logical OR of RX events
+     *  @return Zero if reception started, -1 if a read is on-going or the
+     *          target does not support circular reads
+     */
+    int start_read_circular(void *buffer, int buffer_size, const event_callback_t& callback, int event);
+
+    /** Get the index of the circular buffer the next byte is written to
+     */
+    size_t read_circular_position() const;
 #endif
 
 protected:
@@ -253,6 +274,9 @@ protected:
     DMAUsage _rx_usage;
     event_callback_t _tx_callback;
     event_callback_t _rx_callback;
+    void *_rx_buffer;       // buffer of the running read, invalidated in the data cache when it completes
+    int _rx_buffer_size;    // in bytes
+    bool _rx_circular;      // a circular read is running, it holds the deep sleep lock until abort_read
 #endif
 
     serial_t         _serial;
@@ -19,20 +19,53 @@
 #include "platform/FunctionPointer.h"
 #include "hal/ticker_api.h"
 #include "platform/mbed_critical.h"
+#if MBED_CONF_EVENTS_PRESENT
+#include "events/StaticEvent.h"
+#endif
 
 namespace mbed {
 
+Ticker::~Ticker() {
+    detach();
+#if MBED_CONF_EVENTS_PRESENT
+    delete _deferred;
+#endif
+}
+
 void Ticker::detach() {
     core_util_critical_section_enter();
     remove();
+#if MBED_CONF_EVENTS_PRESENT
+    if (_deferred) {
+        _deferred->cancel();
+    }
+#endif
     // unlocked only if we were attached (we locked it)
-    if (_function) {
-        sleep_manager_unlock_deep_sleep();
+    if (_function && _lock_deepsleep) {
+        sleep_manager_unlock_deep_sleep_named("Ticker");
     }
     _function = 0;
     core_util_critical_section_exit();
 }
 
+#if MBED_CONF_EVENTS_PRESENT
+void Ticker::attach_deferred_us(events::EventQueue *queue, Callback<void()> func, us_timestamp_t t) {
+    events::StaticEvent<Callback<void()> > *deferred =
+            new events::StaticEvent<Callback<void()> >(queue, func);
+
+    // stop firing before the previous event is replaced
+    core_util_critical_section_enter();
+    remove();
+    events::StaticEvent<Callback<void()> > *previous = _deferred;
+    _deferred = deferred;
+    core_util_critical_section_exit();
+    delete previous;
+
+    // posting the event coalesces overruns, as it is only pending once
+    attach_us(Callback<void()>(deferred, &events::StaticEvent<Callback<void()> >::operator()), t);
+}
+#endif
+
 void Ticker::setup(us_timestamp_t t) {
     core_util_critical_section_enter();
     remove();
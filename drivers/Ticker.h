@@ -22,6 +22,14 @@
 #include "platform/NonCopyable.h"
 #include "platform/mbed_sleep.h"
 
+#if MBED_CONF_EVENTS_PRESENT
+namespace events {
+class EventQueue;
+template <typename F>
+class StaticEvent;
+}
+#endif
+
 namespace mbed {
 /** \addtogroup drivers */
 
@@ -64,10 +72,19 @@ namespace mbed {
 class Ticker : public TimerEvent, private NonCopyable<Ticker> {
 
 public:
-    Ticker() : TimerEvent(), _function(0) {
+    Ticker() : TimerEvent(), _function(0), _lock_deepsleep(true)
+#if MBED_CONF_EVENTS_PRESENT
+        , _deferred(NULL)
+#endif
+    {
     }
 
-    Ticker(const ticker_data_t *data) : TimerEvent(data), _function(0) {
+    Ticker(const ticker_data_t *data) : TimerEvent(data), _function(0),
+        _lock_deepsleep(data == get_us_ticker_data())
+#if MBED_CONF_EVENTS_PRESENT
+        , _deferred(NULL)
+#endif
+    {
         data->interface->init();
     }
 
@@ -103,9 +120,10 @@ public:
      *  @param t the time between calls in micro-seconds
      */
     void attach_us(Callback<void()> func, us_timestamp_t t) {
-        // lock only for the initial callback setup
-        if (!_function) {
-            sleep_manager_lock_deep_sleep();
+        // lock only for the initial callback setup and only for tickers
+        // that stop in deep sleep
+        if (!_function && _lock_deepsleep) {
+            sleep_manager_lock_deep_sleep_named("Ticker");
         }
         _function = func;
         setup(t);
@@ -128,10 +146,38 @@ public:
         attach_us(Callback<void()>(obj, method), t);
     }
 
-    virtual ~Ticker() {
-        detach();
+#if MBED_CONF_EVENTS_PRESENT
+    /** Attach a function to be called from an event queue, specifiying the interval in seconds
+     *
+     *  When the Ticker fires, an event preallocated on attach is posted to
+     *  the queue, so the function runs in the context of the queue's
+     *  dispatch loop instead of in interrupt context. If the Ticker fires
+     *  again before the event is dispatched, the function is only called
+     *  once for both.
+     *
+     *  Allocates the event, so it can not be called from interrupt context.
+     *
+     *  @param queue event queue to call the function from
+     *  @param func pointer to the function to be called
+     *  @param t the time between calls in seconds
+     */
+    void attach_deferred(events::EventQueue *queue, Callback<void()> func, float t) {
+        attach_deferred_us(queue, func, t * 1000000.0f);
     }
 
+    /** Attach a function to be called from an event queue, specifiying the interval in micro-seconds
+     *
+     *  @see attach_deferred
+     *
+     *  @param queue event queue to call the function from
+     *  @param func pointer to the function to be called
+     *  @param t the time between calls in micro-seconds
+     */
+    void attach_deferred_us(events::EventQueue *queue, Callback<void()> func, us_timestamp_t t);
+#endif
+
+    virtual ~Ticker();
+
     /** Detach the function
      */
     void detach();
@@ -143,6 +189,10 @@ protected:
 protected:
     us_timestamp_t         _delay;  /**< Time delay (in microseconds) for re-setting the multi-shot callback. */
     Callback<void()>    _function;  /**< Callback. */
+    bool          _lock_deepsleep;  /**< Flag which indicates if deep-sleep should be disabled. */
+#if MBED_CONF_EVENTS_PRESENT
+    events::StaticEvent<Callback<void()> > *_deferred;  /**< Event posted when attached to an event queue. */
+#endif
 };
 
 } // namespace mbed
@@ -56,6 +56,17 @@ namespace mbed {
  */
 class Timeout : public Ticker, private NonCopyable<Timeout> {
 
+public:
+    Timeout() : Ticker() {
+    }
+
+    /** Create a Timeout running on the given ticker
+     *
+     *  @param data ticker to time the Timeout with
+     */
+    Timeout(const ticker_data_t *data) : Ticker(data) {
+    }
+
 protected:
     virtual void handler();
 };
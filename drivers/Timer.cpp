@@ -20,18 +20,21 @@
 
 namespace mbed {
 
-Timer::Timer() : _running(), _start(), _time(), _ticker_data(get_us_ticker_data()) {
+Timer::Timer() : _running(), _start(), _time(), _ticker_data(get_us_ticker_data()), _lock_deepsleep(true) {
     reset();
 }
 
-Timer::Timer(const ticker_data_t *data) : _running(), _start(), _time(), _ticker_data(data) {
+Timer::Timer(const ticker_data_t *data) : _running(), _start(), _time(), _ticker_data(data),
+    _lock_deepsleep(data == get_us_ticker_data()) {
     reset();
 }
 
 void Timer::start() {
     core_util_critical_section_enter();
     if (!_running) {
-        sleep_manager_lock_deep_sleep();
+        if (_lock_deepsleep) {
+            sleep_manager_lock_deep_sleep_named("Timer");
+        }
         _start = ticker_read_us(_ticker_data);
         _running = 1;
     }
@@ -41,8 +44,8 @@ void Timer::start() {
 void Timer::stop() {
     core_util_critical_section_enter();
     _time += slicetime();
-    if (_running) {
-        sleep_manager_unlock_deep_sleep();
+    if (_running && _lock_deepsleep) {
+        sleep_manager_unlock_deep_sleep_named("Timer");
     }
     _running = 0;
     core_util_critical_section_exit();
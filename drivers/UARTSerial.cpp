@@ -17,25 +17,114 @@
 #if (DEVICE_SERIAL && DEVICE_INTERRUPTIN)
 
 #include <errno.h>
+#include <string.h>
 #include "UARTSerial.h"
+#include "platform/mbed_assert.h"
 #include "platform/mbed_poll.h"
 #include "platform/mbed_wait_api.h"
 
 namespace mbed {
 
+static char *alloc_storage(size_t size)
+{
+#if UARTSERIAL_DMA
+    // the RX storage doubles as the DMA buffer, keep it clear of other cache lines
+    char *storage = static_cast<char *>(mbed_dma_alloc(size));
+    MBED_ASSERT(storage);
+    return storage;
+#else
+    return new char[size];
+#endif
+}
+
+static void free_storage(char *storage)
+{
+#if UARTSERIAL_DMA
+    mbed_dma_free(storage);
+#else
+    delete[] storage;
+#endif
+}
+
 UARTSerial::UARTSerial(PinName tx, PinName rx, int baud) :
         SerialBase(tx, rx, baud),
+        _rx_storage(alloc_storage(MBED_CONF_DRIVERS_UART_SERIAL_RXBUF_SIZE + 1)),
+        _rx_storage_size(MBED_CONF_DRIVERS_UART_SERIAL_RXBUF_SIZE + 1),
+        _tx_storage(alloc_storage(MBED_CONF_DRIVERS_UART_SERIAL_TXBUF_SIZE + 1)),
+        _own_storage(true),
+        _rxbuf(_rx_storage, _rx_storage_size),
+        _txbuf(_tx_storage, MBED_CONF_DRIVERS_UART_SERIAL_TXBUF_SIZE + 1),
+        _blocking(true),
+        _tx_irq_enabled(false),
+        _rx_flow(false),
+        _rx_throttled(false),
+        _rx_enabled(true),
+        _dcd_irq(NULL)
+#if UARTSERIAL_DMA
+        , _dma_rx(false),
+        _dma_tx_active(false),
+        _dma_rx_tail(0)
+#endif
+{
+    init();
+}
+
+UARTSerial::UARTSerial(PinName tx, PinName rx, void *rxbuf, size_t rxbuf_size, void *txbuf, size_t txbuf_size, int baud) :
+        SerialBase(tx, rx, baud),
+        _rx_storage(static_cast<char *>(rxbuf)),
+        _rx_storage_size(rxbuf_size),
+        _tx_storage(static_cast<char *>(txbuf)),
+        _own_storage(false),
+        _rxbuf(_rx_storage, rxbuf_size),
+        _txbuf(_tx_storage, txbuf_size),
         _blocking(true),
         _tx_irq_enabled(false),
+        _rx_flow(false),
+        _rx_throttled(false),
+        _rx_enabled(true),
         _dcd_irq(NULL)
+#if UARTSERIAL_DMA
+        , _dma_rx(false),
+        _dma_tx_active(false),
+        _dma_rx_tail(0)
+#endif
 {
+    MBED_ASSERT(rxbuf && rxbuf_size >= 2 && txbuf && txbuf_size >= 2);
+    init();
+}
+
+void UARTSerial::init()
+{
+#if UARTSERIAL_DMA
+    SerialBase::set_dma_usage_tx(DMA_USAGE_ALWAYS);
+    SerialBase::set_dma_usage_rx(DMA_USAGE_ALWAYS);
+    _dma_rx = SerialBase::start_read_circular(_rx_storage, _rx_storage_size,
+            callback(this, &UARTSerial::dma_rx_event),
+            SERIAL_EVENT_RX_HALF | SERIAL_EVENT_RX_COMPLETE | SERIAL_EVENT_RX_IDLE) == 0;
+    if (_dma_rx) {
+        return;
+    }
+#endif
     /* Attatch IRQ routines to the serial device. */
     SerialBase::attach(callback(this, &UARTSerial::rx_irq), RxIrq);
 }
 
 UARTSerial::~UARTSerial()
 {
+#if UARTSERIAL_DMA
+    if (_dma_rx && _rx_enabled) {
+        SerialBase::abort_read();
+    }
+    if (_dma_tx_active) {
+        SerialBase::abort_write();
+    }
+#endif
     delete _dcd_irq;
+
+    if (_own_storage) {
+        free_storage(_rx_storage);
+        free_storage(_tx_storage);
+    }
 }
 
 void UARTSerial::dcd_irq()
@@ -48,6 +137,19 @@ void UARTSerial::set_baud(int baud)
     SerialBase::baud(baud);
 }
 
+#if DEVICE_SERIAL_FC
+void UARTSerial::set_flow_control(Flow type, PinName flow1, PinName flow2)
+{
+    api_lock();
+    SerialBase::set_flow_control(type, flow1, flow2);
+    _rx_flow = type == RTS || type == RTSCTS;
+    if (!_rx_flow) {
+        rx_resume();
+    }
+    api_unlock();
+}
+#endif
+
 void UARTSerial::set_data_carrier_detect(PinName dcd_pin, bool active_high)
 {
      delete _dcd_irq;
@@ -63,6 +165,36 @@ void UARTSerial::set_data_carrier_detect(PinName dcd_pin, bool active_high)
     }
 }
 
+void UARTSerial::enable_input(bool enabled)
+{
+    core_util_critical_section_enter();
+    if (enabled != _rx_enabled) {
+        _rx_enabled = enabled;
+#if UARTSERIAL_DMA
+        if (_dma_rx) {
+            if (enabled) {
+                _dma_rx_tail = 0;
+                SerialBase::start_read_circular(_rx_storage, _rx_storage_size,
+                        callback(this, &UARTSerial::dma_rx_event),
+                        SERIAL_EVENT_RX_HALF | SERIAL_EVENT_RX_COMPLETE | SERIAL_EVENT_RX_IDLE);
+            } else {
+                SerialBase::abort_read();
+            }
+            core_util_critical_section_exit();
+            return;
+        }
+#endif
+        if (enabled) {
+            SerialBase::attach(callback(this, &UARTSerial::rx_irq), RxIrq);
+        } else if (!_rx_throttled) {
+            SerialBase::attach(NULL, RxIrq);
+        }
+        /* rx_irq is attached again by enabling input, not by read */
+        _rx_throttled = false;
+    }
+    core_util_critical_section_exit();
+}
+
 int UARTSerial::close()
 {
     /* Does not let us pass a file descriptor. So how to close ?
@@ -87,7 +219,11 @@ int UARTSerial::sync()
 {
     api_lock();
 
-    while (!_txbuf.empty()) {
+    while (!_txbuf.empty()
+#if UARTSERIAL_DMA
+            || _dma_tx_active
+#endif
+            ) {
         api_unlock();
         // Doing better than wait would require TxIRQ to also do wake() when becoming empty. Worth it?
         wait_ms(1);
@@ -128,12 +264,14 @@ ssize_t UARTSerial::write(const void* buffer, size_t length)
         api_lock();
     }
 
-    while (data_written < length && !_txbuf.full()) {
-        _txbuf.push(*buf_ptr++);
-        data_written++;
-    }
+    data_written = _txbuf.push(buf_ptr, length);
 
     core_util_critical_section_enter();
+#if UARTSERIAL_DMA
+    if (!_dma_tx_active) {
+        UARTSerial::dma_tx_start();
+    }
+#else
     if (!_tx_irq_enabled) {
         UARTSerial::tx_irq();                // only write to hardware in one place
         if (!_txbuf.empty()) {
@@ -141,6 +279,7 @@ ssize_t UARTSerial::write(const void* buffer, size_t length)
             _tx_irq_enabled = true;
         }
     }
+#endif
     core_util_critical_section_exit();
 
     api_unlock();
@@ -156,6 +295,40 @@ ssize_t UARTSerial::read(void* buffer, size_t length)
 
     api_lock();
 
+#if UARTSERIAL_DMA
+    if (_dma_rx) {
+        while (dma_rx_available() == 0) {
+            if (!_blocking) {
+                api_unlock();
+                return -EAGAIN;
+            }
+            api_unlock();
+            wait_ms(1);
+            api_lock();
+        }
+
+        size_t head = SerialBase::read_circular_position();
+        while (data_read < length && _dma_rx_tail != head) {
+            // copy up to the head or the end of the buffer, whichever is first
+            size_t end = head > _dma_rx_tail ? head : _rx_storage_size;
+            size_t n = end - _dma_rx_tail;
+            if (n > length - data_read) {
+                n = length - data_read;
+            }
+
+            mbed_dcache_invalidate(&_rx_storage[_dma_rx_tail], n);
+            memcpy(ptr, &_rx_storage[_dma_rx_tail], n);
+            ptr += n;
+            data_read += n;
+            _dma_rx_tail = (_dma_rx_tail + n) % _rx_storage_size;
+        }
+
+        api_unlock();
+
+        return data_read;
+    }
+#endif
+
     while (_rxbuf.empty()) {
         if (!_blocking) {
             api_unlock();
@@ -166,16 +339,52 @@ ssize_t UARTSerial::read(void* buffer, size_t length)
         api_lock();
     }
 
-    while (data_read < length && !_rxbuf.empty()) {
-        _rxbuf.pop(*ptr++);
-        data_read++;
-    }
+    data_read = _rxbuf.pop(ptr, length);
+    rx_resume();
 
     api_unlock();
 
     return data_read;
 }
 
+ssize_t UARTSerial::writev(const struct iovec *iov, int iovcnt)
+{
+    ssize_t total = 0;
+
+    // the mutex is recursive, so write keeps it held while it waits for space
+    api_lock();
+    for (int i = 0; i < iovcnt; i++) {
+        const char *ptr = static_cast<const char *>(iov[i].iov_base);
+        size_t left = iov[i].iov_len;
+        while (left) {
+            ssize_t n = write(ptr, left);
+            if (n < 0) {
+                api_unlock();
+                return total ? total : n;
+            }
+            total += n;
+            ptr += n;
+            left -= n;
+            if (left && !_blocking) {
+                api_unlock();
+                return total;
+            }
+        }
+    }
+    api_unlock();
+
+    return total;
+}
+
+ssize_t UARTSerial::readv(const struct iovec *iov, int iovcnt)
+{
+    api_lock();
+    ssize_t total = FileHandle::readv(iov, iovcnt);
+    api_unlock();
+
+    return total;
+}
+
 bool UARTSerial::hup() const
 {
     return _dcd_irq && _dcd_irq->read() != 0;
@@ -186,6 +395,7 @@ void UARTSerial::wake()
     if (_sigio_cb) {
         _sigio_cb();
     }
+    poll_change(this);
 }
 
 short UARTSerial::poll(short events) const {
@@ -194,9 +404,15 @@ short UARTSerial::poll(short events) const {
     /* Check the Circular Buffer if space available for writing out */
 
 
+#if UARTSERIAL_DMA
+    if (_dma_rx ? dma_rx_available() != 0 : !_rxbuf.empty()) {
+        revents |= POLLIN;
+    }
+#else
     if (!_rxbuf.empty()) {
         revents |= POLLIN;
     }
+#endif
 
     /* POLLHUP and POLLOUT are mutually exclusive */
     if (hup()) {
@@ -239,6 +455,13 @@ void UARTSerial::rx_irq(void)
     /* Fill in the receive buffer if the peripheral is readable
      * and receive buffer is not full. */
     while (SerialBase::readable()) {
+        if (_rx_flow && _rxbuf.full()) {
+            /* Leave the rest in the peripheral, for RTS to hold off the
+             * remote end, until read makes space. */
+            SerialBase::attach(NULL, RxIrq);
+            _rx_throttled = true;
+            break;
+        }
         char data = SerialBase::_base_getc();
         if (!_rxbuf.full()) {
             _rxbuf.push(data);
@@ -253,6 +476,16 @@ void UARTSerial::rx_irq(void)
     }
 }
 
+void UARTSerial::rx_resume(void)
+{
+    core_util_critical_section_enter();
+    if (_rx_throttled) {
+        _rx_throttled = false;
+        SerialBase::attach(callback(this, &UARTSerial::rx_irq), RxIrq);
+    }
+    core_util_critical_section_exit();
+}
+
 // Also called from write to start transfer
 void UARTSerial::tx_irq(void)
 {
@@ -277,6 +510,52 @@ void UARTSerial::tx_irq(void)
     }
 }
 
+#if UARTSERIAL_DMA
+size_t UARTSerial::dma_rx_available() const
+{
+    if (!_rx_enabled) {
+        return 0;
+    }
+
+    /* Data the reader fell a whole buffer behind on is overwritten and can
+     * not be told apart from an empty buffer - as with rx_irq, it is lost. */
+    size_t head = SerialBase::read_circular_position();
+    return (head + _rx_storage_size - _dma_rx_tail) % _rx_storage_size;
+}
+
+void UARTSerial::dma_rx_event(int event)
+{
+    /* Report the File handler that data is ready to be read from the buffer. */
+    if (dma_rx_available() != 0) {
+        wake();
+    }
+}
+
+// Also called from write to start transfer
+void UARTSerial::dma_tx_start(void)
+{
+    bool was_full = _txbuf.full();
+    size_t n = _txbuf.pop(_dma_txbuf, sizeof _dma_txbuf);
+
+    if (n) {
+        _dma_tx_active = true;
+        SerialBase::write(reinterpret_cast<const uint8_t *>(_dma_txbuf), n,
+                callback(this, &UARTSerial::dma_tx_done), SERIAL_EVENT_TX_COMPLETE);
+    }
+
+    /* Report the File handler that data can be written to peripheral. */
+    if (was_full && !_txbuf.full() && !hup()) {
+        wake();
+    }
+}
+
+void UARTSerial::dma_tx_done(int event)
+{
+    _dma_tx_active = false;
+    dma_tx_start();
+}
+#endif
+
 } //namespace mbed
 
 #endif //(DEVICE_SERIAL && DEVICE_INTERRUPTIN)
@@ -26,7 +26,7 @@
 #include "InterruptIn.h"
 #include "PlatformMutex.h"
 #include "serial_api.h"
-#include "CircularBuffer.h"
+#include "SPSCCircularBuffer.h"
 #include "platform/NonCopyable.h"
 
 #ifndef MBED_CONF_DRIVERS_UART_SERIAL_RXBUF_SIZE
@@ -37,6 +37,25 @@
 #define MBED_CONF_DRIVERS_UART_SERIAL_TXBUF_SIZE  256
 #endif
 
+#ifndef MBED_CONF_DRIVERS_UART_SERIAL_DMA
+#define MBED_CONF_DRIVERS_UART_SERIAL_DMA  0
+#endif
+
+#ifndef MBED_CONF_DRIVERS_UART_SERIAL_DMA_TX_CHUNK
+#define MBED_CONF_DRIVERS_UART_SERIAL_DMA_TX_CHUNK  64
+#endif
+
+/* With DMA enabled, the RX buffer is filled by a circular DMA read instead
+ * of an interrupt per character, and the TX buffer is drained in chunks by
+ * asynchronous writes. Targets that can not do circular reads fall back to
+ * the RX interrupt.
+ */
+#define UARTSERIAL_DMA  (DEVICE_SERIAL_ASYNCH && MBED_CONF_DRIVERS_UART_SERIAL_DMA)
+
+#if UARTSERIAL_DMA
+#include "platform/mbed_dcache.h"
+#endif
+
 namespace mbed {
 
 class UARTSerial : private SerialBase, public FileHandle, private NonCopyable<UARTSerial> {
@@ -49,6 +68,31 @@ public:
      *  @param baud The baud rate of the serial port (optional, defaults to MBED_CONF_PLATFORM_DEFAULT_SERIAL_BAUD_RATE)
      */
     UARTSerial(PinName tx, PinName rx, int baud = MBED_CONF_PLATFORM_DEFAULT_SERIAL_BAUD_RATE);
+
+    /** Create a UARTSerial port with caller provided buffers.
+     *
+     *  The buffers replace the ones of the configured sizes, so each port
+     *  gets as much RAM as its traffic needs. They must outlive the port and
+     *  each holds one byte less than its size. With drivers.uart-serial-dma
+     *  the RX buffer is also the DMA buffer and should be MBED_DCACHE_ALIGNED.
+     *
+     *  @code
+     *  static char modem_rx[1024];
+     *  static char modem_tx[128];
+     *  UARTSerial modem(TX, RX, modem_rx, sizeof(modem_rx), modem_tx, sizeof(modem_tx), 115200);
+     *  @endcode
+     *
+     *  @param tx Transmit pin
+     *  @param rx Receive pin
+     *  @param rxbuf Receive buffer
+     *  @param rxbuf_size Size of the receive buffer in bytes, at least 2
+     *  @param txbuf Transmit buffer
+     *  @param txbuf_size Size of the transmit buffer in bytes, at least 2
+     *  @param baud The baud rate of the serial port (optional, defaults to MBED_CONF_PLATFORM_DEFAULT_SERIAL_BAUD_RATE)
+     */
+    UARTSerial(PinName tx, PinName rx, void *rxbuf, size_t rxbuf_size, void *txbuf, size_t txbuf_size,
+               int baud = MBED_CONF_PLATFORM_DEFAULT_SERIAL_BAUD_RATE);
+
     virtual ~UARTSerial();
 
     /** Equivalent to POSIX poll(). Derived from FileHandle.
@@ -78,6 +122,28 @@ public:
      */
     virtual ssize_t read(void* buffer, size_t length);
 
+    /** Write the contents of several buffers
+     *
+     *  The buffers are written with the lock held, so a frame built from
+     *  several buffers is not interleaved with other writers. In blocking
+     *  mode all the data is written before returning.
+     *
+     *  @param iov      The buffers to write from
+     *  @param iovcnt   The number of buffers
+     *  @return         The number of bytes written, negative error on failure
+     */
+    virtual ssize_t writev(const struct iovec *iov, int iovcnt);
+
+    /** Read the contents of a file into several buffers
+     *
+     *  Follows the semantics of read, as if by one read of the total size.
+     *
+     *  @param iov      The buffers to read in to
+     *  @param iovcnt   The number of buffers
+     *  @return         The number of bytes read, negative error on failure
+     */
+    virtual ssize_t readv(const struct iovec *iov, int iovcnt);
+
     /** Close a file
      *
      *  @return         0 on success, negative error code on failure
@@ -152,12 +218,49 @@ public:
      */
     void set_data_carrier_detect(PinName dcd_pin, bool active_high = false);
 
+    /** Enable or disable input
+     *
+     *  While input is disabled, the receive interrupt or circular DMA read is
+     *  stopped, which releases the deep sleep lock it holds, and characters
+     *  arriving are lost. Data already received remains readable, except with
+     *  a circular DMA read, where it is discarded. Output and the DCD
+     *  interrupt are not affected, so the DCD line can signal through sigio()
+     *  that input should be enabled again, e.g., a modem leaving its sleep.
+     *
+     *  Can be called from interrupt context.
+     *
+     *  @param enabled  true to enable input, false to disable it
+     */
+    void enable_input(bool enabled);
+
     /** Set the baud rate
      *
      *  @param baud   The baud rate
      */
     void set_baud(int baud);
 
+#if DEVICE_SERIAL_FC
+    // The flow control types of SerialBase, which is a private base
+    using SerialBase::Flow;
+    using SerialBase::Disabled;
+    using SerialBase::RTS;
+    using SerialBase::CTS;
+    using SerialBase::RTSCTS;
+
+    /** Set the flow control type of the port
+     *
+     *  With RTS, characters that arrive while the RX buffer is full are
+     *  left in the peripheral, which deasserts RTS to hold off the remote
+     *  end until they are read, rather than dropped. A circular DMA read
+     *  is not held off, its buffer must take what arrives between reads.
+     *
+     *  @param type     The flow control type (Disabled, RTS, CTS, RTSCTS)
+     *  @param flow1    The first flow control pin (RTS for RTS or RTSCTS, CTS for CTS)
+     *  @param flow2    The second flow control pin (CTS for RTSCTS)
+     */
+    void set_flow_control(Flow type, PinName flow1 = NC, PinName flow2 = NC);
+#endif
+
 private:
 
     /** SerialBase lock override */
@@ -172,11 +275,24 @@ private:
     /** Release mutex */
     virtual void api_unlock(void);
 
+    /** Shared part of the constructors */
+    void init(void);
+
+    /** Storage of the software serial buffers
+     *  Allocated by the constructor unless provided by the caller.
+     */
+    char *_rx_storage;
+    size_t _rx_storage_size;
+    char *_tx_storage;
+    bool _own_storage;
+
     /** Software serial buffers
      *  By default buffer size is 256 for TX and 256 for RX. Configurable through mbed_app.json
+     *  Each has a single producer and a single consumer, the ISRs on one
+     *  side and the api_lock holder on the other, so they need no critical sections.
      */
-    CircularBuffer<char, MBED_CONF_DRIVERS_UART_SERIAL_RXBUF_SIZE> _rxbuf;
-    CircularBuffer<char, MBED_CONF_DRIVERS_UART_SERIAL_TXBUF_SIZE> _txbuf;
+    SPSCRingBuffer<char> _rxbuf;
+    SPSCRingBuffer<char> _txbuf;
 
     PlatformMutex _mutex;
 
@@ -184,6 +300,9 @@ private:
 
     bool _blocking;
     bool _tx_irq_enabled;
+    bool _rx_flow;                  // RTS holds off the remote end while _rxbuf is full
+    bool _rx_throttled;             // rx_irq is detached until read makes space
+    bool _rx_enabled;               // input is not disabled by enable_input()
     InterruptIn *_dcd_irq;
 
     /** Device Hanged up
@@ -201,10 +320,30 @@ private:
     void tx_irq(void);
     void rx_irq(void);
 
+    /** Attach rx_irq again if it was detached for flow control */
+    void rx_resume(void);
+
     void wake(void);
 
     void dcd_irq(void);
 
+#if UARTSERIAL_DMA
+    /** DMA handlers
+     *  Start the next TX chunk and report RX events to the File handle.
+     */
+    void dma_tx_start(void);
+    void dma_tx_done(int event);
+    void dma_rx_event(int event);
+
+    /** Bytes received by DMA and not read yet */
+    size_t dma_rx_available() const;
+
+    bool _dma_rx;                   // RX runs on a circular read rather than rx_irq
+    volatile bool _dma_tx_active;
+    size_t _dma_rx_tail;            // next byte of _rx_storage to read, the circular read uses it instead of _rxbuf
+    MBED_DCACHE_ALIGNED char _dma_txbuf[MBED_DCACHE_ROUND_UP(MBED_CONF_DRIVERS_UART_SERIAL_DMA_TX_CHUNK)];
+#endif
+
 };
 } //namespace mbed
 
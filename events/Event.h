@@ -209,6 +209,7 @@ private:
         equeue_event_delay(p, e->delay);
         equeue_event_period(p, e->period);
         equeue_event_dtor(p, &EventQueue::function_dtor<C>);
+        equeue_event_tag(p, EventQueue::profile_tag(*(F*)(e + 1)));
         return equeue_post(e->equeue, &EventQueue::function_call<C>, p);
     }
 
@@ -627,6 +628,7 @@ private:
         equeue_event_delay(p, e->delay);
         equeue_event_period(p, e->period);
         equeue_event_dtor(p, &EventQueue::function_dtor<C>);
+        equeue_event_tag(p, EventQueue::profile_tag(*(F*)(e + 1)));
         return equeue_post(e->equeue, &EventQueue::function_call<C>, p);
     }
 
@@ -1045,6 +1047,7 @@ private:
         equeue_event_delay(p, e->delay);
         equeue_event_period(p, e->period);
         equeue_event_dtor(p, &EventQueue::function_dtor<C>);
+        equeue_event_tag(p, EventQueue::profile_tag(*(F*)(e + 1)));
         return equeue_post(e->equeue, &EventQueue::function_call<C>, p);
     }
 
@@ -1463,6 +1466,7 @@ private:
         equeue_event_delay(p, e->delay);
         equeue_event_period(p, e->period);
         equeue_event_dtor(p, &EventQueue::function_dtor<C>);
+        equeue_event_tag(p, EventQueue::profile_tag(*(F*)(e + 1)));
         return equeue_post(e->equeue, &EventQueue::function_call<C>, p);
     }
 
@@ -1881,6 +1885,7 @@ private:
         equeue_event_delay(p, e->delay);
         equeue_event_period(p, e->period);
         equeue_event_dtor(p, &EventQueue::function_dtor<C>);
+        equeue_event_tag(p, EventQueue::profile_tag(*(F*)(e + 1)));
         return equeue_post(e->equeue, &EventQueue::function_call<C>, p);
     }
 
@@ -2299,6 +2304,7 @@ private:
         equeue_event_delay(p, e->delay);
         equeue_event_period(p, e->period);
         equeue_event_dtor(p, &EventQueue::function_dtor<C>);
+        equeue_event_tag(p, EventQueue::profile_tag(*(F*)(e + 1)));
         return equeue_post(e->equeue, &EventQueue::function_call<C>, p);
     }
 
@@ -18,6 +18,16 @@
 #include "events/mbed_events.h"
 #include "mbed.h"
 
+#if defined(FEATURE_COMMON_PAL)
+#include "mbed_trace.h"
+#define TRACE_GROUP "EVQ"
+#else
+#define tr_info(...) (void(0)) //dummies if feature common pal is not added
+#endif
+
+#if MBED_CONF_EVENTS_DIAGNOSTICS_ENABLED
+EventQueue *EventQueue::_queues = NULL;
+#endif
 
 EventQueue::EventQueue(unsigned event_size, unsigned char *event_pointer) {
     if (!event_pointer) {
@@ -25,13 +35,35 @@ EventQueue::EventQueue(unsigned event_size, unsigned char *event_pointer) {
     } else {
         equeue_create_inplace(&_equeue, event_size, event_pointer);
     }
+
+#if MBED_CONF_EVENTS_DIAGNOSTICS_ENABLED
+    _name = NULL;
+    _thread_id = 0;
+    core_util_critical_section_enter();
+    _next = _queues;
+    _queues = this;
+    core_util_critical_section_exit();
+#endif
 }
 
 EventQueue::~EventQueue() {
+#if MBED_CONF_EVENTS_DIAGNOSTICS_ENABLED
+    core_util_critical_section_enter();
+    EventQueue **p = &_queues;
+    while (*p != this) {
+        p = &(*p)->_next;
+    }
+    *p = _next;
+    core_util_critical_section_exit();
+#endif
+
     equeue_destroy(&_equeue);
 }
 
 void EventQueue::dispatch(int ms) {
+#if MBED_CONF_EVENTS_DIAGNOSTICS_ENABLED && MBED_CONF_RTOS_PRESENT
+    _thread_id = (uint32_t)osThreadGetId();
+#endif
     return equeue_dispatch(&_equeue, ms);
 }
 
@@ -57,6 +89,86 @@ void EventQueue::background(Callback<void(int)> update) {
     }
 }
 
+int EventQueue::reserve(unsigned size, unsigned count) {
+    return equeue_reserve(&_equeue, size, count);
+}
+
+void EventQueue::get_stats(struct equeue_stats *stats) {
+    return equeue_stats(&_equeue, stats);
+}
+
+unsigned EventQueue::get_class_stats(struct equeue_class_stats *stats,
+        unsigned count) {
+    return equeue_class_stats(&_equeue, stats, count);
+}
+
+unsigned EventQueue::get_profile(struct equeue_profile *profiles,
+        unsigned count) {
+    return equeue_profile(&_equeue, profiles, count);
+}
+
+void EventQueue::reset_profile() {
+    equeue_profile_reset(&_equeue);
+}
+
+void EventQueue::dump_profile() {
+#ifdef EQUEUE_PROFILE
+    struct equeue_profile profiles[EQUEUE_PROFILE_CALLBACKS];
+    unsigned n = equeue_profile(&_equeue, profiles, EQUEUE_PROFILE_CALLBACKS);
+    for (unsigned i = 0; i < n; i++) {
+        tr_info("%p: tag %p, count %u, latency mean %uus max %uus, "
+                "duration mean %uus max %uus",
+                (void *)profiles[i].cb, profiles[i].tag, profiles[i].count,
+                (unsigned)(profiles[i].latency_total / profiles[i].count),
+                profiles[i].latency_max,
+                (unsigned)(profiles[i].duration_total / profiles[i].count),
+                profiles[i].duration_max);
+        tr_info("%p: latency histogram %u %u %u %u %u %u %u %u",
+                (void *)profiles[i].cb,
+                profiles[i].latency_hist[0], profiles[i].latency_hist[1],
+                profiles[i].latency_hist[2], profiles[i].latency_hist[3],
+                profiles[i].latency_hist[4], profiles[i].latency_hist[5],
+                profiles[i].latency_hist[6], profiles[i].latency_hist[7]);
+        tr_info("%p: duration histogram %u %u %u %u %u %u %u %u",
+                (void *)profiles[i].cb,
+                profiles[i].duration_hist[0], profiles[i].duration_hist[1],
+                profiles[i].duration_hist[2], profiles[i].duration_hist[3],
+                profiles[i].duration_hist[4], profiles[i].duration_hist[5],
+                profiles[i].duration_hist[6], profiles[i].duration_hist[7]);
+    }
+
+    unsigned dropped = equeue_profile_dropped(&_equeue);
+    if (dropped) {
+        tr_info("%u dispatches of unprofiled callbacks", dropped);
+    }
+#endif
+}
+
+void EventQueue::set_name(const char *name) {
+#if MBED_CONF_EVENTS_DIAGNOSTICS_ENABLED
+    _name = name;
+#endif
+}
+
+unsigned EventQueue::get_all_stats(struct queue_stats *stats, unsigned count) {
+    unsigned n = 0;
+#if MBED_CONF_EVENTS_DIAGNOSTICS_ENABLED
+    // the queue lock is a critical section too, so this nests and
+    // keeps queues from going away while their stats are read
+    core_util_critical_section_enter();
+    for (EventQueue *q = _queues; q; q = q->_next) {
+        if (n < count) {
+            stats[n].name = q->_name;
+            stats[n].thread_id = q->_thread_id;
+            equeue_stats(&q->_equeue, &stats[n].stats);
+        }
+        n++;
+    }
+    core_util_critical_section_exit();
+#endif
+    return n;
+}
+
 void EventQueue::chain(EventQueue *target) {
     if (target) {
         equeue_chain(&_equeue, &target->_equeue);
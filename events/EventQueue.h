@@ -41,6 +41,8 @@ namespace events {
 // Predeclared classes
 template <typename F>
 class Event;
+template <typename F>
+class StaticEvent;
 
 
 /** EventQueue
@@ -76,6 +78,14 @@ public:
      *  to terminate. When called with a timeout of 0, the dispatch function
      *  does not wait and is irq safe.
      *
+     *  Multiple threads may dispatch the same queue. Each thread takes one
+     *  event at a time, so a long running callback only holds up the thread
+     *  running it. Events posted with call_serial and the same key are never
+     *  run concurrently and keep their order.
+     *
+     *  Due events are executed from the highest priority first, see
+     *  EventQueue::call_with_priority.
+     *
      *  @param ms       Time to wait for events in milliseconds, a negative
      *                  value will dispatch events indefinitely
      *                  (default to -1)
@@ -159,6 +169,120 @@ public:
      */
     void chain(EventQueue *target);
 
+    /** Reserve memory for events of a specific size
+     *
+     *  Slices count chunks for events of the specified size out of the
+     *  queue's buffer, so hot event types are allocated in constant time
+     *  from a dedicated size class. This should be called right after
+     *  construction, before events of other sizes are posted.
+     *
+     *  The size is the size of the event's context, for example the size
+     *  of the callback passed to call. Events created with call and one or
+     *  more arguments carry an internal context around their arguments, so
+     *  EventQueue::reserve_call is usually more convenient.
+     *
+     *  @param size     Size of the event's context in bytes
+     *  @param count    Number of chunks to reserve
+     *  @return         0 on success, or a negative value if the buffer can
+     *                  not fit all of the chunks
+     */
+    int reserve(unsigned size, unsigned count);
+
+    /** Reserve memory for calls of a specific function type
+     *
+     *  Reserves count chunks that fit EventQueue::call(f), where f is of
+     *  type F. For calls with arguments, pass the pre-bound callback type,
+     *  for example mbed::Callback<void()>.
+     *
+     *  @param count    Number of chunks to reserve
+     *  @return         0 on success, or a negative value if the buffer can
+     *                  not fit all of the chunks
+     *  @see EventQueue::reserve
+     */
+    template <typename F>
+    int reserve_call(unsigned count) {
+        return reserve(sizeof(F), count);
+    }
+
+    /** Get allocator statistics
+     *
+     *  Reports the memory usage of the event queue's buffer. The allocation
+     *  counters, high-water marks and failure counts are only tracked if
+     *  events.stats-enabled is set, and are reported as zero otherwise.
+     *
+     *  @param stats    Structure to fill with the queue's statistics
+     */
+    void get_stats(struct equeue_stats *stats);
+
+    /** Get allocator statistics per size class
+     *
+     *  Fills up to count entries with the usage of each chunk size in the
+     *  event queue's buffer.
+     *
+     *  @param stats    Array to fill with the statistics of each size class
+     *  @param count    Number of entries in the array
+     *  @return         Number of entries filled
+     */
+    unsigned get_class_stats(struct equeue_class_stats *stats, unsigned count);
+
+    /** Get the dispatch profile
+     *
+     *  Fills up to count entries with the latency from when each event was
+     *  due until its callback started, and the time spent in the callback,
+     *  recorded per callback. Profiles are only recorded if
+     *  events.profile-enabled is set, otherwise no entries are filled.
+     *
+     *  Events posted with EventQueue::call and friends, or with an Event,
+     *  are recorded by the thunk for their function type and tagged with
+     *  the function pointer they wrap, so each plain function gets its own
+     *  entry. Other callables, such as mbed::Callback<void()> or bound
+     *  methods, can not be told apart and share one entry per type.
+     *
+     *  @param profiles Array to fill with the profile of each callback
+     *  @param count    Number of entries in the array
+     *  @return         Number of entries filled
+     */
+    unsigned get_profile(struct equeue_profile *profiles, unsigned count);
+
+    /** Clear the dispatch profile
+     */
+    void reset_profile();
+
+    /** Print the dispatch profile with mbed-trace
+     *
+     *  Prints the recorded profile of each callback at the info level. Does
+     *  nothing if events.profile-enabled is not set.
+     */
+    void dump_profile();
+
+    /** Name the event queue for diagnostics
+     *
+     *  The name is listed by EventQueue::get_all_stats and the diagnostics
+     *  console, and is only kept if events.diagnostics-enabled is set.
+     *
+     *  @param name     Name of the queue, which must outlive the queue
+     */
+    void set_name(const char *name);
+
+    /** Usage of an event queue, see EventQueue::get_all_stats
+     */
+    struct queue_stats {
+        const char *name;           /**< Name set with set_name, or NULL */
+        uint32_t thread_id;         /**< Thread that last dispatched the queue, or 0 */
+        struct equeue_stats stats;  /**< Allocator statistics, see get_stats */
+    };
+
+    /** Get the usage of all event queues
+     *
+     *  Queues are only tracked if events.diagnostics-enabled is set,
+     *  otherwise no entries are filled.
+     *
+     *  @param stats    Array to fill with the usage of each queue
+     *  @param count    Number of entries in the array
+     *  @return         Number of queues, which may be more than count
+     */
+    static unsigned get_all_stats(struct queue_stats *stats, unsigned count);
+
     /** Calls an event on the queue
      *
      *  The specified callback will be executed in the context of the event
@@ -181,6 +305,65 @@ public:
 
         F *e = new (p) F(f);
         equeue_event_dtor(e, &EventQueue::function_dtor<F>);
+        equeue_event_tag(e, profile_tag(f));
+        return equeue_post(&_equeue, &EventQueue::function_call<F>, e);
+    }
+
+    /** Calls an event on the queue with a serial key
+     *
+     *  Behaves like EventQueue::call, but events posted with the same
+     *  non-zero key are never executed concurrently when the queue is
+     *  dispatched by multiple threads, and are executed in the order they
+     *  became ready.
+     *
+     *  Arguments can be bound with mbed::callback.
+     *
+     *  @param key      Serial key of the event, 0 for no key
+     *  @param f        Function to execute in the context of the dispatch loop
+     *  @return         A unique id that represents the posted event and can
+     *                  be passed to cancel, or an id of 0 if there is not
+     *                  enough memory to allocate the event.
+     */
+    template <typename F>
+    int call_serial(unsigned key, F f) {
+        void *p = equeue_alloc(&_equeue, sizeof(F));
+        if (!p) {
+            return 0;
+        }
+
+        F *e = new (p) F(f);
+        equeue_event_dtor(e, &EventQueue::function_dtor<F>);
+        equeue_event_tag(e, profile_tag(f));
+        equeue_event_key(e, key);
+        return equeue_post(&_equeue, &EventQueue::function_call<F>, e);
+    }
+
+    /** Calls an event on the queue with a priority
+     *
+     *  Behaves like EventQueue::call, but once the event is due it is
+     *  executed before any due events with a lower priority, even if they
+     *  became due earlier. Priorities range from 0, the default and lowest
+     *  priority, to EQUEUE_PRIORITIES-1, higher values are clamped.
+     *
+     *  Arguments can be bound with mbed::callback.
+     *
+     *  @param priority Priority band of the event
+     *  @param f        Function to execute in the context of the dispatch loop
+     *  @return         A unique id that represents the posted event and can
+     *                  be passed to cancel, or an id of 0 if there is not
+     *                  enough memory to allocate the event.
+     */
+    template <typename F>
+    int call_with_priority(unsigned priority, F f) {
+        void *p = equeue_alloc(&_equeue, sizeof(F));
+        if (!p) {
+            return 0;
+        }
+
+        F *e = new (p) F(f);
+        equeue_event_dtor(e, &EventQueue::function_dtor<F>);
+        equeue_event_tag(e, profile_tag(f));
+        equeue_event_priority(e, priority);
         return equeue_post(&_equeue, &EventQueue::function_call<F>, e);
     }
 
@@ -450,6 +633,36 @@ public:
         F *e = new (p) F(f);
         equeue_event_delay(e, ms);
         equeue_event_dtor(e, &EventQueue::function_dtor<F>);
+        equeue_event_tag(e, profile_tag(f));
+        return equeue_post(&_equeue, &EventQueue::function_call<F>, e);
+    }
+
+    /** Calls an event on the queue after a specified delay with slack
+     *
+     *  Behaves like EventQueue::call_in, but the event may be executed up
+     *  to slack milliseconds late. The dispatch loop uses the slack to run
+     *  events with nearby deadlines from a single wakeup, which lets the
+     *  device sleep for longer between events.
+     *
+     *  @param ms       Time to delay in milliseconds
+     *  @param slack    Time the event may be delayed further in milliseconds
+     *  @param f        Function to execute in the context of the dispatch loop
+     *  @return         A unique id that represents the posted event and can
+     *                  be passed to cancel, or an id of 0 if there is not
+     *                  enough memory to allocate the event.
+     */
+    template <typename F>
+    int call_in_with_slack(int ms, int slack, F f) {
+        void *p = equeue_alloc(&_equeue, sizeof(F));
+        if (!p) {
+            return 0;
+        }
+
+        F *e = new (p) F(f);
+        equeue_event_delay(e, ms);
+        equeue_event_slack(e, slack);
+        equeue_event_dtor(e, &EventQueue::function_dtor<F>);
+        equeue_event_tag(e, profile_tag(f));
         return equeue_post(&_equeue, &EventQueue::function_call<F>, e);
     }
 
@@ -725,6 +938,36 @@ public:
         equeue_event_delay(e, ms);
         equeue_event_period(e, ms);
         equeue_event_dtor(e, &EventQueue::function_dtor<F>);
+        equeue_event_tag(e, profile_tag(f));
+        return equeue_post(&_equeue, &EventQueue::function_call<F>, e);
+    }
+
+    /** Calls an event on the queue periodically with slack
+     *
+     *  Behaves like EventQueue::call_every, but each period may be executed
+     *  up to slack milliseconds late. The period is still measured from the
+     *  intended deadline, so the slack does not accumulate.
+     *
+     *  @param ms       Period of the event in milliseconds
+     *  @param slack    Time each period may be delayed in milliseconds
+     *  @param f        Function to execute in the context of the dispatch loop
+     *  @return         A unique id that represents the posted event and can
+     *                  be passed to cancel, or an id of 0 if there is not
+     *                  enough memory to allocate the event.
+     */
+    template <typename F>
+    int call_every_with_slack(int ms, int slack, F f) {
+        void *p = equeue_alloc(&_equeue, sizeof(F));
+        if (!p) {
+            return 0;
+        }
+
+        F *e = new (p) F(f);
+        equeue_event_delay(e, ms);
+        equeue_event_period(e, ms);
+        equeue_event_slack(e, slack);
+        equeue_event_dtor(e, &EventQueue::function_dtor<F>);
+        equeue_event_tag(e, profile_tag(f));
         return equeue_post(&_equeue, &EventQueue::function_call<F>, e);
     }
 
@@ -2280,9 +2523,19 @@ public:
 protected:
     template <typename F>
     friend class Event;
+    template <typename F>
+    friend class StaticEvent;
     struct equeue _equeue;
     mbed::Callback<void(int)> _update;
 
+#if MBED_CONF_EVENTS_DIAGNOSTICS_ENABLED
+    // Registry of all queues, for get_all_stats
+    static EventQueue *_queues;
+    EventQueue *_next;
+    const char *_name;
+    uint32_t _thread_id;
+#endif
+
     // Function attributes
     template <typename F>
     static void function_call(void *p) {
@@ -2726,6 +2979,224 @@ protected:
             f(c0, c1, c2, c3, c4, a0, a1, a2, a3, a4);
         }
     };
+
+    // Profile tags, events that wrap a function pointer are profiled by
+    // the function pointer instead of by the thunk for their type
+
+    template <typename F>
+    static const void *profile_tag(const F &) {
+        return 0;
+    }
+
+    template <typename R>
+    static const void *profile_tag(R (*f)()) {
+        return (const void *)f;
+    }
+
+    template <typename R, typename B0>
+    static const void *profile_tag(R (*f)(B0)) {
+        return (const void *)f;
+    }
+
+    template <typename R, typename B0, typename B1>
+    static const void *profile_tag(R (*f)(B0, B1)) {
+        return (const void *)f;
+    }
+
+    template <typename R, typename B0, typename B1, typename B2>
+    static const void *profile_tag(R (*f)(B0, B1, B2)) {
+        return (const void *)f;
+    }
+
+    template <typename R, typename B0, typename B1, typename B2, typename B3>
+    static const void *profile_tag(R (*f)(B0, B1, B2, B3)) {
+        return (const void *)f;
+    }
+
+    template <typename R, typename B0, typename B1, typename B2, typename B3, typename B4>
+    static const void *profile_tag(R (*f)(B0, B1, B2, B3, B4)) {
+        return (const void *)f;
+    }
+
+    template <typename F>
+    static const void *profile_tag(const context00<F> &c) {
+        return profile_tag(c.f);
+    }
+
+    template <typename F, typename A0>
+    static const void *profile_tag(const context01<F, A0> &c) {
+        return profile_tag(c.f);
+    }
+
+    template <typename F, typename A0, typename A1>
+    static const void *profile_tag(const context02<F, A0, A1> &c) {
+        return profile_tag(c.f);
+    }
+
+    template <typename F, typename A0, typename A1, typename A2>
+    static const void *profile_tag(const context03<F, A0, A1, A2> &c) {
+        return profile_tag(c.f);
+    }
+
+    template <typename F, typename A0, typename A1, typename A2, typename A3>
+    static const void *profile_tag(const context04<F, A0, A1, A2, A3> &c) {
+        return profile_tag(c.f);
+    }
+
+    template <typename F, typename A0, typename A1, typename A2, typename A3, typename A4>
+    static const void *profile_tag(const context05<F, A0, A1, A2, A3, A4> &c) {
+        return profile_tag(c.f);
+    }
+
+    template <typename F, typename C0>
+    static const void *profile_tag(const context10<F, C0> &c) {
+        return profile_tag(c.f);
+    }
+
+    template <typename F, typename C0, typename A0>
+    static const void *profile_tag(const context11<F, C0, A0> &c) {
+        return profile_tag(c.f);
+    }
+
+    template <typename F, typename C0, typename A0, typename A1>
+    static const void *profile_tag(const context12<F, C0, A0, A1> &c) {
+        return profile_tag(c.f);
+    }
+
+    template <typename F, typename C0, typename A0, typename A1, typename A2>
+    static const void *profile_tag(const context13<F, C0, A0, A1, A2> &c) {
+        return profile_tag(c.f);
+    }
+
+    template <typename F, typename C0, typename A0, typename A1, typename A2, typename A3>
+    static const void *profile_tag(const context14<F, C0, A0, A1, A2, A3> &c) {
+        return profile_tag(c.f);
+    }
+
+    template <typename F, typename C0, typename A0, typename A1, typename A2, typename A3, typename A4>
+    static const void *profile_tag(const context15<F, C0, A0, A1, A2, A3, A4> &c) {
+        return profile_tag(c.f);
+    }
+
+    template <typename F, typename C0, typename C1>
+    static const void *profile_tag(const context20<F, C0, C1> &c) {
+        return profile_tag(c.f);
+    }
+
+    template <typename F, typename C0, typename C1, typename A0>
+    static const void *profile_tag(const context21<F, C0, C1, A0> &c) {
+        return profile_tag(c.f);
+    }
+
+    template <typename F, typename C0, typename C1, typename A0, typename A1>
+    static const void *profile_tag(const context22<F, C0, C1, A0, A1> &c) {
+        return profile_tag(c.f);
+    }
+
+    template <typename F, typename C0, typename C1, typename A0, typename A1, typename A2>
+    static const void *profile_tag(const context23<F, C0, C1, A0, A1, A2> &c) {
+        return profile_tag(c.f);
+    }
+
+    template <typename F, typename C0, typename C1, typename A0, typename A1, typename A2, typename A3>
+    static const void *profile_tag(const context24<F, C0, C1, A0, A1, A2, A3> &c) {
+        return profile_tag(c.f);
+    }
+
+    template <typename F, typename C0, typename C1, typename A0, typename A1, typename A2, typename A3, typename A4>
+    static const void *profile_tag(const context25<F, C0, C1, A0, A1, A2, A3, A4> &c) {
+        return profile_tag(c.f);
+    }
+
+    template <typename F, typename C0, typename C1, typename C2>
+    static const void *profile_tag(const context30<F, C0, C1, C2> &c) {
+        return profile_tag(c.f);
+    }
+
+    template <typename F, typename C0, typename C1, typename C2, typename A0>
+    static const void *profile_tag(const context31<F, C0, C1, C2, A0> &c) {
+        return profile_tag(c.f);
+    }
+
+    template <typename F, typename C0, typename C1, typename C2, typename A0, typename A1>
+    static const void *profile_tag(const context32<F, C0, C1, C2, A0, A1> &c) {
+        return profile_tag(c.f);
+    }
+
+    template <typename F, typename C0, typename C1, typename C2, typename A0, typename A1, typename A2>
+    static const void *profile_tag(const context33<F, C0, C1, C2, A0, A1, A2> &c) {
+        return profile_tag(c.f);
+    }
+
+    template <typename F, typename C0, typename C1, typename C2, typename A0, typename A1, typename A2, typename A3>
+    static const void *profile_tag(const context34<F, C0, C1, C2, A0, A1, A2, A3> &c) {
+        return profile_tag(c.f);
+    }
+
+    template <typename F, typename C0, typename C1, typename C2, typename A0, typename A1, typename A2, typename A3, typename A4>
+    static const void *profile_tag(const context35<F, C0, C1, C2, A0, A1, A2, A3, A4> &c) {
+        return profile_tag(c.f);
+    }
+
+    template <typename F, typename C0, typename C1, typename C2, typename C3>
+    static const void *profile_tag(const context40<F, C0, C1, C2, C3> &c) {
+        return profile_tag(c.f);
+    }
+
+    template <typename F, typename C0, typename C1, typename C2, typename C3, typename A0>
+    static const void *profile_tag(const context41<F, C0, C1, C2, C3, A0> &c) {
+        return profile_tag(c.f);
+    }
+
+    template <typename F, typename C0, typename C1, typename C2, typename C3, typename A0, typename A1>
+    static const void *profile_tag(const context42<F, C0, C1, C2, C3, A0, A1> &c) {
+        return profile_tag(c.f);
+    }
+
+    template <typename F, typename C0, typename C1, typename C2, typename C3, typename A0, typename A1, typename A2>
+    static const void *profile_tag(const context43<F, C0, C1, C2, C3, A0, A1, A2> &c) {
+        return profile_tag(c.f);
+    }
+
+    template <typename F, typename C0, typename C1, typename C2, typename C3, typename A0, typename A1, typename A2, typename A3>
+    static const void *profile_tag(const context44<F, C0, C1, C2, C3, A0, A1, A2, A3> &c) {
+        return profile_tag(c.f);
+    }
+
+    template <typename F, typename C0, typename C1, typename C2, typename C3, typename A0, typename A1, typename A2, typename A3, typename A4>
+    static const void *profile_tag(const context45<F, C0, C1, C2, C3, A0, A1, A2, A3, A4> &c) {
+        return profile_tag(c.f);
+    }
+
+    template <typename F, typename C0, typename C1, typename C2, typename C3, typename C4>
+    static const void *profile_tag(const context50<F, C0, C1, C2, C3, C4> &c) {
+        return profile_tag(c.f);
+    }
+
+    template <typename F, typename C0, typename C1, typename C2, typename C3, typename C4, typename A0>
+    static const void *profile_tag(const context51<F, C0, C1, C2, C3, C4, A0> &c) {
+        return profile_tag(c.f);
+    }
+
+    template <typename F, typename C0, typename C1, typename C2, typename C3, typename C4, typename A0, typename A1>
+    static const void *profile_tag(const context52<F, C0, C1, C2, C3, C4, A0, A1> &c) {
+        return profile_tag(c.f);
+    }
+
+    template <typename F, typename C0, typename C1, typename C2, typename C3, typename C4, typename A0, typename A1, typename A2>
+    static const void *profile_tag(const context53<F, C0, C1, C2, C3, C4, A0, A1, A2> &c) {
+        return profile_tag(c.f);
+    }
+
+    template <typename F, typename C0, typename C1, typename C2, typename C3, typename C4, typename A0, typename A1, typename A2, typename A3>
+    static const void *profile_tag(const context54<F, C0, C1, C2, C3, C4, A0, A1, A2, A3> &c) {
+        return profile_tag(c.f);
+    }
+
+    template <typename F, typename C0, typename C1, typename C2, typename C3, typename C4, typename A0, typename A1, typename A2, typename A3, typename A4>
+    static const void *profile_tag(const context55<F, C0, C1, C2, C3, C4, A0, A1, A2, A3, A4> &c) {
+        return profile_tag(c.f);
+    }
 };
 
 }
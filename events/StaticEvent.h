@@ -0,0 +1,170 @@
+/* events
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef STATIC_EVENT_H
+#define STATIC_EVENT_H
+
+#include "events/EventQueue.h"
+#include "platform/NonCopyable.h"
+#include "platform/mbed_assert.h"
+
+namespace events {
+/** \addtogroup events */
+
+/** StaticEvent
+ *
+ *  Representation of an event whose storage is embedded in the StaticEvent
+ *  itself instead of being allocated from the event queue. The callback and
+ *  its bound arguments are stored once on construction, so posting the event
+ *  never allocates and can not fail because the queue is out of memory.
+ *
+ *  The callback is called without arguments, so any arguments must be bound
+ *  into the callback itself, for example with mbed::callback.
+ *
+ *  A StaticEvent can only be pending once at a time. Destroying it cancels
+ *  the event, but it should not be destroyed while the event is being
+ *  dispatched.
+ *
+ *  Example:
+ *  @code
+ *  EventQueue queue;
+ *  StaticEvent<Callback<void()> > sample(&queue, callback(&adc, &Adc::read));
+ *
+ *  void adc_isr() {
+ *      sample.post();
+ *  }
+ *  @endcode
+ * @ingroup events
+ */
+template <typename F>
+class StaticEvent : private mbed::NonCopyable<StaticEvent<F> > {
+public:
+    /** Create a static event
+     *
+     *  Constructs an event bound to the specified event queue. The specified
+     *  callback acts as the target for the event and is executed in the
+     *  context of the event queue's dispatch loop once posted.
+     *
+     *  @param q        Event queue to dispatch on
+     *  @param f        Function to execute when the event is dispatched,
+     *                  called without arguments
+     */
+    StaticEvent(EventQueue *q, F f)
+        : _equeue(&q->_equeue), _f(f) {
+        void *p = equeue_user_allocated(&_storage);
+        MBED_ASSERT(p == &_storage.self);
+        (void)p;
+        _storage.self = this;
+    }
+
+    /** Destructor for static events
+     *
+     *  Cancels the event if it is still pending, removing it from the event
+     *  queue unless it is already being dispatched.
+     */
+    ~StaticEvent() {
+        cancel();
+    }
+
+    /** Configure the delay of an event
+     *
+     *  The delay is applied every time the event is posted.
+     *
+     *  @param delay    Millisecond delay before dispatching the event
+     */
+    void delay(int delay) {
+        equeue_event_delay(&_storage.self, delay);
+    }
+
+    /** Configure the period of an event
+     *
+     *  @param period   Millisecond period for repeatedly dispatching an event
+     */
+    void period(int period) {
+        equeue_event_period(&_storage.self, period);
+    }
+
+    /** Posts the event onto the underlying event queue
+     *
+     *  The event is posted to the underlying queue and is executed in the
+     *  context of the event queue's dispatch loop.
+     *
+     *  The post function is irq safe and can act as a mechanism for moving
+     *  events out of irq contexts.
+     *
+     *  @return         True if the event was posted, false if the event is
+     *                  already pending.
+     */
+    bool post() {
+        return equeue_post_user_allocated(_equeue,
+                &StaticEvent::event_call, &_storage.self) == 0;
+    }
+
+    /** Posts the event onto the underlying event queue
+     *  @see StaticEvent::post
+     */
+    void operator()() {
+        post();
+    }
+
+    /** Cancels the event
+     *
+     *  Attempts to cancel the event if it is pending. It is safe to call
+     *  cancel after the event has already been dispatched.
+     *
+     *  The cancel function is irq safe.
+     *
+     *  If called while the event queue's dispatch loop is active, the cancel
+     *  function does not guarantee that the event will not execute after it
+     *  returns, as the event may have already begun executing.
+     *
+     *  @return         True if the event was removed before it was dispatched,
+     *                  which is the case unless its dispatch has begun
+     */
+    bool cancel() {
+        return equeue_cancel_user_allocated(_equeue, &_storage.self);
+    }
+
+    /** Check if the event is pending
+     *
+     *  @return         True from when the event is posted until it has been
+     *                  dispatched or cancelled
+     */
+    bool pending() const {
+        return equeue_user_allocated_pending(_equeue,
+                const_cast<StaticEvent **>(&_storage.self));
+    }
+
+private:
+    equeue_t *_equeue;
+    F _f;
+
+    // the event header must be directly followed by the argument passed to
+    // the callback, which is a pointer back to this StaticEvent
+    struct storage {
+        struct equeue_event e;
+        StaticEvent *self;
+    } _storage;
+
+    static void event_call(void *p) {
+        (*static_cast<StaticEvent **>(p))->_f();
+    }
+};
+
+}
+
+#endif
+
+/** @}*/
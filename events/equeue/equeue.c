@@ -20,6 +20,10 @@
 #include <stdlib.h>
 #include <string.h>
 
+// event flags, only used by user allocated events
+#define EQUEUE_EVENT_USER      0x1
+#define EQUEUE_EVENT_PENDING   0x2
+#define EQUEUE_EVENT_CANCELLED 0x4
 
 // calculate the relative-difference between absolute times while
 // correctly handling overflow conditions
@@ -69,9 +73,29 @@ int equeue_create_inplace(equeue_t *q, size_t size, void *buffer) {
     q->chunks = 0;
     q->slab.size = size;
     q->slab.data = buffer;
-
-    q->queue = 0;
+#ifdef EQUEUE_STATS
+    memset(&q->stats, 0, sizeof(q->stats));
+    memset(q->classes, 0, sizeof(q->classes));
+#endif
+#ifdef EQUEUE_PROFILE
+    memset(q->profiles, 0, sizeof(q->profiles));
+    q->profile_dropped = 0;
+#endif
+
+    q->immediate = 0;
+    for (unsigned i = 0; i < EQUEUE_PRIORITIES; i++) {
+        q->ready[i] = 0;
+        q->ready_tail[i] = &q->ready[i];
+    }
+    q->running = 0;
+    q->dispatchers = 0;
     q->tick = equeue_tick();
+#ifdef EQUEUE_TIMER_WHEEL
+    memset(&q->wheel, 0, sizeof(q->wheel));
+    q->wheel.tick = q->tick;
+#else
+    q->queue = 0;
+#endif
     q->generation = 0;
     q->breaks = 0;
 
@@ -101,6 +125,32 @@ int equeue_create_inplace(equeue_t *q, size_t size, void *buffer) {
 
 void equeue_destroy(equeue_t *q) {
     // call destructors on pending events
+    for (struct equeue_event *e = q->immediate; e; e = e->next) {
+        if (e->dtor) {
+            e->dtor(e + 1);
+        }
+    }
+
+    for (unsigned i = 0; i < EQUEUE_PRIORITIES; i++) {
+        for (struct equeue_event *e = q->ready[i]; e; e = e->next) {
+            if (e->dtor) {
+                e->dtor(e + 1);
+            }
+        }
+    }
+
+#ifdef EQUEUE_TIMER_WHEEL
+    for (unsigned l = 0; l < EQUEUE_WHEEL_LEVELS; l++) {
+        for (unsigned s = 0; s < EQUEUE_WHEEL_SLOTS; s++) {
+            for (struct equeue_event *e = q->wheel.slots[l][s]; e;
+                    e = e->next) {
+                if (e->dtor) {
+                    e->dtor(e + 1);
+                }
+            }
+        }
+    }
+#else
     for (struct equeue_event *es = q->queue; es; es = es->next) {
         for (struct equeue_event *e = q->queue; e; e = e->sibling) {
             if (e->dtor) {
@@ -108,6 +158,7 @@ void equeue_destroy(equeue_t *q) {
             }
         }
     }
+#endif
 
     // notify background timer
     if (q->background.update) {
@@ -123,10 +174,106 @@ void equeue_destroy(equeue_t *q) {
 
 
 // equeue chunk allocation functions
-static struct equeue_event *equeue_mem_alloc(equeue_t *q, size_t size) {
+static inline size_t equeue_mem_size(size_t size) {
     // add event overhead
     size += sizeof(struct equeue_event);
-    size = (size + sizeof(void*)-1) & ~(sizeof(void*)-1);
+    return (size + sizeof(void*)-1) & ~(sizeof(void*)-1);
+}
+
+#ifdef EQUEUE_STATS
+// find the stats for a chunk size, adding a new class if there is room
+static struct equeue_class_stats *equeue_stats_class(equeue_t *q,
+        size_t size, bool create) {
+    for (unsigned i = 0; i < EQUEUE_STATS_CLASSES; i++) {
+        struct equeue_class_stats *c = &q->classes[i];
+        if (c->size == size) {
+            return c;
+        } else if (!c->size) {
+            if (!create) {
+                return 0;
+            }
+
+            c->size = size;
+            return c;
+        }
+    }
+
+    return 0;
+}
+
+static void equeue_stats_alloc(equeue_t *q, struct equeue_event *e) {
+    q->stats.alloc_size += e->size;
+    if (q->stats.alloc_size > q->stats.max_alloc_size) {
+        q->stats.max_alloc_size = q->stats.alloc_size;
+    }
+
+    q->stats.alloc_cnt += 1;
+    if (q->stats.alloc_cnt > q->stats.max_alloc_cnt) {
+        q->stats.max_alloc_cnt = q->stats.alloc_cnt;
+    }
+
+    struct equeue_class_stats *c = equeue_stats_class(q, e->size, true);
+    if (c) {
+        c->alloc_cnt += 1;
+        if (c->alloc_cnt > c->max_alloc_cnt) {
+            c->max_alloc_cnt = c->alloc_cnt;
+        }
+    }
+}
+
+static void equeue_stats_dealloc(equeue_t *q, struct equeue_event *e) {
+    q->stats.alloc_size -= e->size;
+    q->stats.alloc_cnt -= 1;
+
+    struct equeue_class_stats *c = equeue_stats_class(q, e->size, false);
+    if (c) {
+        c->alloc_cnt -= 1;
+    }
+}
+
+static void equeue_stats_fail(equeue_t *q, size_t size) {
+    q->stats.alloc_fail_cnt += 1;
+
+    struct equeue_class_stats *c = equeue_stats_class(q, size, false);
+    if (c) {
+        c->alloc_fail_cnt += 1;
+    }
+}
+#endif
+
+// slice a new chunk out of the slab, must be called with the memlock held
+static struct equeue_event *equeue_mem_slice(equeue_t *q, size_t size) {
+    if (q->slab.size < size) {
+        return 0;
+    }
+
+    struct equeue_event *e = (struct equeue_event *)q->slab.data;
+    q->slab.data += size;
+    q->slab.size -= size;
+    e->size = size;
+    e->id = 1;
+    return e;
+}
+
+// stick chunk into list of chunks, must be called with the memlock held
+static void equeue_mem_insert(equeue_t *q, struct equeue_event *e) {
+    struct equeue_event **p = &q->chunks;
+    while (*p && (*p)->size < e->size) {
+        p = &(*p)->next;
+    }
+
+    if (*p && (*p)->size == e->size) {
+        e->sibling = *p;
+        e->next = (*p)->next;
+    } else {
+        e->sibling = 0;
+        e->next = *p;
+    }
+    *p = e;
+}
+
+static struct equeue_event *equeue_mem_alloc(equeue_t *q, size_t size) {
+    size = equeue_mem_size(size);
 
     equeue_mutex_lock(&q->memlock);
 
@@ -141,46 +288,162 @@ static struct equeue_event *equeue_mem_alloc(equeue_t *q, size_t size) {
                 *p = e->next;
             }
 
+#ifdef EQUEUE_STATS
+            equeue_stats_alloc(q, e);
+#endif
             equeue_mutex_unlock(&q->memlock);
             return e;
         }
     }
 
     // otherwise allocate a new chunk out of the slab
-    if (q->slab.size >= size) {
-        struct equeue_event *e = (struct equeue_event *)q->slab.data;
-        q->slab.data += size;
-        q->slab.size -= size;
-        e->size = size;
-        e->id = 1;
+    struct equeue_event *e = equeue_mem_slice(q, size);
+#ifdef EQUEUE_STATS
+    if (e) {
+        equeue_stats_alloc(q, e);
+    } else {
+        equeue_stats_fail(q, size);
+    }
+#endif
 
-        equeue_mutex_unlock(&q->memlock);
-        return e;
+    equeue_mutex_unlock(&q->memlock);
+    return e;
+}
+
+static void equeue_mem_dealloc(equeue_t *q, struct equeue_event *e) {
+    equeue_mutex_lock(&q->memlock);
+#ifdef EQUEUE_STATS
+    equeue_stats_dealloc(q, e);
+#endif
+    equeue_mem_insert(q, e);
+    equeue_mutex_unlock(&q->memlock);
+}
+
+int equeue_reserve(equeue_t *q, size_t size, unsigned count) {
+    size = equeue_mem_size(size);
+
+    equeue_mutex_lock(&q->memlock);
+#ifdef EQUEUE_STATS
+    equeue_stats_class(q, size, true);
+#endif
+
+    for (unsigned i = 0; i < count; i++) {
+        struct equeue_event *e = equeue_mem_slice(q, size);
+        if (!e) {
+            equeue_mutex_unlock(&q->memlock);
+            return -1;
+        }
+
+        equeue_mem_insert(q, e);
     }
 
     equeue_mutex_unlock(&q->memlock);
     return 0;
 }
 
-static void equeue_mem_dealloc(equeue_t *q, struct equeue_event *e) {
+void equeue_stats(equeue_t *q, struct equeue_stats *stats) {
+    equeue_mutex_lock(&q->memlock);
+#ifdef EQUEUE_STATS
+    *stats = q->stats;
+#else
+    memset(stats, 0, sizeof(*stats));
+#endif
+    stats->buffer_size = (q->slab.data - q->buffer) + q->slab.size;
+    stats->slab_size = q->slab.size;
+
+    stats->free_size = 0;
+    stats->free_cnt = 0;
+    stats->class_cnt = 0;
+    for (struct equeue_event *es = q->chunks; es; es = es->next) {
+        stats->class_cnt += 1;
+        for (struct equeue_event *e = es; e; e = e->sibling) {
+            stats->free_size += e->size;
+            stats->free_cnt += 1;
+        }
+    }
+    equeue_mutex_unlock(&q->memlock);
+}
+
+unsigned equeue_class_stats(equeue_t *q,
+        struct equeue_class_stats *stats, unsigned count) {
     equeue_mutex_lock(&q->memlock);
 
-    // stick chunk into list of chunks
-    struct equeue_event **p = &q->chunks;
-    while (*p && (*p)->size < e->size) {
-        p = &(*p)->next;
+    // one entry per chunk size on the free lists, merged with the tracked
+    // classes when stats are enabled
+    unsigned n = 0;
+#ifdef EQUEUE_STATS
+    for (unsigned i = 0; i < EQUEUE_STATS_CLASSES && n < count; i++) {
+        if (!q->classes[i].size) {
+            break;
+        }
+
+        stats[n] = q->classes[i];
+        stats[n].free_cnt = 0;
+        n++;
     }
+#endif
 
-    if (*p && (*p)->size == e->size) {
-        e->sibling = *p;
-        e->next = (*p)->next;
-    } else {
-        e->sibling = 0;
-        e->next = *p;
+    for (struct equeue_event *es = q->chunks; es; es = es->next) {
+        unsigned i = 0;
+        while (i < n && stats[i].size != es->size) {
+            i++;
+        }
+
+        if (i == n) {
+            if (n == count) {
+                continue;
+            }
+
+            memset(&stats[n], 0, sizeof(stats[n]));
+            stats[n].size = es->size;
+            n++;
+        }
+
+        for (struct equeue_event *e = es; e; e = e->sibling) {
+            stats[i].free_cnt += 1;
+        }
     }
-    *p = e;
 
     equeue_mutex_unlock(&q->memlock);
+    return n;
+}
+
+unsigned equeue_profile(equeue_t *q,
+        struct equeue_profile *profiles, unsigned count) {
+    unsigned n = 0;
+#ifdef EQUEUE_PROFILE
+    equeue_mutex_lock(&q->queuelock);
+    while (n < count && n < EQUEUE_PROFILE_CALLBACKS && q->profiles[n].cb) {
+        profiles[n] = q->profiles[n];
+        n++;
+    }
+    equeue_mutex_unlock(&q->queuelock);
+#else
+    (void)q;
+    (void)profiles;
+    (void)count;
+#endif
+    return n;
+}
+
+unsigned equeue_profile_dropped(equeue_t *q) {
+#ifdef EQUEUE_PROFILE
+    return q->profile_dropped;
+#else
+    (void)q;
+    return 0;
+#endif
+}
+
+void equeue_profile_reset(equeue_t *q) {
+#ifdef EQUEUE_PROFILE
+    equeue_mutex_lock(&q->queuelock);
+    memset(q->profiles, 0, sizeof(q->profiles));
+    q->profile_dropped = 0;
+    equeue_mutex_unlock(&q->queuelock);
+#else
+    (void)q;
+#endif
 }
 
 void *equeue_alloc(equeue_t *q, size_t size) {
@@ -191,7 +454,36 @@ void *equeue_alloc(equeue_t *q, size_t size) {
 
     e->target = 0;
     e->period = -1;
+    e->slack = 0;
+    e->priority = 0;
+    e->flags = 0;
+    e->key = 0;
     e->dtor = 0;
+#ifdef EQUEUE_PROFILE
+    e->tag = 0;
+#endif
+
+    return e + 1;
+}
+
+void *equeue_user_allocated(void *buffer) {
+    // user allocated events never go through the allocator, so the size
+    // instead holds the delay that is applied on every post
+    struct equeue_event *e = (struct equeue_event*)buffer;
+    e->size = 0;
+    e->id = 1;
+    e->generation = 0;
+    e->target = 0;
+    e->period = -1;
+    e->slack = 0;
+    e->priority = 0;
+    e->flags = EQUEUE_EVENT_USER;
+    e->key = 0;
+    e->dtor = 0;
+#ifdef EQUEUE_PROFILE
+    e->tag = 0;
+#endif
+    e->cb = 0;
 
     return e + 1;
 }
@@ -208,13 +500,289 @@ void equeue_dealloc(equeue_t *q, void *p) {
 
 
 // equeue scheduling functions
-static int equeue_enqueue(equeue_t *q, struct equeue_event *e, unsigned tick) {
+#ifdef EQUEUE_TIMER_WHEEL
+#define EQUEUE_WHEEL_MASK (EQUEUE_WHEEL_SLOTS-1)
+
+// find the index of the lowest/highest set bit, a must be non-zero
+static inline unsigned equeue_ctz(uint32_t a) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctz(a);
+#else
+    unsigned n = 0;
+    while (!(a & 1)) {
+        a >>= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+
+static inline unsigned equeue_fls(uint32_t a) {
+#if defined(__GNUC__) || defined(__clang__)
+    return 31 - __builtin_clz(a);
+#else
+    unsigned n = 0;
+    while (a >>= 1) {
+        n++;
+    }
+    return n;
+#endif
+}
+
+// The wheel is made of EQUEUE_WHEEL_LEVELS levels of EQUEUE_WHEEL_SLOTS
+// slots. An event is placed in the level of the highest bit where its
+// target differs from the wheel's tick, so the lowest level holds exact
+// ticks and each slot in a higher level holds a block of ticks that is
+// cascaded into the lower levels once the wheel reaches it. Slots are
+// kept in reverse insertion order, as in the sorted list.
+static void equeue_wheel_insert(equeue_t *q, struct equeue_event *e) {
+    unsigned diff = e->target ^ q->wheel.tick;
+    unsigned level = diff ? equeue_fls(diff) / EQUEUE_WHEEL_BITS : 0;
+    unsigned slot = (e->target >> (level*EQUEUE_WHEEL_BITS))
+            & EQUEUE_WHEEL_MASK;
+
+    struct equeue_event **p = &q->wheel.slots[level][slot];
+    e->next = *p;
+    if (e->next) {
+        e->next->ref = &e->next;
+    }
+
+    e->sibling = 0;
+    *p = e;
+    e->ref = p;
+    q->wheel.occupied[level] |= (uint32_t)1 << slot;
+}
+
+static void equeue_wheel_remove(equeue_t *q, struct equeue_event *e) {
+    *e->ref = e->next;
+    if (e->next) {
+        e->next->ref = e->ref;
+    }
+
+    // clear the slot's occupied bit if this was its last event
+    struct equeue_event **slots = &q->wheel.slots[0][0];
+    if (!*e->ref && e->ref >= slots &&
+        e->ref < slots + EQUEUE_WHEEL_LEVELS*EQUEUE_WHEEL_SLOTS) {
+        unsigned i = e->ref - slots;
+        q->wheel.occupied[i / EQUEUE_WHEEL_SLOTS] &=
+                ~((uint32_t)1 << (i % EQUEUE_WHEEL_SLOTS));
+    }
+}
+
+// take a slot's events in insertion order
+static struct equeue_event *equeue_wheel_take(equeue_t *q,
+        unsigned level, unsigned slot) {
+    struct equeue_event *e = q->wheel.slots[level][slot];
+    q->wheel.slots[level][slot] = 0;
+    q->wheel.occupied[level] &= ~((uint32_t)1 << slot);
+
+    struct equeue_event *prev = 0;
+    while (e) {
+        struct equeue_event *next = e->next;
+        e->next = prev;
+        prev = e;
+        e = next;
+    }
+
+    return prev;
+}
+
+// find the start of the earliest occupied slot of a level, higher levels
+// only contain slots after the wheel's current slot
+//
+// Targets are at most 2^31 ticks after the wheel's tick, so those that wrap
+// around past 2^32 always differ from it in the top bit and land in the top
+// level, in slots before the current one. The top level is searched in
+// order of the ticks after the wheel's tick, so they follow every target
+// that does not wrap around.
+static bool equeue_wheel_slot(equeue_t *q, unsigned level, unsigned *tick) {
+    unsigned t = q->wheel.tick;
+    unsigned shift = level*EQUEUE_WHEEL_BITS;
+    unsigned digit = (t >> shift) & EQUEUE_WHEEL_MASK;
+
+    uint32_t mask = (level == 0 ? ~(uint32_t)0 : ~(uint32_t)1) << digit;
+    uint32_t bits = q->wheel.occupied[level] & mask;
+    if (!bits && level == EQUEUE_WHEEL_LEVELS-1) {
+        bits = q->wheel.occupied[level];
+    }
+
+    if (!bits) {
+        return false;
+    }
+
+    unsigned block = shift + EQUEUE_WHEEL_BITS;
+    unsigned base = (block < 32) ? t & ~((1u << block)-1) : 0;
+    *tick = base | (equeue_ctz(bits) << shift);
+    return true;
+}
+
+// find the earliest tick that may have pending events, this is exact for
+// the lowest level and the start of the slot's block for higher levels
+static bool equeue_wheel_next(equeue_t *q, unsigned *tick, unsigned *level) {
+    for (unsigned l = 0; l < EQUEUE_WHEEL_LEVELS; l++) {
+        if (equeue_wheel_slot(q, l, tick)) {
+            *level = l;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// cascade the slots the wheel has just entered into the lower levels
+static void equeue_wheel_cascade(equeue_t *q) {
+    unsigned t = q->wheel.tick;
+    for (unsigned l = 1; l < EQUEUE_WHEEL_LEVELS; l++) {
+        if (t & ((1u << (l*EQUEUE_WHEEL_BITS))-1)) {
+            break;
+        }
+
+        unsigned slot = (t >> (l*EQUEUE_WHEEL_BITS)) & EQUEUE_WHEEL_MASK;
+        struct equeue_event *e = equeue_wheel_take(q, l, slot);
+        while (e) {
+            struct equeue_event *next = e->next;
+            equeue_wheel_insert(q, e);
+            e = next;
+        }
+    }
+}
+
+// find the tick the dispatch loop must wake up at, which is the earliest
+// target plus slack of any pending event, must be called with the queuelock
+// held
+//
+// Events in the current block are scanned until a slot starts after the
+// deadline found so far. Events in higher levels come after the current
+// block, so only the earliest occupied slot in the higher levels needs to be
+// scanned, with the end of that slot bounding every later event.
+static bool equeue_deadline(equeue_t *q, unsigned *deadline) {
+    unsigned t = q->wheel.tick;
+    unsigned base = t & ~EQUEUE_WHEEL_MASK;
+    uint32_t bits = q->wheel.occupied[0] &
+            (~(uint32_t)0 << (t & EQUEUE_WHEEL_MASK));
+
+    bool found = false;
+    unsigned d = 0;
+    while (bits) {
+        unsigned slot = equeue_ctz(bits);
+        bits &= bits - 1;
+        if (found && equeue_tickdiff(base | slot, d) >= 0) {
+            break;
+        }
+
+        for (struct equeue_event *e = q->wheel.slots[0][slot]; e;
+                e = e->next) {
+            unsigned latest = e->target + e->slack;
+            if (!found || equeue_tickdiff(latest, d) < 0) {
+                d = latest;
+                found = true;
+            }
+        }
+    }
+
+    unsigned next;
+    unsigned level;
+    for (level = 1; level < EQUEUE_WHEEL_LEVELS; level++) {
+        if (equeue_wheel_slot(q, level, &next)) {
+            break;
+        }
+    }
+
+    if (level < EQUEUE_WHEEL_LEVELS &&
+            (!found || equeue_tickdiff(next, d) < 0)) {
+        unsigned slot = (next >> (level*EQUEUE_WHEEL_BITS))
+                & EQUEUE_WHEEL_MASK;
+        unsigned end = next + (1u << (level*EQUEUE_WHEEL_BITS));
+        for (struct equeue_event *e = q->wheel.slots[level][slot]; e;
+                e = e->next) {
+            unsigned latest = e->target + e->slack;
+            if (equeue_tickdiff(latest, end) > 0) {
+                latest = end;
+            }
+
+            if (!found || equeue_tickdiff(latest, d) < 0) {
+                d = latest;
+                found = true;
+            }
+        }
+    }
+
+    *deadline = d;
+    return found;
+}
+
+// insert an event into the queue, must be called with the queuelock held
+static int equeue_enqueue_locked(equeue_t *q, struct equeue_event *e,
+        unsigned tick) {
     // setup event and hash local id with buffer offset for unique id
     int id = (e->id << q->npw2) | ((unsigned char *)e - q->buffer);
     e->target = tick + equeue_clampdiff(e->target, tick);
     e->generation = q->generation;
 
-    equeue_mutex_lock(&q->queuelock);
+    // events can not be placed behind the wheel
+    if (equeue_tickdiff(e->target, q->wheel.tick) < 0) {
+        e->target = q->wheel.tick;
+    }
+
+    // only backgrounded queues need to know if this moves the deadline
+    bool first = false;
+    if (q->background.update && q->background.active) {
+        unsigned deadline;
+        first = !equeue_deadline(q, &deadline) ||
+                equeue_tickdiff(e->target + e->slack, deadline) < 0;
+    }
+
+    equeue_wheel_insert(q, e);
+
+    // notify background timer
+    if (first) {
+        q->background.update(q->background.timer,
+                equeue_clampdiff(e->target + e->slack, tick));
+    }
+
+    return id;
+}
+#else
+// find the tick the dispatch loop must wake up at, which is the earliest
+// target plus slack of any pending event, must be called with the queuelock
+// held
+static bool equeue_deadline(equeue_t *q, unsigned *deadline) {
+    bool found = false;
+    unsigned d = 0;
+    for (struct equeue_event *es = q->queue; es; es = es->next) {
+        // events are sorted, so later events can't have an earlier deadline
+        if (found && equeue_tickdiff(es->target, d) >= 0) {
+            break;
+        }
+
+        for (struct equeue_event *e = es; e; e = e->sibling) {
+            unsigned latest = e->target + e->slack;
+            if (!found || equeue_tickdiff(latest, d) < 0) {
+                d = latest;
+                found = true;
+            }
+        }
+    }
+
+    *deadline = d;
+    return found;
+}
+
+// insert an event into the queue, must be called with the queuelock held
+static int equeue_enqueue_locked(equeue_t *q, struct equeue_event *e,
+        unsigned tick) {
+    // setup event and hash local id with buffer offset for unique id
+    int id = (e->id << q->npw2) | ((unsigned char *)e - q->buffer);
+    e->target = tick + equeue_clampdiff(e->target, tick);
+    e->generation = q->generation;
+
+    // only backgrounded queues need to know if this moves the deadline
+    bool first = false;
+    if (q->background.update && q->background.active) {
+        unsigned deadline;
+        first = !equeue_deadline(q, &deadline) ||
+                equeue_tickdiff(e->target + e->slack, deadline) < 0;
+    }
 
     // find the event slot
     struct equeue_event **p = &q->queue;
@@ -230,6 +798,7 @@ static int equeue_enqueue(equeue_t *q, struct equeue_event *e, unsigned tick) {
         }
 
         e->sibling = *p;
+        e->sibling->next = 0;
         e->sibling->ref = &e->sibling;
     } else {
         e->next = *p;
@@ -244,39 +813,45 @@ static int equeue_enqueue(equeue_t *q, struct equeue_event *e, unsigned tick) {
     e->ref = p;
 
     // notify background timer
-    if ((q->background.update && q->background.active) &&
-        (q->queue == e && !e->sibling)) {
+    if (first) {
         q->background.update(q->background.timer,
-                equeue_clampdiff(e->target, tick));
+                equeue_clampdiff(e->target + e->slack, tick));
     }
 
-    equeue_mutex_unlock(&q->queuelock);
-
     return id;
 }
 
-static struct equeue_event *equeue_unqueue(equeue_t *q, int id) {
-    // decode event from unique id and check that the local id matches
-    struct equeue_event *e = (struct equeue_event *)
-            &q->buffer[id & ((1 << q->npw2)-1)];
+#endif
 
+static int equeue_enqueue(equeue_t *q, struct equeue_event *e, unsigned tick) {
     equeue_mutex_lock(&q->queuelock);
-    if (e->id != id >> q->npw2) {
-        equeue_mutex_unlock(&q->queuelock);
-        return 0;
-    }
+    int id = equeue_enqueue_locked(q, e, tick);
+    equeue_mutex_unlock(&q->queuelock);
+    return id;
+}
 
+// clear an event and remove it from the queue if it is not already
+// in-flight, must be called with the queuelock held
+static bool equeue_unqueue_event(equeue_t *q, struct equeue_event *e) {
     // clear the event and check if already in-flight
     e->cb = 0;
     e->period = -1;
 
+    // immediate events can't be removed from the lock-free list, but
+    // are skipped and deallocated by the dispatch loop once cleared
+    if (!e->ref) {
+        return false;
+    }
+
     int diff = equeue_tickdiff(e->target, q->tick);
     if (diff < 0 || (diff == 0 && e->generation != q->generation)) {
-        equeue_mutex_unlock(&q->queuelock);
-        return 0;
+        return false;
     }
 
     // disentangle from queue
+#ifdef EQUEUE_TIMER_WHEEL
+    equeue_wheel_remove(q, e);
+#else
     if (e->sibling) {
         e->sibling->next = e->next;
         if (e->sibling->next) {
@@ -291,6 +866,21 @@ static struct equeue_event *equeue_unqueue(equeue_t *q, int id) {
             e->next->ref = e->ref;
         }
     }
+#endif
+
+    return true;
+}
+
+static struct equeue_event *equeue_unqueue(equeue_t *q, int id) {
+    // decode event from unique id and check that the local id matches
+    struct equeue_event *e = (struct equeue_event *)
+            &q->buffer[id & ((1 << q->npw2)-1)];
+
+    equeue_mutex_lock(&q->queuelock);
+    if (e->id != id >> q->npw2 || !equeue_unqueue_event(q, e)) {
+        equeue_mutex_unlock(&q->queuelock);
+        return 0;
+    }
 
     equeue_incid(q, e);
     equeue_mutex_unlock(&q->queuelock);
@@ -298,15 +888,70 @@ static struct equeue_event *equeue_unqueue(equeue_t *q, int id) {
     return e;
 }
 
-static struct equeue_event *equeue_dequeue(equeue_t *q, unsigned target) {
-    equeue_mutex_lock(&q->queuelock);
+// take all immediate events in insertion order, this is the only consumer
+// of the lock-free list so a single atomic swap is enough
+static struct equeue_event *equeue_dequeue_immediate(equeue_t *q,
+        unsigned target) {
+    struct equeue_event *e = q->immediate;
+    while (e && !equeue_atomic_cas((void **)&q->immediate, e, 0)) {
+        e = q->immediate;
+    }
+
+    struct equeue_event *prev = 0;
+    while (e) {
+        struct equeue_event *next = e->next;
+        e->target = target;
+        e->generation = q->generation;
+        e->next = prev;
+        prev = e;
+        e = next;
+    }
+
+    return prev;
+}
 
+// collect expired events, must be called with the queuelock held so a
+// cancelled event can always be found on one of the queue's lists
+static EQUEUE_RAMFUNC struct equeue_event *equeue_dequeue(equeue_t *q, unsigned target) {
     // find all expired events and mark a new generation
     q->generation += 1;
     if (equeue_tickdiff(q->tick, target) <= 0) {
         q->tick = target;
     }
 
+#ifdef EQUEUE_TIMER_WHEEL
+    // advance the wheel, skipping over empty slots and cascading the
+    // higher levels as they are reached
+    struct equeue_event *head = 0;
+    struct equeue_event **tail = &head;
+    while (1) {
+        unsigned next;
+        unsigned level;
+        if (!equeue_wheel_next(q, &next, &level) ||
+            equeue_tickdiff(next, target) > 0) {
+            break;
+        }
+
+        q->wheel.tick = next;
+        equeue_wheel_cascade(q);
+
+        if (level == 0) {
+            *tail = equeue_wheel_take(q, 0, next & EQUEUE_WHEEL_MASK);
+            while (*tail) {
+                tail = &(*tail)->next;
+            }
+        }
+    }
+
+    if (equeue_tickdiff(target, q->wheel.tick) > 0) {
+        q->wheel.tick = target;
+        equeue_wheel_cascade(q);
+    }
+
+    // immediate events follow any expired timed events
+    *tail = equeue_dequeue_immediate(q, target);
+    return head;
+#else
     struct equeue_event *head = q->queue;
     struct equeue_event **p = &head;
     while (*p && equeue_tickdiff((*p)->target, target) <= 0) {
@@ -320,8 +965,6 @@ static struct equeue_event *equeue_dequeue(equeue_t *q, unsigned target) {
 
     *p = 0;
 
-    equeue_mutex_unlock(&q->queuelock);
-
     // reverse and flatten each slot to match insertion order
     struct equeue_event **tail = &head;
     struct equeue_event *ess = head;
@@ -339,13 +982,144 @@ static struct equeue_event *equeue_dequeue(equeue_t *q, unsigned target) {
         tail = &es->next;
     }
 
+    // immediate events follow any expired timed events
+    *tail = equeue_dequeue_immediate(q, target);
     return head;
+#endif
+}
+
+// Expired events are moved onto the ready list of their priority band,
+// where each dispatching thread takes one event at a time from the highest
+// band with events. An event with a serial key is skipped while another
+// event with the same key is running, keeping events with the same key in
+// order even with multiple dispatching threads. Must be called with the
+// queuelock held.
+static void equeue_ready_push(equeue_t *q, struct equeue_event *es) {
+    while (es) {
+        struct equeue_event *e = es;
+        es = e->next;
+
+        e->next = 0;
+        *q->ready_tail[e->priority] = e;
+        q->ready_tail[e->priority] = &e->next;
+    }
+}
+
+static bool equeue_ready_any(equeue_t *q) {
+    for (unsigned i = 0; i < EQUEUE_PRIORITIES; i++) {
+        if (q->ready[i]) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// find the first event in a band that can run, must be called with the
+// queuelock held
+static struct equeue_event *equeue_ready_take(equeue_t *q, unsigned band) {
+    for (struct equeue_event **p = &q->ready[band]; *p; p = &(*p)->next) {
+        struct equeue_event *e = *p;
+
+        // running events with a key are linked through their sibling
+        if (e->key) {
+            struct equeue_event *r = q->running;
+            while (r && r->key != e->key) {
+                r = r->sibling;
+            }
+
+            if (r) {
+                continue;
+            }
+
+            e->sibling = q->running;
+            q->running = e;
+        }
+
+        *p = e->next;
+        if (!*p) {
+            q->ready_tail[band] = p;
+        }
+
+        return e;
+    }
+
+    return 0;
+}
+
+static struct equeue_event *equeue_ready_pop(equeue_t *q) {
+    equeue_mutex_lock(&q->queuelock);
+    struct equeue_event *e = 0;
+    for (unsigned i = EQUEUE_PRIORITIES; !e && i-- > 0;) {
+        e = equeue_ready_take(q, i);
+    }
+
+    // hand off any remaining events to other dispatching threads
+    bool more = e && q->dispatchers > 1 && equeue_ready_any(q);
+    equeue_mutex_unlock(&q->queuelock);
+
+    if (more) {
+        equeue_sema_signal(&q->eventsema);
+    }
+
+    return e;
+}
+
+static void equeue_ready_release(equeue_t *q, struct equeue_event *e) {
+    equeue_mutex_lock(&q->queuelock);
+    struct equeue_event **p = &q->running;
+    while (*p != e) {
+        p = &(*p)->sibling;
+    }
+
+    *p = e->sibling;
+    equeue_mutex_unlock(&q->queuelock);
+}
+
+// push a chain of zero-delay events onto the lock-free list, the chain is
+// linked newest first from head to tail
+static void equeue_push_immediate(equeue_t *q,
+        struct equeue_event *head, struct equeue_event *tail) {
+    struct equeue_event *next;
+    do {
+        next = q->immediate;
+        tail->next = next;
+    } while (!equeue_atomic_cas((void **)&q->immediate, next, head));
+}
+
+// post a zero-delay event onto the lock-free list, a null ref marks the
+// event as immediate for equeue_cancel
+static int equeue_post_immediate(equeue_t *q, struct equeue_event *e) {
+    int id = (e->id << q->npw2) | ((unsigned char *)e - q->buffer);
+    e->ref = 0;
+    equeue_push_immediate(q, e, e);
+
+    // backgrounded queues still need to update their timer
+    if (q->background.update) {
+        equeue_mutex_lock(&q->queuelock);
+        if (q->background.update && q->background.active) {
+            q->background.update(q->background.timer, 0);
+        }
+        equeue_mutex_unlock(&q->queuelock);
+    }
+
+    return id;
 }
 
 int equeue_post(equeue_t *q, void (*cb)(void*), void *p) {
     struct equeue_event *e = (struct equeue_event*)p - 1;
-    unsigned tick = equeue_tick();
     e->cb = cb;
+#ifdef EQUEUE_PROFILE
+    e->due_us = equeue_tick_us() + e->target*1000;
+#endif
+
+    if (!e->target) {
+        int id = equeue_post_immediate(q, e);
+        equeue_sema_signal(&q->eventsema);
+        return id;
+    }
+
+    unsigned tick = equeue_tick();
     e->target = tick + e->target;
 
     int id = equeue_enqueue(q, e, tick);
@@ -353,6 +1127,153 @@ int equeue_post(equeue_t *q, void (*cb)(void*), void *p) {
     return id;
 }
 
+void equeue_post_batch(equeue_t *q, void (*const *cbs)(void *),
+        void *const *events, int *ids, unsigned count) {
+    // timed events and the background timer share a single lock
+    bool timed = false;
+    for (unsigned i = 0; i < count; i++) {
+        if (((struct equeue_event*)events[i] - 1)->target) {
+            timed = true;
+            break;
+        }
+    }
+
+    bool locked = timed || q->background.update;
+    if (locked) {
+        equeue_mutex_lock(&q->queuelock);
+    }
+
+    // chain the zero-delay events so they are pushed with a single atomic
+    // operation, newest first like the lock-free list
+    unsigned tick = equeue_tick();
+    struct equeue_event *head = 0;
+    struct equeue_event *tail = 0;
+    for (unsigned i = 0; i < count; i++) {
+        struct equeue_event *e = (struct equeue_event*)events[i] - 1;
+        e->cb = cbs[i];
+#ifdef EQUEUE_PROFILE
+        e->due_us = equeue_tick_us() + e->target*1000;
+#endif
+
+        int id;
+        if (e->target) {
+            e->target = tick + e->target;
+            id = equeue_enqueue_locked(q, e, tick);
+        } else {
+            id = (e->id << q->npw2) | ((unsigned char *)e - q->buffer);
+            e->ref = 0;
+            e->next = head;
+            head = e;
+            if (!tail) {
+                tail = e;
+            }
+        }
+
+        if (ids) {
+            ids[i] = id;
+        }
+    }
+
+    if (head) {
+        equeue_push_immediate(q, head, tail);
+    }
+
+    if (locked) {
+        if (head && q->background.update && q->background.active) {
+            q->background.update(q->background.timer, 0);
+        }
+        equeue_mutex_unlock(&q->queuelock);
+    }
+
+    equeue_sema_signal(&q->eventsema);
+}
+
+// remove an expired event that has not been dispatched yet, must be called
+// with the queuelock held
+static bool equeue_ready_remove(equeue_t *q, struct equeue_event *e) {
+    for (struct equeue_event **p = &q->ready[e->priority]; *p;
+            p = &(*p)->next) {
+        if (*p == e) {
+            *p = e->next;
+            if (!*p) {
+                q->ready_tail[e->priority] = p;
+            }
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// remove an event from the lock-free list, must be called with the
+// queuelock held so the dispatch loop can't take the list meanwhile,
+// producers only ever replace the head
+static bool equeue_immediate_remove(equeue_t *q, struct equeue_event *e) {
+    if (q->immediate == e &&
+            equeue_atomic_cas((void **)&q->immediate, e, e->next)) {
+        return true;
+    }
+
+    for (struct equeue_event *p = q->immediate; p; p = p->next) {
+        if (p->next == e) {
+            p->next = e->next;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+int equeue_post_user_allocated(equeue_t *q, void (*cb)(void*), void *p) {
+    struct equeue_event *e = (struct equeue_event*)p - 1;
+
+    // an event can only be on the queue once
+    equeue_mutex_lock(&q->queuelock);
+    if (e->flags & EQUEUE_EVENT_PENDING) {
+        equeue_mutex_unlock(&q->queuelock);
+        return -1;
+    }
+    e->flags |= EQUEUE_EVENT_PENDING;
+    e->target = e->size;
+    equeue_mutex_unlock(&q->queuelock);
+
+    equeue_post(q, cb, p);
+    return 0;
+}
+
+bool equeue_cancel_user_allocated(equeue_t *q, void *p) {
+    struct equeue_event *e = (struct equeue_event*)p - 1;
+
+    equeue_mutex_lock(&q->queuelock);
+    if (!(e->flags & EQUEUE_EVENT_PENDING)) {
+        equeue_mutex_unlock(&q->queuelock);
+        return false;
+    }
+
+    // keep the period for the next post, expired events are unlinked from
+    // the lists they wait on, and only an event that is being dispatched is
+    // marked cancelled so the dispatch loop doesn't repeat it
+    int period = e->period;
+    bool removed = equeue_unqueue_event(q, e) ||
+            equeue_ready_remove(q, e) ||
+            (!e->ref && equeue_immediate_remove(q, e));
+    e->period = period;
+    if (removed) {
+        e->flags &= ~EQUEUE_EVENT_PENDING;
+    } else {
+        e->flags |= EQUEUE_EVENT_CANCELLED;
+    }
+    equeue_mutex_unlock(&q->queuelock);
+
+    return removed;
+}
+
+bool equeue_user_allocated_pending(equeue_t *q, void *p) {
+    struct equeue_event *e = (struct equeue_event*)p - 1;
+    (void)q;
+    return e->flags & EQUEUE_EVENT_PENDING;
+}
+
 void equeue_cancel(equeue_t *q, int id) {
     if (!id) {
         return;
@@ -371,30 +1292,117 @@ void equeue_break(equeue_t *q) {
     equeue_sema_signal(&q->eventsema);
 }
 
-void equeue_dispatch(equeue_t *q, int ms) {
+// simple callback events, the profiler records these by their callback
+struct ecallback {
+    void (*cb)(void*);
+    void *data;
+};
+
+static void ecallback_dispatch(void *p) {
+    struct ecallback *e = (struct ecallback*)p;
+    e->cb(e->data);
+}
+
+#ifdef EQUEUE_PROFILE
+// profile histograms grow by a factor of 4 per bucket, starting at 16us
+static unsigned equeue_profile_bucket(unsigned us) {
+    unsigned b = 0;
+    for (us >>= 4; us && b < EQUEUE_PROFILE_BUCKETS-1; us >>= 2) {
+        b++;
+    }
+
+    return b;
+}
+
+static void equeue_profile_record(equeue_t *q, void (*cb)(void *),
+        const void *tag, unsigned due, unsigned start, unsigned end) {
+    unsigned latency = equeue_clampdiff(start, due);
+    unsigned duration = end - start;
+
+    equeue_mutex_lock(&q->queuelock);
+    struct equeue_profile *p = 0;
+    for (unsigned i = 0; i < EQUEUE_PROFILE_CALLBACKS; i++) {
+        if ((q->profiles[i].cb == cb && q->profiles[i].tag == tag) ||
+                !q->profiles[i].cb) {
+            p = &q->profiles[i];
+            break;
+        }
+    }
+
+    if (!p) {
+        q->profile_dropped += 1;
+        equeue_mutex_unlock(&q->queuelock);
+        return;
+    }
+
+    p->cb = cb;
+    p->tag = tag;
+    p->count += 1;
+    p->latency_total += latency;
+    if (latency > p->latency_max) {
+        p->latency_max = latency;
+    }
+    p->latency_hist[equeue_profile_bucket(latency)] += 1;
+    p->duration_total += duration;
+    if (duration > p->duration_max) {
+        p->duration_max = duration;
+    }
+    p->duration_hist[equeue_profile_bucket(duration)] += 1;
+    equeue_mutex_unlock(&q->queuelock);
+}
+#endif
+
+EQUEUE_RAMFUNC void equeue_dispatch(equeue_t *q, int ms) {
     unsigned tick = equeue_tick();
     unsigned timeout = tick + ms;
     q->background.active = false;
 
+    equeue_mutex_lock(&q->queuelock);
+    q->dispatchers += 1;
+    equeue_mutex_unlock(&q->queuelock);
+
     while (1) {
         // collect all the available events and next deadline
-        struct equeue_event *es = equeue_dequeue(q, tick);
+        equeue_mutex_lock(&q->queuelock);
+        equeue_ready_push(q, equeue_dequeue(q, tick));
+        equeue_mutex_unlock(&q->queuelock);
 
         // dispatch events
-        while (es) {
-            struct equeue_event *e = es;
-            es = e->next;
-
+        struct equeue_event *e;
+        while ((e = equeue_ready_pop(q))) {
             // actually dispatch the callbacks
             void (*cb)(void *) = e->cb;
             if (cb) {
+#ifdef EQUEUE_PROFILE
+                void (*key)(void *) = (cb == ecallback_dispatch) ?
+                        ((struct ecallback*)(e + 1))->cb : cb;
+                const void *tag = e->tag;
+                unsigned due = e->due_us;
+                unsigned start = equeue_tick_us();
                 cb(e + 1);
+                equeue_profile_record(q, key, tag, due, start,
+                        equeue_tick_us());
+#else
+                cb(e + 1);
+#endif
+            }
+
+            if (e->key) {
+                equeue_ready_release(q, e);
             }
 
             // reenqueue periodic events or deallocate
-            if (e->period >= 0) {
+            if (e->period >= 0 && !(e->flags & EQUEUE_EVENT_CANCELLED)) {
                 e->target += e->period;
+#ifdef EQUEUE_PROFILE
+                e->due_us += e->period*1000;
+#endif
                 equeue_enqueue(q, e, equeue_tick());
+            } else if (e->flags & EQUEUE_EVENT_USER) {
+                // the owner may reuse the event as soon as it is released
+                equeue_mutex_lock(&q->queuelock);
+                e->flags &= ~(EQUEUE_EVENT_PENDING | EQUEUE_EVENT_CANCELLED);
+                equeue_mutex_unlock(&q->queuelock);
             } else {
                 equeue_incid(q, e);
                 equeue_dealloc(q, e+1);
@@ -411,21 +1419,28 @@ void equeue_dispatch(equeue_t *q, int ms) {
                 // update background timer if necessary
                 if (q->background.update) {
                     equeue_mutex_lock(&q->queuelock);
-                    if (q->background.update && q->queue) {
+                    unsigned target;
+                    if (q->background.update && q->immediate) {
+                        q->background.update(q->background.timer, 0);
+                    } else if (q->background.update &&
+                            equeue_deadline(q, &target)) {
                         q->background.update(q->background.timer,
-                                equeue_clampdiff(q->queue->target, tick));
+                                equeue_clampdiff(target, tick));
                     }
                     q->background.active = true;
                     equeue_mutex_unlock(&q->queuelock);
                 }
-                return;
+                break;
             }
         }
 
         // find closest deadline
         equeue_mutex_lock(&q->queuelock);
-        if (q->queue) {
-            int diff = equeue_clampdiff(q->queue->target, tick);
+        unsigned target;
+        if (q->immediate) {
+            deadline = 0;
+        } else if (equeue_deadline(q, &target)) {
+            int diff = equeue_clampdiff(target, tick);
             if ((unsigned)diff < (unsigned)deadline) {
                 deadline = diff;
             }
@@ -441,7 +1456,7 @@ void equeue_dispatch(equeue_t *q, int ms) {
             if (q->breaks > 0) {
                 q->breaks--;
                 equeue_mutex_unlock(&q->queuelock);
-                return;
+                break;
             }
             equeue_mutex_unlock(&q->queuelock);
         }
@@ -449,13 +1464,21 @@ void equeue_dispatch(equeue_t *q, int ms) {
         // update tick for next iteration
         tick = equeue_tick();
     }
+
+    equeue_mutex_lock(&q->queuelock);
+    q->dispatchers -= 1;
+    equeue_mutex_unlock(&q->queuelock);
 }
 
 
 // event functions
 void equeue_event_delay(void *p, int ms) {
     struct equeue_event *e = (struct equeue_event*)p - 1;
-    e->target = ms;
+    if (e->flags & EQUEUE_EVENT_USER) {
+        e->size = ms;
+    } else {
+        e->target = ms;
+    }
 }
 
 void equeue_event_period(void *p, int ms) {
@@ -463,23 +1486,39 @@ void equeue_event_period(void *p, int ms) {
     e->period = ms;
 }
 
-void equeue_event_dtor(void *p, void (*dtor)(void *)) {
+void equeue_event_slack(void *p, int ms) {
     struct equeue_event *e = (struct equeue_event*)p - 1;
-    e->dtor = dtor;
+    e->slack = ms > 0 ? ms : 0;
 }
 
+void equeue_event_priority(void *p, unsigned priority) {
+    struct equeue_event *e = (struct equeue_event*)p - 1;
+    e->priority = priority < EQUEUE_PRIORITIES ?
+            priority : EQUEUE_PRIORITIES-1;
+}
 
-// simple callbacks 
-struct ecallback {
-    void (*cb)(void*);
-    void *data;
-};
+void equeue_event_key(void *p, unsigned key) {
+    struct equeue_event *e = (struct equeue_event*)p - 1;
+    e->key = key;
+}
 
-static void ecallback_dispatch(void *p) {
-    struct ecallback *e = (struct ecallback*)p;
-    e->cb(e->data);
+void equeue_event_dtor(void *p, void (*dtor)(void *)) {
+    struct equeue_event *e = (struct equeue_event*)p - 1;
+    e->dtor = dtor;
 }
 
+void equeue_event_tag(void *p, const void *tag) {
+#ifdef EQUEUE_PROFILE
+    struct equeue_event *e = (struct equeue_event*)p - 1;
+    e->tag = tag;
+#else
+    (void)p;
+    (void)tag;
+#endif
+}
+
+
+// simple callbacks 
 int equeue_call(equeue_t *q, void (*cb)(void*), void *data) {
     struct ecallback *e = equeue_alloc(q, sizeof(struct ecallback));
     if (!e) {
@@ -528,9 +1567,12 @@ void equeue_background(equeue_t *q,
     q->background.update = update;
     q->background.timer = timer;
 
-    if (q->background.update && q->queue) {
+    unsigned target;
+    if (q->background.update && q->immediate) {
+        q->background.update(q->background.timer, 0);
+    } else if (q->background.update && equeue_deadline(q, &target)) {
         q->background.update(q->background.timer,
-                equeue_clampdiff(q->queue->target, equeue_tick()));
+                equeue_clampdiff(target, equeue_tick()));
     }
     q->background.active = true;
     equeue_mutex_unlock(&q->queuelock);
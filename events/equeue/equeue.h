@@ -32,6 +32,74 @@ extern "C" {
 #include <stdint.h>
 
 
+// Timer wheel backend
+//
+// By default pending events are kept in a sorted list, so posting a timed
+// event is linear in the number of pending events. Defining
+// EQUEUE_TIMER_WHEEL replaces the list with a hierarchical timer wheel, which
+// makes posting and cancelling events constant-time regardless of how many
+// events are pending, at the cost of a larger equeue_t.
+#if !defined(EQUEUE_TIMER_WHEEL) && defined(MBED_CONF_EVENTS_USE_TIMER_WHEEL)
+#if MBED_CONF_EVENTS_USE_TIMER_WHEEL
+#define EQUEUE_TIMER_WHEEL
+#endif
+#endif
+
+#ifdef EQUEUE_TIMER_WHEEL
+#define EQUEUE_WHEEL_BITS 5
+#define EQUEUE_WHEEL_SLOTS (1 << EQUEUE_WHEEL_BITS)
+#define EQUEUE_WHEEL_LEVELS ((32 + EQUEUE_WHEEL_BITS-1) / EQUEUE_WHEEL_BITS)
+#endif
+
+// Allocator statistics
+//
+// Defining EQUEUE_STATS enables tracking of allocation counts, high-water
+// marks and allocation failures in equeue_stats and equeue_class_stats. The
+// per size class counters are tracked for the first EQUEUE_STATS_CLASSES
+// chunk sizes used by the queue.
+#if !defined(EQUEUE_STATS) && defined(MBED_CONF_EVENTS_STATS_ENABLED)
+#if MBED_CONF_EVENTS_STATS_ENABLED
+#define EQUEUE_STATS
+#endif
+#endif
+
+#if defined(EQUEUE_STATS) && !defined(EQUEUE_STATS_CLASSES)
+#define EQUEUE_STATS_CLASSES 8
+#endif
+
+// Dispatch profiling
+//
+// Defining EQUEUE_PROFILE records, for the first EQUEUE_PROFILE_CALLBACKS
+// callbacks dispatched by the queue, how late each callback started after
+// its event became due and how long it ran, using equeue_tick_us. Both are
+// kept as a count, total, maximum and a histogram of EQUEUE_PROFILE_BUCKETS
+// buckets, where bucket i counts times below 16 << 2*i microseconds and the
+// last bucket counts everything longer.
+#if !defined(EQUEUE_PROFILE) && defined(MBED_CONF_EVENTS_PROFILE_ENABLED)
+#if MBED_CONF_EVENTS_PROFILE_ENABLED
+#define EQUEUE_PROFILE
+#endif
+#endif
+
+#if defined(EQUEUE_PROFILE) && !defined(EQUEUE_PROFILE_CALLBACKS)
+#define EQUEUE_PROFILE_CALLBACKS 8
+#endif
+
+#define EQUEUE_PROFILE_BUCKETS 8
+
+// Priority bands
+//
+// Events that are due are dispatched from the highest priority band first,
+// and in deadline order within a band. EQUEUE_PRIORITIES sets the number of
+// bands, events default to band 0, the lowest priority.
+#if !defined(EQUEUE_PRIORITIES) && defined(MBED_CONF_EVENTS_PRIORITY_LEVELS)
+#define EQUEUE_PRIORITIES MBED_CONF_EVENTS_PRIORITY_LEVELS
+#endif
+
+#ifndef EQUEUE_PRIORITIES
+#define EQUEUE_PRIORITIES 4
+#endif
+
 // The minimum size of an event
 // This size is guaranteed to fit events created by event_call
 #define EQUEUE_EVENT_SIZE (sizeof(struct equeue_event) + 2*sizeof(void*))
@@ -41,6 +109,9 @@ struct equeue_event {
     unsigned size;
     uint8_t id;
     uint8_t generation;
+    uint8_t priority;
+    uint8_t flags;
+    unsigned key;
 
     struct equeue_event *next;
     struct equeue_event *sibling;
@@ -48,15 +119,67 @@ struct equeue_event {
 
     unsigned target;
     int period;
+    unsigned slack;
+#ifdef EQUEUE_PROFILE
+    unsigned due_us;
+    const void *tag;
+#endif
     void (*dtor)(void *);
 
     void (*cb)(void *);
     // data follows
 };
 
+// Allocator statistics structures
+struct equeue_stats {
+    size_t buffer_size;         // Size of the event buffer in bytes
+    size_t slab_size;           // Bytes not yet sliced into chunks
+    size_t free_size;           // Bytes in chunks on the free lists
+    unsigned free_cnt;          // Number of chunks on the free lists
+    unsigned class_cnt;         // Number of chunk sizes on the free lists
+    size_t alloc_size;          // Bytes in allocated events
+    size_t max_alloc_size;      // High-water mark of alloc_size
+    unsigned alloc_cnt;         // Number of allocated events
+    unsigned max_alloc_cnt;     // High-water mark of alloc_cnt
+    unsigned alloc_fail_cnt;    // Number of failed allocations
+};
+
+struct equeue_class_stats {
+    size_t size;                // Chunk size including event overhead
+    unsigned free_cnt;          // Number of chunks on the free list
+    unsigned alloc_cnt;         // Number of allocated chunks
+    unsigned max_alloc_cnt;     // High-water mark of alloc_cnt
+    unsigned alloc_fail_cnt;    // Failed allocations of this size
+};
+
+struct equeue_profile {
+    void (*cb)(void *);         // Callback the samples belong to
+    const void *tag;            // Profile tag of the events, if any
+    unsigned count;             // Number of dispatches
+    uint64_t latency_total;     // Total microseconds from due to start
+    unsigned latency_max;       // Longest microseconds from due to start
+    uint64_t duration_total;    // Total microseconds spent in the callback
+    unsigned duration_max;      // Longest microseconds spent in the callback
+    unsigned latency_hist[EQUEUE_PROFILE_BUCKETS];
+    unsigned duration_hist[EQUEUE_PROFILE_BUCKETS];
+};
+
 // Event queue structure
 typedef struct equeue {
+#ifdef EQUEUE_TIMER_WHEEL
+    struct equeue_wheel {
+        unsigned tick;
+        uint32_t occupied[EQUEUE_WHEEL_LEVELS];
+        struct equeue_event *slots[EQUEUE_WHEEL_LEVELS][EQUEUE_WHEEL_SLOTS];
+    } wheel;
+#else
     struct equeue_event *queue;
+#endif
+    struct equeue_event *volatile immediate;
+    struct equeue_event *ready[EQUEUE_PRIORITIES];
+    struct equeue_event **ready_tail[EQUEUE_PRIORITIES];
+    struct equeue_event *running;
+    unsigned dispatchers;
     unsigned tick;
     unsigned breaks;
     uint8_t generation;
@@ -70,6 +193,14 @@ typedef struct equeue {
         size_t size;
         unsigned char *data;
     } slab;
+#ifdef EQUEUE_PROFILE
+    struct equeue_profile profiles[EQUEUE_PROFILE_CALLBACKS];
+    unsigned profile_dropped;
+#endif
+#ifdef EQUEUE_STATS
+    struct equeue_stats stats;
+    struct equeue_class_stats classes[EQUEUE_STATS_CLASSES];
+#endif
 
     struct equeue_background {
         bool active;
@@ -104,12 +235,25 @@ void equeue_destroy(equeue_t *queue);
 // When called with a finite timeout, the equeue_dispatch function is
 // guaranteed to terminate. When called with a timeout of 0, the
 // equeue_dispatch does not wait and is irq safe.
+//
+// Multiple threads may dispatch the same event queue. Each thread takes
+// one ready event at a time, so a long running callback only blocks the
+// thread running it. Events with the same serial key, set with
+// equeue_event_key, are never run concurrently and run in the order
+// they became ready.
+//
+// Due events are collected in batches, and each batch is dispatched from
+// the highest priority band first, set with equeue_event_priority. Events
+// that become due while a batch is dispatched are part of the next batch.
 void equeue_dispatch(equeue_t *queue, int ms);
 
 // Break out of a running event loop
 //
 // Forces the specified event queue's dispatch loop to terminate. Pending
 // events may finish executing, but no new events will be executed.
+//
+// Each call to equeue_break terminates a single dispatch loop, so queues
+// dispatched by multiple threads need one call per thread.
 void equeue_break(equeue_t *queue);
 
 // Simple event calls
@@ -151,14 +295,73 @@ int equeue_call_every(equeue_t *queue, int ms, void (*cb)(void *), void *data);
 void *equeue_alloc(equeue_t *queue, size_t size);
 void equeue_dealloc(equeue_t *queue, void *event);
 
+// Reserve memory for events
+//
+// Slices count chunks that fit events of the specified size out of the
+// queue's buffer and places them on the free lists. Later allocations of
+// that size are served in constant time from the dedicated chunks instead
+// of slicing the buffer or reusing larger chunks. This is intended to be
+// called right after equeue_create, before other sizes are allocated.
+//
+// Returns a negative error code if the buffer can not fit all the chunks,
+// in which case the chunks that did fit are still reserved.
+int equeue_reserve(equeue_t *queue, size_t size, unsigned count);
+
+// Allocator statistics
+//
+// The equeue_stats function reports the overall memory usage of the event
+// queue. The equeue_class_stats function fills up to count entries with
+// usage for each chunk size, or size class, and returns the number of
+// entries filled.
+//
+// The free list counters are always available. The allocation counters,
+// high-water marks and failure counts are only tracked if EQUEUE_STATS is
+// defined, and are zero otherwise.
+void equeue_stats(equeue_t *queue, struct equeue_stats *stats);
+unsigned equeue_class_stats(equeue_t *queue,
+        struct equeue_class_stats *stats, unsigned count);
+
+// Dispatch profile
+//
+// The equeue_profile function fills up to count entries with the dispatch
+// latency and duration recorded for each callback, and returns the number
+// of entries filled. The latency of an event is measured from when it was
+// posted, plus its delay or period. Events are recorded by their callback
+// and profile tag, or by the callback passed to equeue_call and friends.
+// Callbacks beyond the first EQUEUE_PROFILE_CALLBACKS are not recorded and
+// are only counted by equeue_profile_dropped.
+//
+// Profiles are only recorded if EQUEUE_PROFILE is defined, otherwise
+// equeue_profile always returns 0.
+unsigned equeue_profile(equeue_t *queue,
+        struct equeue_profile *profiles, unsigned count);
+unsigned equeue_profile_dropped(equeue_t *queue);
+void equeue_profile_reset(equeue_t *queue);
+
 // Configure an allocated event
 //
 // equeue_event_delay  - Millisecond delay before dispatching an event
 // equeue_event_period - Millisecond period for repeating dispatching an event
+// equeue_event_slack  - Millisecond tolerance for dispatching an event late,
+//                       letting the dispatch loop batch events whose
+//                       deadlines fall within each other's slack into a
+//                       single wakeup
+// equeue_event_priority - Priority band, due events in higher bands are
+//                       dispatched before due events in lower bands,
+//                       priorities above EQUEUE_PRIORITIES-1 are clamped
+// equeue_event_key    - Serial key, events with the same non-zero key are
+//                       never dispatched concurrently by multiple threads
 // equeue_event_dtor   - Destructor to run when the event is deallocated
+// equeue_event_tag    - Profile tag, events that share a callback are
+//                       profiled separately for each tag, ignored unless
+//                       EQUEUE_PROFILE is defined
 void equeue_event_delay(void *event, int ms);
 void equeue_event_period(void *event, int ms);
+void equeue_event_slack(void *event, int ms);
+void equeue_event_priority(void *event, unsigned priority);
+void equeue_event_key(void *event, unsigned key);
 void equeue_event_dtor(void *event, void (*dtor)(void *));
+void equeue_event_tag(void *event, const void *tag);
 
 // Post an event onto the event queue
 //
@@ -168,12 +371,26 @@ void equeue_event_dtor(void *event, void (*dtor)(void *));
 // as its argument.
 //
 // The equeue_post function is irq safe and can act as a mechanism for
-// moving events out of irq contexts.
+// moving events out of irq contexts. Events without a delay are pushed onto
+// a lock-free list with equeue_atomic_cas, so posting them does not take
+// the queue's mutex unless the queue has been backgrounded. Allocating the
+// event with equeue_alloc still takes the memory mutex.
 //
 // The return value is a unique id that represents the posted event and can
 // be passed to equeue_cancel.
 int equeue_post(equeue_t *queue, void (*cb)(void *), void *event);
 
+// Post several events onto the event queue at once
+//
+// Behaves like calling equeue_post with cbs[i] and events[i] for each of
+// the count events, in order, but takes the queue's mutex at most once and
+// wakes up the dispatch loop once. Events without a delay are pushed onto
+// the lock-free list with a single atomic operation.
+//
+// If ids is not null, it is filled with the unique id of each event.
+void equeue_post_batch(equeue_t *queue, void (*const *cbs)(void *),
+        void *const *events, int *ids, unsigned count);
+
 // Cancel an in-flight event
 //
 // Attempts to cancel an event referenced by the unique id returned from
@@ -187,6 +404,42 @@ int equeue_post(equeue_t *queue, void (*cb)(void *), void *event);
 // the event may have already begun executing.
 void equeue_cancel(equeue_t *queue, int id);
 
+// Prepare user allocated memory as an event
+//
+// The buffer must hold a struct equeue_event followed by the event's data,
+// and must outlive any posts of the event. The returned pointer to the data
+// can be configured with the equeue_event_* functions like an event from
+// equeue_alloc, but is posted with equeue_post_user_allocated and is never
+// deallocated by the event queue.
+void *equeue_user_allocated(void *buffer);
+
+// Post a user allocated event onto the event queue
+//
+// Behaves like equeue_post, but the event is owned by the caller, so posting
+// never allocates and can not fail because the queue is out of memory. The
+// event's delay and period are kept, so the event only needs to be
+// configured once and can then be posted repeatedly.
+//
+// The equeue_post_user_allocated function is irq safe. Returns 0 on success,
+// or a negative value if the event is already pending.
+int equeue_post_user_allocated(equeue_t *queue, void (*cb)(void *),
+        void *event);
+
+// Cancel a user allocated event
+//
+// Returns true if the event was removed before it was dispatched. Once a
+// user allocated event is no longer pending it may be posted again or its
+// memory may be released.
+//
+// The equeue_cancel_user_allocated function is irq safe.
+bool equeue_cancel_user_allocated(equeue_t *queue, void *event);
+
+// Check if a user allocated event is pending
+//
+// A user allocated event is pending from when it is posted until it has
+// been dispatched or cancelled.
+bool equeue_user_allocated_pending(equeue_t *queue, void *event);
+
 // Background an event queue onto a single-shot timer
 //
 // The provided update function will be called to indicate when the queue
@@ -23,27 +23,41 @@
 #include <stdbool.h>
 #include "mbed.h"
 
+// The low power timers keep running in deep sleep, which lets the sleep
+// manager enter deep sleep between events instead of being held in sleep
+// by the microsecond ticker. Only the bare-metal semaphore waits on them,
+// with the RTOS the wait is timed by the kernel tick
+#if MBED_CONF_EVENTS_USE_LOWPOWER_TIMER_TICKER && DEVICE_LOWPOWERTIMER
+#define ALIAS_TIMER    LowPowerTimer
+#define ALIAS_TICKER   LowPowerTicker
+#define ALIAS_TIMEOUT  LowPowerTimeout
+#else
+#define ALIAS_TIMER    Timer
+#define ALIAS_TICKER   Ticker
+#define ALIAS_TIMEOUT  Timeout
+#endif
+
 
 // Ticker operations
 static bool equeue_tick_inited = false;
 static volatile unsigned equeue_minutes = 0;
 static unsigned equeue_timer[
-        (sizeof(Timer)+sizeof(unsigned)-1)/sizeof(unsigned)];
+        (sizeof(ALIAS_TIMER)+sizeof(unsigned)-1)/sizeof(unsigned)];
 static unsigned equeue_ticker[
-        (sizeof(Ticker)+sizeof(unsigned)-1)/sizeof(unsigned)];
+        (sizeof(ALIAS_TICKER)+sizeof(unsigned)-1)/sizeof(unsigned)];
 
 static void equeue_tick_update() {
-    equeue_minutes += reinterpret_cast<Timer*>(equeue_timer)->read_ms();
-    reinterpret_cast<Timer*>(equeue_timer)->reset();
+    equeue_minutes += reinterpret_cast<ALIAS_TIMER*>(equeue_timer)->read_ms();
+    reinterpret_cast<ALIAS_TIMER*>(equeue_timer)->reset();
 }
 
 static void equeue_tick_init() {
-    MBED_STATIC_ASSERT(sizeof(equeue_timer) >= sizeof(Timer),
+    MBED_STATIC_ASSERT(sizeof(equeue_timer) >= sizeof(ALIAS_TIMER),
             "The equeue_timer buffer must fit the class Timer");
-    MBED_STATIC_ASSERT(sizeof(equeue_ticker) >= sizeof(Ticker),
+    MBED_STATIC_ASSERT(sizeof(equeue_ticker) >= sizeof(ALIAS_TICKER),
             "The equeue_ticker buffer must fit the class Ticker");
-    Timer *timer = new (equeue_timer) Timer;
-    Ticker *ticker = new (equeue_ticker) Ticker;
+    ALIAS_TIMER *timer = new (equeue_timer) ALIAS_TIMER;
+    ALIAS_TICKER *ticker = new (equeue_ticker) ALIAS_TICKER;
 
     equeue_minutes = 0;
     timer->start();
@@ -62,12 +76,16 @@ unsigned equeue_tick() {
 
     do {
         minutes = equeue_minutes;
-        ms = reinterpret_cast<Timer*>(equeue_timer)->read_ms();
+        ms = reinterpret_cast<ALIAS_TIMER*>(equeue_timer)->read_ms();
     } while (minutes != equeue_minutes);
 
     return minutes + ms;
 }
 
+unsigned equeue_tick_us() {
+    return ticker_read(get_us_ticker_data());
+}
+
 
 // Mutex operations
 int equeue_mutex_create(equeue_mutex_t *m) { return 0; }
@@ -82,6 +100,12 @@ void equeue_mutex_unlock(equeue_mutex_t *m) {
 }
 
 
+// Atomic operations
+bool equeue_atomic_cas(void **ptr, void *expected, void *desired) {
+    return core_util_atomic_cas_ptr(ptr, &expected, desired);
+}
+
+
 // Semaphore operations
 #ifdef MBED_CONF_RTOS_PRESENT
 
@@ -103,6 +127,8 @@ void equeue_sema_signal(equeue_sema_t *s) {
     osEventFlagsSet(s->id, 1);
 }
 
+// timed by the kernel tick, events.use-lowpower-timer-ticker does not
+// apply here
 bool equeue_sema_wait(equeue_sema_t *s, int ms) {
     if (ms < 0) {
         ms = osWaitForever;
@@ -132,13 +158,15 @@ static void equeue_sema_timeout(equeue_sema_t *s) {
 
 bool equeue_sema_wait(equeue_sema_t *s, int ms) {
     int signal = 0;
-    Timeout timeout;
+    ALIAS_TIMEOUT timeout;
     if (ms == 0) {
         return false;
     } else if (ms > 0) {
         timeout.attach_us(callback(equeue_sema_timeout, s), ms*1000);
     }
 
+    // sleep() goes through sleep_manager_sleep_auto, so with the low power
+    // timers the device may deep sleep until the next event is due
     core_util_critical_section_enter();
     while (!*s) {
         sleep();
@@ -55,6 +55,24 @@ extern "C" {
 #endif
 
 
+// Platform code placement
+//
+// EQUEUE_RAMFUNC marks the functions on the path of every dispatched event,
+// so that they can run from RAM instead of flash. It expands to nothing
+// unless the platform provides it.
+#if !defined(EQUEUE_RAMFUNC) && defined(EQUEUE_PLATFORM_MBED) \
+ && defined(MBED_CONF_EVENTS_DISPATCH_IN_RAM)
+#if MBED_CONF_EVENTS_DISPATCH_IN_RAM
+#include "platform/mbed_toolchain.h"
+#define EQUEUE_RAMFUNC MBED_RAMFUNC
+#endif
+#endif
+
+#ifndef EQUEUE_RAMFUNC
+#define EQUEUE_RAMFUNC
+#endif
+
+
 // Platform millisecond counter
 //
 // Return a tick that represents the number of milliseconds that have passed
@@ -65,6 +83,15 @@ extern "C" {
 // Must intentionally overflow to 0 after 2^32-1
 unsigned equeue_tick(void);
 
+// Platform microsecond counter
+//
+// Return a tick that represents the number of microseconds that have passed
+// since an arbitrary point in time. This is only used to profile dispatch
+// latencies and callback durations when EQUEUE_PROFILE is defined.
+//
+// Must intentionally overflow to 0 after 2^32-1
+unsigned equeue_tick_us(void);
+
 
 // Platform mutex type
 //
@@ -143,6 +170,18 @@ void equeue_sema_signal(equeue_sema_t *sema);
 bool equeue_sema_wait(equeue_sema_t *sema, int ms);
 
 
+
+// Platform atomic operations
+//
+// The equeue_atomic_cas function atomically replaces the pointer at ptr
+// with desired if it is equal to expected, returning true on success. It
+// must be safe to call from interrupt contexts and is used for posting
+// events without taking the equeue mutex.
+//
+// Platforms without atomic instructions can implement equeue_atomic_cas
+// with a short critical section.
+bool equeue_atomic_cas(void **ptr, void *expected, void *desired);
+
 #ifdef __cplusplus
 }
 #endif
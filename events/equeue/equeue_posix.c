@@ -24,11 +24,20 @@
 #include <errno.h>
 
 
-// Tick operations
+// Tick operations, offset from the clock so tests can start the ticks
+// just before they wrap around
+unsigned equeue_tick_offset = 0;
+
 unsigned equeue_tick(void) {
     struct timeval tv;
     gettimeofday(&tv, 0);
-    return (unsigned)(tv.tv_sec*1000 + tv.tv_usec/1000);
+    return (unsigned)(tv.tv_sec*1000 + tv.tv_usec/1000) + equeue_tick_offset;
+}
+
+unsigned equeue_tick_us(void) {
+    struct timeval tv;
+    gettimeofday(&tv, 0);
+    return (unsigned)(tv.tv_sec*1000000 + tv.tv_usec);
 }
 
 
@@ -50,6 +59,12 @@ void equeue_mutex_unlock(equeue_mutex_t *m) {
 }
 
 
+// Atomic operations
+bool equeue_atomic_cas(void **ptr, void *expected, void *desired) {
+    return __sync_bool_compare_and_swap(ptr, expected, desired);
+}
+
+
 // Semaphore operations
 int equeue_sema_create(equeue_sema_t *s) {
     int err = pthread_mutex_init(&s->mutex, 0);
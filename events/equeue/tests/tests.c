@@ -21,6 +21,7 @@
 #include <setjmp.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 #include <pthread.h>
 
 
@@ -269,6 +270,227 @@ void allocation_failure_test(void) {
     equeue_destroy(&q);
 }
 
+void reserve_test(void) {
+    equeue_t q;
+    int err = equeue_create(&q, 2048);
+    test_assert(!err);
+
+    err = equeue_reserve(&q, sizeof(struct indirect), 4);
+    test_assert(!err);
+
+    struct equeue_stats stats;
+    equeue_stats(&q, &stats);
+    test_assert(stats.buffer_size == 2048);
+    test_assert(stats.free_cnt == 4);
+    test_assert(stats.class_cnt == 1);
+    test_assert(stats.slab_size == 2048 - stats.free_size);
+    size_t slab_size = stats.slab_size;
+
+    void *p[4];
+    for (int i = 0; i < 4; i++) {
+        p[i] = equeue_alloc(&q, sizeof(struct indirect));
+        test_assert(p[i]);
+    }
+
+    equeue_stats(&q, &stats);
+    test_assert(stats.free_cnt == 0);
+    test_assert(stats.slab_size == slab_size);
+#ifdef EQUEUE_STATS
+    test_assert(stats.alloc_cnt == 4);
+    test_assert(stats.max_alloc_cnt == 4);
+#endif
+
+    for (int i = 0; i < 4; i++) {
+        equeue_dealloc(&q, p[i]);
+    }
+
+    test_assert(!equeue_alloc(&q, 4096));
+
+    struct equeue_class_stats classes[2];
+    unsigned n = equeue_class_stats(&q, classes, 2);
+    test_assert(n == 1);
+    test_assert(classes[0].free_cnt == 4);
+#ifdef EQUEUE_STATS
+    test_assert(classes[0].alloc_cnt == 0);
+    test_assert(classes[0].max_alloc_cnt == 4);
+
+    equeue_stats(&q, &stats);
+    test_assert(stats.alloc_cnt == 0);
+    test_assert(stats.alloc_fail_cnt == 1);
+#endif
+
+    err = equeue_reserve(&q, 4096, 1);
+    test_assert(err < 0);
+
+    equeue_destroy(&q);
+}
+
+struct user_event {
+    struct equeue_event header;
+    int *touched;
+};
+
+void user_func(void *p) {
+    int **touched = (int**)p;
+    (**touched)++;
+}
+
+struct user_cancel {
+    equeue_t *q;
+    void *p;
+    bool removed;
+};
+
+void user_cancel_func(void *p) {
+    struct user_cancel *cancel = (struct user_cancel *)p;
+    cancel->removed = equeue_cancel_user_allocated(cancel->q, cancel->p);
+}
+
+void user_allocated_test(void) {
+    equeue_t q;
+    int err = equeue_create(&q, 2048);
+    test_assert(!err);
+
+    // exhaust the queue's memory
+    while (equeue_alloc(&q, 32));
+
+    int touched = 0;
+    struct user_event storage;
+    int **p = equeue_user_allocated(&storage);
+    *p = &touched;
+    test_assert(!equeue_user_allocated_pending(&q, p));
+
+    for (int i = 0; i < 3; i++) {
+        err = equeue_post_user_allocated(&q, user_func, p);
+        test_assert(!err);
+        test_assert(equeue_user_allocated_pending(&q, p));
+
+        err = equeue_post_user_allocated(&q, user_func, p);
+        test_assert(err < 0);
+
+        equeue_dispatch(&q, 0);
+        test_assert(touched == i+1);
+        test_assert(!equeue_user_allocated_pending(&q, p));
+    }
+
+    // zero-delay events are unlinked from the queue when cancelled, so
+    // their storage can be reused right away
+    err = equeue_post_user_allocated(&q, user_func, p);
+    test_assert(!err);
+    test_assert(equeue_cancel_user_allocated(&q, p));
+    test_assert(!equeue_user_allocated_pending(&q, p));
+    memset(&storage, 0xff, sizeof(storage));
+    p = equeue_user_allocated(&storage);
+    *p = &touched;
+    equeue_dispatch(&q, 0);
+    test_assert(touched == 3);
+
+    // as are events that expired but have not been dispatched yet
+    equeue_destroy(&q);
+    err = equeue_create(&q, 2048);
+    test_assert(!err);
+    struct user_cancel cancel = {&q, p, false};
+    test_assert(equeue_call(&q, user_cancel_func, &cancel));
+    err = equeue_post_user_allocated(&q, user_func, p);
+    test_assert(!err);
+    equeue_dispatch(&q, 0);
+    test_assert(cancel.removed);
+    test_assert(touched == 3);
+    test_assert(!equeue_user_allocated_pending(&q, p));
+
+    equeue_event_delay(p, 10);
+    err = equeue_post_user_allocated(&q, user_func, p);
+    test_assert(!err);
+    test_assert(equeue_cancel_user_allocated(&q, p));
+    test_assert(!equeue_user_allocated_pending(&q, p));
+    test_assert(!equeue_cancel_user_allocated(&q, p));
+
+    equeue_dispatch(&q, 20);
+    test_assert(touched == 3);
+
+    equeue_event_delay(p, 10);
+    equeue_event_period(p, 10);
+    err = equeue_post_user_allocated(&q, user_func, p);
+    test_assert(!err);
+
+    equeue_dispatch(&q, 55);
+    test_assert(touched == 8);
+    test_assert(equeue_user_allocated_pending(&q, p));
+    test_assert(equeue_cancel_user_allocated(&q, p));
+
+    equeue_destroy(&q);
+}
+
+void profile_test(void) {
+    equeue_t q;
+    int err = equeue_create(&q, 2048);
+    test_assert(!err);
+
+    int touched = 0;
+    int id = equeue_call(&q, sloth_func, &touched);
+    test_assert(id);
+
+    for (int i = 0; i < 4; i++) {
+        id = equeue_call(&q, simple_func, &touched);
+        test_assert(id);
+    }
+
+    id = equeue_call_in(&q, 20, simple_func, &touched);
+    test_assert(id);
+
+    equeue_dispatch(&q, 40);
+    test_assert(touched == 6);
+
+    struct equeue_profile profiles[4];
+    unsigned n = equeue_profile(&q, profiles, 4);
+#ifdef EQUEUE_PROFILE
+    test_assert(n == 2);
+    test_assert(profiles[0].cb == sloth_func);
+    test_assert(profiles[0].count == 1);
+    test_assert(profiles[0].duration_max >= 10000);
+    test_assert(profiles[1].cb == simple_func);
+    test_assert(profiles[1].count == 5);
+
+    // the immediate simple_funcs had to wait for the sloth_func
+    test_assert(profiles[1].latency_max >= 10000);
+
+    unsigned hist = 0;
+    for (int i = 0; i < EQUEUE_PROFILE_BUCKETS; i++) {
+        hist += profiles[1].latency_hist[i];
+    }
+    test_assert(hist == 5);
+
+    equeue_profile_reset(&q);
+    test_assert(equeue_profile(&q, profiles, 4) == 0);
+
+    // events sharing a callback are recorded separately for each tag
+    static const char tags[2] = {0};
+    for (int i = 0; i < 3; i++) {
+        int *e = equeue_alloc(&q, sizeof(int));
+        test_assert(e);
+        *e = 0;
+        equeue_event_tag(e, &tags[i % 2]);
+        id = equeue_post(&q, simple_func, e);
+        test_assert(id);
+    }
+
+    equeue_dispatch(&q, 0);
+    n = equeue_profile(&q, profiles, 4);
+    test_assert(n == 2);
+    test_assert(profiles[0].cb == simple_func);
+    test_assert(profiles[0].tag == &tags[0]);
+    test_assert(profiles[0].count == 2);
+    test_assert(profiles[1].cb == simple_func);
+    test_assert(profiles[1].tag == &tags[1]);
+    test_assert(profiles[1].count == 1);
+#else
+    test_assert(n == 0);
+#endif
+    test_assert(equeue_profile_dropped(&q) == 0);
+
+    equeue_destroy(&q);
+}
+
 void cancel_test(int N) {
     equeue_t q;
     int err = equeue_create(&q, 2048);
@@ -405,6 +627,32 @@ void period_test(void) {
     equeue_destroy(&q);
 }
 
+void wraparound_test(void) {
+    // start the ticks 100 ms before they wrap around
+    extern unsigned equeue_tick_offset;
+    equeue_tick_offset += (UINT32_MAX - 100) - equeue_tick();
+
+    equeue_t q;
+    int err = equeue_create(&q, 2048);
+    test_assert(!err);
+
+    int counts[3] = {0, 0, 0};
+    int touched = 0;
+    equeue_call_every(&q, 10, simple_func, &counts[0]);
+    equeue_call_every(&q, 20, simple_func, &counts[1]);
+    equeue_call_every(&q, 50, simple_func, &counts[2]);
+    equeue_call_in(&q, 150, simple_func, &touched);
+
+    equeue_dispatch(&q, 205);
+    test_assert(counts[0] == 20);
+    test_assert(counts[1] == 10);
+    test_assert(counts[2] == 4);
+    test_assert(touched == 1);
+
+    equeue_destroy(&q);
+    equeue_tick_offset = 0;
+}
+
 void nested_test(void) {
     equeue_t q;
     int err = equeue_create(&q, 2048);
@@ -522,6 +770,170 @@ void background_test(void) {
     test_assert(ms == -1);
 }
 
+void slack_test(void) {
+    equeue_t q;
+    int err = equeue_create(&q, 2048);
+    test_assert(!err);
+
+    unsigned ms;
+    equeue_background(&q, background_func, &ms);
+
+    int touched = 0;
+    struct indirect *i = equeue_alloc(&q, sizeof(struct indirect));
+    test_assert(i);
+    i->touched = &touched;
+    equeue_event_delay(i, 10);
+    equeue_event_slack(i, 20);
+    int id = equeue_post(&q, indirect_func, i);
+    test_assert(id);
+    test_assert(ms == 30);
+
+    // an event inside the slack window pulls the wakeup in
+    id = equeue_call_in(&q, 20, simple_func, &touched);
+    test_assert(id);
+    test_assert(ms == 20);
+
+    // later events don't move the wakeup
+    id = equeue_call_in(&q, 40, simple_func, &touched);
+    test_assert(id);
+    test_assert(ms == 20);
+
+    // both events run from a single wakeup
+    usleep(20*1000);
+    equeue_dispatch(&q, 0);
+    test_assert(touched == 2);
+    test_assert(ms > 0 && ms <= 20);
+
+    equeue_destroy(&q);
+}
+
+struct priority_log {
+    int log[16];
+    int count;
+};
+
+struct priority_event {
+    struct priority_log *order;
+    int value;
+    equeue_t *q;
+};
+
+void priority_func(void *p) {
+    struct priority_event *e = (struct priority_event*)p;
+    e->order->log[e->order->count++] = e->value;
+}
+
+void priority_post(equeue_t *q, struct priority_log *order, int value,
+        unsigned priority) {
+    struct priority_event *e = equeue_alloc(q, sizeof(struct priority_event));
+    test_assert(e);
+
+    e->order = order;
+    e->value = value;
+    e->q = q;
+    equeue_event_priority(e, priority);
+    int id = equeue_post(q, priority_func, e);
+    test_assert(id);
+}
+
+void urgent_func(void *p) {
+    struct priority_event *e = (struct priority_event*)p;
+    priority_func(e);
+    priority_post(e->q, e->order, 9, EQUEUE_PRIORITIES-1);
+}
+
+void priority_test(void) {
+    equeue_t q;
+    int err = equeue_create(&q, 2048);
+    test_assert(!err);
+
+    // due events run by priority, then in order within a priority
+    struct priority_log order = {{0}, 0};
+    priority_post(&q, &order, 0, 0);
+    priority_post(&q, &order, 1, 0);
+    priority_post(&q, &order, 2, 1);
+    priority_post(&q, &order, 3, EQUEUE_PRIORITIES-1);
+    priority_post(&q, &order, 4, 1000);
+
+    equeue_dispatch(&q, 0);
+    test_assert(order.count == 5);
+    test_assert(order.log[0] == 3);
+    test_assert(order.log[1] == 4);
+    test_assert(order.log[2] == 2);
+    test_assert(order.log[3] == 0);
+    test_assert(order.log[4] == 1);
+
+    // events that expire during dispatch wait for the next batch
+    order.count = 0;
+    struct priority_event *e = equeue_alloc(&q, sizeof(struct priority_event));
+    test_assert(e);
+    e->order = &order;
+    e->value = 0;
+    e->q = &q;
+    int id = equeue_post(&q, urgent_func, e);
+    test_assert(id);
+    priority_post(&q, &order, 1, 0);
+    priority_post(&q, &order, 2, 0);
+
+    equeue_dispatch(&q, 0);
+    test_assert(order.count == 3);
+    equeue_dispatch(&q, 0);
+    test_assert(order.count == 4);
+    test_assert(order.log[0] == 0);
+    test_assert(order.log[1] == 1);
+    test_assert(order.log[2] == 2);
+    test_assert(order.log[3] == 9);
+
+    equeue_destroy(&q);
+}
+
+void batch_test(void) {
+    equeue_t q;
+    int err = equeue_create(&q, 2048);
+    test_assert(!err);
+
+    unsigned ms;
+    equeue_background(&q, background_func, &ms);
+
+    struct priority_log log = {{0}, 0};
+    void (*cbs[5])(void *);
+    void *events[5];
+    int ids[5];
+    for (int i = 0; i < 5; i++) {
+        struct priority_event *e = equeue_alloc(&q,
+                sizeof(struct priority_event));
+        test_assert(e);
+        e->order = &log;
+        e->value = i;
+        e->q = &q;
+
+        // odd events are delayed, the rest run right away in order
+        if (i % 2) {
+            equeue_event_delay(e, 10*i);
+        }
+
+        cbs[i] = priority_func;
+        events[i] = e;
+    }
+
+    equeue_post_batch(&q, cbs, events, ids, 5);
+    test_assert(ms == 0);
+    for (int i = 0; i < 5; i++) {
+        test_assert(ids[i]);
+    }
+
+    equeue_cancel(&q, ids[3]);
+    equeue_cancel(&q, ids[4]);
+
+    equeue_dispatch(&q, 20);
+    test_assert(log.count == 3);
+    test_assert(log.log[0] == 0);
+    test_assert(log.log[1] == 2);
+    test_assert(log.log[2] == 1);
+
+    equeue_destroy(&q);
+}
+
 void chain_test(void) {
     equeue_t q1;
     int err = equeue_create(&q1, 2048);
@@ -686,6 +1098,203 @@ void multithreaded_barrage_test(int N) {
 
     equeue_destroy(&q);
 }
+struct immediate {
+    equeue_t *q;
+    int *touched;
+    int count;
+};
+
+static void *immediate_thread(void *p) {
+    struct immediate *i = (struct immediate*)p;
+    for (int j = 0; j < i->count; j++) {
+        while (!equeue_call(i->q, simple_func, i->touched)) {
+            usleep(100);
+        }
+    }
+    return 0;
+}
+
+void immediate_barrage_test(int N) {
+    equeue_t q;
+    int err = equeue_create(&q, 64*EQUEUE_EVENT_SIZE);
+    test_assert(!err);
+
+    int touched[4] = {0};
+    struct immediate i[4];
+    pthread_t threads[4];
+    for (int j = 0; j < 4; j++) {
+        i[j].q = &q;
+        i[j].touched = &touched[j];
+        i[j].count = N;
+        err = pthread_create(&threads[j], 0, immediate_thread, &i[j]);
+        test_assert(!err);
+    }
+
+    unsigned start = equeue_tick();
+    while (touched[0] + touched[1] + touched[2] + touched[3] < 4*N &&
+           equeue_tick() - start < 1000) {
+        equeue_dispatch(&q, 10);
+    }
+
+    for (int j = 0; j < 4; j++) {
+        err = pthread_join(threads[j], 0);
+        test_assert(!err);
+    }
+
+    equeue_dispatch(&q, 0);
+    for (int j = 0; j < 4; j++) {
+        test_assert(touched[j] == N);
+    }
+
+    equeue_destroy(&q);
+}
+
+struct serial {
+    volatile int running;
+    int count;
+    int last;
+    bool overlapped;
+    bool reordered;
+};
+
+struct serial_event {
+    struct serial *serial;
+    int index;
+};
+
+void serial_func(void *p) {
+    struct serial_event *e = (struct serial_event*)p;
+    struct serial *serial = e->serial;
+
+    if (__sync_fetch_and_add(&serial->running, 1) != 0) {
+        serial->overlapped = true;
+    }
+
+    if (e->index <= serial->last) {
+        serial->reordered = true;
+    }
+    serial->last = e->index;
+
+    usleep(1000);
+    serial->count += 1;
+    __sync_fetch_and_sub(&serial->running, 1);
+}
+
+void shared_dispatch_test(int N) {
+    equeue_t q;
+    int err = equeue_create(&q, 4*N*(EQUEUE_EVENT_SIZE +
+            sizeof(struct serial_event)));
+    test_assert(!err);
+
+    struct ethread t[4];
+    for (int i = 0; i < 4; i++) {
+        t[i].q = &q;
+        t[i].ms = -1;
+        err = pthread_create(&t[i].thread, 0, ethread_dispatch, &t[i]);
+        test_assert(!err);
+    }
+
+    // unkeyed events are spread over all threads
+    int touched = 0;
+    unsigned start = equeue_tick();
+    for (int i = 0; i < 4; i++) {
+        equeue_call(&q, sloth_func, &touched);
+    }
+
+    while (__sync_fetch_and_add(&touched, 0) < 4) {
+        usleep(1000);
+    }
+    test_assert(equeue_tick() - start < 30);
+
+    // keyed events never overlap and keep their order, whatever their key
+    struct serial serial[2] = {{0, 0, -1}, {0, 0, -1}};
+    for (int i = 0; i < 2*N; i++) {
+        struct serial_event *e = equeue_alloc(&q, sizeof(struct serial_event));
+        test_assert(e);
+
+        e->serial = &serial[i % 2];
+        e->index = i;
+        equeue_event_key(e, (1 + i % 2) << 16);
+        int id = equeue_post(&q, serial_func, e);
+        test_assert(id);
+    }
+
+    while (__sync_fetch_and_add(&serial[0].running, 0) ||
+           serial[0].count + serial[1].count < 2*N) {
+        usleep(1000);
+    }
+
+    for (int i = 0; i < 4; i++) {
+        equeue_break(&q);
+    }
+
+    for (int i = 0; i < 4; i++) {
+        err = pthread_join(t[i].thread, 0);
+        test_assert(!err);
+    }
+
+    for (int i = 0; i < 2; i++) {
+        test_assert(serial[i].count == N);
+        test_assert(!serial[i].overlapped);
+        test_assert(!serial[i].reordered);
+    }
+
+    equeue_destroy(&q);
+}
+
+struct order {
+    int *log;
+    int *count;
+    int index;
+};
+
+void order_func(void *p) {
+    struct order *order = (struct order*)p;
+    order->log[(*order->count)++] = order->index;
+}
+
+void ordering_barrage_test(int N) {
+    equeue_t q;
+    int err = equeue_create(&q, N*(EQUEUE_EVENT_SIZE+sizeof(struct order)));
+    test_assert(!err);
+
+    int delays[N];
+    int ids[N];
+    int log[N];
+    int count = 0;
+
+    for (int i = 0; i < N; i++) {
+        struct order *order = equeue_alloc(&q, sizeof(struct order));
+        test_assert(order);
+
+        order->log = log;
+        order->count = &count;
+        order->index = i;
+        delays[i] = (i*7919) % 1200;
+        equeue_event_delay(order, delays[i]);
+
+        ids[i] = equeue_post(&q, order_func, order);
+        test_assert(ids[i]);
+    }
+
+    for (int i = 0; i < N; i += 3) {
+        equeue_cancel(&q, ids[i]);
+    }
+
+    equeue_dispatch(&q, 1300);
+
+    test_assert(count == N - (N+2)/3);
+    for (int i = 0; i < count; i++) {
+        test_assert(log[i] % 3 != 0);
+        if (i > 0) {
+            test_assert(delays[log[i-1]] < delays[log[i]] ||
+                    (delays[log[i-1]] == delays[log[i]] &&
+                     log[i-1] < log[i]));
+        }
+    }
+
+    equeue_destroy(&q);
+}
 
 
 int main() {
@@ -697,21 +1306,31 @@ int main() {
     test_run(simple_post_test);
     test_run(destructor_test);
     test_run(allocation_failure_test);
+    test_run(reserve_test);
+    test_run(user_allocated_test);
+    test_run(profile_test);
     test_run(cancel_test, 20);
     test_run(cancel_inflight_test);
     test_run(cancel_unnecessarily_test);
     test_run(loop_protect_test);
     test_run(break_test);
     test_run(period_test);
+    test_run(wraparound_test);
     test_run(nested_test);
     test_run(sloth_test);
     test_run(background_test);
+    test_run(slack_test);
+    test_run(priority_test);
+    test_run(batch_test);
     test_run(chain_test);
     test_run(unchain_test);
     test_run(multithread_test);
     test_run(simple_barrage_test, 20);
     test_run(fragmenting_barrage_test, 20);
     test_run(multithreaded_barrage_test, 20);
+    test_run(immediate_barrage_test, 1000);
+    test_run(shared_dispatch_test, 20);
+    test_run(ordering_barrage_test, 200);
 
     printf("done!\n");
     return test_failure;
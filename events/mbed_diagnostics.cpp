@@ -0,0 +1,353 @@
+/* events
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "events/mbed_diagnostics.h"
+#include "events/EventQueue.h"
+#include "platform/mbed_stats.h"
+#include "platform/mbed_assert.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if MBED_CONF_RTOS_PRESENT
+#include "cmsis_os2.h"
+#endif
+
+#ifndef MBED_CONF_EVENTS_DIAGNOSTICS_LINE_SIZE
+#define MBED_CONF_EVENTS_DIAGNOSTICS_LINE_SIZE  64
+#endif
+
+#ifndef MBED_CONF_EVENTS_DIAGNOSTICS_REPLY_SIZE
+#define MBED_CONF_EVENTS_DIAGNOSTICS_REPLY_SIZE 1024
+#endif
+
+#ifndef MBED_CPU_STATS_MAX_THREADS
+#define MBED_CPU_STATS_MAX_THREADS 16
+#endif
+
+using namespace events;
+
+namespace mbed {
+
+// Reply being formatted, len keeps counting past the end of the buffer
+struct reply_t {
+    char *buf;
+    size_t size;
+    int len;
+};
+
+static void put(reply_t *r, const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    size_t offset = (size_t)r->len < r->size ? r->len : r->size;
+    int n = vsnprintf(r->buf + offset, r->size - offset, format, args);
+    va_end(args);
+    if (n > 0) {
+        r->len += n;
+    }
+}
+
+static const char *next_word(const char **line, size_t *len)
+{
+    const char *s = *line;
+    while (*s == ' ' || *s == '\t') {
+        s++;
+    }
+    const char *word = s;
+    while (*s && *s != ' ' && *s != '\t') {
+        s++;
+    }
+    *len = s - word;
+    *line = s;
+    return word;
+}
+
+static bool word_is(const char *word, size_t len, const char *name)
+{
+    return name && strlen(name) == len && memcmp(word, name, len) == 0;
+}
+
+// Allocates and fills an array with the usage of all event queues
+static EventQueue::queue_stats *get_queues(unsigned *count)
+{
+    // leave room for queues created while the stats are gathered
+    unsigned n = EventQueue::get_all_stats(NULL, 0) + 2;
+    EventQueue::queue_stats *queues = (EventQueue::queue_stats *)malloc(n * sizeof(EventQueue::queue_stats));
+    MBED_ASSERT(queues != NULL);
+    unsigned found = EventQueue::get_all_stats(queues, n);
+    *count = found < n ? found : n;
+    return queues;
+}
+
+#if MBED_CONF_RTOS_PRESENT
+#if MBED_CPU_STATS_ENABLED
+// runtimes at the previous threads command, to report recent cpu shares
+static struct {
+    uint32_t thread_id;
+    uint64_t runtime;
+} cpu_last[MBED_CPU_STATS_MAX_THREADS];
+static uint64_t cpu_last_uptime;
+#endif
+
+static const char *state_name(osThreadState_t state)
+{
+    switch (state) {
+        case osThreadInactive:      return "inactive";
+        case osThreadReady:         return "ready";
+        case osThreadRunning:       return "running";
+        case osThreadBlocked:       return "blocked";
+        case osThreadTerminated:    return "terminated";
+        default:                    return "error";
+    }
+}
+
+static void list_threads(reply_t *r)
+{
+    // leave room for threads created while the stats are gathered
+    uint32_t count = osThreadGetCount() + 4;
+    osThreadId_t *threads = (osThreadId_t *)malloc(count * sizeof(osThreadId_t));
+    mbed_stats_stack_t *stacks = (mbed_stats_stack_t *)malloc(count * sizeof(mbed_stats_stack_t));
+    mbed_stats_thread_cpu_t *cpus = (mbed_stats_thread_cpu_t *)malloc(count * sizeof(mbed_stats_thread_cpu_t));
+    MBED_ASSERT(threads != NULL && stacks != NULL && cpus != NULL);
+
+    size_t stack_n = mbed_stats_stack_get_each(stacks, count);
+    size_t cpu_n = mbed_stats_thread_cpu_get_each(cpus, count);
+    mbed_stats_cpu_t cpu;
+    mbed_stats_cpu_get(&cpu);
+#if MBED_CPU_STATS_ENABLED
+    uint64_t elapsed = cpu.uptime - cpu_last_uptime;
+    cpu_last_uptime = cpu.uptime;
+#endif
+
+    put(r, "%-10s %-16s %-10s %4s %6s %6s %6s\n", "id", "name", "state", "prio", "stack", "used", "cpu%");
+
+    count = osThreadEnumerate(threads, count);
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t id = (uint32_t)threads[i];
+        const char *name = osThreadGetName(threads[i]);
+        put(r, "0x%08lx %-16.16s %-10s %4d %6lu ", (unsigned long)id, name ? name : "-",
+            state_name(osThreadGetState(threads[i])), (int)osThreadGetPriority(threads[i]),
+            (unsigned long)osThreadGetStackSize(threads[i]));
+
+        size_t j = 0;
+        while (j < stack_n && stacks[j].thread_id != id) {
+            j++;
+        }
+        if (j < stack_n) {
+            put(r, "%6lu ", (unsigned long)stacks[j].max_size);
+        } else {
+            put(r, "%6s ", "-");
+        }
+
+        j = 0;
+        while (j < cpu_n && cpus[j].thread_id != id) {
+            j++;
+        }
+#if MBED_CPU_STATS_ENABLED
+        if (j < cpu_n) {
+            uint64_t runtime = cpus[j].runtime;
+            for (int k = 0; k < MBED_CPU_STATS_MAX_THREADS; k++) {
+                // a new thread can reuse the id of one that ran less
+                if (cpu_last[k].thread_id == id && cpu_last[k].runtime <= runtime) {
+                    runtime -= cpu_last[k].runtime;
+                    break;
+                }
+            }
+            unsigned tenths = elapsed ? (unsigned)(runtime * 1000 / elapsed) : 0;
+            put(r, "%4u.%u\n", tenths / 10, tenths % 10);
+            continue;
+        }
+#endif
+        put(r, "%6s\n", "-");
+    }
+
+#if MBED_CPU_STATS_ENABLED
+    memset(cpu_last, 0, sizeof(cpu_last));
+    for (size_t i = 0; i < cpu_n && i < MBED_CPU_STATS_MAX_THREADS; i++) {
+        cpu_last[i].thread_id = cpus[i].thread_id;
+        cpu_last[i].runtime = cpus[i].runtime;
+    }
+#endif
+
+    free(cpus);
+    free(stacks);
+    free(threads);
+}
+
+static void set_priority(reply_t *r, const char *line)
+{
+    size_t target_len, prio_len;
+    const char *target = next_word(&line, &target_len);
+    const char *prio = next_word(&line, &prio_len);
+    char *end;
+    long priority = strtol(prio, &end, 0);
+    if (!target_len || !prio_len || end != prio + prio_len) {
+        put(r, "usage: prio THREAD PRIORITY\n");
+        return;
+    }
+
+    // a queue name stands for the thread that dispatches it
+    uint32_t queue_thread = 0;
+    unsigned queue_n;
+    EventQueue::queue_stats *queues = get_queues(&queue_n);
+    for (unsigned i = 0; i < queue_n && !queue_thread; i++) {
+        if (word_is(target, target_len, queues[i].name)) {
+            queue_thread = queues[i].thread_id;
+        }
+    }
+    free(queues);
+
+    unsigned long id = strtoul(target, &end, 16);
+    uint32_t count = osThreadGetCount() + 4;
+    osThreadId_t *threads = (osThreadId_t *)malloc(count * sizeof(osThreadId_t));
+    MBED_ASSERT(threads != NULL);
+
+    osKernelLock();
+    osThreadId_t thread = NULL;
+    count = osThreadEnumerate(threads, count);
+    for (uint32_t i = 0; i < count && !thread; i++) {
+        if ((uint32_t)threads[i] == queue_thread ||
+                (end == target + target_len && (uint32_t)threads[i] == id) ||
+                word_is(target, target_len, osThreadGetName(threads[i]))) {
+            thread = threads[i];
+        }
+    }
+    osStatus_t status = thread ? osThreadSetPriority(thread, (osPriority_t)priority) : osErrorResource;
+    osKernelUnlock();
+    free(threads);
+
+    if (!thread) {
+        put(r, "no thread %.*s\n", (int)target_len, target);
+    } else if (status != osOK) {
+        put(r, "invalid priority %ld\n", priority);
+    } else {
+        put(r, "0x%08lx priority %ld\n", (unsigned long)(uint32_t)thread, priority);
+    }
+}
+#endif
+
+static void list_queues(reply_t *r)
+{
+    unsigned n;
+    EventQueue::queue_stats *queues = get_queues(&n);
+
+    put(r, "%-16s %-10s %6s %6s %6s %6s %6s\n", "name", "thread", "size", "used", "events", "max", "fail");
+    for (unsigned i = 0; i < n; i++) {
+        struct equeue_stats *s = &queues[i].stats;
+        put(r, "%-16.16s ", queues[i].name ? queues[i].name : "-");
+        if (queues[i].thread_id) {
+            put(r, "0x%08lx ", (unsigned long)queues[i].thread_id);
+        } else {
+            put(r, "%-10s ", "-");
+        }
+        put(r, "%6lu %6lu ", (unsigned long)s->buffer_size,
+            (unsigned long)(s->buffer_size - s->slab_size - s->free_size));
+#if MBED_CONF_EVENTS_STATS_ENABLED
+        put(r, "%6u %6u %6u\n", s->alloc_cnt, s->max_alloc_cnt, s->alloc_fail_cnt);
+#else
+        put(r, "%6s %6s %6s\n", "-", "-", "-");
+#endif
+    }
+
+    free(queues);
+}
+
+int mbed_diag_command(const char *line, char *reply, size_t size)
+{
+    reply_t r = { reply, size, 0 };
+    if (size) {
+        reply[0] = '\0';
+    }
+
+    size_t len;
+    const char *command = next_word(&line, &len);
+    if (len == 0) {
+        return 0;
+    } else if (word_is(command, len, "queues")) {
+        list_queues(&r);
+#if MBED_CONF_RTOS_PRESENT
+    } else if (word_is(command, len, "threads")) {
+        list_threads(&r);
+    } else if (word_is(command, len, "prio")) {
+        set_priority(&r, line);
+#endif
+    } else if (word_is(command, len, "help")) {
+#if MBED_CONF_RTOS_PRESENT
+        put(&r, "threads                 list threads\n"
+                "prio THREAD PRIORITY    set the priority of a thread, by id, name or queue name\n");
+#endif
+        put(&r, "queues                  list event queues\n");
+    } else {
+        put(&r, "unknown command %.*s, try help\n", (int)len, command);
+    }
+
+    return r.len;
+}
+
+void mbed_diag_console(FileHandle *fh)
+{
+    char line[MBED_CONF_EVENTS_DIAGNOSTICS_LINE_SIZE + 1];
+    char *reply = (char *)malloc(MBED_CONF_EVENTS_DIAGNOSTICS_REPLY_SIZE);
+    MBED_ASSERT(reply != NULL);
+    size_t len = 0;
+    bool overflow = false;
+
+    while (true) {
+        char c;
+        if (fh->read(&c, 1) != 1) {
+            break;
+        }
+
+        if (c != '\r' && c != '\n') {
+            if (len < MBED_CONF_EVENTS_DIAGNOSTICS_LINE_SIZE) {
+                line[len++] = c;
+            } else {
+                overflow = true;
+            }
+            continue;
+        }
+
+        int n;
+        if (overflow) {
+            n = snprintf(reply, MBED_CONF_EVENTS_DIAGNOSTICS_REPLY_SIZE, "line too long\n");
+        } else {
+            line[len] = '\0';
+            n = mbed_diag_command(line, reply, MBED_CONF_EVENTS_DIAGNOSTICS_REPLY_SIZE);
+        }
+        if (n >= (int)MBED_CONF_EVENTS_DIAGNOSTICS_REPLY_SIZE) {
+            n = MBED_CONF_EVENTS_DIAGNOSTICS_REPLY_SIZE - 1;
+        }
+        int i = 0;
+        while (i < n) {
+            ssize_t written = fh->write(reply + i, n - i);
+            if (written <= 0) {
+                break;
+            }
+            i += written;
+        }
+        if (i < n) {
+            break;
+        }
+        len = 0;
+        overflow = false;
+    }
+
+    free(reply);
+}
+
+}
@@ -0,0 +1,75 @@
+/** \addtogroup events */
+/** @{*/
+/* events
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MBED_DIAGNOSTICS_H
+#define MBED_DIAGNOSTICS_H
+
+#include <stddef.h>
+#include "platform/FileHandle.h"
+
+namespace mbed {
+
+/**
+ * Run a diagnostics command and format its reply as text.
+ *
+ * The commands are:
+ *  - threads: list the threads with their state, priority, stack size and
+ *    usage, and share of the cpu since the previous threads command
+ *  - queues: list the event queues with their name, dispatching thread,
+ *    buffer usage and allocated events
+ *  - prio THREAD PRIORITY: change the priority of a thread, given by its
+ *    id, its name, or the name of an event queue it dispatches
+ *  - help: list the commands
+ *
+ * Stack usage needs MBED_STACK_STATS_ENABLED and cpu shares need
+ * MBED_CPU_STATS_ENABLED, see mbed_stats.h. Event queues are only listed if
+ * events.diagnostics-enabled is set, and their allocation counts need
+ * events.stats-enabled too. Values that are not tracked are shown as -.
+ *
+ * The reply can be sent from a serial shell, see mbed_diag_console, or
+ * as the payload of a CoAP resource.
+ *
+ * @param line  Command line, without the line ending
+ * @param reply Buffer for the reply, which is always null-terminated
+ * @param size  Size of the reply buffer
+ * @return      Length of the full reply, which was cut if size or more
+ */
+int mbed_diag_command(const char *line, char *reply, size_t size);
+
+/**
+ * Serve diagnostics commands on a file handle, such as a UARTSerial.
+ *
+ * Reads command lines from the file handle, runs them with
+ * mbed_diag_command and writes the replies back, until reading fails.
+ * Lines are limited to events.diagnostics-line-size characters and replies
+ * to events.diagnostics-reply-size bytes. Meant to run in its own thread:
+ *
+ * @code
+ * UARTSerial serial(USBTX, USBRX, 115200);
+ * Thread console(osPriorityLow, 2048);
+ * console.start(callback(mbed_diag_console, (FileHandle *)&serial));
+ * @endcode
+ *
+ * @param fh    File handle to read commands from and write replies to
+ */
+void mbed_diag_console(FileHandle *fh);
+
+}
+
+#endif
+
+/** @}*/
@@ -27,8 +27,10 @@
 
 #include "events/EventQueue.h"
 #include "events/Event.h"
+#include "events/StaticEvent.h"
 
 #include "events/mbed_shared_queues.h"
+#include "events/mbed_diagnostics.h"
 
 using namespace events;
 
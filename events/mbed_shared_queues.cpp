@@ -28,7 +28,7 @@ namespace mbed {
  */
 template
 <osPriority Priority, size_t QueueSize, size_t StackSize>
-EventQueue *do_shared_event_queue_with_thread()
+EventQueue *do_shared_event_queue_with_thread(const char *name)
 {
     static uint64_t queue_buffer[QueueSize / sizeof(uint64_t)];
     static EventQueue queue(sizeof queue_buffer, (unsigned char *) queue_buffer);
@@ -38,6 +38,7 @@ EventQueue *do_shared_event_queue_with_thread()
 
     Thread::State state = thread.get_state();
     if (state == Thread::Inactive || state == Thread::Deleted) {
+        queue.set_name(name);
         osStatus status = thread.start(callback(&queue, &EventQueue::dispatch_forever));
         MBED_ASSERT(status == osOK);
         if (status != osOK) {
@@ -55,17 +56,18 @@ EventQueue *mbed_event_queue()
     /* Only create the EventQueue, but no dispatching thread */
     static unsigned char queue_buffer[MBED_CONF_EVENTS_SHARED_EVENTSIZE];
     static EventQueue queue(sizeof queue_buffer, queue_buffer);
+    queue.set_name("shared");
 
     return &queue;
 #else
-    return do_shared_event_queue_with_thread<osPriorityNormal, MBED_CONF_EVENTS_SHARED_EVENTSIZE, MBED_CONF_EVENTS_SHARED_STACKSIZE>();
+    return do_shared_event_queue_with_thread<osPriorityNormal, MBED_CONF_EVENTS_SHARED_EVENTSIZE, MBED_CONF_EVENTS_SHARED_STACKSIZE>("shared");
 #endif
 }
 
 #ifdef MBED_CONF_RTOS_PRESENT
 EventQueue *mbed_highprio_event_queue()
 {
-    return do_shared_event_queue_with_thread<osPriorityHigh, MBED_CONF_EVENTS_SHARED_HIGHPRIO_EVENTSIZE, MBED_CONF_EVENTS_SHARED_HIGHPRIO_STACKSIZE>();
+    return do_shared_event_queue_with_thread<osPriorityHigh, MBED_CONF_EVENTS_SHARED_HIGHPRIO_EVENTSIZE, MBED_CONF_EVENTS_SHARED_HIGHPRIO_STACKSIZE>("shared-highprio");
 }
 #endif
 
@@ -0,0 +1,409 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "mbed.h"
+#include "ble/GattClientCache.h"
+#include "greentea-client/test_env.h"
+#include "unity.h"
+#include "utest.h"
+
+using namespace utest::v1;
+
+#define CONNECTION      1
+#define MAX_RECORDS     (BLE_GATT_CLIENT_CACHE_MAX_SERVICES + BLE_GATT_CLIENT_CACHE_MAX_CHARACTERISTICS + 2)
+
+enum {
+    PROPS_READ      = 0x02,
+    PROPS_WRITE     = 0x08,
+    PROPS_NOTIFY    = 0x10,
+};
+
+/* Attribute table of the peer: a battery service and a custom service
+ * with a long UUID, each with characteristics.
+ */
+struct Attribute {
+    uint16_t shortUuid;         // 0 for the long UUID
+    uint8_t props;              // 0 for services
+    GattAttribute::Handle_t first;
+    GattAttribute::Handle_t second;
+    GattAttribute::Handle_t last;
+};
+
+static const UUID::LongUUIDBytes_t custom_uuid = {
+    0x6e, 0x40, 0x00, 0x01, 0xb5, 0xa3, 0xf3, 0x93, 0xe0, 0xa9, 0xe5, 0x0e, 0x24, 0xdc, 0xca, 0x9e,
+};
+
+static const Attribute peer_services[] = {
+    { 0x180f, 0, 1, 5, 5 },
+    { 0, 0, 6, 12, 12 },
+};
+
+static const Attribute peer_characteristics[] = {
+    { 0x2a19, PROPS_READ | PROPS_NOTIFY, 2, 3, 5 },
+    { 0, PROPS_WRITE, 7, 8, 9 },
+    { 0x2a00, PROPS_READ, 10, 11, 12 },
+};
+
+static UUID uuid_of(const Attribute &attribute) {
+    if (attribute.shortUuid) {
+        return UUID(attribute.shortUuid);
+    }
+    return UUID(custom_uuid);
+}
+
+class TestCharacteristic : public DiscoveredCharacteristic {
+public:
+    void setup(GattClient *client, const Attribute &attribute) {
+        gattc = client;
+        connHandle = CONNECTION;
+        uuid = uuid_of(attribute);
+        props._read = (attribute.props & PROPS_READ) ? 1 : 0;
+        props._write = (attribute.props & PROPS_WRITE) ? 1 : 0;
+        props._notify = (attribute.props & PROPS_NOTIFY) ? 1 : 0;
+        declHandle = attribute.first;
+        valueHandle = attribute.second;
+        lastHandle = attribute.last;
+    }
+};
+
+class TestGap : public Gap {
+public:
+    virtual ble_error_t setAdvertisingData(const GapAdvertisingData &, const GapAdvertisingData &) {
+        return BLE_ERROR_NONE;
+    }
+
+    virtual ble_error_t startAdvertising(const GapAdvertisingParams &) {
+        return BLE_ERROR_NONE;
+    }
+
+    void disconnect_peer() {
+        processDisconnectionEvent(CONNECTION, REMOTE_USER_TERMINATED_CONNECTION);
+    }
+};
+
+/* Client discovering the peer table when the test asks it to */
+class TestClient : public GattClient {
+public:
+    unsigned discoveries;
+    unsigned extra_services;
+
+    TestClient() : discoveries(0), extra_services(0) { }
+
+    virtual ble_error_t launchServiceDiscovery(Gap::Handle_t connectionHandle,
+                                               ServiceDiscovery::ServiceCallback_t sc,
+                                               ServiceDiscovery::CharacteristicCallback_t cc,
+                                               const UUID &matchingServiceUUID,
+                                               const UUID &matchingCharacteristicUUID) {
+        // the cache walks the whole table
+        TEST_ASSERT_EQUAL(CONNECTION, connectionHandle);
+        TEST_ASSERT_TRUE(matchingServiceUUID == UUID(UUID::ShortUUIDBytes_t(BLE_UUID_UNKNOWN)));
+        TEST_ASSERT_TRUE(matchingCharacteristicUUID == UUID(UUID::ShortUUIDBytes_t(BLE_UUID_UNKNOWN)));
+        discoveries++;
+        _sc = sc;
+        _cc = cc;
+        return BLE_ERROR_NONE;
+    }
+
+    virtual void onServiceDiscoveryTermination(ServiceDiscovery::TerminationCallback_t callback) {
+        _tc = callback;
+    }
+
+    virtual void terminateServiceDiscovery(void) {
+        _tc.call(CONNECTION);
+    }
+
+    // Reports the whole table, then the end of the discovery
+    void run() {
+        for (unsigned i = 0; i < sizeof(peer_services) / sizeof(peer_services[0]); i++) {
+            DiscoveredService service;
+            service.setup(uuid_of(peer_services[i]), peer_services[i].first, peer_services[i].second);
+            _sc.call(&service);
+
+            for (unsigned j = 0; j < sizeof(peer_characteristics) / sizeof(peer_characteristics[0]); j++) {
+                const Attribute &c = peer_characteristics[j];
+                if (c.first >= peer_services[i].first && c.first <= peer_services[i].second) {
+                    TestCharacteristic characteristic;
+                    characteristic.setup(this, c);
+                    _cc.call(&characteristic);
+                }
+            }
+        }
+
+        for (unsigned i = 0; i < extra_services; i++) {
+            DiscoveredService service;
+            service.setup(UUID(UUID::ShortUUIDBytes_t(0x1800 + i)), 0x100 + i, 0x100 + i);
+            _sc.call(&service);
+        }
+
+        _tc.call(CONNECTION);
+    }
+
+private:
+    ServiceDiscovery::ServiceCallback_t _sc;
+    ServiceDiscovery::CharacteristicCallback_t _cc;
+    ServiceDiscovery::TerminationCallback_t _tc;
+};
+
+/* Store holding a single value */
+class TestStore : public GattClientCache::Store {
+public:
+    TestStore() : _size(0) { }
+
+    void clear() {
+        _size = 0;
+    }
+
+    virtual int get(const char *key, void *buffer, size_t size, size_t *actualSize) {
+        if (!_size || strcmp(key, _key)) {
+            return -1;
+        }
+        memcpy(buffer, _value, size < _size ? size : _size);
+        *actualSize = _size;
+        return 0;
+    }
+
+    virtual int set(const char *key, const void *buffer, size_t size) {
+        TEST_ASSERT(size <= sizeof(_value));
+        strcpy(_key, key);
+        memcpy(_value, buffer, size);
+        _size = size;
+        return 0;
+    }
+
+    virtual int remove(const char *key) {
+        if (!_size || strcmp(key, _key)) {
+            return -1;
+        }
+        _size = 0;
+        return 0;
+    }
+
+private:
+    char _key[GattClientCache::KEY_SIZE];
+    uint8_t _value[2048];
+    size_t _size;
+};
+
+/* What the application callbacks saw */
+struct Record {
+    UUID uuid;
+    uint8_t props;
+    GattAttribute::Handle_t first;
+    GattAttribute::Handle_t second;
+    GattAttribute::Handle_t last;
+};
+
+namespace {
+    TestGap gap;
+    TestClient client;
+    TestStore store;
+
+    const BLEProtocol::AddressBytes_t peer_bytes = { 0x01, 0x02, 0x03, 0x04, 0x05, 0xc6 };
+    const BLEProtocol::AddressBytes_t other_bytes = { 0x01, 0x02, 0x03, 0x04, 0x05, 0xc7 };
+    const BLEProtocol::Address_t peer(BLEProtocol::AddressType::RANDOM_STATIC, peer_bytes);
+    const BLEProtocol::Address_t other(BLEProtocol::AddressType::RANDOM_STATIC, other_bytes);
+
+    Record records[MAX_RECORDS];
+    unsigned record_count;
+    unsigned terminations;
+}
+
+static void on_service(const DiscoveredService *service) {
+    TEST_ASSERT(record_count < MAX_RECORDS);
+    Record &r = records[record_count++];
+    r.uuid = service->getUUID();
+    r.props = 0;
+    r.first = service->getStartHandle();
+    r.second = service->getEndHandle();
+    r.last = service->getEndHandle();
+}
+
+static void on_characteristic(const DiscoveredCharacteristic *characteristic) {
+    TEST_ASSERT(record_count < MAX_RECORDS);
+    const DiscoveredCharacteristic::Properties_t &props = characteristic->getProperties();
+    Record &r = records[record_count++];
+    r.uuid = characteristic->getUUID();
+    r.props = (props.read() ? PROPS_READ : 0) | (props.write() ? PROPS_WRITE : 0) |
+              (props.notify() ? PROPS_NOTIFY : 0);
+    r.first = characteristic->getDeclHandle();
+    r.second = characteristic->getValueHandle();
+    r.last = characteristic->getLastHandle();
+    TEST_ASSERT_EQUAL(CONNECTION, characteristic->getConnectionHandle());
+    TEST_ASSERT_EQUAL_PTR(&client, characteristic->getGattClient());
+}
+
+static void on_termination(Gap::Handle_t handle) {
+    TEST_ASSERT_EQUAL(CONNECTION, handle);
+    terminations++;
+}
+
+static void expect(unsigned index, const Attribute &attribute) {
+    TEST_ASSERT(index < record_count);
+    const Record &r = records[index];
+    TEST_ASSERT_TRUE(r.uuid == uuid_of(attribute));
+    TEST_ASSERT_EQUAL(attribute.props, r.props);
+    TEST_ASSERT_EQUAL(attribute.first, r.first);
+    TEST_ASSERT_EQUAL(attribute.second, r.second);
+    TEST_ASSERT_EQUAL(attribute.last, r.last);
+}
+
+// Checks that the callbacks saw the whole table, in order
+static void expect_table() {
+    TEST_ASSERT_EQUAL(5, record_count);
+    expect(0, peer_services[0]);
+    expect(1, peer_characteristics[0]);
+    expect(2, peer_services[1]);
+    expect(3, peer_characteristics[1]);
+    expect(4, peer_characteristics[2]);
+    TEST_ASSERT_EQUAL(1, terminations);
+}
+
+static ble_error_t discover(GattClientCache &cache,
+                            const UUID &service = UUID(UUID::ShortUUIDBytes_t(BLE_UUID_UNKNOWN)),
+                            const UUID &characteristic = UUID(UUID::ShortUUIDBytes_t(BLE_UUID_UNKNOWN))) {
+    record_count = 0;
+    terminations = 0;
+    return cache.launchServiceDiscovery(CONNECTION, peer, on_service, on_characteristic, on_termination,
+                                        service, characteristic);
+}
+
+static void reset() {
+    store.clear();
+    client.discoveries = 0;
+    client.extra_services = 0;
+}
+
+void test_gatt_client_cache_hit() {
+    reset();
+    GattClientCache cache(gap, client, store);
+    TEST_ASSERT_FALSE(cache.contains(peer));
+
+    // the first discovery goes over the air
+    TEST_ASSERT_EQUAL(BLE_ERROR_NONE, discover(cache));
+    TEST_ASSERT_EQUAL(1, client.discoveries);
+    TEST_ASSERT_EQUAL(BLE_STACK_BUSY, discover(cache));
+    client.run();
+    expect_table();
+    TEST_ASSERT_TRUE(cache.contains(peer));
+    TEST_ASSERT_FALSE(cache.contains(other));
+
+    // the next ones are answered before they return, with the same table
+    TEST_ASSERT_EQUAL(BLE_ERROR_NONE, discover(cache));
+    expect_table();
+    TEST_ASSERT_EQUAL(1, client.discoveries);
+
+    // also by a new cache on the same store
+    GattClientCache restarted(gap, client, store);
+    TEST_ASSERT_EQUAL(BLE_ERROR_NONE, discover(restarted));
+    expect_table();
+    TEST_ASSERT_EQUAL(1, client.discoveries);
+}
+
+void test_gatt_client_cache_filter() {
+    reset();
+    GattClientCache cache(gap, client, store);
+
+    // filters apply both over the air and from the cache
+    for (int pass = 0; pass < 2; pass++) {
+        TEST_ASSERT_EQUAL(BLE_ERROR_NONE, discover(cache, UUID(custom_uuid)));
+        if (pass == 0) {
+            client.run();
+        }
+        TEST_ASSERT_EQUAL(3, record_count);
+        expect(0, peer_services[1]);
+        expect(1, peer_characteristics[1]);
+        expect(2, peer_characteristics[2]);
+
+        TEST_ASSERT_EQUAL(BLE_ERROR_NONE, discover(cache, UUID(UUID::ShortUUIDBytes_t(BLE_UUID_UNKNOWN)), UUID(UUID::ShortUUIDBytes_t(0x2a19))));
+        TEST_ASSERT_EQUAL(3, record_count);
+        expect(0, peer_services[0]);
+        expect(1, peer_characteristics[0]);
+        expect(2, peer_services[1]);
+        TEST_ASSERT_EQUAL(1, terminations);
+    }
+    TEST_ASSERT_EQUAL(1, client.discoveries);
+}
+
+void test_gatt_client_cache_invalidate() {
+    reset();
+    GattClientCache cache(gap, client, store);
+    discover(cache);
+    client.run();
+
+    TEST_ASSERT_EQUAL(BLE_ERROR_NONE, cache.invalidate(other));
+    TEST_ASSERT_TRUE(cache.contains(peer));
+    TEST_ASSERT_EQUAL(BLE_ERROR_NONE, cache.invalidate(peer));
+    TEST_ASSERT_FALSE(cache.contains(peer));
+
+    // invalidated during the discovery, the table is not stored
+    discover(cache);
+    TEST_ASSERT_EQUAL(2, client.discoveries);
+    cache.invalidate(peer);
+    client.run();
+    expect_table();
+    TEST_ASSERT_FALSE(cache.contains(peer));
+}
+
+void test_gatt_client_cache_partial() {
+    reset();
+    GattClientCache cache(gap, client, store);
+
+    // a discovery ended by a disconnection is not stored
+    discover(cache);
+    gap.disconnect_peer();
+    client.run();
+    TEST_ASSERT_EQUAL(1, terminations);
+    TEST_ASSERT_FALSE(cache.contains(peer));
+
+    // nor one terminated early
+    discover(cache);
+    cache.terminateServiceDiscovery();
+    TEST_ASSERT_EQUAL(1, terminations);
+    TEST_ASSERT_FALSE(cache.contains(peer));
+
+    // nor a table larger than the cache
+    client.extra_services = BLE_GATT_CLIENT_CACHE_MAX_SERVICES;
+    discover(cache);
+    client.run();
+    TEST_ASSERT_EQUAL(2 + BLE_GATT_CLIENT_CACHE_MAX_SERVICES + 3, record_count);
+    TEST_ASSERT_FALSE(cache.contains(peer));
+    TEST_ASSERT_EQUAL(3, client.discoveries);
+
+    // but a complete discovery is
+    client.extra_services = 0;
+    discover(cache);
+    client.run();
+    TEST_ASSERT_TRUE(cache.contains(peer));
+}
+
+
+// Test setup
+utest::v1::status_t test_setup(const size_t number_of_cases) {
+    GREENTEA_SETUP(20, "default_auto");
+    return verbose_test_setup_handler(number_of_cases);
+}
+
+Case cases[] = {
+    Case("GATT client cache hit", test_gatt_client_cache_hit),
+    Case("GATT client cache filters", test_gatt_client_cache_filter),
+    Case("GATT client cache invalidation", test_gatt_client_cache_invalidate),
+    Case("GATT client cache partial discoveries", test_gatt_client_cache_partial),
+};
+
+Specification specification(test_setup, cases);
+
+int main() {
+    return !Harness::run(specification);
+}
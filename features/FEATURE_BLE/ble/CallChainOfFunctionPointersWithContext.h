@@ -17,9 +17,56 @@
 #define MBED_CALLCHAIN_OF_FUNCTION_POINTERS_WITH_CONTEXT_H
 
 #include <string.h>
+#include <stdint.h>
+#include <new>
 #include "FunctionPointerWithContext.h"
 #include "SafeBool.h"
 
+/**
+ * Number of callbacks, shared by all callchains, which are stored in static
+ * memory rather than on the heap. Callbacks added once the pool is exhausted
+ * are allocated with new. Set to 0 to always use the heap.
+ */
+#ifndef BLE_CALLCHAIN_STATIC_NODES
+#define BLE_CALLCHAIN_STATIC_NODES 16
+#endif
+
+/**
+ * Fixed pool of storage for the callbacks of CallChainOfFunctionPointersWithContext.
+ *
+ * FunctionPointerWithContext has the same size whatever its context type,
+ * so one pool serves all the callchains.
+ *
+ * @note Like the rest of the BLE API, the pool must only be used from the
+ *       context which processes BLE events.
+ */
+class CallChainNodePool {
+public:
+    /**
+     * Size of a node of the pool.
+     */
+    static const size_t NODE_SIZE = sizeof(FunctionPointerWithContext<void *>);
+
+    /**
+     * Get storage for a callback.
+     *
+     * @return NODE_SIZE bytes of suitably aligned storage, or NULL if the
+     *         pool is exhausted.
+     */
+    static void *allocate(void);
+
+    /**
+     * Return storage obtained from allocate() to the pool.
+     *
+     * @param[in] node
+     *              The storage to release.
+     *
+     * @return true if @p node belongs to the pool and was released, false if
+     *         it was not taken from the pool.
+     */
+    static bool release(void *node);
+};
+
 
 /** Group one or more functions in an instance of a CallChainOfFunctionPointersWithContext, then call them in
  * sequence using CallChainOfFunctionPointersWithContext::call(). Used mostly by the interrupt chaining code,
@@ -84,7 +131,7 @@ public:
      * @return  The function object created for @p function.
      */
     pFunctionPointerWithContext_t add(void (*function)(ContextType context)) {
-        return common_add(new FunctionPointerWithContext<ContextType>(function));
+        return common_add(FunctionPointerWithContext<ContextType>(function));
     }
 
     /**
@@ -99,7 +146,7 @@ public:
      */
     template<typename T>
     pFunctionPointerWithContext_t add(T *tptr, void (T::*mptr)(ContextType context)) {
-        return common_add(new FunctionPointerWithContext<ContextType>(tptr, mptr));
+        return common_add(FunctionPointerWithContext<ContextType>(tptr, mptr));
     }
 
     /**
@@ -111,7 +158,7 @@ public:
      * @return  The function object created for @p func.
      */
     pFunctionPointerWithContext_t add(const FunctionPointerWithContext<ContextType>& func) {
-        return common_add(new FunctionPointerWithContext<ContextType>(func));
+        return common_add(func);
     }
 
     /**
@@ -142,7 +189,7 @@ public:
                     }
                     previous->chainAsNext(current->getNext());
                 }
-                delete current;
+                destroy(current);
                 return true;
             }
 
@@ -161,7 +208,7 @@ public:
         while (fptr) {
             pFunctionPointerWithContext_t deadPtr = fptr;
             fptr = deadPtr->getNext();
-            delete deadPtr;
+            destroy(deadPtr);
         }
 
         chainHead = NULL;
@@ -232,11 +279,24 @@ public:
 
 private:
     /**
-     * Add a callback to the head of the callchain.
+     * Add a copy of a callback to the head of the callchain. The copy is
+     * stored in the CallChainNodePool if it has room, else on the heap.
      *
      * @return A pointer to the head of the callchain.
      */
-    pFunctionPointerWithContext_t common_add(pFunctionPointerWithContext_t pf) {
+    pFunctionPointerWithContext_t common_add(const FunctionPointerWithContext<ContextType> &func) {
+        void *storage = NULL;
+        if (sizeof(FunctionPointerWithContext<ContextType>) <= CallChainNodePool::NODE_SIZE) {
+            storage = CallChainNodePool::allocate();
+        }
+
+        pFunctionPointerWithContext_t pf;
+        if (storage) {
+            pf = new (storage) FunctionPointerWithContext<ContextType>(func);
+        } else {
+            pf = new FunctionPointerWithContext<ContextType>(func);
+        }
+
         if (chainHead == NULL) {
             chainHead = pf;
         } else {
@@ -247,6 +307,16 @@ private:
         return chainHead;
     }
 
+    /**
+     * Free a callback created by common_add().
+     */
+    static void destroy(pFunctionPointerWithContext_t pf) {
+        pf->~FunctionPointerWithContext<ContextType>();
+        if (!CallChainNodePool::release(pf)) {
+            ::operator delete(pf);
+        }
+    }
+
 private:
     /**
      * A pointer to the first callback in the callchain or NULL if the callchain is empty.
@@ -21,6 +21,7 @@
 #include "GapAdvertisingData.h"
 #include "GapAdvertisingParams.h"
 #include "GapScanningParams.h"
+#include "GapScanFilter.h"
 #include "GapEvents.h"
 #include "CallChainOfFunctionPointersWithContext.h"
 #include "FunctionPointerWithContext.h"
@@ -284,6 +285,57 @@ public:
         {}
     };
 
+    /**
+     * Enumeration for the LE PHYs. Values can be ORed together to describe a
+     * set of PHYs. Refer to Gap::setPhy().
+     */
+    enum Phy_t {
+        PHY_1M    = 0x01, /**< LE 1M PHY. */
+        PHY_2M    = 0x02, /**< LE 2M PHY. */
+        PHY_CODED = 0x04, /**< LE Coded PHY. */
+    };
+
+    /**
+     * Structure that encapsulates the connection parameters in use after an
+     * update. Refer to Gap::onConnectionParamsUpdate().
+     */
+    struct ConnectionParamsUpdateCallbackParams_t {
+        Handle_t                  handle;           /**< The ID of the connection */
+        const ConnectionParams_t *connectionParams; /**< The parameters now in use, with minConnectionInterval equal to maxConnectionInterval */
+    };
+
+    /**
+     * Structure that encapsulates the result of a PHY update procedure.
+     * Refer to Gap::onPhyUpdate().
+     */
+    struct PhyUpdateCallbackParams_t {
+        Handle_t    handle; /**< The ID of the connection */
+        ble_error_t status; /**< BLE_ERROR_NONE if the procedure completed, else the PHYs did not change */
+        uint8_t     txPhy;  /**< The PHY used to transmit, see Phy_t */
+        uint8_t     rxPhy;  /**< The PHY used to receive, see Phy_t */
+    };
+
+    /**
+     * Structure that encapsulates the link layer data length in use on a
+     * connection. Refer to Gap::onDataLengthChange().
+     */
+    struct DataLengthCallbackParams_t {
+        Handle_t handle;      /**< The ID of the connection */
+        uint16_t maxTxOctets; /**< Maximum payload of a transmitted link layer PDU (27 to 251 bytes) */
+        uint16_t maxTxTime;   /**< Maximum time to transmit a link layer PDU (in microseconds) */
+        uint16_t maxRxOctets; /**< Maximum payload of a received link layer PDU (27 to 251 bytes) */
+        uint16_t maxRxTime;   /**< Maximum time to receive a link layer PDU (in microseconds) */
+    };
+
+    /**
+     * Structure that encapsulates the ATT_MTU in use on a connection.
+     * Refer to Gap::onAttMtuChange().
+     */
+    struct AttMtuCallbackParams_t {
+        Handle_t handle; /**< The ID of the connection */
+        uint16_t attMtu; /**< The ATT_MTU negotiated with the peer (in bytes) */
+    };
+
     static const uint16_t UNIT_1_25_MS  = 1250; /**< Number of microseconds in 1.25 milliseconds. */
     /**
      * Helper function to convert from units of milliseconds to GAP duration
@@ -328,6 +380,49 @@ public:
      */
     typedef CallChainOfFunctionPointersWithContext<const DisconnectionCallbackParams_t*> DisconnectionEventCallbackChain_t;
 
+    /**
+     * Type for the registered callbacks added to the connection parameters
+     * update event callchain. Refer to Gap::onConnectionParamsUpdate().
+     */
+    typedef FunctionPointerWithContext<const ConnectionParamsUpdateCallbackParams_t *> ConnectionParamsUpdateEventCallback_t;
+    /**
+     * Type for the connection parameters update event callchain. Refer to
+     * Gap::onConnectionParamsUpdate().
+     */
+    typedef CallChainOfFunctionPointersWithContext<const ConnectionParamsUpdateCallbackParams_t *> ConnectionParamsUpdateEventCallbackChain_t;
+
+    /**
+     * Type for the registered callbacks added to the PHY update event
+     * callchain. Refer to Gap::onPhyUpdate().
+     */
+    typedef FunctionPointerWithContext<const PhyUpdateCallbackParams_t *> PhyUpdateEventCallback_t;
+    /**
+     * Type for the PHY update event callchain. Refer to Gap::onPhyUpdate().
+     */
+    typedef CallChainOfFunctionPointersWithContext<const PhyUpdateCallbackParams_t *> PhyUpdateEventCallbackChain_t;
+
+    /**
+     * Type for the registered callbacks added to the data length change event
+     * callchain. Refer to Gap::onDataLengthChange().
+     */
+    typedef FunctionPointerWithContext<const DataLengthCallbackParams_t *> DataLengthEventCallback_t;
+    /**
+     * Type for the data length change event callchain. Refer to
+     * Gap::onDataLengthChange().
+     */
+    typedef CallChainOfFunctionPointersWithContext<const DataLengthCallbackParams_t *> DataLengthEventCallbackChain_t;
+
+    /**
+     * Type for the registered callbacks added to the ATT_MTU change event
+     * callchain. Refer to Gap::onAttMtuChange().
+     */
+    typedef FunctionPointerWithContext<const AttMtuCallbackParams_t *> AttMtuEventCallback_t;
+    /**
+     * Type for the ATT_MTU change event callchain. Refer to
+     * Gap::onAttMtuChange().
+     */
+    typedef CallChainOfFunctionPointersWithContext<const AttMtuCallbackParams_t *> AttMtuEventCallbackChain_t;
+
     /**
      * Type for the handlers of radio notification callback events. Refer to
      * Gap::onRadioNotification().
@@ -428,6 +523,33 @@ public:
         return BLE_ERROR_NOT_IMPLEMENTED; /* Requesting action from porter(s): override this API if this capability is supported. */
     }
 
+    /**
+     * Hand a rotation of advertising payloads to the stack, for controllers
+     * that can alternate several advertising sets without the application.
+     * The payloads are advertised in turn, each for its number of advertising
+     * events, with the current advertising parameters.
+     *
+     * @param[in] payloads
+     *              The payloads, copied by the stack.
+     * @param[in] events
+     *              Number of consecutive advertising events of each payload.
+     *              0 skips a payload.
+     * @param[in] count
+     *              Number of payloads. 0 returns to a single payload set
+     *              through Gap::setAdvertisingPayload().
+     *
+     * @return BLE_ERROR_NONE if the stack rotates the payloads, or
+     *         BLE_ERROR_NOT_IMPLEMENTED if the application has to do it.
+     */
+    virtual ble_error_t setAdvertisingSets(const GapAdvertisingData *payloads, const uint16_t *events, uint8_t count) {
+        /* Avoid compiler warnings about unused variables. */
+        (void)payloads;
+        (void)events;
+        (void)count;
+
+        return BLE_ERROR_NOT_IMPLEMENTED; /* Requesting action from porter(s): override this API if this capability is supported. */
+    }
+
     /**
      * Stop scanning. The current scanning parameters remain in effect.
      *
@@ -585,6 +707,52 @@ public:
         return BLE_ERROR_NOT_IMPLEMENTED; /* Requesting action from porter(s): override this API if this capability is supported. */
     }
 
+    /**
+     * Request a change of the PHYs used by a connection. The controller picks
+     * one PHY from each set, taking the peer's preferences into account. The
+     * outcome is reported through Gap::onPhyUpdate().
+     *
+     * @param[in] handle
+     *              Connection Handle.
+     * @param[in] txPhys
+     *              The PHYs acceptable to transmit on, a combination of Phy_t.
+     * @param[in] rxPhys
+     *              The PHYs acceptable to receive on, a combination of Phy_t.
+     *
+     * @return BLE_ERROR_NONE if the PHY update procedure was started.
+     */
+    virtual ble_error_t setPhy(Handle_t handle, uint8_t txPhys, uint8_t rxPhys) {
+        /* avoid compiler warnings about unused variables */
+        (void)handle;
+        (void)txPhys;
+        (void)rxPhys;
+
+        return BLE_ERROR_NOT_IMPLEMENTED; /* Requesting action from porter(s): override this API if this capability is supported. */
+    }
+
+    /**
+     * Start an ATT_MTU exchange with the peer, offering the largest ATT_MTU
+     * supported by the stack. The negotiated value is reported through
+     * Gap::onAttMtuChange(). Stacks which tie the link layer data length to
+     * the ATT_MTU report the new data length through
+     * Gap::onDataLengthChange().
+     *
+     * @param[in] handle
+     *              Connection Handle.
+     *
+     * @return BLE_ERROR_NONE if the exchange was started.
+     *
+     * @note Only the GATT client side of a connection can start the exchange;
+     *       peer-initiated exchanges are answered by the stack and reported
+     *       through the same event.
+     */
+    virtual ble_error_t negotiateAttMtu(Handle_t handle) {
+        /* avoid compiler warnings about unused variables */
+        (void)handle;
+
+        return BLE_ERROR_NOT_IMPLEMENTED; /* Requesting action from porter(s): override this API if this capability is supported. */
+    }
+
     /**
      * Set the device name characteristic in the GAP service.
      *
@@ -1334,6 +1502,24 @@ public:
         return BLE_ERROR_NONE;
     }
 
+    /**
+     * Get the filter applied to advertisement reports before they are passed
+     * to the callback given to startScan(). Reports are filtered in software
+     * by the BLE API, so that only the reports of interest reach the
+     * application.
+     *
+     * @return A reference to the scan filter.
+     *
+     * @note The filter persists across scans. The duplicate cache is
+     *       cleared when a scan starts.
+     *
+     * @note Filtering by address is the controller's job; refer to
+     *       setScanningPolicyMode() and setWhitelist().
+     */
+    GapScanFilter &getScanFilter(void) {
+        return _scanFilter;
+    }
+
     /**
      * Start scanning (Observer Procedure) based on the parameters currently in
      * effect.
@@ -1349,6 +1535,7 @@ public:
     ble_error_t startScan(void (*callback)(const AdvertisementCallbackParams_t *params)) {
         ble_error_t err = BLE_ERROR_NONE;
         if (callback) {
+            _scanFilter.clearDuplicates();
             if ((err = startRadioScan(_scanningParams)) == BLE_ERROR_NONE) {
                 scanningActive = true;
                 onAdvertisementReport.attach(callback);
@@ -1377,6 +1564,7 @@ public:
     ble_error_t startScan(T *object, void (T::*callbackMember)(const AdvertisementCallbackParams_t *params)) {
         ble_error_t err = BLE_ERROR_NONE;
         if (object && callbackMember) {
+            _scanFilter.clearDuplicates();
             if ((err = startRadioScan(_scanningParams)) == BLE_ERROR_NONE) {
                 scanningActive = true;
                 onAdvertisementReport.attach(object, callbackMember);
@@ -1579,6 +1767,158 @@ public:
         return disconnectionCallChain;
     }
 
+    /**
+     * Set up a callback for changes of the connection parameters, whether
+     * requested through Gap::updateConnectionParams() or by the peer.
+     *
+     * @param[in] callback
+     *              Event handler being registered.
+     */
+    void onConnectionParamsUpdate(ConnectionParamsUpdateEventCallback_t callback) {
+        connectionParamsUpdateCallChain.add(callback);
+    }
+
+    /**
+     * Same as Gap::onConnectionParamsUpdate(), but allows the possibility to
+     * add an object reference and member function as handler for connection
+     * parameters update event callbacks.
+     *
+     * @param[in] tptr
+     *              Pointer to the object of a class defining the member callback
+     *              function (@p mptr).
+     * @param[in] mptr
+     *              The member callback (within the context of an object) to be
+     *              invoked.
+     */
+    template<typename T>
+    void onConnectionParamsUpdate(T *tptr, void (T::*mptr)(const ConnectionParamsUpdateCallbackParams_t*)) {
+        connectionParamsUpdateCallChain.add(tptr, mptr);
+    }
+
+    /**
+     * @brief Provide access to the callchain of connection parameters update
+     * event callbacks.
+     *
+     * @return A reference to the connection parameters update event callback
+     *         chain.
+     */
+    ConnectionParamsUpdateEventCallbackChain_t& onConnectionParamsUpdate() {
+        return connectionParamsUpdateCallChain;
+    }
+
+    /**
+     * Set up a callback for the completion of a PHY update procedure, whether
+     * started locally through Gap::setPhy() or by the peer.
+     *
+     * @param[in] callback
+     *              Event handler being registered.
+     */
+    void onPhyUpdate(PhyUpdateEventCallback_t callback) {
+        phyUpdateCallChain.add(callback);
+    }
+
+    /**
+     * Same as Gap::onPhyUpdate(), but allows the possibility to add an object
+     * reference and member function as handler for PHY update event
+     * callbacks.
+     *
+     * @param[in] tptr
+     *              Pointer to the object of a class defining the member callback
+     *              function (@p mptr).
+     * @param[in] mptr
+     *              The member callback (within the context of an object) to be
+     *              invoked.
+     */
+    template<typename T>
+    void onPhyUpdate(T *tptr, void (T::*mptr)(const PhyUpdateCallbackParams_t*)) {
+        phyUpdateCallChain.add(tptr, mptr);
+    }
+
+    /**
+     * @brief Provide access to the callchain of PHY update event callbacks.
+     *
+     * @return A reference to the PHY update event callback chain.
+     */
+    PhyUpdateEventCallbackChain_t& onPhyUpdate() {
+        return phyUpdateCallChain;
+    }
+
+    /**
+     * Set up a callback for changes of the link layer data length of a
+     * connection (LE Data Length Extension).
+     *
+     * @param[in] callback
+     *              Event handler being registered.
+     */
+    void onDataLengthChange(DataLengthEventCallback_t callback) {
+        dataLengthCallChain.add(callback);
+    }
+
+    /**
+     * Same as Gap::onDataLengthChange(), but allows the possibility to add an
+     * object reference and member function as handler for data length change
+     * event callbacks.
+     *
+     * @param[in] tptr
+     *              Pointer to the object of a class defining the member callback
+     *              function (@p mptr).
+     * @param[in] mptr
+     *              The member callback (within the context of an object) to be
+     *              invoked.
+     */
+    template<typename T>
+    void onDataLengthChange(T *tptr, void (T::*mptr)(const DataLengthCallbackParams_t*)) {
+        dataLengthCallChain.add(tptr, mptr);
+    }
+
+    /**
+     * @brief Provide access to the callchain of data length change event
+     * callbacks.
+     *
+     * @return A reference to the data length change event callback chain.
+     */
+    DataLengthEventCallbackChain_t& onDataLengthChange() {
+        return dataLengthCallChain;
+    }
+
+    /**
+     * Set up a callback for the completion of an ATT_MTU exchange, whether
+     * started locally through Gap::negotiateAttMtu() or by the peer.
+     *
+     * @param[in] callback
+     *              Event handler being registered.
+     */
+    void onAttMtuChange(AttMtuEventCallback_t callback) {
+        attMtuCallChain.add(callback);
+    }
+
+    /**
+     * Same as Gap::onAttMtuChange(), but allows the possibility to add an
+     * object reference and member function as handler for ATT_MTU change
+     * event callbacks.
+     *
+     * @param[in] tptr
+     *              Pointer to the object of a class defining the member callback
+     *              function (@p mptr).
+     * @param[in] mptr
+     *              The member callback (within the context of an object) to be
+     *              invoked.
+     */
+    template<typename T>
+    void onAttMtuChange(T *tptr, void (T::*mptr)(const AttMtuCallbackParams_t*)) {
+        attMtuCallChain.add(tptr, mptr);
+    }
+
+    /**
+     * @brief Provide access to the callchain of ATT_MTU change event
+     * callbacks.
+     *
+     * @return A reference to the ATT_MTU change event callback chain.
+     */
+    AttMtuEventCallbackChain_t& onAttMtuChange() {
+        return attMtuCallChain;
+    }
+
     /**
      * Set the application callback for radio-notification events.
      *
@@ -1702,11 +2042,16 @@ public:
         /* Clear advertising and scanning data */
         _advPayload.clear();
         _scanResponse.clear();
+        _scanFilter.clear();
 
         /* Clear callbacks */
         timeoutCallbackChain.clear();
         connectionCallChain.clear();
         disconnectionCallChain.clear();
+        connectionParamsUpdateCallChain.clear();
+        phyUpdateCallChain.clear();
+        dataLengthCallChain.clear();
+        attMtuCallChain.clear();
         radioNotificationCallback = NULL;
         onAdvertisementReport     = NULL;
 
@@ -1722,6 +2067,7 @@ protected:
         _advPayload(),
         _scanningParams(),
         _scanResponse(),
+        _scanFilter(),
         connectionCount(0),
         state(),
         scanningActive(false),
@@ -1729,7 +2075,11 @@ protected:
         radioNotificationCallback(),
         onAdvertisementReport(),
         connectionCallChain(),
-        disconnectionCallChain() {
+        disconnectionCallChain(),
+        connectionParamsUpdateCallChain(),
+        phyUpdateCallChain(),
+        dataLengthCallChain(),
+        attMtuCallChain() {
         _advPayload.clear();
         _scanResponse.clear();
     }
@@ -1817,6 +2167,11 @@ public:
                                     GapAdvertisingParams::AdvertisingType_t  type,
                                     uint8_t                                  advertisingDataLen,
                                     const uint8_t                           *advertisingData) {
+        if (_scanFilter.isActive() &&
+            !_scanFilter.accept(peerAddr, rssi, isScanResponse, advertisingDataLen, advertisingData)) {
+            return;
+        }
+
         AdvertisementCallbackParams_t params;
         memcpy(params.peerAddr, peerAddr, ADDR_LEN);
         params.rssi               = rssi;
@@ -1845,6 +2200,67 @@ public:
         }
     }
 
+    /**
+     * Helper function that notifies all registered handlers of a change of
+     * the connection parameters. This function is meant to be called from
+     * the BLE stack specific implementation.
+     *
+     * @param[in] handle
+     *              Handle of the connection whose parameters changed.
+     * @param[in] connectionParams
+     *              The parameters now in use.
+     */
+    void processConnectionParamsUpdateEvent(Handle_t handle, const ConnectionParams_t *connectionParams) {
+        ConnectionParamsUpdateCallbackParams_t callbackParams = { handle, connectionParams };
+        connectionParamsUpdateCallChain.call(&callbackParams);
+    }
+
+    /**
+     * Helper function that notifies all registered handlers of the completion
+     * of a PHY update procedure. This function is meant to be called from the
+     * BLE stack specific implementation.
+     *
+     * @param[in] handle
+     *              Handle of the connection whose PHYs were updated.
+     * @param[in] status
+     *              BLE_ERROR_NONE if the procedure completed.
+     * @param[in] txPhy
+     *              The PHY now used to transmit.
+     * @param[in] rxPhy
+     *              The PHY now used to receive.
+     */
+    void processPhyUpdateEvent(Handle_t handle, ble_error_t status, uint8_t txPhy, uint8_t rxPhy) {
+        PhyUpdateCallbackParams_t callbackParams = { handle, status, txPhy, rxPhy };
+        phyUpdateCallChain.call(&callbackParams);
+    }
+
+    /**
+     * Helper function that notifies all registered handlers of a change of
+     * the link layer data length of a connection. This function is meant to
+     * be called from the BLE stack specific implementation.
+     *
+     * @param[in] params
+     *              The new data length of the connection.
+     */
+    void processDataLengthChangeEvent(const DataLengthCallbackParams_t *params) {
+        dataLengthCallChain.call(params);
+    }
+
+    /**
+     * Helper function that notifies all registered handlers of the completion
+     * of an ATT_MTU exchange. This function is meant to be called from the
+     * BLE stack specific implementation.
+     *
+     * @param[in] handle
+     *              Handle of the connection whose ATT_MTU was negotiated.
+     * @param[in] attMtu
+     *              The ATT_MTU in use on the connection.
+     */
+    void processAttMtuChangeEvent(Handle_t handle, uint16_t attMtu) {
+        AttMtuCallbackParams_t callbackParams = { handle, attMtu };
+        attMtuCallChain.call(&callbackParams);
+    }
+
 protected:
     /**
      * Currently set advertising parameters.
@@ -1862,6 +2278,10 @@ protected:
      * Currently set scan response data.
      */
     GapAdvertisingData               _scanResponse;
+    /**
+     * Filter applied to advertisement reports.
+     */
+    GapScanFilter                    _scanFilter;
 
     /**
      * Total number of open connections.
@@ -1902,6 +2322,26 @@ protected:
      * events.
      */
     DisconnectionEventCallbackChain_t disconnectionCallChain;
+    /**
+     * Callchain containing all registered callback handlers for connection
+     * parameters update events.
+     */
+    ConnectionParamsUpdateEventCallbackChain_t connectionParamsUpdateCallChain;
+    /**
+     * Callchain containing all registered callback handlers for PHY update
+     * events.
+     */
+    PhyUpdateEventCallbackChain_t     phyUpdateCallChain;
+    /**
+     * Callchain containing all registered callback handlers for data length
+     * change events.
+     */
+    DataLengthEventCallbackChain_t    dataLengthCallChain;
+    /**
+     * Callchain containing all registered callback handlers for ATT_MTU
+     * change events.
+     */
+    AttMtuEventCallbackChain_t        attMtuCallChain;
 
 private:
     /**
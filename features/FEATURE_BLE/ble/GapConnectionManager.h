@@ -0,0 +1,222 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2006-2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __GAP_CONNECTION_MANAGER_H__
+#define __GAP_CONNECTION_MANAGER_H__
+
+#include "Gap.h"
+
+/**
+ * Maximum number of links managed as a central.
+ */
+#ifndef BLE_GAP_CONNECTION_MANAGER_MAX_LINKS
+#define BLE_GAP_CONNECTION_MANAGER_MAX_LINKS 8
+#endif
+
+/**
+ * Maximum number of connection requests waiting for the current attempt to
+ * end.
+ */
+#ifndef BLE_GAP_CONNECTION_MANAGER_MAX_PENDING
+#define BLE_GAP_CONNECTION_MANAGER_MAX_PENDING 8
+#endif
+
+/**
+ * Central side manager of several connections.
+ *
+ * Gap::connect() runs a single connection attempt, so the manager queues
+ * connection requests and starts each one when the previous attempt ends in
+ * a connection or a timeout.
+ *
+ * The controller schedules the connection events of every link in the same
+ * radio timeline. When the links use unrelated intervals their events
+ * collide and are skipped, which is what makes the throughput of a busy
+ * gateway collapse. The manager gives all the links the same interval, long
+ * enough to hold one connection event of each link back to back, and
+ * updates the interval as links come and go.
+ */
+class GapConnectionManager {
+public:
+    /**
+     * Scheduling state and statistics of a link.
+     */
+    struct LinkStatistics_t {
+        Gap::Handle_t               handle;             /**< The ID of the connection */
+        BLEProtocol::AddressType_t  peerAddrType;       /**< The peer's address type */
+        BLEProtocol::AddressBytes_t peerAddr;           /**< The peer's address */
+        uint16_t                    connectionInterval; /**< Interval in use, in 1.25 ms units */
+        uint16_t                    slaveLatency;       /**< Slave latency in use, in connection events */
+        uint16_t                    supervisionTimeout; /**< Supervision timeout in use, in 10 ms units */
+        uint16_t                    targetInterval;     /**< Interval requested by the manager, in 1.25 ms units */
+        uint16_t                    parameterUpdates;   /**< Number of connection parameter changes */
+        uint16_t                    updateFailures;     /**< Number of update requests rejected by the stack */
+    };
+
+    /**
+     * Counters of the connection attempts.
+     */
+    struct Statistics_t {
+        uint16_t attempts;  /**< Connection attempts started */
+        uint16_t failures;  /**< Attempts which timed out or failed to start */
+        uint16_t pending;   /**< Requests waiting for the current attempt */
+        uint8_t  links;     /**< Links currently managed */
+    };
+
+public:
+    /**
+     * Construct a connection manager. It registers itself with the Gap
+     * events, and must outlive its use.
+     *
+     * @param[in] gap
+     *              The Gap instance establishing the connections.
+     */
+    GapConnectionManager(Gap &gap);
+
+    ~GapConnectionManager();
+
+    /**
+     * Configure how the connection events are scheduled.
+     *
+     * @param[in] eventLength
+     *              Radio time reserved for each link in every interval, in
+     *              1.25 ms units. The interval of N links is at least N times
+     *              this value.
+     * @param[in] minInterval
+     *              Shortest interval used, in 1.25 ms units.
+     * @param[in] slaveLatency
+     *              Slave latency of every link.
+     * @param[in] supervisionTimeout
+     *              Supervision timeout of every link, in 10 ms units. It is
+     *              raised if needed to stay valid for the interval in use.
+     *
+     * @return BLE_ERROR_NONE, or BLE_ERROR_PARAM_OUT_OF_RANGE if a value is
+     *         outside the limits of the specification.
+     */
+    ble_error_t setSchedule(uint16_t eventLength,
+                            uint16_t minInterval,
+                            uint16_t slaveLatency,
+                            uint16_t supervisionTimeout);
+
+    /**
+     * Request a connection to a peripheral. The attempt starts right away,
+     * or after the attempts requested before it.
+     *
+     * @param[in] peerAddr
+     *              48-bit address of the peripheral, LSB format.
+     * @param[in] peerAddrType
+     *              Address type of the peripheral.
+     * @param[in] scanParams
+     *              Parameters used while scanning for the peripheral, or NULL
+     *              for the Gap defaults. The parameters must stay valid until
+     *              the attempt starts.
+     *
+     * @return BLE_ERROR_NONE if the request was started or queued,
+     *         BLE_ERROR_NO_MEM if the links and the queue are full, or the
+     *         error of Gap::connect() when the attempt could not start
+     *         right away.
+     */
+    ble_error_t connect(const BLEProtocol::AddressBytes_t  peerAddr,
+                        BLEProtocol::AddressType_t         peerAddrType,
+                        const GapScanningParams           *scanParams = NULL);
+
+    /**
+     * Drop the requests which have not started yet.
+     */
+    void clearPending(void);
+
+    /**
+     * Get the interval the manager gives to a number of links.
+     *
+     * @param[in] links
+     *              The number of links.
+     *
+     * @return The interval, in 1.25 ms units.
+     */
+    uint16_t getIntervalForLinks(uint8_t links) const;
+
+    /**
+     * Get the number of links managed.
+     *
+     * @return The number of central links established through the manager.
+     */
+    uint8_t getLinkCount(void) const {
+        return _linkCount;
+    }
+
+    /**
+     * Get the scheduling state of a link.
+     *
+     * @param[in] index
+     *              Index of the link, below getLinkCount().
+     *
+     * @return The statistics of the link, or NULL if @p index is out of range.
+     */
+    const LinkStatistics_t *getLinkStatistics(uint8_t index) const {
+        return (index < _linkCount) ? &_links[index] : NULL;
+    }
+
+    /**
+     * Get the counters of the connection attempts.
+     *
+     * @param[out] statistics
+     *              Filled with the current counters.
+     */
+    void getStatistics(Statistics_t *statistics) const;
+
+private:
+    struct PendingConnection_t {
+        BLEProtocol::AddressBytes_t  peerAddr;
+        BLEProtocol::AddressType_t   peerAddrType;
+        const GapScanningParams     *scanParams;
+    };
+
+    void makeParams(uint8_t links, Gap::ConnectionParams_t *params) const;
+    ble_error_t startAttempt(void);
+    void startNext(void);
+    void reschedule(void);
+    int findLink(Gap::Handle_t handle) const;
+
+    void onConnection(const Gap::ConnectionCallbackParams_t *params);
+    void onDisconnection(const Gap::DisconnectionCallbackParams_t *params);
+    void onTimeout(Gap::TimeoutSource_t source);
+    void onConnectionParamsUpdate(const Gap::ConnectionParamsUpdateCallbackParams_t *params);
+
+    /* Disallow copy and assignment. */
+    GapConnectionManager(const GapConnectionManager &);
+    GapConnectionManager& operator=(const GapConnectionManager &);
+
+private:
+    Gap                 &_gap;
+
+    uint16_t             _eventLength;
+    uint16_t             _minInterval;
+    uint16_t             _slaveLatency;
+    uint16_t             _supervisionTimeout;
+
+    bool                 _attemptActive;
+    PendingConnection_t  _attempt;
+    PendingConnection_t  _pending[BLE_GAP_CONNECTION_MANAGER_MAX_PENDING];
+    uint8_t              _pendingHead;
+    uint8_t              _pendingCount;
+
+    LinkStatistics_t     _links[BLE_GAP_CONNECTION_MANAGER_MAX_LINKS];
+    uint8_t              _linkCount;
+
+    uint16_t             _attempts;
+    uint16_t             _failures;
+};
+
+#endif /* ifndef __GAP_CONNECTION_MANAGER_H__ */
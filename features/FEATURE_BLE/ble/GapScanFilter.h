@@ -0,0 +1,171 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2006-2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __GAP_SCAN_FILTER_H__
+#define __GAP_SCAN_FILTER_H__
+
+#include "blecommon.h"
+#include "BLEProtocol.h"
+#include "UUID.h"
+
+/**
+ * Number of advertisers remembered for duplicate suppression. When more
+ * devices than this are in range, the oldest entries are evicted and their
+ * next report is delivered again.
+ */
+#ifndef BLE_GAP_SCAN_DUPLICATE_CACHE_SIZE
+#define BLE_GAP_SCAN_DUPLICATE_CACHE_SIZE 32
+#endif
+
+/**
+ * Maximum length of the manufacturer data prefix matched by
+ * GapScanFilter::setManufacturerData().
+ */
+#ifndef BLE_GAP_SCAN_FILTER_MANUFACTURER_DATA_MAX
+#define BLE_GAP_SCAN_FILTER_MANUFACTURER_DATA_MAX 8
+#endif
+
+/**
+ * Filter applied by Gap to advertisement reports before they reach the
+ * application's scan callback. Refer to Gap::setScanFilter().
+ *
+ * A report is delivered when it passes all the configured criteria:
+ * - its RSSI is at least the RSSI threshold,
+ * - its payload lists the service UUID in a 16-bit or 128-bit service list,
+ * - its manufacturer specific data starts with the configured prefix,
+ * - the same payload was not already received from the same advertiser
+ *   within the duplicate window.
+ */
+class GapScanFilter {
+public:
+    /**
+     * Construct a filter which accepts every report.
+     */
+    GapScanFilter();
+
+    /**
+     * Only accept reports received at or above an RSSI.
+     *
+     * @param[in] minRssi
+     *              The RSSI threshold in dBm. -128 accepts every report.
+     */
+    void setRssiThreshold(int8_t minRssi) {
+        _minRssi = minRssi;
+    }
+
+    /**
+     * Only accept reports which advertise a service.
+     *
+     * @param[in] uuid
+     *              The service UUID to look for.
+     */
+    void setServiceUuid(const UUID &uuid);
+
+    /**
+     * Only accept reports whose manufacturer specific data starts with a
+     * prefix, usually the company identifier followed by a beacon type.
+     *
+     * @param[in] prefix
+     *              The bytes to match, in the order of the payload.
+     * @param[in] len
+     *              Length of @p prefix. 0 removes the criterion.
+     *
+     * @return BLE_ERROR_NONE, or BLE_ERROR_PARAM_OUT_OF_RANGE if @p len is
+     *         larger than BLE_GAP_SCAN_FILTER_MANUFACTURER_DATA_MAX.
+     */
+    ble_error_t setManufacturerData(const uint8_t *prefix, uint8_t len);
+
+    /**
+     * Drop repeated reports of an unchanged payload from the same
+     * advertiser.
+     *
+     * @param[in] windowInMs
+     *              How long a payload is considered a duplicate after it
+     *              was delivered. 0 disables duplicate suppression.
+     */
+    void setDuplicateWindow(uint16_t windowInMs) {
+        _duplicateWindow = windowInMs;
+        clearDuplicates();
+    }
+
+    /**
+     * Forget the advertisers seen so far, so their next report is delivered.
+     */
+    void clearDuplicates(void);
+
+    /**
+     * Remove all the criteria, so that every report is accepted.
+     */
+    void clear(void);
+
+    /**
+     * Check whether any criterion is set.
+     *
+     * @return true if some reports may be dropped.
+     */
+    bool isActive(void) const {
+        return _minRssi != -128 || _uuidLen || _manufacturerDataLen || _duplicateWindow;
+    }
+
+    /**
+     * Check an advertisement report against the filter. Accepted reports are
+     * recorded for duplicate suppression.
+     *
+     * @param[in] peerAddr
+     *              The advertiser's address.
+     * @param[in] rssi
+     *              The RSSI of the report.
+     * @param[in] isScanResponse
+     *              Whether the report is a scan response.
+     * @param[in] advertisingDataLen
+     *              The length of the payload.
+     * @param[in] advertisingData
+     *              The payload.
+     *
+     * @return true if the report should be delivered to the application.
+     */
+    bool accept(const BLEProtocol::AddressBytes_t  peerAddr,
+                int8_t                             rssi,
+                bool                               isScanResponse,
+                uint8_t                            advertisingDataLen,
+                const uint8_t                     *advertisingData);
+
+private:
+    bool matchServiceUuid(uint8_t advertisingDataLen, const uint8_t *advertisingData) const;
+    bool matchManufacturerData(uint8_t advertisingDataLen, const uint8_t *advertisingData) const;
+    bool isDuplicate(const BLEProtocol::AddressBytes_t peerAddr, bool isScanResponse,
+                     uint8_t advertisingDataLen, const uint8_t *advertisingData);
+
+private:
+    struct DuplicateEntry_t {
+        BLEProtocol::AddressBytes_t address;        /**< Advertiser address */
+        bool                        isScanResponse; /**< Whether the entry tracks scan responses */
+        uint16_t                    checksum;       /**< Checksum of the payload */
+        uint32_t                    time;           /**< Time of the last delivered report, in us */
+    };
+
+    int8_t              _minRssi;
+    uint8_t             _uuidLen;
+    uint8_t             _uuid[UUID::LENGTH_OF_LONG_UUID];
+    uint8_t             _manufacturerDataLen;
+    uint8_t             _manufacturerData[BLE_GAP_SCAN_FILTER_MANUFACTURER_DATA_MAX];
+    uint16_t            _duplicateWindow;
+    uint16_t            _duplicateCount;
+    uint16_t            _duplicateNext;
+    DuplicateEntry_t    _duplicates[BLE_GAP_SCAN_DUPLICATE_CACHE_SIZE];
+};
+
+#endif /* ifndef __GAP_SCAN_FILTER_H__ */
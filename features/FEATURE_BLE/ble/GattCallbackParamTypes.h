@@ -112,4 +112,14 @@ struct GattHVXCallbackParams {
   const uint8_t           *data;       /**< Attribute data, variable length. */
 };
 
+/**
+ * For reporting the end of a batch of GATT client operations. Refer to
+ * GattClient::readBatch() and GattClient::writeBatch().
+ */
+struct GattBatchCallbackParams {
+    Gap::Handle_t            connHandle; /**< The handle of the connection on which the batch ran. */
+    uint8_t                  completed;  /**< Number of operations completed, in order. */
+    ble_error_t              status;     /**< BLE_ERROR_NONE, or the error which stopped the batch. */
+};
+
 #endif /*__GATT_CALLBACK_PARAM_TYPES_H__*/
@@ -76,6 +76,21 @@ public:
      */
     typedef CallChainOfFunctionPointersWithContext<const GattClient *> GattClientShutdownCallbackChain_t;
 
+    /**
+     * Type for the callback invoked at the end of a batch of operations.
+     * Refer to GattClient::readBatch() and GattClient::writeBatch().
+     */
+    typedef FunctionPointerWithContext<const GattBatchCallbackParams*> BatchCallback_t;
+
+    /**
+     * One write of a batch. Refer to GattClient::writeBatch().
+     */
+    struct BatchWrite_t {
+        GattAttribute::Handle_t  handle; /**< Handle of the attribute to write. */
+        uint16_t                 len;    /**< Length of the value. */
+        const uint8_t           *value;  /**< The value, which must stay valid until the batch ends. */
+    };
+
     /*
      * The following functions are meant to be overridden in the platform-specific sub-class.
      */
@@ -297,6 +312,105 @@ public:
         return BLE_ERROR_NOT_IMPLEMENTED; /* Requesting action from porters: override this API if this capability is supported. */
     }
 
+    /**
+     * Read several attributes with a single ATT Read Multiple request.
+     *
+     * The response is reported through onDataRead() as a single event, with
+     * the handle of the first attribute and the values concatenated in
+     * order. The values carry no length, so this is only usable when the
+     * lengths of all but the last value are known; readBatch() reports the
+     * values separately.
+     *
+     * @param[in] connHandle
+     *              Handle for the connection with the peer.
+     * @param[in] handles
+     *              Handles of the attributes to read.
+     * @param[in] count
+     *              Number of handles, at least 2.
+     *
+     * @return
+     *          BLE_ERROR_NONE if the read procedure was successfully started.
+     */
+    virtual ble_error_t readMultiple(Gap::Handle_t                  connHandle,
+                                     const GattAttribute::Handle_t *handles,
+                                     uint8_t                        count) const {
+        /* Avoid compiler warnings about unused variables. */
+        (void)connHandle;
+        (void)handles;
+        (void)count;
+
+        return BLE_ERROR_NOT_IMPLEMENTED; /* Requesting action from porters: override this API if this capability is supported. */
+    }
+
+    /**
+     * Read several attributes one after the other. Each value is reported
+     * through onDataRead() as for read(), and each request is sent as soon
+     * as the previous response is received, without a round trip through
+     * the application.
+     *
+     * @param[in] connHandle
+     *              Handle for the connection with the peer.
+     * @param[in] handles
+     *              Handles of the attributes to read. The array must stay
+     *              valid until the batch ends.
+     * @param[in] count
+     *              Number of handles.
+     * @param[in] callback
+     *              Invoked once all the values are read, or on the first
+     *              error.
+     *
+     * @return BLE_ERROR_NONE if the batch started, BLE_STACK_BUSY if another
+     *         batch is running, or the error of the first read.
+     */
+    ble_error_t readBatch(Gap::Handle_t                  connHandle,
+                          const GattAttribute::Handle_t *handles,
+                          uint8_t                        count,
+                          BatchCallback_t                callback = NULL) {
+        return startBatch(connHandle, false, GATT_OP_WRITE_REQ, handles, NULL, count, callback);
+    }
+
+    /**
+     * Write several attributes with the same operation.
+     *
+     * Write commands are handed to the stack as long as it has transmit
+     * buffers, and the batch resumes as buffers are released, so several
+     * commands share each connection event. Write requests are sent one
+     * after the other, each as soon as the previous response is received.
+     * The responses are reported through onDataWritten() as for write().
+     *
+     * @param[in] cmd
+     *              The write operation used for all the writes.
+     * @param[in] connHandle
+     *              Handle for the connection with the peer.
+     * @param[in] writes
+     *              The writes. The array and the values must stay valid until
+     *              the batch ends.
+     * @param[in] count
+     *              Number of writes.
+     * @param[in] callback
+     *              Invoked once all the writes are done, or on the first
+     *              error.
+     *
+     * @return BLE_ERROR_NONE if the batch started, BLE_STACK_BUSY if another
+     *         batch is running, or the error of the first write.
+     */
+    ble_error_t writeBatch(GattClient::WriteOp_t  cmd,
+                           Gap::Handle_t          connHandle,
+                           const BatchWrite_t    *writes,
+                           uint8_t                count,
+                           BatchCallback_t        callback = NULL) {
+        return startBatch(connHandle, true, cmd, NULL, writes, count, callback);
+    }
+
+    /**
+     * Check whether a batch of operations is running.
+     *
+     * @return true if readBatch() or writeBatch() has not completed yet.
+     */
+    bool isBatchActive(void) const {
+        return batchActive;
+    }
+
     /* Event callback handlers. */
 public:
     /**
@@ -544,11 +658,22 @@ public:
         onDataWriteCallbackChain.clear();
         onHVXCallbackChain.clear();
 
+        batchActive = false;
+
         return BLE_ERROR_NONE;
     }
 
 protected:
-    GattClient() {
+    GattClient() :
+        batchActive(false),
+        batchIsWrite(false),
+        batchWriteOp(GATT_OP_WRITE_REQ),
+        batchConnHandle(),
+        batchHandles(NULL),
+        batchWrites(NULL),
+        batchCount(0),
+        batchIndex(0),
+        batchCallback() {
         /* Empty */
     }
 
@@ -565,6 +690,13 @@ public:
      */
     void processReadResponse(const GattReadCallbackParams *params) {
         onDataReadCallbackChain(params);
+
+        if (batchActive && !batchIsWrite &&
+            params->connHandle == batchConnHandle &&
+            params->handle == batchHandles[batchIndex]) {
+            batchIndex++;
+            continueBatch();
+        }
     }
 
     /**
@@ -578,6 +710,28 @@ public:
      */
     void processWriteResponse(const GattWriteCallbackParams *params) {
         onDataWriteCallbackChain(params);
+
+        if (batchActive && batchIsWrite && batchWriteOp == GATT_OP_WRITE_REQ &&
+            params->connHandle == batchConnHandle &&
+            params->handle == batchWrites[batchIndex].handle) {
+            batchIndex++;
+            continueBatch();
+        }
+    }
+
+    /**
+     * Helper function that resumes a batch of write commands. This function
+     * is meant to be called from the BLE stack specific implementation when
+     * transmit buffers are released.
+     *
+     * @param[in] connHandle
+     *              The connection on which packets were transmitted.
+     */
+    void processDataSentEvent(Gap::Handle_t connHandle) {
+        if (batchActive && batchIsWrite && batchWriteOp == GATT_OP_WRITE_CMD &&
+            connHandle == batchConnHandle) {
+            continueBatch();
+        }
     }
 
     /**
@@ -617,6 +771,102 @@ protected:
      */
     GattClientShutdownCallbackChain_t shutdownCallChain;
 
+private:
+    ble_error_t startBatch(Gap::Handle_t                  connHandle,
+                           bool                           isWrite,
+                           GattClient::WriteOp_t          cmd,
+                           const GattAttribute::Handle_t *handles,
+                           const BatchWrite_t            *writes,
+                           uint8_t                        count,
+                           BatchCallback_t                callback) {
+        if (batchActive) {
+            return BLE_STACK_BUSY;
+        }
+
+        batchIsWrite    = isWrite;
+        batchWriteOp    = cmd;
+        batchConnHandle = connHandle;
+        batchHandles    = handles;
+        batchWrites     = writes;
+        batchCount      = count;
+        batchIndex      = 0;
+        batchCallback   = callback;
+        batchActive     = true;
+
+        ble_error_t err = issueBatch();
+        if (err != BLE_ERROR_NONE && batchIndex == 0 && !isOutOfBuffers(err)) {
+            /* Nothing happened, report the error to the caller only */
+            batchActive = false;
+            return err;
+        }
+        settleBatch(err);
+        return BLE_ERROR_NONE;
+    }
+
+    /* Issue operations until one needs an event. Returns the first error. */
+    ble_error_t issueBatch(void) {
+        while (batchIndex < batchCount) {
+            if (!batchIsWrite) {
+                return read(batchConnHandle, batchHandles[batchIndex], 0);
+            }
+
+            const BatchWrite_t &w = batchWrites[batchIndex];
+            ble_error_t err = write(batchWriteOp, batchConnHandle, w.handle, w.len, w.value);
+            if (batchWriteOp == GATT_OP_WRITE_REQ || err != BLE_ERROR_NONE) {
+                return err;
+            }
+            batchIndex++;
+        }
+        return BLE_ERROR_NONE;
+    }
+
+    /* Write commands wait for transmit buffers rather than failing */
+    bool isOutOfBuffers(ble_error_t err) const {
+        return batchIsWrite && batchWriteOp == GATT_OP_WRITE_CMD &&
+               (err == BLE_ERROR_NO_MEM || err == BLE_STACK_BUSY);
+    }
+
+    void continueBatch(void) {
+        settleBatch(issueBatch());
+    }
+
+    void settleBatch(ble_error_t err) {
+        if (err == BLE_ERROR_NONE && batchIndex < batchCount) {
+            /* Waiting for a response */
+            return;
+        }
+        if (isOutOfBuffers(err)) {
+            /* Resumed by processDataSentEvent() */
+            return;
+        }
+        endBatch(err);
+    }
+
+    void endBatch(ble_error_t status) {
+        GattBatchCallbackParams params = {
+            /* .connHandle = */ batchConnHandle,
+            /* .completed  = */ batchIndex,
+            /* .status     = */ status
+        };
+
+        /* The callback may start the next batch */
+        batchActive = false;
+        if (batchCallback) {
+            batchCallback(&params);
+        }
+    }
+
+private:
+    bool                           batchActive;
+    bool                           batchIsWrite;
+    GattClient::WriteOp_t          batchWriteOp;
+    Gap::Handle_t                  batchConnHandle;
+    const GattAttribute::Handle_t *batchHandles;
+    const BatchWrite_t            *batchWrites;
+    uint8_t                        batchCount;
+    uint8_t                        batchIndex;
+    BatchCallback_t                batchCallback;
+
 private:
     /* Disallow copy and assignment. */
     GattClient(const GattClient &);
@@ -0,0 +1,274 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2006-2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __GATT_CLIENT_CACHE_H__
+#define __GATT_CLIENT_CACHE_H__
+
+#include "Gap.h"
+#include "GattClient.h"
+#include "DiscoveredService.h"
+#include "DiscoveredCharacteristic.h"
+#include "ServiceDiscovery.h"
+
+/**
+ * Maximum number of services remembered for a peer. Peers with more
+ * services are discovered every time.
+ */
+#ifndef BLE_GATT_CLIENT_CACHE_MAX_SERVICES
+#define BLE_GATT_CLIENT_CACHE_MAX_SERVICES 8
+#endif
+
+/**
+ * Maximum number of characteristics remembered for a peer, across all its
+ * services. Peers with more characteristics are discovered every time.
+ */
+#ifndef BLE_GATT_CLIENT_CACHE_MAX_CHARACTERISTICS
+#define BLE_GATT_CLIENT_CACHE_MAX_CHARACTERISTICS 32
+#endif
+
+/**
+ * Cache of the attribute tables of known peers.
+ *
+ * The first discovery launched through the cache for a peer walks the whole
+ * attribute table and stores the services and characteristics found. Later
+ * discoveries for the same peer are answered from the stored table, without
+ * any exchange over the air, so the DiscoveredCharacteristic objects can be
+ * used as soon as the connection is established.
+ *
+ * Entries are keyed by the peer identity address. The application must call
+ * invalidate() when it learns that the peer's attribute table changed, for
+ * example on an indication of the Service Changed characteristic.
+ */
+class GattClientCache {
+public:
+    /**
+     * Persistent storage used by the cache. The interface matches KVStore,
+     * and GattClientCacheStoreAdapter wraps any object which provides it.
+     */
+    class Store {
+    public:
+        virtual ~Store() { }
+
+        /**
+         * Read a value.
+         *
+         * @param[in]  key        Null terminated key
+         * @param[out] buffer     Buffer receiving the value
+         * @param[in]  size       Size of @p buffer
+         * @param[out] actualSize Size of the stored value
+         *
+         * @return 0 on success, negative error code on failure.
+         */
+        virtual int get(const char *key, void *buffer, size_t size, size_t *actualSize) = 0;
+
+        /**
+         * Write a value, replacing any previous one.
+         *
+         * @param[in] key    Null terminated key
+         * @param[in] buffer Value to store
+         * @param[in] size   Size of the value
+         *
+         * @return 0 on success, negative error code on failure.
+         */
+        virtual int set(const char *key, const void *buffer, size_t size) = 0;
+
+        /**
+         * Remove a value.
+         *
+         * @param[in] key Null terminated key
+         *
+         * @return 0 on success, negative error code on failure.
+         */
+        virtual int remove(const char *key) = 0;
+    };
+
+    /**
+     * Length of the keys used in the store, including the terminator.
+     */
+    static const size_t KEY_SIZE = sizeof("gattc/") - 1 + 2 + 2 * BLEProtocol::ADDR_LEN + 1;
+
+public:
+    /**
+     * Construct a cache.
+     *
+     * @param[in] gap    The Gap instance, used to detect disconnections
+     *                   during discovery.
+     * @param[in] client The GattClient performing the discoveries.
+     * @param[in] store  The persistent storage of the attribute tables.
+     */
+    GattClientCache(Gap &gap, GattClient &client, Store &store);
+
+    ~GattClientCache();
+
+    /**
+     * Discover services and characteristics of a peer, from the cache when
+     * possible. The parameters and the callbacks behave as for
+     * GattClient::launchServiceDiscovery().
+     *
+     * When the peer is in the cache, the callbacks are all invoked before
+     * this function returns. Otherwise the whole attribute table is
+     * discovered, only the matching attributes are reported, and the table
+     * is stored at the end of a complete discovery.
+     *
+     * @note The cache registers its own termination callback with
+     * GattClient::onServiceDiscoveryTermination(), pass @p tc instead.
+     *
+     * @param[in] connectionHandle
+     *              Handle for the connection with the peer.
+     * @param[in] peerAddr
+     *              Identity address of the peer.
+     * @param[in] sc
+     *              Application callback for a matching service.
+     * @param[in] cc
+     *              Application callback for a matching characteristic.
+     * @param[in] tc
+     *              Application callback invoked at the end of the discovery.
+     * @param[in] matchingServiceUUID
+     *              UUID of the service of interest, or BLE_UUID_UNKNOWN.
+     * @param[in] matchingCharacteristicUUID
+     *              UUID of the characteristic of interest, or BLE_UUID_UNKNOWN.
+     *
+     * @return BLE_ERROR_NONE if the discovery was answered from the cache or
+     *         launched successfully, BLE_STACK_BUSY if a discovery is already
+     *         running, or the error of GattClient::launchServiceDiscovery().
+     */
+    ble_error_t launchServiceDiscovery(Gap::Handle_t                              connectionHandle,
+                                       const BLEProtocol::Address_t              &peerAddr,
+                                       ServiceDiscovery::ServiceCallback_t        sc                         = NULL,
+                                       ServiceDiscovery::CharacteristicCallback_t cc                         = NULL,
+                                       ServiceDiscovery::TerminationCallback_t    tc                         = NULL,
+                                       const UUID                                &matchingServiceUUID        = UUID::ShortUUIDBytes_t(BLE_UUID_UNKNOWN),
+                                       const UUID                                &matchingCharacteristicUUID = UUID::ShortUUIDBytes_t(BLE_UUID_UNKNOWN));
+
+    /**
+     * Check whether the attribute table of a peer is in the cache.
+     *
+     * @param[in] peerAddr Identity address of the peer.
+     *
+     * @return true if the next discovery will be answered from the cache.
+     */
+    bool contains(const BLEProtocol::Address_t &peerAddr);
+
+    /**
+     * Forget the attribute table of a peer, so that it is discovered again.
+     *
+     * @param[in] peerAddr Identity address of the peer.
+     *
+     * @return BLE_ERROR_NONE, or BLE_ERROR_INVALID_STATE if the store failed.
+     */
+    ble_error_t invalidate(const BLEProtocol::Address_t &peerAddr);
+
+    /**
+     * Stop a discovery launched through the cache. The partial table is
+     * not stored.
+     */
+    void terminateServiceDiscovery(void);
+
+private:
+    /* Characteristic rebuilt from the cache */
+    class CachedCharacteristic : public DiscoveredCharacteristic {
+    public:
+        void setup(GattClient *gattcIn, Gap::Handle_t connectionHandleIn, const UUID &uuidIn,
+                   uint8_t propsIn, GattAttribute::Handle_t declHandleIn,
+                   GattAttribute::Handle_t valueHandleIn, GattAttribute::Handle_t lastHandleIn);
+    };
+
+    struct ServiceEntry_t {
+        uint8_t                 uuidType;
+        uint8_t                 uuid[UUID::LENGTH_OF_LONG_UUID]; /**< Little endian */
+        GattAttribute::Handle_t startHandle;
+        GattAttribute::Handle_t endHandle;
+    };
+
+    struct CharacteristicEntry_t {
+        uint8_t                 uuidType;
+        uint8_t                 uuid[UUID::LENGTH_OF_LONG_UUID]; /**< Little endian */
+        uint8_t                 props;
+        GattAttribute::Handle_t declHandle;
+        GattAttribute::Handle_t valueHandle;
+        GattAttribute::Handle_t lastHandle;
+    };
+
+    struct Table_t {
+        uint16_t              magic;
+        uint8_t               serviceCount;
+        uint8_t               characteristicCount;
+        ServiceEntry_t        services[BLE_GATT_CLIENT_CACHE_MAX_SERVICES];
+        CharacteristicEntry_t characteristics[BLE_GATT_CLIENT_CACHE_MAX_CHARACTERISTICS];
+    };
+
+    static void makeKey(const BLEProtocol::Address_t &peerAddr, char *key);
+    static void storeUuid(const UUID &uuid, uint8_t &type, uint8_t *bytes);
+    static UUID loadUuid(uint8_t type, const uint8_t *bytes);
+    static bool matches(const UUID &filter, const UUID &uuid);
+
+    bool load(const BLEProtocol::Address_t &peerAddr);
+    void replay(void);
+    bool isInMatchingService(GattAttribute::Handle_t handle) const;
+
+    void onService(const DiscoveredService *service);
+    void onCharacteristic(const DiscoveredCharacteristic *characteristic);
+    void onTermination(Gap::Handle_t connectionHandle);
+    void onDisconnection(const Gap::DisconnectionCallbackParams_t *params);
+
+    /* Disallow copy and assignment. */
+    GattClientCache(const GattClientCache &);
+    GattClientCache& operator=(const GattClientCache &);
+
+private:
+    Gap                                        &_gap;
+    GattClient                                 &_client;
+    Store                                      &_store;
+
+    Table_t                                     _table;
+    bool                                        _active;
+    bool                                        _complete;
+    Gap::Handle_t                               _connectionHandle;
+    char                                        _key[KEY_SIZE];
+
+    ServiceDiscovery::ServiceCallback_t         _serviceCallback;
+    ServiceDiscovery::CharacteristicCallback_t  _characteristicCallback;
+    ServiceDiscovery::TerminationCallback_t     _terminationCallback;
+    UUID                                        _matchingServiceUUID;
+    UUID                                        _matchingCharacteristicUUID;
+};
+
+/**
+ * Adapter exposing a KVStore, or any object with the same get, set and
+ * remove functions, as a GattClientCache::Store.
+ */
+template <typename T>
+class GattClientCacheStoreAdapter : public GattClientCache::Store {
+public:
+    GattClientCacheStoreAdapter(T &store) : _store(store) { }
+
+    virtual int get(const char *key, void *buffer, size_t size, size_t *actualSize) {
+        return _store.get(key, buffer, size, actualSize);
+    }
+
+    virtual int set(const char *key, const void *buffer, size_t size) {
+        return _store.set(key, buffer, size);
+    }
+
+    virtual int remove(const char *key) {
+        return _store.remove(key);
+    }
+
+private:
+    T &_store;
+};
+
+#endif /* ifndef __GATT_CLIENT_CACHE_H__ */
@@ -19,11 +19,30 @@
 
 #include "Gap.h"
 #include "GattService.h"
+#include "GattStaticDatabase.h"
 #include "GattAttribute.h"
 #include "GattServerEvents.h"
 #include "GattCallbackParamTypes.h"
 #include "CallChainOfFunctionPointersWithContext.h"
 
+#include <string.h>
+
+/**
+ * Number of notifications GattServer::queueNotification() can hold until the
+ * stack has transmit buffers available for them (at most 255).
+ */
+#ifndef BLE_GATT_SERVER_NOTIFICATION_QUEUE_SIZE
+#define BLE_GATT_SERVER_NOTIFICATION_QUEUE_SIZE  8
+#endif
+
+/**
+ * Maximum length of a queued notification value. The default is the payload
+ * of a notification with the default ATT_MTU of 23 bytes.
+ */
+#ifndef BLE_GATT_SERVER_NOTIFICATION_MAX_LENGTH
+#define BLE_GATT_SERVER_NOTIFICATION_MAX_LENGTH  20
+#endif
+
 class GattServer {
 public:
     /**
@@ -85,7 +104,9 @@ protected:
         dataReadCallChain(),
         updatesEnabledCallback(NULL),
         updatesDisabledCallback(NULL),
-        confirmationReceivedCallback(NULL) {
+        confirmationReceivedCallback(NULL),
+        notificationQueueHead(0),
+        notificationQueueCount(0) {
         /* empty */
     }
 
@@ -110,6 +131,42 @@ public:
         return BLE_ERROR_NOT_IMPLEMENTED; /* Requesting action from porters: override this API if this capability is supported. */
     }
 
+    /**
+     * Add the services of a static GATT database to the local server ATT
+     * table, in one call. The descriptions are only read during the call,
+     * so they can be const tables in flash: no GattService or
+     * GattCharacteristic object is involved, and the handles are returned
+     * through the valueHandle and handle pointers of the descriptions.
+     *
+     * @note Characteristics of a static database have no authorization
+     * callbacks, and no descriptor other than the user description and the
+     * CCCD added by the stack. Use addService() for those.
+     *
+     * @param[in] services
+     *              Array of service descriptions.
+     * @param[in] count
+     *              Number of entries in @p services.
+     *
+     * @return BLE_ERROR_NONE if all the services were added, BLE_ERROR_NO_MEM
+     *         if the table is full.
+     */
+    virtual ble_error_t addStaticServices(const GattStaticService_t *services, uint8_t count) {
+        /* Avoid compiler warnings about unused variables. */
+        (void)services;
+        (void)count;
+
+        return BLE_ERROR_NOT_IMPLEMENTED; /* Requesting action from porters: override this API if this capability is supported. */
+    }
+
+    /**
+     * Same as addStaticServices(), with the number of services taken from
+     * the array declaration.
+     */
+    template <size_t N>
+    ble_error_t addStaticServices(const GattStaticService_t (&services)[N]) {
+        return addStaticServices(services, N);
+    }
+
     /**
      * Read the value of a characteristic from the local GATT server.
      *
@@ -277,10 +334,109 @@ public:
         return false; /* Requesting action from porters: override this API if this capability is supported. */
     }
 
+    /**
+     * Get the number of notifications the stack can currently accept for a
+     * connection without returning BLE_STACK_BUSY.
+     *
+     * @param[in]  connectionHandle
+     *               The connection handle.
+     * @param[out] creditsP
+     *               Upon return, the number of free transmit buffers
+     *               available to the connection.
+     *
+     * @return BLE_ERROR_NONE if the credits were reported.
+     *
+     * @note On stacks where the transmit buffers are shared between
+     *       connections, the credits reported for each connection are those
+     *       of the shared pool.
+     */
+    virtual ble_error_t getTxCredits(Gap::Handle_t connectionHandle, uint16_t *creditsP) {
+        /* Avoid compiler warnings about unused variables. */
+        (void)connectionHandle;
+        (void)creditsP;
+
+        return BLE_ERROR_NOT_IMPLEMENTED; /* Requesting action from porters: override this API if this capability is supported. */
+    }
+
     /*
      * APIs with non-virtual implementations.
      */
 public:
+    /**
+     * Queue a notification or indication of a characteristic value to a
+     * connected peer. The value is sent immediately if the stack has a
+     * transmit buffer available, otherwise it is held in the notification
+     * queue and sent when the stack reports DATA_SENT events.
+     *
+     * Queued values are sent in order. A value which the stack refuses for a
+     * reason other than a lack of buffers (for example, because the peer
+     * has disconnected) is dropped.
+     *
+     * @param[in] connectionHandle
+     *              Connection handle.
+     * @param[in] attributeHandle
+     *              Handle for the value attribute of the characteristic.
+     * @param[in] value
+     *              A pointer to a buffer holding the new value. The value is
+     *              copied into the queue.
+     * @param[in] size
+     *              Size of the new value (in bytes).
+     *
+     * @return BLE_ERROR_NONE if the value was sent or queued,
+     *         BLE_ERROR_PARAM_OUT_OF_RANGE if the value is longer than
+     *         BLE_GATT_SERVER_NOTIFICATION_MAX_LENGTH, BLE_ERROR_NO_MEM if
+     *         the queue is full, or the error returned by write() if the
+     *         value could not be sent.
+     *
+     * @note Like the rest of the API, this must be called from the context
+     *       that processes BLE events.
+     */
+    ble_error_t queueNotification(Gap::Handle_t connectionHandle, GattAttribute::Handle_t attributeHandle, const uint8_t *value, uint16_t size) {
+        if (size > BLE_GATT_SERVER_NOTIFICATION_MAX_LENGTH) {
+            return BLE_ERROR_PARAM_OUT_OF_RANGE;
+        }
+
+        /* Preserve ordering behind values that are already waiting */
+        if (notificationQueueCount == 0) {
+            ble_error_t err = write(connectionHandle, attributeHandle, value, size);
+            if (err != BLE_STACK_BUSY && err != BLE_ERROR_NO_MEM) {
+                return err;
+            }
+        }
+
+        if (notificationQueueCount == BLE_GATT_SERVER_NOTIFICATION_QUEUE_SIZE) {
+            return BLE_ERROR_NO_MEM;
+        }
+
+        QueuedNotification_t &entry = notificationQueue[
+            (notificationQueueHead + notificationQueueCount) % BLE_GATT_SERVER_NOTIFICATION_QUEUE_SIZE];
+        entry.connectionHandle = connectionHandle;
+        entry.attributeHandle  = attributeHandle;
+        entry.size             = size;
+        memcpy(entry.value, value, size);
+        notificationQueueCount++;
+
+        return BLE_ERROR_NONE;
+    }
+
+    /**
+     * Get the number of notifications waiting in the notification queue.
+     *
+     * @return The number of queued notifications.
+     */
+    unsigned getQueuedNotificationCount() const {
+        return notificationQueueCount;
+    }
+
+    /**
+     * Get the number of notifications which can still be queued.
+     *
+     * @return The number of free entries in the notification queue.
+     */
+    unsigned getFreeNotificationCount() const {
+        return BLE_GATT_SERVER_NOTIFICATION_QUEUE_SIZE - notificationQueueCount;
+    }
+
     /**
      * Add a callback for the GATT event DATA_SENT (which is triggered when
      * updates are sent out by GATT in the form of notifications).
@@ -599,11 +755,32 @@ protected:
      *
      * @param[in] count
      *              Number of packets sent.
+     *
+     * @note The notification queue is refilled into the freed transmit
+     *       buffers before the registered handlers are called.
      */
     void handleDataSentEvent(unsigned count) {
+        processNotificationQueue();
         dataSentCallChain.call(count);
     }
 
+    /**
+     * Send queued notifications until the queue is empty or the stack runs
+     * out of transmit buffers.
+     */
+    void processNotificationQueue(void) {
+        while (notificationQueueCount > 0) {
+            const QueuedNotification_t &entry = notificationQueue[notificationQueueHead];
+            ble_error_t err = write(entry.connectionHandle, entry.attributeHandle, entry.value, entry.size);
+            if (err == BLE_STACK_BUSY || err == BLE_ERROR_NO_MEM) {
+                return;
+            }
+
+            notificationQueueHead = (notificationQueueHead + 1) % BLE_GATT_SERVER_NOTIFICATION_QUEUE_SIZE;
+            notificationQueueCount--;
+        }
+    }
+
 public:
     /**
      * Notify all registered onShutdown callbacks that the GattServer is
@@ -633,6 +810,9 @@ public:
         updatesDisabledCallback      = NULL;
         confirmationReceivedCallback = NULL;
 
+        notificationQueueHead  = 0;
+        notificationQueueCount = 0;
+
         return BLE_ERROR_NONE;
     }
 
@@ -680,6 +860,30 @@ private:
      */
     EventCallback_t                   confirmationReceivedCallback;
 
+    /**
+     * A notification waiting for a transmit buffer.
+     */
+    struct QueuedNotification_t {
+        Gap::Handle_t           connectionHandle;
+        GattAttribute::Handle_t attributeHandle;
+        uint16_t                size;
+        uint8_t                 value[BLE_GATT_SERVER_NOTIFICATION_MAX_LENGTH];
+    };
+
+    /**
+     * Notifications queued by queueNotification(), oldest at
+     * notificationQueueHead.
+     */
+    QueuedNotification_t              notificationQueue[BLE_GATT_SERVER_NOTIFICATION_QUEUE_SIZE];
+    /**
+     * Index of the oldest queued notification.
+     */
+    uint8_t                           notificationQueueHead;
+    /**
+     * Number of queued notifications.
+     */
+    uint8_t                           notificationQueueCount;
+
 private:
     /* Disallow copy and assignment. */
     GattServer(const GattServer &);
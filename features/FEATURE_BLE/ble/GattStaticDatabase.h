@@ -0,0 +1,81 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2006-2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __GATT_STATIC_DATABASE_H__
+#define __GATT_STATIC_DATABASE_H__
+
+#include "UUID.h"
+#include "GattAttribute.h"
+#include "SecurityManager.h"
+
+/**
+ * Description of a characteristic of a static GATT database.
+ *
+ * Unlike GattCharacteristic, it is a plain aggregate: a const instance with
+ * constant initializers is placed in flash by the compiler and costs no RAM
+ * and no construction at boot. The stack keeps the value of the
+ * characteristic, which is accessed through its handle with GattServer::read()
+ * and GattServer::write().
+ *
+ * @code
+ *
+ * static GattAttribute::Handle_t levelHandle;
+ * static const uint8_t initialLevel = 100;
+ *
+ * static const GattStaticCharacteristic_t batteryCharacteristics[] = {
+ *     {
+ *         GattCharacteristic::UUID_BATTERY_LEVEL_CHAR, NULL,
+ *         GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_READ | GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_NOTIFY,
+ *         SecurityManager::SECURITY_MODE_ENCRYPTION_OPEN_LINK,
+ *         &initialLevel, sizeof(initialLevel), sizeof(initialLevel), false,
+ *         NULL, &levelHandle
+ *     }
+ * };
+ *
+ * static const GattStaticService_t services[] = {
+ *     { GattService::UUID_BATTERY_SERVICE, NULL, batteryCharacteristics, 1, NULL }
+ * };
+ *
+ * ble.gattServer().addStaticServices(services);
+ *
+ * @endcode
+ */
+struct GattStaticCharacteristic_t {
+    UUID::ShortUUIDBytes_t           shortUUID;         /**< 16-bit UUID, used when longUUID is NULL */
+    const uint8_t                   *longUUID;          /**< 128-bit UUID, MSB first, or NULL */
+    uint8_t                          properties;        /**< Bitfield of GattCharacteristic::Properties_t */
+    SecurityManager::SecurityMode_t  requiredSecurity;  /**< Security required to access the value */
+    const uint8_t                   *initialValue;      /**< Value the characteristic starts with, or NULL */
+    uint16_t                         initialLength;     /**< Length of the initial value */
+    uint16_t                         maxLength;         /**< Maximum length of the value */
+    bool                             hasVariableLength; /**< Whether the length of the value may change */
+    const char                      *userDescription;   /**< Null terminated user description, or NULL for none */
+    GattAttribute::Handle_t         *valueHandle;       /**< Receives the handle of the value when registered, may be NULL */
+};
+
+/**
+ * Description of a primary service of a static GATT database. Like
+ * GattStaticCharacteristic_t, it is meant to be declared const.
+ */
+struct GattStaticService_t {
+    UUID::ShortUUIDBytes_t            shortUUID;           /**< 16-bit UUID, used when longUUID is NULL */
+    const uint8_t                    *longUUID;            /**< 128-bit UUID, MSB first, or NULL */
+    const GattStaticCharacteristic_t *characteristics;     /**< The characteristics of the service */
+    uint8_t                           characteristicCount; /**< Number of entries in characteristics */
+    GattAttribute::Handle_t          *handle;              /**< Receives the handle of the service declaration, may be NULL */
+};
+
+#endif /* ifndef __GATT_STATIC_DATABASE_H__ */
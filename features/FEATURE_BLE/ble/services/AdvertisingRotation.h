@@ -0,0 +1,161 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2006-2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SERVICES_ADVERTISINGROTATION_H_
+#define SERVICES_ADVERTISINGROTATION_H_
+
+#include "ble/BLE.h"
+
+#ifdef YOTTA_CFG_MBED_OS
+#include "mbed-drivers/mbed.h"
+#else
+#include "mbed.h"
+#endif
+
+/**
+ * Maximum number of payloads in a rotation.
+ */
+#ifndef BLE_ADVERTISING_ROTATION_MAX_FRAMES
+#define BLE_ADVERTISING_ROTATION_MAX_FRAMES 4
+#endif
+
+/**
+ * Rotation of several advertising payloads, as used by beacons interleaving
+ * frame types.
+ *
+ * The payloads are preloaded, and each one is advertised for a number of
+ * advertising events before the next one takes its place. When the stack
+ * rotates payloads by itself (refer to Gap::setAdvertisingSets()), the
+ * rotation is handed to it and the CPU is not involved at all. Otherwise the
+ * payload is swapped in place once per frame from a single timeout, while
+ * advertising keeps running: there is no stop and restart of advertising
+ * and no wake up for every advertising event.
+ */
+class AdvertisingRotation {
+public:
+    /**
+     * Type for the callback invoked before a frame is advertised. It receives
+     * the index of the frame, and may refresh its payload with setFrame().
+     */
+    typedef FunctionPointerWithContext<uint8_t> FrameCallback_t;
+
+public:
+    /**
+     * Construct an empty rotation.
+     *
+     * @param[in] gap
+     *              The Gap instance advertising the payloads. Its advertising
+     *              parameters are used, and its interval paces the rotation.
+     */
+    AdvertisingRotation(Gap &gap);
+
+    /**
+     * Set the payload of a frame.
+     *
+     * @param[in] index
+     *              Index of the frame, below BLE_ADVERTISING_ROTATION_MAX_FRAMES.
+     * @param[in] payload
+     *              The advertising payload. It is copied.
+     * @param[in] events
+     *              Number of consecutive advertising events the frame is
+     *              advertised for. 0 skips the frame.
+     *
+     * @return BLE_ERROR_NONE, BLE_ERROR_PARAM_OUT_OF_RANGE if @p index is too
+     *         large, or the error of the stack when the rotation is running.
+     */
+    ble_error_t setFrame(uint8_t index, const GapAdvertisingData &payload, uint16_t events);
+
+    /**
+     * Change the number of events a frame is advertised for, keeping its
+     * payload. This is cheaper than setFrame() to enable a frame for a
+     * single turn.
+     *
+     * @param[in] index
+     *              Index of the frame.
+     * @param[in] events
+     *              Number of consecutive advertising events. 0 skips the frame.
+     *
+     * @return BLE_ERROR_NONE, or BLE_ERROR_PARAM_OUT_OF_RANGE if @p index is
+     *         too large.
+     */
+    ble_error_t setFrameEvents(uint8_t index, uint16_t events);
+
+    /**
+     * Set up a callback invoked before each frame is advertised, for instance
+     * to refresh telemetry. It runs in interrupt context.
+     *
+     * @param[in] callback
+     *              The handler, or NULL.
+     */
+    void onFrameChange(FrameCallback_t callback) {
+        _frameCallback = callback;
+    }
+
+    /**
+     * Same as onFrameChange() but allows an object reference and member
+     * function to be added as the callback.
+     */
+    template <typename T>
+    void onFrameChange(T *objPtr, void (T::*memberPtr)(uint8_t)) {
+        _frameCallback.attach(objPtr, memberPtr);
+    }
+
+    /**
+     * Start advertising the frames in turn.
+     *
+     * @return BLE_ERROR_NONE, BLE_ERROR_INVALID_STATE if no frame has any
+     *         event, or the error of Gap::startAdvertising().
+     */
+    ble_error_t start(void);
+
+    /**
+     * Stop advertising.
+     *
+     * @return The error of Gap::stopAdvertising().
+     */
+    ble_error_t stop(void);
+
+    /**
+     * Get the number of advertising events of the frames completed so far.
+     * The count is derived from the schedule, and is exact only when no
+     * event is skipped by the stack.
+     *
+     * @return The number of advertising events since start().
+     */
+    uint32_t getEventCount(void) const {
+        return _eventCount;
+    }
+
+private:
+    int nextFrame(int from) const;
+    ble_error_t loadSets(void);
+    void arm(uint16_t events);
+    void rotate(void);
+
+private:
+    Gap                &_gap;
+    GapAdvertisingData  _payloads[BLE_ADVERTISING_ROTATION_MAX_FRAMES];
+    uint16_t            _events[BLE_ADVERTISING_ROTATION_MAX_FRAMES];
+    FrameCallback_t     _frameCallback;
+    Timeout             _timeout;
+    bool                _running;
+    bool                _offloaded;
+    int                 _current;
+    uint16_t            _armedEvents;
+    volatile uint32_t   _eventCount;
+};
+
+#endif // SERVICES_ADVERTISINGROTATION_H_
@@ -0,0 +1,226 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2006-2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __BLE_BENCHMARK_CLIENT_H__
+#define __BLE_BENCHMARK_CLIENT_H__
+
+#include "ble/services/BenchmarkService.h"
+
+/**
+ * Maximum number of round trips of a latency run.
+ */
+#ifndef BLE_BENCHMARK_CLIENT_MAX_LATENCY_SAMPLES
+#define BLE_BENCHMARK_CLIENT_MAX_LATENCY_SAMPLES 100
+#endif
+
+/**
+ * Time without progress after which a run is aborted, in milliseconds.
+ */
+#ifndef BLE_BENCHMARK_CLIENT_TIMEOUT_MS
+#define BLE_BENCHMARK_CLIENT_TIMEOUT_MS 2000
+#endif
+
+/**
+ * Central side of the benchmark: drives a BenchmarkService on the peer and
+ * reports throughput and latency.
+ *
+ * The report records the ATT_MTU, the link layer data length and the
+ * connection interval in use, as last reported by Gap. Runs under other
+ * settings are done by changing them between runs, with
+ * Gap::negotiateAttMtu() and Gap::updateConnectionParams().
+ *
+ * @note The client relies on GattServer::onDataSent() to resume write
+ * commands when transmit buffers are released, and registers its own
+ * GattClient::onServiceDiscoveryTermination() callback during attach().
+ */
+class BenchmarkClient {
+public:
+    /** Kind of run. */
+    enum Test_t {
+        TEST_DOWNLOAD, /**< Notifications streamed by the server */
+        TEST_UPLOAD,   /**< Write commands streamed by the client */
+        TEST_LATENCY   /**< Round trips of a write command and its echo */
+    };
+
+    /**
+     * Results of a run.
+     */
+    struct Report_t {
+        Test_t      test;               /**< The kind of run */
+        ble_error_t status;             /**< BLE_ERROR_NONE, or the reason the run was aborted (BLE_STACK_BUSY when the peer stopped responding) */
+        uint16_t    attMtu;             /**< ATT_MTU in use, 23 until an exchange is reported */
+        uint16_t    dataLength;         /**< Link layer transmit payload in use, 27 until a change is reported */
+        uint16_t    connectionInterval; /**< Connection interval in use, in 1.25 ms units */
+        uint16_t    payloadLength;      /**< Length of each packet */
+        uint32_t    packets;            /**< Packets received on the measuring side */
+        uint32_t    bytes;              /**< Bytes received on the measuring side */
+        uint32_t    elapsedUs;          /**< Time between the first and the last packet */
+        uint32_t    throughput;         /**< Bytes per second */
+        uint16_t    packetsPerEvent;    /**< Average packets per connection event, in hundredths */
+        uint32_t    latencyMin;         /**< Shortest round trip, in microseconds */
+        uint32_t    latencyP50;         /**< Median round trip, in microseconds */
+        uint32_t    latencyP90;         /**< 90th percentile of the round trips, in microseconds */
+        uint32_t    latencyP99;         /**< 99th percentile of the round trips, in microseconds */
+        uint32_t    latencyMax;         /**< Longest round trip, in microseconds */
+    };
+
+    /** Type of the callback reporting the end of a run. */
+    typedef FunctionPointerWithContext<const Report_t *> ReportCallback_t;
+
+    /** Type of the callback reporting the end of attach(). */
+    typedef FunctionPointerWithContext<ble_error_t> AttachCallback_t;
+
+public:
+    /**
+     * @param[ref] ble
+     *               BLE object for the underlying controller.
+     */
+    BenchmarkClient(BLE &ble);
+
+    ~BenchmarkClient();
+
+    /**
+     * Find the benchmark service of a connected peer and enable its
+     * notifications.
+     *
+     * @param[in] connection
+     *              The connection parameters, as received by the connection
+     *              callback.
+     * @param[in] callback
+     *              Invoked with BLE_ERROR_NONE once runs can be started, or
+     *              with the reason of the failure.
+     *
+     * @return BLE_ERROR_NONE if the service discovery was launched.
+     */
+    ble_error_t attach(const Gap::ConnectionCallbackParams_t *connection, AttachCallback_t callback);
+
+    /**
+     * Check whether runs can be started.
+     */
+    bool isReady(void) const {
+        return _ready;
+    }
+
+    /**
+     * Set up the callback invoked at the end of every run.
+     */
+    void onReport(ReportCallback_t callback) {
+        _reportCallback = callback;
+    }
+
+    /**
+     * Same as onReport(), taking an object and a member function.
+     */
+    template <typename T>
+    void onReport(T *objPtr, void (T::*memberPtr)(const Report_t *)) {
+        _reportCallback.attach(objPtr, memberPtr);
+    }
+
+    /**
+     * Have the server notify @p count packets of @p payloadLength bytes as
+     * fast as possible. The throughput is measured on reception.
+     *
+     * @return BLE_ERROR_NONE if the run started, BLE_ERROR_INVALID_STATE if
+     *         not attached or a run is active, BLE_ERROR_PARAM_OUT_OF_RANGE
+     *         if a parameter is invalid.
+     */
+    ble_error_t runDownload(uint16_t payloadLength, uint32_t count);
+
+    /**
+     * Write @p count packets of @p payloadLength bytes without response as
+     * fast as possible. The throughput is measured by the server, and read
+     * back at the end of the run.
+     *
+     * @return As runDownload().
+     */
+    ble_error_t runUpload(uint16_t payloadLength, uint32_t count);
+
+    /**
+     * Measure @p count round trips of a write command echoed as a
+     * notification. Each packet is written once the previous echo arrived.
+     *
+     * @param[in] payloadLength
+     *              Length of each packet, at least 4 bytes.
+     * @param[in] count
+     *              Number of round trips, up to
+     *              BLE_BENCHMARK_CLIENT_MAX_LATENCY_SAMPLES.
+     *
+     * @return As runDownload().
+     */
+    ble_error_t runLatency(uint16_t payloadLength, uint16_t count);
+
+private:
+    enum State_t {
+        STATE_IDLE,
+        STATE_DISCOVERING,
+        STATE_ENABLING,
+        STATE_STARTING,
+        STATE_RUNNING,
+        STATE_STOPPING,
+        STATE_READING_RESULT
+    };
+
+    ble_error_t start(Test_t test, uint16_t payloadLength, uint32_t count);
+    ble_error_t writeRequest(GattAttribute::Handle_t handle, const uint8_t *value, uint16_t length);
+    void sendPing(void);
+    void pump(void);
+    void stop(void);
+    void finish(ble_error_t status);
+    void computeLatency(void);
+    void armWatchdog(void);
+
+    void onCharacteristic(const DiscoveredCharacteristic *characteristic);
+    void onDiscoveryTermination(Gap::Handle_t connectionHandle);
+    void onDataWritten(const GattWriteCallbackParams *params);
+    void onDataRead(const GattReadCallbackParams *params);
+    void onHVX(const GattHVXCallbackParams *params);
+    void onDataSent(unsigned count);
+    void onDisconnection(const Gap::DisconnectionCallbackParams_t *params);
+    void onAttMtuChange(const Gap::AttMtuCallbackParams_t *params);
+    void onDataLengthChange(const Gap::DataLengthCallbackParams_t *params);
+    void onConnectionParamsUpdate(const Gap::ConnectionParamsUpdateCallbackParams_t *params);
+    void onWatchdog(void);
+
+    /* Disallow copy and assignment. */
+    BenchmarkClient(const BenchmarkClient &);
+    BenchmarkClient& operator=(const BenchmarkClient &);
+
+private:
+    BLE                    &_ble;
+    State_t                 _state;
+    bool                    _ready;
+    bool                    _stopIssued;
+    Gap::Handle_t           _connectionHandle;
+    GattAttribute::Handle_t _controlHandle;
+    GattAttribute::Handle_t _dataHandle;
+    GattAttribute::Handle_t _resultHandle;
+
+    AttachCallback_t        _attachCallback;
+    ReportCallback_t        _reportCallback;
+
+    Report_t                _report;
+    uint32_t                _count;
+    uint32_t                _sent;
+    uint32_t                _firstUs;
+    uint32_t                _sentUs;
+    uint8_t                 _payload[BenchmarkService::MAX_PAYLOAD_LEN];
+    uint32_t                _samples[BLE_BENCHMARK_CLIENT_MAX_LATENCY_SAMPLES];
+
+    Timer                   _timer;
+    Timeout                 _watchdog;
+};
+
+#endif /* #ifndef __BLE_BENCHMARK_CLIENT_H__*/
@@ -0,0 +1,279 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2006-2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __BLE_BENCHMARK_SERVICE_H__
+#define __BLE_BENCHMARK_SERVICE_H__
+
+#ifdef YOTTA_CFG_MBED_OS
+#include "mbed-drivers/mbed.h"
+#else
+#include "mbed.h"
+#endif
+
+#include "ble/UUID.h"
+#include "ble/BLE.h"
+
+/**
+ * Largest payload streamed or accepted by the benchmark, in bytes. The
+ * default fits a notification with an ATT_MTU of 247 bytes, the largest
+ * one carried by a single link layer PDU with Data Length Extension.
+ */
+#ifndef BLE_BENCHMARK_SERVICE_MAX_PAYLOAD_LEN
+#define BLE_BENCHMARK_SERVICE_MAX_PAYLOAD_LEN 244
+#endif
+
+extern const uint8_t  BenchmarkServiceUUID[UUID::LENGTH_OF_LONG_UUID];
+extern const uint8_t  BenchmarkServiceControlCharacteristicUUID[UUID::LENGTH_OF_LONG_UUID];
+extern const uint8_t  BenchmarkServiceDataCharacteristicUUID[UUID::LENGTH_OF_LONG_UUID];
+extern const uint8_t  BenchmarkServiceResultCharacteristicUUID[UUID::LENGTH_OF_LONG_UUID];
+
+/**
+* @class BenchmarkService
+* @brief BLE Service to measure GATT throughput and latency, driven by a
+* GATT client such as BenchmarkClient or a phone application.
+*
+* The client writes commands to the control characteristic:
+* - COMMAND_STREAM, followed by the payload length (16 bits) and the number
+*   of packets (32 bits, 0 streams until COMMAND_STOP), both little endian:
+*   the server notifies the data characteristic as fast as the stack
+*   accepts notifications. Each packet starts with its sequence number
+*   (32 bits, little endian).
+* - COMMAND_ECHO: every value written to the data characteristic is
+*   notified back, for round trip latency measurements.
+* - COMMAND_STOP: stop streaming or echoing, and publish the result.
+* - COMMAND_RESET: clear the counters.
+*
+* Values written to the data characteristic are always counted. The result
+* characteristic holds the counters as of the last COMMAND_STOP or
+* COMMAND_RESET, as five 32-bit little endian values: bytes received,
+* packets received, microseconds between the first and the last packet
+* received, bytes sent and packets sent.
+*/
+class BenchmarkService {
+public:
+    /** Commands written to the control characteristic. */
+    enum Command_t {
+        COMMAND_STREAM = 0x01,
+        COMMAND_ECHO   = 0x02,
+        COMMAND_STOP   = 0x03,
+        COMMAND_RESET  = 0x04
+    };
+
+    /** Length of a COMMAND_STREAM write. */
+    static const unsigned STREAM_COMMAND_LEN = 7;
+
+    /** Length of the result characteristic value. */
+    static const unsigned RESULT_LEN = 20;
+
+    /** Largest payload of the data characteristic. */
+    static const unsigned MAX_PAYLOAD_LEN = BLE_BENCHMARK_SERVICE_MAX_PAYLOAD_LEN;
+
+public:
+    /**
+    * @param[ref] _ble
+    *               BLE object for the underlying controller.
+    */
+    BenchmarkService(BLE &_ble) :
+        ble(_ble),
+        payload(),
+        result(),
+        controlValue(),
+        connectionHandle(0),
+        streaming(false),
+        echoing(false),
+        streamLength(0),
+        streamCount(0),
+        bytesReceived(0),
+        packetsReceived(0),
+        firstReceived(0),
+        lastReceived(0),
+        bytesSent(0),
+        packetsSent(0),
+        timer(),
+        controlCharacteristic(BenchmarkServiceControlCharacteristicUUID, controlValue, 1, STREAM_COMMAND_LEN,
+                              GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_WRITE),
+        dataCharacteristic(BenchmarkServiceDataCharacteristicUUID, payload, 1, MAX_PAYLOAD_LEN,
+                           GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_WRITE_WITHOUT_RESPONSE |
+                           GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_NOTIFY),
+        resultCharacteristic(BenchmarkServiceResultCharacteristicUUID, result, RESULT_LEN, RESULT_LEN,
+                             GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_READ, NULL, 0, false) {
+        GattCharacteristic *charTable[] = {&controlCharacteristic, &dataCharacteristic, &resultCharacteristic};
+        GattService         benchmarkService(BenchmarkServiceUUID, charTable, sizeof(charTable) / sizeof(GattCharacteristic *));
+
+        ble.addService(benchmarkService);
+        ble.gattServer().onDataWritten(this, &BenchmarkService::onDataWritten);
+        ble.gattServer().onDataSent(this, &BenchmarkService::onDataSent);
+        ble.gap().onDisconnection(this, &BenchmarkService::onDisconnection);
+        timer.start();
+    }
+
+    uint16_t getControlCharacteristicHandle() {
+        return controlCharacteristic.getValueAttribute().getHandle();
+    }
+
+    uint16_t getDataCharacteristicHandle() {
+        return dataCharacteristic.getValueAttribute().getHandle();
+    }
+
+    uint16_t getResultCharacteristicHandle() {
+        return resultCharacteristic.getValueAttribute().getHandle();
+    }
+
+protected:
+    /**
+     * This callback allows the benchmark service to receive the commands and
+     * the data written by the client.
+     */
+    void onDataWritten(const GattWriteCallbackParams *params) {
+        if (params->handle == getDataCharacteristicHandle()) {
+            uint32_t now = timer.read_us();
+            if (packetsReceived == 0) {
+                firstReceived = now;
+            }
+            lastReceived   = now;
+            bytesReceived += params->len;
+            packetsReceived++;
+
+            if (echoing) {
+                ble.gattServer().write(params->connHandle, getDataCharacteristicHandle(), params->data, params->len);
+            }
+        } else if ((params->handle == getControlCharacteristicHandle()) && (params->len >= 1)) {
+            connectionHandle = params->connHandle;
+            switch (params->data[0]) {
+                case COMMAND_STREAM:
+                    if (params->len == STREAM_COMMAND_LEN) {
+                        streamLength = params->data[1] | (params->data[2] << 8);
+                        streamCount  = getUint32(&params->data[3]);
+                        if (streamLength > MAX_PAYLOAD_LEN) {
+                            streamLength = MAX_PAYLOAD_LEN;
+                        }
+                        streaming = true;
+                        stream();
+                    }
+                    break;
+                case COMMAND_ECHO:
+                    echoing = true;
+                    break;
+                case COMMAND_STOP:
+                    streaming = false;
+                    echoing   = false;
+                    publishResult();
+                    break;
+                case COMMAND_RESET:
+                    bytesReceived   = 0;
+                    packetsReceived = 0;
+                    firstReceived   = 0;
+                    lastReceived    = 0;
+                    bytesSent       = 0;
+                    packetsSent     = 0;
+                    publishResult();
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+
+    /**
+     * Notifications were transmitted: the stack has room for more.
+     */
+    void onDataSent(unsigned count) {
+        (void)count;
+        if (streaming) {
+            stream();
+        }
+    }
+
+    void onDisconnection(const Gap::DisconnectionCallbackParams_t *params) {
+        if (params->handle == connectionHandle) {
+            streaming = false;
+            echoing   = false;
+        }
+    }
+
+    /**
+     * Queue notifications until the stack runs out of buffers, or the
+     * requested number of packets is sent.
+     */
+    void stream(void) {
+        while (streaming && ((streamCount == 0) || (packetsSent < streamCount))) {
+            uint32_t sequence = packetsSent;
+            for (unsigned i = 0; i < streamLength; i++) {
+                payload[i] = (i < sizeof(sequence)) ? (uint8_t)(sequence >> (8 * i)) : (uint8_t)i;
+            }
+
+            ble_error_t error = ble.gattServer().write(connectionHandle, getDataCharacteristicHandle(), payload, streamLength);
+            if (error == BLE_STACK_BUSY) {
+                /* Resumed by onDataSent() */
+                return;
+            }
+            if (error != BLE_ERROR_NONE) {
+                /* Notifications disabled, or payload larger than the ATT_MTU */
+                break;
+            }
+            bytesSent += streamLength;
+            packetsSent++;
+        }
+        streaming = false;
+    }
+
+    void publishResult(void) {
+        setUint32(&result[0],  bytesReceived);
+        setUint32(&result[4],  packetsReceived);
+        setUint32(&result[8],  lastReceived - firstReceived);
+        setUint32(&result[12], bytesSent);
+        setUint32(&result[16], packetsSent);
+        ble.gattServer().write(getResultCharacteristicHandle(), result, RESULT_LEN, true);
+    }
+
+    static uint32_t getUint32(const uint8_t *bytes) {
+        return bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+    }
+
+    static void setUint32(uint8_t *bytes, uint32_t value) {
+        bytes[0] = value;
+        bytes[1] = value >> 8;
+        bytes[2] = value >> 16;
+        bytes[3] = value >> 24;
+    }
+
+protected:
+    BLE                &ble;
+
+    uint8_t             payload[MAX_PAYLOAD_LEN];
+    uint8_t             result[RESULT_LEN];
+    uint8_t             controlValue[STREAM_COMMAND_LEN];
+
+    Gap::Handle_t       connectionHandle;
+    bool                streaming;
+    bool                echoing;
+    uint16_t            streamLength;
+    uint32_t            streamCount;
+
+    uint32_t            bytesReceived;
+    uint32_t            packetsReceived;
+    uint32_t            firstReceived;
+    uint32_t            lastReceived;
+    uint32_t            bytesSent;
+    uint32_t            packetsSent;
+    Timer               timer;
+
+    GattCharacteristic  controlCharacteristic;
+    GattCharacteristic  dataCharacteristic;
+    GattCharacteristic  resultCharacteristic;
+};
+
+#endif /* #ifndef __BLE_BENCHMARK_SERVICE_H__*/
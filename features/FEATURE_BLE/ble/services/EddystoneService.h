@@ -20,8 +20,8 @@
 #warning ble/services/EddystoneService.h is deprecated. Please use the example in 'github.com/ARMmbed/ble-examples/tree/master/BLE_EddystoneService'.
 
 #include "ble/BLE.h"
+#include "ble/services/AdvertisingRotation.h"
 #include "mbed.h"
-#include "CircularBuffer.h"
 static const uint8_t BEACON_EDDYSTONE[] = {0xAA, 0xFE};
 
 //Debug is disabled by default
@@ -76,7 +76,6 @@ public:
     void (*frames[EDDYSTONE_MAX_FRAMETYPE])(uint8_t *, uint32_t);
     static const int URI_DATA_MAX = 18;
     typedef uint8_t  UriData_t[URI_DATA_MAX];
-    CircularBuffer<FrameTypes, EDDYSTONE_MAX_FRAMETYPE> overflow;
 
     // UID Frame Type subfields
     static const int UID_NAMESPACEID_SIZE = 10;
@@ -322,165 +321,62 @@ public:
     }
 
     /*
-    * Update advertising data
+    * Build the advertising payload of a frame
     * @return true on success, false on failure
     */
-    bool updateAdvPacket(uint8_t serviceData[], unsigned serviceDataLen) {
-        // Fields from the Service
-        DBG("Updating AdvFrame: %d", serviceDataLen);
-
-        ble.clearAdvertisingPayload();
-        ble.setAdvertisingType(GapAdvertisingParams::ADV_NON_CONNECTABLE_UNDIRECTED);
-        ble.setAdvertisingInterval(100);
-        ble.accumulateAdvertisingPayload(GapAdvertisingData::BREDR_NOT_SUPPORTED | GapAdvertisingData::LE_GENERAL_DISCOVERABLE);
-        ble.accumulateAdvertisingPayload(GapAdvertisingData::COMPLETE_LIST_16BIT_SERVICE_IDS, BEACON_EDDYSTONE, sizeof(BEACON_EDDYSTONE));
-        ble.accumulateAdvertisingPayload(GapAdvertisingData::SERVICE_DATA, serviceData, serviceDataLen);
-
-
-        return true;
-    }
-
-    /*
-    *   State machine for switching out frames.
-    *   This function is called by the radioNotificationCallback when a frame needs to get swapped out.
-    *   This function exists because of time constraints in the radioNotificationCallback, so it is effectively
-    *   broken up into two functions.
-    */
-    void swapOutFrames(FrameTypes frameType) {
+    bool buildAdvPacket(FrameTypes frameType, GapAdvertisingData &payload) {
         uint8_t  serviceData[SERVICE_DATA_MAX];
         unsigned serviceDataLen = 0;
         //hard code in the eddystone UUID
         serviceData[serviceDataLen++] = BEACON_EDDYSTONE[0];
         serviceData[serviceDataLen++] = BEACON_EDDYSTONE[1];
 
-        // if certain frames are not enabled, then skip them. Worst case TLM is always enabled
         switch (frameType) {
             case tlm:
-                // TLM frame
-                if (tlmIsSet) {
-                    DBG("Swapping in TLM Frame: version=%x, Batt=%d, Temp = %d, PDUCnt = %d, TimeSinceBoot=%d",
-                        TlmVersion,
-                        TlmBatteryVoltage,
-                        TlmBeaconTemp,
-                        TlmPduCount,
-                        TlmTimeSinceBoot);
-                    serviceDataLen += constructTLMFrame(serviceData + serviceDataLen, 20);
-                    DBG("\t Swapping in TLM Frame: len=%d", serviceDataLen);
-                    updateAdvPacket(serviceData, serviceDataLen);
-                }
+                serviceDataLen += constructTLMFrame(serviceData + serviceDataLen, 20);
                 break;
             case url:
-                // URL Frame
-                if (urlIsSet) {
-                    DBG("Swapping in URL Frame: Power: %d", defaultUrlPower);
-                    serviceDataLen += constructURLFrame(serviceData + serviceDataLen, 20);
-                    DBG("\t Swapping in URL Frame: len=%d ", serviceDataLen);
-                    updateAdvPacket(serviceData, serviceDataLen);
-                    //switchFlag = false;
-                }
+                serviceDataLen += constructURLFrame(serviceData + serviceDataLen, 20);
                 break;
             case uid:
-                // UID Frame
-                if (uidIsSet) {
-                    DBG("Swapping in UID Frame: Power: %d", defaultUidPower);
-                    serviceDataLen += constructUIDFrame(serviceData + serviceDataLen, 20);
-                    DBG("\t Swapping in UID Frame: len=%d", serviceDataLen);
-                    updateAdvPacket(serviceData, serviceDataLen);
-                    //switchFlag = false;
-                }
+                serviceDataLen += constructUIDFrame(serviceData + serviceDataLen, 20);
                 break;
             default:
-                ERR("You have not initialized a Frame yet, please initialize one before starting a beacon");
-                ERR("uidIsSet = %d, urlIsSet = %d, tlmIsSet = %d", uidIsSet, urlIsSet, tlmIsSet);
+                return false;
         }
-    }
+        DBG("Building AdvFrame %d: len=%d", frameType, serviceDataLen);
 
-    /*
-    * Callback to swap in URL frame
-    */
-    void urlCallback(void) {
-        DBG("urlCallback");
-        if (false == advLock) {
-            advLock = true;
-            DBG("advLock = url")
-            frameIndex = url;
-            swapOutFrames(frameIndex);
-            ble.startAdvertising();
-        } else {
-            // Someone else is broadcasting, toss it into the overflow buffer to retransmit when free
-            INFO("URI(%d) cannot complete, %d is currently broadcasting", url, frameIndex);
-            FrameTypes x = url;
-            overflow.push(x);
-        }
+        payload.clear();
+        payload.addFlags(GapAdvertisingData::BREDR_NOT_SUPPORTED | GapAdvertisingData::LE_GENERAL_DISCOVERABLE);
+        payload.addData(GapAdvertisingData::COMPLETE_LIST_16BIT_SERVICE_IDS, BEACON_EDDYSTONE, sizeof(BEACON_EDDYSTONE));
+        payload.addData(GapAdvertisingData::SERVICE_DATA, serviceData, serviceDataLen);
+        return true;
     }
 
     /*
-    * Callback to swap in UID frame
+    *   Called by the rotation before a frame goes on air. The TLM frame is
+    *   refreshed with the current telemetry, and advertised for a single event
+    *   until the TLM ticker enables it again, unless it is the only frame.
     */
-    void uidCallback(void) {
-        DBG("uidCallback");
-        if (false == advLock) {
-            advLock = true;
-            DBG("advLock = uid")
-            frameIndex = uid;
-            swapOutFrames(frameIndex);
-            ble.startAdvertising();
-        } else {
-            // Someone else is broadcasting, toss it into the overflow buffer to retransmit when free
-            INFO("UID(%d) cannot complete, %d is currently broadcasting", uid, frameIndex);
-            FrameTypes x = uid; // have to do this to satisfy cont vs volatile keywords... sigh...
-            overflow.push(x);
+    void frameChangeCallback(uint8_t index) {
+        frameIndex = (FrameTypes)index;
+        if (tlm == index) {
+            uint32_t eventCount = rotation.getEventCount();
+            TlmPduCount    += eventCount - lastEventCount;
+            lastEventCount  = eventCount;
+
+            GapAdvertisingData payload;
+            buildAdvPacket(tlm, payload);
+            rotation.setFrame(tlm, payload, (urlIsSet || uidIsSet) ? 0 : 1);
         }
     }
 
     /*
-    * Callback to swap in TLM frame
+    * Callback to put the TLM frame back in the rotation
     */
     void tlmCallback(void) {
         DBG("tlmCallback");
-        if (false == advLock) {
-            // OK to broadcast
-            advLock = true;
-            DBG("advLock = tlm")
-            frameIndex = tlm;
-            swapOutFrames(frameIndex);
-            ble.startAdvertising();
-        } else {
-            // Someone else is broadcasting, toss it into the overflow buffer to retransmit when free
-            INFO("TLM(%d) cannot complete, %d is currently broadcasting", tlm, frameIndex);
-            FrameTypes x = tlm;
-            overflow.push(x);
-        }
-    }
-
-    void stopAdvCallback(void) {
-        if (overflow.empty()) {
-            // if nothing left to transmit, stop
-            ble.stopAdvertising();
-            advLock = false; // unlock lock
-        } else {
-            // transmit other packets at current time index
-            FrameTypes x = NONE;
-            overflow.pop(x);
-            INFO("Re-Transmitting %d", x);
-            swapOutFrames(x);
-        }
-    }
-
-    /*
-    *  Callback from onRadioNotification(), used to update the PDUCounter and process next state.
-    */
-#define EDDYSTONE_SWAPFRAME_DELAYMS 1
-    void radioNotificationCallback(bool radioActive) {
-        // Update PDUCount
-        TlmPduCount++;
-        // True just before an frame is sent, false just after a frame is sent
-        if (radioActive) {
-            // Do Nothing
-        } else {
-            // Packet has been sent, disable advertising
-            stopAdv.attach_us(this, &EddystoneService::stopAdvCallback, 1);
-        }
+        rotation.setFrameEvents(tlm, 1);
     }
 
     /*
@@ -498,42 +394,54 @@ public:
         ble(bleIn),
         advPeriodus(beaconPeriodus),
         txPower(txPowerIn),
-        advLock(false),
-        frameIndex(NONE) {
+        frameIndex(NONE),
+        rotation(bleIn.gap()),
+        lastEventCount(0) {
     }
 
     /*
     * @breif this function starts eddystone advertising based on configured frames.
+    *
+    * The frames are preloaded in an AdvertisingRotation, so advertising is
+    * started once and the payloads are swapped without stopping it. URL and
+    * UID frames are advertised for their period, in advertising events, and
+    * the TLM frame is interleaved once per TLM period.
     */
     void start(void) {
-        // Initialize Frame transition, start with URL to pass eddystone validator app on first try
+        GapAdvertisingData payload;
+
         if (urlIsSet) {
-            frameIndex = url;
-            urlTicker.attach(this, &EddystoneService::urlCallback, (float) advPeriodus / 1000.0f);
-            DBG("attached urlCallback every %d seconds", urlAdvPeriod);
+            buildAdvPacket(url, payload);
+            rotation.setFrame(url, payload, (urlAdvPeriod < 1.0f) ? 1 : (uint16_t)urlAdvPeriod);
+            DBG("url frame advertised for %d events", (int)urlAdvPeriod);
         }
         if (uidIsSet) {
-            frameIndex = uid;
-            uidTicker.attach(this, &EddystoneService::uidCallback, uidAdvPeriod);
-            DBG("attached uidCallback every %d seconds", uidAdvPeriod);
+            buildAdvPacket(uid, payload);
+            rotation.setFrame(uid, payload, (uidAdvPeriod < 1.0f) ? 1 : (uint16_t)uidAdvPeriod);
+            DBG("uid frame advertised for %d events", (int)uidAdvPeriod);
         }
         if (tlmIsSet) {
-            frameIndex = tlm;
             // Make double sure the PDUCount and TimeSinceBoot fields are set to zero at reset
             updateTlmPduCount(0);
             updateTlmTimeSinceBoot(0);
             lastBootTimerRead = 0;
+            lastEventCount    = 0;
             timeSinceBootTimer.start();
+            buildAdvPacket(tlm, payload);
+            rotation.setFrame(tlm, payload, 1);
             tlmTicker.attach(this, &EddystoneService::tlmCallback, TlmAdvPeriod);
             DBG("attached tlmCallback every %d seconds", TlmAdvPeriod);
         }
-        if (NONE == frameIndex) {
+        if (!urlIsSet && !uidIsSet && !tlmIsSet) {
             error("No Frames were Initialized! Please initialize a frame before starting an eddystone beacon.");
         }
         //uidRFU = 0;
 
         ble.setTxPower(txPower);
-        ble.gap().onRadioNotification(this, &EddystoneService::radioNotificationCallback);
+        ble.setAdvertisingType(GapAdvertisingParams::ADV_NON_CONNECTABLE_UNDIRECTED);
+        ble.setAdvertisingInterval(advPeriodus);
+        rotation.onFrameChange(this, &EddystoneService::frameChangeCallback);
+        rotation.start();
     }
 
 private:
@@ -544,9 +452,9 @@ private:
     uint8_t             txPower;
     Timer               timeSinceBootTimer;
     volatile uint32_t   lastBootTimerRead;
-    volatile bool       advLock;
     volatile FrameTypes frameIndex;
-    Timeout             stopAdv;
+    AdvertisingRotation rotation;
+    uint32_t            lastEventCount;
 
 
     // URI Frame Variables
@@ -555,7 +463,6 @@ private:
     int8_t              defaultUrlPower;
     bool                urlIsSet;       // flag that enables / disable URI Frames
     float               urlAdvPeriod;   // how long the url frame will be advertised for
-    Ticker              urlTicker;
 
     // UID Frame Variables
     UIDNamespaceID_t    defaultUidNamespaceID;
@@ -564,7 +471,6 @@ private:
     uint16_t            uidRFU;
     bool                uidIsSet;       // flag that enables / disable UID Frames
     float               uidAdvPeriod;   // how long the uid frame will be advertised for
-    Ticker              uidTicker;
 
     // TLM Frame Variables
     uint8_t             TlmVersion;
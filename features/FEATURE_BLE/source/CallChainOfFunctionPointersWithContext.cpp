@@ -0,0 +1,76 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2006-2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ble/CallChainOfFunctionPointersWithContext.h"
+
+#if BLE_CALLCHAIN_STATIC_NODES > 0
+
+/* A free node holds the link to the next free node */
+union CallChainNode {
+    CallChainNode *next;
+    uint64_t       alignment;
+    char           storage[CallChainNodePool::NODE_SIZE];
+};
+
+static CallChainNode  nodes[BLE_CALLCHAIN_STATIC_NODES];
+static CallChainNode *freeList;
+static bool           initialized;
+
+void *CallChainNodePool::allocate(void)
+{
+    if (!initialized) {
+        for (unsigned i = 0; i < BLE_CALLCHAIN_STATIC_NODES - 1; i++) {
+            nodes[i].next = &nodes[i + 1];
+        }
+        nodes[BLE_CALLCHAIN_STATIC_NODES - 1].next = NULL;
+        freeList = &nodes[0];
+        initialized = true;
+    }
+
+    CallChainNode *node = freeList;
+    if (node) {
+        freeList = node->next;
+    }
+
+    return node;
+}
+
+bool CallChainNodePool::release(void *p)
+{
+    CallChainNode *node = static_cast<CallChainNode *>(p);
+    if (node < &nodes[0] || node >= &nodes[BLE_CALLCHAIN_STATIC_NODES]) {
+        return false;
+    }
+
+    node->next = freeList;
+    freeList = node;
+    return true;
+}
+
+#else
+
+void *CallChainNodePool::allocate(void)
+{
+    return NULL;
+}
+
+bool CallChainNodePool::release(void *p)
+{
+    (void)p;
+    return false;
+}
+
+#endif
@@ -0,0 +1,270 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2006-2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ble/GapConnectionManager.h"
+
+#include <string.h>
+
+/* Connection parameter limits of the specification */
+#define CONN_INTERVAL_MIN        6      /* 7.5 ms */
+#define CONN_INTERVAL_MAX        3200   /* 4 s */
+#define SLAVE_LATENCY_MAX        499
+#define SUPERVISION_TIMEOUT_MIN  10     /* 100 ms */
+#define SUPERVISION_TIMEOUT_MAX  3200   /* 32 s */
+
+GapConnectionManager::GapConnectionManager(Gap &gap) :
+    _gap(gap),
+    _eventLength(3),
+    _minInterval(CONN_INTERVAL_MIN),
+    _slaveLatency(0),
+    _supervisionTimeout(400),
+    _attemptActive(false),
+    _attempt(),
+    _pending(),
+    _pendingHead(0),
+    _pendingCount(0),
+    _links(),
+    _linkCount(0),
+    _attempts(0),
+    _failures(0)
+{
+    _gap.onConnection(this, &GapConnectionManager::onConnection);
+    _gap.onDisconnection(this, &GapConnectionManager::onDisconnection);
+    _gap.onTimeout().add(this, &GapConnectionManager::onTimeout);
+    _gap.onConnectionParamsUpdate(this, &GapConnectionManager::onConnectionParamsUpdate);
+}
+
+GapConnectionManager::~GapConnectionManager()
+{
+    _gap.onConnection().detach(
+        Gap::ConnectionEventCallback_t(this, &GapConnectionManager::onConnection));
+    _gap.onDisconnection().detach(
+        Gap::DisconnectionEventCallback_t(this, &GapConnectionManager::onDisconnection));
+    _gap.onTimeout().detach(
+        Gap::TimeoutEventCallback_t(this, &GapConnectionManager::onTimeout));
+    _gap.onConnectionParamsUpdate().detach(
+        Gap::ConnectionParamsUpdateEventCallback_t(this, &GapConnectionManager::onConnectionParamsUpdate));
+}
+
+ble_error_t GapConnectionManager::setSchedule(uint16_t eventLength,
+                                              uint16_t minInterval,
+                                              uint16_t slaveLatency,
+                                              uint16_t supervisionTimeout)
+{
+    if (eventLength == 0 || eventLength > CONN_INTERVAL_MAX ||
+        minInterval < CONN_INTERVAL_MIN || minInterval > CONN_INTERVAL_MAX ||
+        slaveLatency > SLAVE_LATENCY_MAX ||
+        supervisionTimeout < SUPERVISION_TIMEOUT_MIN || supervisionTimeout > SUPERVISION_TIMEOUT_MAX) {
+        return BLE_ERROR_PARAM_OUT_OF_RANGE;
+    }
+
+    _eventLength        = eventLength;
+    _minInterval        = minInterval;
+    _slaveLatency       = slaveLatency;
+    _supervisionTimeout = supervisionTimeout;
+
+    reschedule();
+    return BLE_ERROR_NONE;
+}
+
+ble_error_t GapConnectionManager::connect(const BLEProtocol::AddressBytes_t  peerAddr,
+                                          BLEProtocol::AddressType_t         peerAddrType,
+                                          const GapScanningParams           *scanParams)
+{
+    unsigned inProgress = _linkCount + (_attemptActive ? 1 : 0) + _pendingCount;
+    if (inProgress >= BLE_GAP_CONNECTION_MANAGER_MAX_LINKS ||
+        _pendingCount >= BLE_GAP_CONNECTION_MANAGER_MAX_PENDING) {
+        return BLE_ERROR_NO_MEM;
+    }
+
+    PendingConnection_t request;
+    memcpy(request.peerAddr, peerAddr, BLEProtocol::ADDR_LEN);
+    request.peerAddrType = peerAddrType;
+    request.scanParams   = scanParams;
+
+    if (_attemptActive) {
+        _pending[(_pendingHead + _pendingCount) % BLE_GAP_CONNECTION_MANAGER_MAX_PENDING] = request;
+        _pendingCount++;
+        return BLE_ERROR_NONE;
+    }
+
+    _attempt = request;
+    return startAttempt();
+}
+
+void GapConnectionManager::clearPending(void)
+{
+    _pendingHead  = 0;
+    _pendingCount = 0;
+}
+
+uint16_t GapConnectionManager::getIntervalForLinks(uint8_t links) const
+{
+    uint32_t interval = (uint32_t)_eventLength * (links ? links : 1);
+    if (interval < _minInterval) {
+        interval = _minInterval;
+    }
+    if (interval > CONN_INTERVAL_MAX) {
+        interval = CONN_INTERVAL_MAX;
+    }
+    return interval;
+}
+
+void GapConnectionManager::getStatistics(Statistics_t *statistics) const
+{
+    statistics->attempts = _attempts;
+    statistics->failures = _failures;
+    statistics->pending  = _pendingCount;
+    statistics->links    = _linkCount;
+}
+
+void GapConnectionManager::makeParams(uint8_t links, Gap::ConnectionParams_t *params) const
+{
+    uint16_t interval = getIntervalForLinks(links);
+
+    /* The timeout must cover two intervals stretched by the latency:
+     * timeout * 10 ms > (1 + latency) * interval * 1.25 ms * 2 */
+    uint32_t minTimeout = ((uint32_t)(1 + _slaveLatency) * interval) / 4 + 1;
+    uint32_t timeout    = _supervisionTimeout;
+    if (timeout < minTimeout) {
+        timeout = (minTimeout > SUPERVISION_TIMEOUT_MAX) ? SUPERVISION_TIMEOUT_MAX : minTimeout;
+    }
+
+    params->minConnectionInterval        = interval;
+    params->maxConnectionInterval        = interval;
+    params->slaveLatency                 = _slaveLatency;
+    params->connectionSupervisionTimeout = timeout;
+}
+
+ble_error_t GapConnectionManager::startAttempt(void)
+{
+    Gap::ConnectionParams_t params;
+    makeParams(_linkCount + 1, &params);
+
+    _attempts++;
+    ble_error_t err = _gap.connect(_attempt.peerAddr, _attempt.peerAddrType, &params, _attempt.scanParams);
+    if (err != BLE_ERROR_NONE) {
+        _failures++;
+        return err;
+    }
+
+    _attemptActive = true;
+    return BLE_ERROR_NONE;
+}
+
+void GapConnectionManager::startNext(void)
+{
+    while (!_attemptActive && _pendingCount) {
+        _attempt     = _pending[_pendingHead];
+        _pendingHead = (_pendingHead + 1) % BLE_GAP_CONNECTION_MANAGER_MAX_PENDING;
+        _pendingCount--;
+
+        /* A request which cannot start counts as failed, try the next one */
+        startAttempt();
+    }
+}
+
+void GapConnectionManager::reschedule(void)
+{
+    Gap::ConnectionParams_t params;
+    makeParams(_linkCount, &params);
+
+    for (uint8_t i = 0; i < _linkCount; i++) {
+        LinkStatistics_t &link = _links[i];
+        if (link.targetInterval == params.minConnectionInterval &&
+            link.connectionInterval == params.minConnectionInterval) {
+            continue;
+        }
+
+        link.targetInterval = params.minConnectionInterval;
+        if (_gap.updateConnectionParams(link.handle, &params) != BLE_ERROR_NONE) {
+            link.updateFailures++;
+        }
+    }
+}
+
+int GapConnectionManager::findLink(Gap::Handle_t handle) const
+{
+    for (uint8_t i = 0; i < _linkCount; i++) {
+        if (_links[i].handle == handle) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void GapConnectionManager::onConnection(const Gap::ConnectionCallbackParams_t *params)
+{
+    if (params->role != Gap::CENTRAL || !_attemptActive ||
+        memcmp(params->peerAddr, _attempt.peerAddr, BLEProtocol::ADDR_LEN) != 0) {
+        /* Not established through the manager */
+        return;
+    }
+    _attemptActive = false;
+
+    if (_linkCount < BLE_GAP_CONNECTION_MANAGER_MAX_LINKS) {
+        LinkStatistics_t &link = _links[_linkCount++];
+        memset(&link, 0, sizeof(link));
+        link.handle             = params->handle;
+        link.peerAddrType       = params->peerAddrType;
+        memcpy(link.peerAddr, params->peerAddr, BLEProtocol::ADDR_LEN);
+        link.connectionInterval = params->connectionParams->maxConnectionInterval;
+        link.slaveLatency       = params->connectionParams->slaveLatency;
+        link.supervisionTimeout = params->connectionParams->connectionSupervisionTimeout;
+        link.targetInterval     = link.connectionInterval;
+
+        /* The older links move to the interval sized for the new count */
+        reschedule();
+    }
+
+    startNext();
+}
+
+void GapConnectionManager::onDisconnection(const Gap::DisconnectionCallbackParams_t *params)
+{
+    int index = findLink(params->handle);
+    if (index < 0) {
+        return;
+    }
+
+    _links[index] = _links[--_linkCount];
+    reschedule();
+}
+
+void GapConnectionManager::onTimeout(Gap::TimeoutSource_t source)
+{
+    if (source != Gap::TIMEOUT_SRC_CONN || !_attemptActive) {
+        return;
+    }
+
+    _attemptActive = false;
+    _failures++;
+    startNext();
+}
+
+void GapConnectionManager::onConnectionParamsUpdate(const Gap::ConnectionParamsUpdateCallbackParams_t *params)
+{
+    int index = findLink(params->handle);
+    if (index < 0) {
+        return;
+    }
+
+    LinkStatistics_t &link = _links[index];
+    link.connectionInterval = params->connectionParams->maxConnectionInterval;
+    link.slaveLatency       = params->connectionParams->slaveLatency;
+    link.supervisionTimeout = params->connectionParams->connectionSupervisionTimeout;
+    link.parameterUpdates++;
+}
@@ -0,0 +1,195 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2006-2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ble/GapScanFilter.h"
+#include "ble/GapAdvertisingData.h"
+
+#ifdef YOTTA_CFG_MBED_OS
+    #include "mbed-drivers/mbed.h"
+#else
+    #include "mbed.h"
+#endif
+
+GapScanFilter::GapScanFilter() :
+    _minRssi(-128),
+    _uuidLen(0),
+    _uuid(),
+    _manufacturerDataLen(0),
+    _manufacturerData(),
+    _duplicateWindow(0),
+    _duplicateCount(0),
+    _duplicateNext(0) {
+    /* empty */
+}
+
+void GapScanFilter::setServiceUuid(const UUID &uuid)
+{
+    /* Both forms are kept little endian, as they appear in the payload */
+    _uuidLen = uuid.getLen();
+    memcpy(_uuid, uuid.getBaseUUID(), _uuidLen);
+}
+
+ble_error_t GapScanFilter::setManufacturerData(const uint8_t *prefix, uint8_t len)
+{
+    if (len > BLE_GAP_SCAN_FILTER_MANUFACTURER_DATA_MAX) {
+        return BLE_ERROR_PARAM_OUT_OF_RANGE;
+    }
+
+    _manufacturerDataLen = len;
+    memcpy(_manufacturerData, prefix, len);
+    return BLE_ERROR_NONE;
+}
+
+void GapScanFilter::clearDuplicates(void)
+{
+    _duplicateCount = 0;
+    _duplicateNext  = 0;
+}
+
+void GapScanFilter::clear(void)
+{
+    _minRssi             = -128;
+    _uuidLen             = 0;
+    _manufacturerDataLen = 0;
+    _duplicateWindow     = 0;
+    clearDuplicates();
+}
+
+bool GapScanFilter::accept(const BLEProtocol::AddressBytes_t  peerAddr,
+                           int8_t                             rssi,
+                           bool                               isScanResponse,
+                           uint8_t                            advertisingDataLen,
+                           const uint8_t                     *advertisingData)
+{
+    if (rssi < _minRssi) {
+        return false;
+    }
+
+    if (_uuidLen && !matchServiceUuid(advertisingDataLen, advertisingData)) {
+        return false;
+    }
+
+    if (_manufacturerDataLen && !matchManufacturerData(advertisingDataLen, advertisingData)) {
+        return false;
+    }
+
+    if (_duplicateWindow && isDuplicate(peerAddr, isScanResponse, advertisingDataLen, advertisingData)) {
+        return false;
+    }
+
+    return true;
+}
+
+bool GapScanFilter::matchServiceUuid(uint8_t advertisingDataLen, const uint8_t *advertisingData) const
+{
+    uint8_t index = 0;
+    while (index + 1 < advertisingDataLen) {
+        uint8_t fieldLen  = advertisingData[index];
+        uint8_t fieldType = advertisingData[index + 1];
+        if (fieldLen == 0 || index + 1 + fieldLen > advertisingDataLen) {
+            break;
+        }
+
+        bool isShortList = (fieldType == GapAdvertisingData::INCOMPLETE_LIST_16BIT_SERVICE_IDS ||
+                            fieldType == GapAdvertisingData::COMPLETE_LIST_16BIT_SERVICE_IDS);
+        bool isLongList  = (fieldType == GapAdvertisingData::INCOMPLETE_LIST_128BIT_SERVICE_IDS ||
+                            fieldType == GapAdvertisingData::COMPLETE_LIST_128BIT_SERVICE_IDS);
+        if ((isShortList && _uuidLen == sizeof(UUID::ShortUUIDBytes_t)) ||
+            (isLongList  && _uuidLen == UUID::LENGTH_OF_LONG_UUID)) {
+            const uint8_t *uuids = &advertisingData[index + 2];
+            for (uint8_t offset = 0; offset + _uuidLen <= fieldLen - 1; offset += _uuidLen) {
+                if (memcmp(&uuids[offset], _uuid, _uuidLen) == 0) {
+                    return true;
+                }
+            }
+        }
+
+        index += fieldLen + 1;
+    }
+
+    return false;
+}
+
+bool GapScanFilter::matchManufacturerData(uint8_t advertisingDataLen, const uint8_t *advertisingData) const
+{
+    uint8_t index = 0;
+    while (index + 1 < advertisingDataLen) {
+        uint8_t fieldLen  = advertisingData[index];
+        uint8_t fieldType = advertisingData[index + 1];
+        if (fieldLen == 0 || index + 1 + fieldLen > advertisingDataLen) {
+            break;
+        }
+
+        if (fieldType == GapAdvertisingData::MANUFACTURER_SPECIFIC_DATA &&
+            fieldLen - 1 >= _manufacturerDataLen &&
+            memcmp(&advertisingData[index + 2], _manufacturerData, _manufacturerDataLen) == 0) {
+            return true;
+        }
+
+        index += fieldLen + 1;
+    }
+
+    return false;
+}
+
+bool GapScanFilter::isDuplicate(const BLEProtocol::AddressBytes_t  peerAddr,
+                                bool                               isScanResponse,
+                                uint8_t                            advertisingDataLen,
+                                const uint8_t                     *advertisingData)
+{
+    /* Fletcher-16 over the payload */
+    uint16_t sum1 = 0;
+    uint16_t sum2 = 0;
+    for (uint8_t i = 0; i < advertisingDataLen; i++) {
+        sum1 = (sum1 + advertisingData[i]) % 255;
+        sum2 = (sum2 + sum1) % 255;
+    }
+    uint16_t checksum = (sum2 << 8) | sum1;
+
+    uint32_t now = us_ticker_read();
+    uint32_t window = (uint32_t)_duplicateWindow * 1000;
+
+    for (uint16_t i = 0; i < _duplicateCount; i++) {
+        DuplicateEntry_t &entry = _duplicates[i];
+        /* Advertisements and scan responses are tracked separately */
+        if (entry.isScanResponse != isScanResponse ||
+            memcmp(entry.address, peerAddr, BLEProtocol::ADDR_LEN) != 0) {
+            continue;
+        }
+
+        if (entry.checksum == checksum && (uint32_t)(now - entry.time) < window) {
+            return true;
+        }
+
+        entry.checksum = checksum;
+        entry.time     = now;
+        return false;
+    }
+
+    /* New advertiser, replace the oldest entry once the cache is full */
+    DuplicateEntry_t &entry = _duplicates[_duplicateNext];
+    memcpy(entry.address, peerAddr, BLEProtocol::ADDR_LEN);
+    entry.isScanResponse = isScanResponse;
+    entry.checksum = checksum;
+    entry.time     = now;
+
+    _duplicateNext = (_duplicateNext + 1) % BLE_GAP_SCAN_DUPLICATE_CACHE_SIZE;
+    if (_duplicateCount < BLE_GAP_SCAN_DUPLICATE_CACHE_SIZE) {
+        _duplicateCount++;
+    }
+
+    return false;
+}
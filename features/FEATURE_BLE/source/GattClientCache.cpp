@@ -0,0 +1,329 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2006-2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ble/GattClientCache.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/* Identifies a stored table, and changes with its layout */
+#define GATT_CLIENT_CACHE_MAGIC 0x4701
+
+enum {
+    PROP_BROADCAST          = 0x01,
+    PROP_READ               = 0x02,
+    PROP_WRITE_WO_RESP      = 0x04,
+    PROP_WRITE              = 0x08,
+    PROP_NOTIFY             = 0x10,
+    PROP_INDICATE           = 0x20,
+    PROP_AUTH_SIGNED_WRITE  = 0x40
+};
+
+void GattClientCache::CachedCharacteristic::setup(GattClient              *gattcIn,
+                                                  Gap::Handle_t            connectionHandleIn,
+                                                  const UUID              &uuidIn,
+                                                  uint8_t                  propsIn,
+                                                  GattAttribute::Handle_t  declHandleIn,
+                                                  GattAttribute::Handle_t  valueHandleIn,
+                                                  GattAttribute::Handle_t  lastHandleIn)
+{
+    gattc       = gattcIn;
+    connHandle  = connectionHandleIn;
+    uuid        = uuidIn;
+    declHandle  = declHandleIn;
+    valueHandle = valueHandleIn;
+    lastHandle  = lastHandleIn;
+
+    props._broadcast       = (propsIn & PROP_BROADCAST) ? 1 : 0;
+    props._read            = (propsIn & PROP_READ) ? 1 : 0;
+    props._writeWoResp     = (propsIn & PROP_WRITE_WO_RESP) ? 1 : 0;
+    props._write           = (propsIn & PROP_WRITE) ? 1 : 0;
+    props._notify          = (propsIn & PROP_NOTIFY) ? 1 : 0;
+    props._indicate        = (propsIn & PROP_INDICATE) ? 1 : 0;
+    props._authSignedWrite = (propsIn & PROP_AUTH_SIGNED_WRITE) ? 1 : 0;
+}
+
+GattClientCache::GattClientCache(Gap &gap, GattClient &client, Store &store) :
+    _gap(gap),
+    _client(client),
+    _store(store),
+    _table(),
+    _active(false),
+    _complete(false),
+    _connectionHandle(),
+    _key(),
+    _serviceCallback(),
+    _characteristicCallback(),
+    _terminationCallback(),
+    _matchingServiceUUID(),
+    _matchingCharacteristicUUID()
+{
+    _gap.onDisconnection(this, &GattClientCache::onDisconnection);
+}
+
+GattClientCache::~GattClientCache()
+{
+    _gap.onDisconnection().detach(
+        Gap::DisconnectionEventCallback_t(this, &GattClientCache::onDisconnection));
+}
+
+ble_error_t GattClientCache::launchServiceDiscovery(Gap::Handle_t                              connectionHandle,
+                                                    const BLEProtocol::Address_t              &peerAddr,
+                                                    ServiceDiscovery::ServiceCallback_t        sc,
+                                                    ServiceDiscovery::CharacteristicCallback_t cc,
+                                                    ServiceDiscovery::TerminationCallback_t    tc,
+                                                    const UUID                                &matchingServiceUUID,
+                                                    const UUID                                &matchingCharacteristicUUID)
+{
+    if (_active) {
+        return BLE_STACK_BUSY;
+    }
+
+    _connectionHandle           = connectionHandle;
+    _serviceCallback            = sc;
+    _characteristicCallback     = cc;
+    _terminationCallback        = tc;
+    _matchingServiceUUID        = matchingServiceUUID;
+    _matchingCharacteristicUUID = matchingCharacteristicUUID;
+
+    if (load(peerAddr)) {
+        replay();
+        return BLE_ERROR_NONE;
+    }
+
+    /* Walk the whole table, the callbacks only see what they asked for */
+    makeKey(peerAddr, _key);
+    _table.magic               = GATT_CLIENT_CACHE_MAGIC;
+    _table.serviceCount        = 0;
+    _table.characteristicCount = 0;
+    _complete                  = true;
+    _active                    = true;
+
+    _client.onServiceDiscoveryTermination(
+        ServiceDiscovery::TerminationCallback_t(this, &GattClientCache::onTermination));
+    ble_error_t err = _client.launchServiceDiscovery(
+        connectionHandle,
+        ServiceDiscovery::ServiceCallback_t(this, &GattClientCache::onService),
+        ServiceDiscovery::CharacteristicCallback_t(this, &GattClientCache::onCharacteristic));
+    if (err != BLE_ERROR_NONE) {
+        _active = false;
+    }
+    return err;
+}
+
+bool GattClientCache::contains(const BLEProtocol::Address_t &peerAddr)
+{
+    char key[KEY_SIZE];
+    makeKey(peerAddr, key);
+
+    uint16_t magic;
+    size_t size = 0;
+    /* Only the size of the value matters, the buffer is deliberately short */
+    _store.get(key, &magic, sizeof(magic), &size);
+    return size == sizeof(Table_t);
+}
+
+ble_error_t GattClientCache::invalidate(const BLEProtocol::Address_t &peerAddr)
+{
+    char key[KEY_SIZE];
+    makeKey(peerAddr, key);
+
+    if (_active && strcmp(key, _key) == 0) {
+        _complete = false;
+    }
+
+    if (!contains(peerAddr)) {
+        return BLE_ERROR_NONE;
+    }
+    return _store.remove(key) == 0 ? BLE_ERROR_NONE : BLE_ERROR_INVALID_STATE;
+}
+
+void GattClientCache::terminateServiceDiscovery(void)
+{
+    if (_active) {
+        _complete = false;
+        _client.terminateServiceDiscovery();
+    }
+}
+
+void GattClientCache::makeKey(const BLEProtocol::Address_t &peerAddr, char *key)
+{
+    int len = snprintf(key, KEY_SIZE, "gattc/%02x", (unsigned)peerAddr.type);
+    for (size_t i = 0; i < BLEProtocol::ADDR_LEN; i++) {
+        /* Most significant byte first, as addresses are usually written */
+        len += snprintf(key + len, KEY_SIZE - len, "%02x",
+                        peerAddr.address[BLEProtocol::ADDR_LEN - 1 - i]);
+    }
+}
+
+void GattClientCache::storeUuid(const UUID &uuid, uint8_t &type, uint8_t *bytes)
+{
+    type = uuid.shortOrLong();
+    memset(bytes, 0, UUID::LENGTH_OF_LONG_UUID);
+    if (type == UUID::UUID_TYPE_LONG) {
+        memcpy(bytes, uuid.getBaseUUID(), UUID::LENGTH_OF_LONG_UUID);
+    } else {
+        bytes[0] = uuid.getShortUUID() & 0xFF;
+        bytes[1] = uuid.getShortUUID() >> 8;
+    }
+}
+
+UUID GattClientCache::loadUuid(uint8_t type, const uint8_t *bytes)
+{
+    if (type == UUID::UUID_TYPE_LONG) {
+        return UUID(bytes, UUID::LSB);
+    }
+    return UUID((UUID::ShortUUIDBytes_t)(bytes[0] | (bytes[1] << 8)));
+}
+
+bool GattClientCache::matches(const UUID &filter, const UUID &uuid)
+{
+    return (filter.shortOrLong() == UUID::UUID_TYPE_SHORT &&
+            filter.getShortUUID() == BLE_UUID_UNKNOWN) ||
+           filter == uuid;
+}
+
+bool GattClientCache::load(const BLEProtocol::Address_t &peerAddr)
+{
+    char key[KEY_SIZE];
+    makeKey(peerAddr, key);
+
+    size_t size = 0;
+    int err = _store.get(key, &_table, sizeof(_table), &size);
+    return err == 0 &&
+           size == sizeof(_table) &&
+           _table.magic == GATT_CLIENT_CACHE_MAGIC &&
+           _table.serviceCount <= BLE_GATT_CLIENT_CACHE_MAX_SERVICES &&
+           _table.characteristicCount <= BLE_GATT_CLIENT_CACHE_MAX_CHARACTERISTICS;
+}
+
+void GattClientCache::replay(void)
+{
+    for (uint8_t i = 0; i < _table.serviceCount; i++) {
+        const ServiceEntry_t &entry = _table.services[i];
+
+        DiscoveredService service;
+        service.setup(loadUuid(entry.uuidType, entry.uuid), entry.startHandle, entry.endHandle);
+        if (!matches(_matchingServiceUUID, service.getUUID())) {
+            continue;
+        }
+
+        if (_serviceCallback.toBool()) {
+            _serviceCallback.call(&service);
+        }
+
+        if (!_characteristicCallback.toBool()) {
+            continue;
+        }
+
+        for (uint8_t j = 0; j < _table.characteristicCount; j++) {
+            const CharacteristicEntry_t &c = _table.characteristics[j];
+            if (c.declHandle < entry.startHandle || c.declHandle > entry.endHandle) {
+                continue;
+            }
+
+            CachedCharacteristic characteristic;
+            characteristic.setup(&_client, _connectionHandle, loadUuid(c.uuidType, c.uuid),
+                                 c.props, c.declHandle, c.valueHandle, c.lastHandle);
+            if (matches(_matchingCharacteristicUUID, characteristic.getUUID())) {
+                _characteristicCallback.call(&characteristic);
+            }
+        }
+    }
+
+    if (_terminationCallback.toBool()) {
+        _terminationCallback.call(_connectionHandle);
+    }
+}
+
+bool GattClientCache::isInMatchingService(GattAttribute::Handle_t handle) const
+{
+    for (uint8_t i = 0; i < _table.serviceCount; i++) {
+        const ServiceEntry_t &entry = _table.services[i];
+        if (handle >= entry.startHandle && handle <= entry.endHandle) {
+            return matches(_matchingServiceUUID, loadUuid(entry.uuidType, entry.uuid));
+        }
+    }
+    return false;
+}
+
+void GattClientCache::onService(const DiscoveredService *service)
+{
+    if (_table.serviceCount < BLE_GATT_CLIENT_CACHE_MAX_SERVICES) {
+        ServiceEntry_t &entry = _table.services[_table.serviceCount++];
+        storeUuid(service->getUUID(), entry.uuidType, entry.uuid);
+        entry.startHandle = service->getStartHandle();
+        entry.endHandle   = service->getEndHandle();
+    } else {
+        _complete = false;
+    }
+
+    if (_serviceCallback.toBool() && matches(_matchingServiceUUID, service->getUUID())) {
+        _serviceCallback.call(service);
+    }
+}
+
+void GattClientCache::onCharacteristic(const DiscoveredCharacteristic *characteristic)
+{
+    if (_table.characteristicCount < BLE_GATT_CLIENT_CACHE_MAX_CHARACTERISTICS) {
+        CharacteristicEntry_t &entry = _table.characteristics[_table.characteristicCount++];
+        const DiscoveredCharacteristic::Properties_t &props = characteristic->getProperties();
+
+        storeUuid(characteristic->getUUID(), entry.uuidType, entry.uuid);
+        entry.props = (props.broadcast()       ? PROP_BROADCAST         : 0) |
+                      (props.read()            ? PROP_READ              : 0) |
+                      (props.writeWoResp()     ? PROP_WRITE_WO_RESP     : 0) |
+                      (props.write()           ? PROP_WRITE             : 0) |
+                      (props.notify()          ? PROP_NOTIFY            : 0) |
+                      (props.indicate()        ? PROP_INDICATE          : 0) |
+                      (props.authSignedWrite() ? PROP_AUTH_SIGNED_WRITE : 0);
+        entry.declHandle  = characteristic->getDeclHandle();
+        entry.valueHandle = characteristic->getValueHandle();
+        entry.lastHandle  = characteristic->getLastHandle();
+    } else {
+        _complete = false;
+    }
+
+    if (_characteristicCallback.toBool() &&
+        isInMatchingService(characteristic->getDeclHandle()) &&
+        matches(_matchingCharacteristicUUID, characteristic->getUUID())) {
+        _characteristicCallback.call(characteristic);
+    }
+}
+
+void GattClientCache::onTermination(Gap::Handle_t connectionHandle)
+{
+    if (!_active || connectionHandle != _connectionHandle) {
+        return;
+    }
+    _active = false;
+
+    if (_complete) {
+        _store.set(_key, &_table, sizeof(_table));
+    }
+
+    if (_terminationCallback.toBool()) {
+        _terminationCallback.call(connectionHandle);
+    }
+}
+
+void GattClientCache::onDisconnection(const Gap::DisconnectionCallbackParams_t *params)
+{
+    /* The stack ends the discovery, but the table is partial */
+    if (_active && params->handle == _connectionHandle) {
+        _complete = false;
+    }
+}
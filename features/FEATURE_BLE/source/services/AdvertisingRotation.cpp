@@ -0,0 +1,165 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2006-2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ble/services/AdvertisingRotation.h"
+
+/* Average of the 0 to 10 ms random delay added to every advertising event */
+#define ADV_DELAY_AVERAGE_MS 5
+
+AdvertisingRotation::AdvertisingRotation(Gap &gap) :
+    _gap(gap),
+    _payloads(),
+    _events(),
+    _frameCallback(),
+    _timeout(),
+    _running(false),
+    _offloaded(false),
+    _current(-1),
+    _armedEvents(0),
+    _eventCount(0)
+{
+    /* empty */
+}
+
+ble_error_t AdvertisingRotation::setFrame(uint8_t index, const GapAdvertisingData &payload, uint16_t events)
+{
+    if (index >= BLE_ADVERTISING_ROTATION_MAX_FRAMES) {
+        return BLE_ERROR_PARAM_OUT_OF_RANGE;
+    }
+
+    /* The rotation reads the payloads from the timeout interrupt */
+    core_util_critical_section_enter();
+    _payloads[index] = payload;
+    _events[index]   = events;
+    core_util_critical_section_exit();
+
+    if (!_running) {
+        return BLE_ERROR_NONE;
+    }
+    if (_offloaded) {
+        return loadSets();
+    }
+    if (index == _current) {
+        return _gap.setAdvertisingPayload(_payloads[index]);
+    }
+    return BLE_ERROR_NONE;
+}
+
+ble_error_t AdvertisingRotation::setFrameEvents(uint8_t index, uint16_t events)
+{
+    if (index >= BLE_ADVERTISING_ROTATION_MAX_FRAMES) {
+        return BLE_ERROR_PARAM_OUT_OF_RANGE;
+    }
+
+    _events[index] = events;
+    if (_running && _offloaded) {
+        return loadSets();
+    }
+    return BLE_ERROR_NONE;
+}
+
+ble_error_t AdvertisingRotation::start(void)
+{
+    if (_running) {
+        return BLE_ERROR_NONE;
+    }
+
+    int first = nextFrame(-1);
+    if (first < 0) {
+        return BLE_ERROR_INVALID_STATE;
+    }
+
+    _eventCount = 0;
+    _offloaded  = (loadSets() == BLE_ERROR_NONE);
+
+    if (!_offloaded) {
+        if (_frameCallback) {
+            _frameCallback(first);
+        }
+        _current = first;
+        ble_error_t err = _gap.setAdvertisingPayload(_payloads[_current]);
+        if (err != BLE_ERROR_NONE) {
+            return err;
+        }
+    }
+
+    ble_error_t err = _gap.startAdvertising();
+    if (err != BLE_ERROR_NONE) {
+        if (_offloaded) {
+            _gap.setAdvertisingSets(NULL, NULL, 0);
+        }
+        return err;
+    }
+
+    _running = true;
+    if (!_offloaded) {
+        arm(_events[_current]);
+    }
+    return BLE_ERROR_NONE;
+}
+
+ble_error_t AdvertisingRotation::stop(void)
+{
+    _timeout.detach();
+    if (_running && _offloaded) {
+        _gap.setAdvertisingSets(NULL, NULL, 0);
+    }
+    _running = false;
+    _current = -1;
+    return _gap.stopAdvertising();
+}
+
+int AdvertisingRotation::nextFrame(int from) const
+{
+    for (int i = 1; i <= BLE_ADVERTISING_ROTATION_MAX_FRAMES; i++) {
+        int index = (from + i) % BLE_ADVERTISING_ROTATION_MAX_FRAMES;
+        if (_events[index]) {
+            return index;
+        }
+    }
+    return -1;
+}
+
+ble_error_t AdvertisingRotation::loadSets(void)
+{
+    return _gap.setAdvertisingSets(_payloads, _events, BLE_ADVERTISING_ROTATION_MAX_FRAMES);
+}
+
+void AdvertisingRotation::arm(uint16_t events)
+{
+    uint32_t eventMs = _gap.getAdvertisingParams().getInterval() + ADV_DELAY_AVERAGE_MS;
+    _armedEvents = events;
+    _timeout.attach_us(this, &AdvertisingRotation::rotate, events * eventMs * 1000);
+}
+
+void AdvertisingRotation::rotate(void)
+{
+    _eventCount += _armedEvents;
+
+    /* With every frame disabled, keep the last payload on air */
+    int next = nextFrame(_current);
+    if (next >= 0) {
+        if (_frameCallback) {
+            _frameCallback(next);
+        }
+        if (next != _current || _frameCallback) {
+            _gap.setAdvertisingPayload(_payloads[next]);
+        }
+        _current = next;
+    }
+
+    arm(_events[_current] ? _events[_current] : 1);
+}
@@ -0,0 +1,532 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2006-2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ble/services/BenchmarkClient.h"
+#include "ble/DiscoveredCharacteristic.h"
+
+/* Default ATT_MTU and link layer payload of the specification */
+#define DEFAULT_ATT_MTU      23
+#define DEFAULT_DATA_LENGTH  27
+
+static uint32_t getUint32(const uint8_t *bytes)
+{
+    return bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+}
+
+static void setUint32(uint8_t *bytes, uint32_t value)
+{
+    bytes[0] = value;
+    bytes[1] = value >> 8;
+    bytes[2] = value >> 16;
+    bytes[3] = value >> 24;
+}
+
+static bool isOutOfBuffers(ble_error_t err)
+{
+    return (err == BLE_ERROR_NO_MEM) || (err == BLE_STACK_BUSY);
+}
+
+BenchmarkClient::BenchmarkClient(BLE &ble) :
+    _ble(ble),
+    _state(STATE_IDLE),
+    _ready(false),
+    _stopIssued(false),
+    _connectionHandle(0),
+    _controlHandle(0),
+    _dataHandle(0),
+    _resultHandle(0),
+    _attachCallback(),
+    _reportCallback(),
+    _report(),
+    _count(0),
+    _sent(0),
+    _firstUs(0),
+    _sentUs(0),
+    _payload(),
+    _samples(),
+    _timer(),
+    _watchdog()
+{
+    _report.attMtu     = DEFAULT_ATT_MTU;
+    _report.dataLength = DEFAULT_DATA_LENGTH;
+
+    _ble.gattClient().onDataWritten(GattClient::WriteCallback_t(this, &BenchmarkClient::onDataWritten));
+    _ble.gattClient().onDataRead(GattClient::ReadCallback_t(this, &BenchmarkClient::onDataRead));
+    _ble.gattClient().onHVX(GattClient::HVXCallback_t(this, &BenchmarkClient::onHVX));
+    _ble.gattServer().onDataSent(this, &BenchmarkClient::onDataSent);
+    _ble.gap().onDisconnection(this, &BenchmarkClient::onDisconnection);
+    _ble.gap().onAttMtuChange(this, &BenchmarkClient::onAttMtuChange);
+    _ble.gap().onDataLengthChange(this, &BenchmarkClient::onDataLengthChange);
+    _ble.gap().onConnectionParamsUpdate(this, &BenchmarkClient::onConnectionParamsUpdate);
+    _timer.start();
+}
+
+BenchmarkClient::~BenchmarkClient()
+{
+    _watchdog.detach();
+    _ble.gattClient().onDataWritten().detach(
+        GattClient::WriteCallback_t(this, &BenchmarkClient::onDataWritten));
+    _ble.gattClient().onDataRead().detach(
+        GattClient::ReadCallback_t(this, &BenchmarkClient::onDataRead));
+    _ble.gattClient().onHVX().detach(
+        GattClient::HVXCallback_t(this, &BenchmarkClient::onHVX));
+    _ble.gattServer().onDataSent().detach(
+        GattServer::DataSentCallback_t(this, &BenchmarkClient::onDataSent));
+    _ble.gap().onDisconnection().detach(
+        Gap::DisconnectionEventCallback_t(this, &BenchmarkClient::onDisconnection));
+    _ble.gap().onAttMtuChange().detach(
+        Gap::AttMtuEventCallback_t(this, &BenchmarkClient::onAttMtuChange));
+    _ble.gap().onDataLengthChange().detach(
+        Gap::DataLengthEventCallback_t(this, &BenchmarkClient::onDataLengthChange));
+    _ble.gap().onConnectionParamsUpdate().detach(
+        Gap::ConnectionParamsUpdateEventCallback_t(this, &BenchmarkClient::onConnectionParamsUpdate));
+}
+
+ble_error_t BenchmarkClient::attach(const Gap::ConnectionCallbackParams_t *connection, AttachCallback_t callback)
+{
+    if (_state != STATE_IDLE) {
+        return BLE_ERROR_INVALID_STATE;
+    }
+
+    _ready                     = false;
+    _connectionHandle          = connection->handle;
+    _controlHandle             = 0;
+    _dataHandle                = 0;
+    _resultHandle              = 0;
+    _attachCallback            = callback;
+    _report.attMtu             = DEFAULT_ATT_MTU;
+    _report.dataLength         = DEFAULT_DATA_LENGTH;
+    _report.connectionInterval = connection->connectionParams->maxConnectionInterval;
+
+    _ble.gattClient().onServiceDiscoveryTermination(
+        ServiceDiscovery::TerminationCallback_t(this, &BenchmarkClient::onDiscoveryTermination));
+    ble_error_t err = _ble.gattClient().launchServiceDiscovery(
+        _connectionHandle,
+        NULL,
+        ServiceDiscovery::CharacteristicCallback_t(this, &BenchmarkClient::onCharacteristic),
+        UUID(BenchmarkServiceUUID));
+    if (err == BLE_ERROR_NONE) {
+        _state = STATE_DISCOVERING;
+    }
+    return err;
+}
+
+ble_error_t BenchmarkClient::runDownload(uint16_t payloadLength, uint32_t count)
+{
+    return start(TEST_DOWNLOAD, payloadLength, count);
+}
+
+ble_error_t BenchmarkClient::runUpload(uint16_t payloadLength, uint32_t count)
+{
+    return start(TEST_UPLOAD, payloadLength, count);
+}
+
+ble_error_t BenchmarkClient::runLatency(uint16_t payloadLength, uint16_t count)
+{
+    if (payloadLength < sizeof(uint32_t) || count > BLE_BENCHMARK_CLIENT_MAX_LATENCY_SAMPLES) {
+        return BLE_ERROR_PARAM_OUT_OF_RANGE;
+    }
+    return start(TEST_LATENCY, payloadLength, count);
+}
+
+ble_error_t BenchmarkClient::start(Test_t test, uint16_t payloadLength, uint32_t count)
+{
+    if (!_ready || _state != STATE_IDLE) {
+        return BLE_ERROR_INVALID_STATE;
+    }
+    if (payloadLength == 0 || payloadLength > BenchmarkService::MAX_PAYLOAD_LEN || count == 0) {
+        return BLE_ERROR_PARAM_OUT_OF_RANGE;
+    }
+
+    uint8_t  command[BenchmarkService::STREAM_COMMAND_LEN];
+    uint16_t commandLength = 1;
+    switch (test) {
+        case TEST_DOWNLOAD:
+            command[0] = BenchmarkService::COMMAND_STREAM;
+            command[1] = payloadLength;
+            command[2] = payloadLength >> 8;
+            setUint32(&command[3], count);
+            commandLength = BenchmarkService::STREAM_COMMAND_LEN;
+            break;
+        case TEST_UPLOAD:
+            command[0] = BenchmarkService::COMMAND_RESET;
+            break;
+        case TEST_LATENCY:
+        default:
+            command[0] = BenchmarkService::COMMAND_ECHO;
+            break;
+    }
+
+    ble_error_t err = writeRequest(_controlHandle, command, commandLength);
+    if (err != BLE_ERROR_NONE) {
+        return err;
+    }
+
+    _report.test            = test;
+    _report.status          = BLE_ERROR_NONE;
+    _report.payloadLength   = payloadLength;
+    _report.packets         = 0;
+    _report.bytes           = 0;
+    _report.elapsedUs       = 0;
+    _report.throughput      = 0;
+    _report.packetsPerEvent = 0;
+    _report.latencyMin      = 0;
+    _report.latencyP50      = 0;
+    _report.latencyP90      = 0;
+    _report.latencyP99      = 0;
+    _report.latencyMax      = 0;
+    _count                  = count;
+    _sent                   = 0;
+    _stopIssued             = false;
+    _state                  = STATE_STARTING;
+    armWatchdog();
+    return BLE_ERROR_NONE;
+}
+
+ble_error_t BenchmarkClient::writeRequest(GattAttribute::Handle_t handle, const uint8_t *value, uint16_t length)
+{
+    return _ble.gattClient().write(GattClient::GATT_OP_WRITE_REQ, _connectionHandle, handle, length, value);
+}
+
+void BenchmarkClient::sendPing(void)
+{
+    setUint32(_payload, _sent);
+    _sentUs = _timer.read_us();
+
+    ble_error_t err = _ble.gattClient().write(GattClient::GATT_OP_WRITE_CMD, _connectionHandle, _dataHandle,
+                                              _report.payloadLength, _payload);
+    if (isOutOfBuffers(err)) {
+        /* Resent by onDataSent() */
+        return;
+    }
+    if (err != BLE_ERROR_NONE) {
+        finish(err);
+        return;
+    }
+    _sent++;
+    armWatchdog();
+}
+
+void BenchmarkClient::pump(void)
+{
+    while (_sent < _count) {
+        setUint32(_payload, _sent);
+        ble_error_t err = _ble.gattClient().write(GattClient::GATT_OP_WRITE_CMD, _connectionHandle, _dataHandle,
+                                                  _report.payloadLength, _payload);
+        if (isOutOfBuffers(err)) {
+            /* Resumed by onDataSent() */
+            return;
+        }
+        if (err != BLE_ERROR_NONE) {
+            finish(err);
+            return;
+        }
+        _sent++;
+        armWatchdog();
+    }
+
+    /* Queued after the write commands, so acknowledged once they reached the server */
+    stop();
+}
+
+void BenchmarkClient::stop(void)
+{
+    _state = STATE_STOPPING;
+
+    uint8_t command = BenchmarkService::COMMAND_STOP;
+    ble_error_t err = writeRequest(_controlHandle, &command, sizeof(command));
+    if (isOutOfBuffers(err)) {
+        /* Retried by onDataSent() */
+        return;
+    }
+    if (err != BLE_ERROR_NONE) {
+        finish(err);
+        return;
+    }
+    _stopIssued = true;
+    armWatchdog();
+}
+
+void BenchmarkClient::finish(ble_error_t status)
+{
+    _watchdog.detach();
+    _state         = STATE_IDLE;
+    _report.status = status;
+
+    if (status == BLE_ERROR_NONE) {
+        /* Measured from the end of the first packet, which is not counted */
+        if (_report.packets > 1 && _report.elapsedUs) {
+            uint64_t bytes = _report.bytes - _report.payloadLength;
+            _report.throughput = (uint32_t)((bytes * 1000000) / _report.elapsedUs);
+        }
+        uint32_t eventUs = (uint32_t)_report.connectionInterval * Gap::UNIT_1_25_MS;
+        if (_report.packets > 1 && eventUs && _report.elapsedUs >= eventUs) {
+            uint32_t events = _report.elapsedUs / eventUs;
+            _report.packetsPerEvent = ((_report.packets - 1) * 100) / events;
+        }
+        if (_report.test == TEST_LATENCY) {
+            computeLatency();
+        }
+    }
+
+    if (_reportCallback) {
+        _reportCallback(&_report);
+    }
+}
+
+void BenchmarkClient::computeLatency(void)
+{
+    uint32_t count = _report.packets;
+    if (count == 0) {
+        return;
+    }
+
+    /* At most BLE_BENCHMARK_CLIENT_MAX_LATENCY_SAMPLES values */
+    for (uint32_t i = 1; i < count; i++) {
+        uint32_t sample = _samples[i];
+        uint32_t j      = i;
+        while (j > 0 && _samples[j - 1] > sample) {
+            _samples[j] = _samples[j - 1];
+            j--;
+        }
+        _samples[j] = sample;
+    }
+
+    _report.latencyMin = _samples[0];
+    _report.latencyP50 = _samples[((count - 1) * 50) / 100];
+    _report.latencyP90 = _samples[((count - 1) * 90) / 100];
+    _report.latencyP99 = _samples[((count - 1) * 99) / 100];
+    _report.latencyMax = _samples[count - 1];
+}
+
+void BenchmarkClient::armWatchdog(void)
+{
+    _watchdog.attach_us(this, &BenchmarkClient::onWatchdog, BLE_BENCHMARK_CLIENT_TIMEOUT_MS * 1000);
+}
+
+void BenchmarkClient::onCharacteristic(const DiscoveredCharacteristic *characteristic)
+{
+    if (characteristic->getConnectionHandle() != _connectionHandle) {
+        return;
+    }
+
+    const UUID &uuid = characteristic->getUUID();
+    if (uuid == UUID(BenchmarkServiceControlCharacteristicUUID)) {
+        _controlHandle = characteristic->getValueHandle();
+    } else if (uuid == UUID(BenchmarkServiceDataCharacteristicUUID)) {
+        _dataHandle = characteristic->getValueHandle();
+    } else if (uuid == UUID(BenchmarkServiceResultCharacteristicUUID)) {
+        _resultHandle = characteristic->getValueHandle();
+    }
+}
+
+void BenchmarkClient::onDiscoveryTermination(Gap::Handle_t connectionHandle)
+{
+    if (_state != STATE_DISCOVERING || connectionHandle != _connectionHandle) {
+        return;
+    }
+
+    ble_error_t err = BLE_ERROR_INVALID_STATE;
+    if (_controlHandle && _dataHandle && _resultHandle) {
+        /* The CCCD follows the value of the characteristic */
+        static const uint8_t enableNotifications[] = { BLE_HVX_NOTIFICATION, 0x00 };
+        err = writeRequest(_dataHandle + 1, enableNotifications, sizeof(enableNotifications));
+    }
+
+    if (err == BLE_ERROR_NONE) {
+        _state = STATE_ENABLING;
+    } else {
+        _state = STATE_IDLE;
+        if (_attachCallback) {
+            _attachCallback(err);
+        }
+    }
+}
+
+void BenchmarkClient::onDataWritten(const GattWriteCallbackParams *params)
+{
+    if (params->connHandle != _connectionHandle) {
+        return;
+    }
+
+    switch (_state) {
+        case STATE_ENABLING:
+            if (params->handle == _dataHandle + 1) {
+                _ready = true;
+                _state = STATE_IDLE;
+                if (_attachCallback) {
+                    _attachCallback(BLE_ERROR_NONE);
+                }
+            }
+            break;
+
+        case STATE_STARTING:
+            if (params->handle == _controlHandle) {
+                _state = STATE_RUNNING;
+                if (_report.test == TEST_UPLOAD) {
+                    pump();
+                } else if (_report.test == TEST_LATENCY) {
+                    sendPing();
+                }
+            }
+            break;
+
+        case STATE_STOPPING:
+            if (params->handle == _controlHandle) {
+                if (_report.test == TEST_UPLOAD) {
+                    /* The server publishes its counters on stop */
+                    ble_error_t err = _ble.gattClient().read(_connectionHandle, _resultHandle, 0);
+                    if (err != BLE_ERROR_NONE) {
+                        finish(err);
+                        return;
+                    }
+                    _state = STATE_READING_RESULT;
+                    armWatchdog();
+                } else {
+                    finish(BLE_ERROR_NONE);
+                }
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+void BenchmarkClient::onDataRead(const GattReadCallbackParams *params)
+{
+    if (_state != STATE_READING_RESULT || params->connHandle != _connectionHandle ||
+        params->handle != _resultHandle) {
+        return;
+    }
+
+    if (params->len < BenchmarkService::RESULT_LEN) {
+        finish(BLE_ERROR_INVALID_STATE);
+        return;
+    }
+    _report.bytes     = getUint32(&params->data[0]);
+    _report.packets   = getUint32(&params->data[4]);
+    _report.elapsedUs = getUint32(&params->data[8]);
+    finish(BLE_ERROR_NONE);
+}
+
+void BenchmarkClient::onHVX(const GattHVXCallbackParams *params)
+{
+    if (_state != STATE_RUNNING || params->connHandle != _connectionHandle ||
+        params->handle != _dataHandle) {
+        return;
+    }
+
+    uint32_t now = _timer.read_us();
+    if (_report.test == TEST_DOWNLOAD) {
+        if (_report.packets == 0) {
+            _firstUs = now;
+        }
+        _report.packets++;
+        _report.bytes    += params->len;
+        _report.elapsedUs = now - _firstUs;
+        armWatchdog();
+
+        if (_report.packets >= _count) {
+            stop();
+        }
+    } else if (_report.test == TEST_LATENCY) {
+        /* Only the echo of the outstanding packet completes a round trip */
+        if (_sent == _report.packets || params->len < sizeof(uint32_t) ||
+            getUint32(params->data) != _sent - 1) {
+            return;
+        }
+        _samples[_report.packets++] = now - _sentUs;
+        _report.bytes += params->len;
+
+        if (_report.packets >= _count) {
+            stop();
+        } else {
+            sendPing();
+        }
+    }
+}
+
+void BenchmarkClient::onDataSent(unsigned count)
+{
+    (void)count;
+
+    if (_state == STATE_RUNNING) {
+        if (_report.test == TEST_UPLOAD) {
+            pump();
+        } else if (_report.test == TEST_LATENCY && _sent == _report.packets) {
+            sendPing();
+        }
+    } else if (_state == STATE_STOPPING && !_stopIssued) {
+        stop();
+    }
+}
+
+void BenchmarkClient::onDisconnection(const Gap::DisconnectionCallbackParams_t *params)
+{
+    if (params->handle != _connectionHandle) {
+        return;
+    }
+
+    _ready = false;
+    switch (_state) {
+        case STATE_IDLE:
+            break;
+        case STATE_DISCOVERING:
+        case STATE_ENABLING:
+            _state = STATE_IDLE;
+            if (_attachCallback) {
+                _attachCallback(BLE_ERROR_INVALID_STATE);
+            }
+            break;
+        default:
+            finish(BLE_ERROR_INVALID_STATE);
+            break;
+    }
+}
+
+void BenchmarkClient::onAttMtuChange(const Gap::AttMtuCallbackParams_t *params)
+{
+    if (params->handle == _connectionHandle) {
+        _report.attMtu = params->attMtu;
+    }
+}
+
+void BenchmarkClient::onDataLengthChange(const Gap::DataLengthCallbackParams_t *params)
+{
+    if (params->handle == _connectionHandle) {
+        _report.dataLength = params->maxTxOctets;
+    }
+}
+
+void BenchmarkClient::onConnectionParamsUpdate(const Gap::ConnectionParamsUpdateCallbackParams_t *params)
+{
+    if (params->handle == _connectionHandle) {
+        _report.connectionInterval = params->connectionParams->maxConnectionInterval;
+    }
+}
+
+void BenchmarkClient::onWatchdog(void)
+{
+    if (_state == STATE_RUNNING || _state == STATE_STARTING) {
+        /* Best effort, stop the server streaming or echoing */
+        uint8_t command = BenchmarkService::COMMAND_STOP;
+        writeRequest(_controlHandle, &command, sizeof(command));
+    }
+    if (_state != STATE_IDLE) {
+        finish(BLE_STACK_BUSY);
+    }
+}
@@ -0,0 +1,29 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2006-2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ble/services/BenchmarkService.h"
+
+/* B3C1xxxx-5A3E-4F4B-9C39-7E2B8C6F1A00 */
+#define BENCHMARK_UUID(shortUUID) {                                 \
+    0xB3, 0xC1, (uint8_t)((shortUUID) >> 8), (uint8_t)((shortUUID) & 0xFF), \
+    0x5A, 0x3E, 0x4F, 0x4B, 0x9C, 0x39, 0x7E, 0x2B,              \
+    0x8C, 0x6F, 0x1A, 0x00,                                      \
+}
+
+const uint8_t BenchmarkServiceUUID[UUID::LENGTH_OF_LONG_UUID]                      = BENCHMARK_UUID(0x0001);
+const uint8_t BenchmarkServiceControlCharacteristicUUID[UUID::LENGTH_OF_LONG_UUID] = BENCHMARK_UUID(0x0002);
+const uint8_t BenchmarkServiceDataCharacteristicUUID[UUID::LENGTH_OF_LONG_UUID]    = BENCHMARK_UUID(0x0003);
+const uint8_t BenchmarkServiceResultCharacteristicUUID[UUID::LENGTH_OF_LONG_UUID]  = BENCHMARK_UUID(0x0004);
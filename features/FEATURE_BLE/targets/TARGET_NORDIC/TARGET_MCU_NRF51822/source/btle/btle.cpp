@@ -202,6 +202,18 @@ static void btle_handler(ble_evt_t *p_ble_evt)
             securityManager.processPasskeyDisplayEvent(p_ble_evt->evt.gap_evt.conn_handle, p_ble_evt->evt.gap_evt.params.passkey_display.passkey);
             break;
 
+        case BLE_GAP_EVT_CONN_PARAM_UPDATE: {
+            const ble_gap_conn_params_t *connParams = &p_ble_evt->evt.gap_evt.params.conn_param_update.conn_params;
+            Gap::ConnectionParams_t params = {
+                connParams->min_conn_interval,
+                connParams->max_conn_interval,
+                connParams->slave_latency,
+                connParams->conn_sup_timeout
+            };
+            gap.processConnectionParamsUpdateEvent(p_ble_evt->evt.gap_evt.conn_handle, &params);
+            break;
+        }
+
         case BLE_GAP_EVT_TIMEOUT:
             gap.processTimeoutEvent(static_cast<Gap::TimeoutSource_t>(p_ble_evt->evt.gap_evt.params.timeout.src));
             break;
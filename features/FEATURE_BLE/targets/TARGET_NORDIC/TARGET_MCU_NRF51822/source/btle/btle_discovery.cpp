@@ -73,6 +73,18 @@ void bleGattcEventHandler(const ble_evt_t *p_ble_evt)
             }
             break;
 
+        case BLE_GATTC_EVT_CHAR_VALS_READ_RSP: {
+                GattReadCallbackParams response = {
+                    .connHandle = p_ble_evt->evt.gattc_evt.conn_handle,
+                    .handle     = gattClient.readMultipleHandle(),
+                    .offset     = 0,
+                    .len        = p_ble_evt->evt.gattc_evt.params.char_vals_read_rsp.len,
+                    .data       = p_ble_evt->evt.gattc_evt.params.char_vals_read_rsp.values,
+                };
+                gattClient.processReadResponse(&response);
+            }
+            break;
+
         case BLE_GATTC_EVT_WRITE_RSP: {
                 GattWriteCallbackParams response = {
                     .connHandle = p_ble_evt->evt.gattc_evt.conn_handle,
@@ -86,6 +98,11 @@ void bleGattcEventHandler(const ble_evt_t *p_ble_evt)
             }
             break;
 
+        case BLE_EVT_TX_COMPLETE:
+            /* Resume pending write commands */
+            gattClient.processDataSentEvent(p_ble_evt->evt.common_evt.conn_handle);
+            break;
+
         case BLE_GATTC_EVT_HVX: {
                 GattHVXCallbackParams params;
                 params.connHandle = p_ble_evt->evt.gattc_evt.conn_handle;
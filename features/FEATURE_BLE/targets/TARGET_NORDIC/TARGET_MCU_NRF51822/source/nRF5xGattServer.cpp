@@ -26,6 +26,14 @@
 
 #include "nRF5xn.h"
 
+static UUID makeStaticUUID(UUID::ShortUUIDBytes_t shortUUID, const uint8_t *longUUID)
+{
+    if (longUUID == NULL) {
+        return UUID(shortUUID);
+    }
+    return UUID(longUUID);
+}
+
 /**************************************************************************/
 /*!
     @brief  Adds a new service to the GATT table on the peripheral
@@ -106,6 +114,7 @@ ble_error_t nRF5xGattServer::addService(GattService &service)
 
         /* Update the characteristic handle */
         p_characteristics[characteristicCount] = p_char;
+        p_staticCharacteristics[characteristicCount] = NULL;
         p_char->getValueAttribute().setHandle(nrfCharacteristicHandles[characteristicCount].value_handle);
         characteristicCount++;
 
@@ -144,6 +153,75 @@ ble_error_t nRF5xGattServer::addService(GattService &service)
     return BLE_ERROR_NONE;
 }
 
+/**************************************************************************/
+/*!
+    @brief  Adds the services of a static GATT database to the GATT table
+            on the peripheral
+
+    @returns    ble_error_t
+
+    @retval     BLE_ERROR_NONE
+                Everything executed properly
+*/
+/**************************************************************************/
+ble_error_t nRF5xGattServer::addStaticServices(const GattStaticService_t *services, uint8_t count)
+{
+    for (uint8_t i = 0; i < count; i++) {
+        const GattStaticService_t &service = services[i];
+
+        ble_uuid_t nordicUUID;
+        nordicUUID = custom_convert_to_nordic_uuid(makeStaticUUID(service.shortUUID, service.longUUID));
+
+        uint16_t serviceHandle;
+        ASSERT_TRUE( ERROR_NONE ==
+                sd_ble_gatts_service_add(BLE_GATTS_SRVC_TYPE_PRIMARY,
+                                         &nordicUUID,
+                                         &serviceHandle),
+                BLE_ERROR_PARAM_OUT_OF_RANGE );
+        if (service.handle != NULL) {
+            *service.handle = serviceHandle;
+        }
+
+        for (uint8_t j = 0; j < service.characteristicCount; j++) {
+            if (characteristicCount >= BLE_TOTAL_CHARACTERISTICS) {
+                return BLE_ERROR_NO_MEM;
+            }
+            const GattStaticCharacteristic_t &characteristic = service.characteristics[j];
+
+            nordicUUID = custom_convert_to_nordic_uuid(makeStaticUUID(characteristic.shortUUID, characteristic.longUUID));
+
+            /* The values are copied by the SoftDevice, the descriptions can stay in flash. */
+            const char *userDescription = characteristic.userDescription;
+            ASSERT_TRUE ( ERROR_NONE ==
+                     custom_add_in_characteristic(BLE_GATT_HANDLE_INVALID,
+                                                  &nordicUUID,
+                                                  characteristic.properties,
+                                                  characteristic.requiredSecurity,
+                                                  const_cast<uint8_t *>(characteristic.initialValue),
+                                                  characteristic.initialLength,
+                                                  characteristic.maxLength,
+                                                  characteristic.hasVariableLength,
+                                                  reinterpret_cast<const uint8_t *>(userDescription),
+                                                  (userDescription != NULL) ? strlen(userDescription) : 0,
+                                                  false,
+                                                  false,
+                                                  &nrfCharacteristicHandles[characteristicCount]),
+                     BLE_ERROR_PARAM_OUT_OF_RANGE );
+
+            p_characteristics[characteristicCount] = NULL;
+            p_staticCharacteristics[characteristicCount] = &characteristic;
+            if (characteristic.valueHandle != NULL) {
+                *characteristic.valueHandle = nrfCharacteristicHandles[characteristicCount].value_handle;
+            }
+            characteristicCount++;
+        }
+
+        serviceCount++;
+    }
+
+    return BLE_ERROR_NONE;
+}
+
 /**************************************************************************/
 /*!
     @brief  Reads the value of a characteristic, based on the service
@@ -229,13 +307,13 @@ ble_error_t nRF5xGattServer::write(Gap::Handle_t connectionHandle, GattAttribute
 
     int characteristicIndex = resolveValueHandleToCharIndex(attributeHandle);
     if ((characteristicIndex != -1) &&
-        (p_characteristics[characteristicIndex]->getProperties() & (GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_INDICATE | GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_NOTIFY))) {
+        (getCharacteristicProperties(characteristicIndex) & (GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_INDICATE | GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_NOTIFY))) {
         /* HVX update for the characteristic value */
         ble_gatts_hvx_params_t hvx_params;
 
         hvx_params.handle = attributeHandle;
         hvx_params.type   =
-            (p_characteristics[characteristicIndex]->getProperties() & GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_NOTIFY) ? BLE_GATT_HVX_NOTIFICATION : BLE_GATT_HVX_INDICATION;
+            (getCharacteristicProperties(characteristicIndex) & GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_NOTIFY) ? BLE_GATT_HVX_NOTIFICATION : BLE_GATT_HVX_INDICATION;
         hvx_params.offset = 0;
         hvx_params.p_data = const_cast<uint8_t *>(buffer);
         hvx_params.p_len  = &len;
@@ -245,6 +323,9 @@ ble_error_t nRF5xGattServer::write(Gap::Handle_t connectionHandle, GattAttribute
             connectionHandle = gap.getConnectionHandle();
         }
         error_t error = (error_t) sd_ble_gatts_hvx(connectionHandle, &hvx_params);
+        if (error == ERROR_NONE && hvx_params.type == BLE_GATT_HVX_NOTIFICATION) {
+            txBuffersPending++;
+        }
         if (error != ERROR_NONE) {
             switch (error) {
                 case ERROR_BLE_NO_TX_BUFFERS: /*  Notifications consume application buffers. The return value can be used for resending notifications. */
@@ -330,6 +411,33 @@ ble_error_t nRF5xGattServer::areUpdatesEnabled(Gap::Handle_t connectionHandle, c
     return BLE_ERROR_NONE;
 }
 
+/**************************************************************************/
+/*!
+    @brief  Get the number of notifications the SoftDevice can accept.
+
+    @note   The application buffers are shared by all connections, so the
+            same count is reported for every connection.
+
+    @returns    ble_error_t
+
+    @retval     BLE_ERROR_NONE
+                Everything executed properly
+*/
+/**************************************************************************/
+ble_error_t nRF5xGattServer::getTxCredits(Gap::Handle_t connectionHandle, uint16_t *creditsP)
+{
+    (void)connectionHandle;
+
+    if (txBufferCount == 0) {
+        ASSERT_INT( ERROR_NONE,
+                    sd_ble_tx_buffer_count_get(&txBufferCount),
+                    BLE_ERROR_INVALID_STATE );
+    }
+
+    *creditsP = (txBuffersPending < txBufferCount) ? (txBufferCount - txBuffersPending) : 0;
+    return BLE_ERROR_NONE;
+}
+
 /**************************************************************************/
 /*!
     @brief  Clear nRF5xGattServer's state.
@@ -349,10 +457,12 @@ ble_error_t nRF5xGattServer::reset(void)
 
     /* Clear derived class members */
     memset(p_characteristics,        0, sizeof(p_characteristics));
+    memset(p_staticCharacteristics,  0, sizeof(p_staticCharacteristics));
     memset(p_descriptors,            0, sizeof(p_descriptors));
     memset(nrfCharacteristicHandles, 0, sizeof(ble_gatts_char_handles_t));
     memset(nrfDescriptorHandles,     0, sizeof(nrfDescriptorHandles));
     descriptorCount = 0;
+    txBuffersPending = 0;
 
     return BLE_ERROR_NONE;
 }
@@ -376,19 +486,19 @@ void nRF5xGattServer::hwCallback(ble_evt_t *p_ble_evt)
                 handle_value = gattsEventP->params.write.handle;
                 int characteristicIndex = resolveCCCDHandleToCharIndex(handle_value);
                 if ((characteristicIndex != -1) &&
-                    (p_characteristics[characteristicIndex]->getProperties() &
+                    (getCharacteristicProperties(characteristicIndex) &
                         (GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_INDICATE | GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_NOTIFY))) {
 
                     uint16_t cccd_value = (gattsEventP->params.write.data[1] << 8) | gattsEventP->params.write.data[0]; /* Little Endian but M0 may be mis-aligned */
 
-                    if (((p_characteristics[characteristicIndex]->getProperties() & GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_INDICATE) && (cccd_value & BLE_GATT_HVX_INDICATION)) ||
-                        ((p_characteristics[characteristicIndex]->getProperties() & GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_NOTIFY) && (cccd_value & BLE_GATT_HVX_NOTIFICATION))) {
+                    if (((getCharacteristicProperties(characteristicIndex) & GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_INDICATE) && (cccd_value & BLE_GATT_HVX_INDICATION)) ||
+                        ((getCharacteristicProperties(characteristicIndex) & GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_NOTIFY) && (cccd_value & BLE_GATT_HVX_NOTIFICATION))) {
                         eventType = GattServerEvents::GATT_EVENT_UPDATES_ENABLED;
                     } else {
                         eventType = GattServerEvents::GATT_EVENT_UPDATES_DISABLED;
                     }
 
-                    handleEvent(eventType, p_characteristics[characteristicIndex]->getValueHandle());
+                    handleEvent(eventType, nrfCharacteristicHandles[characteristicIndex].value_handle);
                     return;
                 }
 
@@ -404,10 +514,18 @@ void nRF5xGattServer::hwCallback(ble_evt_t *p_ble_evt)
             break;
 
         case BLE_EVT_TX_COMPLETE: {
-            handleDataSentEvent(p_ble_evt->evt.common_evt.params.tx_complete.count);
+            /* The count also covers write commands sent by the GattClient */
+            uint8_t count = p_ble_evt->evt.common_evt.params.tx_complete.count;
+            txBuffersPending = (count < txBuffersPending) ? (txBuffersPending - count) : 0;
+            handleDataSentEvent(count);
             return;
         }
 
+        case BLE_GAP_EVT_DISCONNECTED:
+            /* Buffers still held for the link are released with it */
+            txBuffersPending = 0;
+            return;
+
         case BLE_GATTS_EVT_SYS_ATTR_MISSING:
             sd_ble_gatts_sys_attr_set(gattsEventP->conn_handle, NULL, 0, 0);
             return;
@@ -465,7 +583,7 @@ void nRF5xGattServer::hwCallback(ble_evt_t *p_ble_evt)
                 .type = BLE_GATTS_AUTHORIZE_TYPE_WRITE,
                 .params = {
                     .write = {
-                        .gatt_status = p_characteristics[characteristicIndex]->authorizeWrite(&cbParams)
+                        .gatt_status = (p_characteristics[characteristicIndex] ? p_characteristics[characteristicIndex]->authorizeWrite(&cbParams) : AUTH_CALLBACK_REPLY_SUCCESS)
                     }
                 }
             };
@@ -507,7 +625,7 @@ void nRF5xGattServer::hwCallback(ble_evt_t *p_ble_evt)
                 .type = BLE_GATTS_AUTHORIZE_TYPE_READ,
                 .params = {
                     .read = {
-                        .gatt_status = p_characteristics[characteristicIndex]->authorizeRead(&cbParams)
+                        .gatt_status = (p_characteristics[characteristicIndex] ? p_characteristics[characteristicIndex]->authorizeRead(&cbParams) : AUTH_CALLBACK_REPLY_SUCCESS)
                     }
                 }
             };
@@ -29,12 +29,14 @@ class nRF5xGattServer : public GattServer
 public:
     /* Functions that must be implemented from GattServer */
     virtual ble_error_t addService(GattService &);
+    virtual ble_error_t addStaticServices(const GattStaticService_t *services, uint8_t count);
     virtual ble_error_t read(GattAttribute::Handle_t attributeHandle, uint8_t buffer[], uint16_t *lengthP);
     virtual ble_error_t read(Gap::Handle_t connectionHandle, GattAttribute::Handle_t attributeHandle, uint8_t buffer[], uint16_t *lengthP);
     virtual ble_error_t write(GattAttribute::Handle_t, const uint8_t[], uint16_t, bool localOnly = false);
     virtual ble_error_t write(Gap::Handle_t connectionHandle, GattAttribute::Handle_t, const uint8_t[], uint16_t, bool localOnly = false);
     virtual ble_error_t areUpdatesEnabled(const GattCharacteristic &characteristic, bool *enabledP);
     virtual ble_error_t areUpdatesEnabled(Gap::Handle_t connectionHandle, const GattCharacteristic &characteristic, bool *enabledP);
+    virtual ble_error_t getTxCredits(Gap::Handle_t connectionHandle, uint16_t *creditsP);
     virtual ble_error_t reset(void);
 
     /* nRF51 Functions */
@@ -79,19 +81,35 @@ private:
         return -1;
     }
 
+    /**
+     * Get the properties of a characteristic, whether it was added from a
+     * GattCharacteristic or from a static database.
+     * @param  charIndex index of the characteristic.
+     * @return           bitfield of GattCharacteristic::Properties_t.
+     */
+    uint8_t getCharacteristicProperties(int charIndex) const {
+        if (p_characteristics[charIndex] != NULL) {
+            return p_characteristics[charIndex]->getProperties();
+        }
+        return p_staticCharacteristics[charIndex]->properties;
+    }
+
 private:
     GattCharacteristic       *p_characteristics[BLE_TOTAL_CHARACTERISTICS];
+    const GattStaticCharacteristic_t *p_staticCharacteristics[BLE_TOTAL_CHARACTERISTICS]; /* set when p_characteristics is NULL */
     ble_gatts_char_handles_t  nrfCharacteristicHandles[BLE_TOTAL_CHARACTERISTICS];
     GattAttribute            *p_descriptors[BLE_TOTAL_DESCRIPTORS];
     uint8_t                   descriptorCount;
     uint16_t                  nrfDescriptorHandles[BLE_TOTAL_DESCRIPTORS];
+    uint8_t                   txBufferCount;   /* application buffers of the SoftDevice, 0 until queried */
+    uint8_t                   txBuffersPending; /* notifications accepted but not yet reported by TX_COMPLETE */
 
     /*
      * Allow instantiation from nRF5xn when required.
      */
     friend class nRF5xn;
 
-    nRF5xGattServer() : GattServer(), p_characteristics(), nrfCharacteristicHandles(), p_descriptors(), descriptorCount(0), nrfDescriptorHandles() {
+    nRF5xGattServer() : GattServer(), p_characteristics(), p_staticCharacteristics(), nrfCharacteristicHandles(), p_descriptors(), descriptorCount(0), nrfDescriptorHandles(), txBufferCount(0), txBuffersPending(0) {
         /* empty */
     }
 
@@ -155,6 +155,9 @@ error_t btle_init(void)
     ble_enable_params.gatts_enable_params.attr_tab_size  = GATTS_ATTR_TAB_SIZE;
     ble_enable_params.gatts_enable_params.service_changed  = IS_SRVC_CHANGED_CHARACT_PRESENT;
     ble_enable_params.common_enable_params.vs_uuid_count = UUID_TABLE_MAX_ENTRIES;
+#if  (NRF_SD_BLE_API_VERSION >= 5)
+    ble_enable_params.gatt_enable_params.att_mtu = NRF_BLE_GATT_MAX_MTU_SIZE;
+#endif
 
     if(err_code  != NRF_SUCCESS) {
         return ERROR_INVALID_PARAM;
@@ -288,6 +291,18 @@ static void btle_handler(ble_evt_t *p_ble_evt)
             securityManager.processPasskeyDisplayEvent(p_ble_evt->evt.gap_evt.conn_handle, p_ble_evt->evt.gap_evt.params.passkey_display.passkey);
             break;
 
+        case BLE_GAP_EVT_CONN_PARAM_UPDATE: {
+            const ble_gap_conn_params_t *connParams = &p_ble_evt->evt.gap_evt.params.conn_param_update.conn_params;
+            Gap::ConnectionParams_t params = {
+                connParams->min_conn_interval,
+                connParams->max_conn_interval,
+                connParams->slave_latency,
+                connParams->conn_sup_timeout
+            };
+            gap.processConnectionParamsUpdateEvent(p_ble_evt->evt.gap_evt.conn_handle, &params);
+            break;
+        }
+
         case BLE_GAP_EVT_TIMEOUT:
             gap.processTimeoutEvent(static_cast<Gap::TimeoutSource_t>(p_ble_evt->evt.gap_evt.params.timeout.src));
             break;
@@ -299,6 +314,47 @@ static void btle_handler(ble_evt_t *p_ble_evt)
             // BLE_HCI_REMOTE_USER_TERMINATED_CONNECTION));
             break;
 
+#if  (NRF_SD_BLE_API_VERSION >= 5)
+        case BLE_GAP_EVT_PHY_UPDATE: {
+            const ble_gap_evt_phy_update_t *phyUpdate = &p_ble_evt->evt.gap_evt.params.phy_update;
+            gap.processPhyUpdateEvent(p_ble_evt->evt.gap_evt.conn_handle,
+                                      (phyUpdate->status == BLE_HCI_STATUS_CODE_SUCCESS) ? BLE_ERROR_NONE : BLE_ERROR_UNSPECIFIED,
+                                      phyUpdate->tx_phy,
+                                      phyUpdate->rx_phy);
+            break;
+        }
+
+        case BLE_EVT_DATA_LENGTH_CHANGED: {
+            const ble_evt_data_length_changed_t *dataLength = &p_ble_evt->evt.common_evt.params.data_length_changed;
+            Gap::DataLengthCallbackParams_t params = {
+                p_ble_evt->evt.common_evt.conn_handle,
+                dataLength->max_tx_octets,
+                dataLength->max_tx_time,
+                dataLength->max_rx_octets,
+                dataLength->max_rx_time
+            };
+            gap.processDataLengthChangeEvent(&params);
+            break;
+        }
+
+        case BLE_GATTS_EVT_EXCHANGE_MTU_REQUEST: {
+            /* The ATT_MTU is the smaller of the two RX MTUs */
+            uint16_t clientRxMtu = p_ble_evt->evt.gatts_evt.params.exchange_mtu_request.client_rx_mtu;
+            if (sd_ble_gatts_exchange_mtu_reply(p_ble_evt->evt.gatts_evt.conn_handle, NRF_BLE_GATT_MAX_MTU_SIZE) == NRF_SUCCESS) {
+                gap.processAttMtuChangeEvent(p_ble_evt->evt.gatts_evt.conn_handle,
+                                             MAX(BLE_GATT_MTU_SIZE_DEFAULT, MIN(clientRxMtu, NRF_BLE_GATT_MAX_MTU_SIZE)));
+            }
+            break;
+        }
+
+        case BLE_GATTC_EVT_EXCHANGE_MTU_RSP: {
+            uint16_t serverRxMtu = p_ble_evt->evt.gattc_evt.params.exchange_mtu_rsp.server_rx_mtu;
+            gap.processAttMtuChangeEvent(p_ble_evt->evt.gattc_evt.conn_handle,
+                                         MAX(BLE_GATT_MTU_SIZE_DEFAULT, MIN(serverRxMtu, NRF_BLE_GATT_MAX_MTU_SIZE)));
+            break;
+        }
+#endif
+
         case BLE_GAP_EVT_ADV_REPORT: {
             const ble_gap_evt_adv_report_t *advReport = &p_ble_evt->evt.gap_evt.params.adv_report;
             gap.processAdvertisementReport(advReport->peer_addr.addr,
@@ -26,6 +26,17 @@ extern "C" {
 #include "ble_srv_common.h"
 #include "headers/nrf_ble.h"
 
+#if (NRF_SD_BLE_API_VERSION >= 5)
+/**
+ * Largest ATT_MTU offered in MTU exchanges. The SoftDevice needs more RAM for
+ * larger values, so the start of the application RAM in the linker script has
+ * to be moved up when raising it.
+ */
+#ifndef NRF_BLE_GATT_MAX_MTU_SIZE
+#define NRF_BLE_GATT_MAX_MTU_SIZE BLE_GATT_MTU_SIZE_DEFAULT
+#endif
+#endif
+
 error_t     btle_init(void);
 
 // flag indicating if events have been signaled or not
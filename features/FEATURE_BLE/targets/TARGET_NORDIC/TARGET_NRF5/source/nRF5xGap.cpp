@@ -466,6 +466,44 @@ ble_error_t nRF5xGap::updateConnectionParams(Handle_t handle, const ConnectionPa
     }
 }
 
+#if  (NRF_SD_BLE_API_VERSION >= 5)
+ble_error_t nRF5xGap::setPhy(Handle_t handle, uint8_t txPhys, uint8_t rxPhys)
+{
+    /* Gap::Phy_t matches the SoftDevice's BLE_GAP_PHYS bits */
+    ble_gap_phys_t phys = {
+        .tx_phys = txPhys,
+        .rx_phys = rxPhys
+    };
+
+    switch (sd_ble_gap_phy_request(handle, &phys)) {
+        case NRF_SUCCESS:
+            return BLE_ERROR_NONE;
+        case NRF_ERROR_INVALID_PARAM:
+            return BLE_ERROR_INVALID_PARAM;
+        case NRF_ERROR_BUSY:
+            return BLE_STACK_BUSY;
+        case BLE_ERROR_INVALID_CONN_HANDLE:
+            return BLE_ERROR_PARAM_OUT_OF_RANGE;
+        default:
+            return BLE_ERROR_INVALID_STATE;
+    }
+}
+
+ble_error_t nRF5xGap::negotiateAttMtu(Handle_t handle)
+{
+    switch (sd_ble_gattc_exchange_mtu_request(handle, NRF_BLE_GATT_MAX_MTU_SIZE)) {
+        case NRF_SUCCESS:
+            return BLE_ERROR_NONE;
+        case NRF_ERROR_BUSY:
+            return BLE_STACK_BUSY;
+        case BLE_ERROR_INVALID_CONN_HANDLE:
+            return BLE_ERROR_PARAM_OUT_OF_RANGE;
+        default:
+            return BLE_ERROR_INVALID_STATE;
+    }
+}
+#endif
+
 /**************************************************************************/
 /*!
     @brief  Clear nRF5xGap's state.
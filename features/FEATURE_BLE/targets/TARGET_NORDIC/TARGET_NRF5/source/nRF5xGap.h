@@ -94,6 +94,10 @@ public:
     virtual ble_error_t getPreferredConnectionParams(ConnectionParams_t *params);
     virtual ble_error_t setPreferredConnectionParams(const ConnectionParams_t *params);
     virtual ble_error_t updateConnectionParams(Handle_t handle, const ConnectionParams_t *params);
+#if  (NRF_SD_BLE_API_VERSION >= 5)
+    virtual ble_error_t setPhy(Handle_t handle, uint8_t txPhys, uint8_t rxPhys);
+    virtual ble_error_t negotiateAttMtu(Handle_t handle);
+#endif
 
     virtual ble_error_t reset(void);
 
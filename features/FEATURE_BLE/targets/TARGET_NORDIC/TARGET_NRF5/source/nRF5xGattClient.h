@@ -168,6 +168,24 @@ public:
         }
     }
 
+    virtual ble_error_t readMultiple(Gap::Handle_t connHandle, const GattAttribute::Handle_t *handles, uint8_t count) const {
+        uint32_t rc = sd_ble_gattc_char_values_read(connHandle, handles, count);
+        if (rc == NRF_SUCCESS) {
+            /* The response does not carry any handle */
+            _readMultipleHandle = handles[0];
+            return BLE_ERROR_NONE;
+        }
+        switch (rc) {
+            case NRF_ERROR_BUSY:
+                return BLE_STACK_BUSY;
+            case BLE_ERROR_INVALID_CONN_HANDLE:
+            case NRF_ERROR_INVALID_STATE:
+            case NRF_ERROR_INVALID_ADDR:
+            default:
+                return BLE_ERROR_INVALID_STATE;
+        }
+    }
+
     /**
      * @brief  Clear nRF5xGattClient's state.
      *
@@ -192,7 +210,7 @@ public:
      */
     friend class nRF5xn;
 
-    nRF5xGattClient() : _discovery(this) {
+    nRF5xGattClient() : _discovery(this), _readMultipleHandle(GattAttribute::INVALID_HANDLE) {
         /* empty */
     }
 
@@ -204,6 +222,10 @@ public:
         return _characteristicDescriptorDiscoverer;
     }
 
+    GattAttribute::Handle_t readMultipleHandle() const {
+        return _readMultipleHandle;
+    }
+
 private:
     nRF5xGattClient(const nRF5xGattClient &);
     const nRF5xGattClient& operator=(const nRF5xGattClient &);
@@ -211,6 +233,7 @@ private:
 private:
     nRF5xServiceDiscovery _discovery;
     nRF5xCharacteristicDescriptorDiscoverer _characteristicDescriptorDiscoverer;
+    mutable GattAttribute::Handle_t _readMultipleHandle;
 
 #endif // if !S110
 };
@@ -28,6 +28,14 @@
 
 namespace {
 
+static UUID makeStaticUUID(UUID::ShortUUIDBytes_t shortUUID, const uint8_t *longUUID)
+{
+    if (longUUID == NULL) {
+        return UUID(shortUUID);
+    }
+    return UUID(longUUID);
+}
+
 static const ble_gatts_rw_authorize_reply_params_t write_auth_queue_full_reply = {
     .type = BLE_GATTS_AUTHORIZE_TYPE_WRITE,
     .params = {
@@ -147,6 +155,7 @@ ble_error_t nRF5xGattServer::addService(GattService &service)
 
         /* Update the characteristic handle */
         p_characteristics[characteristicCount] = p_char;
+        p_staticCharacteristics[characteristicCount] = NULL;
         p_char->getValueAttribute().setHandle(nrfCharacteristicHandles[characteristicCount].value_handle);
         characteristicCount++;
 
@@ -185,6 +194,75 @@ ble_error_t nRF5xGattServer::addService(GattService &service)
     return BLE_ERROR_NONE;
 }
 
+/**************************************************************************/
+/*!
+    @brief  Adds the services of a static GATT database to the GATT table
+            on the peripheral
+
+    @returns    ble_error_t
+
+    @retval     BLE_ERROR_NONE
+                Everything executed properly
+*/
+/**************************************************************************/
+ble_error_t nRF5xGattServer::addStaticServices(const GattStaticService_t *services, uint8_t count)
+{
+    for (uint8_t i = 0; i < count; i++) {
+        const GattStaticService_t &service = services[i];
+
+        ble_uuid_t nordicUUID;
+        nordicUUID = custom_convert_to_nordic_uuid(makeStaticUUID(service.shortUUID, service.longUUID));
+
+        uint16_t serviceHandle;
+        ASSERT_TRUE( ERROR_NONE ==
+                sd_ble_gatts_service_add(BLE_GATTS_SRVC_TYPE_PRIMARY,
+                                         &nordicUUID,
+                                         &serviceHandle),
+                BLE_ERROR_PARAM_OUT_OF_RANGE );
+        if (service.handle != NULL) {
+            *service.handle = serviceHandle;
+        }
+
+        for (uint8_t j = 0; j < service.characteristicCount; j++) {
+            if (characteristicCount >= BLE_TOTAL_CHARACTERISTICS) {
+                return BLE_ERROR_NO_MEM;
+            }
+            const GattStaticCharacteristic_t &characteristic = service.characteristics[j];
+
+            nordicUUID = custom_convert_to_nordic_uuid(makeStaticUUID(characteristic.shortUUID, characteristic.longUUID));
+
+            /* The values are copied by the SoftDevice, the descriptions can stay in flash. */
+            const char *userDescription = characteristic.userDescription;
+            ASSERT_TRUE ( ERROR_NONE ==
+                     custom_add_in_characteristic(BLE_GATT_HANDLE_INVALID,
+                                                  &nordicUUID,
+                                                  characteristic.properties,
+                                                  characteristic.requiredSecurity,
+                                                  const_cast<uint8_t *>(characteristic.initialValue),
+                                                  characteristic.initialLength,
+                                                  characteristic.maxLength,
+                                                  characteristic.hasVariableLength,
+                                                  reinterpret_cast<const uint8_t *>(userDescription),
+                                                  (userDescription != NULL) ? strlen(userDescription) : 0,
+                                                  false,
+                                                  false,
+                                                  &nrfCharacteristicHandles[characteristicCount]),
+                     BLE_ERROR_PARAM_OUT_OF_RANGE );
+
+            p_characteristics[characteristicCount] = NULL;
+            p_staticCharacteristics[characteristicCount] = &characteristic;
+            if (characteristic.valueHandle != NULL) {
+                *characteristic.valueHandle = nrfCharacteristicHandles[characteristicCount].value_handle;
+            }
+            characteristicCount++;
+        }
+
+        serviceCount++;
+    }
+
+    return BLE_ERROR_NONE;
+}
+
 /**************************************************************************/
 /*!
     @brief  Reads the value of a characteristic, based on the service
@@ -270,13 +348,13 @@ ble_error_t nRF5xGattServer::write(Gap::Handle_t connectionHandle, GattAttribute
 
     int characteristicIndex = resolveValueHandleToCharIndex(attributeHandle);
     if ((characteristicIndex != -1) &&
-        (p_characteristics[characteristicIndex]->getProperties() & (GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_INDICATE | GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_NOTIFY))) {
+        (getCharacteristicProperties(characteristicIndex) & (GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_INDICATE | GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_NOTIFY))) {
         /* HVX update for the characteristic value */
         ble_gatts_hvx_params_t hvx_params;
 
         hvx_params.handle = attributeHandle;
         hvx_params.type   =
-            (p_characteristics[characteristicIndex]->getProperties() & GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_NOTIFY) ? BLE_GATT_HVX_NOTIFICATION : BLE_GATT_HVX_INDICATION;
+            (getCharacteristicProperties(characteristicIndex) & GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_NOTIFY) ? BLE_GATT_HVX_NOTIFICATION : BLE_GATT_HVX_INDICATION;
         hvx_params.offset = 0;
         hvx_params.p_data = const_cast<uint8_t *>(buffer);
         hvx_params.p_len  = &len;
@@ -390,6 +468,7 @@ ble_error_t nRF5xGattServer::reset(void)
 
     /* Clear derived class members */
     memset(p_characteristics,        0, sizeof(p_characteristics));
+    memset(p_staticCharacteristics,  0, sizeof(p_staticCharacteristics));
     memset(p_descriptors,            0, sizeof(p_descriptors));
     memset(nrfCharacteristicHandles, 0, sizeof(ble_gatts_char_handles_t));
     memset(nrfDescriptorHandles,     0, sizeof(nrfDescriptorHandles));
@@ -419,19 +498,19 @@ void nRF5xGattServer::hwCallback(ble_evt_t *p_ble_evt)
                 handle_value = gattsEventP->params.write.handle;
                 int characteristicIndex = resolveCCCDHandleToCharIndex(handle_value);
                 if ((characteristicIndex != -1) &&
-                    (p_characteristics[characteristicIndex]->getProperties() &
+                    (getCharacteristicProperties(characteristicIndex) &
                         (GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_INDICATE | GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_NOTIFY))) {
 
                     uint16_t cccd_value = (gattsEventP->params.write.data[1] << 8) | gattsEventP->params.write.data[0]; /* Little Endian but M0 may be mis-aligned */
 
-                    if (((p_characteristics[characteristicIndex]->getProperties() & GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_INDICATE) && (cccd_value & BLE_GATT_HVX_INDICATION)) ||
-                        ((p_characteristics[characteristicIndex]->getProperties() & GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_NOTIFY) && (cccd_value & BLE_GATT_HVX_NOTIFICATION))) {
+                    if (((getCharacteristicProperties(characteristicIndex) & GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_INDICATE) && (cccd_value & BLE_GATT_HVX_INDICATION)) ||
+                        ((getCharacteristicProperties(characteristicIndex) & GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_NOTIFY) && (cccd_value & BLE_GATT_HVX_NOTIFICATION))) {
                         eventType = GattServerEvents::GATT_EVENT_UPDATES_ENABLED;
                     } else {
                         eventType = GattServerEvents::GATT_EVENT_UPDATES_DISABLED;
                     }
 
-                    handleEvent(eventType, p_characteristics[characteristicIndex]->getValueHandle());
+                    handleEvent(eventType, nrfCharacteristicHandles[characteristicIndex].value_handle);
                     return;
                 }
 
@@ -600,7 +679,7 @@ void nRF5xGattServer::hwCallback(ble_evt_t *p_ble_evt)
                                                                            * set to AUTH_CALLBACK_REPLY_SUCCESS if the client
                                                                            * request is to proceed. */
                     };
-                    uint16_t write_authorization = p_characteristics[characteristicIndex]->authorizeWrite(&cbParams);
+                    uint16_t write_authorization = (p_characteristics[characteristicIndex] ? p_characteristics[characteristicIndex]->authorizeWrite(&cbParams) : AUTH_CALLBACK_REPLY_SUCCESS);
 
                     // the user code didn't provide the write authorization,
                     // just leave here.
@@ -654,7 +733,7 @@ void nRF5xGattServer::hwCallback(ble_evt_t *p_ble_evt)
                 .type = BLE_GATTS_AUTHORIZE_TYPE_WRITE,
                 .params = {
                     .write = {
-                        .gatt_status = p_characteristics[characteristicIndex]->authorizeWrite(&cbParams),
+                        .gatt_status = (p_characteristics[characteristicIndex] ? p_characteristics[characteristicIndex]->authorizeWrite(&cbParams) : AUTH_CALLBACK_REPLY_SUCCESS),
                         .update = 1,
                         .offset = cbParams.offset,
                         .len = cbParams.len,
@@ -706,7 +785,7 @@ void nRF5xGattServer::hwCallback(ble_evt_t *p_ble_evt)
                 .type = BLE_GATTS_AUTHORIZE_TYPE_READ,
                 .params = {
                     .read = {
-                        .gatt_status = p_characteristics[characteristicIndex]->authorizeRead(&cbParams)
+                        .gatt_status = (p_characteristics[characteristicIndex] ? p_characteristics[characteristicIndex]->authorizeRead(&cbParams) : AUTH_CALLBACK_REPLY_SUCCESS)
                     }
                 }
             };
@@ -733,7 +812,8 @@ void nRF5xGattServer::hwCallback(ble_evt_t *p_ble_evt)
 uint16_t nRF5xGattServer::getBiggestCharacteristicSize() const {
     uint16_t result = 0;
     for (size_t i = 0; i < characteristicCount; ++i) {
-        uint16_t current_size = p_characteristics[i]->getValueAttribute().getMaxLength();
+        uint16_t current_size = p_characteristics[i] ?
+            p_characteristics[i]->getValueAttribute().getMaxLength() : p_staticCharacteristics[i]->maxLength;
         if (current_size > result) {
             result = current_size;
         }
@@ -29,6 +29,7 @@ class nRF5xGattServer : public GattServer
 public:
     /* Functions that must be implemented from GattServer */
     virtual ble_error_t addService(GattService &);
+    virtual ble_error_t addStaticServices(const GattStaticService_t *services, uint8_t count);
     virtual ble_error_t read(GattAttribute::Handle_t attributeHandle, uint8_t buffer[], uint16_t *lengthP);
     virtual ble_error_t read(Gap::Handle_t connectionHandle, GattAttribute::Handle_t attributeHandle, uint8_t buffer[], uint16_t *lengthP);
     virtual ble_error_t write(GattAttribute::Handle_t, const uint8_t[], uint16_t, bool localOnly = false);
@@ -102,6 +103,19 @@ private:
         return -1;
     }
 
+    /**
+     * Get the properties of a characteristic, whether it was added from a
+     * GattCharacteristic or from a static database.
+     * @param  charIndex index of the characteristic.
+     * @return           bitfield of GattCharacteristic::Properties_t.
+     */
+    uint8_t getCharacteristicProperties(int charIndex) const {
+        if (p_characteristics[charIndex] != NULL) {
+            return p_characteristics[charIndex]->getProperties();
+        }
+        return p_staticCharacteristics[charIndex]->properties;
+    }
+
     /**
      * Return the biggest size used by a characteristic in the server
      */
@@ -135,6 +149,7 @@ private:
 
 private:
     GattCharacteristic       *p_characteristics[BLE_TOTAL_CHARACTERISTICS];
+    const GattStaticCharacteristic_t *p_staticCharacteristics[BLE_TOTAL_CHARACTERISTICS]; /* set when p_characteristics is NULL */
     ble_gatts_char_handles_t  nrfCharacteristicHandles[BLE_TOTAL_CHARACTERISTICS];
     GattAttribute            *p_descriptors[BLE_TOTAL_DESCRIPTORS];
     uint8_t                   descriptorCount;
@@ -146,7 +161,7 @@ private:
      */
     friend class nRF5xn;
 
-    nRF5xGattServer() : GattServer(), p_characteristics(), nrfCharacteristicHandles(), p_descriptors(), descriptorCount(0), nrfDescriptorHandles(), long_write_requests() {
+    nRF5xGattServer() : GattServer(), p_characteristics(), p_staticCharacteristics(), nrfCharacteristicHandles(), p_descriptors(), descriptorCount(0), nrfDescriptorHandles(), long_write_requests() {
         /* empty */
     }
 
@@ -158,8 +158,10 @@ typedef enum sn_coap_status_ {
     COAP_STATUS_PARSER_BLOCKWISE_MSG_REJECTED  = 5, /**< Blockwise message received but not supported by compiling switch */
     COAP_STATUS_PARSER_BLOCKWISE_MSG_RECEIVED  = 6, /**< Blockwise message fully received and returned to app.
                                                          User must take care of releasing whole payload of the blockwise messages */
-    COAP_STATUS_BUILDER_MESSAGE_SENDING_FAILED = 7  /**< When re-transmissions have been done and ACK not received, CoAP library calls
+    COAP_STATUS_BUILDER_MESSAGE_SENDING_FAILED = 7, /**< When re-transmissions have been done and ACK not received, CoAP library calls
                                                          RX callback with this status */
+    COAP_STATUS_PARSER_BLOCKWISE_MSG_STREAMED  = 8  /**< Last block of a streamed blockwise message received, refer to
+                                                         sn_coap_protocol_set_block_stream(). The message has no payload to release */
 } sn_coap_status_e;
 
 
@@ -304,6 +306,37 @@ typedef struct sn_nsdl_addr_ {
  */
 extern sn_coap_hdr_s *sn_coap_parser(struct coap_s *handle, uint16_t packet_data_len, uint8_t *packet_data_ptr, coap_version_e *coap_version_ptr);
 
+/**
+ * \fn sn_coap_hdr_s *sn_coap_parser_in_place(uint16_t packet_data_len, uint8_t *packet_data_ptr, coap_version_e *coap_version_ptr, sn_coap_hdr_s *dst_coap_msg_ptr, sn_coap_options_list_s *dst_options_ptr)
+ *
+ * \brief Parses CoAP message from given Packet data into caller provided storage, without
+ *        allocating memory
+ *
+ *        The token, option values and payload of the parsed message point into the Packet data,
+ *        which must therefore outlive the message. Options made of several parts (Uri-Path,
+ *        Uri-Query, Location-Path, Location-Query and ETag) are joined in place, over their
+ *        option headers, so the Packet data is modified and cannot be parsed again.
+ *
+ *        The parsed message must not be released with sn_coap_parser_release_allocated_coap_msg_mem().
+ *
+ * \param packet_data_len is length of given Packet data to be parsed to CoAP message
+ *
+ * \param *packet_data_ptr is source for Packet data to be parsed to CoAP message
+ *
+ * \param *coap_version_ptr is destination for parsed CoAP specification version
+ *
+ * \param *dst_coap_msg_ptr is destination for parsed CoAP message
+ *
+ * \param *dst_options_ptr is storage for the options of the message. options_list_ptr of the
+ *        parsed message points to it only if the Packet data has options.
+ *
+ * \return Return value is dst_coap_msg_ptr, with coap_status set in case of parsing failure.\n
+ *         In following failure cases NULL is returned:\n
+ *          -Failure in given pointer (= NULL)
+ */
+extern sn_coap_hdr_s *sn_coap_parser_in_place(uint16_t packet_data_len, uint8_t *packet_data_ptr, coap_version_e *coap_version_ptr,
+                                              sn_coap_hdr_s *dst_coap_msg_ptr, sn_coap_options_list_s *dst_options_ptr);
+
 /**
  * \fn void sn_coap_parser_release_allocated_coap_msg_mem(struct coap_s *handle, sn_coap_hdr_s *freed_coap_msg_ptr)
  *
@@ -362,6 +395,27 @@ extern uint16_t sn_coap_builder_calc_needed_packet_data_size(sn_coap_hdr_s *src_
  */
 extern int16_t sn_coap_builder_2(uint8_t *dst_packet_data_ptr, sn_coap_hdr_s *src_coap_msg_ptr, uint16_t blockwise_payload_size);
 
+/**
+ * \fn int16_t sn_coap_builder_3(uint8_t *dst_packet_data_ptr, uint16_t dst_packet_data_size, sn_coap_hdr_s *src_coap_msg_ptr, uint16_t blockwise_payload_size)
+ *
+ * \brief Builds an outgoing message buffer from a CoAP header structure, straight into a buffer
+ *        of limited size such as a socket transmit buffer.
+ *
+ * \param *dst_packet_data_ptr is pointer to destination to built CoAP packet
+ *
+ * \param dst_packet_data_size is size of the destination
+ *
+ * \param *src_coap_msg_ptr is pointer to source structure for building Packet data
+ *
+ * \param blockwise_payload_size Blockwise message maximum payload size
+ *
+ * \return Return value is byte count of built Packet data. In failure cases:\n
+ *          -1 = Failure in given CoAP header structure\n
+ *          -2 = Failure in given pointer (= NULL)\n
+ *          -3 = Built Packet data does not fit the destination
+ */
+extern int16_t sn_coap_builder_3(uint8_t *dst_packet_data_ptr, uint16_t dst_packet_data_size, sn_coap_hdr_s *src_coap_msg_ptr, uint16_t blockwise_payload_size);
+
 /**
  * \fn uint16_t sn_coap_builder_calc_needed_packet_data_size_2(sn_coap_hdr_s *src_coap_msg_ptr, uint16_t blockwise_payload_size)
  *
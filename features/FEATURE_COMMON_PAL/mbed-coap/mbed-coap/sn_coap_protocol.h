@@ -114,6 +114,27 @@ extern int16_t sn_coap_protocol_build(struct coap_s *handle, sn_nsdl_addr_s *dst
  */
 extern sn_coap_hdr_s *sn_coap_protocol_parse(struct coap_s *handle, sn_nsdl_addr_s *src_addr_ptr, uint16_t packet_data_len, uint8_t *packet_data_ptr, void *);
 
+/**
+ * \fn sn_coap_hdr_s *sn_coap_protocol_parse_in_place(struct coap_s *handle, sn_nsdl_addr_s *src_addr_ptr, uint16_t packet_data_len, uint8_t *packet_data_ptr, void *param, sn_coap_hdr_s *dst_coap_msg_ptr, sn_coap_options_list_s *dst_options_ptr)
+ *
+ * \brief Same as sn_coap_protocol_parse(), but the message is parsed into caller provided
+ *        storage, with no memory allocated for it. Refer to sn_coap_parser_in_place().
+ *
+ *        The returned message references, and has modified, the Packet data. It must not be
+ *        released with sn_coap_parser_release_allocated_coap_msg_mem(). Blockwise messages
+ *        are returned with COAP_STATUS_PARSER_BLOCKWISE_MSG_REJECTED, as the library stores
+ *        them across packets.
+ *
+ * \param *dst_coap_msg_ptr is destination for parsed CoAP message
+ *
+ * \param *dst_options_ptr is storage for the options of the message
+ *
+ * \return Return value is dst_coap_msg_ptr, or NULL in the cases sn_coap_protocol_parse()
+ *         returns NULL.
+ */
+extern sn_coap_hdr_s *sn_coap_protocol_parse_in_place(struct coap_s *handle, sn_nsdl_addr_s *src_addr_ptr, uint16_t packet_data_len, uint8_t *packet_data_ptr, void *param,
+                                                      sn_coap_hdr_s *dst_coap_msg_ptr, sn_coap_options_list_s *dst_options_ptr);
+
 /**
  * \fn int8_t sn_coap_protocol_exec(struct coap_s *handle, uint32_t current_time)
  *
@@ -144,6 +165,37 @@ extern int8_t sn_coap_protocol_exec(struct coap_s *handle, uint32_t current_time
  */
 extern int8_t sn_coap_protocol_set_block_size(struct coap_s *handle, uint16_t block_size);
 
+/**
+ * \fn int8_t sn_coap_protocol_set_block_stream(struct coap_s *handle, int8_t (*block_callback_ptr)(sn_coap_hdr_s *, uint32_t, sn_nsdl_addr_s *, void *), uint8_t block2_window)
+ *
+ * \brief If block transfer is enabled, this function makes received blockwise messages streamed
+ *        instead of gathered in memory. Both Block1 requests and Block2 responses are streamed.
+ *
+ *        Each block is given to the callback as it arrives, with the offset of its payload in the
+ *        whole payload, e.g. to write it straight to storage. The callback returns 0 to continue
+ *        the transfer. Any other value aborts it: Block1 requests are answered with
+ *        COAP_MSG_CODE_RESPONSE_INTERNAL_SERVER_ERROR, and the message is returned to the user
+ *        with COAP_STATUS_PARSER_BLOCKWISE_MSG_REJECTED. Once all the blocks are received, the
+ *        message is returned with COAP_STATUS_PARSER_BLOCKWISE_MSG_STREAMED and no payload.
+ *
+ *        The size limit of SN_COAP_MAX_INCOMING_BLOCK_MESSAGE_SIZE does not apply, the callback
+ *        can check the Size1 option of the message instead.
+ *
+ * \param *handle Pointer to CoAP library handle
+ *
+ * \param *block_callback_ptr receives the blocks, with the message, the offset, the source
+ *        address and the param given to sn_coap_protocol_parse(). NULL disables streaming.
+ *
+ * \param block2_window Number of Block2 requests kept in flight once the size of the response
+ *        is known from its Size2 option, which is asked for. Blocks may then be received out of
+ *        order. Until the size is known, and with a window of 1, blocks are requested one at a time.
+ *
+ * \return  0 = success
+ *          -1 = failure
+ */
+extern int8_t sn_coap_protocol_set_block_stream(struct coap_s *handle,
+        int8_t (*block_callback_ptr)(sn_coap_hdr_s *, uint32_t, sn_nsdl_addr_s *, void *), uint8_t block2_window);
+
 /**
  * \fn int8_t sn_coap_protocol_set_duplicate_buffer_size(uint8_t message_count)
  *
@@ -83,6 +83,25 @@
  */
 #undef SN_COAP_MAX_INCOMING_MESSAGE_SIZE    /* UINT16_MAX */
 
+/**
+ * \def SN_COAP_MAX_ALLOWED_DUPLICATION_MESSAGE_COUNT
+ *
+ * \brief Sets the largest duplication buffer that
+ * sn_coap_protocol_set_duplicate_buffer_size() accepts.
+ * Default is 6, and at most 255.
+ */
+#undef SN_COAP_MAX_ALLOWED_DUPLICATION_MESSAGE_COUNT /* 6 */
+
+/**
+ * \def SN_COAP_LOOKUP_HASH_SIZE
+ *
+ * \brief Sets the number of hash buckets used to look up
+ * resending messages and duplication infos. Must be a
+ * power of two, each bucket takes two pointers per table.
+ * Default is 8.
+ */
+#undef SN_COAP_LOOKUP_HASH_SIZE             /* 8 */
+
 #ifdef MBED_CLIENT_USER_CONFIG_FILE
 #include MBED_CLIENT_USER_CONFIG_FILE
 #endif
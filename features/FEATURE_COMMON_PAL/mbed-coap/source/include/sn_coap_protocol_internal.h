@@ -92,11 +92,20 @@ struct sn_coap_hdr_;
 
 
 /* Maximum allowed number of saved messages for duplicate searching */
+#ifndef SN_COAP_MAX_ALLOWED_DUPLICATION_MESSAGE_COUNT
 #define SN_COAP_MAX_ALLOWED_DUPLICATION_MESSAGE_COUNT   6
+#endif
 
 /* Maximum time in seconds of messages to be stored for duplication detection */
 #define SN_COAP_DUPLICATION_MAX_TIME_MSGS_STORED    60 /* RESPONSE_TIMEOUT * RESPONSE_RANDOM_FACTOR * (2 ^ MAX_RETRANSMIT - 1) + the expected maximum round trip time */
 
+/* * For Message lookup * */
+
+/* Number of hash buckets indexing the resending messages and the duplication infos, must be 2^x */
+#ifndef SN_COAP_LOOKUP_HASH_SIZE
+#define SN_COAP_LOOKUP_HASH_SIZE                    8
+#endif
+
 /* * For Message blockwising * */
 
 /* Init value for the maximum payload size to be sent and received at one blockwise message                         */
@@ -144,6 +153,7 @@ int8_t prepare_blockwise_message(struct coap_s *handle, struct sn_coap_hdr_ *coa
 /* Structure which is stored to Linked list for message sending purposes */
 typedef struct coap_send_msg_ {
     uint8_t             resending_counter;  /* Tells how many times message is still tried to resend */
+    uint16_t            msg_id;             /* Message ID of the stored packet */
     uint32_t            resending_time;     /* Tells next resending time */
 
     sn_nsdl_transmit_s *send_msg_ptr;
@@ -151,10 +161,12 @@ typedef struct coap_send_msg_ {
     struct coap_s       *coap;              /* CoAP library handle */
     void                *param;             /* Extra parameter that will be passed to TX/RX callback functions */
 
-    ns_list_link_t      link;
+    ns_list_link_t      link;               /* Link in the list ordered by resending time */
+    ns_list_link_t      hash_link;          /* Link in the hash bucket of the message ID */
 } coap_send_msg_s;
 
 typedef NS_LIST_HEAD(coap_send_msg_s, link) coap_send_msg_list_t;
+typedef NS_LIST_HEAD(coap_send_msg_s, hash_link) coap_send_msg_hash_list_t;
 
 /* Structure which is stored to Linked list for message duplication detection purposes */
 typedef struct coap_duplication_info_ {
@@ -165,10 +177,12 @@ typedef struct coap_duplication_info_ {
     struct coap_s       *coap;  /* CoAP library handle */
     sn_nsdl_addr_s      *address;
     void                *param;
-    ns_list_link_t      link;
+    ns_list_link_t      link;       /* Link in the list ordered by timestamp */
+    ns_list_link_t      hash_link;  /* Link in the hash bucket of the address, port and message ID */
 } coap_duplication_info_s;
 
 typedef NS_LIST_HEAD(coap_duplication_info_s, link) coap_duplication_info_list_t;
+typedef NS_LIST_HEAD(coap_duplication_info_s, hash_link) coap_duplication_info_hash_list_t;
 
 /* Structure which is stored to Linked list for blockwise messages sending purposes */
 typedef struct coap_blockwise_msg_ {
@@ -200,6 +214,27 @@ typedef struct coap_blockwise_payload_ {
 
 typedef NS_LIST_HEAD(coap_blockwise_payload_s, link) coap_blockwise_payload_list_t;
 
+/* Structure which is stored to Linked list for streamed blockwise responses receiving purposes */
+typedef struct coap_blockwise_stream_ {
+    uint32_t            timestamp;      /* Tells when the last block was received */
+
+    uint8_t             addr_len;
+    uint8_t             *addr_ptr;
+    uint16_t            port;
+
+    sn_coap_hdr_s       *request_ptr;   /* Copy of the request, next blocks are requested with it */
+    uint32_t            next_block;     /* Number of the next block to request */
+    uint32_t            block_count;    /* Number of blocks of the response, 0 until known */
+    uint32_t            received_blocks;
+    uint8_t             pending_blocks; /* Blocks requested and not received yet */
+    uint8_t             block_szx;      /* Block size exponent given by the server */
+    struct coap_s       *coap;          /* CoAP library handle */
+
+    ns_list_link_t     link;
+} coap_blockwise_stream_s;
+
+typedef NS_LIST_HEAD(coap_blockwise_stream_s, link) coap_blockwise_stream_list_t;
+
 struct coap_s {
     void *(*sn_coap_protocol_malloc)(uint16_t);
     void (*sn_coap_protocol_free)(void *);
@@ -208,18 +243,23 @@ struct coap_s {
     int8_t (*sn_coap_rx_callback)(sn_coap_hdr_s *, sn_nsdl_addr_s *, void *);
 
     #if ENABLE_RESENDINGS /* If Message resending is not used at all, this part of code will not be compiled */
-        coap_send_msg_list_t linked_list_resent_msgs; /* Active resending messages are stored to this Linked list */
+        coap_send_msg_list_t linked_list_resent_msgs; /* Active resending messages are stored to this Linked list, next resending first */
+        coap_send_msg_hash_list_t hash_resent_msgs[SN_COAP_LOOKUP_HASH_SIZE]; /* Active resending messages indexed by Message ID */
         uint16_t count_resent_msgs;
     #endif
 
     #if SN_COAP_DUPLICATION_MAX_MSGS_COUNT /* If Message duplication detection is not used at all, this part of code will not be compiled */
-        coap_duplication_info_list_t  linked_list_duplication_msgs; /* Messages for duplicated messages detection is stored to this Linked list */
+        coap_duplication_info_list_t  linked_list_duplication_msgs; /* Messages for duplicated messages detection is stored to this Linked list, oldest first */
+        coap_duplication_info_hash_list_t hash_duplication_msgs[SN_COAP_LOOKUP_HASH_SIZE]; /* The same messages indexed by address, port and Message ID */
         uint16_t                      count_duplication_msgs;
     #endif
 
     #if SN_COAP_MAX_BLOCKWISE_PAYLOAD_SIZE /* If Message blockwise is not used at all, this part of code will not be compiled */
         coap_blockwise_msg_list_t     linked_list_blockwise_sent_msgs; /* Blockwise message to to be sent is stored to this Linked list */
         coap_blockwise_payload_list_t linked_list_blockwise_received_payloads; /* Blockwise payload to to be received is stored to this Linked list */
+        coap_blockwise_stream_list_t  linked_list_blockwise_streams; /* Streamed blockwise responses being received are stored to this Linked list */
+        int8_t (*sn_coap_block_callback)(sn_coap_hdr_s *, uint32_t, sn_nsdl_addr_s *, void *); /* Receives the blocks when streaming, or NULL */
+        uint8_t sn_coap_block2_window;
     #endif
 
     uint32_t system_time;    /* System time seconds */
@@ -99,6 +99,11 @@ int16_t sn_coap_builder(uint8_t *dst_packet_data_ptr, sn_coap_hdr_s *src_coap_ms
 }
 
 int16_t sn_coap_builder_2(uint8_t *dst_packet_data_ptr, sn_coap_hdr_s *src_coap_msg_ptr, uint16_t blockwise_payload_size)
+{
+    return sn_coap_builder_3(dst_packet_data_ptr, UINT16_MAX, src_coap_msg_ptr, blockwise_payload_size);
+}
+
+int16_t sn_coap_builder_3(uint8_t *dst_packet_data_ptr, uint16_t dst_packet_data_size, sn_coap_hdr_s *src_coap_msg_ptr, uint16_t blockwise_payload_size)
 {
     uint8_t *base_packet_data_ptr = NULL;
 
@@ -110,10 +115,15 @@ int16_t sn_coap_builder_2(uint8_t *dst_packet_data_ptr, sn_coap_hdr_s *src_coap_
     /* Initialize given Packet data memory area with zero values */
     uint16_t dst_byte_count_to_be_built = sn_coap_builder_calc_needed_packet_data_size_2(src_coap_msg_ptr, blockwise_payload_size);
     if (!dst_byte_count_to_be_built) {
-        tr_error("sn_coap_builder_2 - failed to allocate message!");
+        tr_error("sn_coap_builder_3 - failed to allocate message!");
         return -1;
     }
 
+    if (dst_byte_count_to_be_built > dst_packet_data_size) {
+        tr_error("sn_coap_builder_3 - destination too small!");
+        return -3;
+    }
+
     memset(dst_packet_data_ptr, 0, dst_byte_count_to_be_built);
 
     /* * * * Store base (= original) destination Packet data pointer for later usage * * * */
@@ -124,7 +134,7 @@ int16_t sn_coap_builder_2(uint8_t *dst_packet_data_ptr, sn_coap_hdr_s *src_coap_
     /* * * * * * * * * * * * * * * * * * */
     if (sn_coap_builder_header_build(&dst_packet_data_ptr, src_coap_msg_ptr) != 0) {
         /* Header building failed */
-        tr_error("sn_coap_builder_2 - header building failed!");
+        tr_error("sn_coap_builder_3 - header building failed!");
         return -1;
     }
 
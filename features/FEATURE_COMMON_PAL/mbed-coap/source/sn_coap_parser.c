@@ -43,8 +43,10 @@
 /* * * * * * * * * * * * * * * * * * * * */
 
 static void     sn_coap_parser_header_parse(uint8_t **packet_data_pptr, sn_coap_hdr_s *dst_coap_msg_ptr, coap_version_e *coap_version_ptr);
-static int8_t   sn_coap_parser_options_parse(struct coap_s *handle, uint8_t **packet_data_pptr, sn_coap_hdr_s *dst_coap_msg_ptr, uint8_t *packet_data_start_ptr, uint16_t packet_len);
-static int8_t   sn_coap_parser_options_parse_multiple_options(struct coap_s *handle, uint8_t **packet_data_pptr, uint16_t packet_left_len,  uint8_t **dst_pptr, uint16_t *dst_len_ptr, sn_coap_option_numbers_e option, uint16_t option_number_len);
+static int8_t   sn_coap_parser_options_parse(struct coap_s *handle, uint8_t **packet_data_pptr, sn_coap_hdr_s *dst_coap_msg_ptr, uint8_t *packet_data_start_ptr, uint16_t packet_len, sn_coap_options_list_s *in_place_options_ptr);
+static int8_t   sn_coap_parser_options_parse_multiple_options(struct coap_s *handle, uint8_t **packet_data_pptr, uint16_t packet_left_len,  uint8_t **dst_pptr, uint16_t *dst_len_ptr, sn_coap_option_numbers_e option, uint16_t option_number_len, bool in_place);
+static uint8_t *sn_coap_parser_options_store(struct coap_s *handle, uint8_t *option_ptr, uint16_t option_len, bool in_place);
+static void     sn_coap_parser_init_options(sn_coap_options_list_s *options_list_ptr);
 static int16_t  sn_coap_parser_options_count_needed_memory_multiple_option(uint8_t *packet_data_ptr, uint16_t packet_left_len, sn_coap_option_numbers_e option, uint16_t option_number_len);
 static int8_t   sn_coap_parser_payload_parse(uint16_t packet_data_len, uint8_t *packet_data_start_ptr, uint8_t **packet_data_pptr, sn_coap_hdr_s *dst_coap_msg_ptr);
 
@@ -99,19 +101,24 @@ sn_coap_options_list_s *sn_coap_parser_alloc_options(struct coap_s *handle, sn_c
         return NULL;
     }
 
-    /* XXX not technically legal to memset pointers to 0 */
-    memset(coap_msg_ptr->options_list_ptr, 0x00, sizeof(sn_coap_options_list_s));
-
-    coap_msg_ptr->options_list_ptr->max_age = COAP_OPTION_MAX_AGE_DEFAULT;
-    coap_msg_ptr->options_list_ptr->uri_port = COAP_OPTION_URI_PORT_NONE;
-    coap_msg_ptr->options_list_ptr->observe = COAP_OBSERVE_NONE;
-    coap_msg_ptr->options_list_ptr->accept = COAP_CT_NONE;
-    coap_msg_ptr->options_list_ptr->block2 = COAP_OPTION_BLOCK_NONE;
-    coap_msg_ptr->options_list_ptr->block1 = COAP_OPTION_BLOCK_NONE;
+    sn_coap_parser_init_options(coap_msg_ptr->options_list_ptr);
 
     return coap_msg_ptr->options_list_ptr;
 }
 
+static void sn_coap_parser_init_options(sn_coap_options_list_s *options_list_ptr)
+{
+    /* XXX not technically legal to memset pointers to 0 */
+    memset(options_list_ptr, 0x00, sizeof(sn_coap_options_list_s));
+
+    options_list_ptr->max_age = COAP_OPTION_MAX_AGE_DEFAULT;
+    options_list_ptr->uri_port = COAP_OPTION_URI_PORT_NONE;
+    options_list_ptr->observe = COAP_OBSERVE_NONE;
+    options_list_ptr->accept = COAP_CT_NONE;
+    options_list_ptr->block2 = COAP_OPTION_BLOCK_NONE;
+    options_list_ptr->block1 = COAP_OPTION_BLOCK_NONE;
+}
+
 sn_coap_hdr_s *sn_coap_parser(struct coap_s *handle, uint16_t packet_data_len, uint8_t *packet_data_ptr, coap_version_e *coap_version_ptr)
 {
     uint8_t       *data_temp_ptr                    = packet_data_ptr;
@@ -134,7 +141,7 @@ sn_coap_hdr_s *sn_coap_parser(struct coap_s *handle, uint16_t packet_data_len, u
     sn_coap_parser_header_parse(&data_temp_ptr, parsed_and_returned_coap_msg_ptr, coap_version_ptr);
 
     /* * * * Options parsing, move pointer over the options... * * * */
-    if (sn_coap_parser_options_parse(handle, &data_temp_ptr, parsed_and_returned_coap_msg_ptr, packet_data_ptr, packet_data_len) != 0) {
+    if (sn_coap_parser_options_parse(handle, &data_temp_ptr, parsed_and_returned_coap_msg_ptr, packet_data_ptr, packet_data_len, NULL) != 0) {
         parsed_and_returned_coap_msg_ptr->coap_status = COAP_STATUS_PARSER_ERROR_IN_HEADER;
         return parsed_and_returned_coap_msg_ptr;
     }
@@ -149,6 +156,38 @@ sn_coap_hdr_s *sn_coap_parser(struct coap_s *handle, uint16_t packet_data_len, u
     return parsed_and_returned_coap_msg_ptr;
 }
 
+sn_coap_hdr_s *sn_coap_parser_in_place(uint16_t packet_data_len, uint8_t *packet_data_ptr, coap_version_e *coap_version_ptr,
+                                       sn_coap_hdr_s *dst_coap_msg_ptr, sn_coap_options_list_s *dst_options_ptr)
+{
+    uint8_t *data_temp_ptr = packet_data_ptr;
+
+    /* * * * Check given pointer * * * */
+    if (packet_data_ptr == NULL || packet_data_len < 4 || dst_coap_msg_ptr == NULL || dst_options_ptr == NULL) {
+        return NULL;
+    }
+
+    /* * * * Initialize CoAP message, options are attached only if the packet has some * * * */
+    sn_coap_parser_init_message(dst_coap_msg_ptr);
+
+    /* * * * Header parsing, move pointer over the header...  * * * */
+    sn_coap_parser_header_parse(&data_temp_ptr, dst_coap_msg_ptr, coap_version_ptr);
+
+    /* * * * Options parsing, move pointer over the options... * * * */
+    if (sn_coap_parser_options_parse(NULL, &data_temp_ptr, dst_coap_msg_ptr, packet_data_ptr, packet_data_len, dst_options_ptr) != 0) {
+        dst_coap_msg_ptr->coap_status = COAP_STATUS_PARSER_ERROR_IN_HEADER;
+        return dst_coap_msg_ptr;
+    }
+
+    /* * * * Payload parsing * * * */
+    if (sn_coap_parser_payload_parse(packet_data_len, packet_data_ptr, &data_temp_ptr, dst_coap_msg_ptr) == -1) {
+        dst_coap_msg_ptr->coap_status = COAP_STATUS_PARSER_ERROR_IN_HEADER;
+        return dst_coap_msg_ptr;
+    }
+
+    /* * * * Return parsed CoAP message  * * * * */
+    return dst_coap_msg_ptr;
+}
+
 void sn_coap_parser_release_allocated_coap_msg_mem(struct coap_s *handle, sn_coap_hdr_s *freed_coap_msg_ptr)
 {
     if (handle == NULL) {
@@ -243,6 +282,30 @@ static uint32_t sn_coap_parser_options_parse_uint(uint8_t **packet_data_pptr, ui
     return value;
 }
 
+/**
+ * \brief Stores the value of a single option
+ *
+ * \param *option_ptr is the value in Packet data
+ * \param option_len is length of the value
+ * \param in_place tells whether the value is referenced in Packet data instead of copied
+ *
+ * \return Return value is pointer to the stored value, NULL if allocation failed
+ */
+static uint8_t *sn_coap_parser_options_store(struct coap_s *handle, uint8_t *option_ptr, uint16_t option_len, bool in_place)
+{
+    uint8_t *stored_ptr;
+
+    if (in_place) {
+        return option_ptr;
+    }
+
+    stored_ptr = handle->sn_coap_protocol_malloc(option_len);
+    if (stored_ptr) {
+        memcpy(stored_ptr, option_ptr, option_len);
+    }
+    return stored_ptr;
+}
+
 /**
  * \fn static uint8_t sn_coap_parser_options_parse(uint8_t **packet_data_pptr, sn_coap_hdr_s *dst_coap_msg_ptr)
  *
@@ -250,11 +313,14 @@ static uint32_t sn_coap_parser_options_parse_uint(uint8_t **packet_data_pptr, ui
  *
  * \param **packet_data_pptr is source of Packet data to be parsed to CoAP message
  * \param *dst_coap_msg_ptr is destination for parsed CoAP message
+ * \param *in_place_options_ptr is storage for the options when parsing in place, NULL to allocate
+ *        options and copy option values
  *
  * \return Return value is 0 in ok case and -1 in failure case
  */
-static int8_t sn_coap_parser_options_parse(struct coap_s *handle, uint8_t **packet_data_pptr, sn_coap_hdr_s *dst_coap_msg_ptr, uint8_t *packet_data_start_ptr, uint16_t packet_len)
+static int8_t sn_coap_parser_options_parse(struct coap_s *handle, uint8_t **packet_data_pptr, sn_coap_hdr_s *dst_coap_msg_ptr, uint8_t *packet_data_start_ptr, uint16_t packet_len, sn_coap_options_list_s *in_place_options_ptr)
 {
+    bool     in_place              = (in_place_options_ptr != NULL);
     uint8_t previous_option_number = 0;
     uint8_t i                      = 0;
     int8_t  ret_status             = 0;
@@ -269,14 +335,13 @@ static int8_t sn_coap_parser_options_parse(struct coap_s *handle, uint8_t **pack
             return -1;
         }
 
-        dst_coap_msg_ptr->token_ptr = handle->sn_coap_protocol_malloc(dst_coap_msg_ptr->token_len);
+        dst_coap_msg_ptr->token_ptr = sn_coap_parser_options_store(handle, *packet_data_pptr, dst_coap_msg_ptr->token_len, in_place);
 
         if (dst_coap_msg_ptr->token_ptr == NULL) {
             tr_error("sn_coap_parser_options_parse - failed to allocate token!");
             return -1;
         }
 
-        memcpy(dst_coap_msg_ptr->token_ptr, *packet_data_pptr, dst_coap_msg_ptr->token_len);
         (*packet_data_pptr) += dst_coap_msg_ptr->token_len;
     }
 
@@ -344,7 +409,12 @@ static int8_t sn_coap_parser_options_parse(struct coap_s *handle, uint8_t **pack
             case COAP_OPTION_ACCEPT:
             case COAP_OPTION_SIZE1:
             case COAP_OPTION_SIZE2:
-                if (sn_coap_parser_alloc_options(handle, dst_coap_msg_ptr) == NULL) {
+                if (in_place) {
+                    if (dst_coap_msg_ptr->options_list_ptr == NULL) {
+                        sn_coap_parser_init_options(in_place_options_ptr);
+                        dst_coap_msg_ptr->options_list_ptr = in_place_options_ptr;
+                    }
+                } else if (sn_coap_parser_alloc_options(handle, dst_coap_msg_ptr) == NULL) {
                     tr_error("sn_coap_parser_options_parse - failed to allocate options!");
                     return -1;
                 }
@@ -379,14 +449,13 @@ static int8_t sn_coap_parser_options_parse(struct coap_s *handle, uint8_t **pack
                 dst_coap_msg_ptr->options_list_ptr->proxy_uri_len = option_len;
                 (*packet_data_pptr)++;
 
-                dst_coap_msg_ptr->options_list_ptr->proxy_uri_ptr = handle->sn_coap_protocol_malloc(option_len);
+                dst_coap_msg_ptr->options_list_ptr->proxy_uri_ptr = sn_coap_parser_options_store(handle, *packet_data_pptr, option_len, in_place);
 
                 if (dst_coap_msg_ptr->options_list_ptr->proxy_uri_ptr == NULL) {
                     tr_error("sn_coap_parser_options_parse - COAP_OPTION_PROXY_URI allocation failed!");
                     return -1;
                 }
 
-                memcpy(dst_coap_msg_ptr->options_list_ptr->proxy_uri_ptr, *packet_data_pptr, option_len);
                 (*packet_data_pptr) += option_len;
 
                 break;
@@ -398,7 +467,7 @@ static int8_t sn_coap_parser_options_parse(struct coap_s *handle, uint8_t **pack
                              message_left,
                              &dst_coap_msg_ptr->options_list_ptr->etag_ptr,
                              (uint16_t *)&dst_coap_msg_ptr->options_list_ptr->etag_len,
-                             COAP_OPTION_ETAG, option_len);
+                             COAP_OPTION_ETAG, option_len, in_place);
                 if (ret_status >= 0) {
                     i += (ret_status - 1); /* i += is because possible several Options are handled by sn_coap_parser_options_parse_multiple_options() */
                 } else {
@@ -415,13 +484,12 @@ static int8_t sn_coap_parser_options_parse(struct coap_s *handle, uint8_t **pack
                 dst_coap_msg_ptr->options_list_ptr->uri_host_len = option_len;
                 (*packet_data_pptr)++;
 
-                dst_coap_msg_ptr->options_list_ptr->uri_host_ptr = handle->sn_coap_protocol_malloc(option_len);
+                dst_coap_msg_ptr->options_list_ptr->uri_host_ptr = sn_coap_parser_options_store(handle, *packet_data_pptr, option_len, in_place);
 
                 if (dst_coap_msg_ptr->options_list_ptr->uri_host_ptr == NULL) {
                     tr_error("sn_coap_parser_options_parse - COAP_OPTION_URI_HOST allocation failed!");
                     return -1;
                 }
-                memcpy(dst_coap_msg_ptr->options_list_ptr->uri_host_ptr, *packet_data_pptr, option_len);
                 (*packet_data_pptr) += option_len;
 
                 break;
@@ -434,7 +502,7 @@ static int8_t sn_coap_parser_options_parse(struct coap_s *handle, uint8_t **pack
                 /* This is managed independently because User gives this option in one character table */
                 ret_status = sn_coap_parser_options_parse_multiple_options(handle, packet_data_pptr, message_left,
                              &dst_coap_msg_ptr->options_list_ptr->location_path_ptr, &dst_coap_msg_ptr->options_list_ptr->location_path_len,
-                             COAP_OPTION_LOCATION_PATH, option_len);
+                             COAP_OPTION_LOCATION_PATH, option_len, in_place);
                 if (ret_status >= 0) {
                     i += (ret_status - 1); /* i += is because possible several Options are handled by sn_coap_parser_options_parse_multiple_options() */
                 } else {
@@ -458,7 +526,7 @@ static int8_t sn_coap_parser_options_parse(struct coap_s *handle, uint8_t **pack
             case COAP_OPTION_LOCATION_QUERY:
                 ret_status = sn_coap_parser_options_parse_multiple_options(handle, packet_data_pptr, message_left,
                              &dst_coap_msg_ptr->options_list_ptr->location_query_ptr, &dst_coap_msg_ptr->options_list_ptr->location_query_len,
-                             COAP_OPTION_LOCATION_QUERY, option_len);
+                             COAP_OPTION_LOCATION_QUERY, option_len, in_place);
                 if (ret_status >= 0) {
                     i += (ret_status - 1); /* i += is because possible several Options are handled by sn_coap_parser_options_parse_multiple_options() */
                 } else {
@@ -471,7 +539,7 @@ static int8_t sn_coap_parser_options_parse(struct coap_s *handle, uint8_t **pack
             case COAP_OPTION_URI_PATH:
                 ret_status = sn_coap_parser_options_parse_multiple_options(handle, packet_data_pptr, message_left,
                              &dst_coap_msg_ptr->uri_path_ptr, &dst_coap_msg_ptr->uri_path_len,
-                             COAP_OPTION_URI_PATH, option_len);
+                             COAP_OPTION_URI_PATH, option_len, in_place);
                 if (ret_status >= 0) {
                     i += (ret_status - 1); /* i += is because possible several Options are handled by sn_coap_parser_options_parse_multiple_options() */
                 } else {
@@ -496,7 +564,7 @@ static int8_t sn_coap_parser_options_parse(struct coap_s *handle, uint8_t **pack
             case COAP_OPTION_URI_QUERY:
                 ret_status = sn_coap_parser_options_parse_multiple_options(handle, packet_data_pptr, message_left,
                              &dst_coap_msg_ptr->options_list_ptr->uri_query_ptr, &dst_coap_msg_ptr->options_list_ptr->uri_query_len,
-                             COAP_OPTION_URI_QUERY, option_len);
+                             COAP_OPTION_URI_QUERY, option_len, in_place);
                 if (ret_status >= 0) {
                     i += (ret_status - 1); /* i += is because possible several Options are handled by sn_coap_parser_options_parse_multiple_options() */
                 } else {
@@ -591,9 +659,12 @@ static int8_t sn_coap_parser_options_parse(struct coap_s *handle, uint8_t **pack
  *
  * \param *previous_option_number_ptr is pointer to used and returned previous Option number
  *
+ * \param in_place tells whether the parts are joined in Packet data, over their option headers, instead of
+ *        in allocated memory. The joined value is never longer than the options it replaces.
+ *
  * \return Return value is count of Uri-query optios parsed. In failure case -1 is returned.
 */
-static int8_t sn_coap_parser_options_parse_multiple_options(struct coap_s *handle, uint8_t **packet_data_pptr, uint16_t packet_left_len,  uint8_t **dst_pptr, uint16_t *dst_len_ptr, sn_coap_option_numbers_e option, uint16_t option_number_len)
+static int8_t sn_coap_parser_options_parse_multiple_options(struct coap_s *handle, uint8_t **packet_data_pptr, uint16_t packet_left_len,  uint8_t **dst_pptr, uint16_t *dst_len_ptr, sn_coap_option_numbers_e option, uint16_t option_number_len, bool in_place)
 {
     int16_t     uri_query_needed_heap       = sn_coap_parser_options_count_needed_memory_multiple_option(*packet_data_pptr, packet_left_len, option, option_number_len);
     uint8_t    *temp_parsed_uri_query_ptr   = NULL;
@@ -603,7 +674,9 @@ static int8_t sn_coap_parser_options_parse_multiple_options(struct coap_s *handl
         return -1;
     }
 
-    if (uri_query_needed_heap) {
+    if (uri_query_needed_heap && in_place) {
+        *dst_pptr = *packet_data_pptr + 1;
+    } else if (uri_query_needed_heap) {
         *dst_pptr = (uint8_t *) handle->sn_coap_protocol_malloc(uri_query_needed_heap);
 
         if (*dst_pptr == NULL) {
@@ -639,7 +712,8 @@ static int8_t sn_coap_parser_options_parse_multiple_options(struct coap_s *handl
             return -1;
         }
 
-        memcpy(temp_parsed_uri_query_ptr, *packet_data_pptr, option_number_len);
+        /* In place, the destination never passes the part being moved */
+        memmove(temp_parsed_uri_query_ptr, *packet_data_pptr, option_number_len);
 
         (*packet_data_pptr) += option_number_len;
         temp_parsed_uri_query_ptr += option_number_len;
@@ -48,10 +48,14 @@
 /* * * * * * * * * * * * * * * * * * * * */
 
 static void                  sn_coap_protocol_send_rst(struct coap_s *handle, uint16_t msg_id, sn_nsdl_addr_s *addr_ptr, void *param);
+static sn_coap_hdr_s        *sn_coap_protocol_parse_message(struct coap_s *handle, sn_nsdl_addr_s *src_addr_ptr, uint16_t packet_data_len, uint8_t *packet_data_ptr, void *param,
+                                                            sn_coap_hdr_s *in_place_msg_ptr, sn_coap_options_list_s *in_place_options_ptr);
+static void                  sn_coap_protocol_release_parsed_msg(struct coap_s *handle, sn_coap_hdr_s *freed_coap_msg_ptr, sn_coap_hdr_s *in_place_msg_ptr);
 #if SN_COAP_DUPLICATION_MAX_MSGS_COUNT/* If Message duplication detection is not used at all, this part of code will not be compiled */
 static void                  sn_coap_protocol_linked_list_duplication_info_store(struct coap_s *handle, sn_nsdl_addr_s *src_addr_ptr, uint16_t msg_id, void *param);
 static coap_duplication_info_s *sn_coap_protocol_linked_list_duplication_info_search(struct coap_s *handle, sn_nsdl_addr_s *scr_addr_ptr, uint16_t msg_id);
-static void                  sn_coap_protocol_linked_list_duplication_info_remove(struct coap_s *handle, uint8_t *scr_addr_ptr, uint16_t port, uint16_t msg_id);
+static void                  sn_coap_protocol_linked_list_duplication_info_remove(struct coap_s *handle, coap_duplication_info_s *removed_duplication_info_ptr);
+static uint8_t               sn_coap_protocol_duplication_info_hash(const sn_nsdl_addr_s *addr_ptr, uint16_t msg_id);
 static void                  sn_coap_protocol_linked_list_duplication_info_remove_old_ones(struct coap_s *handle);
 #endif
 #if SN_COAP_MAX_BLOCKWISE_PAYLOAD_SIZE /* If Message blockwising is not used at all, this part of code will not be compiled */
@@ -63,14 +67,20 @@ static void                  sn_coap_protocol_linked_list_blockwise_payload_remo
 static void                  sn_coap_protocol_linked_list_blockwise_payload_remove_oldest(struct coap_s *handle);
 static uint32_t              sn_coap_protocol_linked_list_blockwise_payloads_get_len(struct coap_s *handle, sn_nsdl_addr_s *src_addr_ptr);
 static void                  sn_coap_protocol_linked_list_blockwise_remove_old_data(struct coap_s *handle);
+static coap_blockwise_stream_s *sn_coap_protocol_linked_list_blockwise_stream_store(struct coap_s *handle, sn_nsdl_addr_s *addr_ptr, sn_coap_hdr_s *request_ptr);
+static coap_blockwise_stream_s *sn_coap_protocol_linked_list_blockwise_stream_search(struct coap_s *handle, sn_nsdl_addr_s *src_addr_ptr, sn_coap_hdr_s *received_coap_msg_ptr);
+static void                  sn_coap_protocol_linked_list_blockwise_stream_remove(struct coap_s *handle, coap_blockwise_stream_s *removed_stream_ptr);
+static int8_t                sn_coap_protocol_blockwise_stream_request(struct coap_s *handle, coap_blockwise_stream_s *stream_ptr, sn_nsdl_addr_s *dst_addr_ptr, void *param);
+static sn_coap_hdr_s        *sn_coap_handle_blockwise_stream_response(struct coap_s *handle, sn_nsdl_addr_s *src_addr_ptr, sn_coap_hdr_s *received_coap_msg_ptr, void *param);
 static sn_coap_hdr_s        *sn_coap_handle_blockwise_message(struct coap_s *handle, sn_nsdl_addr_s *src_addr_ptr, sn_coap_hdr_s *received_coap_msg_ptr, void *param);
 static int8_t                sn_coap_convert_block_size(uint16_t block_size);
 static sn_coap_hdr_s        *sn_coap_protocol_copy_header(struct coap_s *handle, sn_coap_hdr_s *source_header_ptr);
 #endif
 #if ENABLE_RESENDINGS
 static uint8_t               sn_coap_protocol_linked_list_send_msg_store(struct coap_s *handle, sn_nsdl_addr_s *dst_addr_ptr, uint16_t send_packet_data_len, uint8_t *send_packet_data_ptr, uint32_t sending_time, void *param);
-static sn_nsdl_transmit_s   *sn_coap_protocol_linked_list_send_msg_search(struct coap_s *handle,sn_nsdl_addr_s *src_addr_ptr, uint16_t msg_id);
-static void                  sn_coap_protocol_linked_list_send_msg_remove(struct coap_s *handle, sn_nsdl_addr_s *src_addr_ptr, uint16_t msg_id);
+static coap_send_msg_s      *sn_coap_protocol_linked_list_send_msg_search(struct coap_s *handle,sn_nsdl_addr_s *src_addr_ptr, uint16_t msg_id);
+static void                  sn_coap_protocol_linked_list_send_msg_remove(struct coap_s *handle, coap_send_msg_s *removed_msg_ptr);
+static void                  sn_coap_protocol_linked_list_send_msg_insert(struct coap_s *handle, coap_send_msg_s *stored_msg_ptr);
 static coap_send_msg_s      *sn_coap_protocol_allocate_mem_for_msg(struct coap_s *handle, sn_nsdl_addr_s *dst_addr_ptr, uint16_t packet_data_len);
 static void                  sn_coap_protocol_release_allocated_send_msg_mem(struct coap_s *handle, coap_send_msg_s *freed_send_msg_ptr);
 static uint16_t              sn_coap_count_linked_list_size(const coap_send_msg_list_t *linked_list_ptr);
@@ -96,22 +106,7 @@ int8_t sn_coap_protocol_destroy(struct coap_s *handle)
 #if SN_COAP_DUPLICATION_MAX_MSGS_COUNT /* If Message duplication detection is not used at all, this part of code will not be compiled */
     ns_list_foreach_safe(coap_duplication_info_s, tmp, &handle->linked_list_duplication_msgs) {
         if (tmp->coap == handle) {
-            if (tmp->address) {
-                if (tmp->address->addr_ptr) {
-                    handle->sn_coap_protocol_free(tmp->address->addr_ptr);
-                    tmp->address->addr_ptr = 0;
-                }
-                handle->sn_coap_protocol_free(tmp->address);
-                tmp->address = 0;
-            }
-            if (tmp->packet_ptr) {
-                handle->sn_coap_protocol_free(tmp->packet_ptr);
-                tmp->packet_ptr = 0;
-            }
-            ns_list_remove(&handle->linked_list_duplication_msgs, tmp);
-            handle->count_duplication_msgs--;
-            handle->sn_coap_protocol_free(tmp);
-            tmp = 0;
+            sn_coap_protocol_linked_list_duplication_info_remove(handle, tmp);
         }
     }
 
@@ -148,6 +143,11 @@ int8_t sn_coap_protocol_destroy(struct coap_s *handle)
             tmp = 0;
         }
     }
+    ns_list_foreach_safe(coap_blockwise_stream_s, tmp, &handle->linked_list_blockwise_streams) {
+        if (tmp->coap == handle) {
+            sn_coap_protocol_linked_list_blockwise_stream_remove(handle, tmp);
+        }
+    }
 #endif
 
     handle->sn_coap_protocol_free(handle);
@@ -188,6 +188,9 @@ struct coap_s *sn_coap_protocol_init(void *(*used_malloc_func_ptr)(uint16_t), vo
 
     /* * * * Create Linked list for storing active resending messages  * * * */
     ns_list_init(&handle->linked_list_resent_msgs);
+    for (uint8_t i = 0; i < SN_COAP_LOOKUP_HASH_SIZE; i++) {
+        ns_list_init(&handle->hash_resent_msgs[i]);
+    }
     handle->sn_coap_resending_queue_msgs = SN_COAP_RESENDING_QUEUE_SIZE_MSGS;
     handle->sn_coap_resending_queue_bytes = SN_COAP_RESENDING_QUEUE_SIZE_BYTES;
     handle->sn_coap_resending_intervall = DEFAULT_RESPONSE_TIMEOUT;
@@ -199,6 +202,9 @@ struct coap_s *sn_coap_protocol_init(void *(*used_malloc_func_ptr)(uint16_t), vo
 #if SN_COAP_DUPLICATION_MAX_MSGS_COUNT /* If Message duplication detection is not used at all, this part of code will not be compiled */
     /* * * * Create Linked list for storing Duplication info * * * */
     ns_list_init(&handle->linked_list_duplication_msgs);
+    for (uint8_t i = 0; i < SN_COAP_LOOKUP_HASH_SIZE; i++) {
+        ns_list_init(&handle->hash_duplication_msgs[i]);
+    }
     handle->sn_coap_duplication_buffer_size = SN_COAP_DUPLICATION_MAX_MSGS_COUNT;
 #endif
 
@@ -206,7 +212,9 @@ struct coap_s *sn_coap_protocol_init(void *(*used_malloc_func_ptr)(uint16_t), vo
 
     ns_list_init(&handle->linked_list_blockwise_sent_msgs);
     ns_list_init(&handle->linked_list_blockwise_received_payloads);
+    ns_list_init(&handle->linked_list_blockwise_streams);
     handle->sn_coap_block_data_size = SN_COAP_MAX_BLOCKWISE_PAYLOAD_SIZE;
+    handle->sn_coap_block2_window = 1;
 
 #endif /* ENABLE_RESENDINGS */
 
@@ -247,6 +255,24 @@ int8_t sn_coap_protocol_set_block_size(struct coap_s *handle, uint16_t block_siz
 
 }
 
+int8_t sn_coap_protocol_set_block_stream(struct coap_s *handle,
+        int8_t (*block_callback_ptr)(sn_coap_hdr_s *, uint32_t, sn_nsdl_addr_s *, void *), uint8_t block2_window)
+{
+    (void) handle;
+    (void) block_callback_ptr;
+    (void) block2_window;
+#if SN_COAP_MAX_BLOCKWISE_PAYLOAD_SIZE
+    if (handle == NULL || block2_window == 0) {
+        return -1;
+    }
+    handle->sn_coap_block_callback = block_callback_ptr;
+    handle->sn_coap_block2_window = block2_window;
+    return 0;
+#else
+    return -1;
+#endif
+}
+
 int8_t sn_coap_protocol_set_duplicate_buffer_size(struct coap_s *handle, uint8_t message_count)
 {
     (void) handle;
@@ -311,9 +337,7 @@ void sn_coap_protocol_clear_retransmission_buffer(struct coap_s *handle)
         return;
     }
     ns_list_foreach_safe(coap_send_msg_s, tmp, &handle->linked_list_resent_msgs) {
-        ns_list_remove(&handle->linked_list_resent_msgs, tmp);
-        sn_coap_protocol_release_allocated_send_msg_mem(handle, tmp);
-        --handle->count_resent_msgs;
+        sn_coap_protocol_linked_list_send_msg_remove(handle, tmp);
     }
 #endif
 }
@@ -324,16 +348,10 @@ int8_t sn_coap_protocol_delete_retransmission(struct coap_s *handle, uint16_t ms
     if (handle == NULL) {
         return -1;
     }
-    ns_list_foreach_safe(coap_send_msg_s, tmp, &handle->linked_list_resent_msgs) {
-        if (tmp->send_msg_ptr && tmp->send_msg_ptr->packet_ptr ) {
-            uint16_t temp_msg_id = (tmp->send_msg_ptr->packet_ptr[2] << 8);
-            temp_msg_id += (uint16_t)tmp->send_msg_ptr->packet_ptr[3];
-            if(temp_msg_id == msg_id){
-                ns_list_remove(&handle->linked_list_resent_msgs, tmp);
-                --handle->count_resent_msgs;
-                sn_coap_protocol_release_allocated_send_msg_mem(handle, tmp);
-                return 0;
-            }
+    ns_list_foreach(coap_send_msg_s, tmp, &handle->hash_resent_msgs[msg_id & (SN_COAP_LOOKUP_HASH_SIZE - 1)]) {
+        if (tmp->msg_id == msg_id) {
+            sn_coap_protocol_linked_list_send_msg_remove(handle, tmp);
+            return 0;
         }
     }
 #endif
@@ -543,6 +561,29 @@ int16_t sn_coap_protocol_build(struct coap_s *handle, sn_nsdl_addr_s *dst_addr_p
 }
 
 sn_coap_hdr_s *sn_coap_protocol_parse(struct coap_s *handle, sn_nsdl_addr_s *src_addr_ptr, uint16_t packet_data_len, uint8_t *packet_data_ptr, void *param)
+{
+    return sn_coap_protocol_parse_message(handle, src_addr_ptr, packet_data_len, packet_data_ptr, param, NULL, NULL);
+}
+
+sn_coap_hdr_s *sn_coap_protocol_parse_in_place(struct coap_s *handle, sn_nsdl_addr_s *src_addr_ptr, uint16_t packet_data_len, uint8_t *packet_data_ptr, void *param,
+                                               sn_coap_hdr_s *dst_coap_msg_ptr, sn_coap_options_list_s *dst_options_ptr)
+{
+    if (dst_coap_msg_ptr == NULL || dst_options_ptr == NULL) {
+        return NULL;
+    }
+    return sn_coap_protocol_parse_message(handle, src_addr_ptr, packet_data_len, packet_data_ptr, param, dst_coap_msg_ptr, dst_options_ptr);
+}
+
+/* Messages parsed in place are in caller storage, they are never released */
+static void sn_coap_protocol_release_parsed_msg(struct coap_s *handle, sn_coap_hdr_s *freed_coap_msg_ptr, sn_coap_hdr_s *in_place_msg_ptr)
+{
+    if (in_place_msg_ptr == NULL) {
+        sn_coap_parser_release_allocated_coap_msg_mem(handle, freed_coap_msg_ptr);
+    }
+}
+
+static sn_coap_hdr_s *sn_coap_protocol_parse_message(struct coap_s *handle, sn_nsdl_addr_s *src_addr_ptr, uint16_t packet_data_len, uint8_t *packet_data_ptr, void *param,
+                                                     sn_coap_hdr_s *in_place_msg_ptr, sn_coap_options_list_s *in_place_options_ptr)
 {
     sn_coap_hdr_s   *returned_dst_coap_msg_ptr = NULL;
     coap_version_e   coap_version              = COAP_VERSION_UNKNOWN;
@@ -554,7 +595,12 @@ sn_coap_hdr_s *sn_coap_protocol_parse(struct coap_s *handle, sn_nsdl_addr_s *src
     }
 
     /* * * * Parse Packet data to CoAP message by using CoAP Header parser * * * */
-    returned_dst_coap_msg_ptr = sn_coap_parser(handle, packet_data_len, packet_data_ptr, &coap_version);
+    if (in_place_msg_ptr) {
+        returned_dst_coap_msg_ptr = sn_coap_parser_in_place(packet_data_len, packet_data_ptr, &coap_version,
+                                                            in_place_msg_ptr, in_place_options_ptr);
+    } else {
+        returned_dst_coap_msg_ptr = sn_coap_parser(handle, packet_data_len, packet_data_ptr, &coap_version);
+    }
 
     /* Check status of returned pointer */
     if (returned_dst_coap_msg_ptr == NULL) {
@@ -565,7 +611,7 @@ sn_coap_hdr_s *sn_coap_protocol_parse(struct coap_s *handle, sn_nsdl_addr_s *src
     /* * * * Send bad request response if parsing fails * * * */
     if (returned_dst_coap_msg_ptr->coap_status == COAP_STATUS_PARSER_ERROR_IN_HEADER) {
         sn_coap_protocol_send_rst(handle, returned_dst_coap_msg_ptr->msg_id, src_addr_ptr, param);
-        sn_coap_parser_release_allocated_coap_msg_mem(handle, returned_dst_coap_msg_ptr);
+        sn_coap_protocol_release_parsed_msg(handle, returned_dst_coap_msg_ptr, in_place_msg_ptr);
         tr_error("sn_coap_protocol_parse - COAP_STATUS_PARSER_ERROR_IN_HEADER");
         return NULL;
     }
@@ -581,7 +627,7 @@ sn_coap_hdr_s *sn_coap_protocol_parse(struct coap_s *handle, sn_nsdl_addr_s *src
         }
 
         /* Release memory of CoAP message */
-        sn_coap_parser_release_allocated_coap_msg_mem(handle, returned_dst_coap_msg_ptr);
+        sn_coap_protocol_release_parsed_msg(handle, returned_dst_coap_msg_ptr, in_place_msg_ptr);
 
         /* Return NULL because Header validity check failed */
         return NULL;
@@ -600,7 +646,7 @@ sn_coap_hdr_s *sn_coap_protocol_parse(struct coap_s *handle, sn_nsdl_addr_s *src
             sn_coap_protocol_send_rst(handle, returned_dst_coap_msg_ptr->msg_id, src_addr_ptr, param);
 
             /* Release memory of CoAP message */
-            sn_coap_parser_release_allocated_coap_msg_mem(handle, returned_dst_coap_msg_ptr);
+            sn_coap_protocol_release_parsed_msg(handle, returned_dst_coap_msg_ptr, in_place_msg_ptr);
 
             /* Return NULL because Header validity check failed */
             return NULL;
@@ -608,9 +654,10 @@ sn_coap_hdr_s *sn_coap_protocol_parse(struct coap_s *handle, sn_nsdl_addr_s *src
     }
 
 
-#if !SN_COAP_MAX_BLOCKWISE_PAYLOAD_SIZE /* If Message blockwising is used, this part of code will not be compiled */
-    /* If blockwising used in received message */
-    if (returned_dst_coap_msg_ptr->options_list_ptr != NULL &&
+    /* If blockwising used in received message, and not handled by the library. Blockwise */
+    /* messages are stored by the library, so messages parsed in place cannot be handled.  */
+    if ((!SN_COAP_MAX_BLOCKWISE_PAYLOAD_SIZE || in_place_msg_ptr != NULL) &&
+            returned_dst_coap_msg_ptr->options_list_ptr != NULL &&
             (returned_dst_coap_msg_ptr->options_list_ptr->block1 != COAP_OPTION_BLOCK_NONE ||
              returned_dst_coap_msg_ptr->options_list_ptr->block2 != COAP_OPTION_BLOCK_NONE)) {
         /* Set returned status to User */
@@ -619,7 +666,6 @@ sn_coap_hdr_s *sn_coap_protocol_parse(struct coap_s *handle, sn_nsdl_addr_s *src
         //todo: send response -> not implemented
         return returned_dst_coap_msg_ptr;
     }
-#endif /* !SN_COAP_MAX_BLOCKWISE_PAYLOAD_SIZE */
 
 #if SN_COAP_DUPLICATION_MAX_MSGS_COUNT/* If Message duplication is used, this part of code will not be compiled */
 
@@ -629,7 +675,10 @@ sn_coap_hdr_s *sn_coap_protocol_parse(struct coap_s *handle, sn_nsdl_addr_s *src
     if ((returned_dst_coap_msg_ptr->msg_type == COAP_MSG_TYPE_CONFIRMABLE ||
             returned_dst_coap_msg_ptr->msg_type == COAP_MSG_TYPE_NON_CONFIRMABLE) &&
             handle->sn_coap_duplication_buffer_size != 0) {
-        if (sn_coap_protocol_linked_list_duplication_info_search(handle, src_addr_ptr, returned_dst_coap_msg_ptr->msg_id) == NULL) {
+        coap_duplication_info_s* response = sn_coap_protocol_linked_list_duplication_info_search(handle,
+                                                                                                 src_addr_ptr,
+                                                                                                 returned_dst_coap_msg_ptr->msg_id);
+        if (response == NULL) {
             /* * * No Message duplication: Store received message for detecting later duplication * * */
 
             /* Get count of stored duplication messages */
@@ -637,14 +686,9 @@ sn_coap_hdr_s *sn_coap_protocol_parse(struct coap_s *handle, sn_nsdl_addr_s *src
 
             /* Check if there is no room to store message for duplication detection purposes */
             if (stored_duplication_msgs_count >= handle->sn_coap_duplication_buffer_size) {
-                /* Get oldest stored duplication message */
-                coap_duplication_info_s *stored_duplication_info_ptr = ns_list_get_first(&handle->linked_list_duplication_msgs);
-
                 /* Remove oldest stored duplication message for getting room for new duplication message */
                 sn_coap_protocol_linked_list_duplication_info_remove(handle,
-                                                                     stored_duplication_info_ptr->address->addr_ptr,
-                                                                     stored_duplication_info_ptr->address->port,
-                                                                     stored_duplication_info_ptr->msg_id);
+                                                                     ns_list_get_first(&handle->linked_list_duplication_msgs));
             }
 
             /* Store Duplication info to Linked list */
@@ -652,16 +696,10 @@ sn_coap_hdr_s *sn_coap_protocol_parse(struct coap_s *handle, sn_nsdl_addr_s *src
         } else { /* * * Message duplication detected * * */
             /* Set returned status to User */
             returned_dst_coap_msg_ptr->coap_status = COAP_STATUS_PARSER_DUPLICATED_MSG;
-            coap_duplication_info_s* response = sn_coap_protocol_linked_list_duplication_info_search(handle,
-                                                                                                     src_addr_ptr,
-                                                                                                     returned_dst_coap_msg_ptr->msg_id);
-            /* Send ACK response */
-            if (response) {
-                /* Check that response has been created */
-                if (response->packet_ptr) {
-                    response->coap->sn_coap_tx_callback(response->packet_ptr,
-                            response->packet_len, response->address, response->param);
-                }
+            /* Send ACK response, check that response has been created */
+            if (response->packet_ptr) {
+                response->coap->sn_coap_tx_callback(response->packet_ptr,
+                        response->packet_len, response->address, response->param);
             }
 
             return returned_dst_coap_msg_ptr;
@@ -735,14 +773,14 @@ sn_coap_hdr_s *sn_coap_protocol_parse(struct coap_s *handle, sn_nsdl_addr_s *src
 
         /* Check if there is ongoing active message resendings */
         if (stored_resending_msgs_count > 0) {
-            sn_nsdl_transmit_s *removed_msg_ptr = NULL;
+            coap_send_msg_s *removed_msg_ptr = NULL;
 
             /* Check if received message was confirmation for some active resending message */
             removed_msg_ptr = sn_coap_protocol_linked_list_send_msg_search(handle, src_addr_ptr, returned_dst_coap_msg_ptr->msg_id);
 
             if (removed_msg_ptr != NULL) {
                 /* Remove resending message from active message resending Linked list */
-                sn_coap_protocol_linked_list_send_msg_remove(handle, src_addr_ptr, returned_dst_coap_msg_ptr->msg_id);
+                sn_coap_protocol_linked_list_send_msg_remove(handle, removed_msg_ptr);
             }
         }
     }
@@ -773,59 +811,51 @@ int8_t sn_coap_protocol_exec(struct coap_s *handle, uint32_t current_time)
 #endif
 
 #if ENABLE_RESENDINGS
-    /* Check if there is ongoing active message sendings */
-    /* foreach_safe isn't sufficient because callback routine could cancel messages. */
-rescan:
-    ns_list_foreach(coap_send_msg_s, stored_msg_ptr, &handle->linked_list_resent_msgs) {
-        // First check that msg belongs to handle
-        if( stored_msg_ptr->coap == handle ){
-            /* Check if it is time to send this message */
-            if (current_time >= stored_msg_ptr->resending_time) {
-                /* * * Increase Resending counter  * * */
-                stored_msg_ptr->resending_counter++;
-
-                /* Check if all re-sendings have been done */
-                if (stored_msg_ptr->resending_counter > handle->sn_coap_resending_count) {
-                    coap_version_e coap_version = COAP_VERSION_UNKNOWN;
-
-                    /* Get message ID from stored sending message */
-                    uint16_t temp_msg_id = (stored_msg_ptr->send_msg_ptr->packet_ptr[2] << 8);
-                    temp_msg_id += (uint16_t)stored_msg_ptr->send_msg_ptr->packet_ptr[3];
-
-                    /* Remove message from Linked list */
-                    ns_list_remove(&handle->linked_list_resent_msgs, stored_msg_ptr);
-                    --handle->count_resent_msgs;
-
-                    /* If RX callback have been defined.. */
-                    if (stored_msg_ptr->coap->sn_coap_rx_callback != 0) {
-                        sn_coap_hdr_s *tmp_coap_hdr_ptr;
-                        /* Parse CoAP message, set status and call RX callback */
-                        tmp_coap_hdr_ptr = sn_coap_parser(stored_msg_ptr->coap, stored_msg_ptr->send_msg_ptr->packet_len, stored_msg_ptr->send_msg_ptr->packet_ptr, &coap_version);
-
-                        if (tmp_coap_hdr_ptr != 0) {
-                            tmp_coap_hdr_ptr->coap_status = COAP_STATUS_BUILDER_MESSAGE_SENDING_FAILED;
-                            stored_msg_ptr->coap->sn_coap_rx_callback(tmp_coap_hdr_ptr, stored_msg_ptr->send_msg_ptr->dst_addr_ptr, stored_msg_ptr->param);
-
-                            sn_coap_parser_release_allocated_coap_msg_mem(stored_msg_ptr->coap, tmp_coap_hdr_ptr);
-                        }
-                    }
-
-                    /* Free memory of stored message */
-                    sn_coap_protocol_release_allocated_send_msg_mem(handle, stored_msg_ptr);
-                } else {
-                    /* Send message  */
-                    stored_msg_ptr->coap->sn_coap_tx_callback(stored_msg_ptr->send_msg_ptr->packet_ptr,
-                            stored_msg_ptr->send_msg_ptr->packet_len, stored_msg_ptr->send_msg_ptr->dst_addr_ptr, stored_msg_ptr->param);
-
-                    /* * * Count new Resending time  * * */
-                    stored_msg_ptr->resending_time = sn_coap_calculate_new_resend_time(current_time,
-                                                                                       handle->sn_coap_resending_intervall,
-                                                                                       stored_msg_ptr->resending_counter);
+    /* Messages are ordered by resending time: only the ones that are due are visited */
+    /* The list is read again from the start after each message, as callback routines could cancel messages. */
+    coap_send_msg_s *stored_msg_ptr;
+    while ((stored_msg_ptr = ns_list_get_first(&handle->linked_list_resent_msgs)) != NULL &&
+            current_time >= stored_msg_ptr->resending_time) {
+        /* * * Increase Resending counter  * * */
+        stored_msg_ptr->resending_counter++;
+
+        /* Check if all re-sendings have been done */
+        if (stored_msg_ptr->resending_counter > handle->sn_coap_resending_count) {
+            coap_version_e coap_version = COAP_VERSION_UNKNOWN;
+
+            /* Remove message from Linked list */
+            ns_list_remove(&handle->linked_list_resent_msgs, stored_msg_ptr);
+            ns_list_remove(&handle->hash_resent_msgs[stored_msg_ptr->msg_id & (SN_COAP_LOOKUP_HASH_SIZE - 1)], stored_msg_ptr);
+            --handle->count_resent_msgs;
+
+            /* If RX callback have been defined.. */
+            if (stored_msg_ptr->coap->sn_coap_rx_callback != 0) {
+                sn_coap_hdr_s *tmp_coap_hdr_ptr;
+                /* Parse CoAP message, set status and call RX callback */
+                tmp_coap_hdr_ptr = sn_coap_parser(stored_msg_ptr->coap, stored_msg_ptr->send_msg_ptr->packet_len, stored_msg_ptr->send_msg_ptr->packet_ptr, &coap_version);
+
+                if (tmp_coap_hdr_ptr != 0) {
+                    tmp_coap_hdr_ptr->coap_status = COAP_STATUS_BUILDER_MESSAGE_SENDING_FAILED;
+                    stored_msg_ptr->coap->sn_coap_rx_callback(tmp_coap_hdr_ptr, stored_msg_ptr->send_msg_ptr->dst_addr_ptr, stored_msg_ptr->param);
+
+                    sn_coap_parser_release_allocated_coap_msg_mem(stored_msg_ptr->coap, tmp_coap_hdr_ptr);
                 }
-                /* Callback routine could have wiped the list (eg as a response to sending failed) */
-                /* Be super cautious and rescan from the start */
-                goto rescan;
             }
+
+            /* Free memory of stored message */
+            sn_coap_protocol_release_allocated_send_msg_mem(handle, stored_msg_ptr);
+        } else {
+            /* * * Count new Resending time and move the message to its place, before the callback can cancel it * * */
+            stored_msg_ptr->resending_time = sn_coap_calculate_new_resend_time(current_time,
+                                                                               handle->sn_coap_resending_intervall,
+                                                                               stored_msg_ptr->resending_counter);
+            ns_list_remove(&handle->linked_list_resent_msgs, stored_msg_ptr);
+            ns_list_remove(&handle->hash_resent_msgs[stored_msg_ptr->msg_id & (SN_COAP_LOOKUP_HASH_SIZE - 1)], stored_msg_ptr);
+            sn_coap_protocol_linked_list_send_msg_insert(handle, stored_msg_ptr);
+
+            /* Send message  */
+            stored_msg_ptr->coap->sn_coap_tx_callback(stored_msg_ptr->send_msg_ptr->packet_ptr,
+                    stored_msg_ptr->send_msg_ptr->packet_len, stored_msg_ptr->send_msg_ptr->dst_addr_ptr, stored_msg_ptr->param);
         }
     }
 
@@ -905,15 +935,42 @@ static uint8_t sn_coap_protocol_linked_list_send_msg_store(struct coap_s *handle
 
     stored_msg_ptr->coap = handle;
     stored_msg_ptr->param = param;
+    stored_msg_ptr->msg_id = (send_packet_data_ptr[2] << 8) | send_packet_data_ptr[3];
 
     /* Storing Resending message to Linked list */
-    ns_list_add_to_end(&handle->linked_list_resent_msgs, stored_msg_ptr);
+    sn_coap_protocol_linked_list_send_msg_insert(handle, stored_msg_ptr);
     ++handle->count_resent_msgs;
     return 1;
 }
 
 /**************************************************************************//**
- * \fn static sn_nsdl_transmit_s *sn_coap_protocol_linked_list_send_msg_search(sn_nsdl_addr_s *src_addr_ptr, uint16_t msg_id)
+ * \fn static void sn_coap_protocol_linked_list_send_msg_insert(struct coap_s *handle, coap_send_msg_s *stored_msg_ptr)
+ *
+ * \brief Links a resending message to the list ordered by resending time and
+ *        to the hash bucket of its Message ID. The count is not changed.
+ *
+ * \param *stored_msg_ptr is the message to be linked
+ *****************************************************************************/
+
+static void sn_coap_protocol_linked_list_send_msg_insert(struct coap_s *handle, coap_send_msg_s *stored_msg_ptr)
+{
+    /* Messages are mostly stored and rescheduled with the latest resending time, look from the end */
+    coap_send_msg_s *previous_msg_ptr = ns_list_get_last(&handle->linked_list_resent_msgs);
+    while (previous_msg_ptr && previous_msg_ptr->resending_time > stored_msg_ptr->resending_time) {
+        previous_msg_ptr = ns_list_get_previous(&handle->linked_list_resent_msgs, previous_msg_ptr);
+    }
+    if (previous_msg_ptr) {
+        ns_list_add_after(&handle->linked_list_resent_msgs, previous_msg_ptr, stored_msg_ptr);
+    } else {
+        ns_list_add_to_start(&handle->linked_list_resent_msgs, stored_msg_ptr);
+    }
+
+    /* Message IDs are allocated sequentially, so the low bits spread them evenly */
+    ns_list_add_to_end(&handle->hash_resent_msgs[stored_msg_ptr->msg_id & (SN_COAP_LOOKUP_HASH_SIZE - 1)], stored_msg_ptr);
+}
+
+/**************************************************************************//**
+ * \fn static coap_send_msg_s *sn_coap_protocol_linked_list_send_msg_search(struct coap_s *handle, sn_nsdl_addr_s *src_addr_ptr, uint16_t msg_id)
  *
  * \brief Searches stored resending message from Linked list
  *
@@ -925,23 +982,19 @@ static uint8_t sn_coap_protocol_linked_list_send_msg_store(struct coap_s *handle
  *         list or NULL if message not found
  *****************************************************************************/
 
-static sn_nsdl_transmit_s *sn_coap_protocol_linked_list_send_msg_search(struct coap_s *handle,
+static coap_send_msg_s *sn_coap_protocol_linked_list_send_msg_search(struct coap_s *handle,
         sn_nsdl_addr_s *src_addr_ptr, uint16_t msg_id)
 {
-    /* Loop all stored resending messages Linked list */
-    ns_list_foreach(coap_send_msg_s, stored_msg_ptr, &handle->linked_list_resent_msgs) {
-        /* Get message ID from stored resending message */
-        uint16_t temp_msg_id = (stored_msg_ptr->send_msg_ptr->packet_ptr[2] << 8);
-        temp_msg_id += (uint16_t)stored_msg_ptr->send_msg_ptr->packet_ptr[3];
-
+    /* Loop stored resending messages with the same hash */
+    ns_list_foreach(coap_send_msg_s, stored_msg_ptr, &handle->hash_resent_msgs[msg_id & (SN_COAP_LOOKUP_HASH_SIZE - 1)]) {
         /* If message's Message ID is same than is searched */
-        if (temp_msg_id == msg_id) {
+        if (stored_msg_ptr->msg_id == msg_id) {
             /* If message's Source address is same than is searched */
             if (0 == memcmp(src_addr_ptr->addr_ptr, stored_msg_ptr->send_msg_ptr->dst_addr_ptr->addr_ptr, src_addr_ptr->addr_len)) {
                 /* If message's Source address port is same than is searched */
                 if (stored_msg_ptr->send_msg_ptr->dst_addr_ptr->port == src_addr_ptr->port) {
                     /* * * Message found, return pointer to that stored resending message * * * */
-                    return stored_msg_ptr->send_msg_ptr;
+                    return stored_msg_ptr;
                 }
             }
         }
@@ -951,42 +1004,21 @@ static sn_nsdl_transmit_s *sn_coap_protocol_linked_list_send_msg_search(struct c
     return NULL;
 }
 /**************************************************************************//**
- * \fn static void sn_coap_protocol_linked_list_send_msg_remove(sn_nsdl_addr_s *src_addr_ptr, uint16_t msg_id)
+ * \fn static void sn_coap_protocol_linked_list_send_msg_remove(struct coap_s *handle, coap_send_msg_s *removed_msg_ptr)
  *
- * \brief Removes stored resending message from Linked list
+ * \brief Removes stored resending message from Linked list and frees it
  *
- * \param *src_addr_ptr is searching key for searched message
- * \param msg_id is searching key for removed message
+ * \param *removed_msg_ptr is the message to be removed
  *****************************************************************************/
 
-static void sn_coap_protocol_linked_list_send_msg_remove(struct coap_s *handle, sn_nsdl_addr_s *src_addr_ptr, uint16_t msg_id)
+static void sn_coap_protocol_linked_list_send_msg_remove(struct coap_s *handle, coap_send_msg_s *removed_msg_ptr)
 {
-    /* Loop all stored resending messages in Linked list */
-    ns_list_foreach(coap_send_msg_s, stored_msg_ptr, &handle->linked_list_resent_msgs) {
-        /* Get message ID from stored resending message */
-        uint16_t temp_msg_id = (stored_msg_ptr->send_msg_ptr->packet_ptr[2] << 8);
-        temp_msg_id += (uint16_t)stored_msg_ptr->send_msg_ptr->packet_ptr[3];
-
-        /* If message's Message ID is same than is searched */
-        if (temp_msg_id == msg_id) {
-            /* If message's Source address is same than is searched */
-            if (0 == memcmp(src_addr_ptr->addr_ptr, stored_msg_ptr->send_msg_ptr->dst_addr_ptr->addr_ptr, src_addr_ptr->addr_len)) {
-                /* If message's Source address port is same than is searched */
-                if (stored_msg_ptr->send_msg_ptr->dst_addr_ptr->port == src_addr_ptr->port) {
-                    /* * * Message found * * */
-
-                    /* Remove message from Linked list */
-                    ns_list_remove(&handle->linked_list_resent_msgs, stored_msg_ptr);
-                    --handle->count_resent_msgs;
+    ns_list_remove(&handle->linked_list_resent_msgs, removed_msg_ptr);
+    ns_list_remove(&handle->hash_resent_msgs[removed_msg_ptr->msg_id & (SN_COAP_LOOKUP_HASH_SIZE - 1)], removed_msg_ptr);
+    --handle->count_resent_msgs;
 
-                    /* Free memory of stored message */
-                    sn_coap_protocol_release_allocated_send_msg_mem(handle, stored_msg_ptr);
-
-                    return;
-                }
-            }
-        }
-    }
+    /* Free memory of stored message */
+    sn_coap_protocol_release_allocated_send_msg_mem(handle, removed_msg_ptr);
 }
 
 uint32_t sn_coap_calculate_new_resend_time(const uint32_t current_time, const uint8_t interval, const uint8_t counter)
@@ -1078,9 +1110,32 @@ static void sn_coap_protocol_linked_list_duplication_info_store(struct coap_s *h
     /* * * * Storing Duplication info to Linked list * * * */
 
     ns_list_add_to_end(&handle->linked_list_duplication_msgs, stored_duplication_info_ptr);
+    ns_list_add_to_end(&handle->hash_duplication_msgs[sn_coap_protocol_duplication_info_hash(addr_ptr, msg_id)],
+                       stored_duplication_info_ptr);
     ++handle->count_duplication_msgs;
 }
 
+/**************************************************************************//**
+ * \fn static uint8_t sn_coap_protocol_duplication_info_hash(const sn_nsdl_addr_s *addr_ptr, uint16_t msg_id)
+ *
+ * \brief Computes the hash bucket of a Duplication info
+ *
+ * \param *addr_ptr is pointer to Address key
+ * \param msg_id is Message ID key
+ *
+ * \return Index of the bucket in hash_duplication_msgs
+ *****************************************************************************/
+
+static uint8_t sn_coap_protocol_duplication_info_hash(const sn_nsdl_addr_s *addr_ptr, uint16_t msg_id)
+{
+    /* Peers choose their Message IDs independently, so the address and port are mixed in */
+    uint16_t hash = msg_id ^ addr_ptr->port;
+    for (uint8_t i = 0; i < addr_ptr->addr_len; i++) {
+        hash = ((hash << 5) | (hash >> 11)) ^ addr_ptr->addr_ptr[i];
+    }
+    return (hash ^ (hash >> 8)) & (SN_COAP_LOOKUP_HASH_SIZE - 1);
+}
+
 /**************************************************************************//**
  * \fn static int8_t sn_coap_protocol_linked_list_duplication_info_search(sn_nsdl_addr_s *addr_ptr, uint16_t msg_id)
  *
@@ -1095,8 +1150,9 @@ static void sn_coap_protocol_linked_list_duplication_info_store(struct coap_s *h
 static coap_duplication_info_s* sn_coap_protocol_linked_list_duplication_info_search(struct coap_s *handle,
         sn_nsdl_addr_s *addr_ptr, uint16_t msg_id)
 {
-    /* Loop all nodes in Linked list for searching Message ID */
-    ns_list_foreach(coap_duplication_info_s, stored_duplication_info_ptr, &handle->linked_list_duplication_msgs) {
+    /* Loop nodes with the same hash for searching Message ID */
+    ns_list_foreach(coap_duplication_info_s, stored_duplication_info_ptr,
+                    &handle->hash_duplication_msgs[sn_coap_protocol_duplication_info_hash(addr_ptr, msg_id)]) {
         /* If message's Message ID is same than is searched */
         if (stored_duplication_info_ptr->msg_id == msg_id) {
             /* If message's Source address is same than is searched */
@@ -1113,47 +1169,29 @@ static coap_duplication_info_s* sn_coap_protocol_linked_list_duplication_info_se
 }
 
 /**************************************************************************//**
- * \fn static void sn_coap_protocol_linked_list_duplication_info_remove(struct coap_s *handle, uint8_t *addr_ptr, uint16_t port, uint16_t msg_id)
- *
- * \brief Removes stored Duplication info from Linked list
+ * \fn static void sn_coap_protocol_linked_list_duplication_info_remove(struct coap_s *handle, coap_duplication_info_s *removed_duplication_info_ptr)
  *
- * \param *addr_ptr is pointer to Address key to be removed
+ * \brief Removes stored Duplication info from Linked list and frees it
  *
- * \param port is Port key to be removed
- *
- * \param msg_id is Message ID key to be removed
+ * \param *removed_duplication_info_ptr is the Duplication info to be removed
  *****************************************************************************/
 
-static void sn_coap_protocol_linked_list_duplication_info_remove(struct coap_s *handle, uint8_t *addr_ptr, uint16_t port, uint16_t msg_id)
+static void sn_coap_protocol_linked_list_duplication_info_remove(struct coap_s *handle, coap_duplication_info_s *removed_duplication_info_ptr)
 {
-    /* Loop all stored duplication messages in Linked list */
-    ns_list_foreach(coap_duplication_info_s, removed_duplication_info_ptr, &handle->linked_list_duplication_msgs) {
-        /* If message's Address is same than is searched */
-        if (handle == removed_duplication_info_ptr->coap && 0 == memcmp(addr_ptr,
-                                                                        removed_duplication_info_ptr->address->addr_ptr,
-                                                                        removed_duplication_info_ptr->address->addr_len)) {
-            /* If message's Address prt is same than is searched */
-            if (removed_duplication_info_ptr->address->port == port) {
-                /* If Message ID is same than is searched */
-                if (removed_duplication_info_ptr->msg_id == msg_id) {
-                    /* * * * Correct Duplication info found, remove it from Linked list * * * */
-                    ns_list_remove(&handle->linked_list_duplication_msgs, removed_duplication_info_ptr);
-                    --handle->count_duplication_msgs;
-
-                    /* Free memory of stored Duplication info */
-                    handle->sn_coap_protocol_free(removed_duplication_info_ptr->address->addr_ptr);
-                    removed_duplication_info_ptr->address->addr_ptr = 0;
-                    handle->sn_coap_protocol_free(removed_duplication_info_ptr->address);
-                    removed_duplication_info_ptr->address = 0;
-                    handle->sn_coap_protocol_free(removed_duplication_info_ptr->packet_ptr);
-                    removed_duplication_info_ptr->packet_ptr = 0;
-                    handle->sn_coap_protocol_free(removed_duplication_info_ptr);
-                    removed_duplication_info_ptr = 0;
-                    return;
-                }
-            }
-        }
-    }
+    ns_list_remove(&handle->linked_list_duplication_msgs, removed_duplication_info_ptr);
+    ns_list_remove(&handle->hash_duplication_msgs[sn_coap_protocol_duplication_info_hash(removed_duplication_info_ptr->address,
+                                                                                        removed_duplication_info_ptr->msg_id)],
+                   removed_duplication_info_ptr);
+    --handle->count_duplication_msgs;
+
+    /* Free memory of stored Duplication info */
+    handle->sn_coap_protocol_free(removed_duplication_info_ptr->address->addr_ptr);
+    removed_duplication_info_ptr->address->addr_ptr = 0;
+    handle->sn_coap_protocol_free(removed_duplication_info_ptr->address);
+    removed_duplication_info_ptr->address = 0;
+    handle->sn_coap_protocol_free(removed_duplication_info_ptr->packet_ptr);
+    removed_duplication_info_ptr->packet_ptr = 0;
+    handle->sn_coap_protocol_free(removed_duplication_info_ptr);
 }
 
 /**************************************************************************//**
@@ -1164,23 +1202,13 @@ static void sn_coap_protocol_linked_list_duplication_info_remove(struct coap_s *
 
 static void sn_coap_protocol_linked_list_duplication_info_remove_old_ones(struct coap_s *handle)
 {
-    /* Loop all stored duplication messages in Linked list */
+    /* Infos are stored in timestamp order: stop at the first one that is still recent */
     ns_list_foreach_safe(coap_duplication_info_s, removed_duplication_info_ptr, &handle->linked_list_duplication_msgs) {
-        if ((handle->system_time - removed_duplication_info_ptr->timestamp)  > SN_COAP_DUPLICATION_MAX_TIME_MSGS_STORED) {
-            /* * * * Old Duplication info found, remove it from Linked list * * * */
-            ns_list_remove(&handle->linked_list_duplication_msgs, removed_duplication_info_ptr);
-            --handle->count_duplication_msgs;
-
-            /* Free memory of stored Duplication info */
-            handle->sn_coap_protocol_free(removed_duplication_info_ptr->address->addr_ptr);
-            removed_duplication_info_ptr->address->addr_ptr = 0;
-            handle->sn_coap_protocol_free(removed_duplication_info_ptr->address);
-            removed_duplication_info_ptr->address = 0;
-            handle->sn_coap_protocol_free(removed_duplication_info_ptr->packet_ptr);
-            removed_duplication_info_ptr->packet_ptr = 0;
-            handle->sn_coap_protocol_free(removed_duplication_info_ptr);
-            removed_duplication_info_ptr = 0;
+        if ((handle->system_time - removed_duplication_info_ptr->timestamp) <= SN_COAP_DUPLICATION_MAX_TIME_MSGS_STORED) {
+            break;
         }
+        /* * * * Old Duplication info found, remove it from Linked list * * * */
+        sn_coap_protocol_linked_list_duplication_info_remove(handle, removed_duplication_info_ptr);
     }
 }
 
@@ -1445,6 +1473,255 @@ static void sn_coap_protocol_linked_list_blockwise_remove_old_data(struct coap_s
             sn_coap_protocol_linked_list_blockwise_payload_remove(handle, removed_blocwise_payload_ptr);
         }
     }
+
+    /* Loop all streamed Blockwise responses in Linked list */
+    ns_list_foreach_safe(coap_blockwise_stream_s, removed_stream_ptr, &handle->linked_list_blockwise_streams) {
+        if ((handle->system_time - removed_stream_ptr->timestamp)  > SN_COAP_BLOCKWISE_MAX_TIME_DATA_STORED) {
+            sn_coap_protocol_linked_list_blockwise_stream_remove(handle, removed_stream_ptr);
+        }
+    }
+}
+
+/**************************************************************************//**
+ * \fn static coap_blockwise_stream_s *sn_coap_protocol_linked_list_blockwise_stream_store(struct coap_s *handle, sn_nsdl_addr_s *addr_ptr, sn_coap_hdr_s *request_ptr)
+ *
+ * \brief Stores a streamed Blockwise response to Linked list
+ *
+ * \param *addr_ptr is pointer to Address of the server
+ *
+ * \param *request_ptr is the stored request, owned by the stream if it is stored
+ *
+ * \return Return value is the stored stream, or NULL if no memory
+ *****************************************************************************/
+
+static coap_blockwise_stream_s *sn_coap_protocol_linked_list_blockwise_stream_store(struct coap_s *handle, sn_nsdl_addr_s *addr_ptr,
+                                                                                    sn_coap_hdr_s *request_ptr)
+{
+    coap_blockwise_stream_s *stored_stream_ptr = handle->sn_coap_protocol_malloc(sizeof(coap_blockwise_stream_s));
+    if (stored_stream_ptr == NULL) {
+        tr_error("sn_coap_protocol_linked_list_blockwise_stream_store - failed to allocate stream!");
+        return NULL;
+    }
+    memset(stored_stream_ptr, 0, sizeof(coap_blockwise_stream_s));
+
+    stored_stream_ptr->addr_ptr = handle->sn_coap_protocol_malloc(addr_ptr->addr_len);
+    if (stored_stream_ptr->addr_ptr == NULL) {
+        tr_error("sn_coap_protocol_linked_list_blockwise_stream_store - failed to allocate address pointer!");
+        handle->sn_coap_protocol_free(stored_stream_ptr);
+        return NULL;
+    }
+    memcpy(stored_stream_ptr->addr_ptr, addr_ptr->addr_ptr, addr_ptr->addr_len);
+    stored_stream_ptr->addr_len = addr_ptr->addr_len;
+    stored_stream_ptr->port = addr_ptr->port;
+
+    stored_stream_ptr->timestamp = handle->system_time;
+    stored_stream_ptr->request_ptr = request_ptr;
+    stored_stream_ptr->coap = handle;
+
+    ns_list_add_to_end(&handle->linked_list_blockwise_streams, stored_stream_ptr);
+    return stored_stream_ptr;
+}
+
+/**************************************************************************//**
+ * \fn static coap_blockwise_stream_s *sn_coap_protocol_linked_list_blockwise_stream_search(struct coap_s *handle, sn_nsdl_addr_s *src_addr_ptr, sn_coap_hdr_s *received_coap_msg_ptr)
+ *
+ * \brief Searches the streamed Blockwise response a received block belongs to (Address and Token as key)
+ *
+ * \return Return value is the found stream, or NULL if not found
+ *****************************************************************************/
+
+static coap_blockwise_stream_s *sn_coap_protocol_linked_list_blockwise_stream_search(struct coap_s *handle, sn_nsdl_addr_s *src_addr_ptr,
+                                                                                     sn_coap_hdr_s *received_coap_msg_ptr)
+{
+    ns_list_foreach(coap_blockwise_stream_s, stream_ptr, &handle->linked_list_blockwise_streams) {
+        sn_coap_hdr_s *request_ptr = stream_ptr->request_ptr;
+
+        if (stream_ptr->port == src_addr_ptr->port &&
+                stream_ptr->addr_len == src_addr_ptr->addr_len &&
+                0 == memcmp(stream_ptr->addr_ptr, src_addr_ptr->addr_ptr, src_addr_ptr->addr_len) &&
+                request_ptr->token_len == received_coap_msg_ptr->token_len &&
+                (request_ptr->token_len == 0 ||
+                 0 == memcmp(request_ptr->token_ptr, received_coap_msg_ptr->token_ptr, request_ptr->token_len))) {
+            return stream_ptr;
+        }
+    }
+
+    return NULL;
+}
+
+/**************************************************************************//**
+ * \fn static void sn_coap_protocol_linked_list_blockwise_stream_remove(struct coap_s *handle, coap_blockwise_stream_s *removed_stream_ptr)
+ *
+ * \brief Removes a streamed Blockwise response from Linked list, with its request
+ *****************************************************************************/
+
+static void sn_coap_protocol_linked_list_blockwise_stream_remove(struct coap_s *handle, coap_blockwise_stream_s *removed_stream_ptr)
+{
+    ns_list_remove(&handle->linked_list_blockwise_streams, removed_stream_ptr);
+
+    if (removed_stream_ptr->request_ptr) {
+        if (removed_stream_ptr->request_ptr->payload_ptr) {
+            handle->sn_coap_protocol_free(removed_stream_ptr->request_ptr->payload_ptr);
+            removed_stream_ptr->request_ptr->payload_ptr = 0;
+        }
+        sn_coap_parser_release_allocated_coap_msg_mem(handle, removed_stream_ptr->request_ptr);
+        removed_stream_ptr->request_ptr = 0;
+    }
+    handle->sn_coap_protocol_free(removed_stream_ptr->addr_ptr);
+    removed_stream_ptr->addr_ptr = 0;
+
+    handle->sn_coap_protocol_free(removed_stream_ptr);
+}
+
+/**************************************************************************//**
+ * \fn static int8_t sn_coap_protocol_blockwise_stream_request(struct coap_s *handle, coap_blockwise_stream_s *stream_ptr, sn_nsdl_addr_s *dst_addr_ptr, void *param)
+ *
+ * \brief Sends the request for the next block of a streamed Blockwise response
+ *
+ * \return 0 if the request was sent, -1 if no memory
+ *****************************************************************************/
+
+static int8_t sn_coap_protocol_blockwise_stream_request(struct coap_s *handle, coap_blockwise_stream_s *stream_ptr,
+                                                        sn_nsdl_addr_s *dst_addr_ptr, void *param)
+{
+    sn_coap_hdr_s *request_ptr = stream_ptr->request_ptr;
+    uint16_t dst_packed_data_needed_mem;
+    uint8_t *dst_packet_data_ptr;
+
+    if (request_ptr->options_list_ptr == NULL && sn_coap_parser_alloc_options(handle, request_ptr) == NULL) {
+        tr_error("sn_coap_protocol_blockwise_stream_request - failed to allocate options!");
+        return -1;
+    }
+
+    request_ptr->options_list_ptr->block1 = COAP_OPTION_BLOCK_NONE;
+    request_ptr->options_list_ptr->block2 = (stream_ptr->next_block << 4) | stream_ptr->block_szx;
+
+    /* Ask for the size of the response until it is known, it opens the window (RFC 7959, 4) */
+    request_ptr->options_list_ptr->use_size2 = (stream_ptr->block_count == 0);
+    request_ptr->options_list_ptr->size2 = 0;
+
+    request_ptr->msg_id = message_id++;
+    if (message_id == 0) {
+        message_id = 1;
+    }
+
+    dst_packed_data_needed_mem = sn_coap_builder_calc_needed_packet_data_size_2(request_ptr, handle->sn_coap_block_data_size);
+    dst_packet_data_ptr = handle->sn_coap_protocol_malloc(dst_packed_data_needed_mem);
+    if (dst_packet_data_ptr == NULL) {
+        tr_error("sn_coap_protocol_blockwise_stream_request - failed to allocate packet!");
+        return -1;
+    }
+
+    if (sn_coap_builder_2(dst_packet_data_ptr, request_ptr, handle->sn_coap_block_data_size) < 0) {
+        tr_error("sn_coap_protocol_blockwise_stream_request - builder failed!");
+        handle->sn_coap_protocol_free(dst_packet_data_ptr);
+        return -1;
+    }
+
+    handle->sn_coap_tx_callback(dst_packet_data_ptr, dst_packed_data_needed_mem, dst_addr_ptr, param);
+
+#if ENABLE_RESENDINGS
+    if (request_ptr->msg_type == COAP_MSG_TYPE_CONFIRMABLE) {
+        uint32_t resend_time = sn_coap_calculate_new_resend_time(handle->system_time, handle->sn_coap_resending_intervall, 0);
+        sn_coap_protocol_linked_list_send_msg_store(handle, dst_addr_ptr,
+                dst_packed_data_needed_mem,
+                dst_packet_data_ptr,
+                resend_time, param);
+    }
+#endif
+    handle->sn_coap_protocol_free(dst_packet_data_ptr);
+
+    stream_ptr->next_block++;
+    stream_ptr->pending_blocks++;
+    return 0;
+}
+
+/**************************************************************************//**
+ * \fn static sn_coap_hdr_s *sn_coap_handle_blockwise_stream_response(struct coap_s *handle, sn_nsdl_addr_s *src_addr_ptr, sn_coap_hdr_s *received_coap_msg_ptr, void *param)
+ *
+ * \brief Gives a received block of a Blockwise response to the user, and requests the next ones
+ *
+ * \return Return value is the received message with its updated status, or NULL if failed
+ *****************************************************************************/
+
+static sn_coap_hdr_s *sn_coap_handle_blockwise_stream_response(struct coap_s *handle, sn_nsdl_addr_s *src_addr_ptr,
+                                                               sn_coap_hdr_s *received_coap_msg_ptr, void *param)
+{
+    int32_t block2 = received_coap_msg_ptr->options_list_ptr->block2;
+    uint32_t block_number = block2 >> 4;
+    uint8_t block_szx = block2 & 0x07;
+    uint32_t block_offset = block_number << (block_szx + 4);
+    coap_blockwise_stream_s *stream_ptr;
+
+    stream_ptr = sn_coap_protocol_linked_list_blockwise_stream_search(handle, src_addr_ptr, received_coap_msg_ptr);
+    if (stream_ptr == NULL) {
+        /* First block: the stored request is moved to the stream, to request the next blocks */
+        coap_blockwise_msg_s *previous_blockwise_msg_ptr = NULL;
+
+        ns_list_foreach(coap_blockwise_msg_s, msg, &handle->linked_list_blockwise_sent_msgs) {
+            if (msg->coap_msg_ptr && received_coap_msg_ptr->msg_id == msg->coap_msg_ptr->msg_id) {
+                previous_blockwise_msg_ptr = msg;
+                break;
+            }
+        }
+
+        if (!previous_blockwise_msg_ptr) {
+            tr_error("sn_coap_handle_blockwise_stream_response - previous message null!");
+            sn_coap_parser_release_allocated_coap_msg_mem(handle, received_coap_msg_ptr);
+            return NULL;
+        }
+
+        stream_ptr = sn_coap_protocol_linked_list_blockwise_stream_store(handle, src_addr_ptr, previous_blockwise_msg_ptr->coap_msg_ptr);
+        if (stream_ptr == NULL) {
+            sn_coap_parser_release_allocated_coap_msg_mem(handle, received_coap_msg_ptr);
+            return NULL;
+        }
+        previous_blockwise_msg_ptr->coap_msg_ptr = NULL;
+        sn_coap_protocol_linked_list_blockwise_msg_remove(handle, previous_blockwise_msg_ptr);
+
+        stream_ptr->next_block = block_number + 1;
+        stream_ptr->block_szx = block_szx;
+    } else if (stream_ptr->pending_blocks) {
+        stream_ptr->pending_blocks--;
+    }
+
+    stream_ptr->timestamp = handle->system_time;
+
+    /* Number of blocks, from the last block or from the size of the response */
+    if (!(block2 & 0x08)) {
+        stream_ptr->block_count = block_number + 1;
+    } else if (stream_ptr->block_count == 0 && received_coap_msg_ptr->options_list_ptr->use_size2) {
+        uint32_t block_size = 1u << (stream_ptr->block_szx + 4);
+        stream_ptr->block_count = (received_coap_msg_ptr->options_list_ptr->size2 + block_size - 1) / block_size;
+    }
+
+    if (handle->sn_coap_block_callback(received_coap_msg_ptr, block_offset, src_addr_ptr, param) != 0) {
+        tr_error("sn_coap_handle_blockwise_stream_response - block rejected by user!");
+        sn_coap_protocol_linked_list_blockwise_stream_remove(handle, stream_ptr);
+        received_coap_msg_ptr->coap_status = COAP_STATUS_PARSER_BLOCKWISE_MSG_REJECTED;
+        return received_coap_msg_ptr;
+    }
+    stream_ptr->received_blocks++;
+
+    if (stream_ptr->block_count && stream_ptr->received_blocks >= stream_ptr->block_count) {
+        sn_coap_protocol_linked_list_blockwise_stream_remove(handle, stream_ptr);
+        received_coap_msg_ptr->payload_ptr = NULL;
+        received_coap_msg_ptr->payload_len = 0;
+        received_coap_msg_ptr->coap_status = COAP_STATUS_PARSER_BLOCKWISE_MSG_STREAMED;
+        return received_coap_msg_ptr;
+    }
+
+    /* One block at a time until the number of blocks is known, then keep the window full */
+    uint8_t window = stream_ptr->block_count ? handle->sn_coap_block2_window : 1;
+    while (stream_ptr->pending_blocks < window &&
+            (stream_ptr->block_count == 0 || stream_ptr->next_block < stream_ptr->block_count)) {
+        if (sn_coap_protocol_blockwise_stream_request(handle, stream_ptr, src_addr_ptr, param) < 0) {
+            break;
+        }
+    }
+
+    received_coap_msg_ptr->coap_status = COAP_STATUS_PARSER_BLOCKWISE_MSG_RECEIVING;
+    return received_coap_msg_ptr;
 }
 
 #endif /* SN_COAP_MAX_BLOCKWISE_PAYLOAD_SIZE */
@@ -1696,21 +1973,32 @@ static sn_coap_hdr_s *sn_coap_handle_blockwise_message(struct coap_s *handle, sn
                 received_coap_msg_ptr->payload_len = handle->sn_coap_block_data_size;
             }
 
-            // Check that incoming block number is in order.
             uint32_t block_number = received_coap_msg_ptr->options_list_ptr->block1 >> 4;
             bool blocks_in_order = true;
-            if (block_number > 0 &&
-                !sn_coap_protocol_linked_list_blockwise_payload_compare_block_number(handle,
-                                                                                     src_addr_ptr,
-                                                                                     block_number)) {
-                blocks_in_order = false;
-            }
+            bool block_accepted = true;
+
+            if (handle->sn_coap_block_callback) {
+                /* Streaming: the block is given to the user where it belongs, nothing is stored */
+                uint32_t block_offset = block_number << ((received_coap_msg_ptr->options_list_ptr->block1 & 0x07) + 4);
+                if (handle->sn_coap_block_callback(received_coap_msg_ptr, block_offset, src_addr_ptr, param) != 0) {
+                    tr_error("sn_coap_handle_blockwise_message - (recv block1) block rejected by user!");
+                    block_accepted = false;
+                }
+            } else {
+                // Check that incoming block number is in order.
+                if (block_number > 0 &&
+                    !sn_coap_protocol_linked_list_blockwise_payload_compare_block_number(handle,
+                                                                                         src_addr_ptr,
+                                                                                         block_number)) {
+                    blocks_in_order = false;
+                }
 
-            sn_coap_protocol_linked_list_blockwise_payload_store(handle,
-                                                                 src_addr_ptr,
-                                                                 received_coap_msg_ptr->payload_len,
-                                                                 received_coap_msg_ptr->payload_ptr,
-                                                                 block_number);
+                sn_coap_protocol_linked_list_blockwise_payload_store(handle,
+                                                                     src_addr_ptr,
+                                                                     received_coap_msg_ptr->payload_len,
+                                                                     received_coap_msg_ptr->payload_ptr,
+                                                                     block_number);
+            }
 
             /* If not last block (more value is set) */
             /* Block option length can be 1-3 bytes. First 4-20 bits are for block number. Last 4 bits are ALWAYS more bit + block size. */
@@ -1733,10 +2021,13 @@ static sn_coap_hdr_s *sn_coap_handle_blockwise_message(struct coap_s *handle, sn
                 // Response with COAP_MSG_CODE_RESPONSE_REQUEST_ENTITY_TOO_LARGE if the payload size is more than we can handle
 
                 uint32_t max_size = SN_COAP_MAX_INCOMING_BLOCK_MESSAGE_SIZE;
-                if (!blocks_in_order) {
+                if (!block_accepted) {
+                    src_coap_blockwise_ack_msg_ptr->msg_code = COAP_MSG_CODE_RESPONSE_INTERNAL_SERVER_ERROR;
+                } else if (!blocks_in_order) {
                     tr_error("sn_coap_handle_blockwise_message - (recv block1) COAP_MSG_CODE_RESPONSE_REQUEST_ENTITY_INCOMPLETE!");
                     src_coap_blockwise_ack_msg_ptr->msg_code = COAP_MSG_CODE_RESPONSE_REQUEST_ENTITY_INCOMPLETE;
-                } else if (received_coap_msg_ptr->options_list_ptr->size1 > max_size) {
+                } else if (!handle->sn_coap_block_callback &&
+                           received_coap_msg_ptr->options_list_ptr->size1 > max_size) {
                     // Include maximum size that stack can handle into response
                     tr_error("sn_coap_handle_blockwise_message - (recv block1) COAP_MSG_CODE_RESPONSE_REQUEST_ENTITY_TOO_LARGE!");
                     src_coap_blockwise_ack_msg_ptr->msg_code = COAP_MSG_CODE_RESPONSE_REQUEST_ENTITY_TOO_LARGE;
@@ -1764,10 +2055,12 @@ static sn_coap_hdr_s *sn_coap_handle_blockwise_message(struct coap_s *handle, sn
                 src_coap_blockwise_ack_msg_ptr->msg_id = received_coap_msg_ptr->msg_id;
 
                 // Copy token to response
-                src_coap_blockwise_ack_msg_ptr->token_ptr = handle->sn_coap_protocol_malloc(received_coap_msg_ptr->token_len);
-                if (src_coap_blockwise_ack_msg_ptr->token_ptr) {
-                    memcpy(src_coap_blockwise_ack_msg_ptr->token_ptr, received_coap_msg_ptr->token_ptr, received_coap_msg_ptr->token_len);
-                    src_coap_blockwise_ack_msg_ptr->token_len = received_coap_msg_ptr->token_len;
+                if (received_coap_msg_ptr->token_len) {
+                    src_coap_blockwise_ack_msg_ptr->token_ptr = handle->sn_coap_protocol_malloc(received_coap_msg_ptr->token_len);
+                    if (src_coap_blockwise_ack_msg_ptr->token_ptr) {
+                        memcpy(src_coap_blockwise_ack_msg_ptr->token_ptr, received_coap_msg_ptr->token_ptr, received_coap_msg_ptr->token_len);
+                        src_coap_blockwise_ack_msg_ptr->token_len = received_coap_msg_ptr->token_len;
+                    }
                 }
 
                 dst_packed_data_needed_mem = sn_coap_builder_calc_needed_packet_data_size_2(src_coap_blockwise_ack_msg_ptr, handle->sn_coap_block_data_size);
@@ -1790,8 +2083,21 @@ static sn_coap_hdr_s *sn_coap_handle_blockwise_message(struct coap_s *handle, sn
                 handle->sn_coap_protocol_free(dst_ack_packet_data_ptr);
                 dst_ack_packet_data_ptr = 0;
 
-                received_coap_msg_ptr->coap_status = COAP_STATUS_PARSER_BLOCKWISE_MSG_RECEIVING;
+                if (block_accepted) {
+                    received_coap_msg_ptr->coap_status = COAP_STATUS_PARSER_BLOCKWISE_MSG_RECEIVING;
+                } else {
+                    received_coap_msg_ptr->coap_status = COAP_STATUS_PARSER_BLOCKWISE_MSG_REJECTED;
+                }
 
+            } else if (handle->sn_coap_block_callback) {
+                /* * * Last block of a streamed message, the user answers the request * * */
+                if (block_accepted) {
+                    received_coap_msg_ptr->payload_ptr = NULL;
+                    received_coap_msg_ptr->payload_len = 0;
+                    received_coap_msg_ptr->coap_status = COAP_STATUS_PARSER_BLOCKWISE_MSG_STREAMED;
+                } else {
+                    received_coap_msg_ptr->coap_status = COAP_STATUS_PARSER_BLOCKWISE_MSG_REJECTED;
+                }
             } else {
                 /* * * This is the last block when whole Blockwise payload from received * * */
                 /* * * blockwise messages is gathered and returned to User               * * */
@@ -1831,7 +2137,9 @@ static sn_coap_hdr_s *sn_coap_handle_blockwise_message(struct coap_s *handle, sn
     /* Message ID must be same than in received message */
     else {
         //This is response to request we made
-        if (received_coap_msg_ptr->msg_code > COAP_MSG_CODE_REQUEST_DELETE) {
+        if (received_coap_msg_ptr->msg_code > COAP_MSG_CODE_REQUEST_DELETE && handle->sn_coap_block_callback) {
+            return sn_coap_handle_blockwise_stream_response(handle, src_addr_ptr, received_coap_msg_ptr, param);
+        } else if (received_coap_msg_ptr->msg_code > COAP_MSG_CODE_REQUEST_DELETE) {
             uint32_t block_number = 0;
 
             /* Store blockwise payload to Linked list */
@@ -0,0 +1,372 @@
+/*
+ * Copyright (c) 2017 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "CppUTest/TestHarness.h"
+#include <stdlib.h>
+#include <string.h>
+#include "ns_types.h"
+#include "mbed-coap/sn_coap_header.h"
+#include "mbed-coap/sn_coap_protocol.h"
+#include "sn_coap_protocol_internal.h"
+
+#define BLOCK_SIZE      16
+#define BLOCK_COUNT     5
+#define MAX_SENT        8
+#define MAX_BLOCKS      8
+
+/* Block option value, with 16 byte blocks */
+#define BLOCK(number, more)     (((number) << 4) | ((more) ? 0x08 : 0))
+
+static struct coap_s *handle;
+static uint8_t address[4] = { 192, 168, 0, 1 };
+static sn_nsdl_addr_s peer;
+static uint8_t token[2] = { 0xab, 0xcd };
+static uint8_t resource[BLOCK_COUNT * BLOCK_SIZE];
+
+static int sent_count;
+static uint8_t sent_packets[MAX_SENT][32];
+static uint16_t sent_lens[MAX_SENT];
+
+static int block_count;
+static uint32_t block_offsets[MAX_BLOCKS];
+static uint8_t streamed[BLOCK_COUNT * BLOCK_SIZE];
+static int reject_block;
+
+static void *test_malloc(uint16_t size)
+{
+    return malloc(size);
+}
+
+static void test_free(void *ptr)
+{
+    free(ptr);
+}
+
+static uint8_t test_tx(uint8_t *packet_ptr, uint16_t packet_len, sn_nsdl_addr_s *addr_ptr, void *param)
+{
+    if (sent_count < MAX_SENT && packet_len <= sizeof(sent_packets[0])) {
+        memcpy(sent_packets[sent_count], packet_ptr, packet_len);
+        sent_lens[sent_count] = packet_len;
+    }
+    sent_count++;
+    return 1;
+}
+
+static int8_t test_rx(sn_coap_hdr_s *coap_ptr, sn_nsdl_addr_s *addr_ptr, void *param)
+{
+    return 0;
+}
+
+static int8_t test_block(sn_coap_hdr_s *coap_ptr, uint32_t offset, sn_nsdl_addr_s *addr_ptr, void *param)
+{
+    if (block_count == reject_block) {
+        return -1;
+    }
+    if (block_count < MAX_BLOCKS) {
+        block_offsets[block_count] = offset;
+    }
+    block_count++;
+    if (offset + coap_ptr->payload_len <= sizeof(streamed)) {
+        memcpy(streamed + offset, coap_ptr->payload_ptr, coap_ptr->payload_len);
+    }
+    return 0;
+}
+
+// Parses a sent packet, which is modified, into coap and options
+static void parse_sent(int index, sn_coap_hdr_s *coap, sn_coap_options_list_s *options)
+{
+    coap_version_e version;
+    CHECK(index < sent_count);
+    CHECK(sn_coap_parser_in_place(sent_lens[index], sent_packets[index], &version, coap, options) != NULL);
+}
+
+// Parses a block of the resource, with a Block1 option for requests and a Block2 option for responses
+static int receive_block(sn_coap_msg_type_e type, sn_coap_msg_code_e code, uint16_t msg_id,
+                         uint32_t number, bool more, int32_t size)
+{
+    sn_coap_hdr_s coap;
+    sn_coap_options_list_s options;
+    uint8_t packet[64];
+    sn_coap_parser_init_message(&coap);
+    memset(&options, 0, sizeof(options));
+    options.max_age = COAP_OPTION_MAX_AGE_DEFAULT;
+    options.uri_port = COAP_OPTION_URI_PORT_NONE;
+    options.observe = COAP_OBSERVE_NONE;
+    options.accept = COAP_CT_NONE;
+    options.block1 = COAP_OPTION_BLOCK_NONE;
+    options.block2 = COAP_OPTION_BLOCK_NONE;
+
+    bool request = code <= COAP_MSG_CODE_REQUEST_DELETE;
+    if (request) {
+        options.block1 = BLOCK(number, more);
+        options.use_size1 = size >= 0;
+        options.size1 = size;
+    } else {
+        options.block2 = BLOCK(number, more);
+        options.use_size2 = size >= 0;
+        options.size2 = size;
+    }
+    coap.msg_type = type;
+    coap.msg_code = code;
+    coap.msg_id = msg_id;
+    coap.token_ptr = token;
+    coap.token_len = sizeof(token);
+    if (request) {
+        coap.uri_path_ptr = (uint8_t *)"fw";
+        coap.uri_path_len = 2;
+    }
+    coap.payload_ptr = resource + number * BLOCK_SIZE;
+    coap.payload_len = BLOCK_SIZE;
+    coap.options_list_ptr = &options;
+
+    int16_t packet_len = sn_coap_builder(packet, &coap);
+    CHECK(packet_len > 0);
+    sn_coap_hdr_s *coap_ptr = sn_coap_protocol_parse(handle, &peer, packet_len, packet, NULL);
+    if (coap_ptr == NULL) {
+        return -1;
+    }
+    int status = coap_ptr->coap_status;
+    if (status == COAP_STATUS_PARSER_BLOCKWISE_MSG_STREAMED) {
+        POINTERS_EQUAL(NULL, coap_ptr->payload_ptr);
+        LONGS_EQUAL(0, coap_ptr->payload_len);
+    }
+    sn_coap_parser_release_allocated_coap_msg_mem(handle, coap_ptr);
+    return status;
+}
+
+// Sends a GET request for the resource, returns its Message ID
+static uint16_t request_resource()
+{
+    sn_coap_hdr_s coap;
+    uint8_t packet[32];
+    sn_coap_parser_init_message(&coap);
+    coap.msg_type = COAP_MSG_TYPE_CONFIRMABLE;
+    coap.msg_code = COAP_MSG_CODE_REQUEST_GET;
+    coap.token_ptr = token;
+    coap.token_len = sizeof(token);
+    coap.uri_path_ptr = (uint8_t *)"fw";
+    coap.uri_path_len = 2;
+    CHECK(sn_coap_protocol_build(handle, &peer, packet, &coap, NULL) > 0);
+    return coap.msg_id;
+}
+
+// Checks that a sent packet requests a block, returns its Message ID
+static uint16_t check_block_request(int index, uint32_t number, bool size_asked)
+{
+    sn_coap_hdr_s coap;
+    sn_coap_options_list_s options;
+    parse_sent(index, &coap, &options);
+    LONGS_EQUAL(COAP_MSG_CODE_REQUEST_GET, coap.msg_code);
+    LONGS_EQUAL(sizeof(token), coap.token_len);
+    MEMCMP_EQUAL(token, coap.token_ptr, sizeof(token));
+    POINTERS_EQUAL(&options, coap.options_list_ptr);
+    LONGS_EQUAL(number << 4, options.block2);
+    LONGS_EQUAL(size_asked, options.use_size2);
+    return coap.msg_id;
+}
+
+TEST_GROUP(sn_coap_block_stream)
+{
+    void setup()
+    {
+        handle = sn_coap_protocol_init(test_malloc, test_free, test_tx, test_rx);
+        CHECK(handle != NULL);
+        // Requests are not resent, so that only the block requests are sent
+        LONGS_EQUAL(0, sn_coap_protocol_set_retransmission_parameters(handle, 0, 10));
+
+        peer.addr_ptr = address;
+        peer.addr_len = sizeof(address);
+        peer.port = 5683;
+        peer.type = SN_NSDL_ADDRESS_TYPE_IPV4;
+        for (unsigned i = 0; i < sizeof(resource); i++) {
+            resource[i] = i * 7;
+        }
+        memset(streamed, 0, sizeof(streamed));
+        sent_count = 0;
+        block_count = 0;
+        reject_block = -1;
+    }
+
+    void teardown()
+    {
+        sn_coap_protocol_destroy(handle);
+    }
+};
+
+TEST(sn_coap_block_stream, set_block_stream)
+{
+    LONGS_EQUAL(-1, sn_coap_protocol_set_block_stream(NULL, test_block, 1));
+    LONGS_EQUAL(-1, sn_coap_protocol_set_block_stream(handle, test_block, 0));
+    LONGS_EQUAL(0, sn_coap_protocol_set_block_stream(handle, test_block, 4));
+    LONGS_EQUAL(0, sn_coap_protocol_set_block_stream(handle, NULL, 1));
+}
+
+TEST(sn_coap_block_stream, block1)
+{
+    LONGS_EQUAL(0, sn_coap_protocol_set_block_stream(handle, test_block, 1));
+
+    // Each block goes to the callback at its offset, and is acknowledged to continue
+    for (uint32_t i = 0; i < BLOCK_COUNT - 1; i++) {
+        LONGS_EQUAL(COAP_STATUS_PARSER_BLOCKWISE_MSG_RECEIVING,
+                    receive_block(COAP_MSG_TYPE_CONFIRMABLE, COAP_MSG_CODE_REQUEST_PUT, 100 + i, i, true,
+                                  i == 0 ? sizeof(resource) : -1));
+        LONGS_EQUAL(i + 1, sent_count);
+
+        sn_coap_hdr_s coap;
+        sn_coap_options_list_s options;
+        parse_sent(i, &coap, &options);
+        LONGS_EQUAL(COAP_MSG_TYPE_ACKNOWLEDGEMENT, coap.msg_type);
+        LONGS_EQUAL(COAP_MSG_CODE_RESPONSE_CONTINUE, coap.msg_code);
+        LONGS_EQUAL(100 + i, coap.msg_id);
+        MEMCMP_EQUAL(token, coap.token_ptr, sizeof(token));
+    }
+
+    // The last one completes the transfer, which the user answers
+    LONGS_EQUAL(COAP_STATUS_PARSER_BLOCKWISE_MSG_STREAMED,
+                receive_block(COAP_MSG_TYPE_CONFIRMABLE, COAP_MSG_CODE_REQUEST_PUT, 200, BLOCK_COUNT - 1, false, -1));
+    LONGS_EQUAL(BLOCK_COUNT - 1, sent_count);
+    LONGS_EQUAL(BLOCK_COUNT, block_count);
+    for (int i = 0; i < BLOCK_COUNT; i++) {
+        LONGS_EQUAL(i * BLOCK_SIZE, block_offsets[i]);
+    }
+    MEMCMP_EQUAL(resource, streamed, sizeof(resource));
+}
+
+TEST(sn_coap_block_stream, block1_rejected)
+{
+    LONGS_EQUAL(0, sn_coap_protocol_set_block_stream(handle, test_block, 1));
+    reject_block = 1;
+
+    LONGS_EQUAL(COAP_STATUS_PARSER_BLOCKWISE_MSG_RECEIVING,
+                receive_block(COAP_MSG_TYPE_CONFIRMABLE, COAP_MSG_CODE_REQUEST_POST, 100, 0, true, -1));
+
+    // A rejected block aborts the transfer with an error response
+    LONGS_EQUAL(COAP_STATUS_PARSER_BLOCKWISE_MSG_REJECTED,
+                receive_block(COAP_MSG_TYPE_CONFIRMABLE, COAP_MSG_CODE_REQUEST_POST, 101, 1, true, -1));
+    LONGS_EQUAL(2, sent_count);
+    sn_coap_hdr_s coap;
+    sn_coap_options_list_s options;
+    parse_sent(1, &coap, &options);
+    LONGS_EQUAL(COAP_MSG_CODE_RESPONSE_INTERNAL_SERVER_ERROR, coap.msg_code);
+    LONGS_EQUAL(101, coap.msg_id);
+
+    // Even on the last block, which the user then does not answer
+    LONGS_EQUAL(COAP_STATUS_PARSER_BLOCKWISE_MSG_REJECTED,
+                receive_block(COAP_MSG_TYPE_CONFIRMABLE, COAP_MSG_CODE_REQUEST_POST, 102, 2, false, -1));
+    LONGS_EQUAL(2, sent_count);
+}
+
+TEST(sn_coap_block_stream, block2_window)
+{
+    LONGS_EQUAL(0, sn_coap_protocol_set_block_stream(handle, test_block, 3));
+    uint16_t msg_id = request_resource();
+    LONGS_EQUAL(0, sent_count);
+
+    // The size of the resource opens the window
+    LONGS_EQUAL(COAP_STATUS_PARSER_BLOCKWISE_MSG_RECEIVING,
+                receive_block(COAP_MSG_TYPE_ACKNOWLEDGEMENT, COAP_MSG_CODE_RESPONSE_CONTENT, msg_id, 0, true,
+                              sizeof(resource)));
+    LONGS_EQUAL(3, sent_count);
+    uint16_t ids[BLOCK_COUNT];
+    for (int i = 1; i <= 3; i++) {
+        ids[i] = check_block_request(i - 1, i, false);
+    }
+
+    // Blocks may come out of order, each one received requests the next one
+    LONGS_EQUAL(COAP_STATUS_PARSER_BLOCKWISE_MSG_RECEIVING,
+                receive_block(COAP_MSG_TYPE_ACKNOWLEDGEMENT, COAP_MSG_CODE_RESPONSE_CONTENT, ids[2], 2, true, -1));
+    LONGS_EQUAL(4, sent_count);
+    ids[4] = check_block_request(3, 4, false);
+    LONGS_EQUAL(COAP_STATUS_PARSER_BLOCKWISE_MSG_RECEIVING,
+                receive_block(COAP_MSG_TYPE_ACKNOWLEDGEMENT, COAP_MSG_CODE_RESPONSE_CONTENT, ids[1], 1, true, -1));
+    LONGS_EQUAL(COAP_STATUS_PARSER_BLOCKWISE_MSG_RECEIVING,
+                receive_block(COAP_MSG_TYPE_ACKNOWLEDGEMENT, COAP_MSG_CODE_RESPONSE_CONTENT, ids[4], 4, false, -1));
+
+    // Nothing is requested past the end of the resource
+    LONGS_EQUAL(4, sent_count);
+    LONGS_EQUAL(COAP_STATUS_PARSER_BLOCKWISE_MSG_STREAMED,
+                receive_block(COAP_MSG_TYPE_ACKNOWLEDGEMENT, COAP_MSG_CODE_RESPONSE_CONTENT, ids[3], 3, true, -1));
+    LONGS_EQUAL(4, sent_count);
+
+    LONGS_EQUAL(BLOCK_COUNT, block_count);
+    LONGS_EQUAL(0 * BLOCK_SIZE, block_offsets[0]);
+    LONGS_EQUAL(2 * BLOCK_SIZE, block_offsets[1]);
+    LONGS_EQUAL(1 * BLOCK_SIZE, block_offsets[2]);
+    LONGS_EQUAL(4 * BLOCK_SIZE, block_offsets[3]);
+    LONGS_EQUAL(3 * BLOCK_SIZE, block_offsets[4]);
+    MEMCMP_EQUAL(resource, streamed, sizeof(resource));
+}
+
+TEST(sn_coap_block_stream, block2_unknown_size)
+{
+    LONGS_EQUAL(0, sn_coap_protocol_set_block_stream(handle, test_block, 3));
+    uint16_t msg_id = request_resource();
+
+    // Without the size, blocks are requested one at a time, asking for it
+    LONGS_EQUAL(COAP_STATUS_PARSER_BLOCKWISE_MSG_RECEIVING,
+                receive_block(COAP_MSG_TYPE_ACKNOWLEDGEMENT, COAP_MSG_CODE_RESPONSE_CONTENT, msg_id, 0, true, -1));
+    LONGS_EQUAL(1, sent_count);
+    uint16_t id = check_block_request(0, 1, true);
+
+    LONGS_EQUAL(COAP_STATUS_PARSER_BLOCKWISE_MSG_RECEIVING,
+                receive_block(COAP_MSG_TYPE_ACKNOWLEDGEMENT, COAP_MSG_CODE_RESPONSE_CONTENT, id, 1, true, -1));
+    LONGS_EQUAL(2, sent_count);
+    id = check_block_request(1, 2, true);
+
+    // Until the size is given
+    LONGS_EQUAL(COAP_STATUS_PARSER_BLOCKWISE_MSG_RECEIVING,
+                receive_block(COAP_MSG_TYPE_ACKNOWLEDGEMENT, COAP_MSG_CODE_RESPONSE_CONTENT, id, 2, true,
+                              sizeof(resource)));
+    LONGS_EQUAL(4, sent_count);
+    check_block_request(2, 3, false);
+    check_block_request(3, 4, false);
+}
+
+TEST(sn_coap_block_stream, block2_rejected)
+{
+    LONGS_EQUAL(0, sn_coap_protocol_set_block_stream(handle, test_block, 1));
+    uint16_t msg_id = request_resource();
+    reject_block = 1;
+
+    LONGS_EQUAL(COAP_STATUS_PARSER_BLOCKWISE_MSG_RECEIVING,
+                receive_block(COAP_MSG_TYPE_ACKNOWLEDGEMENT, COAP_MSG_CODE_RESPONSE_CONTENT, msg_id, 0, true,
+                              sizeof(resource)));
+    LONGS_EQUAL(1, sent_count);
+    uint16_t id = check_block_request(0, 1, false);
+
+    // A rejected block ends the transfer, later blocks are not for any request
+    LONGS_EQUAL(COAP_STATUS_PARSER_BLOCKWISE_MSG_REJECTED,
+                receive_block(COAP_MSG_TYPE_ACKNOWLEDGEMENT, COAP_MSG_CODE_RESPONSE_CONTENT, id, 1, true, -1));
+    LONGS_EQUAL(1, sent_count);
+    LONGS_EQUAL(-1, receive_block(COAP_MSG_TYPE_ACKNOWLEDGEMENT, COAP_MSG_CODE_RESPONSE_CONTENT, id + 1, 2, true, -1));
+    LONGS_EQUAL(1, sent_count);
+    LONGS_EQUAL(1, block_count);
+}
+
+TEST(sn_coap_block_stream, block2_expired)
+{
+    LONGS_EQUAL(0, sn_coap_protocol_set_block_stream(handle, test_block, 1));
+    sn_coap_protocol_exec(handle, 0);
+    uint16_t msg_id = request_resource();
+
+    LONGS_EQUAL(COAP_STATUS_PARSER_BLOCKWISE_MSG_RECEIVING,
+                receive_block(COAP_MSG_TYPE_ACKNOWLEDGEMENT, COAP_MSG_CODE_RESPONSE_CONTENT, msg_id, 0, true, -1));
+    uint16_t id = check_block_request(0, 1, true);
+
+    // A stream left without blocks is dropped like other blockwise data
+    sn_coap_protocol_exec(handle, SN_COAP_BLOCKWISE_MAX_TIME_DATA_STORED + 1);
+    LONGS_EQUAL(-1, receive_block(COAP_MSG_TYPE_ACKNOWLEDGEMENT, COAP_MSG_CODE_RESPONSE_CONTENT, id, 1, true, -1));
+    LONGS_EQUAL(1, block_count);
+}
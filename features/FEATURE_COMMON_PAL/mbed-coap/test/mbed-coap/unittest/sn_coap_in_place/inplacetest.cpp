@@ -0,0 +1,260 @@
+/*
+ * Copyright (c) 2017 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "CppUTest/TestHarness.h"
+#include <stdlib.h>
+#include <string.h>
+#include "ns_types.h"
+#include "mbed-coap/sn_coap_header.h"
+#include "mbed-coap/sn_coap_protocol.h"
+#include "sn_coap_protocol_internal.h"
+
+static struct coap_s *handle;
+static int malloc_count;
+static int sent_count;
+
+static uint8_t token[4] = { 0x01, 0x02, 0x03, 0x04 };
+static uint8_t address[4] = { 192, 168, 0, 1 };
+static sn_nsdl_addr_s peer;
+
+static void *test_malloc(uint16_t size)
+{
+    malloc_count++;
+    return malloc(size);
+}
+
+static void test_free(void *ptr)
+{
+    free(ptr);
+}
+
+static uint8_t test_tx(uint8_t *packet_ptr, uint16_t packet_len, sn_nsdl_addr_s *addr_ptr, void *param)
+{
+    sent_count++;
+    return 1;
+}
+
+static int8_t test_rx(sn_coap_hdr_s *coap_ptr, sn_nsdl_addr_s *addr_ptr, void *param)
+{
+    return 0;
+}
+
+static bool points_into(const uint8_t *ptr, const uint8_t *packet, uint16_t packet_len)
+{
+    return ptr >= packet && ptr < packet + packet_len;
+}
+
+// Builds a request with multi-part options and a payload, and a Block1 option if given
+static uint16_t build_request(uint8_t *packet, uint16_t packet_size, int32_t block1)
+{
+    sn_coap_hdr_s coap;
+    sn_coap_options_list_s options;
+    sn_coap_parser_init_message(&coap);
+    memset(&options, 0, sizeof(options));
+    options.max_age = COAP_OPTION_MAX_AGE_DEFAULT;
+    options.uri_port = COAP_OPTION_URI_PORT_NONE;
+    options.observe = COAP_OBSERVE_NONE;
+    options.accept = COAP_CT_NONE;
+    options.block1 = block1;
+    options.block2 = COAP_OPTION_BLOCK_NONE;
+    options.uri_query_ptr = (uint8_t *)"x=1&y=22";
+    options.uri_query_len = 8;
+
+    coap.msg_type = COAP_MSG_TYPE_CONFIRMABLE;
+    coap.msg_code = COAP_MSG_CODE_REQUEST_POST;
+    coap.msg_id = 0x1234;
+    coap.token_ptr = token;
+    coap.token_len = sizeof(token);
+    coap.uri_path_ptr = (uint8_t *)"a/bc/def";
+    coap.uri_path_len = 8;
+    coap.content_format = COAP_CT_TEXT_PLAIN;
+    coap.payload_ptr = (uint8_t *)"hello";
+    coap.payload_len = 5;
+    coap.options_list_ptr = &options;
+
+    CHECK(sn_coap_builder_calc_needed_packet_data_size(&coap) <= packet_size);
+    int16_t packet_len = sn_coap_builder(packet, &coap);
+    CHECK(packet_len > 0);
+    return packet_len;
+}
+
+TEST_GROUP(sn_coap_in_place)
+{
+    void setup()
+    {
+        handle = sn_coap_protocol_init(test_malloc, test_free, test_tx, test_rx);
+        CHECK(handle != NULL);
+        peer.addr_ptr = address;
+        peer.addr_len = sizeof(address);
+        peer.port = 5683;
+        peer.type = SN_NSDL_ADDRESS_TYPE_IPV4;
+        malloc_count = 0;
+        sent_count = 0;
+    }
+
+    void teardown()
+    {
+        sn_coap_protocol_destroy(handle);
+    }
+};
+
+TEST(sn_coap_in_place, parser)
+{
+    uint8_t packet[64];
+    uint8_t copy[64];
+    uint16_t packet_len = build_request(packet, sizeof(packet), COAP_OPTION_BLOCK_NONE);
+    memcpy(copy, packet, packet_len);
+
+    coap_version_e version = COAP_VERSION_UNKNOWN;
+    sn_coap_hdr_s coap;
+    sn_coap_options_list_s options;
+    POINTERS_EQUAL(&coap, sn_coap_parser_in_place(packet_len, packet, &version, &coap, &options));
+    LONGS_EQUAL(0, malloc_count);
+    LONGS_EQUAL(COAP_VERSION_1, version);
+    LONGS_EQUAL(COAP_STATUS_OK, coap.coap_status);
+    POINTERS_EQUAL(&options, coap.options_list_ptr);
+
+    // The message is the one the allocating parser gives, pointing into the packet
+    sn_coap_hdr_s *expected = sn_coap_parser(handle, packet_len, copy, &version);
+    CHECK(expected != NULL);
+    LONGS_EQUAL(expected->msg_type, coap.msg_type);
+    LONGS_EQUAL(expected->msg_code, coap.msg_code);
+    LONGS_EQUAL(expected->msg_id, coap.msg_id);
+    LONGS_EQUAL(expected->content_format, coap.content_format);
+
+    LONGS_EQUAL(sizeof(token), coap.token_len);
+    MEMCMP_EQUAL(token, coap.token_ptr, sizeof(token));
+    CHECK(points_into(coap.token_ptr, packet, packet_len));
+
+    LONGS_EQUAL(8, coap.uri_path_len);
+    MEMCMP_EQUAL("a/bc/def", coap.uri_path_ptr, 8);
+    CHECK(points_into(coap.uri_path_ptr, packet, packet_len));
+
+    LONGS_EQUAL(expected->options_list_ptr->uri_query_len, options.uri_query_len);
+    MEMCMP_EQUAL(expected->options_list_ptr->uri_query_ptr, options.uri_query_ptr, options.uri_query_len);
+    CHECK(points_into(options.uri_query_ptr, packet, packet_len));
+    LONGS_EQUAL(COAP_OPTION_BLOCK_NONE, options.block1);
+
+    LONGS_EQUAL(5, coap.payload_len);
+    MEMCMP_EQUAL("hello", coap.payload_ptr, 5);
+    POINTERS_EQUAL(packet + packet_len - 5, coap.payload_ptr);
+
+    sn_coap_parser_release_allocated_coap_msg_mem(handle, expected);
+}
+
+TEST(sn_coap_in_place, parser_no_options)
+{
+    uint8_t packet[4] = { 0x50, COAP_MSG_CODE_REQUEST_GET, 0x00, 0x07 };
+    coap_version_e version = COAP_VERSION_UNKNOWN;
+    sn_coap_hdr_s coap;
+    sn_coap_options_list_s options;
+
+    POINTERS_EQUAL(&coap, sn_coap_parser_in_place(sizeof(packet), packet, &version, &coap, &options));
+    LONGS_EQUAL(COAP_STATUS_OK, coap.coap_status);
+    LONGS_EQUAL(COAP_MSG_TYPE_NON_CONFIRMABLE, coap.msg_type);
+    LONGS_EQUAL(7, coap.msg_id);
+    POINTERS_EQUAL(NULL, coap.options_list_ptr);
+    POINTERS_EQUAL(NULL, coap.payload_ptr);
+
+    POINTERS_EQUAL(NULL, sn_coap_parser_in_place(sizeof(packet), packet, &version, &coap, NULL));
+    POINTERS_EQUAL(NULL, sn_coap_parser_in_place(3, packet, &version, &coap, &options));
+    LONGS_EQUAL(0, malloc_count);
+}
+
+TEST(sn_coap_in_place, protocol_parse)
+{
+    uint8_t packet[64];
+    uint16_t packet_len = build_request(packet, sizeof(packet), COAP_OPTION_BLOCK_NONE);
+    sn_coap_hdr_s coap;
+    sn_coap_options_list_s options;
+    malloc_count = 0;
+
+    POINTERS_EQUAL(NULL, sn_coap_protocol_parse_in_place(handle, &peer, packet_len, packet, NULL, NULL, &options));
+    POINTERS_EQUAL(NULL, sn_coap_protocol_parse_in_place(handle, &peer, packet_len, packet, NULL, &coap, NULL));
+
+    POINTERS_EQUAL(&coap, sn_coap_protocol_parse_in_place(handle, &peer, packet_len, packet, NULL, &coap, &options));
+    LONGS_EQUAL(COAP_STATUS_OK, coap.coap_status);
+    LONGS_EQUAL(0x1234, coap.msg_id);
+    MEMCMP_EQUAL("a/bc/def", coap.uri_path_ptr, 8);
+    MEMCMP_EQUAL("hello", coap.payload_ptr, 5);
+    LONGS_EQUAL(0, malloc_count);
+    LONGS_EQUAL(0, sent_count);
+}
+
+TEST(sn_coap_in_place, protocol_parse_error)
+{
+    // Option delta 15 is reserved for the payload marker
+    uint8_t packet[6] = { 0x40, COAP_MSG_CODE_REQUEST_GET, 0x00, 0x08, 0xf1, 0x00 };
+    sn_coap_hdr_s coap;
+    sn_coap_options_list_s options;
+
+    // The caller storage is not released, and a reset is sent
+    POINTERS_EQUAL(NULL, sn_coap_protocol_parse_in_place(handle, &peer, sizeof(packet), packet, NULL, &coap, &options));
+    LONGS_EQUAL(1, sent_count);
+}
+
+TEST(sn_coap_in_place, blockwise_rejected)
+{
+    uint8_t packet[64];
+    uint8_t copy[64];
+    uint16_t packet_len = build_request(packet, sizeof(packet), 0x08);
+    memcpy(copy, packet, packet_len);
+    sn_coap_hdr_s coap;
+    sn_coap_options_list_s options;
+    malloc_count = 0;
+
+    // Blockwise messages parsed in place are left to the caller
+    POINTERS_EQUAL(&coap, sn_coap_protocol_parse_in_place(handle, &peer, packet_len, packet, NULL, &coap, &options));
+    LONGS_EQUAL(COAP_STATUS_PARSER_BLOCKWISE_MSG_REJECTED, coap.coap_status);
+    LONGS_EQUAL(0x08, options.block1);
+    LONGS_EQUAL(0, malloc_count);
+    LONGS_EQUAL(0, sent_count);
+
+    // While the library handles them otherwise
+    sn_coap_hdr_s *coap_ptr = sn_coap_protocol_parse(handle, &peer, packet_len, copy, NULL);
+    CHECK(coap_ptr != NULL);
+    CHECK(coap_ptr->coap_status != COAP_STATUS_PARSER_BLOCKWISE_MSG_REJECTED);
+    LONGS_EQUAL(1, sent_count);
+    sn_coap_parser_release_allocated_coap_msg_mem(handle, coap_ptr);
+}
+
+TEST(sn_coap_in_place, builder_bounded)
+{
+    uint8_t packet[64];
+    uint8_t expected[64];
+    uint16_t packet_len = build_request(expected, sizeof(expected), COAP_OPTION_BLOCK_NONE);
+
+    sn_coap_hdr_s coap;
+    sn_coap_options_list_s options;
+    coap_version_e version;
+    uint8_t parsed[64];
+    memcpy(parsed, expected, packet_len);
+    sn_coap_parser_in_place(packet_len, parsed, &version, &coap, &options);
+    coap.uri_path_ptr = (uint8_t *)"a/bc/def";
+    options.uri_query_ptr = (uint8_t *)"x=1&y=22";
+
+    // A message that does not fit is not written at all
+    memset(packet, 0xaa, sizeof(packet));
+    LONGS_EQUAL(-3, sn_coap_builder_3(packet, packet_len - 1, &coap, 0));
+    for (uint16_t i = 0; i < sizeof(packet); i++) {
+        LONGS_EQUAL(0xaa, packet[i]);
+    }
+
+    LONGS_EQUAL(packet_len, sn_coap_builder_3(packet, packet_len, &coap, 0));
+    MEMCMP_EQUAL(expected, packet, packet_len);
+    LONGS_EQUAL(0xaa, packet[packet_len]);
+    LONGS_EQUAL(-2, sn_coap_builder_3(NULL, packet_len, &coap, 0));
+    LONGS_EQUAL(-2, sn_coap_builder_3(packet, packet_len, NULL, 0));
+}
@@ -0,0 +1,260 @@
+/*
+ * Copyright (c) 2017 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "CppUTest/TestHarness.h"
+#include <stdlib.h>
+#include <string.h>
+#include "ns_types.h"
+#include "mbed-coap/sn_coap_header.h"
+#include "mbed-coap/sn_coap_protocol.h"
+
+#define PEER_COUNT  24
+#define MAX_SENT    8
+
+static struct coap_s *handle;
+static uint8_t peer_addresses[PEER_COUNT][16];
+static sn_nsdl_addr_s peers[PEER_COUNT];
+
+static int sent_count;
+static uint16_t sent_ids[MAX_SENT];
+static int failed_count;
+static uint16_t failed_ids[MAX_SENT];
+static bool cancel_all;
+
+static void *test_malloc(uint16_t size)
+{
+    return malloc(size);
+}
+
+static void test_free(void *ptr)
+{
+    free(ptr);
+}
+
+static uint16_t packet_msg_id(const uint8_t *packet_ptr)
+{
+    return (packet_ptr[2] << 8) | packet_ptr[3];
+}
+
+static uint8_t test_tx(uint8_t *packet_ptr, uint16_t packet_len, sn_nsdl_addr_s *addr_ptr, void *param)
+{
+    if (sent_count < MAX_SENT) {
+        sent_ids[sent_count] = packet_msg_id(packet_ptr);
+    }
+    sent_count++;
+
+    // The message being sent and the ones after it can be cancelled from here
+    if (cancel_all) {
+        for (uint16_t i = 0; i < MAX_SENT; i++) {
+            sn_coap_protocol_delete_retransmission(handle, sent_ids[0] + i);
+        }
+    }
+    return 1;
+}
+
+static int8_t test_rx(sn_coap_hdr_s *coap_ptr, sn_nsdl_addr_s *addr_ptr, void *param)
+{
+    if (coap_ptr->coap_status == COAP_STATUS_BUILDER_MESSAGE_SENDING_FAILED && failed_count < MAX_SENT) {
+        failed_ids[failed_count++] = coap_ptr->msg_id;
+    }
+    return 0;
+}
+
+// Parses a message of the given type from a peer, returns its status
+static int receive(sn_nsdl_addr_s *peer, sn_coap_msg_type_e type, uint16_t msg_id)
+{
+    bool request = type == COAP_MSG_TYPE_CONFIRMABLE || type == COAP_MSG_TYPE_NON_CONFIRMABLE;
+    uint8_t packet[4] = { (uint8_t)(0x40 | type), request ? COAP_MSG_CODE_REQUEST_GET : COAP_MSG_CODE_EMPTY,
+                          (uint8_t)(msg_id >> 8), (uint8_t)msg_id };
+    sn_coap_hdr_s *coap_ptr = sn_coap_protocol_parse(handle, peer, sizeof(packet), packet, NULL);
+    CHECK(coap_ptr != NULL);
+    int status = coap_ptr->coap_status;
+    sn_coap_parser_release_allocated_coap_msg_mem(handle, coap_ptr);
+    return status;
+}
+
+// Builds a message to a peer, returns its Message ID
+static uint16_t send(sn_nsdl_addr_s *peer, sn_coap_msg_type_e type, uint16_t msg_id)
+{
+    sn_coap_hdr_s coap;
+    uint8_t packet[16];
+    memset(&coap, 0, sizeof(coap));
+    coap.msg_type = type;
+    coap.msg_code = type == COAP_MSG_TYPE_ACKNOWLEDGEMENT ? COAP_MSG_CODE_RESPONSE_CONTENT : COAP_MSG_CODE_REQUEST_GET;
+    coap.msg_id = msg_id;
+    CHECK(sn_coap_protocol_build(handle, peer, packet, &coap, NULL) > 0);
+    return coap.msg_id;
+}
+
+TEST_GROUP(sn_coap_lookup)
+{
+    void setup()
+    {
+        handle = sn_coap_protocol_init(test_malloc, test_free, test_tx, test_rx);
+        CHECK(handle != NULL);
+
+        // Peers differ by only one byte of address, or only by port
+        for (int i = 0; i < PEER_COUNT; i++) {
+            memset(peer_addresses[i], 0, 16);
+            peer_addresses[i][0] = 0xfe;
+            peer_addresses[i][15] = i / 2;
+            peers[i].addr_ptr = peer_addresses[i];
+            peers[i].addr_len = 16;
+            peers[i].port = 5683 + i % 2;
+            peers[i].type = SN_NSDL_ADDRESS_TYPE_IPV6;
+        }
+        sent_count = 0;
+        failed_count = 0;
+        cancel_all = false;
+    }
+
+    void teardown()
+    {
+        sn_coap_protocol_destroy(handle);
+    }
+};
+
+TEST(sn_coap_lookup, duplicates)
+{
+    LONGS_EQUAL(-1, sn_coap_protocol_set_duplicate_buffer_size(handle, 33));
+    LONGS_EQUAL(0, sn_coap_protocol_set_duplicate_buffer_size(handle, 32));
+
+    // Peers choose the same Message IDs, each one is told apart
+    for (int i = 0; i < 16; i++) {
+        LONGS_EQUAL(COAP_STATUS_OK, receive(&peers[i], COAP_MSG_TYPE_CONFIRMABLE, 100));
+        LONGS_EQUAL(COAP_STATUS_OK, receive(&peers[i], COAP_MSG_TYPE_NON_CONFIRMABLE, 101 + i));
+    }
+    for (int i = 0; i < 16; i++) {
+        LONGS_EQUAL(COAP_STATUS_PARSER_DUPLICATED_MSG, receive(&peers[i], COAP_MSG_TYPE_CONFIRMABLE, 100));
+        LONGS_EQUAL(COAP_STATUS_PARSER_DUPLICATED_MSG, receive(&peers[i], COAP_MSG_TYPE_NON_CONFIRMABLE, 101 + i));
+    }
+    for (int i = 16; i < PEER_COUNT; i++) {
+        LONGS_EQUAL(COAP_STATUS_OK, receive(&peers[i], COAP_MSG_TYPE_CONFIRMABLE, 100));
+    }
+    LONGS_EQUAL(0, sent_count);
+}
+
+TEST(sn_coap_lookup, duplicate_answered)
+{
+    // A duplicated request is answered with the stored acknowledgement
+    LONGS_EQUAL(COAP_STATUS_OK, receive(&peers[3], COAP_MSG_TYPE_CONFIRMABLE, 7));
+    LONGS_EQUAL(COAP_STATUS_OK, receive(&peers[2], COAP_MSG_TYPE_CONFIRMABLE, 7));
+    send(&peers[3], COAP_MSG_TYPE_ACKNOWLEDGEMENT, 7);
+
+    LONGS_EQUAL(COAP_STATUS_PARSER_DUPLICATED_MSG, receive(&peers[2], COAP_MSG_TYPE_CONFIRMABLE, 7));
+    LONGS_EQUAL(0, sent_count);
+    LONGS_EQUAL(COAP_STATUS_PARSER_DUPLICATED_MSG, receive(&peers[3], COAP_MSG_TYPE_CONFIRMABLE, 7));
+    LONGS_EQUAL(1, sent_count);
+    LONGS_EQUAL(7, sent_ids[0]);
+}
+
+TEST(sn_coap_lookup, duplicates_evicted)
+{
+    LONGS_EQUAL(0, sn_coap_protocol_set_duplicate_buffer_size(handle, 4));
+
+    // The oldest info makes room for new ones
+    for (int i = 0; i < 5; i++) {
+        LONGS_EQUAL(COAP_STATUS_OK, receive(&peers[i], COAP_MSG_TYPE_CONFIRMABLE, 1));
+    }
+    LONGS_EQUAL(COAP_STATUS_PARSER_DUPLICATED_MSG, receive(&peers[4], COAP_MSG_TYPE_CONFIRMABLE, 1));
+    LONGS_EQUAL(COAP_STATUS_PARSER_DUPLICATED_MSG, receive(&peers[1], COAP_MSG_TYPE_CONFIRMABLE, 1));
+    LONGS_EQUAL(COAP_STATUS_OK, receive(&peers[0], COAP_MSG_TYPE_CONFIRMABLE, 1));
+
+    // And infos expire
+    sn_coap_protocol_exec(handle, 30);
+    LONGS_EQUAL(COAP_STATUS_OK, receive(&peers[5], COAP_MSG_TYPE_CONFIRMABLE, 1));
+    sn_coap_protocol_exec(handle, 70);
+    LONGS_EQUAL(COAP_STATUS_OK, receive(&peers[4], COAP_MSG_TYPE_CONFIRMABLE, 1));
+    LONGS_EQUAL(COAP_STATUS_PARSER_DUPLICATED_MSG, receive(&peers[5], COAP_MSG_TYPE_CONFIRMABLE, 1));
+}
+
+TEST(sn_coap_lookup, acknowledged)
+{
+    LONGS_EQUAL(0, sn_coap_protocol_set_retransmission_buffer(handle, 6, 0));
+
+    uint16_t ids[6];
+    for (int i = 0; i < 6; i++) {
+        ids[i] = send(&peers[i % 2], COAP_MSG_TYPE_CONFIRMABLE, 0);
+    }
+    sn_coap_hdr_s coap;
+    uint8_t packet[16];
+    memset(&coap, 0, sizeof(coap));
+    coap.msg_type = COAP_MSG_TYPE_CONFIRMABLE;
+    coap.msg_code = COAP_MSG_CODE_REQUEST_GET;
+    LONGS_EQUAL(-4, sn_coap_protocol_build(handle, &peers[0], packet, &coap, NULL));
+
+    // Only an acknowledgement from the right peer removes a message
+    receive(&peers[0], COAP_MSG_TYPE_ACKNOWLEDGEMENT, ids[1]);
+    receive(&peers[3], COAP_MSG_TYPE_ACKNOWLEDGEMENT, ids[1]);
+    receive(&peers[1], COAP_MSG_TYPE_ACKNOWLEDGEMENT, ids[3]);
+    receive(&peers[0], COAP_MSG_TYPE_RESET, ids[4]);
+    LONGS_EQUAL(-2, sn_coap_protocol_delete_retransmission(handle, ids[3]));
+    LONGS_EQUAL(-2, sn_coap_protocol_delete_retransmission(handle, ids[4]));
+    LONGS_EQUAL(0, sn_coap_protocol_delete_retransmission(handle, ids[1]));
+    LONGS_EQUAL(-2, sn_coap_protocol_delete_retransmission(handle, ids[1]));
+
+    // The others are still there, and room was made
+    LONGS_EQUAL(0, sn_coap_protocol_delete_retransmission(handle, ids[0]));
+    LONGS_EQUAL(0, sn_coap_protocol_delete_retransmission(handle, ids[5]));
+    send(&peers[0], COAP_MSG_TYPE_CONFIRMABLE, 0);
+    send(&peers[0], COAP_MSG_TYPE_CONFIRMABLE, 0);
+    LONGS_EQUAL(0, sent_count);
+}
+
+TEST(sn_coap_lookup, resending_order)
+{
+    LONGS_EQUAL(0, sn_coap_protocol_set_retransmission_parameters(handle, 1, 10));
+
+    sn_coap_protocol_exec(handle, 0);
+    uint16_t first = send(&peers[0], COAP_MSG_TYPE_CONFIRMABLE, 0);
+    sn_coap_protocol_exec(handle, 4);
+    uint16_t second = send(&peers[1], COAP_MSG_TYPE_CONFIRMABLE, 0);
+
+    // Messages are resent when they are due, once each
+    sn_coap_protocol_exec(handle, 9);
+    LONGS_EQUAL(0, sent_count);
+    sn_coap_protocol_exec(handle, 10);
+    LONGS_EQUAL(1, sent_count);
+    LONGS_EQUAL(first, sent_ids[0]);
+    sn_coap_protocol_exec(handle, 14);
+    LONGS_EQUAL(2, sent_count);
+    LONGS_EQUAL(second, sent_ids[1]);
+    sn_coap_protocol_exec(handle, 29);
+    LONGS_EQUAL(2, sent_count);
+
+    // And fail in the same order, after their last resending
+    sn_coap_protocol_exec(handle, 40);
+    LONGS_EQUAL(2, sent_count);
+    LONGS_EQUAL(2, failed_count);
+    LONGS_EQUAL(first, failed_ids[0]);
+    LONGS_EQUAL(second, failed_ids[1]);
+    LONGS_EQUAL(-2, sn_coap_protocol_delete_retransmission(handle, first));
+    LONGS_EQUAL(-2, sn_coap_protocol_delete_retransmission(handle, second));
+}
+
+TEST(sn_coap_lookup, cancelled_from_callback)
+{
+    sn_coap_protocol_exec(handle, 0);
+    send(&peers[0], COAP_MSG_TYPE_CONFIRMABLE, 0);
+    send(&peers[1], COAP_MSG_TYPE_CONFIRMABLE, 0);
+
+    // Both are due, the first sending cancels them both
+    cancel_all = true;
+    sn_coap_protocol_exec(handle, 100);
+    LONGS_EQUAL(1, sent_count);
+    sn_coap_protocol_exec(handle, 1000);
+    LONGS_EQUAL(1, sent_count);
+    LONGS_EQUAL(0, failed_count);
+}
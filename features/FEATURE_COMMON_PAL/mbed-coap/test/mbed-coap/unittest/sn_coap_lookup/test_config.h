@@ -0,0 +1,25 @@
+/*
+ * Copyright (c) 2017 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef TEST_CONFIG_H
+#define TEST_CONFIG_H
+
+#define SN_COAP_DUPLICATION_MAX_MSGS_COUNT              6
+#define SN_COAP_MAX_ALLOWED_DUPLICATION_MESSAGE_COUNT   32
+
+/* Fewer buckets than messages, so that they share buckets */
+#define SN_COAP_LOOKUP_HASH_SIZE                        4
+
+#endif // TEST_CONFIG_H
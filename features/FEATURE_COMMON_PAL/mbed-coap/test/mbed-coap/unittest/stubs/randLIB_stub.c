@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2017 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "randLIB.h"
+
+/* Not random at all, so message IDs and resending times are known */
+uint16_t randLIB_stub_16bit = 0x1000;
+
+void randLIB_seed_random(void)
+{
+}
+
+uint16_t randLIB_get_16bit(void)
+{
+    return randLIB_stub_16bit;
+}
+
+uint16_t randLIB_get_random_in_range(uint16_t min, uint16_t max)
+{
+    (void) max;
+    return min;
+}
@@ -119,33 +119,55 @@ extern "C" {
 #define TRACE_LEVEL_CMD           0x01
 
 #ifndef MBED_TRACE_MAX_LEVEL
+#ifdef MBED_CONF_MBED_TRACE_MAX_LEVEL
+#define MBED_TRACE_MAX_LEVEL MBED_CONF_MBED_TRACE_MAX_LEVEL
+#else
 #define MBED_TRACE_MAX_LEVEL TRACE_LEVEL_DEBUG
 #endif
+#endif
+
+/**
+ * Highest level compiled in for the TRACE_GROUP of a source file, at most
+ * MBED_TRACE_MAX_LEVEL. Define it before including mbed_trace.h, or #undef
+ * and redefine it next to TRACE_GROUP:
+ *
+ *      #define TRACE_GROUP  "main"
+ *      #undef TRACE_GROUP_MAX_LEVEL
+ *      #define TRACE_GROUP_MAX_LEVEL TRACE_LEVEL_INFO  // tr_debug() is compiled out
+ *
+ * Traces above it are removed by the compiler, along with their arguments.
+ */
+#ifndef TRACE_GROUP_MAX_LEVEL
+#define TRACE_GROUP_MAX_LEVEL MBED_TRACE_MAX_LEVEL
+#endif
+
+/** trace the given level if it is compiled in for the TRACE_GROUP of the file */
+#define MBED_TRACE_GROUP_TRACEF(dlevel, ...)    (((dlevel) <= TRACE_GROUP_MAX_LEVEL) ? mbed_tracef(dlevel, TRACE_GROUP, __VA_ARGS__) : (void) 0)
 
 //usage macros:
 #if MBED_TRACE_MAX_LEVEL >= TRACE_LEVEL_DEBUG
-#define tr_debug(...)           mbed_tracef(TRACE_LEVEL_DEBUG,   TRACE_GROUP, __VA_ARGS__)   //!< Print debug message
+#define tr_debug(...)           MBED_TRACE_GROUP_TRACEF(TRACE_LEVEL_DEBUG,   __VA_ARGS__)   //!< Print debug message
 #else
 #define tr_debug(...)
 #endif
 
 #if MBED_TRACE_MAX_LEVEL >= TRACE_LEVEL_INFO
-#define tr_info(...)            mbed_tracef(TRACE_LEVEL_INFO,    TRACE_GROUP, __VA_ARGS__)   //!< Print info message
+#define tr_info(...)            MBED_TRACE_GROUP_TRACEF(TRACE_LEVEL_INFO,    __VA_ARGS__)   //!< Print info message
 #else
 #define tr_info(...)
 #endif
 
 #if MBED_TRACE_MAX_LEVEL >= TRACE_LEVEL_WARN
-#define tr_warning(...)         mbed_tracef(TRACE_LEVEL_WARN,    TRACE_GROUP, __VA_ARGS__)   //!< Print warning message
-#define tr_warn(...)            mbed_tracef(TRACE_LEVEL_WARN,    TRACE_GROUP, __VA_ARGS__)   //!< Alternative warning message
+#define tr_warning(...)         MBED_TRACE_GROUP_TRACEF(TRACE_LEVEL_WARN,    __VA_ARGS__)   //!< Print warning message
+#define tr_warn(...)            MBED_TRACE_GROUP_TRACEF(TRACE_LEVEL_WARN,    __VA_ARGS__)   //!< Alternative warning message
 #else
 #define tr_warning(...)
 #define tr_warn(...)
 #endif
 
 #if MBED_TRACE_MAX_LEVEL >= TRACE_LEVEL_ERROR
-#define tr_error(...)           mbed_tracef(TRACE_LEVEL_ERROR,   TRACE_GROUP, __VA_ARGS__)   //!< Print Error Message
-#define tr_err(...)             mbed_tracef(TRACE_LEVEL_ERROR,   TRACE_GROUP, __VA_ARGS__)   //!< Alternative error message
+#define tr_error(...)           MBED_TRACE_GROUP_TRACEF(TRACE_LEVEL_ERROR,   __VA_ARGS__)   //!< Print Error Message
+#define tr_err(...)             MBED_TRACE_GROUP_TRACEF(TRACE_LEVEL_ERROR,   __VA_ARGS__)   //!< Alternative error message
 #else
 #define tr_error(...)
 #define tr_err(...)
@@ -286,6 +308,63 @@ void mbed_trace_include_filters_set(char* filters);
 /** get trace include filters
  */
 const char* mbed_trace_include_filters_get(void);
+/** Output queue statistics, see mbed_trace_output_stats_get() */
+typedef struct mbed_trace_output_stats_s {
+    /** lines queued for deferred output */
+    uint32_t queued;
+    /** lines dropped because the output queue was full */
+    uint32_t dropped;
+    /** lines dropped by the rate limiter */
+    uint32_t rate_limited;
+    /** highest number of bytes used in the output queue */
+    int queue_peak;
+} mbed_trace_output_stats_t;
+/**
+ * Defer trace output to a queue.
+ * Formatted lines are copied to a ring buffer instead of being given to
+ * the print function, and are printed later by mbed_trace_output_process(),
+ * typically from a low priority thread or event. Lines which do not fit in
+ * the queue are dropped, and replaced by a "lines dropped" notice as soon
+ * as there is room again. TRACE_LEVEL_CMD lines are always printed directly.
+ * e.g.:
+ *   static void trace_notify(void) { queue.call(mbed_trace_output_process); }
+ *   mbed_trace_output_queue_set(1024, trace_notify);
+ *
+ * @param size      queue size in bytes, each line takes its length + 2 bytes.
+ *                  0 frees the queue, without printing the lines still queued,
+ *                  and switches back to direct output.
+ * @param notify_f  function called when a line is queued in an empty queue, or NULL.
+ *                  It is called from the tracing thread with the trace mutex held,
+ *                  and should only signal the thread printing the queue.
+ * @return 0 when all success, otherwise non zero
+ */
+int mbed_trace_output_queue_set(int size, void (*notify_f)(void));
+/**
+ * Print the lines of the output queue with the print function.
+ * The trace mutex is released while a line is printed, so the tracing
+ * threads are not blocked by the output.
+ * @return number of lines printed
+ */
+int mbed_trace_output_process(void);
+/**
+ * Get output queue and rate limiter statistics
+ * @param stats     filled with the counters since the last mbed_trace_init()
+ */
+void mbed_trace_output_stats_get(mbed_trace_output_stats_t *stats);
+/**
+ * Limit the number of lines printed per trace group.
+ * At most lines traces of a group are printed in each period, the others are
+ * dropped before being formatted. Levels other than TRACE_LEVEL_CMD are limited.
+ * Up to MBED_TRACE_RATE_LIMIT_GROUPS groups are tracked at once, the least
+ * recently limited group is forgotten when a new group shows up.
+ * e.g.:
+ *   mbed_trace_rate_limit_set(10, 1000, my_time_ms);
+ *
+ * @param lines     lines allowed per period and group, 0 disables rate limiting
+ * @param period_ms length of the period in milliseconds
+ * @param time_ms_f function returning a free running millisecond counter
+ */
+void mbed_trace_rate_limit_set(uint16_t lines, uint32_t period_ms, uint32_t (*time_ms_f)(void));
 /**
  * General trace function
  * This should be used every time when user want to print out something important thing
@@ -398,6 +477,10 @@ char* mbed_trace_array(const uint8_t* buf, uint16_t len);
 #undef mbed_trace_exclude_filters_get
 #undef mbed_trace_include_filters_set
 #undef mbed_trace_include_filters_get
+#undef mbed_trace_output_queue_set
+#undef mbed_trace_output_process
+#undef mbed_trace_output_stats_get
+#undef mbed_trace_rate_limit_set
 #undef mbed_tracef
 #undef mbed_vtracef
 #undef mbed_trace_last
@@ -423,6 +506,10 @@ char* mbed_trace_array(const uint8_t* buf, uint16_t len);
 #define mbed_trace_exclude_filters_get(...)         ((const char *) 0)
 #define mbed_trace_include_filters_set(...)         ((void) 0)
 #define mbed_trace_include_filters_get(...)         ((const char *) 0)
+#define mbed_trace_output_queue_set(...)            ((int) 0)
+#define mbed_trace_output_process(...)              ((int) 0)
+#define mbed_trace_output_stats_get(...)            ((void) 0)
+#define mbed_trace_rate_limit_set(...)              ((void) 0)
 #define mbed_trace_last(...)                        ((const char *) 0)
 #define mbed_tracef(...)                            ((void) 0)
 #define mbed_vtracef(...)                           ((void) 0)
@@ -92,10 +92,46 @@
 #define DEFAULT_TRACE_CONFIG              TRACE_MODE_COLOR | TRACE_ACTIVE_LEVEL_ALL | TRACE_CARRIAGE_RETURN
 #endif
 
+/** number of trace groups whose filtering result is cached, 0 disables the cache.
+    The cache identifies groups by address, so it requires constant group strings,
+    such as the TRACE_GROUP of a source file. */
+#ifdef MBED_TRACE_GROUP_CACHE_SIZE
+#define DEFAULT_TRACE_GROUP_CACHE_SIZE    MBED_TRACE_GROUP_CACHE_SIZE
+#elif defined MBED_CONF_MBED_TRACE_GROUP_CACHE_SIZE
+#define DEFAULT_TRACE_GROUP_CACHE_SIZE    MBED_CONF_MBED_TRACE_GROUP_CACHE_SIZE
+#else
+#define DEFAULT_TRACE_GROUP_CACHE_SIZE    0
+#endif
+
+/** number of trace groups tracked by the rate limiter */
+#ifdef MBED_TRACE_RATE_LIMIT_GROUPS
+#define DEFAULT_TRACE_RATE_LIMIT_GROUPS   MBED_TRACE_RATE_LIMIT_GROUPS
+#else
+#define DEFAULT_TRACE_RATE_LIMIT_GROUPS   4
+#endif
+
+/** significant length of a trace group name for the rate limiter */
+#define TRACE_RATE_LIMIT_GROUP_LEN        8
+
+/** size of an output queue entry header, holding the line length */
+#define TRACE_QUEUE_HEADER_LEN            2
+
 /** default print function, just redirect str to printf */
 static void mbed_trace_realloc( char **buffer, int *length_ptr, int new_length);
 static void mbed_trace_default_print(const char *str);
 static void mbed_trace_reset_tmp(void);
+static void mbed_trace_group_cache_clear(void);
+static void mbed_trace_output(const char *str);
+static int8_t mbed_trace_rate_limited(const char *grp);
+
+typedef struct trace_rate_limit_s {
+    /** trace group, not null terminated when it is TRACE_RATE_LIMIT_GROUP_LEN long */
+    char grp[TRACE_RATE_LIMIT_GROUP_LEN];
+    /** start of the current period */
+    uint32_t period_start;
+    /** lines traced in the current period */
+    uint16_t count;
+} trace_rate_limit_t;
 
 typedef struct trace_s {
     /** trace configuration bits */
@@ -131,6 +167,43 @@ typedef struct trace_s {
     void (*mutex_release_f)(void);
     /** number of times the mutex has been locked */
     int mutex_lock_count;
+
+    /** deferred output queue, ring buffer of length prefixed lines */
+    uint8_t *queue;
+    /** output queue size */
+    int queue_size;
+    /** number of bytes used in the output queue */
+    int queue_used;
+    /** offset of the oldest line in the output queue */
+    int queue_read;
+    /** line printed from the output queue */
+    char *queue_line;
+    /** length of the line printed from the output queue */
+    int queue_line_length;
+    /** lines dropped since the last line queued */
+    uint32_t queue_dropped;
+    /** function called when a line is queued in an empty queue */
+    void (*queue_notify_f)(void);
+    /** output queue and rate limiter statistics */
+    mbed_trace_output_stats_t stats;
+
+    /** lines allowed per rate limiting period, 0 when rate limiting is disabled */
+    uint16_t rate_lines;
+    /** rate limiting period in milliseconds */
+    uint32_t rate_period_ms;
+    /** millisecond counter used by the rate limiter */
+    uint32_t (*rate_time_f)(void);
+    /** rate limited groups */
+    trace_rate_limit_t rate_groups[DEFAULT_TRACE_RATE_LIMIT_GROUPS];
+
+#if DEFAULT_TRACE_GROUP_CACHE_SIZE > 0
+    /** groups with a cached filtering result */
+    const char *group_cache[DEFAULT_TRACE_GROUP_CACHE_SIZE];
+    /** cached filtering results */
+    int8_t group_cache_skip[DEFAULT_TRACE_GROUP_CACHE_SIZE];
+    /** next cache entry to replace */
+    uint8_t group_cache_next;
+#endif
 } trace_t;
 
 static trace_t m_trace = {
@@ -148,7 +221,13 @@ static trace_t m_trace = {
     .cmd_printf = 0,
     .mutex_wait_f = 0,
     .mutex_release_f = 0,
-    .mutex_lock_count = 0
+    .mutex_lock_count = 0,
+    .queue = 0,
+    .queue_size = 0,
+    .queue_line = 0,
+    .queue_notify_f = 0,
+    .rate_lines = 0,
+    .rate_time_f = 0
 };
 
 int mbed_trace_init(void)
@@ -181,6 +260,8 @@ int mbed_trace_init(void)
     memset(m_trace.filters_exclude, 0, m_trace.filters_length);
     memset(m_trace.filters_include, 0, m_trace.filters_length);
     memset(m_trace.line, 0, m_trace.line_length);
+    memset(&m_trace.stats, 0, sizeof(m_trace.stats));
+    mbed_trace_group_cache_clear();
 
     return 0;
 }
@@ -191,6 +272,8 @@ void mbed_trace_free(void)
     MBED_TRACE_MEM_FREE(m_trace.tmp_data);
     MBED_TRACE_MEM_FREE(m_trace.filters_exclude);
     MBED_TRACE_MEM_FREE(m_trace.filters_include);
+    MBED_TRACE_MEM_FREE(m_trace.queue);
+    MBED_TRACE_MEM_FREE(m_trace.queue_line);
 
     // reset to default values
     m_trace.trace_config = DEFAULT_TRACE_CONFIG;
@@ -208,6 +291,17 @@ void mbed_trace_free(void)
     m_trace.mutex_wait_f = 0;
     m_trace.mutex_release_f = 0;
     m_trace.mutex_lock_count = 0;
+    m_trace.queue = 0;
+    m_trace.queue_size = 0;
+    m_trace.queue_used = 0;
+    m_trace.queue_read = 0;
+    m_trace.queue_line = 0;
+    m_trace.queue_line_length = 0;
+    m_trace.queue_dropped = 0;
+    m_trace.queue_notify_f = 0;
+    m_trace.rate_lines = 0;
+    m_trace.rate_period_ms = 0;
+    m_trace.rate_time_f = 0;
 }
 static void mbed_trace_realloc( char **buffer, int *length_ptr, int new_length)
 {
@@ -264,6 +358,7 @@ void mbed_trace_exclude_filters_set(char *filters)
     } else {
         m_trace.filters_exclude[0] = 0;
     }
+    mbed_trace_group_cache_clear();
 }
 const char *mbed_trace_exclude_filters_get(void)
 {
@@ -280,23 +375,268 @@ void mbed_trace_include_filters_set(char *filters)
     } else {
         m_trace.filters_include[0] = 0;
     }
+    mbed_trace_group_cache_clear();
+}
+static void mbed_trace_lock(void)
+{
+    if (m_trace.mutex_wait_f) {
+        m_trace.mutex_wait_f();
+    }
+}
+static void mbed_trace_unlock(void)
+{
+    if (m_trace.mutex_release_f) {
+        m_trace.mutex_release_f();
+    }
+}
+int mbed_trace_output_queue_set(int size, void (*notify_f)(void))
+{
+    uint8_t *queue = 0;
+    char *line = 0;
+    int line_length = m_trace.line_length;
+    int retval = 0;
+
+    if (size > 0 && size <= TRACE_QUEUE_HEADER_LEN) {
+        return -1;
+    }
+    if (size > 0) {
+        queue = MBED_TRACE_MEM_ALLOC(size);
+        line = MBED_TRACE_MEM_ALLOC(line_length);
+        if (queue == NULL || line == NULL) {
+            MBED_TRACE_MEM_FREE(queue);
+            MBED_TRACE_MEM_FREE(line);
+            queue = 0;
+            line = 0;
+            size = 0;
+            retval = -1;
+        }
+    } else {
+        size = 0;
+    }
+
+    mbed_trace_lock();
+    MBED_TRACE_MEM_FREE(m_trace.queue);
+    MBED_TRACE_MEM_FREE(m_trace.queue_line);
+    m_trace.queue = queue;
+    m_trace.queue_line = line;
+    m_trace.queue_line_length = line ? line_length : 0;
+    m_trace.queue_size = size;
+    m_trace.queue_used = 0;
+    m_trace.queue_read = 0;
+    m_trace.queue_dropped = 0;
+    m_trace.queue_notify_f = queue ? notify_f : 0;
+    mbed_trace_unlock();
+
+    return retval;
+}
+static void mbed_trace_queue_copy_in(int offset, const char *data, int len)
+{
+    int first = m_trace.queue_size - offset;
+    if (first > len) {
+        first = len;
+    }
+    memcpy(m_trace.queue + offset, data, first);
+    memcpy(m_trace.queue, data + first, len - first);
+}
+static void mbed_trace_queue_copy_out(int offset, char *data, int len)
+{
+    int first = m_trace.queue_size - offset;
+    if (first > len) {
+        first = len;
+    }
+    memcpy(data, m_trace.queue + offset, first);
+    memcpy(data + first, m_trace.queue, len - first);
+}
+static int mbed_trace_queue_put(const char *str, int len)
+{
+    uint8_t header[TRACE_QUEUE_HEADER_LEN];
+    int offset;
+
+    if (len + TRACE_QUEUE_HEADER_LEN > m_trace.queue_size - m_trace.queue_used) {
+        return -1;
+    }
+    offset = (m_trace.queue_read + m_trace.queue_used) % m_trace.queue_size;
+    header[0] = (uint8_t)len;
+    header[1] = (uint8_t)(len >> 8);
+    mbed_trace_queue_copy_in(offset, (const char *)header, TRACE_QUEUE_HEADER_LEN);
+    offset = (offset + TRACE_QUEUE_HEADER_LEN) % m_trace.queue_size;
+    mbed_trace_queue_copy_in(offset, str, len);
+    m_trace.queue_used += len + TRACE_QUEUE_HEADER_LEN;
+    if (m_trace.queue_used > m_trace.stats.queue_peak) {
+        m_trace.stats.queue_peak = m_trace.queue_used;
+    }
+    return 0;
+}
+/** queue a formatted line, called with the mutex held */
+static void mbed_trace_queue_line(const char *str)
+{
+    bool was_empty = m_trace.queue_used == 0;
+    int len = strlen(str);
+    // lines are truncated to what can be printed back
+    if (len > m_trace.queue_line_length - 1) {
+        len = m_trace.queue_line_length - 1;
+    }
+    if (len > m_trace.queue_size - TRACE_QUEUE_HEADER_LEN) {
+        len = m_trace.queue_size - TRACE_QUEUE_HEADER_LEN;
+    }
+    if (m_trace.queue_dropped) {
+        // tell about the lost lines where they were lost
+        char notice[40];
+        int notice_len = snprintf(notice, sizeof(notice), "%lu trace lines dropped", (unsigned long)m_trace.queue_dropped);
+        if (notice_len + len + 2 * TRACE_QUEUE_HEADER_LEN > m_trace.queue_size - m_trace.queue_used) {
+            m_trace.queue_dropped++;
+            m_trace.stats.dropped++;
+            return;
+        }
+        mbed_trace_queue_put(notice, notice_len);
+        m_trace.queue_dropped = 0;
+    }
+    if (mbed_trace_queue_put(str, len) != 0) {
+        m_trace.queue_dropped++;
+        m_trace.stats.dropped++;
+        return;
+    }
+    m_trace.stats.queued++;
+    if (was_empty && m_trace.queue_notify_f) {
+        m_trace.queue_notify_f();
+    }
+}
+static void mbed_trace_output(const char *str)
+{
+    if (m_trace.queue) {
+        mbed_trace_queue_line(str);
+    } else {
+        m_trace.printf(str);
+    }
+}
+int mbed_trace_output_process(void)
+{
+    int printed = 0;
+
+    for (;;) {
+        uint8_t header[TRACE_QUEUE_HEADER_LEN];
+        void (*print_f)(const char *);
+        char *line;
+        int len;
+
+        mbed_trace_lock();
+        if (m_trace.queue == NULL || m_trace.queue_used == 0 || !m_trace.printf) {
+            mbed_trace_unlock();
+            break;
+        }
+        mbed_trace_queue_copy_out(m_trace.queue_read, (char *)header, TRACE_QUEUE_HEADER_LEN);
+        len = header[0] | (header[1] << 8);
+        line = m_trace.queue_line;
+        mbed_trace_queue_copy_out((m_trace.queue_read + TRACE_QUEUE_HEADER_LEN) % m_trace.queue_size, line, len);
+        line[len] = 0;
+        m_trace.queue_read = (m_trace.queue_read + TRACE_QUEUE_HEADER_LEN + len) % m_trace.queue_size;
+        m_trace.queue_used -= TRACE_QUEUE_HEADER_LEN + len;
+        print_f = m_trace.printf;
+        mbed_trace_unlock();
+
+        // print without blocking the tracing threads. The queue line is only
+        // modified by mbed_trace_output_queue_set() or by this function, which
+        // are not expected to run concurrently.
+        print_f(line);
+        printed++;
+    }
+    return printed;
+}
+void mbed_trace_output_stats_get(mbed_trace_output_stats_t *stats)
+{
+    if (stats) {
+        mbed_trace_lock();
+        *stats = m_trace.stats;
+        mbed_trace_unlock();
+    }
+}
+void mbed_trace_rate_limit_set(uint16_t lines, uint32_t period_ms, uint32_t (*time_ms_f)(void))
+{
+    mbed_trace_lock();
+    m_trace.rate_lines = time_ms_f ? lines : 0;
+    m_trace.rate_period_ms = period_ms;
+    m_trace.rate_time_f = time_ms_f;
+    memset(m_trace.rate_groups, 0, sizeof(m_trace.rate_groups));
+    mbed_trace_unlock();
+}
+/** check the group against the rate limit, called with the mutex held */
+static int8_t mbed_trace_rate_limited(const char *grp)
+{
+    uint32_t now = m_trace.rate_time_f();
+    trace_rate_limit_t *entry = &m_trace.rate_groups[0];
+    int i;
+
+    for (i = 0; i < DEFAULT_TRACE_RATE_LIMIT_GROUPS; i++) {
+        trace_rate_limit_t *candidate = &m_trace.rate_groups[i];
+        if (strncmp(candidate->grp, grp, TRACE_RATE_LIMIT_GROUP_LEN) == 0) {
+            entry = candidate;
+            break;
+        }
+        // otherwise replace the group with the oldest period
+        if ((uint32_t)(now - candidate->period_start) > (uint32_t)(now - entry->period_start)) {
+            entry = candidate;
+        }
+    }
+    if (i == DEFAULT_TRACE_RATE_LIMIT_GROUPS) {
+        strncpy(entry->grp, grp, TRACE_RATE_LIMIT_GROUP_LEN);
+        entry->period_start = now;
+        entry->count = 0;
+    } else if ((uint32_t)(now - entry->period_start) >= m_trace.rate_period_ms) {
+        entry->period_start = now;
+        entry->count = 0;
+    }
+    if (entry->count >= m_trace.rate_lines) {
+        m_trace.stats.rate_limited++;
+        return 1;
+    }
+    entry->count++;
+    return 0;
+}
+static void mbed_trace_group_cache_clear(void)
+{
+#if DEFAULT_TRACE_GROUP_CACHE_SIZE > 0
+    memset(m_trace.group_cache, 0, sizeof(m_trace.group_cache));
+    m_trace.group_cache_next = 0;
+#endif
+}
+static int8_t mbed_trace_filtered(const char *grp)
+{
+    /// @TODO this could be much better..
+    if (m_trace.filters_exclude[0] != '\0' &&
+            strstr(m_trace.filters_exclude, grp) != 0) {
+        //grp was in exclude list
+        return 1;
+    }
+    if (m_trace.filters_include[0] != '\0' &&
+            strstr(m_trace.filters_include, grp) == 0) {
+        //grp was in include list
+        return 1;
+    }
+    return 0;
 }
 static int8_t mbed_trace_skip(int8_t dlevel, const char *grp)
 {
     if (dlevel >= 0 && grp != 0) {
         // filter debug prints only when dlevel is >0 and grp is given
-
-        /// @TODO this could be much better..
-        if (m_trace.filters_exclude[0] != '\0' &&
-                strstr(m_trace.filters_exclude, grp) != 0) {
-            //grp was in exclude list
-            return 1;
+        if (m_trace.filters_exclude[0] == '\0' && m_trace.filters_include[0] == '\0') {
+            return 0;
         }
-        if (m_trace.filters_include[0] != '\0' &&
-                strstr(m_trace.filters_include, grp) == 0) {
-            //grp was in include list
-            return 1;
+#if DEFAULT_TRACE_GROUP_CACHE_SIZE > 0
+        int i;
+        int8_t skip;
+        for (i = 0; i < DEFAULT_TRACE_GROUP_CACHE_SIZE; i++) {
+            if (m_trace.group_cache[i] == grp) {
+                return m_trace.group_cache_skip[i];
+            }
         }
+        skip = mbed_trace_filtered(grp);
+        m_trace.group_cache[m_trace.group_cache_next] = grp;
+        m_trace.group_cache_skip[m_trace.group_cache_next] = skip;
+        m_trace.group_cache_next = (m_trace.group_cache_next + 1) % DEFAULT_TRACE_GROUP_CACHE_SIZE;
+        return skip;
+#else
+        return mbed_trace_filtered(grp);
+#endif
     }
     return 0;
 }
@@ -329,6 +669,12 @@ void mbed_vtracef(uint8_t dlevel, const char* grp, const char *fmt, va_list ap)
         mbed_trace_reset_tmp();
         goto end;
     }
+    if (m_trace.rate_lines && dlevel != TRACE_LEVEL_CMD &&
+            ((m_trace.trace_config & TRACE_MASK_LEVEL) & dlevel) &&
+            mbed_trace_rate_limited(grp)) {
+        mbed_trace_reset_tmp();
+        goto end;
+    }
     if ((m_trace.trace_config & TRACE_MASK_LEVEL) &  dlevel) {
         bool color = (m_trace.trace_config & TRACE_MODE_COLOR) != 0;
         bool plain = (m_trace.trace_config & TRACE_MODE_PLAIN) != 0;
@@ -342,9 +688,12 @@ void mbed_vtracef(uint8_t dlevel, const char* grp, const char *fmt, va_list ap)
             if (dlevel == TRACE_LEVEL_CMD && m_trace.cmd_printf) {
                 m_trace.cmd_printf(m_trace.line);
                 m_trace.cmd_printf("\n");
+            } else if (dlevel == TRACE_LEVEL_CMD) {
+                //cmdline output is never deferred
+                m_trace.printf(m_trace.line);
             } else {
                 //print out whole data
-                m_trace.printf(m_trace.line);
+                mbed_trace_output(m_trace.line);
             }
         } else {
             if (color) {
@@ -469,7 +818,7 @@ void mbed_vtracef(uint8_t dlevel, const char* grp, const char *fmt, va_list ap)
                 }
             }
             //print out whole data
-            m_trace.printf(m_trace.line);
+            mbed_trace_output(m_trace.line);
         }
         //return tmp data pointer back to the beginning
         mbed_trace_reset_tmp();
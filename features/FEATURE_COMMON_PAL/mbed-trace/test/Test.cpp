@@ -474,3 +474,124 @@ TEST(trace, uninitialized)
     STRCMP_EQUAL("hello", buf);
 }
 
+
+static int notify_count = 0;
+void my_notify()
+{
+  notify_count++;
+}
+char outbuf[256];
+void myappend(const char* str)
+{
+  strcat(outbuf, str);
+  strcat(outbuf, "|");
+}
+TEST(trace, output_queue)
+{
+  mbed_trace_output_stats_t stats;
+  notify_count = 0;
+  outbuf[0] = 0;
+  mbed_trace_print_function_set( myappend );
+  CHECK(mbed_trace_output_queue_set(32, my_notify) == 0);
+
+  mbed_tracef(TRACE_LEVEL_DEBUG, "mygr", "first");
+  mbed_tracef(TRACE_LEVEL_DEBUG, "mygr", "second");
+  STRCMP_EQUAL("", outbuf);
+  STRCMP_EQUAL("second", mbed_trace_last());
+  CHECK(notify_count == 1);
+
+  CHECK(mbed_trace_output_process() == 2);
+  STRCMP_EQUAL("first|second|", outbuf);
+  CHECK(mbed_trace_output_process() == 0);
+
+  // lines not fitting in the queue are replaced by a notice
+  outbuf[0] = 0;
+  mbed_tracef(TRACE_LEVEL_DEBUG, "mygr", "0123456789012345678901234567");
+  mbed_tracef(TRACE_LEVEL_DEBUG, "mygr", "lost");
+  mbed_tracef(TRACE_LEVEL_DEBUG, "mygr", "lost");
+  CHECK(mbed_trace_output_process() == 1);
+  mbed_tracef(TRACE_LEVEL_DEBUG, "mygr", "back");
+  CHECK(mbed_trace_output_process() == 2);
+  STRCMP_EQUAL("0123456789012345678901234567|2 trace lines dropped|back|", outbuf);
+  CHECK(notify_count == 3);
+
+  mbed_trace_output_stats_get(&stats);
+  CHECK(stats.queued == 4);
+  CHECK(stats.dropped == 2);
+  CHECK(stats.queue_peak == 30);
+
+  // cmdline output is not deferred
+  outbuf[0] = 0;
+  mbed_tracef(TRACE_LEVEL_CMD, "mygr", "cmd");
+  STRCMP_EQUAL("cmd|", outbuf);
+
+  CHECK(mbed_trace_output_queue_set(0, NULL) == 0);
+  mbed_tracef(TRACE_LEVEL_DEBUG, "mygr", "direct");
+  STRCMP_EQUAL("cmd|direct|", outbuf);
+}
+static uint32_t fake_time_ms = 0;
+uint32_t my_time_ms()
+{
+  return fake_time_ms;
+}
+TEST(trace, rate_limit)
+{
+  mbed_trace_output_stats_t stats;
+  fake_time_ms = 1000;
+  mbed_trace_rate_limit_set(2, 100, my_time_ms);
+
+  mbed_tracef(TRACE_LEVEL_DEBUG, "mygr", "1");
+  STRCMP_EQUAL("1", buf);
+  mbed_tracef(TRACE_LEVEL_DEBUG, "mygr", "2");
+  STRCMP_EQUAL("2", buf);
+  mbed_tracef(TRACE_LEVEL_DEBUG, "mygr", "3");
+  STRCMP_EQUAL("2", buf);
+  mbed_tracef(TRACE_LEVEL_DEBUG, "grp2", "other");
+  STRCMP_EQUAL("other", buf);
+
+  fake_time_ms += 100;
+  mbed_tracef(TRACE_LEVEL_DEBUG, "mygr", "4");
+  STRCMP_EQUAL("4", buf);
+
+  mbed_trace_output_stats_get(&stats);
+  CHECK(stats.rate_limited == 1);
+
+  mbed_trace_rate_limit_set(0, 0, NULL);
+  mbed_tracef(TRACE_LEVEL_DEBUG, "mygr", "5");
+  mbed_tracef(TRACE_LEVEL_DEBUG, "mygr", "6");
+  STRCMP_EQUAL("6", buf);
+}
+TEST(trace, group_max_level)
+{
+#define TRACE_GROUP "mygr"
+#undef TRACE_GROUP_MAX_LEVEL
+#define TRACE_GROUP_MAX_LEVEL TRACE_LEVEL_INFO
+  int evaluated = 0;
+  tr_info("info %d", ++evaluated);
+  STRCMP_EQUAL("info 1", buf);
+  tr_debug("debug %d", ++evaluated);
+  STRCMP_EQUAL("info 1", buf);
+  CHECK(evaluated == 1);
+  tr_error("error");
+  STRCMP_EQUAL("error", buf);
+#undef TRACE_GROUP_MAX_LEVEL
+#define TRACE_GROUP_MAX_LEVEL MBED_TRACE_MAX_LEVEL
+  tr_debug("debug");
+  STRCMP_EQUAL("debug", buf);
+#undef TRACE_GROUP
+}
+TEST(trace, filters_change)
+{
+  // filtering results are not kept over filter changes
+  mbed_trace_exclude_filters_set((char*)"mygr");
+  mbed_tracef(TRACE_LEVEL_DEBUG, "mygr", "excluded");
+  mbed_tracef(TRACE_LEVEL_DEBUG, "grp2", "printed");
+  STRCMP_EQUAL("printed", buf);
+  mbed_trace_exclude_filters_set(0);
+  mbed_tracef(TRACE_LEVEL_DEBUG, "mygr", "not excluded");
+  STRCMP_EQUAL("not excluded", buf);
+  mbed_trace_include_filters_set((char*)"grp2");
+  mbed_tracef(TRACE_LEVEL_DEBUG, "mygr", "not included");
+  STRCMP_EQUAL("not excluded", buf);
+  mbed_trace_include_filters_set(0);
+}
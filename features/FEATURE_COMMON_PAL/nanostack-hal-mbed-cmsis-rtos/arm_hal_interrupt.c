@@ -4,12 +4,90 @@
 
 #include "arm_hal_interrupt.h"
 #include "arm_hal_interrupt_private.h"
+#include "ns_hal_init.h"
 #include "cmsis_os2.h"
 #include "mbed_rtos_storage.h"
+#include "platform/mbed_critical.h"
+#include "platform/mbed_cycle_counter.h"
 #include <mbed_assert.h>
 
 static uint8_t sys_irq_disable_counter;
 
+#if MBED_CONF_NANOSTACK_HAL_CRITICAL_SECTION_STATS
+static uint32_t critical_start;
+static uint32_t critical_count;
+static uint32_t critical_max_cycles;
+
+static void critical_stats_enter(void)
+{
+    critical_start = mbed_cycle_counter_read();
+}
+
+static void critical_stats_exit(void)
+{
+    uint32_t cycles = mbed_cycle_counter_read() - critical_start;
+    critical_count++;
+    if (cycles > critical_max_cycles) {
+        critical_max_cycles = cycles;
+    }
+}
+
+void ns_hal_critical_stats_get(ns_hal_critical_stats_t *stats)
+{
+    core_util_critical_section_enter();
+    stats->count = critical_count;
+    stats->max_cycles = critical_max_cycles;
+    core_util_critical_section_exit();
+    stats->max_ns = mbed_cycle_counter_to_ns(stats->max_cycles);
+}
+
+void ns_hal_critical_stats_reset(void)
+{
+    core_util_critical_section_enter();
+    critical_count = 0;
+    critical_max_cycles = 0;
+    core_util_critical_section_exit();
+}
+#else
+#define critical_stats_enter()  ((void)0)
+#define critical_stats_exit()   ((void)0)
+
+void ns_hal_critical_stats_get(ns_hal_critical_stats_t *stats)
+{
+    stats->count = 0;
+    stats->max_cycles = 0;
+    stats->max_ns = 0;
+}
+
+void ns_hal_critical_stats_reset(void)
+{
+}
+#endif
+
+#if MBED_CONF_NANOSTACK_HAL_CRITICAL_SECTION_IRQ
+
+void platform_critical_init(void)
+{
+}
+
+void platform_enter_critical(void)
+{
+    core_util_critical_section_enter();
+    if (sys_irq_disable_counter++ == 0) {
+        critical_stats_enter();
+    }
+}
+
+void platform_exit_critical(void)
+{
+    if (--sys_irq_disable_counter == 0) {
+        critical_stats_exit();
+    }
+    core_util_critical_section_exit();
+}
+
+#else
+
 static mbed_rtos_storage_mutex_t critical_mutex;
 static const osMutexAttr_t critical_mutex_attr = {
   .name = "nanostack_critical_mutex",
@@ -28,11 +106,17 @@ void platform_critical_init(void)
 void platform_enter_critical(void)
 {
     osMutexAcquire(critical_mutex_id, osWaitForever);
-    sys_irq_disable_counter++;
+    if (sys_irq_disable_counter++ == 0) {
+        critical_stats_enter();
+    }
 }
 
 void platform_exit_critical(void)
 {
-    --sys_irq_disable_counter;
+    if (--sys_irq_disable_counter == 0) {
+        critical_stats_exit();
+    }
     osMutexRelease(critical_mutex_id);
 }
+
+#endif
@@ -60,3 +60,44 @@ uint16_t platform_timer_get_remaining_slots(void)
     }
 }
 
+
+#ifdef NS_EVENTLOOP_USE_TICK_TIMER
+// Low resolution tick timer of the eventloop system timer, run by the queue
+// that dispatches the event loop so that it shares its sleep handling.
+static int tick_timer_id;
+static void (*tick_timer_cb)(void);
+
+static EventQueue *tick_timer_queue(void)
+{
+#if MBED_CONF_NANOSTACK_HAL_EVENT_LOOP_USE_MBED_EVENTS
+    return mbed_event_queue();
+#else
+    return mbed_highprio_event_queue();
+#endif
+}
+
+int8_t platform_tick_timer_register(void (*tick_timer_cb_handler)(void))
+{
+    tick_timer_cb = tick_timer_cb_handler;
+    return 0;
+}
+
+int8_t platform_tick_timer_start(uint32_t period_ms)
+{
+    if (tick_timer_id) {
+        return 0;
+    }
+    tick_timer_id = tick_timer_queue()->call_every(period_ms, tick_timer_cb);
+    return tick_timer_id ? 0 : -1;
+}
+
+int8_t platform_tick_timer_stop(void)
+{
+    if (!tick_timer_id) {
+        return -1;
+    }
+    tick_timer_queue()->cancel(tick_timer_id);
+    tick_timer_id = 0;
+    return 0;
+}
+#endif // NS_EVENTLOOP_USE_TICK_TIMER
@@ -40,6 +40,11 @@
 // Timeout for polling response from configuration store
 #define NVM_CB_POLLING_TIMEOUT 50
 
+// Minimum time in milliseconds between flushes to flash
+#ifndef MBED_CONF_NANOSTACK_HAL_NVM_FLUSH_INTERVAL
+#define MBED_CONF_NANOSTACK_HAL_NVM_FLUSH_INTERVAL 0
+#endif
+
 // Check if synchronous mode is enabled
 #define IS_SYNC_MODE(cs_ctx) ((cs_ctx)->capabilities.asynchronous_ops == 0)
 
@@ -78,6 +83,8 @@ typedef struct cfstore_context_s {
     platform_nvm_status client_status;      // status to be returned to client
     uint8_t *client_buf;                    // buffer provided by client
     uint16_t *client_buf_len;               // client buffer length
+    uint32_t flush_time;                    // eventOS ticks of the last flush
+    bool flushed;                           // whether flush_time is set
 } cs_context_t;
 
 ARM_CFSTORE_DRIVER *drv = &cfstore_driver;
@@ -88,10 +95,12 @@ static bool nvm_write_internal(cs_context_t *cf_context);
 static bool nvm_read_internal(cs_context_t *cf_context);
 static bool nvm_delete_internal(cs_context_t *cf_context);
 static bool nvm_close_internal(cs_context_t *cf_context);
+static void nvm_flush_internal(cs_context_t *cf_context);
 static bool nvm_status_check(cs_context_t *cf_context);
 static platform_nvm_status nvm_error_map(int32_t cs_error);
 static void nvm_fsm_timer_start(void);
 static void nvm_fsm_timer_cb(void *arg);
+static void nvm_flush_timer_cb(void *arg);
 
 /**
  * Configuration store callback
@@ -515,8 +524,6 @@ platform_nvm_status platform_nvm_flush(nvm_callback *callback, void *context)
 {
     tr_debug("platform_nvm_flush()");
 
-    int32_t ret;
-
     if (callback == NULL) {
         return PLATFORM_NVM_ERROR;
     }
@@ -530,12 +537,19 @@ platform_nvm_status platform_nvm_flush(nvm_callback *callback, void *context)
     cs_context_ptr->client_status = PLATFORM_NVM_OK;
     cs_context_ptr->state = NVM_STATE_FLUSHING;
 
-    ret = drv->Flush();
-
-    if(ret < ARM_DRIVER_OK) {
-        cs_context_ptr->state = NVM_STATE_FLUSH_DONE;
-        cs_context_ptr->client_status = nvm_error_map(ret);
+#if MBED_CONF_NANOSTACK_HAL_NVM_FLUSH_INTERVAL
+    uint32_t elapsed = eventOS_event_timer_ticks_to_ms(eventOS_event_timer_ticks() - cs_context_ptr->flush_time);
+    if (cs_context_ptr->flushed && elapsed < MBED_CONF_NANOSTACK_HAL_NVM_FLUSH_INTERVAL) {
+        // flushed recently, flush later along with the changes queued meanwhile
+        cs_context_ptr->callback_timer = eventOS_timeout_ms(nvm_flush_timer_cb,
+                MBED_CONF_NANOSTACK_HAL_NVM_FLUSH_INTERVAL - elapsed, NULL);
+        if (cs_context_ptr->callback_timer) {
+            return PLATFORM_NVM_OK;
+        }
     }
+#endif
+
+    nvm_flush_internal(cs_context_ptr);
 
     // start callback timer in both asynch and synch mode
     nvm_fsm_timer_start();
@@ -543,6 +557,27 @@ platform_nvm_status platform_nvm_flush(nvm_callback *callback, void *context)
     return PLATFORM_NVM_OK;
 }
 
+static void nvm_flush_internal(cs_context_t *cf_context)
+{
+    int32_t ret;
+
+    cf_context->flush_time = eventOS_event_timer_ticks();
+    cf_context->flushed = true;
+    ret = drv->Flush();
+
+    if(ret < ARM_DRIVER_OK) {
+        cf_context->state = NVM_STATE_FLUSH_DONE;
+        cf_context->client_status = nvm_error_map(ret);
+    }
+}
+
+static void nvm_flush_timer_cb(void *args)
+{
+    (void) args;
+    nvm_flush_internal(cs_context_ptr);
+    nvm_fsm_timer_start();
+}
+
 static bool nvm_write_internal(cs_context_t *cf_context)
 {
     int32_t ret;
@@ -14,6 +14,7 @@
 
 #define TRACE_GROUP "evlp"
 
+#if !MBED_CONF_NANOSTACK_HAL_EVENT_LOOP_USE_MBED_EVENTS
 static void event_loop_thread(void *arg);
 
 static uint64_t event_thread_stk[MBED_CONF_NANOSTACK_HAL_EVENT_LOOP_THREAD_STACK_SIZE/8];
@@ -27,6 +28,7 @@ static const osThreadAttr_t event_thread_attr = {
     .cb_size = sizeof event_thread_tcb,
 };
 static osThreadId_t event_thread_id;
+#endif
 static mbed_rtos_storage_mutex_t event_mutex;
 static const osMutexAttr_t event_mutex_attr = {
   .name = "nanostack_event_mutex",
@@ -61,6 +63,7 @@ uint8_t eventOS_scheduler_mutex_is_owner(void)
     return osThreadGetId() == event_mutex_owner_id ? 1 : 0;
 }
 
+#if !MBED_CONF_NANOSTACK_HAL_EVENT_LOOP_USE_MBED_EVENTS
 void eventOS_scheduler_signal(void)
 {
     // XXX why does signal set lock if called with irqs disabled?
@@ -84,14 +87,19 @@ static void event_loop_thread(void *arg)
     eventOS_scheduler_mutex_wait();
     eventOS_scheduler_run(); //Does not return
 }
+#endif
 
 void ns_event_loop_thread_create(void)
 {
     event_mutex_id = osMutexNew(&event_mutex_attr);
     MBED_ASSERT(event_mutex_id != NULL);
 
+#if MBED_CONF_NANOSTACK_HAL_EVENT_LOOP_USE_MBED_EVENTS
+    ns_event_loop_queue_create();
+#else
     event_thread_id = osThreadNew(event_loop_thread, NULL, &event_thread_attr);
     MBED_ASSERT(event_thread_id != NULL);
+#endif
 }
 
 void ns_event_loop_thread_start(void)
@@ -9,6 +9,10 @@ extern "C" {
 void ns_event_loop_thread_create(void);
 void ns_event_loop_thread_start(void);
 
+/* Internal: binds the event loop to the shared event queue, when
+ * nanostack-hal.event_loop_use_mbed_events is set */
+void ns_event_loop_queue_create(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2017 ARM Limited, All Rights Reserved
+ */
+
+#include "mbed.h"
+
+#include "eventOS_scheduler.h"
+
+#include "ns_event_loop.h"
+
+#if MBED_CONF_NANOSTACK_HAL_EVENT_LOOP_USE_MBED_EVENTS
+
+// Tasklet events are dispatched one per queue callback, so that the other
+// users of the shared queue are not held off by a burst of Nanostack events.
+static void event_loop_dispatch(void);
+
+static StaticEvent<void (*)(void)> *dispatch_event;
+
+static void event_loop_dispatch(void)
+{
+    eventOS_scheduler_mutex_wait();
+    bool dispatched = eventOS_scheduler_dispatch_event();
+    eventOS_scheduler_mutex_release();
+
+    if (dispatched) {
+        dispatch_event->post();
+    }
+}
+
+// Called from any context, including interrupts. Posting an event that is
+// already pending is a no-op, so signals collapse into one dispatch.
+void eventOS_scheduler_signal(void)
+{
+    if (dispatch_event) {
+        dispatch_event->post();
+    }
+}
+
+// Only reached through eventOS_scheduler_run(), which has no use here: let
+// the other threads run until the next signal.
+void eventOS_scheduler_idle(void)
+{
+    eventOS_scheduler_mutex_release();
+    osThreadYield();
+    eventOS_scheduler_mutex_wait();
+}
+
+void ns_event_loop_queue_create(void)
+{
+    EventQueue *equeue = mbed_event_queue();
+    MBED_ASSERT(equeue != NULL);
+
+    dispatch_event = new StaticEvent<void (*)(void)>(equeue, event_loop_dispatch);
+    // Events may have been queued before the loop was bound
+    dispatch_event->post();
+}
+
+#endif // MBED_CONF_NANOSTACK_HAL_EVENT_LOOP_USE_MBED_EVENTS
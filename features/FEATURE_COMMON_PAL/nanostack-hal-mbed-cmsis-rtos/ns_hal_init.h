@@ -6,6 +6,7 @@
 #define NS_HAL_INIT_H_
 
 #include <stddef.h>
+#include <stdint.h>
 #include "nsdynmemLIB.h"
 
 #ifdef __cplusplus
@@ -28,6 +29,27 @@ extern "C" {
  */
 void ns_hal_init(void *heap, size_t h_size, void (*passed_fptr)(heap_fail_t), mem_stat_t *info_ptr);
 
+/** Statistics of the Nanostack critical sections */
+typedef struct {
+    uint32_t count;         /**< Outermost critical sections exited */
+    uint32_t max_cycles;    /**< Longest critical section, in mbed_cycle_counter counts */
+    uint32_t max_ns;        /**< Longest critical section in nanoseconds */
+} ns_hal_critical_stats_t;
+
+/**
+ * Get the statistics of platform_enter_critical/platform_exit_critical.
+ *
+ * They are only gathered when nanostack-hal.critical_section_stats is set,
+ * all the fields read 0 otherwise.
+ */
+void ns_hal_critical_stats_get(ns_hal_critical_stats_t *stats);
+
+/**
+ * Clear the critical section statistics, for example to measure from the
+ * end of network bootstrap on.
+ */
+void ns_hal_critical_stats_reset(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -22,11 +22,14 @@ extern "C" {
 #include "ns_types.h"
 
 #define MAX_IPV6_STRING_LEN_WITH_TRAILING_NULL 40
+#define MAX_IPV6_PREFIX_STRING_LEN_WITH_TRAILING_NULL 44
 
 /**
  * Print binary IPv6 address to a string.
  *
- * String must contain enough room for full address, 40 bytes exact.
+ * String must contain enough room for full address, 40 bytes exact
+ * (MAX_IPV6_STRING_LEN_WITH_TRAILING_NULL). The address is compressed as
+ * RFC 5952 recommends, in a single pass and without stdio.
  * IPv4 tunneling addresses are not covered.
  *
  * \param ip6addr IPv6 address.
@@ -38,7 +41,8 @@ uint_fast8_t ip6tos(const void *ip6addr, char *p);
 /**
  * Print binary IPv6 prefix to a string.
  *
- * String buffer `p` must contain enough room for a full address and prefix length, 44 bytes exact.
+ * String buffer `p` must contain enough room for a full address and prefix length, 44 bytes exact
+ * (MAX_IPV6_PREFIX_STRING_LEN_WITH_TRAILING_NULL).
  * Bits in the `prefix` buffer beyond `prefix_len` bits are not shown and only the bytes containing the
  * prefix bits are read. I.e. for a 20 bit prefix 3 bytes are read, and for a 0 bit prefix 0 bytes are
  * read (thus if `prefix_len` is zero, `prefix` can be NULL).
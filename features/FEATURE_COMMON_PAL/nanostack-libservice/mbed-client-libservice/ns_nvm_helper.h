@@ -27,6 +27,16 @@
  * When client deletes a key this module will:
  * -initialize the NVM if not initialized
  * -delete the key from NVM
+ *
+ * Requests are handled one at a time, in order. While earlier requests are in progress:
+ * -a write to a key that is still queued to be written stores the data of the later
+ *  write instead, and both callbacks are called once it is flushed
+ * -consecutive writes and deletes are flushed once, after the last of them, and all their
+ *  callbacks are called once the flush completes
+ *
+ * Counters that must never repeat a value after reset, like frame counters, can be kept
+ * with ns_nvm_counter_init and ns_nvm_counter_use, which only write to NVM once per
+ * reserved range of values.
  */
 
 /*
@@ -84,3 +94,60 @@ int ns_nvm_data_read(ns_nvm_callback *callback, const char *key_name, uint8_t *b
  * \return provided callback function will be called with status indicating success or failure.
  */
 int ns_nvm_data_write(ns_nvm_callback *callback, const char *key_name, uint8_t *buf, uint16_t *buf_len, void *context);
+
+/**
+ * Counter kept in NVM with reserved increments
+ *
+ * Only the end of a range of values reserved for the counter is stored. The next range
+ * is written once half of the current one is used, so the write has the other half to
+ * complete. After reset the counter continues from the end of the last range stored,
+ * skipping the values left in it, and never repeats a value used before.
+ *
+ * Members are managed by ns_nvm_counter_init and ns_nvm_counter_use, except start which
+ * the owner reads once initialization completes.
+ */
+typedef struct ns_nvm_counter {
+    uint32_t start;             /**< first value to use after initialization */
+    const char *key_name;
+    uint32_t reserve;
+    uint32_t limit;             /**< end of the range stored in NVM */
+    uint32_t writing_limit;     /**< end of the range being written, 0 if none */
+    ns_nvm_callback *callback;
+    void *context;
+    uint8_t buf[4];
+    uint16_t buf_len;
+} ns_nvm_counter_t;
+
+/**
+ * \brief Initialize a counter kept in NVM
+ *
+ * Reads the end of the last range reserved from NVM and reserves a range from there.
+ * counter->start is then the first value to use.
+ *
+ * \param callback function to be called when the first range is reserved
+ * \param key_name Name of the key storing the counter
+ * \param counter counter to initialize, which must stay valid while used
+ * \param reserve Number of values reserved by each write to NVM, at least 2. The writes
+ *        slow down as the reserve grows, and a reset skips up to this many values
+ * \param context argument will be provided as an argument when callback is called
+ *
+ * \return NS_NVM_OK if initialization is in progress and callback will be called
+ * \return NS_NVM_ERROR in error case, callback will not be called
+ * \return provided callback function will be called with status indicating success or failure.
+ */
+int ns_nvm_counter_init(ns_nvm_callback *callback, const char *key_name, ns_nvm_counter_t *counter, uint32_t reserve, void *context);
+
+/**
+ * \brief Check that a counter value may be used
+ *
+ * Values must be used in increasing order. Reserves the next range in NVM once half of
+ * the current one is used.
+ *
+ * \param counter counter initialized with ns_nvm_counter_init
+ * \param value Value about to be used
+ *
+ * \return NS_NVM_OK if the value is reserved in NVM and may be used
+ * \return NS_NVM_ERROR if the value is not reserved yet, because writing the next range
+ *         failed or has not completed. The value must not be used.
+ */
+int ns_nvm_counter_use(ns_nvm_counter_t *counter, uint32_t value);
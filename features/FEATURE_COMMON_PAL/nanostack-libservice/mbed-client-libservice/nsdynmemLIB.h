@@ -37,6 +37,30 @@ extern "C" {
 typedef uint16_t ns_mem_block_size_t; //external interface unsigned heap block size type
 typedef uint16_t ns_mem_heap_size_t; //total heap size type.
 
+/*
+ * Size-class bins in front of the heap. When NS_DYN_MEM_BIN_COUNT is not 0,
+ * allocations of up to NS_DYN_MEM_BIN_COUNT * NS_DYN_MEM_BIN_GRANULE bytes are
+ * rounded up to a multiple of NS_DYN_MEM_BIN_GRANULE. Freed blocks of those
+ * sizes are kept in a free list per size, up to NS_DYN_MEM_BIN_MAX_CACHED
+ * each, instead of being merged back into the heap, and allocations of the
+ * same size take them without searching the heap. The cached blocks are
+ * returned to the heap when an allocation would otherwise fail.
+ *
+ * The options change mem_stat_t, so they must be the same for the library
+ * and its users.
+ */
+#ifndef NS_DYN_MEM_BIN_COUNT
+#define NS_DYN_MEM_BIN_COUNT 0
+#endif
+
+#ifndef NS_DYN_MEM_BIN_GRANULE
+#define NS_DYN_MEM_BIN_GRANULE 16
+#endif
+
+#ifndef NS_DYN_MEM_BIN_MAX_CACHED
+#define NS_DYN_MEM_BIN_MAX_CACHED 8
+#endif
+
 /*!
  * \enum heap_fail_t
  * \brief Dynamically heap system failure call back event types.
@@ -62,6 +86,13 @@ typedef struct mem_stat_t {
     ns_mem_heap_size_t heap_sector_allocated_bytes_max;    /**< Reserved Heap data in bytes max value. */
     uint32_t heap_alloc_total_bytes;            /**< Total Heap allocated bytes. */
     uint32_t heap_alloc_fail_cnt;               /**< Counter for Heap allocation fail. */
+#if NS_DYN_MEM_BIN_COUNT > 0
+    /*Size-class bin stats, bin i holding blocks of (i + 1) * NS_DYN_MEM_BIN_GRANULE bytes*/
+    ns_mem_heap_size_t heap_bin_alloc_cnt[NS_DYN_MEM_BIN_COUNT];  /**< Reserved blocks of each size class. */
+    ns_mem_heap_size_t heap_bin_cached_cnt[NS_DYN_MEM_BIN_COUNT]; /**< Free blocks kept in each bin. */
+    uint32_t heap_bin_hit_cnt;                  /**< Counter for allocations served from a bin. */
+    uint32_t heap_bin_flush_cnt;                /**< Counter for bins returned to the heap by a failing allocation. */
+#endif
 } mem_stat_t;
 
 
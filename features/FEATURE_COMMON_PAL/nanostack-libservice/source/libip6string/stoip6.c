@@ -19,7 +19,7 @@
 #include "common_functions.h"
 #include "ip6string.h"
 
-static uint16_t hex(const char *p);
+static uint_fast8_t hex_value(char c);
 
 /**
  * Convert numeric IPv6 address string to a binary.
@@ -31,7 +31,7 @@ static uint16_t hex(const char *p);
 void stoip6(const char *ip6addr, size_t len, void *dest)
 {
     uint8_t *addr;
-    const char *p, *q;
+    const char *p, *end;
     int_fast8_t field_no, coloncolon = -1;
 
     addr = dest;
@@ -40,20 +40,28 @@ void stoip6(const char *ip6addr, size_t len, void *dest)
         return;
     }
 
-    // First go forward the string, until end, noting :: position if any
-    for (field_no = 0, p = ip6addr; (len > (size_t)(p - ip6addr)) && *p && field_no < 8; p = q + 1) {
-        q = p;
-        // Seek for ':' or end
-        while (*q && (*q != ':')) {
-            q++;
+    // Go forward the string once, until end, noting :: position if any
+    for (field_no = 0, p = ip6addr, end = ip6addr + len; p < end && *p && field_no < 8; p++) {
+        uint16_t part = 0;
+        uint_fast8_t digit;
+
+        // Convert the hex digits of this part, ignoring anything else up to ':' or end
+        while (p < end && (digit = hex_value(*p)) < 16) {
+            part = (part << 4) | digit;
+            p++;
+        }
+        while (p < end && *p && *p != ':') {
+            p++;
         }
-        //Convert and write this part, (high-endian AKA network byte order)
-        addr = common_write_16_bit(hex(p), addr);
+        //Write this part, (high-endian AKA network byte order)
+        addr = common_write_16_bit(part, addr);
         field_no++;
         //Check if we reached "::"
-        if ((len > (size_t)(q - ip6addr)) && *q && (q[0] == ':') && (q[1] == ':')) {
+        if (p + 1 < end && p[0] == ':' && p[1] == ':') {
             coloncolon = field_no;
-            q++;
+            p++;
+        } else if (p >= end || !*p) {
+            break;
         }
     }
 
@@ -78,21 +86,14 @@ unsigned char  sipv6_prefixlength(const char *ip6addr)
     }
     return 0;
 }
-static uint16_t hex(const char *p)
+static uint_fast8_t hex_value(char c)
 {
-    uint16_t val = 0;
-
-    for (;;) {
-        char c = *p++;
-        if ((c >= '0') && (c <= '9')) {
-            val = (val << 4) | (c - '0');
-        } else if ((c >= 'A') && (c <= 'F')) {
-            val = (val << 4) | (10 + (c - 'A'));
-        } else if ((c >= 'a') && (c <= 'f')) {
-            val = (val << 4) | (10 + (c - 'a'));
-        } else {
-            break; // Non hex character
-        }
+    if ((uint8_t)(c - '0') <= 9) {
+        return c - '0';
+    }
+    c |= 0x20; // lower case
+    if ((uint8_t)(c - 'a') <= 5) {
+        return 10 + (c - 'a');
     }
-    return val;
+    return 16; // Non hex character
 }
@@ -41,6 +41,10 @@ struct ns_mem_book {
     void (*heap_failure_callback)(heap_fail_t);
     NS_LIST_HEAD(hole_t, link) holes_list;
     ns_mem_heap_size_t heap_size;
+#if NS_DYN_MEM_BIN_COUNT > 0
+    NS_LIST_HEAD(hole_t, link) bins[NS_DYN_MEM_BIN_COUNT];
+    uint8_t bin_cached_cnt[NS_DYN_MEM_BIN_COUNT];
+#endif
 };
 
 static ns_mem_book_t *default_book; // heap pointer for original "ns_" API use
@@ -48,6 +52,16 @@ static ns_mem_book_t *default_book; // heap pointer for original "ns_" API use
 // size of a hole_t in our word units
 #define HOLE_T_SIZE ((sizeof(hole_t) + sizeof(ns_mem_word_size_t) - 1) / sizeof(ns_mem_word_size_t))
 
+#if NS_DYN_MEM_BIN_COUNT > 0
+// size of the size class granule and of the blocks of a bin in our word units
+#define BIN_GRANULE_SIZE ((ns_mem_word_size_t)(NS_DYN_MEM_BIN_GRANULE / sizeof(ns_mem_word_size_t)))
+#define BIN_DATA_SIZE(bin) (((bin) + 1) * BIN_GRANULE_SIZE)
+
+// Cached blocks are linked through their data area, like holes
+NS_STATIC_ASSERT(NS_DYN_MEM_BIN_GRANULE % sizeof(ns_mem_word_size_t) == 0, "NS_DYN_MEM_BIN_GRANULE must be a multiple of the heap word")
+NS_STATIC_ASSERT(NS_DYN_MEM_BIN_GRANULE >= sizeof(hole_t), "NS_DYN_MEM_BIN_GRANULE too small")
+#endif
+
 static NS_INLINE hole_t *hole_from_block_start(ns_mem_word_size_t *start)
 {
     return (hole_t *)(start + 1);
@@ -117,6 +131,12 @@ ns_mem_book_t *ns_mem_init(void *heap, ns_mem_heap_size_t h_size,
 
     ns_list_init(&book->holes_list);
     ns_list_add_to_start(&book->holes_list, hole_from_block_start(book->heap_main));
+#if NS_DYN_MEM_BIN_COUNT > 0
+    for (int bin = 0; bin < NS_DYN_MEM_BIN_COUNT; bin++) {
+        ns_list_init(&book->bins[bin]);
+        book->bin_cached_cnt[bin] = 0;
+    }
+#endif
 
     book->mem_stat_info_ptr = info_ptr;
     //RESET Memory by Hea Len
@@ -191,27 +211,14 @@ static int8_t ns_mem_block_validate(ns_mem_word_size_t *block_start, int directi
     }
     return ret_val;
 }
-#endif
 
-// For direction, use 1 for direction up and -1 for down
-static void *ns_mem_internal_alloc(ns_mem_book_t *book, const ns_mem_block_size_t alloc_size, int direction)
+// Takes a block of at least data_size words from the first hole big enough,
+// searching from the start of the heap for direction up and from its end for
+// down. The size of the block is left in its length indicators.
+static ns_mem_word_size_t *ns_mem_hole_alloc(ns_mem_book_t *book, ns_mem_word_size_t data_size, int direction)
 {
-#ifndef STANDARD_MALLOC
-    if (!book) {
-        /* We can not do anything except return NULL because we can't find book
-           keeping block */
-        return NULL;
-    }
-
     ns_mem_word_size_t *block_ptr = NULL;
 
-    platform_enter_critical();
-
-    ns_mem_word_size_t data_size = convert_allocation_size(book, alloc_size);
-    if (!data_size) {
-        goto done;
-    }
-
     // ns_list_foreach, either forwards or backwards, result to ptr
     for (hole_t *cur_hole = direction > 0 ? ns_list_get_first(&book->holes_list)
                                           : ns_list_get_last(&book->holes_list);
@@ -233,7 +240,7 @@ static void *ns_mem_internal_alloc(ns_mem_book_t *book, const ns_mem_block_size_
     }
 
     if (!block_ptr) {
-        goto done;
+        return NULL;
     }
 
     ns_mem_word_size_t block_data_size = -*block_ptr;
@@ -270,11 +277,170 @@ static void *ns_mem_internal_alloc(ns_mem_book_t *book, const ns_mem_block_size_
     block_ptr[0] = data_size;
     block_ptr[1 + data_size] = data_size;
 
+    return block_ptr;
+}
+
+#if NS_DYN_MEM_BIN_COUNT > 0
+static void ns_mem_free_and_merge_with_adjacent_blocks(ns_mem_book_t *book, ns_mem_word_size_t *cur_block, ns_mem_word_size_t data_size);
+
+// Cached blocks keep their positive (allocated) length indicators, so that
+// they are never merged with adjacent holes while in a bin.
+
+// Returns the size class an allocation of data_size words is rounded up to,
+// or -1 if it is served by the heap alone
+static int ns_mem_bin_index(ns_mem_word_size_t data_size)
+{
+    int bin = (data_size - 1) / BIN_GRANULE_SIZE;
+    return bin < NS_DYN_MEM_BIN_COUNT ? bin : -1;
+}
+
+// Returns the size class of a block, or -1 if its size is not one of them
+static int ns_mem_bin_of_block(ns_mem_word_size_t data_size)
+{
+    int bin = ns_mem_bin_index(data_size);
+    if (bin >= 0 && data_size != BIN_DATA_SIZE(bin)) {
+        bin = -1;
+    }
+    return bin;
+}
+
+static ns_mem_word_size_t *ns_mem_bin_get(ns_mem_book_t *book, int bin)
+{
+    hole_t *cached = ns_list_get_first(&book->bins[bin]);
+    if (!cached) {
+        return NULL;
+    }
+
+    ns_mem_word_size_t *block_ptr = block_start_from_hole(cached);
+    if (ns_mem_block_validate(block_ptr, 1) != 0 || *block_ptr != BIN_DATA_SIZE(bin)) {
+        heap_failure(book, NS_DYN_MEM_HEAP_SECTOR_CORRUPTED);
+        return NULL;
+    }
+
+    ns_list_remove(&book->bins[bin], cached);
+    book->bin_cached_cnt[bin]--;
+    if (book->mem_stat_info_ptr) {
+        book->mem_stat_info_ptr->heap_bin_cached_cnt[bin]--;
+        book->mem_stat_info_ptr->heap_bin_hit_cnt++;
+    }
+    return block_ptr;
+}
+
+// Keeps a freed block in its bin. Returns false if the block is to be
+// returned to the heap instead.
+static bool ns_mem_bin_put(ns_mem_book_t *book, ns_mem_word_size_t *block_ptr, ns_mem_word_size_t data_size)
+{
+    int bin = ns_mem_bin_of_block(data_size);
+    if (bin < 0) {
+        return false;
+    }
+
+    if (book->mem_stat_info_ptr) {
+        book->mem_stat_info_ptr->heap_bin_alloc_cnt[bin]--;
+    }
+    if (book->bin_cached_cnt[bin] >= NS_DYN_MEM_BIN_MAX_CACHED) {
+        return false;
+    }
+
+    ns_list_add_to_start(&book->bins[bin], hole_from_block_start(block_ptr));
+    book->bin_cached_cnt[bin]++;
+    if (book->mem_stat_info_ptr) {
+        book->mem_stat_info_ptr->heap_bin_cached_cnt[bin]++;
+    }
+    return true;
+}
+
+// A cached block still looks allocated: look it up to catch a double free.
+// Bins are short, so this is bounded by NS_DYN_MEM_BIN_MAX_CACHED.
+static bool ns_mem_bin_is_cached(ns_mem_book_t *book, ns_mem_word_size_t *block_ptr, ns_mem_word_size_t data_size)
+{
+    int bin = ns_mem_bin_of_block(data_size);
+    if (bin >= 0) {
+        ns_list_foreach(hole_t, cached, &book->bins[bin]) {
+            if (cached == hole_from_block_start(block_ptr)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// Returns all cached blocks to the heap. Returns false if there were none.
+static bool ns_mem_bins_flush(ns_mem_book_t *book)
+{
+    bool flushed = false;
+
+    for (int bin = 0; bin < NS_DYN_MEM_BIN_COUNT; bin++) {
+        ns_list_foreach_safe(hole_t, cached, &book->bins[bin]) {
+            ns_list_remove(&book->bins[bin], cached);
+            ns_mem_free_and_merge_with_adjacent_blocks(book, block_start_from_hole(cached), BIN_DATA_SIZE(bin));
+            flushed = true;
+        }
+        book->bin_cached_cnt[bin] = 0;
+        if (book->mem_stat_info_ptr) {
+            book->mem_stat_info_ptr->heap_bin_cached_cnt[bin] = 0;
+        }
+    }
+
+    if (flushed && book->mem_stat_info_ptr) {
+        book->mem_stat_info_ptr->heap_bin_flush_cnt++;
+    }
+    return flushed;
+}
+#endif
+#endif
+
+// For direction, use 1 for direction up and -1 for down
+static void *ns_mem_internal_alloc(ns_mem_book_t *book, const ns_mem_block_size_t alloc_size, int direction)
+{
+#ifndef STANDARD_MALLOC
+    if (!book) {
+        /* We can not do anything except return NULL because we can't find book
+           keeping block */
+        return NULL;
+    }
+
+    ns_mem_word_size_t *block_ptr = NULL;
+
+    platform_enter_critical();
+
+    ns_mem_word_size_t data_size = convert_allocation_size(book, alloc_size);
+    if (!data_size) {
+        goto done;
+    }
+
+#if NS_DYN_MEM_BIN_COUNT > 0
+    int bin = ns_mem_bin_index(data_size);
+    if (bin >= 0) {
+        // A cached block of the size class is taken wherever it lies, the
+        // direction only applies to blocks cut from the heap
+        data_size = BIN_DATA_SIZE(bin);
+        block_ptr = ns_mem_bin_get(book, bin);
+    }
+    if (!block_ptr) {
+        block_ptr = ns_mem_hole_alloc(book, data_size, direction);
+        if (!block_ptr && ns_mem_bins_flush(book)) {
+            block_ptr = ns_mem_hole_alloc(book, data_size, direction);
+        }
+    }
+#else
+    block_ptr = ns_mem_hole_alloc(book, data_size, direction);
+#endif
+    if (block_ptr) {
+        data_size = block_ptr[0];
+    }
+
  done:
     if (book->mem_stat_info_ptr) {
         if (block_ptr) {
             //Update Allocate OK
             dev_stat_update(book->mem_stat_info_ptr, DEV_HEAP_ALLOC_OK, (data_size + 2) * sizeof(ns_mem_word_size_t));
+#if NS_DYN_MEM_BIN_COUNT > 0
+            bin = ns_mem_bin_of_block(data_size);
+            if (bin >= 0) {
+                book->mem_stat_info_ptr->heap_bin_alloc_cnt[bin]++;
+            }
+#endif
 
         } else {
             //Update Allocate Fail, second parameter is not used for stats
@@ -427,8 +593,17 @@ void ns_mem_free(ns_mem_book_t *book, void *block)
     } else {
         if (ns_mem_block_validate(ptr, 1) != 0) {
             heap_failure(book, NS_DYN_MEM_HEAP_SECTOR_CORRUPTED);
+#if NS_DYN_MEM_BIN_COUNT > 0
+        } else if (ns_mem_bin_is_cached(book, ptr, size)) {
+            heap_failure(book, NS_DYN_MEM_DOUBLE_FREE);
+        } else {
+            if (!ns_mem_bin_put(book, ptr, size)) {
+                ns_mem_free_and_merge_with_adjacent_blocks(book, ptr, size);
+            }
+#else
         } else {
             ns_mem_free_and_merge_with_adjacent_blocks(book, ptr, size);
+#endif
             if (book->mem_stat_info_ptr) {
                 //Update Free Counter
                 dev_stat_update(book->mem_stat_info_ptr, DEV_HEAP_FREE, (size + 2) * sizeof(ns_mem_word_size_t));
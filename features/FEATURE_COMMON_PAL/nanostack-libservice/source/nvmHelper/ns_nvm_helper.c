@@ -6,6 +6,7 @@
 #include <ns_types.h>
 #include <nsdynmemLIB.h>
 #include "ns_list.h"
+#include "common_functions.h"
 #include "platform/arm_hal_nvm.h"
 #include "ns_nvm_helper.h"
 
@@ -20,7 +21,7 @@
 #define NS_NVM_FLUSH        0x05
 #define NS_NVM_KEY_DELETE   0x06
 
-typedef struct {
+typedef struct ns_nvm_request {
     ns_nvm_callback *callback;
     const char *client_key_name;
     void *client_context;
@@ -28,6 +29,7 @@ typedef struct {
     uint8_t *buffer;
     uint16_t *buffer_len;
     void *original_request;
+    struct ns_nvm_request *merged;  // requests whose data this one writes
     ns_list_link_t link;
 } ns_nvm_request_t;
 
@@ -38,8 +40,16 @@ static ns_nvm_request_t *ns_nvm_create_request(ns_nvm_callback *callback, void *
 static int ns_nvm_operation_start(ns_nvm_request_t *request);
 static int ns_nvm_operation_continue(ns_nvm_request_t *request, bool free_request);
 static void ns_nvm_operation_end(ns_nvm_request_t *ns_nvm_request_ptr, int client_retval);
+static void ns_nvm_operation_next(void);
 
 static NS_LIST_DEFINE(ns_nvm_request_list, ns_nvm_request_t, link);
+// Written requests waiting for the flush that ends their batch
+static NS_LIST_DEFINE(ns_nvm_flush_list, ns_nvm_request_t, link);
+
+static bool ns_nvm_operation_is_modify(const ns_nvm_request_t *request)
+{
+    return request && (request->operation == NS_NVM_KEY_WRITE || request->operation == NS_NVM_KEY_DELETE);
+}
 
 /*
  * Callback from platform NVM adaptation
@@ -74,10 +84,16 @@ void ns_nvm_callback_func(platform_nvm_status status, void *args)
             break;
         case NS_NVM_KEY_DELETE:
         case NS_NVM_KEY_WRITE:
-            if (status == PLATFORM_NVM_OK) {
+            if (status == PLATFORM_NVM_OK && ns_nvm_operation_is_modify(ns_list_get_first(&ns_nvm_request_list))) {
+                // more changes queued, flush them all at once after the last one
+                ns_list_add_to_end(&ns_nvm_flush_list, ns_nvm_request_ptr);
+                ns_nvm_operation_next();
+            } else if (status == PLATFORM_NVM_OK) {
                 // write ok, flush the changes
                 ns_nvm_request_ptr->operation = NS_NVM_FLUSH;
-                platform_nvm_flush(ns_nvm_callback_func, ns_nvm_request_ptr);
+                if (platform_nvm_flush(ns_nvm_callback_func, ns_nvm_request_ptr) != PLATFORM_NVM_OK) {
+                    ns_nvm_operation_end(ns_nvm_request_ptr, NS_NVM_ERROR);
+                }
             } else {
                 // write failed, inform client
                 ns_nvm_operation_end(ns_nvm_request_ptr, client_retval);
@@ -110,9 +126,113 @@ int ns_nvm_data_write(ns_nvm_callback *callback, const char *key_name, uint8_t *
         return NS_NVM_ERROR;
     }
     ns_nvm_request_t *ns_nvm_request_ptr = ns_nvm_create_request(callback, context, key_name, buf, buf_len, NS_NVM_KEY_WRITE);
+    if (ns_nvm_request_ptr && ns_nvm_operation_in_progress) {
+        // a write to the same key still queued stores this data instead
+        ns_list_foreach_reverse(ns_nvm_request_t, queued_req, &ns_nvm_request_list) {
+            if (strcmp(queued_req->client_key_name, key_name) != 0) {
+                continue;
+            }
+            if (queued_req->operation == NS_NVM_KEY_WRITE) {
+                ns_nvm_request_t **last = &queued_req->merged;
+                while (*last) {
+                    last = &(*last)->merged;
+                }
+                *last = ns_nvm_request_ptr;
+                queued_req->buffer = buf;
+                queued_req->buffer_len = buf_len;
+                return NS_NVM_OK;
+            }
+            break;
+        }
+    }
     return ns_nvm_operation_start(ns_nvm_request_ptr);
 }
 
+static void ns_nvm_counter_write_cb(int status, void *context)
+{
+    ns_nvm_counter_t *counter = context;
+    ns_nvm_callback *callback = counter->callback;
+
+    if (status == NS_NVM_OK) {
+        counter->limit = counter->writing_limit;
+    }
+    counter->writing_limit = 0;
+    if (callback) {
+        // first reservation of ns_nvm_counter_init written
+        counter->callback = NULL;
+        callback(status, counter->context);
+    }
+}
+
+static int ns_nvm_counter_write(ns_nvm_counter_t *counter, uint32_t limit)
+{
+    common_write_32_bit(limit, counter->buf);
+    counter->buf_len = sizeof(counter->buf);
+    counter->writing_limit = limit;
+    int ret = ns_nvm_data_write(ns_nvm_counter_write_cb, counter->key_name, counter->buf, &counter->buf_len, counter);
+    if (ret != NS_NVM_OK) {
+        counter->writing_limit = 0;
+    }
+    return ret;
+}
+
+static void ns_nvm_counter_read_cb(int status, void *context)
+{
+    ns_nvm_counter_t *counter = context;
+
+    if (status == NS_NVM_OK && counter->buf_len == sizeof(counter->buf)) {
+        // values below the stored limit may have been used before reset
+        counter->start = common_read_32_bit(counter->buf);
+    } else if (status == NS_NVM_DATA_NOT_FOUND) {
+        counter->start = 0;
+    } else {
+        status = NS_NVM_ERROR;
+    }
+
+    if (status != NS_NVM_ERROR) {
+        counter->limit = counter->start;
+        status = ns_nvm_counter_write(counter, counter->start + counter->reserve);
+    }
+    if (status != NS_NVM_OK) {
+        ns_nvm_callback *callback = counter->callback;
+        counter->callback = NULL;
+        callback(status, counter->context);
+    }
+}
+
+int ns_nvm_counter_init(ns_nvm_callback *callback, const char *key_name, ns_nvm_counter_t *counter, uint32_t reserve, void *context)
+{
+    if (!callback || !key_name || !counter || reserve < 2) {
+        return NS_NVM_ERROR;
+    }
+    counter->key_name = key_name;
+    counter->reserve = reserve;
+    counter->start = 0;
+    counter->limit = 0;
+    counter->writing_limit = 0;
+    counter->callback = callback;
+    counter->context = context;
+    counter->buf_len = sizeof(counter->buf);
+    int ret = ns_nvm_data_read(ns_nvm_counter_read_cb, key_name, counter->buf, &counter->buf_len, counter);
+    if (ret != NS_NVM_OK) {
+        counter->callback = NULL;
+    }
+    return ret;
+}
+
+int ns_nvm_counter_use(ns_nvm_counter_t *counter, uint32_t value)
+{
+    // distances from the start, which the counter only moves away from
+    uint32_t used = value - counter->start;
+    uint32_t reserved = counter->limit - counter->start;
+
+    if (!counter->writing_limit && !counter->callback && used + counter->reserve / 2 >= reserved) {
+        // half the reservation used, write the next one while the rest lasts
+        ns_nvm_counter_write(counter, value + counter->reserve);
+    }
+    return used < reserved ? NS_NVM_OK : NS_NVM_ERROR;
+}
+
 static int ns_nvm_operation_start(ns_nvm_request_t *nvm_request)
 {
     int ret = NS_NVM_OK;
@@ -162,6 +282,7 @@ static ns_nvm_request_t *ns_nvm_create_request(ns_nvm_callback *callback, void *
     ns_nvm_request_ptr->operation = operation;
     ns_nvm_request_ptr->buffer = buf;
     ns_nvm_request_ptr->buffer_len = buf_len;
+    ns_nvm_request_ptr->merged = NULL;
 
     return ns_nvm_request_ptr;
 }
@@ -182,6 +303,9 @@ static int ns_nvm_operation_continue(ns_nvm_request_t *request, bool free_reques
         case NS_NVM_KEY_DELETE:
             ret = platform_nvm_key_delete(ns_nvm_callback_func, request->client_key_name, request);
             break;
+        case NS_NVM_FLUSH:
+            ret = platform_nvm_flush(ns_nvm_callback_func, request);
+            break;
     }
 
     if (ret != PLATFORM_NVM_OK) {
@@ -196,20 +320,49 @@ static int ns_nvm_operation_continue(ns_nvm_request_t *request, bool free_reques
     return NS_NVM_OK;
 }
 
+static void ns_nvm_request_complete(ns_nvm_request_t *request, int client_retval)
+{
+    while (request) {
+        ns_nvm_request_t *merged = request->merged;
+        request->callback(client_retval, request->client_context);
+        ns_dyn_mem_free(request);
+        request = merged;
+    }
+}
+
 static void ns_nvm_operation_end(ns_nvm_request_t *ns_nvm_request_ptr, int client_retval)
 {
-    ns_nvm_request_ptr->callback(client_retval, ns_nvm_request_ptr->client_context);
-    ns_dyn_mem_free(ns_nvm_request_ptr);
-    ns_nvm_operation_in_progress = false;
+    bool flushed = ns_nvm_request_ptr->operation == NS_NVM_FLUSH;
 
-    ns_list_foreach_safe(ns_nvm_request_t, pending_req, &ns_nvm_request_list) {
-        // there are pending requests to be processed
-        ns_list_remove(&ns_nvm_request_list, pending_req);
-        int ret = ns_nvm_operation_continue(pending_req, false);
-        if (ret != NS_NVM_OK) {
-            ns_nvm_operation_end(pending_req, ret);
-        } else {
-            break;
+    ns_nvm_request_complete(ns_nvm_request_ptr, client_retval);
+    if (flushed) {
+        // the flush also ends the batch written before it
+        ns_list_foreach_safe(ns_nvm_request_t, written_req, &ns_nvm_flush_list) {
+            ns_list_remove(&ns_nvm_flush_list, written_req);
+            ns_nvm_request_complete(written_req, client_retval);
         }
     }
+    ns_nvm_operation_next();
+}
+
+static void ns_nvm_operation_next(void)
+{
+    ns_nvm_request_t *pending_req = ns_list_get_first(&ns_nvm_request_list);
+
+    ns_nvm_operation_in_progress = false;
+    if (!ns_list_is_empty(&ns_nvm_flush_list) && !ns_nvm_operation_is_modify(pending_req)) {
+        // no more changes queued, flush the batch written so far
+        pending_req = ns_list_get_first(&ns_nvm_flush_list);
+        ns_list_remove(&ns_nvm_flush_list, pending_req);
+        pending_req->operation = NS_NVM_FLUSH;
+    } else if (pending_req) {
+        ns_list_remove(&ns_nvm_request_list, pending_req);
+    } else {
+        return;
+    }
+
+    int ret = ns_nvm_operation_continue(pending_req, false);
+    if (ret != NS_NVM_OK) {
+        ns_nvm_operation_end(pending_req, ret);
+    }
 }
@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2017 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "CppUTest/TestHarness.h"
+#include "nsdynmemLIB.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include "error_callback.h"
+
+TEST_GROUP(dynmem_bins)
+{
+    void setup() {
+        reset_heap_error();
+    }
+
+    void teardown() {
+    }
+};
+
+TEST(dynmem_bins, reuse_freed_block)
+{
+    uint16_t size = 1000;
+    mem_stat_t info;
+    uint8_t *heap = (uint8_t*)malloc(size);
+    CHECK(NULL != heap);
+    ns_dyn_mem_init(heap, size, &heap_fail_callback, &info);
+    void *p1 = ns_dyn_mem_alloc(10);
+    void *p2 = ns_dyn_mem_alloc(30);
+    CHECK(p1 && p2);
+    CHECK(info.heap_bin_alloc_cnt[0] == 1);
+    CHECK(info.heap_bin_alloc_cnt[1] == 1);
+    ns_dyn_mem_free(p1);
+    CHECK(info.heap_bin_alloc_cnt[0] == 0);
+    CHECK(info.heap_bin_cached_cnt[0] == 1);
+    // Same size class, taken from the bin whatever the direction
+    void *p3 = ns_dyn_mem_temporary_alloc(16);
+    CHECK(p3 == p1);
+    CHECK(info.heap_bin_hit_cnt == 1);
+    CHECK(info.heap_bin_cached_cnt[0] == 0);
+    ns_dyn_mem_free(p3);
+    ns_dyn_mem_free(p2);
+    CHECK(!heap_have_failed());
+    CHECK(info.heap_sector_alloc_cnt == 0);
+    CHECK(info.heap_sector_allocated_bytes == 0);
+    free(heap);
+}
+
+TEST(dynmem_bins, large_blocks_not_binned)
+{
+    uint16_t size = 1000;
+    mem_stat_t info;
+    uint8_t *heap = (uint8_t*)malloc(size);
+    CHECK(NULL != heap);
+    ns_dyn_mem_init(heap, size, &heap_fail_callback, &info);
+    void *p = ns_dyn_mem_alloc(65);
+    CHECK(p);
+    ns_dyn_mem_free(p);
+    for (int i = 0; i < NS_DYN_MEM_BIN_COUNT; i++) {
+        CHECK(info.heap_bin_alloc_cnt[i] == 0);
+        CHECK(info.heap_bin_cached_cnt[i] == 0);
+    }
+    CHECK(!heap_have_failed());
+    free(heap);
+}
+
+TEST(dynmem_bins, bin_limit)
+{
+    uint16_t size = 1000;
+    mem_stat_t info;
+    uint8_t *heap = (uint8_t*)malloc(size);
+    void *p[3];
+    CHECK(NULL != heap);
+    ns_dyn_mem_init(heap, size, &heap_fail_callback, &info);
+    for (int i = 0; i < 3; i++) {
+        p[i] = ns_dyn_mem_alloc(20);
+        CHECK(p[i]);
+    }
+    for (int i = 0; i < 3; i++) {
+        ns_dyn_mem_free(p[i]);
+    }
+    CHECK(info.heap_bin_cached_cnt[1] == NS_DYN_MEM_BIN_MAX_CACHED);
+    CHECK(info.heap_bin_alloc_cnt[1] == 0);
+    CHECK(!heap_have_failed());
+    free(heap);
+}
+
+TEST(dynmem_bins, flush_on_failure)
+{
+    uint16_t size = 1000;
+    mem_stat_t info;
+    uint8_t *heap = (uint8_t*)malloc(size);
+    void *p[2];
+    CHECK(NULL != heap);
+    ns_dyn_mem_init(heap, size, &heap_fail_callback, &info);
+    p[0] = ns_dyn_mem_alloc(40);
+    p[1] = ns_dyn_mem_temporary_alloc(40);
+    CHECK(p[0] && p[1]);
+    ns_dyn_mem_free(p[0]);
+    ns_dyn_mem_free(p[1]);
+    CHECK(info.heap_bin_cached_cnt[2] == 2);
+    // Only fits once the cached blocks are merged back into the heap
+    void *big = ns_dyn_mem_alloc(info.heap_sector_size - 2 * sizeof(int) - 64);
+    CHECK(big);
+    CHECK(info.heap_bin_flush_cnt == 1);
+    CHECK(info.heap_bin_cached_cnt[2] == 0);
+    ns_dyn_mem_free(big);
+    CHECK(!heap_have_failed());
+    CHECK(info.heap_sector_alloc_cnt == 0);
+    free(heap);
+}
+
+TEST(dynmem_bins, double_free)
+{
+    uint16_t size = 1000;
+    mem_stat_t info;
+    uint8_t *heap = (uint8_t*)malloc(size);
+    void *p;
+    CHECK(NULL != heap);
+    ns_dyn_mem_init(heap, size, &heap_fail_callback, &info);
+    p = ns_dyn_mem_alloc(8);
+    CHECK(p);
+    ns_dyn_mem_free(p);
+    CHECK(!heap_have_failed());
+    ns_dyn_mem_free(p);
+    CHECK(heap_have_failed());
+    CHECK(NS_DYN_MEM_DOUBLE_FREE == current_heap_error);
+    CHECK(info.heap_bin_cached_cnt[0] == 1);
+    free(heap);
+}
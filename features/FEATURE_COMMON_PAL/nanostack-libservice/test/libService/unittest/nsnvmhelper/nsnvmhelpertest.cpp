@@ -15,6 +15,16 @@ TEST_GROUP(NS_NVM_HELPER)
     }
 };
 
+TEST(NS_NVM_HELPER, test_ns_nvm_helper_counter)
+{
+    CHECK(test_ns_nvm_helper_counter() == true);
+}
+
+TEST(NS_NVM_HELPER, test_ns_nvm_helper_write_coalescing)
+{
+    CHECK(test_ns_nvm_helper_write_coalescing() == true);
+}
+
 TEST(NS_NVM_HELPER, test_ns_nvm_helper_platform_error_in_write)
 {
     CHECK(test_ns_nvm_helper_platform_error_in_write() == true);
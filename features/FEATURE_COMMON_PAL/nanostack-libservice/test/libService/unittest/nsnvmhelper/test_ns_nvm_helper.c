@@ -23,6 +23,8 @@ static int write_callback_status = 0;
 static void *write_callback_context = NULL;
 static int delete_callback_status = 0;
 static void *delete_callback_context = NULL;
+static int coalesced_callback_count = 0;
+static int counter_callback_status = 0;
 
 extern void test_platform_nvm_api_set_retval(platform_nvm_status return_value);
 
@@ -44,6 +46,19 @@ void test_ns_nvm_helper_delete_callback(int status, void *context)
     delete_callback_context = context;
 }
 
+void test_ns_nvm_helper_coalesced_callback(int status, void *context)
+{
+    if (status == NS_NVM_OK) {
+        coalesced_callback_count++;
+    }
+    write_callback_context = context;
+}
+
+void test_ns_nvm_helper_counter_callback(int status, void *context)
+{
+    counter_callback_status = status;
+}
+
 bool test_ns_nvm_helper_write()
 {
     int ret_val;
@@ -288,7 +303,7 @@ bool test_ns_nvm_helper_concurrent_requests()
     // make write callback
     test_platform_nvm_api_callback();
 
-    // make write-flush callback with error status, note also delete will be given same error as pending request is triggered
+    // write is flushed along with the delete queued after it, make delete callback with error status
     test_platform_nvm_api_set_retval(PLATFORM_NVM_ERROR);
     test_platform_nvm_api_callback();
 
@@ -296,7 +311,7 @@ bool test_ns_nvm_helper_concurrent_requests()
         return false;
     }
 
-    // delete callback is called after write because write was failing
+    // flush of the write fails directly in platform_nvm_api
     if (delete_callback_status != NS_NVM_ERROR || delete_callback_context != TEST_NS_NVM_HELPER_CONTEXT3) {
         return false;
     }
@@ -424,3 +439,126 @@ bool test_ns_nvm_helper_platform_error_in_write()
 
     return true;
 }
+
+bool test_ns_nvm_helper_write_coalescing()
+{
+    int ret_val;
+    static uint8_t buf2[10];
+    static uint16_t buf2_len = sizeof(buf2);
+
+    coalesced_callback_count = 0;
+    write_callback_context = NULL;
+
+    // first write starts directly
+    test_platform_nvm_api_set_retval(PLATFORM_NVM_OK);
+    nsdynmemlib_stub.returnCounter = 3;
+    ret_val = ns_nvm_data_write(test_ns_nvm_helper_coalesced_callback, key1, buf, &buf_len, TEST_NS_NVM_HELPER_CONTEXT1);
+    if (ret_val != NS_NVM_OK) {
+        return false;
+    }
+
+    // second write is queued, third write to the same key is merged into it
+    ret_val = ns_nvm_data_write(test_ns_nvm_helper_coalesced_callback, key1, buf, &buf_len, TEST_NS_NVM_HELPER_CONTEXT2);
+    if (ret_val != NS_NVM_OK) {
+        return false;
+    }
+    ret_val = ns_nvm_data_write(test_ns_nvm_helper_coalesced_callback, key1, buf2, &buf2_len, TEST_NS_NVM_HELPER_CONTEXT3);
+    if (ret_val != NS_NVM_OK || nsdynmemlib_stub.returnCounter != 0) {
+        return false;
+    }
+
+    // make create and write callbacks of the first write, which waits for the flush of the second
+    test_platform_nvm_api_callback();
+    test_platform_nvm_api_callback();
+    if (coalesced_callback_count != 0) {
+        return false;
+    }
+
+    // make create and write callbacks of the merged writes
+    test_platform_nvm_api_callback();
+    test_platform_nvm_api_callback();
+    if (coalesced_callback_count != 0) {
+        return false;
+    }
+
+    // make flush callback, which completes all three writes
+    test_platform_nvm_api_callback();
+    if (coalesced_callback_count != 3 || write_callback_context != TEST_NS_NVM_HELPER_CONTEXT1) {
+        return false;
+    }
+
+    return true;
+}
+
+bool test_ns_nvm_helper_counter()
+{
+    int ret_val;
+    static ns_nvm_counter_t counter;
+
+    counter_callback_status = -1;
+
+    // test with invalid parameters - reserve too small
+    ret_val = ns_nvm_counter_init(test_ns_nvm_helper_counter_callback, key1, &counter, 1, NULL);
+    if (ret_val == NS_NVM_OK) {
+        return false;
+    }
+
+    // stored limit is 256, read from the counter buffer by the stub
+    test_platform_nvm_api_set_retval(PLATFORM_NVM_OK);
+    nsdynmemlib_stub.returnCounter = 2;
+    counter.buf[0] = 0;
+    counter.buf[1] = 0;
+    counter.buf[2] = 1;
+    counter.buf[3] = 0;
+    ret_val = ns_nvm_counter_init(test_ns_nvm_helper_counter_callback, key1, &counter, 100, NULL);
+    if (ret_val != NS_NVM_OK) {
+        return false;
+    }
+
+    // make read callback, which reserves values up to 356
+    test_platform_nvm_api_callback();
+    if (counter_callback_status != -1 || counter.start != 256) {
+        return false;
+    }
+    if (ns_nvm_counter_use(&counter, 256) != NS_NVM_ERROR) {
+        return false;
+    }
+
+    // make create, write and flush callbacks
+    test_platform_nvm_api_callback();
+    test_platform_nvm_api_callback();
+    test_platform_nvm_api_callback();
+    if (counter_callback_status != NS_NVM_OK) {
+        return false;
+    }
+
+    // first half of the range is used without writes
+    if (ns_nvm_counter_use(&counter, 256) != NS_NVM_OK || ns_nvm_counter_use(&counter, 305) != NS_NVM_OK) {
+        return false;
+    }
+    if (nsdynmemlib_stub.returnCounter != 0) {
+        return false;
+    }
+
+    // second half reserves the next range, up to 406
+    nsdynmemlib_stub.returnCounter = 1;
+    if (ns_nvm_counter_use(&counter, 306) != NS_NVM_OK || nsdynmemlib_stub.returnCounter != 0) {
+        return false;
+    }
+    if (ns_nvm_counter_use(&counter, 355) != NS_NVM_OK || ns_nvm_counter_use(&counter, 356) != NS_NVM_ERROR) {
+        return false;
+    }
+    if (counter.buf[2] != 0x01 || counter.buf[3] != 0x96) {
+        return false;
+    }
+
+    // make create, write and flush callbacks
+    test_platform_nvm_api_callback();
+    test_platform_nvm_api_callback();
+    test_platform_nvm_api_callback();
+    if (ns_nvm_counter_use(&counter, 356) != NS_NVM_OK || ns_nvm_counter_use(&counter, 406) != NS_NVM_ERROR) {
+        return false;
+    }
+
+    return true;
+}
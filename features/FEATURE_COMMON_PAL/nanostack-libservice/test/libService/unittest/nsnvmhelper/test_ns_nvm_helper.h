@@ -16,6 +16,8 @@ bool test_ns_nvm_helper_delete();
 bool test_ns_nvm_helper_concurrent_requests();
 bool test_ns_nvm_helper_platform_error();
 bool test_ns_nvm_helper_platform_error_in_write();
+bool test_ns_nvm_helper_write_coalescing();
+bool test_ns_nvm_helper_counter();
 
 #ifdef __cplusplus
 }
@@ -27,6 +27,12 @@
 #undef NS_EVENTLOOP_USE_TICK_TIMER
 /* Exclude high resolution timer from build (removes need for "platform_timer" API) */
 #undef NS_EXCLUDE_HIGHRES_TIMER
+/* Number of statically allocated events */
+#undef NS_EVENTLOOP_EVENT_POOL_SIZE
+/* Number of statically allocated event timers */
+#undef NS_EVENTLOOP_TIMER_POOL_SIZE
+/* Number of slots of the event timer wheel, a power of 2 */
+#undef NS_EVENTLOOP_TIMER_WHEEL_SIZE
 
 /*
  * mbedOS 5 specific configuration flag mapping to internal flags
@@ -35,10 +41,30 @@
 #define NS_EVENTLOOP_USE_TICK_TIMER     1
 #endif
 
+/* The event loop dispatched from the mbed shared event queue keeps its system
+ * timer on that queue */
+#ifdef MBED_CONF_NANOSTACK_HAL_EVENT_LOOP_USE_MBED_EVENTS
+#if MBED_CONF_NANOSTACK_HAL_EVENT_LOOP_USE_MBED_EVENTS
+#define NS_EVENTLOOP_USE_TICK_TIMER     1
+#endif
+#endif
+
 #ifdef MBED_CONF_NANOSTACK_EVENTLOOP_EXCLUDE_HIGHRES_TIMER
 #define NS_EXCLUDE_HIGHRES_TIMER        1
 #endif
 
+#ifdef MBED_CONF_NANOSTACK_EVENTLOOP_EVENT_POOL_SIZE
+#define NS_EVENTLOOP_EVENT_POOL_SIZE    MBED_CONF_NANOSTACK_EVENTLOOP_EVENT_POOL_SIZE
+#endif
+
+#ifdef MBED_CONF_NANOSTACK_EVENTLOOP_TIMER_POOL_SIZE
+#define NS_EVENTLOOP_TIMER_POOL_SIZE    MBED_CONF_NANOSTACK_EVENTLOOP_TIMER_POOL_SIZE
+#endif
+
+#ifdef MBED_CONF_NANOSTACK_EVENTLOOP_TIMER_WHEEL_SIZE
+#define NS_EVENTLOOP_TIMER_WHEEL_SIZE   MBED_CONF_NANOSTACK_EVENTLOOP_TIMER_WHEEL_SIZE
+#endif
+
 /*
  * For mbedOS 3 and minar use platform tick timer by default, highres timers should come from eventloop adaptor
  */
@@ -31,12 +31,21 @@ typedef struct arm_core_tasklet {
     ns_list_link_t link;
 } arm_core_tasklet_t;
 
+typedef NS_LIST_HEAD(arm_event_storage_t, link) event_queue_t;
+
 static NS_LIST_DEFINE(arm_core_tasklet_list, arm_core_tasklet_t, link);
-static NS_LIST_DEFINE(event_queue_active, arm_event_storage_t, link);
 static NS_LIST_DEFINE(free_event_entry, arm_event_storage_t, link);
 
+// One queue per priority, so queueing an event does not walk the queued ones.
+#define EVENT_QUEUE_COUNT (ARM_LIB_LOW_PRIORITY_EVENT + 1)
+static event_queue_t event_queue_active[EVENT_QUEUE_COUNT];
+
 // Statically allocate initial pool of events.
+#ifdef NS_EVENTLOOP_EVENT_POOL_SIZE
+#define STARTUP_EVENT_POOL_SIZE NS_EVENTLOOP_EVENT_POOL_SIZE
+#else
 #define STARTUP_EVENT_POOL_SIZE 10
+#endif
 static arm_event_storage_t startup_event_pool[STARTUP_EVENT_POOL_SIZE];
 
 /** Curr_tasklet tell to core and platform which task_let is active, Core Update this automatic when switch Tasklet. */
@@ -48,6 +57,15 @@ static arm_event_storage_t *event_dynamically_allocate(void);
 static arm_event_storage_t *event_core_get(void);
 static void event_core_write(arm_event_storage_t *event);
 
+static event_queue_t *event_queue_get(const arm_event_storage_t *event)
+{
+    // Out-of-range priorities are queued with the lowest one
+    if ((unsigned) event->data.priority >= EVENT_QUEUE_COUNT) {
+        return &event_queue_active[EVENT_QUEUE_COUNT - 1];
+    }
+    return &event_queue_active[event->data.priority];
+}
+
 static arm_core_tasklet_t *event_tasklet_handler_get(uint8_t tasklet_id)
 {
     ns_list_foreach(arm_core_tasklet_t, cur, &arm_core_tasklet_list) {
@@ -142,7 +160,7 @@ void eventOS_event_send_timer_allocated(arm_event_storage_t *event)
 
 void eventOS_event_cancel_critical(arm_event_storage_t *event)
 {
-    ns_list_remove(&event_queue_active, event);
+    ns_list_remove(event_queue_get(event), event);
 }
 
 static arm_event_storage_t *event_dynamically_allocate(void)
@@ -204,11 +222,15 @@ void event_core_free_push(arm_event_storage_t *free)
 
 static arm_event_storage_t *event_core_read(void)
 {
+    arm_event_storage_t *event = NULL;
     platform_enter_critical();
-    arm_event_storage_t *event = ns_list_get_first(&event_queue_active);
-    if (event) {
-        event->state = ARM_LIB_EVENT_RUNNING;
-        ns_list_remove(&event_queue_active, event);
+    for (unsigned i = 0; i < EVENT_QUEUE_COUNT; i++) {
+        event = ns_list_get_first(&event_queue_active[i]);
+        if (event) {
+            event->state = ARM_LIB_EVENT_RUNNING;
+            ns_list_remove(&event_queue_active[i], event);
+            break;
+        }
     }
     platform_exit_critical();
     return event;
@@ -217,18 +239,7 @@ static arm_event_storage_t *event_core_read(void)
 void event_core_write(arm_event_storage_t *event)
 {
     platform_enter_critical();
-    bool added = false;
-    ns_list_foreach(arm_event_storage_t, event_tmp, &event_queue_active) {
-        // note enum ordering means we're checking if event_tmp is LOWER priority than event
-        if (event_tmp->data.priority > event->data.priority) {
-            ns_list_add_before(&event_queue_active, event_tmp, event);
-            added = true;
-            break;
-        }
-    }
-    if (!added) {
-        ns_list_add_to_end(&event_queue_active, event);
-    }
+    ns_list_add_to_end(event_queue_get(event), event);
     event->state = ARM_LIB_EVENT_QUEUED;
 
     /* Wake From Idle */
@@ -239,9 +250,11 @@ void event_core_write(arm_event_storage_t *event)
 // Requires lock to be held
 arm_event_storage_t *eventOS_event_find_by_id_critical(uint8_t tasklet_id, uint8_t event_id)
 {
-    ns_list_foreach(arm_event_storage_t, cur, &event_queue_active) {
-        if (cur->data.receiver == tasklet_id && cur->data.event_id == event_id) {
-            return cur;
+    for (unsigned i = 0; i < EVENT_QUEUE_COUNT; i++) {
+        ns_list_foreach(arm_event_storage_t, cur, &event_queue_active[i]) {
+            if (cur->data.receiver == tasklet_id && cur->data.event_id == event_id) {
+                return cur;
+            }
         }
     }
 
@@ -259,10 +272,12 @@ void eventOS_scheduler_init(void)
 {
     /* Reset Event List variables */
     ns_list_init(&free_event_entry);
-    ns_list_init(&event_queue_active);
+    for (unsigned i = 0; i < EVENT_QUEUE_COUNT; i++) {
+        ns_list_init(&event_queue_active[i]);
+    }
     ns_list_init(&arm_core_tasklet_list);
 
-    //Add first 10 entries to "free" list
+    //Add the static pool to "free" list
     for (unsigned i = 0; i < (sizeof(startup_event_pool) / sizeof(startup_event_pool[0])); i++) {
         startup_event_pool[i].allocator = ARM_LIB_EVENT_STARTUP_POOL;
         ns_list_add_to_start(&free_event_entry, &startup_event_pool[i]);
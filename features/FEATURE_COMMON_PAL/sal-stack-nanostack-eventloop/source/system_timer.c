@@ -27,11 +27,25 @@
 #include "ns_timer.h"
 
 #ifndef ST_MAX
+#ifdef NS_EVENTLOOP_TIMER_POOL_SIZE
+#define ST_MAX NS_EVENTLOOP_TIMER_POOL_SIZE
+#else
 #define ST_MAX 6
 #endif
+#endif
 
 static sys_timer_struct_s startup_sys_timer_pool[ST_MAX];
 
+/* Pending timers are hashed by launch tick to the slots of a wheel: a request
+ * is queued in constant time, and a tick only looks at the timers of its slot */
+#ifdef NS_EVENTLOOP_TIMER_WHEEL_SIZE
+#define TIMER_WHEEL_SIZE            NS_EVENTLOOP_TIMER_WHEEL_SIZE
+#else
+#define TIMER_WHEEL_SIZE            32
+#endif
+NS_STATIC_ASSERT((TIMER_WHEEL_SIZE & (TIMER_WHEEL_SIZE - 1)) == 0, "Timer wheel size must be a power of 2")
+#define TIMER_WHEEL_SLOT(ticks)     ((ticks) & (TIMER_WHEEL_SIZE - 1))
+
 #define TIMER_SLOTS_PER_MS          20
 NS_STATIC_ASSERT(1000 % EVENTOS_EVENT_TIMER_HZ == 0, "Need whole number of ms per tick")
 #define TIMER_SYS_TICK_PERIOD       (1000 / EVENTOS_EVENT_TIMER_HZ) // milliseconds
@@ -40,13 +54,20 @@ NS_STATIC_ASSERT(1000 % EVENTOS_EVENT_TIMER_HZ == 0, "Need whole number of ms pe
 // atomicity on 16-bit platforms
 static volatile uint32_t timer_sys_ticks;
 
+typedef NS_LIST_HEAD(sys_timer_struct_s, event.link) sys_timer_list_t;
+
 static NS_LIST_DEFINE(system_timer_free, sys_timer_struct_s, event.link);
-static NS_LIST_DEFINE(system_timer_list, sys_timer_struct_s, event.link);
+static sys_timer_list_t system_timer_wheel[TIMER_WHEEL_SIZE];
+static uint32_t system_timer_count;
+// Launch time of the first pending timer, recomputed when that timer leaves
+static uint32_t system_timer_first_launch;
+static bool system_timer_first_valid;
 
 
 static sys_timer_struct_s *sys_timer_dynamically_allocate(void);
 static void timer_sys_interrupt(void);
 static void timer_sys_add(sys_timer_struct_s *timer);
+static void timer_sys_remove(sys_timer_struct_s *timer);
 
 #ifndef NS_EVENTLOOP_USE_TICK_TIMER
 static int8_t platform_tick_timer_start(uint32_t period_ms);
@@ -93,6 +114,11 @@ void timer_sys_init(void)
     for (uint8_t i = 0; i < ST_MAX; i++) {
         ns_list_add_to_start(&system_timer_free, &startup_sys_timer_pool[i]);
     }
+    for (uint16_t i = 0; i < TIMER_WHEEL_SIZE; i++) {
+        ns_list_init(&system_timer_wheel[i]);
+    }
+    system_timer_count = 0;
+    system_timer_first_valid = false;
 
     platform_tick_timer_register(timer_sys_interrupt);
     platform_tick_timer_start(TIMER_SYS_TICK_PERIOD);
@@ -170,7 +196,7 @@ void timer_sys_event_cancel_critical(struct arm_event_storage *event)
     timer->period = 0;
     // If its unqueued it is on my timer list, otherwise it is in event-loop.
     if (event->state == ARM_LIB_EVENT_UNQUEUED) {
-        ns_list_remove(&system_timer_list, timer);
+        timer_sys_remove(timer);
     }
 }
 
@@ -190,17 +216,44 @@ static void timer_sys_add(sys_timer_struct_s *timer)
 {
     uint32_t at = timer->launch_time;
 
-    // Find first timer scheduled to run after us, and insert before it.
-    // (This means timers scheduled for same time run in order of request)
-    ns_list_foreach(sys_timer_struct_s, t, &system_timer_list) {
-        if (TICKS_BEFORE(at, t->launch_time)) {
-            ns_list_add_before(&system_timer_list, t, timer);
-            return;
-        }
+    // Timers scheduled for same time share a slot, and run in order of request
+    ns_list_add_to_end(&system_timer_wheel[TIMER_WHEEL_SLOT(at)], timer);
+
+    if (system_timer_count++ == 0) {
+        system_timer_first_launch = at;
+        system_timer_first_valid = true;
+    } else if (system_timer_first_valid && TICKS_BEFORE(at, system_timer_first_launch)) {
+        system_timer_first_launch = at;
     }
+}
+
+/* Called internally with lock held */
+static void timer_sys_remove(sys_timer_struct_s *timer)
+{
+    ns_list_remove(&system_timer_wheel[TIMER_WHEEL_SLOT(timer->launch_time)], timer);
+    system_timer_count--;
 
-    // Didn't insert before another timer, so must be last.
-    ns_list_add_to_end(&system_timer_list, timer);
+    if (timer->launch_time == system_timer_first_launch) {
+        system_timer_first_valid = false;
+    }
+}
+
+/* Called internally with lock held, with at least one timer pending */
+static uint32_t timer_sys_first_launch(void)
+{
+    if (!system_timer_first_valid) {
+        bool found = false;
+        for (uint16_t i = 0; i < TIMER_WHEEL_SIZE; i++) {
+            ns_list_foreach(sys_timer_struct_s, t, &system_timer_wheel[i]) {
+                if (!found || TICKS_BEFORE(t->launch_time, system_timer_first_launch)) {
+                    system_timer_first_launch = t->launch_time;
+                    found = true;
+                }
+            }
+        }
+        system_timer_first_valid = true;
+    }
+    return system_timer_first_launch;
 }
 
 /* Called internally with lock held */
@@ -307,10 +360,12 @@ int8_t eventOS_event_timer_cancel(uint8_t event_id, int8_t tasklet_id)
     platform_enter_critical();
 
     /* First check pending timers */
-    ns_list_foreach(sys_timer_struct_s, cur, &system_timer_list) {
-        if (cur->event.data.receiver == tasklet_id && cur->event.data.event_id == event_id) {
-            eventOS_cancel(&cur->event);
-            goto done;
+    for (uint16_t i = 0; i < TIMER_WHEEL_SIZE; i++) {
+        ns_list_foreach(sys_timer_struct_s, cur, &system_timer_wheel[i]) {
+            if (cur->event.data.receiver == tasklet_id && cur->event.data.event_id == event_id) {
+                eventOS_cancel(&cur->event);
+                goto done;
+            }
         }
     }
 
@@ -335,15 +390,17 @@ uint32_t eventOS_event_timer_shortest_active_timer(void)
     uint32_t ret_val = 0;
 
     platform_enter_critical();
-    sys_timer_struct_s *first = ns_list_get_first(&system_timer_list);
-    if (first == NULL) {
+    if (system_timer_count == 0) {
         // Weird API has 0 for "no events"
         ret_val = 0;
-    } else if (TICKS_BEFORE_OR_AT(first->launch_time, timer_sys_ticks)) {
-        // Which means an immediate/overdue event has to be 1
-        ret_val = 1;
     } else {
-        ret_val = first->launch_time - timer_sys_ticks;
+        uint32_t first_launch = timer_sys_first_launch();
+        if (TICKS_BEFORE_OR_AT(first_launch, timer_sys_ticks)) {
+            // Which means an immediate/overdue event has to be 1
+            ret_val = 1;
+        } else {
+            ret_val = first_launch - timer_sys_ticks;
+        }
     }
 
     platform_exit_critical();
@@ -353,18 +410,26 @@ uint32_t eventOS_event_timer_shortest_active_timer(void)
 void system_timer_tick_update(uint32_t ticks)
 {
     platform_enter_critical();
+    // Visit the slots of the elapsed ticks in order, so that timers run in
+    // order of launch time. A catch-up of a whole turn or more visits every
+    // slot once, starting from the oldest one.
+    uint32_t tick = timer_sys_ticks + 1;
+    uint32_t slots = ticks;
+    if (ticks >= TIMER_WHEEL_SIZE) {
+        tick = timer_sys_ticks + ticks - TIMER_WHEEL_SIZE + 1;
+        slots = TIMER_WHEEL_SIZE;
+    }
     //Keep runtime time
     timer_sys_ticks += ticks;
-    ns_list_foreach_safe(sys_timer_struct_s, cur, &system_timer_list) {
-        if (TICKS_BEFORE_OR_AT(cur->launch_time, timer_sys_ticks)) {
-            // Unthread from our list
-            ns_list_remove(&system_timer_list, cur);
-            // Make it an event (can't fail - no allocation)
-            // event system will call our timer_sys_event_free on event delivery.
-            eventOS_event_send_timer_allocated(&cur->event);
-        } else {
-            // List is ordered, so as soon as we see a later event, we're done.
-            break;
+    for (; slots && system_timer_count; slots--, tick++) {
+        ns_list_foreach_safe(sys_timer_struct_s, cur, &system_timer_wheel[TIMER_WHEEL_SLOT(tick)]) {
+            if (TICKS_BEFORE_OR_AT(cur->launch_time, timer_sys_ticks)) {
+                // Unthread from our wheel
+                timer_sys_remove(cur);
+                // Make it an event (can't fail - no allocation)
+                // event system will call our timer_sys_event_free on event delivery.
+                eventOS_event_send_timer_allocated(&cur->event);
+            }
         }
     }
 
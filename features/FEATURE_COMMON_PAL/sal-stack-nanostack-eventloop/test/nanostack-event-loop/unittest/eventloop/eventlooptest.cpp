@@ -0,0 +1,275 @@
+/*
+ * Copyright (c) 2017 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "CppUTest/TestHarness.h"
+#include <string.h>
+#include "ns_types.h"
+#include "eventOS_event.h"
+#include "eventOS_event_timer.h"
+#include "eventOS_scheduler.h"
+#include "timer_sys.h"
+#include "nsdynmemLIB_stub.h"
+#include "platform_critical_stub.h"
+
+#define INIT_EVENT      0
+#define TEST_EVENT      1
+
+static int8_t tasklet_id = -1;
+static uint8_t order[16];
+static int order_count;
+
+static void tasklet(arm_event_s *event)
+{
+    if (event->event_type == TEST_EVENT && order_count < (int) sizeof(order)) {
+        order[order_count++] = event->event_id;
+    }
+}
+
+static arm_event_t test_event(uint8_t id, arm_library_event_priority_e priority)
+{
+    arm_event_t event;
+    memset(&event, 0, sizeof(event));
+    event.receiver = tasklet_id;
+    event.event_type = TEST_EVENT;
+    event.event_id = id;
+    event.priority = priority;
+    return event;
+}
+
+static void send(uint8_t id, arm_library_event_priority_e priority)
+{
+    arm_event_t event = test_event(id, priority);
+    LONGS_EQUAL(0, eventOS_event_send(&event));
+}
+
+static void timer_at(uint8_t id, uint32_t at)
+{
+    arm_event_t event = test_event(id, ARM_LIB_MED_PRIORITY_EVENT);
+    CHECK(eventOS_event_timer_request_at(&event, at) != NULL);
+}
+
+static void tick(uint32_t ticks)
+{
+    system_timer_tick_update(ticks);
+    eventOS_scheduler_run_until_idle();
+}
+
+static void check_order(const uint8_t *expected, int count)
+{
+    LONGS_EQUAL(count, order_count);
+    MEMCMP_EQUAL(expected, order, count);
+}
+
+TEST_GROUP(eventloop)
+{
+    void setup()
+    {
+        // The event loop is initialised once, as on a device
+        if (tasklet_id < 0) {
+            eventOS_scheduler_init();
+            tasklet_id = eventOS_event_handler_create(tasklet, INIT_EVENT);
+            CHECK(tasklet_id >= 0);
+        }
+        eventOS_scheduler_run_until_idle();
+        order_count = 0;
+        memset(&nsdynmemlib_stub, 0, sizeof(nsdynmemlib_stub));
+    }
+
+    void teardown()
+    {
+        // Let every timer left by the test fire, and drain the queue
+        tick(2 * MBED_CONF_NANOSTACK_EVENTLOOP_TIMER_WHEEL_SIZE);
+        LONGS_EQUAL(0, eventOS_event_timer_shortest_active_timer());
+        CHECK(!eventOS_scheduler_dispatch_event());
+        LONGS_EQUAL(0, platform_critical_nesting);
+    }
+};
+
+TEST(eventloop, priority_order)
+{
+    send(1, ARM_LIB_LOW_PRIORITY_EVENT);
+    send(2, ARM_LIB_MED_PRIORITY_EVENT);
+    send(3, ARM_LIB_HIGH_PRIORITY_EVENT);
+    send(4, ARM_LIB_MED_PRIORITY_EVENT);
+    send(5, ARM_LIB_HIGH_PRIORITY_EVENT);
+    // Out-of-range priorities are queued with the lowest one
+    send(6, (arm_library_event_priority_e) 7);
+    send(7, ARM_LIB_LOW_PRIORITY_EVENT);
+
+    eventOS_scheduler_run_until_idle();
+    const uint8_t expected[] = { 3, 5, 2, 4, 1, 6, 7 };
+    check_order(expected, sizeof(expected));
+}
+
+TEST(eventloop, pool_fallback)
+{
+    const int count = MBED_CONF_NANOSTACK_EVENTLOOP_EVENT_POOL_SIZE + 2;
+    uint8_t expected[MBED_CONF_NANOSTACK_EVENTLOOP_EVENT_POOL_SIZE + 2];
+    for (int i = 0; i < count; i++) {
+        expected[i] = i + 1;
+        send(i + 1, ARM_LIB_LOW_PRIORITY_EVENT);
+    }
+    // Only the events beyond the pool come from the heap, and go back to it
+    LONGS_EQUAL(2, nsdynmemlib_stub.alloc_count);
+    eventOS_scheduler_run_until_idle();
+    check_order(expected, count);
+    LONGS_EQUAL(2, nsdynmemlib_stub.free_count);
+
+    for (int i = 0; i < MBED_CONF_NANOSTACK_EVENTLOOP_EVENT_POOL_SIZE; i++) {
+        send(i + 1, ARM_LIB_LOW_PRIORITY_EVENT);
+    }
+    LONGS_EQUAL(2, nsdynmemlib_stub.alloc_count);
+}
+
+TEST(eventloop, cancel)
+{
+    arm_event_storage_t user_event;
+    user_event.data = test_event(1, ARM_LIB_MED_PRIORITY_EVENT);
+    send(2, ARM_LIB_MED_PRIORITY_EVENT);
+    eventOS_event_send_user_allocated(&user_event);
+    send(3, ARM_LIB_HIGH_PRIORITY_EVENT);
+
+    // The cancelled event leaves its own queue, which stays usable
+    eventOS_cancel(&user_event);
+    LONGS_EQUAL(arm_event_storage_t::ARM_LIB_EVENT_UNQUEUED, user_event.state);
+    send(4, ARM_LIB_MED_PRIORITY_EVENT);
+    eventOS_scheduler_run_until_idle();
+    const uint8_t expected[] = { 3, 2, 4 };
+    check_order(expected, sizeof(expected));
+}
+
+TEST(eventloop, timers_same_tick)
+{
+    uint32_t now = eventOS_event_timer_ticks();
+    timer_at(1, now + 3);
+    // Same wheel slot, one turn later
+    timer_at(2, now + 3 + MBED_CONF_NANOSTACK_EVENTLOOP_TIMER_WHEEL_SIZE);
+    timer_at(3, now + 3);
+    timer_at(4, now + 1);
+    timer_at(5, now + 3);
+    // Due timers are sent at once
+    timer_at(6, now);
+    LONGS_EQUAL(4, nsdynmemlib_stub.alloc_count);
+
+    eventOS_scheduler_run_until_idle();
+    tick(1);
+    tick(1);
+    const uint8_t first[] = { 6, 4 };
+    check_order(first, sizeof(first));
+
+    // Timers due at the same tick run in the order they were requested
+    tick(1);
+    const uint8_t second[] = { 6, 4, 1, 3, 5 };
+    check_order(second, sizeof(second));
+
+    tick(MBED_CONF_NANOSTACK_EVENTLOOP_TIMER_WHEEL_SIZE - 1);
+    LONGS_EQUAL(5, order_count);
+    tick(1);
+    const uint8_t third[] = { 6, 4, 1, 3, 5, 2 };
+    check_order(third, sizeof(third));
+
+    // Timers taken from the heap stay in the pool
+    for (int i = 0; i < 6; i++) {
+        timer_at(i + 1, now + 20);
+    }
+    LONGS_EQUAL(4, nsdynmemlib_stub.alloc_count);
+    LONGS_EQUAL(0, nsdynmemlib_stub.free_count);
+}
+
+TEST(eventloop, catch_up)
+{
+    uint32_t now = eventOS_event_timer_ticks();
+    timer_at(1, now + 2);
+    timer_at(2, now + 5);
+    timer_at(3, now + 4);
+
+    // A catch-up shorter than the wheel runs the timers in launch order
+    tick(5);
+    const uint8_t expected[] = { 1, 3, 2 };
+    check_order(expected, sizeof(expected));
+
+    // A longer one visits every slot once, and leaves timers not yet due
+    order_count = 0;
+    now = eventOS_event_timer_ticks();
+    timer_at(4, now + 3);
+    timer_at(5, now + 20);
+    timer_at(6, now + 3 + MBED_CONF_NANOSTACK_EVENTLOOP_TIMER_WHEEL_SIZE);
+    timer_at(7, now + 40);
+    tick(30);
+    LONGS_EQUAL(3, order_count);
+    uint8_t ran = 0;
+    for (int i = 0; i < order_count; i++) {
+        ran |= 1 << (order[i] - 4);
+    }
+    LONGS_EQUAL(0x7, ran);
+    LONGS_EQUAL(eventOS_event_timer_ticks_to_ms(10), eventOS_event_timer_shortest_active_timer());
+
+    tick(10);
+    LONGS_EQUAL(4, order_count);
+    LONGS_EQUAL(7, order[3]);
+}
+
+TEST(eventloop, shortest_active_timer)
+{
+    LONGS_EQUAL(0, eventOS_event_timer_shortest_active_timer());
+
+    uint32_t now = eventOS_event_timer_ticks();
+    timer_at(1, now + 5);
+    timer_at(2, now + 3);
+    LONGS_EQUAL(eventOS_event_timer_ticks_to_ms(3), eventOS_event_timer_shortest_active_timer());
+
+    // The first timer leaving the wheel makes the next one the shortest
+    LONGS_EQUAL(0, eventOS_event_timer_cancel(2, tasklet_id));
+    LONGS_EQUAL(-1, eventOS_event_timer_cancel(2, tasklet_id));
+    LONGS_EQUAL(eventOS_event_timer_ticks_to_ms(5), eventOS_event_timer_shortest_active_timer());
+
+    timer_at(3, now + 7);
+    LONGS_EQUAL(eventOS_event_timer_ticks_to_ms(5), eventOS_event_timer_shortest_active_timer());
+    timer_at(4, now + 4);
+    LONGS_EQUAL(eventOS_event_timer_ticks_to_ms(4), eventOS_event_timer_shortest_active_timer());
+
+    tick(5);
+    const uint8_t expected[] = { 4, 1 };
+    check_order(expected, sizeof(expected));
+    LONGS_EQUAL(eventOS_event_timer_ticks_to_ms(2), eventOS_event_timer_shortest_active_timer());
+
+    tick(2);
+    LONGS_EQUAL(0, eventOS_event_timer_shortest_active_timer());
+}
+
+TEST(eventloop, periodic)
+{
+    arm_event_t event = test_event(1, ARM_LIB_MED_PRIORITY_EVENT);
+    CHECK(eventOS_event_timer_request_every(&event, 3) != NULL);
+
+    tick(3);
+    LONGS_EQUAL(1, order_count);
+    tick(2);
+    LONGS_EQUAL(1, order_count);
+    tick(1);
+    LONGS_EQUAL(2, order_count);
+    LONGS_EQUAL(eventOS_event_timer_ticks_to_ms(3), eventOS_event_timer_shortest_active_timer());
+
+    LONGS_EQUAL(0, eventOS_event_timer_cancel(1, tasklet_id));
+    tick(10);
+    LONGS_EQUAL(2, order_count);
+
+    // A periodic timer can also be cancelled while its event is queued
+    CHECK(eventOS_event_timer_request_every(&event, 3) != NULL);
+    system_timer_tick_update(3);
+    LONGS_EQUAL(0, eventOS_event_timer_cancel(1, tasklet_id));
+    tick(10);
+    LONGS_EQUAL(2, order_count);
+}
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2017 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <stdint.h>
+#include "nsdynmemLIB.h"
+#include "nsdynmemLIB_stub.h"
+
+/* Allocations come from a static heap and are never reused, so that blocks
+ * the event loop keeps for its lifetime are not reported as leaks */
+static uint64_t stub_heap[256];
+static uint16_t heap_used;
+
+nsdynmemlib_stub_data_t nsdynmemlib_stub;
+
+void ns_dyn_mem_init(void *heap, ns_mem_heap_size_t h_size, void (*passed_fptr)(heap_fail_t), mem_stat_t *info_ptr)
+{
+}
+
+void *ns_dyn_mem_alloc(ns_mem_block_size_t alloc_size)
+{
+    uint16_t words = (alloc_size + sizeof(stub_heap[0]) - 1) / sizeof(stub_heap[0]);
+    if (alloc_size == 0 || heap_used + words > sizeof(stub_heap) / sizeof(stub_heap[0])) {
+        return NULL;
+    }
+    void *block = &stub_heap[heap_used];
+    heap_used += words;
+    nsdynmemlib_stub.alloc_count++;
+    return block;
+}
+
+void *ns_dyn_mem_temporary_alloc(ns_mem_block_size_t alloc_size)
+{
+    return ns_dyn_mem_alloc(alloc_size);
+}
+
+void ns_dyn_mem_free(void *heap_ptr)
+{
+    if (heap_ptr) {
+        nsdynmemlib_stub.free_count++;
+    }
+}
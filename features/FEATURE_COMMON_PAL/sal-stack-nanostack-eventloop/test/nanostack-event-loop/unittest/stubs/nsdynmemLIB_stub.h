@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) 2017 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __NSDYNMEMLIB_STUB_H__
+#define __NSDYNMEMLIB_STUB_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+typedef struct {
+    uint16_t alloc_count;
+    uint16_t free_count;
+} nsdynmemlib_stub_data_t;
+
+extern nsdynmemlib_stub_data_t nsdynmemlib_stub;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -22,15 +22,223 @@
 #include "lwip/tcp.h"
 #include "lwip/ip.h"
 #include "netif/etharp.h"
+#include "lwip/stats.h"
+
+#if LWIP_CHECKSUM_CTRL_PER_NETIF
+/* Checksums lwIP leaves to interfaces with the capability */
+static const struct {
+    uint32_t cap;
+    u16_t flag;
+} emac_lwip_checksums[] = {
+    { EMAC_CAP_CHECKSUM_GEN_IP,     NETIF_CHECKSUM_GEN_IP },
+    { EMAC_CAP_CHECKSUM_GEN_UDP,    NETIF_CHECKSUM_GEN_UDP },
+    { EMAC_CAP_CHECKSUM_GEN_TCP,    NETIF_CHECKSUM_GEN_TCP },
+    { EMAC_CAP_CHECKSUM_GEN_ICMP,   NETIF_CHECKSUM_GEN_ICMP },
+    { EMAC_CAP_CHECKSUM_CHECK_IP,   NETIF_CHECKSUM_CHECK_IP },
+    { EMAC_CAP_CHECKSUM_CHECK_UDP,  NETIF_CHECKSUM_CHECK_UDP },
+    { EMAC_CAP_CHECKSUM_CHECK_TCP,  NETIF_CHECKSUM_CHECK_TCP },
+    { EMAC_CAP_CHECKSUM_CHECK_ICMP, NETIF_CHECKSUM_CHECK_ICMP },
+};
+#endif
+
+static uint32_t emac_lwip_capabilities(emac_interface_t *mac)
+{
+    if (!mac->ops.get_capabilities) {
+        return EMAC_CAP_SCATTER_GATHER_TX;
+    }
+
+    return mac->ops.get_capabilities(mac);
+}
+
+#ifndef MBED_CONF_LWIP_EMAC_TX_PRIORITY_QUEUES
+#define MBED_CONF_LWIP_EMAC_TX_PRIORITY_QUEUES  1
+#endif
+
+#ifndef MBED_CONF_LWIP_EMAC_TX_QUEUE_LENGTH
+#define MBED_CONF_LWIP_EMAC_TX_QUEUE_LENGTH     8
+#endif
+
+#define EMAC_LWIP_TX_LEVELS MBED_CONF_LWIP_EMAC_TX_PRIORITY_QUEUES
+
+static uint8_t emac_lwip_tx_queues(emac_interface_t *mac)
+{
+    if (!mac->ops.get_tx_queues || !mac->ops.link_out_queue) {
+        return 1;
+    }
+
+    return mac->ops.get_tx_queues(mac);
+}
+
+/* Send a frame on a hardware queue, returns false if the frame was not taken */
+static bool emac_lwip_send(emac_interface_t *mac, struct pbuf *p, uint8_t queue)
+{
+    /* Interfaces without scatter-gather get the packet in one buffer */
+    if (p->next && !(emac_lwip_capabilities(mac) & EMAC_CAP_SCATTER_GATHER_TX)) {
+        struct pbuf *q = pbuf_alloc(PBUF_RAW, p->tot_len, PBUF_RAM);
+        if (!q) {
+            return false;
+        }
+
+        pbuf_copy(q, p);
+        bool ret = emac_lwip_send(mac, q, queue);
+        pbuf_free(q);
+
+        return ret;
+    }
+
+    if (queue) {
+        return mac->ops.link_out_queue(mac, (emac_stack_mem_t *)p, queue);
+    }
+
+    return mac->ops.link_out(mac, (emac_stack_mem_t *)p);
+}
+
+#if EMAC_LWIP_TX_LEVELS > 1
+
+/* Frames held back while the transmit ring is full, one ring per priority level */
+typedef struct {
+    struct pbuf *frames[MBED_CONF_LWIP_EMAC_TX_QUEUE_LENGTH];
+    uint8_t head;
+    uint8_t count;
+} emac_lwip_tx_level_t;
+
+static emac_lwip_tx_level_t emac_lwip_tx_levels[EMAC_LWIP_TX_LEVELS];
+static unsigned emac_lwip_tx_pending;
+static struct tcpip_callback_msg *emac_lwip_tx_ready_msg;
+#if MBED_CONF_LWIP_EMAC_TX_WEIGHTED
+static uint16_t emac_lwip_tx_credits[EMAC_LWIP_TX_LEVELS];
+#endif
+
+/* Priority from 0 to 7 of a frame, from its VLAN tag or its IP precedence */
+static uint8_t emac_lwip_frame_priority(struct pbuf *p)
+{
+    const u8_t *frame = (const u8_t *)p->payload + ETH_PAD_SIZE;
+
+    if (p->len < ETH_PAD_SIZE + 16) {
+        return 0;
+    }
+
+    switch ((frame[12] << 8) | frame[13]) {
+        case ETHTYPE_VLAN:
+            return frame[14] >> 5;
+        case ETHTYPE_IP:
+            return frame[15] >> 5;
+        case ETHTYPE_IPV6:
+            return (frame[14] & 0x0F) >> 1;
+        default:
+            return 0;
+    }
+}
+
+/* Level the next frame is sent from, -1 if none is waiting */
+static int emac_lwip_tx_next_level(void)
+{
+#if MBED_CONF_LWIP_EMAC_TX_WEIGHTED
+    for (int round = 0; round < 2; round++) {
+        for (int level = EMAC_LWIP_TX_LEVELS - 1; level >= 0; level--) {
+            if (emac_lwip_tx_levels[level].count && emac_lwip_tx_credits[level]) {
+                return level;
+            }
+        }
+
+        for (int level = 0; level < EMAC_LWIP_TX_LEVELS; level++) {
+            emac_lwip_tx_credits[level] = 1 << level;
+        }
+    }
+#else
+    for (int level = EMAC_LWIP_TX_LEVELS - 1; level >= 0; level--) {
+        if (emac_lwip_tx_levels[level].count) {
+            return level;
+        }
+    }
+#endif
+
+    return -1;
+}
+
+static uint8_t emac_lwip_tx_hw_queue(emac_interface_t *mac, int level)
+{
+    return level * emac_lwip_tx_queues(mac) / EMAC_LWIP_TX_LEVELS;
+}
+
+static void emac_lwip_tx_drain(emac_interface_t *mac)
+{
+    int level;
+
+    while ((level = emac_lwip_tx_next_level()) >= 0) {
+        emac_lwip_tx_level_t *q = &emac_lwip_tx_levels[level];
+        struct pbuf *p = q->frames[q->head];
+
+        if (!emac_lwip_send(mac, p, emac_lwip_tx_hw_queue(mac, level))) {
+            /* Ring full, wait for the interface to have room */
+            break;
+        }
+
+        q->head = (q->head + 1) % MBED_CONF_LWIP_EMAC_TX_QUEUE_LENGTH;
+        q->count--;
+        emac_lwip_tx_pending--;
+#if MBED_CONF_LWIP_EMAC_TX_WEIGHTED
+        emac_lwip_tx_credits[level]--;
+#endif
+        pbuf_free(p);
+    }
+}
+
+/* Runs in the TCPIP thread, from the tx ready callback of the interface */
+static void emac_lwip_tx_ready(void *ctx)
+{
+    struct netif *netif = (struct netif *)ctx;
+
+    emac_lwip_tx_drain((emac_interface_t *)netif->state);
+}
+
+static void emac_lwip_tx_ready_isr(void *data)
+{
+    (void)data;
+
+    /* A callback still queued drains every level already */
+    tcpip_trycallback(emac_lwip_tx_ready_msg);
+}
+
+static err_t emac_lwip_low_level_output(struct netif *netif, struct pbuf *p)
+{
+    emac_interface_t *mac = (emac_interface_t *)netif->state;
+    int level = emac_lwip_frame_priority(p) * EMAC_LWIP_TX_LEVELS / 8;
+
+    /* Nothing is held back, so the frame can go straight to the interface */
+    if (!emac_lwip_tx_pending && emac_lwip_send(mac, p, emac_lwip_tx_hw_queue(mac, level))) {
+        return ERR_OK;
+    }
+
+    emac_lwip_tx_level_t *q = &emac_lwip_tx_levels[level];
+    if (q->count == MBED_CONF_LWIP_EMAC_TX_QUEUE_LENGTH) {
+        LINK_STATS_INC(link.drop);
+        return ERR_MEM;
+    }
+
+    pbuf_ref(p);
+    q->frames[(q->head + q->count) % MBED_CONF_LWIP_EMAC_TX_QUEUE_LENGTH] = p;
+    q->count++;
+    emac_lwip_tx_pending++;
+
+    emac_lwip_tx_drain(mac);
+
+    return ERR_OK;
+}
+
+#else
 
 static err_t emac_lwip_low_level_output(struct netif *netif, struct pbuf *p)
 {
     emac_interface_t *mac = (emac_interface_t *)netif->state;
-    bool ret = mac->ops.link_out(mac, (emac_stack_mem_t *)p);
+
+    bool ret = emac_lwip_send(mac, p, 0);
 
     return ret ? ERR_OK : ERR_IF;
 }
 
+#endif
+
 static void emac_lwip_input(void *data, emac_stack_t *buf)
 {
     struct pbuf *p = (struct pbuf *)buf;
@@ -63,6 +271,12 @@ err_t emac_lwip_if_init(struct netif *netif)
     mac->ops.set_link_input_cb(mac, emac_lwip_input, netif);
     mac->ops.set_link_state_cb(mac, emac_lwip_state_change, netif);
 
+#ifdef MBED_CONF_LWIP_EMAC_MTU
+    if (mac->ops.set_mtu_size) {
+        mac->ops.set_mtu_size(mac, MBED_CONF_LWIP_EMAC_MTU);
+    }
+#endif
+
     if (!mac->ops.power_up(mac)) {
         err = ERR_IF;
     }
@@ -74,6 +288,17 @@ err_t emac_lwip_if_init(struct netif *netif)
     /* Interface capabilities */
     netif->flags = NETIF_FLAG_BROADCAST | NETIF_FLAG_ETHARP | NETIF_FLAG_ETHERNET | NETIF_FLAG_IGMP;
 
+#if LWIP_CHECKSUM_CTRL_PER_NETIF
+    uint32_t caps = emac_lwip_capabilities(mac);
+    u16_t checksums = NETIF_CHECKSUM_ENABLE_ALL;
+    for (unsigned i = 0; i < sizeof(emac_lwip_checksums) / sizeof(emac_lwip_checksums[0]); i++) {
+        if (caps & emac_lwip_checksums[i].cap) {
+            checksums &= ~emac_lwip_checksums[i].flag;
+        }
+    }
+    NETIF_SET_CHECKSUM_CTRL(netif, checksums);
+#endif
+
     mac->ops.get_ifname(mac, netif->name, 2);
 
 #if LWIP_IPV4
@@ -82,6 +307,15 @@ err_t emac_lwip_if_init(struct netif *netif)
 
     netif->linkoutput = emac_lwip_low_level_output;
 
+#if EMAC_LWIP_TX_LEVELS > 1
+    if (!emac_lwip_tx_ready_msg) {
+        emac_lwip_tx_ready_msg = tcpip_callbackmsg_new(emac_lwip_tx_ready, netif);
+    }
+    if (mac->ops.set_tx_ready_cb && emac_lwip_tx_ready_msg) {
+        mac->ops.set_tx_ready_cb(mac, emac_lwip_tx_ready_isr, netif);
+    }
+#endif
+
     return err;
 }
 
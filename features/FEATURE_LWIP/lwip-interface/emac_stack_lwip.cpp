@@ -19,14 +19,8 @@
 #include "emac_stack_mem.h"
 #include "pbuf.h"
 
-emac_stack_mem_t *emac_stack_mem_alloc(emac_stack_t* stack, uint32_t size, uint32_t align)
+static void emac_stack_mem_align(struct pbuf *pbuf, uint32_t align)
 {
-
-    struct pbuf *pbuf = pbuf_alloc(PBUF_RAW, size + align, PBUF_RAM);
-    if (pbuf == NULL) {
-        return NULL;
-    }
-
     if (align) {
         uint32_t remainder = (uint32_t)pbuf->payload % align;
         uint32_t offset = align - remainder;
@@ -38,6 +32,30 @@ emac_stack_mem_t *emac_stack_mem_alloc(emac_stack_t* stack, uint32_t size, uint3
         pbuf->tot_len -= offset;
         pbuf->len -= offset;
     }
+}
+
+emac_stack_mem_t *emac_stack_mem_alloc(emac_stack_t* stack, uint32_t size, uint32_t align)
+{
+
+    struct pbuf *pbuf = pbuf_alloc(PBUF_RAW, size + align, PBUF_RAM);
+    if (pbuf == NULL) {
+        return NULL;
+    }
+
+    emac_stack_mem_align(pbuf, align);
+
+    return (emac_stack_mem_t*)pbuf;
+}
+
+emac_stack_mem_t *emac_stack_mem_rx_alloc(emac_stack_t* stack, uint32_t align)
+{
+    // A whole pool buffer, which pbuf_alloc returns as a single pbuf
+    struct pbuf *pbuf = pbuf_alloc(PBUF_RAW, PBUF_POOL_BUFSIZE, PBUF_POOL);
+    if (pbuf == NULL) {
+        return NULL;
+    }
+
+    emac_stack_mem_align(pbuf, align);
 
     return (emac_stack_mem_t*)pbuf;
 }
@@ -66,9 +84,27 @@ void emac_stack_mem_set_len(emac_stack_t* stack, emac_stack_mem_t *mem, uint32_t
 {
     struct pbuf *pbuf = (struct pbuf*)mem;
 
+    pbuf->tot_len = pbuf->tot_len - pbuf->len + len;
     pbuf->len = len;
 }
 
+emac_stack_mem_t *emac_stack_mem_next(emac_stack_t* stack, emac_stack_mem_t *mem)
+{
+    struct pbuf *pbuf = (struct pbuf*)mem;
+
+    // The last pbuf of a packet may still link to the next packet
+    if (pbuf->len == pbuf->tot_len) {
+        return NULL;
+    }
+
+    return (emac_stack_mem_t *)pbuf->next;
+}
+
+void emac_stack_mem_chain_concat(emac_stack_t* stack, emac_stack_mem_chain_t *chain, emac_stack_mem_t *mem)
+{
+    pbuf_cat((struct pbuf*)chain, (struct pbuf*)mem);
+}
+
 emac_stack_mem_t *emac_stack_mem_chain_dequeue(emac_stack_t* stack, emac_stack_mem_chain_t **chain)
 {
     struct pbuf **list = (struct pbuf**)chain;
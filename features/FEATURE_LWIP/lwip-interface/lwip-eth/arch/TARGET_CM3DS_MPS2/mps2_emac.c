@@ -33,6 +33,7 @@
 #include "lwip/sys.h"
 #include "lwip/tcpip.h"
 
+#include "lwip_eth_rx.h"
 #include "mbed_interface.h"
 #include "mbed_wait_api.h"
 #include "netif/etharp.h"
@@ -52,7 +53,7 @@
 
 #define HOSTNAME_STRING "lwip_mps2"
 
-static sys_sem_t rx_ready_sem;
+static eth_rx_dev_t rx_dev;
 
 struct ethernetif {
     const struct eth_addr *ethaddr;
@@ -157,20 +158,30 @@ static void ethernetif_input(struct netif *netif)
 }
 
 /**
- * This task is called when a packet is received. It will
- * pass the packet to the LWIP core.
+ * This function is called by the shared receive thread once the
+ * receive interrupt has fired. It passes the packets waiting in the
+ * RX FIFO to the LWIP core.
  *
- * @param pvParameters pointer to the interface data
+ * @param dev the receive worker registration of the interface
+ * @param budget the most packets to pass
+ * @return the number of packets passed
  */
-static void packet_rx(void* pvParameters)
+static int packet_rx(eth_rx_dev_t *dev, int budget)
 {
-    struct netif *netif = pvParameters;
+    struct netif *netif = dev->context;
+    int count = 0;
 
-    while (1) {
-        sys_arch_sem_wait(&rx_ready_sem, 0);
+    while (count < budget && smsc9220_peek_next_packet_size()) {
         ethernetif_input(netif);
-        smsc9220_enable_interrupt(enum_smsc9220_interrupt_rxstatus_fifo_level);
+        count++;
     }
+    return count;
+}
+
+static void packet_rx_irq_enable(eth_rx_dev_t *dev)
+{
+    (void)dev;
+    smsc9220_enable_interrupt(enum_smsc9220_interrupt_rxstatus_fifo_level);
 }
 
 /**
@@ -360,9 +371,10 @@ err_t eth_arch_enetif_init(struct netif *netif)
     error = low_level_init(netif);
 
     if (error == ERR_OK) {
-        sys_thread_new("receive_thread", packet_rx, netif,
-                       DEFAULT_THREAD_STACKSIZE, osPriorityNormal);
-        sys_sem_new(&rx_ready_sem, 0);
+        rx_dev.poll = packet_rx;
+        rx_dev.irq_enable = packet_rx_irq_enable;
+        rx_dev.context = netif;
+        eth_rx_register(&rx_dev);
         ethernetif->is_enabled = 1;
     }
 
@@ -383,9 +395,9 @@ void eth_arch_disable_interrupts(void)
 void ETHERNET_IRQHandler(void)
 {
     if (smsc9220_get_interrupt(enum_smsc9220_interrupt_rxstatus_fifo_level)) {
-        sys_sem_signal(&rx_ready_sem);
         smsc9220_clear_interrupt(enum_smsc9220_interrupt_rxstatus_fifo_level);
         smsc9220_disable_interrupt(enum_smsc9220_interrupt_rxstatus_fifo_level);
+        eth_rx_schedule(&rx_dev);
     }
 }
 
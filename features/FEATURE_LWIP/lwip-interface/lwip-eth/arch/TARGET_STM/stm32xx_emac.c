@@ -6,6 +6,7 @@
 #include <string.h>
 #include "cmsis_os2.h"
 #include "mbed_interface.h"
+#include "mbed_dcache.h"
 
 // Check for LWIP having Ethernet enabled
 #if LWIP_ARP || LWIP_ETHERNET
@@ -20,25 +21,15 @@
 
 ETH_HandleTypeDef EthHandle;
 
-#if defined (__ICCARM__)   /*!< IAR Compiler */
-  #pragma data_alignment=4
-#endif
-__ALIGN_BEGIN ETH_DMADescTypeDef DMARxDscrTab[ETH_RXBUFNB] __ALIGN_END; /* Ethernet Rx DMA Descriptor */
+/* DMA descriptors and buffers start on a data cache line, so cache
+ * maintenance on one of them never touches its neighbours */
+MBED_DCACHE_ALIGNED __ALIGN_BEGIN ETH_DMADescTypeDef DMARxDscrTab[ETH_RXBUFNB] __ALIGN_END; /* Ethernet Rx DMA Descriptor */
 
-#if defined (__ICCARM__)   /*!< IAR Compiler */
-  #pragma data_alignment=4
-#endif
-__ALIGN_BEGIN ETH_DMADescTypeDef DMATxDscrTab[ETH_TXBUFNB] __ALIGN_END; /* Ethernet Tx DMA Descriptor */
+MBED_DCACHE_ALIGNED __ALIGN_BEGIN ETH_DMADescTypeDef DMATxDscrTab[ETH_TXBUFNB] __ALIGN_END; /* Ethernet Tx DMA Descriptor */
 
-#if defined (__ICCARM__)   /*!< IAR Compiler */
-  #pragma data_alignment=4
-#endif
-__ALIGN_BEGIN uint8_t Rx_Buff[ETH_RXBUFNB][ETH_RX_BUF_SIZE] __ALIGN_END; /* Ethernet Receive Buffer */
+MBED_DCACHE_ALIGNED __ALIGN_BEGIN uint8_t Rx_Buff[ETH_RXBUFNB][ETH_RX_BUF_SIZE] __ALIGN_END; /* Ethernet Receive Buffer */
 
-#if defined (__ICCARM__)   /*!< IAR Compiler */
-  #pragma data_alignment=4
-#endif
-__ALIGN_BEGIN uint8_t Tx_Buff[ETH_TXBUFNB][ETH_TX_BUF_SIZE] __ALIGN_END; /* Ethernet Transmit Buffer */
+MBED_DCACHE_ALIGNED __ALIGN_BEGIN uint8_t Tx_Buff[ETH_TXBUFNB][ETH_TX_BUF_SIZE] __ALIGN_END; /* Ethernet Transmit Buffer */
 
 static sys_sem_t rx_ready_sem;    /* receive ready semaphore */
 static sys_mutex_t tx_lock_mutex;
@@ -149,6 +140,10 @@ static void _eth_arch_low_level_init(struct netif *netif)
     /* Configure MAC */
     _eth_config_mac(&EthHandle);
 
+    /* Write the descriptor lists back before the DMA starts using them */
+    mbed_dcache_clean(DMATxDscrTab, sizeof(DMATxDscrTab));
+    mbed_dcache_clean(DMARxDscrTab, sizeof(DMARxDscrTab));
+
     /* Enable MAC and DMA transmission and reception */
     HAL_ETH_Start(&EthHandle);
 #endif
@@ -185,6 +180,9 @@ static err_t _eth_arch_low_level_output(struct netif *netif, struct pbuf *p)
 
     sys_mutex_lock(&tx_lock_mutex);
 
+    /* Pick up descriptor status written by the DMA */
+    mbed_dcache_clean_invalidate(DMATxDscrTab, sizeof(DMATxDscrTab));
+
     /* copy frame from pbufs to driver buffers */
     for (q = p; q != NULL; q = q->next) {
         /* Is this buffer available? If not, goto error */
@@ -201,6 +199,7 @@ static err_t _eth_arch_low_level_output(struct netif *netif, struct pbuf *p)
         while ((byteslefttocopy + bufferoffset) > ETH_TX_BUF_SIZE) {
             /* Copy data to Tx buffer*/
             memcpy((uint8_t*)((uint8_t*)buffer + bufferoffset), (uint8_t*)((uint8_t*)q->payload + payloadoffset), (ETH_TX_BUF_SIZE - bufferoffset));
+            mbed_dcache_clean((uint8_t*)buffer + bufferoffset, ETH_TX_BUF_SIZE - bufferoffset);
 
             /* Point to next descriptor */
             DmaTxDesc = (ETH_DMADescTypeDef*)(DmaTxDesc->Buffer2NextDescAddr);
@@ -221,6 +220,7 @@ static err_t _eth_arch_low_level_output(struct netif *netif, struct pbuf *p)
 
         /* Copy the remaining bytes */
         memcpy((uint8_t*)((uint8_t*)buffer + bufferoffset), (uint8_t*)((uint8_t*)q->payload + payloadoffset), byteslefttocopy);
+        mbed_dcache_clean((uint8_t*)buffer + bufferoffset, byteslefttocopy);
         bufferoffset = bufferoffset + byteslefttocopy;
         framelength = framelength + byteslefttocopy;
     }
@@ -228,6 +228,13 @@ static err_t _eth_arch_low_level_output(struct netif *netif, struct pbuf *p)
     /* Prepare transmit descriptors to give to DMA */
     HAL_ETH_TransmitFrame(&EthHandle, framelength);
 
+#if MBED_DCACHE_PRESENT
+    /* The DMA may have polled the descriptors before they were written back,
+     * so poll again once they are in memory */
+    mbed_dcache_clean(DMATxDscrTab, sizeof(DMATxDscrTab));
+    EthHandle.Instance->DMATPDR = 0;
+#endif
+
     errval = ERR_OK;
 
 error:
@@ -268,6 +275,9 @@ static struct pbuf * _eth_arch_low_level_input(struct netif *netif)
     uint32_t i = 0;
 
 
+    /* Pick up descriptor status written by the DMA */
+    mbed_dcache_clean_invalidate(DMARxDscrTab, sizeof(DMARxDscrTab));
+
     /* get received frame */
     if (HAL_ETH_GetReceivedFrame(&EthHandle) != HAL_OK)
         return NULL;
@@ -291,6 +301,7 @@ static struct pbuf * _eth_arch_low_level_input(struct netif *netif)
             /* Check if the length of bytes to copy in current pbuf is bigger than Rx buffer size*/
             while ((byteslefttocopy + bufferoffset) > ETH_RX_BUF_SIZE) {
                 /* Copy data to pbuf */
+                mbed_dcache_invalidate((uint8_t*)buffer + bufferoffset, ETH_RX_BUF_SIZE - bufferoffset);
                 memcpy((uint8_t*)((uint8_t*)q->payload + payloadoffset), (uint8_t*)((uint8_t*)buffer + bufferoffset), (ETH_RX_BUF_SIZE - bufferoffset));
 
                 /* Point to next descriptor */
@@ -302,6 +313,7 @@ static struct pbuf * _eth_arch_low_level_input(struct netif *netif)
                 bufferoffset = 0;
             }
             /* Copy remaining data in pbuf */
+            mbed_dcache_invalidate((uint8_t*)buffer + bufferoffset, byteslefttocopy);
             memcpy((uint8_t*)((uint8_t*)q->payload + payloadoffset), (uint8_t*)((uint8_t*)buffer + bufferoffset), byteslefttocopy);
             bufferoffset = bufferoffset + byteslefttocopy;
         }
@@ -319,6 +331,9 @@ static struct pbuf * _eth_arch_low_level_input(struct netif *netif)
     /* Clear Segment_Count */
     EthHandle.RxFrameInfos.SegCount = 0;
 
+    /* Write the Own bits back so the DMA sees them */
+    mbed_dcache_clean(DMARxDscrTab, sizeof(DMARxDscrTab));
+
     /* When Rx Buffer unavailable flag is set: clear it and resume reception */
     if ((EthHandle.Instance->DMASR & ETH_DMASR_RBUS) != (uint32_t)RESET) {
         /* Clear RBUS ETHERNET DMA flag */
@@ -437,6 +452,10 @@ err_t eth_arch_enetif_init(struct netif *netif)
     /* device capabilities */
     netif->flags = NETIF_FLAG_BROADCAST | NETIF_FLAG_ETHARP | NETIF_FLAG_ETHERNET;
 
+    /* the MAC inserts IPv4, TCP, UDP and ICMP checksums and drops
+     * received frames with bad checksums (ETH_CHECKSUM_BY_HARDWARE) */
+    NETIF_SET_CHECKSUM_CTRL(netif, NETIF_CHECKSUM_GEN_ICMP6 | NETIF_CHECKSUM_CHECK_ICMP6);
+
 #if LWIP_NETIF_HOSTNAME
     /* Initialize interface hostname */
     netif->hostname = "lwipstm32";
@@ -211,6 +211,17 @@ err_t sys_mbox_trypost(sys_mbox_t *mbox, void *msg) {
     return ERR_OK;
 }
 
+/* Takes the oldest message of a mailbox, called with the kernel locked */
+static void sys_arch_mbox_take(sys_mbox_t *mbox, void **msg) {
+    if (msg)
+        *msg = mbox->queue[mbox->fetch_idx % MB_SIZE];
+    mbox->fetch_idx += 1;
+
+    osEventFlagsSet(mbox->id, SYS_MBOX_POST_EVENT);
+    if (mbox->post_idx == mbox->fetch_idx)
+        osEventFlagsClear(mbox->id, SYS_MBOX_FETCH_EVENT);
+}
+
 /*---------------------------------------------------------------------------*
  * Routine:  sys_arch_mbox_fetch
  *---------------------------------------------------------------------------*
@@ -237,21 +248,25 @@ err_t sys_mbox_trypost(sys_mbox_t *mbox, void *msg) {
  *                                  of milliseconds until received.
  *---------------------------------------------------------------------------*/
 u32_t sys_arch_mbox_fetch(sys_mbox_t *mbox, void **msg, u32_t timeout) {
+    // Messages queued since the last wakeup are taken without waiting,
+    // so a burst of them is processed in one go
+    int state = osKernelLock();
+    if (mbox->post_idx != mbox->fetch_idx) {
+        sys_arch_mbox_take(mbox, msg);
+        osKernelRestoreLock(state);
+        return 0;
+    }
+    osKernelRestoreLock(state);
+
     uint32_t start = us_ticker_read();
     uint32_t flags = osEventFlagsWait(mbox->id, SYS_MBOX_FETCH_EVENT,
             osFlagsWaitAny | osFlagsNoClear, (timeout ? timeout : osWaitForever));
     if ((flags & osFlagsError) || !(flags & SYS_MBOX_FETCH_EVENT))
         return SYS_ARCH_TIMEOUT;
 
-    int state = osKernelLock();
-
-    if (msg)
-        *msg = mbox->queue[mbox->fetch_idx % MB_SIZE];
-    mbox->fetch_idx += 1;
+    state = osKernelLock();
 
-    osEventFlagsSet(mbox->id, SYS_MBOX_POST_EVENT);
-    if (mbox->post_idx == mbox->fetch_idx)
-        osEventFlagsClear(mbox->id, SYS_MBOX_FETCH_EVENT);
+    sys_arch_mbox_take(mbox, msg);
 
     osKernelRestoreLock(state);
     return (us_ticker_read() - start) / 1000;
@@ -279,13 +294,7 @@ u32_t sys_arch_mbox_tryfetch(sys_mbox_t *mbox, void **msg) {
 
     int state = osKernelLock();
 
-    if (msg)
-        *msg = mbox->queue[mbox->fetch_idx % MB_SIZE];
-    mbox->fetch_idx += 1;
-
-    osEventFlagsSet(mbox->id, SYS_MBOX_POST_EVENT);
-    if (mbox->post_idx == mbox->fetch_idx)
-        osEventFlagsClear(mbox->id, SYS_MBOX_FETCH_EVENT);
+    sys_arch_mbox_take(mbox, msg);
 
     osKernelRestoreLock(state);
     return ERR_OK;
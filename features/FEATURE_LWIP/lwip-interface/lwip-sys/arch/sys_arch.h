@@ -44,7 +44,12 @@ typedef struct {
 } sys_mutex_t;
 
 // === MAIL BOX ===
-#define MB_SIZE      8
+#define MB_SIZE      MBED_CONF_LWIP_MBOX_SIZE
+
+// The mailbox indexes are 8-bit and wrap around
+#if (MB_SIZE & (MB_SIZE - 1)) || MB_SIZE > 128
+#   error Mailbox size must be a power of two up to 128
+#endif
 
 typedef struct {
     osEventFlagsId_t                id;
@@ -467,24 +467,32 @@ pppos_input(ppp_pcb *ppp, u8_t *s, int l)
   struct pbuf *next_pbuf;
   u8_t cur_char;
   u8_t escaped;
+  ext_accm in_accm;
   PPPOS_DECL_PROTECT(lev);
 
   PPPDEBUG(LOG_DEBUG, ("pppos_input[%d]: got %d bytes\n", ppp->netif->num, l));
+
+  /* ppp_input can disconnect the interface, we need to abort to prevent a memory
+   * leak if there are remaining bytes because pppos_connect and pppos_listen
+   * functions expect input buffer to be free. Furthermore there are no real
+   * reason to continue reading bytes if we are disconnected.
+   *
+   * The state is checked, and the ACCM copied, once for the chunk and again
+   * at each flag character rather than for every byte, as the protection
+   * can be a mutex. The ACCM only changes between frames.
+   */
+  PPPOS_PROTECT(lev);
+  if (!pppos->open) {
+    PPPOS_UNPROTECT(lev);
+    return;
+  }
+  MEMCPY(in_accm, pppos->in_accm, sizeof(in_accm));
+  PPPOS_UNPROTECT(lev);
+
   while (l-- > 0) {
     cur_char = *s++;
 
-    PPPOS_PROTECT(lev);
-    /* ppp_input can disconnect the interface, we need to abort to prevent a memory
-     * leak if there are remaining bytes because pppos_connect and pppos_listen
-     * functions expect input buffer to be free. Furthermore there are no real
-     * reason to continue reading bytes if we are disconnected.
-     */
-    if (!pppos->open) {
-      PPPOS_UNPROTECT(lev);
-      return;
-    }
-    escaped = ESCAPE_P(pppos->in_accm, cur_char);
-    PPPOS_UNPROTECT(lev);
+    escaped = ESCAPE_P(in_accm, cur_char);
     /* Handle special characters. */
     if (escaped) {
       /* Check for escape sequences. */
@@ -496,6 +504,14 @@ pppos_input(ppp_pcb *ppp, u8_t *s, int l)
         pppos->in_escaped = 1;
       /* Check for the flag character. */
       } else if (cur_char == PPP_FLAG) {
+        PPPOS_PROTECT(lev);
+        if (!pppos->open) {
+          PPPOS_UNPROTECT(lev);
+          return;
+        }
+        MEMCPY(in_accm, pppos->in_accm, sizeof(in_accm));
+        PPPOS_UNPROTECT(lev);
+
         /* If this is just an extra flag character, ignore it. */
         if (pppos->in_state <= PDADDRESS) {
           /* ignore it */;
@@ -552,6 +568,9 @@ pppos_input(ppp_pcb *ppp, u8_t *s, int l)
           }
 #else /* PPP_INPROC_IRQ_SAFE */
           ppp_input(ppp, inp);
+          if (!pppos->open) {
+            return;
+          }
 #endif /* PPP_INPROC_IRQ_SAFE */
         }
 
@@ -0,0 +1,107 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "lwip_eth_rx.h"
+#include "lwip/sys.h"
+#include "cmsis_os2.h"
+#include "platform/mbed_critical.h"
+
+#ifndef MBED_CONF_LWIP_ETH_RX_THREAD_STACKSIZE
+#define MBED_CONF_LWIP_ETH_RX_THREAD_STACKSIZE  1024
+#endif
+
+#ifndef MBED_CONF_LWIP_ETH_RX_THREAD_PRIORITY
+#define MBED_CONF_LWIP_ETH_RX_THREAD_PRIORITY   osPriorityNormal
+#endif
+
+#ifndef MBED_CONF_LWIP_ETH_RX_BUDGET
+#define MBED_CONF_LWIP_ETH_RX_BUDGET            8
+#endif
+
+#ifndef MBED_CONF_LWIP_ETH_RX_MITIGATION_MS
+#define MBED_CONF_LWIP_ETH_RX_MITIGATION_MS     0
+#endif
+
+#define ETH_RX_FLAG_SCHEDULED   0x1
+
+static eth_rx_dev_t *eth_rx_devs;
+static sys_thread_t eth_rx_thread;
+
+static void eth_rx_worker(void *arg)
+{
+    (void)arg;
+
+    while (1) {
+        osThreadFlagsWait(ETH_RX_FLAG_SCHEDULED, osFlagsWaitAny, osWaitForever);
+
+        int busy;
+        do {
+            busy = 0;
+            // one budget for each scheduled driver per round, so a flooded
+            // interface can not starve the others
+            for (eth_rx_dev_t *dev = eth_rx_devs; dev; dev = dev->next) {
+                if (!dev->scheduled) {
+                    continue;
+                }
+
+                int frames = dev->poll(dev, MBED_CONF_LWIP_ETH_RX_BUDGET);
+                dev->frames += frames;
+                if (frames < MBED_CONF_LWIP_ETH_RX_BUDGET) {
+                    // drained, the next frame interrupts again
+                    dev->scheduled = 0;
+                    dev->irq_enable(dev);
+                } else {
+                    dev->budget_exhausted++;
+                    busy = 1;
+                }
+            }
+
+            if (busy) {
+#if MBED_CONF_LWIP_ETH_RX_MITIGATION_MS
+                osDelay(MBED_CONF_LWIP_ETH_RX_MITIGATION_MS);
+#else
+                osThreadYield();
+#endif
+            }
+        } while (busy);
+    }
+}
+
+void eth_rx_register(eth_rx_dev_t *dev)
+{
+    dev->scheduled = 0;
+    dev->frames = 0;
+    dev->interrupts = 0;
+    dev->budget_exhausted = 0;
+
+    core_util_critical_section_enter();
+    dev->next = eth_rx_devs;
+    eth_rx_devs = dev;
+    core_util_critical_section_exit();
+
+    if (!eth_rx_thread) {
+        eth_rx_thread = sys_thread_new("eth_rx_thread", eth_rx_worker, NULL,
+                                       MBED_CONF_LWIP_ETH_RX_THREAD_STACKSIZE,
+                                       MBED_CONF_LWIP_ETH_RX_THREAD_PRIORITY);
+    }
+}
+
+void eth_rx_schedule(eth_rx_dev_t *dev)
+{
+    dev->interrupts++;
+    dev->scheduled = 1;
+    osThreadFlagsSet(eth_rx_thread->id, ETH_RX_FLAG_SCHEDULED);
+}
@@ -0,0 +1,108 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef LWIP_ETH_RX_H
+#define LWIP_ETH_RX_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Shared Ethernet receive worker
+ *
+ * Instead of a receive thread of their own, Ethernet drivers register with
+ * one worker thread shared by all interfaces. Reception is polled, as in
+ * NAPI:
+ *
+ * - the receive interrupt of the driver masks itself and calls
+ *   eth_rx_schedule;
+ * - the worker calls the poll function of the driver, which passes at most
+ *   budget frames to the stack and returns how many it passed;
+ * - a poll that passes fewer frames than the budget means the driver is
+ *   drained, and the worker calls irq_enable to unmask the interrupt;
+ * - otherwise the driver stays scheduled and is polled again after the
+ *   other scheduled drivers, with its interrupt still masked.
+ *
+ * Under a flood of frames a driver therefore takes no interrupt at all,
+ * and each wakeup of the worker handles a bounded number of frames per
+ * driver. With lwip.eth-rx-mitigation-ms set, the worker sleeps that long
+ * between rounds that used a full budget, which bounds the CPU time spent
+ * on reception.
+ */
+
+typedef struct eth_rx_dev eth_rx_dev_t;
+
+/**
+ * Receive frames
+ *
+ * @param dev    The registered driver
+ * @param budget The most frames to pass to the stack
+ * @return The number of frames passed or dropped, fewer than budget once
+ *         no frame is left
+ */
+typedef int (*eth_rx_poll_fn)(eth_rx_dev_t *dev, int budget);
+
+/**
+ * Unmask the receive interrupt of the driver
+ *
+ * @param dev    The registered driver
+ */
+typedef void (*eth_rx_irq_enable_fn)(eth_rx_dev_t *dev);
+
+/** A driver registered with the receive worker, owned by the driver */
+struct eth_rx_dev {
+    eth_rx_poll_fn poll;                /**< Receive function */
+    eth_rx_irq_enable_fn irq_enable;    /**< Interrupt unmask function */
+    void *context;                      /**< Driver data, such as the netif */
+
+    /* Worker state */
+    struct eth_rx_dev *next;
+    volatile uint8_t scheduled;
+
+    /* Statistics */
+    uint32_t frames;                    /**< Frames received */
+    uint32_t interrupts;                /**< Calls of eth_rx_schedule */
+    uint32_t budget_exhausted;          /**< Polls that used the whole budget */
+};
+
+/**
+ * Register a driver with the receive worker
+ *
+ * The worker thread is started on the first registration. A driver is
+ * registered once, before it enables its receive interrupt, and stays
+ * registered.
+ *
+ * @param dev    The driver, with poll, irq_enable and context set
+ */
+void eth_rx_register(eth_rx_dev_t *dev);
+
+/**
+ * Schedule a driver to be polled
+ *
+ * Called from the receive interrupt, after masking it, or from a thread.
+ *
+ * @param dev    The registered driver
+ */
+void eth_rx_schedule(eth_rx_dev_t *dev);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LWIP_ETH_RX_H */
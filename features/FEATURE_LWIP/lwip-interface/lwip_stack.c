@@ -34,6 +34,8 @@
 #include "lwip/mld6.h"
 #include "lwip/dns.h"
 #include "lwip/udp.h"
+#include "lwip/memp.h"
+#include "lwip/stats.h"
 #include "netif/lwip_ethernet.h"
 #include "emac_api.h"
 #include "ppp_lwip.h"
@@ -46,18 +48,25 @@ static nsapi_error_t mbed_lwip_err_remap(err_t err);
     #define MBED_NETIF_INIT_FN eth_arch_enetif_init
 #endif
 
-/* Static arena of sockets */
+/* Static arena of sockets, the free ones linked through next */
 static struct lwip_socket {
     bool in_use;
+    struct lwip_socket *next;
 
     struct netconn *conn;
     struct netbuf *buf;
     u16_t offset;
+    /* Receive events less receive minus events, the packets queued on a
+     * UDP socket, as counted by the lwIP sockets layer */
+    s16_t rcvevent;
 
     void (*cb)(void *);
     void *data;
 } lwip_arena[MEMP_NUM_NETCONN];
 
+static struct lwip_socket *lwip_arena_free;
+static bool lwip_arena_inited = false;
+
 static bool lwip_inited = false;
 static bool lwip_connected = false;
 static bool netif_inited = false;
@@ -67,23 +76,32 @@ static struct lwip_socket *mbed_lwip_arena_alloc(void)
 {
     sys_prot_t prot = sys_arch_protect();
 
-    for (int i = 0; i < MEMP_NUM_NETCONN; i++) {
-        if (!lwip_arena[i].in_use) {
-            struct lwip_socket *s = &lwip_arena[i];
-            memset(s, 0, sizeof *s);
-            s->in_use = true;
-            sys_arch_unprotect(prot);
-            return s;
+    if (!lwip_arena_inited) {
+        for (int i = MEMP_NUM_NETCONN - 1; i >= 0; i--) {
+            lwip_arena[i].next = lwip_arena_free;
+            lwip_arena_free = &lwip_arena[i];
         }
+        lwip_arena_inited = true;
+    }
+
+    struct lwip_socket *s = lwip_arena_free;
+    if (s) {
+        lwip_arena_free = s->next;
+        memset(s, 0, sizeof *s);
+        s->in_use = true;
     }
 
     sys_arch_unprotect(prot);
-    return 0;
+    return s;
 }
 
 static void mbed_lwip_arena_dealloc(struct lwip_socket *s)
 {
+    sys_prot_t prot = sys_arch_protect();
     s->in_use = false;
+    s->next = lwip_arena_free;
+    lwip_arena_free = s;
+    sys_arch_unprotect(prot);
 }
 
 static void mbed_lwip_socket_callback(struct netconn *nc, enum netconn_evt eh, u16_t len)
@@ -97,9 +115,17 @@ static void mbed_lwip_socket_callback(struct netconn *nc, enum netconn_evt eh, u
 
     for (int i = 0; i < MEMP_NUM_NETCONN; i++) {
         if (lwip_arena[i].in_use
-            && lwip_arena[i].conn == nc
-            && lwip_arena[i].cb) {
-            lwip_arena[i].cb(lwip_arena[i].data);
+            && lwip_arena[i].conn == nc) {
+            if (eh == NETCONN_EVT_RCVPLUS) {
+                lwip_arena[i].rcvevent++;
+            } else if (eh == NETCONN_EVT_RCVMINUS) {
+                lwip_arena[i].rcvevent--;
+            }
+
+            if (lwip_arena[i].cb) {
+                lwip_arena[i].cb(lwip_arena[i].data);
+            }
+            break;
         }
     }
 
@@ -922,6 +948,13 @@ static nsapi_error_t mbed_lwip_socket_close(nsapi_stack_t *stack, nsapi_socket_t
 {
     struct lwip_socket *s = (struct lwip_socket *)handle;
 
+#if LWIP_SO_LINGER
+    // A nonblocking netconn cannot linger, close would fail instead
+    if (s->conn->linger > 0) {
+        netconn_set_nonblocking(s->conn, false);
+    }
+#endif
+
     netbuf_delete(s->buf);
     err_t err = netconn_delete(s->conn);
     mbed_lwip_arena_dealloc(s);
@@ -953,6 +986,13 @@ static nsapi_error_t mbed_lwip_socket_listen(nsapi_stack_t *stack, nsapi_socket_
 {
     struct lwip_socket *s = (struct lwip_socket *)handle;
 
+    // Accepted connections wait in the accept mailbox, which bounds the backlog
+    if (backlog < 1) {
+        backlog = 1;
+    } else if (backlog > DEFAULT_ACCEPTMBOX_SIZE) {
+        backlog = DEFAULT_ACCEPTMBOX_SIZE;
+    }
+
     err_t err = netconn_listen_with_backlog(s->conn, backlog);
     return mbed_lwip_err_remap(err);
 }
@@ -1080,6 +1120,212 @@ static nsapi_size_or_error_t mbed_lwip_socket_recvfrom(nsapi_stack_t *stack, nsa
     return recv;
 }
 
+static nsapi_size_or_error_t mbed_lwip_socket_sendto_batch(nsapi_stack_t *stack, nsapi_socket_t handle, nsapi_msg_t *msgs, nsapi_size_t count)
+{
+    struct lwip_socket *s = (struct lwip_socket *)handle;
+    err_t err = ERR_OK;
+    nsapi_size_t i;
+
+    /* One netbuf refers to the data of each packet in turn */
+    struct netbuf *buf = netbuf_new();
+    if (!buf) {
+        return NSAPI_ERROR_NO_MEMORY;
+    }
+
+    for (i = 0; i < count; i++) {
+        ip_addr_t ip_addr;
+        if (!convert_mbed_addr_to_lwip(&ip_addr, &msgs[i].addr)) {
+            err = ERR_ARG;
+            break;
+        }
+
+        err = netbuf_ref(buf, msgs[i].data, (u16_t)msgs[i].size);
+        if (err != ERR_OK) {
+            break;
+        }
+
+        err = netconn_sendto(s->conn, buf, &ip_addr, msgs[i].port);
+        if (err != ERR_OK) {
+            break;
+        }
+
+        msgs[i].len = msgs[i].size;
+    }
+
+    netbuf_delete(buf);
+    if (i == 0 && err != ERR_OK) {
+        return mbed_lwip_err_remap(err);
+    }
+
+    return i;
+}
+
+static nsapi_size_or_error_t mbed_lwip_socket_recvfrom_batch(nsapi_stack_t *stack, nsapi_socket_t handle, nsapi_msg_t *msgs, nsapi_size_t count)
+{
+    struct lwip_socket *s = (struct lwip_socket *)handle;
+    nsapi_size_t i;
+
+    for (i = 0; i < count; i++) {
+        /* After the first packet only take the ones already queued, rather
+         * than waiting out the receive timeout on an empty mailbox */
+        if (i > 0 && s->rcvevent <= 0) {
+            break;
+        }
+
+        struct netbuf *buf;
+        err_t err = netconn_recv(s->conn, &buf);
+        if (err != ERR_OK) {
+            if (i == 0) {
+                return mbed_lwip_err_remap(err);
+            }
+            break;
+        }
+
+        convert_lwip_addr_to_mbed(&msgs[i].addr, netbuf_fromaddr(buf));
+        msgs[i].port = netbuf_fromport(buf);
+        msgs[i].len = netbuf_copy(buf, msgs[i].data, (u16_t)msgs[i].size);
+        netbuf_delete(buf);
+    }
+
+    return i;
+}
+
+static nsapi_error_t mbed_lwip_buf_alloc(nsapi_stack_t *stack, nsapi_buf_t *buf, nsapi_size_t size)
+{
+    if (size > 0xffff) {
+        return NSAPI_ERROR_PARAMETER;
+    }
+
+    struct pbuf *p = pbuf_alloc(PBUF_TRANSPORT, (u16_t)size, PBUF_RAM);
+    if (!p) {
+        return NSAPI_ERROR_NO_MEMORY;
+    }
+
+    *buf = p;
+    return 0;
+}
+
+static void mbed_lwip_buf_free(nsapi_stack_t *stack, nsapi_buf_t buf)
+{
+    pbuf_free((struct pbuf *)buf);
+}
+
+static nsapi_buf_t mbed_lwip_buf_segment(nsapi_stack_t *stack, nsapi_buf_t segment, void **data, nsapi_size_t *len)
+{
+    struct pbuf *p = (struct pbuf *)segment;
+
+    *data = p->payload;
+    *len = p->len;
+
+    /* The last pbuf of a packet may still link to the next packet */
+    return (p->len == p->tot_len) ? NULL : p->next;
+}
+
+static nsapi_size_or_error_t mbed_lwip_socket_recv_buf(nsapi_stack_t *stack, nsapi_socket_t handle, nsapi_buf_t *buf)
+{
+    struct lwip_socket *s = (struct lwip_socket *)handle;
+
+    if (!s->buf) {
+        err_t err = netconn_recv(s->conn, &s->buf);
+        s->offset = 0;
+
+        if (err != ERR_OK) {
+            return mbed_lwip_err_remap(err);
+        }
+    }
+
+    /* Hand over the pbufs after what was already read with recv */
+    u16_t offset;
+    struct pbuf *p = pbuf_skip(s->buf->p, s->offset, &offset);
+    pbuf_ref(p);
+    netbuf_delete(s->buf);
+    s->buf = 0;
+
+    pbuf_header(p, -(s16_t)offset);
+    *buf = p;
+    return p->tot_len;
+}
+
+static nsapi_size_or_error_t mbed_lwip_socket_recvfrom_buf(nsapi_stack_t *stack, nsapi_socket_t handle, nsapi_addr_t *addr, uint16_t *port, nsapi_buf_t *buf)
+{
+    struct lwip_socket *s = (struct lwip_socket *)handle;
+    struct netbuf *nbuf;
+
+    err_t err = netconn_recv(s->conn, &nbuf);
+    if (err != ERR_OK) {
+        return mbed_lwip_err_remap(err);
+    }
+
+    convert_lwip_addr_to_mbed(addr, netbuf_fromaddr(nbuf));
+    *port = netbuf_fromport(nbuf);
+
+    struct pbuf *p = nbuf->p;
+    nbuf->p = nbuf->ptr = NULL;
+    netbuf_delete(nbuf);
+
+    *buf = p;
+    return p->tot_len;
+}
+
+static nsapi_size_or_error_t mbed_lwip_socket_send_buf(nsapi_stack_t *stack, nsapi_socket_t handle, nsapi_buf_t buf, nsapi_size_t offset)
+{
+    struct lwip_socket *s = (struct lwip_socket *)handle;
+    struct pbuf *p = (struct pbuf *)buf;
+    nsapi_size_t sent = 0;
+    u16_t skip;
+
+    if (offset >= p->tot_len) {
+        return 0;
+    }
+
+    /* lwIP has no way to queue a pbuf on a TCP connection, so the data is
+     * copied into the segments of the connection */
+    for (p = pbuf_skip(p, (u16_t)offset, &skip); p; p = p->next) {
+        size_t bytes_written = 0;
+        err_t err = netconn_write_partly(s->conn, (u8_t *)p->payload + skip,
+                p->len - skip, NETCONN_COPY, &bytes_written);
+        if (err != ERR_OK) {
+            return sent ? (nsapi_size_or_error_t)sent : mbed_lwip_err_remap(err);
+        }
+
+        sent += bytes_written;
+        if (bytes_written < (size_t)(p->len - skip) || p->len == p->tot_len) {
+            break;
+        }
+        skip = 0;
+    }
+
+    return (nsapi_size_or_error_t)sent;
+}
+
+static nsapi_size_or_error_t mbed_lwip_socket_sendto_buf(nsapi_stack_t *stack, nsapi_socket_t handle, nsapi_addr_t addr, uint16_t port, nsapi_buf_t buf)
+{
+    struct lwip_socket *s = (struct lwip_socket *)handle;
+    struct pbuf *p = (struct pbuf *)buf;
+    ip_addr_t ip_addr;
+
+    if (!convert_mbed_addr_to_lwip(&ip_addr, &addr)) {
+        return NSAPI_ERROR_PARAMETER;
+    }
+
+    struct netbuf *nbuf = netbuf_new();
+    if (!nbuf) {
+        return NSAPI_ERROR_NO_MEMORY;
+    }
+
+    /* The pbuf is sent as it is, and stays owned by the caller */
+    u16_t size = p->tot_len;
+    nbuf->p = nbuf->ptr = p;
+    err_t err = netconn_sendto(s->conn, nbuf, &ip_addr, port);
+    nbuf->p = nbuf->ptr = NULL;
+    netbuf_delete(nbuf);
+    if (err != ERR_OK) {
+        return mbed_lwip_err_remap(err);
+    }
+
+    return size;
+}
+
 static nsapi_error_t mbed_lwip_setsockopt(nsapi_stack_t *stack, nsapi_socket_t handle, int level, int optname, const void *optval, unsigned optlen)
 {
     struct lwip_socket *s = (struct lwip_socket *)handle;
@@ -1109,8 +1355,49 @@ static nsapi_error_t mbed_lwip_setsockopt(nsapi_stack_t *stack, nsapi_socket_t h
 
             s->conn->pcb.tcp->keep_intvl = *(int*)optval;
             return 0;
+
+#if LWIP_SO_LINGER
+        case NSAPI_LINGER: {
+            if (optlen != sizeof(nsapi_linger_t) || NETCONNTYPE_GROUP(s->conn->type) != NETCONN_TCP) {
+                return NSAPI_ERROR_UNSUPPORTED;
+            }
+
+            const nsapi_linger_t *linger = (const nsapi_linger_t *)optval;
+            if (!linger->l_onoff) {
+                s->conn->linger = -1;
+            } else if (linger->l_linger >= 0 && linger->l_linger <= 0x7fff) {
+                s->conn->linger = linger->l_linger;
+            } else {
+                return NSAPI_ERROR_PARAMETER;
+            }
+            return 0;
+        }
+#endif
+#endif
+
+#if LWIP_SO_RCVBUF
+        case NSAPI_RCVBUF:
+            // Bytes of datagrams queued before further ones are dropped,
+            // the TCP receive window is shared by all connections
+            if (optlen != sizeof(int) || NETCONNTYPE_GROUP(s->conn->type) != NETCONN_UDP
+                    || *(int *)optval <= 0) {
+                return NSAPI_ERROR_UNSUPPORTED;
+            }
+
+            netconn_set_recvbufsize(s->conn, *(int *)optval);
+            return 0;
 #endif
 
+        case NSAPI_PRIORITY:
+            if (optlen != sizeof(int) || *(int *)optval < 0 || *(int *)optval > 7) {
+                return NSAPI_ERROR_UNSUPPORTED;
+            }
+
+            // The IP precedence, the top bits of the TOS or traffic class,
+            // which the EMAC layer picks the transmit queue of a frame by
+            s->conn->pcb.ip->tos = (s->conn->pcb.ip->tos & 0x1F) | (*(int *)optval << 5);
+            return 0;
+
         case NSAPI_REUSEADDR:
             if (optlen != sizeof(int)) {
                 return NSAPI_ERROR_UNSUPPORTED;
@@ -1136,6 +1423,38 @@ static void mbed_lwip_socket_attach(nsapi_stack_t *stack, nsapi_socket_t handle,
     s->data = data;
 }
 
+int mbed_lwip_get_pool_stats(mbed_lwip_pool_stats_t *stats, int count)
+{
+#if MEM_STATS && MEMP_STATS
+    int n = 0;
+    SYS_ARCH_DECL_PROTECT(lev);
+
+    SYS_ARCH_PROTECT(lev);
+    if (n < count) {
+        stats[n].name = "HEAP";
+        stats[n].avail = lwip_stats.mem.avail;
+        stats[n].used = lwip_stats.mem.used;
+        stats[n].max = lwip_stats.mem.max;
+        stats[n].err = lwip_stats.mem.err;
+        n++;
+    }
+
+    for (int i = 0; i < MEMP_MAX && n < count; i++, n++) {
+        const struct stats_mem *mem = memp_pools[i]->stats;
+        stats[n].name = memp_pools[i]->desc;
+        stats[n].avail = mem->avail;
+        stats[n].used = mem->used;
+        stats[n].max = mem->max;
+        stats[n].err = mem->err;
+    }
+    SYS_ARCH_UNPROTECT(lev);
+
+    return n;
+#else
+    return NSAPI_ERROR_UNSUPPORTED;
+#endif
+}
+
 /* LWIP network stack */
 const nsapi_stack_api_t lwip_stack_api = {
     .gethostbyname      = mbed_lwip_gethostbyname,
@@ -1152,6 +1471,15 @@ const nsapi_stack_api_t lwip_stack_api = {
     .socket_recvfrom    = mbed_lwip_socket_recvfrom,
     .setsockopt         = mbed_lwip_setsockopt,
     .socket_attach      = mbed_lwip_socket_attach,
+    .buf_alloc          = mbed_lwip_buf_alloc,
+    .buf_free           = mbed_lwip_buf_free,
+    .buf_segment        = mbed_lwip_buf_segment,
+    .socket_recv_buf    = mbed_lwip_socket_recv_buf,
+    .socket_recvfrom_buf = mbed_lwip_socket_recvfrom_buf,
+    .socket_send_buf    = mbed_lwip_socket_send_buf,
+    .socket_sendto_buf  = mbed_lwip_socket_sendto_buf,
+    .socket_sendto_batch = mbed_lwip_socket_sendto_batch,
+    .socket_recvfrom_batch = mbed_lwip_socket_recvfrom_batch,
 };
 
 nsapi_stack_t lwip_stack = {
@@ -38,6 +38,27 @@ char *mbed_lwip_get_ip_address(char *buf, nsapi_size_t buflen);
 char *mbed_lwip_get_netmask(char *buf, nsapi_size_t buflen);
 char *mbed_lwip_get_gateway(char *buf, nsapi_size_t buflen);
 
+/** Usage of the lwIP heap or of a memory pool */
+typedef struct {
+    const char *name;   /**< Name of the heap or pool */
+    uint32_t avail;     /**< Size of the heap in bytes, or number of pool elements */
+    uint32_t used;      /**< Currently used */
+    uint32_t max;       /**< High-water mark of used */
+    uint32_t err;       /**< Number of failed allocations */
+} mbed_lwip_pool_stats_t;
+
+/** Get the usage of the lwIP heap and memory pools
+ *
+ *  The heap comes first, followed by the pools, PBUF_POOL among them.
+ *  Needs the lwip.stats-enabled configuration option.
+ *
+ *  @param stats    Destination array for the statistics
+ *  @param count    Number of entries in stats
+ *  @return         Number of entries filled in, or NSAPI_ERROR_UNSUPPORTED
+ *                  without statistics
+ */
+int mbed_lwip_get_pool_stats(mbed_lwip_pool_stats_t *stats, int count);
+
 extern nsapi_stack_t lwip_stack;
 
 #ifdef __cplusplus
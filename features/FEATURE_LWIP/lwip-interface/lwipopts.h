@@ -88,11 +88,16 @@
 
 #define LWIP_RAW                    0
 
-#define TCPIP_MBOX_SIZE             8
-#define DEFAULT_TCP_RECVMBOX_SIZE   8
-#define DEFAULT_UDP_RECVMBOX_SIZE   8
-#define DEFAULT_RAW_RECVMBOX_SIZE   8
-#define DEFAULT_ACCEPTMBOX_SIZE     8
+// Size of the mailboxes of the tcpip thread and each netconn
+#ifndef MBED_CONF_LWIP_MBOX_SIZE
+#define MBED_CONF_LWIP_MBOX_SIZE    8
+#endif
+
+#define TCPIP_MBOX_SIZE             MBED_CONF_LWIP_MBOX_SIZE
+#define DEFAULT_TCP_RECVMBOX_SIZE   MBED_CONF_LWIP_MBOX_SIZE
+#define DEFAULT_UDP_RECVMBOX_SIZE   MBED_CONF_LWIP_MBOX_SIZE
+#define DEFAULT_RAW_RECVMBOX_SIZE   MBED_CONF_LWIP_MBOX_SIZE
+#define DEFAULT_ACCEPTMBOX_SIZE     MBED_CONF_LWIP_MBOX_SIZE
 
 // Thread stack size for lwip tcpip thread
 #ifndef MBED_CONF_LWIP_TCPIP_THREAD_STACKSIZE
@@ -105,7 +110,25 @@
 #define TCPIP_THREAD_STACKSIZE      MBED_CONF_LWIP_TCPIP_THREAD_STACKSIZE
 #endif
 
-#define TCPIP_THREAD_PRIO           (osPriorityNormal)
+// Priority of the lwip tcpip thread
+#ifndef MBED_CONF_LWIP_TCPIP_THREAD_PRIORITY
+#define MBED_CONF_LWIP_TCPIP_THREAD_PRIORITY       osPriorityNormal
+#endif
+
+#define TCPIP_THREAD_PRIO           (MBED_CONF_LWIP_TCPIP_THREAD_PRIORITY)
+
+// With core locking, API calls run under the core lock in the calling
+// thread instead of being posted to the tcpip thread, and with input core
+// locking so do received frames in the driver's thread.
+#if MBED_CONF_LWIP_CORE_LOCKING
+#define LWIP_TCPIP_CORE_LOCKING     1
+#else
+#define LWIP_TCPIP_CORE_LOCKING     0
+#endif
+
+#if MBED_CONF_LWIP_CORE_LOCKING_INPUT
+#define LWIP_TCPIP_CORE_LOCKING_INPUT 1
+#endif
 
 // Thread stack size for lwip system threads
 #ifndef MBED_CONF_LWIP_DEFAULT_THREAD_STACKSIZE
@@ -117,6 +140,11 @@
 #define MBED_CONF_LWIP_PPP_THREAD_STACKSIZE    768
 #endif
 
+// Size of the buffer the PPP input is read into from the serial stream
+#ifndef MBED_CONF_LWIP_PPP_INPUT_BUFFER_SIZE
+#define MBED_CONF_LWIP_PPP_INPUT_BUFFER_SIZE    128
+#endif
+
 #ifdef LWIP_DEBUG
 #define DEFAULT_THREAD_STACKSIZE    MBED_CONF_LWIP_DEFAULT_THREAD_STACKSIZE*2
 #define PPP_THREAD_STACK_SIZE       MBED_CONF_LWIP_PPP_THREAD_STACKSIZE*2
@@ -125,7 +153,11 @@
 #define PPP_THREAD_STACK_SIZE       MBED_CONF_LWIP_PPP_THREAD_STACKSIZE
 #endif
 
+#ifdef MBED_CONF_LWIP_MEMP_NUM_SYS_TIMEOUT
+#define MEMP_NUM_SYS_TIMEOUT        MBED_CONF_LWIP_MEMP_NUM_SYS_TIMEOUT
+#else
 #define MEMP_NUM_SYS_TIMEOUT        16
+#endif
 
 #define sys_msleep(ms) sys_msleep(ms)
 
@@ -136,12 +168,53 @@
 
 #define LWIP_RAM_HEAP_POINTER       lwip_ram_heap
 
+// Configured sizes override the defaults of the target's lwipopts_conf.h
+// Size of the heap for RAM pbufs and other dynamic allocations.
+#ifdef MBED_CONF_LWIP_MEM_SIZE
+#undef MEM_SIZE
+#define MEM_SIZE                    MBED_CONF_LWIP_MEM_SIZE
+#endif
+
 // Number of pool pbufs.
 // Each requires 684 bytes of RAM.
-#ifndef PBUF_POOL_SIZE
+#ifdef MBED_CONF_LWIP_PBUF_POOL_SIZE
+#undef PBUF_POOL_SIZE
+#define PBUF_POOL_SIZE              MBED_CONF_LWIP_PBUF_POOL_SIZE
+#elif !defined PBUF_POOL_SIZE
 #define PBUF_POOL_SIZE              5
 #endif
 
+#ifdef MBED_CONF_LWIP_PBUF_POOL_BUFSIZE
+#undef PBUF_POOL_BUFSIZE
+#define PBUF_POOL_BUFSIZE           MBED_CONF_LWIP_PBUF_POOL_BUFSIZE
+#endif
+
+#ifdef MBED_CONF_LWIP_TCP_MSS
+#undef TCP_MSS
+#define TCP_MSS                     MBED_CONF_LWIP_TCP_MSS
+#endif
+
+#ifdef MBED_CONF_LWIP_TCP_WND
+#undef TCP_WND
+#define TCP_WND                     MBED_CONF_LWIP_TCP_WND
+#endif
+
+#ifdef MBED_CONF_LWIP_TCP_SND_BUF
+#undef TCP_SND_BUF
+#define TCP_SND_BUF                 MBED_CONF_LWIP_TCP_SND_BUF
+#endif
+
+#ifdef MBED_CONF_LWIP_TCP_SND_QUEUELEN
+#undef TCP_SND_QUEUELEN
+#define TCP_SND_QUEUELEN            MBED_CONF_LWIP_TCP_SND_QUEUELEN
+#endif
+
+// Number of TCP segments queued for sending or out of sequence.
+#ifdef MBED_CONF_LWIP_MEMP_NUM_TCP_SEG
+#undef MEMP_NUM_TCP_SEG
+#define MEMP_NUM_TCP_SEG            MBED_CONF_LWIP_MEMP_NUM_TCP_SEG
+#endif
+
 // One tcp_pcb_listen is needed for each TCPServer.
 // Each requires 72 bytes of RAM.
 #ifdef MBED_CONF_LWIP_TCP_SERVER_MAX
@@ -168,12 +241,18 @@
 
 // Number of non-pool pbufs.
 // Each requires 92 bytes of RAM.
-#ifndef MEMP_NUM_PBUF
+#ifdef MBED_CONF_LWIP_MEMP_NUM_PBUF
+#undef MEMP_NUM_PBUF
+#define MEMP_NUM_PBUF               MBED_CONF_LWIP_MEMP_NUM_PBUF
+#elif !defined MEMP_NUM_PBUF
 #define MEMP_NUM_PBUF               8
 #endif
 
 // Each netbuf requires 64 bytes of RAM.
-#ifndef MEMP_NUM_NETBUF
+#ifdef MBED_CONF_LWIP_MEMP_NUM_NETBUF
+#undef MEMP_NUM_NETBUF
+#define MEMP_NUM_NETBUF             MBED_CONF_LWIP_MEMP_NUM_NETBUF
+#elif !defined MEMP_NUM_NETBUF
 #define MEMP_NUM_NETBUF             8
 #endif
 
@@ -190,6 +269,9 @@
 #define TCP_QUEUE_OOSEQ             0
 #define TCP_OVERSIZE                0
 #define LWIP_TCP_KEEPALIVE          1
+// Connections beyond the backlog of a listener have their SYN dropped,
+// and are retried by the peer, rather than reset
+#define TCP_LISTEN_BACKLOG          1
 #else
 #define LWIP_TCP                    0
 #endif
@@ -199,6 +281,10 @@
 
 #define SO_REUSE                    1
 
+// Lets NSAPI_RCVBUF bound the datagrams queued on each UDP socket
+#define LWIP_SO_RCVBUF              1
+#define LWIP_SO_LINGER              1
+
 // Support Multicast
 #include "stdlib.h"
 #define LWIP_IGMP                   LWIP_IPV4
@@ -264,6 +350,29 @@
 #define LWIP_DBG_MIN_LEVEL          LWIP_DBG_LEVEL_ALL
 #else
 #define LWIP_NOASSERT               1
+#endif
+
+// Memory usage statistics, read with mbed_lwip_get_pool_stats
+#if MBED_CONF_LWIP_STATS_ENABLED
+#define LWIP_STATS                  1
+#define LWIP_STATS_DISPLAY          1
+#define MEM_STATS                   1
+#define MEMP_STATS                  1
+#define LINK_STATS                  0
+#define ETHARP_STATS                0
+#define IP_STATS                    0
+#define IPFRAG_STATS                0
+#define ICMP_STATS                  0
+#define IGMP_STATS                  0
+#define UDP_STATS                   0
+#define TCP_STATS                   0
+#define SYS_STATS                   0
+#define IP6_STATS                   0
+#define ICMP6_STATS                 0
+#define IP6_FRAG_STATS              0
+#define MLD6_STATS                  0
+#define ND6_STATS                   0
+#elif !defined LWIP_DEBUG
 #define LWIP_STATS                  0
 #endif
 
@@ -316,6 +425,9 @@
 // Checksum-on-copy disabled due to https://savannah.nongnu.org/bugs/?50914
 #define LWIP_CHECKSUM_ON_COPY       0
 
+// Checksums offloaded per interface, to the hardware of capable drivers
+#define LWIP_CHECKSUM_CTRL_PER_NETIF 1
+
 #define LWIP_NETIF_HOSTNAME         1
 #define LWIP_NETIF_STATUS_CALLBACK  1
 #define LWIP_NETIF_LINK_CALLBACK    1
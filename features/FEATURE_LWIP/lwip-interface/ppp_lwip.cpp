@@ -256,8 +256,10 @@ static void ppp_input()
 
     // Infinite loop, but we assume that we can read faster than the
     // serial, so we will fairly rapidly hit -EAGAIN.
+    // The buffer is static, as only the PPP thread reads, to drain the
+    // stream in large reads without taking it from the thread's stack.
+    static u8_t buffer[MBED_CONF_LWIP_PPP_INPUT_BUFFER_SIZE];
     for (;;) {
-        u8_t buffer[16];
         ssize_t len = my_stream->read(buffer, sizeof buffer);
         if (len == -EAGAIN) {
             break;
@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2017, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __UVISOR_LIB_PROFILE_H__
+#define __UVISOR_LIB_PROFILE_H__
+
+/* Cost of the uVisor boundary crossings
+ *
+ * A profile statistic counts the occurrences of an operation and keeps the
+ * total, shortest and longest time it took. Statistics are plain objects
+ * owned by the box that measures, one per operation of interest:
+ *
+ * - secure gateway calls and RPC round trips, timed around the gateway by the
+ *   calling box:
+ *
+ *       static uvisor_profile_stat_t crypto_rpc = UVISOR_PROFILE_STAT_INIT("box_crypto: hash");
+ *       UVISOR_PROFILE_CALL(&crypto_rpc, ret = secure_hash_gw(ctx, data, size));
+ *
+ * - virtualized interrupt delivery, from the interrupt being set pending to
+ *   the entry of its handler:
+ *
+ *       static uvisor_profile_stat_t irq_delivery = UVISOR_PROFILE_STAT_INIT("vIRQ delivery");
+ *       static void handler(void) { uvisor_profile_irq_entry(&irq_delivery); ... }
+ *       uvisor_profile_irq_trigger(&irq_delivery, irqn);
+ *
+ * - the virtualized NVIC operations of cmsis_nvic_virtual.h, timed with
+ *   UVISOR_PROFILE_CALL like the gateways.
+ *
+ * Naming the statistics after the box and the operation gives the cost per
+ * box, uvisor_profile_print printing them.
+ *
+ * Boxes run unprivileged and cannot read the DWT cycle counter, so times are
+ * read from UVISOR_PROFILE_TIMER(), us_ticker_read() by default, which the box
+ * measuring must have access to. A box owning another free running timer can
+ * define UVISOR_PROFILE_TIMER() before including this file to use it instead.
+ *
+ * Nothing is measured unless the uvisor-lib.profile configuration option is
+ * set: UVISOR_PROFILE_CALL then only evaluates the call. */
+
+#include "uvisor/api/inc/uvisor_exports.h"
+#include "cmsis.h"
+#include <stdint.h>
+#include <stdio.h>
+
+#ifndef MBED_CONF_UVISOR_LIB_PROFILE
+#define MBED_CONF_UVISOR_LIB_PROFILE 0
+#endif
+
+#ifndef UVISOR_PROFILE_TIMER
+#include "hal/us_ticker_api.h"
+#define UVISOR_PROFILE_TIMER() us_ticker_read()
+#endif
+
+typedef struct uvisor_profile_stat {
+    const char * name;
+    uint32_t count;
+    uint32_t total;
+    uint32_t min;
+    uint32_t max;
+    /* Start of the operation in progress, for interrupt delivery */
+    volatile uint32_t start;
+    volatile uint32_t started;
+} uvisor_profile_stat_t;
+
+#define UVISOR_PROFILE_STAT_INIT(stat_name) { (stat_name), 0, 0, 0xFFFFFFFFUL, 0, 0, 0 }
+
+/* Account for an operation that started at the given time. */
+static UVISOR_FORCEINLINE void uvisor_profile_record(uvisor_profile_stat_t * stat, uint32_t start)
+{
+    uint32_t duration = UVISOR_PROFILE_TIMER() - start;
+
+    stat->count++;
+    stat->total += duration;
+    if (duration < stat->min) {
+        stat->min = duration;
+    }
+    if (duration > stat->max) {
+        stat->max = duration;
+    }
+}
+
+#if MBED_CONF_UVISOR_LIB_PROFILE
+
+/* Evaluate `call` and account for the time it took. */
+#define UVISOR_PROFILE_CALL(stat, call) \
+    do { \
+        uint32_t __uvisor_profile_start = UVISOR_PROFILE_TIMER(); \
+        call; \
+        uvisor_profile_record((stat), __uvisor_profile_start); \
+    } while (0)
+
+#else
+
+#define UVISOR_PROFILE_CALL(stat, call) \
+    do { \
+        (void) (stat); \
+        call; \
+    } while (0)
+
+#endif
+
+/* Set an interrupt of the measuring box pending through uVisor, its handler
+ * calling uvisor_profile_irq_entry with the same statistic. */
+static UVISOR_FORCEINLINE void uvisor_profile_irq_trigger(uvisor_profile_stat_t * stat, uint32_t irqn)
+{
+    stat->start = UVISOR_PROFILE_TIMER();
+    stat->started = 1;
+    NVIC_SetPendingIRQ((IRQn_Type) irqn);
+}
+
+/* Account for the delivery of an interrupt set pending with
+ * uvisor_profile_irq_trigger, at the entry of its handler. */
+static UVISOR_FORCEINLINE void uvisor_profile_irq_entry(uvisor_profile_stat_t * stat)
+{
+    if (stat->started) {
+        stat->started = 0;
+        uvisor_profile_record(stat, stat->start);
+    }
+}
+
+static UVISOR_FORCEINLINE void uvisor_profile_reset(uvisor_profile_stat_t * stat)
+{
+    stat->count = 0;
+    stat->total = 0;
+    stat->min = 0xFFFFFFFFUL;
+    stat->max = 0;
+    stat->started = 0;
+}
+
+/* Print a statistic, times being in UVISOR_PROFILE_TIMER() ticks. */
+static inline void uvisor_profile_print(const uvisor_profile_stat_t * stat)
+{
+    if (stat->count == 0) {
+        printf("%-32s count 0\r\n", stat->name);
+        return;
+    }
+    printf("%-32s count %lu, min %lu, mean %lu, max %lu\r\n", stat->name,
+           (unsigned long) stat->count, (unsigned long) stat->min,
+           (unsigned long) (stat->total / stat->count), (unsigned long) stat->max);
+}
+
+#endif /* __UVISOR_LIB_PROFILE_H__ */
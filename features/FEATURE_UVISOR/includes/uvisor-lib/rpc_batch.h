@@ -0,0 +1,201 @@
+/*
+ * Copyright (c) 2017, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __UVISOR_LIB_RPC_BATCH_H__
+#define __UVISOR_LIB_RPC_BATCH_H__
+
+/* Batched RPC
+ *
+ * Every RPC is a message through the pool queues of the two boxes and a
+ * transition through uVisor. A box calling another one many times in a row
+ * can instead fill an array of calls and submit it with a single RPC: the
+ * target box runs the calls one after the other and writes each result back
+ * into the array, where the caller reads it.
+ *
+ * The array is shared memory: it must be readable and writable by the target
+ * box, such as memory of the public box when calling from the public box.
+ * The target only runs the functions of its own table, which the calls refer
+ * to by index, and refuses arrays in the memory of uVisor or of the secure
+ * boxes.
+ *
+ * Target box:
+ *
+ *     static uint32_t crypto_hash(uint32_t ctx, uint32_t data, uint32_t size, uint32_t unused);
+ *     static uint32_t crypto_finish(uint32_t ctx, uint32_t out, uint32_t unused0, uint32_t unused1);
+ *
+ *     static const TFN_Ptr crypto_batch_fns[] = {
+ *         (TFN_Ptr) crypto_hash,
+ *         (TFN_Ptr) crypto_finish,
+ *     };
+ *
+ *     UVISOR_BOX_RPC_BATCH_TARGET(crypto_batch, crypto_batch_fns);
+ *     UVISOR_BOX_RPC_GATEWAY_SYNC(box_crypto, crypto_batch_gw, crypto_batch, uint32_t, uint32_t, uint32_t);
+ *
+ * Calling box:
+ *
+ *     static uvisor_rpc_batch_call_t calls[8];
+ *     uvisor_rpc_batch_t batch;
+ *
+ *     uvisor_rpc_batch_init(&batch, calls, 8);
+ *     uvisor_rpc_batch_add(&batch, 0, ctx, (uint32_t) block, sizeof(block), 0);
+ *     int finish = uvisor_rpc_batch_add(&batch, 1, ctx, (uint32_t) digest, 0, 0);
+ *     if (uvisor_rpc_batch_submit(&batch, crypto_batch_gw) == 2) {
+ *         status = uvisor_rpc_batch_result(&batch, finish);
+ *     }
+ *
+ * An asynchronous gateway to the batch target submits the batch without
+ * waiting, rpc_fncall_wait then returning the number of calls run.
+ */
+
+#include "uvisor/api/inc/rpc_exports.h"
+#include "uvisor/api/inc/uvisor_exports.h"
+#include <stdint.h>
+#include <stddef.h>
+
+/* Most calls a batch can hold */
+#ifndef UVISOR_RPC_BATCH_MAX_CALLS
+#define UVISOR_RPC_BATCH_MAX_CALLS 64
+#endif
+
+/* A call of a batch: the index of the function in the table of the target,
+ * its parameters and, once run, its return value */
+typedef struct uvisor_rpc_batch_call {
+    uint32_t fn;
+    uint32_t p0;
+    uint32_t p1;
+    uint32_t p2;
+    uint32_t p3;
+    uint32_t result;
+} uvisor_rpc_batch_call_t;
+
+typedef struct uvisor_rpc_batch {
+    uvisor_rpc_batch_call_t * calls;
+    size_t capacity;
+    size_t count;
+} uvisor_rpc_batch_t;
+
+/* Gateway to a batch target, as declared with UVISOR_BOX_RPC_GATEWAY_SYNC */
+typedef uint32_t (*uvisor_rpc_batch_gateway_t)(uint32_t calls, uint32_t count);
+
+#if UVISOR_PRESENT == 1
+UVISOR_EXTERN const uint8_t __uvisor_bss_start[];
+UVISOR_EXTERN const uint8_t __uvisor_bss_end[];
+UVISOR_EXTERN const uint8_t __uvisor_page_start[];
+UVISOR_EXTERN const uint8_t __uvisor_page_end[];
+#endif
+
+/* Check that an array of calls is outside of the memory of uVisor and of the
+ * secure boxes, which a target must not write to on behalf of its caller. */
+static UVISOR_FORCEINLINE int uvisor_rpc_batch_is_shared(const uvisor_rpc_batch_call_t * calls, uint32_t count)
+{
+    uint32_t start = (uint32_t) calls;
+    uint32_t end = start + count * sizeof(uvisor_rpc_batch_call_t);
+
+    if (count > UVISOR_RPC_BATCH_MAX_CALLS || end < start) {
+        return 0;
+    }
+#if UVISOR_PRESENT == 1
+    if (start < (uint32_t) __uvisor_bss_end && end > (uint32_t) __uvisor_bss_start) {
+        return 0;
+    }
+    if (start < (uint32_t) __uvisor_page_end && end > (uint32_t) __uvisor_page_start) {
+        return 0;
+    }
+#endif
+    return 1;
+}
+
+/* Run the calls of a batch, in the target box. Return the number of calls
+ * run: the calls stop at the first one with an invalid function index, and
+ * none run if the array is not in shared memory. */
+static inline uint32_t uvisor_rpc_batch_dispatch(const TFN_Ptr fn_ptr_array[], size_t fn_count,
+                                                 uvisor_rpc_batch_call_t * calls, uint32_t count)
+{
+    uint32_t i;
+
+    if (!uvisor_rpc_batch_is_shared(calls, count)) {
+        return 0;
+    }
+    for (i = 0; i < count; i++) {
+        /* The caller can write to the array at any time: read the index once. */
+        uint32_t fn = *(volatile uint32_t *) &calls[i].fn;
+        if (fn >= fn_count) {
+            break;
+        }
+        calls[i].result = fn_ptr_array[fn](calls[i].p0, calls[i].p1, calls[i].p2, calls[i].p3);
+    }
+    return i;
+}
+
+/* Define the RPC target `target_name` running batches of calls to the
+ * functions of `fn_ptr_array`. Gateways to it take the array of calls and the
+ * number of calls, and return the number of calls run. */
+#define UVISOR_BOX_RPC_BATCH_TARGET(target_name, fn_ptr_array) \
+    static uint32_t target_name(uint32_t calls, uint32_t count) \
+    { \
+        return uvisor_rpc_batch_dispatch(fn_ptr_array, sizeof(fn_ptr_array) / sizeof(fn_ptr_array[0]), \
+                                         (uvisor_rpc_batch_call_t *) calls, count); \
+    }
+
+/* Prepare an empty batch, made of the calls array of a given capacity. */
+static UVISOR_FORCEINLINE void uvisor_rpc_batch_init(uvisor_rpc_batch_t * batch, uvisor_rpc_batch_call_t * calls, size_t capacity)
+{
+    batch->calls = calls;
+    batch->capacity = capacity < UVISOR_RPC_BATCH_MAX_CALLS ? capacity : UVISOR_RPC_BATCH_MAX_CALLS;
+    batch->count = 0;
+}
+
+/* Append a call to a batch. Return the index to read its result with, or -1
+ * if the batch is full. */
+static UVISOR_FORCEINLINE int uvisor_rpc_batch_add(uvisor_rpc_batch_t * batch, uint32_t fn,
+                                                   uint32_t p0, uint32_t p1, uint32_t p2, uint32_t p3)
+{
+    uvisor_rpc_batch_call_t * call;
+
+    if (batch->count >= batch->capacity) {
+        return -1;
+    }
+    call = &batch->calls[batch->count];
+    call->fn = fn;
+    call->p0 = p0;
+    call->p1 = p1;
+    call->p2 = p2;
+    call->p3 = p3;
+    call->result = 0;
+    return (int) batch->count++;
+}
+
+/* Run the calls of a batch with one RPC through the gateway of a batch
+ * target. Return the number of calls run, the batch is then empty but its
+ * results can be read until the next call is added. */
+static UVISOR_FORCEINLINE uint32_t uvisor_rpc_batch_submit(uvisor_rpc_batch_t * batch, uvisor_rpc_batch_gateway_t gateway)
+{
+    uint32_t count = batch->count;
+
+    batch->count = 0;
+    if (count == 0) {
+        return 0;
+    }
+    return gateway((uint32_t) batch->calls, count);
+}
+
+/* Read the return value of a call of the last batch submitted. */
+static UVISOR_FORCEINLINE uint32_t uvisor_rpc_batch_result(const uvisor_rpc_batch_t * batch, int call)
+{
+    return batch->calls[call].result;
+}
+
+#endif /* __UVISOR_LIB_RPC_BATCH_H__ */
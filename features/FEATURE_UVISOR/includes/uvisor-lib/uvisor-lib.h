@@ -42,5 +42,6 @@
 #include "uvisor/api/inc/uvisor-lib.h"
 #include "uvisor-lib/rtx/rtx_box_index.h"
 #include "uvisor-lib/rtx/secure_allocator.h"
+#include "uvisor-lib/rpc_batch.h"
 
 #endif /* __UVISOR_LIB_UVISOR_LIB_H__ */
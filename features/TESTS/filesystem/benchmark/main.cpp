@@ -0,0 +1,483 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity.h"
+#include "utest.h"
+#include <stdlib.h>
+
+using namespace utest::v1;
+
+/* Measures a block device and a filesystem on it: sequential read, program
+ * and erase throughput of the device, then sequential and random file
+ * throughput, sync latency and the rate small files are created and removed
+ * at, for several I/O sizes. The results are collected by the
+ * benchmark_report host test.
+ *
+ * The block device and filesystem are chosen with benchmark-block-device and
+ * benchmark-filesystem, see template_mbed_app.txt. Everything on the block
+ * device is erased.
+ */
+
+#ifndef MBED_EXTENDED_TESTS
+    #error [NOT_SUPPORTED] Filesystem tests not supported by default
+#endif
+
+#define HEAP    1
+#define SD      2
+#define SPIF    3
+
+#define FAT     1
+#define LOG     2
+
+#ifndef MBED_CONF_APP_BENCHMARK_BLOCK_DEVICE
+#define MBED_CONF_APP_BENCHMARK_BLOCK_DEVICE HEAP
+#endif
+
+#ifndef MBED_CONF_APP_BENCHMARK_FILESYSTEM
+#define MBED_CONF_APP_BENCHMARK_FILESYSTEM FAT
+#endif
+
+#ifndef MBED_CONF_APP_BENCHMARK_HEAP_SIZE
+#define MBED_CONF_APP_BENCHMARK_HEAP_SIZE   (64 * 1024)
+#endif
+
+#ifndef MBED_CONF_APP_BENCHMARK_SIZE
+#define MBED_CONF_APP_BENCHMARK_SIZE        (16 * 1024)
+#endif
+
+#if MBED_CONF_APP_BENCHMARK_BLOCK_DEVICE == HEAP
+#include "HeapBlockDevice.h"
+// sparse, so large devices only take memory for the blocks in use
+HeapBlockDevice bd(MBED_CONF_APP_BENCHMARK_HEAP_SIZE, 512, 512, 512, 0xff);
+#elif MBED_CONF_APP_BENCHMARK_BLOCK_DEVICE == SD
+#if !defined(MBED_CONF_SD_SPI_MOSI)
+#error [NOT_SUPPORTED] The sd-driver library and its pins are needed for this test
+#endif
+#include "SDBlockDevice.h"
+SDBlockDevice bd(MBED_CONF_SD_SPI_MOSI, MBED_CONF_SD_SPI_MISO,
+        MBED_CONF_SD_SPI_CLK, MBED_CONF_SD_SPI_CS);
+#elif MBED_CONF_APP_BENCHMARK_BLOCK_DEVICE == SPIF
+#if !defined(MBED_CONF_SPIF_DRIVER_SPI_MOSI)
+#error [NOT_SUPPORTED] The spif-driver library and its pins are needed for this test
+#endif
+#include "SPIFBlockDevice.h"
+SPIFBlockDevice bd(MBED_CONF_SPIF_DRIVER_SPI_MOSI, MBED_CONF_SPIF_DRIVER_SPI_MISO,
+        MBED_CONF_SPIF_DRIVER_SPI_CLK, MBED_CONF_SPIF_DRIVER_SPI_CS);
+#else
+#error [NOT_SUPPORTED] Unknown benchmark-block-device
+#endif
+
+#if MBED_CONF_APP_BENCHMARK_FILESYSTEM == FAT
+#include "FATFileSystem.h"
+FATFileSystem fs("bench");
+#elif MBED_CONF_APP_BENCHMARK_FILESYSTEM == LOG
+#include "LogFileSystem.h"
+LogFileSystem fs("bench");
+#else
+#error [NOT_SUPPORTED] Unknown benchmark-filesystem
+#endif
+
+#define MAX_IO_SIZE         8192
+#define ROUNDS              3
+#define SAMPLES             32
+#define SMALL_FILES         16
+#define SMALL_FILE_SIZE     64
+
+static uint32_t kbyte_per_s(uint64_t bytes, uint32_t us)
+{
+    return us ? bytes * 1000000 / 1024 / us : 0;
+}
+
+static uint32_t per_s(uint32_t count, uint32_t us)
+{
+    return us ? (uint64_t)count * 1000000 / us : 0;
+}
+
+static bd_size_t round_up(bd_size_t size, bd_size_t unit)
+{
+    return ((size + unit - 1) / unit) * unit;
+}
+
+static uint8_t buffer[MAX_IO_SIZE];
+static Timer timer;
+
+// Bytes of the device measured, from its start
+static bd_size_t bd_region()
+{
+    bd_size_t region = round_up(MBED_CONF_APP_BENCHMARK_SIZE, bd.get_erase_size());
+    return (region > bd.size()) ? bd.size() - bd.size() % bd.get_erase_size() : region;
+}
+
+
+// Block device benchmarks
+void test_bd_init()
+{
+    int err = bd.init();
+    TEST_ASSERT_EQUAL(0, err);
+
+    for (int i = 0; i < MAX_IO_SIZE; i++) {
+        buffer[i] = 0xff & rand();
+    }
+}
+
+void test_bd_erase()
+{
+    bd_size_t region = bd_region();
+    bench_result_t r;
+    bench_reset(&r);
+
+    for (int i = 0; i < ROUNDS; i++) {
+        timer.reset();
+        timer.start();
+        for (bd_addr_t addr = 0; addr < region; addr += bd.get_erase_size()) {
+            int err = bd.erase(addr, bd.get_erase_size());
+            TEST_ASSERT_EQUAL(0, err);
+        }
+        timer.stop();
+        bench_add(&r, kbyte_per_s(region, timer.read_us()));
+    }
+
+    bench_report("bd_erase", "KiB/s", &r);
+}
+
+template <bd_size_t IO_SIZE>
+void test_bd_program()
+{
+    bd_size_t size = round_up(IO_SIZE, bd.get_program_size());
+    bd_size_t region = bd_region();
+    if (size > MAX_IO_SIZE || size > region) {
+        TEST_IGNORE_MESSAGE("Program size of the device too large");
+    }
+    region -= region % size;
+
+    bench_result_t r;
+    bench_reset(&r);
+
+    for (int i = 0; i < ROUNDS; i++) {
+        int err = bd.erase(0, round_up(region, bd.get_erase_size()));
+        TEST_ASSERT_EQUAL(0, err);
+
+        timer.reset();
+        timer.start();
+        for (bd_addr_t addr = 0; addr < region; addr += size) {
+            err = bd.program(buffer, addr, size);
+            TEST_ASSERT_EQUAL(0, err);
+        }
+        err = bd.sync();
+        TEST_ASSERT_EQUAL(0, err);
+        timer.stop();
+        bench_add(&r, kbyte_per_s(region, timer.read_us()));
+    }
+
+    char name[32];
+    snprintf(name, sizeof(name), "bd_program_%lu", (unsigned long)size);
+    bench_report(name, "KiB/s", &r);
+}
+
+template <bd_size_t IO_SIZE>
+void test_bd_read()
+{
+    bd_size_t size = round_up(IO_SIZE, bd.get_read_size());
+    bd_size_t region = bd_region();
+    if (size > MAX_IO_SIZE || size > region) {
+        TEST_IGNORE_MESSAGE("Read size of the device too large");
+    }
+    region -= region % size;
+
+    bench_result_t r;
+    bench_reset(&r);
+
+    for (int i = 0; i < ROUNDS; i++) {
+        timer.reset();
+        timer.start();
+        for (bd_addr_t addr = 0; addr < region; addr += size) {
+            int err = bd.read(buffer, addr, size);
+            TEST_ASSERT_EQUAL(0, err);
+        }
+        timer.stop();
+        bench_add(&r, kbyte_per_s(region, timer.read_us()));
+    }
+
+    char name[32];
+    snprintf(name, sizeof(name), "bd_read_%lu", (unsigned long)size);
+    bench_report(name, "KiB/s", &r);
+}
+
+void test_bd_random_read()
+{
+    bd_size_t size = round_up(512, bd.get_read_size());
+    bd_size_t blocks = bd_region() / size;
+    bench_result_t r;
+    bench_reset(&r);
+
+    timer.reset();
+    timer.start();
+    uint32_t total = 0;
+    for (int i = 0; i < SAMPLES; i++) {
+        bd_addr_t addr = (rand() % blocks) * size;
+        uint32_t start = timer.read_us();
+        int err = bd.read(buffer, addr, size);
+        TEST_ASSERT_EQUAL(0, err);
+        uint32_t us = timer.read_us() - start;
+        bench_add(&r, us);
+        total += us;
+    }
+    timer.stop();
+
+    char name[32];
+    snprintf(name, sizeof(name), "bd_random_read_%lu", (unsigned long)size);
+    bench_report(name, "us", &r);
+
+    bench_reset(&r);
+    bench_add(&r, per_s(SAMPLES, total));
+    bench_report(name, "ops/s", &r);
+}
+
+void test_bd_deinit()
+{
+    int err = bd.deinit();
+    TEST_ASSERT_EQUAL(0, err);
+}
+
+
+// Filesystem benchmarks
+void test_fs_format()
+{
+    bench_result_t r;
+    bench_reset(&r);
+
+    timer.reset();
+    timer.start();
+    int err = fs.reformat(&bd);
+    TEST_ASSERT_EQUAL(0, err);
+    timer.stop();
+    bench_add(&r, timer.read_ms());
+    bench_report("fs_format", "ms", &r);
+
+    // Remount to time the mount alone
+    err = fs.unmount();
+    TEST_ASSERT_EQUAL(0, err);
+
+    bench_reset(&r);
+    timer.reset();
+    timer.start();
+    err = fs.mount(&bd);
+    TEST_ASSERT_EQUAL(0, err);
+    timer.stop();
+    bench_add(&r, timer.read_us());
+    bench_report("fs_mount", "us", &r);
+}
+
+template <size_t IO_SIZE>
+void test_fs_write()
+{
+    bench_result_t r;
+    bench_reset(&r);
+
+    for (int i = 0; i < ROUNDS; i++) {
+        File file;
+        timer.reset();
+        timer.start();
+        int err = file.open(&fs, "bench.dat", O_WRONLY | O_CREAT | O_TRUNC);
+        TEST_ASSERT_EQUAL(0, err);
+        for (size_t j = 0; j < MBED_CONF_APP_BENCHMARK_SIZE; j += IO_SIZE) {
+            ssize_t size = file.write(buffer, IO_SIZE);
+            TEST_ASSERT_EQUAL(IO_SIZE, size);
+        }
+        err = file.close();
+        TEST_ASSERT_EQUAL(0, err);
+        timer.stop();
+        bench_add(&r, kbyte_per_s(MBED_CONF_APP_BENCHMARK_SIZE, timer.read_us()));
+    }
+
+    char name[32];
+    snprintf(name, sizeof(name), "fs_write_%lu", (unsigned long)IO_SIZE);
+    bench_report(name, "KiB/s", &r);
+}
+
+template <size_t IO_SIZE>
+void test_fs_read()
+{
+    bench_result_t r;
+    bench_reset(&r);
+
+    for (int i = 0; i < ROUNDS; i++) {
+        File file;
+        timer.reset();
+        timer.start();
+        int err = file.open(&fs, "bench.dat", O_RDONLY);
+        TEST_ASSERT_EQUAL(0, err);
+        for (size_t j = 0; j < MBED_CONF_APP_BENCHMARK_SIZE; j += IO_SIZE) {
+            ssize_t size = file.read(buffer, IO_SIZE);
+            TEST_ASSERT_EQUAL(IO_SIZE, size);
+        }
+        err = file.close();
+        TEST_ASSERT_EQUAL(0, err);
+        timer.stop();
+        bench_add(&r, kbyte_per_s(MBED_CONF_APP_BENCHMARK_SIZE, timer.read_us()));
+    }
+
+    char name[32];
+    snprintf(name, sizeof(name), "fs_read_%lu", (unsigned long)IO_SIZE);
+    bench_report(name, "KiB/s", &r);
+}
+
+void test_fs_random_read()
+{
+    const size_t size = 512;
+    bench_result_t r;
+    bench_reset(&r);
+
+    File file;
+    int err = file.open(&fs, "bench.dat", O_RDONLY);
+    TEST_ASSERT_EQUAL(0, err);
+
+    timer.reset();
+    timer.start();
+    uint32_t total = 0;
+    for (int i = 0; i < SAMPLES; i++) {
+        off_t off = (rand() % (MBED_CONF_APP_BENCHMARK_SIZE / size)) * size;
+        uint32_t start = timer.read_us();
+        off_t res = file.seek(off, SEEK_SET);
+        TEST_ASSERT_EQUAL(off, res);
+        ssize_t read = file.read(buffer, size);
+        TEST_ASSERT_EQUAL(size, read);
+        uint32_t us = timer.read_us() - start;
+        bench_add(&r, us);
+        total += us;
+    }
+    timer.stop();
+
+    err = file.close();
+    TEST_ASSERT_EQUAL(0, err);
+
+    bench_report("fs_random_read_512", "us", &r);
+
+    bench_reset(&r);
+    bench_add(&r, per_s(SAMPLES, total));
+    bench_report("fs_random_read_512", "ops/s", &r);
+}
+
+void test_fs_sync()
+{
+    bench_result_t r;
+    bench_reset(&r);
+
+    File file;
+    int err = file.open(&fs, "sync.dat", O_WRONLY | O_CREAT | O_TRUNC);
+    TEST_ASSERT_EQUAL(0, err);
+
+    timer.reset();
+    timer.start();
+    for (int i = 0; i < SAMPLES; i++) {
+        ssize_t size = file.write(buffer, SMALL_FILE_SIZE);
+        TEST_ASSERT_EQUAL(SMALL_FILE_SIZE, size);
+        uint32_t start = timer.read_us();
+        err = file.sync();
+        TEST_ASSERT_EQUAL(0, err);
+        bench_add(&r, timer.read_us() - start);
+    }
+    timer.stop();
+
+    err = file.close();
+    TEST_ASSERT_EQUAL(0, err);
+
+    bench_report("fs_sync", "us", &r);
+}
+
+void test_fs_small_files()
+{
+    bench_result_t create;
+    bench_result_t remove;
+    bench_reset(&create);
+    bench_reset(&remove);
+
+    for (int i = 0; i < ROUNDS; i++) {
+        char path[16];
+
+        timer.reset();
+        timer.start();
+        for (int j = 0; j < SMALL_FILES; j++) {
+            snprintf(path, sizeof(path), "small%d", j);
+            File file;
+            int err = file.open(&fs, path, O_WRONLY | O_CREAT | O_TRUNC);
+            TEST_ASSERT_EQUAL(0, err);
+            ssize_t size = file.write(buffer, SMALL_FILE_SIZE);
+            TEST_ASSERT_EQUAL(SMALL_FILE_SIZE, size);
+            err = file.close();
+            TEST_ASSERT_EQUAL(0, err);
+        }
+        timer.stop();
+        bench_add(&create, per_s(SMALL_FILES, timer.read_us()));
+
+        timer.reset();
+        timer.start();
+        for (int j = 0; j < SMALL_FILES; j++) {
+            snprintf(path, sizeof(path), "small%d", j);
+            int err = fs.remove(path);
+            TEST_ASSERT_EQUAL(0, err);
+        }
+        timer.stop();
+        bench_add(&remove, per_s(SMALL_FILES, timer.read_us()));
+    }
+
+    bench_report("fs_create", "files/s", &create);
+    bench_report("fs_remove", "files/s", &remove);
+}
+
+void test_fs_unmount()
+{
+    int err = fs.unmount();
+    TEST_ASSERT_EQUAL(0, err);
+}
+
+
+// Test setup
+utest::v1::status_t test_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(300, "benchmark_report");
+    return verbose_test_setup_handler(number_of_cases);
+}
+
+Case cases[] = {
+    Case("Block device init", test_bd_init),
+    Case("Benchmark block device erase", test_bd_erase),
+    Case("Benchmark block device program 512", test_bd_program<512>),
+    Case("Benchmark block device program 8192", test_bd_program<8192>),
+    Case("Benchmark block device read 512", test_bd_read<512>),
+    Case("Benchmark block device read 8192", test_bd_read<8192>),
+    Case("Benchmark block device random read", test_bd_random_read),
+    Case("Block device deinit", test_bd_deinit),
+    Case("Benchmark filesystem format and mount", test_fs_format),
+    Case("Benchmark file write 64", test_fs_write<64>),
+    Case("Benchmark file write 512", test_fs_write<512>),
+    Case("Benchmark file write 8192", test_fs_write<8192>),
+    Case("Benchmark file read 64", test_fs_read<64>),
+    Case("Benchmark file read 512", test_fs_read<512>),
+    Case("Benchmark file read 8192", test_fs_read<8192>),
+    Case("Benchmark file random read", test_fs_random_read),
+    Case("Benchmark file sync", test_fs_sync),
+    Case("Benchmark small file create and remove", test_fs_small_files),
+    Case("Filesystem unmount", test_fs_unmount),
+};
+
+Specification specification(test_setup, cases);
+
+int main()
+{
+    return !Harness::run(specification);
+}
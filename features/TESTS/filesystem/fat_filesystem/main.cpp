@@ -146,6 +146,112 @@ void test_read_dir() {
 }
 
 
+// Test for seeking and reading through fragmented files
+#define FRAGMENT_SIZE 256
+#define FRAGMENT_COUNT 64
+
+static uint8_t test_fragment_byte(int file, off_t off) {
+    return 0xff & (off*7 + off/FRAGMENT_SIZE + file*3);
+}
+
+void test_seek_fragmented() {
+    FATFileSystem fs("fat");
+
+    int err = fs.mount(&bd);
+    TEST_ASSERT_EQUAL(0, err);
+
+    uint8_t *buffer = (uint8_t *)malloc(FRAGMENT_SIZE*FRAGMENT_COUNT);
+    TEST_ASSERT(buffer);
+
+    // write two files in turns so their clusters interleave
+    File file[2];
+    err = file[0].open(&fs, "test_fragment0.dat", O_WRONLY | O_CREAT | O_TRUNC);
+    TEST_ASSERT_EQUAL(0, err);
+    err = file[1].open(&fs, "test_fragment1.dat", O_WRONLY | O_CREAT | O_TRUNC);
+    TEST_ASSERT_EQUAL(0, err);
+
+    for (int j = 0; j < FRAGMENT_COUNT; j++) {
+        for (int k = 0; k < 2; k++) {
+            for (int i = 0; i < FRAGMENT_SIZE; i++) {
+                buffer[i] = test_fragment_byte(k, j*FRAGMENT_SIZE + i);
+            }
+            ssize_t size = file[k].write(buffer, FRAGMENT_SIZE);
+            TEST_ASSERT_EQUAL(FRAGMENT_SIZE, size);
+        }
+    }
+
+    for (int k = 0; k < 2; k++) {
+        err = file[k].close();
+        TEST_ASSERT_EQUAL(0, err);
+    }
+
+    for (int k = 0; k < 2; k++) {
+        const char *path = k ? "test_fragment1.dat" : "test_fragment0.dat";
+        err = file[k].open(&fs, path, O_RDONLY);
+        TEST_ASSERT_EQUAL(0, err);
+
+        // the whole file in one read
+        ssize_t size = file[k].read(buffer, FRAGMENT_SIZE*FRAGMENT_COUNT);
+        TEST_ASSERT_EQUAL(FRAGMENT_SIZE*FRAGMENT_COUNT, size);
+        for (int i = 0; i < FRAGMENT_SIZE*FRAGMENT_COUNT; i++) {
+            TEST_ASSERT_EQUAL(test_fragment_byte(k, i), buffer[i]);
+        }
+
+        // seek backwards through the file, across fragments
+        for (off_t off = FRAGMENT_SIZE*FRAGMENT_COUNT - 1000; off > 0; off -= 1337) {
+            off_t res = file[k].seek(off, SEEK_SET);
+            TEST_ASSERT_EQUAL(off, res);
+            size = file[k].read(buffer, 1000);
+            TEST_ASSERT_EQUAL(1000, size);
+            for (int i = 0; i < 1000; i++) {
+                TEST_ASSERT_EQUAL(test_fragment_byte(k, off + i), buffer[i]);
+            }
+        }
+
+        err = file[k].close();
+        TEST_ASSERT_EQUAL(0, err);
+    }
+
+    free(buffer);
+
+    err = fs.unmount();
+    TEST_ASSERT_EQUAL(0, err);
+}
+
+
+// Test for reading a file in place on a block device in memory
+void test_mapped() {
+    FATFileSystem fs("fat");
+
+    int err = fs.mount(&bd);
+    TEST_ASSERT_EQUAL(0, err);
+
+    // A file within a block of the HeapBlockDevice, which is mapped
+    const char data[] = "Hello World!\n";
+    File file;
+    err = file.open(&fs, "test_mapped.dat", O_WRONLY | O_CREAT | O_TRUNC);
+    TEST_ASSERT_EQUAL(0, err);
+    ssize_t size = file.write(data, sizeof(data));
+    TEST_ASSERT_EQUAL(sizeof(data), size);
+
+    // Files open for writing are not mapped
+    TEST_ASSERT_NULL(file.get_mapped_address());
+    err = file.close();
+    TEST_ASSERT_EQUAL(0, err);
+
+    err = file.open(&fs, "test_mapped.dat", O_RDONLY);
+    TEST_ASSERT_EQUAL(0, err);
+    const void *mapped = file.get_mapped_address();
+    TEST_ASSERT_NOT_NULL(mapped);
+    TEST_ASSERT_EQUAL(0, memcmp(data, mapped, sizeof(data)));
+    err = file.close();
+    TEST_ASSERT_EQUAL(0, err);
+
+    err = fs.unmount();
+    TEST_ASSERT_EQUAL(0, err);
+}
+
+
 // Test setup
 utest::v1::status_t test_setup(const size_t number_of_cases) {
     GREENTEA_SETUP(10, "default_auto");
@@ -157,6 +263,8 @@ Case cases[] = {
     Case("Testing read write < block", test_read_write<BLOCK_SIZE/2>),
     Case("Testing read write > block", test_read_write<2*BLOCK_SIZE>),
     Case("Testing dir iteration", test_read_dir),
+    Case("Testing seek fragmented", test_seek_fragmented),
+    Case("Testing mapped files", test_mapped),
 };
 
 Specification specification(test_setup, cases);
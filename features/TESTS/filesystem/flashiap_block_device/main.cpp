@@ -0,0 +1,117 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity.h"
+#include "utest.h"
+
+#include "FlashIAPBlockDevice.h"
+#include <stdlib.h>
+
+using namespace utest::v1;
+
+#if !DEVICE_FLASH
+    #error [NOT_SUPPORTED] Flash API not supported for this target
+#endif
+
+
+// Test block device on the last sector of the flash
+static uint32_t last_sector(uint32_t *size)
+{
+    FlashIAP flash;
+    int err = flash.init();
+    TEST_ASSERT_EQUAL(0, err);
+
+    uint32_t end = flash.get_flash_start() + flash.get_flash_size();
+    *size = flash.get_sector_size(end - 1);
+
+    err = flash.deinit();
+    TEST_ASSERT_EQUAL(0, err);
+    return end - *size;
+}
+
+void test_read_write() {
+    uint32_t size;
+    uint32_t address = last_sector(&size);
+    FlashIAPBlockDevice bd(address, size);
+
+    int err = bd.init();
+    TEST_ASSERT_EQUAL(0, err);
+    TEST_ASSERT_EQUAL(size, bd.size());
+    TEST_ASSERT_EQUAL(size, bd.get_erase_size());
+
+    bd_size_t block_size = bd.get_program_size();
+    uint8_t *write_block = new uint8_t[block_size];
+    uint8_t *read_block = new uint8_t[block_size];
+
+    // Fill with random sequence
+    srand(1);
+    for (bd_size_t i = 0; i < block_size; i++) {
+        write_block[i] = 0xff & rand();
+    }
+
+    err = bd.erase(0, bd.get_erase_size());
+    TEST_ASSERT_EQUAL(0, err);
+
+    err = bd.program(write_block, 0, block_size);
+    TEST_ASSERT_EQUAL(0, err);
+
+    err = bd.read(read_block, 0, block_size);
+    TEST_ASSERT_EQUAL(0, err);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(write_block, read_block, block_size);
+
+    // The flash reads in place at its address
+    const void *mapped = bd.get_mapped_address(0, block_size);
+    TEST_ASSERT_EQUAL(address, (uint32_t)(uintptr_t)mapped);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(write_block, (const uint8_t *)mapped, block_size);
+    TEST_ASSERT_NULL(bd.get_mapped_address(size, block_size));
+
+    err = bd.erase(0, bd.get_erase_size());
+    TEST_ASSERT_EQUAL(0, err);
+
+    delete[] write_block;
+    delete[] read_block;
+    err = bd.deinit();
+    TEST_ASSERT_EQUAL(0, err);
+}
+
+void test_outside_flash() {
+    uint32_t size;
+    uint32_t address = last_sector(&size);
+
+    // Past the end of the flash
+    FlashIAPBlockDevice bd(address, 2*size);
+    int err = bd.init();
+    TEST_ASSERT_NOT_EQUAL(0, err);
+}
+
+
+// Test setup
+utest::v1::status_t test_setup(const size_t number_of_cases) {
+    GREENTEA_SETUP(30, "default_auto");
+    return verbose_test_setup_handler(number_of_cases);
+}
+
+Case cases[] = {
+    Case("Testing read write and mapping", test_read_write),
+    Case("Testing flash outside the device", test_outside_flash),
+};
+
+Specification specification(test_setup, cases);
+
+int main() {
+    return !Harness::run(specification);
+}
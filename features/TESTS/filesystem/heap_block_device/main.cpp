@@ -132,6 +132,54 @@ void test_read_write() {
     TEST_ASSERT_EQUAL(0, err);
 }
 
+// Sparse devices only take memory for the blocks that are programmed
+void test_sparse() {
+    HeapBlockDevice bd(1024ULL*1024*1024, 1, 1, TEST_BLOCK_SIZE, 0xff);
+
+    int err = bd.init();
+    TEST_ASSERT_EQUAL(0, err);
+    TEST_ASSERT_EQUAL(0xff, bd.get_erase_value());
+    TEST_ASSERT_EQUAL(0, bd.get_memory_used());
+
+    uint8_t write_block[TEST_BLOCK_SIZE];
+    uint8_t read_block[TEST_BLOCK_SIZE];
+    err = bd.read(read_block, bd.size() - TEST_BLOCK_SIZE, TEST_BLOCK_SIZE);
+    TEST_ASSERT_EQUAL(0, err);
+    for (bd_size_t i = 0; i < TEST_BLOCK_SIZE; i++) {
+        TEST_ASSERT_EQUAL(0xff, read_block[i]);
+    }
+
+    bd_addr_t blocks[TEST_BLOCK_COUNT];
+    for (int b = 0; b < TEST_BLOCK_COUNT; b++) {
+        blocks[b] = (bd_addr_t)b * (bd.size() / TEST_BLOCK_COUNT);
+        memset(write_block, b, TEST_BLOCK_SIZE);
+        err = bd.program(write_block, blocks[b], TEST_BLOCK_SIZE);
+        TEST_ASSERT_EQUAL(0, err);
+    }
+    TEST_ASSERT_TRUE(bd.get_memory_used() >= TEST_BLOCK_COUNT*TEST_BLOCK_SIZE);
+    TEST_ASSERT_TRUE(bd.get_memory_used() < 2*TEST_BLOCK_COUNT*TEST_BLOCK_SIZE);
+
+    for (int b = 0; b < TEST_BLOCK_COUNT; b++) {
+        err = bd.read(read_block, blocks[b], TEST_BLOCK_SIZE);
+        TEST_ASSERT_EQUAL(0, err);
+        for (bd_size_t i = 0; i < TEST_BLOCK_SIZE; i++) {
+            TEST_ASSERT_EQUAL(b, read_block[i]);
+        }
+
+        err = bd.erase(blocks[b], TEST_BLOCK_SIZE);
+        TEST_ASSERT_EQUAL(0, err);
+        err = bd.read(read_block, blocks[b], TEST_BLOCK_SIZE);
+        TEST_ASSERT_EQUAL(0, err);
+        for (bd_size_t i = 0; i < TEST_BLOCK_SIZE; i++) {
+            TEST_ASSERT_EQUAL(0xff, read_block[i]);
+        }
+    }
+    TEST_ASSERT_TRUE(bd.get_memory_used() < TEST_BLOCK_COUNT*TEST_BLOCK_SIZE);
+
+    err = bd.deinit();
+    TEST_ASSERT_EQUAL(0, err);
+}
+
 
 // Test setup
 utest::v1::status_t test_setup(const size_t number_of_cases) {
@@ -141,6 +189,7 @@ utest::v1::status_t test_setup(const size_t number_of_cases) {
 
 Case cases[] = {
     Case("Testing read write random blocks", test_read_write),
+    Case("Testing sparse devices", test_sparse),
 };
 
 Specification specification(test_setup, cases);
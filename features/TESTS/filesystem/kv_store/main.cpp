@@ -0,0 +1,155 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity.h"
+#include "utest.h"
+
+#include "HeapBlockDevice.h"
+#include "KVStore.h"
+#include <stdlib.h>
+#include <errno.h>
+
+using namespace utest::v1;
+
+// Test block device
+#define BLOCK_SIZE 512
+HeapBlockDevice bd(16*BLOCK_SIZE, 1, 4, BLOCK_SIZE);
+
+
+// Test formatting
+void test_format() {
+    KVStore kv(&bd, 8);
+
+    int err = kv.format();
+    TEST_ASSERT_EQUAL(0, err);
+
+    err = kv.init();
+    TEST_ASSERT_EQUAL(0, err);
+    TEST_ASSERT_EQUAL(0, kv.count());
+
+    err = kv.deinit();
+    TEST_ASSERT_EQUAL(0, err);
+}
+
+// Test setting, getting and removing keys across mounts
+void test_set_get_remove() {
+    KVStore kv(&bd, 8);
+
+    int err = kv.init();
+    TEST_ASSERT_EQUAL(0, err);
+
+    err = kv.set("wifi/ssid", "mbed", 4);
+    TEST_ASSERT_EQUAL(0, err);
+    err = kv.set("wifi/pass", "secret", 6);
+    TEST_ASSERT_EQUAL(0, err);
+    err = kv.set("wifi/ssid", "mbed-os", 7);
+    TEST_ASSERT_EQUAL(0, err);
+
+    err = kv.deinit();
+    TEST_ASSERT_EQUAL(0, err);
+    err = kv.init();
+    TEST_ASSERT_EQUAL(0, err);
+    TEST_ASSERT_EQUAL(2, kv.count());
+
+    char buffer[16];
+    size_t size;
+    err = kv.get("wifi/ssid", buffer, sizeof(buffer), &size);
+    TEST_ASSERT_EQUAL(0, err);
+    TEST_ASSERT_EQUAL(7, size);
+    TEST_ASSERT_EQUAL_MEMORY("mbed-os", buffer, 7);
+
+    err = kv.get("wifi/pass", buffer, 2, &size);
+    TEST_ASSERT_EQUAL(-ENOMEM, err);
+    TEST_ASSERT_EQUAL(6, size);
+
+    err = kv.remove("wifi/pass");
+    TEST_ASSERT_EQUAL(0, err);
+    err = kv.remove("wifi/pass");
+    TEST_ASSERT_EQUAL(-ENOENT, err);
+
+    err = kv.deinit();
+    TEST_ASSERT_EQUAL(0, err);
+    err = kv.init();
+    TEST_ASSERT_EQUAL(0, err);
+
+    err = kv.get("wifi/pass", buffer, sizeof(buffer), &size);
+    TEST_ASSERT_EQUAL(-ENOENT, err);
+    TEST_ASSERT_EQUAL(1, kv.count());
+
+    err = kv.deinit();
+    TEST_ASSERT_EQUAL(0, err);
+}
+
+// Test updates that fill the area several times over
+void test_collect() {
+    KVStore kv(&bd, 8);
+
+    int err = kv.format();
+    TEST_ASSERT_EQUAL(0, err);
+    err = kv.init();
+    TEST_ASSERT_EQUAL(0, err);
+
+    uint8_t value[64];
+    for (int i = 0; i < 400; i++) {
+        char key[8];
+        snprintf(key, sizeof(key), "key%d", i % 8);
+        memset(value, i, sizeof(value));
+        err = kv.set(key, value, sizeof(value));
+        TEST_ASSERT_EQUAL(0, err);
+    }
+
+    err = kv.deinit();
+    TEST_ASSERT_EQUAL(0, err);
+    err = kv.init();
+    TEST_ASSERT_EQUAL(0, err);
+    TEST_ASSERT_EQUAL(8, kv.count());
+
+    for (int i = 400 - 8; i < 400; i++) {
+        char key[8];
+        snprintf(key, sizeof(key), "key%d", i % 8);
+        uint8_t buffer[64];
+        err = kv.get(key, buffer, sizeof(buffer));
+        TEST_ASSERT_EQUAL(0, err);
+        memset(value, i, sizeof(value));
+        TEST_ASSERT_EQUAL_MEMORY(value, buffer, sizeof(value));
+    }
+
+    err = kv.set("key8", value, sizeof(value));
+    TEST_ASSERT_EQUAL(-ENOSPC, err);
+
+    err = kv.deinit();
+    TEST_ASSERT_EQUAL(0, err);
+}
+
+
+// Test setup
+utest::v1::status_t test_setup(const size_t number_of_cases) {
+    GREENTEA_SETUP(10, "default_auto");
+    return verbose_test_setup_handler(number_of_cases);
+}
+
+Case cases[] = {
+    Case("Testing formating", test_format),
+    Case("Testing set get remove", test_set_get_remove),
+    Case("Testing collection", test_collect),
+};
+
+Specification specification(test_setup, cases);
+
+int main() {
+    return !Harness::run(specification);
+}
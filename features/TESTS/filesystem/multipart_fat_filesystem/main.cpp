@@ -164,6 +164,111 @@ void test_read_write() {
 }
 
 
+#if defined(MBED_CONF_RTOS_PRESENT)
+// Writes and checks a file of random data, many times over
+#define CONCURRENT_SIZE (2*BLOCK_SIZE)
+#define CONCURRENT_COUNT 16
+
+struct concurrent_test {
+    FATFileSystem *fs;
+    unsigned seed;
+    int err;
+};
+
+static void test_concurrent_thread(concurrent_test *test) {
+    uint8_t *buffer = (uint8_t *)malloc(CONCURRENT_SIZE);
+    if (!buffer) {
+        test->err = -ENOMEM;
+        return;
+    }
+
+    unsigned seed = test->seed;
+    test->err = 0;
+
+    for (int j = 0; j < CONCURRENT_COUNT && !test->err; j++) {
+        for (int i = 0; i < CONCURRENT_SIZE; i++) {
+            buffer[i] = 0xff & (seed*(j+1) + i);
+        }
+
+        File file;
+        test->err = file.open(test->fs, "test_concurrent.dat", O_WRONLY | O_CREAT | O_TRUNC);
+        if (test->err) {
+            break;
+        }
+        if (file.write(buffer, CONCURRENT_SIZE) != CONCURRENT_SIZE) {
+            test->err = -EIO;
+        }
+        file.close();
+        if (test->err) {
+            break;
+        }
+
+        memset(buffer, 0, CONCURRENT_SIZE);
+        test->err = file.open(test->fs, "test_concurrent.dat", O_RDONLY);
+        if (test->err) {
+            break;
+        }
+        if (file.read(buffer, CONCURRENT_SIZE) != CONCURRENT_SIZE) {
+            test->err = -EIO;
+        }
+        file.close();
+
+        for (int i = 0; i < CONCURRENT_SIZE && !test->err; i++) {
+            if (buffer[i] != (0xff & (seed*(j+1) + i))) {
+                test->err = -EILSEQ;
+            }
+        }
+    }
+
+    free(buffer);
+}
+
+// Volumes are locked independently, so both partitions are used at once
+void test_concurrent() {
+    MBRBlockDevice part1(&bd, 1);
+    int err = part1.init();
+    TEST_ASSERT_EQUAL(0, err);
+
+    MBRBlockDevice part2(&bd, 2);
+    err = part2.init();
+    TEST_ASSERT_EQUAL(0, err);
+
+    FATFileSystem fs1("fat1");
+    FATFileSystem fs2("fat2");
+
+    err = fs1.mount(&part1);
+    TEST_ASSERT_EQUAL(0, err);
+
+    err = fs2.mount(&part2);
+    TEST_ASSERT_EQUAL(0, err);
+
+    concurrent_test test1 = {&fs1, 1, 0};
+    concurrent_test test2 = {&fs2, 2, 0};
+
+    Thread thread(osPriorityNormal, 4096);
+    osStatus status = thread.start(callback(test_concurrent_thread, &test2));
+    TEST_ASSERT_EQUAL(osOK, status);
+    test_concurrent_thread(&test1);
+    thread.join();
+
+    TEST_ASSERT_EQUAL(0, test1.err);
+    TEST_ASSERT_EQUAL(0, test2.err);
+
+    err = fs1.unmount();
+    TEST_ASSERT_EQUAL(0, err);
+
+    err = fs2.unmount();
+    TEST_ASSERT_EQUAL(0, err);
+
+    err = part1.deinit();
+    TEST_ASSERT_EQUAL(0, err);
+
+    err = part2.deinit();
+    TEST_ASSERT_EQUAL(0, err);
+}
+#endif
+
+
 // Test setup
 utest::v1::status_t test_setup(const size_t number_of_cases) {
     GREENTEA_SETUP(10, "default_auto");
@@ -174,6 +279,9 @@ Case cases[] = {
     Case("Testing formating", test_format),
     Case("Testing read write < block", test_read_write<BLOCK_SIZE/2>),
     Case("Testing read write > block", test_read_write<2*BLOCK_SIZE>),
+#if defined(MBED_CONF_RTOS_PRESENT)
+    Case("Testing concurrent volumes", test_concurrent),
+#endif
 };
 
 Specification specification(test_setup, cases);
@@ -21,7 +21,10 @@
 #include "HeapBlockDevice.h"
 #include "SlicingBlockDevice.h"
 #include "ChainingBlockDevice.h"
+#include "StripingBlockDevice.h"
 #include "ProfilingBlockDevice.h"
+#include "CachingBlockDevice.h"
+#include "WearLevelingBlockDevice.h"
 #include <stdlib.h>
 
 using namespace utest::v1;
@@ -122,6 +125,11 @@ void test_slicing() {
     TEST_ASSERT_EQUAL(0, err);
 }
 
+// Completion of an asynchronous operation
+static void async_done(int *result, int err) {
+    *(volatile int *)result = err;
+}
+
 // Simple test which read/writes blocks on a chain of block devices
 void test_chaining() {
     HeapBlockDevice bd1((BLOCK_COUNT/2)*BLOCK_SIZE, BLOCK_SIZE);
@@ -171,12 +179,93 @@ void test_chaining() {
         TEST_ASSERT_EQUAL(0xff & rand(), read_block[i]);
     }
 
+    // Program and read across both block devices asynchronously
+    int results[2] = {1, 1};
+    err = chain.program_async(write_block, (BLOCK_COUNT/2 - 1)*BLOCK_SIZE, BLOCK_SIZE,
+            callback(async_done, &results[0]));
+    TEST_ASSERT_EQUAL(0, err);
+    err = chain.read_async(read_block, (BLOCK_COUNT/2 - 1)*BLOCK_SIZE, BLOCK_SIZE,
+            callback(async_done, &results[1]));
+    TEST_ASSERT_EQUAL(0, err);
+
+    while (results[0] == 1 || results[1] == 1);
+    TEST_ASSERT_EQUAL(0, results[0]);
+    TEST_ASSERT_EQUAL(0, results[1]);
+
+    // Check that the data was unmodified
+    srand(1);
+    for (int i = 0; i < BLOCK_SIZE; i++) {
+        TEST_ASSERT_EQUAL(0xff & rand(), read_block[i]);
+    }
+
     delete[] write_block;
     delete[] read_block;
     err = chain.deinit();
     TEST_ASSERT_EQUAL(0, err);
 }
 
+// Simple test which read/writes blocks on block devices interleaved in stripes
+void test_striping() {
+    HeapBlockDevice bd1((BLOCK_COUNT/2)*BLOCK_SIZE, BLOCK_SIZE);
+    HeapBlockDevice bd2((BLOCK_COUNT/2)*BLOCK_SIZE, BLOCK_SIZE);
+    uint8_t *write_block = new uint8_t[4*BLOCK_SIZE];
+    uint8_t *read_block = new uint8_t[4*BLOCK_SIZE];
+
+    // Test with stripes of two blocks
+    BlockDevice *bds[] = {&bd1, &bd2};
+    StripingBlockDevice stripe(bds, 2*BLOCK_SIZE);
+
+    int err = stripe.init();
+    TEST_ASSERT_EQUAL(0, err);
+
+    TEST_ASSERT_EQUAL(BLOCK_SIZE, stripe.get_program_size());
+    TEST_ASSERT_EQUAL(2*BLOCK_SIZE, stripe.get_stripe_size());
+    TEST_ASSERT_EQUAL(BLOCK_COUNT*BLOCK_SIZE, stripe.size());
+
+    // Fill with random sequence
+    srand(1);
+    for (int i = 0; i < 4*BLOCK_SIZE; i++) {
+        write_block[i] = 0xff & rand();
+    }
+
+    // Write and read blocks across three stripes
+    err = stripe.program(write_block, BLOCK_SIZE, 4*BLOCK_SIZE);
+    TEST_ASSERT_EQUAL(0, err);
+
+    err = stripe.read(read_block, BLOCK_SIZE, 4*BLOCK_SIZE);
+    TEST_ASSERT_EQUAL(0, err);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(write_block, read_block, 4*BLOCK_SIZE);
+
+    // Check that the stripes alternate between the block devices
+    err = bd1.read(read_block, BLOCK_SIZE, BLOCK_SIZE);
+    TEST_ASSERT_EQUAL(0, err);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(&write_block[0], read_block, BLOCK_SIZE);
+
+    err = bd2.read(read_block, 0, 2*BLOCK_SIZE);
+    TEST_ASSERT_EQUAL(0, err);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(&write_block[BLOCK_SIZE], read_block, 2*BLOCK_SIZE);
+
+    err = bd1.read(read_block, 2*BLOCK_SIZE, BLOCK_SIZE);
+    TEST_ASSERT_EQUAL(0, err);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(&write_block[3*BLOCK_SIZE], read_block, BLOCK_SIZE);
+
+    // Read across both block devices asynchronously
+    int result = 1;
+    memset(read_block, 0, 4*BLOCK_SIZE);
+    err = stripe.read_async(read_block, BLOCK_SIZE, 4*BLOCK_SIZE,
+            callback(async_done, &result));
+    TEST_ASSERT_EQUAL(0, err);
+
+    while (result == 1);
+    TEST_ASSERT_EQUAL(0, result);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(write_block, read_block, 4*BLOCK_SIZE);
+
+    delete[] write_block;
+    delete[] read_block;
+    err = stripe.deinit();
+    TEST_ASSERT_EQUAL(0, err);
+}
+
 // Simple test which read/writes blocks on a chain of block devices
 void test_profiling() {
     HeapBlockDevice bd(BLOCK_COUNT*BLOCK_SIZE, BLOCK_SIZE);
@@ -238,6 +327,431 @@ void test_profiling() {
     TEST_ASSERT_EQUAL(BLOCK_SIZE, erase_count);
 }
 
+// Test of the histograms and trace of a profiled block device
+void test_profiling_trace() {
+    HeapBlockDevice bd(BLOCK_COUNT*BLOCK_SIZE, BLOCK_SIZE);
+    uint8_t *block = new uint8_t[BLOCK_SIZE];
+    memset(block, 0, BLOCK_SIZE);
+
+    // Trace of 4 operations, fewer than are done
+    ProfilingBlockDevice profiler(&bd, 4);
+
+    int err = profiler.init();
+    TEST_ASSERT_EQUAL(0, err);
+
+    // Erase and program two blocks in order, then read them backwards
+    err = profiler.erase(0, 2*BLOCK_SIZE);
+    TEST_ASSERT_EQUAL(0, err);
+
+    for (int i = 0; i < 2; i++) {
+        err = profiler.program(block, i*BLOCK_SIZE, BLOCK_SIZE);
+        TEST_ASSERT_EQUAL(0, err);
+    }
+
+    for (int i = 1; i >= 0; i--) {
+        err = profiler.read(block, i*BLOCK_SIZE, BLOCK_SIZE);
+        TEST_ASSERT_EQUAL(0, err);
+    }
+
+    err = profiler.deinit();
+    TEST_ASSERT_EQUAL(0, err);
+
+    TEST_ASSERT_EQUAL(1, profiler.get_operation_count(ProfilingBlockDevice::PROFILE_ERASE));
+    TEST_ASSERT_EQUAL(2, profiler.get_operation_count(ProfilingBlockDevice::PROFILE_PROGRAM));
+    TEST_ASSERT_EQUAL(2, profiler.get_operation_count(ProfilingBlockDevice::PROFILE_READ));
+    TEST_ASSERT_EQUAL(1, profiler.get_sequential_count(ProfilingBlockDevice::PROFILE_PROGRAM));
+    TEST_ASSERT_EQUAL(0, profiler.get_sequential_count(ProfilingBlockDevice::PROFILE_READ));
+
+    // Every timed operation is in the histogram
+    uint32_t timed = 0;
+    const uint32_t *histogram = profiler.get_histogram(ProfilingBlockDevice::PROFILE_PROGRAM);
+    for (int i = 0; i < ProfilingBlockDevice::PROFILE_BUCKETS; i++) {
+        timed += histogram[i];
+    }
+    TEST_ASSERT_EQUAL(2, timed);
+
+    // The trace holds the last 4 operations, oldest first
+    ProfilingBlockDevice::profile_record records[8];
+    bd_size_t count = profiler.get_trace(records, 8);
+    TEST_ASSERT_EQUAL(4, count);
+    TEST_ASSERT_EQUAL(1, profiler.get_trace_dropped());
+
+    TEST_ASSERT_EQUAL(ProfilingBlockDevice::PROFILE_PROGRAM, records[0].op);
+    TEST_ASSERT_EQUAL(0, records[0].addr);
+    TEST_ASSERT_EQUAL(ProfilingBlockDevice::PROFILE_PROGRAM, records[1].op);
+    TEST_ASSERT_EQUAL(BLOCK_SIZE, records[1].addr);
+    TEST_ASSERT_EQUAL(ProfilingBlockDevice::PROFILE_READ, records[2].op);
+    TEST_ASSERT_EQUAL(BLOCK_SIZE, records[2].addr);
+    TEST_ASSERT_EQUAL(ProfilingBlockDevice::PROFILE_READ, records[3].op);
+    TEST_ASSERT_EQUAL(0, records[3].addr);
+    TEST_ASSERT_EQUAL(BLOCK_SIZE, records[3].size);
+
+    profiler.reset();
+    TEST_ASSERT_EQUAL(0, profiler.get_trace(records, 8));
+    TEST_ASSERT_EQUAL(0, profiler.get_operation_count(ProfilingBlockDevice::PROFILE_READ));
+
+    delete[] block;
+}
+
+// Test of the addresses blocks are mapped at through other block devices
+void test_mapping() {
+    HeapBlockDevice bd1((BLOCK_COUNT/2)*BLOCK_SIZE, BLOCK_SIZE);
+    HeapBlockDevice bd2((BLOCK_COUNT/2)*BLOCK_SIZE, BLOCK_SIZE);
+    uint8_t *block = new uint8_t[BLOCK_SIZE];
+    memset(block, 0x5a, BLOCK_SIZE);
+
+    BlockDevice *bds[] = {&bd1, &bd2};
+    ChainingBlockDevice chain(bds);
+    SlicingBlockDevice slice(&chain, BLOCK_SIZE);
+    ProfilingBlockDevice profiler(&slice);
+
+    int err = profiler.init();
+    TEST_ASSERT_EQUAL(0, err);
+
+    // Blocks that were never programmed are not in memory
+    TEST_ASSERT_NULL(profiler.get_mapped_address(0, BLOCK_SIZE));
+
+    // The last block of the first device and the first of the second
+    bd_addr_t addr = (BLOCK_COUNT/2 - 2)*BLOCK_SIZE;
+    err = profiler.erase(addr, 2*BLOCK_SIZE);
+    TEST_ASSERT_EQUAL(0, err);
+    err = profiler.program(block, addr, BLOCK_SIZE);
+    TEST_ASSERT_EQUAL(0, err);
+    err = profiler.program(block, addr + BLOCK_SIZE, BLOCK_SIZE);
+    TEST_ASSERT_EQUAL(0, err);
+
+    const void *mapped = profiler.get_mapped_address(addr + 16, BLOCK_SIZE - 16);
+    TEST_ASSERT_EQUAL(bd1.get_mapped_address(addr + BLOCK_SIZE + 16, BLOCK_SIZE - 16), mapped);
+    TEST_ASSERT_NOT_NULL(mapped);
+    TEST_ASSERT_EQUAL(0, memcmp(block, mapped, BLOCK_SIZE - 16));
+
+    // Ranges across the chained devices are not contiguous
+    TEST_ASSERT_NULL(profiler.get_mapped_address(addr, 2*BLOCK_SIZE));
+    TEST_ASSERT_NOT_NULL(profiler.get_mapped_address(addr + BLOCK_SIZE, BLOCK_SIZE));
+    TEST_ASSERT_NULL(profiler.get_mapped_address(profiler.size(), BLOCK_SIZE));
+
+    delete[] block;
+    err = profiler.deinit();
+    TEST_ASSERT_EQUAL(0, err);
+}
+
+// Simple test which read/writes blocks through a cache
+void test_caching() {
+    HeapBlockDevice bd(BLOCK_COUNT*BLOCK_SIZE, BLOCK_SIZE);
+    uint8_t *write_block = new uint8_t[BLOCK_SIZE];
+    uint8_t *read_block = new uint8_t[BLOCK_SIZE];
+
+    // Test with a cache of 2 blocks, profiled underneath
+    ProfilingBlockDevice profiler(&bd);
+    CachingBlockDevice cache(&profiler, 2, 1);
+
+    int err = cache.init();
+    TEST_ASSERT_EQUAL(0, err);
+
+    TEST_ASSERT_EQUAL(BLOCK_SIZE, cache.get_erase_size());
+    TEST_ASSERT_EQUAL(BLOCK_COUNT*BLOCK_SIZE, cache.size());
+
+    // Fill with random sequence
+    srand(1);
+    for (int i = 0; i < BLOCK_SIZE; i++) {
+        write_block[i] = 0xff & rand();
+    }
+
+    // Rewrite the same block, which stays in the cache
+    for (int i = 0; i < 4; i++) {
+        err = cache.erase(0, BLOCK_SIZE);
+        TEST_ASSERT_EQUAL(0, err);
+
+        err = cache.program(write_block, 0, BLOCK_SIZE);
+        TEST_ASSERT_EQUAL(0, err);
+
+        err = cache.read(read_block, 0, BLOCK_SIZE);
+        TEST_ASSERT_EQUAL(0, err);
+    }
+
+    TEST_ASSERT_EQUAL(0, profiler.get_read_count());
+    TEST_ASSERT_EQUAL(0, profiler.get_program_count());
+    TEST_ASSERT_EQUAL(0, profiler.get_erase_count());
+
+    // Check that the data was unmodified
+    srand(1);
+    for (int i = 0; i < BLOCK_SIZE; i++) {
+        TEST_ASSERT_EQUAL(0xff & rand(), read_block[i]);
+    }
+
+    // Sync writes the block back once, the heap needs no erase
+    err = cache.sync();
+    TEST_ASSERT_EQUAL(0, err);
+    TEST_ASSERT_EQUAL(BLOCK_SIZE, profiler.get_program_count());
+    TEST_ASSERT_EQUAL(0, profiler.get_erase_count());
+
+    err = bd.read(read_block, 0, BLOCK_SIZE);
+    TEST_ASSERT_EQUAL(0, err);
+
+    srand(1);
+    for (int i = 0; i < BLOCK_SIZE; i++) {
+        TEST_ASSERT_EQUAL(0xff & rand(), read_block[i]);
+    }
+
+    // Reading a block reads the next one ahead
+    profiler.reset();
+    err = cache.read(read_block, 2*BLOCK_SIZE, BLOCK_SIZE);
+    TEST_ASSERT_EQUAL(0, err);
+    err = cache.read(read_block, 3*BLOCK_SIZE, BLOCK_SIZE);
+    TEST_ASSERT_EQUAL(0, err);
+    TEST_ASSERT_EQUAL(2*BLOCK_SIZE, profiler.get_read_count());
+
+    // Programming more blocks than cached evicts and writes back the oldest
+    profiler.reset();
+    for (int i = 0; i < 4; i++) {
+        err = cache.erase(i*BLOCK_SIZE, BLOCK_SIZE);
+        TEST_ASSERT_EQUAL(0, err);
+
+        err = cache.program(write_block, i*BLOCK_SIZE, BLOCK_SIZE);
+        TEST_ASSERT_EQUAL(0, err);
+    }
+    TEST_ASSERT_EQUAL(2*BLOCK_SIZE, profiler.get_program_count());
+
+    // Transfers of several blocks go directly to the device
+    profiler.reset();
+    err = cache.erase(8*BLOCK_SIZE, 4*BLOCK_SIZE);
+    TEST_ASSERT_EQUAL(0, err);
+    TEST_ASSERT_EQUAL(4*BLOCK_SIZE, profiler.get_erase_count());
+
+    // Trimming a cached block drops it
+    err = cache.trim(3*BLOCK_SIZE, BLOCK_SIZE);
+    TEST_ASSERT_EQUAL(0, err);
+
+    profiler.reset();
+    err = cache.deinit();
+    TEST_ASSERT_EQUAL(0, err);
+    TEST_ASSERT_EQUAL(BLOCK_SIZE, profiler.get_program_count());
+
+    // Deinit wrote back the rest
+    for (int j = 0; j < 3; j++) {
+        err = bd.read(read_block, j*BLOCK_SIZE, BLOCK_SIZE);
+        TEST_ASSERT_EQUAL(0, err);
+
+        srand(1);
+        for (int i = 0; i < BLOCK_SIZE; i++) {
+            TEST_ASSERT_EQUAL(0xff & rand(), read_block[i]);
+        }
+    }
+
+    delete[] write_block;
+    delete[] read_block;
+}
+
+
+// Fill a block with a sequence given by its contents
+static void wl_fill(uint8_t *block, int seed) {
+    srand(seed);
+    for (int i = 0; i < BLOCK_SIZE; i++) {
+        block[i] = 0xff & rand();
+    }
+}
+
+// Test which rewrites a few blocks of a wear-leveled block device
+void test_wear_leveling() {
+    const int erase_size = 8*BLOCK_SIZE;
+    HeapBlockDevice bd(4*BLOCK_COUNT*erase_size, 16, 16, erase_size);
+    uint8_t *write_block = new uint8_t[BLOCK_SIZE];
+    uint8_t *read_block = new uint8_t[BLOCK_SIZE];
+
+    // 4 reserved erase blocks of 7 pages each, and a low threshold
+    WearLevelingBlockDevice wl(&bd, BLOCK_SIZE, 4, 8);
+
+    int err = wl.init();
+    TEST_ASSERT_EQUAL(0, err);
+
+    const int lblocks = (4*BLOCK_COUNT - 4) * 7;
+    TEST_ASSERT_EQUAL(BLOCK_SIZE, wl.get_erase_size());
+    TEST_ASSERT_EQUAL(lblocks*BLOCK_SIZE, wl.size());
+
+    // Unwritten blocks read as erased
+    err = wl.read(read_block, 0, BLOCK_SIZE);
+    TEST_ASSERT_EQUAL(0, err);
+    for (int i = 0; i < BLOCK_SIZE; i++) {
+        TEST_ASSERT_EQUAL(0xff, read_block[i]);
+    }
+
+    // Fill every block once, then rewrite the first few many times
+    int *seeds = new int[lblocks];
+    for (int j = 0; j < lblocks; j++) {
+        seeds[j] = j + 1;
+        wl_fill(write_block, seeds[j]);
+        err = wl.program(write_block, j*BLOCK_SIZE, BLOCK_SIZE);
+        TEST_ASSERT_EQUAL(0, err);
+    }
+
+    for (int k = 0; k < 4000; k++) {
+        int j = k % 4;
+        seeds[j] = lblocks + k + 1;
+        wl_fill(write_block, seeds[j]);
+        err = wl.program(write_block, j*BLOCK_SIZE, BLOCK_SIZE);
+        TEST_ASSERT_EQUAL(0, err);
+    }
+
+    // The blocks that were not rewritten were moved to spread the erases
+    uint32_t min, max;
+    wl.get_erase_counts(&min, &max);
+    TEST_ASSERT(max - min <= 2*8);
+
+    // Check the data once written, and again from the block device
+    for (int pass = 0; pass < 2; pass++) {
+        for (int j = 0; j < lblocks; j++) {
+            err = wl.read(read_block, j*BLOCK_SIZE, BLOCK_SIZE);
+            TEST_ASSERT_EQUAL(0, err);
+
+            wl_fill(write_block, seeds[j]);
+            TEST_ASSERT_EQUAL_UINT8_ARRAY(write_block, read_block, BLOCK_SIZE);
+        }
+
+        err = wl.deinit();
+        TEST_ASSERT_EQUAL(0, err);
+        err = wl.init();
+        TEST_ASSERT_EQUAL(0, err);
+    }
+
+    // Collecting frees the reserved erase blocks ahead of the writes
+    err = wl.trim(0, 4*BLOCK_SIZE);
+    TEST_ASSERT_EQUAL(0, err);
+    err = wl.collect();
+    TEST_ASSERT_EQUAL(0, err);
+
+    err = wl.deinit();
+    TEST_ASSERT_EQUAL(0, err);
+
+    delete[] seeds;
+    delete[] write_block;
+    delete[] read_block;
+}
+
+
+// Next of a sequence of test choices
+static uint32_t wl_random(uint32_t *state) {
+    *state = *state * 1103515245 + 12345;
+    return *state >> 16;
+}
+
+// Block device that loses power after a number of programs and erases,
+// the operation cut short programs half of its data
+class PowerLossBlockDevice : public BlockDevice {
+public:
+    PowerLossBlockDevice(BlockDevice *bd) : _bd(bd), _budget(-1) {}
+
+    // Cut power after the given number of operations, or never if negative
+    void set_budget(int budget) { _budget = budget; }
+    bool lost() const { return _budget == 0; }
+
+    virtual int init() { return _bd->init(); }
+    virtual int deinit() { return _bd->deinit(); }
+    virtual int read(void *b, bd_addr_t addr, bd_size_t size) {
+        return lost() ? BD_ERROR_DEVICE_ERROR : _bd->read(b, addr, size);
+    }
+    virtual int program(const void *b, bd_addr_t addr, bd_size_t size) {
+        if (cut()) {
+            bd_size_t half = (size / 2) - (size / 2) % _bd->get_program_size();
+            if (half) {
+                _bd->program(b, addr, half);
+            }
+            return BD_ERROR_DEVICE_ERROR;
+        }
+        return _bd->program(b, addr, size);
+    }
+    virtual int erase(bd_addr_t addr, bd_size_t size) {
+        return cut() ? BD_ERROR_DEVICE_ERROR : _bd->erase(addr, size);
+    }
+    virtual bd_size_t get_read_size() const { return _bd->get_read_size(); }
+    virtual bd_size_t get_program_size() const { return _bd->get_program_size(); }
+    virtual bd_size_t get_erase_size() const { return _bd->get_erase_size(); }
+    virtual int get_erase_value() const { return _bd->get_erase_value(); }
+    virtual bd_size_t size() const { return _bd->size(); }
+
+private:
+    bool cut() {
+        if (_budget > 0) {
+            _budget--;
+            return false;
+        }
+        return _budget == 0;
+    }
+
+    BlockDevice *_bd;
+    int _budget;
+};
+
+// Test which cuts power at random points while rewriting blocks
+void test_wear_leveling_power_loss() {
+    const int erase_size = 8*BLOCK_SIZE;
+    HeapBlockDevice heap(BLOCK_COUNT*erase_size, 16, 16, erase_size, 0xff);
+    PowerLossBlockDevice bd(&heap);
+    uint8_t *write_block = new uint8_t[BLOCK_SIZE];
+    uint8_t *read_block = new uint8_t[BLOCK_SIZE];
+
+    // Metadata of larger program sizes does not fit in the first page
+    HeapBlockDevice coarse(BLOCK_COUNT*erase_size, 256, 256, erase_size);
+    WearLevelingBlockDevice wl_coarse(&coarse, BLOCK_SIZE);
+    TEST_ASSERT_EQUAL(BD_ERROR_PARAMETER, wl_coarse.init());
+
+    WearLevelingBlockDevice wl(&bd, BLOCK_SIZE, 4, 8);
+    int err = wl.init();
+    TEST_ASSERT_EQUAL(0, err);
+
+    const int lblocks = (BLOCK_COUNT - 4) * 7;
+    int *seeds = new int[lblocks];
+    for (int j = 0; j < lblocks; j++) {
+        seeds[j] = j + 1;
+        wl_fill(write_block, seeds[j]);
+        err = wl.program(write_block, j*BLOCK_SIZE, BLOCK_SIZE);
+        TEST_ASSERT_EQUAL(0, err);
+    }
+
+    // Choices of the test, apart from the sequences blocks are filled with
+    uint32_t state = 1;
+    int seed = lblocks;
+    for (int round = 0; round < 100; round++) {
+        // Rewrite mostly the first few blocks until power is lost
+        bd.set_budget(wl_random(&state) % 200);
+        int j;
+        while (true) {
+            j = wl_random(&state) % 4 ? wl_random(&state) % 4 : wl_random(&state) % lblocks;
+            wl_fill(write_block, ++seed);
+            err = wl.program(write_block, j*BLOCK_SIZE, BLOCK_SIZE);
+            if (err) {
+                break;
+            }
+            seeds[j] = seed;
+        }
+        TEST_ASSERT(bd.lost());
+
+        // Mounting again recovers, the block cut short is old or new
+        bd.set_budget(-1);
+        wl.deinit();
+        err = wl.init();
+        TEST_ASSERT_EQUAL(0, err);
+
+        for (int k = 0; k < lblocks; k++) {
+            err = wl.read(read_block, k*BLOCK_SIZE, BLOCK_SIZE);
+            TEST_ASSERT_EQUAL(0, err);
+
+            wl_fill(write_block, seeds[k]);
+            if (k == j && memcmp(write_block, read_block, BLOCK_SIZE) != 0) {
+                seeds[k] = seed;
+                wl_fill(write_block, seeds[k]);
+            }
+            TEST_ASSERT_EQUAL_UINT8_ARRAY(write_block, read_block, BLOCK_SIZE);
+        }
+    }
+
+    err = wl.deinit();
+    TEST_ASSERT_EQUAL(0, err);
+
+    delete[] seeds;
+    delete[] write_block;
+    delete[] read_block;
+}
+
 
 // Test setup
 utest::v1::status_t test_setup(const size_t number_of_cases) {
@@ -248,7 +762,13 @@ utest::v1::status_t test_setup(const size_t number_of_cases) {
 Case cases[] = {
     Case("Testing slicing of a block device", test_slicing),
     Case("Testing chaining of block devices", test_chaining),
+    Case("Testing striping of block devices", test_striping),
     Case("Testing profiling of block devices", test_profiling),
+    Case("Testing tracing of block devices", test_profiling_trace),
+    Case("Testing mapping of block devices", test_mapping),
+    Case("Testing caching of block devices", test_caching),
+    Case("Testing wear leveling of block devices", test_wear_leveling),
+    Case("Testing power loss under wear leveling", test_wear_leveling_power_loss),
 };
 
 Specification specification(test_setup, cases);
@@ -74,6 +74,18 @@ ssize_t File::write(const void *buffer, size_t len)
     return _fs->file_write(_file, buffer, len);
 }
 
+ssize_t File::readv(const struct iovec *iov, int iovcnt)
+{
+    MBED_ASSERT(_fs);
+    return _fs->file_readv(_file, iov, iovcnt);
+}
+
+ssize_t File::writev(const struct iovec *iov, int iovcnt)
+{
+    MBED_ASSERT(_fs);
+    return _fs->file_writev(_file, iov, iovcnt);
+}
+
 int File::sync()
 {
     MBED_ASSERT(_fs);
@@ -110,3 +122,9 @@ off_t File::size()
     return _fs->file_size(_file);
 }
 
+const void *File::get_mapped_address()
+{
+    MBED_ASSERT(_fs);
+    return _fs->file_get_mapped_address(_file);
+}
+
@@ -85,6 +85,22 @@ public:
      */
     virtual ssize_t write(const void *buffer, size_t size);
 
+    /** Read the contents of a file into several buffers
+     *
+     *  @param iov      The buffers to read in to
+     *  @param iovcnt   The number of buffers
+     *  @return         The number of bytes read, 0 at end of file, negative error on failure
+     */
+    virtual ssize_t readv(const struct iovec *iov, int iovcnt);
+
+    /** Write the contents of several buffers to a file
+     *
+     *  @param iov      The buffers to write from
+     *  @param iovcnt   The number of buffers
+     *  @return         The number of bytes written, negative error on failure
+     */
+    virtual ssize_t writev(const struct iovec *iov, int iovcnt);
+
     /** Flush any buffers associated with the file
      *
      *  @return         0 on success, negative error code on failure
@@ -126,6 +142,17 @@ public:
      */
     virtual off_t size();
 
+    /** Get the address the contents of the file can be read at in place
+     *
+     *  Files that are contiguous on a block device in memory, such as a
+     *  FlashIAPBlockDevice, can be read without copying them. The contents
+     *  at the address are valid while the file is open and not written.
+     *
+     *  @return         Address of the first byte of the file, or NULL if
+     *                  the file can not be read in place
+     */
+    virtual const void *get_mapped_address();
+
 private:
     FileSystem *_fs;
     fs_file_t _file;
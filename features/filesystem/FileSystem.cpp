@@ -49,6 +49,38 @@ int FileSystem::mkdir(const char *path, mode_t mode)
     return -ENOSYS;
 }
 
+ssize_t FileSystem::file_readv(fs_file_t file, const struct iovec *iov, int iovcnt)
+{
+    ssize_t total = 0;
+    for (int i = 0; i < iovcnt; i++) {
+        ssize_t n = file_read(file, iov[i].iov_base, iov[i].iov_len);
+        if (n < 0) {
+            return total ? total : n;
+        }
+        total += n;
+        if ((size_t)n < iov[i].iov_len) {
+            break;
+        }
+    }
+    return total;
+}
+
+ssize_t FileSystem::file_writev(fs_file_t file, const struct iovec *iov, int iovcnt)
+{
+    ssize_t total = 0;
+    for (int i = 0; i < iovcnt; i++) {
+        ssize_t n = file_write(file, iov[i].iov_base, iov[i].iov_len);
+        if (n < 0) {
+            return total ? total : n;
+        }
+        total += n;
+        if ((size_t)n < iov[i].iov_len) {
+            break;
+        }
+    }
+    return total;
+}
+
 int FileSystem::file_sync(fs_file_t file)
 {
     return 0;
@@ -77,6 +109,11 @@ off_t FileSystem::file_size(fs_file_t file)
     return size;
 }
 
+const void *FileSystem::file_get_mapped_address(fs_file_t file)
+{
+    return NULL;
+}
+
 int FileSystem::dir_open(fs_dir_t *dir, const char *path)
 {
     return -ENOSYS;
@@ -148,6 +148,30 @@ protected:
      */
     virtual ssize_t file_write(fs_file_t file, const void *buffer, size_t size) = 0;
 
+    /** Read the contents of a file into several buffers
+     *
+     *  The default implementation calls file_read for each buffer and stops
+     *  at the first short read.
+     *
+     *  @param file     File handle
+     *  @param iov      The buffers to read in to
+     *  @param iovcnt   The number of buffers
+     *  @return         The number of bytes read, 0 at end of file, negative error on failure
+     */
+    virtual ssize_t file_readv(fs_file_t file, const struct iovec *iov, int iovcnt);
+
+    /** Write the contents of several buffers to a file
+     *
+     *  The default implementation calls file_write for each buffer and stops
+     *  at the first short write.
+     *
+     *  @param file     File handle
+     *  @param iov      The buffers to write from
+     *  @param iovcnt   The number of buffers
+     *  @return         The number of bytes written, negative error on failure
+     */
+    virtual ssize_t file_writev(fs_file_t file, const struct iovec *iov, int iovcnt);
+
     /** Flush any buffers associated with the file
      *
      *  @param file     File handle
@@ -196,6 +220,14 @@ protected:
      */
     virtual off_t file_size(fs_file_t file);
 
+    /** Get the address the contents of a file can be read at in place
+     *
+     *  @param file     File handle
+     *  @return         Address of the first byte of the file, or NULL if
+     *                  the file can not be read in place
+     */
+    virtual const void *file_get_mapped_address(fs_file_t file);
+
     /** Open a directory on the filesystem
      *
      *  @param dir      Destination for the handle to the directory
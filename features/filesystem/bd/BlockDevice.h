@@ -18,6 +18,7 @@
 #define MBED_BLOCK_DEVICE_H
 
 #include <stdint.h>
+#include "platform/Callback.h"
 
 
 /** Enum of standard error codes
@@ -27,6 +28,8 @@
 enum bd_error {
     BD_ERROR_OK                 = 0,     /*!< no error */
     BD_ERROR_DEVICE_ERROR       = -4001, /*!< device specific error */
+    BD_ERROR_WOULD_BLOCK        = -4002, /*!< too many asynchronous operations in progress */
+    BD_ERROR_PARAMETER          = -4003, /*!< invalid parameter or geometry */
 };
 
 /** Type representing the address of a specific block
@@ -37,6 +40,11 @@ typedef uint64_t bd_addr_t;
  */
 typedef uint64_t bd_size_t;
 
+/** Type of the callback of an asynchronous operation, called with 0 on
+ *  success or a negative error code on failure
+ */
+typedef mbed::Callback<void(int)> bd_callback_t;
+
 
 /** A hardware device capable of writing and reading blocks
  */
@@ -59,6 +67,18 @@ public:
      */
     virtual int deinit() = 0;
 
+    /** Ensure data on storage is in sync with the driver
+     *
+     *  Block devices that buffer writes, such as CachingBlockDevice, write
+     *  them to the storage. Others have nothing to do.
+     *
+     *  @return         0 on success or a negative error code on failure
+     */
+    virtual int sync()
+    {
+        return 0;
+    }
+
     /** Read blocks from a block device
      *
      *  If a failure occurs, it is not possible to determine how many bytes succeeded
@@ -93,6 +113,88 @@ public:
      */
     virtual int erase(bd_addr_t addr, bd_size_t size) = 0;
 
+    /** Mark blocks as no longer in use
+     *
+     *  A hint that the blocks hold no data anymore, so block devices can
+     *  drop or erase them ahead of their next use. Trimmed blocks read as
+     *  undefined data until they are programmed again, and must still be
+     *  erased before that if the block device requires it.
+     *
+     *  @param addr     Address of block to mark as unused
+     *  @param size     Size to mark as unused in bytes, must be a multiple of erase block size
+     *  @return         0 on success, negative error code on failure
+     */
+    virtual int trim(bd_addr_t addr, bd_size_t size)
+    {
+        return 0;
+    }
+
+    /** Read blocks from a block device without waiting for the transfer
+     *
+     *  The callback is called once the read completes, possibly from an
+     *  interrupt and possibly before read_async returns. The buffer must
+     *  stay valid until then. Block devices without asynchronous
+     *  transfers complete the read before returning.
+     *
+     *  @param buffer   Buffer to read blocks into
+     *  @param addr     Address of block to begin reading from
+     *  @param size     Size to read in bytes, must be a multiple of read block size
+     *  @param callback Function called with the result of the read
+     *  @return         0 if the read was started, negative error code on
+     *                  failure, in which case the callback is not called
+     */
+    virtual int read_async(void *buffer, bd_addr_t addr, bd_size_t size, bd_callback_t callback)
+    {
+        callback(read(buffer, addr, size));
+        return 0;
+    }
+
+    /** Program blocks to a block device without waiting for the transfer
+     *
+     *  Completes as read_async does.
+     *
+     *  @param buffer   Buffer of data to write to blocks
+     *  @param addr     Address of block to begin writing to
+     *  @param size     Size to write in bytes, must be a multiple of program block size
+     *  @param callback Function called with the result of the program
+     *  @return         0 if the program was started, negative error code
+     *                  on failure, in which case the callback is not called
+     */
+    virtual int program_async(const void *buffer, bd_addr_t addr, bd_size_t size, bd_callback_t callback)
+    {
+        callback(program(buffer, addr, size));
+        return 0;
+    }
+
+    /** Erase blocks on a block device without waiting for the erase
+     *
+     *  Completes as read_async does.
+     *
+     *  @param addr     Address of block to begin erasing
+     *  @param size     Size to erase in bytes, must be a multiple of erase block size
+     *  @param callback Function called with the result of the erase
+     *  @return         0 if the erase was started, negative error code on
+     *                  failure, in which case the callback is not called
+     */
+    virtual int erase_async(bd_addr_t addr, bd_size_t size, bd_callback_t callback)
+    {
+        callback(erase(addr, size));
+        return 0;
+    }
+
+    /** Get the number of asynchronous operations that can be in progress
+     *
+     *  Further operations fail with BD_ERROR_WOULD_BLOCK until one has
+     *  completed. Synchronous operations must not be mixed with
+     *  asynchronous ones in progress.
+     *
+     *  @return         Number of operations that can be in progress
+     */
+    virtual unsigned get_queue_depth() const
+    {
+        return 1;
+    }
+
     /** Get the size of a readable block
      *
      *  @return         Size of a readable block in bytes
@@ -113,6 +215,49 @@ public:
      */
     virtual bd_size_t get_erase_size() const = 0;
 
+    /** Get the value of storage when erased
+     *
+     *  If get_erase_value returns a non-negative byte value, erased storage
+     *  reads as that value, and storage that reads as that value can be
+     *  programmed without erasing it first.
+     *
+     *  @return         The value of storage when erased, or -1 if the value
+     *                  of erased storage is not defined
+     */
+    virtual int get_erase_value() const
+    {
+        return -1;
+    }
+
+    /** Check if blocks must be erased before they are programmed
+     *
+     *  Block devices that program over previous data, such as SD cards,
+     *  return false, there is no need to call erase before program.
+     *
+     *  @return         True if blocks must be erased before they are
+     *                  programmed
+     */
+    virtual bool is_erase_required() const
+    {
+        return true;
+    }
+
+    /** Get the address blocks can be read at in place
+     *
+     *  Block devices on memory in the address space, such as internal
+     *  flash, let their blocks be read without copying them. What is read
+     *  at the address changes when the blocks are programmed or erased.
+     *
+     *  @param addr     Address of block to begin at
+     *  @param size     Size in bytes from the address
+     *  @return         Address the blocks are at in memory, or NULL if
+     *                  they are not in memory or not contiguous
+     */
+    virtual const void *get_mapped_address(bd_addr_t addr, bd_size_t size) const
+    {
+        return NULL;
+    }
+
     /** Get the total size of the underlying device
      *
      *  @return         Size of the underlying device in bytes
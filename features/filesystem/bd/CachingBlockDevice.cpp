@@ -0,0 +1,457 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "CachingBlockDevice.h"
+#include <string.h>
+
+// Erased blocks are given this content until they are programmed, unless
+// the underlying block device has an erase value
+#define CACHE_ERASE_VALUE 0xff
+
+
+CachingBlockDevice::CachingBlockDevice(BlockDevice *bd, bd_size_t blocks, bd_size_t read_ahead)
+    : _bd(bd)
+    , _count(blocks)
+    , _read_ahead(read_ahead)
+    , _block_size(0)
+    , _lines(0)
+    , _buffer(0)
+    , _clock(0)
+    , _wb_pending(0)
+    , _wb_err(0)
+{
+    MBED_ASSERT(_count > 0);
+}
+
+CachingBlockDevice::~CachingBlockDevice()
+{
+    delete[] _lines;
+    delete[] _buffer;
+}
+
+int CachingBlockDevice::init()
+{
+    int err = _bd->init();
+    if (err) {
+        return err;
+    }
+
+    if (!_lines) {
+        _block_size = _bd->get_erase_size();
+        _lines = new cache_line[_count];
+        _buffer = new uint8_t[_count * _block_size];
+        for (bd_size_t i = 0; i < _count; i++) {
+            _lines[i].data = &_buffer[i * _block_size];
+            _lines[i].used = 0;
+            _lines[i].valid = false;
+            _lines[i].dirty = false;
+        }
+    }
+
+    return BD_ERROR_OK;
+}
+
+int CachingBlockDevice::deinit()
+{
+    if (_lines) {
+        int err = sync();
+        if (err) {
+            return err;
+        }
+
+        delete[] _lines;
+        _lines = 0;
+        delete[] _buffer;
+        _buffer = 0;
+    }
+
+    return _bd->deinit();
+}
+
+static void write_back_wait()
+{
+#if MBED_CONF_RTOS_PRESENT
+    rtos::Thread::yield();
+#endif
+}
+
+void CachingBlockDevice::write_back_done(int err)
+{
+    core_util_critical_section_enter();
+    if (err && !_wb_err) {
+        _wb_err = err;
+    }
+    _wb_pending--;
+    core_util_critical_section_exit();
+}
+
+int CachingBlockDevice::write_back_async(bool erase)
+{
+    unsigned depth = _bd->get_queue_depth();
+    _wb_err = 0;
+
+    for (bd_size_t i = 0; i < _count && !_wb_err; i++) {
+        cache_line *l = &_lines[i];
+        if (!l->valid || !l->dirty) {
+            continue;
+        }
+
+        while (_wb_pending >= depth) {
+            write_back_wait();
+        }
+
+        core_util_critical_section_enter();
+        _wb_pending++;
+        core_util_critical_section_exit();
+
+        bd_callback_t done(this, &CachingBlockDevice::write_back_done);
+        int err = erase
+                ? _bd->erase_async(l->addr, _block_size, done)
+                : _bd->program_async(l->data, l->addr, _block_size, done);
+        if (err) {
+            // not started, so done is not called
+            write_back_done(err);
+        }
+    }
+
+    while (_wb_pending) {
+        write_back_wait();
+    }
+
+    return _wb_err;
+}
+
+int CachingBlockDevice::sync()
+{
+    MBED_ASSERT(_lines != NULL);
+
+    // all the erases, then all the programs, to keep the device's queue full
+    int err = 0;
+    if (_bd->is_erase_required()) {
+        err = write_back_async(true);
+    }
+    if (!err) {
+        err = write_back_async(false);
+    }
+    if (err) {
+        return err;
+    }
+
+    for (bd_size_t i = 0; i < _count; i++) {
+        _lines[i].dirty = false;
+    }
+
+    return _bd->sync();
+}
+
+CachingBlockDevice::cache_line *CachingBlockDevice::find(bd_addr_t addr)
+{
+    for (bd_size_t i = 0; i < _count; i++) {
+        if (_lines[i].valid && _lines[i].addr == addr) {
+            return &_lines[i];
+        }
+    }
+
+    return NULL;
+}
+
+CachingBlockDevice::cache_line *CachingBlockDevice::victim(bool dirty_ok)
+{
+    cache_line *lru = NULL;
+    for (bd_size_t i = 0; i < _count; i++) {
+        cache_line *l = &_lines[i];
+        if (!l->valid) {
+            return l;
+        }
+        if ((dirty_ok || !l->dirty) && (!lru || l->used < lru->used)) {
+            lru = l;
+        }
+    }
+
+    return lru;
+}
+
+void CachingBlockDevice::touch(cache_line *l)
+{
+    l->used = ++_clock;
+}
+
+int CachingBlockDevice::write_back(cache_line *l)
+{
+    if (!l->valid || !l->dirty) {
+        return 0;
+    }
+
+    int err = 0;
+    if (_bd->is_erase_required()) {
+        err = _bd->erase(l->addr, _block_size);
+    }
+    if (!err) {
+        err = _bd->program(l->data, l->addr, _block_size);
+    }
+    if (err) {
+        return err;
+    }
+
+    l->dirty = false;
+    return 0;
+}
+
+int CachingBlockDevice::fetch(cache_line **lp, bd_addr_t addr, bool load)
+{
+    cache_line *l = victim(true);
+    int err = write_back(l);
+    if (err) {
+        return err;
+    }
+
+    l->valid = false;
+    if (load) {
+        err = _bd->read(l->data, addr, _block_size);
+        if (err) {
+            return err;
+        }
+    }
+
+    l->addr = addr;
+    l->valid = true;
+    l->dirty = false;
+    touch(l);
+    *lp = l;
+    return 0;
+}
+
+void CachingBlockDevice::read_ahead(bd_addr_t addr)
+{
+    // never more than the other lines, so it does not evict its own blocks
+    bd_size_t count = _read_ahead < _count ? _read_ahead : _count - 1;
+    for (bd_size_t i = 0; i < count; i++, addr += _block_size) {
+        if (addr >= size()) {
+            break;
+        }
+        if (find(addr)) {
+            continue;
+        }
+
+        // only lines that need no writing back are worth a guess
+        cache_line *l = victim(false);
+        if (!l) {
+            break;
+        }
+
+        l->valid = false;
+        if (_bd->read(l->data, addr, _block_size)) {
+            break;
+        }
+
+        l->addr = addr;
+        l->valid = true;
+        l->dirty = false;
+        touch(l);
+    }
+}
+
+int CachingBlockDevice::read(void *b, bd_addr_t addr, bd_size_t size)
+{
+    MBED_ASSERT(_lines != NULL);
+    MBED_ASSERT(is_valid_read(addr, size));
+    uint8_t *buffer = static_cast<uint8_t*>(b);
+
+    // transfers of several blocks read the ones not cached directly
+    bool bulk = size >= 2*_block_size;
+
+    while (size > 0) {
+        bd_addr_t block = addr - addr % _block_size;
+        bd_size_t offset = addr - block;
+        bd_size_t chunk = _block_size - offset;
+        if (chunk > size) {
+            chunk = size;
+        }
+
+        cache_line *l = find(block);
+        if (!l && bulk && chunk == _block_size) {
+            while (chunk + _block_size <= size && !find(addr + chunk)) {
+                chunk += _block_size;
+            }
+
+            int err = _bd->read(buffer, addr, chunk);
+            if (err) {
+                return err;
+            }
+        } else if (l) {
+            touch(l);
+            memcpy(buffer, &l->data[offset], chunk);
+        } else {
+            int err = fetch(&l, block, true);
+            if (err) {
+                return err;
+            }
+
+            memcpy(buffer, &l->data[offset], chunk);
+            read_ahead(block + _block_size);
+        }
+
+        buffer += chunk;
+        addr += chunk;
+        size -= chunk;
+    }
+
+    return 0;
+}
+
+int CachingBlockDevice::program(const void *b, bd_addr_t addr, bd_size_t size)
+{
+    MBED_ASSERT(_lines != NULL);
+    MBED_ASSERT(is_valid_program(addr, size));
+    const uint8_t *buffer = static_cast<const uint8_t*>(b);
+
+    // transfers of several blocks program the ones not cached directly
+    bool bulk = size >= 2*_block_size;
+
+    while (size > 0) {
+        bd_addr_t block = addr - addr % _block_size;
+        bd_size_t offset = addr - block;
+        bd_size_t chunk = _block_size - offset;
+        if (chunk > size) {
+            chunk = size;
+        }
+
+        cache_line *l = find(block);
+        if (!l && bulk && chunk == _block_size) {
+            while (chunk + _block_size <= size && !find(addr + chunk)) {
+                chunk += _block_size;
+            }
+
+            int err = 0;
+            if (_bd->is_erase_required()) {
+                err = _bd->erase(addr, chunk);
+            }
+            if (!err) {
+                err = _bd->program(buffer, addr, chunk);
+            }
+            if (err) {
+                return err;
+            }
+        } else {
+            if (l) {
+                touch(l);
+            } else {
+                // a whole block need not be read first
+                int err = fetch(&l, block, chunk != _block_size);
+                if (err) {
+                    return err;
+                }
+            }
+
+            memcpy(&l->data[offset], buffer, chunk);
+            l->dirty = true;
+        }
+
+        buffer += chunk;
+        addr += chunk;
+        size -= chunk;
+    }
+
+    return 0;
+}
+
+int CachingBlockDevice::erase(bd_addr_t addr, bd_size_t size)
+{
+    MBED_ASSERT(_lines != NULL);
+    MBED_ASSERT(is_valid_erase(addr, size));
+
+    // erases of several blocks erase the ones not cached directly
+    bool bulk = size >= 2*_block_size;
+
+    while (size > 0) {
+        bd_size_t chunk = _block_size;
+
+        cache_line *l = find(addr);
+        if (!l && bulk) {
+            while (chunk + _block_size <= size && !find(addr + chunk)) {
+                chunk += _block_size;
+            }
+
+            int err = _bd->erase(addr, chunk);
+            if (err) {
+                return err;
+            }
+        } else {
+            if (l) {
+                touch(l);
+            } else {
+                int err = fetch(&l, addr, false);
+                if (err) {
+                    return err;
+                }
+            }
+
+            int value = _bd->get_erase_value();
+            memset(l->data, value < 0 ? CACHE_ERASE_VALUE : value, _block_size);
+            l->dirty = true;
+        }
+
+        addr += chunk;
+        size -= chunk;
+    }
+
+    return 0;
+}
+
+int CachingBlockDevice::trim(bd_addr_t addr, bd_size_t size)
+{
+    MBED_ASSERT(_lines != NULL);
+    MBED_ASSERT(is_valid_erase(addr, size));
+
+    for (bd_size_t i = 0; i < _count; i++) {
+        if (_lines[i].valid && _lines[i].addr >= addr && _lines[i].addr < addr + size) {
+            _lines[i].valid = false;
+            _lines[i].dirty = false;
+        }
+    }
+
+    return _bd->trim(addr, size);
+}
+
+bd_size_t CachingBlockDevice::get_read_size() const
+{
+    return _bd->get_read_size();
+}
+
+bd_size_t CachingBlockDevice::get_program_size() const
+{
+    return _bd->get_program_size();
+}
+
+bd_size_t CachingBlockDevice::get_erase_size() const
+{
+    return _bd->get_erase_size();
+}
+
+int CachingBlockDevice::get_erase_value() const
+{
+    return _bd->get_erase_value();
+}
+
+bool CachingBlockDevice::is_erase_required() const
+{
+    return false;
+}
+
+bd_size_t CachingBlockDevice::size() const
+{
+    return _bd->size();
+}
@@ -0,0 +1,220 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef MBED_CACHING_BLOCK_DEVICE_H
+#define MBED_CACHING_BLOCK_DEVICE_H
+
+#include "BlockDevice.h"
+#include "mbed.h"
+
+#ifndef MBED_CONF_FILESYSTEM_CACHE_BLOCKS
+#define MBED_CONF_FILESYSTEM_CACHE_BLOCKS 4
+#endif
+
+#ifndef MBED_CONF_FILESYSTEM_CACHE_READ_AHEAD
+#define MBED_CONF_FILESYSTEM_CACHE_READ_AHEAD 0
+#endif
+
+
+/** Block device for caching the erase blocks of another block device
+ *
+ *  Reads, programs and erases are done on a few erase blocks held in RAM,
+ *  and a block is only written back, erased and programmed as a whole,
+ *  when it is evicted to make room for another or on sync. The least
+ *  recently used block is evicted first. This suits file systems that
+ *  rewrite the same few blocks, such as FAT tables and directories.
+ *
+ *  Data programmed or erased is not on the underlying block device until
+ *  sync or deinit. FATFileSystem syncs when files are synced or closed
+ *  and on unmount.
+ *
+ *  @code
+ *  #include "mbed.h"
+ *  #include "SDBlockDevice.h"
+ *  #include "CachingBlockDevice.h"
+ *  #include "FATFileSystem.h"
+ *
+ *  // Cache 8 blocks of an SD card, reading 2 blocks ahead
+ *  SDBlockDevice sd(p5, p6, p7, p12);
+ *  CachingBlockDevice cache(&sd, 8, 2);
+ *
+ *  FATFileSystem fs("fs", &cache);
+ *  @endcode
+ */
+class CachingBlockDevice : public BlockDevice
+{
+public:
+    /** Lifetime of the caching block device
+     *
+     *  @param bd           Block device to back the CachingBlockDevice
+     *  @param blocks       Number of erase blocks to cache, the cache takes
+     *                      blocks times the erase size of bd in RAM
+     *  @param read_ahead   Number of blocks after one that misses the cache
+     *                      to read with it, into blocks of the cache that
+     *                      do not need writing back
+     */
+    CachingBlockDevice(BlockDevice *bd,
+            bd_size_t blocks = MBED_CONF_FILESYSTEM_CACHE_BLOCKS,
+            bd_size_t read_ahead = MBED_CONF_FILESYSTEM_CACHE_READ_AHEAD);
+
+    /** Lifetime of a block device
+     *
+     *  Data that has not been synced is lost
+     */
+    virtual ~CachingBlockDevice();
+
+    /** Initialize a block device
+     *
+     *  Allocates the cache once the erase size of the underlying block
+     *  device is known.
+     *
+     *  @return         0 on success or a negative error code on failure
+     */
+    virtual int init();
+
+    /** Deinitialize a block device
+     *
+     *  Writes back the cached blocks and frees the cache.
+     *
+     *  @return         0 on success or a negative error code on failure
+     */
+    virtual int deinit();
+
+    /** Write back the cached blocks that have been programmed or erased
+     *
+     *  The blocks are erased and programmed with as many operations in
+     *  progress as the queue depth of the underlying block device allows.
+     *
+     *  @return         0 on success or a negative error code on failure
+     */
+    virtual int sync();
+
+    /** Read blocks from a block device
+     *
+     *  @param buffer   Buffer to read blocks into
+     *  @param addr     Address of block to begin reading from
+     *  @param size     Size to read in bytes, must be a multiple of read block size
+     *  @return         0 on success, negative error code on failure
+     */
+    virtual int read(void *buffer, bd_addr_t addr, bd_size_t size);
+
+    /** Program blocks to a block device
+     *
+     *  The blocks need not be erased first, they are erased when they
+     *  are written back
+     *
+     *  @param buffer   Buffer of data to write to blocks
+     *  @param addr     Address of block to begin writing to
+     *  @param size     Size to write in bytes, must be a multiple of program block size
+     *  @return         0 on success, negative error code on failure
+     */
+    virtual int program(const void *buffer, bd_addr_t addr, bd_size_t size);
+
+    /** Erase blocks on a block device
+     *
+     *  The state of an erased block is undefined until it has been programmed
+     *
+     *  @param addr     Address of block to begin erasing
+     *  @param size     Size to erase in bytes, must be a multiple of erase block size
+     *  @return         0 on success, negative error code on failure
+     */
+    virtual int erase(bd_addr_t addr, bd_size_t size);
+
+    /** Mark blocks as no longer in use
+     *
+     *  Cached blocks in the range are dropped without being written back.
+     *
+     *  @param addr     Address of block to mark as unused
+     *  @param size     Size to mark as unused in bytes, must be a multiple of erase block size
+     *  @return         0 on success, negative error code on failure
+     */
+    virtual int trim(bd_addr_t addr, bd_size_t size);
+
+    /** Get the size of a readable block
+     *
+     *  @return         Size of a readable block in bytes
+     */
+    virtual bd_size_t get_read_size() const;
+
+    /** Get the size of a programable block
+     *
+     *  @return         Size of a programable block in bytes
+     *  @note Must be a multiple of the read size
+     */
+    virtual bd_size_t get_program_size() const;
+
+    /** Get the size of a eraseable block
+     *
+     *  @return         Size of a eraseable block in bytes
+     *  @note Must be a multiple of the program size
+     */
+    virtual bd_size_t get_erase_size() const;
+
+    /** Get the value of storage when erased
+     *
+     *  @return         The value of storage when erased, or -1 if the value
+     *                  of erased storage is not defined
+     */
+    virtual int get_erase_value() const;
+
+    /** Check if blocks must be erased before they are programmed
+     *
+     *  @return         False, blocks are erased when they are written back
+     */
+    virtual bool is_erase_required() const;
+
+    /** Get the total size of the underlying device
+     *
+     *  @return         Size of the underlying device in bytes
+     */
+    virtual bd_size_t size() const;
+
+private:
+    struct cache_line {
+        uint8_t *data;
+        bd_addr_t addr;
+        uint32_t used;      // _clock when last used, for LRU eviction
+        bool valid;
+        bool dirty;         // programmed or erased since it was read
+    };
+
+    cache_line *find(bd_addr_t addr);
+    cache_line *victim(bool dirty_ok);
+    int fetch(cache_line **l, bd_addr_t addr, bool load);
+    int write_back(cache_line *l);
+    void read_ahead(bd_addr_t addr);
+    void touch(cache_line *l);
+    int write_back_async(bool erase);
+    void write_back_done(int err);
+
+    BlockDevice *_bd;
+    bd_size_t _count;
+    bd_size_t _read_ahead;
+    bd_size_t _block_size;
+    cache_line *_lines;
+    uint8_t *_buffer;
+    uint32_t _clock;
+    volatile unsigned _wb_pending;
+    volatile int _wb_err;
+};
+
+
+#endif
@@ -84,6 +84,18 @@ int ChainingBlockDevice::deinit()
     return 0;
 }
 
+int ChainingBlockDevice::sync()
+{
+    for (size_t i = 0; i < _bd_count; i++) {
+        int err = _bds[i]->sync();
+        if (err) {
+            return err;
+        }
+    }
+
+    return 0;
+}
+
 int ChainingBlockDevice::read(void *b, bd_addr_t addr, bd_size_t size)
 {
     MBED_ASSERT(is_valid_read(addr, size));
@@ -109,7 +121,7 @@ int ChainingBlockDevice::read(void *b, bd_addr_t addr, bd_size_t size)
             size -= read;
         }
 
-        addr -= size;
+        addr -= bdsize;
     }
 
     return 0;
@@ -140,7 +152,7 @@ int ChainingBlockDevice::program(const void *b, bd_addr_t addr, bd_size_t size)
             size -= program;
         }
 
-        addr -= size;
+        addr -= bdsize;
     }
 
     return 0;
@@ -169,12 +181,192 @@ int ChainingBlockDevice::erase(bd_addr_t addr, bd_size_t size)
             size -= erase;
         }
 
-        addr -= size;
+        addr -= bdsize;
+    }
+
+    return 0;
+}
+
+int ChainingBlockDevice::trim(bd_addr_t addr, bd_size_t size)
+{
+    MBED_ASSERT(is_valid_erase(addr, size));
+
+    // Find block devices containing blocks, may span multiple block devices
+    for (size_t i = 0; i < _bd_count && size > 0; i++) {
+        bd_size_t bdsize = _bds[i]->size();
+
+        if (addr < bdsize) {
+            bd_size_t trim = size;
+            if (addr + trim > bdsize) {
+                trim = bdsize - addr;
+            }
+
+            int err = _bds[i]->trim(addr, trim);
+            if (err) {
+                return err;
+            }
+
+            addr += trim;
+            size -= trim;
+        }
+
+        addr -= bdsize;
+    }
+
+    return 0;
+}
+
+const void *ChainingBlockDevice::get_mapped_address(bd_addr_t addr, bd_size_t size) const
+{
+    // Only blocks within one block device are contiguous
+    for (size_t i = 0; i < _bd_count; i++) {
+        bd_size_t bdsize = _bds[i]->size();
+
+        if (addr < bdsize) {
+            if (addr + size > bdsize) {
+                return NULL;
+            }
+            return _bds[i]->get_mapped_address(addr, size);
+        }
+
+        addr -= bdsize;
+    }
+
+    return NULL;
+}
+
+void ChainingBlockDevice::async_op::done(int result)
+{
+    core_util_critical_section_enter();
+    if (result && !err) {
+        err = result;
+    }
+    bool last = --pending == 0;
+    bd_callback_t cb = callback;
+    int e = err;
+    if (last) {
+        used = false;
+    }
+    core_util_critical_section_exit();
+
+    if (last) {
+        cb(e);
+    }
+}
+
+int ChainingBlockDevice::start_async(async_type type, uint8_t *buffer,
+        bd_addr_t addr, bd_size_t size, bd_callback_t callback)
+{
+    async_op *op = NULL;
+    core_util_critical_section_enter();
+    for (size_t i = 0; i < MBED_CONF_FILESYSTEM_CHAIN_QUEUE_DEPTH; i++) {
+        if (!_ops[i].used) {
+            op = &_ops[i];
+            op->used = true;
+            break;
+        }
+    }
+    core_util_critical_section_exit();
+
+    if (!op) {
+        return BD_ERROR_WOULD_BLOCK;
+    }
+
+    // One extra count holds the callback back until all parts are started
+    op->callback = callback;
+    op->err = 0;
+    op->pending = 1;
+
+    // Start the parts on the block devices containing blocks together
+    size_t started = 0;
+    for (size_t i = 0; i < _bd_count && size > 0; i++) {
+        bd_size_t bdsize = _bds[i]->size();
+
+        if (addr < bdsize) {
+            bd_size_t part = size;
+            if (addr + part > bdsize) {
+                part = bdsize - addr;
+            }
+
+            core_util_critical_section_enter();
+            op->pending++;
+            core_util_critical_section_exit();
+
+            bd_callback_t done(op, &async_op::done);
+            int err;
+            if (type == ASYNC_READ) {
+                err = _bds[i]->read_async(buffer, addr, part, done);
+            } else if (type == ASYNC_PROGRAM) {
+                err = _bds[i]->program_async(buffer, addr, part, done);
+            } else {
+                err = _bds[i]->erase_async(addr, part, done);
+            }
+
+            if (err) {
+                core_util_critical_section_enter();
+                op->pending--;
+                if (!op->err) {
+                    op->err = err;
+                }
+                core_util_critical_section_exit();
+                break;
+            }
+
+            started++;
+            if (buffer) {
+                buffer += part;
+            }
+            addr += part;
+            size -= part;
+        }
+
+        addr -= bdsize;
     }
 
+    if (!started && op->err) {
+        // nothing to wait for, the callback is not called
+        int err = op->err;
+        op->used = false;
+        return err;
+    }
+
+    op->done(0);
     return 0;
 }
 
+int ChainingBlockDevice::read_async(void *b, bd_addr_t addr, bd_size_t size, bd_callback_t callback)
+{
+    MBED_ASSERT(is_valid_read(addr, size));
+    return start_async(ASYNC_READ, static_cast<uint8_t*>(b), addr, size, callback);
+}
+
+int ChainingBlockDevice::program_async(const void *b, bd_addr_t addr, bd_size_t size, bd_callback_t callback)
+{
+    MBED_ASSERT(is_valid_program(addr, size));
+    // the buffer is only read, by program_async
+    return start_async(ASYNC_PROGRAM, static_cast<uint8_t*>(const_cast<void*>(b)), addr, size, callback);
+}
+
+int ChainingBlockDevice::erase_async(bd_addr_t addr, bd_size_t size, bd_callback_t callback)
+{
+    MBED_ASSERT(is_valid_erase(addr, size));
+    return start_async(ASYNC_ERASE, NULL, addr, size, callback);
+}
+
+unsigned ChainingBlockDevice::get_queue_depth() const
+{
+    // an operation takes at most one place in the queue of each block device
+    unsigned depth = MBED_CONF_FILESYSTEM_CHAIN_QUEUE_DEPTH;
+    for (size_t i = 0; i < _bd_count; i++) {
+        unsigned bd_depth = _bds[i]->get_queue_depth();
+        if (bd_depth < depth) {
+            depth = bd_depth;
+        }
+    }
+
+    return depth;
+}
+
 bd_size_t ChainingBlockDevice::get_read_size() const
 {
     return _read_size;
@@ -190,6 +382,30 @@ bd_size_t ChainingBlockDevice::get_erase_size() const
     return _erase_size;
 }
 
+int ChainingBlockDevice::get_erase_value() const
+{
+    // only defined if the same for all the block devices
+    int value = _bd_count ? _bds[0]->get_erase_value() : -1;
+    for (size_t i = 1; i < _bd_count; i++) {
+        if (_bds[i]->get_erase_value() != value) {
+            return -1;
+        }
+    }
+
+    return value;
+}
+
+bool ChainingBlockDevice::is_erase_required() const
+{
+    for (size_t i = 0; i < _bd_count; i++) {
+        if (_bds[i]->is_erase_required()) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
 bd_size_t ChainingBlockDevice::size() const
 {
     return _size;
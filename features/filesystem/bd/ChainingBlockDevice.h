@@ -25,6 +25,10 @@
 #include "BlockDevice.h"
 #include "mbed.h"
 
+#ifndef MBED_CONF_FILESYSTEM_CHAIN_QUEUE_DEPTH
+#define MBED_CONF_FILESYSTEM_CHAIN_QUEUE_DEPTH 4
+#endif
+
 
 /** Block device for chaining multiple block devices
  *  with the similar block sizes at sequential addresses
@@ -85,6 +89,12 @@ public:
      */
     virtual int deinit();
 
+    /** Ensure data on storage is in sync with the driver
+     *
+     *  @return         0 on success or a negative error code on failure
+     */
+    virtual int sync();
+
     /** Read blocks from a block device
      *
      *  @param buffer   Buffer to write blocks to
@@ -115,6 +125,61 @@ public:
      */
     virtual int erase(bd_addr_t addr, bd_size_t size);
 
+    /** Mark blocks as no longer in use
+     *
+     *  @param addr     Address of block to mark as unused
+     *  @param size     Size to mark as unused in bytes, must be a multiple of erase block size
+     *  @return         0 on success, negative error code on failure
+     */
+    virtual int trim(bd_addr_t addr, bd_size_t size);
+
+    /** Get the address blocks can be read at in place
+     *
+     *  @param addr     Address of block to begin at
+     *  @param size     Size in bytes from the address
+     *  @return         Address the blocks are at in memory, or NULL if
+     *                  they are not in memory or not contiguous
+     */
+    virtual const void *get_mapped_address(bd_addr_t addr, bd_size_t size) const;
+
+    /** Read blocks from a block device without waiting for the transfer
+     *
+     *  Operations that span block devices are started on each of them at
+     *  once, and complete when all have completed.
+     *
+     *  @param buffer   Buffer to read blocks into
+     *  @param addr     Address of block to begin reading from
+     *  @param size     Size to read in bytes, must be a multiple of read block size
+     *  @param callback Function called with the result of the read
+     *  @return         0 if the read was started, negative error code on failure
+     */
+    virtual int read_async(void *buffer, bd_addr_t addr, bd_size_t size, bd_callback_t callback);
+
+    /** Program blocks to a block device without waiting for the transfer
+     *
+     *  @param buffer   Buffer of data to write to blocks
+     *  @param addr     Address of block to begin writing to
+     *  @param size     Size to write in bytes, must be a multiple of program block size
+     *  @param callback Function called with the result of the program
+     *  @return         0 if the program was started, negative error code on failure
+     */
+    virtual int program_async(const void *buffer, bd_addr_t addr, bd_size_t size, bd_callback_t callback);
+
+    /** Erase blocks on a block device without waiting for the erase
+     *
+     *  @param addr     Address of block to begin erasing
+     *  @param size     Size to erase in bytes, must be a multiple of erase block size
+     *  @param callback Function called with the result of the erase
+     *  @return         0 if the erase was started, negative error code on failure
+     */
+    virtual int erase_async(bd_addr_t addr, bd_size_t size, bd_callback_t callback);
+
+    /** Get the number of asynchronous operations that can be in progress
+     *
+     *  @return         Number of operations that can be in progress
+     */
+    virtual unsigned get_queue_depth() const;
+
     /** Get the size of a readable block
      *
      *  @return         Size of a readable block in bytes
@@ -135,6 +200,20 @@ public:
      */
     virtual bd_size_t get_erase_size() const;
 
+    /** Get the value of storage when erased
+     *
+     *  @return         The value of storage when erased, or -1 if the value
+     *                  of erased storage is not defined
+     */
+    virtual int get_erase_value() const;
+
+    /** Check if blocks must be erased before they are programmed
+     *
+     *  @return         True if blocks must be erased before they are
+     *                  programmed
+     */
+    virtual bool is_erase_required() const;
+
     /** Get the total size of the underlying device
      *
      *  @return         Size of the underlying device in bytes
@@ -142,6 +221,26 @@ public:
     virtual bd_size_t size() const;
 
 protected:
+    enum async_type {
+        ASYNC_READ,
+        ASYNC_PROGRAM,
+        ASYNC_ERASE
+    };
+
+    // An asynchronous operation, pending counts the parts in progress
+    struct async_op {
+        bd_callback_t callback;
+        int pending;
+        int err;
+        bool used;
+
+        async_op() : pending(0), err(0), used(false) {}
+        void done(int result);
+    };
+
+    int start_async(async_type type, uint8_t *buffer, bd_addr_t addr, bd_size_t size, bd_callback_t callback);
+
+    async_op _ops[MBED_CONF_FILESYSTEM_CHAIN_QUEUE_DEPTH];
     BlockDevice **_bds;
     size_t _bd_count;
     bd_size_t _read_size;
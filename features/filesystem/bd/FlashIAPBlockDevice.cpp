@@ -0,0 +1,140 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "FlashIAPBlockDevice.h"
+
+#if DEVICE_FLASH
+
+
+FlashIAPBlockDevice::FlashIAPBlockDevice(uint32_t address, uint32_t size)
+    : _address(address), _size(size), _program_size(0), _erase_size(0)
+{
+}
+
+FlashIAPBlockDevice::~FlashIAPBlockDevice()
+{
+}
+
+int FlashIAPBlockDevice::init()
+{
+    if (_flash.init()) {
+        return BD_ERROR_DEVICE_ERROR;
+    }
+
+    uint32_t start = _flash.get_flash_start();
+    if (_address < start || _address + _size > start + _flash.get_flash_size()) {
+        _flash.deinit();
+        return BD_ERROR_DEVICE_ERROR;
+    }
+
+    _program_size = _flash.get_page_size();
+    _erase_size = 0;
+    for (uint32_t addr = _address; addr < _address + _size; addr += _flash.get_sector_size(addr)) {
+        if (_flash.get_sector_size(addr) > _erase_size) {
+            _erase_size = _flash.get_sector_size(addr);
+        }
+    }
+
+    // Sectors must not cross erase blocks and fill the flash used
+    uint32_t addr = _address;
+    while (addr < _address + _size) {
+        uint32_t sector = _flash.get_sector_size(addr);
+        if ((addr - _address) / _erase_size != (addr - _address + sector - 1) / _erase_size) {
+            break;
+        }
+        addr += sector;
+    }
+    if (!_erase_size || addr != _address + _size || _size % _erase_size) {
+        _flash.deinit();
+        return BD_ERROR_DEVICE_ERROR;
+    }
+
+    return 0;
+}
+
+int FlashIAPBlockDevice::deinit()
+{
+    return _flash.deinit() ? BD_ERROR_DEVICE_ERROR : 0;
+}
+
+int FlashIAPBlockDevice::read(void *b, bd_addr_t addr, bd_size_t size)
+{
+    MBED_ASSERT(is_valid_read(addr, size));
+    return _flash.read(b, _address + addr, size) ? BD_ERROR_DEVICE_ERROR : 0;
+}
+
+int FlashIAPBlockDevice::program(const void *b, bd_addr_t addr, bd_size_t size)
+{
+    MBED_ASSERT(is_valid_program(addr, size));
+    const uint8_t *buffer = static_cast<const uint8_t*>(b);
+
+    // FlashIAP programs within a sector at a time
+    while (size > 0) {
+        uint32_t faddr = _address + addr;
+        uint32_t sector = _flash.get_sector_size(faddr);
+        bd_size_t chunk = sector - (faddr % sector);
+        if (chunk > size) {
+            chunk = size;
+        }
+
+        if (_flash.program(buffer, faddr, chunk)) {
+            return BD_ERROR_DEVICE_ERROR;
+        }
+
+        buffer += chunk;
+        addr += chunk;
+        size -= chunk;
+    }
+
+    return 0;
+}
+
+int FlashIAPBlockDevice::erase(bd_addr_t addr, bd_size_t size)
+{
+    MBED_ASSERT(is_valid_erase(addr, size));
+    return _flash.erase(_address + addr, size) ? BD_ERROR_DEVICE_ERROR : 0;
+}
+
+const void *FlashIAPBlockDevice::get_mapped_address(bd_addr_t addr, bd_size_t size) const
+{
+    if (addr + size > this->size()) {
+        return NULL;
+    }
+    return (const void *)(uintptr_t)(_address + addr);
+}
+
+bd_size_t FlashIAPBlockDevice::get_read_size() const
+{
+    return 1;
+}
+
+bd_size_t FlashIAPBlockDevice::get_program_size() const
+{
+    return _program_size;
+}
+
+bd_size_t FlashIAPBlockDevice::get_erase_size() const
+{
+    return _erase_size;
+}
+
+bd_size_t FlashIAPBlockDevice::size() const
+{
+    return _size;
+}
+
+
+#endif
@@ -0,0 +1,156 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef MBED_FLASHIAP_BLOCK_DEVICE_H
+#define MBED_FLASHIAP_BLOCK_DEVICE_H
+
+#include "BlockDevice.h"
+#include "mbed.h"
+
+#if DEVICE_FLASH
+
+
+/** Block device on the internal flash of the MCU, through FlashIAP
+ *
+ *  The internal flash is in the address space, so get_mapped_address gives
+ *  the address of the blocks, and a file of a filesystem on the device can
+ *  be read in place with File::get_mapped_address.
+ *
+ *  The erase block is the largest sector of the flash used, so the flash
+ *  used must start and end on sectors of that size.
+ *
+ *  @code
+ *  #include "mbed.h"
+ *  #include "FlashIAPBlockDevice.h"
+ *
+ *  // The last 64KB of a 512KB flash
+ *  FlashIAPBlockDevice flash(0x70000, 0x10000);
+ *
+ *  int main() {
+ *      flash.init();
+ *      const char *data = (const char *)flash.get_mapped_address(0, 16);
+ *      printf("%.16s\n", data);
+ *      flash.deinit();
+ *  }
+ *  @endcode
+ */
+class FlashIAPBlockDevice : public BlockDevice
+{
+public:
+    /** Lifetime of the block device
+     *
+     *  @param address  Address of the flash used, the start of a sector
+     *  @param size     Size in bytes of the flash used
+     */
+    FlashIAPBlockDevice(uint32_t address, uint32_t size);
+
+    /** Lifetime of the block device
+     */
+    virtual ~FlashIAPBlockDevice();
+
+    /** Initialize a block device
+     *
+     *  @return         0 on success or a negative error code on failure
+     */
+    virtual int init();
+
+    /** Deinitialize a block device
+     *
+     *  @return         0 on success or a negative error code on failure
+     */
+    virtual int deinit();
+
+    /** Read blocks from a block device
+     *
+     *  @param buffer   Buffer to read blocks into
+     *  @param addr     Address of block to begin reading from
+     *  @param size     Size to read in bytes, must be a multiple of read block size
+     *  @return         0 on success, negative error code on failure
+     */
+    virtual int read(void *buffer, bd_addr_t addr, bd_size_t size);
+
+    /** Program blocks to a block device
+     *
+     *  The blocks must have been erased prior to being programmed
+     *
+     *  @param buffer   Buffer of data to write to blocks
+     *  @param addr     Address of block to begin writing to
+     *  @param size     Size to write in bytes, must be a multiple of program block size
+     *  @return         0 on success, negative error code on failure
+     */
+    virtual int program(const void *buffer, bd_addr_t addr, bd_size_t size);
+
+    /** Erase blocks on a block device
+     *
+     *  The state of an erased block is undefined until it has been programmed
+     *
+     *  @param addr     Address of block to begin erasing
+     *  @param size     Size to erase in bytes, must be a multiple of erase block size
+     *  @return         0 on success, negative error code on failure
+     */
+    virtual int erase(bd_addr_t addr, bd_size_t size);
+
+    /** Get the address blocks can be read at in place
+     *
+     *  @param addr     Address of block to begin at
+     *  @param size     Size in bytes from the address
+     *  @return         Address the blocks are at in memory, or NULL if
+     *                  they are not on the device
+     */
+    virtual const void *get_mapped_address(bd_addr_t addr, bd_size_t size) const;
+
+    /** Get the size of a readable block
+     *
+     *  @return         Size of a readable block in bytes
+     */
+    virtual bd_size_t get_read_size() const;
+
+    /** Get the size of a programable block
+     *
+     *  @return         Size of a programable block in bytes
+     *  @note Must be a multiple of the read size
+     */
+    virtual bd_size_t get_program_size() const;
+
+    /** Get the size of a eraseable block
+     *
+     *  @return         Size of a eraseable block in bytes
+     *  @note Must be a multiple of the program size
+     */
+    virtual bd_size_t get_erase_size() const;
+
+    /** Get the total size of the underlying device
+     *
+     *  @return         Size of the underlying device in bytes
+     */
+    virtual bd_size_t size() const;
+
+private:
+    FlashIAP _flash;
+    uint32_t _address;
+    uint32_t _size;
+    uint32_t _program_size;
+    uint32_t _erase_size;
+};
+
+
+#endif
+#endif
@@ -19,14 +19,25 @@
 
 HeapBlockDevice::HeapBlockDevice(bd_size_t size, bd_size_t block)
     : _read_size(block), _program_size(block), _erase_size(block)
-    , _count(size / block), _blocks(0)
+    , _count(size / block), _init(false), _sparse(false), _erase_value(0), _allocated(0)
+    , _blocks(0), _sparse_blocks(0), _sparse_count(0), _sparse_capacity(0)
 {
     MBED_ASSERT(_count * _erase_size == size);
 }
 
 HeapBlockDevice::HeapBlockDevice(bd_size_t size, bd_size_t read, bd_size_t program, bd_size_t erase)
     : _read_size(read), _program_size(program), _erase_size(erase)
-    , _count(size / erase), _blocks(0)
+    , _count(size / erase), _init(false), _sparse(false), _erase_value(0), _allocated(0)
+    , _blocks(0), _sparse_blocks(0), _sparse_count(0), _sparse_capacity(0)
+{
+    MBED_ASSERT(_count * _erase_size == size);
+}
+
+HeapBlockDevice::HeapBlockDevice(bd_size_t size, bd_size_t read, bd_size_t program, bd_size_t erase,
+        uint8_t erase_value)
+    : _read_size(read), _program_size(program), _erase_size(erase)
+    , _count(size / erase), _init(false), _sparse(true), _erase_value(erase_value), _allocated(0)
+    , _blocks(0), _sparse_blocks(0), _sparse_count(0), _sparse_capacity(0)
 {
     MBED_ASSERT(_count * _erase_size == size);
 }
@@ -41,23 +52,30 @@ HeapBlockDevice::~HeapBlockDevice()
         delete[] _blocks;
         _blocks = 0;
     }
+
+    for (bd_size_t i = 0; i < _sparse_count; i++) {
+        free(_sparse_blocks[i].data);
+    }
+    free(_sparse_blocks);
+    _sparse_blocks = 0;
 }
 
 int HeapBlockDevice::init()
 {
-    if (!_blocks) {
+    if (!_sparse && !_blocks) {
         _blocks = new uint8_t*[_count];
         for (size_t i = 0; i < _count; i++) {
             _blocks[i] = 0;
         }
     }
 
+    _init = true;
     return BD_ERROR_OK;
 }
 
 int HeapBlockDevice::deinit()
 {
-    MBED_ASSERT(_blocks != NULL);
+    MBED_ASSERT(_init);
     // Memory is lazily cleaned up in destructor to allow
     // data to live across de/reinitialization
     return BD_ERROR_OK;
@@ -65,31 +83,133 @@ int HeapBlockDevice::deinit()
 
 bd_size_t HeapBlockDevice::get_read_size() const
 {
-    MBED_ASSERT(_blocks != NULL);
+    MBED_ASSERT(_init);
     return _read_size;
 }
 
 bd_size_t HeapBlockDevice::get_program_size() const
 {
-    MBED_ASSERT(_blocks != NULL);
+    MBED_ASSERT(_init);
     return _program_size;
 }
 
 bd_size_t HeapBlockDevice::get_erase_size() const
 {
-    MBED_ASSERT(_blocks != NULL);
+    MBED_ASSERT(_init);
     return _erase_size;
 }
 
+int HeapBlockDevice::get_erase_value() const
+{
+    return _sparse ? _erase_value : -1;
+}
+
+bool HeapBlockDevice::is_erase_required() const
+{
+    return false;
+}
+
 bd_size_t HeapBlockDevice::size() const
 {
-    MBED_ASSERT(_blocks != NULL);
+    MBED_ASSERT(_init);
     return _count * _erase_size;
 }
 
+bd_size_t HeapBlockDevice::get_memory_used() const
+{
+    bd_size_t table = _blocks ? _count * sizeof(uint8_t*) : 0;
+    table += _sparse_capacity * sizeof(sparse_block);
+    return table + _allocated * _erase_size;
+}
+
+uint8_t *HeapBlockDevice::find(bd_size_t index, bd_size_t *pos) const
+{
+    if (!_sparse) {
+        return _blocks[index];
+    }
+
+    // binary search for the block, or where it would be inserted
+    bd_size_t lo = 0;
+    bd_size_t hi = _sparse_count;
+    while (lo < hi) {
+        bd_size_t mid = lo + (hi - lo) / 2;
+        if (_sparse_blocks[mid].index < index) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    if (pos) {
+        *pos = lo;
+    }
+    if (lo < _sparse_count && _sparse_blocks[lo].index == index) {
+        return _sparse_blocks[lo].data;
+    }
+    return 0;
+}
+
+uint8_t *HeapBlockDevice::allocate(bd_size_t index)
+{
+    bd_size_t pos;
+    uint8_t *data = find(index, &pos);
+    if (data) {
+        return data;
+    }
+
+    if (_sparse && _sparse_count == _sparse_capacity) {
+        bd_size_t capacity = _sparse_capacity ? 2 * _sparse_capacity : 8;
+        sparse_block *blocks = (sparse_block*)realloc(_sparse_blocks, capacity * sizeof(sparse_block));
+        if (!blocks) {
+            return 0;
+        }
+        _sparse_blocks = blocks;
+        _sparse_capacity = capacity;
+    }
+
+    // parts of the block that are not programmed read as before
+    data = (uint8_t*)malloc(_erase_size);
+    if (!data) {
+        return 0;
+    }
+    memset(data, _erase_value, _erase_size);
+    _allocated++;
+
+    if (!_sparse) {
+        _blocks[index] = data;
+    } else {
+        memmove(&_sparse_blocks[pos + 1], &_sparse_blocks[pos],
+                (_sparse_count - pos) * sizeof(sparse_block));
+        _sparse_blocks[pos].index = index;
+        _sparse_blocks[pos].data = data;
+        _sparse_count++;
+    }
+    return data;
+}
+
+void HeapBlockDevice::release(bd_size_t index)
+{
+    bd_size_t pos;
+    uint8_t *data = find(index, &pos);
+    if (!data) {
+        return;
+    }
+
+    free(data);
+    _allocated--;
+
+    if (!_sparse) {
+        _blocks[index] = 0;
+    } else {
+        _sparse_count--;
+        memmove(&_sparse_blocks[pos], &_sparse_blocks[pos + 1],
+                (_sparse_count - pos) * sizeof(sparse_block));
+    }
+}
+
 int HeapBlockDevice::read(void *b, bd_addr_t addr, bd_size_t size)
 {
-    MBED_ASSERT(_blocks != NULL);
+    MBED_ASSERT(_init);
     MBED_ASSERT(is_valid_read(addr, size));
     uint8_t *buffer = static_cast<uint8_t*>(b);
 
@@ -97,15 +217,22 @@ int HeapBlockDevice::read(void *b, bd_addr_t addr, bd_size_t size)
         bd_addr_t hi = addr / _erase_size;
         bd_addr_t lo = addr % _erase_size;
 
-        if (_blocks[hi]) {
-            memcpy(buffer, &_blocks[hi][lo], _read_size);
+        // read up to the end of the block at once
+        bd_size_t chunk = _erase_size - lo;
+        if (chunk > size) {
+            chunk = size;
+        }
+
+        const uint8_t *data = find(hi);
+        if (data) {
+            memcpy(buffer, &data[lo], chunk);
         } else {
-            memset(buffer, 0, _read_size);
+            memset(buffer, _erase_value, chunk);
         }
 
-        buffer += _read_size;
-        addr += _read_size;
-        size -= _read_size;
+        buffer += chunk;
+        addr += chunk;
+        size -= chunk;
     }
 
     return 0;
@@ -113,7 +240,7 @@ int HeapBlockDevice::read(void *b, bd_addr_t addr, bd_size_t size)
 
 int HeapBlockDevice::program(const void *b, bd_addr_t addr, bd_size_t size)
 {
-    MBED_ASSERT(_blocks != NULL);
+    MBED_ASSERT(_init);
     MBED_ASSERT(is_valid_program(addr, size));
     const uint8_t *buffer = static_cast<const uint8_t*>(b);
 
@@ -121,18 +248,21 @@ int HeapBlockDevice::program(const void *b, bd_addr_t addr, bd_size_t size)
         bd_addr_t hi = addr / _erase_size;
         bd_addr_t lo = addr % _erase_size;
 
-        if (!_blocks[hi]) {
-            _blocks[hi] = (uint8_t*)malloc(_erase_size);
-            if (!_blocks[hi]) {
-                return BD_ERROR_DEVICE_ERROR;
-            }
+        bd_size_t chunk = _erase_size - lo;
+        if (chunk > size) {
+            chunk = size;
+        }
+
+        uint8_t *data = allocate(hi);
+        if (!data) {
+            return BD_ERROR_DEVICE_ERROR;
         }
 
-        memcpy(&_blocks[hi][lo], buffer, _program_size);
+        memcpy(&data[lo], buffer, chunk);
 
-        buffer += _program_size;
-        addr += _program_size;
-        size -= _program_size;
+        buffer += chunk;
+        addr += chunk;
+        size -= chunk;
     }
 
     return 0;
@@ -140,10 +270,41 @@ int HeapBlockDevice::program(const void *b, bd_addr_t addr, bd_size_t size)
 
 int HeapBlockDevice::erase(bd_addr_t addr, bd_size_t size)
 {
-    MBED_ASSERT(_blocks != NULL);
+    MBED_ASSERT(_init);
     MBED_ASSERT(is_valid_erase(addr, size));
     // TODO assert on programming unerased blocks
 
+    if (_sparse) {
+        return trim(addr, size);
+    }
+
+    return 0;
+}
+
+int HeapBlockDevice::trim(bd_addr_t addr, bd_size_t size)
+{
+    MBED_ASSERT(_init);
+    MBED_ASSERT(is_valid_erase(addr, size));
+
+    while (size > 0) {
+        release(addr / _erase_size);
+
+        addr += _erase_size;
+        size -= _erase_size;
+    }
+
     return 0;
 }
 
+const void *HeapBlockDevice::get_mapped_address(bd_addr_t addr, bd_size_t size) const
+{
+    bd_addr_t hi = addr / _erase_size;
+    bd_addr_t lo = addr % _erase_size;
+
+    if (!_init || addr + size > this->size() || lo + size > _erase_size) {
+        return NULL;
+    }
+
+    const uint8_t *data = find(hi);
+    return data ? &data[lo] : NULL;
+}
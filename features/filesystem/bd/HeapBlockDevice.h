@@ -30,6 +30,13 @@
  *
  * Useful for simulating a block device and tests
  *
+ * Blocks are allocated when they are first programmed. By default a table
+ * with a pointer for every erase block of the device is kept as well. In
+ * sparse mode only the programmed blocks are kept, sorted by address, so
+ * devices much larger than the memory can be simulated as long as little
+ * of them is used. Sparse devices read as their erase value until they are
+ * programmed, and erasing blocks frees them.
+ *
  * @code
  * #include "mbed.h"
  * #include "HeapBlockDevice.h"
@@ -64,6 +71,19 @@ public:
      * @param erase     Minimum erase size required in bytes
      */
     HeapBlockDevice(bd_size_t size, bd_size_t read, bd_size_t program, bd_size_t erase);
+
+    /** Lifetime of a sparse memory block device
+     *
+     * @param size          Size of the Block Device in bytes
+     * @param read          Minimum read size required in bytes
+     * @param program       Minimum program size required in bytes
+     * @param erase         Minimum erase size required in bytes
+     * @param erase_value   Value blocks read as before they are programmed
+     *                      and after they are erased
+     */
+    HeapBlockDevice(bd_size_t size, bd_size_t read, bd_size_t program, bd_size_t erase,
+            uint8_t erase_value);
+
     virtual ~HeapBlockDevice();
 
     /** Initialize a block device
@@ -100,7 +120,9 @@ public:
 
     /** Erase blocks on a block device
      *
-     *  The state of an erased block is undefined until it has been programmed
+     *  The state of an erased block is undefined until it has been programmed,
+     *  except in sparse mode where erased blocks are freed and read as the
+     *  erase value
      *
      *  @param addr     Address of block to begin erasing
      *  @param size     Size to erase in bytes, must be a multiple of erase block size
@@ -108,6 +130,29 @@ public:
      */
     virtual int erase(bd_addr_t addr, bd_size_t size);
 
+    /** Mark blocks as no longer in use
+     *
+     *  The memory of the blocks is freed, they read as zero, or the erase
+     *  value in sparse mode, until they are programmed again.
+     *
+     *  @param addr     Address of block to mark as unused
+     *  @param size     Size to mark as unused in bytes, must be a multiple of erase block size
+     *  @return         0 on success, negative error code on failure
+     */
+    virtual int trim(bd_addr_t addr, bd_size_t size);
+
+    /** Get the address blocks can be read at in place
+     *
+     *  Each block is allocated on its own, so only ranges within a block
+     *  that has been programmed are mapped.
+     *
+     *  @param addr     Address of block to begin at
+     *  @param size     Size in bytes from the address
+     *  @return         Address the blocks are at in memory, or NULL if
+     *                  they are not in memory or not contiguous
+     */
+    virtual const void *get_mapped_address(bd_addr_t addr, bd_size_t size) const;
+
     /** Get the size of a readable block
      *
      *  @return         Size of a readable block in bytes
@@ -126,18 +171,55 @@ public:
      */
     virtual bd_size_t get_erase_size() const;
 
+    /** Get the value of storage when erased
+     *
+     *  @return         The erase value in sparse mode, -1 otherwise
+     */
+    virtual int get_erase_value() const;
+
+    /** Check if blocks must be erased before they are programmed
+     *
+     *  @return         False, programs overwrite the heap memory
+     */
+    virtual bool is_erase_required() const;
+
     /** Get the total size of the underlying device
      *
      *  @return         Size of the underlying device in bytes
      */
     virtual bd_size_t size() const;
 
+    /** Get the heap memory used by the device
+     *
+     *  @return         Bytes allocated for the blocks and the tables
+     *                  that keep track of them
+     */
+    bd_size_t get_memory_used() const;
+
 private:
+    struct sparse_block {
+        bd_size_t index;
+        uint8_t *data;
+    };
+
+    uint8_t *find(bd_size_t index, bd_size_t *pos = NULL) const;
+    uint8_t *allocate(bd_size_t index);
+    void release(bd_size_t index);
+
     bd_size_t _read_size;
     bd_size_t _program_size;
     bd_size_t _erase_size;
     bd_size_t _count;
+    bool _init;
+    bool _sparse;
+    uint8_t _erase_value;
+    bd_size_t _allocated;
+
+    // Pointer for every block, or the programmed blocks in sparse mode
     uint8_t **_blocks;
+    sparse_block *_sparse_blocks;
+    bd_size_t _sparse_count;
+    bd_size_t _sparse_capacity;
 };
 
 
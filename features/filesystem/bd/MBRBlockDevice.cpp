@@ -234,6 +234,11 @@ int MBRBlockDevice::deinit()
     return _bd->deinit();
 }
 
+int MBRBlockDevice::sync()
+{
+    return _bd->sync();
+}
+
 int MBRBlockDevice::read(void *b, bd_addr_t addr, bd_size_t size)
 {
     MBED_ASSERT(is_valid_read(addr, size));
@@ -252,6 +257,43 @@ int MBRBlockDevice::erase(bd_addr_t addr, bd_size_t size)
     return _bd->erase(addr + _offset, size);
 }
 
+int MBRBlockDevice::trim(bd_addr_t addr, bd_size_t size)
+{
+    MBED_ASSERT(is_valid_erase(addr, size));
+    return _bd->trim(addr + _offset, size);
+}
+
+const void *MBRBlockDevice::get_mapped_address(bd_addr_t addr, bd_size_t size) const
+{
+    if (addr + size > this->size()) {
+        return NULL;
+    }
+    return _bd->get_mapped_address(addr + _offset, size);
+}
+
+int MBRBlockDevice::read_async(void *b, bd_addr_t addr, bd_size_t size, bd_callback_t callback)
+{
+    MBED_ASSERT(is_valid_read(addr, size));
+    return _bd->read_async(b, addr + _offset, size, callback);
+}
+
+int MBRBlockDevice::program_async(const void *b, bd_addr_t addr, bd_size_t size, bd_callback_t callback)
+{
+    MBED_ASSERT(is_valid_program(addr, size));
+    return _bd->program_async(b, addr + _offset, size, callback);
+}
+
+int MBRBlockDevice::erase_async(bd_addr_t addr, bd_size_t size, bd_callback_t callback)
+{
+    MBED_ASSERT(is_valid_erase(addr, size));
+    return _bd->erase_async(addr + _offset, size, callback);
+}
+
+unsigned MBRBlockDevice::get_queue_depth() const
+{
+    return _bd->get_queue_depth();
+}
+
 bd_size_t MBRBlockDevice::get_read_size() const
 {
     return _bd->get_read_size();
@@ -267,6 +309,16 @@ bd_size_t MBRBlockDevice::get_erase_size() const
     return _bd->get_erase_size();
 }
 
+int MBRBlockDevice::get_erase_value() const
+{
+    return _bd->get_erase_value();
+}
+
+bool MBRBlockDevice::is_erase_required() const
+{
+    return _bd->is_erase_required();
+}
+
 bd_size_t MBRBlockDevice::size() const
 {
     return _size;
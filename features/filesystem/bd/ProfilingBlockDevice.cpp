@@ -15,14 +15,23 @@
  */
 
 #include "ProfilingBlockDevice.h"
+#include <string.h>
 
 
-ProfilingBlockDevice::ProfilingBlockDevice(BlockDevice *bd)
+ProfilingBlockDevice::ProfilingBlockDevice(BlockDevice *bd, bd_size_t trace_size)
     : _bd(bd)
-    , _read_count(0)
-    , _program_count(0)
-    , _erase_count(0)
+    , _trace(NULL)
+    , _trace_size(trace_size)
 {
+    if (_trace_size) {
+        _trace = new profile_record[_trace_size];
+    }
+    reset();
+}
+
+ProfilingBlockDevice::~ProfilingBlockDevice()
+{
+    delete[] _trace;
 }
 
 int ProfilingBlockDevice::init()
@@ -35,33 +44,97 @@ int ProfilingBlockDevice::deinit()
     return _bd->deinit();
 }
 
+int ProfilingBlockDevice::sync()
+{
+    return _bd->sync();
+}
+
 int ProfilingBlockDevice::read(void *b, bd_addr_t addr, bd_size_t size)
 {
+    uint32_t time = us_ticker_read();
     int err = _bd->read(b, addr, size);
     if (!err) {
         _read_count += size;
+        record(PROFILE_READ, addr, size, time, us_ticker_read() - time, true);
     }
     return err;
 }
 
 int ProfilingBlockDevice::program(const void *b, bd_addr_t addr, bd_size_t size)
 {
+    uint32_t time = us_ticker_read();
     int err = _bd->program(b, addr, size);
     if (!err) {
         _program_count += size;
+        record(PROFILE_PROGRAM, addr, size, time, us_ticker_read() - time, true);
     }
     return err;
 }
 
 int ProfilingBlockDevice::erase(bd_addr_t addr, bd_size_t size)
 {
+    uint32_t time = us_ticker_read();
     int err = _bd->erase(addr, size);
     if (!err) {
         _erase_count += size;
+        record(PROFILE_ERASE, addr, size, time, us_ticker_read() - time, true);
+    }
+    return err;
+}
+
+int ProfilingBlockDevice::trim(bd_addr_t addr, bd_size_t size)
+{
+    uint32_t time = us_ticker_read();
+    int err = _bd->trim(addr, size);
+    if (!err) {
+        record(PROFILE_TRIM, addr, size, time, us_ticker_read() - time, true);
+    }
+    return err;
+}
+
+const void *ProfilingBlockDevice::get_mapped_address(bd_addr_t addr, bd_size_t size) const
+{
+    return _bd->get_mapped_address(addr, size);
+}
+
+int ProfilingBlockDevice::read_async(void *b, bd_addr_t addr, bd_size_t size, bd_callback_t callback)
+{
+    uint32_t time = us_ticker_read();
+    int err = _bd->read_async(b, addr, size, callback);
+    if (!err) {
+        _read_count += size;
+        record(PROFILE_READ, addr, size, time, 0, false);
+    }
+    return err;
+}
+
+int ProfilingBlockDevice::program_async(const void *b, bd_addr_t addr, bd_size_t size, bd_callback_t callback)
+{
+    uint32_t time = us_ticker_read();
+    int err = _bd->program_async(b, addr, size, callback);
+    if (!err) {
+        _program_count += size;
+        record(PROFILE_PROGRAM, addr, size, time, 0, false);
+    }
+    return err;
+}
+
+int ProfilingBlockDevice::erase_async(bd_addr_t addr, bd_size_t size, bd_callback_t callback)
+{
+    uint32_t time = us_ticker_read();
+    int err = _bd->erase_async(addr, size, callback);
+    if (!err) {
+        _erase_count += size;
+        record(PROFILE_ERASE, addr, size, time, 0, false);
     }
     return err;
 }
 
+unsigned ProfilingBlockDevice::get_queue_depth() const
+{
+    return _bd->get_queue_depth();
+}
+
 bd_size_t ProfilingBlockDevice::get_read_size() const
 {
     return _bd->get_read_size();
@@ -77,6 +150,16 @@ bd_size_t ProfilingBlockDevice::get_erase_size() const
     return _bd->get_erase_size();
 }
 
+int ProfilingBlockDevice::get_erase_value() const
+{
+    return _bd->get_erase_value();
+}
+
+bool ProfilingBlockDevice::is_erase_required() const
+{
+    return _bd->is_erase_required();
+}
+
 bd_size_t ProfilingBlockDevice::size() const
 {
     return _bd->size();
@@ -87,6 +170,39 @@ void ProfilingBlockDevice::reset()
     _read_count = 0;
     _program_count = 0;
     _erase_count = 0;
+    memset(_op_count, 0, sizeof(_op_count));
+    memset(_sequential_count, 0, sizeof(_sequential_count));
+    memset(_next_addr, 0, sizeof(_next_addr));
+    memset(_histogram, 0, sizeof(_histogram));
+    _trace_count = 0;
+}
+
+void ProfilingBlockDevice::record(profile_op op, bd_addr_t addr, bd_size_t size,
+        uint32_t time, uint32_t latency, bool timed)
+{
+    if (_op_count[op] && addr == _next_addr[op]) {
+        _sequential_count[op] += 1;
+    }
+    _op_count[op] += 1;
+    _next_addr[op] = addr + size;
+
+    if (timed) {
+        int bucket = 0;
+        while (latency >> (bucket+1) && bucket < PROFILE_BUCKETS-1) {
+            bucket += 1;
+        }
+        _histogram[op][bucket] += 1;
+    }
+
+    if (_trace) {
+        profile_record *r = &_trace[_trace_count % _trace_size];
+        r->time = time;
+        r->latency = latency;
+        r->addr = addr;
+        r->size = size;
+        r->op = op;
+        _trace_count += 1;
+    }
 }
 
 bd_size_t ProfilingBlockDevice::get_read_count() const
@@ -103,3 +219,64 @@ bd_size_t ProfilingBlockDevice::get_erase_count() const
 {
     return _erase_count;
 }
+
+bd_size_t ProfilingBlockDevice::get_operation_count(profile_op op) const
+{
+    return _op_count[op];
+}
+
+bd_size_t ProfilingBlockDevice::get_sequential_count(profile_op op) const
+{
+    return _sequential_count[op];
+}
+
+const uint32_t *ProfilingBlockDevice::get_histogram(profile_op op) const
+{
+    return _histogram[op];
+}
+
+bd_size_t ProfilingBlockDevice::get_trace(profile_record *records, bd_size_t count) const
+{
+    bd_size_t recorded = (_trace_count < _trace_size) ? _trace_count : _trace_size;
+    if (count > recorded) {
+        count = recorded;
+    }
+
+    bd_size_t first = _trace_count - recorded;
+    for (bd_size_t i = 0; i < count; i++) {
+        records[i] = _trace[(first + i) % _trace_size];
+    }
+
+    return count;
+}
+
+bd_size_t ProfilingBlockDevice::get_trace_dropped() const
+{
+    return (_trace_count < _trace_size) ? 0 : _trace_count - _trace_size;
+}
+
+void ProfilingBlockDevice::print(FILE *file) const
+{
+    static const char *const names[PROFILE_OPS] = {"read", "program", "erase", "trim"};
+    const bd_size_t bytes[PROFILE_OPS] = {_read_count, _program_count, _erase_count, 0};
+
+    for (int op = 0; op < PROFILE_OPS; op++) {
+        fprintf(file, "histogram,%s,%llu,%llu,%llu", names[op],
+                (unsigned long long)_op_count[op],
+                (unsigned long long)_sequential_count[op],
+                (unsigned long long)bytes[op]);
+        for (int i = 0; i < PROFILE_BUCKETS; i++) {
+            fprintf(file, ",%lu", (unsigned long)_histogram[op][i]);
+        }
+        fprintf(file, "\n");
+    }
+
+    bd_size_t recorded = (_trace_count < _trace_size) ? _trace_count : _trace_size;
+    bd_size_t first = _trace_count - recorded;
+    for (bd_size_t i = 0; i < recorded; i++) {
+        const profile_record *r = &_trace[(first + i) % _trace_size];
+        fprintf(file, "trace,%s,%lu,%lu,%llu,%llu\n", names[r->op],
+                (unsigned long)r->time, (unsigned long)r->latency,
+                (unsigned long long)r->addr, (unsigned long long)r->size);
+    }
+}
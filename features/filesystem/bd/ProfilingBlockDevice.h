@@ -24,9 +24,19 @@
 
 #include "BlockDevice.h"
 #include "mbed.h"
+#include <stdio.h>
+
+#ifndef MBED_CONF_FILESYSTEM_PROFILING_TRACE_SIZE
+#define MBED_CONF_FILESYSTEM_PROFILING_TRACE_SIZE 0
+#endif
 
 
 /** Block device for measuring storage operations of another block device
+ *
+ *  Besides the bytes transferred, the profiler counts the operations of
+ *  each kind and how many of them start where the previous one ended, and
+ *  keeps a histogram of their latencies. It can also record the last
+ *  operations in a trace, which print writes out for tools on the host.
  *
  *  @code
  *  #include "mbed.h"
@@ -46,15 +56,45 @@
 class ProfilingBlockDevice : public BlockDevice
 {
 public:
+    /** Operations that are profiled
+     */
+    enum profile_op {
+        PROFILE_READ = 0,
+        PROFILE_PROGRAM,
+        PROFILE_ERASE,
+        PROFILE_TRIM,
+        PROFILE_OPS,
+    };
+
+    /** Number of buckets of a latency histogram
+     *
+     *  Bucket n counts latencies from 2^n up to 2^(n+1) microseconds, the
+     *  first bucket counts from 0 and the last has no upper bound.
+     */
+    static const int PROFILE_BUCKETS = 20;
+
+    /** Record of an operation in the trace
+     */
+    struct profile_record {
+        uint32_t time;      // start of the operation on the us_ticker
+        uint32_t latency;   // in microseconds, 0 if asynchronous
+        bd_addr_t addr;
+        bd_size_t size;
+        profile_op op;
+    };
+
     /** Lifetime of the memory block device
      *
-     *  @param bd       Block device to back the ProfilingBlockDevice
+     *  @param bd           Block device to back the ProfilingBlockDevice
+     *  @param trace_size   Number of operations to record in the trace,
+     *                      the oldest are dropped once it is full
      */
-    ProfilingBlockDevice(BlockDevice *bd);
+    ProfilingBlockDevice(BlockDevice *bd,
+            bd_size_t trace_size = MBED_CONF_FILESYSTEM_PROFILING_TRACE_SIZE);
 
     /** Lifetime of a block device
      */
-    virtual ~ProfilingBlockDevice() {};
+    virtual ~ProfilingBlockDevice();
 
     /** Initialize a block device
      *
@@ -70,6 +110,12 @@ public:
      */
     virtual int deinit();
 
+    /** Ensure data on storage is in sync with the driver
+     *
+     *  @return         0 on success or a negative error code on failure
+     */
+    virtual int sync();
+
     /** Read blocks from a block device
      *
      *  @param buffer   Buffer to read blocks into
@@ -100,6 +146,60 @@ public:
      */
     virtual int erase(bd_addr_t addr, bd_size_t size);
 
+    /** Mark blocks as no longer in use
+     *
+     *  @param addr     Address of block to mark as unused
+     *  @param size     Size to mark as unused in bytes, must be a multiple of erase block size
+     *  @return         0 on success, negative error code on failure
+     */
+    virtual int trim(bd_addr_t addr, bd_size_t size);
+
+    /** Get the address blocks can be read at in place
+     *
+     *  @param addr     Address of block to begin at
+     *  @param size     Size in bytes from the address
+     *  @return         Address the blocks are at in memory, or NULL if
+     *                  they are not in memory or not contiguous
+     */
+    virtual const void *get_mapped_address(bd_addr_t addr, bd_size_t size) const;
+
+    /** Read blocks from a block device without waiting for the transfer
+     *
+     *  Asynchronous operations are counted when they are started.
+     *
+     *  @param buffer   Buffer to read blocks into
+     *  @param addr     Address of block to begin reading from
+     *  @param size     Size to read in bytes, must be a multiple of read block size
+     *  @param callback Function called with the result of the read
+     *  @return         0 if the read was started, negative error code on failure
+     */
+    virtual int read_async(void *buffer, bd_addr_t addr, bd_size_t size, bd_callback_t callback);
+
+    /** Program blocks to a block device without waiting for the transfer
+     *
+     *  @param buffer   Buffer of data to write to blocks
+     *  @param addr     Address of block to begin writing to
+     *  @param size     Size to write in bytes, must be a multiple of program block size
+     *  @param callback Function called with the result of the program
+     *  @return         0 if the program was started, negative error code on failure
+     */
+    virtual int program_async(const void *buffer, bd_addr_t addr, bd_size_t size, bd_callback_t callback);
+
+    /** Erase blocks on a block device without waiting for the erase
+     *
+     *  @param addr     Address of block to begin erasing
+     *  @param size     Size to erase in bytes, must be a multiple of erase block size
+     *  @param callback Function called with the result of the erase
+     *  @return         0 if the erase was started, negative error code on failure
+     */
+    virtual int erase_async(bd_addr_t addr, bd_size_t size, bd_callback_t callback);
+
+    /** Get the number of asynchronous operations that can be in progress
+     *
+     *  @return         Number of operations that can be in progress
+     */
+    virtual unsigned get_queue_depth() const;
+
     /** Get the size of a readable block
      *
      *  @return         Size of a readable block in bytes
@@ -120,13 +220,27 @@ public:
      */
     virtual bd_size_t get_erase_size() const;
 
+    /** Get the value of storage when erased
+     *
+     *  @return         The value of storage when erased, or -1 if the value
+     *                  of erased storage is not defined
+     */
+    virtual int get_erase_value() const;
+
+    /** Check if blocks must be erased before they are programmed
+     *
+     *  @return         True if blocks must be erased before they are
+     *                  programmed
+     */
+    virtual bool is_erase_required() const;
+
     /** Get the total size of the underlying device
      *
      *  @return         Size of the underlying device in bytes
      */
     virtual bd_size_t size() const;
 
-    /** Reset the current profile counts to zero
+    /** Reset the current profile counts, histograms and trace to zero
      */
     void reset();
 
@@ -148,11 +262,78 @@ public:
      */
     bd_size_t get_erase_count() const;
 
+    /** Get number of operations of a kind on the block device
+     *
+     *  Asynchronous operations are counted when they are started.
+     *
+     *  @param op       Kind of operation
+     *  @return         The number of operations
+     */
+    bd_size_t get_operation_count(profile_op op) const;
+
+    /** Get number of operations of a kind that started at the address the
+     *  previous one of the kind ended
+     *
+     *  @param op       Kind of operation
+     *  @return         The number of sequential operations
+     */
+    bd_size_t get_sequential_count(profile_op op) const;
+
+    /** Get the latency histogram of a kind of operation
+     *
+     *  Asynchronous operations are not timed and not in the histogram.
+     *
+     *  @param op       Kind of operation
+     *  @return         Array of PROFILE_BUCKETS counts
+     */
+    const uint32_t *get_histogram(profile_op op) const;
+
+    /** Copy the recorded trace, oldest operation first
+     *
+     *  @param records  Array to copy records to
+     *  @param count    Number of records the array holds
+     *  @return         The number of records copied
+     */
+    bd_size_t get_trace(profile_record *records, bd_size_t count) const;
+
+    /** Get number of operations dropped from the trace when it was full
+     *
+     *  @return         The number of operations dropped
+     */
+    bd_size_t get_trace_dropped() const;
+
+    /** Write the profile out as comma separated lines
+     *
+     *  A line for each kind of operation holds its name, number of
+     *  operations, sequential operations, bytes and the histogram:
+     *  @code
+     *  histogram,read,<ops>,<sequential>,<bytes>,<bucket 0>,...
+     *  @endcode
+     *
+     *  It is followed by a line for each operation recorded in the trace:
+     *  @code
+     *  trace,read,<time>,<latency>,<address>,<size>
+     *  @endcode
+     *
+     *  @param file     Stream to write to, such as the serial port
+     */
+    void print(FILE *file = stdout) const;
+
 private:
+    void record(profile_op op, bd_addr_t addr, bd_size_t size,
+            uint32_t time, uint32_t latency, bool timed);
+
     BlockDevice *_bd;
     bd_size_t _read_count;
     bd_size_t _program_count;
     bd_size_t _erase_count;
+    bd_size_t _op_count[PROFILE_OPS];
+    bd_size_t _sequential_count[PROFILE_OPS];
+    bd_addr_t _next_addr[PROFILE_OPS];
+    uint32_t _histogram[PROFILE_OPS][PROFILE_BUCKETS];
+    profile_record *_trace;
+    bd_size_t _trace_size;
+    bd_size_t _trace_count;
 };
 
 
@@ -75,6 +75,11 @@ int SlicingBlockDevice::deinit()
     return _bd->deinit();
 }
 
+int SlicingBlockDevice::sync()
+{
+    return _bd->sync();
+}
+
 int SlicingBlockDevice::read(void *b, bd_addr_t addr, bd_size_t size)
 {
     MBED_ASSERT(is_valid_read(addr, size));
@@ -93,6 +98,43 @@ int SlicingBlockDevice::erase(bd_addr_t addr, bd_size_t size)
     return _bd->erase(addr + _start, size);
 }
 
+int SlicingBlockDevice::trim(bd_addr_t addr, bd_size_t size)
+{
+    MBED_ASSERT(is_valid_erase(addr, size));
+    return _bd->trim(addr + _start, size);
+}
+
+const void *SlicingBlockDevice::get_mapped_address(bd_addr_t addr, bd_size_t size) const
+{
+    if (addr + size > this->size()) {
+        return NULL;
+    }
+    return _bd->get_mapped_address(addr + _start, size);
+}
+
+int SlicingBlockDevice::read_async(void *b, bd_addr_t addr, bd_size_t size, bd_callback_t callback)
+{
+    MBED_ASSERT(is_valid_read(addr, size));
+    return _bd->read_async(b, addr + _start, size, callback);
+}
+
+int SlicingBlockDevice::program_async(const void *b, bd_addr_t addr, bd_size_t size, bd_callback_t callback)
+{
+    MBED_ASSERT(is_valid_program(addr, size));
+    return _bd->program_async(b, addr + _start, size, callback);
+}
+
+int SlicingBlockDevice::erase_async(bd_addr_t addr, bd_size_t size, bd_callback_t callback)
+{
+    MBED_ASSERT(is_valid_erase(addr, size));
+    return _bd->erase_async(addr + _start, size, callback);
+}
+
+unsigned SlicingBlockDevice::get_queue_depth() const
+{
+    return _bd->get_queue_depth();
+}
+
 bd_size_t SlicingBlockDevice::get_read_size() const
 {
     return _bd->get_read_size();
@@ -108,6 +150,16 @@ bd_size_t SlicingBlockDevice::get_erase_size() const
     return _bd->get_erase_size();
 }
 
+int SlicingBlockDevice::get_erase_value() const
+{
+    return _bd->get_erase_value();
+}
+
+bool SlicingBlockDevice::is_erase_required() const
+{
+    return _bd->is_erase_required();
+}
+
 bd_size_t SlicingBlockDevice::size() const
 {
     return _stop - _start;
@@ -0,0 +1,446 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "StripingBlockDevice.h"
+
+
+StripingBlockDevice::StripingBlockDevice(BlockDevice **bds, size_t bd_count, bd_size_t stripe_size)
+    : _bds(bds), _bd_count(bd_count), _lanes(0)
+    , _stripe_size(stripe_size), _read_size(0), _program_size(0), _erase_size(0), _size(0)
+{
+}
+
+StripingBlockDevice::~StripingBlockDevice()
+{
+    delete[] _lanes;
+}
+
+static bool is_aligned(uint64_t x, uint64_t alignment)
+{
+    return (x / alignment) * alignment == x;
+}
+
+static void wait_async_done()
+{
+#if MBED_CONF_RTOS_PRESENT
+    rtos::Thread::yield();
+#endif
+}
+
+static void wait_async_result(int *result, int err)
+{
+    *(volatile int *)result = err;
+}
+
+int StripingBlockDevice::init()
+{
+    MBED_ASSERT(_bd_count > 0);
+    _read_size = 0;
+    _program_size = 0;
+    _erase_size = 0;
+    _size = 0;
+
+    // Initialize children block devices, find all sizes and
+    // assert that block sizes are similar, as ChainingBlockDevice does
+    bd_size_t min_size = 0;
+    for (size_t i = 0; i < _bd_count; i++) {
+        int err = _bds[i]->init();
+        if (err) {
+            return err;
+        }
+
+        bd_size_t read = _bds[i]->get_read_size();
+        if (i == 0 || (read >= _read_size && is_aligned(read, _read_size))) {
+            _read_size = read;
+        } else {
+            MBED_ASSERT(_read_size > read && is_aligned(_read_size, read));
+        }
+
+        bd_size_t program = _bds[i]->get_program_size();
+        if (i == 0 || (program >= _program_size && is_aligned(program, _program_size))) {
+            _program_size = program;
+        } else {
+            MBED_ASSERT(_program_size > program && is_aligned(_program_size, program));
+        }
+
+        bd_size_t erase = _bds[i]->get_erase_size();
+        if (i == 0 || (erase >= _erase_size && is_aligned(erase, _erase_size))) {
+            _erase_size = erase;
+        } else {
+            MBED_ASSERT(_erase_size > erase && is_aligned(_erase_size, erase));
+        }
+
+        bd_size_t size = _bds[i]->size();
+        if (i == 0 || size < min_size) {
+            min_size = size;
+        }
+    }
+
+    // Stripes hold whole erase blocks, so erases never span block devices
+    if (!_stripe_size) {
+        _stripe_size = _erase_size;
+    }
+    MBED_ASSERT(is_aligned(_stripe_size, _erase_size));
+
+    _size = (min_size / _stripe_size) * _stripe_size * _bd_count;
+
+    if (!_lanes) {
+        _lanes = new lane[MBED_CONF_FILESYSTEM_STRIPE_QUEUE_DEPTH * _bd_count];
+    }
+
+    return 0;
+}
+
+int StripingBlockDevice::deinit()
+{
+    for (size_t i = 0; i < _bd_count; i++) {
+        int err = _bds[i]->deinit();
+        if (err) {
+            return err;
+        }
+    }
+
+    delete[] _lanes;
+    _lanes = 0;
+    return 0;
+}
+
+int StripingBlockDevice::sync()
+{
+    for (size_t i = 0; i < _bd_count; i++) {
+        int err = _bds[i]->sync();
+        if (err) {
+            return err;
+        }
+    }
+
+    return 0;
+}
+
+int StripingBlockDevice::wait_async(async_type type, uint8_t *buffer, bd_addr_t addr, bd_size_t size)
+{
+    // The synchronous operations run the block devices concurrently too
+    int result = 1;
+    int err;
+    while ((err = start_async(type, buffer, addr, size,
+            callback(wait_async_result, &result))) == BD_ERROR_WOULD_BLOCK) {
+        wait_async_done();
+    }
+    if (err) {
+        return err;
+    }
+
+    while (*(volatile int *)&result == 1) {
+        wait_async_done();
+    }
+
+    return result;
+}
+
+int StripingBlockDevice::read(void *b, bd_addr_t addr, bd_size_t size)
+{
+    MBED_ASSERT(is_valid_read(addr, size));
+    return wait_async(ASYNC_READ, static_cast<uint8_t*>(b), addr, size);
+}
+
+int StripingBlockDevice::program(const void *b, bd_addr_t addr, bd_size_t size)
+{
+    MBED_ASSERT(is_valid_program(addr, size));
+    // the buffer is only read, by program_async
+    return wait_async(ASYNC_PROGRAM, static_cast<uint8_t*>(const_cast<void*>(b)), addr, size);
+}
+
+int StripingBlockDevice::erase(bd_addr_t addr, bd_size_t size)
+{
+    MBED_ASSERT(is_valid_erase(addr, size));
+    return wait_async(ASYNC_ERASE, NULL, addr, size);
+}
+
+int StripingBlockDevice::trim(bd_addr_t addr, bd_size_t size)
+{
+    MBED_ASSERT(is_valid_erase(addr, size));
+
+    // Trimming does no transfers, so the stripes are simply trimmed in turn
+    while (size > 0) {
+        bd_addr_t stripe = addr / _stripe_size;
+        bd_addr_t offset = addr % _stripe_size;
+        bd_size_t trim = _stripe_size - offset;
+        if (trim > size) {
+            trim = size;
+        }
+
+        int err = _bds[stripe % _bd_count]->trim(
+                (stripe / _bd_count) * _stripe_size + offset, trim);
+        if (err) {
+            return err;
+        }
+
+        addr += trim;
+        size -= trim;
+    }
+
+    return 0;
+}
+
+const void *StripingBlockDevice::get_mapped_address(bd_addr_t addr, bd_size_t size) const
+{
+    // Only blocks within one stripe are contiguous
+    bd_addr_t stripe = addr / _stripe_size;
+    bd_addr_t offset = addr % _stripe_size;
+    if (offset + size > _stripe_size) {
+        return NULL;
+    }
+
+    return _bds[stripe % _bd_count]->get_mapped_address(
+            (stripe / _bd_count) * _stripe_size + offset, size);
+}
+
+void StripingBlockDevice::async_op::done(int result)
+{
+    core_util_critical_section_enter();
+    if (result && !err) {
+        err = result;
+    }
+    bool last = --pending == 0;
+    bd_callback_t cb = callback;
+    int e = err;
+    if (last) {
+        used = false;
+    }
+    core_util_critical_section_exit();
+
+    if (last) {
+        cb(e);
+    }
+}
+
+void StripingBlockDevice::lane::done(int result)
+{
+    core_util_critical_section_enter();
+    this->result = result;
+    if (starting) {
+        // completed within the call starting it, run_lane carries on
+        completed = true;
+        core_util_critical_section_exit();
+        return;
+    }
+    core_util_critical_section_exit();
+
+    if (result) {
+        op->done(result);
+        return;
+    }
+    owner->run_lane(this);
+}
+
+void StripingBlockDevice::run_lane(lane *l)
+{
+    async_op *op = l->op;
+
+    // Stripes completing synchronously loop here rather than recursing
+    // through the callbacks, the stack stays flat on blocking drivers
+    while (true) {
+        bd_addr_t addr = l->next;
+        if (op->err || addr >= op->end) {
+            op->done(0);
+            return;
+        }
+
+        bd_addr_t stripe = addr / _stripe_size;
+        bd_addr_t offset = addr % _stripe_size;
+        bd_size_t part = _stripe_size - offset;
+        if (addr + part > op->end) {
+            part = op->end - addr;
+        }
+        bd_addr_t bd_addr = (stripe / _bd_count) * _stripe_size + offset;
+        l->next = (stripe + _bd_count) * _stripe_size;
+
+        l->starting = true;
+        l->completed = false;
+
+        BlockDevice *bd = _bds[l->bd];
+        bd_callback_t done(l, &lane::done);
+        int err;
+        if (op->type == ASYNC_READ) {
+            err = bd->read_async(op->buffer + (addr - op->addr), bd_addr, part, done);
+        } else if (op->type == ASYNC_PROGRAM) {
+            err = bd->program_async(op->buffer + (addr - op->addr), bd_addr, part, done);
+        } else {
+            err = bd->erase_async(bd_addr, part, done);
+        }
+
+        if (err) {
+            // not started, so done is not called
+            op->done(err);
+            return;
+        }
+
+        core_util_critical_section_enter();
+        l->starting = false;
+        bool completed = l->completed;
+        core_util_critical_section_exit();
+
+        if (!completed) {
+            // the callback runs the next stripe
+            return;
+        }
+
+        if (l->result) {
+            op->done(l->result);
+            return;
+        }
+    }
+}
+
+int StripingBlockDevice::start_async(async_type type, uint8_t *buffer,
+        bd_addr_t addr, bd_size_t size, bd_callback_t callback)
+{
+    MBED_ASSERT(_lanes != NULL);
+
+    size_t index = 0;
+    async_op *op = NULL;
+    core_util_critical_section_enter();
+    for (size_t i = 0; i < MBED_CONF_FILESYSTEM_STRIPE_QUEUE_DEPTH; i++) {
+        if (!_ops[i].used) {
+            index = i;
+            op = &_ops[i];
+            op->used = true;
+            break;
+        }
+    }
+    core_util_critical_section_exit();
+
+    if (!op) {
+        return BD_ERROR_WOULD_BLOCK;
+    }
+
+    op->callback = callback;
+    op->type = type;
+    op->buffer = buffer;
+    op->addr = addr;
+    op->end = addr + size;
+    op->err = 0;
+
+    // Find the first stripe of each block device in the range, the
+    // block devices without one have nothing to do
+    bd_addr_t first = addr / _stripe_size;
+    lane *lanes = &_lanes[index * _bd_count];
+    size_t count = 0;
+    for (size_t i = 0; i < _bd_count; i++) {
+        bd_addr_t stripe = first + (i + _bd_count - first % _bd_count) % _bd_count;
+        bd_addr_t next = stripe == first ? addr : stripe * _stripe_size;
+        if (next >= op->end) {
+            continue;
+        }
+
+        lane *l = &lanes[count++];
+        l->owner = this;
+        l->op = op;
+        l->bd = i;
+        l->next = next;
+    }
+
+    // One extra count holds the callback back until all lanes are started
+    op->pending = count + 1;
+    for (size_t i = 0; i < count; i++) {
+        run_lane(&lanes[i]);
+    }
+
+    op->done(0);
+    return 0;
+}
+
+int StripingBlockDevice::read_async(void *b, bd_addr_t addr, bd_size_t size, bd_callback_t callback)
+{
+    MBED_ASSERT(is_valid_read(addr, size));
+    return start_async(ASYNC_READ, static_cast<uint8_t*>(b), addr, size, callback);
+}
+
+int StripingBlockDevice::program_async(const void *b, bd_addr_t addr, bd_size_t size, bd_callback_t callback)
+{
+    MBED_ASSERT(is_valid_program(addr, size));
+    // the buffer is only read, by program_async
+    return start_async(ASYNC_PROGRAM, static_cast<uint8_t*>(const_cast<void*>(b)), addr, size, callback);
+}
+
+int StripingBlockDevice::erase_async(bd_addr_t addr, bd_size_t size, bd_callback_t callback)
+{
+    MBED_ASSERT(is_valid_erase(addr, size));
+    return start_async(ASYNC_ERASE, NULL, addr, size, callback);
+}
+
+unsigned StripingBlockDevice::get_queue_depth() const
+{
+    // an operation takes at most one place in the queue of each block device
+    unsigned depth = MBED_CONF_FILESYSTEM_STRIPE_QUEUE_DEPTH;
+    for (size_t i = 0; i < _bd_count; i++) {
+        unsigned bd_depth = _bds[i]->get_queue_depth();
+        if (bd_depth < depth) {
+            depth = bd_depth;
+        }
+    }
+
+    return depth;
+}
+
+bd_size_t StripingBlockDevice::get_read_size() const
+{
+    return _read_size;
+}
+
+bd_size_t StripingBlockDevice::get_program_size() const
+{
+    return _program_size;
+}
+
+bd_size_t StripingBlockDevice::get_erase_size() const
+{
+    return _erase_size;
+}
+
+int StripingBlockDevice::get_erase_value() const
+{
+    // only defined if the same for all the block devices
+    int value = _bd_count ? _bds[0]->get_erase_value() : -1;
+    for (size_t i = 1; i < _bd_count; i++) {
+        if (_bds[i]->get_erase_value() != value) {
+            return -1;
+        }
+    }
+
+    return value;
+}
+
+bool StripingBlockDevice::is_erase_required() const
+{
+    for (size_t i = 0; i < _bd_count; i++) {
+        if (_bds[i]->is_erase_required()) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bd_size_t StripingBlockDevice::get_stripe_size() const
+{
+    return _stripe_size;
+}
+
+bd_size_t StripingBlockDevice::size() const
+{
+    return _size;
+}
@@ -0,0 +1,292 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef MBED_STRIPING_BLOCK_DEVICE_H
+#define MBED_STRIPING_BLOCK_DEVICE_H
+
+#include "BlockDevice.h"
+#include "mbed.h"
+
+#ifndef MBED_CONF_FILESYSTEM_STRIPE_QUEUE_DEPTH
+#define MBED_CONF_FILESYSTEM_STRIPE_QUEUE_DEPTH 4
+#endif
+
+
+/** Block device for interleaving multiple block devices
+ *  in stripes, so sequential operations use all of them at once
+ *
+ *  Stripe n is stored on block device n % count. Operations are split
+ *  into stripes and the stripes of each block device are transferred in
+ *  turn, with all the block devices working concurrently through the
+ *  asynchronous block device API.
+ *
+ *  @code
+ *  #include "mbed.h"
+ *  #include "HeapBlockDevice.h"
+ *  #include "StripingBlockDevice.h"
+ *
+ *  // Create two block devices with 64 blocks of size 512 bytes
+ *  HeapBlockDevice mem1(64*512, 512);
+ *  HeapBlockDevice mem2(64*512, 512);
+ *
+ *  // Create a block device backed by mem1 and mem2
+ *  // contains 128 blocks of size 512 bytes, with
+ *  // even blocks on mem1 and odd blocks on mem2
+ *  BlockDevice *bds[] = {&mem1, &mem2};
+ *  StripingBlockDevice stripemem(bds);
+ *  @endcode
+ */
+class StripingBlockDevice : public BlockDevice
+{
+public:
+    /** Lifetime of the memory block device
+     *
+     *  @param bds         Array of block devices to interleave
+     *  @param bd_count    Number of block devices to interleave
+     *  @param stripe_size Size of a stripe in bytes, a multiple of the erase size,
+     *                     or 0 to use the erase size
+     *  @note The size of the block device is the size of the smallest block
+     *        device, in whole stripes, times the number of block devices
+     */
+    StripingBlockDevice(BlockDevice **bds, size_t bd_count, bd_size_t stripe_size);
+
+    /** Lifetime of the memory block device
+     *
+     *  @param bds         Array of block devices to interleave
+     *  @param stripe_size Size of a stripe in bytes, a multiple of the erase size,
+     *                     or 0 to use the erase size
+     */
+    template <size_t Size>
+    StripingBlockDevice(BlockDevice *(&bds)[Size], bd_size_t stripe_size = 0)
+        : _bds(bds), _bd_count(sizeof(bds) / sizeof(bds[0])), _lanes(0)
+        , _stripe_size(stripe_size), _read_size(0), _program_size(0), _erase_size(0), _size(0)
+    {
+    }
+
+    /** Lifetime of the memory block device
+     *
+     */
+    virtual ~StripingBlockDevice();
+
+    /** Initialize a block device
+     *
+     *  @return         0 on success or a negative error code on failure
+     */
+    virtual int init();
+
+    /** Deinitialize a block device
+     *
+     *  @return         0 on success or a negative error code on failure
+     */
+    virtual int deinit();
+
+    /** Ensure data on storage is in sync with the driver
+     *
+     *  @return         0 on success or a negative error code on failure
+     */
+    virtual int sync();
+
+    /** Read blocks from a block device
+     *
+     *  @param buffer   Buffer to write blocks to
+     *  @param addr     Address of block to begin reading from
+     *  @param size     Size to read in bytes, must be a multiple of read block size
+     *  @return         0 on success, negative error code on failure
+     */
+    virtual int read(void *buffer, bd_addr_t addr, bd_size_t size);
+
+    /** Program blocks to a block device
+     *
+     *  The blocks must have been erased prior to being programmed
+     *
+     *  @param buffer   Buffer of data to write to blocks
+     *  @param addr     Address of block to begin writing to
+     *  @param size     Size to write in bytes, must be a multiple of program block size
+     *  @return         0 on success, negative error code on failure
+     */
+    virtual int program(const void *buffer, bd_addr_t addr, bd_size_t size);
+
+    /** Erase blocks on a block device
+     *
+     *  The state of an erased block is undefined until it has been programmed
+     *
+     *  @param addr     Address of block to begin erasing
+     *  @param size     Size to erase in bytes, must be a multiple of erase block size
+     *  @return         0 on success, negative error code on failure
+     */
+    virtual int erase(bd_addr_t addr, bd_size_t size);
+
+    /** Mark blocks as no longer in use
+     *
+     *  @param addr     Address of block to mark as unused
+     *  @param size     Size to mark as unused in bytes, must be a multiple of erase block size
+     *  @return         0 on success, negative error code on failure
+     */
+    virtual int trim(bd_addr_t addr, bd_size_t size);
+
+    /** Get the address blocks can be read at in place
+     *
+     *  @param addr     Address of block to begin at
+     *  @param size     Size in bytes from the address
+     *  @return         Address the blocks are at in memory, or NULL if
+     *                  they are not in memory or not within one stripe
+     */
+    virtual const void *get_mapped_address(bd_addr_t addr, bd_size_t size) const;
+
+    /** Read blocks from a block device without waiting for the transfer
+     *
+     *  The stripes on each block device are read one after the other,
+     *  and the block devices are read at once. The next stripe may be
+     *  started from the callback of the previous one, so from an interrupt.
+     *
+     *  @param buffer   Buffer to read blocks into
+     *  @param addr     Address of block to begin reading from
+     *  @param size     Size to read in bytes, must be a multiple of read block size
+     *  @param callback Function called with the result of the read
+     *  @return         0 if the read was started, negative error code on failure
+     */
+    virtual int read_async(void *buffer, bd_addr_t addr, bd_size_t size, bd_callback_t callback);
+
+    /** Program blocks to a block device without waiting for the transfer
+     *
+     *  @param buffer   Buffer of data to write to blocks
+     *  @param addr     Address of block to begin writing to
+     *  @param size     Size to write in bytes, must be a multiple of program block size
+     *  @param callback Function called with the result of the program
+     *  @return         0 if the program was started, negative error code on failure
+     */
+    virtual int program_async(const void *buffer, bd_addr_t addr, bd_size_t size, bd_callback_t callback);
+
+    /** Erase blocks on a block device without waiting for the erase
+     *
+     *  @param addr     Address of block to begin erasing
+     *  @param size     Size to erase in bytes, must be a multiple of erase block size
+     *  @param callback Function called with the result of the erase
+     *  @return         0 if the erase was started, negative error code on failure
+     */
+    virtual int erase_async(bd_addr_t addr, bd_size_t size, bd_callback_t callback);
+
+    /** Get the number of asynchronous operations that can be in progress
+     *
+     *  @return         Number of operations that can be in progress
+     */
+    virtual unsigned get_queue_depth() const;
+
+    /** Get the size of a readable block
+     *
+     *  @return         Size of a readable block in bytes
+     */
+    virtual bd_size_t get_read_size() const;
+
+    /** Get the size of a programable block
+     *
+     *  @return         Size of a programable block in bytes
+     *  @note Must be a multiple of the read size
+     */
+    virtual bd_size_t get_program_size() const;
+
+    /** Get the size of a eraseable block
+     *
+     *  @return         Size of a eraseable block in bytes
+     *  @note Must be a multiple of the program size
+     */
+    virtual bd_size_t get_erase_size() const;
+
+    /** Get the value of storage when erased
+     *
+     *  @return         The value of storage when erased, or -1 if the value
+     *                  of erased storage is not defined
+     */
+    virtual int get_erase_value() const;
+
+    /** Check if blocks must be erased before they are programmed
+     *
+     *  @return         True if blocks must be erased before they are
+     *                  programmed
+     */
+    virtual bool is_erase_required() const;
+
+    /** Get the size of a stripe
+     *
+     *  @return         Size of a stripe in bytes
+     */
+    bd_size_t get_stripe_size() const;
+
+    /** Get the total size of the underlying device
+     *
+     *  @return         Size of the underlying device in bytes
+     */
+    virtual bd_size_t size() const;
+
+protected:
+    enum async_type {
+        ASYNC_READ,
+        ASYNC_PROGRAM,
+        ASYNC_ERASE
+    };
+
+    struct async_op;
+
+    // The stripes of an operation on one block device, transferred in turn
+    struct lane {
+        StripingBlockDevice *owner;
+        async_op *op;
+        size_t bd;
+        bd_addr_t next;
+        int result;
+        bool starting;
+        bool completed;
+
+        void done(int result);
+    };
+
+    // An asynchronous operation, pending counts the lanes in progress
+    struct async_op {
+        bd_callback_t callback;
+        async_type type;
+        uint8_t *buffer;
+        bd_addr_t addr;
+        bd_addr_t end;
+        int pending;
+        int err;
+        bool used;
+
+        async_op() : pending(0), err(0), used(false) {}
+        void done(int result);
+    };
+
+    int start_async(async_type type, uint8_t *buffer, bd_addr_t addr, bd_size_t size, bd_callback_t callback);
+    int wait_async(async_type type, uint8_t *buffer, bd_addr_t addr, bd_size_t size);
+    void run_lane(lane *l);
+
+    async_op _ops[MBED_CONF_FILESYSTEM_STRIPE_QUEUE_DEPTH];
+    BlockDevice **_bds;
+    size_t _bd_count;
+    lane *_lanes;
+    bd_size_t _stripe_size;
+    bd_size_t _read_size;
+    bd_size_t _program_size;
+    bd_size_t _erase_size;
+    bd_size_t _size;
+};
+
+
+#endif
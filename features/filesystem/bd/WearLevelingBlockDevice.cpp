@@ -0,0 +1,626 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "WearLevelingBlockDevice.h"
+#include <string.h>
+
+// Metadata slots of an erase block, in its first page
+#define WL_SLOT_HEADER  0       // magic, erase count and its complement
+#define WL_SLOT_SEQ     1       // sequence number and its complement
+#define WL_SLOT_PAGES   2       // logical block of each page and its complement
+
+#define WL_MAGIC        0x4c574c57  // "WLWL"
+#define WL_NONE         0xffff      // unmapped in _map
+#define WL_NO_BLOCK     ((bd_size_t)-1)
+
+
+WearLevelingBlockDevice::WearLevelingBlockDevice(BlockDevice *bd, bd_size_t block_size,
+        bd_size_t reserved, uint32_t threshold)
+    : _bd(bd)
+    , _block_size(block_size)
+    , _reserved(reserved)
+    , _threshold(threshold)
+    , _erase_size(0), _slot_size(0), _pages(0), _blocks(0), _lblocks(0)
+    , _erased(0xff)
+    , _map(0), _erase_count(0), _seq(0), _valid(0), _state(0), _page(0), _slot(0)
+    , _active(WL_NO_BLOCK), _next_page(0), _next_seq(0)
+{
+    MBED_ASSERT(_reserved >= 3);
+}
+
+WearLevelingBlockDevice::~WearLevelingBlockDevice()
+{
+    deinit();
+}
+
+int WearLevelingBlockDevice::init()
+{
+    int err = _bd->init();
+    if (err) {
+        return err;
+    }
+
+    if (_map) {
+        return BD_ERROR_OK;
+    }
+
+    _erase_size = _bd->get_erase_size();
+    _blocks = _bd->size() / _erase_size;
+    _pages = _erase_size / _block_size - 1;
+    bd_size_t program = _bd->get_program_size();
+    _slot_size = ((16 + program - 1) / program) * program;
+
+    // the metadata of all the pages must fit in the first page
+    if (_erase_size % _block_size != 0 || _pages < 1
+            || _block_size % _bd->get_read_size() != 0 || _block_size % program != 0
+            || (WL_SLOT_PAGES + _pages) * _slot_size > _block_size
+            || _reserved < 3 || _blocks <= _reserved || _blocks * _pages >= WL_NONE) {
+        _bd->deinit();
+        return BD_ERROR_PARAMETER;
+    }
+
+    // erased flash of unknown value is taken to be 0xff, on block devices
+    // without erase the metadata page is filled with it instead
+    int value = _bd->get_erase_value();
+    _erased = value < 0 ? 0xff : value;
+
+    _lblocks = (_blocks - _reserved) * _pages;
+    _map = new uint16_t[_lblocks];
+    _erase_count = new uint32_t[_blocks];
+    _seq = new uint32_t[_blocks];
+    _valid = new uint16_t[_blocks];
+    _state = new uint8_t[_blocks];
+    _page = new uint8_t[_block_size];
+    _slot = new uint8_t[_slot_size];
+
+    err = scan();
+
+    // A power loss after the last free block was taken, before a block
+    // was moved out to free another, leaves none free. The move is
+    // finished in the newest block before anything else is written.
+    if (!err && free_count() == 0) {
+        err = move(least_valid());
+    }
+
+    if (err) {
+        deinit();
+    }
+    return err;
+}
+
+int WearLevelingBlockDevice::deinit()
+{
+    if (!_map) {
+        return BD_ERROR_OK;
+    }
+
+    delete[] _map;
+    _map = 0;
+    delete[] _erase_count;
+    delete[] _seq;
+    delete[] _valid;
+    delete[] _state;
+    delete[] _page;
+    delete[] _slot;
+    _active = WL_NO_BLOCK;
+
+    return _bd->deinit();
+}
+
+int WearLevelingBlockDevice::sync()
+{
+    // nothing is buffered
+    return _bd->sync();
+}
+
+bd_addr_t WearLevelingBlockDevice::page_addr(uint16_t page) const
+{
+    return (bd_addr_t)(page / _pages) * _erase_size + (page % _pages + 1) * _block_size;
+}
+
+bd_addr_t WearLevelingBlockDevice::slot_addr(bd_size_t block, bd_size_t slot) const
+{
+    return (bd_addr_t)block * _erase_size + slot * _slot_size;
+}
+
+int WearLevelingBlockDevice::program_slot(bd_size_t block, bd_size_t slot, uint32_t a, uint32_t b)
+{
+    memset(_slot, _erased, _slot_size);
+    memcpy(&_slot[0], &a, sizeof(a));
+    memcpy(&_slot[4], &b, sizeof(b));
+    return _bd->program(_slot, slot_addr(block, slot), _slot_size);
+}
+
+static bool slot_word_pair(const uint8_t *slot, uint32_t *value)
+{
+    uint32_t a, b;
+    memcpy(&a, &slot[0], sizeof(a));
+    memcpy(&b, &slot[4], sizeof(b));
+    *value = a;
+    return a == ~b;
+}
+
+bool WearLevelingBlockDevice::is_erased(const uint8_t *data, bd_size_t size) const
+{
+    for (bd_size_t i = 0; i < size; i++) {
+        if (data[i] != _erased) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int WearLevelingBlockDevice::scan()
+{
+    uint32_t max_count = 0;
+    bd_size_t newest = WL_NO_BLOCK;
+    _next_seq = 0;
+
+    for (bd_size_t i = 0; i < _lblocks; i++) {
+        _map[i] = WL_NONE;
+    }
+
+    for (bd_size_t block = 0; block < _blocks; block++) {
+        int err = _bd->read(_page, slot_addr(block, 0), _block_size);
+        if (err) {
+            return err;
+        }
+
+        uint32_t magic, count, count_check;
+        memcpy(&magic, &_page[0], sizeof(magic));
+        memcpy(&count, &_page[4], sizeof(count));
+        memcpy(&count_check, &_page[8], sizeof(count_check));
+        bool counted = magic == WL_MAGIC && count == ~count_check;
+        _erase_count[block] = counted ? count : 0;
+        if (counted && count > max_count) {
+            max_count = count;
+        }
+
+        // The header is programmed once the block is erased, so a block
+        // with a header and no sequence number is only dirty if opening
+        // or writing it was interrupted
+        uint32_t seq;
+        _valid[block] = 0;
+        if (!counted || !slot_word_pair(&_page[WL_SLOT_SEQ * _slot_size], &seq)) {
+            _state[block] = counted && is_erased(&_page[WL_SLOT_SEQ * _slot_size],
+                    _block_size - WL_SLOT_SEQ * _slot_size) ? WL_ERASED : WL_DIRTY;
+            _seq[block] = 0;
+            continue;
+        }
+
+        _state[block] = WL_USED;
+        _seq[block] = seq;
+        if (seq >= _next_seq) {
+            _next_seq = seq + 1;
+            newest = block;
+        }
+
+        for (bd_size_t i = 0; i < _pages; i++) {
+            uint32_t lblock;
+            if (!slot_word_pair(&_page[(WL_SLOT_PAGES + i) * _slot_size], &lblock)
+                    || lblock >= _lblocks) {
+                continue;
+            }
+
+            // the most recent copy wins, later pages of a block are newer
+            uint16_t old = _map[lblock];
+            if (old != WL_NONE) {
+                bd_size_t old_block = old / _pages;
+                if (old_block != block && _seq[old_block] > seq) {
+                    continue;
+                }
+                _valid[old_block]--;
+            }
+
+            _map[lblock] = block * _pages + i;
+            _valid[block]++;
+        }
+    }
+
+    // blocks that lost their erase count are assumed to be the most erased
+    for (bd_size_t block = 0; block < _blocks; block++) {
+        if (_erase_count[block] == 0) {
+            _erase_count[block] = max_count;
+        }
+    }
+
+    return resume(newest);
+}
+
+int WearLevelingBlockDevice::resume(bd_size_t block)
+{
+    // Writes go on in the newest block, so an interrupted move does not
+    // leave it taken with its free pages unused
+    _active = block;
+    _next_page = _pages;
+    if (block == WL_NO_BLOCK) {
+        return 0;
+    }
+
+    int err = _bd->read(_page, slot_addr(block, 0), _block_size);
+    if (err) {
+        return err;
+    }
+
+    // after the last page described, even partly
+    while (_next_page > 0 && is_erased(&_page[(WL_SLOT_PAGES + _next_page - 1) * _slot_size],
+            _slot_size)) {
+        _next_page--;
+    }
+
+    // a page programmed before a power loss kept it from being described
+    // is skipped, as is any page that does not read as erased
+    while (_bd->is_erase_required() && _next_page < _pages) {
+        err = _bd->read(_page, page_addr(block * _pages + _next_page), _block_size);
+        if (err) {
+            return err;
+        }
+        if (is_erased(_page, _block_size)) {
+            break;
+        }
+        _next_page++;
+    }
+
+    return 0;
+}
+
+int WearLevelingBlockDevice::erase_block(bd_size_t block)
+{
+    int err = 0;
+    if (_bd->is_erase_required()) {
+        err = _bd->erase((bd_addr_t)block * _erase_size, _erase_size);
+    } else {
+        // the metadata page is all that needs to read as erased
+        memset(_slot, _erased, _slot_size);
+        for (bd_size_t off = 0; off < _block_size && !err; off += _slot_size) {
+            err = _bd->program(_slot, slot_addr(block, 0) + off, _slot_size);
+        }
+    }
+    if (err) {
+        return err;
+    }
+
+    _erase_count[block]++;
+    _valid[block] = 0;
+    _state[block] = WL_DIRTY;
+    memset(_slot, _erased, _slot_size);
+    uint32_t words[3] = {WL_MAGIC, _erase_count[block], ~_erase_count[block]};
+    memcpy(_slot, words, sizeof(words));
+    err = _bd->program(_slot, slot_addr(block, WL_SLOT_HEADER), _slot_size);
+    if (err) {
+        return err;
+    }
+
+    _state[block] = WL_ERASED;
+    return 0;
+}
+
+bd_size_t WearLevelingBlockDevice::free_count() const
+{
+    bd_size_t count = 0;
+    for (bd_size_t block = 0; block < _blocks; block++) {
+        if (_state[block] != WL_USED) {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+bd_size_t WearLevelingBlockDevice::least_valid() const
+{
+    bd_size_t best = WL_NO_BLOCK;
+    for (bd_size_t block = 0; block < _blocks; block++) {
+        if (_state[block] != WL_USED || block == _active) {
+            continue;
+        }
+        if (best == WL_NO_BLOCK || _valid[block] < _valid[best]
+                || (_valid[block] == _valid[best] && _erase_count[block] < _erase_count[best])) {
+            best = block;
+        }
+    }
+
+    return best;
+}
+
+bd_size_t WearLevelingBlockDevice::least_erased() const
+{
+    bd_size_t best = WL_NO_BLOCK;
+    for (bd_size_t block = 0; block < _blocks; block++) {
+        if (_state[block] != WL_USED || block == _active) {
+            continue;
+        }
+        if (best == WL_NO_BLOCK || _erase_count[block] < _erase_count[best]) {
+            best = block;
+        }
+    }
+
+    return best;
+}
+
+uint32_t WearLevelingBlockDevice::most_erased() const
+{
+    uint32_t max = 0;
+    for (bd_size_t block = 0; block < _blocks; block++) {
+        if (_erase_count[block] > max) {
+            max = _erase_count[block];
+        }
+    }
+
+    return max;
+}
+
+int WearLevelingBlockDevice::open_block()
+{
+    // the free block erased the fewest times, preferring erased ones
+    bd_size_t best = WL_NO_BLOCK;
+    for (bd_size_t block = 0; block < _blocks; block++) {
+        if (_state[block] == WL_USED) {
+            continue;
+        }
+        if (best == WL_NO_BLOCK || _erase_count[block] < _erase_count[best]
+                || (_erase_count[block] == _erase_count[best]
+                    && _state[block] == WL_ERASED)) {
+            best = block;
+        }
+    }
+
+    if (best == WL_NO_BLOCK) {
+        return BD_ERROR_DEVICE_ERROR;
+    }
+
+    if (_state[best] == WL_DIRTY) {
+        int err = erase_block(best);
+        if (err) {
+            return err;
+        }
+    }
+
+    int err = program_slot(best, WL_SLOT_SEQ, _next_seq, ~_next_seq);
+    if (err) {
+        return err;
+    }
+
+    _seq[best] = _next_seq++;
+    _state[best] = WL_USED;
+    _valid[best] = 0;
+    _active = best;
+    _next_page = 0;
+    return 0;
+}
+
+void WearLevelingBlockDevice::drop(bd_size_t lblock)
+{
+    uint16_t page = _map[lblock];
+    if (page != WL_NONE) {
+        _valid[page / _pages]--;
+        _map[lblock] = WL_NONE;
+    }
+}
+
+int WearLevelingBlockDevice::move(bd_size_t block)
+{
+    // copy the pages in use, then the block can be erased
+    for (bd_size_t lblock = 0; lblock < _lblocks && _valid[block]; lblock++) {
+        uint16_t page = _map[lblock];
+        if (page == WL_NONE || page / _pages != block) {
+            continue;
+        }
+
+        int err = _bd->read(_page, page_addr(page), _block_size);
+        if (!err) {
+            err = append(lblock, _page);
+        }
+        if (err) {
+            return err;
+        }
+    }
+
+    return erase_block(block);
+}
+
+int WearLevelingBlockDevice::append(bd_size_t lblock, const uint8_t *data)
+{
+    bool leveled = false;
+    while (_active == WL_NO_BLOCK || _next_page == _pages) {
+        int err = open_block();
+        if (err) {
+            return err;
+        }
+
+        // The new block is empty, so the pages of any other fit in it and
+        // moving one frees a block. The reserved blocks make sure one has
+        // pages not in use, and one block is kept free besides the new
+        // one, so a power loss in the middle of moving a full block for
+        // leveling does not leave none free. A block moved for leveling
+        // may fill the new block, another is then opened.
+        bd_size_t cold = leveled ? WL_NO_BLOCK : least_erased();
+        leveled = true;
+        if (free_count() == 0) {
+            err = move(least_valid());
+        } else if (cold != WL_NO_BLOCK && most_erased() - _erase_count[cold] > _threshold) {
+            err = move(cold);
+        } else if (free_count() == 1) {
+            err = move(least_valid());
+        }
+        if (err) {
+            return err;
+        }
+    }
+
+    // the page is used up whatever happens
+    uint16_t page = _active * _pages + _next_page;
+    bd_size_t slot = WL_SLOT_PAGES + _next_page;
+    _next_page++;
+
+    // the data first, it is only found once described
+    int err = _bd->program(data, page_addr(page), _block_size);
+    if (!err) {
+        err = program_slot(_active, slot, lblock, ~(uint32_t)lblock);
+    }
+    if (err) {
+        return err;
+    }
+
+    drop(lblock);
+    _map[lblock] = page;
+    _valid[_active]++;
+    return 0;
+}
+
+int WearLevelingBlockDevice::read(void *b, bd_addr_t addr, bd_size_t size)
+{
+    MBED_ASSERT(_map != NULL);
+    MBED_ASSERT(is_valid_read(addr, size));
+    uint8_t *buffer = static_cast<uint8_t*>(b);
+
+    while (size > 0) {
+        uint16_t page = _map[addr / _block_size];
+        if (page == WL_NONE) {
+            memset(buffer, 0xff, _block_size);
+        } else {
+            int err = _bd->read(buffer, page_addr(page), _block_size);
+            if (err) {
+                return err;
+            }
+        }
+
+        buffer += _block_size;
+        addr += _block_size;
+        size -= _block_size;
+    }
+
+    return 0;
+}
+
+int WearLevelingBlockDevice::program(const void *b, bd_addr_t addr, bd_size_t size)
+{
+    MBED_ASSERT(_map != NULL);
+    MBED_ASSERT(is_valid_program(addr, size));
+    const uint8_t *buffer = static_cast<const uint8_t*>(b);
+
+    while (size > 0) {
+        int err = append(addr / _block_size, buffer);
+        if (err) {
+            return err;
+        }
+
+        buffer += _block_size;
+        addr += _block_size;
+        size -= _block_size;
+    }
+
+    return 0;
+}
+
+int WearLevelingBlockDevice::erase(bd_addr_t addr, bd_size_t size)
+{
+    return trim(addr, size);
+}
+
+int WearLevelingBlockDevice::trim(bd_addr_t addr, bd_size_t size)
+{
+    MBED_ASSERT(_map != NULL);
+    MBED_ASSERT(is_valid_erase(addr, size));
+
+    for (bd_size_t lblock = addr / _block_size; size > 0; lblock++, size -= _block_size) {
+        drop(lblock);
+    }
+
+    return 0;
+}
+
+int WearLevelingBlockDevice::collect()
+{
+    MBED_ASSERT(_map != NULL);
+
+    for (bd_size_t block = 0; block < _blocks; block++) {
+        if (_state[block] == WL_DIRTY) {
+            int err = erase_block(block);
+            if (err) {
+                return err;
+            }
+        }
+    }
+
+    // Moving a block takes a free one at most, two make sure the last
+    // is left for append
+    if (free_count() >= 2) {
+        bd_size_t cold = least_erased();
+        if (cold != WL_NO_BLOCK && most_erased() - _erase_count[cold] > _threshold) {
+            int err = move(cold);
+            if (err) {
+                return err;
+            }
+        }
+    }
+
+    for (bd_size_t i = 0; i < _blocks && free_count() >= 2 && free_count() < _reserved; i++) {
+        bd_size_t block = least_valid();
+        if (block == WL_NO_BLOCK || _valid[block] == _pages) {
+            break;
+        }
+
+        int err = move(block);
+        if (err) {
+            return err;
+        }
+    }
+
+    return 0;
+}
+
+void WearLevelingBlockDevice::get_erase_counts(uint32_t *min, uint32_t *max) const
+{
+    MBED_ASSERT(_map != NULL);
+    *min = _erase_count[0];
+    *max = _erase_count[0];
+    for (bd_size_t block = 1; block < _blocks; block++) {
+        if (_erase_count[block] < *min) {
+            *min = _erase_count[block];
+        }
+        if (_erase_count[block] > *max) {
+            *max = _erase_count[block];
+        }
+    }
+}
+
+bd_size_t WearLevelingBlockDevice::get_read_size() const
+{
+    return _block_size;
+}
+
+bd_size_t WearLevelingBlockDevice::get_program_size() const
+{
+    return _block_size;
+}
+
+bd_size_t WearLevelingBlockDevice::get_erase_size() const
+{
+    return _block_size;
+}
+
+bool WearLevelingBlockDevice::is_erase_required() const
+{
+    return false;
+}
+
+bd_size_t WearLevelingBlockDevice::size() const
+{
+    MBED_ASSERT(_map != NULL);
+    return _lblocks * _block_size;
+}
@@ -0,0 +1,264 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef MBED_WEAR_LEVELING_BLOCK_DEVICE_H
+#define MBED_WEAR_LEVELING_BLOCK_DEVICE_H
+
+#include "BlockDevice.h"
+#include "mbed.h"
+
+#ifndef MBED_CONF_FILESYSTEM_WEAR_LEVELING_RESERVED_BLOCKS
+#define MBED_CONF_FILESYSTEM_WEAR_LEVELING_RESERVED_BLOCKS 4
+#endif
+
+#ifndef MBED_CONF_FILESYSTEM_WEAR_LEVELING_THRESHOLD
+#define MBED_CONF_FILESYSTEM_WEAR_LEVELING_THRESHOLD 64
+#endif
+
+
+/** Block device for spreading the erases of a flash block device
+ *
+ *  Logical blocks are written to the next free page of the underlying
+ *  block device rather than in place, so repeated writes to the same
+ *  blocks, such as FAT tables, go round all the erase blocks.
+ *
+ *  Each erase block of the underlying block device is divided in pages of
+ *  the logical block size. The first page holds the erase count of the
+ *  block, its sequence number and the logical block of each other page,
+ *  each programmed once, after the data it describes. At init, the map
+ *  of logical blocks is rebuilt from them, the most recent copy of a block
+ *  winning, so a write interrupted by a power loss leaves the previous
+ *  data of the block.
+ *
+ *  Free erase blocks are taken by least erase count. When the last one is
+ *  taken, the erase block with the fewest pages in use is collected: its
+ *  pages are copied and it is erased. Erase blocks holding data that does
+ *  not change are moved once their erase count is threshold below the
+ *  most erased block. collect does this work ahead of the writes, from a
+ *  low priority thread for instance.
+ *
+ *  The map takes 2 bytes of RAM per page and 11 bytes per erase block.
+ *  Trims and erases are not recorded on the block device, the data of
+ *  trimmed blocks can come back after init.
+ *
+ *  @code
+ *  #include "mbed.h"
+ *  #include "SPIFBlockDevice.h"
+ *  #include "WearLevelingBlockDevice.h"
+ *  #include "FATFileSystem.h"
+ *
+ *  // 512 byte blocks on a NOR flash with 4 KB erase blocks
+ *  SPIFBlockDevice spif(PTE2, PTE4, PTE1, PTE5);
+ *  WearLevelingBlockDevice wl(&spif, 512);
+ *
+ *  FATFileSystem fs("fs", &wl);
+ *  @endcode
+ */
+class WearLevelingBlockDevice : public BlockDevice
+{
+public:
+    /** Lifetime of the wear leveling block device
+     *
+     *  @param bd           Block device to back the WearLevelingBlockDevice,
+     *                      its erase size must be a multiple of block_size of
+     *                      at least twice it
+     *  @param block_size   Size of the logical blocks in bytes. The first
+     *                      page of each erase block holds 2 metadata entries
+     *                      plus 1 per other page, each 16 bytes rounded up to
+     *                      the program size of bd, so larger program sizes
+     *                      need larger blocks. init fails with
+     *                      BD_ERROR_PARAMETER if they do not fit
+     *  @param reserved     Number of erase blocks kept out of the logical
+     *                      size for collection, at least 3. More of them
+     *                      means fewer pages copied per collection
+     *  @param threshold    Difference of erase counts from which erase
+     *                      blocks holding data that does not change are moved
+     */
+    WearLevelingBlockDevice(BlockDevice *bd, bd_size_t block_size = 512,
+            bd_size_t reserved = MBED_CONF_FILESYSTEM_WEAR_LEVELING_RESERVED_BLOCKS,
+            uint32_t threshold = MBED_CONF_FILESYSTEM_WEAR_LEVELING_THRESHOLD);
+
+    /** Lifetime of a block device
+     */
+    virtual ~WearLevelingBlockDevice();
+
+    /** Initialize a block device
+     *
+     *  Reads the metadata of every erase block to rebuild the map, and
+     *  finishes a collection interrupted by a power loss.
+     *
+     *  @return         0 on success or a negative error code on failure
+     */
+    virtual int init();
+
+    /** Deinitialize a block device
+     *
+     *  @return         0 on success or a negative error code on failure
+     */
+    virtual int deinit();
+
+    /** Ensure data on storage is in sync with the driver
+     *
+     *  @return         0 on success or a negative error code on failure
+     */
+    virtual int sync();
+
+    /** Read blocks from a block device
+     *
+     *  Blocks never programmed read as 0xff.
+     *
+     *  @param buffer   Buffer to read blocks into
+     *  @param addr     Address of block to begin reading from
+     *  @param size     Size to read in bytes, must be a multiple of read block size
+     *  @return         0 on success, negative error code on failure
+     */
+    virtual int read(void *buffer, bd_addr_t addr, bd_size_t size);
+
+    /** Program blocks to a block device
+     *
+     *  The blocks need not be erased first
+     *
+     *  @param buffer   Buffer of data to write to blocks
+     *  @param addr     Address of block to begin writing to
+     *  @param size     Size to write in bytes, must be a multiple of program block size
+     *  @return         0 on success, negative error code on failure
+     */
+    virtual int program(const void *buffer, bd_addr_t addr, bd_size_t size);
+
+    /** Erase blocks on a block device
+     *
+     *  The blocks are dropped from the map, as by trim
+     *
+     *  @param addr     Address of block to begin erasing
+     *  @param size     Size to erase in bytes, must be a multiple of erase block size
+     *  @return         0 on success, negative error code on failure
+     */
+    virtual int erase(bd_addr_t addr, bd_size_t size);
+
+    /** Mark blocks as no longer in use
+     *
+     *  The pages of the blocks are collected without being copied.
+     *
+     *  @param addr     Address of block to mark as unused
+     *  @param size     Size to mark as unused in bytes, must be a multiple of erase block size
+     *  @return         0 on success, negative error code on failure
+     */
+    virtual int trim(bd_addr_t addr, bd_size_t size);
+
+    /** Get the size of a readable block
+     *
+     *  @return         Size of a readable block in bytes
+     */
+    virtual bd_size_t get_read_size() const;
+
+    /** Get the size of a programable block
+     *
+     *  @return         Size of a programable block in bytes
+     *  @note Must be a multiple of the read size
+     */
+    virtual bd_size_t get_program_size() const;
+
+    /** Get the size of a eraseable block
+     *
+     *  @return         Size of a eraseable block in bytes
+     *  @note Must be a multiple of the program size
+     */
+    virtual bd_size_t get_erase_size() const;
+
+    /** Check if blocks must be erased before they are programmed
+     *
+     *  @return         False, blocks are written to erased pages
+     */
+    virtual bool is_erase_required() const;
+
+    /** Get the total size of the logical blocks
+     *
+     *  @return         Size of the logical blocks in bytes
+     */
+    virtual bd_size_t size() const;
+
+    /** Collect and erase blocks ahead of the writes
+     *
+     *  Erases the free erase blocks that need it, moves data that does not
+     *  change out of the least erased block if due, and collects erase
+     *  blocks until the reserved number of them are free.
+     *
+     *  @return         0 on success or a negative error code on failure
+     */
+    int collect();
+
+    /** Get the least and most erase counts of the erase blocks
+     *
+     *  @param min      Destination for the least erase count
+     *  @param max      Destination for the most erase count
+     */
+    void get_erase_counts(uint32_t *min, uint32_t *max) const;
+
+private:
+    enum block_state {
+        WL_DIRTY,           // free, but must be erased before use
+        WL_ERASED,          // free and erased
+        WL_USED             // taken, with a sequence number
+    };
+
+    bd_addr_t page_addr(uint16_t page) const;
+    bd_addr_t slot_addr(bd_size_t block, bd_size_t slot) const;
+    int program_slot(bd_size_t block, bd_size_t slot, uint32_t a, uint32_t b);
+    bool is_erased(const uint8_t *data, bd_size_t size) const;
+    int scan();
+    int resume(bd_size_t block);
+    int erase_block(bd_size_t block);
+    int open_block();
+    int append(bd_size_t lblock, const uint8_t *data);
+    int move(bd_size_t block);
+    bd_size_t free_count() const;
+    bd_size_t least_valid() const;
+    bd_size_t least_erased() const;
+    uint32_t most_erased() const;
+    void drop(bd_size_t lblock);
+
+    BlockDevice *_bd;
+    bd_size_t _block_size;
+    bd_size_t _reserved;
+    uint32_t _threshold;
+
+    bd_size_t _erase_size;          // of the underlying block device
+    bd_size_t _slot_size;           // of the metadata entries
+    bd_size_t _pages;               // data pages per erase block
+    bd_size_t _blocks;              // erase blocks
+    bd_size_t _lblocks;             // logical blocks
+    uint8_t _erased;                // value of erased bytes
+
+    uint16_t *_map;                 // page of each logical block
+    uint32_t *_erase_count;
+    uint32_t *_seq;
+    uint16_t *_valid;               // pages in use of each erase block
+    uint8_t *_state;
+    uint8_t *_page;                 // for the metadata and copies
+    uint8_t *_slot;
+
+    bd_size_t _active;              // erase block being written
+    bd_size_t _next_page;           // next free page in _active
+    uint32_t _next_seq;
+};
+
+
+#endif
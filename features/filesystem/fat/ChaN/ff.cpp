@@ -475,7 +475,7 @@ static WCHAR LfnBuf[_MAX_LFN + 1];
 #define	FREE_BUF()
 #elif _USE_LFN == 3 		/* LFN feature with dynamic working buffer on the heap */
 #define	DEFINE_NAMEBUF		BYTE sfn[12]; WCHAR *lfn
-#define INIT_BUF(dobj)		{ lfn = ff_memalloc((_MAX_LFN + 1) * 2); if (!lfn) LEAVE_FF((dobj).fs, FR_NOT_ENOUGH_CORE); (dobj).lfn = lfn; (dobj).fn = sfn; }
+#define INIT_BUF(dobj)		{ lfn = (WCHAR*)ff_memalloc((_MAX_LFN + 1) * 2); if (!lfn) LEAVE_FF((dobj).fs, FR_NOT_ENOUGH_CORE); (dobj).lfn = lfn; (dobj).fn = sfn; }
 #define	FREE_BUF()			ff_memfree(lfn)
 #else
 #error Wrong _USE_LFN setting
@@ -2649,8 +2649,21 @@ FRESULT f_read (
 			sect += csect;
 			cc = btr / SS(fp->fs);				/* When remaining bytes >= sector size, */
 			if (cc) {							/* Read maximum contiguous sectors directly */
-				if (csect + cc > fp->fs->csize)	/* Clip at cluster boundary */
+				if (csect + cc > fp->fs->csize) {	/* Clip at cluster boundary */
+					UINT rc = cc - (fp->fs->csize - csect);
 					cc = fp->fs->csize - csect;
+					while (rc >= fp->fs->csize) {	/* Extend over the following clusters while they are contiguous */
+#if _USE_FASTSEEK
+						if (fp->cltbl)
+							clst = clmt_clust(fp, fp->fptr + (DWORD)cc * SS(fp->fs));
+						else
+#endif
+							clst = get_fat(fp->fs, fp->clust);
+						if (clst != fp->clust + 1) break;
+						fp->clust = clst;
+						cc += fp->fs->csize; rc -= fp->fs->csize;
+					}
+				}
 				if (disk_read(fp->fs->drv, rbuff, sect, cc) != RES_OK)
 					ABORT(fp->fs, FR_DISK_ERR);
 #if !_FS_READONLY && _FS_MINIMIZE <= 2			/* Replace one of the read sectors with cached data if it contains a dirty sector */
@@ -25,6 +25,7 @@
 #include "ffconf.h"
 #include "mbed_debug.h"
 #include "mbed_critical.h"
+#include "mbed_mktime.h"
 #include <errno.h>
 
 #include "FATFileSystem.h"
@@ -132,21 +133,55 @@ static Deferred<const char*> fat_path_prefix(int id, const char *path)
 
 // Global access to block device from FAT driver
 static BlockDevice *_ffs[_VOLUMES] = {0};
+
+// Guards the volume table, f_mount and f_mkfs, taken after the lock of a
+// volume. FatFs is otherwise reentrant for different volumes.
 static SingletonPtr<PlatformMutex> _ffs_mutex;
 
 
+#if MBED_CONF_FILESYSTEM_FAT_FAST_SEEK
+// Create the cluster link map table of a file, which is sized to its
+// fragments: two entries for each, one for the size and one for the end
+static FRESULT fat_map_clusters(FIL *fh)
+{
+    DWORD size = 1 + 2*4 + 1;
+    while (true) {
+        fh->cltbl = new DWORD[size];
+        fh->cltbl[0] = size;
+        FRESULT res = f_lseek(fh, CREATE_LINKMAP);
+        if (res != FR_NOT_ENOUGH_CORE) {
+            if (res != FR_OK) {
+                delete[] fh->cltbl;
+                fh->cltbl = NULL;
+            }
+            return res;
+        }
+
+        // the table holds the size needed
+        size = fh->cltbl[0];
+        delete[] fh->cltbl;
+    }
+}
+#endif
+
+
 // FAT driver functions
 DWORD get_fattime(void)
 {
     time_t rawtime;
     time(&rawtime);
-    struct tm *ptm = localtime(&rawtime);
-    return (DWORD)(ptm->tm_year - 80) << 25
-           | (DWORD)(ptm->tm_mon + 1  ) << 21
-           | (DWORD)(ptm->tm_mday     ) << 16
-           | (DWORD)(ptm->tm_hour     ) << 11
-           | (DWORD)(ptm->tm_min      ) << 5
-           | (DWORD)(ptm->tm_sec/2    );
+    // localtime shares its result between volumes locked independently
+    struct tm tm;
+    if (!_rtc_localtime(rawtime, &tm)) {
+        // 1980-01-01, the start of FAT time
+        return (DWORD)1 << 21 | (DWORD)1 << 16;
+    }
+    return (DWORD)(tm.tm_year - 80) << 25
+           | (DWORD)(tm.tm_mon + 1  ) << 21
+           | (DWORD)(tm.tm_mday     ) << 16
+           | (DWORD)(tm.tm_hour     ) << 11
+           | (DWORD)(tm.tm_min      ) << 5
+           | (DWORD)(tm.tm_sec/2    );
 }
 
 void *ff_memalloc(UINT size)
@@ -196,20 +231,74 @@ DRESULT disk_read(BYTE pdrv, BYTE *buff, DWORD sector, UINT count)
 {
     debug_if(FFS_DBG, "disk_read(sector %d, count %d) on pdrv [%d]\n", sector, count, pdrv);
     DWORD ssize = disk_get_sector_size(pdrv);
-    int err = _ffs[pdrv]->read(buff, sector*ssize, count*ssize);
+    int err = _ffs[pdrv]->read(buff, (bd_addr_t)sector*ssize, (bd_size_t)count*ssize);
     return err ? RES_PARERR : RES_OK;
 }
 
+// Size of the reads a sector is checked for its erase value in
+#define DISK_ERASED_CHUNK 64
+
+static bool disk_is_erased(BlockDevice *bd, bd_addr_t addr, bd_size_t size)
+{
+    int value = bd->get_erase_value();
+    bd_size_t read_size = bd->get_read_size();
+    if (value < 0 || read_size > DISK_ERASED_CHUNK) {
+        return false;
+    }
+
+    uint8_t buffer[DISK_ERASED_CHUNK];
+    bd_size_t chunk = DISK_ERASED_CHUNK - DISK_ERASED_CHUNK % read_size;
+    for (bd_size_t off = 0; off < size; off += chunk) {
+        bd_size_t len = size - off < chunk ? size - off : chunk;
+        if (bd->read(buffer, addr + off, len)) {
+            return false;
+        }
+
+        for (bd_size_t i = 0; i < len; i++) {
+            if (buffer[i] != value) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+static int disk_erase(BlockDevice *bd, bd_addr_t addr, bd_size_t size, bd_size_t ssize)
+{
+    // Sectors that read as erased are programmed as they are, and each run
+    // of the others is erased in one go
+    bd_size_t run = 0;
+    for (bd_size_t off = 0; off < size; off += ssize) {
+        if (!disk_is_erased(bd, addr + off, ssize)) {
+            run += ssize;
+        } else if (run) {
+            int err = bd->erase(addr + off - run, run);
+            if (err) {
+                return err;
+            }
+            run = 0;
+        }
+    }
+
+    return run ? bd->erase(addr + size - run, run) : 0;
+}
+
 DRESULT disk_write(BYTE pdrv, const BYTE *buff, DWORD sector, UINT count)
 {
     debug_if(FFS_DBG, "disk_write(sector %d, count %d) on pdrv [%d]\n", sector, count, pdrv);
     DWORD ssize = disk_get_sector_size(pdrv);
-    int err = _ffs[pdrv]->erase(sector*ssize, count*ssize);
-    if (err) {
-        return RES_PARERR;
+    bd_addr_t addr = (bd_addr_t)sector*ssize;
+    bd_size_t size = (bd_size_t)count*ssize;
+
+    if (_ffs[pdrv]->is_erase_required()) {
+        int err = disk_erase(_ffs[pdrv], addr, size, ssize);
+        if (err) {
+            return RES_PARERR;
+        }
     }
 
-    err = _ffs[pdrv]->program(buff, sector*ssize, count*ssize);
+    int err = _ffs[pdrv]->program(buff, addr, size);
     if (err) {
         return RES_PARERR;
     }
@@ -224,6 +313,8 @@ DRESULT disk_ioctl(BYTE pdrv, BYTE cmd, void *buff)
         case CTRL_SYNC:
             if (_ffs[pdrv] == NULL) {
                 return RES_NOTRDY;
+            } else if (_ffs[pdrv]->sync()) {
+                return RES_ERROR;
             } else {
                 return RES_OK;
             }
@@ -241,6 +332,18 @@ DRESULT disk_ioctl(BYTE pdrv, BYTE cmd, void *buff)
                 *((WORD*)buff) = disk_get_sector_size(pdrv);
                 return RES_OK;
             }
+        case CTRL_TRIM:
+            if (_ffs[pdrv] == NULL) {
+                return RES_NOTRDY;
+            } else {
+                // first and last sector of the range
+                DWORD *sectors = (DWORD*)buff;
+                DWORD ssize = disk_get_sector_size(pdrv);
+                bd_addr_t addr = (bd_addr_t)sectors[0]*ssize;
+                bd_size_t size = (bd_size_t)(sectors[1] - sectors[0] + 1)*ssize;
+                int err = _ffs[pdrv]->trim(addr, size);
+                return err ? RES_PARERR : RES_OK;
+            }
         case GET_BLOCK_SIZE:
             *((DWORD*)buff) = 1; // default when not known
             return RES_OK;
@@ -278,6 +381,7 @@ int FATFileSystem::mount(BlockDevice *bd, bool mount) {
         return -EINVAL;
     }
 
+    _ffs_mutex->lock();
     for (int i = 0; i < _VOLUMES; i++) {
         if (!_ffs[i]) {
             _id = i;
@@ -287,11 +391,13 @@ int FATFileSystem::mount(BlockDevice *bd, bool mount) {
             _fsid[2] = '\0';
             debug_if(FFS_DBG, "Mounting [%s] on ffs drive [%s]\n", getName(), _fsid);
             FRESULT res = f_mount(&_fs, _fsid, mount);
+            _ffs_mutex->unlock();
             unlock();
             return fat_error_remap(res);
         }
     }
 
+    _ffs_mutex->unlock();
     unlock();
     return -ENOMEM;
 }
@@ -304,8 +410,16 @@ int FATFileSystem::unmount()
         return -EINVAL;
     }
 
+    // write back what a caching block device still holds
+    int err = _ffs[_id]->sync();
+
+    _ffs_mutex->lock();
     FRESULT res = f_mount(NULL, _fsid, 0);
     _ffs[_id] = NULL;
+    _ffs_mutex->unlock();
+    if (err && res == FR_OK) {
+        res = FR_DISK_ERR;
+    }
     _id = -1;
     unlock();
     return fat_error_remap(res);
@@ -322,7 +436,9 @@ int FATFileSystem::format(BlockDevice *bd, bd_size_t cluster_size) {
 
     // Logical drive number, Partitioning rule, Allocation unit size (bytes per cluster)
     fs.lock();
+    _ffs_mutex->lock();
     FRESULT res = f_mkfs(fs._fsid, 1, cluster_size);
+    _ffs_mutex->unlock();
     fs.unlock();
     if (res != FR_OK) {
         return fat_error_remap(res);
@@ -434,11 +550,11 @@ int FATFileSystem::stat(const char *path, struct stat *st) {
 }
 
 void FATFileSystem::lock() {
-    _ffs_mutex->lock();
+    _mutex.lock();
 }
 
 void FATFileSystem::unlock() {
-    _ffs_mutex->unlock();
+    _mutex.unlock();
 }
 
 
@@ -479,6 +595,20 @@ int FATFileSystem::file_open(fs_file_t *file, const char *path, int flags) {
     if (flags & O_APPEND) {
         f_lseek(fh, fh->fsize);
     }
+
+#if MBED_CONF_FILESYSTEM_FAT_FAST_SEEK
+    // files that are only read are mapped for seeking without the FAT, a
+    // mapped file can not grow
+    if (openmode == FA_READ) {
+        res = fat_map_clusters(fh);
+        if (res != FR_OK) {
+            f_close(fh);
+            unlock();
+            delete fh;
+            return fat_error_remap(res);
+        }
+    }
+#endif
     unlock();
 
     *file = fh;
@@ -492,6 +622,7 @@ int FATFileSystem::file_close(fs_file_t file) {
     FRESULT res = f_close(fh);
     unlock();
 
+    delete[] fh->cltbl;
     delete fh;
     return fat_error_remap(res);
 }
@@ -528,6 +659,21 @@ ssize_t FATFileSystem::file_write(fs_file_t file, const void *buffer, size_t len
     }
 }
 
+ssize_t FATFileSystem::file_readv(fs_file_t file, const struct iovec *iov, int iovcnt) {
+    // the lock is recursive, so file_read can take it again
+    lock();
+    ssize_t n = FileSystem::file_readv(file, iov, iovcnt);
+    unlock();
+    return n;
+}
+
+ssize_t FATFileSystem::file_writev(fs_file_t file, const struct iovec *iov, int iovcnt) {
+    lock();
+    ssize_t n = FileSystem::file_writev(file, iov, iovcnt);
+    unlock();
+    return n;
+}
+
 int FATFileSystem::file_sync(fs_file_t file) {
     FIL *fh = static_cast<FIL*>(file);
 
@@ -583,6 +729,43 @@ off_t FATFileSystem::file_size(fs_file_t file) {
     return res;
 }
 
+const void *FATFileSystem::file_get_mapped_address(fs_file_t file) {
+    FIL *fh = static_cast<FIL*>(file);
+
+    lock();
+    // written data may still be in the window of the filesystem
+    if ((fh->flag & FA_WRITE) || !fh->sclust) {
+        unlock();
+        return NULL;
+    }
+
+    // the clusters must be a single fragment, which the cluster link map
+    // table of a fast seek file already tells
+    DWORD tbl[4];
+    DWORD *cltbl = fh->cltbl;
+    if (!cltbl) {
+        tbl[0] = sizeof(tbl) / sizeof(tbl[0]);
+        fh->cltbl = tbl;
+        FRESULT res = f_lseek(fh, CREATE_LINKMAP);
+        fh->cltbl = NULL;
+        if (res != FR_OK) {
+            unlock();
+            return NULL;
+        }
+        cltbl = tbl;
+    } else if (cltbl[0] != sizeof(tbl) / sizeof(tbl[0])) {
+        unlock();
+        return NULL;
+    }
+
+    DWORD sect = fh->fs->database + (cltbl[2] - 2) * fh->fs->csize;
+    WORD ssize = disk_get_sector_size(fh->fs->drv);
+    const void *addr = _ffs[_id]->get_mapped_address((bd_addr_t)sect * ssize, fh->fsize);
+    unlock();
+
+    return addr;
+}
+
 
 ////// Dir operations //////
 int FATFileSystem::dir_open(fs_dir_t *dir, const char *path) {
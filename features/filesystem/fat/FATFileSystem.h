@@ -31,8 +31,19 @@
 
 using namespace mbed;
 
+#ifndef MBED_CONF_FILESYSTEM_FAT_FAST_SEEK
+#define MBED_CONF_FILESYSTEM_FAT_FAST_SEEK 0
+#endif
+
 /**
  * FATFileSystem based on ChaN's Fat Filesystem library v0.8
+ *
+ * Each FATFileSystem has its own lock, so operations on different volumes
+ * run concurrently.
+ *
+ * With filesystem.fat-fast-seek, a file opened for reading only gets a map
+ * of its clusters, of 8 bytes for each contiguous fragment, so seeking
+ * does not follow the FAT from the start of the file.
  */
 class FATFileSystem : public FileSystem {
 public:
@@ -175,6 +186,24 @@ protected:
      */
     virtual ssize_t file_write(fs_file_t file, const void *buffer, size_t len);
 
+    /** Read the contents of a file into several buffers, with the lock held
+     *
+     *  @param file     File handle
+     *  @param iov      The buffers to read in to
+     *  @param iovcnt   The number of buffers
+     *  @return         The number of bytes read, 0 at end of file, negative error on failure
+     */
+    virtual ssize_t file_readv(fs_file_t file, const struct iovec *iov, int iovcnt);
+
+    /** Write the contents of several buffers to a file, with the lock held
+     *
+     *  @param file     File handle
+     *  @param iov      The buffers to write from
+     *  @param iovcnt   The number of buffers
+     *  @return         The number of bytes written, negative error on failure
+     */
+    virtual ssize_t file_writev(fs_file_t file, const struct iovec *iov, int iovcnt);
+
     /** Flush any buffers associated with the file
      *
      *  @param file     File handle
@@ -208,6 +237,17 @@ protected:
      */
     virtual off_t file_size(fs_file_t file);
 
+    /** Get the address the contents of a file can be read at in place
+     *
+     *  Files opened for reading only whose clusters are contiguous are
+     *  mapped, if the block device is.
+     *
+     *  @param file     File handle
+     *  @return         Address of the first byte of the file, or NULL if
+     *                  the file can not be read in place
+     */
+    virtual const void *file_get_mapped_address(fs_file_t file);
+
     /** Open a directory on the filesystem
      *
      *  @param dir      Destination for the handle to the directory
@@ -256,6 +296,7 @@ private:
     FATFS _fs; // Work area (file system object) for logical drive
     char _fsid[sizeof("0:")];
     int _id;
+    PlatformMutex _mutex;
 
 protected:
     virtual void lock();
@@ -0,0 +1,836 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "KVStore.h"
+#include "mbed.h"
+#include <errno.h>
+#include <stddef.h>
+
+
+// Header of an area, at its start
+#define KV_AREA_MAGIC       0x5453564b  // "KVST"
+#define KV_AREA_VERSION     1
+
+// Flags of a record
+#define KV_DELETED          0x0001
+
+#define KV_RECORD_MAGIC     0x4345524b  // "KREC"
+#define KV_NONE             0xffffffff  // free slot of the index
+
+struct kv_area {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t seq;                   // the area with the latest one is active
+    uint32_t crc;
+};
+
+// Header of a record, followed by the key and the value, padded to the
+// program size. seq is that of the area, so stale records left in an area
+// that was not erased do not pass for records of the area in use; crc
+// covers the sizes, flags, key and value
+struct kv_record {
+    uint32_t magic;
+    uint32_t seq;
+    uint32_t value_size;
+    uint16_t key_size;
+    uint16_t flags;
+    uint32_t crc;
+};
+
+#define KV_RECORD_CRC_START offsetof(struct kv_record, value_size)
+#define KV_RECORD_CRC_SIZE  (offsetof(struct kv_record, crc) - KV_RECORD_CRC_START)
+
+
+static uint32_t kv_crc(uint32_t crc, const void *buffer, size_t size)
+{
+    static const uint32_t rtable[16] = {
+        0x00000000, 0x1db71064, 0x3b6e20c8, 0x26d930ac,
+        0x76dc4190, 0x6b6b51f4, 0x4db26158, 0x5005713c,
+        0xedb88320, 0xf00f9344, 0xd6d6a3e8, 0xcb61b38c,
+        0x9b64c2b0, 0x86d3d2d4, 0xa00ae278, 0xbdbdf21c,
+    };
+
+    const uint8_t *data = (const uint8_t *)buffer;
+    for (size_t i = 0; i < size; i++) {
+        crc = (crc >> 4) ^ rtable[(crc ^ (data[i] >> 0)) & 0xf];
+        crc = (crc >> 4) ^ rtable[(crc ^ (data[i] >> 4)) & 0xf];
+    }
+
+    return crc;
+}
+
+// FNV-1a
+static uint32_t kv_hash(const char *key, size_t size)
+{
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ (uint8_t)key[i]) * 16777619u;
+    }
+
+    return hash;
+}
+
+static bd_size_t kv_align(bd_size_t size, bd_size_t unit)
+{
+    return ((size + unit - 1) / unit) * unit;
+}
+
+
+KVStore::KVStore(BlockDevice *bd, size_t max_keys)
+    : _bd(bd)
+    , _max_keys(max_keys)
+    , _area_size(0), _program_size(0), _header_size(0), _erased(0xff)
+    , _index(0), _index_mask(0), _count(0)
+    , _buffer(0), _buffer_size(0), _read_buffer(0), _key(0)
+    , _active(0), _seq(0), _free(0)
+    , _program_addr(0), _program_fill(0)
+{
+    MBED_ASSERT(_max_keys > 0);
+}
+
+KVStore::~KVStore()
+{
+    deinit();
+}
+
+int KVStore::init()
+{
+    _mutex.lock();
+    if (_index) {
+        _mutex.unlock();
+        return 0;
+    }
+
+    int err = _bd->init();
+    if (err) {
+        _mutex.unlock();
+        return err;
+    }
+
+    configure();
+    size_t slots = 1;
+    while (slots < 2*_max_keys) {
+        slots *= 2;
+    }
+    _index_mask = slots - 1;
+    _index = new struct entry[slots];
+    _key = new char[KVSTORE_MAX_KEY_SIZE];
+
+    err = scan();
+    _mutex.unlock();
+    if (err) {
+        deinit();
+    }
+    return err;
+}
+
+int KVStore::deinit()
+{
+    _mutex.lock();
+    if (!_index) {
+        _mutex.unlock();
+        return 0;
+    }
+
+    delete[] _index;
+    _index = 0;
+    delete[] _buffer;
+    _buffer = 0;
+    delete[] _read_buffer;
+    _read_buffer = 0;
+    delete[] _key;
+    _count = 0;
+
+    int err = _bd->deinit();
+    _mutex.unlock();
+    return err;
+}
+
+int KVStore::format()
+{
+    _mutex.lock();
+    MBED_ASSERT(!_index);
+
+    int err = _bd->init();
+    if (err) {
+        _mutex.unlock();
+        return err;
+    }
+
+    configure();
+
+    // sequence numbers carry on from a previous store, so its records do
+    // not pass for records of the new one on block devices not cleared by
+    // erase
+    int area;
+    uint32_t seq;
+    err = latest_area(&area, &seq);
+    seq = err ? 1 : seq + 1;
+
+    err = _bd->erase(0, 2*_area_size);
+    if (!err && !_bd->is_erase_required()) {
+        // nothing cleared the header of the second area
+        memset(_buffer, 0, _buffer_size);
+        err = _bd->program(_buffer, area_addr(1), _header_size);
+    }
+    if (!err) {
+        err = write_area_header(0, seq);
+    }
+
+    delete[] _buffer;
+    _buffer = 0;
+    delete[] _read_buffer;
+    _read_buffer = 0;
+    int deinit_err = _bd->deinit();
+    _mutex.unlock();
+    return err ? err : deinit_err;
+}
+
+void KVStore::configure()
+{
+    bd_size_t erase_size = _bd->get_erase_size();
+    _area_size = (_bd->size() / erase_size / 2) * erase_size;
+    _program_size = _bd->get_program_size();
+    _header_size = kv_align(sizeof(struct kv_area), _program_size);
+    _buffer_size = kv_align(32, _program_size);
+    int value = _bd->get_erase_value();
+    _erased = value < 0 ? 0xff : value;
+    MBED_ASSERT(_area_size > 0 && _area_size < KV_NONE);
+
+    _buffer = new uint8_t[_buffer_size];
+    _read_buffer = new uint8_t[_bd->get_read_size()];
+}
+
+bd_addr_t KVStore::area_addr(int area) const
+{
+    return area * _area_size;
+}
+
+int KVStore::read(bd_addr_t addr, void *buffer, bd_size_t size)
+{
+    uint8_t *data = (uint8_t *)buffer;
+    bd_size_t read_size = _bd->get_read_size();
+
+    while (size > 0) {
+        bd_size_t off = addr % read_size;
+        bd_size_t diff;
+        int err;
+
+        if (off == 0 && size >= read_size) {
+            diff = size - size % read_size;
+            err = _bd->read(data, addr, diff);
+        } else {
+            diff = read_size - off < size ? read_size - off : size;
+            err = _bd->read(_read_buffer, addr - off, read_size);
+            memcpy(data, &_read_buffer[off], diff);
+        }
+        if (err) {
+            return err;
+        }
+
+        addr += diff;
+        data += diff;
+        size -= diff;
+    }
+
+    return 0;
+}
+
+int KVStore::program_begin(bd_addr_t addr)
+{
+    _program_addr = addr;
+    _program_fill = 0;
+    return 0;
+}
+
+int KVStore::program_data(const void *data, bd_size_t size)
+{
+    const uint8_t *bytes = (const uint8_t *)data;
+
+    while (size > 0) {
+        bd_size_t diff = _buffer_size - _program_fill < size ? _buffer_size - _program_fill : size;
+        memcpy(&_buffer[_program_fill], bytes, diff);
+        _program_fill += diff;
+        bytes += diff;
+        size -= diff;
+
+        if (_program_fill == _buffer_size) {
+            int err = _bd->program(_buffer, _program_addr, _buffer_size);
+            if (err) {
+                return err;
+            }
+
+            _program_addr += _buffer_size;
+            _program_fill = 0;
+        }
+    }
+
+    return 0;
+}
+
+int KVStore::program_end()
+{
+    if (_program_fill == 0) {
+        return 0;
+    }
+
+    bd_size_t size = kv_align(_program_fill, _program_size);
+    memset(&_buffer[_program_fill], _erased, size - _program_fill);
+    _program_fill = 0;
+    return _bd->program(_buffer, _program_addr, size);
+}
+
+int KVStore::read_header(bd_addr_t off, struct kv_record *record)
+{
+    int err = read(area_addr(_active) + off, record, sizeof(*record));
+    if (err) {
+        return err;
+    }
+
+    if (record->magic != KV_RECORD_MAGIC || record->seq != _seq ||
+            record->key_size == 0 || record->key_size > KVSTORE_MAX_KEY_SIZE ||
+            record->value_size > _area_size ||
+            off + sizeof(*record) + record->key_size + record->value_size > _area_size) {
+        return -EILSEQ;
+    }
+
+    return 0;
+}
+
+int KVStore::read_area_header(int area, uint32_t *seq)
+{
+    struct kv_area header;
+    int err = read(area_addr(area), &header, sizeof(header));
+    if (err) {
+        return err;
+    }
+
+    if (header.magic != KV_AREA_MAGIC || header.version != KV_AREA_VERSION ||
+            header.crc != kv_crc(0xffffffff, &header, offsetof(struct kv_area, crc))) {
+        return -EILSEQ;
+    }
+
+    *seq = header.seq;
+    return 0;
+}
+
+// Finds the area with the latest valid header
+int KVStore::latest_area(int *area, uint32_t *seq)
+{
+    uint32_t seqs[2];
+    int err[2];
+    err[0] = read_area_header(0, &seqs[0]);
+    err[1] = read_area_header(1, &seqs[1]);
+    if (err[0] && err[0] != -EILSEQ) {
+        return err[0];
+    } else if (err[1] && err[1] != -EILSEQ) {
+        return err[1];
+    } else if (err[0] && err[1]) {
+        return -EILSEQ;
+    }
+
+    *area = (err[1] || (!err[0] && (int32_t)(seqs[0] - seqs[1]) > 0)) ? 0 : 1;
+    *seq = seqs[*area];
+    return 0;
+}
+
+int KVStore::write_area_header(int area, uint32_t seq)
+{
+    struct kv_area header;
+    header.magic = KV_AREA_MAGIC;
+    header.version = KV_AREA_VERSION;
+    header.seq = seq;
+    header.crc = kv_crc(0xffffffff, &header, offsetof(struct kv_area, crc));
+
+    program_begin(area_addr(area));
+    int err = program_data(&header, sizeof(header));
+    if (err) {
+        return err;
+    }
+
+    err = program_end();
+    if (err) {
+        return err;
+    }
+
+    return _bd->sync();
+}
+
+int KVStore::record_crc(bd_addr_t off, const struct kv_record *record, uint32_t *crc)
+{
+    *crc = kv_crc(0xffffffff, (const uint8_t *)record + KV_RECORD_CRC_START, KV_RECORD_CRC_SIZE);
+
+    bd_addr_t addr = area_addr(_active) + off + sizeof(*record);
+    bd_size_t size = record->key_size + record->value_size;
+    while (size > 0) {
+        bd_size_t diff = _buffer_size < size ? _buffer_size : size;
+        int err = read(addr, _buffer, diff);
+        if (err) {
+            return err;
+        }
+
+        *crc = kv_crc(*crc, _buffer, diff);
+        addr += diff;
+        size -= diff;
+    }
+
+    return 0;
+}
+
+int KVStore::key_matches(uint32_t off, const char *key, size_t key_size, bool *match)
+{
+    struct kv_record record;
+    int err = read_header(off, &record);
+    if (err) {
+        return err;
+    }
+
+    *match = false;
+    if (record.key_size != key_size) {
+        return 0;
+    }
+
+    bd_addr_t addr = area_addr(_active) + off + sizeof(record);
+    while (key_size > 0) {
+        bd_size_t diff = _buffer_size < key_size ? _buffer_size : key_size;
+        err = read(addr, _buffer, diff);
+        if (err) {
+            return err;
+        }
+
+        if (memcmp(_buffer, key, diff) != 0) {
+            return 0;
+        }
+
+        addr += diff;
+        key += diff;
+        key_size -= diff;
+    }
+
+    *match = true;
+    return 0;
+}
+
+// Finds the slot of a key in the index, or the free slot it would take
+int KVStore::find(const char *key, size_t key_size, uint32_t hash, size_t *index)
+{
+    size_t i = hash & _index_mask;
+    while (_index[i].off != KV_NONE) {
+        if (_index[i].hash == hash) {
+            bool match;
+            int err = key_matches(_index[i].off, key, key_size, &match);
+            if (err) {
+                return err;
+            }
+
+            if (match) {
+                *index = i;
+                return 0;
+            }
+        }
+
+        i = (i + 1) & _index_mask;
+    }
+
+    *index = i;
+    return -ENOENT;
+}
+
+void KVStore::insert(size_t index, uint32_t hash, uint32_t off)
+{
+    if (_index[index].off == KV_NONE) {
+        _count += 1;
+    }
+
+    _index[index].hash = hash;
+    _index[index].off = off;
+}
+
+// Removes a slot, moving back the entries of the run after it so no
+// lookup stops short at the hole
+void KVStore::drop(size_t index)
+{
+    size_t hole = index;
+    size_t i = index;
+    while (true) {
+        i = (i + 1) & _index_mask;
+        if (_index[i].off == KV_NONE) {
+            break;
+        }
+
+        size_t home = _index[i].hash & _index_mask;
+        if (((i - home) & _index_mask) >= ((i - hole) & _index_mask)) {
+            _index[hole] = _index[i];
+            hole = i;
+        }
+    }
+
+    _index[hole].off = KV_NONE;
+    _count -= 1;
+}
+
+// Rebuilds the index from the active area. Records before the last one are
+// complete, a set only appends after a complete record; the last one is
+// checked against its CRC before it is taken
+int KVStore::scan()
+{
+    for (size_t i = 0; i <= _index_mask; i++) {
+        _index[i].off = KV_NONE;
+    }
+    _count = 0;
+
+    uint32_t seq;
+    int err = latest_area(&_active, &seq);
+    if (err) {
+        return err;
+    }
+    _seq = seq;
+
+    bd_size_t off = _header_size;
+    bool pending = false;
+    struct kv_record record;
+    bd_size_t record_off = 0;
+    uint32_t hash = 0;
+
+    while (true) {
+        struct kv_record next;
+        err = (off + sizeof(next) <= _area_size) ? read_header(off, &next) : -EILSEQ;
+        if (err && err != -EILSEQ) {
+            return err;
+        }
+
+        if (pending) {
+            if (err) {
+                // last record
+                uint32_t crc;
+                int crc_err = record_crc(record_off, &record, &crc);
+                if (crc_err) {
+                    return crc_err;
+                }
+
+                if (crc != record.crc) {
+                    // left by an interrupted set, nothing may be programmed
+                    // over it before the area is collected
+                    _free = _area_size;
+                    return 0;
+                }
+            }
+
+            size_t index;
+            int find_err = find(_key, record.key_size, hash, &index);
+            if (find_err && find_err != -ENOENT) {
+                return find_err;
+            }
+
+            if (record.flags & KV_DELETED) {
+                if (!find_err) {
+                    drop(index);
+                }
+            } else if (find_err && _count == _max_keys) {
+                return -ENOSPC;
+            } else {
+                insert(index, hash, record_off);
+            }
+            pending = false;
+        }
+
+        if (err) {
+            break;
+        }
+
+        record = next;
+        record_off = off;
+        err = read(area_addr(_active) + off + sizeof(record), _key, record.key_size);
+        if (err) {
+            return err;
+        }
+
+        hash = kv_hash(_key, record.key_size);
+        pending = true;
+        off += kv_align(sizeof(record) + record.key_size + record.value_size, _program_size);
+    }
+
+    _free = off;
+    return 0;
+}
+
+int KVStore::append(const char *key, const void *buffer, size_t size, uint16_t flags)
+{
+    size_t key_size = strlen(key);
+    bd_size_t record_size = kv_align(sizeof(struct kv_record) + key_size + size, _program_size);
+    if (_free + record_size > _area_size) {
+        int err = collect_locked();
+        if (err) {
+            return err;
+        }
+
+        if (_free + record_size > _area_size) {
+            return -ENOSPC;
+        }
+    }
+
+    struct kv_record record;
+    record.magic = KV_RECORD_MAGIC;
+    record.seq = _seq;
+    record.value_size = size;
+    record.key_size = key_size;
+    record.flags = flags;
+    record.crc = kv_crc(0xffffffff, (const uint8_t *)&record + KV_RECORD_CRC_START, KV_RECORD_CRC_SIZE);
+    record.crc = kv_crc(record.crc, key, key_size);
+    record.crc = kv_crc(record.crc, buffer, size);
+
+    bd_size_t off = _free;
+    _free += record_size; // taken even if programming fails part way
+
+    program_begin(area_addr(_active) + off);
+    int err = program_data(&record, sizeof(record));
+    if (!err) {
+        err = program_data(key, key_size);
+    }
+    if (!err) {
+        err = program_data(buffer, size);
+    }
+    if (!err) {
+        err = program_end();
+    }
+    if (!err) {
+        err = _bd->sync();
+    }
+    if (err) {
+        return err;
+    }
+
+    // the index is searched again, the collection may have moved the key
+    uint32_t hash = kv_hash(key, key_size);
+    size_t index;
+    err = find(key, key_size, hash, &index);
+    if (err && err != -ENOENT) {
+        return err;
+    }
+
+    if (flags & KV_DELETED) {
+        if (!err) {
+            drop(index);
+        }
+    } else {
+        insert(index, hash, off);
+    }
+    return 0;
+}
+
+int KVStore::set(const char *key, const void *buffer, size_t size)
+{
+    size_t key_size = strlen(key);
+    if (key_size == 0 || key_size > KVSTORE_MAX_KEY_SIZE) {
+        return -EINVAL;
+    }
+
+    _mutex.lock();
+    if (!_index) {
+        _mutex.unlock();
+        return -ENODEV;
+    }
+
+    size_t index;
+    int err = find(key, key_size, kv_hash(key, key_size), &index);
+    if (err == -ENOENT) {
+        err = (_count == _max_keys) ? -ENOSPC : 0;
+    }
+    if (!err) {
+        err = append(key, buffer, size, 0);
+    }
+
+    _mutex.unlock();
+    return err;
+}
+
+int KVStore::get(const char *key, void *buffer, size_t buffer_size, size_t *actual_size)
+{
+    size_t key_size = strlen(key);
+    if (key_size == 0 || key_size > KVSTORE_MAX_KEY_SIZE) {
+        return -EINVAL;
+    }
+
+    _mutex.lock();
+    if (!_index) {
+        _mutex.unlock();
+        return -ENODEV;
+    }
+
+    size_t index;
+    int err = find(key, key_size, kv_hash(key, key_size), &index);
+    if (err) {
+        _mutex.unlock();
+        return err;
+    }
+
+    struct kv_record record;
+    bd_size_t off = _index[index].off;
+    err = read_header(off, &record);
+    if (!err && actual_size) {
+        *actual_size = record.value_size;
+    }
+    if (!err && record.value_size > buffer_size) {
+        err = -ENOMEM;
+    }
+    if (!err) {
+        err = read(area_addr(_active) + off + sizeof(record) + record.key_size,
+                buffer, record.value_size);
+    }
+    if (!err) {
+        uint32_t crc = kv_crc(0xffffffff, (const uint8_t *)&record + KV_RECORD_CRC_START, KV_RECORD_CRC_SIZE);
+        crc = kv_crc(crc, key, key_size);
+        crc = kv_crc(crc, buffer, record.value_size);
+        if (crc != record.crc) {
+            err = -EILSEQ;
+        }
+    }
+
+    _mutex.unlock();
+    return err;
+}
+
+int KVStore::remove(const char *key)
+{
+    size_t key_size = strlen(key);
+    if (key_size == 0 || key_size > KVSTORE_MAX_KEY_SIZE) {
+        return -EINVAL;
+    }
+
+    _mutex.lock();
+    if (!_index) {
+        _mutex.unlock();
+        return -ENODEV;
+    }
+
+    size_t index;
+    int err = find(key, key_size, kv_hash(key, key_size), &index);
+    if (!err) {
+        err = append(key, NULL, 0, KV_DELETED);
+    }
+
+    _mutex.unlock();
+    return err;
+}
+
+int KVStore::collect()
+{
+    _mutex.lock();
+    if (!_index) {
+        _mutex.unlock();
+        return -ENODEV;
+    }
+
+    int err = collect_locked();
+    _mutex.unlock();
+    return err;
+}
+
+// Copies the records in the index to the other area, then writes its header
+// with the next sequence number to switch to it. On failure the index is
+// rebuilt from the area still active
+int KVStore::collect_locked()
+{
+    int area = 1 - _active;
+    uint32_t seq = _seq + 1;
+
+    int err = _bd->erase(area_addr(area), _area_size);
+    if (err) {
+        return err;
+    }
+
+    bd_size_t off = _header_size;
+    for (size_t i = 0; i <= _index_mask && !err; i++) {
+        if (_index[i].off == KV_NONE) {
+            continue;
+        }
+
+        struct kv_record record;
+        bd_addr_t from = area_addr(_active) + _index[i].off;
+        err = read_header(_index[i].off, &record);
+        if (err) {
+            break;
+        }
+
+        bd_size_t size = kv_align(sizeof(record) + record.key_size + record.value_size, _program_size);
+        record.seq = seq;
+
+        program_begin(area_addr(area) + off);
+        err = program_data(&record, sizeof(record));
+        bd_size_t copied = sizeof(record);
+        while (!err && copied < size) {
+            // the rest of the record, up to its padding, copied as it is
+            bd_size_t diff = _buffer_size - _program_fill;
+            if (diff > size - copied) {
+                diff = size - copied;
+            }
+
+            err = read(from + copied, &_buffer[_program_fill], diff);
+            if (!err) {
+                _program_fill += diff;
+                copied += diff;
+                if (_program_fill == _buffer_size) {
+                    err = _bd->program(_buffer, _program_addr, _buffer_size);
+                    _program_addr += _buffer_size;
+                    _program_fill = 0;
+                }
+            }
+        }
+        if (!err) {
+            err = program_end();
+        }
+
+        _index[i].off = off;
+        off += size;
+    }
+
+    if (!err) {
+        err = _bd->sync();
+    }
+    if (!err) {
+        err = write_area_header(area, seq);
+    }
+    if (err) {
+        int scan_err = scan();
+        return scan_err ? scan_err : err;
+    }
+
+    _active = area;
+    _seq = seq;
+    _free = off;
+    return 0;
+}
+
+size_t KVStore::count() const
+{
+    _mutex.lock();
+    size_t count = _count;
+    _mutex.unlock();
+    return count;
+}
+
+bd_size_t KVStore::free_space() const
+{
+    _mutex.lock();
+    bd_size_t space = _index ? _area_size - _free : 0;
+    _mutex.unlock();
+    return space;
+}
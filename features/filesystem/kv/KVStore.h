@@ -0,0 +1,215 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef MBED_KVSTORE_H
+#define MBED_KVSTORE_H
+
+#include "BlockDevice.h"
+#include "PlatformMutex.h"
+
+#ifndef MBED_CONF_FILESYSTEM_KV_MAX_KEYS
+#define MBED_CONF_FILESYSTEM_KV_MAX_KEYS 32
+#endif
+
+/** Largest key of a KVStore in bytes, not counting the terminating null */
+#define KVSTORE_MAX_KEY_SIZE 255
+
+
+/** Key-value store for configuration and credentials on a block device
+ *
+ *  The block device is split in two areas of whole erase blocks. Records,
+ *  each a key and its value with a CRC, are appended to the active area;
+ *  setting a key again appends a new record and removing it appends an
+ *  empty one. When the active area is full, the records still in use are
+ *  copied to the other area, which is switched to only once the copy is
+ *  complete, so losing power leaves each key with its previous or its new
+ *  value.
+ *
+ *  A RAM index holds the record of each key by hash, so get and set read
+ *  a single record. Mounting reads the header and key of each record of
+ *  the active area, not the values, and checks the CRC of the last record
+ *  only, the one an interrupted set can have left behind.
+ *
+ *  The index takes 8 bytes of RAM per key for 2 * max_keys keys rounded up
+ *  to a power of two, and a buffer of the program size of the block device,
+ *  at least 32 bytes, is used for programming.
+ *
+ *  @code
+ *  #include "mbed.h"
+ *  #include "FlashIAPBlockDevice.h"
+ *  #include "KVStore.h"
+ *
+ *  // Last 16 KB of the internal flash
+ *  FlashIAPBlockDevice bd(0x000FC000, 16*1024);
+ *  KVStore kv(&bd);
+ *
+ *  int main() {
+ *      if (kv.init()) {
+ *          kv.format();
+ *          kv.init();
+ *      }
+ *      kv.set("wifi/ssid", "mbed", 4);
+ *  }
+ *  @endcode
+ */
+class KVStore
+{
+public:
+    /** Lifetime of the KVStore
+     *
+     *  @param bd           Block device to store the keys on, at least two
+     *                      erase blocks
+     *  @param max_keys     Number of keys the store can hold
+     */
+    KVStore(BlockDevice *bd, size_t max_keys = MBED_CONF_FILESYSTEM_KV_MAX_KEYS);
+    ~KVStore();
+
+    /** Mount the store
+     *
+     *  Initializes the block device and rebuilds the index.
+     *
+     *  @return         0 on success, -EILSEQ if the block device holds no
+     *                  store, or another negative error code on failure
+     */
+    int init();
+
+    /** Unmount the store
+     *
+     *  Deinitializes the block device.
+     *
+     *  @return         0 on success, negative error code on failure
+     */
+    int deinit();
+
+    /** Create an empty store on the block device
+     *
+     *  Erases the block device. The store is left unmounted.
+     *
+     *  @return         0 on success, negative error code on failure
+     */
+    int format();
+
+    /** Set the value of a key
+     *
+     *  @param key      Null terminated key, at most KVSTORE_MAX_KEY_SIZE bytes
+     *  @param buffer   Value of the key
+     *  @param size     Size of the value in bytes
+     *  @return         0 on success, -ENOSPC if the store is full, or another
+     *                  negative error code on failure
+     */
+    int set(const char *key, const void *buffer, size_t size);
+
+    /** Get the value of a key
+     *
+     *  @param key          Null terminated key
+     *  @param buffer       Buffer to read the value into
+     *  @param buffer_size  Size of the buffer in bytes
+     *  @param actual_size  If not NULL, destination for the size of the
+     *                      value, also set when the buffer is too small
+     *  @return             0 on success, -ENOENT if the key is not set,
+     *                      -ENOMEM if the buffer is too small for the value,
+     *                      -EILSEQ if the record is corrupt, or another
+     *                      negative error code on failure
+     */
+    int get(const char *key, void *buffer, size_t buffer_size, size_t *actual_size = NULL);
+
+    /** Remove a key
+     *
+     *  @param key      Null terminated key
+     *  @return         0 on success, -ENOENT if the key is not set, or
+     *                  another negative error code on failure
+     */
+    int remove(const char *key);
+
+    /** Copy the records in use to the other area ahead of the sets
+     *
+     *  Sets do this when the active area is full; calling it from a low
+     *  priority thread instead keeps the erase out of a later set.
+     *
+     *  @return         0 on success, negative error code on failure
+     */
+    int collect();
+
+    /** Get the number of keys set
+     *
+     *  @return         Number of keys set
+     */
+    size_t count() const;
+
+    /** Get the space left in the active area
+     *
+     *  @return         Bytes left for records before the area is collected
+     */
+    bd_size_t free_space() const;
+
+private:
+    struct entry {
+        uint32_t hash;
+        uint32_t off;               // of the record in the active area
+    };
+
+    void configure();
+    bd_addr_t area_addr(int area) const;
+    int read(bd_addr_t addr, void *buffer, bd_size_t size);
+    int program_begin(bd_addr_t addr);
+    int program_data(const void *data, bd_size_t size);
+    int program_end();
+    int read_header(bd_addr_t off, struct kv_record *record);
+    int read_area_header(int area, uint32_t *seq);
+    int latest_area(int *area, uint32_t *seq);
+    int write_area_header(int area, uint32_t seq);
+    int record_crc(bd_addr_t off, const struct kv_record *record, uint32_t *crc);
+    int key_matches(uint32_t off, const char *key, size_t key_size, bool *match);
+    int find(const char *key, size_t key_size, uint32_t hash, size_t *index);
+    void insert(size_t index, uint32_t hash, uint32_t off);
+    void drop(size_t index);
+    int scan();
+    int append(const char *key, const void *buffer, size_t size, uint16_t flags);
+    int collect_locked();
+
+    BlockDevice *_bd;
+    size_t _max_keys;
+
+    bd_size_t _area_size;
+    bd_size_t _program_size;
+    bd_size_t _header_size;         // of the area header
+    uint8_t _erased;                // value programmed as padding
+
+    struct entry *_index;
+    size_t _index_mask;             // slots in the index minus 1
+    size_t _count;
+    uint8_t *_buffer;               // for programming and reading keys
+    bd_size_t _buffer_size;
+    uint8_t *_read_buffer;          // for reads unaligned to the read size
+    char *_key;                     // key of the record being scanned
+
+    int _active;                    // area holding the store
+    uint32_t _seq;                  // of the active area
+    bd_size_t _free;                // offset of the next record in the active area
+
+    bd_addr_t _program_addr;        // of the start of _buffer
+    bd_size_t _program_fill;        // bytes in _buffer
+
+    mutable PlatformMutex _mutex;
+};
+
+
+#endif
@@ -0,0 +1,496 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "mbed.h"
+#include <errno.h>
+
+#include "LogFileSystem.h"
+
+
+////// Error handling /////
+
+static int logfs_error_remap(int err)
+{
+    switch (err) {
+        case LOGFS_ERR_OK:
+            return 0;
+        case LOGFS_ERR_NOENT:
+            return -ENOENT;
+        case LOGFS_ERR_BADF:
+            return -EBADF;
+        case LOGFS_ERR_NOMEM:
+            return -ENOMEM;
+        case LOGFS_ERR_EXIST:
+            return -EEXIST;
+        case LOGFS_ERR_NOTDIR:
+            return -ENOTDIR;
+        case LOGFS_ERR_ISDIR:
+            return -EISDIR;
+        case LOGFS_ERR_INVAL:
+            return -EINVAL;
+        case LOGFS_ERR_NOSPC:
+            return -ENOSPC;
+        case LOGFS_ERR_NAMETOOLONG:
+            return -ENAMETOOLONG;
+        case LOGFS_ERR_NOTEMPTY:
+            return -ENOTEMPTY;
+        case LOGFS_ERR_CORRUPT:
+            return -EILSEQ;
+        case LOGFS_ERR_IO:
+        default:                        /* errors of the block device */
+            return -EIO;
+    }
+}
+
+static int logfs_flags_remap(int flags)
+{
+    int lflags = 0;
+    switch (flags & (O_RDONLY | O_WRONLY | O_RDWR)) {
+        case O_WRONLY:
+            lflags |= LOGFS_O_WRONLY;
+            break;
+        case O_RDWR:
+            lflags |= LOGFS_O_RDWR;
+            break;
+        default:
+            lflags |= LOGFS_O_RDONLY;
+            break;
+    }
+
+    lflags |= (flags & O_CREAT)  ? LOGFS_O_CREAT  : 0;
+    lflags |= (flags & O_EXCL)   ? LOGFS_O_EXCL   : 0;
+    lflags |= (flags & O_TRUNC)  ? LOGFS_O_TRUNC  : 0;
+    lflags |= (flags & O_APPEND) ? LOGFS_O_APPEND : 0;
+    return lflags;
+}
+
+
+////// Block device operations //////
+
+static int logfs_bd_read(const struct logfs_config *c, logfs_block_t block,
+        logfs_off_t off, void *buffer, logfs_size_t size)
+{
+    BlockDevice *bd = static_cast<BlockDevice*>(c->context);
+    return bd->read(buffer, (bd_addr_t)block*c->block_size + off, size);
+}
+
+static int logfs_bd_prog(const struct logfs_config *c, logfs_block_t block,
+        logfs_off_t off, const void *buffer, logfs_size_t size)
+{
+    BlockDevice *bd = static_cast<BlockDevice*>(c->context);
+    return bd->program(buffer, (bd_addr_t)block*c->block_size + off, size);
+}
+
+static int logfs_bd_erase(const struct logfs_config *c, logfs_block_t block)
+{
+    BlockDevice *bd = static_cast<BlockDevice*>(c->context);
+    return bd->erase((bd_addr_t)block*c->block_size, c->block_size);
+}
+
+static int logfs_bd_sync(const struct logfs_config *c)
+{
+    BlockDevice *bd = static_cast<BlockDevice*>(c->context);
+    return bd->sync();
+}
+
+void LogFileSystem::configure(struct logfs_config *config, BlockDevice *bd,
+        bd_size_t lookahead, bd_size_t cache_size)
+{
+    memset(config, 0, sizeof(*config));
+    config->context = bd;
+    config->read = logfs_bd_read;
+    config->prog = logfs_bd_prog;
+    config->erase = bd->is_erase_required() ? logfs_bd_erase : NULL;
+    config->sync = logfs_bd_sync;
+    config->read_size = bd->get_read_size();
+    config->prog_size = bd->get_program_size();
+
+    // blocks are erase blocks of at least 512 bytes
+    bd_size_t erase_size = bd->get_erase_size();
+    bd_size_t block_size = erase_size;
+    while (block_size < 512) {
+        block_size += erase_size;
+    }
+    config->block_size = block_size;
+    config->block_count = bd->size() / block_size;
+
+    // the caches take whole units of the device and divide the blocks
+    bd_size_t unit = config->read_size > config->prog_size
+            ? config->read_size : config->prog_size;
+    if (cache_size < unit) {
+        cache_size = unit;
+    }
+    cache_size = ((cache_size + unit - 1) / unit) * unit;
+    if (cache_size % config->read_size || cache_size % config->prog_size
+            || block_size % cache_size) {
+        cache_size = block_size;
+    }
+    config->cache_size = cache_size;
+
+    config->lookahead = ((lookahead + 31) / 32) * 32;
+    int erase_value = bd->get_erase_value();
+    config->erase_value = erase_value < 0 ? 0xff : erase_value;
+}
+
+
+////// Generic filesystem operations //////
+
+// Filesystem implementation (See LogFileSystem.h)
+LogFileSystem::LogFileSystem(const char *name, BlockDevice *bd,
+        bd_size_t lookahead, bd_size_t cache_size)
+        : FileSystem(name), _bd(NULL)
+        , _lookahead(lookahead), _cache_size(cache_size) {
+    if (bd) {
+        mount(bd);
+    }
+}
+
+LogFileSystem::~LogFileSystem()
+{
+    // nop if unmounted
+    unmount();
+}
+
+int LogFileSystem::mount(BlockDevice *bd) {
+    lock();
+    if (_bd) {
+        unlock();
+        return -EINVAL;
+    }
+
+    int err = bd->init();
+    if (err) {
+        unlock();
+        return err;
+    }
+
+    configure(&_config, bd, _lookahead, _cache_size);
+    err = logfs_mount(&_lfs, &_config);
+    if (err) {
+        bd->deinit();
+        unlock();
+        return logfs_error_remap(err);
+    }
+
+    _bd = bd;
+    unlock();
+    return 0;
+}
+
+int LogFileSystem::unmount()
+{
+    lock();
+    if (!_bd) {
+        unlock();
+        return -EINVAL;
+    }
+
+    int res = logfs_error_remap(logfs_unmount(&_lfs));
+    int err = _bd->deinit();
+    if (err && !res) {
+        res = err;
+    }
+
+    _bd = NULL;
+    unlock();
+    return res;
+}
+
+int LogFileSystem::format(BlockDevice *bd, bd_size_t lookahead, bd_size_t cache_size) {
+    int err = bd->init();
+    if (err) {
+        return err;
+    }
+
+    logfs_t lfs;
+    struct logfs_config config;
+    configure(&config, bd, lookahead, cache_size);
+    int res = logfs_error_remap(logfs_format(&lfs, &config));
+
+    err = bd->deinit();
+    if (err && !res) {
+        res = err;
+    }
+
+    return res;
+}
+
+int LogFileSystem::reformat(BlockDevice *bd) {
+    lock();
+    if (_bd) {
+        if (!bd) {
+            bd = _bd;
+        }
+
+        int err = unmount();
+        if (err) {
+            unlock();
+            return err;
+        }
+    }
+
+    if (!bd) {
+        unlock();
+        return -ENODEV;
+    }
+
+    int err = LogFileSystem::format(bd, _lookahead, _cache_size);
+    if (err) {
+        unlock();
+        return err;
+    }
+
+    err = mount(bd);
+    unlock();
+    return err;
+}
+
+int LogFileSystem::remove(const char *path) {
+    lock();
+    int err = logfs_remove(&_lfs, path);
+    unlock();
+    return logfs_error_remap(err);
+}
+
+int LogFileSystem::rename(const char *oldpath, const char *newpath) {
+    lock();
+    int err = logfs_rename(&_lfs, oldpath, newpath);
+    unlock();
+    return logfs_error_remap(err);
+}
+
+int LogFileSystem::mkdir(const char *path, mode_t mode) {
+    lock();
+    int err = logfs_mkdir(&_lfs, path);
+    unlock();
+    return logfs_error_remap(err);
+}
+
+int LogFileSystem::stat(const char *path, struct stat *st) {
+    struct logfs_info info;
+    lock();
+    int err = logfs_stat(&_lfs, path, &info);
+    unlock();
+    if (err) {
+        return logfs_error_remap(err);
+    }
+
+    /* ARMCC doesnt support stat(), and these symbols are not defined by the toolchain. */
+#ifdef TOOLCHAIN_GCC
+    st->st_size = info.size;
+    st->st_mode = (info.type == LOGFS_TYPE_DIR) ? S_IFDIR : S_IFREG;
+    st->st_mode |= S_IRWXU | S_IRWXG | S_IRWXO;
+#endif /* TOOLCHAIN_GCC */
+
+    return 0;
+}
+
+void LogFileSystem::lock() {
+    _mutex.lock();
+}
+
+void LogFileSystem::unlock() {
+    _mutex.unlock();
+}
+
+
+////// File operations //////
+int LogFileSystem::file_open(fs_file_t *file, const char *path, int flags) {
+    logfs_file_t *f = new logfs_file_t;
+
+    lock();
+    int err = logfs_file_open(&_lfs, f, path, logfs_flags_remap(flags));
+    unlock();
+
+    if (err) {
+        delete f;
+        return logfs_error_remap(err);
+    }
+
+    *file = f;
+    return 0;
+}
+
+int LogFileSystem::file_close(fs_file_t file) {
+    logfs_file_t *f = static_cast<logfs_file_t*>(file);
+
+    lock();
+    int err = logfs_file_close(&_lfs, f);
+    unlock();
+
+    delete f;
+    return logfs_error_remap(err);
+}
+
+ssize_t LogFileSystem::file_read(fs_file_t file, void *buffer, size_t len) {
+    logfs_file_t *f = static_cast<logfs_file_t*>(file);
+
+    lock();
+    logfs_ssize_t res = logfs_file_read(&_lfs, f, buffer, len);
+    unlock();
+
+    return res < 0 ? logfs_error_remap(res) : res;
+}
+
+ssize_t LogFileSystem::file_write(fs_file_t file, const void *buffer, size_t len) {
+    logfs_file_t *f = static_cast<logfs_file_t*>(file);
+
+    lock();
+    logfs_ssize_t res = logfs_file_write(&_lfs, f, buffer, len);
+    unlock();
+
+    return res < 0 ? logfs_error_remap(res) : res;
+}
+
+ssize_t LogFileSystem::file_readv(fs_file_t file, const struct iovec *iov, int iovcnt) {
+    // the lock is recursive, so file_read can take it again
+    lock();
+    ssize_t n = FileSystem::file_readv(file, iov, iovcnt);
+    unlock();
+    return n;
+}
+
+ssize_t LogFileSystem::file_writev(fs_file_t file, const struct iovec *iov, int iovcnt) {
+    lock();
+    ssize_t n = FileSystem::file_writev(file, iov, iovcnt);
+    unlock();
+    return n;
+}
+
+int LogFileSystem::file_sync(fs_file_t file) {
+    logfs_file_t *f = static_cast<logfs_file_t*>(file);
+
+    lock();
+    int err = logfs_file_sync(&_lfs, f);
+    unlock();
+
+    return logfs_error_remap(err);
+}
+
+off_t LogFileSystem::file_seek(fs_file_t file, off_t offset, int whence) {
+    logfs_file_t *f = static_cast<logfs_file_t*>(file);
+
+    int lwhence = LOGFS_SEEK_SET;
+    if (whence == SEEK_CUR) {
+        lwhence = LOGFS_SEEK_CUR;
+    } else if (whence == SEEK_END) {
+        lwhence = LOGFS_SEEK_END;
+    }
+
+    lock();
+    logfs_soff_t res = logfs_file_seek(&_lfs, f, offset, lwhence);
+    unlock();
+
+    return res < 0 ? logfs_error_remap(res) : res;
+}
+
+off_t LogFileSystem::file_tell(fs_file_t file) {
+    logfs_file_t *f = static_cast<logfs_file_t*>(file);
+
+    lock();
+    off_t res = logfs_file_tell(&_lfs, f);
+    unlock();
+
+    return res;
+}
+
+off_t LogFileSystem::file_size(fs_file_t file) {
+    logfs_file_t *f = static_cast<logfs_file_t*>(file);
+
+    lock();
+    off_t res = logfs_file_size(&_lfs, f);
+    unlock();
+
+    return res;
+}
+
+
+////// Dir operations //////
+int LogFileSystem::dir_open(fs_dir_t *dir, const char *path) {
+    logfs_dir_t *d = new logfs_dir_t;
+
+    lock();
+    int err = logfs_dir_open(&_lfs, d, path);
+    unlock();
+
+    if (err) {
+        delete d;
+        return logfs_error_remap(err);
+    }
+
+    *dir = d;
+    return 0;
+}
+
+int LogFileSystem::dir_close(fs_dir_t dir) {
+    logfs_dir_t *d = static_cast<logfs_dir_t*>(dir);
+
+    lock();
+    int err = logfs_dir_close(&_lfs, d);
+    unlock();
+
+    delete d;
+    return logfs_error_remap(err);
+}
+
+ssize_t LogFileSystem::dir_read(fs_dir_t dir, struct dirent *ent) {
+    logfs_dir_t *d = static_cast<logfs_dir_t*>(dir);
+    struct logfs_info info;
+
+    lock();
+    int res = logfs_dir_read(&_lfs, d, &info);
+    unlock();
+
+    if (res <= 0) {
+        return logfs_error_remap(res);
+    }
+
+    ent->d_type = (info.type == LOGFS_TYPE_DIR) ? DT_DIR : DT_REG;
+    strncpy(ent->d_name, info.name, NAME_MAX);
+    ent->d_name[NAME_MAX] = '\0';
+    return 1;
+}
+
+void LogFileSystem::dir_seek(fs_dir_t dir, off_t offset) {
+    logfs_dir_t *d = static_cast<logfs_dir_t*>(dir);
+
+    lock();
+    logfs_dir_seek(&_lfs, d, offset);
+    unlock();
+}
+
+off_t LogFileSystem::dir_tell(fs_dir_t dir) {
+    logfs_dir_t *d = static_cast<logfs_dir_t*>(dir);
+
+    lock();
+    off_t offset = logfs_dir_tell(&_lfs, d);
+    unlock();
+
+    return offset;
+}
+
+void LogFileSystem::dir_rewind(fs_dir_t dir) {
+    logfs_dir_t *d = static_cast<logfs_dir_t*>(dir);
+
+    lock();
+    logfs_dir_rewind(&_lfs, d);
+    unlock();
+}
@@ -0,0 +1,2739 @@
+/* logfs
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "logfs.h"
+
+#include <string.h>
+#include <stdlib.h>
+
+
+/// On-disk format ///
+//
+// A metadata block starts with a 32-bit revision, followed by commits of
+// entries. Each entry has a 4-byte header of its type, the length of its
+// name and the length of its data, all little-endian, and is padded to 4
+// bytes. A commit ends with a CRC entry holding the CRC-32 of the block
+// up to it, less the earlier CRC entries, padded so the next commit starts
+// on a program boundary.
+#define LOGFS_BLOCK_NULL    ((logfs_block_t)-1)
+
+enum logfs_attr_type {
+    LOGFS_ATTR_REG      = 0x01,     // file, head and size
+    LOGFS_ATTR_DIR      = 0x02,     // directory, pair
+    LOGFS_ATTR_SUPER    = 0x10,     // version, block size and count, name max
+    LOGFS_ATTR_DEL      = 0x20,     // removes the entry of a name
+    LOGFS_ATTR_TAIL     = 0x30,     // split flag and pair of the next pair
+    LOGFS_ATTR_CRC      = 0x40,     // CRC of the commits up to this entry
+};
+
+#define LOGFS_ATTR_SIZE(nlen, dlen) logfs_alignup(4 + (nlen) + (dlen), 4)
+
+// Internal file flags
+enum logfs_file_flags {
+    LOGFS_F_DIRTY   = 0x010000,     // entry must be committed
+    LOGFS_F_WRITING = 0x020000,     // block being written, in the cache
+    LOGFS_F_READING = 0x040000,     // block being read
+    LOGFS_F_ERRED   = 0x080000,     // a write failed, nothing is committed
+};
+
+// Entry in RAM when block is LOGFS_BLOCK_NULL, on disk otherwise
+struct logfs_attr {
+    uint8_t type;
+    uint8_t nlen;
+    uint16_t dlen;
+    const void *name;
+    const void *data;
+    logfs_block_t block;
+    logfs_off_t off;
+};
+
+// Entry found in a directory
+struct logfs_entry {
+    uint8_t type;
+    logfs_block_t u[2];     // head and size of a file, pair of a directory
+    struct logfs_attr attr;
+};
+
+
+/// Utilities ///
+static inline uint32_t logfs_min(uint32_t a, uint32_t b)
+{
+    return a < b ? a : b;
+}
+
+static inline uint32_t logfs_max(uint32_t a, uint32_t b)
+{
+    return a > b ? a : b;
+}
+
+static inline uint32_t logfs_aligndown(uint32_t a, uint32_t align)
+{
+    return a - (a % align);
+}
+
+static inline uint32_t logfs_alignup(uint32_t a, uint32_t align)
+{
+    return logfs_aligndown(a + align - 1, align);
+}
+
+// Trailing zeros, a must not be zero
+static inline uint32_t logfs_ctz(uint32_t a)
+{
+    uint32_t n = 0;
+    while (!(a & 1)) {
+        a >>= 1;
+        n++;
+    }
+    return n;
+}
+
+// Floor of the base 2 logarithm, a must not be zero
+static inline uint32_t logfs_log2(uint32_t a)
+{
+    uint32_t n = 0;
+    while (a >>= 1) {
+        n++;
+    }
+    return n;
+}
+
+static inline uint32_t logfs_popc(uint32_t a)
+{
+    uint32_t n = 0;
+    while (a) {
+        a &= a - 1;
+        n++;
+    }
+    return n;
+}
+
+// Signed comparison of revisions, which may wrap
+static inline int logfs_scmp(uint32_t a, uint32_t b)
+{
+    return (int)(int32_t)(a - b);
+}
+
+static inline uint32_t logfs_fromle32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8)
+        | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline void logfs_tole32(uint32_t a, uint8_t *p)
+{
+    p[0] = (uint8_t)(a >> 0);
+    p[1] = (uint8_t)(a >> 8);
+    p[2] = (uint8_t)(a >> 16);
+    p[3] = (uint8_t)(a >> 24);
+}
+
+static inline bool logfs_pair_isnull(const logfs_block_t pair[2])
+{
+    return pair[0] == LOGFS_BLOCK_NULL || pair[1] == LOGFS_BLOCK_NULL;
+}
+
+// Pairs are the same whichever block is active
+static inline bool logfs_pair_eq(const logfs_block_t a[2], const logfs_block_t b[2])
+{
+    return (a[0] == b[0] && a[1] == b[1]) || (a[0] == b[1] && a[1] == b[0]);
+}
+
+// CRC-32 with polynomial 0x04c11db7, a nibble at a time
+static uint32_t logfs_crc(uint32_t crc, const void *buffer, logfs_size_t size)
+{
+    static const uint32_t rtable[16] = {
+        0x00000000, 0x1db71064, 0x3b6e20c8, 0x26d930ac,
+        0x76dc4190, 0x6b6b51f4, 0x4db26158, 0x5005713c,
+        0xedb88320, 0xf00f9344, 0xd6d6a3e8, 0xcb61b38c,
+        0x9b64c2b0, 0x86d3d2d4, 0xa00ae278, 0xbdbdf21c,
+    };
+
+    const uint8_t *data = (const uint8_t *)buffer;
+    for (logfs_size_t i = 0; i < size; i++) {
+        crc = (crc >> 4) ^ rtable[(crc ^ (data[i] >> 0)) & 0xf];
+        crc = (crc >> 4) ^ rtable[(crc ^ (data[i] >> 4)) & 0xf];
+    }
+
+    return crc;
+}
+
+
+/// Block device operations ///
+//
+// Reads go through the read cache, or the program cache of the data they
+// were programmed from until it is flushed. Programs to a block are
+// sequential and are held in a program cache until it is full or flushed.
+static int logfs_bd_read(logfs_t *lfs, const logfs_cache_t *pcache,
+        logfs_block_t block, logfs_off_t off, void *buffer, logfs_size_t size)
+{
+    const struct logfs_config *cfg = lfs->cfg;
+    uint8_t *data = (uint8_t *)buffer;
+    if (block >= cfg->block_count || off + size > cfg->block_size) {
+        return LOGFS_ERR_CORRUPT;
+    }
+
+    while (size > 0) {
+        logfs_size_t diff = size;
+
+        if (pcache && pcache->block == block
+                && off < pcache->off + pcache->size) {
+            if (off >= pcache->off) {
+                diff = logfs_min(diff, pcache->size - (off - pcache->off));
+                memcpy(data, &pcache->buffer[off - pcache->off], diff);
+                data += diff;
+                off += diff;
+                size -= diff;
+                continue;
+            }
+
+            diff = logfs_min(diff, pcache->off - off);
+        }
+
+        if (lfs->rcache.block == block
+                && off < lfs->rcache.off + lfs->rcache.size) {
+            if (off >= lfs->rcache.off) {
+                diff = logfs_min(diff, lfs->rcache.size - (off - lfs->rcache.off));
+                memcpy(data, &lfs->rcache.buffer[off - lfs->rcache.off], diff);
+                data += diff;
+                off += diff;
+                size -= diff;
+                continue;
+            }
+
+            diff = logfs_min(diff, lfs->rcache.off - off);
+        }
+
+        // large aligned reads bypass the cache
+        if (off % cfg->read_size == 0 && diff >= cfg->cache_size) {
+            diff = logfs_aligndown(diff, cfg->read_size);
+            int err = cfg->read(cfg, block, off, data, diff);
+            if (err) {
+                return err;
+            }
+
+            data += diff;
+            off += diff;
+            size -= diff;
+            continue;
+        }
+
+        lfs->rcache.block = block;
+        lfs->rcache.off = logfs_aligndown(off, cfg->cache_size);
+        lfs->rcache.size = cfg->cache_size;
+        int err = cfg->read(cfg, block, lfs->rcache.off,
+                lfs->rcache.buffer, lfs->rcache.size);
+        if (err) {
+            lfs->rcache.block = LOGFS_BLOCK_NULL;
+            return err;
+        }
+    }
+
+    return 0;
+}
+
+// Compare data on disk, 0 if equal, 1 if not, or a negative error
+static int logfs_bd_cmp(logfs_t *lfs, logfs_block_t block, logfs_off_t off,
+        const void *buffer, logfs_size_t size)
+{
+    const uint8_t *data = (const uint8_t *)buffer;
+    uint8_t chunk[16];
+
+    while (size > 0) {
+        logfs_size_t diff = logfs_min(size, sizeof(chunk));
+        int err = logfs_bd_read(lfs, NULL, block, off, chunk, diff);
+        if (err) {
+            return err;
+        }
+
+        if (memcmp(chunk, data, diff) != 0) {
+            return 1;
+        }
+
+        data += diff;
+        off += diff;
+        size -= diff;
+    }
+
+    return 0;
+}
+
+static int logfs_bd_crc(logfs_t *lfs, logfs_block_t block, logfs_off_t off,
+        logfs_size_t size, uint32_t *crc)
+{
+    uint8_t chunk[16];
+
+    while (size > 0) {
+        logfs_size_t diff = logfs_min(size, sizeof(chunk));
+        int err = logfs_bd_read(lfs, NULL, block, off, chunk, diff);
+        if (err) {
+            return err;
+        }
+
+        *crc = logfs_crc(*crc, chunk, diff);
+        off += diff;
+        size -= diff;
+    }
+
+    return 0;
+}
+
+static int logfs_bd_flush(logfs_t *lfs, logfs_cache_t *pcache)
+{
+    const struct logfs_config *cfg = lfs->cfg;
+
+    if (pcache->block != LOGFS_BLOCK_NULL && pcache->size > 0) {
+        logfs_size_t diff = logfs_alignup(pcache->size, cfg->prog_size);
+        int err = cfg->prog(cfg, pcache->block, pcache->off,
+                pcache->buffer, diff);
+        if (lfs->rcache.block == pcache->block) {
+            lfs->rcache.block = LOGFS_BLOCK_NULL;
+        }
+        if (err) {
+            pcache->block = LOGFS_BLOCK_NULL;
+            return err;
+        }
+    }
+
+    pcache->block = LOGFS_BLOCK_NULL;
+    pcache->size = 0;
+    return 0;
+}
+
+static int logfs_bd_prog(logfs_t *lfs, logfs_cache_t *pcache,
+        logfs_block_t block, logfs_off_t off, const void *buffer, logfs_size_t size)
+{
+    const struct logfs_config *cfg = lfs->cfg;
+    const uint8_t *data = (const uint8_t *)buffer;
+    if (block >= cfg->block_count || off + size > cfg->block_size) {
+        return LOGFS_ERR_CORRUPT;
+    }
+
+    while (size > 0) {
+        logfs_off_t end = logfs_min(pcache->off + cfg->cache_size, cfg->block_size);
+
+        if (pcache->block == block && off >= pcache->off && off < end) {
+            logfs_size_t diff = logfs_min(size, end - off);
+            memcpy(&pcache->buffer[off - pcache->off], data, diff);
+            data += diff;
+            off += diff;
+            size -= diff;
+
+            pcache->size = logfs_max(pcache->size, off - pcache->off);
+            if (off == end) {
+                int err = logfs_bd_flush(lfs, pcache);
+                if (err) {
+                    return err;
+                }
+            }
+            continue;
+        }
+
+        int err = logfs_bd_flush(lfs, pcache);
+        if (err) {
+            return err;
+        }
+
+        pcache->block = block;
+        pcache->off = logfs_aligndown(off, cfg->prog_size);
+        pcache->size = 0;
+        memset(pcache->buffer, cfg->erase_value, cfg->cache_size);
+    }
+
+    return 0;
+}
+
+static int logfs_bd_erase(logfs_t *lfs, logfs_block_t block)
+{
+    if (lfs->rcache.block == block) {
+        lfs->rcache.block = LOGFS_BLOCK_NULL;
+    }
+
+    if (!lfs->cfg->erase) {
+        return 0;
+    }
+
+    return lfs->cfg->erase(lfs->cfg, block);
+}
+
+static int logfs_bd_sync(logfs_t *lfs)
+{
+    lfs->rcache.block = LOGFS_BLOCK_NULL;
+    if (!lfs->cfg->sync) {
+        return 0;
+    }
+
+    return lfs->cfg->sync(lfs->cfg);
+}
+
+
+/// Metadata pairs ///
+static int logfs_attr_get(logfs_t *lfs, logfs_block_t block, logfs_off_t off,
+        struct logfs_attr *attr)
+{
+    uint8_t header[4];
+    int err = logfs_bd_read(lfs, NULL, block, off, header, sizeof(header));
+    if (err) {
+        return err;
+    }
+
+    attr->type = header[0];
+    attr->nlen = header[1];
+    attr->dlen = (uint16_t)(header[2] | (header[3] << 8));
+    attr->name = NULL;
+    attr->data = NULL;
+    attr->block = block;
+    attr->off = off;
+    return 0;
+}
+
+static int logfs_attr_data(logfs_t *lfs, const struct logfs_attr *attr,
+        void *buffer, logfs_size_t size)
+{
+    memset(buffer, 0xff, size);
+    if (attr->block == LOGFS_BLOCK_NULL) {
+        memcpy(buffer, attr->data, logfs_min(size, attr->dlen));
+        return 0;
+    }
+
+    return logfs_bd_read(lfs, NULL, attr->block, attr->off + 4 + attr->nlen,
+            buffer, logfs_min(size, attr->dlen));
+}
+
+// Compare the name of an entry, 0 if equal, 1 if not, or a negative error
+static int logfs_attr_cmp(logfs_t *lfs, const struct logfs_attr *attr,
+        const char *name, logfs_size_t nlen)
+{
+    if (attr->nlen != nlen) {
+        return 1;
+    }
+
+    if (attr->block == LOGFS_BLOCK_NULL) {
+        return memcmp(attr->name, name, nlen) != 0;
+    }
+
+    return logfs_bd_cmp(lfs, attr->block, attr->off + 4, name, nlen);
+}
+
+static inline bool logfs_attr_isnamed(uint8_t type)
+{
+    return type == LOGFS_ATTR_REG || type == LOGFS_ATTR_DIR
+        || type == LOGFS_ATTR_DEL;
+}
+
+// Find the commits of a block, valid is set if it has one
+static int logfs_mdir_scan(logfs_t *lfs, logfs_block_t block,
+        logfs_mdir_t *m, bool *valid)
+{
+    const struct logfs_config *cfg = lfs->cfg;
+    uint8_t buffer[4];
+    int err = logfs_bd_read(lfs, NULL, block, 0, buffer, sizeof(buffer));
+    if (err) {
+        return err;
+    }
+
+    uint32_t crc = logfs_crc(0xffffffff, buffer, sizeof(buffer));
+    logfs_off_t off = sizeof(buffer);
+    logfs_block_t tail[2] = {LOGFS_BLOCK_NULL, LOGFS_BLOCK_NULL};
+    bool split = false;
+
+    m->rev = logfs_fromle32(buffer);
+    m->tail[0] = LOGFS_BLOCK_NULL;
+    m->tail[1] = LOGFS_BLOCK_NULL;
+    m->split = false;
+    *valid = false;
+
+    while (off + 4 <= cfg->block_size) {
+        uint8_t header[4];
+        err = logfs_bd_read(lfs, NULL, block, off, header, sizeof(header));
+        if (err) {
+            return err;
+        }
+
+        struct logfs_attr attr;
+        attr.type = header[0];
+        attr.nlen = header[1];
+        attr.dlen = (uint16_t)(header[2] | (header[3] << 8));
+        attr.block = block;
+        attr.off = off;
+        logfs_size_t size = LOGFS_ATTR_SIZE(attr.nlen, attr.dlen);
+        if (off + size > cfg->block_size) {
+            break;
+        }
+
+        crc = logfs_crc(crc, header, sizeof(header));
+        if (attr.type == LOGFS_ATTR_CRC) {
+            if (attr.dlen < 4) {
+                break;
+            }
+
+            err = logfs_bd_read(lfs, NULL, block, off + 4, buffer, sizeof(buffer));
+            if (err) {
+                return err;
+            }
+
+            if (logfs_fromle32(buffer) != crc) {
+                break;
+            }
+
+            off += size;
+            m->off = off;
+            m->crc = crc;
+            m->tail[0] = tail[0];
+            m->tail[1] = tail[1];
+            m->split = split;
+            *valid = true;
+            continue;
+        }
+
+        if (attr.type == LOGFS_ATTR_TAIL && attr.nlen == 0 && attr.dlen >= 12) {
+            uint8_t data[12];
+            err = logfs_attr_data(lfs, &attr, data, sizeof(data));
+            if (err) {
+                return err;
+            }
+
+            split = data[0] != 0;
+            tail[0] = logfs_fromle32(&data[4]);
+            tail[1] = logfs_fromle32(&data[8]);
+        }
+
+        err = logfs_bd_crc(lfs, block, off + 4, size - 4, &crc);
+        if (err) {
+            return err;
+        }
+
+        off += size;
+    }
+
+    return 0;
+}
+
+// Check that commits can be appended to the active block
+static int logfs_mdir_erased(logfs_t *lfs, logfs_mdir_t *m)
+{
+    const struct logfs_config *cfg = lfs->cfg;
+    m->erased = true;
+    if (!cfg->erase) {
+        return 0;
+    }
+
+    // programs are sequential, so an interrupted commit changed the first
+    // program unit after the last commit
+    logfs_size_t size = logfs_max(cfg->prog_size, 4);
+    if (m->off + size > cfg->block_size) {
+        m->erased = false;
+        return 0;
+    }
+
+    for (logfs_size_t i = 0; i < size; i++) {
+        uint8_t c;
+        int err = logfs_bd_read(lfs, NULL, m->pair[0], m->off + i, &c, 1);
+        if (err) {
+            return err;
+        }
+
+        if (c != cfg->erase_value) {
+            m->erased = false;
+            return 0;
+        }
+    }
+
+    return 0;
+}
+
+static int logfs_mdir_fetch(logfs_t *lfs, logfs_mdir_t *m,
+        const logfs_block_t pair[2])
+{
+    const struct logfs_config *cfg = lfs->cfg;
+    if (pair[0] >= cfg->block_count || pair[1] >= cfg->block_count) {
+        return LOGFS_ERR_CORRUPT;
+    }
+
+    // the block with the later revision is tried first, it is the other
+    // if its compaction was interrupted
+    uint32_t rev[2];
+    for (int i = 0; i < 2; i++) {
+        uint8_t buffer[4];
+        int err = logfs_bd_read(lfs, NULL, pair[i], 0, buffer, sizeof(buffer));
+        if (err) {
+            return err;
+        }
+        rev[i] = logfs_fromle32(buffer);
+    }
+
+    int first = logfs_scmp(rev[1], rev[0]) > 0 ? 1 : 0;
+    for (int i = 0; i < 2; i++) {
+        logfs_block_t block = pair[(first + i) % 2];
+        bool valid;
+        int err = logfs_mdir_scan(lfs, block, m, &valid);
+        if (err) {
+            return err;
+        }
+
+        if (valid) {
+            m->pair[0] = block;
+            m->pair[1] = pair[(first + i + 1) % 2];
+            return logfs_mdir_erased(lfs, m);
+        }
+    }
+
+    return LOGFS_ERR_CORRUPT;
+}
+
+// Check that no later entry of the log replaces an entry
+static int logfs_mdir_islive(logfs_t *lfs, const logfs_mdir_t *m,
+        const struct logfs_attr *attr, bool *live)
+{
+    char name[LOGFS_NAME_MAX + 1];
+    if (attr->type != LOGFS_ATTR_SUPER) {
+        int err = logfs_bd_read(lfs, NULL, attr->block, attr->off + 4,
+                name, attr->nlen);
+        if (err) {
+            return err;
+        }
+    }
+
+    *live = true;
+    logfs_off_t off = attr->off + LOGFS_ATTR_SIZE(attr->nlen, attr->dlen);
+    while (off < m->off) {
+        struct logfs_attr next;
+        int err = logfs_attr_get(lfs, m->pair[0], off, &next);
+        if (err) {
+            return err;
+        }
+
+        if (attr->type == LOGFS_ATTR_SUPER) {
+            if (next.type == LOGFS_ATTR_SUPER) {
+                *live = false;
+                return 0;
+            }
+        } else if (logfs_attr_isnamed(next.type)) {
+            err = logfs_attr_cmp(lfs, &next, name, attr->nlen);
+            if (err < 0) {
+                return err;
+            }
+
+            if (!err) {
+                *live = false;
+                return 0;
+            }
+        }
+
+        off += LOGFS_ATTR_SIZE(next.nlen, next.dlen);
+    }
+
+    return 0;
+}
+
+// Find the entry of a name in the log of a pair
+static int logfs_mdir_find(logfs_t *lfs, const logfs_mdir_t *m,
+        const char *name, logfs_size_t nlen, struct logfs_entry *entry)
+{
+    bool found = false;
+    logfs_off_t off = 4;
+    while (off < m->off) {
+        struct logfs_attr attr;
+        int err = logfs_attr_get(lfs, m->pair[0], off, &attr);
+        if (err) {
+            return err;
+        }
+
+        if (logfs_attr_isnamed(attr.type)) {
+            err = logfs_attr_cmp(lfs, &attr, name, nlen);
+            if (err < 0) {
+                return err;
+            }
+
+            if (!err) {
+                entry->attr = attr;
+                found = attr.type != LOGFS_ATTR_DEL;
+            }
+        }
+
+        off += LOGFS_ATTR_SIZE(attr.nlen, attr.dlen);
+    }
+
+    if (!found) {
+        return LOGFS_ERR_NOENT;
+    }
+
+    uint8_t data[8];
+    int err = logfs_attr_data(lfs, &entry->attr, data, sizeof(data));
+    if (err) {
+        return err;
+    }
+
+    entry->type = entry->attr.type;
+    entry->u[0] = logfs_fromle32(&data[0]);
+    entry->u[1] = logfs_fromle32(&data[4]);
+    return 0;
+}
+
+// Writes entries of a commit, keeping the CRC
+struct logfs_commit {
+    logfs_block_t block;
+    logfs_off_t off;
+    uint32_t crc;
+};
+
+static int logfs_commit_prog(logfs_t *lfs, struct logfs_commit *commit,
+        const void *buffer, logfs_size_t size)
+{
+    int err = logfs_bd_prog(lfs, &lfs->pcache, commit->block, commit->off,
+            buffer, size);
+    if (err) {
+        return err;
+    }
+
+    commit->crc = logfs_crc(commit->crc, buffer, size);
+    commit->off += size;
+    return 0;
+}
+
+static int logfs_commit_attr(logfs_t *lfs, struct logfs_commit *commit,
+        const struct logfs_attr *attr)
+{
+    uint8_t header[4] = {attr->type, attr->nlen,
+            (uint8_t)(attr->dlen & 0xff), (uint8_t)(attr->dlen >> 8)};
+    int err = logfs_commit_prog(lfs, commit, header, sizeof(header));
+    if (err) {
+        return err;
+    }
+
+    logfs_size_t size = attr->nlen + attr->dlen;
+    if (attr->block == LOGFS_BLOCK_NULL) {
+        err = logfs_commit_prog(lfs, commit, attr->name, attr->nlen);
+        if (!err) {
+            err = logfs_commit_prog(lfs, commit, attr->data, attr->dlen);
+        }
+        if (err) {
+            return err;
+        }
+    } else {
+        // copy from the disk, the padding comes along
+        size = LOGFS_ATTR_SIZE(attr->nlen, attr->dlen) - 4;
+        logfs_off_t off = attr->off + 4;
+        uint8_t chunk[16];
+        for (logfs_size_t i = 0; i < size; i += sizeof(chunk)) {
+            logfs_size_t diff = logfs_min(size - i, sizeof(chunk));
+            err = logfs_bd_read(lfs, NULL, attr->block, off + i, chunk, diff);
+            if (!err) {
+                err = logfs_commit_prog(lfs, commit, chunk, diff);
+            }
+            if (err) {
+                return err;
+            }
+        }
+    }
+
+    static const uint8_t zeros[4] = {0};
+    return logfs_commit_prog(lfs, commit, zeros,
+            LOGFS_ATTR_SIZE(attr->nlen, attr->dlen) - 4 - size);
+}
+
+static int logfs_commit_crc(logfs_t *lfs, struct logfs_commit *commit)
+{
+    const struct logfs_config *cfg = lfs->cfg;
+    logfs_size_t align = logfs_max(cfg->prog_size, 4);
+    logfs_off_t end = logfs_alignup(commit->off + 8, align);
+    logfs_size_t dlen = end - commit->off - 4;
+
+    uint8_t header[4] = {LOGFS_ATTR_CRC, 0,
+            (uint8_t)(dlen & 0xff), (uint8_t)(dlen >> 8)};
+    int err = logfs_commit_prog(lfs, commit, header, sizeof(header));
+    if (err) {
+        return err;
+    }
+
+    // The CRC and padding are left out of the CRC of the next commit, as a
+    // CRC over its own value gives the same residue whatever the data, and
+    // commits would no longer depend on the log before them
+    uint8_t crc[4];
+    logfs_tole32(commit->crc, crc);
+    err = logfs_bd_prog(lfs, &lfs->pcache, commit->block, commit->off,
+            crc, sizeof(crc));
+    commit->off += sizeof(crc);
+
+    static const uint8_t zeros[4] = {0};
+    while (!err && commit->off < end) {
+        logfs_size_t diff = logfs_min(end - commit->off, sizeof(zeros));
+        err = logfs_bd_prog(lfs, &lfs->pcache, commit->block, commit->off,
+                zeros, diff);
+        commit->off += diff;
+    }
+    if (err) {
+        return err;
+    }
+
+    return logfs_bd_flush(lfs, &lfs->pcache);
+}
+
+// Space taken by the entries of a compacted block, leaving room for its
+// revision, tail and CRC
+static logfs_size_t logfs_mdir_capacity(logfs_t *lfs)
+{
+    const struct logfs_config *cfg = lfs->cfg;
+    logfs_size_t align = logfs_max(cfg->prog_size, 4);
+    return logfs_aligndown(cfg->block_size, align) - 4
+        - LOGFS_ATTR_SIZE(0, 12) - 8 - (align - 4);
+}
+
+// Packs the entries kept by a compaction into blocks, and writes those of
+// one of them
+struct logfs_pack {
+    logfs_size_t used;
+    int block;
+    int target;
+    struct logfs_commit *commit;
+};
+
+static int logfs_pack_attr(logfs_t *lfs, struct logfs_pack *pack,
+        const struct logfs_attr *attr)
+{
+    logfs_size_t size = LOGFS_ATTR_SIZE(attr->nlen, attr->dlen);
+    if (pack->used > 0 && pack->used + size > logfs_mdir_capacity(lfs)) {
+        pack->block++;
+        pack->used = 0;
+    }
+
+    pack->used += size;
+    if (pack->block != pack->target) {
+        return 0;
+    }
+
+    return logfs_commit_attr(lfs, pack->commit, attr);
+}
+
+// Visit the entries kept by a compaction, those of the log not replaced
+// by later entries or by attrs, then the new entries of attrs
+static int logfs_mdir_pack(logfs_t *lfs, const logfs_mdir_t *m,
+        const struct logfs_attr *attrs, int count, struct logfs_pack *pack)
+{
+    logfs_off_t off = 4;
+    while (m && off < m->off) {
+        struct logfs_attr attr;
+        int err = logfs_attr_get(lfs, m->pair[0], off, &attr);
+        if (err) {
+            return err;
+        }
+        off += LOGFS_ATTR_SIZE(attr.nlen, attr.dlen);
+
+        if (attr.type != LOGFS_ATTR_REG && attr.type != LOGFS_ATTR_DIR
+                && attr.type != LOGFS_ATTR_SUPER) {
+            continue;
+        }
+
+        bool live;
+        err = logfs_mdir_islive(lfs, m, &attr, &live);
+        if (err) {
+            return err;
+        }
+
+        for (int i = 0; i < count && live; i++) {
+            if (attr.type == LOGFS_ATTR_SUPER) {
+                live = attrs[i].type != LOGFS_ATTR_SUPER;
+            } else if (logfs_attr_isnamed(attrs[i].type)) {
+                err = logfs_attr_cmp(lfs, &attr, (const char *)attrs[i].name,
+                        attrs[i].nlen);
+                if (err < 0) {
+                    return err;
+                }
+                live = err;
+            }
+        }
+
+        if (live) {
+            err = logfs_pack_attr(lfs, pack, &attr);
+            if (err) {
+                return err;
+            }
+        }
+    }
+
+    for (int i = 0; i < count; i++) {
+        if (attrs[i].type == LOGFS_ATTR_REG || attrs[i].type == LOGFS_ATTR_DIR
+                || attrs[i].type == LOGFS_ATTR_SUPER) {
+            int err = logfs_pack_attr(lfs, pack, &attrs[i]);
+            if (err) {
+                return err;
+            }
+        }
+    }
+
+    return 0;
+}
+
+static void logfs_tail_attr(struct logfs_attr *attr, uint8_t data[12],
+        const logfs_block_t tail[2], bool split)
+{
+    memset(data, 0, 12);
+    data[0] = split ? 1 : 0;
+    logfs_tole32(tail[0], &data[4]);
+    logfs_tole32(tail[1], &data[8]);
+
+    attr->type = LOGFS_ATTR_TAIL;
+    attr->nlen = 0;
+    attr->dlen = 12;
+    attr->name = NULL;
+    attr->data = data;
+    attr->block = LOGFS_BLOCK_NULL;
+    attr->off = 0;
+}
+
+// Write a block of a compaction, or an empty one if target is negative
+static int logfs_mdir_write(logfs_t *lfs, logfs_block_t block, uint32_t rev,
+        const logfs_mdir_t *m, const struct logfs_attr *attrs, int count,
+        int target, const logfs_block_t tail[2], bool split,
+        struct logfs_commit *commit)
+{
+    int err = logfs_bd_erase(lfs, block);
+    if (err) {
+        return err;
+    }
+
+    commit->block = block;
+    commit->off = 0;
+    commit->crc = 0xffffffff;
+
+    uint8_t buffer[4];
+    logfs_tole32(rev, buffer);
+    err = logfs_commit_prog(lfs, commit, buffer, sizeof(buffer));
+    if (err) {
+        goto cleanup;
+    }
+
+    if (target >= 0) {
+        struct logfs_pack pack = {0, 0, target, commit};
+        err = logfs_mdir_pack(lfs, m, attrs, count, &pack);
+        if (err) {
+            goto cleanup;
+        }
+    }
+
+    if (!logfs_pair_isnull(tail)) {
+        struct logfs_attr attr;
+        uint8_t data[12];
+        logfs_tail_attr(&attr, data, tail, split);
+        err = logfs_commit_attr(lfs, commit, &attr);
+        if (err) {
+            goto cleanup;
+        }
+    }
+
+    err = logfs_commit_crc(lfs, commit);
+
+cleanup:
+    if (err) {
+        lfs->pcache.block = LOGFS_BLOCK_NULL;
+    }
+    return err;
+}
+
+// Revisions for writing a new pair, the first block the later. Those of a
+// block only grow, so without erase, commits left from what a block held
+// before never chain onto a new log.
+static int logfs_mdir_revs(logfs_t *lfs, const logfs_block_t pair[2],
+        uint32_t rev[2])
+{
+    for (int i = 0; i < 2; i++) {
+        uint8_t buffer[4];
+        int err = logfs_bd_read(lfs, NULL, pair[i], 0, buffer, sizeof(buffer));
+        if (err) {
+            return err;
+        }
+        rev[i] = logfs_fromle32(buffer) + 1;
+    }
+
+    if (logfs_scmp(rev[0], rev[1]) <= 0) {
+        rev[0] = rev[1] + 1;
+    }
+
+    return 0;
+}
+
+// Create a pair holding the entries of one block of a compaction
+static int logfs_mdir_split(logfs_t *lfs, logfs_block_t pair[2],
+        const logfs_mdir_t *m, const struct logfs_attr *attrs, int count,
+        int target, const logfs_block_t tail[2], bool split);
+
+static void logfs_dir_notify(logfs_t *lfs, const logfs_block_t pair[2],
+        const logfs_mdir_t *m, bool compacted);
+
+static int logfs_mdir_compact(logfs_t *lfs, logfs_mdir_t *m,
+        const struct logfs_attr *attrs, int count)
+{
+    logfs_block_t tail[2] = {m->tail[0], m->tail[1]};
+    bool split = m->split;
+    for (int i = 0; i < count; i++) {
+        if (attrs[i].type == LOGFS_ATTR_TAIL) {
+            const uint8_t *data = (const uint8_t *)attrs[i].data;
+            split = data[0] != 0;
+            tail[0] = logfs_fromle32(&data[4]);
+            tail[1] = logfs_fromle32(&data[8]);
+        }
+    }
+
+    // count the blocks the entries take
+    struct logfs_pack pack = {0, 0, -1, NULL};
+    int err = logfs_mdir_pack(lfs, m, attrs, count, &pack);
+    if (err) {
+        return err;
+    }
+
+    // What does not fit goes to new pairs continuing the directory, they
+    // are written first, the last one first, so nothing refers to them
+    // until the compaction of this pair
+    for (int i = pack.block; i > 0; i--) {
+        logfs_block_t pair[2];
+        err = logfs_mdir_split(lfs, pair, m, attrs, count, i, tail, split);
+        if (err) {
+            return err;
+        }
+
+        tail[0] = pair[0];
+        tail[1] = pair[1];
+        split = true;
+    }
+
+    logfs_block_t pair[2] = {m->pair[0], m->pair[1]};
+    struct logfs_commit commit;
+    err = logfs_mdir_write(lfs, m->pair[1], m->rev + 1, m, attrs, count, 0,
+            tail, split, &commit);
+    if (err) {
+        return err;
+    }
+
+    m->pair[0] = pair[1];
+    m->pair[1] = pair[0];
+    m->rev += 1;
+    m->off = commit.off;
+    m->crc = commit.crc;
+    m->tail[0] = tail[0];
+    m->tail[1] = tail[1];
+    m->split = split;
+    m->erased = true;
+    logfs_dir_notify(lfs, pair, m, true);
+    return 0;
+}
+
+static int logfs_mdir_commit(logfs_t *lfs, logfs_mdir_t *m,
+        const struct logfs_attr *attrs, int count)
+{
+    const struct logfs_config *cfg = lfs->cfg;
+    logfs_size_t size = 0;
+    for (int i = 0; i < count; i++) {
+        size += LOGFS_ATTR_SIZE(attrs[i].nlen, attrs[i].dlen);
+    }
+
+    logfs_size_t align = logfs_max(cfg->prog_size, 4);
+    if (!m->erased || logfs_alignup(m->off + size + 8, align) > cfg->block_size) {
+        return logfs_mdir_compact(lfs, m, attrs, count);
+    }
+
+    struct logfs_commit commit = {m->pair[0], m->off, m->crc};
+    int err = 0;
+    for (int i = 0; i < count && !err; i++) {
+        err = logfs_commit_attr(lfs, &commit, &attrs[i]);
+    }
+    if (!err) {
+        err = logfs_commit_crc(lfs, &commit);
+    }
+    if (err) {
+        // what was programmed must not be programmed again
+        lfs->pcache.block = LOGFS_BLOCK_NULL;
+        m->erased = false;
+        return err;
+    }
+
+    for (int i = 0; i < count; i++) {
+        if (attrs[i].type == LOGFS_ATTR_TAIL) {
+            const uint8_t *data = (const uint8_t *)attrs[i].data;
+            m->split = data[0] != 0;
+            m->tail[0] = logfs_fromle32(&data[4]);
+            m->tail[1] = logfs_fromle32(&data[8]);
+        }
+    }
+
+    m->off = commit.off;
+    m->crc = commit.crc;
+    logfs_dir_notify(lfs, m->pair, m, false);
+    return 0;
+}
+
+static int logfs_alloc(logfs_t *lfs, logfs_block_t *block);
+
+static int logfs_mdir_split(logfs_t *lfs, logfs_block_t pair[2],
+        const logfs_mdir_t *m, const struct logfs_attr *attrs, int count,
+        int target, const logfs_block_t tail[2], bool split)
+{
+    for (int i = 0; i < 2; i++) {
+        int err = logfs_alloc(lfs, &pair[i]);
+        if (err) {
+            return err;
+        }
+    }
+
+    uint32_t rev[2];
+    int err = logfs_mdir_revs(lfs, pair, rev);
+    if (err) {
+        return err;
+    }
+
+    // both blocks are written, the other may hold an older log
+    struct logfs_commit commit;
+    err = logfs_mdir_write(lfs, pair[1], rev[1], NULL, NULL, 0, -1,
+            tail, split, &commit);
+    if (err) {
+        return err;
+    }
+
+    return logfs_mdir_write(lfs, pair[0], rev[0], m, attrs, count, target,
+            tail, split, &commit);
+}
+
+
+/// Allocation ///
+typedef int (*logfs_traverse_cb)(logfs_t *lfs, void *data, logfs_block_t block);
+
+// Index and offset in its block of a position in a file
+static logfs_off_t logfs_ctz_start(logfs_t *lfs, logfs_size_t index)
+{
+    if (index == 0) {
+        return 0;
+    }
+
+    // each block n after the first starts with ctz(n)+1 pointers
+    return lfs->cfg->block_size*index
+        - 4*(2*(index - 1) - logfs_popc(index - 1));
+}
+
+static logfs_size_t logfs_ctz_skips(logfs_size_t index)
+{
+    return index == 0 ? 0 : logfs_ctz(index) + 1;
+}
+
+static logfs_size_t logfs_ctz_index(logfs_t *lfs, logfs_off_t *off)
+{
+    logfs_off_t pos = *off;
+    logfs_size_t index = pos / (lfs->cfg->block_size - 8);
+    while (index > 0 && logfs_ctz_start(lfs, index) > pos) {
+        index--;
+    }
+
+    *off = pos - logfs_ctz_start(lfs, index) + 4*logfs_ctz_skips(index);
+    return index;
+}
+
+// Find block target of the list ending with block index
+static int logfs_ctz_find(logfs_t *lfs, const logfs_cache_t *pcache,
+        logfs_block_t head, logfs_size_t index, logfs_size_t target,
+        logfs_block_t *block)
+{
+    while (index > target) {
+        logfs_size_t skip = logfs_min(logfs_log2(index - target),
+                logfs_ctz(index));
+        uint8_t buffer[4];
+        int err = logfs_bd_read(lfs, pcache, head, 4*skip, buffer, sizeof(buffer));
+        if (err) {
+            return err;
+        }
+
+        head = logfs_fromle32(buffer);
+        index -= 1 << skip;
+    }
+
+    *block = head;
+    return 0;
+}
+
+// Start block index+1 after head, writing its pointers
+static int logfs_ctz_extend(logfs_t *lfs, logfs_cache_t *pcache,
+        logfs_block_t head, logfs_size_t index, logfs_block_t *block)
+{
+    logfs_block_t nblock;
+    int err = logfs_alloc(lfs, &nblock);
+    if (err) {
+        return err;
+    }
+
+    // pointer k of block n is block n-2^k, which is pointer k-1 of block
+    // n-2^(k-1)
+    logfs_size_t skips = logfs_ctz_skips(index + 1);
+    for (logfs_size_t k = 0; k < skips; k++) {
+        uint8_t buffer[4];
+        logfs_tole32(head, buffer);
+        err = logfs_bd_prog(lfs, pcache, nblock, 4*k, buffer, sizeof(buffer));
+        if (err) {
+            return err;
+        }
+
+        if (k != skips - 1) {
+            err = logfs_bd_read(lfs, pcache, head, 4*k, buffer, sizeof(buffer));
+            if (err) {
+                return err;
+            }
+            head = logfs_fromle32(buffer);
+        }
+    }
+
+    *block = nblock;
+    return 0;
+}
+
+static int logfs_ctz_traverse(logfs_t *lfs, const logfs_cache_t *pcache,
+        logfs_block_t head, logfs_size_t index, logfs_traverse_cb cb, void *data)
+{
+    while (true) {
+        int err = cb(lfs, data, head);
+        if (err || index == 0) {
+            return err;
+        }
+
+        uint8_t buffer[4];
+        err = logfs_bd_read(lfs, pcache, head, 0, buffer, sizeof(buffer));
+        if (err) {
+            return err;
+        }
+
+        head = logfs_fromle32(buffer);
+        index -= 1;
+    }
+}
+
+// Index of the block a file is writing
+static logfs_size_t logfs_file_index(logfs_t *lfs, const logfs_file_t *file)
+{
+    logfs_off_t off = file->pos;
+    logfs_size_t index = logfs_ctz_index(lfs, &off);
+    return file->off == lfs->cfg->block_size ? index - 1 : index;
+}
+
+// Visit the blocks in use, following the thread of directories
+static int logfs_traverse(logfs_t *lfs, logfs_traverse_cb cb, void *data)
+{
+    logfs_block_t pair[2] = {lfs->root[0], lfs->root[1]};
+    logfs_size_t count = 0;
+
+    while (!logfs_pair_isnull(pair)) {
+        if (count++ > lfs->cfg->block_count/2) {
+            return LOGFS_ERR_CORRUPT;
+        }
+
+        for (int i = 0; i < 2; i++) {
+            int err = cb(lfs, data, pair[i]);
+            if (err) {
+                return err;
+            }
+        }
+
+        logfs_mdir_t m;
+        int err = logfs_mdir_fetch(lfs, &m, pair);
+        if (err) {
+            return err;
+        }
+
+        logfs_off_t off = 4;
+        while (off < m.off) {
+            struct logfs_attr attr;
+            err = logfs_attr_get(lfs, m.pair[0], off, &attr);
+            if (err) {
+                return err;
+            }
+            off += LOGFS_ATTR_SIZE(attr.nlen, attr.dlen);
+
+            if (attr.type != LOGFS_ATTR_REG) {
+                continue;
+            }
+
+            uint8_t buffer[8];
+            err = logfs_attr_data(lfs, &attr, buffer, sizeof(buffer));
+            if (err) {
+                return err;
+            }
+
+            logfs_block_t head = logfs_fromle32(&buffer[0]);
+            logfs_off_t size = logfs_fromle32(&buffer[4]);
+            if (size == 0) {
+                continue;
+            }
+
+            bool live;
+            err = logfs_mdir_islive(lfs, &m, &attr, &live);
+            if (err) {
+                return err;
+            }
+
+            if (live) {
+                size -= 1;
+                err = logfs_ctz_traverse(lfs, NULL, head,
+                        logfs_ctz_index(lfs, &size), cb, data);
+                if (err) {
+                    return err;
+                }
+            }
+        }
+
+        pair[0] = m.tail[0];
+        pair[1] = m.tail[1];
+    }
+
+    // and the blocks open files have not committed yet
+    for (logfs_file_t *f = lfs->files; f; f = f->next) {
+        if (f->size > 0 && f->head != LOGFS_BLOCK_NULL) {
+            logfs_off_t size = f->size - 1;
+            int err = logfs_ctz_traverse(lfs, NULL, f->head,
+                    logfs_ctz_index(lfs, &size), cb, data);
+            if (err) {
+                return err;
+            }
+        }
+
+        if (f->flags & LOGFS_F_WRITING) {
+            int err = logfs_ctz_traverse(lfs, &f->cache, f->block,
+                    logfs_file_index(lfs, f), cb, data);
+            if (err) {
+                return err;
+            }
+        }
+    }
+
+    return 0;
+}
+
+static int logfs_alloc_lookahead(logfs_t *lfs, void *data, logfs_block_t block)
+{
+    (void)data;
+    logfs_block_t off = (block + lfs->cfg->block_count - lfs->free.start)
+        % lfs->cfg->block_count;
+    if (off < lfs->free.size) {
+        lfs->free.buffer[off / 32] |= 1U << (off % 32);
+    }
+
+    return 0;
+}
+
+// Find a free block and erase it. The window moves on once its blocks are
+// taken, and each block is considered once per operation, so a block
+// taken and not yet referenced is not taken again.
+static int logfs_alloc(logfs_t *lfs, logfs_block_t *block)
+{
+    while (true) {
+        while (lfs->free.off < lfs->free.size) {
+            if (lfs->free.ack == 0) {
+                return LOGFS_ERR_NOSPC;
+            }
+
+            logfs_size_t off = lfs->free.off++;
+            lfs->free.ack -= 1;
+            if (!(lfs->free.buffer[off / 32] & (1U << (off % 32)))) {
+                *block = (lfs->free.start + off) % lfs->cfg->block_count;
+                return logfs_bd_erase(lfs, *block);
+            }
+        }
+
+        if (lfs->free.ack == 0) {
+            return LOGFS_ERR_NOSPC;
+        }
+
+        lfs->free.start = (lfs->free.start + lfs->free.size)
+            % lfs->cfg->block_count;
+        lfs->free.off = 0;
+        memset(lfs->free.buffer, 0, lfs->cfg->lookahead / 8);
+        int err = logfs_traverse(lfs, logfs_alloc_lookahead, NULL);
+        if (err) {
+            lfs->free.off = lfs->free.size;
+            return err;
+        }
+    }
+}
+
+
+/// Directories ///
+static void logfs_dir_notify(logfs_t *lfs, const logfs_block_t pair[2],
+        const logfs_mdir_t *m, bool compacted)
+{
+    for (logfs_dir_t *d = lfs->dirs; d; d = d->next) {
+        if (logfs_pair_eq(d->m.pair, pair)) {
+            d->m = *m;
+            if (compacted) {
+                // offsets changed, the entries already read are skipped
+                d->off = 4;
+                d->skip = d->id;
+                d->id = 0;
+            }
+        }
+    }
+}
+
+// Find a name in a directory, m is left on the pair holding it, or on the
+// last pair of the directory if there is none
+static int logfs_dir_find(logfs_t *lfs, const logfs_block_t head[2],
+        const char *name, logfs_size_t nlen, logfs_mdir_t *m,
+        struct logfs_entry *entry)
+{
+    int err = logfs_mdir_fetch(lfs, m, head);
+    if (err) {
+        return err;
+    }
+
+    logfs_size_t count = 0;
+    while (true) {
+        err = nlen ? logfs_mdir_find(lfs, m, name, nlen, entry) : LOGFS_ERR_NOENT;
+        if (err != LOGFS_ERR_NOENT || !m->split) {
+            return err;
+        }
+
+        if (count++ > lfs->cfg->block_count/2) {
+            return LOGFS_ERR_CORRUPT;
+        }
+
+        logfs_block_t tail[2] = {m->tail[0], m->tail[1]};
+        err = logfs_mdir_fetch(lfs, m, tail);
+        if (err) {
+            return err;
+        }
+    }
+}
+
+// Find the entry a path names. dir is set to the first pair of its
+// directory and name to its last component. A missing last component
+// returns LOGFS_ERR_NOENT with name set, for creating the entry in m.
+static int logfs_lookup(logfs_t *lfs, const char *path, logfs_block_t dir[2],
+        logfs_mdir_t *m, struct logfs_entry *entry,
+        const char **name, logfs_size_t *nlen)
+{
+    const char *p = path;
+    entry->type = LOGFS_TYPE_DIR;
+    entry->u[0] = lfs->root[0];
+    entry->u[1] = lfs->root[1];
+    entry->attr.block = LOGFS_BLOCK_NULL;
+    dir[0] = lfs->root[0];
+    dir[1] = lfs->root[1];
+    *name = NULL;
+    *nlen = 0;
+
+    while (true) {
+    next:
+        p += strspn(p, "/");
+        logfs_size_t len = strcspn(p, "/");
+        if (len == 0) {
+            return 0;
+        }
+
+        if ((len == 1 && memcmp(p, ".", 1) == 0)
+                || (len == 2 && memcmp(p, "..", 2) == 0)) {
+            p += len;
+            continue;
+        }
+
+        // skip names followed by a '..' that cancels them
+        const char *suffix = p + len;
+        int depth = 1;
+        while (true) {
+            suffix += strspn(suffix, "/");
+            logfs_size_t slen = strcspn(suffix, "/");
+            if (slen == 0) {
+                break;
+            }
+
+            if (slen == 2 && memcmp(suffix, "..", 2) == 0) {
+                depth -= 1;
+                if (depth == 0) {
+                    p = suffix + slen;
+                    goto next;
+                }
+            } else if (!(slen == 1 && memcmp(suffix, ".", 1) == 0)) {
+                depth += 1;
+            }
+
+            suffix += slen;
+        }
+
+        if (entry->type != LOGFS_TYPE_DIR) {
+            *name = NULL;
+            return LOGFS_ERR_NOTDIR;
+        }
+
+        if (len > LOGFS_NAME_MAX) {
+            *name = NULL;
+            return LOGFS_ERR_NAMETOOLONG;
+        }
+
+        dir[0] = entry->u[0];
+        dir[1] = entry->u[1];
+        *name = p;
+        *nlen = len;
+        int err = logfs_dir_find(lfs, dir, p, len, m, entry);
+        p += len;
+        if (err) {
+            // only the last component can be created
+            if (err != LOGFS_ERR_NOENT || p[strspn(p, "/")] != '\0') {
+                *name = NULL;
+            }
+            return err;
+        }
+    }
+}
+
+// Check that no entry is in use in a directory
+static int logfs_dir_isempty(logfs_t *lfs, const logfs_block_t head[2],
+        logfs_mdir_t *m, bool *empty)
+{
+    int err = logfs_mdir_fetch(lfs, m, head);
+    if (err) {
+        return err;
+    }
+
+    *empty = true;
+    while (true) {
+        logfs_off_t off = 4;
+        while (off < m->off) {
+            struct logfs_attr attr;
+            err = logfs_attr_get(lfs, m->pair[0], off, &attr);
+            if (err) {
+                return err;
+            }
+            off += LOGFS_ATTR_SIZE(attr.nlen, attr.dlen);
+
+            if (attr.type == LOGFS_ATTR_REG || attr.type == LOGFS_ATTR_DIR) {
+                bool live;
+                err = logfs_mdir_islive(lfs, m, &attr, &live);
+                if (err) {
+                    return err;
+                }
+
+                if (live) {
+                    *empty = false;
+                    return 0;
+                }
+            }
+        }
+
+        if (!m->split) {
+            return 0;
+        }
+
+        logfs_block_t tail[2] = {m->tail[0], m->tail[1]};
+        err = logfs_mdir_fetch(lfs, m, tail);
+        if (err) {
+            return err;
+        }
+    }
+}
+
+// Count the entries referring to a directory
+static int logfs_dir_refs(logfs_t *lfs, const logfs_block_t pair[2],
+        logfs_size_t *refs)
+{
+    logfs_block_t cur[2] = {lfs->root[0], lfs->root[1]};
+    logfs_size_t count = 0;
+    *refs = 0;
+
+    while (!logfs_pair_isnull(cur)) {
+        if (count++ > lfs->cfg->block_count/2) {
+            return LOGFS_ERR_CORRUPT;
+        }
+
+        logfs_mdir_t m;
+        int err = logfs_mdir_fetch(lfs, &m, cur);
+        if (err) {
+            return err;
+        }
+
+        logfs_off_t off = 4;
+        while (off < m.off) {
+            struct logfs_attr attr;
+            err = logfs_attr_get(lfs, m.pair[0], off, &attr);
+            if (err) {
+                return err;
+            }
+            off += LOGFS_ATTR_SIZE(attr.nlen, attr.dlen);
+
+            if (attr.type != LOGFS_ATTR_DIR) {
+                continue;
+            }
+
+            uint8_t buffer[8];
+            err = logfs_attr_data(lfs, &attr, buffer, sizeof(buffer));
+            if (err) {
+                return err;
+            }
+
+            logfs_block_t dpair[2] = {logfs_fromle32(&buffer[0]),
+                    logfs_fromle32(&buffer[4])};
+            if (!logfs_pair_eq(dpair, pair)) {
+                continue;
+            }
+
+            bool live;
+            err = logfs_mdir_islive(lfs, &m, &attr, &live);
+            if (err) {
+                return err;
+            }
+
+            if (live) {
+                *refs += 1;
+            }
+        }
+
+        cur[0] = m.tail[0];
+        cur[1] = m.tail[1];
+    }
+
+    return 0;
+}
+
+// Find the pair threading to a directory
+static int logfs_dir_pred(logfs_t *lfs, const logfs_block_t pair[2],
+        logfs_mdir_t *pm)
+{
+    logfs_block_t cur[2] = {lfs->root[0], lfs->root[1]};
+    logfs_size_t count = 0;
+
+    while (!logfs_pair_isnull(cur)) {
+        if (count++ > lfs->cfg->block_count/2) {
+            return LOGFS_ERR_CORRUPT;
+        }
+
+        int err = logfs_mdir_fetch(lfs, pm, cur);
+        if (err) {
+            return err;
+        }
+
+        if (logfs_pair_eq(pm->tail, pair)) {
+            return 0;
+        }
+
+        cur[0] = pm->tail[0];
+        cur[1] = pm->tail[1];
+    }
+
+    return LOGFS_ERR_CORRUPT;
+}
+
+// Tail of the last pair of a directory, the next directory of the thread
+static int logfs_dir_next(logfs_t *lfs, const logfs_block_t head[2],
+        logfs_block_t next[2])
+{
+    logfs_mdir_t m;
+    int err = logfs_mdir_fetch(lfs, &m, head);
+    if (err) {
+        return err;
+    }
+
+    logfs_size_t count = 0;
+    while (m.split) {
+        if (count++ > lfs->cfg->block_count/2) {
+            return LOGFS_ERR_CORRUPT;
+        }
+
+        logfs_block_t tail[2] = {m.tail[0], m.tail[1]};
+        err = logfs_mdir_fetch(lfs, &m, tail);
+        if (err) {
+            return err;
+        }
+    }
+
+    next[0] = m.tail[0];
+    next[1] = m.tail[1];
+    return 0;
+}
+
+
+// Commit removing a name from m, and a directory from the thread
+static int logfs_dir_unlink(logfs_t *lfs, logfs_mdir_t *m,
+        const struct logfs_attr *attrs, int count, const logfs_block_t dir[2])
+{
+    if (!dir) {
+        return logfs_mdir_commit(lfs, m, attrs, count);
+    }
+
+    logfs_block_t next[2];
+    logfs_mdir_t pm;
+    int err = logfs_dir_next(lfs, dir, next);
+    if (!err) {
+        err = logfs_dir_pred(lfs, dir, &pm);
+    }
+    if (err) {
+        return err;
+    }
+
+    struct logfs_attr nattrs[3];
+    uint8_t data[12];
+    memcpy(nattrs, attrs, count*sizeof(*attrs));
+    logfs_tail_attr(&nattrs[count], data, next, false);
+
+    // in one commit if the pair before the directory is m, or else the
+    // entry is removed first, leaving an orphan if interrupted
+    if (logfs_pair_eq(pm.pair, m->pair)) {
+        return logfs_mdir_commit(lfs, m, nattrs, count + 1);
+    }
+
+    err = logfs_mdir_commit(lfs, m, attrs, count);
+    if (err) {
+        return err;
+    }
+
+    logfs_block_t pair[2] = {pm.pair[0], pm.pair[1]};
+    err = logfs_mdir_fetch(lfs, &pm, pair);
+    if (err) {
+        return err;
+    }
+
+    return logfs_mdir_commit(lfs, &pm, &nattrs[count], 1);
+}
+
+// Remove the directories left in the thread by an interrupted removal
+static int logfs_deorphan(logfs_t *lfs)
+{
+    logfs_mdir_t pm;
+    int err = logfs_mdir_fetch(lfs, &pm, lfs->root);
+    if (err) {
+        return err;
+    }
+
+    logfs_size_t count = 0;
+    while (!logfs_pair_isnull(pm.tail)) {
+        if (count++ > lfs->cfg->block_count) {
+            return LOGFS_ERR_CORRUPT;
+        }
+
+        if (!pm.split) {
+            logfs_size_t refs;
+            err = logfs_dir_refs(lfs, pm.tail, &refs);
+            if (err) {
+                return err;
+            }
+
+            if (refs == 0) {
+                logfs_block_t next[2];
+                err = logfs_dir_next(lfs, pm.tail, next);
+                if (err) {
+                    return err;
+                }
+
+                struct logfs_attr attr;
+                uint8_t data[12];
+                logfs_tail_attr(&attr, data, next, false);
+                err = logfs_mdir_commit(lfs, &pm, &attr, 1);
+                if (err) {
+                    return err;
+                }
+                continue;
+            }
+        }
+
+        logfs_block_t tail[2] = {pm.tail[0], pm.tail[1]};
+        err = logfs_mdir_fetch(lfs, &pm, tail);
+        if (err) {
+            return err;
+        }
+    }
+
+    return 0;
+}
+
+// Start an operation that writes
+static int logfs_begin(logfs_t *lfs)
+{
+    lfs->free.ack = lfs->cfg->block_count;
+    if (!lfs->deorphaned) {
+        lfs->deorphaned = true;
+        int err = logfs_deorphan(lfs);
+        if (err) {
+            lfs->deorphaned = false;
+            return err;
+        }
+    }
+
+    return 0;
+}
+
+// Open files of a name no longer commit to it
+static void logfs_file_orphan(logfs_t *lfs, const logfs_block_t dir[2],
+        const char *name, logfs_size_t nlen)
+{
+    for (logfs_file_t *f = lfs->files; f; f = f->next) {
+        if (logfs_pair_eq(f->dir, dir) && strlen(f->name) == nlen
+                && memcmp(f->name, name, nlen) == 0) {
+            f->name[0] = '\0';
+        }
+    }
+}
+
+int logfs_mkdir(logfs_t *lfs, const char *path)
+{
+    int err = logfs_begin(lfs);
+    if (err) {
+        return err;
+    }
+
+    logfs_block_t dir[2];
+    logfs_mdir_t m;
+    struct logfs_entry entry;
+    const char *name;
+    logfs_size_t nlen;
+    err = logfs_lookup(lfs, path, dir, &m, &entry, &name, &nlen);
+    if (err != LOGFS_ERR_NOENT || !name) {
+        return err ? err : LOGFS_ERR_EXIST;
+    }
+
+    // the directory is threaded after the last pair of its parent, which
+    // its entry is committed to along with the tail
+    logfs_block_t pair[2];
+    err = logfs_mdir_split(lfs, pair, NULL, NULL, 0, -1, m.tail, false);
+    if (err) {
+        return err;
+    }
+
+    uint8_t data[8];
+    logfs_tole32(pair[0], &data[0]);
+    logfs_tole32(pair[1], &data[4]);
+    struct logfs_attr attrs[2] = {
+        {LOGFS_ATTR_DIR, (uint8_t)nlen, sizeof(data), name, data, LOGFS_BLOCK_NULL, 0},
+    };
+    uint8_t tdata[12];
+    logfs_tail_attr(&attrs[1], tdata, pair, false);
+
+    err = logfs_mdir_commit(lfs, &m, attrs, 2);
+    if (err) {
+        return err;
+    }
+
+    return logfs_bd_sync(lfs);
+}
+
+int logfs_remove(logfs_t *lfs, const char *path)
+{
+    int err = logfs_begin(lfs);
+    if (err) {
+        return err;
+    }
+
+    logfs_block_t dir[2];
+    logfs_mdir_t m;
+    struct logfs_entry entry;
+    const char *name;
+    logfs_size_t nlen;
+    err = logfs_lookup(lfs, path, dir, &m, &entry, &name, &nlen);
+    if (err) {
+        return err;
+    }
+
+    if (!name) {
+        return LOGFS_ERR_INVAL;
+    }
+
+    // A directory must be empty. It leaves the thread unless another
+    // entry, left by an interrupted rename, still refers to it.
+    bool unthread = false;
+    if (entry.type == LOGFS_TYPE_DIR) {
+        logfs_mdir_t dm;
+        bool empty;
+        err = logfs_dir_isempty(lfs, entry.u, &dm, &empty);
+        if (err) {
+            return err;
+        }
+
+        if (!empty) {
+            return LOGFS_ERR_NOTEMPTY;
+        }
+
+        logfs_size_t refs;
+        err = logfs_dir_refs(lfs, entry.u, &refs);
+        if (err) {
+            return err;
+        }
+        unthread = refs <= 1;
+    }
+
+    struct logfs_attr attr = {LOGFS_ATTR_DEL, (uint8_t)nlen, 0,
+            name, NULL, LOGFS_BLOCK_NULL, 0};
+    err = logfs_dir_unlink(lfs, &m, &attr, 1, unthread ? entry.u : NULL);
+    if (err) {
+        return err;
+    }
+
+    logfs_file_orphan(lfs, dir, name, nlen);
+    return logfs_bd_sync(lfs);
+}
+
+int logfs_rename(logfs_t *lfs, const char *oldpath, const char *newpath)
+{
+    int err = logfs_begin(lfs);
+    if (err) {
+        return err;
+    }
+
+    logfs_block_t olddir[2];
+    logfs_mdir_t oldm;
+    struct logfs_entry oldentry;
+    const char *oldname;
+    logfs_size_t oldlen;
+    err = logfs_lookup(lfs, oldpath, olddir, &oldm, &oldentry, &oldname, &oldlen);
+    if (err) {
+        return err;
+    }
+
+    if (!oldname) {
+        return LOGFS_ERR_INVAL;
+    }
+
+    logfs_block_t newdir[2];
+    logfs_mdir_t newm;
+    struct logfs_entry newentry;
+    const char *newname;
+    logfs_size_t newlen;
+    err = logfs_lookup(lfs, newpath, newdir, &newm, &newentry, &newname, &newlen);
+    if (err && !(err == LOGFS_ERR_NOENT && newname)) {
+        return err;
+    }
+
+    if (!newname) {
+        return LOGFS_ERR_INVAL;
+    }
+
+    // A replaced directory must be empty, and leaves the thread
+    bool replaced = !err;
+    bool unthread = false;
+    if (replaced) {
+        if (logfs_pair_eq(oldm.pair, newm.pair)
+                && oldentry.attr.off == newentry.attr.off) {
+            return 0;
+        }
+
+        if (newentry.type == LOGFS_TYPE_DIR) {
+            if (oldentry.type != LOGFS_TYPE_DIR) {
+                return LOGFS_ERR_ISDIR;
+            }
+
+            logfs_mdir_t dm;
+            bool empty;
+            err = logfs_dir_isempty(lfs, newentry.u, &dm, &empty);
+            if (err) {
+                return err;
+            }
+
+            if (!empty) {
+                return LOGFS_ERR_NOTEMPTY;
+            }
+
+            logfs_size_t refs;
+            err = logfs_dir_refs(lfs, newentry.u, &refs);
+            if (err) {
+                return err;
+            }
+            unthread = refs <= 1;
+        } else if (oldentry.type == LOGFS_TYPE_DIR) {
+            return LOGFS_ERR_NOTDIR;
+        }
+    }
+
+    uint8_t data[8];
+    logfs_tole32(oldentry.u[0], &data[0]);
+    logfs_tole32(oldentry.u[1], &data[4]);
+    struct logfs_attr attrs[2] = {
+        {oldentry.type, (uint8_t)newlen, sizeof(data), newname, data, LOGFS_BLOCK_NULL, 0},
+        {LOGFS_ATTR_DEL, (uint8_t)oldlen, 0, oldname, NULL, LOGFS_BLOCK_NULL, 0},
+    };
+
+    // Atomic within a pair. Between pairs the new name is committed first,
+    // so an interrupted rename leaves the entry under both names.
+    if (logfs_pair_eq(oldm.pair, newm.pair)) {
+        err = logfs_dir_unlink(lfs, &newm, attrs, 2,
+                unthread ? newentry.u : NULL);
+        if (err) {
+            return err;
+        }
+    } else {
+        err = logfs_dir_unlink(lfs, &newm, attrs, 1,
+                unthread ? newentry.u : NULL);
+        if (err) {
+            return err;
+        }
+
+        err = logfs_dir_find(lfs, olddir, oldname, oldlen, &oldm, &oldentry);
+        if (err) {
+            return err;
+        }
+
+        err = logfs_mdir_commit(lfs, &oldm, &attrs[1], 1);
+        if (err) {
+            return err;
+        }
+    }
+
+    // open files follow the entry
+    logfs_file_orphan(lfs, newdir, newname, newlen);
+    for (logfs_file_t *f = lfs->files; f; f = f->next) {
+        if (logfs_pair_eq(f->dir, olddir) && strlen(f->name) == oldlen
+                && memcmp(f->name, oldname, oldlen) == 0) {
+            f->dir[0] = newdir[0];
+            f->dir[1] = newdir[1];
+            memcpy(f->name, newname, newlen);
+            f->name[newlen] = '\0';
+        }
+    }
+
+    return logfs_bd_sync(lfs);
+}
+
+int logfs_stat(logfs_t *lfs, const char *path, struct logfs_info *info)
+{
+    logfs_block_t dir[2];
+    logfs_mdir_t m;
+    struct logfs_entry entry;
+    const char *name;
+    logfs_size_t nlen;
+    int err = logfs_lookup(lfs, path, dir, &m, &entry, &name, &nlen);
+    if (err) {
+        return err;
+    }
+
+    info->type = entry.type;
+    info->size = entry.type == LOGFS_TYPE_REG ? entry.u[1] : 0;
+    if (!name) {
+        strcpy(info->name, "/");
+    } else {
+        memcpy(info->name, name, nlen);
+        info->name[nlen] = '\0';
+    }
+
+    return 0;
+}
+
+int logfs_dir_open(logfs_t *lfs, logfs_dir_t *dir, const char *path)
+{
+    logfs_block_t parent[2];
+    logfs_mdir_t m;
+    struct logfs_entry entry;
+    const char *name;
+    logfs_size_t nlen;
+    int err = logfs_lookup(lfs, path, parent, &m, &entry, &name, &nlen);
+    if (err) {
+        return err;
+    }
+
+    if (entry.type != LOGFS_TYPE_DIR) {
+        return LOGFS_ERR_NOTDIR;
+    }
+
+    dir->head[0] = entry.u[0];
+    dir->head[1] = entry.u[1];
+    err = logfs_dir_rewind(lfs, dir);
+    if (err) {
+        return err;
+    }
+
+    dir->next = lfs->dirs;
+    lfs->dirs = dir;
+    return 0;
+}
+
+int logfs_dir_close(logfs_t *lfs, logfs_dir_t *dir)
+{
+    for (logfs_dir_t **p = &lfs->dirs; *p; p = &(*p)->next) {
+        if (*p == dir) {
+            *p = dir->next;
+            break;
+        }
+    }
+
+    return 0;
+}
+
+int logfs_dir_read(logfs_t *lfs, logfs_dir_t *dir, struct logfs_info *info)
+{
+    memset(info, 0, sizeof(*info));
+    if (dir->pos < 2) {
+        info->type = LOGFS_TYPE_DIR;
+        strcpy(info->name, dir->pos == 0 ? "." : "..");
+        dir->pos += 1;
+        return 1;
+    }
+
+    logfs_size_t count = 0;
+    while (true) {
+        if (dir->off >= dir->m.off) {
+            if (!dir->m.split) {
+                return 0;
+            }
+
+            if (count++ > lfs->cfg->block_count/2) {
+                return LOGFS_ERR_CORRUPT;
+            }
+
+            logfs_block_t tail[2] = {dir->m.tail[0], dir->m.tail[1]};
+            int err = logfs_mdir_fetch(lfs, &dir->m, tail);
+            if (err) {
+                return err;
+            }
+
+            dir->off = 4;
+            dir->id = 0;
+            dir->skip = 0;
+            continue;
+        }
+
+        struct logfs_attr attr;
+        int err = logfs_attr_get(lfs, dir->m.pair[0], dir->off, &attr);
+        if (err) {
+            return err;
+        }
+        dir->off += LOGFS_ATTR_SIZE(attr.nlen, attr.dlen);
+
+        if (attr.type != LOGFS_ATTR_REG && attr.type != LOGFS_ATTR_DIR) {
+            continue;
+        }
+
+        bool live;
+        err = logfs_mdir_islive(lfs, &dir->m, &attr, &live);
+        if (err) {
+            return err;
+        }
+
+        if (!live) {
+            continue;
+        }
+
+        dir->id += 1;
+        if (dir->skip > 0) {
+            dir->skip -= 1;
+            continue;
+        }
+
+        uint8_t data[8];
+        err = logfs_attr_data(lfs, &attr, data, sizeof(data));
+        if (!err) {
+            err = logfs_bd_read(lfs, NULL, attr.block, attr.off + 4,
+                    info->name, attr.nlen);
+        }
+        if (err) {
+            return err;
+        }
+
+        info->name[attr.nlen] = '\0';
+        info->type = attr.type;
+        info->size = attr.type == LOGFS_ATTR_REG ? logfs_fromle32(&data[4]) : 0;
+        dir->pos += 1;
+        return 1;
+    }
+}
+
+int logfs_dir_seek(logfs_t *lfs, logfs_dir_t *dir, logfs_off_t off)
+{
+    int err = logfs_dir_rewind(lfs, dir);
+    if (err) {
+        return err;
+    }
+
+    struct logfs_info info;
+    while (dir->pos < off) {
+        int res = logfs_dir_read(lfs, dir, &info);
+        if (res <= 0) {
+            return res;
+        }
+    }
+
+    return 0;
+}
+
+logfs_soff_t logfs_dir_tell(logfs_t *lfs, logfs_dir_t *dir)
+{
+    (void)lfs;
+    return dir->pos;
+}
+
+int logfs_dir_rewind(logfs_t *lfs, logfs_dir_t *dir)
+{
+    int err = logfs_mdir_fetch(lfs, &dir->m, dir->head);
+    if (err) {
+        return err;
+    }
+
+    dir->off = 4;
+    dir->id = 0;
+    dir->skip = 0;
+    dir->pos = 0;
+    return 0;
+}
+
+
+/// Files ///
+int logfs_file_open(logfs_t *lfs, logfs_file_t *file,
+        const char *path, int flags)
+{
+    if ((flags & LOGFS_O_WRONLY) || (flags & LOGFS_O_CREAT)) {
+        int err = logfs_begin(lfs);
+        if (err) {
+            return err;
+        }
+    }
+
+    logfs_mdir_t m;
+    struct logfs_entry entry;
+    const char *name;
+    logfs_size_t nlen;
+    int err = logfs_lookup(lfs, path, file->dir, &m, &entry, &name, &nlen);
+    if (err && !(err == LOGFS_ERR_NOENT && name)) {
+        return err;
+    }
+
+    if (err == LOGFS_ERR_NOENT) {
+        if (!(flags & LOGFS_O_CREAT)) {
+            return LOGFS_ERR_NOENT;
+        }
+
+        // the entry is created empty
+        uint8_t data[8];
+        logfs_tole32(LOGFS_BLOCK_NULL, &data[0]);
+        logfs_tole32(0, &data[4]);
+        struct logfs_attr attr = {LOGFS_ATTR_REG, (uint8_t)nlen, sizeof(data),
+                name, data, LOGFS_BLOCK_NULL, 0};
+        err = logfs_mdir_commit(lfs, &m, &attr, 1);
+        if (err) {
+            return err;
+        }
+
+        entry.type = LOGFS_TYPE_REG;
+        entry.u[0] = LOGFS_BLOCK_NULL;
+        entry.u[1] = 0;
+    } else if (entry.type == LOGFS_TYPE_DIR) {
+        return LOGFS_ERR_ISDIR;
+    } else if ((flags & LOGFS_O_CREAT) && (flags & LOGFS_O_EXCL)) {
+        return LOGFS_ERR_EXIST;
+    }
+
+    file->cache.buffer = (uint8_t *)malloc(lfs->cfg->cache_size);
+    if (!file->cache.buffer) {
+        return LOGFS_ERR_NOMEM;
+    }
+
+    memcpy(file->name, name, nlen);
+    file->name[nlen] = '\0';
+    file->head = entry.u[0];
+    file->size = entry.u[1];
+    file->flags = flags;
+    file->pos = 0;
+    file->block = LOGFS_BLOCK_NULL;
+    file->off = 0;
+    file->cache.block = LOGFS_BLOCK_NULL;
+    file->cache.off = 0;
+    file->cache.size = 0;
+
+    if ((flags & LOGFS_O_TRUNC) && (flags & LOGFS_O_WRONLY) && file->size > 0) {
+        file->head = LOGFS_BLOCK_NULL;
+        file->size = 0;
+        file->flags |= LOGFS_F_DIRTY;
+    }
+
+    file->next = lfs->files;
+    lfs->files = file;
+    return 0;
+}
+
+int logfs_file_close(logfs_t *lfs, logfs_file_t *file)
+{
+    int err = logfs_file_sync(lfs, file);
+
+    for (logfs_file_t **p = &lfs->files; *p; p = &(*p)->next) {
+        if (*p == file) {
+            *p = file->next;
+            break;
+        }
+    }
+
+    free(file->cache.buffer);
+    file->cache.buffer = NULL;
+    return err;
+}
+
+static logfs_ssize_t logfs_file_read_raw(logfs_t *lfs, logfs_file_t *file,
+        void *buffer, logfs_size_t size)
+{
+    uint8_t *data = (uint8_t *)buffer;
+    if (file->pos >= file->size) {
+        return 0;
+    }
+
+    size = logfs_min(size, file->size - file->pos);
+    logfs_size_t nsize = size;
+    while (nsize > 0) {
+        if (!(file->flags & LOGFS_F_READING)
+                || file->off == lfs->cfg->block_size) {
+            logfs_off_t last = file->size - 1;
+            logfs_size_t head = logfs_ctz_index(lfs, &last);
+            logfs_off_t off = file->pos;
+            logfs_size_t index = logfs_ctz_index(lfs, &off);
+            int err = logfs_ctz_find(lfs, NULL, file->head, head, index,
+                    &file->block);
+            if (err) {
+                return err;
+            }
+
+            file->off = off;
+            file->flags |= LOGFS_F_READING;
+        }
+
+        logfs_size_t diff = logfs_min(nsize, lfs->cfg->block_size - file->off);
+        int err = logfs_bd_read(lfs, NULL, file->block, file->off, data, diff);
+        if (err) {
+            return err;
+        }
+
+        file->pos += diff;
+        file->off += diff;
+        data += diff;
+        nsize -= diff;
+    }
+
+    return size;
+}
+
+// Start a copy of the block at the position of a file
+static int logfs_file_begin(logfs_t *lfs, logfs_file_t *file)
+{
+    logfs_off_t off = file->pos;
+    logfs_size_t index = logfs_ctz_index(lfs, &off);
+    logfs_size_t head = 0;
+    if (file->size > 0) {
+        logfs_off_t last = file->size - 1;
+        head = logfs_ctz_index(lfs, &last);
+    }
+
+    logfs_block_t block;
+    int err;
+    if (index == 0) {
+        err = logfs_alloc(lfs, &block);
+    } else {
+        logfs_block_t prev;
+        err = logfs_ctz_find(lfs, NULL, file->head, head, index - 1, &prev);
+        if (!err) {
+            err = logfs_ctz_extend(lfs, &file->cache, prev, index - 1, &block);
+        }
+    }
+    if (err) {
+        return err;
+    }
+
+    // with the data before the position
+    logfs_off_t start = 4*logfs_ctz_skips(index);
+    if (off > start) {
+        logfs_block_t old;
+        err = logfs_ctz_find(lfs, NULL, file->head, head, index, &old);
+        if (err) {
+            return err;
+        }
+
+        uint8_t chunk[16];
+        for (logfs_off_t i = start; i < off; i += sizeof(chunk)) {
+            logfs_size_t diff = logfs_min(off - i, sizeof(chunk));
+            err = logfs_bd_read(lfs, NULL, old, i, chunk, diff);
+            if (!err) {
+                err = logfs_bd_prog(lfs, &file->cache, block, i, chunk, diff);
+            }
+            if (err) {
+                return err;
+            }
+        }
+    }
+
+    file->block = block;
+    file->off = off;
+    file->flags |= LOGFS_F_WRITING;
+    return 0;
+}
+
+static logfs_ssize_t logfs_file_write_raw(logfs_t *lfs, logfs_file_t *file,
+        const void *buffer, logfs_size_t size)
+{
+    const uint8_t *data = (const uint8_t *)buffer;
+    logfs_size_t nsize = size;
+
+    while (nsize > 0) {
+        int err = 0;
+        if (!(file->flags & LOGFS_F_WRITING)) {
+            err = logfs_file_begin(lfs, file);
+        } else if (file->off == lfs->cfg->block_size) {
+            logfs_size_t index = logfs_file_index(lfs, file);
+            err = logfs_ctz_extend(lfs, &file->cache, file->block, index,
+                    &file->block);
+            file->off = 4*logfs_ctz_skips(index + 1);
+        }
+        if (err) {
+            return err;
+        }
+
+        logfs_size_t diff = logfs_min(nsize, lfs->cfg->block_size - file->off);
+        err = logfs_bd_prog(lfs, &file->cache, file->block, file->off, data, diff);
+        if (err) {
+            return err;
+        }
+
+        file->pos += diff;
+        file->off += diff;
+        data += diff;
+        nsize -= diff;
+    }
+
+    file->flags |= LOGFS_F_DIRTY;
+    return size;
+}
+
+static int logfs_file_flush(logfs_t *lfs, logfs_file_t *file)
+{
+    file->flags &= ~LOGFS_F_READING;
+
+    if (file->flags & LOGFS_F_WRITING) {
+        logfs_off_t pos = file->pos;
+
+        // the rest of the file is copied after what was written
+        if (file->pos < file->size) {
+            logfs_file_t orig;
+            memset(&orig, 0, sizeof(orig));
+            orig.head = file->head;
+            orig.size = file->size;
+            orig.pos = file->pos;
+
+            while (file->pos < file->size) {
+                uint8_t chunk[16];
+                logfs_ssize_t res = logfs_file_read_raw(lfs, &orig, chunk,
+                        sizeof(chunk));
+                if (res < 0) {
+                    return res;
+                }
+
+                res = logfs_file_write_raw(lfs, file, chunk, res);
+                if (res < 0) {
+                    return res;
+                }
+            }
+        }
+
+        int err = logfs_bd_flush(lfs, &file->cache);
+        if (err) {
+            return err;
+        }
+
+        file->head = file->block;
+        file->size = file->pos;
+        file->pos = pos;
+        file->flags &= ~LOGFS_F_WRITING;
+        file->flags |= LOGFS_F_DIRTY;
+    }
+
+    return 0;
+}
+
+int logfs_file_sync(logfs_t *lfs, logfs_file_t *file)
+{
+    if (file->flags & LOGFS_F_ERRED) {
+        return 0;
+    }
+
+    int err = logfs_begin(lfs);
+    if (!err) {
+        err = logfs_file_flush(lfs, file);
+    }
+    if (err) {
+        file->flags |= LOGFS_F_ERRED;
+        return err;
+    }
+
+    if (file->flags & LOGFS_F_DIRTY) {
+        logfs_mdir_t m;
+        struct logfs_entry entry;
+        logfs_size_t nlen = strlen(file->name);
+        err = logfs_dir_find(lfs, file->dir, file->name, nlen, &m, &entry);
+        if (err && err != LOGFS_ERR_NOENT) {
+            return err;
+        }
+
+        // a removed file is not committed
+        if (!err && entry.type == LOGFS_TYPE_REG) {
+            uint8_t data[8];
+            logfs_tole32(file->head, &data[0]);
+            logfs_tole32(file->size, &data[4]);
+            struct logfs_attr attr = {LOGFS_ATTR_REG, (uint8_t)nlen, sizeof(data),
+                    file->name, data, LOGFS_BLOCK_NULL, 0};
+            err = logfs_mdir_commit(lfs, &m, &attr, 1);
+            if (err) {
+                return err;
+            }
+        }
+
+        file->flags &= ~LOGFS_F_DIRTY;
+    }
+
+    return logfs_bd_sync(lfs);
+}
+
+logfs_ssize_t logfs_file_read(logfs_t *lfs, logfs_file_t *file,
+        void *buffer, logfs_size_t size)
+{
+    if ((file->flags & LOGFS_O_RDONLY) != LOGFS_O_RDONLY) {
+        return LOGFS_ERR_BADF;
+    }
+
+    if (file->flags & LOGFS_F_WRITING) {
+        logfs_begin(lfs);
+        int err = logfs_file_flush(lfs, file);
+        if (err) {
+            file->flags |= LOGFS_F_ERRED;
+            return err;
+        }
+    }
+
+    return logfs_file_read_raw(lfs, file, buffer, size);
+}
+
+logfs_ssize_t logfs_file_write(logfs_t *lfs, logfs_file_t *file,
+        const void *buffer, logfs_size_t size)
+{
+    if ((file->flags & LOGFS_O_WRONLY) != LOGFS_O_WRONLY) {
+        return LOGFS_ERR_BADF;
+    }
+
+    int err = logfs_begin(lfs);
+    if (err) {
+        return err;
+    }
+
+    file->flags &= ~LOGFS_F_READING;
+    if ((file->flags & LOGFS_O_APPEND) && !(file->flags & LOGFS_F_WRITING)) {
+        file->pos = file->size;
+    }
+
+    // a position after the end is reached with zeros
+    if (!(file->flags & LOGFS_F_WRITING) && file->pos > file->size) {
+        logfs_off_t pos = file->pos;
+        file->pos = file->size;
+        while (file->pos < pos) {
+            static const uint8_t zeros[16] = {0};
+            logfs_ssize_t res = logfs_file_write_raw(lfs, file, zeros,
+                    logfs_min(pos - file->pos, sizeof(zeros)));
+            if (res < 0) {
+                file->flags |= LOGFS_F_ERRED;
+                return res;
+            }
+        }
+    }
+
+    logfs_ssize_t res = logfs_file_write_raw(lfs, file, buffer, size);
+    if (res < 0) {
+        file->flags |= LOGFS_F_ERRED;
+    }
+    return res;
+}
+
+logfs_soff_t logfs_file_seek(logfs_t *lfs, logfs_file_t *file,
+        logfs_soff_t off, int whence)
+{
+    if (file->flags & LOGFS_F_WRITING) {
+        logfs_begin(lfs);
+        int err = logfs_file_flush(lfs, file);
+        if (err) {
+            file->flags |= LOGFS_F_ERRED;
+            return err;
+        }
+    }
+    file->flags &= ~LOGFS_F_READING;
+
+    logfs_soff_t pos = off;
+    if (whence == LOGFS_SEEK_CUR) {
+        pos += file->pos;
+    } else if (whence == LOGFS_SEEK_END) {
+        pos += file->size;
+    }
+
+    if (pos < 0) {
+        return LOGFS_ERR_INVAL;
+    }
+
+    file->pos = pos;
+    return pos;
+}
+
+logfs_soff_t logfs_file_tell(logfs_t *lfs, logfs_file_t *file)
+{
+    (void)lfs;
+    return file->pos;
+}
+
+logfs_soff_t logfs_file_size(logfs_t *lfs, logfs_file_t *file)
+{
+    (void)lfs;
+    if (file->flags & LOGFS_F_WRITING) {
+        return logfs_max(file->pos, file->size);
+    }
+
+    return file->size;
+}
+
+
+/// Filesystem ///
+static int logfs_init(logfs_t *lfs, const struct logfs_config *cfg)
+{
+    if (cfg->block_size < 512 || cfg->block_count < 2
+            || cfg->cache_size == 0
+            || cfg->cache_size % cfg->read_size != 0
+            || cfg->cache_size % cfg->prog_size != 0
+            || cfg->block_size % cfg->cache_size != 0
+            || cfg->lookahead == 0 || cfg->lookahead % 32 != 0) {
+        return LOGFS_ERR_INVAL;
+    }
+
+    memset(lfs, 0, sizeof(*lfs));
+    lfs->cfg = cfg;
+    lfs->root[0] = 0;
+    lfs->root[1] = 1;
+    lfs->rcache.block = LOGFS_BLOCK_NULL;
+    lfs->pcache.block = LOGFS_BLOCK_NULL;
+    lfs->rcache.buffer = (uint8_t *)malloc(cfg->cache_size);
+    lfs->pcache.buffer = (uint8_t *)malloc(cfg->cache_size);
+    lfs->free.buffer = (uint32_t *)malloc(cfg->lookahead / 8);
+    if (!lfs->rcache.buffer || !lfs->pcache.buffer || !lfs->free.buffer) {
+        free(lfs->rcache.buffer);
+        free(lfs->pcache.buffer);
+        free(lfs->free.buffer);
+        return LOGFS_ERR_NOMEM;
+    }
+
+    // the first allocation fills the window
+    lfs->free.size = logfs_min(cfg->lookahead, cfg->block_count);
+    lfs->free.off = lfs->free.size;
+    return 0;
+}
+
+static void logfs_deinit(logfs_t *lfs)
+{
+    free(lfs->rcache.buffer);
+    free(lfs->pcache.buffer);
+    free(lfs->free.buffer);
+    lfs->rcache.buffer = NULL;
+    lfs->pcache.buffer = NULL;
+    lfs->free.buffer = NULL;
+}
+
+static void logfs_super_attr(logfs_t *lfs, struct logfs_attr *attr,
+        uint8_t data[16])
+{
+    logfs_tole32(LOGFS_VERSION, &data[0]);
+    logfs_tole32(lfs->cfg->block_size, &data[4]);
+    logfs_tole32(lfs->cfg->block_count, &data[8]);
+    logfs_tole32(LOGFS_NAME_MAX, &data[12]);
+
+    attr->type = LOGFS_ATTR_SUPER;
+    attr->nlen = 5;
+    attr->dlen = 16;
+    attr->name = "logfs";
+    attr->data = data;
+    attr->block = LOGFS_BLOCK_NULL;
+    attr->off = 0;
+}
+
+int logfs_format(logfs_t *lfs, const struct logfs_config *cfg)
+{
+    int err = logfs_init(lfs, cfg);
+    if (err) {
+        return err;
+    }
+
+    // the root pair holds the superblock
+    struct logfs_attr attr;
+    uint8_t data[16];
+    logfs_super_attr(lfs, &attr, data);
+    logfs_block_t none[2] = {LOGFS_BLOCK_NULL, LOGFS_BLOCK_NULL};
+    struct logfs_commit commit;
+    uint32_t rev[2];
+    err = logfs_mdir_revs(lfs, lfs->root, rev);
+    if (!err) {
+        err = logfs_mdir_write(lfs, lfs->root[1], rev[1], NULL, NULL, 0, -1,
+                none, false, &commit);
+    }
+    if (!err) {
+        err = logfs_mdir_write(lfs, lfs->root[0], rev[0], NULL, &attr, 1, 0,
+                none, false, &commit);
+    }
+    if (!err) {
+        err = logfs_bd_sync(lfs);
+    }
+
+    logfs_deinit(lfs);
+    return err;
+}
+
+int logfs_mount(logfs_t *lfs, const struct logfs_config *cfg)
+{
+    int err = logfs_init(lfs, cfg);
+    if (err) {
+        return err;
+    }
+
+    logfs_mdir_t m;
+    err = logfs_mdir_fetch(lfs, &m, lfs->root);
+    if (err) {
+        goto cleanup;
+    }
+
+    // find the superblock, the last one of the log
+    err = LOGFS_ERR_CORRUPT;
+    for (logfs_off_t off = 4; off < m.off;) {
+        struct logfs_attr attr;
+        int res = logfs_attr_get(lfs, m.pair[0], off, &attr);
+        if (res) {
+            err = res;
+            goto cleanup;
+        }
+        off += LOGFS_ATTR_SIZE(attr.nlen, attr.dlen);
+
+        if (attr.type != LOGFS_ATTR_SUPER) {
+            continue;
+        }
+
+        uint8_t data[16];
+        res = logfs_attr_data(lfs, &attr, data, sizeof(data));
+        if (res) {
+            err = res;
+            goto cleanup;
+        }
+
+        uint32_t version = logfs_fromle32(&data[0]);
+        bool valid = (version >> 16) == (LOGFS_VERSION >> 16)
+            && logfs_fromle32(&data[4]) == cfg->block_size
+            && logfs_fromle32(&data[8]) == cfg->block_count
+            && logfs_fromle32(&data[12]) <= LOGFS_NAME_MAX;
+        err = valid ? 0 : LOGFS_ERR_CORRUPT;
+    }
+    if (err) {
+        goto cleanup;
+    }
+
+    // allocation starts somewhere different on each mount
+    lfs->free.start = (m.crc + cfg->block_count - lfs->free.size % cfg->block_count)
+        % cfg->block_count;
+    return 0;
+
+cleanup:
+    logfs_deinit(lfs);
+    return err;
+}
+
+int logfs_unmount(logfs_t *lfs)
+{
+    int err = logfs_bd_sync(lfs);
+    logfs_deinit(lfs);
+    return err;
+}
@@ -0,0 +1,275 @@
+/* logfs
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef LOGFS_H
+#define LOGFS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* A log-structured, copy-on-write filesystem for flash
+ *
+ * Directories are logs of entries in pairs of erase blocks. Updates are
+ * appended to the active block of the pair as commits ended by a CRC, and
+ * when it is full the entries still in use are compacted into the other
+ * block, so interrupted commits and compactions leave the previous state.
+ * All directories are threaded into one list from the root, which lets
+ * the allocator find the blocks in use without recursion.
+ *
+ * File data is never written in place. Files are backwards skip-lists of
+ * blocks, block n pointing to the blocks n - 2^i for each 2^i dividing n,
+ * so data is appended in O(1) and found in O(log n) reads. The entry of
+ * a file is committed to its directory once its blocks are written.
+ *
+ * Free blocks are found from a lookahead bitmap of a window of blocks,
+ * filled from the blocks in use when needed, so mounting reads the root
+ * pair only.
+ */
+
+#define LOGFS_VERSION   0x00010000
+
+#ifndef LOGFS_NAME_MAX
+#define LOGFS_NAME_MAX  255
+#endif
+
+typedef uint32_t logfs_size_t;
+typedef uint32_t logfs_off_t;
+typedef int32_t logfs_ssize_t;
+typedef int32_t logfs_soff_t;
+typedef uint32_t logfs_block_t;
+
+// Errors are negative and match the POSIX error numbers
+enum logfs_error {
+    LOGFS_ERR_OK            = 0,    // No error
+    LOGFS_ERR_NOENT         = -2,   // No such file or directory
+    LOGFS_ERR_IO            = -5,   // Error of the block device
+    LOGFS_ERR_BADF          = -9,   // Bad file number
+    LOGFS_ERR_NOMEM         = -12,  // Out of memory
+    LOGFS_ERR_EXIST         = -17,  // Entry already exists
+    LOGFS_ERR_NOTDIR        = -20,  // Entry is not a directory
+    LOGFS_ERR_ISDIR         = -21,  // Entry is a directory
+    LOGFS_ERR_INVAL         = -22,  // Invalid argument
+    LOGFS_ERR_NOSPC         = -28,  // No space left on device
+    LOGFS_ERR_NAMETOOLONG   = -36,  // Name too long
+    LOGFS_ERR_NOTEMPTY      = -39,  // Directory not empty
+    LOGFS_ERR_CORRUPT       = -84,  // No valid filesystem found
+};
+
+enum logfs_type {
+    LOGFS_TYPE_REG  = 0x01,
+    LOGFS_TYPE_DIR  = 0x02,
+};
+
+enum logfs_open_flags {
+    LOGFS_O_RDONLY  = 0x0001,
+    LOGFS_O_WRONLY  = 0x0002,
+    LOGFS_O_RDWR    = 0x0003,
+    LOGFS_O_CREAT   = 0x0100,
+    LOGFS_O_EXCL    = 0x0200,
+    LOGFS_O_TRUNC   = 0x0400,
+    LOGFS_O_APPEND  = 0x0800,
+};
+
+enum logfs_whence_flags {
+    LOGFS_SEEK_SET  = 0,
+    LOGFS_SEEK_CUR  = 1,
+    LOGFS_SEEK_END  = 2,
+};
+
+// Configuration of the block device, which must outlive the filesystem
+struct logfs_config {
+    // Passed to the block device operations
+    void *context;
+
+    // Read, program and erase part of a block, sizes and offsets are
+    // multiples of read_size and prog_size
+    int (*read)(const struct logfs_config *c, logfs_block_t block,
+            logfs_off_t off, void *buffer, logfs_size_t size);
+    int (*prog)(const struct logfs_config *c, logfs_block_t block,
+            logfs_off_t off, const void *buffer, logfs_size_t size);
+
+    // Erase a block, or NULL if blocks are programmed without erase
+    int (*erase)(const struct logfs_config *c, logfs_block_t block);
+
+    // Make what was programmed persistent
+    int (*sync)(const struct logfs_config *c);
+
+    logfs_size_t read_size;
+    logfs_size_t prog_size;
+
+    // Size and number of blocks, at least 512 bytes and 2 blocks
+    logfs_size_t block_size;
+    logfs_size_t block_count;
+
+    // Size of the read and program caches of the filesystem and of each
+    // open file, a multiple of read_size and prog_size and a divisor of
+    // block_size
+    logfs_size_t cache_size;
+
+    // Number of blocks in the window of the allocator, a multiple of 32
+    logfs_size_t lookahead;
+
+    // Value of erased bytes
+    uint8_t erase_value;
+};
+
+// Information of an entry
+struct logfs_info {
+    uint8_t type;
+    logfs_size_t size;
+    char name[LOGFS_NAME_MAX + 1];
+};
+
+
+/// Internal structures ///
+typedef struct logfs_cache {
+    logfs_block_t block;
+    logfs_off_t off;
+    logfs_size_t size;
+    uint8_t *buffer;
+} logfs_cache_t;
+
+typedef struct logfs_mdir {
+    logfs_block_t pair[2];      // the active block first
+    uint32_t rev;
+    logfs_off_t off;            // end of the last commit
+    uint32_t crc;               // of the block up to off
+    logfs_block_t tail[2];
+    bool split;                 // tail continues this directory
+    bool erased;                // off can be programmed
+} logfs_mdir_t;
+
+typedef struct logfs_file {
+    struct logfs_file *next;
+    logfs_block_t dir[2];       // first pair of the directory
+    char name[LOGFS_NAME_MAX + 1];
+
+    logfs_block_t head;
+    logfs_size_t size;
+    uint32_t flags;
+    logfs_off_t pos;
+    logfs_block_t block;        // being read or written
+    logfs_off_t off;            // in block
+    logfs_cache_t cache;
+} logfs_file_t;
+
+typedef struct logfs_dir {
+    struct logfs_dir *next;
+    logfs_block_t head[2];
+    logfs_mdir_t m;
+    logfs_off_t off;            // of the next entry in m
+    logfs_size_t id;            // entries read from m
+    logfs_size_t skip;          // entries of m to skip after compaction
+    logfs_off_t pos;
+} logfs_dir_t;
+
+typedef struct logfs_free {
+    logfs_block_t start;
+    logfs_size_t size;
+    logfs_size_t off;
+    logfs_size_t ack;
+    uint32_t *buffer;
+} logfs_free_t;
+
+typedef struct logfs {
+    const struct logfs_config *cfg;
+    logfs_cache_t rcache;
+    logfs_cache_t pcache;
+    logfs_block_t root[2];
+    logfs_file_t *files;
+    logfs_dir_t *dirs;
+    logfs_free_t free;
+    bool deorphaned;
+} logfs_t;
+
+
+/// Filesystem functions ///
+
+// Format a block device, erasing what it holds
+int logfs_format(logfs_t *lfs, const struct logfs_config *config);
+
+// Mount a filesystem, reading the root pair only
+int logfs_mount(logfs_t *lfs, const struct logfs_config *config);
+
+// Unmount a filesystem, the open files must be closed first
+int logfs_unmount(logfs_t *lfs);
+
+// Remove a file, or a directory which must be empty
+int logfs_remove(logfs_t *lfs, const char *path);
+
+// Rename or move an entry, replacing what newpath names
+int logfs_rename(logfs_t *lfs, const char *oldpath, const char *newpath);
+
+// Find the information of an entry
+int logfs_stat(logfs_t *lfs, const char *path, struct logfs_info *info);
+
+// Create a directory
+int logfs_mkdir(logfs_t *lfs, const char *path);
+
+
+/// File functions ///
+
+// Open a file with flags from logfs_open_flags
+int logfs_file_open(logfs_t *lfs, logfs_file_t *file,
+        const char *path, int flags);
+
+// Sync and close a file
+int logfs_file_close(logfs_t *lfs, logfs_file_t *file);
+
+// Commit what was written to a file
+int logfs_file_sync(logfs_t *lfs, logfs_file_t *file);
+
+logfs_ssize_t logfs_file_read(logfs_t *lfs, logfs_file_t *file,
+        void *buffer, logfs_size_t size);
+
+logfs_ssize_t logfs_file_write(logfs_t *lfs, logfs_file_t *file,
+        const void *buffer, logfs_size_t size);
+
+// Move the position of a file, returning the new position
+logfs_soff_t logfs_file_seek(logfs_t *lfs, logfs_file_t *file,
+        logfs_soff_t off, int whence);
+
+logfs_soff_t logfs_file_tell(logfs_t *lfs, logfs_file_t *file);
+
+logfs_soff_t logfs_file_size(logfs_t *lfs, logfs_file_t *file);
+
+
+/// Directory functions ///
+
+int logfs_dir_open(logfs_t *lfs, logfs_dir_t *dir, const char *path);
+
+int logfs_dir_close(logfs_t *lfs, logfs_dir_t *dir);
+
+// Read the next entry, returning 1 for an entry and 0 at the end
+int logfs_dir_read(logfs_t *lfs, logfs_dir_t *dir, struct logfs_info *info);
+
+// Move to a position returned by logfs_dir_tell
+int logfs_dir_seek(logfs_t *lfs, logfs_dir_t *dir, logfs_off_t off);
+
+logfs_soff_t logfs_dir_tell(logfs_t *lfs, logfs_dir_t *dir);
+
+int logfs_dir_rewind(logfs_t *lfs, logfs_dir_t *dir);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,96 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "utest/utest.h"
+#include "unity/unity.h"
+#include "utest/utest_stack_trace.h"
+
+using namespace utest::v1;
+
+static uint8_t source[256];
+static uint8_t destination[256];
+static volatile uint32_t spin_count;
+
+void copy_block() {
+    memcpy(destination, source, sizeof(source));
+}
+
+void spin() {
+    for (uint32_t i = 0; i < spin_count; i++) {
+        __NOP();
+    }
+}
+
+void test_statistics() {
+    UTEST_LOG_FUNCTION();
+    Benchmark benchmark("memcpy 256B", copy_block, 20, 2);
+    const benchmark_result_t &result = benchmark.run();
+
+    TEST_ASSERT_EQUAL(20, result.iterations);
+    TEST_ASSERT_EQUAL(Benchmark::has_cycle_counter(), result.cycles);
+    TEST_ASSERT(result.min <= result.median);
+    TEST_ASSERT(result.median <= result.p99);
+    TEST_ASSERT(result.p99 <= result.max);
+    TEST_ASSERT(result.min <= result.mean && result.mean <= result.max);
+    TEST_ASSERT(result.outliers < result.iterations);
+    TEST_ASSERT_EQUAL_PTR(&result, &benchmark.get_result());
+}
+
+void test_scaling() {
+    UTEST_LOG_FUNCTION();
+    spin_count = 100;
+    Benchmark shorter("spin 100", spin, 10, 1);
+    uint32_t short_median = shorter.run().median;
+
+    spin_count = 10000;
+    Benchmark longer("spin 10000", spin, 10, 1);
+    uint32_t long_median = longer.run().median;
+
+    TEST_ASSERT(long_median > short_median);
+}
+
+void test_iterations_capped() {
+    UTEST_LOG_FUNCTION();
+    spin_count = 1;
+    Benchmark benchmark("capped", spin, UTEST_BENCHMARK_MAX_ITERATIONS + 1, 0);
+    TEST_ASSERT_EQUAL(UTEST_BENCHMARK_MAX_ITERATIONS, benchmark.run().iterations);
+}
+
+// Custom setup handler required for proper Greentea support
+utest::v1::status_t greentea_setup(const size_t number_of_cases) {
+    UTEST_LOG_FUNCTION();
+    GREENTEA_SETUP(20, "default_auto");
+    // Call the default reporting function
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+// Specify all your test cases here
+Case cases[] = {
+    Case("Benchmark statistics", test_statistics),
+    Case("Benchmark scales with the work", test_scaling),
+    Case("Benchmark iterations are capped", test_iterations_capped),
+    Case("Benchmark case handler", benchmark_handler<copy_block, 10>)
+};
+
+// Declare your test specification with a custom setup handler
+Specification specification(greentea_setup, cases);
+
+int main()
+{
+    UTEST_LOG_FUNCTION();
+    Harness::run(specification);
+}
@@ -0,0 +1,74 @@
+/****************************************************************************
+ * Copyright (c) 2017, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ****************************************************************************
+ */
+
+#include "utest/utest_bench_report.h"
+#include "greentea-client/test_env.h"
+
+#include <stdio.h>
+
+using namespace utest::v1;
+
+namespace
+{
+    // Prints a fixed point value with the given number of decimal places
+    int format_fixed(char *buffer, size_t size, uint32_t value, uint32_t scale, int decimals)
+    {
+        if (decimals == 0) {
+            return snprintf(buffer, size, "%lu", (unsigned long)value);
+        }
+        return snprintf(buffer, size, "%lu.%0*lu", (unsigned long)(value / scale),
+                        decimals, (unsigned long)(value % scale));
+    }
+}
+
+void utest::v1::bench_reset(bench_result_t *r)
+{
+    r->min = UINT32_MAX;
+    r->max = 0;
+    r->sum = 0;
+    r->count = 0;
+}
+
+void utest::v1::bench_add(bench_result_t *r, uint32_t value)
+{
+    if (value < r->min) {
+        r->min = value;
+    }
+    if (value > r->max) {
+        r->max = value;
+    }
+    r->sum += value;
+    r->count++;
+}
+
+void utest::v1::bench_report(const char *name, const char *unit, const bench_result_t *r, int decimals)
+{
+    uint32_t scale = 1;
+    for (int i = 0; i < decimals; i++) {
+        scale *= 10;
+    }
+
+    uint32_t values[3] = { r->min, r->count ? (uint32_t)(r->sum / r->count) : 0, r->max };
+    char buffer[96];
+    int length = snprintf(buffer, sizeof(buffer), "%s,%s", name, unit);
+    for (int i = 0; i < 3 && length > 0 && (size_t)length + 1 < sizeof(buffer); i++) {
+        buffer[length++] = ',';
+        length += format_fixed(buffer + length, sizeof(buffer) - length, values[i], scale, decimals);
+    }
+    greentea_send_kv("bench", buffer);
+}
@@ -0,0 +1,179 @@
+/****************************************************************************
+ * Copyright (c) 2017, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ****************************************************************************
+ */
+
+#include "utest/utest_benchmark.h"
+#include "utest/utest_stack_trace.h"
+#include "utest/utest_serial.h"
+#include "greentea-client/test_env.h"
+#include "hal/us_ticker_api.h"
+#include "cmsis.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace utest::v1;
+
+namespace
+{
+    const char *const benchmark_key = "benchmark";
+
+    uint32_t samples[UTEST_BENCHMARK_MAX_ITERATIONS];
+
+    bool timer_checked = false;
+    bool timer_cycles = false;
+
+    // Enables the DWT cycle counter, if the core has a running one
+    bool cycle_counter_init()
+    {
+#if defined(DWT_CTRL_CYCCNTENA_Msk)
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        if (DWT->CTRL & DWT_CTRL_NOCYCCNT_Msk) {
+            return false;
+        }
+        DWT->CYCCNT = 0;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+        // Some parts only clock the DWT while a debugger is attached
+        uint32_t start = DWT->CYCCNT;
+        for (volatile int i = 0; i < 16; i++) {
+        }
+        return DWT->CYCCNT != start;
+#else
+        return false;
+#endif
+    }
+
+    inline uint32_t timer_read()
+    {
+#if defined(DWT_CTRL_CYCCNTENA_Msk)
+        if (timer_cycles) {
+            return DWT->CYCCNT;
+        }
+#endif
+        return us_ticker_read();
+    }
+
+    int compare_samples(const void *a, const void *b)
+    {
+        uint32_t x = *static_cast<const uint32_t *>(a);
+        uint32_t y = *static_cast<const uint32_t *>(b);
+        return (x > y) - (x < y);
+    }
+}
+
+Benchmark::Benchmark(const char *description,
+                     const benchmark_handler_t handler,
+                     const uint32_t iterations,
+                     const uint32_t warmup) :
+    description(description),
+    handler(handler),
+    iterations(iterations),
+    warmup(warmup),
+    result()
+{
+    if (this->iterations > UTEST_BENCHMARK_MAX_ITERATIONS) {
+        this->iterations = UTEST_BENCHMARK_MAX_ITERATIONS;
+    }
+    if (this->iterations == 0) {
+        this->iterations = 1;
+    }
+}
+
+bool Benchmark::has_cycle_counter()
+{
+    UTEST_LOG_FUNCTION();
+    if (!timer_checked) {
+        timer_cycles = cycle_counter_init();
+        if (!timer_cycles) {
+            // Make sure the ticker is initialized before reading it directly
+            ticker_read(get_us_ticker_data());
+        }
+        timer_checked = true;
+    }
+    return timer_cycles;
+}
+
+const benchmark_result_t& Benchmark::run()
+{
+    UTEST_LOG_FUNCTION();
+    bool cycles = has_cycle_counter();
+
+    // Cost of reading the timer, subtracted from every sample
+    uint32_t overhead = 0xFFFFFFFF;
+    for (int i = 0; i < 8; i++) {
+        uint32_t start = timer_read();
+        uint32_t duration = timer_read() - start;
+        if (duration < overhead) {
+            overhead = duration;
+        }
+    }
+
+    for (uint32_t i = 0; i < warmup; i++) {
+        handler();
+    }
+
+    for (uint32_t i = 0; i < iterations; i++) {
+        uint32_t start = timer_read();
+        handler();
+        uint32_t duration = timer_read() - start;
+        samples[i] = (duration > overhead) ? (duration - overhead) : 0;
+    }
+
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < iterations; i++) {
+        total += samples[i];
+    }
+
+    qsort(samples, iterations, sizeof(samples[0]), compare_samples);
+
+    const uint32_t n = iterations;
+    result.iterations = n;
+    result.min = samples[0];
+    result.max = samples[n - 1];
+    result.median = (n & 1) ? samples[n / 2] : (uint32_t)(((uint64_t)samples[n / 2 - 1] + samples[n / 2]) / 2);
+    // nearest rank
+    result.p99 = samples[(99 * n + 99) / 100 - 1];
+    result.mean = (uint32_t)(total / n);
+    result.cycles = cycles;
+
+    const uint32_t q1 = samples[n / 4];
+    const uint32_t q3 = samples[(3 * n) / 4];
+    const uint64_t fence = q3 + (3 * (uint64_t)(q3 - q1)) / 2;
+    result.outliers = 0;
+    for (uint32_t i = n; i > 0 && samples[i - 1] > fence; i--) {
+        result.outliers++;
+    }
+
+    const char *unit = cycles ? "cycles" : "us";
+    utest_printf(">>> Benchmark '%s': %u iterations, min %u, median %u, p99 %u, max %u, mean %u %s, %u outliers\n",
+                 description, (unsigned)n, (unsigned)result.min, (unsigned)result.median, (unsigned)result.p99,
+                 (unsigned)result.max, (unsigned)result.mean, unit, (unsigned)result.outliers);
+
+    char value[160];
+    snprintf(value, sizeof(value), "%s;%s;%u;%u;%u;%u;%u;%u;%u",
+             description, unit, (unsigned)n, (unsigned)result.min, (unsigned)result.median, (unsigned)result.p99,
+             (unsigned)result.max, (unsigned)result.mean, (unsigned)result.outliers);
+    greentea_send_kv(benchmark_key, value);
+
+    return result;
+}
+
+const benchmark_result_t& Benchmark::get_result() const
+{
+    return result;
+}
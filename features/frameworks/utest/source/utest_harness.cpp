@@ -296,6 +296,12 @@ bool Harness::is_busy()
     return res;
 }
 
+const Case *Harness::get_current_case()
+{
+    UTEST_LOG_FUNCTION();
+    return is_busy() ? case_current : NULL;
+}
+
 void Harness::run_next_case()
 {
     UTEST_LOG_FUNCTION();
@@ -0,0 +1,75 @@
+/****************************************************************************
+ * Copyright (c) 2017, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ****************************************************************************
+ */
+
+#ifndef UTEST_BENCH_REPORT_H
+#define UTEST_BENCH_REPORT_H
+
+#include <stdint.h>
+
+namespace utest {
+/** \addtogroup frameworks */
+/** @{*/
+namespace v1 {
+
+    /** Minimum, average and maximum of a series of measurements.
+     *
+     * Tests measuring something their own way collect the values with
+     * bench_add and send them to the `benchmark_report` host test with
+     * bench_report, which compares them between targets and releases.
+     *
+     * @code
+     * bench_result_t r;
+     * bench_reset(&r);
+     * for (int i = 0; i < SAMPLES; i++) {
+     *     bench_add(&r, measure());
+     * }
+     * bench_report("context_switch", "ns", &r);
+     * @endcode
+     */
+    struct bench_result_t
+    {
+        uint32_t min;       ///< Smallest value
+        uint32_t max;       ///< Largest value
+        uint64_t sum;       ///< Sum of the values
+        uint32_t count;     ///< Number of values
+    };
+
+    /// Empties a result
+    void bench_reset(bench_result_t *r);
+
+    /// Adds a value to a result
+    void bench_add(bench_result_t *r, uint32_t value);
+
+    /** Sends a result to the host as a `bench` key-value message.
+     *
+     * @verbatim {{bench;<name>,<unit>,<min>,<avg>,<max>}} @endverbatim
+     *
+     * @param name      name of the measurement, which must not contain ','
+     * @param unit      unit of the values
+     * @param r         result to send, with at least one value
+     * @param decimals  number of decimal places the values are fixed point
+     *                  with, 2 for values in hundredths of the unit
+     */
+    void bench_report(const char *name, const char *unit, const bench_result_t *r, int decimals = 0);
+
+}   // namespace v1
+}   // namespace utest
+
+#endif // UTEST_BENCH_REPORT_H
+
+/** @}*/
@@ -0,0 +1,146 @@
+/****************************************************************************
+ * Copyright (c) 2017, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ****************************************************************************
+ */
+
+#ifndef UTEST_BENCHMARK_H
+#define UTEST_BENCHMARK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "utest/utest_harness.h"
+
+#ifndef UTEST_BENCHMARK_MAX_ITERATIONS
+#ifdef MBED_CONF_UTEST_BENCHMARK_MAX_ITERATIONS
+#define UTEST_BENCHMARK_MAX_ITERATIONS MBED_CONF_UTEST_BENCHMARK_MAX_ITERATIONS
+#else
+#define UTEST_BENCHMARK_MAX_ITERATIONS 100
+#endif
+#endif
+
+namespace utest {
+/** \addtogroup frameworks */
+/** @{*/
+namespace v1 {
+
+    /// Code under measurement, called once per iteration
+    typedef void (*benchmark_handler_t)(void);
+
+    /** Statistics of a benchmark run.
+     *
+     * Durations are in CPU cycles when the DWT cycle counter is available,
+     * in microseconds otherwise, and exclude the overhead of reading the timer.
+     */
+    struct benchmark_result_t
+    {
+        uint32_t iterations;    ///< Number of timed iterations
+        uint32_t min;           ///< Shortest iteration
+        uint32_t median;        ///< Median iteration
+        uint32_t p99;           ///< 99th percentile
+        uint32_t max;           ///< Longest iteration
+        uint32_t mean;          ///< Average iteration
+        uint32_t outliers;      ///< Iterations beyond the upper fence Q3 + 1.5 * (Q3 - Q1)
+        bool cycles;            ///< `true` if durations are in cycles, `false` if in microseconds
+    };
+
+    /** Repeated measurement of a piece of code.
+     *
+     * The handler first runs for a number of warmup iterations, which fill the
+     * caches and flash accelerators and are not timed. Each of the following
+     * iterations is then timed on its own, and the statistics are printed and
+     * sent to the host as a `benchmark` key-value message:
+     *
+     * @verbatim {{benchmark;<description>;<cycles|us>;<iterations>;<min>;<median>;<p99>;<max>;<mean>;<outliers>}} @endverbatim
+     *
+     * Interrupts are left enabled, so that the code under test may rely on
+     * them. Iterations delayed by an interrupt show up as outliers, and do not
+     * affect the median.
+     *
+     * @code
+     * static void copy_block() { memcpy(dst, src, sizeof(src)); }
+     *
+     * void test_copy() {
+     *     Benchmark benchmark("memcpy 1KB", copy_block, 50);
+     *     TEST_ASSERT(benchmark.run().median < 1000);
+     * }
+     * @endcode
+     *
+     * Benchmarks run one at a time: the samples of the run in progress are
+     * kept in a buffer of UTEST_BENCHMARK_MAX_ITERATIONS entries, which also
+     * caps the number of timed iterations.
+     */
+    class Benchmark
+    {
+    public:
+        /**
+         * @param description   name reported to the host, which must not contain ';'
+         * @param handler       code under measurement
+         * @param iterations    number of timed iterations
+         * @param warmup        number of untimed iterations run first
+         */
+        Benchmark(const char *description,
+                  const benchmark_handler_t handler,
+                  const uint32_t iterations = UTEST_BENCHMARK_MAX_ITERATIONS,
+                  const uint32_t warmup = 10);
+
+        /// Runs the benchmark, then reports its statistics
+        /// @returns the statistics of the run
+        const benchmark_result_t& run();
+
+        /// @returns the statistics of the last run
+        const benchmark_result_t& get_result() const;
+
+        /// @returns `true` if durations are measured with the DWT cycle counter
+        static bool has_cycle_counter();
+
+    private:
+        const char *description;
+        benchmark_handler_t handler;
+        uint32_t iterations;
+        uint32_t warmup;
+        benchmark_result_t result;
+    };
+
+    /** Test case handler running a benchmark named after the test case.
+     *
+     * @note As a template argument, the handler must have external linkage.
+     *
+     * @code
+     * Case("memcpy 1KB", benchmark_handler<copy_block, 50>)
+     * @endcode
+     */
+    template <benchmark_handler_t handler, uint32_t iterations, uint32_t warmup>
+    void benchmark_handler()
+    {
+        const Case *current = Harness::get_current_case();
+        Benchmark benchmark(current ? current->get_description() : "benchmark", handler, iterations, warmup);
+        benchmark.run();
+    }
+
+    /// @cond
+    template <benchmark_handler_t handler, uint32_t iterations>
+    void benchmark_handler()
+    {
+        benchmark_handler<handler, iterations, 10>();
+    }
+    /// @endcond
+
+}   // namespace v1
+}   // namespace utest
+
+#endif // UTEST_BENCHMARK_H
+
+/** @}*/
@@ -64,6 +64,9 @@ namespace v1 {
         /// @returns `true` if a test specification is being executed, `false` otherwise
         static bool is_busy();
 
+        /// @returns the test case being executed, or `NULL` if none is
+        static const Case *get_current_case();
+
         /// Sets the scheduler to be used.
         /// @return `true` if scheduler is properly specified (all functions non-null).
         static bool set_scheduler(utest_v1_scheduler_t scheduler);
@@ -673,6 +673,36 @@ int mbedtls_mpi_mod_int( mbedtls_mpi_uint *r, const mbedtls_mpi *A, mbedtls_mpi_
  */
 int mbedtls_mpi_exp_mod( mbedtls_mpi *X, const mbedtls_mpi *A, const mbedtls_mpi *E, const mbedtls_mpi *N, mbedtls_mpi *_RR );
 
+#if defined(MBEDTLS_MPI_EXP_MOD_ALT)
+/**
+ * \brief          Indicate if the modular exponentiation extension can
+ *                 handle the modulus.
+ *
+ * \param N        Modular MPI, positive and odd
+ *
+ * \return         Non-zero if mbedtls_internal_mpi_exp_mod() is to be used
+ */
+int mbedtls_internal_mpi_exp_mod_capable( const mbedtls_mpi *N );
+
+/**
+ * \brief          Modular exponentiation extension: X = A^E mod N
+ *
+ *                 Called by mbedtls_mpi_exp_mod() with 0 <= A < N, E >= 0,
+ *                 and N positive and odd, for moduli accepted by
+ *                 mbedtls_internal_mpi_exp_mod_capable(). X may alias E.
+ *                 The time taken must not depend on the value of E.
+ *
+ * \param X        Destination MPI
+ * \param A        Left-hand MPI
+ * \param E        Exponent MPI
+ * \param N        Modular MPI
+ *
+ * \return         0 if successful, or an MBEDTLS_ERR_MPI_XXX error code
+ */
+int mbedtls_internal_mpi_exp_mod( mbedtls_mpi *X, const mbedtls_mpi *A,
+                                  const mbedtls_mpi *E, const mbedtls_mpi *N );
+#endif /* MBEDTLS_MPI_EXP_MOD_ALT */
+
 /**
  * \brief          Fill an MPI X with size bytes of random
  *
@@ -629,6 +629,36 @@
            "r6", "r7", "r8", "r9", "cc"         \
          );
 
+#elif defined(__ARM_FEATURE_DSP) && defined(__ARM_ARCH) && ( __ARM_ARCH >= 6 )
+
+/*
+ * UMAAL adds both the carry and the destination word to the 64-bit product
+ * without overflow, so each word takes a single multiply (Cortex-M4/M7 and
+ * ARMv6 and later cores with the DSP instructions).
+ */
+#define MULADDC_INIT                                    \
+    asm(                                                \
+            "ldr    r0, %3                      \n\t"   \
+            "ldr    r1, %4                      \n\t"   \
+            "ldr    r2, %5                      \n\t"   \
+            "ldr    r3, %6                      \n\t"
+
+#define MULADDC_CORE                                    \
+            "ldr    r4, [r0], #4                \n\t"   \
+            "ldr    r6, [r1]                    \n\t"   \
+            "umaal  r6, r2, r3, r4              \n\t"   \
+            "str    r6, [r1], #4                \n\t"
+
+#define MULADDC_STOP                                    \
+            "str    r2, %0                      \n\t"   \
+            "str    r1, %1                      \n\t"   \
+            "str    r0, %2                      \n\t"   \
+         : "=m" (c),  "=m" (d), "=m" (s)        \
+         : "m" (s), "m" (d), "m" (c), "m" (b)   \
+         : "r0", "r1", "r2", "r3", "r4", "r6",  \
+           "cc"                                 \
+         );
+
 #else
 
 #define MULADDC_INIT                                    \
@@ -576,6 +576,32 @@
  */
 #define MBEDTLS_ECP_NIST_OPTIM
 
+/**
+ * \def MBEDTLS_ECP_FAST_SECP256R1
+ *
+ * Multiply points of secp256r1 with the dedicated constant-time
+ * implementation in platform/src/ecp_secp256r1.c instead of the generic
+ * bignum code. The base point uses a 2KB table in flash, so the group's
+ * comb table is never built in RAM.
+ *
+ * Requires: MBEDTLS_ECP_DP_SECP256R1_ENABLED
+ *
+ * Uncomment this macro to enable the secp256r1 implementation.
+ */
+//#define MBEDTLS_ECP_FAST_SECP256R1
+
+/**
+ * \def MBEDTLS_ECP_FAST_CURVE25519
+ *
+ * Multiply points of Curve25519 with the compact X25519 implementation in
+ * platform/src/ecp_curve25519.c instead of the generic bignum code.
+ *
+ * Requires: MBEDTLS_ECP_DP_CURVE25519_ENABLED
+ *
+ * Uncomment this macro to enable the Curve25519 implementation.
+ */
+//#define MBEDTLS_ECP_FAST_CURVE25519
+
 /**
  * \def MBEDTLS_ECDSA_DETERMINISTIC
  *
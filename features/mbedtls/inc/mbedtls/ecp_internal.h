@@ -288,5 +288,37 @@ int mbedtls_internal_ecp_normalize_mxz( const mbedtls_ecp_group *grp,
 
 #endif /* MBEDTLS_ECP_INTERNAL_ALT */
 
+#if defined(MBEDTLS_ECP_FAST_SECP256R1)
+/**
+ * \brief           Constant-time R = m * P on secp256r1, used by
+ *                  mbedtls_ecp_mul() for that group once m and P are checked.
+ *
+ * \param grp       secp256r1 group
+ * \param R         Destination point, may alias P
+ * \param m         Scalar, a valid private key
+ * \param P         Point, a valid public key or the base point
+ *
+ * \return          0 if successful, or an MBEDTLS_ERR_MPI_XXX error code
+ */
+int mbedtls_ecp_fast_secp256r1_mul( const mbedtls_ecp_group *grp, mbedtls_ecp_point *R,
+        const mbedtls_mpi *m, const mbedtls_ecp_point *P );
+#endif
+
+#if defined(MBEDTLS_ECP_FAST_CURVE25519)
+/**
+ * \brief           Constant-time X25519 R = m * P, used by mbedtls_ecp_mul()
+ *                  for that group once m and P are checked.
+ *
+ * \param grp       Curve25519 group
+ * \param R         Destination point, may alias P
+ * \param m         Scalar, a valid private key
+ * \param P         Point, a valid public key
+ *
+ * \return          0 if successful, or an MBEDTLS_ERR_MPI_XXX error code
+ */
+int mbedtls_ecp_fast_curve25519_mul( const mbedtls_ecp_group *grp, mbedtls_ecp_point *R,
+        const mbedtls_mpi *m, const mbedtls_ecp_point *P );
+#endif
+
 #endif /* ecp_internal.h */
 
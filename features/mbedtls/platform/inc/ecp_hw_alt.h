@@ -0,0 +1,92 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MBED_ECP_HW_ALT_H
+#define MBED_ECP_HW_ALT_H
+
+/*
+ * Elliptic curve arithmetic on modular multiplier hardware
+ *
+ * A target with a PKA or crypto cell that multiplies modulo the prime of a
+ * curve defines MBEDTLS_ECP_HW_ALT in its mbedtls_device.h and implements
+ * the functions below. The point doubling and addition of mbed TLS, which
+ * take nearly all the time of ECDH and ECDSA, then do their multiplications
+ * on the hardware; the rest of the point multiplication stays in software.
+ *
+ * Targets with hardware for complete point operations implement the
+ * MBEDTLS_ECP_INTERNAL_ALT functions of mbedtls/ecp_internal.h directly
+ * instead, and modular exponentiation (RSA, DHM) is offloaded with
+ * MBEDTLS_MPI_EXP_MOD_ALT, see mbedtls/bignum.h.
+ */
+
+#if defined(MBEDTLS_ECP_HW_ALT)
+
+#include "mbedtls/ecp.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief           Indicate if the hardware multiplies modulo the prime of
+ *                  a group
+ *
+ * \param grp       Group of the operation, grp->P is its prime
+ *
+ * \return          Non-zero if the group is handled by the hardware
+ */
+int mbedtls_ecp_hw_capable( const mbedtls_ecp_group *grp );
+
+/**
+ * \brief           Prepare the hardware for a point multiplication
+ *
+ *                  Called at the start of each point multiplication in a
+ *                  capable group, to claim and set up the hardware for the
+ *                  prime of the group.
+ *
+ * \param grp       Group of the operation
+ *
+ * \return          0 if successful, or an MBEDTLS_ERR_ECP_XXX error code
+ */
+int mbedtls_ecp_hw_init( const mbedtls_ecp_group *grp );
+
+/**
+ * \brief           Release the hardware after a point multiplication
+ *
+ * \param grp       Group of the operation
+ */
+void mbedtls_ecp_hw_free( const mbedtls_ecp_group *grp );
+
+/**
+ * \brief           Modular multiplication: X = A * B mod P
+ *
+ * \param grp       Group of the operation, grp->P is the modulus
+ * \param X         Destination, may alias A or B
+ * \param A         Left-hand operand, in the range 0..P-1
+ * \param B         Right-hand operand, in the range 0..P-1
+ *
+ * \return          0 if successful, or an MBEDTLS_ERR_MPI_XXX or
+ *                  MBEDTLS_ERR_ECP_XXX error code
+ */
+int mbedtls_ecp_hw_mod_mul( const mbedtls_ecp_group *grp, mbedtls_mpi *X,
+                            const mbedtls_mpi *A, const mbedtls_mpi *B );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MBEDTLS_ECP_HW_ALT */
+
+#endif /* MBED_ECP_HW_ALT_H */
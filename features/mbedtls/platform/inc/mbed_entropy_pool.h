@@ -0,0 +1,54 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MBED_ENTROPY_POOL_H
+#define MBED_ENTROPY_POOL_H
+
+/*
+ * Background TRNG harvesting
+ *
+ * With mbedtls.entropy-pool-size set, a low priority thread reads the TRNG
+ * ahead of time into a pool of that many bytes, and mbedtls_hardware_poll
+ * takes its output from the pool instead of waiting for the TRNG. The
+ * TRNG is only read in the caller's context when the pool runs dry.
+ *
+ * The pool holds raw TRNG output, mbed TLS conditions it in its entropy
+ * accumulator as for any other source.
+ */
+
+#if defined(DEVICE_TRNG) && defined(MBED_CONF_RTOS_PRESENT) \
+    && defined(MBED_CONF_MBEDTLS_ENTROPY_POOL_SIZE)
+#define MBED_ENTROPY_POOL
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief           Start filling the entropy pool
+ *
+ *                  The pool is started by the first mbedtls_hardware_poll,
+ *                  calling this early, for example at the start of main,
+ *                  has it full by the first handshake. Does nothing without
+ *                  a pool.
+ */
+void mbed_entropy_pool_start( void );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MBED_ENTROPY_POOL_H */
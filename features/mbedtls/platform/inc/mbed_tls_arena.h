@@ -0,0 +1,131 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MBED_TLS_ARENA_H
+#define MBED_TLS_ARENA_H
+
+/*
+ * Per-context memory arenas for mbed TLS
+ *
+ * With mbedtls.arena enabled, mbed TLS allocates through mbed_tls_calloc
+ * and mbed_tls_free. While a thread has entered an arena, its allocations
+ * are taken from the arena's buffer instead of the heap, so everything a
+ * connection allocates can be given back at once with the buffer and the
+ * short lived allocations of a handshake do not fragment the heap. Memory
+ * from an arena can be freed by any thread, and heap memory can still be
+ * freed while in an arena.
+ *
+ * An arena is used by one thread at a time, callers serialize the
+ * operations on the contexts that use it, as they do for the contexts
+ * themselves. Objects that outlive the arena, like sessions saved for
+ * resumption or entries of a shared session cache, must be allocated
+ * outside of it.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(MBED_CONF_MBEDTLS_ARENA) && MBED_CONF_MBEDTLS_ARENA
+#define MBED_TLS_ARENA
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    uint32_t current_size;      /**< Bytes allocated currently, including block headers. */
+    uint32_t max_size;          /**< Max bytes allocated at a given time. */
+    uint32_t total_size;        /**< Cumulative sum of bytes ever allocated. */
+    uint32_t reserved_size;     /**< Size of the arena buffer usable for allocations. */
+    uint32_t alloc_cnt;         /**< Current number of allocations. */
+    uint32_t alloc_fail_cnt;    /**< Number of failed allocations. */
+} mbed_tls_arena_stats_t;
+
+typedef struct mbed_tls_arena {
+    unsigned char *buf;
+    size_t size;
+    void *owner;
+    unsigned depth;
+    mbed_tls_arena_stats_t stats;
+    struct mbed_tls_arena *next;
+} mbed_tls_arena_t;
+
+/**
+ * \brief           Set up an arena on a buffer
+ *
+ *                  Allocations fail once the buffer is full, they do not
+ *                  fall back to the heap.
+ *
+ * \param arena     Arena to set up
+ * \param buf       Buffer the allocations are taken from, which must stay
+ *                  valid until mbed_tls_arena_free
+ * \param size      Size of buf in bytes
+ */
+void mbed_tls_arena_init( mbed_tls_arena_t *arena, void *buf, size_t size );
+
+/**
+ * \brief           Stop using an arena
+ *
+ *                  Free the contexts allocated from the arena first, the
+ *                  memory still allocated from it must neither be used nor
+ *                  freed once this returns and the buffer can be reused.
+ *                  The statistics are kept.
+ *
+ * \param arena     Arena to release
+ */
+void mbed_tls_arena_free( mbed_tls_arena_t *arena );
+
+/**
+ * \brief           Allocate from an arena in the calling thread
+ *
+ *                  Calls nest, allocations go back to the heap once
+ *                  mbed_tls_arena_leave is called as many times.
+ *
+ * \param arena     Arena to allocate from
+ */
+void mbed_tls_arena_enter( mbed_tls_arena_t *arena );
+
+/**
+ * \brief           Stop allocating from an arena in the calling thread
+ *
+ * \param arena     Arena entered with mbed_tls_arena_enter
+ */
+void mbed_tls_arena_leave( mbed_tls_arena_t *arena );
+
+/**
+ * \brief           Get the allocation statistics of an arena
+ *
+ * \param arena     Arena to get the statistics of
+ * \param stats     Destination for the statistics
+ */
+void mbed_tls_arena_stats_get( const mbed_tls_arena_t *arena, mbed_tls_arena_stats_t *stats );
+
+/**
+ * \brief           calloc of mbed TLS, from the entered arena or the heap
+ */
+void *mbed_tls_calloc( size_t n, size_t size );
+
+/**
+ * \brief           free of mbed TLS, to the arena the memory belongs to
+ *                  or the heap
+ */
+void mbed_tls_free( void *ptr );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MBED_TLS_ARENA_H */
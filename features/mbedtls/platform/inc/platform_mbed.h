@@ -21,6 +21,19 @@
 #define MBEDTLS_ENTROPY_HARDWARE_ALT
 #endif
 
+#if defined(MBED_CONF_MBEDTLS_ARENA) && MBED_CONF_MBEDTLS_ARENA
+#include "mbed_tls_arena.h"
+#define MBEDTLS_PLATFORM_MEMORY
+#define MBEDTLS_PLATFORM_STD_CALLOC     mbed_tls_calloc
+#define MBEDTLS_PLATFORM_STD_FREE       mbed_tls_free
+#endif
+
 #if defined(MBEDTLS_CONFIG_HW_SUPPORT)
 #include "mbedtls_device.h"
 #endif
+
+#if defined(MBEDTLS_ECP_HW_ALT)
+#define MBEDTLS_ECP_INTERNAL_ALT
+#define MBEDTLS_ECP_DOUBLE_JAC_ALT
+#define MBEDTLS_ECP_ADD_MIXED_ALT
+#endif
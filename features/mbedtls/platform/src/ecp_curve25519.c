@@ -0,0 +1,353 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Curve25519 point multiplication (X25519), enabled with
+ * MBEDTLS_ECP_FAST_CURVE25519
+ *
+ * The Montgomery ladder of RFC 7748 on field elements of eight 32-bit
+ * words, kept below 2^256 and reduced modulo 2^255 - 19 only at the end.
+ * The swaps are branch-free, so the time taken does not depend on the
+ * scalar.
+ */
+
+#if !defined(MBEDTLS_CONFIG_FILE)
+#include "mbedtls/config.h"
+#else
+#include MBEDTLS_CONFIG_FILE
+#endif
+
+#if defined(MBEDTLS_ECP_C) && defined(MBEDTLS_ECP_FAST_CURVE25519) && \
+    defined(MBEDTLS_ECP_DP_CURVE25519_ENABLED)
+
+#include "mbedtls/ecp.h"
+#include "mbedtls/ecp_internal.h"
+
+#include <stdint.h>
+#include <string.h>
+
+typedef uint32_t x25519_fe[8];
+
+/* Implementation that should never be optimized out by the compiler */
+static void mbedtls_zeroize( void *v, size_t n ) {
+    volatile unsigned char *p = v; while( n-- ) *p++ = 0;
+}
+
+/* Add carry * 2^256 = carry * 38 mod p, returns the carry out */
+static uint32_t fe_fold( x25519_fe r, uint32_t carry )
+{
+    uint64_t c = (uint64_t) carry * 38;
+    int i;
+
+    for( i = 0; i < 8; i++ )
+    {
+        c += r[i];
+        r[i] = (uint32_t) c;
+        c >>= 32;
+    }
+    return( (uint32_t) c );
+}
+
+static void fe_add( x25519_fe r, const x25519_fe a, const x25519_fe b )
+{
+    uint64_t c = 0;
+    int i;
+
+    for( i = 0; i < 8; i++ )
+    {
+        c += (uint64_t) a[i] + b[i];
+        r[i] = (uint32_t) c;
+        c >>= 32;
+    }
+    /* a second carry leaves a value far below 2^256 - 38 */
+    fe_fold( r, fe_fold( r, (uint32_t) c ) );
+}
+
+static void fe_sub( x25519_fe r, const x25519_fe a, const x25519_fe b )
+{
+    uint64_t c;
+    uint32_t borrow = 0;
+    int i, pass;
+
+    for( i = 0; i < 8; i++ )
+    {
+        c = (uint64_t) a[i] - b[i] - borrow;
+        r[i] = (uint32_t) c;
+        borrow = (uint32_t)( c >> 63 );
+    }
+    /* a borrow of 2^256 is 38 mod p, once more if it borrows again */
+    for( pass = 0; pass < 2; pass++ )
+    {
+        uint32_t sub = 38 * borrow;
+        borrow = 0;
+        for( i = 0; i < 8; i++ )
+        {
+            c = (uint64_t) r[i] - ( i == 0 ? sub : 0 ) - borrow;
+            r[i] = (uint32_t) c;
+            borrow = (uint32_t)( c >> 63 );
+        }
+    }
+}
+
+static void fe_mul( x25519_fe r, const x25519_fe a, const x25519_fe b )
+{
+    uint32_t t[16] = { 0 };
+    uint64_t c;
+    int i, j;
+
+    for( i = 0; i < 8; i++ )
+    {
+        c = 0;
+        for( j = 0; j < 8; j++ )
+        {
+            c += (uint64_t) a[i] * b[j] + t[i + j];
+            t[i + j] = (uint32_t) c;
+            c >>= 32;
+        }
+        t[i + 8] = (uint32_t) c;
+    }
+
+    /* 2^256 is 38 mod p */
+    c = 0;
+    for( i = 0; i < 8; i++ )
+    {
+        c += (uint64_t) t[i] + (uint64_t) t[i + 8] * 38;
+        r[i] = (uint32_t) c;
+        c >>= 32;
+    }
+    fe_fold( r, fe_fold( r, (uint32_t) c ) );
+}
+
+static void fe_sqr( x25519_fe r, const x25519_fe a )
+{
+    fe_mul( r, a, a );
+}
+
+static void fe_mul_a24( x25519_fe r, const x25519_fe a )
+{
+    uint64_t c = 0;
+    int i;
+
+    for( i = 0; i < 8; i++ )
+    {
+        c += (uint64_t) a[i] * 121665;
+        r[i] = (uint32_t) c;
+        c >>= 32;
+    }
+    fe_fold( r, fe_fold( r, (uint32_t) c ) );
+}
+
+static void fe_sqr_n( x25519_fe r, const x25519_fe a, int n )
+{
+    fe_sqr( r, a );
+    while( --n > 0 )
+        fe_sqr( r, r );
+}
+
+/* r = a^(p - 2) = a^(2^255 - 21) */
+static void fe_inv( x25519_fe r, const x25519_fe a )
+{
+    x25519_fe z2, z9, z11, z2_5_0, z2_10_0, z2_20_0, z2_50_0, z2_100_0, t;
+
+    fe_sqr( z2, a );
+    fe_sqr_n( t, z2, 2 );
+    fe_mul( z9, t, a );
+    fe_mul( z11, z9, z2 );
+    fe_sqr( t, z11 );
+    fe_mul( z2_5_0, t, z9 );
+    fe_sqr_n( t, z2_5_0, 5 );
+    fe_mul( z2_10_0, t, z2_5_0 );
+    fe_sqr_n( t, z2_10_0, 10 );
+    fe_mul( z2_20_0, t, z2_10_0 );
+    fe_sqr_n( t, z2_20_0, 20 );
+    fe_mul( t, t, z2_20_0 );
+    fe_sqr_n( t, t, 10 );
+    fe_mul( z2_50_0, t, z2_10_0 );
+    fe_sqr_n( t, z2_50_0, 50 );
+    fe_mul( z2_100_0, t, z2_50_0 );
+    fe_sqr_n( t, z2_100_0, 100 );
+    fe_mul( t, t, z2_100_0 );
+    fe_sqr_n( t, t, 50 );
+    fe_mul( t, t, z2_50_0 );
+    fe_sqr_n( t, t, 5 );
+    fe_mul( r, t, z11 );
+}
+
+/* Fully reduce modulo p = 2^255 - 19 */
+static void fe_reduce( x25519_fe r )
+{
+    x25519_fe t;
+    uint64_t c;
+    uint32_t mask;
+    int i, pass;
+
+    /* fold bit 255 in twice, leaving r < 2^255 */
+    for( pass = 0; pass < 2; pass++ )
+    {
+        c = (uint64_t)( r[7] >> 31 ) * 19;
+        r[7] &= 0x7fffffff;
+        for( i = 0; i < 8; i++ )
+        {
+            c += r[i];
+            r[i] = (uint32_t) c;
+            c >>= 32;
+        }
+    }
+
+    /* r >= p exactly when r + 19 reaches 2^255 */
+    c = 19;
+    for( i = 0; i < 8; i++ )
+    {
+        c += r[i];
+        t[i] = (uint32_t) c;
+        c >>= 32;
+    }
+    mask = 0 - ( t[7] >> 31 );
+    t[7] &= 0x7fffffff;
+    for( i = 0; i < 8; i++ )
+        r[i] = ( t[i] & mask ) | ( r[i] & ~mask );
+}
+
+static void fe_cswap( x25519_fe a, x25519_fe b, uint32_t swap )
+{
+    uint32_t mask = 0 - swap, x;
+    int i;
+
+    for( i = 0; i < 8; i++ )
+    {
+        x = ( a[i] ^ b[i] ) & mask;
+        a[i] ^= x;
+        b[i] ^= x;
+    }
+}
+
+/* mbedtls_mpi values, as 32 big-endian bytes, to words and back */
+static int fe_read_mpi( x25519_fe r, const mbedtls_mpi *X )
+{
+    int ret;
+    unsigned char buf[32];
+    int i;
+
+    MBEDTLS_MPI_CHK( mbedtls_mpi_write_binary( X, buf, sizeof( buf ) ) );
+    for( i = 0; i < 8; i++ )
+    {
+        const unsigned char *b = buf + 28 - 4 * i;
+        r[i] = ( (uint32_t) b[0] << 24 ) | ( (uint32_t) b[1] << 16 ) |
+               ( (uint32_t) b[2] << 8 ) | b[3];
+    }
+
+cleanup:
+    mbedtls_zeroize( buf, sizeof( buf ) );
+    return( ret );
+}
+
+static int fe_write_mpi( mbedtls_mpi *X, const x25519_fe a )
+{
+    unsigned char buf[32];
+    int i;
+
+    for( i = 0; i < 8; i++ )
+    {
+        unsigned char *b = buf + 28 - 4 * i;
+        b[0] = (unsigned char)( a[i] >> 24 );
+        b[1] = (unsigned char)( a[i] >> 16 );
+        b[2] = (unsigned char)( a[i] >> 8 );
+        b[3] = (unsigned char)( a[i] );
+    }
+    return( mbedtls_mpi_read_binary( X, buf, sizeof( buf ) ) );
+}
+
+int mbedtls_ecp_fast_curve25519_mul( const mbedtls_ecp_group *grp, mbedtls_ecp_point *R,
+                                     const mbedtls_mpi *m, const mbedtls_ecp_point *P )
+{
+    int ret;
+    x25519_fe k, x1, x2, z2, x3, z3, a, aa, b, bb, e, c, d, da, cb;
+    uint32_t swap = 0, bit;
+    int i;
+
+    (void) grp;
+
+    MBEDTLS_MPI_CHK( fe_read_mpi( k, m ) );
+    /* mbedtls_ecp_check_pubkey leaves u below 2^255 */
+    MBEDTLS_MPI_CHK( fe_read_mpi( x1, &P->X ) );
+
+    memset( x2, 0, sizeof( x2 ) );
+    x2[0] = 1;
+    memset( z2, 0, sizeof( z2 ) );
+    memcpy( x3, x1, sizeof( x3 ) );
+    memset( z3, 0, sizeof( z3 ) );
+    z3[0] = 1;
+
+    /* mbedtls_ecp_check_privkey leaves bit 254 as the top bit */
+    for( i = 254; i >= 0; i-- )
+    {
+        bit = ( k[i / 32] >> ( i % 32 ) ) & 1;
+        swap ^= bit;
+        fe_cswap( x2, x3, swap );
+        fe_cswap( z2, z3, swap );
+        swap = bit;
+
+        fe_add( a, x2, z2 );
+        fe_sqr( aa, a );
+        fe_sub( b, x2, z2 );
+        fe_sqr( bb, b );
+        fe_sub( e, aa, bb );
+        fe_add( c, x3, z3 );
+        fe_sub( d, x3, z3 );
+        fe_mul( da, d, a );
+        fe_mul( cb, c, b );
+        fe_add( x3, da, cb );
+        fe_sqr( x3, x3 );
+        fe_sub( z3, da, cb );
+        fe_sqr( z3, z3 );
+        fe_mul( z3, z3, x1 );
+        fe_mul( x2, aa, bb );
+        fe_mul_a24( z2, e );
+        fe_add( z2, z2, aa );
+        fe_mul( z2, z2, e );
+    }
+    fe_cswap( x2, x3, swap );
+    fe_cswap( z2, z3, swap );
+
+    /* as ecp_normalize_mxz, which fails to invert Z = 0 */
+    fe_reduce( z2 );
+    for( i = 0, bit = 0; i < 8; i++ )
+        bit |= z2[i];
+    if( bit == 0 )
+    {
+        ret = MBEDTLS_ERR_MPI_NOT_ACCEPTABLE;
+        goto cleanup;
+    }
+
+    fe_inv( z2, z2 );
+    fe_mul( x2, x2, z2 );
+    fe_reduce( x2 );
+
+    MBEDTLS_MPI_CHK( fe_write_mpi( &R->X, x2 ) );
+    mbedtls_mpi_free( &R->Y );
+    MBEDTLS_MPI_CHK( mbedtls_mpi_lset( &R->Z, 1 ) );
+
+cleanup:
+    mbedtls_zeroize( k, sizeof( k ) );
+    mbedtls_zeroize( x2, sizeof( x2 ) );
+    mbedtls_zeroize( z2, sizeof( z2 ) );
+    mbedtls_zeroize( x3, sizeof( x3 ) );
+    mbedtls_zeroize( z3, sizeof( z3 ) );
+
+    return( ret );
+}
+
+#endif /* MBEDTLS_ECP_C && MBEDTLS_ECP_FAST_CURVE25519 && MBEDTLS_ECP_DP_CURVE25519_ENABLED */
@@ -0,0 +1,675 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * secp256r1 point multiplication, enabled with MBEDTLS_ECP_FAST_SECP256R1
+ *
+ * Field elements are eight 32-bit words in Montgomery form (R = 2^256),
+ * and points are in Jacobian coordinates with Z = 0 for the point at
+ * infinity. The table lookups and the additions of the point at infinity
+ * are branch-free, so the time taken does not depend on the scalar.
+ *
+ * The base point is multiplied with a 5-bit comb over a table in flash,
+ * any other point with 4-bit fixed windows over a table on the stack.
+ */
+
+#if !defined(MBEDTLS_CONFIG_FILE)
+#include "mbedtls/config.h"
+#else
+#include MBEDTLS_CONFIG_FILE
+#endif
+
+#if defined(MBEDTLS_ECP_C) && defined(MBEDTLS_ECP_FAST_SECP256R1) && \
+    defined(MBEDTLS_ECP_DP_SECP256R1_ENABLED)
+
+#include "mbedtls/ecp.h"
+#include "mbedtls/ecp_internal.h"
+
+#include <stdint.h>
+#include <string.h>
+
+typedef uint32_t p256_fe[8];
+
+typedef struct {
+    p256_fe x, y, z;
+} p256_jac;
+
+typedef struct {
+    p256_fe x, y;
+} p256_aff;
+
+#define COMB_TEETH      5
+#define COMB_SPACING    52  /* ceil(256 / COMB_TEETH) */
+#define WINDOW_BITS     4
+
+static const p256_fe p256_p = {
+    0xffffffff, 0xffffffff, 0xffffffff, 0x00000000,
+    0x00000000, 0x00000000, 0x00000001, 0xffffffff
+};
+
+/* p - 2, the exponent of the inversion */
+static const p256_fe p256_p_minus_2 = {
+    0xfffffffd, 0xffffffff, 0xffffffff, 0x00000000,
+    0x00000000, 0x00000000, 0x00000001, 0xffffffff
+};
+
+/* R^2 mod p, to convert into Montgomery form */
+static const p256_fe p256_rr = {
+    0x00000003, 0x00000000, 0xffffffff, 0xfffffffb,
+    0xfffffffe, 0xffffffff, 0xfffffffd, 0x00000004
+};
+
+/* R mod p, one in Montgomery form */
+static const p256_fe p256_one = {
+    0x00000001, 0x00000000, 0x00000000, 0xffffffff,
+    0xffffffff, 0xffffffff, 0xfffffffe, 0x00000000
+};
+
+/*
+ * Comb table of the base point: entry u - 1 is the affine point
+ * sum( u_j * 2^(52 j) * G ) over the bits u_j of u, in Montgomery form.
+ */
+static const p256_aff p256_comb[( 1 << COMB_TEETH ) - 1] = {
+    { { 0x18a9143c, 0x79e730d4, 0x5fedb601, 0x75ba95fc,
+        0x77622510, 0x79fb732b, 0xa53755c6, 0x18905f76 },
+      { 0xce95560a, 0xddf25357, 0xba19e45c, 0x8b4ab8e4,
+        0xdd21f325, 0xd2e88688, 0x25885d85, 0x8571ff18 } },
+    { { 0xceca9754, 0x83f49167, 0x4b7939a0, 0x426d2cf6,
+        0x723fd0bf, 0x2555e355, 0xc4f144e2, 0xa96e6d06 },
+      { 0x87880e61, 0x4768a8dd, 0xe508e4d5, 0x15543815,
+        0xb1b65e15, 0x09d7e772, 0xac302fa0, 0x63439dd6 } },
+    { { 0xa0be5d0e, 0xf2675562, 0x4d1bb068, 0x4b524d25,
+        0xa9b75b8c, 0xbc2c5ff2, 0xd9a6f548, 0x4f326643 },
+      { 0x1258835e, 0x50dd6844, 0x676090e0, 0x7d21beee,
+        0xf4a17b42, 0xb0b62c65, 0xb3cec3b0, 0x60dfae28 } },
+    { { 0xcf7d62d2, 0x20d3c982, 0x23ba8150, 0x1f36e29d,
+        0x92763f9e, 0x48ae0bf0, 0x1d3a7007, 0x7a527e6b },
+      { 0x581a85e3, 0xb4a89097, 0xdc158be5, 0x1f1a520f,
+        0x167d726e, 0xf98db37d, 0x1113e862, 0x8802786e } },
+    { { 0xb113f918, 0x531e7b64, 0x920a681d, 0x26b5d70a,
+        0x24c37044, 0x04e52f8f, 0xbb7c375b, 0xbc7c9542 },
+      { 0xf2e26375, 0xb63a044b, 0xe922a3d0, 0xd842a342,
+        0xa9292d57, 0x9eed2eca, 0x49ac7832, 0xfe27d2c2 } },
+    { { 0xf24aab7e, 0xedbd7944, 0xcd1a1921, 0x56e51d9e,
+        0x962dae55, 0x11c63188, 0x326acd14, 0x37090565 },
+      { 0xd71ed134, 0xc436e587, 0xad89b461, 0x3d96ac3a,
+        0xdcb718bb, 0xcdf570bc, 0xdcfabde2, 0xaaa490e9 } },
+    { { 0x0b639942, 0xb0ab5401, 0x19379664, 0xa6e12f57,
+        0x1d040abc, 0xc535f8b4, 0xa75eef24, 0xef255c54 },
+      { 0xaeceb0ea, 0xb236f734, 0x9d879e2f, 0x38fcc8c1,
+        0x180cacab, 0x674d8fdc, 0xf624df06, 0x0a18bad4 } },
+    { { 0xca8d9d1a, 0x488f1185, 0xd987ded2, 0xadf2c77d,
+        0x60c46124, 0x5f3039f0, 0x71e095f4, 0xe5d70b75 },
+      { 0x6260e70f, 0x82d58650, 0xf750d105, 0x39d75ea7,
+        0x75bac364, 0x8cf3d0b1, 0x21d01329, 0xf3a7564d } },
+    { { 0x60530d0a, 0x83fc8091, 0x7bc23dc8, 0x58c24f52,
+        0xa653af5a, 0xecde2f1f, 0xb10e511e, 0xb2e2a374 },
+      { 0x9bebe1e4, 0xf0c54b32, 0xade42270, 0x239c25df,
+        0x9f22b433, 0xd866f55e, 0xed17efd3, 0x1e513ca2 } },
+    { { 0x5bc98e0d, 0x66313dc8, 0x9a256888, 0xb13fe4e6,
+        0xecd6e280, 0x74816589, 0x5ba88474, 0xdee13cde },
+      { 0xc53bc78d, 0xae4e1872, 0x2f08a464, 0x9b79904a,
+        0x9da51935, 0xef6e5ce2, 0x083c47ea, 0x9e58df82 } },
+    { { 0xf5a32632, 0x4e066713, 0x4b36f498, 0x431f75d4,
+        0x70bd5f07, 0x40ae279f, 0x239ec23d, 0x252cdb93 },
+      { 0x7312a246, 0xc18dddf8, 0x23a9e561, 0x5b77673c,
+        0x1715fede, 0x020f09c3, 0xa580cfc5, 0xabef6451 } },
+    { { 0xf2a0d962, 0x3c8bc3bf, 0x3405a8aa, 0x59f856ee,
+        0xb3dc5948, 0x2fb6590c, 0xed85740e, 0xc8aa740c },
+      { 0xe9aafe19, 0xf8081cfb, 0x2534800d, 0xf7d2e1f3,
+        0x8d78d247, 0x355148c2, 0xd1557399, 0xaf0dc5a4 } },
+    { { 0xc7f68782, 0x34dfbfc4, 0x08ac2685, 0x2c6a80d6,
+        0x08d0255b, 0x5479e1bc, 0x9110c616, 0x42eb9de0 },
+      { 0x10b4acba, 0x97991dd8, 0x94d997c7, 0xf36acc8f,
+        0x69ddc036, 0xd05ad78b, 0xe68b4243, 0x1ac7e528 } },
+    { { 0xe82c8e2a, 0xdd9f8a00, 0x21f80126, 0x104b85c6,
+        0x5b17a522, 0x1997228d, 0x923d0bd0, 0x706e5ec3 },
+      { 0x1dc33622, 0x00c6af27, 0x271f09e1, 0xb3bc76c8,
+        0xe36e325a, 0xec1b7c0b, 0x68f12bfe, 0x128200e2 } },
+    { { 0xa8636d07, 0x8e86cb3d, 0x2be46da2, 0xc79c42ac,
+        0xaa01e0e1, 0xed70e08a, 0xe3b69272, 0x773579fc },
+      { 0x4d8464c3, 0xbc0fe555, 0xcf54e071, 0x9e87a057,
+        0x3913b1d3, 0xda655b0a, 0x9a55dba4, 0x052774d4 } },
+    { { 0xadf7cccf, 0x75d9bc15, 0xdfa1e1b0, 0x81a3e5d6,
+        0x249bc17e, 0x8c39e444, 0x8ea7fd43, 0xf37dccb2 },
+      { 0x907fba12, 0xda654873, 0x4a372904, 0x35daa6da,
+        0x6283a6c5, 0x0564cfc6, 0x4a9395bf, 0xd09fa4f6 } },
+    { { 0xe37542ca, 0xb1f5c026, 0x72e01034, 0x0b860cf3,
+        0x025289f2, 0x3a7c10e4, 0x92901032, 0xd2197d5f },
+      { 0x267ca2f6, 0xfa06f835, 0xbf6e43aa, 0x8fcb9a29,
+        0x7ed9f8e7, 0x465f6c11, 0xe6077aaf, 0x8a50a5b3 } },
+    { { 0xd2b59e85, 0xad76c703, 0x9204c53f, 0x0a230645,
+        0x4a9f1335, 0x9bbc0bc4, 0xd0a967e9, 0x71603515 },
+      { 0xa0205375, 0x8b6d6d6e, 0x51ad76de, 0x63104183,
+        0xaabbd0ac, 0x5abfbc21, 0xc71f3060, 0x61fb45c3 } },
+    { { 0x1d323961, 0x579345df, 0x94cd3bc4, 0x45b79ead,
+        0x423668d2, 0x50b664be, 0x42bc26ea, 0x19dd5b75 },
+      { 0x3677ae8f, 0xc7c1fbaa, 0x5d033158, 0x7b2e711a,
+        0x8942ac93, 0x8aecb50a, 0x8a16718c, 0xe255438b } },
+    { { 0x33396533, 0x80253642, 0x2c5ad150, 0x82cb33a7,
+        0x070ca168, 0x7c147998, 0x6aac6636, 0x07791253 },
+      { 0x7c78be24, 0x160003ae, 0xa30eeabf, 0xbba9fe68,
+        0x3073f0ed, 0x16c31c40, 0x789caeca, 0xd329cd28 } },
+    { { 0x7972bcdf, 0x840dbcbf, 0xbd11900c, 0xb5c8444f,
+        0x16520cee, 0x78b2b290, 0xbe88d914, 0xe19f13a3 },
+      { 0x49d3c0df, 0x052ddc89, 0xe0b4224b, 0xc9fc183c,
+        0xcf31e0bb, 0x2c8dd074, 0xa26b1441, 0x872c7b95 } },
+    { { 0x74c8a327, 0xed93585d, 0x06be87ca, 0xf2fb7d08,
+        0x84e36244, 0x707d83ca, 0x3efa6833, 0x037f499d },
+      { 0x99bf5dde, 0xf3218d42, 0x69ff7ce3, 0xbe0a81c0,
+        0x9eb7d4c0, 0x068fbbea, 0xe6938c78, 0xf4ef6609 } },
+    { { 0xcb22715e, 0x202e5c5a, 0x288f8243, 0x88e93d23,
+        0xdc7eace6, 0xdf1d1f52, 0x373183f8, 0xc6b38b3b },
+      { 0x3eac9c4b, 0x77798b7f, 0x6bfa9835, 0xa9d37dff,
+        0xfaac41c9, 0xaff4a447, 0x0fcb6036, 0xf14fd13c } },
+    { { 0x49ccc093, 0xef5ee27d, 0x40d359a3, 0x7ff3263d,
+        0xc6d6c0ea, 0x885d1942, 0x28c97fee, 0x925abba3 },
+      { 0x5d95f52d, 0xd7383480, 0x4eb691db, 0x6979981c,
+        0x553a29c6, 0x6544e8ae, 0x5043559f, 0x28324ef8 } },
+    { { 0x300c0e39, 0xd6c8e4b7, 0x3e37f58a, 0x37ad4a1a,
+        0xe5e8cdfb, 0x763330f5, 0x870ea133, 0x62bf8c2c },
+      { 0x763ccac9, 0x03fbc63a, 0xfb1886c0, 0xc889d8a5,
+        0xbe49d9fe, 0xf0486de5, 0x62c23338, 0xaf9a8778 } },
+    { { 0x76aa81b3, 0x8a43a2a1, 0x8a0cc3d2, 0x89602129,
+        0x821f6640, 0x49d311e8, 0x5c734ae4, 0x8035608f },
+      { 0x349adc3b, 0xa7be0561, 0x96a337b5, 0x328525b2,
+        0x6bccf78a, 0x575413c3, 0x4854960f, 0x6c7292ec } },
+    { { 0x3c2943ff, 0x121e6a71, 0x6374c47e, 0x0468565c,
+        0x2826f138, 0xd66fe993, 0x7748e3ac, 0x4e2cfaf1 },
+      { 0x4708a6c8, 0xe9baaa2c, 0x66ffb5b4, 0xa3845c8c,
+        0xb77c8fac, 0xad3e293e, 0x440a35e8, 0x00b5cfa9 } },
+    { { 0x63e06277, 0x3f55f58c, 0x64ba6e8c, 0x1a81de8a,
+        0xf4cc043b, 0x85cfdc74, 0x048d26e0, 0x7cbefb98 },
+      { 0x82aba891, 0x5bde4b3c, 0x86db6f46, 0x863d8f75,
+        0x845186c5, 0xc7af5c1f, 0xcb527cec, 0x41d7d404 } },
+    { { 0x83e1a246, 0x3b446994, 0xf6b819a2, 0x11c5ced4,
+        0xaff79a46, 0xc79d4660, 0x5f22411a, 0x423bbdc1 },
+      { 0xa964039d, 0x22652251, 0xe738657b, 0x808d6753,
+        0x4e909dc8, 0xc0ca19e3, 0x34ab0d07, 0x0e036e47 } },
+    { { 0x7a26f742, 0x233593e7, 0xfc0f14d9, 0xddc1c79f,
+        0x2d359358, 0xb33c8980, 0x730aacfe, 0x51df6155 },
+      { 0x0f2c0b8d, 0xa9a6066c, 0x2e706f80, 0xb9212227,
+        0x96a5efe9, 0x3994a532, 0x52316b12, 0xcf3d168b } },
+    { { 0x27eafcc0, 0xbe47dd50, 0xec7e66db, 0x23df1041,
+        0x78a4dddd, 0x18c977ff, 0x9d2d152e, 0xb51565d7 },
+      { 0x78f4a4de, 0x24f6a6d5, 0x7d86b2ca, 0xbbc15b20,
+        0x1d3b43ca, 0xa064d39c, 0x52200839, 0x55248667 } }
+};
+
+/* Implementation that should never be optimized out by the compiler */
+static void mbedtls_zeroize( void *v, size_t n ) {
+    volatile unsigned char *p = v; while( n-- ) *p++ = 0;
+}
+
+/* Select a if mask is all ones, b if zero */
+static void fe_select( p256_fe r, const p256_fe a, const p256_fe b, uint32_t mask )
+{
+    int i;
+    for( i = 0; i < 8; i++ )
+        r[i] = ( a[i] & mask ) | ( b[i] & ~mask );
+}
+
+/* All ones if a is zero, zero otherwise */
+static uint32_t fe_is_zero( const p256_fe a )
+{
+    uint32_t acc = 0;
+    int i;
+    for( i = 0; i < 8; i++ )
+        acc |= a[i];
+    return( (uint32_t)( ( (uint64_t)acc - 1 ) >> 32 ) );
+}
+
+/* r = a - p if a + carry * 2^256 >= p, else a */
+static void fe_reduce_once( p256_fe r, const p256_fe a, uint32_t carry )
+{
+    p256_fe t;
+    uint64_t d;
+    uint32_t borrow = 0;
+    int i;
+
+    for( i = 0; i < 8; i++ )
+    {
+        d = (uint64_t) a[i] - p256_p[i] - borrow;
+        t[i] = (uint32_t) d;
+        borrow = (uint32_t)( d >> 63 );
+    }
+    /* keep a only if it was below p and had no carry */
+    fe_select( r, a, t, 0 - ( borrow & ~carry & 1 ) );
+}
+
+static void fe_add( p256_fe r, const p256_fe a, const p256_fe b )
+{
+    uint64_t c = 0;
+    int i;
+
+    for( i = 0; i < 8; i++ )
+    {
+        c += (uint64_t) a[i] + b[i];
+        r[i] = (uint32_t) c;
+        c >>= 32;
+    }
+    fe_reduce_once( r, r, (uint32_t) c );
+}
+
+static void fe_sub( p256_fe r, const p256_fe a, const p256_fe b )
+{
+    uint64_t c;
+    uint32_t borrow = 0, mask;
+    int i;
+
+    for( i = 0; i < 8; i++ )
+    {
+        c = (uint64_t) a[i] - b[i] - borrow;
+        r[i] = (uint32_t) c;
+        borrow = (uint32_t)( c >> 63 );
+    }
+    /* add p back on borrow */
+    mask = 0 - borrow;
+    c = 0;
+    for( i = 0; i < 8; i++ )
+    {
+        c += (uint64_t) r[i] + ( p256_p[i] & mask );
+        r[i] = (uint32_t) c;
+        c >>= 32;
+    }
+}
+
+/*
+ * Montgomery multiplication r = a * b / R mod p (CIOS). -p^-1 mod 2^32 is 1,
+ * so the multiple of p added at each step is the low word itself.
+ */
+static void fe_mul( p256_fe r, const p256_fe a, const p256_fe b )
+{
+    uint32_t t[10] = { 0 };
+    uint32_t m;
+    uint64_t c;
+    int i, j;
+
+    for( i = 0; i < 8; i++ )
+    {
+        c = 0;
+        for( j = 0; j < 8; j++ )
+        {
+            c += (uint64_t) a[i] * b[j] + t[j];
+            t[j] = (uint32_t) c;
+            c >>= 32;
+        }
+        c += t[8];
+        t[8] = (uint32_t) c;
+        t[9] = (uint32_t)( c >> 32 );
+
+        m = t[0];
+        c = ( (uint64_t) m * p256_p[0] + t[0] ) >> 32;
+        for( j = 1; j < 8; j++ )
+        {
+            c += (uint64_t) m * p256_p[j] + t[j];
+            t[j - 1] = (uint32_t) c;
+            c >>= 32;
+        }
+        c += t[8];
+        t[7] = (uint32_t) c;
+        t[8] = t[9] + (uint32_t)( c >> 32 );
+    }
+
+    fe_reduce_once( r, t, t[8] );
+}
+
+static void fe_sqr( p256_fe r, const p256_fe a )
+{
+    fe_mul( r, a, a );
+}
+
+/* r = a^(p - 2), the exponent is public */
+static void fe_inv( p256_fe r, const p256_fe a )
+{
+    p256_fe t;
+    int i;
+
+    memcpy( t, p256_one, sizeof( t ) );
+    for( i = 255; i >= 0; i-- )
+    {
+        fe_sqr( t, t );
+        if( ( p256_p_minus_2[i / 32] >> ( i % 32 ) ) & 1 )
+            fe_mul( t, t, a );
+    }
+    memcpy( r, t, sizeof( t ) );
+}
+
+/* Big-endian bytes, as mbedtls_mpi_write_binary, to plain words */
+static void fe_from_bytes( p256_fe r, const unsigned char buf[32] )
+{
+    int i;
+    for( i = 0; i < 8; i++ )
+    {
+        const unsigned char *b = buf + 28 - 4 * i;
+        r[i] = ( (uint32_t) b[0] << 24 ) | ( (uint32_t) b[1] << 16 ) |
+               ( (uint32_t) b[2] << 8 ) | b[3];
+    }
+}
+
+static void fe_to_bytes( unsigned char buf[32], const p256_fe a )
+{
+    int i;
+    for( i = 0; i < 8; i++ )
+    {
+        unsigned char *b = buf + 28 - 4 * i;
+        b[0] = (unsigned char)( a[i] >> 24 );
+        b[1] = (unsigned char)( a[i] >> 16 );
+        b[2] = (unsigned char)( a[i] >> 8 );
+        b[3] = (unsigned char)( a[i] );
+    }
+}
+
+static int fe_read_mpi( p256_fe r, const mbedtls_mpi *X )
+{
+    int ret;
+    unsigned char buf[32];
+    p256_fe t;
+
+    MBEDTLS_MPI_CHK( mbedtls_mpi_write_binary( X, buf, sizeof( buf ) ) );
+    fe_from_bytes( t, buf );
+    fe_mul( r, t, p256_rr );
+
+cleanup:
+    return( ret );
+}
+
+static int fe_write_mpi( mbedtls_mpi *X, const p256_fe a )
+{
+    static const p256_fe plain_one = { 1, 0, 0, 0, 0, 0, 0, 0 };
+    unsigned char buf[32];
+    p256_fe t;
+
+    fe_mul( t, a, plain_one );
+    fe_to_bytes( buf, t );
+    return( mbedtls_mpi_read_binary( X, buf, sizeof( buf ) ) );
+}
+
+/*
+ * Doubling for A = -3 (dbl-2001-b), Z = 0 stays the point at infinity
+ */
+static void point_double( p256_jac *r, const p256_jac *p )
+{
+    p256_fe delta, gamma, beta, alpha, t;
+
+    fe_sqr( delta, p->z );
+    fe_sqr( gamma, p->y );
+    fe_mul( beta, p->x, gamma );
+
+    fe_sub( t, p->x, delta );
+    fe_add( alpha, p->x, delta );
+    fe_mul( alpha, alpha, t );
+    fe_add( t, alpha, alpha );
+    fe_add( alpha, alpha, t );
+
+    fe_add( r->z, p->y, p->z );
+    fe_sqr( r->z, r->z );
+    fe_sub( r->z, r->z, gamma );
+    fe_sub( r->z, r->z, delta );
+
+    fe_add( beta, beta, beta );
+    fe_add( beta, beta, beta );
+    fe_sqr( r->x, alpha );
+    fe_sub( r->x, r->x, beta );
+    fe_sub( r->x, r->x, beta );
+
+    fe_sub( beta, beta, r->x );
+    fe_mul( r->y, alpha, beta );
+    fe_sqr( gamma, gamma );
+    fe_add( gamma, gamma, gamma );
+    fe_add( gamma, gamma, gamma );
+    fe_add( gamma, gamma, gamma );
+    fe_sub( r->y, r->y, gamma );
+}
+
+/*
+ * r = p + q with q affine (madd-2007-bl), q skipped unless q_mask is all
+ * ones. r may alias p.
+ */
+static void point_add_affine( p256_jac *r, const p256_jac *p, const p256_aff *q,
+                              uint32_t q_mask )
+{
+    p256_fe z1z1, u2, s2, h, hh, i, j, rr, v;
+    p256_jac s;
+    uint32_t p_inf = fe_is_zero( p->z );
+
+    fe_sqr( z1z1, p->z );
+    fe_mul( u2, q->x, z1z1 );
+    fe_mul( s2, q->y, p->z );
+    fe_mul( s2, s2, z1z1 );
+    fe_sub( h, u2, p->x );
+    fe_sub( rr, s2, p->y );
+
+    if( ( fe_is_zero( h ) & fe_is_zero( rr ) & ~p_inf & q_mask ) != 0 )
+    {
+        /* p == q, only reached for points the comb can not produce */
+        point_double( r, p );
+        return;
+    }
+
+    fe_add( rr, rr, rr );
+    fe_sqr( hh, h );
+    fe_add( i, hh, hh );
+    fe_add( i, i, i );
+    fe_mul( j, h, i );
+    fe_mul( v, p->x, i );
+
+    fe_sqr( s.x, rr );
+    fe_sub( s.x, s.x, j );
+    fe_sub( s.x, s.x, v );
+    fe_sub( s.x, s.x, v );
+
+    fe_sub( v, v, s.x );
+    fe_mul( s.y, rr, v );
+    fe_mul( j, j, p->y );
+    fe_add( j, j, j );
+    fe_sub( s.y, s.y, j );
+
+    fe_add( s.z, p->z, h );
+    fe_sqr( s.z, s.z );
+    fe_sub( s.z, s.z, z1z1 );
+    fe_sub( s.z, s.z, hh );
+
+    /* p at infinity gives q, q skipped gives p */
+    fe_select( s.x, q->x, s.x, p_inf );
+    fe_select( s.y, q->y, s.y, p_inf );
+    fe_select( s.z, p256_one, s.z, p_inf );
+    fe_select( r->x, s.x, p->x, q_mask );
+    fe_select( r->y, s.y, p->y, q_mask );
+    fe_select( r->z, s.z, p->z, q_mask );
+}
+
+/*
+ * r = p + q (add-2007-bl), either may be the point at infinity. r may
+ * alias p.
+ */
+static void point_add( p256_jac *r, const p256_jac *p, const p256_jac *q )
+{
+    p256_fe z1z1, z2z2, u1, u2, s1, s2, h, i, j, rr, v;
+    p256_jac s;
+    uint32_t p_inf = fe_is_zero( p->z );
+    uint32_t q_inf = fe_is_zero( q->z );
+
+    fe_sqr( z1z1, p->z );
+    fe_sqr( z2z2, q->z );
+    fe_mul( u1, p->x, z2z2 );
+    fe_mul( u2, q->x, z1z1 );
+    fe_mul( s1, p->y, q->z );
+    fe_mul( s1, s1, z2z2 );
+    fe_mul( s2, q->y, p->z );
+    fe_mul( s2, s2, z1z1 );
+    fe_sub( h, u2, u1 );
+    fe_sub( rr, s2, s1 );
+
+    if( ( fe_is_zero( h ) & fe_is_zero( rr ) & ~p_inf & ~q_inf ) != 0 )
+    {
+        point_double( r, p );
+        return;
+    }
+
+    fe_add( rr, rr, rr );
+    fe_add( i, h, h );
+    fe_sqr( i, i );
+    fe_mul( j, h, i );
+    fe_mul( v, u1, i );
+
+    fe_sqr( s.x, rr );
+    fe_sub( s.x, s.x, j );
+    fe_sub( s.x, s.x, v );
+    fe_sub( s.x, s.x, v );
+
+    fe_sub( v, v, s.x );
+    fe_mul( s.y, rr, v );
+    fe_mul( j, j, s1 );
+    fe_add( j, j, j );
+    fe_sub( s.y, s.y, j );
+
+    fe_add( s.z, p->z, q->z );
+    fe_sqr( s.z, s.z );
+    fe_sub( s.z, s.z, z1z1 );
+    fe_sub( s.z, s.z, z2z2 );
+    fe_mul( s.z, s.z, h );
+
+    fe_select( s.x, q->x, s.x, p_inf );
+    fe_select( s.y, q->y, s.y, p_inf );
+    fe_select( s.z, q->z, s.z, p_inf );
+    fe_select( r->x, p->x, s.x, q_inf );
+    fe_select( r->y, p->y, s.y, q_inf );
+    fe_select( r->z, p->z, s.z, q_inf );
+}
+
+static uint32_t scalar_bit( const p256_fe k, unsigned int i )
+{
+    return( i < 256 ? ( k[i / 32] >> ( i % 32 ) ) & 1 : 0 );
+}
+
+/* All ones if a == b */
+static uint32_t index_mask( uint32_t a, uint32_t b )
+{
+    return( (uint32_t)( ( (uint64_t)( a ^ b ) - 1 ) >> 32 ) );
+}
+
+static void mul_base( p256_jac *r, const p256_fe k )
+{
+    p256_aff q;
+    unsigned int i, j, u;
+
+    memset( r, 0, sizeof( *r ) );
+    for( i = COMB_SPACING; i-- > 0; )
+    {
+        point_double( r, r );
+
+        u = 0;
+        for( j = 0; j < COMB_TEETH; j++ )
+            u |= scalar_bit( k, j * COMB_SPACING + i ) << j;
+
+        memset( &q, 0, sizeof( q ) );
+        for( j = 1; j < ( 1 << COMB_TEETH ); j++ )
+        {
+            uint32_t mask = index_mask( j, u );
+            fe_select( q.x, p256_comb[j - 1].x, q.x, mask );
+            fe_select( q.y, p256_comb[j - 1].y, q.y, mask );
+        }
+        point_add_affine( r, r, &q, ~index_mask( 0, u ) );
+    }
+}
+
+static void mul_point( p256_jac *r, const p256_fe k, const p256_aff *p )
+{
+    p256_jac table[1 << WINDOW_BITS];
+    p256_jac q;
+    unsigned int i, j, u;
+
+    /* table[j] = j * p */
+    memset( &table[0], 0, sizeof( table[0] ) );
+    memcpy( table[1].x, p->x, sizeof( p256_fe ) );
+    memcpy( table[1].y, p->y, sizeof( p256_fe ) );
+    memcpy( table[1].z, p256_one, sizeof( p256_fe ) );
+    for( j = 2; j < ( 1 << WINDOW_BITS ); j++ )
+        point_add_affine( &table[j], &table[j - 1], p, 0xffffffff );
+
+    memset( r, 0, sizeof( *r ) );
+    for( i = 256 / WINDOW_BITS; i-- > 0; )
+    {
+        for( j = 0; j < WINDOW_BITS; j++ )
+            point_double( r, r );
+
+        u = ( k[i * WINDOW_BITS / 32] >> ( ( i * WINDOW_BITS ) % 32 ) ) &
+            ( ( 1 << WINDOW_BITS ) - 1 );
+
+        memset( &q, 0, sizeof( q ) );
+        for( j = 1; j < ( 1 << WINDOW_BITS ); j++ )
+        {
+            uint32_t mask = index_mask( j, u );
+            fe_select( q.x, table[j].x, q.x, mask );
+            fe_select( q.y, table[j].y, q.y, mask );
+            fe_select( q.z, table[j].z, q.z, mask );
+        }
+        point_add( r, r, &q );
+    }
+
+    mbedtls_zeroize( table, sizeof( table ) );
+}
+
+int mbedtls_ecp_fast_secp256r1_mul( const mbedtls_ecp_group *grp, mbedtls_ecp_point *R,
+                                    const mbedtls_mpi *m, const mbedtls_ecp_point *P )
+{
+    int ret;
+    unsigned char buf[32];
+    p256_fe k, zi, zzi;
+    p256_aff p;
+    p256_jac r;
+
+    MBEDTLS_MPI_CHK( mbedtls_mpi_write_binary( m, buf, sizeof( buf ) ) );
+    fe_from_bytes( k, buf );
+
+    if( mbedtls_mpi_cmp_mpi( &P->X, &grp->G.X ) == 0 &&
+        mbedtls_mpi_cmp_mpi( &P->Y, &grp->G.Y ) == 0 )
+    {
+        mul_base( &r, k );
+    }
+    else
+    {
+        MBEDTLS_MPI_CHK( fe_read_mpi( p.x, &P->X ) );
+        MBEDTLS_MPI_CHK( fe_read_mpi( p.y, &P->Y ) );
+        mul_point( &r, k, &p );
+    }
+
+    if( fe_is_zero( r.z ) )
+    {
+        ret = mbedtls_ecp_set_zero( R );
+        goto cleanup;
+    }
+
+    fe_inv( zi, r.z );
+    fe_sqr( zzi, zi );
+    fe_mul( r.x, r.x, zzi );
+    fe_mul( zzi, zzi, zi );
+    fe_mul( r.y, r.y, zzi );
+
+    MBEDTLS_MPI_CHK( fe_write_mpi( &R->X, r.x ) );
+    MBEDTLS_MPI_CHK( fe_write_mpi( &R->Y, r.y ) );
+    MBEDTLS_MPI_CHK( mbedtls_mpi_lset( &R->Z, 1 ) );
+
+cleanup:
+    mbedtls_zeroize( buf, sizeof( buf ) );
+    mbedtls_zeroize( k, sizeof( k ) );
+    mbedtls_zeroize( &r, sizeof( r ) );
+
+    return( ret );
+}
+
+#endif /* MBEDTLS_ECP_C && MBEDTLS_ECP_FAST_SECP256R1 && MBEDTLS_ECP_DP_SECP256R1_ENABLED */
@@ -0,0 +1,249 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#if !defined(MBEDTLS_CONFIG_FILE)
+#include "mbedtls/config.h"
+#else
+#include MBEDTLS_CONFIG_FILE
+#endif
+
+#include "mbed_tls_arena.h"
+
+#if defined(MBED_TLS_ARENA)
+
+#include <stdlib.h>
+#include <string.h>
+#include "platform/mbed_assert.h"
+#include "platform/mbed_critical.h"
+#if defined(MBED_CONF_RTOS_PRESENT)
+#include "cmsis_os2.h"
+#endif
+
+/*
+ * The arena is a sequence of blocks, each starting with a header holding
+ * its size, with the lowest bit set while allocated, and the size of the
+ * block before it, so freed blocks merge with both neighbours. Allocations
+ * take the first free block large enough.
+ */
+typedef struct {
+    size_t size;
+    size_t prev;
+} arena_block_t;
+
+#define ARENA_ALIGN         8
+#define ARENA_HEADER_SIZE   ((sizeof(arena_block_t) + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1))
+#define ARENA_USED          1
+
+#define BLOCK_AT(arena, offset) ((arena_block_t *)((arena)->buf + (offset)))
+#define BLOCK_SIZE(block)       ((block)->size & ~(size_t)ARENA_USED)
+
+/* Arenas set up with mbed_tls_arena_init, guarded by critical sections */
+static mbed_tls_arena_t *arenas;
+
+static void *current_thread(void)
+{
+#if defined(MBED_CONF_RTOS_PRESENT)
+    return osThreadGetId();
+#else
+    return (void *)1;
+#endif
+}
+
+void mbed_tls_arena_init( mbed_tls_arena_t *arena, void *buf, size_t size )
+{
+    uintptr_t start = ((uintptr_t)buf + ARENA_ALIGN - 1) & ~(uintptr_t)(ARENA_ALIGN - 1);
+    uintptr_t end = ((uintptr_t)buf + size) & ~(uintptr_t)(ARENA_ALIGN - 1);
+
+    memset(arena, 0, sizeof(*arena));
+    arena->buf = (unsigned char *)start;
+    if (size >= ARENA_ALIGN && end > start + ARENA_HEADER_SIZE) {
+        arena->size = end - start;
+        BLOCK_AT(arena, 0)->size = arena->size;
+        BLOCK_AT(arena, 0)->prev = 0;
+    }
+    arena->stats.reserved_size = arena->size;
+
+    core_util_critical_section_enter();
+    arena->next = arenas;
+    arenas = arena;
+    core_util_critical_section_exit();
+}
+
+void mbed_tls_arena_free( mbed_tls_arena_t *arena )
+{
+    core_util_critical_section_enter();
+    for (mbed_tls_arena_t **p = &arenas; *p; p = &(*p)->next) {
+        if (*p == arena) {
+            *p = arena->next;
+            break;
+        }
+    }
+    core_util_critical_section_exit();
+
+    arena->owner = NULL;
+    arena->depth = 0;
+    arena->size = 0;
+}
+
+void mbed_tls_arena_enter( mbed_tls_arena_t *arena )
+{
+    void *self = current_thread();
+    MBED_ASSERT(arena->owner == NULL || arena->owner == self);
+    arena->owner = self;
+    arena->depth++;
+}
+
+void mbed_tls_arena_leave( mbed_tls_arena_t *arena )
+{
+    MBED_ASSERT(arena->owner == current_thread() && arena->depth > 0);
+    if (--arena->depth == 0) {
+        arena->owner = NULL;
+    }
+}
+
+void mbed_tls_arena_stats_get( const mbed_tls_arena_t *arena, mbed_tls_arena_stats_t *stats )
+{
+    core_util_critical_section_enter();
+    *stats = arena->stats;
+    core_util_critical_section_exit();
+}
+
+static void *arena_alloc( mbed_tls_arena_t *arena, size_t len )
+{
+    size_t need = ARENA_HEADER_SIZE + ((len + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1));
+    if (len > arena->size || need > arena->size) {
+        arena->stats.alloc_fail_cnt++;
+        return NULL;
+    }
+
+    for (size_t offset = 0; offset < arena->size; offset += BLOCK_SIZE(BLOCK_AT(arena, offset))) {
+        arena_block_t *block = BLOCK_AT(arena, offset);
+        if ((block->size & ARENA_USED) || block->size < need) {
+            continue;
+        }
+
+        // Split off the rest if it can hold an allocation of its own
+        if (block->size - need >= ARENA_HEADER_SIZE + ARENA_ALIGN) {
+            arena_block_t *rest = BLOCK_AT(arena, offset + need);
+            rest->size = block->size - need;
+            rest->prev = need;
+            if (offset + block->size < arena->size) {
+                BLOCK_AT(arena, offset + block->size)->prev = rest->size;
+            }
+            block->size = need;
+        }
+
+        size_t size = block->size;
+        block->size |= ARENA_USED;
+
+        core_util_critical_section_enter();
+        arena->stats.current_size += size;
+        arena->stats.total_size += size;
+        arena->stats.alloc_cnt++;
+        if (arena->stats.current_size > arena->stats.max_size) {
+            arena->stats.max_size = arena->stats.current_size;
+        }
+        core_util_critical_section_exit();
+
+        void *ptr = (unsigned char *)block + ARENA_HEADER_SIZE;
+        memset(ptr, 0, size - ARENA_HEADER_SIZE);
+        return ptr;
+    }
+
+    arena->stats.alloc_fail_cnt++;
+    return NULL;
+}
+
+static void arena_release( mbed_tls_arena_t *arena, void *ptr )
+{
+    arena_block_t *block = (arena_block_t *)((unsigned char *)ptr - ARENA_HEADER_SIZE);
+    size_t offset = (unsigned char *)block - arena->buf;
+    MBED_ASSERT(block->size & ARENA_USED);
+
+    block->size &= ~(size_t)ARENA_USED;
+
+    core_util_critical_section_enter();
+    arena->stats.current_size -= block->size;
+    arena->stats.alloc_cnt--;
+    core_util_critical_section_exit();
+
+    // Merge with the free neighbours
+    if (offset + block->size < arena->size) {
+        arena_block_t *next = BLOCK_AT(arena, offset + block->size);
+        if (!(next->size & ARENA_USED)) {
+            block->size += next->size;
+        }
+    }
+    if (block->prev) {
+        arena_block_t *prev = BLOCK_AT(arena, offset - block->prev);
+        if (!(prev->size & ARENA_USED)) {
+            prev->size += block->size;
+            offset -= block->prev;
+            block = prev;
+        }
+    }
+    if (offset + block->size < arena->size) {
+        BLOCK_AT(arena, offset + block->size)->prev = block->size;
+    }
+}
+
+void *mbed_tls_calloc( size_t n, size_t size )
+{
+    void *self = current_thread();
+    mbed_tls_arena_t *arena;
+
+    core_util_critical_section_enter();
+    for (arena = arenas; arena; arena = arena->next) {
+        if (arena->owner == self) {
+            break;
+        }
+    }
+    core_util_critical_section_exit();
+
+    if (!arena) {
+        return calloc(n, size);
+    }
+    if (n && size > (size_t)-1 / n) {
+        arena->stats.alloc_fail_cnt++;
+        return NULL;
+    }
+    return arena_alloc(arena, n * size);
+}
+
+void mbed_tls_free( void *ptr )
+{
+    mbed_tls_arena_t *arena;
+
+    if (!ptr) {
+        return;
+    }
+
+    core_util_critical_section_enter();
+    for (arena = arenas; arena; arena = arena->next) {
+        if ((unsigned char *)ptr >= arena->buf && (unsigned char *)ptr < arena->buf + arena->size) {
+            break;
+        }
+    }
+    core_util_critical_section_exit();
+
+    if (!arena) {
+        free(ptr);
+        return;
+    }
+    arena_release(arena, ptr);
+}
+
+#endif /* MBED_TLS_ARENA */
@@ -14,11 +14,13 @@
  * limitations under the License.
  */
 
+#include "mbed_entropy_pool.h"
+
 #if defined(DEVICE_TRNG)
 
 #include "hal/trng_api.h"
 
-int mbedtls_hardware_poll( void *data, unsigned char *output, size_t len, size_t *olen ) {
+static int trng_poll( unsigned char *output, size_t len, size_t *olen ) {
     trng_t trng_obj;
     trng_init(&trng_obj);
     int ret = trng_get_bytes(&trng_obj, output, len, olen);
@@ -26,4 +28,165 @@ int mbedtls_hardware_poll( void *data, unsigned char *output, size_t len, size_t
     return ret;
 }
 
+#if defined(MBED_ENTROPY_POOL)
+
+#include <string.h>
+#include "cmsis_os2.h"
+#include "mbed_rtos_storage.h"
+#include "platform/mbed_assert.h"
+#include "platform/mbed_critical.h"
+
+/* Bytes read from the TRNG at a time by the pool thread */
+#define POOL_CHUNK_SIZE     32
+
+#define POOL_FILL_FLAG      1
+
+#define POOL_STOPPED        0
+#define POOL_STARTING       1
+#define POOL_RUNNING        2
+
+static unsigned char pool[MBED_CONF_MBEDTLS_ENTROPY_POOL_SIZE];
+static size_t pool_len;
+static volatile uint8_t pool_state = POOL_STOPPED;
+
+static uint64_t pool_thread_stk[MBED_CONF_MBEDTLS_ENTROPY_POOL_THREAD_STACK_SIZE/8];
+static mbed_rtos_storage_thread_t pool_thread_tcb;
+static const osThreadAttr_t pool_thread_attr = {
+    .name = "entropy_pool_thread",
+    .priority = osPriorityLow,
+    .stack_mem = &pool_thread_stk[0],
+    .stack_size = sizeof pool_thread_stk,
+    .cb_mem = &pool_thread_tcb,
+    .cb_size = sizeof pool_thread_tcb,
+};
+static osThreadId_t pool_thread_id;
+
+/* Guards pool and pool_len */
+static mbed_rtos_storage_mutex_t pool_mutex;
+static const osMutexAttr_t pool_mutex_attr = {
+    .name = "entropy_pool_mutex",
+    .attr_bits = osMutexPrioInherit,
+    .cb_mem = &pool_mutex,
+    .cb_size = sizeof pool_mutex,
+};
+static osMutexId_t pool_mutex_id;
+
+/* Serializes the TRNG between the pool thread and emptied pool polls */
+static mbed_rtos_storage_mutex_t trng_mutex;
+static const osMutexAttr_t trng_mutex_attr = {
+    .name = "entropy_trng_mutex",
+    .attr_bits = osMutexPrioInherit,
+    .cb_mem = &trng_mutex,
+    .cb_size = sizeof trng_mutex,
+};
+static osMutexId_t trng_mutex_id;
+
+static void zeroize( void *v, size_t n ) {
+    volatile unsigned char *p = v;
+    while( n-- ) {
+        *p++ = 0;
+    }
+}
+
+static int trng_read( unsigned char *output, size_t len, size_t *olen ) {
+    osMutexAcquire(trng_mutex_id, osWaitForever);
+    int ret = trng_poll(output, len, olen);
+    osMutexRelease(trng_mutex_id);
+    return ret;
+}
+
+static void pool_thread( void *arg ) {
+    unsigned char chunk[POOL_CHUNK_SIZE];
+    (void)arg;
+
+    for (;;) {
+        osMutexAcquire(pool_mutex_id, osWaitForever);
+        size_t space = sizeof pool - pool_len;
+        osMutexRelease(pool_mutex_id);
+
+        size_t olen = 0;
+        if (space > 0) {
+            if (space > sizeof chunk) {
+                space = sizeof chunk;
+            }
+            if (trng_read(chunk, space, &olen) != 0) {
+                olen = 0;
+            }
+        }
+
+        /* Full, or the TRNG failed: resume on the next poll */
+        if (olen == 0) {
+            osThreadFlagsWait(POOL_FILL_FLAG, osFlagsWaitAny, osWaitForever);
+            continue;
+        }
+
+        osMutexAcquire(pool_mutex_id, osWaitForever);
+        if (olen > sizeof pool - pool_len) {
+            olen = sizeof pool - pool_len;
+        }
+        memcpy(pool + pool_len, chunk, olen);
+        pool_len += olen;
+        osMutexRelease(pool_mutex_id);
+        zeroize(chunk, sizeof chunk);
+    }
+}
+
+void mbed_entropy_pool_start( void ) {
+    uint8_t expected = POOL_STOPPED;
+    if (!core_util_atomic_cas_u8((uint8_t *)&pool_state, &expected, POOL_STARTING)) {
+        return;
+    }
+
+    pool_mutex_id = osMutexNew(&pool_mutex_attr);
+    MBED_ASSERT(pool_mutex_id != NULL);
+    trng_mutex_id = osMutexNew(&trng_mutex_attr);
+    MBED_ASSERT(trng_mutex_id != NULL);
+    pool_thread_id = osThreadNew(pool_thread, NULL, &pool_thread_attr);
+    MBED_ASSERT(pool_thread_id != NULL);
+
+    pool_state = POOL_RUNNING;
+}
+
+int mbedtls_hardware_poll( void *data, unsigned char *output, size_t len, size_t *olen ) {
+    mbed_entropy_pool_start();
+
+    if (pool_state != POOL_RUNNING) {
+        /* Another thread is still starting the pool */
+        return trng_poll(output, len, olen);
+    }
+
+    osMutexAcquire(pool_mutex_id, osWaitForever);
+    size_t n = len < pool_len ? len : pool_len;
+    pool_len -= n;
+    memcpy(output, pool + pool_len, n);
+    zeroize(pool + pool_len, n);
+    osMutexRelease(pool_mutex_id);
+
+    osThreadFlagsSet(pool_thread_id, POOL_FILL_FLAG);
+
+    /* Partial output is fine, mbed TLS polls again until it has enough,
+     * but an empty pool would have it give up */
+    if (n > 0) {
+        *olen = n;
+        return 0;
+    }
+    return trng_read(output, len, olen);
+}
+
+#else
+
+void mbed_entropy_pool_start( void ) {
+}
+
+int mbedtls_hardware_poll( void *data, unsigned char *output, size_t len, size_t *olen ) {
+    return trng_poll(output, len, olen);
+}
+
+#endif
+
+#else
+
+void mbed_entropy_pool_start( void ) {
+}
+
 #endif
@@ -1620,6 +1620,18 @@ int mbedtls_mpi_exp_mod( mbedtls_mpi *X, const mbedtls_mpi *A, const mbedtls_mpi
     if( mbedtls_mpi_cmp_int( E, 0 ) < 0 )
         return( MBEDTLS_ERR_MPI_BAD_INPUT_DATA );
 
+#if defined(MBEDTLS_MPI_EXP_MOD_ALT)
+    if( mbedtls_internal_mpi_exp_mod_capable( N ) )
+    {
+        mbedtls_mpi_init( &Apos );
+        ret = mbedtls_mpi_mod_mpi( &Apos, A, N );
+        if( ret == 0 )
+            ret = mbedtls_internal_mpi_exp_mod( X, &Apos, E, N );
+        mbedtls_mpi_free( &Apos );
+        return( ret );
+    }
+#endif /* MBEDTLS_MPI_EXP_MOD_ALT */
+
     /*
      * Init temps and window size
      */
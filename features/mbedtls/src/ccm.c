@@ -40,6 +40,13 @@
 
 #include <string.h>
 
+#if defined(MBEDTLS_AES_C) && defined(MBEDTLS_CIPHER_MODE_CBC) && \
+    defined(MBEDTLS_CIPHER_MODE_CTR)
+#include "mbedtls/aes.h"
+#include "mbedtls/cipher_internal.h"
+#define CCM_AES_BLOCKS
+#endif
+
 #if defined(MBEDTLS_SELF_TEST) && defined(MBEDTLS_AES_C)
 #if defined(MBEDTLS_PLATFORM_C)
 #include "mbedtls/platform.h"
@@ -131,6 +138,72 @@ void mbedtls_ccm_free( mbedtls_ccm_context *ctx )
     for( i = 0; i < len; i++ )                                                 \
         dst[i] = src[i] ^ b[i];
 
+#if defined(CCM_AES_BLOCKS)
+/*
+ * Update the CBC-MAC state in y with whole blocks through
+ * mbedtls_aes_crypt_cbc, which leaves the MAC in the last output block.
+ * A chunk at a time, so AES hardware is set up once per chunk rather than
+ * once per block.
+ */
+static int ccm_aes_cbc_mac( mbedtls_aes_context *aes, unsigned char y[16],
+                            const unsigned char *input, size_t length )
+{
+    int ret;
+    unsigned char out[128];
+    size_t use_len;
+
+    while( length > 0 )
+    {
+        use_len = length < sizeof( out ) ? length : sizeof( out );
+
+        if( ( ret = mbedtls_aes_crypt_cbc( aes, MBEDTLS_AES_ENCRYPT, use_len,
+                                           y, input, out ) ) != 0 )
+        {
+            return( ret );
+        }
+        memcpy( y, out + use_len - 16, 16 );
+
+        length -= use_len;
+        input += use_len;
+    }
+
+    return( 0 );
+}
+
+/*
+ * Authenticate and encrypt or decrypt whole blocks, advancing ctr
+ */
+static int ccm_aes_blocks( mbedtls_ccm_context *ctx, int mode, size_t length,
+                           unsigned char y[16], unsigned char ctr[16],
+                           const unsigned char *input, unsigned char *output )
+{
+    int ret;
+    mbedtls_aes_context *aes = (mbedtls_aes_context *) ctx->cipher_ctx.cipher_ctx;
+    unsigned char stream[16];
+    size_t nc_off = 0;
+
+    if( mode == CCM_ENCRYPT &&
+        ( ret = ccm_aes_cbc_mac( aes, y, input, length ) ) != 0 )
+    {
+        return( ret );
+    }
+
+    if( ( ret = mbedtls_aes_crypt_ctr( aes, length, &nc_off, ctr, stream,
+                                       input, output ) ) != 0 )
+    {
+        return( ret );
+    }
+
+    if( mode == CCM_DECRYPT &&
+        ( ret = ccm_aes_cbc_mac( aes, y, output, length ) ) != 0 )
+    {
+        return( ret );
+    }
+
+    return( 0 );
+}
+#endif /* CCM_AES_BLOCKS */
+
 /*
  * Authenticated encryption or decryption
  */
@@ -256,6 +329,25 @@ static int ccm_auth_crypt( mbedtls_ccm_context *ctx, int mode, size_t length,
     src = input;
     dst = output;
 
+#if defined(CCM_AES_BLOCKS)
+    /*
+     * The counter only runs over its q bytes, so the full-block increment
+     * of mbedtls_aes_crypt_ctr gives the same counters.
+     */
+    if( len_left >= 16 &&
+        ctx->cipher_ctx.cipher_info->base->cipher == MBEDTLS_CIPHER_ID_AES )
+    {
+        size_t use_len = len_left & ~(size_t) 15;
+
+        if( ( ret = ccm_aes_blocks( ctx, mode, use_len, y, ctr, src, dst ) ) != 0 )
+            return( ret );
+
+        dst += use_len;
+        src += use_len;
+        len_left -= use_len;
+    }
+#endif /* CCM_AES_BLOCKS */
+
     while( len_left > 0 )
     {
         size_t use_len = len_left > 16 ? 16 : len_left;
@@ -1689,6 +1689,15 @@ int mbedtls_ecp_mul( mbedtls_ecp_group *grp, mbedtls_ecp_point *R,
         ( ret = mbedtls_ecp_check_pubkey( grp, P ) ) != 0 )
         return( ret );
 
+#if defined(MBEDTLS_ECP_FAST_SECP256R1) && defined(MBEDTLS_ECP_DP_SECP256R1_ENABLED)
+    if( grp->id == MBEDTLS_ECP_DP_SECP256R1 )
+        return( mbedtls_ecp_fast_secp256r1_mul( grp, R, m, P ) );
+#endif
+#if defined(MBEDTLS_ECP_FAST_CURVE25519) && defined(MBEDTLS_ECP_DP_CURVE25519_ENABLED)
+    if( grp->id == MBEDTLS_ECP_DP_CURVE25519 )
+        return( mbedtls_ecp_fast_curve25519_mul( grp, R, m, P ) );
+#endif
+
 #if defined(MBEDTLS_ECP_INTERNAL_ALT)
     if ( is_grp_capable = mbedtls_internal_ecp_grp_capable( grp )  )
     {
@@ -1855,6 +1864,11 @@ static int ecp_check_pubkey_mx( const mbedtls_ecp_group *grp, const mbedtls_ecp_
     if( mbedtls_mpi_size( &pt->X ) > ( grp->nbits + 7 ) / 8 )
         return( MBEDTLS_ERR_ECP_INVALID_KEY );
 
+    /* Encodings with bit 255 set are masked by the caller as RFC 7748 asks,
+     * larger coordinates are rejected the same way for every implementation */
+    if( mbedtls_mpi_bitlen( &pt->X ) > grp->pbits )
+        return( MBEDTLS_ERR_ECP_INVALID_KEY );
+
     return( 0 );
 }
 #endif /* ECP_MONTGOMERY */
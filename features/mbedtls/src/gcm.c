@@ -41,6 +41,12 @@
 
 #include <string.h>
 
+#if defined(MBEDTLS_AES_C) && defined(MBEDTLS_CIPHER_MODE_CTR)
+#include "mbedtls/aes.h"
+#include "mbedtls/cipher_internal.h"
+#define GCM_AES_BLOCKS
+#endif
+
 #if defined(MBEDTLS_AESNI_C)
 #include "mbedtls/aesni.h"
 #endif
@@ -346,6 +352,74 @@ int mbedtls_gcm_starts( mbedtls_gcm_context *ctx,
     return( 0 );
 }
 
+#if defined(GCM_AES_BLOCKS)
+/*
+ * Encrypt or decrypt whole blocks with a single mbedtls_aes_crypt_ctr call
+ * per run of counters, so that AES hardware is set up once per buffer
+ * rather than once per block. A run stops where the 32-bit counter of GCM
+ * wraps, as it must not carry into the rest of the counter block.
+ */
+static int gcm_aes_blocks( mbedtls_gcm_context *ctx, size_t blocks,
+                           const unsigned char *input, unsigned char *output )
+{
+    int ret;
+    mbedtls_aes_context *aes = (mbedtls_aes_context *) ctx->cipher_ctx.cipher_ctx;
+    unsigned char ctr[16];
+    unsigned char stream[16];
+    size_t i, j, run, nc_off;
+    uint32_t low;
+
+    while( blocks > 0 )
+    {
+        memcpy( ctr, ctx->y, 16 );
+        GET_UINT32_BE( low, ctr, 12 );
+        low++;
+        PUT_UINT32_BE( low, ctr, 12 );
+
+        run = blocks;
+        if( (uint64_t) low + run > 0x100000000ull )
+            run = (size_t)( 0x100000000ull - low );
+
+        if( ctx->mode == MBEDTLS_GCM_DECRYPT )
+        {
+            for( j = 0; j < run; j++ )
+            {
+                for( i = 0; i < 16; i++ )
+                    ctx->buf[i] ^= input[16 * j + i];
+                gcm_mult( ctx, ctx->buf, ctx->buf );
+            }
+        }
+
+        nc_off = 0;
+        if( ( ret = mbedtls_aes_crypt_ctr( aes, 16 * run, &nc_off, ctr, stream,
+                                           input, output ) ) != 0 )
+        {
+            return( ret );
+        }
+
+        if( ctx->mode == MBEDTLS_GCM_ENCRYPT )
+        {
+            for( j = 0; j < run; j++ )
+            {
+                for( i = 0; i < 16; i++ )
+                    ctx->buf[i] ^= output[16 * j + i];
+                gcm_mult( ctx, ctx->buf, ctx->buf );
+            }
+        }
+
+        /* ctx->y holds the last counter used */
+        low += (uint32_t)( run - 1 );
+        PUT_UINT32_BE( low, ctx->y, 12 );
+
+        blocks -= run;
+        input += 16 * run;
+        output += 16 * run;
+    }
+
+    return( 0 );
+}
+#endif /* GCM_AES_BLOCKS */
+
 int mbedtls_gcm_update( mbedtls_gcm_context *ctx,
                 size_t length,
                 const unsigned char *input,
@@ -372,6 +446,22 @@ int mbedtls_gcm_update( mbedtls_gcm_context *ctx,
     ctx->len += length;
 
     p = input;
+
+#if defined(GCM_AES_BLOCKS)
+    if( length >= 16 &&
+        ctx->cipher_ctx.cipher_info->base->cipher == MBEDTLS_CIPHER_ID_AES )
+    {
+        use_len = length & ~(size_t) 15;
+
+        if( ( ret = gcm_aes_blocks( ctx, use_len / 16, p, out_p ) ) != 0 )
+            return( ret );
+
+        length -= use_len;
+        p += use_len;
+        out_p += use_len;
+    }
+#endif /* GCM_AES_BLOCKS */
+
     while( length > 0 )
     {
         use_len = ( length < 16 ) ? length : 16;
@@ -151,20 +151,16 @@ static int st_hal_cryp_cbc( mbedtls_aes_context *ctx, uint32_t opmode, size_t le
                             unsigned char iv[16], uint8_t *input, uint8_t *output) 
 {
     int status = 0;
-    ctx->hcryp_aes.Init.pInitVect = &iv[0]; // used in process, not in the init
-    if ((ctx->hcryp_aes.Init.OperatingMode != opmode) || \
-         (ctx->hcryp_aes.Init.ChainingMode != CRYP_CHAINMODE_AES_CBC) || \
-         (ctx->hcryp_aes.Init.KeyWriteFlag != CRYP_KEY_WRITE_ENABLE)) {
+    ctx->hcryp_aes.Init.pInitVect = &iv[0];
 
-        /* Re-initialize AES IP with proper parameters */
-        if (HAL_CRYP_DeInit(&ctx->hcryp_aes) != HAL_OK)
-            return HAL_ERROR;
-        ctx->hcryp_aes.Init.OperatingMode = opmode;
-        ctx->hcryp_aes.Init.ChainingMode = CRYP_CHAINMODE_AES_CBC;
-        ctx->hcryp_aes.Init.KeyWriteFlag = CRYP_KEY_WRITE_ENABLE;
-        if (HAL_CRYP_Init(&ctx->hcryp_aes) != HAL_OK)
-            return HAL_ERROR;
-    }
+    /* Re-initialize AES IP with proper parameters, the IV is loaded on init */
+    if (HAL_CRYP_DeInit(&ctx->hcryp_aes) != HAL_OK)
+        return HAL_ERROR;
+    ctx->hcryp_aes.Init.OperatingMode = opmode;
+    ctx->hcryp_aes.Init.ChainingMode = CRYP_CHAINMODE_AES_CBC;
+    ctx->hcryp_aes.Init.KeyWriteFlag = CRYP_KEY_WRITE_ENABLE;
+    if (HAL_CRYP_Init(&ctx->hcryp_aes) != HAL_OK)
+        return HAL_ERROR;
 
     status =  HAL_CRYPEx_AES(&ctx->hcryp_aes, input, length, output, 10);
 
@@ -180,8 +176,14 @@ int mbedtls_aes_crypt_cbc( mbedtls_aes_context *ctx,
                     unsigned char *output )
 {
     int status = 0;
+    unsigned char next_iv[16];
     if( length % 16 )
         return( MBEDTLS_ERR_AES_INVALID_INPUT_LENGTH );
+    if( length == 0 )
+        return( 0 );
+    /* the chaining goes on from the last ciphertext block, as in software */
+    if( mode == MBEDTLS_AES_DECRYPT )
+        memcpy( next_iv, input + length - 16, 16 );
 #if defined (TARGET_STM32L486xG)
     if( mode == MBEDTLS_AES_DECRYPT ) {
         status = st_hal_cryp_cbc(ctx, CRYP_ALGOMODE_KEYDERIVATION_DECRYPT, length, iv, (uint8_t *)input, (uint8_t *)output);
@@ -189,14 +191,21 @@ int mbedtls_aes_crypt_cbc( mbedtls_aes_context *ctx,
         status = st_hal_cryp_cbc(ctx, CRYP_ALGOMODE_ENCRYPT, length, iv, (uint8_t *)input, (uint8_t *)output);
     }
 #else
+    ctx->hcryp_aes.Instance->CR = ctx->ctx_save_cr;
     ctx->hcryp_aes.Init.pInitVect = &iv[0];
-    
+    /* load the mode and IV again rather than going on from the last call */
+    ctx->hcryp_aes.Phase = HAL_CRYP_PHASE_READY;
+
     if( mode == MBEDTLS_AES_DECRYPT ) {
         status = HAL_CRYP_AESCBC_Decrypt(&ctx->hcryp_aes, (uint8_t *)input, length, (uint8_t *)output, 10);
     } else {
         status = HAL_CRYP_AESCBC_Encrypt(&ctx->hcryp_aes, (uint8_t *)input, length, (uint8_t *)output, 10);
     }
+    ctx->hcryp_aes.Phase = HAL_CRYP_PHASE_READY;
+    ctx->ctx_save_cr = ctx->hcryp_aes.Instance->CR;
 #endif
+    if( status == 0 )
+        memcpy( iv, mode == MBEDTLS_AES_DECRYPT ? next_iv : output + length - 16, 16 );
     return( status );
 }
 #endif /* MBEDTLS_CIPHER_MODE_CBC */
@@ -272,6 +281,52 @@ int mbedtls_aes_crypt_cfb8( mbedtls_aes_context *ctx,
 #endif /*MBEDTLS_CIPHER_MODE_CFB */
 
 #if defined(MBEDTLS_CIPHER_MODE_CTR)
+/* Encrypt whole blocks in the CTR mode of the peripheral, advancing the counter */
+static int st_hal_cryp_ctr( mbedtls_aes_context *ctx, size_t length,
+                            unsigned char nonce_counter[16],
+                            const unsigned char *input, unsigned char *output )
+{
+    int status = 0;
+    size_t use_len, blocks;
+    int i;
+
+    while( length > 0 ) {
+        /* the HAL takes 16-bit sizes */
+        use_len = length > 0xFFF0 ? 0xFFF0 : length;
+        ctx->hcryp_aes.Init.pInitVect = nonce_counter;
+#if defined (TARGET_STM32L486xG)
+        /* Re-initialize AES IP with proper parameters, the IV is loaded on init */
+        if (HAL_CRYP_DeInit(&ctx->hcryp_aes) != HAL_OK)
+            return HAL_ERROR;
+        ctx->hcryp_aes.Init.OperatingMode = CRYP_ALGOMODE_ENCRYPT;
+        ctx->hcryp_aes.Init.ChainingMode = CRYP_CHAINMODE_AES_CTR;
+        ctx->hcryp_aes.Init.KeyWriteFlag = CRYP_KEY_WRITE_ENABLE;
+        if (HAL_CRYP_Init(&ctx->hcryp_aes) != HAL_OK)
+            return HAL_ERROR;
+        status = HAL_CRYPEx_AES(&ctx->hcryp_aes, (uint8_t *)input, use_len, output, 10);
+#else
+        ctx->hcryp_aes.Instance->CR = ctx->ctx_save_cr;
+        ctx->hcryp_aes.Phase = HAL_CRYP_PHASE_READY;
+        status = HAL_CRYP_AESCTR_Encrypt(&ctx->hcryp_aes, (uint8_t *)input, use_len, output, 10);
+        ctx->hcryp_aes.Phase = HAL_CRYP_PHASE_READY;
+        ctx->ctx_save_cr = ctx->hcryp_aes.Instance->CR;
+#endif
+        if (status != 0)
+            return status;
+
+        /* the peripheral does not give the counter back */
+        for( blocks = use_len / 16, i = 15; blocks > 0 && i >= 0; i--, blocks >>= 8 ) {
+            blocks += nonce_counter[i];
+            nonce_counter[i] = (unsigned char) blocks;
+        }
+
+        length -= use_len;
+        input += use_len;
+        output += use_len;
+    }
+    return( 0 );
+}
+
 int mbedtls_aes_crypt_ctr( mbedtls_aes_context *ctx,
                        size_t length,
                        size_t *nc_off,
@@ -280,8 +335,28 @@ int mbedtls_aes_crypt_ctr( mbedtls_aes_context *ctx,
                        const unsigned char *input,
                        unsigned char *output )
 {
-    int c, i;
+    int c, i, status;
     size_t n = *nc_off;
+    size_t blocks_len;
+
+    /* bytes left in the stream block of the last call */
+    while( n != 0 && length > 0 ) {
+        c = *input++;
+        *output++ = (unsigned char)( c ^ stream_block[n] );
+        n = ( n + 1 ) & 0x0F;
+        length--;
+    }
+
+    /* whole blocks in one go */
+    blocks_len = length & ~(size_t) 15;
+    if( blocks_len > 0 ) {
+        status = st_hal_cryp_ctr( ctx, blocks_len, nonce_counter, input, output );
+        if( status != 0 )
+            return( status );
+        input += blocks_len;
+        output += blocks_len;
+        length -= blocks_len;
+    }
 
     while( length-- )
     {
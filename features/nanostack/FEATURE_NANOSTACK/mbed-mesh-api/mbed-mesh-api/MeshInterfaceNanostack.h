@@ -56,6 +56,31 @@ public:
     */
     virtual const char *get_mac_address();
 
+    /** Get the radio and routing counters
+     *
+     *  The counters are shared by all Nanostack interfaces. Collection is
+     *  disabled by setting mbed-mesh-api.statistics to false.
+     *
+     *  @param stats    Destination for the snapshot
+     *  @return         0 on success, NSAPI_ERROR_UNSUPPORTED if collection
+     *                  is disabled
+     */
+    nsapi_error_t get_statistics(mesh_statistics_t *stats);
+
+    /** Reset the radio and routing counters to 0
+     */
+    void reset_statistics();
+
+    /** Get the link to a neighbor
+     *
+     *  @param index    Index of the neighbor, from 0
+     *  @param info     Destination for the neighbor
+     *  @return         0 on success, NSAPI_ERROR_PARAMETER past the last
+     *                  neighbor, NSAPI_ERROR_UNSUPPORTED if the network does
+     *                  not report its neighbors
+     */
+    virtual nsapi_error_t get_neighbor(uint8_t index, mesh_neighbor_info_t *info);
+
     /**
      * \brief Callback from C-layer
      * \param state state of the network
@@ -36,6 +36,15 @@ public:
     nsapi_error_t initialize(NanostackRfPhy *phy);
     virtual int connect();
     virtual int disconnect();
+
+    /** Get the link to a neighboring router
+     *
+     *  @param index    Index of the neighbor, from 0
+     *  @param info     Destination for the neighbor
+     *  @return         0 on success, NSAPI_ERROR_PARAMETER past the last
+     *                  neighbor
+     */
+    virtual nsapi_error_t get_neighbor(uint8_t index, mesh_neighbor_info_t *info);
 private:
     /*
      * \brief Initialization of the interface.
@@ -17,6 +17,8 @@
 #ifndef __MESH_INTERFACE_TYPES_H__
 #define __MESH_INTERFACE_TYPES_H__
 
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -59,6 +61,62 @@ typedef enum {
     MESH_DEVICE_TYPE_THREAD_MINIMAL_END_DEVICE  /*<! Thread minimal end device */
 } mesh_device_type_t;
 
+/*
+ * Snapshot of the radio and routing counters of the mesh, read with
+ * MeshInterfaceNanostack::get_statistics(). Counters run from the
+ * registration of the first interface, or from the last reset.
+ */
+typedef struct {
+    /* MAC */
+    uint32_t mac_rx_count;          /*<! Frames received */
+    uint32_t mac_tx_count;          /*<! Frames transmitted */
+    uint32_t mac_bc_tx_count;       /*<! Broadcast frames transmitted */
+    uint32_t mac_rx_bytes;          /*<! MAC payload bytes received */
+    uint32_t mac_tx_bytes;          /*<! MAC payload bytes transmitted */
+    uint32_t mac_tx_retry;          /*<! Retransmissions */
+    uint32_t mac_tx_failed;         /*<! Frames given up after all retries */
+    uint32_t mac_tx_cca_count;      /*<! Clear channel assessments */
+    uint32_t mac_tx_cca_failed;     /*<! Clear channel assessments finding the channel busy */
+    uint32_t mac_rx_drop;           /*<! Received frames dropped */
+    uint32_t mac_security_drop;     /*<! Received frames failing security */
+    uint16_t mac_tx_queue_size;     /*<! Frames in the transmit queue */
+    uint16_t mac_tx_queue_peak;     /*<! Highest number of frames in the transmit queue */
+    uint16_t mac_tx_queue_overflow; /*<! Frames dropped on a full transmit queue */
+    /* IPv6 and 6LoWPAN */
+    uint32_t ip_rx_count;           /*<! Packets received */
+    uint32_t ip_tx_count;           /*<! Packets transmitted */
+    uint32_t ip_rx_bytes;           /*<! Bytes received */
+    uint32_t ip_tx_bytes;           /*<! Bytes transmitted */
+    uint32_t ip_routed_bytes;       /*<! Bytes routed on towards the border router */
+    uint32_t ip_rx_drop;            /*<! Received packets dropped */
+    uint32_t ip_no_route;           /*<! Packets dropped for lack of a route */
+    uint32_t ip_route_loops;        /*<! Routing loops detected */
+    uint32_t frag_rx_errors;        /*<! Fragment reassembly errors */
+    uint32_t frag_tx_errors;        /*<! Fragmentation errors */
+    uint32_t buf_headroom_fail;     /*<! Packets dropped for lack of buffer memory */
+    /* RPL */
+    uint32_t rpl_parent_changes;    /*<! Switches to a parent with a better route cost */
+    uint32_t rpl_parent_tx_fail;    /*<! Transmissions to a parent that failed */
+    uint32_t rpl_local_repair;      /*<! Local repairs */
+    uint32_t rpl_global_repair;     /*<! Global repairs */
+    uint32_t rpl_time_no_next_hop;  /*<! Seconds spent without a next hop */
+    uint32_t rpl_memory;            /*<! Memory used by RPL, in bytes */
+    uint16_t rpl_rank;              /*<! Own rank in the DODAG, 0 if not joined */
+    uint16_t primary_parent_etx;    /*<! ETX to the primary parent, in 1/128 units */
+    uint16_t secondary_parent_etx;  /*<! ETX to the secondary parent, in 1/128 units */
+    uint8_t primary_parent[16];     /*<! Address of the primary parent, unspecified if none */
+    uint8_t secondary_parent[16];   /*<! Address of the secondary parent, unspecified if none */
+} mesh_statistics_t;
+
+/*
+ * Link to a neighbor, read with MeshInterfaceNanostack::get_neighbor()
+ */
+typedef struct {
+    uint8_t mac64[8];               /*<! Extended address */
+    uint16_t short_addr;            /*<! Short address */
+    uint8_t link_margin;            /*<! Link margin in dB */
+} mesh_neighbor_info_t;
+
 #ifdef __cplusplus
 }
 #endif
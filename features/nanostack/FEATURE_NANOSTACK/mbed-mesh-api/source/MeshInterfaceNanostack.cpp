@@ -17,6 +17,14 @@
 #include "MeshInterfaceNanostack.h"
 #include "NanostackInterface.h"
 #include "mesh_system.h"
+#include "nwk_stats_api.h"
+#include "net_rpl.h"
+
+#if MBED_CONF_MBED_MESH_API_STATISTICS
+// Updated by the stack, shared by all interfaces
+static nwk_stats_t nwk_stats;
+static bool nwk_stats_started;
+#endif
 
 MeshInterfaceNanostack::MeshInterfaceNanostack()
     : phy(NULL), _network_interface_id(-1), _device_id(-1), eui64(),
@@ -61,6 +69,12 @@ nsapi_error_t MeshInterfaceNanostack::register_phy()
         nanostack_unlock();
         return -1;
     }
+#if MBED_CONF_MBED_MESH_API_STATISTICS
+    if (!nwk_stats_started) {
+        protocol_stats_start(&nwk_stats);
+        nwk_stats_started = true;
+    }
+#endif
     // Read mac address after registering the device.
     phy->get_mac_address(eui64);
     sprintf(mac_addr_str, "%02x:%02x:%02x:%02x:%02x:%02x:%02x:%02x", eui64[0], eui64[1], eui64[2], eui64[3], eui64[4], eui64[5], eui64[6], eui64[7]);
@@ -93,3 +107,85 @@ const char *MeshInterfaceNanostack::get_mac_address()
 {
     return mac_addr_str;
 }
+
+nsapi_error_t MeshInterfaceNanostack::get_statistics(mesh_statistics_t *stats)
+{
+#if MBED_CONF_MBED_MESH_API_STATISTICS
+    memset(stats, 0, sizeof *stats);
+
+    nanostack_lock();
+
+    stats->mac_rx_count = nwk_stats.mac_rx_count;
+    stats->mac_tx_count = nwk_stats.mac_tx_count;
+    stats->mac_bc_tx_count = nwk_stats.mac_bc_tx_count;
+    stats->mac_rx_bytes = nwk_stats.mac_rx_bytes;
+    stats->mac_tx_bytes = nwk_stats.mac_tx_bytes;
+    stats->mac_tx_retry = nwk_stats.mac_tx_retry;
+    stats->mac_tx_failed = nwk_stats.mac_tx_failed;
+    stats->mac_tx_cca_count = nwk_stats.mac_tx_cca_cnt;
+    stats->mac_tx_cca_failed = nwk_stats.mac_tx_failed_cca;
+    stats->mac_rx_drop = nwk_stats.mac_rx_drop;
+    stats->mac_security_drop = nwk_stats.mac_security_drop;
+    stats->mac_tx_queue_size = nwk_stats.mac_tx_queue_size;
+    stats->mac_tx_queue_peak = nwk_stats.mac_tx_queue_peak;
+    stats->mac_tx_queue_overflow = nwk_stats.mac_tx_buffer_overflow;
+
+    stats->ip_rx_count = nwk_stats.ip_rx_count;
+    stats->ip_tx_count = nwk_stats.ip_tx_count;
+    stats->ip_rx_bytes = nwk_stats.ip_rx_bytes;
+    stats->ip_tx_bytes = nwk_stats.ip_tx_bytes;
+    stats->ip_routed_bytes = nwk_stats.ip_routed_up;
+    stats->ip_rx_drop = nwk_stats.ip_rx_drop;
+    stats->ip_no_route = nwk_stats.ip_no_route;
+    stats->ip_route_loops = nwk_stats.ip_routeloop_detect;
+    stats->frag_rx_errors = nwk_stats.frag_rx_errors;
+    stats->frag_tx_errors = nwk_stats.frag_tx_errors;
+    stats->buf_headroom_fail = nwk_stats.buf_headroom_fail;
+
+    stats->rpl_parent_changes = nwk_stats.rpl_route_routecost_better_change;
+    stats->rpl_parent_tx_fail = nwk_stats.rpl_parent_tx_fail;
+    stats->rpl_local_repair = nwk_stats.rpl_local_repair;
+    stats->rpl_global_repair = nwk_stats.rpl_global_repair;
+    stats->rpl_time_no_next_hop = nwk_stats.rpl_time_no_next_hop;
+    stats->rpl_memory = nwk_stats.rpl_total_memory;
+    stats->primary_parent_etx = nwk_stats.etx_1st_parent;
+    stats->secondary_parent_etx = nwk_stats.etx_2nd_parent;
+
+    // Parents of the first instance. A local instance is followed by its
+    // DODAG ID, which identifies it when reading the DODAG.
+    uint8_t instances[1 + 16];
+    rpl_dodag_info_t dodag;
+    if (rpl_instance_list_read(instances, sizeof instances) > 0) {
+        memcpy(dodag.dodag_id, &instances[1], sizeof dodag.dodag_id);
+        if (rpl_read_dodag_info(&dodag, instances[0])) {
+            stats->rpl_rank = dodag.curent_rank;
+            if (dodag.parent_flags & RPL_PRIMARY_PARENT_SET) {
+                memcpy(stats->primary_parent, dodag.primary_parent, sizeof stats->primary_parent);
+            }
+            if (dodag.parent_flags & RPL_SECONDARY_PARENT_SET) {
+                memcpy(stats->secondary_parent, dodag.secondary_parent, sizeof stats->secondary_parent);
+            }
+        }
+    }
+
+    nanostack_unlock();
+
+    return NSAPI_ERROR_OK;
+#else
+    return NSAPI_ERROR_UNSUPPORTED;
+#endif
+}
+
+void MeshInterfaceNanostack::reset_statistics()
+{
+#if MBED_CONF_MBED_MESH_API_STATISTICS
+    nanostack_lock();
+    protocol_stats_reset();
+    nanostack_unlock();
+#endif
+}
+
+nsapi_error_t MeshInterfaceNanostack::get_neighbor(uint8_t index, mesh_neighbor_info_t *info)
+{
+    return NSAPI_ERROR_UNSUPPORTED;
+}
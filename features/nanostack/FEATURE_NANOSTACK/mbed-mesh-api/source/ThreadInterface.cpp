@@ -3,6 +3,7 @@
 #include "callback_handler.h"
 #include "mesh_system.h"
 #include "randLIB.h"
+#include "net_thread_test.h"
 
 #include "ns_trace.h"
 #define TRACE_GROUP "nsth"
@@ -62,6 +63,18 @@ int ThreadInterface::disconnect()
     return map_mesh_error(status);
 }
 
+nsapi_error_t ThreadInterface::get_neighbor(uint8_t index, mesh_neighbor_info_t *info)
+{
+    nanostack_lock();
+
+    int8_t status = thread_test_neighbour_info_get(_network_interface_id, index, &info->short_addr,
+                                                   info->mac64, &info->link_margin);
+
+    nanostack_unlock();
+
+    return status == 0 ? NSAPI_ERROR_OK : NSAPI_ERROR_PARAMETER;
+}
+
 mesh_error_t ThreadInterface::init()
 {
     if (eui64 == NULL) {
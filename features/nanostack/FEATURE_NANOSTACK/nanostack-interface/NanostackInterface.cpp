@@ -93,6 +93,7 @@ public:
     int8_t proto;               /*!< UDP or TCP */
     bool addr_valid;
     ns_address_t ns_address;
+    uint16_t rx_queued;         /*!< stream data held by Nanostack, as last reported */
 private:
     bool attach(int8_t socket_id);
     socket_mode_t mode;
@@ -125,6 +126,25 @@ static void convert_ns_addr_to_mbed(SocketAddress *s_addr, const ns_address_t *n
     s_addr->set_ip_bytes(ns_addr->address, NSAPI_IPv6);
 }
 
+// Buffer of the zero-copy socket API, the data follows the length
+struct nanostack_buf {
+    nsapi_size_t len;
+};
+
+static nanostack_buf *nanostack_buf_alloc(nsapi_size_t size)
+{
+    // Heap blocks are limited to 16 bits
+    if (size > 0xFFFF - sizeof(nanostack_buf)) {
+        return NULL;
+    }
+
+    nanostack_buf *ns_buf = static_cast<nanostack_buf *>(MALLOC(sizeof(nanostack_buf) + size));
+    if (ns_buf) {
+        ns_buf->len = size;
+    }
+    return ns_buf;
+}
+
 void* NanostackSocket::operator new(std::size_t sz) {
     return MALLOC(sz);
 }
@@ -142,6 +162,7 @@ NanostackSocket::NanostackSocket(int8_t protocol)
     proto = protocol;
     addr_valid = false;
     memset(&ns_address, 0, sizeof(ns_address));
+    rx_queued = 0;
     mode = SOCKET_MODE_UNOPENED;
 }
 
@@ -347,6 +368,11 @@ void NanostackSocket::event_data(socket_callback_t *sock_cb)
     MBED_ASSERT((SOCKET_MODE_STREAM == mode) ||
                 (SOCKET_MODE_DATAGRAM == mode));
 
+    if (SOCKET_MODE_STREAM == mode) {
+        // Total of the receive queue
+        rx_queued = sock_cb->d_len;
+    }
+
     signal_event();
 }
 
@@ -628,6 +654,7 @@ nsapi_size_or_error_t NanostackInterface::socket_recvfrom(void *handle, SocketAd
         if (address != NULL) {
             convert_ns_addr_to_mbed(address, &ns_address);
         }
+        socket->rx_queued -= retcode < socket->rx_queued ? retcode : socket->rx_queued;
     }
 
 out:
@@ -641,6 +668,70 @@ out:
     return ret;
 }
 
+nsapi_size_or_error_t NanostackInterface::do_recvfrom_buffer(void *handle, SocketAddress *address, nsapi_buf_t *buf)
+{
+    // Validate parameters
+    NanostackSocket *socket = static_cast<NanostackSocket *>(handle);
+    if (handle == NULL) {
+        MBED_ASSERT(false);
+        return NSAPI_ERROR_NO_SOCKET;
+    }
+
+    nsapi_size_or_error_t ret;
+    nanostack_buf *ns_buf = NULL;
+    ns_address_t ns_address;
+    int retcode;
+
+    NanostackLockGuard lock;
+
+    if (socket->closed()) {
+        ret = NSAPI_ERROR_NO_CONNECTION;
+        goto out;
+    }
+
+    // Size the buffer to what Nanostack holds. A stream with nothing
+    // reported still gets a read, to report the end of the stream.
+    if (socket->proto == SOCKET_TCP) {
+        retcode = socket->rx_queued ? socket->rx_queued : 1;
+    } else {
+        uint8_t peek;
+        retcode = ::socket_recvfrom(socket->socket_id, &peek, 0, NS_MSG_PEEK | NS_MSG_TRUNC, NULL);
+    }
+
+    if (retcode >= 0) {
+        ns_buf = nanostack_buf_alloc(retcode);
+        if (!ns_buf) {
+            ret = NSAPI_ERROR_NO_MEMORY;
+            goto out;
+        }
+        retcode = ::socket_recvfrom(socket->socket_id, ns_buf + 1, ns_buf->len, 0, &ns_address);
+    }
+
+    if (retcode == NS_EWOULDBLOCK) {
+        ret = NSAPI_ERROR_WOULD_BLOCK;
+    } else if (retcode < 0) {
+        ret = NSAPI_ERROR_PARAMETER;
+    } else {
+        ret = retcode;
+        ns_buf->len = retcode;
+        *buf = ns_buf;
+        ns_buf = NULL;
+        if (address != NULL) {
+            convert_ns_addr_to_mbed(address, &ns_address);
+        }
+        socket->rx_queued -= retcode < socket->rx_queued ? retcode : socket->rx_queued;
+    }
+
+out:
+    if (ns_buf) {
+        FREE(ns_buf);
+    }
+
+    tr_debug("socket_recvfrom_buffer(socket=%p) sock_id=%d, ret=%i", socket, socket->socket_id, ret);
+
+    return ret;
+}
+
 nsapi_error_t NanostackInterface::socket_bind(void *handle, const SocketAddress &address)
 {
     // Validate parameters
@@ -860,6 +951,56 @@ nsapi_size_or_error_t NanostackInterface::socket_recv(void *handle, void *data,
     return socket_recvfrom(handle, NULL, data, size);
 }
 
+nsapi_error_t NanostackInterface::buffer_alloc(nsapi_buf_t *buf, nsapi_size_t size)
+{
+    nanostack_buf *ns_buf = nanostack_buf_alloc(size);
+    if (!ns_buf) {
+        return NSAPI_ERROR_NO_MEMORY;
+    }
+
+    *buf = ns_buf;
+    return NSAPI_ERROR_OK;
+}
+
+void NanostackInterface::buffer_free(nsapi_buf_t buf)
+{
+    FREE(buf);
+}
+
+nsapi_buf_t NanostackInterface::buffer_segment(nsapi_buf_t segment, void **data, nsapi_size_t *len)
+{
+    nanostack_buf *ns_buf = static_cast<nanostack_buf *>(segment);
+    *data = ns_buf + 1;
+    *len = ns_buf->len;
+    return NULL;
+}
+
+nsapi_size_or_error_t NanostackInterface::socket_recv_buffer(void *handle, nsapi_buf_t *buf)
+{
+    return do_recvfrom_buffer(handle, NULL, buf);
+}
+
+nsapi_size_or_error_t NanostackInterface::socket_recvfrom_buffer(void *handle, SocketAddress *address, nsapi_buf_t *buf)
+{
+    return do_recvfrom_buffer(handle, address, buf);
+}
+
+nsapi_size_or_error_t NanostackInterface::socket_send_buffer(void *handle, nsapi_buf_t buf, nsapi_size_t offset)
+{
+    nanostack_buf *ns_buf = static_cast<nanostack_buf *>(buf);
+    if (offset >= ns_buf->len) {
+        return 0;
+    }
+
+    return do_sendto(handle, NULL, (uint8_t *)(ns_buf + 1) + offset, ns_buf->len - offset);
+}
+
+nsapi_size_or_error_t NanostackInterface::socket_sendto_buffer(void *handle, const SocketAddress &address, nsapi_buf_t buf)
+{
+    nanostack_buf *ns_buf = static_cast<nanostack_buf *>(buf);
+    return socket_sendto(handle, address, ns_buf + 1, ns_buf->len);
+}
+
 void NanostackInterface::socket_attach(void *handle, void (*callback)(void *), void *id)
 {
     // Validate parameters
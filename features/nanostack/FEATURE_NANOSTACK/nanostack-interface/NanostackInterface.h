@@ -230,8 +230,24 @@ protected:
      */
     virtual nsapi_error_t getsockopt(void *handle, int level, int optname, void *optval, unsigned *optlen);
 
+    /*  Buffers of the zero-copy socket API
+     *
+     *  Buffers are single blocks of the Nanostack heap. A received buffer is
+     *  sized to the datagram, or to the stream data queued by Nanostack, so
+     *  the data is copied once out of the socket queue, in full, and handed
+     *  over to the application.
+     */
+    virtual nsapi_error_t buffer_alloc(nsapi_buf_t *buf, nsapi_size_t size);
+    virtual void buffer_free(nsapi_buf_t buf);
+    virtual nsapi_buf_t buffer_segment(nsapi_buf_t segment, void **data, nsapi_size_t *len);
+    virtual nsapi_size_or_error_t socket_recv_buffer(nsapi_socket_t handle, nsapi_buf_t *buf);
+    virtual nsapi_size_or_error_t socket_recvfrom_buffer(nsapi_socket_t handle, SocketAddress *address, nsapi_buf_t *buf);
+    virtual nsapi_size_or_error_t socket_send_buffer(nsapi_socket_t handle, nsapi_buf_t buf, nsapi_size_t offset);
+    virtual nsapi_size_or_error_t socket_sendto_buffer(nsapi_socket_t handle, const SocketAddress &address, nsapi_buf_t buf);
+
 private:
     nsapi_size_or_error_t do_sendto(void *handle, const struct ns_address *address, const void *data, nsapi_size_t size);
+    nsapi_size_or_error_t do_recvfrom_buffer(void *handle, SocketAddress *address, nsapi_buf_t *buf);
     char text_ip_address[40];
     static NanostackInterface * _ns_interface;
 };
@@ -0,0 +1,772 @@
+/* MQTTClient
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "netsocket/MQTTClient.h"
+#include <string.h>
+
+// Packet types, in the high nibble of the fixed header
+#define MQTT_CONNECT        1
+#define MQTT_CONNACK        2
+#define MQTT_PUBLISH        3
+#define MQTT_PUBACK         4
+#define MQTT_SUBSCRIBE      8
+#define MQTT_SUBACK         9
+#define MQTT_UNSUBSCRIBE    10
+#define MQTT_UNSUBACK       11
+#define MQTT_PINGREQ        12
+#define MQTT_PINGRESP       13
+#define MQTT_DISCONNECT     14
+
+#define MQTT_MAX_REMAINING  268435455
+
+// Size of the fixed header for a remaining length
+static nsapi_size_t header_size(uint32_t remaining)
+{
+    nsapi_size_t size = 2;
+    while (remaining >= 128) {
+        remaining /= 128;
+        size++;
+    }
+    return size;
+}
+
+MQTTClient::MQTTClient(events::EventQueue *queue, TCPSocket *socket)
+    : _queue(queue), _tcp(socket),
+#ifdef MQTT_CLIENT_TLS
+      _tls(NULL),
+#endif
+      _event(queue, mbed::callback(this, &MQTTClient::process))
+{
+    init();
+}
+
+#ifdef MQTT_CLIENT_TLS
+MQTTClient::MQTTClient(events::EventQueue *queue, TLSSocket *socket)
+    : _queue(queue), _tcp(NULL), _tls(socket),
+      _event(queue, mbed::callback(this, &MQTTClient::process))
+{
+    init();
+}
+#endif
+
+void MQTTClient::init()
+{
+    _state = STATE_DISCONNECTED;
+    _keep_alive = 0;
+    _keep_alive_id = 0;
+    _ping_outstanding = false;
+    _blocked = false;
+    _next_id = 0;
+    _inflight_count = 0;
+    _put_offset = 0;
+    _put_zero_copy = false;
+    _tx_len = 0;
+    _tx_sent = 0;
+    _rx_len = 0;
+    _rx_skip = 0;
+}
+
+MQTTClient::~MQTTClient()
+{
+    _mutex.lock();
+    if (_state != STATE_DISCONNECTED) {
+        attach(false);
+    }
+    _state = STATE_DISCONNECTED;
+    _event.cancel();
+    _mutex.unlock();
+}
+
+void MQTTClient::on_message(message_cb_t callback)
+{
+    _mutex.lock();
+    _message_cb = callback;
+    _mutex.unlock();
+}
+
+void MQTTClient::on_status(status_cb_t callback)
+{
+    _mutex.lock();
+    _status_cb = callback;
+    _mutex.unlock();
+}
+
+void MQTTClient::on_ack(ack_cb_t callback)
+{
+    _mutex.lock();
+    _ack_cb = callback;
+    _mutex.unlock();
+}
+
+void MQTTClient::on_ready(mbed::Callback<void()> callback)
+{
+    _mutex.lock();
+    _ready_cb = callback;
+    _mutex.unlock();
+}
+
+// Take over the socket's events, or give them back
+void MQTTClient::attach(bool attach)
+{
+    mbed::Callback<void()> sigio;
+    if (attach) {
+        sigio = mbed::callback(&_event, &events::StaticEvent<mbed::Callback<void()> >::operator());
+    }
+#ifdef MQTT_CLIENT_TLS
+    if (_tls) {
+        _tls->set_blocking(!attach);
+        _tls->sigio(sigio);
+        return;
+    }
+#endif
+    _tcp->set_blocking(!attach);
+    _tcp->sigio(sigio);
+}
+
+nsapi_size_or_error_t MQTTClient::transport_send(const void *data, nsapi_size_t size)
+{
+#ifdef MQTT_CLIENT_TLS
+    if (_tls) {
+        return _tls->send(data, size);
+    }
+#endif
+    return _tcp->send(data, size);
+}
+
+nsapi_size_or_error_t MQTTClient::transport_recv(void *data, nsapi_size_t size)
+{
+#ifdef MQTT_CLIENT_TLS
+    if (_tls) {
+        return _tls->recv(data, size);
+    }
+#endif
+    return _tcp->recv(data, size);
+}
+
+// Make room for a packet in the transmit buffer and put it there
+bool MQTTClient::tx_reserve(nsapi_size_t size)
+{
+    if (_tx_sent) {
+        memmove(_tx, _tx + _tx_sent, _tx_len - _tx_sent);
+        _tx_len -= _tx_sent;
+        _tx_sent = 0;
+    }
+    if (size > sizeof(_tx) - _tx_len) {
+        return false;
+    }
+    _put_zero_copy = false;
+    return true;
+}
+
+void MQTTClient::put(const void *data, nsapi_size_t size)
+{
+    const uint8_t *bytes = static_cast<const uint8_t *>(data);
+    if (!_put_zero_copy) {
+        memcpy(_tx + _tx_len, bytes, size);
+        _tx_len += size;
+        return;
+    }
+
+    while (size > 0) {
+        void *segment;
+        nsapi_size_t len = _tx_buffer.segment(_put_offset, &segment);
+        if (len > size) {
+            len = size;
+        }
+        memcpy(segment, bytes, len);
+        _put_offset += len;
+        bytes += len;
+        size -= len;
+    }
+}
+
+void MQTTClient::put_header(uint8_t header, uint32_t remaining)
+{
+    uint8_t bytes[5];
+    nsapi_size_t len = 0;
+    bytes[len++] = header;
+    do {
+        uint8_t byte = remaining % 128;
+        remaining /= 128;
+        bytes[len++] = byte | (remaining ? 0x80 : 0);
+    } while (remaining);
+    put(bytes, len);
+}
+
+void MQTTClient::put_u16(uint16_t value)
+{
+    uint8_t bytes[2] = { (uint8_t)(value >> 8), (uint8_t)value };
+    put(bytes, 2);
+}
+
+void MQTTClient::put_string(const char *string, uint16_t length)
+{
+    put_u16(length);
+    put(string, length);
+}
+
+// Send what is waiting, the zero-copy buffer goes first as it is older
+nsapi_error_t MQTTClient::flush()
+{
+    if (_tx_buffer.size()) {
+        nsapi_size_or_error_t sent = _tcp->send(_tx_buffer);
+        if (sent < 0) {
+            return sent;
+        }
+        if (_tx_buffer.size()) {
+            return NSAPI_ERROR_WOULD_BLOCK;
+        }
+    }
+
+    while (_tx_sent < _tx_len) {
+        nsapi_size_or_error_t sent = transport_send(_tx + _tx_sent, _tx_len - _tx_sent);
+        if (sent < 0) {
+            return sent;
+        }
+        if (sent == 0) {
+            return NSAPI_ERROR_WOULD_BLOCK;
+        }
+        _tx_sent += sent;
+    }
+    _tx_len = 0;
+    _tx_sent = 0;
+    return NSAPI_ERROR_OK;
+}
+
+uint16_t MQTTClient::next_id()
+{
+    bool used;
+    do {
+        if (++_next_id == 0) {
+            _next_id = 1;
+        }
+        used = false;
+        for (nsapi_size_t i = 0; i < _inflight_count; i++) {
+            used = used || _inflight[i] == _next_id;
+        }
+    } while (used);
+    return _next_id;
+}
+
+nsapi_error_t MQTTClient::connect(const char *client_id, const char *username,
+        const char *password, uint16_t keep_alive, bool clean_session)
+{
+    _mutex.lock();
+    if (_state != STATE_DISCONNECTED) {
+        _mutex.unlock();
+        return _state == STATE_CONNECTING ? NSAPI_ERROR_ALREADY : NSAPI_ERROR_IS_CONNECTED;
+    }
+
+    size_t id_len = strlen(client_id);
+    size_t user_len = username ? strlen(username) : 0;
+    size_t pass_len = password ? strlen(password) : 0;
+    if (id_len > 0xffff || user_len > 0xffff || pass_len > 0xffff) {
+        _mutex.unlock();
+        return NSAPI_ERROR_PARAMETER;
+    }
+
+    uint32_t remaining = 10 + 2 + id_len;
+    uint8_t flags = clean_session ? 0x02 : 0;
+    if (username) {
+        remaining += 2 + user_len;
+        flags |= 0x80;
+    }
+    if (password) {
+        remaining += 2 + pass_len;
+        flags |= 0x40;
+    }
+
+    init();
+    _tx_buffer.release();
+    if (!tx_reserve(header_size(remaining) + remaining)) {
+        _mutex.unlock();
+        return NSAPI_ERROR_NO_MEMORY;
+    }
+
+    static const uint8_t protocol[] = { 0, 4, 'M', 'Q', 'T', 'T', 4 };
+    put_header(MQTT_CONNECT << 4, remaining);
+    put(protocol, sizeof(protocol));
+    put(&flags, 1);
+    put_u16(keep_alive);
+    put_string(client_id, id_len);
+    if (username) {
+        put_string(username, user_len);
+    }
+    if (password) {
+        put_string(password, pass_len);
+    }
+
+    _keep_alive = keep_alive;
+    _state = STATE_CONNECTING;
+    attach(true);
+
+    nsapi_error_t err = flush();
+    if (err && err != NSAPI_ERROR_WOULD_BLOCK) {
+        attach(false);
+        _state = STATE_DISCONNECTED;
+        _mutex.unlock();
+        return err;
+    }
+
+    // the socket may have had data before it was attached
+    _event.post();
+    _mutex.unlock();
+    return NSAPI_ERROR_OK;
+}
+
+nsapi_error_t MQTTClient::disconnect()
+{
+    _mutex.lock();
+    if (_state == STATE_DISCONNECTED) {
+        _mutex.unlock();
+        return NSAPI_ERROR_NO_CONNECTION;
+    }
+
+    // the packet is sent if the socket takes it right away
+    if (tx_reserve(2)) {
+        put_header(MQTT_DISCONNECT << 4, 0);
+        flush();
+    }
+
+    if (_keep_alive_id) {
+        _queue->cancel(_keep_alive_id);
+    }
+    attach(false);
+    _event.cancel();
+    _tx_buffer.release();
+    init();
+    _mutex.unlock();
+    return NSAPI_ERROR_OK;
+}
+
+bool MQTTClient::is_connected()
+{
+    _mutex.lock();
+    bool connected = _state == STATE_CONNECTED;
+    _mutex.unlock();
+    return connected;
+}
+
+nsapi_size_t MQTTClient::in_flight()
+{
+    _mutex.lock();
+    nsapi_size_t count = _inflight_count;
+    _mutex.unlock();
+    return count;
+}
+
+nsapi_value_or_error_t MQTTClient::subscribe(const char *topic, qos_t qos)
+{
+    size_t topic_len = strlen(topic);
+    if (topic_len > 0xffff || qos > QOS1) {
+        return NSAPI_ERROR_PARAMETER;
+    }
+
+    _mutex.lock();
+    if (_state != STATE_CONNECTED) {
+        _mutex.unlock();
+        return NSAPI_ERROR_NO_CONNECTION;
+    }
+
+    uint32_t remaining = 2 + 2 + topic_len + 1;
+    nsapi_size_t size = header_size(remaining) + remaining;
+    if (!tx_reserve(size)) {
+        _mutex.unlock();
+        return size > sizeof(_tx) ? NSAPI_ERROR_NO_MEMORY : NSAPI_ERROR_WOULD_BLOCK;
+    }
+
+    uint16_t id = next_id();
+    uint8_t requested = qos;
+    put_header((MQTT_SUBSCRIBE << 4) | 0x02, remaining);
+    put_u16(id);
+    put_string(topic, topic_len);
+    put(&requested, 1);
+
+    nsapi_error_t err = flush();
+    if (err && err != NSAPI_ERROR_WOULD_BLOCK) {
+        lost(err);
+        _mutex.unlock();
+        return err;
+    }
+    _mutex.unlock();
+    return id;
+}
+
+nsapi_value_or_error_t MQTTClient::unsubscribe(const char *topic)
+{
+    size_t topic_len = strlen(topic);
+    if (topic_len > 0xffff) {
+        return NSAPI_ERROR_PARAMETER;
+    }
+
+    _mutex.lock();
+    if (_state != STATE_CONNECTED) {
+        _mutex.unlock();
+        return NSAPI_ERROR_NO_CONNECTION;
+    }
+
+    uint32_t remaining = 2 + 2 + topic_len;
+    nsapi_size_t size = header_size(remaining) + remaining;
+    if (!tx_reserve(size)) {
+        _mutex.unlock();
+        return size > sizeof(_tx) ? NSAPI_ERROR_NO_MEMORY : NSAPI_ERROR_WOULD_BLOCK;
+    }
+
+    uint16_t id = next_id();
+    put_header((MQTT_UNSUBSCRIBE << 4) | 0x02, remaining);
+    put_u16(id);
+    put_string(topic, topic_len);
+
+    nsapi_error_t err = flush();
+    if (err && err != NSAPI_ERROR_WOULD_BLOCK) {
+        lost(err);
+        _mutex.unlock();
+        return err;
+    }
+    _mutex.unlock();
+    return id;
+}
+
+nsapi_value_or_error_t MQTTClient::publish(const char *topic, const void *payload, nsapi_size_t size,
+        qos_t qos, bool retain)
+{
+    size_t topic_len = strlen(topic);
+    if (topic_len > 0xffff || qos > QOS1) {
+        return NSAPI_ERROR_PARAMETER;
+    }
+    uint32_t remaining = 2 + topic_len + (qos ? 2 : 0);
+    if (size > MQTT_MAX_REMAINING - remaining) {
+        return NSAPI_ERROR_PARAMETER;
+    }
+    remaining += size;
+    nsapi_size_t packet_size = header_size(remaining) + remaining;
+
+    _mutex.lock();
+    if (_state != STATE_CONNECTED) {
+        _mutex.unlock();
+        return NSAPI_ERROR_NO_CONNECTION;
+    }
+    if (qos == QOS1 && _inflight_count == MBED_CONF_NSAPI_MQTT_MAX_INFLIGHT) {
+        _blocked = true;
+        _mutex.unlock();
+        return NSAPI_ERROR_WOULD_BLOCK;
+    }
+
+    // serialize into a buffer of the stack if nothing is waiting before it
+    if (_tcp && !_tx_buffer.size() && _tx_len == _tx_sent) {
+        nsapi_error_t err = _tx_buffer.allocate(_tcp, packet_size);
+        if (err) {
+            _mutex.unlock();
+            return err;
+        }
+        _put_zero_copy = true;
+        _put_offset = 0;
+    } else if (!tx_reserve(packet_size)) {
+        // a TLS socket can never take it, a TCP socket can once it has the rest
+        if (!_tcp && packet_size > sizeof(_tx)) {
+            _mutex.unlock();
+            return NSAPI_ERROR_NO_MEMORY;
+        }
+        _blocked = true;
+        _mutex.unlock();
+        return NSAPI_ERROR_WOULD_BLOCK;
+    }
+
+    uint16_t id = 0;
+    put_header((MQTT_PUBLISH << 4) | (qos << 1) | (retain ? 1 : 0), remaining);
+    put_string(topic, topic_len);
+    if (qos == QOS1) {
+        id = next_id();
+        put_u16(id);
+        _inflight[_inflight_count++] = id;
+    }
+    put(payload, size);
+    _put_zero_copy = false;
+
+    nsapi_error_t err = flush();
+    if (err && err != NSAPI_ERROR_WOULD_BLOCK) {
+        lost(err);
+        _mutex.unlock();
+        return err;
+    }
+    _mutex.unlock();
+    return id;
+}
+
+void MQTTClient::keep_alive()
+{
+    _mutex.lock();
+    if (_state != STATE_CONNECTED) {
+        _mutex.unlock();
+        return;
+    }
+    if (_ping_outstanding) {
+        lost(NSAPI_ERROR_CONNECTION_TIMEOUT);
+        _mutex.unlock();
+        return;
+    }
+
+    // sent once the packets waiting before it are, if there is no room now
+    if (tx_reserve(2)) {
+        put_header(MQTT_PINGREQ << 4, 0);
+        _ping_outstanding = true;
+        nsapi_error_t err = flush();
+        if (err && err != NSAPI_ERROR_WOULD_BLOCK) {
+            lost(err);
+        }
+    }
+    _mutex.unlock();
+}
+
+void MQTTClient::lost(nsapi_error_t error)
+{
+    if (_keep_alive_id) {
+        _queue->cancel(_keep_alive_id);
+    }
+    attach(false);
+    _tx_buffer.release();
+    init();
+    if (_status_cb) {
+        _status_cb(error);
+    }
+}
+
+void MQTTClient::process()
+{
+    _mutex.lock();
+    if (_state == STATE_DISCONNECTED) {
+        _mutex.unlock();
+        return;
+    }
+
+    nsapi_error_t err = flush();
+    while (err == NSAPI_ERROR_OK || err == NSAPI_ERROR_WOULD_BLOCK) {
+        // parse before reading more, which stops when acknowledgements
+        // can not be queued until the socket takes more
+        err = parse();
+        if (err || _state == STATE_DISCONNECTED) {
+            break;
+        }
+
+        nsapi_size_or_error_t recv = transport_recv(_rx + _rx_len, sizeof(_rx) - _rx_len);
+        if (recv == NSAPI_ERROR_WOULD_BLOCK) {
+            err = flush();
+            break;
+        }
+        if (recv <= 0) {
+            err = recv ? recv : NSAPI_ERROR_CONNECTION_LOST;
+            break;
+        }
+        _rx_len += recv;
+    }
+
+    if (_state != STATE_DISCONNECTED) {
+        if (err && err != NSAPI_ERROR_WOULD_BLOCK) {
+            lost(err);
+        } else if (_blocked && !_tx_buffer.size() && _tx_len == 0 &&
+                _inflight_count < MBED_CONF_NSAPI_MQTT_MAX_INFLIGHT) {
+            _blocked = false;
+            if (_ready_cb) {
+                _ready_cb();
+            }
+        }
+    }
+    _mutex.unlock();
+}
+
+// Handle the complete packets received, WOULD_BLOCK stops with packets left
+nsapi_error_t MQTTClient::parse()
+{
+    nsapi_size_t offset = 0;
+    nsapi_error_t err = NSAPI_ERROR_OK;
+
+    // drop what is left of a message too large to receive
+    if (_rx_skip) {
+        offset = _rx_skip < _rx_len ? _rx_skip : _rx_len;
+        _rx_skip -= offset;
+    }
+
+    while (_state != STATE_DISCONNECTED) {
+        uint8_t *packet = _rx + offset;
+        nsapi_size_t available = _rx_len - offset;
+
+        uint32_t remaining = 0;
+        nsapi_size_t len = 1;
+        bool complete = false;
+        while (len < available && len <= 4) {
+            uint8_t byte = packet[len++];
+            remaining |= (uint32_t)(byte & 0x7f) << (7 * (len - 2));
+            if (!(byte & 0x80)) {
+                complete = true;
+                break;
+            }
+        }
+        if (!complete) {
+            if (len > 4) {
+                err = NSAPI_ERROR_CONNECTION_LOST;
+            }
+            break;
+        }
+        if (remaining > sizeof(_rx) - len) {
+            nsapi_size_or_error_t dropped = drop(packet, len, remaining, available);
+            if (dropped < 0) {
+                err = dropped;
+            } else {
+                offset += dropped;
+            }
+            break;
+        }
+        if (len + remaining > available) {
+            break;
+        }
+
+        // leave a QoS 1 publish until its acknowledgement can be queued
+        if ((packet[0] >> 4) == MQTT_PUBLISH && (packet[0] & 0x06) && !tx_reserve(4)) {
+            err = NSAPI_ERROR_WOULD_BLOCK;
+            break;
+        }
+
+        offset += len + remaining;
+        err = handle(packet[0], packet + len, remaining);
+        if (err) {
+            break;
+        }
+    }
+
+    if (_state != STATE_DISCONNECTED) {
+        memmove(_rx, _rx + offset, _rx_len - offset);
+        _rx_len -= offset;
+    }
+    return err;
+}
+
+// Drop a message larger than the receive buffer, a QoS 1 one is still
+// acknowledged once its packet id is in. Returns the bytes dropped, 0 while
+// waiting for the packet id
+nsapi_size_or_error_t MQTTClient::drop(uint8_t *packet, nsapi_size_t len, uint32_t remaining,
+        nsapi_size_t available)
+{
+    uint8_t qos = (packet[0] >> 1) & 3;
+    if ((packet[0] >> 4) != MQTT_PUBLISH) {
+        return NSAPI_ERROR_NO_MEMORY;
+    }
+    if (_state != STATE_CONNECTED || qos > QOS1) {
+        return NSAPI_ERROR_CONNECTION_LOST;
+    }
+
+    if (qos == QOS1) {
+        if (available < len + 2) {
+            return 0;
+        }
+        nsapi_size_t id_end = len + 2 + ((packet[len] << 8) | packet[len + 1]) + 2;
+        if (id_end > len + remaining) {
+            return NSAPI_ERROR_CONNECTION_LOST;
+        }
+        if (id_end > sizeof(_rx)) {
+            return NSAPI_ERROR_NO_MEMORY;
+        }
+        if (available < id_end) {
+            return 0;
+        }
+        if (!tx_reserve(4)) {
+            return NSAPI_ERROR_WOULD_BLOCK;
+        }
+        put_header(MQTT_PUBACK << 4, 2);
+        put(packet + id_end - 2, 2);
+    }
+
+    _rx_skip = len + remaining - available;
+    return available;
+}
+
+nsapi_error_t MQTTClient::handle(uint8_t header, uint8_t *body, nsapi_size_t size)
+{
+    switch (header >> 4) {
+        case MQTT_CONNACK:
+            if (_state != STATE_CONNECTING || size < 2) {
+                return NSAPI_ERROR_CONNECTION_LOST;
+            }
+            if (body[1] != 0) {
+                lost(NSAPI_ERROR_AUTH_FAILURE);
+                return NSAPI_ERROR_OK;
+            }
+            _state = STATE_CONNECTED;
+            if (_keep_alive) {
+                _keep_alive_id = _queue->call_every(_keep_alive * 1000,
+                        mbed::callback(this, &MQTTClient::keep_alive));
+            }
+            if (_status_cb) {
+                _status_cb(NSAPI_ERROR_OK);
+            }
+            return NSAPI_ERROR_OK;
+
+        case MQTT_PUBLISH: {
+            uint8_t qos = (header >> 1) & 3;
+            if (_state != STATE_CONNECTED || qos > QOS1 || size < 2) {
+                return NSAPI_ERROR_CONNECTION_LOST;
+            }
+            nsapi_size_t topic_len = (body[0] << 8) | body[1];
+            nsapi_size_t header_len = 2 + topic_len + (qos ? 2 : 0);
+            if (header_len > size) {
+                return NSAPI_ERROR_CONNECTION_LOST;
+            }
+            uint16_t id = qos ? (body[2 + topic_len] << 8) | body[3 + topic_len] : 0;
+
+            // queued before the callback can fill the room made for it
+            if (qos == QOS1 && tx_reserve(4)) {
+                put_header(MQTT_PUBACK << 4, 2);
+                put_u16(id);
+            }
+
+            // the topic is moved over its length to terminate it in place
+            char *topic = (char *)body;
+            memmove(topic, body + 2, topic_len);
+            topic[topic_len] = '\0';
+            if (_message_cb) {
+                _message_cb(topic, body + header_len, size - header_len);
+            }
+            return NSAPI_ERROR_OK;
+        }
+
+        case MQTT_PUBACK: {
+            if (size < 2) {
+                return NSAPI_ERROR_CONNECTION_LOST;
+            }
+            uint16_t id = (body[0] << 8) | body[1];
+            for (nsapi_size_t i = 0; i < _inflight_count; i++) {
+                if (_inflight[i] == id) {
+                    _inflight[i] = _inflight[--_inflight_count];
+                    if (_ack_cb) {
+                        _ack_cb(id);
+                    }
+                    break;
+                }
+            }
+            return NSAPI_ERROR_OK;
+        }
+
+        case MQTT_SUBACK:
+        case MQTT_UNSUBACK:
+            return NSAPI_ERROR_OK;
+
+        case MQTT_PINGRESP:
+            _ping_outstanding = false;
+            return NSAPI_ERROR_OK;
+
+        default:
+            return NSAPI_ERROR_CONNECTION_LOST;
+    }
+}
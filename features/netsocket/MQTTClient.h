@@ -0,0 +1,306 @@
+/* MQTTClient
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @addtogroup netsocket */
+/** @{*/
+
+#ifndef MQTT_CLIENT_H
+#define MQTT_CLIENT_H
+
+#include "netsocket/TCPSocket.h"
+#include "netsocket/TLSSocket.h"
+#include "netsocket/NetworkBuffer.h"
+#include "events/EventQueue.h"
+#include "events/StaticEvent.h"
+#include "platform/Callback.h"
+#include "platform/PlatformMutex.h"
+#include "platform/NonCopyable.h"
+
+#if defined(MBEDTLS_SSL_TLS_C) && defined(MBEDTLS_CTR_DRBG_C) && defined(MBEDTLS_ENTROPY_C) \
+    && defined(MBEDTLS_X509_CRT_PARSE_C)
+#define MQTT_CLIENT_TLS
+#endif
+
+#ifndef MBED_CONF_NSAPI_MQTT_TX_BUFFER_SIZE
+#define MBED_CONF_NSAPI_MQTT_TX_BUFFER_SIZE 256
+#endif
+
+#ifndef MBED_CONF_NSAPI_MQTT_RX_BUFFER_SIZE
+#define MBED_CONF_NSAPI_MQTT_RX_BUFFER_SIZE 256
+#endif
+
+#ifndef MBED_CONF_NSAPI_MQTT_MAX_INFLIGHT
+#define MBED_CONF_NSAPI_MQTT_MAX_INFLIGHT 8
+#endif
+
+/** MQTT 3.1.1 client over a TCPSocket or TLSSocket
+ *
+ *  The client runs on an event queue: the socket is made non-blocking
+ *  and its events post a preallocated event that reads, parses and
+ *  acknowledges incoming packets, sends what the socket could not take
+ *  yet and keeps the connection alive. The callbacks are called from the
+ *  queue.
+ *
+ *  Publishes are serialized straight into a NetworkBuffer of the TCP
+ *  socket's stack, without an intermediate copy. Over TLS, and while the
+ *  socket has not taken earlier packets yet, they are copied into a
+ *  transmit buffer of nsapi.mqtt-tx-buffer-size bytes instead.
+ *
+ *  QoS 1 publishes are pipelined: up to nsapi.mqtt-max-inflight of them
+ *  are sent without waiting for their acknowledgements. Once the window
+ *  is full, or the socket does not take more, publish returns
+ *  NSAPI_ERROR_WOULD_BLOCK and the ready callback is called when it may
+ *  be retried. Payloads are not kept, so publishes still in flight when
+ *  the connection is lost are not sent again.
+ *
+ *  Incoming messages, with their topic, must fit in
+ *  nsapi.mqtt-rx-buffer-size bytes. Larger ones are acknowledged, if they
+ *  are QoS 1, and dropped without calling the message callback. QoS 2 is
+ *  not supported, subscriptions ask for QoS 1 at most.
+ *
+ *  @code
+ *  TCPSocket socket;
+ *  socket.open(&net);
+ *  socket.connect("broker.example.com", 1883);
+ *
+ *  MQTTClient client(&queue, &socket);
+ *  client.on_message(print_message);
+ *  client.connect("sensor-42");
+ *  client.subscribe("sensors/+/config", MQTTClient::QOS1);
+ *  queue.dispatch_forever();
+ *  @endcode
+ */
+class MQTTClient : private mbed::NonCopyable<MQTTClient> {
+public:
+    /** Quality of service of a message
+     */
+    enum qos_t {
+        QOS0 = 0,   /**< At most once */
+        QOS1 = 1,   /**< At least once */
+    };
+
+    /** Callback for received messages
+     *
+     *  The topic and payload are only valid during the call.
+     */
+    typedef mbed::Callback<void (const char *topic, const void *payload, nsapi_size_t size)> message_cb_t;
+
+    /** Callback for connection status changes
+     *
+     *  Called with 0 once the broker accepted the connection,
+     *  NSAPI_ERROR_AUTH_FAILURE if it refused it, NSAPI_ERROR_CONNECTION_TIMEOUT
+     *  if it stopped answering keep-alives, or other negative error codes
+     *  when the connection was lost.
+     */
+    typedef mbed::Callback<void (nsapi_error_t status)> status_cb_t;
+
+    /** Callback for acknowledged QoS 1 publishes, with their packet id
+     */
+    typedef mbed::Callback<void (uint16_t id)> ack_cb_t;
+
+    /** Create a client over a TCP socket
+     *
+     *  The socket must be connected to the broker before connect is called,
+     *  and stay open while the client uses it.
+     *
+     *  @param queue    Event queue the client runs on
+     *  @param socket   TCP socket connected to the broker
+     */
+    MQTTClient(events::EventQueue *queue, TCPSocket *socket);
+
+#ifdef MQTT_CLIENT_TLS
+    /** Create a client over a TLS socket
+     *
+     *  The handshake must be complete before connect is called.
+     *
+     *  @param queue    Event queue the client runs on
+     *  @param socket   TLS socket connected to the broker
+     */
+    MQTTClient(events::EventQueue *queue, TLSSocket *socket);
+#endif
+
+    /** Destroy a client
+     *
+     *  Stops using the socket without sending a disconnect, which the
+     *  socket's owner closes.
+     */
+    ~MQTTClient();
+
+    /** Set the callback for received messages
+     *
+     *  @param callback Function called with each message received
+     */
+    void on_message(message_cb_t callback);
+
+    /** Set the callback for connection status changes
+     *
+     *  @param callback Function called when the connection is accepted,
+     *                  refused or lost
+     */
+    void on_status(status_cb_t callback);
+
+    /** Set the callback for acknowledged QoS 1 publishes
+     *
+     *  @param callback Function called with the packet id of each
+     *                  publish acknowledged by the broker
+     */
+    void on_ack(ack_cb_t callback);
+
+    /** Set the callback for retrying publishes
+     *
+     *  @param callback Function called once publishes may succeed again
+     *                  after one returned NSAPI_ERROR_WOULD_BLOCK
+     */
+    void on_ready(mbed::Callback<void()> callback);
+
+    /** Connect to the broker
+     *
+     *  Sends the connect packet, the result is reported to the status
+     *  callback.
+     *
+     *  @param client_id        Client identifier, unique on the broker
+     *  @param username         User name, or NULL for none
+     *  @param password         Password, or NULL for none
+     *  @param keep_alive       Seconds between keep-alives, 0 for none
+     *  @param clean_session    Whether the broker forgets earlier sessions
+     *                          of the client
+     *  @return                 0 once the connect packet is on its way,
+     *                          negative error code on failure
+     */
+    nsapi_error_t connect(const char *client_id, const char *username = NULL,
+            const char *password = NULL, uint16_t keep_alive = 60, bool clean_session = true);
+
+    /** Disconnect from the broker
+     *
+     *  Sends a disconnect packet if the socket takes it. The socket can
+     *  then be closed.
+     *
+     *  @return         0 on success, negative error code on failure
+     */
+    nsapi_error_t disconnect();
+
+    /** Check whether the broker accepted the connection
+     *
+     *  @return         True from when the connection is accepted until it
+     *                  is lost or disconnected
+     */
+    bool is_connected();
+
+    /** Subscribe to a topic
+     *
+     *  @param topic    Topic filter, which may contain wildcards
+     *  @param qos      Maximum quality of service of the messages received
+     *  @return         Packet id of the subscribe on success, negative error code
+     *                  on failure
+     */
+    nsapi_value_or_error_t subscribe(const char *topic, qos_t qos = QOS0);
+
+    /** Unsubscribe from a topic
+     *
+     *  @param topic    Topic filter given to subscribe
+     *  @return         Packet id of the unsubscribe on success, negative error
+     *                  code on failure
+     */
+    nsapi_value_or_error_t unsubscribe(const char *topic);
+
+    /** Publish a message
+     *
+     *  The payload is serialized before publish returns.
+     *
+     *  @param topic    Topic of the message
+     *  @param payload  Payload of the message
+     *  @param size     Size of the payload in bytes
+     *  @param qos      Quality of service of the message
+     *  @param retain   Whether the broker keeps the message for later subscribers
+     *  @return         Packet id for QoS 1, which is passed to the ack callback,
+     *                  0 for QoS 0, NSAPI_ERROR_WOULD_BLOCK if the in-flight
+     *                  window is full or the socket does not take more data,
+     *                  or other negative error code on failure
+     */
+    nsapi_value_or_error_t publish(const char *topic, const void *payload, nsapi_size_t size,
+            qos_t qos = QOS0, bool retain = false);
+
+    /** Number of QoS 1 publishes waiting for their acknowledgement
+     *
+     *  @return         Publishes in flight
+     */
+    nsapi_size_t in_flight();
+
+private:
+    enum state_t {
+        STATE_DISCONNECTED,
+        STATE_CONNECTING,
+        STATE_CONNECTED,
+    };
+
+    void init();
+    void attach(bool attach);
+    nsapi_size_or_error_t transport_send(const void *data, nsapi_size_t size);
+    nsapi_size_or_error_t transport_recv(void *data, nsapi_size_t size);
+
+    bool tx_reserve(nsapi_size_t size);
+    void put(const void *data, nsapi_size_t size);
+    void put_header(uint8_t type, uint32_t remaining);
+    void put_u16(uint16_t value);
+    void put_string(const char *string, uint16_t length);
+    nsapi_error_t flush();
+
+    uint16_t next_id();
+    void process();
+    nsapi_error_t parse();
+    nsapi_size_or_error_t drop(uint8_t *packet, nsapi_size_t len, uint32_t remaining, nsapi_size_t available);
+    nsapi_error_t handle(uint8_t header, uint8_t *body, nsapi_size_t size);
+    void keep_alive();
+    void lost(nsapi_error_t error);
+
+    events::EventQueue *_queue;
+    TCPSocket *_tcp;
+#ifdef MQTT_CLIENT_TLS
+    TLSSocket *_tls;
+#endif
+    events::StaticEvent<mbed::Callback<void()> > _event;
+    PlatformMutex _mutex;
+
+    message_cb_t _message_cb;
+    status_cb_t _status_cb;
+    ack_cb_t _ack_cb;
+    mbed::Callback<void()> _ready_cb;
+
+    state_t _state;
+    uint16_t _keep_alive;
+    int _keep_alive_id;
+    bool _ping_outstanding;
+    bool _blocked;
+    uint16_t _next_id;
+
+    uint16_t _inflight[MBED_CONF_NSAPI_MQTT_MAX_INFLIGHT];
+    nsapi_size_t _inflight_count;
+
+    // Packets go out of the zero-copy buffer first, then the transmit buffer
+    NetworkBuffer _tx_buffer;
+    nsapi_size_t _put_offset;
+    bool _put_zero_copy;
+    uint8_t _tx[MBED_CONF_NSAPI_MQTT_TX_BUFFER_SIZE];
+    nsapi_size_t _tx_len;
+    nsapi_size_t _tx_sent;
+    uint8_t _rx[MBED_CONF_NSAPI_MQTT_RX_BUFFER_SIZE];
+    nsapi_size_t _rx_len;
+    uint32_t _rx_skip;
+};
+
+#endif
+
+/** @}*/
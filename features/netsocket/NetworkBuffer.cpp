@@ -0,0 +1,103 @@
+/* NetworkBuffer
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "NetworkBuffer.h"
+#include "NetworkStack.h"
+#include "Socket.h"
+
+
+NetworkBuffer::NetworkBuffer()
+    : _stack(0), _buf(0), _size(0), _sent(0), _segment(0), _segment_offset(0)
+{
+}
+
+NetworkBuffer::~NetworkBuffer()
+{
+    release();
+}
+
+nsapi_error_t NetworkBuffer::allocate(Socket *socket, nsapi_size_t size)
+{
+    release();
+
+    if (!socket->_stack) {
+        return NSAPI_ERROR_NO_SOCKET;
+    }
+
+    nsapi_buf_t buf;
+    nsapi_error_t err = socket->_stack->buffer_alloc(&buf, size);
+    if (err) {
+        return err;
+    }
+
+    attach(socket->_stack, buf, size);
+    return NSAPI_ERROR_OK;
+}
+
+void NetworkBuffer::release()
+{
+    if (_buf) {
+        _stack->buffer_free(_buf);
+    }
+
+    attach(0, 0, 0);
+}
+
+nsapi_size_t NetworkBuffer::size() const
+{
+    return _size;
+}
+
+nsapi_size_t NetworkBuffer::segment(nsapi_size_t offset, void **data)
+{
+    if (offset >= _size) {
+        return 0;
+    }
+
+    // Segments only link forward, so start over to go back
+    if (!_segment || offset < _segment_offset) {
+        _segment = _buf;
+        _segment_offset = 0;
+    }
+
+    while (true) {
+        void *seg_data;
+        nsapi_size_t seg_len;
+        nsapi_buf_t next = _stack->buffer_segment(_segment, &seg_data, &seg_len);
+
+        if (offset < _segment_offset + seg_len) {
+            *data = (uint8_t *)seg_data + (offset - _segment_offset);
+            return _segment_offset + seg_len - offset;
+        }
+
+        if (!next) {
+            return 0;
+        }
+
+        _segment = next;
+        _segment_offset += seg_len;
+    }
+}
+
+void NetworkBuffer::attach(NetworkStack *stack, nsapi_buf_t buf, nsapi_size_t size)
+{
+    _stack = stack;
+    _buf = buf;
+    _size = size;
+    _sent = 0;
+    _segment = 0;
+    _segment_offset = 0;
+}
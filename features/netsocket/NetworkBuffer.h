@@ -0,0 +1,108 @@
+
+/** \addtogroup netsocket */
+/** @{*/
+/* NetworkBuffer
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef NETWORK_BUFFER_H
+#define NETWORK_BUFFER_H
+
+#include "nsapi_types.h"
+#include "platform/NonCopyable.h"
+
+// Predeclared classes
+class NetworkStack;
+class Socket;
+
+
+/** Buffer owned by a network stack
+ *
+ *  Data is sent from and received into a NetworkBuffer without being
+ *  copied between the stack and the application, on stacks that support
+ *  it. The data is a chain of contiguous segments, accessed with segment.
+ *
+ *  @code
+ *  NetworkBuffer buffer;
+ *  if (socket.recv(buffer) > 0) {
+ *      void *data;
+ *      for (nsapi_size_t offset = 0; offset < buffer.size(); ) {
+ *          offset += process(data, buffer.segment(offset, &data));
+ *      }
+ *  }
+ *  buffer.release();
+ *  @endcode
+ */
+class NetworkBuffer : private mbed::NonCopyable<NetworkBuffer> {
+public:
+    /** Create an empty buffer
+     */
+    NetworkBuffer();
+
+    /** Destroy a buffer, releasing its data
+     */
+    ~NetworkBuffer();
+
+    /** Allocate a buffer to fill and send over a socket
+     *
+     *  Any data already held is released first.
+     *
+     *  @param socket   Open socket the buffer is sent over
+     *  @param size     Size of the buffer in bytes
+     *  @return         0 on success, negative error code on failure
+     */
+    nsapi_error_t allocate(Socket *socket, nsapi_size_t size);
+
+    /** Release the data of the buffer to its stack
+     */
+    void release();
+
+    /** Size of the data in the buffer
+     *
+     *  @return         Size of the data in bytes, or 0 if the buffer is empty
+     */
+    nsapi_size_t size() const;
+
+    /** Access the data at an offset in the buffer
+     *
+     *  Accessing the segments in order is cheapest.
+     *
+     *  @param offset   Offset in bytes from the start of the buffer
+     *  @param data     Destination for a pointer to the data at offset
+     *  @return         Number of contiguous bytes at data, or 0 if offset
+     *                  is past the end of the buffer
+     */
+    nsapi_size_t segment(nsapi_size_t offset, void **data);
+
+protected:
+    friend class TCPSocket;
+    friend class UDPSocket;
+
+    void attach(NetworkStack *stack, nsapi_buf_t buf, nsapi_size_t size);
+
+    NetworkStack *_stack;
+    nsapi_buf_t _buf;
+    nsapi_size_t _size;
+    nsapi_size_t _sent;
+
+    // Segment last accessed, and its offset in the buffer
+    nsapi_buf_t _segment;
+    nsapi_size_t _segment_offset;
+};
+
+
+#endif
+
+/** @}*/
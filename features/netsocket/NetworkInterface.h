@@ -19,6 +19,7 @@
 
 #include "netsocket/nsapi_types.h"
 #include "netsocket/SocketAddress.h"
+#include "platform/Callback.h"
 
 // Predeclared class
 class NetworkStack;
@@ -119,6 +120,36 @@ public:
     virtual nsapi_error_t gethostbyname(const char *host,
             SocketAddress *address, nsapi_version_t version = NSAPI_UNSPEC);
 
+    /** Hostname translation callback, for asynchronous hostname translation
+     *
+     *  @param result   0 on success, negative error code on failure
+     *  @param address  On success, the translated address, which is only
+     *                  valid during the callback
+     */
+    typedef mbed::Callback<void (nsapi_error_t result, SocketAddress *address)> hostbyname_cb_t;
+
+    /** Translates a hostname to an IP address with specific version without blocking
+     *
+     *  @see NetworkStack::gethostbyname_async
+     *
+     *  @param host     Hostname to resolve
+     *  @param callback Callback that is called with the result
+     *  @param version  IP version of address to resolve, NSAPI_UNSPEC indicates
+     *                  version is chosen by the stack (defaults to NSAPI_UNSPEC)
+     *  @return         0 if the callback was already called, a positive id
+     *                  for cancelling the translation, or a negative error
+     *                  code on failure, in which case the callback is not called
+     */
+    virtual nsapi_value_or_error_t gethostbyname_async(const char *host,
+            hostbyname_cb_t callback, nsapi_version_t version = NSAPI_UNSPEC);
+
+    /** Cancels an asynchronous hostname translation
+     *
+     *  @param id       Id returned by gethostbyname_async
+     *  @return         0 on success, negative error code on failure
+     */
+    virtual nsapi_error_t gethostbyname_async_cancel(int id);
+
     /** Add a domain name server to list of servers to query
      *
      *  @param address  Destination for the host address
@@ -20,8 +20,26 @@
 #include "stddef.h"
 #include <new>
 
+#ifndef MBED_CONF_NSAPI_BUFFER_RECV_SIZE
+#define MBED_CONF_NSAPI_BUFFER_RECV_SIZE 536
+#endif
+
 
 // Default NetworkStack operations
+static nsapi_version_t dns_version(NetworkStack *stack, nsapi_version_t version)
+{
+    // if the version is unspecified, try to guess the version from the
+    // ip address of the underlying stack
+    if (version == NSAPI_UNSPEC) {
+        SocketAddress testaddress;
+        if (testaddress.set_ip_address(stack->get_ip_address())) {
+            version = testaddress.get_ip_version();
+        }
+    }
+
+    return version;
+}
+
 nsapi_error_t NetworkStack::gethostbyname(const char *name, SocketAddress *address, nsapi_version_t version)
 {
     // check for simple ip addresses
@@ -33,16 +51,28 @@ nsapi_error_t NetworkStack::gethostbyname(const char *name, SocketAddress *addre
         return NSAPI_ERROR_OK;
     }
 
-    // if the version is unspecified, try to guess the version from the
-    // ip address of the underlying stack
-    if (version == NSAPI_UNSPEC) {
-        SocketAddress testaddress;
-        if (testaddress.set_ip_address(this->get_ip_address())) {
-            version = testaddress.get_ip_version();
+    return nsapi_dns_query(this, name, address, dns_version(this, version));
+}
+
+nsapi_value_or_error_t NetworkStack::gethostbyname_async(const char *name, hostbyname_cb_t callback, nsapi_version_t version)
+{
+    // check for simple ip addresses
+    SocketAddress address;
+    if (address.set_ip_address(name)) {
+        if (version != NSAPI_UNSPEC && address.get_ip_version() != version) {
+            return NSAPI_ERROR_DNS_FAILURE;
         }
+
+        callback(NSAPI_ERROR_OK, &address);
+        return NSAPI_ERROR_OK;
     }
 
-    return nsapi_dns_query(this, name, address, version);
+    return nsapi_dns_query_async(this, name, callback, dns_version(this, version));
+}
+
+nsapi_error_t NetworkStack::gethostbyname_async_cancel(int id)
+{
+    return nsapi_dns_query_async_cancel(id);
 }
 
 nsapi_error_t NetworkStack::add_dns_server(const SocketAddress &address)
@@ -71,6 +101,131 @@ nsapi_error_t NetworkStack::getsockopt(void *handle, int level, int optname, voi
 }
 
 
+// Default buffers are single heap blocks, the data follows the length
+struct nsapi_heap_buf {
+    nsapi_size_t len;
+};
+
+nsapi_error_t NetworkStack::buffer_alloc(nsapi_buf_t *buf, nsapi_size_t size)
+{
+    nsapi_heap_buf *heap_buf = (nsapi_heap_buf *)malloc(sizeof(nsapi_heap_buf) + size);
+    if (!heap_buf) {
+        return NSAPI_ERROR_NO_MEMORY;
+    }
+
+    heap_buf->len = size;
+    *buf = heap_buf;
+    return NSAPI_ERROR_OK;
+}
+
+void NetworkStack::buffer_free(nsapi_buf_t buf)
+{
+    free(buf);
+}
+
+nsapi_buf_t NetworkStack::buffer_segment(nsapi_buf_t segment, void **data, nsapi_size_t *len)
+{
+    nsapi_heap_buf *heap_buf = (nsapi_heap_buf *)segment;
+    *data = heap_buf + 1;
+    *len = heap_buf->len;
+    return NULL;
+}
+
+nsapi_size_or_error_t NetworkStack::socket_recv_buffer(nsapi_socket_t handle, nsapi_buf_t *buf)
+{
+    nsapi_error_t err = buffer_alloc(buf, MBED_CONF_NSAPI_BUFFER_RECV_SIZE);
+    if (err) {
+        return err;
+    }
+
+    nsapi_heap_buf *heap_buf = (nsapi_heap_buf *)*buf;
+    nsapi_size_or_error_t recv = socket_recv(handle, heap_buf + 1, heap_buf->len);
+    if (recv <= 0) {
+        buffer_free(*buf);
+        *buf = NULL;
+        return recv;
+    }
+
+    heap_buf->len = recv;
+    return recv;
+}
+
+nsapi_size_or_error_t NetworkStack::socket_recvfrom_buffer(nsapi_socket_t handle, SocketAddress *address, nsapi_buf_t *buf)
+{
+    nsapi_error_t err = buffer_alloc(buf, MBED_CONF_NSAPI_BUFFER_RECV_SIZE);
+    if (err) {
+        return err;
+    }
+
+    nsapi_heap_buf *heap_buf = (nsapi_heap_buf *)*buf;
+    nsapi_size_or_error_t recv = socket_recvfrom(handle, address, heap_buf + 1, heap_buf->len);
+    if (recv < 0) {
+        buffer_free(*buf);
+        *buf = NULL;
+        return recv;
+    }
+
+    heap_buf->len = recv;
+    return recv;
+}
+
+nsapi_size_or_error_t NetworkStack::socket_send_buffer(nsapi_socket_t handle, nsapi_buf_t buf, nsapi_size_t offset)
+{
+    nsapi_heap_buf *heap_buf = (nsapi_heap_buf *)buf;
+    if (offset >= heap_buf->len) {
+        return 0;
+    }
+
+    return socket_send(handle, (uint8_t *)(heap_buf + 1) + offset, heap_buf->len - offset);
+}
+
+nsapi_size_or_error_t NetworkStack::socket_sendto_buffer(nsapi_socket_t handle, const SocketAddress &address, nsapi_buf_t buf)
+{
+    nsapi_heap_buf *heap_buf = (nsapi_heap_buf *)buf;
+    return socket_sendto(handle, address, heap_buf + 1, heap_buf->len);
+}
+
+// Default batches are one call per packet, an error after the first packet
+// ends the batch early
+nsapi_size_or_error_t NetworkStack::socket_sendto_batch(nsapi_socket_t handle, nsapi_msg_t *msgs, nsapi_size_t count)
+{
+    nsapi_size_t i;
+    for (i = 0; i < count; i++) {
+        nsapi_size_or_error_t sent = socket_sendto(handle,
+                SocketAddress(msgs[i].addr, msgs[i].port), msgs[i].data, msgs[i].size);
+        if (sent < 0) {
+            if (i == 0) {
+                return sent;
+            }
+            break;
+        }
+        msgs[i].len = sent;
+    }
+
+    return i;
+}
+
+nsapi_size_or_error_t NetworkStack::socket_recvfrom_batch(nsapi_socket_t handle, nsapi_msg_t *msgs, nsapi_size_t count)
+{
+    nsapi_size_t i;
+    for (i = 0; i < count; i++) {
+        SocketAddress address;
+        nsapi_size_or_error_t recv = socket_recvfrom(handle, &address, msgs[i].data, msgs[i].size);
+        if (recv < 0) {
+            if (i == 0) {
+                return recv;
+            }
+            break;
+        }
+        msgs[i].addr = address.get_addr();
+        msgs[i].port = address.get_port();
+        msgs[i].len = recv;
+    }
+
+    return i;
+}
+
+
 // NetworkStackWrapper class for encapsulating the raw nsapi_stack structure
 class NetworkStackWrapper : public NetworkStack
 {
@@ -111,6 +266,23 @@ public:
         return err;
     }
 
+    virtual nsapi_value_or_error_t gethostbyname_async(const char *name, hostbyname_cb_t callback, nsapi_version_t version)
+    {
+        if (!_stack_api()->gethostbyname) {
+            return NetworkStack::gethostbyname_async(name, callback, version);
+        }
+
+        // The stack only resolves names blocking, so it completes here
+        SocketAddress address;
+        nsapi_error_t err = gethostbyname(name, &address, version);
+        if (err) {
+            return err;
+        }
+
+        callback(NSAPI_ERROR_OK, &address);
+        return NSAPI_ERROR_OK;
+    }
+
     virtual nsapi_error_t add_dns_server(const SocketAddress &address)
     {
         if (!_stack_api()->add_dns_server) {
@@ -275,6 +447,98 @@ protected:
 
         return _stack_api()->getsockopt(_stack(), socket, level, optname, optval, optlen);
     }
+
+    // Stacks provide either all or none of the buffer functions
+    virtual nsapi_error_t buffer_alloc(nsapi_buf_t *buf, nsapi_size_t size)
+    {
+        if (!_stack_api()->buf_free) {
+            return NetworkStack::buffer_alloc(buf, size);
+        }
+
+        return _stack_api()->buf_alloc(_stack(), buf, size);
+    }
+
+    virtual void buffer_free(nsapi_buf_t buf)
+    {
+        if (!_stack_api()->buf_free) {
+            return NetworkStack::buffer_free(buf);
+        }
+
+        _stack_api()->buf_free(_stack(), buf);
+    }
+
+    virtual nsapi_buf_t buffer_segment(nsapi_buf_t segment, void **data, nsapi_size_t *len)
+    {
+        if (!_stack_api()->buf_free) {
+            return NetworkStack::buffer_segment(segment, data, len);
+        }
+
+        return _stack_api()->buf_segment(_stack(), segment, data, len);
+    }
+
+    virtual nsapi_size_or_error_t socket_recv_buffer(nsapi_socket_t socket, nsapi_buf_t *buf)
+    {
+        if (!_stack_api()->buf_free) {
+            return NetworkStack::socket_recv_buffer(socket, buf);
+        }
+
+        return _stack_api()->socket_recv_buf(_stack(), socket, buf);
+    }
+
+    virtual nsapi_size_or_error_t socket_recvfrom_buffer(nsapi_socket_t socket, SocketAddress *address, nsapi_buf_t *buf)
+    {
+        if (!_stack_api()->buf_free) {
+            return NetworkStack::socket_recvfrom_buffer(socket, address, buf);
+        }
+
+        nsapi_addr_t addr = {NSAPI_IPv4, 0};
+        uint16_t port = 0;
+
+        nsapi_size_or_error_t err = _stack_api()->socket_recvfrom_buf(_stack(), socket, &addr, &port, buf);
+
+        if (address) {
+            address->set_addr(addr);
+            address->set_port(port);
+        }
+
+        return err;
+    }
+
+    virtual nsapi_size_or_error_t socket_send_buffer(nsapi_socket_t socket, nsapi_buf_t buf, nsapi_size_t offset)
+    {
+        if (!_stack_api()->buf_free) {
+            return NetworkStack::socket_send_buffer(socket, buf, offset);
+        }
+
+        return _stack_api()->socket_send_buf(_stack(), socket, buf, offset);
+    }
+
+    virtual nsapi_size_or_error_t socket_sendto_buffer(nsapi_socket_t socket, const SocketAddress &address, nsapi_buf_t buf)
+    {
+        if (!_stack_api()->buf_free) {
+            return NetworkStack::socket_sendto_buffer(socket, address, buf);
+        }
+
+        return _stack_api()->socket_sendto_buf(_stack(), socket, address.get_addr(), address.get_port(), buf);
+    }
+
+    virtual nsapi_size_or_error_t socket_sendto_batch(nsapi_socket_t socket, nsapi_msg_t *msgs, nsapi_size_t count)
+    {
+        if (!_stack_api()->socket_sendto_batch) {
+            return NetworkStack::socket_sendto_batch(socket, msgs, count);
+        }
+
+        return _stack_api()->socket_sendto_batch(_stack(), socket, msgs, count);
+    }
+
+    virtual nsapi_size_or_error_t socket_recvfrom_batch(nsapi_socket_t socket, nsapi_msg_t *msgs, nsapi_size_t count)
+    {
+        if (!_stack_api()->socket_recvfrom_batch) {
+            return NetworkStack::socket_recvfrom_batch(socket, msgs, count);
+        }
+
+        return _stack_api()->socket_recvfrom_batch(_stack(), socket, msgs, count);
+    }
 };
 
 
@@ -60,6 +60,47 @@ public:
     virtual nsapi_error_t gethostbyname(const char *host,
             SocketAddress *address, nsapi_version_t version = NSAPI_UNSPEC);
 
+    /** Hostname translation callback, for asynchronous hostname translation
+     *
+     *  @param result   0 on success, negative error code on failure
+     *  @param address  On success, the translated address, which is only
+     *                  valid during the callback
+     */
+    typedef NetworkInterface::hostbyname_cb_t hostbyname_cb_t;
+
+    /** Translates a hostname to an IP address with specific version without blocking
+     *
+     *  The hostname may be either a domain name or an IP address. If the
+     *  hostname is an IP address, or its address is in the DNS cache, the
+     *  callback is called before this returns.
+     *
+     *  Otherwise the question is sent to all DNS servers at once, and the
+     *  first one to answer with an address wins. The callback is called
+     *  from the shared event queue, see mbed_event_queue().
+     *
+     *  If no stack-specific DNS resolution is provided, the hostname
+     *  will be resolve using a UDP socket on the stack.
+     *
+     *  @param host     Hostname to resolve
+     *  @param callback Callback that is called with the result
+     *  @param version  IP version of address to resolve, NSAPI_UNSPEC indicates
+     *                  version is chosen by the stack (defaults to NSAPI_UNSPEC)
+     *  @return         0 if the callback was already called, a positive id
+     *                  for cancelling the translation, or a negative error
+     *                  code on failure, in which case the callback is not called
+     */
+    virtual nsapi_value_or_error_t gethostbyname_async(const char *host,
+            hostbyname_cb_t callback, nsapi_version_t version = NSAPI_UNSPEC);
+
+    /** Cancels an asynchronous hostname translation
+     *
+     *  The callback is not called once this returns.
+     *
+     *  @param id       Id returned by gethostbyname_async
+     *  @return         0 on success, negative error code on failure
+     */
+    virtual nsapi_error_t gethostbyname_async_cancel(int id);
+
     /** Add a domain name server to list of servers to query
      *
      *  @param address  Destination for the host address
@@ -103,6 +144,7 @@ protected:
     friend class UDPSocket;
     friend class TCPSocket;
     friend class TCPServer;
+    friend class NetworkBuffer;
 
     /** Opens a socket
      *
@@ -299,6 +341,125 @@ protected:
      */
     virtual nsapi_error_t getsockopt(nsapi_socket_t handle, int level,
             int optname, void *optval, unsigned *optlen);
+
+    /** Allocate a buffer to fill and send
+     *
+     *  Stacks that can send and receive their own buffers without copying
+     *  the data override all the buffer functions. By default they are
+     *  single heap blocks the data is copied to and from.
+     *
+     *  @param buf      Destination for the buffer
+     *  @param size     Size of the buffer in bytes
+     *  @return         0 on success, negative error code on failure
+     */
+    virtual nsapi_error_t buffer_alloc(nsapi_buf_t *buf, nsapi_size_t size);
+
+    /** Free a buffer
+     *
+     *  @param buf      Buffer allocated or received from the stack
+     */
+    virtual void buffer_free(nsapi_buf_t buf);
+
+    /** Get the data of a segment of a buffer
+     *
+     *  @param segment  Buffer, or a segment returned by an earlier call
+     *  @param data     Destination for the data of the segment
+     *  @param len      Destination for the length of the segment in bytes
+     *  @return         The next segment, or NULL if this is the last one
+     */
+    virtual nsapi_buf_t buffer_segment(nsapi_buf_t segment, void **data, nsapi_size_t *len);
+
+    /** Receive data over a TCP socket into a buffer owned by the caller
+     *
+     *  This call is non-blocking. If recv would block,
+     *  NSAPI_ERROR_WOULD_BLOCK is returned immediately.
+     *
+     *  @param handle   Socket handle
+     *  @param buf      Destination for a buffer of the received data
+     *  @return         Number of received bytes on success, negative error
+     *                  code on failure
+     */
+    virtual nsapi_size_or_error_t socket_recv_buffer(nsapi_socket_t handle, nsapi_buf_t *buf);
+
+    /** Receive a packet over a UDP socket into a buffer owned by the caller
+     *
+     *  This call is non-blocking. If recvfrom would block,
+     *  NSAPI_ERROR_WOULD_BLOCK is returned immediately.
+     *
+     *  @param handle   Socket handle
+     *  @param address  Destination for the source address or NULL
+     *  @param buf      Destination for a buffer of the received packet
+     *  @return         Number of received bytes on success, negative error
+     *                  code on failure
+     */
+    virtual nsapi_size_or_error_t socket_recvfrom_buffer(nsapi_socket_t handle,
+            SocketAddress *address, nsapi_buf_t *buf);
+
+    /** Send the data of a buffer over a TCP socket
+     *
+     *  This call is non-blocking. If send would block,
+     *  NSAPI_ERROR_WOULD_BLOCK is returned immediately.
+     *
+     *  @param handle   Socket handle
+     *  @param buf      Buffer from the stack
+     *  @param offset   Offset of the data to send in the buffer
+     *  @return         Number of sent bytes on success, negative error
+     *                  code on failure
+     */
+    virtual nsapi_size_or_error_t socket_send_buffer(nsapi_socket_t handle,
+            nsapi_buf_t buf, nsapi_size_t offset);
+
+    /** Send a buffer as a packet over a UDP socket
+     *
+     *  The contents of the buffer are undefined once sent. This call is
+     *  non-blocking. If sendto would block, NSAPI_ERROR_WOULD_BLOCK is
+     *  returned immediately.
+     *
+     *  @param handle   Socket handle
+     *  @param address  The SocketAddress of the remote host
+     *  @param buf      Buffer from the stack
+     *  @return         Number of sent bytes on success, negative error
+     *                  code on failure
+     */
+    virtual nsapi_size_or_error_t socket_sendto_buffer(nsapi_socket_t handle,
+            const SocketAddress &address, nsapi_buf_t buf);
+
+    /** Send several packets over a UDP socket
+     *
+     *  Sends the packets in order until one would block or fails, and
+     *  fills in the len of each packet sent. By default the packets are
+     *  sent one at a time with socket_sendto, stacks override this to
+     *  send a batch at a lower cost per packet.
+     *
+     *  This call is non-blocking. If no packet can be sent,
+     *  NSAPI_ERROR_WOULD_BLOCK is returned immediately.
+     *
+     *  @param handle   Socket handle
+     *  @param msgs     Packets to send
+     *  @param count    Number of packets
+     *  @return         Number of packets sent on success, negative error
+     *                  code if the first packet could not be sent
+     */
+    virtual nsapi_size_or_error_t socket_sendto_batch(nsapi_socket_t handle,
+            nsapi_msg_t *msgs, nsapi_size_t count);
+
+    /** Receive several packets over a UDP socket
+     *
+     *  Receives the packets already queued on the socket up to count,
+     *  filling in the address, port and len of each. By default the
+     *  packets are received one at a time with socket_recvfrom.
+     *
+     *  This call is non-blocking. If no packet is queued,
+     *  NSAPI_ERROR_WOULD_BLOCK is returned immediately.
+     *
+     *  @param handle   Socket handle
+     *  @param msgs     Destinations for the packets
+     *  @param count    Number of destinations
+     *  @return         Number of packets received on success, negative
+     *                  error code if no packet could be received
+     */
+    virtual nsapi_size_or_error_t socket_recvfrom_batch(nsapi_socket_t handle,
+            nsapi_msg_t *msgs, nsapi_size_t count);
 };
 
 
@@ -200,6 +200,8 @@ public:
     }
 
 protected:
+    friend class NetworkBuffer;
+
     Socket();
     virtual nsapi_protocol_t get_proto() = 0;
     virtual void event() = 0;
@@ -66,18 +66,19 @@ static void ipv4_from_address(uint8_t *bytes, const char *addr)
     int i = 0;
 
     for (; count < NSAPI_IPv4_BYTES; count++) {
-        unsigned char b;
-        int scanned = sscanf(&addr[i], "%hhu", &b);
-        if (scanned < 1) {
+        if (addr[i] < '0' || addr[i] > '9') {
             return;
         }
 
+        uint8_t b = 0;
+        for (; addr[i] >= '0' && addr[i] <= '9'; i++) {
+            b = 10*b + (addr[i] - '0');
+        }
+
         bytes[count] = b;
 
-        for (; addr[i] != '.'; i++) {
-            if (!addr[i]) {
-                return;
-            }
+        if (addr[i] != '.') {
+            return;
         }
 
         i++;
@@ -89,18 +90,22 @@ static int ipv6_scan_chunk(uint16_t *shorts, const char *chunk) {
     int i = 0;
 
     for (; count < NSAPI_IPv6_BYTES/2; count++) {
-        unsigned short s;
-        int scanned = sscanf(&chunk[i], "%hx", &s);
-        if (scanned < 1) {
+        // Digits were checked by ipv6_is_valid, only the letter case varies
+        uint16_t s = 0;
+        int digits = 0;
+        for (; chunk[i] && chunk[i] != ':'; i++, digits++) {
+            char c = chunk[i] | 0x20;
+            s = (s << 4) | (c <= '9' ? c - '0' : c - 'a' + 10);
+        }
+
+        if (!digits) {
             return count;
         }
 
         shorts[count] = s;
 
-        for (; chunk[i] != ':'; i++) {
-            if (!chunk[i]) {
-                return count+1;
-            }
+        if (!chunk[i]) {
+            return count+1;
         }
 
         i++;
@@ -141,16 +146,33 @@ static void ipv6_from_address(uint8_t *bytes, const char *addr)
 
 static void ipv4_to_address(char *addr, const uint8_t *bytes)
 {
-    sprintf(addr, "%d.%d.%d.%d", bytes[0], bytes[1], bytes[2], bytes[3]);
+    for (int i = 0; i < NSAPI_IPv4_BYTES; i++) {
+        uint8_t b = bytes[i];
+        if (b >= 100) {
+            *addr++ = '0' + b/100;
+        }
+        if (b >= 10) {
+            *addr++ = '0' + (b/10)%10;
+        }
+        *addr++ = '0' + b%10;
+        *addr++ = '.';
+    }
+    addr[-1] = '\0';
 }
 
 static void ipv6_to_address(char *addr, const uint8_t *bytes)
 {
-    for (int i = 0; i < NSAPI_IPv6_BYTES/2; i++) {
-        sprintf(&addr[5*i], "%02x%02x", bytes[2*i], bytes[2*i+1]);
-        addr[5*i+4] = ':';
+    static const char hex[] = "0123456789abcdef";
+
+    for (int i = 0; i < NSAPI_IPv6_BYTES; i++) {
+        addr[0] = hex[bytes[i] >> 4];
+        addr[1] = hex[bytes[i] & 0xf];
+        addr += 2;
+        if (i & 1) {
+            *addr++ = ':';
+        }
     }
-    addr[NSAPI_IPv6_SIZE-1] = '\0';
+    addr[-1] = '\0';
 }
 
 
@@ -0,0 +1,219 @@
+/* SocketSet
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "SocketSet.h"
+#include "platform/mbed_critical.h"
+#include "cmsis_os2.h"
+
+#define READY_FLAG 0x1u
+
+struct SocketSet::entry {
+    SocketSet *set;
+    Socket *socket;
+    void *data;
+    Trigger trigger;
+    bool queued;
+
+    entry *next;
+    entry *ready_next;
+
+    void event()
+    {
+        set->queue(this);
+    }
+};
+
+
+SocketSet::SocketSet()
+    : _entries(0), _ready(0), _ready_tail(0)
+{
+}
+
+SocketSet::~SocketSet()
+{
+    while (_entries) {
+        remove(_entries->socket);
+    }
+}
+
+nsapi_error_t SocketSet::add(Socket *socket, void *data, Trigger trigger)
+{
+    if (!socket || find(socket)) {
+        return NSAPI_ERROR_PARAMETER;
+    }
+
+    entry *e = new entry;
+    e->set = this;
+    e->socket = socket;
+    e->data = data;
+    e->trigger = trigger;
+    e->queued = false;
+    e->next = _entries;
+    e->ready_next = 0;
+    _entries = e;
+
+    socket->sigio(mbed::callback(e, &entry::event));
+
+    // The state of the socket is not known yet
+    queue(e);
+    return NSAPI_ERROR_OK;
+}
+
+nsapi_error_t SocketSet::remove(Socket *socket)
+{
+    entry **p = &_entries;
+    while (*p && (*p)->socket != socket) {
+        p = &(*p)->next;
+    }
+
+    entry *e = *p;
+    if (!e) {
+        return NSAPI_ERROR_NO_SOCKET;
+    }
+
+    socket->sigio(0);
+    unqueue(e);
+    *p = e->next;
+    delete e;
+    return NSAPI_ERROR_OK;
+}
+
+void SocketSet::clear(Socket *socket)
+{
+    entry *e = find(socket);
+    if (e) {
+        unqueue(e);
+    }
+}
+
+int SocketSet::wait(Event *events, unsigned count, int timeout)
+{
+    uint32_t start = osKernelGetTickCount();
+
+    while (true) {
+        unsigned n = 0;
+        entry *level = 0;
+        entry *level_tail = 0;
+
+        core_util_critical_section_enter();
+        while (n < count && _ready) {
+            entry *e = _ready;
+            _ready = e->ready_next;
+            e->ready_next = 0;
+
+            events[n].socket = e->socket;
+            events[n].data = e->data;
+            n++;
+
+            // Level triggered sockets go back to the end of the queue
+            if (e->trigger == TRIGGER_LEVEL) {
+                if (level_tail) {
+                    level_tail->ready_next = e;
+                } else {
+                    level = e;
+                }
+                level_tail = e;
+            } else {
+                e->queued = false;
+            }
+        }
+
+        if (!_ready) {
+            _ready_tail = 0;
+        }
+
+        if (level) {
+            if (_ready_tail) {
+                _ready_tail->ready_next = level;
+            } else {
+                _ready = level;
+            }
+            _ready_tail = level_tail;
+        }
+        core_util_critical_section_exit();
+
+        if (n > 0) {
+            return n;
+        }
+
+        uint32_t wait = osWaitForever;
+        if (timeout >= 0) {
+            uint32_t elapsed = osKernelGetTickCount() - start;
+            if (elapsed >= (uint32_t)timeout) {
+                return 0;
+            }
+            wait = (uint32_t)timeout - elapsed;
+        }
+
+        if (_flags.wait_any(READY_FLAG, wait) & osFlagsError) {
+            return 0;
+        }
+    }
+}
+
+SocketSet::entry *SocketSet::find(Socket *socket)
+{
+    for (entry *e = _entries; e; e = e->next) {
+        if (e->socket == socket) {
+            return e;
+        }
+    }
+
+    return 0;
+}
+
+void SocketSet::queue(entry *e)
+{
+    core_util_critical_section_enter();
+    if (!e->queued) {
+        e->queued = true;
+        e->ready_next = 0;
+        if (_ready_tail) {
+            _ready_tail->ready_next = e;
+        } else {
+            _ready = e;
+        }
+        _ready_tail = e;
+    }
+    core_util_critical_section_exit();
+
+    _flags.set(READY_FLAG);
+}
+
+void SocketSet::unqueue(entry *e)
+{
+    core_util_critical_section_enter();
+    if (e->queued) {
+        entry *prev = 0;
+        for (entry *q = _ready; q; prev = q, q = q->ready_next) {
+            if (q == e) {
+                if (prev) {
+                    prev->ready_next = e->ready_next;
+                } else {
+                    _ready = e->ready_next;
+                }
+                if (_ready_tail == e) {
+                    _ready_tail = prev;
+                }
+                break;
+            }
+        }
+
+        e->queued = false;
+        e->ready_next = 0;
+    }
+    core_util_critical_section_exit();
+}
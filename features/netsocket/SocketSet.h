@@ -0,0 +1,132 @@
+
+/** \addtogroup netsocket */
+/** @{*/
+/* SocketSet
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SOCKET_SET_H
+#define SOCKET_SET_H
+
+#include "netsocket/Socket.h"
+#include "rtos/EventFlags.h"
+#include "platform/NonCopyable.h"
+
+
+/** Set of sockets to wait on for events
+ *
+ *  A SocketSet collects the events of many sockets into one queue, so a
+ *  single thread can serve all of them. Each wait returns the sockets that
+ *  have had events, in the order of the events, and handling them takes
+ *  time in the number of ready sockets rather than in the size of the set.
+ *
+ *  Edge triggered sockets are returned once for each event, and the
+ *  application serves them until an operation would block. Level triggered
+ *  sockets are returned by every wait until the application clears them,
+ *  typically once an operation returns NSAPI_ERROR_WOULD_BLOCK. As the state
+ *  of a socket is not known when it is added, it is returned once then.
+ *
+ *  @code
+ *  SocketSet set;
+ *  set.add(&socket_a, &client_a);
+ *  set.add(&socket_b, &client_b);
+ *
+ *  SocketSet::Event events[4];
+ *  while (true) {
+ *      int count = set.wait(events, 4);
+ *      for (int i = 0; i < count; i++) {
+ *          serve((Client *)events[i].data);
+ *      }
+ *  }
+ *  @endcode
+ *
+ *  @note The set takes over the sigio callback of its sockets, and sockets
+ *  must be removed from it before they are closed or destroyed. Only one
+ *  thread should add, remove and wait, events may arrive from any context.
+ */
+class SocketSet : private mbed::NonCopyable<SocketSet> {
+public:
+    /** How often a ready socket is returned
+     */
+    enum Trigger {
+        TRIGGER_EDGE,   /*!< once per event */
+        TRIGGER_LEVEL,  /*!< until cleared */
+    };
+
+    /** Socket returned by wait
+     */
+    struct Event {
+        Socket *socket; /*!< socket that had events */
+        void *data;     /*!< data the socket was added with */
+    };
+
+    /** Create an empty set
+     */
+    SocketSet();
+
+    /** Destroy a set, removing all of its sockets
+     */
+    ~SocketSet();
+
+    /** Add a socket to the set
+     *
+     *  @param socket   Socket to wait on
+     *  @param data     Data returned with the events of the socket
+     *  @param trigger  How often the socket is returned when ready
+     *  @return         0 on success, negative error code on failure
+     */
+    nsapi_error_t add(Socket *socket, void *data = NULL, Trigger trigger = TRIGGER_EDGE);
+
+    /** Remove a socket from the set
+     *
+     *  The sigio callback of the socket is cleared.
+     *
+     *  @param socket   Socket to remove
+     *  @return         0 on success, negative error code on failure
+     */
+    nsapi_error_t remove(Socket *socket);
+
+    /** Stop returning a level triggered socket until its next event
+     *
+     *  @param socket   Socket to clear
+     */
+    void clear(Socket *socket);
+
+    /** Wait for sockets to have events
+     *
+     *  @param events   Destination for the ready sockets
+     *  @param count    Number of events that fit in events
+     *  @param timeout  Timeout in milliseconds, or -1 to wait forever
+     *  @return         Number of ready sockets, or 0 on timeout
+     */
+    int wait(Event *events, unsigned count, int timeout = -1);
+
+protected:
+    struct entry;
+
+    entry *find(Socket *socket);
+    void unqueue(entry *e);
+    void queue(entry *e);
+
+    rtos::EventFlags _flags;
+    entry *_entries;
+    entry *_ready;
+    entry *_ready_tail;
+};
+
+
+#endif
+
+/** @}*/
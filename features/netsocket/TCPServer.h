@@ -24,6 +24,9 @@
 #include "netsocket/NetworkInterface.h"
 #include "rtos/Semaphore.h"
 
+#ifndef MBED_CONF_NSAPI_TCP_SERVER_BACKLOG
+#define MBED_CONF_NSAPI_TCP_SERVER_BACKLOG 4
+#endif
 
 /** TCP socket server
  *  @addtogroup netsocket
@@ -62,10 +65,10 @@ public:
      *  incoming connections.
      *
      *  @param backlog  Number of pending connections that can be queued
-     *                  simultaneously, defaults to 1
+     *                  simultaneously, defaults to nsapi.tcp-server-backlog
      *  @return         0 on success, negative error code on failure
      */
-    nsapi_error_t listen(int backlog = 1);
+    nsapi_error_t listen(int backlog = MBED_CONF_NSAPI_TCP_SERVER_BACKLOG);
     
     /** Accepts a connection on a TCP socket
      *
@@ -188,6 +188,111 @@ nsapi_size_or_error_t TCPSocket::recv(void *data, nsapi_size_t size)
     return ret;
 }
 
+nsapi_size_or_error_t TCPSocket::send(NetworkBuffer &buffer)
+{
+    _lock.lock();
+    nsapi_size_or_error_t ret;
+
+    // If this assert is hit then there are two threads
+    // performing a send at the same time which is undefined
+    // behavior
+    MBED_ASSERT(!_write_in_progress);
+    _write_in_progress = true;
+
+    while (true) {
+        if (!_socket) {
+            ret = NSAPI_ERROR_NO_SOCKET;
+            break;
+        }
+
+        if (!buffer._buf || buffer._stack != _stack) {
+            ret = NSAPI_ERROR_PARAMETER;
+            break;
+        }
+
+        _pending = 0;
+        ret = _stack->socket_send_buffer(_socket, buffer._buf, buffer._sent);
+        if ((_timeout == 0) || (ret != NSAPI_ERROR_WOULD_BLOCK)) {
+            break;
+        } else {
+            uint32_t flag;
+
+            // Release lock before blocking so other threads
+            // accessing this object aren't blocked
+            _lock.unlock();
+            flag = _event_flag.wait_any(WRITE_FLAG, _timeout);
+            _lock.lock();
+
+            if (flag & osFlagsError) {
+                // Timeout break
+                ret = NSAPI_ERROR_WOULD_BLOCK;
+                break;
+            }
+        }
+    }
+
+    if (ret > 0) {
+        buffer._sent += ret;
+        if (buffer._sent >= buffer._size) {
+            buffer.release();
+        }
+    }
+
+    _write_in_progress = false;
+    _lock.unlock();
+    return ret;
+}
+
+nsapi_size_or_error_t TCPSocket::recv(NetworkBuffer &buffer)
+{
+    _lock.lock();
+    nsapi_size_or_error_t ret;
+
+    // If this assert is hit then there are two threads
+    // performing a recv at the same time which is undefined
+    // behavior
+    MBED_ASSERT(!_read_in_progress);
+    _read_in_progress = true;
+
+    buffer.release();
+
+    while (true) {
+        if (!_socket) {
+            ret = NSAPI_ERROR_NO_SOCKET;
+            break;
+        }
+
+        nsapi_buf_t buf = 0;
+        _pending = 0;
+        ret = _stack->socket_recv_buffer(_socket, &buf);
+        if (ret > 0) {
+            buffer.attach(_stack, buf, ret);
+        }
+
+        if ((_timeout == 0) || (ret != NSAPI_ERROR_WOULD_BLOCK)) {
+            break;
+        } else {
+            uint32_t flag;
+
+            // Release lock before blocking so other threads
+            // accessing this object aren't blocked
+            _lock.unlock();
+            flag = _event_flag.wait_any(READ_FLAG, _timeout);
+            _lock.lock();
+
+            if (flag & osFlagsError) {
+                // Timeout break
+                ret = NSAPI_ERROR_WOULD_BLOCK;
+                break;
+            }
+        }
+    }
+
+    _read_in_progress = false;
+    _lock.unlock();
+    return ret;
+}
+
 void TCPSocket::event()
 {
     _event_flag.set(READ_FLAG|WRITE_FLAG);
@@ -23,6 +23,7 @@
 #include "netsocket/Socket.h"
 #include "netsocket/NetworkStack.h"
 #include "netsocket/NetworkInterface.h"
+#include "netsocket/NetworkBuffer.h"
 #include "rtos/EventFlags.h"
 
 
@@ -110,6 +111,39 @@ public:
      */
     nsapi_size_or_error_t recv(void *data, nsapi_size_t size);
 
+    /** Send a buffer over a TCP socket
+     *
+     *  The socket must be connected to a remote host and the buffer
+     *  allocated on it. Returns the number of bytes sent from the buffer,
+     *  which is released once all of it has been sent. Otherwise send
+     *  again to continue after the data already sent.
+     *
+     *  By default, send blocks until data is sent. If socket is set to
+     *  non-blocking or times out, NSAPI_ERROR_WOULD_BLOCK is returned
+     *  immediately.
+     *
+     *  @param buffer   Buffer of data to send to the host
+     *  @return         Number of sent bytes on success, negative error
+     *                  code on failure
+     */
+    nsapi_size_or_error_t send(NetworkBuffer &buffer);
+
+    /** Receive data over a TCP socket into a buffer of the stack
+     *
+     *  The socket must be connected to a remote host. Any data already in
+     *  the buffer is released, and the buffer then holds the received data
+     *  until it is released.
+     *
+     *  By default, recv blocks until data is sent. If socket is set to
+     *  non-blocking or times out, NSAPI_ERROR_WOULD_BLOCK is returned
+     *  immediately.
+     *
+     *  @param buffer   Destination for data received from the host
+     *  @return         Number of received bytes on success, negative error
+     *                  code on failure
+     */
+    nsapi_size_or_error_t recv(NetworkBuffer &buffer);
+
 protected:
     friend class TCPServer;
 
@@ -0,0 +1,578 @@
+/* TLSSocket
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TLSSocket.h"
+
+#if defined(MBEDTLS_SSL_TLS_C) && defined(MBEDTLS_CTR_DRBG_C) && defined(MBEDTLS_ENTROPY_C) \
+    && defined(MBEDTLS_X509_CRT_PARSE_C)
+
+#include "mbedtls/net_sockets.h"
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef MBED_CONF_NSAPI_TLS_MAX_FRAGMENT_LENGTH
+#define MBED_CONF_NSAPI_TLS_MAX_FRAGMENT_LENGTH 0
+#endif
+
+static const char drbg_personalization[] = "TLSSocket";
+
+TLSSocket::TLSSocket()
+    : _session(NULL)
+#if defined(MBEDTLS_SSL_CACHE_C)
+    , _cache(NULL)
+#endif
+#if defined(MBEDTLS_SSL_TICKET_C)
+    , _ticket(NULL)
+#endif
+    , _mfl_code(MBEDTLS_SSL_MAX_FRAG_LEN_NONE)
+#if defined(TLSSOCKET_ARENA)
+    , _arena_buf(NULL)
+#endif
+    , _stack(NULL)
+    , _io_error(0)
+    , _seeded(false)
+    , _set_up(false)
+    , _tcp_connected(false)
+    , _in_progress(false)
+    , _connected(false)
+{
+    mbedtls_entropy_init(&_entropy);
+    mbedtls_ctr_drbg_init(&_drbg);
+    mbedtls_ssl_config_init(&_conf);
+    mbedtls_ssl_init(&_ssl);
+    mbedtls_x509_crt_init(&_ca_cert);
+    mbedtls_x509_crt_init(&_own_cert);
+    mbedtls_pk_init(&_own_key);
+#if defined(TLSSOCKET_ARENA)
+    memset(&_arena, 0, sizeof(_arena));
+#endif
+
+#if defined(MBEDTLS_SSL_MAX_FRAGMENT_LENGTH)
+    set_max_fragment_length(MBED_CONF_NSAPI_TLS_MAX_FRAGMENT_LENGTH);
+#endif
+}
+
+TLSSocket::~TLSSocket()
+{
+    close();
+
+    mbedtls_pk_free(&_own_key);
+    mbedtls_x509_crt_free(&_own_cert);
+    mbedtls_x509_crt_free(&_ca_cert);
+    mbedtls_ctr_drbg_free(&_drbg);
+    mbedtls_entropy_free(&_entropy);
+}
+
+nsapi_error_t TLSSocket::open(NetworkStack *stack)
+{
+    _lock.lock();
+    nsapi_error_t ret = _tcp.open(stack);
+    if (!ret) {
+        _stack = stack;
+    }
+    _lock.unlock();
+    return ret;
+}
+
+nsapi_error_t TLSSocket::close()
+{
+    _lock.lock();
+    arena_enter();
+
+    if (_connected) {
+        // Best effort, the connection is closed whether it is sent or not
+        mbedtls_ssl_close_notify(&_ssl);
+    }
+    nsapi_error_t ret = _tcp.close();
+
+    // Freeing the context and configuration releases the record buffers
+    mbedtls_ssl_free(&_ssl);
+    mbedtls_ssl_init(&_ssl);
+    mbedtls_ssl_config_free(&_conf);
+    mbedtls_ssl_config_init(&_conf);
+
+    arena_leave();
+#if defined(TLSSOCKET_ARENA)
+    // Nothing of the connection is left in the arena
+    if (_arena_buf) {
+        mbed_tls_arena_free(&_arena);
+        free(_arena_buf);
+        _arena_buf = NULL;
+    }
+#endif
+
+    _stack = NULL;
+    _set_up = false;
+    _tcp_connected = false;
+    _in_progress = false;
+    _connected = false;
+
+    _lock.unlock();
+    return ret;
+}
+
+nsapi_error_t TLSSocket::set_root_ca_cert(const void *certs, size_t len)
+{
+    _lock.lock();
+    int err = mbedtls_x509_crt_parse(&_ca_cert, (const unsigned char *)certs, len);
+    _lock.unlock();
+    return err ? NSAPI_ERROR_PARAMETER : NSAPI_ERROR_OK;
+}
+
+nsapi_error_t TLSSocket::set_own_cert(const void *cert, size_t cert_len,
+        const void *key, size_t key_len)
+{
+    _lock.lock();
+    mbedtls_x509_crt_free(&_own_cert);
+    mbedtls_x509_crt_init(&_own_cert);
+    mbedtls_pk_free(&_own_key);
+    mbedtls_pk_init(&_own_key);
+
+    int err = mbedtls_x509_crt_parse(&_own_cert, (const unsigned char *)cert, cert_len);
+    if (!err) {
+        err = mbedtls_pk_parse_key(&_own_key, (const unsigned char *)key, key_len, NULL, 0);
+    }
+    if (err) {
+        mbedtls_x509_crt_free(&_own_cert);
+        mbedtls_x509_crt_init(&_own_cert);
+        mbedtls_pk_free(&_own_key);
+        mbedtls_pk_init(&_own_key);
+    }
+    _lock.unlock();
+    return err ? NSAPI_ERROR_PARAMETER : NSAPI_ERROR_OK;
+}
+
+#if defined(MBEDTLS_SSL_MAX_FRAGMENT_LENGTH)
+nsapi_error_t TLSSocket::set_max_fragment_length(size_t len)
+{
+    unsigned char code;
+    switch (len) {
+        case 0:     code = MBEDTLS_SSL_MAX_FRAG_LEN_NONE; break;
+        case 512:   code = MBEDTLS_SSL_MAX_FRAG_LEN_512; break;
+        case 1024:  code = MBEDTLS_SSL_MAX_FRAG_LEN_1024; break;
+        case 2048:  code = MBEDTLS_SSL_MAX_FRAG_LEN_2048; break;
+        case 4096:  code = MBEDTLS_SSL_MAX_FRAG_LEN_4096; break;
+        default:    return NSAPI_ERROR_PARAMETER;
+    }
+
+    _lock.lock();
+    _mfl_code = code;
+    _lock.unlock();
+    return NSAPI_ERROR_OK;
+}
+#endif
+
+nsapi_error_t TLSSocket::setup(int endpoint)
+{
+    int err;
+
+#if defined(TLSSOCKET_ARENA)
+    // Entered until the caller leaves, as if it had been set up before
+    if (!_arena_buf) {
+        _arena_buf = malloc(MBED_CONF_NSAPI_TLS_ARENA_SIZE);
+        if (!_arena_buf) {
+            return NSAPI_ERROR_NO_MEMORY;
+        }
+        mbed_tls_arena_init(&_arena, _arena_buf, MBED_CONF_NSAPI_TLS_ARENA_SIZE);
+        mbed_tls_arena_enter(&_arena);
+    }
+#endif
+
+    if (!_seeded) {
+        err = mbedtls_ctr_drbg_seed(&_drbg, mbedtls_entropy_func, &_entropy,
+                (const unsigned char *)drbg_personalization, sizeof(drbg_personalization));
+        if (err) {
+            return NSAPI_ERROR_DEVICE_ERROR;
+        }
+        _seeded = true;
+    }
+
+    err = mbedtls_ssl_config_defaults(&_conf, endpoint,
+            MBEDTLS_SSL_TRANSPORT_STREAM, MBEDTLS_SSL_PRESET_DEFAULT);
+    if (err) {
+        return ssl_error(err, NSAPI_ERROR_PARAMETER);
+    }
+
+    mbedtls_ssl_conf_rng(&_conf, mbedtls_ctr_drbg_random, &_drbg);
+
+    // Clients always verify the server, servers only verify clients
+    // against authorities they were given
+    if (_ca_cert.version) {
+        mbedtls_ssl_conf_ca_chain(&_conf, &_ca_cert, NULL);
+        mbedtls_ssl_conf_authmode(&_conf, MBEDTLS_SSL_VERIFY_REQUIRED);
+    } else if (endpoint == MBEDTLS_SSL_IS_SERVER) {
+        mbedtls_ssl_conf_authmode(&_conf, MBEDTLS_SSL_VERIFY_NONE);
+    }
+
+    if (mbedtls_pk_get_type(&_own_key) != MBEDTLS_PK_NONE) {
+        err = mbedtls_ssl_conf_own_cert(&_conf, &_own_cert, &_own_key);
+        if (err) {
+            return ssl_error(err, NSAPI_ERROR_PARAMETER);
+        }
+    }
+
+#if defined(MBEDTLS_SSL_MAX_FRAGMENT_LENGTH)
+    if (_mfl_code != MBEDTLS_SSL_MAX_FRAG_LEN_NONE) {
+        mbedtls_ssl_conf_max_frag_len(&_conf, _mfl_code);
+    }
+#endif
+
+#if defined(MBEDTLS_SSL_SRV_C)
+    if (endpoint == MBEDTLS_SSL_IS_SERVER) {
+#if defined(MBEDTLS_SSL_CACHE_C)
+        if (_cache) {
+#if defined(TLSSOCKET_ARENA)
+            mbedtls_ssl_conf_session_cache(&_conf, this,
+                    &TLSSocket::cache_get, &TLSSocket::cache_set);
+#else
+            mbedtls_ssl_conf_session_cache(&_conf, _cache,
+                    mbedtls_ssl_cache_get, mbedtls_ssl_cache_set);
+#endif
+        }
+#endif
+#if defined(MBEDTLS_SSL_TICKET_C)
+        if (_ticket) {
+            mbedtls_ssl_conf_session_tickets_cb(&_conf,
+                    mbedtls_ssl_ticket_write, mbedtls_ssl_ticket_parse, _ticket);
+        }
+#endif
+    }
+#endif
+
+    // Allocates the record buffers
+    err = mbedtls_ssl_setup(&_ssl, &_conf);
+    if (err) {
+        return ssl_error(err, NSAPI_ERROR_PARAMETER);
+    }
+
+    mbedtls_ssl_set_bio(&_ssl, this, &TLSSocket::ssl_send, &TLSSocket::ssl_recv, NULL);
+    _set_up = true;
+    return NSAPI_ERROR_OK;
+}
+
+nsapi_error_t TLSSocket::connect_step(bool first)
+{
+    if (!_tcp_connected) {
+        nsapi_error_t err = _tcp.connect(_address);
+        if (err == NSAPI_ERROR_IN_PROGRESS || err == NSAPI_ERROR_ALREADY) {
+            return first ? NSAPI_ERROR_IN_PROGRESS : NSAPI_ERROR_ALREADY;
+        } else if (err && err != NSAPI_ERROR_IS_CONNECTED) {
+            _in_progress = false;
+            return err;
+        }
+        _tcp_connected = true;
+    }
+
+    int err = mbedtls_ssl_handshake(&_ssl);
+    if (err == MBEDTLS_ERR_SSL_WANT_READ || err == MBEDTLS_ERR_SSL_WANT_WRITE) {
+        return first ? NSAPI_ERROR_IN_PROGRESS : NSAPI_ERROR_ALREADY;
+    }
+
+    _in_progress = false;
+    if (err) {
+        return ssl_error(err, NSAPI_ERROR_AUTH_FAILURE);
+    }
+
+    _connected = true;
+    return first ? NSAPI_ERROR_OK : NSAPI_ERROR_IS_CONNECTED;
+}
+
+#if defined(MBEDTLS_SSL_CLI_C)
+nsapi_error_t TLSSocket::connect(const char *host, uint16_t port)
+{
+    _lock.lock();
+    arena_enter();
+    nsapi_error_t ret;
+
+    if (_connected) {
+        ret = NSAPI_ERROR_IS_CONNECTED;
+    } else if (_in_progress) {
+        ret = connect_step(false);
+    } else if (!_stack) {
+        ret = NSAPI_ERROR_NO_SOCKET;
+    } else if (_stack->gethostbyname(host, &_address)) {
+        ret = NSAPI_ERROR_DNS_FAILURE;
+    } else {
+        _address.set_port(port);
+        ret = setup(MBEDTLS_SSL_IS_CLIENT);
+        if (!ret && mbedtls_ssl_set_hostname(&_ssl, host)) {
+            ret = NSAPI_ERROR_NO_MEMORY;
+        }
+        if (!ret && _session && mbedtls_ssl_set_session(&_ssl, _session)) {
+            ret = NSAPI_ERROR_PARAMETER;
+        }
+        if (!ret) {
+            _in_progress = true;
+            ret = connect_step(true);
+        }
+    }
+
+    arena_leave();
+    _lock.unlock();
+    return ret;
+}
+
+nsapi_error_t TLSSocket::get_session(mbedtls_ssl_session *session)
+{
+    _lock.lock();
+    nsapi_error_t ret = NSAPI_ERROR_NO_CONNECTION;
+    if (_connected) {
+        ret = ssl_error(mbedtls_ssl_get_session(&_ssl, session), NSAPI_ERROR_PARAMETER);
+    }
+    _lock.unlock();
+    return ret;
+}
+
+void TLSSocket::set_session(const mbedtls_ssl_session *session)
+{
+    _lock.lock();
+    _session = session;
+    _lock.unlock();
+}
+#endif
+
+#if defined(MBEDTLS_SSL_SRV_C)
+nsapi_error_t TLSSocket::accept(TCPServer *server, SocketAddress *address)
+{
+    _lock.lock();
+
+    if (_set_up) {
+        close();
+    }
+    arena_enter();
+
+    nsapi_error_t ret = server->accept(&_tcp, address);
+    if (!ret) {
+        _tcp_connected = true;
+        ret = setup(MBEDTLS_SSL_IS_SERVER);
+    }
+    if (!ret) {
+        _in_progress = true;
+        ret = connect_step(true);
+    }
+
+    arena_leave();
+    _lock.unlock();
+    return ret;
+}
+
+#if defined(MBEDTLS_SSL_CACHE_C)
+void TLSSocket::set_session_cache(mbedtls_ssl_cache_context *cache)
+{
+    _lock.lock();
+    _cache = cache;
+    _lock.unlock();
+}
+#endif
+
+#if defined(MBEDTLS_SSL_TICKET_C)
+void TLSSocket::set_session_tickets(mbedtls_ssl_ticket_context *ticket)
+{
+    _lock.lock();
+    _ticket = ticket;
+    _lock.unlock();
+}
+#endif
+#endif
+
+nsapi_error_t TLSSocket::handshake()
+{
+    _lock.lock();
+    arena_enter();
+    nsapi_error_t ret;
+
+    if (_connected) {
+        ret = NSAPI_ERROR_OK;
+    } else if (!_in_progress) {
+        ret = NSAPI_ERROR_NO_CONNECTION;
+    } else {
+        ret = connect_step(true);
+    }
+
+    arena_leave();
+    _lock.unlock();
+    return ret;
+}
+
+nsapi_size_or_error_t TLSSocket::send(const void *data, nsapi_size_t size)
+{
+    _lock.lock();
+    arena_enter();
+    nsapi_size_or_error_t ret = 0;
+
+    if (!_connected) {
+        ret = NSAPI_ERROR_NO_CONNECTION;
+    }
+
+    // A record holds at most MBEDTLS_SSL_MAX_CONTENT_LEN, or the
+    // negotiated fragment length, so larger sends take several writes
+    nsapi_size_t sent = 0;
+    while (!ret && sent < size) {
+        int err = mbedtls_ssl_write(&_ssl, (const unsigned char *)data + sent, size - sent);
+        if (err < 0) {
+            ret = ssl_error(err, NSAPI_ERROR_DEVICE_ERROR);
+        } else {
+            sent += err;
+        }
+    }
+
+    if (sent > 0 && (ret == NSAPI_ERROR_OK || ret == NSAPI_ERROR_WOULD_BLOCK)) {
+        ret = sent;
+    }
+
+    arena_leave();
+    _lock.unlock();
+    return ret;
+}
+
+nsapi_size_or_error_t TLSSocket::recv(void *data, nsapi_size_t size)
+{
+    _lock.lock();
+    arena_enter();
+    nsapi_size_or_error_t ret;
+
+    if (!_connected) {
+        ret = NSAPI_ERROR_NO_CONNECTION;
+    } else {
+        int err = mbedtls_ssl_read(&_ssl, (unsigned char *)data, size);
+        if (err == MBEDTLS_ERR_SSL_PEER_CLOSE_NOTIFY || err == MBEDTLS_ERR_SSL_CONN_EOF) {
+            ret = 0;
+        } else if (err < 0) {
+            ret = ssl_error(err, NSAPI_ERROR_DEVICE_ERROR);
+        } else {
+            ret = err;
+        }
+    }
+
+    arena_leave();
+    _lock.unlock();
+    return ret;
+}
+
+void TLSSocket::set_blocking(bool blocking)
+{
+    _tcp.set_blocking(blocking);
+}
+
+void TLSSocket::set_timeout(int timeout)
+{
+    _tcp.set_timeout(timeout);
+}
+
+void TLSSocket::sigio(mbed::Callback<void()> func)
+{
+    _tcp.sigio(func);
+}
+
+TCPSocket *TLSSocket::get_tcp_socket()
+{
+    return &_tcp;
+}
+
+#if defined(TLSSOCKET_ARENA)
+void TLSSocket::get_memory_stats(mbed_tls_arena_stats_t *stats)
+{
+    _lock.lock();
+    mbed_tls_arena_stats_get(&_arena, stats);
+    _lock.unlock();
+}
+#endif
+
+void TLSSocket::arena_enter()
+{
+#if defined(TLSSOCKET_ARENA)
+    if (_arena_buf) {
+        mbed_tls_arena_enter(&_arena);
+    }
+#endif
+}
+
+void TLSSocket::arena_leave()
+{
+#if defined(TLSSOCKET_ARENA)
+    if (_arena_buf) {
+        mbed_tls_arena_leave(&_arena);
+    }
+#endif
+}
+
+#if defined(TLSSOCKET_ARENA) && defined(MBEDTLS_SSL_SRV_C) && defined(MBEDTLS_SSL_CACHE_C)
+int TLSSocket::cache_get(void *ctx, mbedtls_ssl_session *session)
+{
+    TLSSocket *socket = static_cast<TLSSocket *>(ctx);
+    return mbedtls_ssl_cache_get(socket->_cache, session);
+}
+
+int TLSSocket::cache_set(void *ctx, const mbedtls_ssl_session *session)
+{
+    // The cache outlives the connection, so its entries go on the heap
+    TLSSocket *socket = static_cast<TLSSocket *>(ctx);
+    mbed_tls_arena_leave(&socket->_arena);
+    int err = mbedtls_ssl_cache_set(socket->_cache, session);
+    mbed_tls_arena_enter(&socket->_arena);
+    return err;
+}
+#endif
+
+nsapi_error_t TLSSocket::ssl_error(int err, nsapi_error_t other)
+{
+    switch (err) {
+        case 0:
+            return NSAPI_ERROR_OK;
+        case MBEDTLS_ERR_SSL_WANT_READ:
+        case MBEDTLS_ERR_SSL_WANT_WRITE:
+            return NSAPI_ERROR_WOULD_BLOCK;
+        case MBEDTLS_ERR_SSL_ALLOC_FAILED:
+            return NSAPI_ERROR_NO_MEMORY;
+        case MBEDTLS_ERR_NET_SEND_FAILED:
+        case MBEDTLS_ERR_NET_RECV_FAILED:
+            // The error of the TCP socket
+            return _io_error;
+        case MBEDTLS_ERR_SSL_CONN_EOF:
+        case MBEDTLS_ERR_SSL_PEER_CLOSE_NOTIFY:
+            return NSAPI_ERROR_CONNECTION_LOST;
+        default:
+            return other;
+    }
+}
+
+int TLSSocket::ssl_send(void *ctx, const unsigned char *buf, size_t len)
+{
+    TLSSocket *socket = static_cast<TLSSocket *>(ctx);
+    nsapi_size_or_error_t sent = socket->_tcp.send(buf, len);
+    if (sent == NSAPI_ERROR_WOULD_BLOCK) {
+        return MBEDTLS_ERR_SSL_WANT_WRITE;
+    } else if (sent < 0) {
+        socket->_io_error = sent;
+        return MBEDTLS_ERR_NET_SEND_FAILED;
+    }
+    return sent;
+}
+
+int TLSSocket::ssl_recv(void *ctx, unsigned char *buf, size_t len)
+{
+    TLSSocket *socket = static_cast<TLSSocket *>(ctx);
+    nsapi_size_or_error_t recv = socket->_tcp.recv(buf, len);
+    if (recv == NSAPI_ERROR_WOULD_BLOCK) {
+        return MBEDTLS_ERR_SSL_WANT_READ;
+    } else if (recv < 0) {
+        socket->_io_error = recv;
+        return MBEDTLS_ERR_NET_RECV_FAILED;
+    }
+    return recv;
+}
+
+#endif
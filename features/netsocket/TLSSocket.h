@@ -0,0 +1,334 @@
+/** \addtogroup netsocket */
+/** @{*/
+/* TLSSocket
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TLSSOCKET_H
+#define TLSSOCKET_H
+
+#include "mbedtls/config.h"
+
+#if defined(MBEDTLS_SSL_TLS_C) && defined(MBEDTLS_CTR_DRBG_C) && defined(MBEDTLS_ENTROPY_C) \
+    && defined(MBEDTLS_X509_CRT_PARSE_C)
+
+#include "netsocket/TCPSocket.h"
+#include "netsocket/TCPServer.h"
+#include "rtos/Mutex.h"
+#include "platform/NonCopyable.h"
+#include "mbedtls/ssl.h"
+#include "mbedtls/entropy.h"
+#include "mbedtls/ctr_drbg.h"
+#include "mbedtls/x509_crt.h"
+#include "mbedtls/pk.h"
+#include "mbedtls/ssl_cache.h"
+#include "mbedtls/ssl_ticket.h"
+
+#if defined(MBED_TLS_ARENA) && defined(MBED_CONF_NSAPI_TLS_ARENA_SIZE)
+#define TLSSOCKET_ARENA
+#endif
+
+/** TLS connection over a TCP socket
+ *
+ *  Runs mbed TLS directly on a TCPSocket, the records are read from and
+ *  written to the socket without intermediate buffers. The socket follows
+ *  the blocking mode and timeout of the TLSSocket, so a non-blocking
+ *  handshake is driven by calling connect, or handshake for accepted
+ *  connections, again from sigio until it completes.
+ *
+ *  The two record buffers of mbed TLS take MBEDTLS_SSL_MAX_CONTENT_LEN
+ *  bytes each while the socket is connected. Lowering it in the mbed TLS
+ *  configuration bounds the RAM used, and the nsapi.tls-max-fragment-length
+ *  option, or set_max_fragment_length, asks the peer to keep its records
+ *  within that size.
+ *
+ *  With the mbedtls.arena option enabled, the nsapi.tls-arena-size option
+ *  gives each connection an arena of that size, allocated in one piece
+ *  when it is set up and freed on close, that all its allocations are
+ *  taken from. See get_memory_stats for its peak use.
+ *
+ *  Sends and receives are serialized on the TLS context, so one blocked
+ *  in a receive holds up the other; use a timeout or non-blocking mode to
+ *  send and receive from different threads.
+ */
+class TLSSocket : private mbed::NonCopyable<TLSSocket> {
+public:
+    /** Create an uninitialized socket
+     *
+     *  Must call open to initialize the socket on a network stack, or
+     *  accept to take a connection from a TCPServer.
+     */
+    TLSSocket();
+
+    /** Destroy a socket
+     *
+     *  Closes socket if the socket is still open
+     */
+    ~TLSSocket();
+
+    /** Opens a socket
+     *
+     *  Creates a TCP socket on the given network stack.
+     *
+     *  @param stack    Network stack as target for socket
+     *  @return         0 on success, negative error code on failure
+     */
+    nsapi_error_t open(NetworkStack *stack);
+
+    template <typename S>
+    nsapi_error_t open(S *stack) {
+        return open(nsapi_create_stack(stack));
+    }
+
+    /** Close the connection
+     *
+     *  Notifies the peer if the handshake completed, closes the TCP socket
+     *  and frees the record buffers. The certificates and keys set on the
+     *  socket are kept for the next connection.
+     *
+     *  @return         0 on success, negative error code on failure
+     */
+    nsapi_error_t close();
+
+    /** Set the certificates of the authorities trusted to sign peers'
+     *  certificates
+     *
+     *  Clients require a trusted certificate from the server. Servers ask
+     *  clients for a certificate once authorities are set.
+     *
+     *  @param certs    PEM (including the terminating null) or DER
+     *                  certificates
+     *  @param len      Size of certs in bytes
+     *  @return         0 on success, negative error code on failure
+     */
+    nsapi_error_t set_root_ca_cert(const void *certs, size_t len);
+
+    /** Set the certificate and private key of this end
+     *
+     *  Required for servers, and for clients of servers that ask for one.
+     *
+     *  @param cert     PEM or DER certificate chain
+     *  @param cert_len Size of cert in bytes
+     *  @param key      PEM or DER private key
+     *  @param key_len  Size of key in bytes
+     *  @return         0 on success, negative error code on failure
+     */
+    nsapi_error_t set_own_cert(const void *cert, size_t cert_len,
+            const void *key, size_t key_len);
+
+#if defined(MBEDTLS_SSL_MAX_FRAGMENT_LENGTH)
+    /** Set the largest record the peer is asked to send
+     *
+     *  Takes effect on the next connection.
+     *
+     *  @param len      512, 1024, 2048 or 4096, or 0 for no limit
+     *  @return         0 on success, negative error code on failure
+     */
+    nsapi_error_t set_max_fragment_length(size_t len);
+#endif
+
+#if defined(MBEDTLS_SSL_CLI_C)
+    /** Connect to a server and complete the handshake
+     *
+     *  The host name is checked against the certificate of the server and
+     *  sent to it for virtual hosting.
+     *
+     *  In non-blocking mode, NSAPI_ERROR_IN_PROGRESS is returned while the
+     *  connection and handshake go on, and further calls return
+     *  NSAPI_ERROR_ALREADY until they are done and NSAPI_ERROR_IS_CONNECTED
+     *  after.
+     *
+     *  @param host     Hostname of the remote host
+     *  @param port     Port of the remote host
+     *  @return         0 on success, negative error code on failure
+     */
+    nsapi_error_t connect(const char *host, uint16_t port);
+
+    /** Get the session of the connection to resume it later
+     *
+     *  The session holds the ticket of servers that give one.
+     *
+     *  @param session  Destination for the session, initialized with
+     *                  mbedtls_ssl_session_init and freed by the caller
+     *                  with mbedtls_ssl_session_free
+     *  @return         0 on success, negative error code on failure
+     */
+    nsapi_error_t get_session(mbedtls_ssl_session *session);
+
+    /** Set a session to resume on the next connect
+     *
+     *  @param session  Session from get_session, which must outlive the
+     *                  next connect, or NULL for a full handshake
+     */
+    void set_session(const mbedtls_ssl_session *session);
+#endif
+
+#if defined(MBEDTLS_SSL_SRV_C)
+    /** Accept a connection from a TCPServer and run the server handshake
+     *
+     *  In non-blocking mode, NSAPI_ERROR_WOULD_BLOCK is returned if there
+     *  is no connection to accept, and NSAPI_ERROR_IN_PROGRESS if the
+     *  handshake has not completed, to be continued with handshake.
+     *
+     *  @param server   Listening server socket
+     *  @param address  Destination for the address of the client or NULL
+     *  @return         0 on success, negative error code on failure
+     */
+    nsapi_error_t accept(TCPServer *server, SocketAddress *address = NULL);
+
+#if defined(MBEDTLS_SSL_CACHE_C)
+    /** Let clients resume sessions from a cache shared by server sockets
+     *
+     *  @param cache    Cache initialized with mbedtls_ssl_cache_init,
+     *                  or NULL for none
+     */
+    void set_session_cache(mbedtls_ssl_cache_context *cache);
+#endif
+
+#if defined(MBEDTLS_SSL_TICKET_C)
+    /** Let clients resume sessions from tickets
+     *
+     *  @param ticket   Ticket keys set up with mbedtls_ssl_ticket_setup,
+     *                  or NULL for none
+     */
+    void set_session_tickets(mbedtls_ssl_ticket_context *ticket);
+#endif
+#endif
+
+    /** Continue the handshake of a connection
+     *
+     *  @return         0 once complete, NSAPI_ERROR_IN_PROGRESS while
+     *                  the handshake would block, negative error code on
+     *                  failure
+     */
+    nsapi_error_t handshake();
+
+    /** Send data over the connection
+     *
+     *  By default, send blocks until all data is sent. If socket is set to
+     *  non-blocking or times out, the number of bytes sent so far, or
+     *  NSAPI_ERROR_WOULD_BLOCK if none, is returned instead. A send that
+     *  would block must be retried with the same data.
+     *
+     *  @param data     Buffer of data to send to the host
+     *  @param size     Size of the buffer in bytes
+     *  @return         Number of sent bytes on success, negative error
+     *                  code on failure
+     */
+    nsapi_size_or_error_t send(const void *data, nsapi_size_t size);
+
+    /** Receive data over the connection
+     *
+     *  By default, recv blocks until some data is received. If socket is
+     *  set to non-blocking or times out, NSAPI_ERROR_WOULD_BLOCK is
+     *  returned immediately.
+     *
+     *  @param data     Destination buffer for data received from the host
+     *  @param size     Size of the buffer in bytes
+     *  @return         Number of received bytes on success, 0 once the
+     *                  peer has closed the connection, negative error code
+     *                  on failure
+     */
+    nsapi_size_or_error_t recv(void *data, nsapi_size_t size);
+
+    /** Set blocking or non-blocking mode of the socket
+     *
+     *  @param blocking true for blocking mode, false for non-blocking mode.
+     */
+    void set_blocking(bool blocking);
+
+    /** Set timeout on blocking socket operations
+     *
+     *  @param timeout  Timeout in milliseconds, -1 for no timeout
+     */
+    void set_timeout(int timeout);
+
+    /** Register a callback on state change of the socket
+     *
+     *  The callback is called from the TCP socket, see Socket::sigio.
+     *
+     *  @param func     Function to call on state change
+     */
+    void sigio(mbed::Callback<void()> func);
+
+    /** Get the underlying TCP socket
+     *
+     *  @return         The TCP socket
+     */
+    TCPSocket *get_tcp_socket();
+
+#if defined(TLSSOCKET_ARENA)
+    /** Get the memory use of the current or last connection
+     *
+     *  With max_size, the peak use of a connection, tls-arena-size can be
+     *  set to what the connections of the application take.
+     *
+     *  @param stats    Destination for the statistics of the arena
+     */
+    void get_memory_stats(mbed_tls_arena_stats_t *stats);
+#endif
+
+private:
+    nsapi_error_t setup(int endpoint);
+    nsapi_error_t connect_step(bool first);
+    nsapi_error_t ssl_error(int err, nsapi_error_t other);
+    static int ssl_send(void *ctx, const unsigned char *buf, size_t len);
+    static int ssl_recv(void *ctx, unsigned char *buf, size_t len);
+    void arena_enter();
+    void arena_leave();
+#if defined(TLSSOCKET_ARENA) && defined(MBEDTLS_SSL_SRV_C) && defined(MBEDTLS_SSL_CACHE_C)
+    static int cache_get(void *ctx, mbedtls_ssl_session *session);
+    static int cache_set(void *ctx, const mbedtls_ssl_session *session);
+#endif
+
+    TCPSocket _tcp;
+    rtos::Mutex _lock;
+
+    mbedtls_entropy_context _entropy;
+    mbedtls_ctr_drbg_context _drbg;
+    mbedtls_ssl_config _conf;
+    mbedtls_ssl_context _ssl;
+    mbedtls_x509_crt _ca_cert;
+    mbedtls_x509_crt _own_cert;
+    mbedtls_pk_context _own_key;
+
+    const mbedtls_ssl_session *_session;
+#if defined(MBEDTLS_SSL_CACHE_C)
+    mbedtls_ssl_cache_context *_cache;
+#endif
+#if defined(MBEDTLS_SSL_TICKET_C)
+    mbedtls_ssl_ticket_context *_ticket;
+#endif
+    unsigned char _mfl_code;
+#if defined(TLSSOCKET_ARENA)
+    mbed_tls_arena_t _arena;
+    void *_arena_buf;
+#endif
+
+    NetworkStack *_stack;
+    SocketAddress _address;
+    nsapi_error_t _io_error;
+    bool _seeded;
+    bool _set_up;
+    bool _tcp_connected;
+    bool _in_progress;
+    bool _connected;
+};
+
+#endif
+
+#endif
+
+/** @}*/
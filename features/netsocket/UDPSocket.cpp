@@ -125,6 +125,171 @@ nsapi_size_or_error_t UDPSocket::recvfrom(SocketAddress *address, void *buffer,
     return ret;
 }
 
+nsapi_size_or_error_t UDPSocket::sendto(const SocketAddress &address, NetworkBuffer &buffer)
+{
+    _lock.lock();
+    nsapi_size_or_error_t ret;
+
+    while (true) {
+        if (!_socket) {
+            ret = NSAPI_ERROR_NO_SOCKET;
+            break;
+        }
+
+        if (!buffer._buf || buffer._stack != _stack) {
+            ret = NSAPI_ERROR_PARAMETER;
+            break;
+        }
+
+        _pending = 0;
+        nsapi_size_or_error_t sent = _stack->socket_sendto_buffer(_socket, address, buffer._buf);
+        if ((0 == _timeout) || (NSAPI_ERROR_WOULD_BLOCK != sent)) {
+            ret = sent;
+            break;
+        } else {
+            uint32_t flag;
+
+            // Release lock before blocking so other threads
+            // accessing this object aren't blocked
+            _lock.unlock();
+            flag = _event_flag.wait_any(WRITE_FLAG, _timeout);
+            _lock.lock();
+
+            if (flag & osFlagsError) {
+                // Timeout break
+                ret = NSAPI_ERROR_WOULD_BLOCK;
+                break;
+            }
+        }
+    }
+
+    // The stack may have changed the buffer while sending it
+    if (ret != NSAPI_ERROR_WOULD_BLOCK && buffer._stack == _stack) {
+        buffer.release();
+    }
+
+    _lock.unlock();
+    return ret;
+}
+
+nsapi_size_or_error_t UDPSocket::recvfrom(SocketAddress *address, NetworkBuffer &buffer)
+{
+    _lock.lock();
+    nsapi_size_or_error_t ret;
+
+    buffer.release();
+
+    while (true) {
+        if (!_socket) {
+            ret = NSAPI_ERROR_NO_SOCKET;
+            break;
+        }
+
+        nsapi_buf_t buf = 0;
+        _pending = 0;
+        nsapi_size_or_error_t recv = _stack->socket_recvfrom_buffer(_socket, address, &buf);
+        if (recv >= 0) {
+            buffer.attach(_stack, buf, recv);
+        }
+
+        if ((0 == _timeout) || (NSAPI_ERROR_WOULD_BLOCK != recv)) {
+            ret = recv;
+            break;
+        } else {
+            uint32_t flag;
+
+            // Release lock before blocking so other threads
+            // accessing this object aren't blocked
+            _lock.unlock();
+            flag = _event_flag.wait_any(READ_FLAG, _timeout);
+            _lock.lock();
+
+            if (flag & osFlagsError) {
+                // Timeout break
+                ret = NSAPI_ERROR_WOULD_BLOCK;
+                break;
+            }
+        }
+    }
+
+    _lock.unlock();
+    return ret;
+}
+
+nsapi_size_or_error_t UDPSocket::sendto_batch(nsapi_msg_t *msgs, nsapi_size_t count)
+{
+    _lock.lock();
+    nsapi_size_or_error_t ret;
+
+    while (true) {
+        if (!_socket) {
+            ret = NSAPI_ERROR_NO_SOCKET;
+            break;
+        }
+
+        _pending = 0;
+        nsapi_size_or_error_t sent = _stack->socket_sendto_batch(_socket, msgs, count);
+        if ((0 == _timeout) || (NSAPI_ERROR_WOULD_BLOCK != sent)) {
+            ret = sent;
+            break;
+        } else {
+            uint32_t flag;
+
+            // Release lock before blocking so other threads
+            // accessing this object aren't blocked
+            _lock.unlock();
+            flag = _event_flag.wait_any(WRITE_FLAG, _timeout);
+            _lock.lock();
+
+            if (flag & osFlagsError) {
+                // Timeout break
+                ret = NSAPI_ERROR_WOULD_BLOCK;
+                break;
+            }
+        }
+    }
+
+    _lock.unlock();
+    return ret;
+}
+
+nsapi_size_or_error_t UDPSocket::recvfrom_batch(nsapi_msg_t *msgs, nsapi_size_t count)
+{
+    _lock.lock();
+    nsapi_size_or_error_t ret;
+
+    while (true) {
+        if (!_socket) {
+            ret = NSAPI_ERROR_NO_SOCKET;
+            break;
+        }
+
+        _pending = 0;
+        nsapi_size_or_error_t recv = _stack->socket_recvfrom_batch(_socket, msgs, count);
+        if ((0 == _timeout) || (NSAPI_ERROR_WOULD_BLOCK != recv)) {
+            ret = recv;
+            break;
+        } else {
+            uint32_t flag;
+
+            // Release lock before blocking so other threads
+            // accessing this object aren't blocked
+            _lock.unlock();
+            flag = _event_flag.wait_any(READ_FLAG, _timeout);
+            _lock.lock();
+
+            if (flag & osFlagsError) {
+                // Timeout break
+                ret = NSAPI_ERROR_WOULD_BLOCK;
+                break;
+            }
+        }
+    }
+
+    _lock.unlock();
+    return ret;
+}
+
 void UDPSocket::event()
 {
     _event_flag.set(READ_FLAG|WRITE_FLAG);
@@ -23,6 +23,7 @@
 #include "netsocket/Socket.h"
 #include "netsocket/NetworkStack.h"
 #include "netsocket/NetworkInterface.h"
+#include "netsocket/NetworkBuffer.h"
 #include "rtos/EventFlags.h"
 
 
@@ -112,6 +113,74 @@ public:
     nsapi_size_or_error_t recvfrom(SocketAddress *address,
             void *data, nsapi_size_t size);
 
+    /** Send a buffer as a packet over a UDP socket
+     *
+     *  The buffer must be allocated on the socket, and is released once
+     *  sent or on failure. Returns the number of bytes sent.
+     *
+     *  By default, sendto blocks until data is sent. If socket is set to
+     *  non-blocking or times out, NSAPI_ERROR_WOULD_BLOCK is returned
+     *  immediately and the buffer is kept to send again.
+     *
+     *  @param address  The SocketAddress of the remote host
+     *  @param buffer   Buffer of data to send to the host
+     *  @return         Number of sent bytes on success, negative error
+     *                  code on failure
+     */
+    nsapi_size_or_error_t sendto(const SocketAddress &address, NetworkBuffer &buffer);
+
+    /** Receive a packet over a UDP socket into a buffer of the stack
+     *
+     *  Receives data and stores the source address in address if address
+     *  is not NULL. Any data already in the buffer is released, and the
+     *  buffer then holds the packet until it is released.
+     *
+     *  By default, recvfrom blocks until data is sent. If socket is set to
+     *  non-blocking or times out, NSAPI_ERROR_WOULD_BLOCK is returned
+     *  immediately.
+     *
+     *  @param address  Destination for the source address or NULL
+     *  @param buffer   Destination for the packet received from the host
+     *  @return         Number of received bytes on success, negative error
+     *                  code on failure
+     */
+    nsapi_size_or_error_t recvfrom(SocketAddress *address, NetworkBuffer &buffer);
+
+    /** Send several packets over a UDP socket
+     *
+     *  Sends each packet to the address and port in its nsapi_msg_t, and
+     *  fills in its len. The socket is locked and the stack called once
+     *  for the whole batch, where the stack supports it.
+     *
+     *  By default, sendto_batch blocks until at least one packet is sent,
+     *  and returns without waiting once a packet would block. If socket
+     *  is set to non-blocking or times out, NSAPI_ERROR_WOULD_BLOCK is
+     *  returned immediately.
+     *
+     *  @param msgs     Packets to send
+     *  @param count    Number of packets
+     *  @return         Number of packets sent on success, negative error
+     *                  code if none could be sent
+     */
+    nsapi_size_or_error_t sendto_batch(nsapi_msg_t *msgs, nsapi_size_t count);
+
+    /** Receive several packets over a UDP socket
+     *
+     *  Receives packets into the data of each nsapi_msg_t, and fills in
+     *  the source address, port and len of each packet received.
+     *
+     *  By default, recvfrom_batch blocks until at least one packet is
+     *  received, and then returns the packets already queued on the
+     *  socket up to count. If socket is set to non-blocking or times out,
+     *  NSAPI_ERROR_WOULD_BLOCK is returned immediately.
+     *
+     *  @param msgs     Destinations for the packets
+     *  @param count    Number of destinations
+     *  @return         Number of packets received on success, negative
+     *                  error code if none could be received
+     */
+    nsapi_size_or_error_t recvfrom_batch(nsapi_msg_t *msgs, nsapi_size_t count);
+
 protected:
     virtual nsapi_protocol_t get_proto();
     virtual void event();
@@ -21,6 +21,7 @@
 #include <string.h>
 #include "netsocket/NetworkInterface.h"
 #include "netsocket/WiFiAccessPoint.h"
+#include "platform/Callback.h"
 
 /** WiFiInterface class
  *
@@ -99,6 +100,44 @@ public:
      *                   negative on error see @a nsapi_error
      */
     virtual nsapi_size_or_error_t scan(WiFiAccessPoint *res, nsapi_size_t count) = 0;
+
+    /** Scan callback type, see scan_async
+     */
+    typedef mbed::Callback<void (const WiFiAccessPoint *ap)> scan_cb_t;
+
+    /** Scan for available networks in the background
+     *
+     *  Returns once the scan has started. The callback is called with each
+     *  access point as it is found, then with NULL when the scan completes.
+     *  It is called in the context of the driver and must not block. Drivers
+     *  keep the access points found to answer scan_cached and to connect
+     *  without a full scan.
+     *
+     *  @param callback  Callback for the access points found
+     *  @return          0 on success, NSAPI_ERROR_IN_PROGRESS if a scan is running,
+     *                   NSAPI_ERROR_UNSUPPORTED if the driver only scans with scan,
+     *                   or other negative error code on failure
+     */
+    virtual nsapi_error_t scan_async(scan_cb_t callback)
+    {
+        return NSAPI_ERROR_UNSUPPORTED;
+    }
+
+    /** Get the networks found by recent scans
+     *
+     *  Does not block if scans found access points within @a max_age,
+     *  otherwise scans like scan. Drivers without a scan cache always scan.
+     *
+     *  @param  res      Pointer to allocated array to store discovered AP
+     *  @param  count    Size of allocated @a res array, or 0 to only count available AP
+     *  @param  max_age  Maximum time in milliseconds since the access points were found
+     *  @return          Number of entries in \p res, or if \p count was 0 number of available networks,
+     *                   negative on error see @a nsapi_error
+     */
+    virtual nsapi_size_or_error_t scan_cached(WiFiAccessPoint *res, nsapi_size_t count, uint32_t max_age)
+    {
+        return scan(res, count);
+    }
 };
 
 #endif
@@ -0,0 +1,121 @@
+/* WiFiScanCache
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "netsocket/WiFiScanCache.h"
+#include "cmsis_os2.h"
+#include <string.h>
+
+WiFiScanCache::WiFiScanCache()
+{
+    for (unsigned i = 0; i < MBED_CONF_NSAPI_WIFI_SCAN_CACHE_SIZE; i++) {
+        _entries[i].stamp = 0;
+        _entries[i].used = false;
+    }
+}
+
+bool WiFiScanCache::fresh(const entry &e, uint32_t now, uint32_t max_age) const
+{
+    return e.used && now - e.stamp <= max_age;
+}
+
+void WiFiScanCache::add(const WiFiAccessPoint &ap)
+{
+    uint32_t now = osKernelGetTickCount();
+
+    _mutex.lock();
+    entry *slot = &_entries[0];
+    for (unsigned i = 0; i < MBED_CONF_NSAPI_WIFI_SCAN_CACHE_SIZE; i++) {
+        entry *e = &_entries[i];
+        if (e->used && memcmp(e->ap.get_bssid(), ap.get_bssid(), 6) == 0) {
+            slot = e;
+            break;
+        }
+        // free entries first, then the one seen longest ago
+        if (slot->used && (!e->used || now - e->stamp > now - slot->stamp)) {
+            slot = e;
+        }
+    }
+    slot->ap = ap;
+    slot->stamp = now;
+    slot->used = true;
+    _mutex.unlock();
+}
+
+nsapi_size_t WiFiScanCache::get(WiFiAccessPoint *res, nsapi_size_t count, uint32_t max_age)
+{
+    uint32_t now = osKernelGetTickCount();
+    nsapi_size_t found = 0;
+
+    _mutex.lock();
+    for (unsigned i = 0; i < MBED_CONF_NSAPI_WIFI_SCAN_CACHE_SIZE; i++) {
+        if (!fresh(_entries[i], now, max_age)) {
+            continue;
+        }
+        if (count == 0) {
+            found++;
+            continue;
+        }
+
+        // insert by signal strength, dropping the weakest once res is full
+        const WiFiAccessPoint &ap = _entries[i].ap;
+        nsapi_size_t pos = found < count ? found : count;
+        while (pos > 0 && res[pos - 1].get_rssi() < ap.get_rssi()) {
+            if (pos < count) {
+                res[pos] = res[pos - 1];
+            }
+            pos--;
+        }
+        if (pos < count) {
+            res[pos] = ap;
+            if (found < count) {
+                found++;
+            }
+        }
+    }
+    _mutex.unlock();
+
+    return found;
+}
+
+bool WiFiScanCache::find(const char *ssid, WiFiAccessPoint *ap, uint32_t max_age)
+{
+    uint32_t now = osKernelGetTickCount();
+    const entry *best = NULL;
+
+    _mutex.lock();
+    for (unsigned i = 0; i < MBED_CONF_NSAPI_WIFI_SCAN_CACHE_SIZE; i++) {
+        const entry &e = _entries[i];
+        if (fresh(e, now, max_age) && strcmp(e.ap.get_ssid(), ssid) == 0 &&
+                (!best || e.ap.get_rssi() > best->ap.get_rssi())) {
+            best = &e;
+        }
+    }
+    if (best) {
+        *ap = best->ap;
+    }
+    _mutex.unlock();
+
+    return best != NULL;
+}
+
+void WiFiScanCache::clear()
+{
+    _mutex.lock();
+    for (unsigned i = 0; i < MBED_CONF_NSAPI_WIFI_SCAN_CACHE_SIZE; i++) {
+        _entries[i].used = false;
+    }
+    _mutex.unlock();
+}
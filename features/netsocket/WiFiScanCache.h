@@ -0,0 +1,95 @@
+/* WiFiScanCache
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef WIFI_SCAN_CACHE_H
+#define WIFI_SCAN_CACHE_H
+
+#include "netsocket/WiFiAccessPoint.h"
+#include "platform/PlatformMutex.h"
+
+#ifndef MBED_CONF_NSAPI_WIFI_SCAN_CACHE_SIZE
+#define MBED_CONF_NSAPI_WIFI_SCAN_CACHE_SIZE 8
+#endif
+
+#ifndef MBED_CONF_NSAPI_WIFI_SCAN_CACHE_MAX_AGE
+#define MBED_CONF_NSAPI_WIFI_SCAN_CACHE_MAX_AGE 30000
+#endif
+
+/** WiFiScanCache class
+ *
+ *  Access points seen by the scans of a WiFi driver, kept with the time
+ *  they were last seen so drivers can answer scans and connect without
+ *  sweeping all the channels again. An access point seen again replaces
+ *  its entry, otherwise the oldest entry makes room for it.
+ *  @addtogroup netsocket
+ */
+class WiFiScanCache
+{
+public:
+    /** Create an empty cache
+     */
+    WiFiScanCache();
+
+    /** Add an access point seen by a scan
+     *
+     *  Can be called from the context the driver reports scan results in,
+     *  but not from interrupt context.
+     *
+     *  @param ap   The access point
+     */
+    void add(const WiFiAccessPoint &ap);
+
+    /** Get the access points seen recently, strongest first
+     *
+     *  @param res      Array to store the access points in
+     *  @param count    Size of the @a res array, or 0 to only count the access points
+     *  @param max_age  Maximum time in milliseconds since the access points were seen
+     *  @return         Number of entries in @a res, or if @a count was 0 number of
+     *                  access points seen recently
+     */
+    nsapi_size_t get(WiFiAccessPoint *res, nsapi_size_t count,
+            uint32_t max_age = MBED_CONF_NSAPI_WIFI_SCAN_CACHE_MAX_AGE);
+
+    /** Find the strongest access point of a network seen recently
+     *
+     *  @param ssid     Name of the network
+     *  @param ap       Set to the access point if one is found
+     *  @param max_age  Maximum time in milliseconds since the access point was seen
+     *  @return         True if an access point was found
+     */
+    bool find(const char *ssid, WiFiAccessPoint *ap,
+            uint32_t max_age = MBED_CONF_NSAPI_WIFI_SCAN_CACHE_MAX_AGE);
+
+    /** Forget all the access points
+     */
+    void clear();
+
+private:
+    struct entry {
+        WiFiAccessPoint ap;
+        uint32_t stamp;
+        bool used;
+    };
+
+    bool fresh(const entry &e, uint32_t now, uint32_t max_age) const;
+
+    entry _entries[MBED_CONF_NSAPI_WIFI_SCAN_CACHE_SIZE];
+    PlatformMutex _mutex;
+};
+
+#endif
+
+/** @}*/
@@ -52,10 +52,27 @@
 #define AT_PARSER_TIMEOUT       8*1000 //miliseconds
 #endif //MBED_CONF_PPP_CELL_IFACE_AT_PARSER_TIMEOUT
 
+#ifndef MBED_CONF_PPP_CELL_IFACE_FAST_RECONNECT
+#define MBED_CONF_PPP_CELL_IFACE_FAST_RECONNECT true
+#endif //MBED_CONF_PPP_CELL_IFACE_FAST_RECONNECT
+
+/**
+ * Timeout of the commands probing the modem on reconnection
+ */
+#define RECONNECT_AT_TIMEOUT    1000 //miliseconds
+
 static bool initialized;
 static bool set_credentials_api_used;
 static bool set_sim_pin_check_request;
 static bool change_pin;
+static bool apn_confirmed;
+static bool context_changed;
+static bool power_saving_changed;
+static bool modem_sleeping;
+static char psm_periodic_time[8+1];  //!< Requested T3412 extended, empty when PSM is not requested
+static char psm_active_time[8+1];    //!< Requested T3324
+static char edrx_cycle[4+1];         //!< Requested eDRX value, empty when eDRX is not requested
+static int edrx_act;
 static device_info dev_info;
 
 static void parser_abort(ATCmdParser *at)
@@ -139,6 +156,72 @@ static void CMT_URC(ATCmdParser *at)
 
 }
 
+/**
+ * Unit of a GPRS timer, 3GPP TS 24.008 sections 10.5.7.3 and 10.5.7.4a
+ */
+typedef struct {
+    uint8_t bits;
+    int seconds;
+} gprs_timer_unit;
+
+/** T3412 extended units, GPRS Timer 3, in increasing order */
+static const gprs_timer_unit gprs_timer3_units[] = {
+    {3, 2}, {4, 30}, {5, 60}, {0, 600}, {1, 3600}, {2, 36000}, {6, 1152000}
+};
+
+/** T3324 units, GPRS Timer 2, in increasing order */
+static const gprs_timer_unit gprs_timer2_units[] = {
+    {0, 2}, {1, 60}, {2, 360}
+};
+
+/** eDRX cycles in milliseconds, indexed by their E-UTRAN eDRX value, 3GPP TS 24.008 section 10.5.5.32 */
+static const int edrx_cycles_ms[] = {
+    5120, 10240, 20480, 40960, 61440, 81920, 102400, 122880,
+    143360, 163840, 327680, 655360, 1310720, 2621440, 5242880, 10485760
+};
+
+static void bits_to_string(char *str, unsigned int value, int count)
+{
+    for (int i = 0; i < count; i++) {
+        str[i] = (value & (1 << (count - 1 - i))) ? '1' : '0';
+    }
+    str[count] = '\0';
+}
+
+/**
+ * Encodes a time as the bit string of a GPRS timer, rounding it up to the
+ * nearest value the timer can hold
+ */
+static bool encode_gprs_timer(char *str, int seconds, const gprs_timer_unit *units, int count)
+{
+    for (int i = 0; i < count; i++) {
+        int value = (seconds + units[i].seconds - 1) / units[i].seconds;
+        if (value <= 31) {
+            bits_to_string(str, (units[i].bits << 5) | value, 8);
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool set_CPSMS(ATCmdParser *at)
+{
+    // Power saving mode, the network may grant other timers
+    if (psm_periodic_time[0]) {
+        return at->send("AT+CPSMS=1,,,\"%s\",\"%s\"", psm_periodic_time, psm_active_time) && at->recv("OK");
+    }
+    return at->send("AT+CPSMS=0") && at->recv("OK");
+}
+
+static bool set_CEDRXS(ATCmdParser *at)
+{
+    // Extended discontinuous reception, mode 3 disables it and discards the settings
+    if (edrx_cycle[0]) {
+        return at->send("AT+CEDRXS=1,%d,\"%s\"", edrx_act, edrx_cycle) && at->recv("OK");
+    }
+    return at->send("AT+CEDRXS=3") && at->recv("OK");
+}
+
 static bool set_atd(ATCmdParser *at)
 {
     bool success = at->send("ATD*99***" CTX "#") && at->recv("CONNECT");
@@ -252,6 +335,21 @@ static bool is_registered_psd()
             (dev_info.reg_status_psd == PSD_REGISTERED_ROAMING);
 }
 
+static bool get_CGREG(ATCmdParser *at)
+{
+    // Current packet switched registration status, without initiating a search
+    char str[35];
+    unsigned int reg_status;
+    bool success = at->send("AT+CGREG?")
+            && at->recv("+CGREG: %34[^\n]\n", str)
+            && at->recv("OK\n")
+            && sscanf(str, "%*u,%u", &reg_status) >= 1;
+    if (success) {
+        set_nwk_reg_status_psd(reg_status);
+    }
+    return success;
+}
+
 PPPCellularInterface::PPPCellularInterface(FileHandle *fh, bool debug)
 {
     _new_pin = NULL;
@@ -279,6 +377,11 @@ void PPPCellularInterface::enable_hup(bool)
     //meant to be overridden
 }
 
+void PPPCellularInterface::enable_sleep(bool)
+{
+    //meant to be overridden
+}
+
 void PPPCellularInterface::modem_init()
 {
     //meant to be overridden
@@ -327,6 +430,61 @@ void PPPCellularInterface::set_new_sim_pin(const char *new_pin)
     _new_pin = new_pin;
 }
 
+nsapi_error_t PPPCellularInterface::set_power_saving_mode(int periodic_time, int active_time)
+{
+    if (periodic_time == 0) {
+        psm_periodic_time[0] = '\0';
+    } else if (periodic_time < 0 || active_time < 0
+            || !encode_gprs_timer(psm_periodic_time, periodic_time, gprs_timer3_units,
+                                  sizeof(gprs_timer3_units) / sizeof(gprs_timer3_units[0]))
+            || !encode_gprs_timer(psm_active_time, active_time, gprs_timer2_units,
+                                  sizeof(gprs_timer2_units) / sizeof(gprs_timer2_units[0]))) {
+        psm_periodic_time[0] = '\0';
+        return NSAPI_ERROR_PARAMETER;
+    }
+
+    power_saving_changed = true;
+    return NSAPI_ERROR_OK;
+}
+
+nsapi_error_t PPPCellularInterface::set_edrx(edrx_act_type act, int cycle_ms)
+{
+    if (cycle_ms < 0) {
+        return NSAPI_ERROR_PARAMETER;
+    }
+
+    edrx_cycle[0] = '\0';
+    if (cycle_ms > 0) {
+        /* longest cycle not above the requested one, or the shortest */
+        unsigned int value = 0;
+        while (value + 1 < sizeof(edrx_cycles_ms) / sizeof(edrx_cycles_ms[0])
+                && edrx_cycles_ms[value + 1] <= cycle_ms) {
+            value++;
+        }
+        bits_to_string(edrx_cycle, value, 4);
+        edrx_act = act;
+    }
+
+    power_saving_changed = true;
+    return NSAPI_ERROR_OK;
+}
+
+void PPPCellularInterface::setup_power_saving()
+{
+    if (!power_saving_changed) {
+        return;
+    }
+
+    /* Not fatal: modems without PSM or eDRX support still connect */
+    if (!set_CPSMS(_at)) {
+        tr_error("PSM request failed.");
+    }
+    if (!set_CEDRXS(_at)) {
+        tr_error("eDRX request failed.");
+    }
+    power_saving_changed = false;
+}
+
 bool PPPCellularInterface::nwk_registration(uint8_t nwk_type)
 {
     bool success = false;
@@ -500,6 +658,7 @@ void  PPPCellularInterface::set_credentials(const char *apn, const char *uname,
     _uname = uname;
     _pwd = pwd;
     set_credentials_api_used = true;
+    context_changed = true;
 }
 
 
@@ -530,6 +689,78 @@ void PPPCellularInterface::shutdown_at_parser()
     _at = NULL;
 }
 
+/**
+ * Re-enters data mode with the modem state left by the previous connection:
+ * the modem is powered, the SIM is unlocked and the PDP context is defined
+ * with the APN that was in use. Only the registration is checked again.
+ */
+nsapi_error_t PPPCellularInterface::reconnect()
+{
+    bool success = false;
+
+    setup_at_parser();
+    enable_hup(false);
+
+    /* The modem reports NO CARRIER when kicked out of data mode, unless it was
+     * already read by the PPP stack: do not wait for it for long */
+    _at->set_timeout(RECONNECT_AT_TIMEOUT);
+    _at->recv("NO CARRIER");
+    _at->flush();
+    for (int retry_count = 0; !success && retry_count < 3; retry_count++) {
+        success = _at->send("AT") && _at->recv("OK");
+    }
+    if (!success && modem_sleeping) {
+        /* In power saving mode the modem may only answer once woken up by its
+         * power line */
+        modem_power_up();
+        wait_ms(200);
+        _at->flush();
+        for (int retry_count = 0; !success && retry_count < 3; retry_count++) {
+            success = _at->send("AT") && _at->recv("OK");
+        }
+    }
+    _at->set_timeout(AT_PARSER_TIMEOUT);
+
+    if (!success) {
+        tr_debug("Modem not responding, reconnection aborted");
+        return NSAPI_ERROR_DEVICE_ERROR;
+    }
+    modem_sleeping = false;
+
+    /* After a coverage drop, wait for the modem to register again instead of
+     * restarting it */
+    if (!get_CGREG(_at) || !is_registered_psd()) {
+        if (!nwk_registration(PACKET_SWITCHED)) {
+            return NSAPI_ERROR_NO_CONNECTION;
+        }
+    }
+
+    /* The PDP context is kept by the modem, unless the credentials changed */
+    if (context_changed) {
+        nsapi_error_t retcode = setup_context_and_credentials();
+        if (retcode != NSAPI_ERROR_OK) {
+            return retcode;
+        }
+        context_changed = false;
+    }
+
+    setup_power_saving();
+
+    if (!set_atd(_at)) {
+        return NSAPI_ERROR_NO_CONNECTION;
+    }
+
+    shutdown_at_parser();
+    enable_hup(true);
+
+    nsapi_error_t retcode = nsapi_ppp_connect(_fh, _connection_status_cb, _uname, _pwd, _stack);
+    if (retcode == NSAPI_ERROR_OK) {
+        dev_info.ppp_connection_up = true;
+    }
+
+    return retcode;
+}
+
 nsapi_error_t PPPCellularInterface::connect(const char *sim_pin, const char *apn, const char *uname, const char *pwd)
 {
     if (!sim_pin) {
@@ -537,6 +768,9 @@ nsapi_error_t PPPCellularInterface::connect(const char *sim_pin, const char *apn
     }
 
     if (apn) {
+        if (!_apn || strcmp(apn, _apn) != 0) {
+            context_changed = true;
+        }
         _apn = apn;
     }
 
@@ -563,9 +797,31 @@ nsapi_error_t PPPCellularInterface::connect()
         return NSAPI_ERROR_IS_CONNECTED;
     }
 
+    if (modem_sleeping) {
+        enable_sleep(false);
+    }
+
+#if MBED_CONF_PPP_CELL_IFACE_FAST_RECONNECT
+    /* Try to resume the previous connection first, the full bring-up takes
+     * tens of seconds */
+    if (initialized) {
+        retcode = reconnect();
+        if (retcode == NSAPI_ERROR_OK) {
+            return retcode;
+        }
+
+        tr_info("Fast reconnection failed, restarting the modem");
+        shutdown_at_parser();
+        power_down();
+        initialized = false;
+    }
+#endif
+    modem_sleeping = false;
+
     const char *apn_config = NULL;
 #if MBED_CONF_PPP_CELL_IFACE_APN_LOOKUP
-    if (!set_credentials_api_used) {
+    /* Once an APN of the database worked, it is kept */
+    if (!set_credentials_api_used && !apn_confirmed) {
         apn_config = apnconfig(dev_info.imsi);
     }
 #endif
@@ -637,6 +893,9 @@ nsapi_error_t PPPCellularInterface::connect()
             if (retcode != NSAPI_ERROR_OK) {
                 return retcode;
             }
+            context_changed = false;
+
+            setup_power_saving();
 
             if (!success) {
                 shutdown_at_parser();
@@ -683,6 +942,9 @@ nsapi_error_t PPPCellularInterface::connect()
         retcode = nsapi_ppp_connect(_fh, _connection_status_cb, _uname, _pwd, _stack);
         if (retcode == NSAPI_ERROR_OK) {
             dev_info.ppp_connection_up = true;
+            if (apn_config) {
+                apn_confirmed = true;
+            }
         }
 
     }while(!dev_info.ppp_connection_up && apn_config && *apn_config);
@@ -701,6 +963,12 @@ nsapi_error_t PPPCellularInterface::disconnect()
     nsapi_error_t ret = nsapi_ppp_disconnect(_fh);
     if (ret == NSAPI_ERROR_OK) {
         dev_info.ppp_connection_up = false;
+
+        /* The modem goes to sleep by itself, let the serial port sleep too */
+        if ((psm_periodic_time[0] || edrx_cycle[0]) && !modem_sleeping) {
+            enable_sleep(true);
+            modem_sleeping = true;
+        }
         return NSAPI_ERROR_OK;
     }
 
@@ -79,6 +79,15 @@ typedef enum {
     PSD_EMERGENCY_SERVICES_ONLY=8
 } nwk_registration_status_psd;
 
+/**
+ * Access technology of an eDRX request (AT+CEDRXS)
+ * 3GPP TS 27.007 (Section 7.40)
+ */
+typedef enum {
+    EDRX_ACT_EUTRAN_WB_S1=4,
+    EDRX_ACT_EUTRAN_NB_S1=5
+} edrx_act_type;
+
 typedef struct {
     char ccid[20+1];    //!< Integrated Circuit Card ID
     char imsi[15+1];    //!< International Mobile Station Identity
@@ -166,6 +175,11 @@ public:
      *  the lookup table then the driver tries to resort to default APN settings.
      *
      *  Preferred method is to setup APN using 'set_credentials()' API.
+     *
+     *  Once connected, later calls resume from the state of the modem: it stays powered, with the SIM
+     *  unlocked and the PDP context defined, and only its registration is checked before entering data
+     *  mode again. The full bring-up is only done if this fails. Set 'MBED_CONF_PPP_CELL_IFACE_FAST_RECONNECT'
+     *  to false in your mbed_app.json to always do the full bring-up.
 
      *  @return         0 on success, negative error code on failure
      */
@@ -202,6 +216,35 @@ public:
      */
     void set_new_sim_pin(const char *new_pin);
 
+    /** Request the power saving mode (PSM) of the modem
+     *
+     * The timers are requested from the network with AT+CPSMS while establishing the next
+     * connection, and the network may grant other values. They are rounded up to the nearest
+     * value the 3GPP timers can hold. Once disconnected, the modem sleeps between periodic
+     * updates while staying registered, and the driver releases the serial port so that the
+     * MCU can deep sleep as well. The next connect() wakes the modem up, and resumes the
+     * previous connection state.
+     *
+     * @param periodic_time  requested periodic tracking area update interval (T3412 extended),
+     *                       in seconds, 0 to disable PSM
+     * @param active_time    requested time to stay reachable after an update (T3324), in seconds
+     * @return               NSAPI_ERROR_OK, or NSAPI_ERROR_PARAMETER if a time is out of range
+     */
+    nsapi_error_t set_power_saving_mode(int periodic_time, int active_time);
+
+    /** Request extended discontinuous reception (eDRX)
+     *
+     * The cycle is requested from the network with AT+CEDRXS while establishing the next
+     * connection. Like in PSM, the serial port is released once disconnected. The modem stays
+     * reachable at each cycle, and the serial input resumes when it raises its ring line.
+     *
+     * @param act        access technology the cycle applies to
+     * @param cycle_ms   requested eDRX cycle in milliseconds, rounded down to a 3GPP value
+     *                   of at least 5120 ms, 0 to disable eDRX
+     * @return           NSAPI_ERROR_OK, or NSAPI_ERROR_PARAMETER if the cycle is negative
+     */
+    nsapi_error_t set_edrx(edrx_act_type act, int cycle_ms);
+
     /** Check if the connection is currently established or not
      *
      * @return true/false   If the cellular module have successfully acquired a carrier and is
@@ -259,6 +302,8 @@ private:
     void shutdown_at_parser();
     nsapi_error_t initialize_sim_card();
     nsapi_error_t setup_context_and_credentials();
+    nsapi_error_t reconnect();
+    void setup_power_saving();
     bool power_up();
     void power_down();
 
@@ -274,6 +319,17 @@ protected:
      */
     virtual void enable_hup(bool enable);
 
+    /** Let the FileHandle sleep while the modem does
+     *
+     * Called with true after disconnect() when a power saving mode is requested, and with
+     * false before the modem is used again. An implementation may release the resources
+     * of the FileHandle, e.g., the receive interrupt of a UART and its deep sleep lock, and
+     * resume them when the modem signals activity.
+     *
+     * Meant to be overridden.
+     */
+    virtual void enable_sleep(bool enable);
+
     /** Sets the modem up for powering on
      *
      *  modem_init() is equivalent to plugging in the device, e.g., attaching power and serial port.
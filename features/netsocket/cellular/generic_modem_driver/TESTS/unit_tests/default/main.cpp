@@ -211,6 +211,24 @@ void test_connect_preset_credentials()
     drop_connection(&driver);
 }
 
+/**
+ * Reconnect after a disconnection, resuming from the state of the modem
+ */
+void test_reconnect()
+{
+    Timer timer;
+
+    driver.disconnect();
+    TEST_ASSERT(do_connect(&driver) == 0);
+    drop_connection(&driver);
+
+    timer.start();
+    TEST_ASSERT(do_connect(&driver) == 0);
+    tr_info("Reconnected in %d ms.", timer.read_ms());
+    use_connection(&driver);
+    drop_connection(&driver);
+}
+
 /**
  * Setup Test Environment
  */
@@ -229,7 +247,8 @@ Case cases[] = { Case("UDP echo test", test_udp_echo),
             Case("TCP async echo test", test_tcp_echo_async),
 #endif
             Case("Connect with credentials", test_connect_credentials),
-            Case("Connect with preset credentials", test_connect_preset_credentials) };
+            Case("Connect with preset credentials", test_connect_preset_credentials),
+            Case("Reconnect", test_reconnect) };
 
 Specification specification(test_setup, cases);
 
@@ -22,7 +22,18 @@ UARTCellularInterface::UARTCellularInterface(PinName txd, PinName rxd, PinName d
                                                       _serial(txd, rxd, baud)
 {
     _dcd_pin = dcd;
+    _ri_pin = ri;
     _active_high = active_high;
+
+#if DEVICE_SERIAL_FC
+    if (rts != NC && cts != NC) {
+        _serial.set_flow_control(UARTSerial::RTSCTS, rts, cts);
+    } else if (rts != NC) {
+        _serial.set_flow_control(UARTSerial::RTS, rts);
+    } else if (cts != NC) {
+        _serial.set_flow_control(UARTSerial::CTS, cts);
+    }
+#endif
 }
 
 UARTCellularInterface::~UARTCellularInterface()
@@ -35,4 +46,27 @@ void UARTCellularInterface::enable_hup(bool enable)
     _serial.set_data_carrier_detect(enable ? _dcd_pin : NC, _active_high);
 }
 
+void UARTCellularInterface::wake_irq()
+{
+    _serial.enable_input(true);
+}
+
+void UARTCellularInterface::enable_sleep(bool enable)
+{
+    if (enable) {
+        /* The carrier detect interrupt fires on deassertion of the line for
+         * a hang-up, the opposite polarity makes it fire on assertion */
+        PinName wake_pin = _ri_pin != NC ? _ri_pin : _dcd_pin;
+        if (wake_pin != NC) {
+            _serial.set_data_carrier_detect(wake_pin, !_active_high);
+            _serial.sigio(callback(this, &UARTCellularInterface::wake_irq));
+        }
+        _serial.enable_input(false);
+    } else {
+        _serial.sigio(NULL);
+        _serial.set_data_carrier_detect(NC);
+        _serial.enable_input(true);
+    }
+}
+
 #endif // NSAPI_PPP_AVAILABLE
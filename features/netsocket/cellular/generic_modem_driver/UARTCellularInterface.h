@@ -28,6 +28,14 @@
  *
  *  It constructs a FileHandle and passes it back to its base class as well as overrides
  *  enable_hup() in the base class.
+ *
+ *  The RTS and CTS pins, if given, enable hardware flow control on targets
+ *  that support it, so the modem is held off rather than characters lost
+ *  while the stack is busy.
+ *
+ *  While the modem sleeps in a power saving mode, the UART input is disabled.
+ *  It resumes when the modem asserts its ring line, or its DCD line if RI is
+ *  not connected.
  */
 class UARTCellularInterface : public PPPCellularInterface {
 
@@ -43,8 +51,11 @@ public:
 private:
     UARTSerial _serial;
     PinName _dcd_pin;
+    PinName _ri_pin;
     bool _active_high;
 
+    void wake_irq();
+
 protected:
     /** Enable or disable hang-up detection
      *
@@ -54,6 +65,13 @@ protected:
      *  active.
      */
     virtual void enable_hup(bool enable);
+
+    /** Disable the UART input while the modem sleeps
+     *
+     *  The deep sleep lock of the UART is released until the modem signals
+     *  activity on its ring or DCD line.
+     */
+    virtual void enable_sleep(bool enable);
 };
 
 #endif //NSAPI_PPP_AVAILABLE
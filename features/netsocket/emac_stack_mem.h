@@ -79,12 +79,53 @@ uint32_t emac_stack_mem_len(emac_stack_t* stack, emac_stack_mem_t *mem);
 /**
  * Sets the actual payload size (the allocated payload size will not change)
  *
+ * Used on memory that is not part of a chain yet, such as a receive buffer the hardware has filled.
+ *
  * @param stack Emac stack context
  * @param mem Memory structure
  * @param len Actual payload size
  */
 void emac_stack_mem_set_len(emac_stack_t* stack, emac_stack_mem_t *mem, uint32_t len);
 
+/**
+ * Allocates a receive buffer
+ *
+ * Receive buffers come from a pool of fixed size buffers rather than from the heap, so a driver can
+ * post them to its DMA descriptors in advance. Once the hardware has received into a buffer, the
+ * driver sets its length and passes it to the stack without copying, alone or with
+ * @a emac_stack_mem_chain_concat for frames spanning several buffers.
+ *
+ * Not to be called from interrupt context.
+ *
+ * @param  stack Emac stack context
+ * @param  align Memory alignment requirements
+ * @return       Allocated memory struct of @a emac_stack_mem_len bytes, or NULL if the pool is empty
+ */
+emac_stack_mem_t *emac_stack_mem_rx_alloc(emac_stack_t* stack, uint32_t align);
+
+/**
+ * Returns the memory structure after the given one in a packet made of several
+ *
+ * Unlike @a emac_stack_mem_chain_dequeue the chain is not changed, so a driver can hand each part
+ * of an output packet to its DMA directly.
+ *
+ * @param  stack Emac stack context
+ * @param  mem   Memory structure of a packet
+ * @return       Next memory structure of the packet, or NULL if mem is the last one
+ */
+emac_stack_mem_t *emac_stack_mem_next(emac_stack_t* stack, emac_stack_mem_t *mem);
+
+/**
+ * Appends memory to the end of a chain, building a packet out of several receive buffers
+ *
+ * The chain takes over the reference to the memory.
+ *
+ * @param  stack Emac stack context
+ * @param  chain Memory chain
+ * @param  mem   Memory structure to append
+ */
+void emac_stack_mem_chain_concat(emac_stack_t* stack, emac_stack_mem_chain_t *chain, emac_stack_mem_t *mem);
+
 /**
  * Returns first memory structure from the list and move the head to point to the next node
  *
@@ -33,6 +33,7 @@
 #include "netsocket/NetworkInterface.h"
 #include "netsocket/EthInterface.h"
 #include "netsocket/WiFiInterface.h"
+#include "netsocket/WiFiScanCache.h"
 #include "netsocket/CellularInterface.h"
 #include "netsocket/MeshInterface.h"
 
@@ -40,6 +41,10 @@
 #include "netsocket/UDPSocket.h"
 #include "netsocket/TCPSocket.h"
 #include "netsocket/TCPServer.h"
+#include "netsocket/NetworkBuffer.h"
+#include "netsocket/SocketSet.h"
+#include "netsocket/TLSSocket.h"
+#include "netsocket/MQTTClient.h"
 
 #endif
 
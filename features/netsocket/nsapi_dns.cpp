@@ -16,9 +16,14 @@
  */
 #include "nsapi_dns.h"
 #include "netsocket/UDPSocket.h"
+#include "events/mbed_shared_queues.h"
+#include "platform/SingletonPtr.h"
+#include "platform/PlatformMutex.h"
+#include "cmsis_os2.h"
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <limits.h>
 
 #define CLASS_IN 1
 
@@ -30,6 +35,18 @@
 #define DNS_TIMEOUT 5000
 #define DNS_SERVERS_SIZE 5
 
+#ifndef MBED_CONF_NSAPI_DNS_CACHE_SIZE
+#define MBED_CONF_NSAPI_DNS_CACHE_SIZE 3
+#endif
+
+#ifndef MBED_CONF_NSAPI_DNS_CACHE_ADDRESSES
+#define MBED_CONF_NSAPI_DNS_CACHE_ADDRESSES 2
+#endif
+
+#ifndef MBED_CONF_NSAPI_DNS_CACHE_MAX_TTL
+#define MBED_CONF_NSAPI_DNS_CACHE_MAX_TTL 3600
+#endif
+
 nsapi_addr_t dns_servers[DNS_SERVERS_SIZE] = {
     {NSAPI_IPv4, {8, 8, 8, 8}},                             // Google
     {NSAPI_IPv4, {209, 244, 0, 3}},                         // Level 3
@@ -112,7 +129,7 @@ static void dns_append_question(uint8_t **p, const char *host, nsapi_version_t v
     dns_append_word(p, CLASS_IN);
 }
 
-static int dns_scan_response(const uint8_t **p, nsapi_addr_t *addr, unsigned addr_count)
+static int dns_scan_response(const uint8_t **p, nsapi_addr_t *addr, unsigned addr_count, uint32_t *ttl)
 {
     // scan header
     uint16_t id    = dns_scan_word(p);
@@ -148,6 +165,7 @@ static int dns_scan_response(const uint8_t **p, nsapi_addr_t *addr, unsigned add
 
     // scan each response
     unsigned count = 0;
+    *ttl = 0xffffffff;
 
     for (int i = 0; i < ancount && count < addr_count; i++) {
         while (true) {
@@ -164,7 +182,8 @@ static int dns_scan_response(const uint8_t **p, nsapi_addr_t *addr, unsigned add
 
         uint16_t rtype    = dns_scan_word(p); // rtype
         uint16_t rclass   = dns_scan_word(p); // rclass
-        *p += 4;                              // ttl
+        uint32_t rttl     = dns_scan_word(p); // ttl
+        rttl = (rttl << 16) | dns_scan_word(p);
         uint16_t rdlength = dns_scan_word(p); // rdlength
 
         if (rtype == RR_A && rclass == CLASS_IN && rdlength == NSAPI_IPv4_BYTES) {
@@ -176,6 +195,7 @@ static int dns_scan_response(const uint8_t **p, nsapi_addr_t *addr, unsigned add
 
             addr += 1;
             count += 1;
+            *ttl = rttl < *ttl ? rttl : *ttl;
         } else if (rtype == RR_AAAA && rclass == CLASS_IN && rdlength == NSAPI_IPv6_BYTES) {
             // accept AAAA record
             addr->version = NSAPI_IPv6;
@@ -185,6 +205,7 @@ static int dns_scan_response(const uint8_t **p, nsapi_addr_t *addr, unsigned add
 
             addr += 1;
             count += 1;
+            *ttl = rttl < *ttl ? rttl : *ttl;
         } else {
             // skip unrecognized records
             *p += rdlength;
@@ -194,6 +215,129 @@ static int dns_scan_response(const uint8_t **p, nsapi_addr_t *addr, unsigned add
     return count;
 }
 
+// DNS cache, shared by all stacks
+#if MBED_CONF_NSAPI_DNS_CACHE_SIZE > 0
+struct dns_cache_entry {
+    char *host;
+    nsapi_version_t version;
+    // Whether the response had no more addresses than the cache holds
+    bool complete;
+    uint8_t count;
+    uint32_t stamp;
+    uint32_t ttl;
+    nsapi_addr_t addrs[MBED_CONF_NSAPI_DNS_CACHE_ADDRESSES];
+};
+
+static dns_cache_entry dns_cache[MBED_CONF_NSAPI_DNS_CACHE_SIZE];
+static SingletonPtr<PlatformMutex> dns_cache_mutex;
+
+// Time an entry has left in ms, 0 once it expired
+static uint32_t dns_cache_remaining(const dns_cache_entry *entry, uint32_t now)
+{
+    uint32_t elapsed = now - entry->stamp;
+    return (entry->host && elapsed < entry->ttl) ? entry->ttl - elapsed : 0;
+}
+
+static nsapi_size_or_error_t dns_cache_find(const char *host, nsapi_version_t version,
+        nsapi_addr_t *addr, unsigned addr_count)
+{
+    nsapi_size_or_error_t result = 0;
+    uint32_t now = osKernelGetTickCount();
+
+    dns_cache_mutex->lock();
+    for (unsigned i = 0; i < MBED_CONF_NSAPI_DNS_CACHE_SIZE; i++) {
+        dns_cache_entry *entry = &dns_cache[i];
+        if (!dns_cache_remaining(entry, now) || entry->version != version ||
+                strcmp(entry->host, host) != 0) {
+            continue;
+        }
+
+        // Entries cut short by the cache size cannot answer for more addresses
+        if (entry->complete || addr_count <= entry->count) {
+            result = addr_count < entry->count ? addr_count : entry->count;
+            memcpy(addr, entry->addrs, result * sizeof(nsapi_addr_t));
+        }
+        break;
+    }
+    dns_cache_mutex->unlock();
+
+    return result;
+}
+
+static void dns_cache_add(const char *host, nsapi_version_t version,
+        const nsapi_addr_t *addr, unsigned count, bool complete, uint32_t ttl)
+{
+    if (ttl > MBED_CONF_NSAPI_DNS_CACHE_MAX_TTL) {
+        ttl = MBED_CONF_NSAPI_DNS_CACHE_MAX_TTL;
+    }
+    if (ttl == 0) {
+        return;
+    }
+    if (count > MBED_CONF_NSAPI_DNS_CACHE_ADDRESSES) {
+        count = MBED_CONF_NSAPI_DNS_CACHE_ADDRESSES;
+        complete = false;
+    }
+    uint32_t now = osKernelGetTickCount();
+
+    dns_cache_mutex->lock();
+    // Reuse the entry for this host, or else the one closest to expiring
+    dns_cache_entry *entry = &dns_cache[0];
+    for (unsigned i = 0; i < MBED_CONF_NSAPI_DNS_CACHE_SIZE; i++) {
+        if (dns_cache[i].host && dns_cache[i].version == version &&
+                strcmp(dns_cache[i].host, host) == 0) {
+            entry = &dns_cache[i];
+            break;
+        }
+        if (dns_cache_remaining(&dns_cache[i], now) < dns_cache_remaining(entry, now)) {
+            entry = &dns_cache[i];
+        }
+    }
+
+    if (!entry->host || strcmp(entry->host, host) != 0) {
+        free(entry->host);
+        entry->host = (char *)malloc(strlen(host) + 1);
+        if (!entry->host) {
+            dns_cache_mutex->unlock();
+            return;
+        }
+        strcpy(entry->host, host);
+    }
+
+    entry->version = version;
+    entry->complete = complete;
+    entry->count = count;
+    entry->stamp = now;
+    entry->ttl = ttl * 1000;
+    memcpy(entry->addrs, addr, count * sizeof(nsapi_addr_t));
+    dns_cache_mutex->unlock();
+}
+
+extern "C" void nsapi_dns_cache_clear(void)
+{
+    dns_cache_mutex->lock();
+    for (unsigned i = 0; i < MBED_CONF_NSAPI_DNS_CACHE_SIZE; i++) {
+        free(dns_cache[i].host);
+        dns_cache[i].host = NULL;
+    }
+    dns_cache_mutex->unlock();
+}
+#else
+static nsapi_size_or_error_t dns_cache_find(const char *host, nsapi_version_t version,
+        nsapi_addr_t *addr, unsigned addr_count)
+{
+    return 0;
+}
+
+static void dns_cache_add(const char *host, nsapi_version_t version,
+        const nsapi_addr_t *addr, unsigned count, bool complete, uint32_t ttl)
+{
+}
+
+extern "C" void nsapi_dns_cache_clear(void)
+{
+}
+#endif
+
 // core query function
 static nsapi_size_or_error_t nsapi_dns_query_multiple(NetworkStack *stack, const char *host,
         nsapi_addr_t *addr, unsigned addr_count, nsapi_version_t version)
@@ -204,6 +348,16 @@ static nsapi_size_or_error_t nsapi_dns_query_multiple(NetworkStack *stack, const
         return NSAPI_ERROR_PARAMETER;
     }
 
+    // the same question is sent for unspecified and IPv4
+    if (version != NSAPI_IPv6) {
+        version = NSAPI_IPv4;
+    }
+
+    nsapi_size_or_error_t cached = dns_cache_find(host, version, addr, addr_count);
+    if (cached > 0) {
+        return cached;
+    }
+
     // create a udp socket
     UDPSocket socket;
     int err = socket.open(stack);
@@ -243,8 +397,11 @@ static nsapi_size_or_error_t nsapi_dns_query_multiple(NetworkStack *stack, const
         }
 
         const uint8_t *response = packet;
-        if (dns_scan_response(&response, addr, addr_count) > 0) {
-            result = NSAPI_ERROR_OK;
+        uint32_t ttl;
+        int count = dns_scan_response(&response, addr, addr_count, &ttl);
+        if (count > 0) {
+            dns_cache_add(host, version, addr, count, (unsigned)count < addr_count, ttl);
+            result = count;
         }
 
         /* The DNS response is final, no need to check other servers */
@@ -264,6 +421,223 @@ static nsapi_size_or_error_t nsapi_dns_query_multiple(NetworkStack *stack, const
     return result;
 }
 
+// asynchronous queries, processed from the shared event queue
+struct dns_query {
+    int id;
+    char *host;
+    nsapi_version_t version;
+    NetworkStack::hostbyname_cb_t callback;
+    UDPSocket *socket;
+    int timeout_id;
+    // questions sent and answers without an address received
+    unsigned sent;
+    unsigned failed;
+    dns_query *next;
+};
+
+static dns_query *dns_queries;
+static int dns_query_id;
+static SingletonPtr<PlatformMutex> dns_query_mutex;
+
+// Removes a query from the list, must be called with dns_query_mutex locked
+static dns_query *dns_query_unlink(int id)
+{
+    for (dns_query **query = &dns_queries; *query; query = &(*query)->next) {
+        if ((*query)->id == id) {
+            dns_query *found = *query;
+            *query = found->next;
+            if (found->timeout_id) {
+                mbed_event_queue()->cancel(found->timeout_id);
+            }
+            return found;
+        }
+    }
+
+    return NULL;
+}
+
+static void dns_query_free(dns_query *query)
+{
+    if (query->socket) {
+        query->socket->close();
+        delete query->socket;
+    }
+    free(query->host);
+    delete query;
+}
+
+static void dns_query_process(int id)
+{
+    uint8_t *packet = (uint8_t *)malloc(DNS_BUFFER_SIZE);
+
+    dns_query_mutex->lock();
+    dns_query *query = dns_queries;
+    while (query && query->id != id) {
+        query = query->next;
+    }
+    if (!query) {
+        dns_query_mutex->unlock();
+        free(packet);
+        return;
+    }
+
+    nsapi_error_t result = NSAPI_ERROR_WOULD_BLOCK;
+    nsapi_addr_t addr;
+    while (packet) {
+        nsapi_size_or_error_t size = query->socket->recvfrom(NULL, packet, DNS_BUFFER_SIZE);
+        if (size < 0) {
+            if (size != NSAPI_ERROR_WOULD_BLOCK) {
+                result = size;
+            }
+            break;
+        }
+
+        // the first answer with an address wins
+        const uint8_t *response = packet;
+        uint32_t ttl;
+        int count = dns_scan_response(&response, &addr, 1, &ttl);
+        if (count > 0) {
+            dns_cache_add(query->host, query->version, &addr, count, false, ttl);
+            result = NSAPI_ERROR_OK;
+            break;
+        } else if (++query->failed >= query->sent) {
+            result = NSAPI_ERROR_DNS_FAILURE;
+            break;
+        }
+    }
+
+    if (!packet) {
+        result = NSAPI_ERROR_NO_MEMORY;
+    }
+    if (result != NSAPI_ERROR_WOULD_BLOCK) {
+        dns_query_unlink(id);
+    }
+    dns_query_mutex->unlock();
+    free(packet);
+
+    if (result != NSAPI_ERROR_WOULD_BLOCK) {
+        SocketAddress address(addr, 0);
+        query->callback(result, result == NSAPI_ERROR_OK ? &address : NULL);
+        dns_query_free(query);
+    }
+}
+
+static void dns_query_timeout(int id)
+{
+    dns_query_mutex->lock();
+    dns_query *query = dns_query_unlink(id);
+    if (query) {
+        query->timeout_id = 0;
+    }
+    dns_query_mutex->unlock();
+
+    if (query) {
+        query->callback(NSAPI_ERROR_DNS_FAILURE, NULL);
+        dns_query_free(query);
+    }
+}
+
+// called by the stack, so only defers to the event queue
+static void dns_query_signal(dns_query *query)
+{
+    mbed_event_queue()->call(dns_query_process, query->id);
+}
+
+nsapi_value_or_error_t nsapi_dns_query_async(NetworkStack *stack, const char *host,
+        NetworkStack::hostbyname_cb_t callback, nsapi_version_t version)
+{
+    // check for valid host name
+    int host_len = host ? strlen(host) : 0;
+    if (host_len > 128 || host_len == 0) {
+        return NSAPI_ERROR_PARAMETER;
+    }
+
+    // the same question is sent for unspecified and IPv4
+    if (version != NSAPI_IPv6) {
+        version = NSAPI_IPv4;
+    }
+
+    nsapi_addr_t addr;
+    if (dns_cache_find(host, version, &addr, 1) > 0) {
+        SocketAddress address(addr, 0);
+        callback(NSAPI_ERROR_OK, &address);
+        return NSAPI_ERROR_OK;
+    }
+
+    uint8_t *packet = (uint8_t *)malloc(DNS_BUFFER_SIZE);
+    dns_query *query = new dns_query;
+    query->host = (char *)malloc(host_len + 1);
+    query->socket = new UDPSocket;
+    if (!packet || !query->host) {
+        free(packet);
+        dns_query_free(query);
+        return NSAPI_ERROR_NO_MEMORY;
+    }
+    strcpy(query->host, host);
+    query->version = version;
+    query->callback = callback;
+    query->timeout_id = 0;
+    query->sent = 0;
+    query->failed = 0;
+
+    nsapi_error_t err = query->socket->open(stack);
+    if (err) {
+        free(packet);
+        dns_query_free(query);
+        return err;
+    }
+    query->socket->set_blocking(false);
+    query->socket->sigio(mbed::callback(dns_query_signal, query));
+
+    // the query is listed before any question is sent, so that no answer
+    // can be processed before it is
+    dns_query_mutex->lock();
+    dns_query_id = (dns_query_id % INT_MAX) + 1;
+    query->id = dns_query_id;
+    query->next = dns_queries;
+    dns_queries = query;
+
+    // ask all the servers at once
+    uint8_t *question = packet;
+    dns_append_question(&question, host, version);
+    for (unsigned i = 0; i < DNS_SERVERS_SIZE; i++) {
+        // send may fail for various reasons, including wrong address type - move on
+        if (query->socket->sendto(SocketAddress(dns_servers[i], 53), packet, question - packet) >= 0) {
+            query->sent += 1;
+        }
+    }
+    free(packet);
+
+    if (query->sent) {
+        query->timeout_id = mbed_event_queue()->call_in(DNS_TIMEOUT, dns_query_timeout, query->id);
+    }
+    if (!query->timeout_id) {
+        dns_query_unlink(query->id);
+        dns_query_mutex->unlock();
+        err = query->sent ? NSAPI_ERROR_NO_MEMORY : NSAPI_ERROR_DNS_FAILURE;
+        dns_query_free(query);
+        return err;
+    }
+
+    nsapi_value_or_error_t id = query->id;
+    dns_query_mutex->unlock();
+    return id;
+}
+
+nsapi_error_t nsapi_dns_query_async_cancel(nsapi_value_or_error_t id)
+{
+    dns_query_mutex->lock();
+    dns_query *query = dns_query_unlink(id);
+    dns_query_mutex->unlock();
+
+    if (!query) {
+        return NSAPI_ERROR_PARAMETER;
+    }
+
+    dns_query_free(query);
+    return NSAPI_ERROR_OK;
+}
+
 // convenience functions for other forms of queries
 extern "C" nsapi_size_or_error_t nsapi_dns_query_multiple(nsapi_stack_t *stack, const char *host,
         nsapi_addr_t *addr, nsapi_size_t addr_count, nsapi_version_t version)
@@ -60,6 +60,14 @@ nsapi_size_or_error_t nsapi_dns_query_multiple(nsapi_stack_t *stack, const char
  */
 nsapi_error_t nsapi_dns_add_server(nsapi_addr_t addr);
 
+/** Remove all host addresses from the DNS cache
+ *
+ *  Queries answered from the cache do not reach a server until the TTL
+ *  of the records expires, this forces them to, e.g. after the network
+ *  changed.
+ */
+void nsapi_dns_cache_clear(void);
+
 
 #else
 
@@ -148,6 +156,32 @@ nsapi_size_or_error_t nsapi_dns_query_multiple(S *stack, const char *host,
                 host, addr, addr_count, version);
 }
 
+/** Query the domain name servers for an IP address of a given hostname without blocking
+ *
+ *  The question is sent to all servers at once, and the first answer
+ *  with an address wins. The callback is called from mbed_event_queue(),
+ *  or before this returns if the address is in the DNS cache.
+ *
+ *  @param stack    Network stack as target for DNS query
+ *  @param host     Hostname to resolve
+ *  @param callback Callback that is called with the result
+ *  @param version  IP version to resolve (defaults to NSAPI_IPv4)
+ *  @return         0 if the callback was already called, a positive id
+ *                  for nsapi_dns_query_async_cancel, or a negative error
+ *                  code on failure, in which case the callback is not called
+ */
+nsapi_value_or_error_t nsapi_dns_query_async(NetworkStack *stack, const char *host,
+        NetworkStack::hostbyname_cb_t callback, nsapi_version_t version = NSAPI_IPv4);
+
+/** Cancel an asynchronous DNS query
+ *
+ *  The callback is not called once this returns.
+ *
+ *  @param id       Id returned by nsapi_dns_query_async
+ *  @return         0 on success, NSAPI_ERROR_PARAMETER if the query already completed
+ */
+nsapi_error_t nsapi_dns_query_async_cancel(nsapi_value_or_error_t id);
+
 /** Add a domain name server to list of servers to query
  *
  *  @param addr     Destination for the host address
@@ -175,6 +209,14 @@ static inline nsapi_error_t nsapi_dns_add_server(const char *address)
     return nsapi_dns_add_server(SocketAddress(address));
 }
 
+/** Remove all host addresses from the DNS cache
+ *
+ *  Queries answered from the cache do not reach a server until the TTL
+ *  of the records expires, this forces them to, e.g. after the network
+ *  changed.
+ */
+extern "C" void nsapi_dns_cache_clear(void);
+
 
 #endif
 
@@ -73,6 +73,20 @@ typedef unsigned int nsapi_size_t;
  */
 typedef signed int nsapi_size_or_error_t;
 
+/** Type used to represent either a value or error
+ *
+ *  A valid nsapi_value_or_error_t is either a non-negative value or a
+ *  negative error code from the nsapi_error_t
+ */
+typedef signed int nsapi_value_or_error_t;
+
+/** Opaque handle for a buffer owned by a network stack
+ *
+ *  Buffers are chains of contiguous segments, used to pass data through
+ *  sockets without copying it
+ */
+typedef void *nsapi_buf_t;
+
 /** Enum of encryption types
  *
  *  The security type specifies a particular security to use when
@@ -149,6 +163,25 @@ typedef struct nsapi_addr {
     uint8_t bytes[NSAPI_IP_BYTES];
 } nsapi_addr_t;
 
+/** Datagram passed to the batch send and receive calls
+ */
+typedef struct nsapi_msg {
+    /** Address and port of the remote host, the destination of a sent
+     *  datagram or the source of a received one
+     */
+    nsapi_addr_t addr;
+    uint16_t port;
+
+    /** Data of a datagram to send, or destination for a received one */
+    void *data;
+
+    /** Size of data in bytes */
+    nsapi_size_t size;
+
+    /** Filled in with the number of bytes sent or received */
+    nsapi_size_t len;
+} nsapi_msg_t;
+
 
 /** Opaque handle for network sockets
  */
@@ -211,11 +244,23 @@ typedef enum nsapi_socket_option {
     NSAPI_KEEPALIVE, /*!< Enables sending of keepalive messages */
     NSAPI_KEEPIDLE,  /*!< Sets timeout value to initiate keepalive */
     NSAPI_KEEPINTVL, /*!< Sets timeout value for keepalive */
-    NSAPI_LINGER,    /*!< Keeps close from returning until queues empty */
+    NSAPI_LINGER,    /*!< Keeps close from returning until queues empty, takes an nsapi_linger_t */
     NSAPI_SNDBUF,    /*!< Sets send buffer size */
     NSAPI_RCVBUF,    /*!< Sets recv buffer size */
+    NSAPI_PRIORITY,  /*!< Sets the transmit priority of the packets of the socket, an int from 0 (default) to 7 (highest) */
 } nsapi_socket_option_t;
 
+/** Value of the NSAPI_LINGER socket option
+ */
+typedef struct nsapi_linger {
+    /** Non-zero to linger on close */
+    int l_onoff;
+
+    /** Seconds close waits for unsent data to be acknowledged before
+     *  resetting the connection, 0 to reset it straight away */
+    int l_linger;
+} nsapi_linger_t;
+
 /** Supported IP protocol versions of IP stack
  *
  *  @enum nsapi_ip_stack
@@ -554,6 +599,137 @@ typedef struct nsapi_stack_api
      */    
     nsapi_error_t (*getsockopt)(nsapi_stack_t *stack, nsapi_socket_t socket, int level,
             int optname, void *optval, unsigned *optlen);
+
+    /** Allocate a buffer to fill and send
+     *
+     *  The buffer functions are optional, but a stack provides either all
+     *  of them or none, in which case data is copied to and from heap
+     *  buffers by the send and recv functions.
+     *
+     *  @param stack    Stack handle
+     *  @param buf      Destination for the buffer
+     *  @param size     Size of the buffer in bytes
+     *  @return         0 on success, negative error code on failure
+     */
+    nsapi_error_t (*buf_alloc)(nsapi_stack_t *stack, nsapi_buf_t *buf, nsapi_size_t size);
+
+    /** Free a buffer
+     *
+     *  @param stack    Stack handle
+     *  @param buf      Buffer allocated or received from the stack
+     */
+    void (*buf_free)(nsapi_stack_t *stack, nsapi_buf_t buf);
+
+    /** Get the data of a segment of a buffer
+     *
+     *  @param stack    Stack handle
+     *  @param segment  Buffer, or a segment returned by an earlier call
+     *  @param data     Destination for the data of the segment
+     *  @param len      Destination for the length of the segment in bytes
+     *  @return         The next segment, or NULL if this is the last one
+     */
+    nsapi_buf_t (*buf_segment)(nsapi_stack_t *stack, nsapi_buf_t segment,
+            void **data, nsapi_size_t *len);
+
+    /** Receive data over a TCP socket into a buffer owned by the caller
+     *
+     *  This call is non-blocking. If recv would block,
+     *  NSAPI_ERROR_WOULD_BLOCK is returned immediately.
+     *
+     *  @param stack    Stack handle
+     *  @param socket   Socket handle
+     *  @param buf      Destination for a buffer of the received data,
+     *                  which the caller frees with buf_free
+     *  @return         Number of received bytes on success, negative error
+     *                  code on failure
+     */
+    nsapi_size_or_error_t (*socket_recv_buf)(nsapi_stack_t *stack, nsapi_socket_t socket,
+            nsapi_buf_t *buf);
+
+    /** Receive a packet over a UDP socket into a buffer owned by the caller
+     *
+     *  This call is non-blocking. If recvfrom would block,
+     *  NSAPI_ERROR_WOULD_BLOCK is returned immediately.
+     *
+     *  @param stack    Stack handle
+     *  @param socket   Socket handle
+     *  @param addr     Destination for the address of the remote host
+     *  @param port     Destination for the port of the remote host
+     *  @param buf      Destination for a buffer of the received packet,
+     *                  which the caller frees with buf_free
+     *  @return         Number of received bytes on success, negative error
+     *                  code on failure
+     */
+    nsapi_size_or_error_t (*socket_recvfrom_buf)(nsapi_stack_t *stack, nsapi_socket_t socket,
+            nsapi_addr_t *addr, uint16_t *port, nsapi_buf_t *buf);
+
+    /** Send the data of a buffer over a TCP socket
+     *
+     *  The buffer stays owned by the caller. This call is non-blocking. If
+     *  send would block, NSAPI_ERROR_WOULD_BLOCK is returned immediately.
+     *
+     *  @param stack    Stack handle
+     *  @param socket   Socket handle
+     *  @param buf      Buffer from the stack
+     *  @param offset   Offset of the data to send in the buffer
+     *  @return         Number of sent bytes on success, negative error
+     *                  code on failure
+     */
+    nsapi_size_or_error_t (*socket_send_buf)(nsapi_stack_t *stack, nsapi_socket_t socket,
+            nsapi_buf_t buf, nsapi_size_t offset);
+
+    /** Send a buffer as a packet over a UDP socket
+     *
+     *  The buffer stays owned by the caller, but its contents are undefined
+     *  once sent. This call is non-blocking. If sendto would block,
+     *  NSAPI_ERROR_WOULD_BLOCK is returned immediately.
+     *
+     *  @param stack    Stack handle
+     *  @param socket   Socket handle
+     *  @param addr     The address of the remote host
+     *  @param port     The port of the remote host
+     *  @param buf      Buffer from the stack
+     *  @return         Number of sent bytes on success, negative error
+     *                  code on failure
+     */
+    nsapi_size_or_error_t (*socket_sendto_buf)(nsapi_stack_t *stack, nsapi_socket_t socket,
+            nsapi_addr_t addr, uint16_t port, nsapi_buf_t buf);
+
+    /** Send several packets over a UDP socket
+     *
+     *  Optional, stacks without it send the packets one at a time with
+     *  socket_sendto. Sends the packets in order until one would block or
+     *  fails, and fills in the len of each packet sent. This call is
+     *  non-blocking. If no packet can be sent, NSAPI_ERROR_WOULD_BLOCK is
+     *  returned immediately.
+     *
+     *  @param stack    Stack handle
+     *  @param socket   Socket handle
+     *  @param msgs     Packets to send
+     *  @param count    Number of packets
+     *  @return         Number of packets sent on success, negative error
+     *                  code if the first packet could not be sent
+     */
+    nsapi_size_or_error_t (*socket_sendto_batch)(nsapi_stack_t *stack, nsapi_socket_t socket,
+            nsapi_msg_t *msgs, nsapi_size_t count);
+
+    /** Receive several packets over a UDP socket
+     *
+     *  Optional, stacks without it receive the packets one at a time with
+     *  socket_recvfrom. Receives the packets already queued on the socket
+     *  up to count, filling in the address, port and len of each. This
+     *  call is non-blocking. If no packet is queued,
+     *  NSAPI_ERROR_WOULD_BLOCK is returned immediately.
+     *
+     *  @param stack    Stack handle
+     *  @param socket   Socket handle
+     *  @param msgs     Destinations for the packets
+     *  @param count    Number of destinations
+     *  @return         Number of packets received on success, negative
+     *                  error code if no packet could be received
+     */
+    nsapi_size_or_error_t (*socket_recvfrom_batch)(nsapi_stack_t *stack, nsapi_socket_t socket,
+            nsapi_msg_t *msgs, nsapi_size_t count);
 } nsapi_stack_api_t;
 
 
@@ -509,6 +509,82 @@ control_t cfstore_find_test_07_end(const size_t call_count)
 }
 
 
+/// @cond CFSTORE_DOXYGEN_DISABLE
+#define CFSTORE_FIND_TEST_08_NUM_KVS            48
+/// @endcond
+
+/**
+ * @brief   test case to check KVs are opened by name correctly as KVs before
+ *          them in the store are deleted and grown
+ *
+ * @return on success returns CaseNext to continue to next test case, otherwise will assert on errors.
+ */
+control_t cfstore_find_test_08_end(const size_t call_count)
+{
+    char key_name[CFSTORE_KEY_NAME_MAX_LENGTH+1];
+    char value[CFSTORE_KEY_NAME_MAX_LENGTH+1];
+    char read_buf[CFSTORE_KEY_NAME_MAX_LENGTH+1];
+    int32_t ret = ARM_DRIVER_ERROR;
+    int32_t i = 0;
+    ARM_CFSTORE_SIZE len = 0;
+    ARM_CFSTORE_DRIVER* drv = &cfstore_driver;
+    ARM_CFSTORE_KEYDESC kdesc;
+    ARM_CFSTORE_HANDLE_INIT(hkey);
+
+    (void) call_count;
+    memset(&kdesc, 0, sizeof(kdesc));
+    for(i = 0; i < CFSTORE_FIND_TEST_08_NUM_KVS; i++){
+        snprintf(key_name, CFSTORE_KEY_NAME_MAX_LENGTH+1, "com.arm.mbed.find.test08.key%d", (int) i);
+        snprintf(value, CFSTORE_KEY_NAME_MAX_LENGTH+1, "value%d", (int) i);
+        len = strlen(value);
+        ret = cfstore_test_create(key_name, value, &len, &kdesc);
+        CFSTORE_TEST_UTEST_MESSAGE(cfstore_find_utest_msg_g, CFSTORE_UTEST_MSG_BUF_SIZE, "%s:Error: failed to create KV (key_name=%s, ret=%d).\n", __func__, key_name, (int) ret);
+        TEST_ASSERT_MESSAGE(ret >= ARM_DRIVER_OK, cfstore_find_utest_msg_g);
+    }
+
+    /* delete every third KV and grow the KV after it */
+    for(i = 0; i < CFSTORE_FIND_TEST_08_NUM_KVS; i += 3){
+        snprintf(key_name, CFSTORE_KEY_NAME_MAX_LENGTH+1, "com.arm.mbed.find.test08.key%d", (int) i);
+        ret = cfstore_test_delete(key_name);
+        CFSTORE_TEST_UTEST_MESSAGE(cfstore_find_utest_msg_g, CFSTORE_UTEST_MSG_BUF_SIZE, "%s:Error: failed to delete KV (key_name=%s, ret=%d).\n", __func__, key_name, (int) ret);
+        TEST_ASSERT_MESSAGE(ret >= ARM_DRIVER_OK, cfstore_find_utest_msg_g);
+
+        snprintf(key_name, CFSTORE_KEY_NAME_MAX_LENGTH+1, "com.arm.mbed.find.test08.key%d", (int) i+1);
+        snprintf(value, CFSTORE_KEY_NAME_MAX_LENGTH+1, "value%d.grown", (int) i+1);
+        len = strlen(value);
+        ret = drv->Create(key_name, len, NULL, hkey);
+        CFSTORE_TEST_UTEST_MESSAGE(cfstore_find_utest_msg_g, CFSTORE_UTEST_MSG_BUF_SIZE, "%s:Error: failed to grow KV (key_name=%s, ret=%d).\n", __func__, key_name, (int) ret);
+        TEST_ASSERT_MESSAGE(ret >= ARM_DRIVER_OK, cfstore_find_utest_msg_g);
+        ret = drv->Write(hkey, value, &len);
+        CFSTORE_TEST_UTEST_MESSAGE(cfstore_find_utest_msg_g, CFSTORE_UTEST_MSG_BUF_SIZE, "%s:Error: failed to write KV (key_name=%s, ret=%d).\n", __func__, key_name, (int) ret);
+        TEST_ASSERT_MESSAGE(ret >= ARM_DRIVER_OK, cfstore_find_utest_msg_g);
+        drv->Close(hkey);
+    }
+
+    for(i = 0; i < CFSTORE_FIND_TEST_08_NUM_KVS; i++){
+        snprintf(key_name, CFSTORE_KEY_NAME_MAX_LENGTH+1, "com.arm.mbed.find.test08.key%d", (int) i);
+        snprintf(value, CFSTORE_KEY_NAME_MAX_LENGTH+1, i % 3 == 1 ? "value%d.grown" : "value%d", (int) i);
+        len = CFSTORE_KEY_NAME_MAX_LENGTH;
+        memset(read_buf, 0, CFSTORE_KEY_NAME_MAX_LENGTH+1);
+        ret = cfstore_test_read(key_name, read_buf, &len);
+        if(i % 3 == 0){
+            CFSTORE_TEST_UTEST_MESSAGE(cfstore_find_utest_msg_g, CFSTORE_UTEST_MSG_BUF_SIZE, "%s:Error: found deleted KV (key_name=%s, ret=%d).\n", __func__, key_name, (int) ret);
+            TEST_ASSERT_MESSAGE(ret == ARM_CFSTORE_DRIVER_ERROR_KEY_NOT_FOUND, cfstore_find_utest_msg_g);
+            continue;
+        }
+        CFSTORE_TEST_UTEST_MESSAGE(cfstore_find_utest_msg_g, CFSTORE_UTEST_MSG_BUF_SIZE, "%s:Error: failed to read KV (key_name=%s, ret=%d).\n", __func__, key_name, (int) ret);
+        TEST_ASSERT_MESSAGE(ret >= ARM_DRIVER_OK, cfstore_find_utest_msg_g);
+        CFSTORE_TEST_UTEST_MESSAGE(cfstore_find_utest_msg_g, CFSTORE_UTEST_MSG_BUF_SIZE, "%s:Error: read incorrect value (key_name=%s, value=%s).\n", __func__, key_name, read_buf);
+        TEST_ASSERT_MESSAGE(strcmp(read_buf, value) == 0, cfstore_find_utest_msg_g);
+    }
+
+    ret = drv->Uninitialize();
+    CFSTORE_TEST_UTEST_MESSAGE(cfstore_find_utest_msg_g, CFSTORE_UTEST_MSG_BUF_SIZE, "%s:Error: Uninitialize() call failed.\n", __func__);
+    TEST_ASSERT_MESSAGE(ret >= ARM_DRIVER_OK, cfstore_find_utest_msg_g);
+    return CaseNext;
+}
+
+
 /// @cond CFSTORE_DOXYGEN_DISABLE
 utest::v1::status_t greentea_setup(const size_t number_of_cases)
 {
@@ -531,6 +607,8 @@ Case cases[] = {
         Case("FIND_test_06_end", cfstore_find_test_06_end),
         Case("FIND_test_07_start", cfstore_utest_default_start),
         Case("FIND_test_07_end", cfstore_find_test_07_end),
+        Case("FIND_test_08_start", cfstore_utest_default_start),
+        Case("FIND_test_08_end", cfstore_find_test_08_end),
 };
 
 
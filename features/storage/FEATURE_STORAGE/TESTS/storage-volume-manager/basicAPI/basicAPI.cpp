@@ -1195,6 +1195,79 @@ control_t test_concurrentAccessFromTwoCStorageDevices(const size_t call_count)
     return CaseNext;
 }
 
+control_t test_statisticsAndReadCache(const size_t call_count)
+{
+    tr_info("test_statisticsAndReadCache: called with call_count %lu", call_count);
+    static StorageVolumeManager volumeManager;
+    static StorageVolume *volumeP = NULL;
+    static ARM_STORAGE_INFO info;
+
+    int32_t rc;
+    if (call_count == 1) {
+        rc = volumeManager.initialize(drv, initializeCallbackHandler);
+        TEST_ASSERT(rc >= ARM_DRIVER_OK);
+        if (rc == ARM_DRIVER_OK) {
+            TEST_ASSERT_EQUAL(1,  drv->GetCapabilities().asynchronous_ops);
+            return CaseTimeout(200) + CaseRepeatAll;
+        }
+
+        /* synchronous completion */
+        TEST_ASSERT(rc == 1);
+    }
+
+    if (drv->GetCapabilities().asynchronous_ops) {
+        return CaseNext; /* the read cache only serves synchronous storage; the rest is covered by the tests above. */
+    }
+
+    ARM_STORAGE_BLOCK firstBlock;
+    rc = drv->GetNextBlock(NULL, &firstBlock);
+    TEST_ASSERT_EQUAL(ARM_DRIVER_OK, rc);
+    rc = drv->GetInfo(&info);
+    TEST_ASSERT_EQUAL(ARM_DRIVER_OK, rc);
+
+    rc = volumeManager.addVolume(firstBlock.addr, info.total_storage, &volumeP);
+    TEST_ASSERT_EQUAL(ARM_DRIVER_OK, rc);
+    rc = volumeP->Initialize(virtualMTDCallbackHandler);
+    TEST_ASSERT_EQUAL(1, rc);
+
+    const StorageVolume_Statistics_t &statistics = volumeP->getStatistics();
+    TEST_ASSERT_EQUAL(0, statistics.reads);
+
+    /* repeated small reads */
+    uint8_t small[16];
+    rc = volumeP->ReadData(0, small, sizeof(small));
+    TEST_ASSERT_EQUAL(sizeof(small), rc);
+    rc = volumeP->ReadData(sizeof(small), small, sizeof(small));
+    TEST_ASSERT_EQUAL(sizeof(small), rc);
+    TEST_ASSERT_EQUAL(2, statistics.reads);
+    TEST_ASSERT_EQUAL(2 * sizeof(small), statistics.readBytes);
+    TEST_ASSERT_EQUAL((STORAGE_VOLUME_MANAGER_READ_CACHE_SIZE >= (2 * sizeof(small))) ? 1 : 0, statistics.readCacheHits);
+
+    /* a read after a program must see the new data */
+    const uint32_t sizeofDataOperation = firstBlock.attributes.erase_unit;
+    TEST_ASSERT(sizeofDataOperation <= BUFFER_SIZE);
+    rc = volumeP->Erase(0, sizeofDataOperation);
+    TEST_ASSERT_EQUAL(sizeofDataOperation, rc);
+    memset(buffer, 0xAA, sizeofDataOperation);
+    rc = volumeP->ProgramData(0, buffer, sizeofDataOperation);
+    TEST_ASSERT_EQUAL(sizeofDataOperation, rc);
+    rc = volumeP->ReadData(0, small, sizeof(small));
+    TEST_ASSERT_EQUAL(sizeof(small), rc);
+    for (size_t index = 0; index < sizeof(small); index++) {
+        TEST_ASSERT_EQUAL(0xAA, small[index]);
+    }
+
+    TEST_ASSERT_EQUAL(1, statistics.erases);
+    TEST_ASSERT_EQUAL(sizeofDataOperation, statistics.eraseBytes);
+    TEST_ASSERT_EQUAL(1, statistics.programs);
+    TEST_ASSERT_EQUAL(sizeofDataOperation, statistics.programBytes);
+
+    volumeP->resetStatistics();
+    TEST_ASSERT_EQUAL(0, statistics.reads);
+
+    return CaseNext;
+}
+
 // Specify all your test cases here
 Case cases[] = {
     Case("initialize",                                    test_initialize),
@@ -1206,6 +1279,7 @@ Case cases[] = {
     Case("Against a single C_Storage at offset",          test_againstSingleCStorageAtOffset<4096>),
     Case("Against a single C_Storage at offset",          test_againstSingleCStorageAtOffset<8192>),
     Case("Against a single C_Storage at offset",          test_againstSingleCStorageAtOffset<65536>),
+    Case("Statistics and read cache of a volume",         test_statisticsAndReadCache),
 
     /* note: the following tests are unportable in the sense that they require the underlying storage device to support certain address ranges. */
     Case("Concurrent accesss from two volumes",           test_concurrentAccessFromTwoVolumes<512*1024, 128*1024, (512+128)*1024, 128*1024>),
@@ -56,6 +56,19 @@
 #define CFSTORE_CONFIG_BACKEND_FLASH_ENABLED
 #endif
 
+/* CFSTORE_HASH_INDEX
+ *   Look up key names in a hash index held in the heap, rather than walking
+ *   the KVs in the area. The index isnt used when the client provides the
+ *   memory slab for the area (CFSTORE_YOTTA_CFG_CFSTORE_SRAM_ADDR).
+ */
+#ifndef CFSTORE_HASH_INDEX
+#define CFSTORE_HASH_INDEX 1
+#endif
+
+#if CFSTORE_HASH_INDEX && !defined CFSTORE_YOTTA_CFG_CFSTORE_SRAM_ADDR
+#define CFSTORE_CONFIG_HASH_INDEX_ENABLED
+#endif
+
 #if defined STORAGE_CONFIG_HARDWARE_MTD_K64F_ASYNC_OPS
 #define CFSTORE_STORAGE_DRIVER_CONFIG_HARDWARE_MTD_ASYNC_OPS STORAGE_CONFIG_HARDWARE_MTD_K64F_ASYNC_OPS
 #endif
@@ -84,9 +84,20 @@ struct _ARM_DRIVER_STORAGE cfstore_journal_mtd;
  *
  * ARM_DRIVER_OK_DONE
  *   value that indicates an operation has been done i.e. a value > 0
+ *
+ * CFSTORE_KEY_NAME_QUERY_CHARS_SPECIAL
+ *  characters cfstore_fnmatch() treats specially in a query. The part of a query
+ *  before the first of them must be matched literally.
+ *
+ * CFSTORE_INDEX_LEN_MIN
+ *  minimum number of slots in the key name hash index
+ *
+ * CFSTORE_AREA_GROWTH_MIN
+ *  minimum room in octets left for the sram area to grow into when it is realloc-ed
  */
 #define CFSTORE_KEY_NAME_CHARS_ACCEPTABLE           "0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ{}.-_@"
 #define CFSTORE_KEY_NAME_QUERY_CHARS_ACCEPTABLE     CFSTORE_KEY_NAME_CHARS_ACCEPTABLE"*"
+#define CFSTORE_KEY_NAME_QUERY_CHARS_SPECIAL        "*?[\\"
 #define CFSTORE_HKVT_REFCOUNT_MAX                   0xff
 #define CFSTORE_LOCK_REFCOUNT_MAX                   0xffff
 #define CFSTORE_FILE_CREATE_MODE_DEFAULT            (ARM_CFSTORE_FMODE)0
@@ -97,6 +108,8 @@ struct _ARM_DRIVER_STORAGE cfstore_journal_mtd;
 #define CFSTORE_SENTINEL                            0x7fffffff
 #define CFSTORE_CALLBACK_RET_CODE_DEFAULT           0x1
 #define ARM_DRIVER_OK_DONE                          1
+#define CFSTORE_INDEX_LEN_MIN                       8
+#define CFSTORE_AREA_GROWTH_MIN                     64
 
 /*
  * Simple Types
@@ -351,8 +364,9 @@ static int32_t cfstore_get_key_name_ex(cfstore_area_hkvt_t *hkvt, char* key_name
  *          - accessed in app & intr context; hence needs CS protection.
  *
  * @param   area_0_len
- *          length of the area used for storing KVs, including padding to
- *          round to nearest program unit
+ *          length of the memory allocated for storing KVs, a multiple of
+ *          the program unit. This includes room for the KVs to grow into
+ *          without a realloc(), which is kept zeroed.
  *
  * @param   rw_area0_lock
  *          lock used to make CS re-entrant e.g. only 1 flush operation can be
@@ -370,6 +384,22 @@ static int32_t cfstore_get_key_name_ex(cfstore_area_hkvt_t *hkvt, char* key_name
  *          flag indicating that the area has been written and therefore is
  *          dirty with respect to the data persisted to flash.
  *
+ * @param   index_stale_flag
+ *          flag indicating the KVs in the area have moved since the hash
+ *          index was built, so the index must be rebuilt before it is used.
+ *
+ * @param   index
+ *          open addressed hash table of key names, each slot holding the
+ *          offset of a KV from area_0_head plus 1, or 0 if the slot is free.
+ *          Offsets rather than pointers are stored so the index survives
+ *          the area being moved by realloc().
+ *
+ * @param   index_len
+ *          number of slots in the index, a power of 2.
+ *
+ * @param   index_count
+ *          number of KVs in the index.
+ *
  * @expected_blob_size  expected_blob_size = area_0_tail - area_0_head + pad
  *          In the case of reading from flash into sram, this will be be size
  *          of the flash blob (rounded to a multiple program_unit if not
@@ -399,7 +429,15 @@ typedef struct cfstore_ctx_t
     /* flags */
     uint32_t client_callback_notify_flag : 1;
     uint32_t area_dirty_flag : 1;
-    uint32_t f_reserved0 : 30;
+    uint32_t index_stale_flag : 1;
+    uint32_t f_reserved0 : 29;
+
+#ifdef CFSTORE_CONFIG_HASH_INDEX_ENABLED
+    /* hash index of key names */
+    uint32_t *index;
+    uint32_t index_len;
+    uint32_t index_count;
+#endif /* CFSTORE_CONFIG_HASH_INDEX_ENABLED */
 
 #ifdef CFSTORE_CONFIG_BACKEND_FLASH_ENABLED
     /* flash journal related data */
@@ -639,6 +677,29 @@ static inline uint32_t cfstore_ctx_get_program_unit(cfstore_ctx_t* ctx)
 
 }
 
+/* @brief   helper function to compute the memory to allocate for an area of
+ *          size bytes (a multiple of the program_unit), leaving room for KVs
+ *          to be created and grown without a realloc() of the area each time.
+ */
+static ARM_CFSTORE_SIZE cfstore_ctx_get_area_capacity(cfstore_ctx_t* ctx, ARM_CFSTORE_SIZE size)
+{
+    ARM_CFSTORE_SIZE capacity = size + size / 2;
+
+    if(capacity < size + CFSTORE_AREA_GROWTH_MIN){
+        capacity = size + CFSTORE_AREA_GROWTH_MIN;
+    }
+    if(capacity % cfstore_ctx_get_program_unit(ctx) > 0){
+        capacity += (cfstore_ctx_get_program_unit(ctx) - (capacity % cfstore_ctx_get_program_unit(ctx)));
+    }
+#ifdef CFSTORE_YOTTA_CFG_CFSTORE_SRAM_ADDR
+    /* the area cannot grow beyond the client provided memory slab */
+    if(capacity > CFSTORE_YOTTA_CFG_CFSTORE_SRAM_SIZE){
+        capacity = size;
+    }
+#endif /* CFSTORE_YOTTA_CFG_CFSTORE_SRAM_ADDR */
+    return capacity;
+}
+
 static inline void cfstore_ctx_client_notify(cfstore_ctx_t* ctx, cfstore_client_notify_data_t* data)
 {
     CFSTORE_FENTRYLOG("%s:entered: ctx=%p, ctx->client_callback=%p, ctx->client_context=%p\n", __func__, ctx, ctx->client_callback, ctx->client_context);
@@ -1312,11 +1373,229 @@ static int32_t cfstore_get_next_hkvt(cfstore_area_hkvt_t* prev, cfstore_area_hkv
 }
 
 
+static CFSTORE_INLINE void cfstore_hkvt_dump(cfstore_area_hkvt_t* hkvt, const char* tag);
+
+
 /*
- * Flash support functions
+ * Hash index support functions
  */
 
-static CFSTORE_INLINE void cfstore_hkvt_dump(cfstore_area_hkvt_t* hkvt, const char* tag);
+#ifdef CFSTORE_CONFIG_HASH_INDEX_ENABLED
+
+/* @brief   FNV-1a hash of a key name of len characters */
+static uint32_t cfstore_index_hash(const uint8_t* key_name, size_t len)
+{
+    uint32_t hash = 2166136261UL;
+
+    while(len-- > 0){
+        hash ^= *key_name++;
+        hash *= 16777619UL;
+    }
+    return hash;
+}
+
+
+/* @brief   helper function to mark the index as needing to be rebuilt.
+ *          Call whenever KVs are removed from the area, or the area is
+ *          replaced, without updating the index. */
+static CFSTORE_INLINE void cfstore_index_set_stale(void)
+{
+    cfstore_ctx_get()->index_stale_flag = true;
+}
+
+
+/* @brief   helper function to free the index */
+static void cfstore_index_free(void)
+{
+    cfstore_ctx_t* ctx = cfstore_ctx_get();
+
+    /* the index isnt part of the area so the libc allocator is used directly,
+     * leaving the CFSTORE_REALLOC() memory accounting to the area */
+    free(ctx->index);
+    ctx->index = NULL;
+    ctx->index_len = 0;
+    ctx->index_count = 0;
+    ctx->index_stale_flag = true;
+}
+
+
+/* @brief   helper function to add a KV to the index without rebuilding it */
+static void cfstore_index_add(cfstore_area_hkvt_t* hkvt)
+{
+    uint32_t slot = 0;
+    cfstore_ctx_t* ctx = cfstore_ctx_get();
+
+    slot = cfstore_index_hash(hkvt->key, cfstore_hkvt_get_key_len(hkvt)) & (ctx->index_len - 1);
+    while(ctx->index[slot] != 0){
+        slot = (slot + 1) & (ctx->index_len - 1);
+    }
+    ctx->index[slot] = (uint32_t) (hkvt->head - ctx->area_0_head) + 1;
+    ctx->index_count++;
+}
+
+
+/* @brief   build the index from the KVs in the area, if the area has
+ *          changed since it was last built.
+ *
+ * The index has at least twice as many slots as there are KVs so probe
+ * sequences stay short. A KV being deleted may share its name with a KV
+ * created since, so a name may be present in the index more than once.
+ *
+ * @return  ARM_DRIVER_OK if the index is usable, otherwise
+ *          ARM_CFSTORE_DRIVER_ERROR_OUT_OF_MEMORY in which case the caller
+ *          should fall back to walking the area.
+ */
+static int32_t cfstore_index_update(void)
+{
+    uint8_t* ptr = NULL;
+    uint32_t* index = NULL;
+    uint32_t count = 0;
+    uint32_t len = CFSTORE_INDEX_LEN_MIN;
+    cfstore_area_hkvt_t hkvt;
+    cfstore_ctx_t* ctx = cfstore_ctx_get();
+
+    CFSTORE_FENTRYLOG("%s:entered\n", __func__);
+    if(!ctx->index_stale_flag && ctx->index != NULL){
+        return ARM_DRIVER_OK;
+    }
+    /* count the KVs to size the table */
+    ptr = ctx->area_0_head;
+    while(ptr != NULL && ptr + sizeof(cfstore_area_header_t) <= ctx->area_0_tail){
+        hkvt = cfstore_get_hkvt_from_head_ptr(ptr);
+        if(hkvt.tail > ctx->area_0_tail){
+            CFSTORE_ERRLOG("%s:Error:found invalid hkvt entry in area\n", __func__);
+            break;
+        }
+        count++;
+        ptr = hkvt.tail;
+    }
+    while(len < 2 * count){
+        len <<= 1;
+    }
+    if(len != ctx->index_len){
+        index = (uint32_t*) realloc(ctx->index, len * sizeof(uint32_t));
+        if(index == NULL){
+            CFSTORE_ERRLOG("%s:Error: unable to allocate memory for index (len=%d)\n", __func__, (int) len);
+            cfstore_index_free();
+            return ARM_CFSTORE_DRIVER_ERROR_OUT_OF_MEMORY;
+        }
+        ctx->index = index;
+        ctx->index_len = len;
+    }
+    memset(ctx->index, 0, ctx->index_len * sizeof(uint32_t));
+
+    ptr = ctx->area_0_head;
+    ctx->index_count = 0;
+    while(count-- > 0){
+        hkvt = cfstore_get_hkvt_from_head_ptr(ptr);
+        cfstore_index_add(&hkvt);
+        ptr = hkvt.tail;
+    }
+    ctx->index_stale_flag = false;
+    return ARM_DRIVER_OK;
+}
+
+
+/* @brief   add a KV just appended to the area to the index, or leave the
+ *          index to be rebuilt by the next lookup if the table is full.
+ */
+static void cfstore_index_insert(cfstore_area_hkvt_t* hkvt)
+{
+    cfstore_ctx_t* ctx = cfstore_ctx_get();
+
+    if(ctx->index_stale_flag || ctx->index == NULL || 2 * (ctx->index_count + 1) > ctx->index_len){
+        ctx->index_stale_flag = true;
+        return;
+    }
+    cfstore_index_add(hkvt);
+}
+
+
+/* @brief   update the index for the KVs following head having moved by
+ *          size_diff bytes in the area, as in cfstore_file_update().
+ */
+static void cfstore_index_move(uint8_t* head, int32_t size_diff)
+{
+    uint32_t slot = 0;
+    uint32_t offset = 0;
+    cfstore_ctx_t* ctx = cfstore_ctx_get();
+
+    if(ctx->index_stale_flag || ctx->index == NULL){
+        return;
+    }
+    offset = (uint32_t) (head - ctx->area_0_head) + 1;
+    for(slot = 0; slot < ctx->index_len; slot++){
+        if(ctx->index[slot] > offset){
+            ctx->index[slot] += size_diff;
+        }
+    }
+}
+
+
+/* @brief   helper function to determine whether a query can only match a
+ *          key_name equal to it, and so can be looked up in the index.
+ */
+static CFSTORE_INLINE bool cfstore_index_is_exact_query(const char* key_name_query)
+{
+    return key_name_query[strcspn(key_name_query, CFSTORE_KEY_NAME_QUERY_CHARS_SPECIAL)] == '\0';
+}
+
+
+/* @brief   find the KV named key_name using the index.
+ *
+ * Matches the walk performed by cfstore_find_ex() from the start of the
+ * area: KVs being deleted or not readable by the client are passed over,
+ * and of several KVs with the name the first in the area is returned.
+ *
+ * @note    cfstore_index_update() must have returned ARM_DRIVER_OK.
+ *
+ * @return  ARM_DRIVER_OK if found, otherwise ARM_CFSTORE_DRIVER_ERROR_KEY_NOT_FOUND
+ *          with next zeroed.
+ */
+static int32_t cfstore_index_find(const char* key_name, cfstore_area_hkvt_t* next)
+{
+    size_t len = strlen(key_name);
+    uint32_t slot = 0;
+    uint8_t* found = NULL;
+    cfstore_area_hkvt_t hkvt;
+    cfstore_ctx_t* ctx = cfstore_ctx_get();
+
+    CFSTORE_TP((CFSTORE_TP_FIND|CFSTORE_TP_FENTRY), "%s:entered: key_name=\"%s\"\n", __func__, key_name);
+    cfstore_hkvt_init(next);
+    slot = cfstore_index_hash((const uint8_t*) key_name, len) & (ctx->index_len - 1);
+    while(ctx->index[slot] != 0){
+        hkvt = cfstore_get_hkvt_from_head_ptr(ctx->area_0_head + ctx->index[slot] - 1);
+        if(cfstore_hkvt_get_key_len(&hkvt) == len
+                && memcmp(hkvt.key, key_name, len) == 0
+                && (found == NULL || hkvt.head < found)
+                && !cfstore_hkvt_get_flags_delete(&hkvt)
+                && cfstore_is_kv_client_readable(&hkvt)){
+            found = hkvt.head;
+            *next = hkvt;
+        }
+        slot = (slot + 1) & (ctx->index_len - 1);
+    }
+    if(found == NULL){
+        CFSTORE_TP(CFSTORE_TP_FIND, "%s:No matching KV found\n", __func__);
+        return ARM_CFSTORE_DRIVER_ERROR_KEY_NOT_FOUND;
+    }
+    cfstore_hkvt_dump(next, __func__);
+    return ARM_DRIVER_OK;
+}
+
+#else
+
+static CFSTORE_INLINE void cfstore_index_set_stale(void) { return; }
+static CFSTORE_INLINE void cfstore_index_free(void) { return; }
+static CFSTORE_INLINE void cfstore_index_insert(cfstore_area_hkvt_t* hkvt) { (void) hkvt; return; }
+static CFSTORE_INLINE void cfstore_index_move(uint8_t* head, int32_t size_diff) { (void) head; (void) size_diff; return; }
+
+#endif /* CFSTORE_CONFIG_HASH_INDEX_ENABLED */
+
+
+/*
+ * Flash support functions
+ */
 
 /** @brief  Set the context tail pointer area_0_tail to point to the end of the
  *          last KV in the memory area.
@@ -1352,6 +1631,7 @@ static int32_t cfstore_flash_set_tail(void)
     CFSTORE_FENTRYLOG("%s:entered: \n", __func__);
     CFSTORE_ASSERT(ctx != NULL);
     cfstore_hkvt_init(&hkvt);
+    cfstore_index_set_stale();
 
     /* Check for cases where the tail pointer is already set correctly
      * e.g. where the area is of zero length */
@@ -1403,9 +1683,10 @@ static int32_t cfstore_flash_set_tail(void)
  * as this is computed and added in this function.
  *
  * @param   allocated_size
- * total size in bytes that was allocated (value returned to caller).
+ * total size in bytes of the area (value returned to caller).
  * This may be larger than the requested size due to rounding to align with a
- * flash program unit boundary.
+ * flash program unit boundary. The memory allocated for the area
+ * (area_0_len) may be larger again, to leave room for the area to grow.
  */
 static int32_t cfstore_realloc_ex(ARM_CFSTORE_SIZE size, uint64_t *allocated_size)
 {
@@ -1417,6 +1698,8 @@ static int32_t cfstore_realloc_ex(ARM_CFSTORE_SIZE size, uint64_t *allocated_siz
     cfstore_list_node_t* node;
     cfstore_list_node_t* file_list = &ctx->file_list;
     ARM_CFSTORE_SIZE total_kv_size = size;
+    ARM_CFSTORE_SIZE capacity = 0;
+    ARM_CFSTORE_SIZE old_kv_size = cfstore_ctx_get_kv_total_len();
 
     /* Switch on the size of the sram area to create:
      * - if size > 0 (but may be shrinking) then use REALLOC.
@@ -1438,13 +1721,26 @@ static int32_t cfstore_realloc_ex(ARM_CFSTORE_SIZE size, uint64_t *allocated_siz
             size += (cfstore_ctx_get_program_unit(ctx) - (size % cfstore_ctx_get_program_unit(ctx)));
         }
 
-        ptr = (uint8_t*) CFSTORE_REALLOC((void*) ctx->area_0_head, size);
-        if (ptr == NULL) {
-            if (total_kv_size <= ctx->area_0_len) {
-                /* Size is shrinking so a realloc failure is recoverable.
-                 * Update ptr so it matches the previous head.
-                 */
-                ptr = ctx->area_0_head;
+        /* The memory allocated has room for the area to grow, so the area is only realloc-ed
+         * when it outgrows the memory or shrinks to well under it. */
+        capacity = ctx->area_0_len;
+        ptr = ctx->area_0_head;
+        if(size > ctx->area_0_len || 2 * cfstore_ctx_get_area_capacity(ctx, size) < ctx->area_0_len){
+            capacity = cfstore_ctx_get_area_capacity(ctx, size);
+            ptr = (uint8_t*) CFSTORE_REALLOC((void*) ctx->area_0_head, capacity);
+            if (ptr == NULL && capacity > size) {
+                /* retry without the room to grow */
+                capacity = size;
+                ptr = (uint8_t*) CFSTORE_REALLOC((void*) ctx->area_0_head, capacity);
+            }
+            if (ptr == NULL) {
+                if (total_kv_size <= ctx->area_0_len) {
+                    /* Size is shrinking so a realloc failure is recoverable.
+                     * Update ptr so it matches the previous head.
+                     */
+                    capacity = ctx->area_0_len;
+                    ptr = ctx->area_0_head;
+                }
             }
         }
         if(ptr == NULL){
@@ -1473,16 +1769,21 @@ static int32_t cfstore_realloc_ex(ARM_CFSTORE_SIZE size, uint64_t *allocated_siz
             ctx->area_0_head = ptr;
         }
 
-        /* If the area is growing then zero the new space at the end of the area */
-        len_diff = size - (int32_t) ctx->area_0_len;
+        /* The memory after the last KV is kept zeroed, so when the memory grows zero the new
+         * space at the end, and when the KVs shrink zero the space they no longer use */
+        len_diff = capacity - (int32_t) ctx->area_0_len;
         if(len_diff > 0) {
             memset(ptr + ctx->area_0_len, 0, len_diff);
         }
+        len_diff = (int32_t) old_kv_size - (int32_t) total_kv_size;
+        if(len_diff > 0 && total_kv_size < capacity) {
+            memset(ptr + total_kv_size, 0, len_diff < (int32_t) (capacity - total_kv_size) ? len_diff : capacity - total_kv_size);
+        }
         /* Set area_0_tail to be the memory address after the end of the last KV in the memory area.
          * This is the only place that area_0_tail should be changed, apart from cfstore_flash_set_tail()
          * which is only called when attributes are loaded from flash.
          */
-        ctx->area_0_len = size;
+        ctx->area_0_len = capacity;
         ctx->area_0_tail = ptr + total_kv_size;
         if(allocated_size != NULL) {
             *allocated_size = size;
@@ -1720,6 +2021,7 @@ static int32_t cfstore_fsm_read_on_entry(void* context)
     {
         /* setup the expected blob size for writing */
         ctx->expected_blob_size = ctx->info.sizeofJournaledBlob;
+        cfstore_index_set_stale();
         ret = cfstore_realloc_ex(ctx->expected_blob_size, &ctx->expected_blob_size);
         if(ret < ARM_DRIVER_OK){
             CFSTORE_ERRLOG("%s:Error: cfstore_realloc_ex() failed (ret=%d)\n", __func__, (int) ret);
@@ -2388,6 +2690,7 @@ static int32_t cfstore_delete_ex(cfstore_area_hkvt_t* hkvt)
      *     cfstore_file_t::head pointers i.e. after 1. has been completed.
      */
     memmove(hkvt->head, hkvt->tail, ctx->area_0_tail - hkvt->tail);
+    cfstore_index_set_stale();
     /* zero the deleted KV memory */
     memset(ctx->area_0_tail-kv_size, 0, kv_size);
 
@@ -3140,10 +3443,20 @@ static int32_t cfstore_find_ex(const char* key_name_query, cfstore_area_hkvt_t *
 {
     int32_t ret = ARM_DRIVER_ERROR;
     uint8_t next_key_len;
+    size_t prefix_len = 0;
     char key_name[CFSTORE_KEY_NAME_MAX_LENGTH+1];
     cfstore_ctx_t* ctx = cfstore_ctx_get();
 
     CFSTORE_TP((CFSTORE_TP_FIND|CFSTORE_TP_FENTRY), "%s:entered: key_name_query=\"%s\", prev=%p, next=%p\n", __func__, key_name_query, prev, next);
+#ifdef CFSTORE_CONFIG_HASH_INDEX_ENABLED
+    /* key names are unique apart from KVs being deleted, so a query without
+     * wildcards starting from the beginning of the area is an index lookup */
+    if(prev == NULL && cfstore_index_is_exact_query(key_name_query) && cfstore_index_update() == ARM_DRIVER_OK){
+        return cfstore_index_find(key_name_query, next);
+    }
+#endif /* CFSTORE_CONFIG_HASH_INDEX_ENABLED */
+    /* only key names starting with the literal part of the query can match it */
+    prefix_len = strcspn(key_name_query, CFSTORE_KEY_NAME_QUERY_CHARS_SPECIAL);
     if(prev == NULL){
         ret = cfstore_get_head_hkvt(next);
         /* CFSTORE_TP(CFSTORE_TP_FIND, "%s:next->head=%p, next->key=%p, next->value=%p, next->tail=%p, \n", __func__, next->head, next->key, next->value, next->tail); */
@@ -3203,9 +3516,13 @@ static int32_t cfstore_find_ex(const char* key_name_query, cfstore_area_hkvt_t *
         }
         /* check if this key_name matches the query */
         next_key_len = cfstore_hkvt_get_key_len(next);
-        next_key_len++;
-        cfstore_get_key_name_ex(next, key_name, &next_key_len);
-        ret = cfstore_fnmatch(key_name_query, key_name, 0);
+        if(next_key_len < prefix_len || memcmp(next->key, key_name_query, prefix_len) != 0){
+            ret = CFSTORE_FNM_NOMATCH;
+        } else {
+            next_key_len++;
+            cfstore_get_key_name_ex(next, key_name, &next_key_len);
+            ret = cfstore_fnmatch(key_name_query, key_name, 0);
+        }
         if(ret == 0){
             /* found the entry in the store. return handle */
             CFSTORE_TP(CFSTORE_TP_FIND, "%s:Found matching key (key_name_query = \"%s\", next->key = \"%s\"),next_key_len=%d\n", __func__, key_name_query, key_name, (int) next_key_len);
@@ -3405,6 +3722,7 @@ static int32_t cfstore_recreate(const char* key_name, ARM_CFSTORE_SIZE value_len
     }
     /* hkvt->head, hkvt->key and hkvt->value remain unchanged but hkvt->tail has moved. Update it.*/
     hkvt->tail = hkvt->tail + kv_size_diff;
+    cfstore_index_move(hkvt->head, kv_size_diff);
 
     /* set the new value length in the header */
     cfstore_hkvt_set_value_len(hkvt, value_len);
@@ -3417,6 +3735,10 @@ static int32_t cfstore_recreate(const char* key_name, ARM_CFSTORE_SIZE value_len
 #endif
     ret = ARM_DRIVER_OK;
 out0:
+    if(ret < ARM_DRIVER_OK){
+        /* the KVs may have been moved without the index being updated */
+        cfstore_index_set_stale();
+    }
     return ret;
 }
 
@@ -3542,6 +3864,7 @@ static int32_t cfstore_create(const char* key_name, ARM_CFSTORE_SIZE value_len,
     hdr->perm_other_execute = kdesc->acl.perm_other_execute;
     strncpy((char*)hdr + sizeof(cfstore_area_header_t), key_name, strlen(key_name));
     hkvt = cfstore_get_hkvt_from_head_ptr((uint8_t*) hdr);
+    cfstore_index_insert(&hkvt);
     if(cfstore_flags_is_default(kdesc->flags)){
         /* set as read-only by default default */
         flags.read = true;
@@ -3837,10 +4160,14 @@ static int32_t cfstore_write(ARM_CFSTORE_HANDLE hkey, const char* data, ARM_CFST
     }
     value_len = (ARM_CFSTORE_SIZE) cfstore_hkvt_get_value_len(&hkvt);
     *len = *len < value_len ? *len: value_len;
-    memcpy(hkvt.value + file->wlocation, data, *len);
+    /* rewriting a value with the data it already holds leaves the area clean,
+     * so Flush() doesnt rewrite the flash for it */
+    if(memcmp(hkvt.value + file->wlocation, data, *len) != 0){
+        memcpy(hkvt.value + file->wlocation, data, *len);
+        ctx->area_dirty_flag = true;
+    }
     file->wlocation += *len;
     cfstore_hkvt_dump(&hkvt, __func__);
-    ctx->area_dirty_flag = true;
     ret = *len;
 out0:
     /* Write() always completes synchronously irrespective of flash mode, so indicate to caller */
@@ -4061,6 +4388,7 @@ static int32_t cfstore_uninitialise(void)
             ctx->area_0_tail = NULL;
             ctx->area_0_len = 0;
         }
+        cfstore_index_free();
     }
 out:
     /* notify client */
@@ -33,6 +33,13 @@ static inline uint32_t roundDown_uint32(uint32_t N, uint32_t BOUNDARY) {
 
 #define LCM_OF_ALL_ERASE_UNITS 4096 /* Assume an LCM of erase_units for now. This will be generalized later. */
 
+/* The largest erase issued to the MTD in one call while logging; rounded up to
+ * a multiple of LCM_OF_ALL_ERASE_UNITS. Flash is unavailable to the rest of the
+ * system for the duration of an erase, so smaller slices bound that latency. */
+#ifndef FLASH_JOURNAL_ERASE_SLICE_SIZE
+#define FLASH_JOURNAL_ERASE_SLICE_SIZE LCM_OF_ALL_ERASE_UNITS
+#endif
+
 static const uint32_t SEQUENTIAL_FLASH_JOURNAL_INVALD_NEXT_SEQUENCE_NUMBER = 0xFFFFFFFFUL;
 static const uint32_t SEQUENTIAL_FLASH_JOURNAL_MAGIC                       = 0xCE02102AUL;
 static const uint32_t SEQUENTIAL_FLASH_JOURNAL_VERSION                     = 1;
@@ -130,20 +137,20 @@ typedef struct _SequentialFlashJournal_t {
         struct {
             const uint8_t *blob;           /**< the original buffer holding source data. */
             size_t         sizeofBlob;
+
+            /* The slot is erased as the log-entry grows into it rather than all at
+             * once; only the erase-units holding the head, the logged data, and the
+             * tail are erased, so the cost of a commit scales with the size of the blob. */
+            uint64_t       mtdEraseOffset;  /**< the next Storage offset to be erased; everything in the slot before it has been erased. */
+            SequentialFlashJournalState_t stateAfterErase; /**< the logging state to resume once the erase completes. */
+
+            uint64_t       mtdOffset;       /**< the current Storage offset at which data will be written. */
+            uint64_t       mtdTailOffset;   /**< Storage offset at which the SequentialFlashJournalLogTail_t will be logged for this log-entry. */
+            const uint8_t *dataBeingLogged; /**< temporary pointer aimed at the next data to be logged. */
+            size_t         amountLeftToLog;
             union {
-                struct {
-                    uint64_t mtdEraseOffset;
-                };
-                struct {
-                    uint64_t       mtdOffset;       /**< the current Storage offset at which data will be written. */
-                    uint64_t       mtdTailOffset;   /**< Storage offset at which the SequentialFlashJournalLogTail_t will be logged for this log-entry. */
-                    const uint8_t *dataBeingLogged; /**< temporary pointer aimed at the next data to be logged. */
-                    size_t         amountLeftToLog;
-                    union {
-                        SequentialFlashJournalLogHead_t head;
-                        SequentialFlashJournalLogTail_t tail;
-                    };
-                };
+                SequentialFlashJournalLogHead_t head;
+                SequentialFlashJournalLogTail_t tail;
             };
         } log;
 
@@ -124,6 +124,10 @@ extern "C" {
  *     | |  aligned with program_unit| |    |
  *     | +---------------------------+ |    |
  *     +-------------------------------+    v
+ *
+ * A slot is erased as a log grows into it: only the erase-units holding the
+ * slot head, the logged blob, and the slot tail are erased, so the cost of a
+ * commit scales with the size of the blob rather than with the slot size.
  */
 int32_t               flashJournalStrategySequential_format(ARM_DRIVER_STORAGE      *mtd,
                                                             uint32_t                 numSlots,
@@ -140,6 +144,25 @@ int32_t               flashJournalStrategySequential_log(FlashJournal_t *journal
 int32_t               flashJournalStrategySequential_commit(FlashJournal_t *journal);
 int32_t               flashJournalStrategySequential_reset(FlashJournal_t *journal);
 
+/**
+ * Hook called before each slice of erase issued while logging or committing.
+ *
+ * Flash is unavailable for the duration of an erase; on parts executing in
+ * place from a single bank, that stalls the rest of the system. Erases are
+ * issued in slices of at most FLASH_JOURNAL_ERASE_SLICE_SIZE bytes, and an
+ * application with timing deadlines can override this weak default to return
+ * only once it is safe to erase 'sizeofErase' bytes, e.g. by waiting for an
+ * idle window of its radio. The default returns immediately.
+ *
+ * @note With an MTD executing asynchronously, this is called from the context
+ *     of the MTD's completion callback, which may be an interrupt handler; an
+ *     override must not block in that case.
+ *
+ * @param[in] sizeofErase
+ *              The number of bytes about to be erased.
+ */
+void flashJournalStrategySequential_waitForEraseWindow(uint32_t sizeofErase);
+
 static const FlashJournal_Ops_t FLASH_JOURNAL_STRATEGY_SEQUENTIAL = {
     flashJournalStrategySequential_initialize,
     flashJournalStrategySequential_getInfo,
@@ -298,9 +298,10 @@ int32_t flashJournalStrategySequential_log(FlashJournal_t *_journal, const void
             logBlobIndex = 0;
         }
 
-        /* setup an erase for the slot */
-        journal->log.mtdEraseOffset = SLOT_ADDRESS(journal, logBlobIndex);
-        journal->state              = SEQUENTIAL_JOURNAL_STATE_LOGGING_ERASE; /* start with erasing the log region */
+        /* setup an erase for the head of the slot; the rest is erased as the log grows into it. */
+        journal->log.mtdEraseOffset  = SLOT_ADDRESS(journal, logBlobIndex);
+        journal->log.stateAfterErase = SEQUENTIAL_JOURNAL_STATE_LOGGING_HEAD;
+        journal->state               = SEQUENTIAL_JOURNAL_STATE_LOGGING_ERASE; /* start with erasing the log region */
         journal->prevCommand        = FLASH_JOURNAL_OPCODE_LOG_BLOB;
     } else {
         /* This is a continuation of an ongoing logging sequence. */
@@ -336,8 +337,9 @@ int32_t flashJournalStrategySequential_commit(FlashJournal_t *_journal)
         if (logBlobIndex == journal->numSlots) {
             logBlobIndex = 0;
         }
-        journal->log.mtdEraseOffset = SLOT_ADDRESS(journal, logBlobIndex);
-        journal->state              = SEQUENTIAL_JOURNAL_STATE_LOGGING_ERASE;
+        journal->log.mtdEraseOffset  = SLOT_ADDRESS(journal, logBlobIndex);
+        journal->log.stateAfterErase = SEQUENTIAL_JOURNAL_STATE_LOGGING_HEAD;
+        journal->state               = SEQUENTIAL_JOURNAL_STATE_LOGGING_ERASE;
     }
 
     journal->prevCommand = FLASH_JOURNAL_OPCODE_COMMIT;
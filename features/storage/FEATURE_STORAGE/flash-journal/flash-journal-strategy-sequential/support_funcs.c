@@ -17,12 +17,18 @@
 
 #include "flash-journal-strategy-sequential/flash_journal_crc.h"
 #include "support_funcs.h"
+#include "platform/mbed_toolchain.h"
 #include <string.h>
 #include <stdio.h>
 #include <inttypes.h>
 
 struct FormatInfo_t formatInfoSingleton;
 
+MBED_WEAK void flashJournalStrategySequential_waitForEraseWindow(uint32_t sizeofErase)
+{
+    /* by default, erase as soon as the journal gets to it. */
+}
+
 int32_t mtdGetStartAddr(ARM_DRIVER_STORAGE *mtd, uint64_t *startAddrP)
 {
     ARM_STORAGE_BLOCK mtdBlock;
@@ -390,6 +396,41 @@ int32_t flashJournalStrategySequential_read_progress(void)
     return (journal->read.dataBeingRead - journal->read.blob);
 }
 
+/**
+ * Round a Storage offset within the slots down to the start of its erase-unit.
+ * Slots start and end at boundaries of LCM_OF_ALL_ERASE_UNITS.
+ */
+static uint64_t eraseBoundaryBelow(SequentialFlashJournal_t *journal, uint64_t offset)
+{
+    return SLOT_ADDRESS(journal, 0) + roundDown_uint32(offset - SLOT_ADDRESS(journal, 0), LCM_OF_ALL_ERASE_UNITS);
+}
+
+/**
+ * Round a Storage offset within the slots up to the next erase-unit boundary.
+ */
+static uint64_t eraseBoundaryAbove(SequentialFlashJournal_t *journal, uint64_t offset)
+{
+    return SLOT_ADDRESS(journal, 0) + roundUp_uint32(offset - SLOT_ADDRESS(journal, 0), LCM_OF_ALL_ERASE_UNITS);
+}
+
+/**
+ * Determine the end of the region which needs to be erased before logging can
+ * proceed in a given state: the erase-unit holding the head, or the units
+ * reached by the pending program of the body or the tail.
+ */
+static uint64_t eraseEnd(SequentialFlashJournal_t *journal, uint32_t blobIndexBeingLogged, SequentialFlashJournalState_t state)
+{
+    if (state == SEQUENTIAL_JOURNAL_STATE_LOGGING_HEAD) {
+        return SLOT_ADDRESS(journal, blobIndexBeingLogged) + LCM_OF_ALL_ERASE_UNITS;
+    }
+
+    uint64_t programEnd = journal->log.mtdOffset + journal->log.amountLeftToLog;
+    if (state == SEQUENTIAL_JOURNAL_STATE_LOGGING_BODY) {
+        programEnd -= journal->log.amountLeftToLog % journal->info.program_unit; /* only whole program_units get logged. */
+    }
+    return eraseBoundaryAbove(journal, programEnd);
+}
+
 /**
  * Progress the state machine for the 'log' operation. This method can also be called from an interrupt handler.
  * @return  < JOURNAL_STATUS_OK for error
@@ -415,12 +456,30 @@ int32_t flashJournalStrategySequential_log_progress(void)
     while (true) {
         int32_t rc;
 
+        if ((journal->state == SEQUENTIAL_JOURNAL_STATE_LOGGING_BODY) || (journal->state == SEQUENTIAL_JOURNAL_STATE_LOGGING_TAIL)) {
+            /* erase whatever the next program would reach beyond the region erased so far. */
+            if (eraseEnd(journal, blobIndexBeingLogged, journal->state) > journal->log.mtdEraseOffset) {
+                uint64_t eraseStart = eraseBoundaryBelow(journal, journal->log.mtdOffset);
+                if (eraseStart > journal->log.mtdEraseOffset) {
+                    journal->log.mtdEraseOffset = eraseStart; /* the tail doesn't need the units between the body and itself. */
+                }
+                journal->log.stateAfterErase = journal->state;
+                journal->state               = SEQUENTIAL_JOURNAL_STATE_LOGGING_ERASE;
+            }
+        }
+
         if (journal->state == SEQUENTIAL_JOURNAL_STATE_LOGGING_ERASE) {
-            uint64_t amountLeftToErase = SLOT_ADDRESS(journal, blobIndexBeingLogged + 1) - journal->log.mtdEraseOffset;
+            uint64_t amountLeftToErase = eraseEnd(journal, blobIndexBeingLogged, journal->log.stateAfterErase) - journal->log.mtdEraseOffset;
             // printf("journal state: erasing; offset %lu [size %lu]\n",
             //        (uint32_t)journal->log.eraseOffset, (uint32_t)amountLeftToErase);
             while (amountLeftToErase) {
-                if ((rc = journal->mtd->Erase(journal->log.mtdEraseOffset, amountLeftToErase)) < ARM_DRIVER_OK) {
+                uint32_t sizeofErase = roundUp_uint32(FLASH_JOURNAL_ERASE_SLICE_SIZE, LCM_OF_ALL_ERASE_UNITS);
+                if (amountLeftToErase < sizeofErase) {
+                    sizeofErase = amountLeftToErase;
+                }
+
+                flashJournalStrategySequential_waitForEraseWindow(sizeofErase);
+                if ((rc = journal->mtd->Erase(journal->log.mtdEraseOffset, sizeofErase)) < ARM_DRIVER_OK) {
                     journal->state = SEQUENTIAL_JOURNAL_STATE_INITIALIZED; /* reset state */
                     if (rc == ARM_STORAGE_ERROR_RUNTIME_OR_INTEGRITY_FAILURE) {
                         return JOURNAL_STATUS_STORAGE_RUNTIME_OR_INTEGRITY_FAILURE;
@@ -491,6 +550,12 @@ int32_t flashJournalStrategySequential_log_progress(void)
         /* state transition */
         switch (journal->state) {
             case SEQUENTIAL_JOURNAL_STATE_LOGGING_ERASE:
+                if (journal->log.stateAfterErase != SEQUENTIAL_JOURNAL_STATE_LOGGING_HEAD) {
+                    /* resume programming the body or the tail */
+                    journal->state = journal->log.stateAfterErase;
+                    break;
+                }
+
                 journal->state                   = SEQUENTIAL_JOURNAL_STATE_LOGGING_HEAD;
                 journal->log.mtdOffset           = SLOT_ADDRESS(journal, blobIndexBeingLogged);
                 journal->log.head.version        = SEQUENTIAL_FLASH_JOURNAL_VERSION;
@@ -674,10 +739,15 @@ void mtdHandler(int32_t status, ARM_STORAGE_OPERATION operation)
 
                 activeJournal->log.mtdEraseOffset += status;
 
+                /* an erase may resume a log or a commit which had to extend the erased region. */
+                FlashJournal_OpCode_t opcode = (activeJournal->prevCommand == FLASH_JOURNAL_OPCODE_COMMIT) ?
+                                                   FLASH_JOURNAL_OPCODE_COMMIT : FLASH_JOURNAL_OPCODE_LOG_BLOB;
                 if ((rc = flashJournalStrategySequential_log_progress()) != JOURNAL_STATUS_OK) {
-                    activeJournal->state = SEQUENTIAL_JOURNAL_STATE_INITIALIZED; /* reset state */
+                    if (rc < JOURNAL_STATUS_OK) {
+                        activeJournal->state = SEQUENTIAL_JOURNAL_STATE_INITIALIZED; /* reset state */
+                    }
                     if (activeJournal->callback) {
-                        activeJournal->callback(rc, FLASH_JOURNAL_OPCODE_LOG_BLOB);
+                        activeJournal->callback(rc, opcode);
                     }
                     return;
                 }
@@ -36,6 +36,51 @@ void StorageVolume::setup(uint64_t _addr, uint64_t _size, StorageVolumeManager *
     volumeSize    = _size;
     volumeManager = _volumeManager;
     allocated     = true;
+    readCacheSize = 0;
+    resetStatistics();
+}
+
+/*
+ * Serve a read from the cached unit of storage, first filling the cache with
+ * the unit holding [addr, addr + size) if needed. Returns the number of bytes
+ * read, or ARM_DRIVER_ERROR if the read can't be served from the cache; only
+ * reads falling within a single unit are cached, and only from synchronous
+ * storage.
+ */
+int32_t StorageVolume::readFromCache(uint64_t addr, void *data, uint32_t size)
+{
+#if STORAGE_VOLUME_MANAGER_READ_CACHE_SIZE > 0
+    const uint64_t unitAddr = addr - (addr % STORAGE_VOLUME_MANAGER_READ_CACHE_SIZE);
+    if ((addr + size) > (unitAddr + STORAGE_VOLUME_MANAGER_READ_CACHE_SIZE)) {
+        return ARM_DRIVER_ERROR;
+    }
+
+    if ((readCacheSize == 0) || (readCacheAddr != unitAddr)) {
+        if (volumeManager->getStorageCapabilities().asynchronous_ops) {
+            return ARM_DRIVER_ERROR;
+        }
+
+        uint32_t unitSize = STORAGE_VOLUME_MANAGER_READ_CACHE_SIZE;
+        if ((unitAddr + unitSize) > volumeSize) {
+            unitSize = (uint32_t)(volumeSize - unitAddr);
+        }
+
+        readCacheSize = 0;
+        int32_t rc = volumeManager->getStorage()->ReadData(volumeOffset + unitAddr, readCache, unitSize);
+        if (rc != (int32_t)unitSize) {
+            return ARM_DRIVER_ERROR;
+        }
+        readCacheAddr = unitAddr;
+        readCacheSize = unitSize;
+    } else {
+        statistics.readCacheHits++;
+    }
+
+    memcpy(data, &readCache[addr - unitAddr], size);
+    return size;
+#else
+    return ARM_DRIVER_ERROR;
+#endif
 }
 
 ARM_DRIVER_VERSION StorageVolume::GetVersion(void)
@@ -109,8 +154,16 @@ int32_t StorageVolume::ReadData(uint64_t addr, void *data, uint32_t size)
         return ARM_DRIVER_ERROR_PARAMETER;
     }
 
+    statistics.reads++;
+    statistics.readBytes += size;
+
+    int32_t rc = readFromCache(addr, data, size);
+    if (rc >= ARM_DRIVER_OK) {
+        return rc; /* synchronous completion. */
+    }
+
     volumeManager->activeVolume = this;
-    int32_t rc = volumeManager->getStorage()->ReadData(volumeOffset + addr, data, size);
+    rc = volumeManager->getStorage()->ReadData(volumeOffset + addr, data, size);
     if (rc != ARM_DRIVER_OK) {
         volumeManager->activeVolume = NULL; /* we're certain that there is no more pending asynch. activity */
     }
@@ -130,6 +183,10 @@ int32_t StorageVolume::ProgramData(uint64_t addr, const void *data, uint32_t siz
         return ARM_DRIVER_ERROR_PARAMETER;
     }
 
+    statistics.programs++;
+    statistics.programBytes += size;
+    volumeManager->invalidateReadCaches();
+
     volumeManager->activeVolume = this;
     int32_t rc = volumeManager->getStorage()->ProgramData(volumeOffset + addr, data, size);
     if (rc != ARM_DRIVER_OK) {
@@ -151,6 +208,10 @@ int32_t StorageVolume::Erase(uint64_t addr, uint32_t size)
         return ARM_DRIVER_ERROR_PARAMETER;
     }
 
+    statistics.erases++;
+    statistics.eraseBytes += size;
+    volumeManager->invalidateReadCaches();
+
     volumeManager->activeVolume = this;
     int32_t rc = volumeManager->getStorage()->Erase(volumeOffset + addr, size);
     if (rc != ARM_DRIVER_OK) {
@@ -184,6 +245,10 @@ int32_t StorageVolume::EraseAll(void)
         }
     }
 
+    statistics.erases++;
+    statistics.eraseBytes += (uint32_t)volumeSize;
+    volumeManager->invalidateReadCaches();
+
     volumeManager->activeVolume = this;
     rc = volumeManager->getStorage()->EraseAll();
     if (rc != ARM_DRIVER_OK) {
@@ -24,12 +24,19 @@
 
 #include "storage_abstraction/Driver_Storage.h"
 #include "mbed_toolchain.h"                     /* required for MBED_DEPRECATED_SINCE */
+#include <string.h>
 
 #if !defined(YOTTA_CFG_STORAGE_VOLUME_MANAGER_MAX_VOLUMES)
 #define MAX_VOLUMES 4
 #else
 #define MAX_VOLUMES YOTTA_CFG_STORAGE_VOLUME_MANAGER_MAX_VOLUMES
 #endif
+/* Size in bytes of the per-volume cache of the most recently read unit of
+ * storage; 0 disables the cache. Only synchronous storage is cached. */
+#ifndef STORAGE_VOLUME_MANAGER_READ_CACHE_SIZE
+#define STORAGE_VOLUME_MANAGER_READ_CACHE_SIZE 0
+#endif
+
 /**<
  * A static assert to ensure that the size of SequentialJournal is smaller than
  * FlashJournal_t. The caller will only allocate a FlashJournal_t and expect the
@@ -84,6 +91,21 @@ typedef enum _StorageVolumeManager_Status
     STORAGE_VOLUME_MANAGER_STATUS_ERROR_VOLUME_NOT_ALLOCATED = -12, ///< attempt to operate on an unallocated volume
 } StorageVolumeManager_Status_t;
 
+/**
+ * Counters of the I/O requested through a volume. Byte counts are those
+ * requested; reads served from the read cache don't reach the storage.
+ */
+typedef struct _StorageVolume_Statistics
+{
+    uint32_t reads;          ///< ReadData() requests
+    uint32_t readBytes;      ///< bytes requested by ReadData()
+    uint32_t readCacheHits;  ///< ReadData() requests served from the volume's read cache
+    uint32_t programs;       ///< ProgramData() requests
+    uint32_t programBytes;   ///< bytes requested by ProgramData()
+    uint32_t erases;         ///< Erase() and EraseAll() requests
+    uint32_t eraseBytes;     ///< bytes requested by Erase() and EraseAll()
+} StorageVolume_Statistics_t;
+
 typedef void (*InitializeCallback_t)(int32_t status);
 class StorageVolumeManager; /* forward declaration */
 
@@ -137,6 +159,23 @@ public:
     const ARM_Storage_Callback_t &getCallback(void) const {
         return callback;
     }
+    const StorageVolume_Statistics_t &getStatistics(void) const {
+        return statistics;
+    }
+    void resetStatistics(void) {
+        memset(&statistics, 0, sizeof(statistics));
+    }
+
+    /**
+     * Drop the contents of the read cache; needed whenever the underlying
+     * storage changes.
+     */
+    void invalidateReadCache(void) {
+        readCacheSize = 0;
+    }
+
+private:
+    int32_t readFromCache(uint64_t addr, void *data, uint32_t size);
 
 private:
     bool overlapsWithBlock(const ARM_STORAGE_BLOCK* blockP) const {
@@ -160,6 +199,13 @@ private:
     uint64_t                volumeSize;
     ARM_Storage_Callback_t  callback;
     StorageVolumeManager   *volumeManager;
+
+    StorageVolume_Statistics_t statistics;
+    uint64_t                readCacheAddr; /* volume offset of the cached unit */
+    uint32_t                readCacheSize; /* size of the cached unit; 0 if nothing is cached */
+#if STORAGE_VOLUME_MANAGER_READ_CACHE_SIZE > 0
+    uint8_t                 readCache[STORAGE_VOLUME_MANAGER_READ_CACHE_SIZE];
+#endif
 };
 
 class StorageVolumeManager {
@@ -210,6 +256,16 @@ public:
         return &volumes[index];
     }
 
+    /**
+     * Drop the read caches of all volumes; volumes may overlap, so a change
+     * through one of them may be visible through the others.
+     */
+    void invalidateReadCaches(void) {
+        for (size_t index = 0; index < MAX_VOLUMES; index++) {
+            volumes[index].invalidateReadCache();
+        }
+    }
+
 public:
     static void storageCallback(int32_t status, ARM_STORAGE_OPERATION operation);
 
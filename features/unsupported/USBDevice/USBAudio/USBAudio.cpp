@@ -19,6 +19,7 @@
 #include "stdint.h"
 #include "USBAudio.h"
 #include "USBAudio_Types.h"
+#include "platform/mbed_dcache.h"
 
 
 
@@ -56,6 +57,24 @@ USBAudio::USBAudio(uint32_t frequency_in, uint8_t channel_nb_in, uint32_t freque
 
     volume = 0;
 
+    // stream buffers, in their own cache lines for DMA
+    rx_slot_size = MBED_DCACHE_ROUND_UP(PACKET_SIZE_ISO_IN);
+    tx_slot_size = MBED_DCACHE_ROUND_UP(PACKET_SIZE_ISO_OUT + channel_nb_out*2);
+    rx_slots = NULL;
+    tx_slots = NULL;
+#if USBAUDIO_STREAM_PACKETS
+    rx_slots = (uint8_t *)mbed_dma_alloc(rx_slot_size * USBAUDIO_STREAM_PACKETS);
+    tx_slots = (uint8_t *)mbed_dma_alloc(tx_slot_size * USBAUDIO_STREAM_PACKETS);
+#endif
+    rx_head = 0;
+    rx_tail = 0;
+    tx_head = 0;
+    tx_tail = 0;
+    tx_pending = false;
+    tx_streaming = false;
+    rx_overruns = 0;
+    tx_underruns = 0;
+
     // connect the device
     USBDevice::connect();
 }
@@ -129,6 +148,111 @@ uint32_t USBAudio::readSync(uint8_t *buf)
     return size;
 }
 
+USBAudio::~USBAudio() {
+    disconnect();
+    mbed_dma_free(rx_slots);
+    mbed_dma_free(tx_slots);
+}
+
+const uint8_t * USBAudio::rxPacket(uint32_t * size) {
+#if USBAUDIO_STREAM_PACKETS
+    if ((rx_slots != NULL) && (rx_head != rx_tail)) {
+        // the length and the data were published before the head
+        __DMB();
+        uint32_t i = rx_tail % USBAUDIO_STREAM_PACKETS;
+        *size = rx_length[i];
+        return &rx_slots[i * rx_slot_size];
+    }
+#endif
+    return NULL;
+}
+
+void USBAudio::releaseRxPacket() {
+    if (rx_head != rx_tail) {
+        // done with the packet before its buffer is given back
+        __DMB();
+        rx_tail = rx_tail + 1;
+    }
+}
+
+uint8_t * USBAudio::txPacket() {
+#if USBAUDIO_STREAM_PACKETS
+    if ((tx_slots != NULL) && (tx_head - tx_tail < USBAUDIO_STREAM_PACKETS)) {
+        uint8_t * slot = &tx_slots[(tx_head % USBAUDIO_STREAM_PACKETS) * tx_slot_size];
+        // no dirty line of the buffer may be written back over what a DMA puts there
+        mbed_dcache_clean_invalidate(slot, tx_slot_size);
+        return slot;
+    }
+#endif
+    return NULL;
+}
+
+void USBAudio::queueTxPacket(uint32_t size) {
+#if USBAUDIO_STREAM_PACKETS
+    if ((tx_slots != NULL) && (tx_head - tx_tail < USBAUDIO_STREAM_PACKETS)) {
+        uint32_t i = tx_head % USBAUDIO_STREAM_PACKETS;
+        if (size > PACKET_SIZE_ISO_OUT + channel_nb_out*2) {
+            size = PACKET_SIZE_ISO_OUT + channel_nb_out*2;
+        }
+        mbed_dcache_clean(&tx_slots[i * tx_slot_size], size);
+        tx_length[i] = size;
+        __DMB();
+        tx_head = tx_head + 1;
+    }
+#endif
+}
+
+// Called in ISR context
+bool USBAudio::streamRead(bool nb) {
+#if USBAUDIO_STREAM_PACKETS
+    if ((rx_slots == NULL) || rxDone) {
+        return false;
+    }
+
+    if (rx_head - rx_tail == USBAUDIO_STREAM_PACKETS) {
+        // a packet arrived, but there is no room for it
+        if (!nb) {
+            rx_overruns = rx_overruns + 1;
+        }
+        return false;
+    }
+
+    uint32_t i = rx_head % USBAUDIO_STREAM_PACKETS;
+    uint8_t * slot = &rx_slots[i * rx_slot_size];
+    uint32_t size = 0;
+    bool ok = nb ? USBDevice::readEP_NB(EPISO_OUT, slot, &size, PACKET_SIZE_ISO_IN)
+                 : USBDevice::readEP(EPISO_OUT, slot, &size, PACKET_SIZE_ISO_IN);
+    if (!ok || !size) {
+        return false;
+    }
+
+    // the packet may be handed to DMA in place
+    mbed_dcache_clean(slot, size);
+    rx_length[i] = size;
+    __DMB();
+    rx_head = rx_head + 1;
+    return true;
+#else
+    return false;
+#endif
+}
+
+// Called in ISR context
+void USBAudio::streamWrite() {
+#if USBAUDIO_STREAM_PACKETS
+    if ((tx_slots == NULL) || tx_pending || (tx_head == tx_tail)) {
+        return;
+    }
+
+    // the buffer stays queued until the packet has been sent
+    __DMB();
+    uint32_t i = tx_tail % USBAUDIO_STREAM_PACKETS;
+    tx_pending = true;
+    tx_streaming = true;
+    USBDevice::writeNB(EPISO_IN, &tx_slots[i * tx_slot_size], tx_length[i], PACKET_SIZE_ISO_OUT + channel_nb_out*2);
+#endif
+}
+
 float USBAudio::getVolume() {
     return (mute) ? 0.0 : volume;
 }
@@ -142,7 +266,7 @@ bool USBAudio::EPISO_OUT_callback() {
         available = true;
         buf_stream_in = NULL;
     }
-    else  {
+    else if (!streamRead(false)) {
         if (rxDone)
             rxDone.call();
     }
@@ -154,6 +278,12 @@ bool USBAudio::EPISO_OUT_callback() {
 bool USBAudio::EPISO_IN_callback() {
     interruptIN = true;
     writeIN = true;
+    if (tx_pending) {
+        // the packet of the stream buffers is sent, queue the next one for the next frame
+        tx_tail = tx_tail + 1;
+        tx_pending = false;
+        streamWrite();
+    }
     if (txDone) 
         txDone.call();
     return true;
@@ -175,6 +305,8 @@ void USBAudio::SOF(int frameNumber) {
                     buf_stream_in = NULL;
                 }
             }
+        } else if (streamRead(true)) {
+            readStart(EPISO_OUT, PACKET_SIZE_ISO_IN);
         }
     }
 
@@ -184,8 +316,20 @@ void USBAudio::SOF(int frameNumber) {
             USBDevice::writeNB(EPISO_IN, (uint8_t *)buf_stream_out, PACKET_SIZE_ISO_OUT, PACKET_SIZE_ISO_OUT);
             buf_stream_out = NULL;
         }
+
+        // without IN interrupts, the packet of the last frame has been sent by now
+        if (tx_pending) {
+            tx_tail = tx_tail + 1;
+            tx_pending = false;
+        }
     }
 
+    // start the stream, or account for a frame it had nothing to send in
+    if (!tx_pending && tx_streaming && (tx_head == tx_tail)) {
+        tx_underruns = tx_underruns + 1;
+    }
+    streamWrite();
+
     SOF_handler = true;
 }
 
@@ -600,7 +744,7 @@ uint8_t * USBAudio::configurationDesc() {
         ENDPOINT_DESCRIPTOR_LENGTH + 2,         // bLength
         ENDPOINT_DESCRIPTOR,                    // bDescriptorType
         PHY_TO_DESC(EPISO_IN),                  // bEndpointAddress
-        E_ISOCHRONOUS,                          // bmAttributes
+        E_ISOCHRONOUS | E_ASYNCHRONOUS,         // bmAttributes
         (uint8_t)(LSB(PACKET_SIZE_ISO_OUT+channel_nb_out*2)),                   // wMaxPacketSize
         (uint8_t)(MSB(PACKET_SIZE_ISO_OUT+channel_nb_out*2)),                   // wMaxPacketSize
         0x01,                                   // bInterval
@@ -27,6 +27,13 @@
 #include "USBDevice.h"
 #include "Callback.h"
 
+/* Number of packets buffered in each direction by the stream API, 0 to
+ * leave the buffers out. Each packet takes one millisecond of audio.
+ */
+#ifndef USBAUDIO_STREAM_PACKETS
+#define USBAUDIO_STREAM_PACKETS 4
+#endif
+
 /**
 * USBAudio example
 *
@@ -65,6 +72,41 @@
 *    }
 * }
 * @endcode
+*
+* Stream API
+*
+* Instead of read and write, which wait for the frame of each packet, the
+* stream API lets the USB interrupt exchange packets with buffers of
+* USBAUDIO_STREAM_PACKETS packets in each direction, so a thread that is
+* held up for a few milliseconds does not lose audio. Nothing is called
+* back: rxPacket returns the oldest packet received, in place in its
+* buffer, and txPacket a buffer to fill for queueTxPacket. The buffers are
+* cache line aligned, so they can be handed to DMA, e.g. of an I2S
+* peripheral, in place. Packets are received into the stream buffers while
+* no read is waiting and no Rx handler is attached. Do not mix write or
+* writeSync with queueTxPacket.
+*
+* The microphone endpoint is asynchronous: a packet may carry one sample per
+* channel more or less than the nominal packet length, for the packets to
+* follow the clock of the samples rather than the clock of the USB frames.
+*
+* @code
+* USBAudio audio(48000, 2, 48000, 2);
+*
+* int main() {
+*    while (1) {
+*        uint32_t size;
+*        const uint8_t *in = audio.rxPacket(&size);
+*        uint8_t *out = audio.txPacket();
+*        if (in && out) {
+*            // loop back what the host plays, as soon as both buffers are ready
+*            memcpy(out, in, size);
+*            audio.releaseRxPacket();
+*            audio.queueTxPacket(size);
+*        }
+*    }
+* }
+* @endcode
 */
 class USBAudio: public USBDevice {
 public:
@@ -82,6 +124,11 @@ public:
     */
     USBAudio(uint32_t frequency_in = 48000, uint8_t channel_nb_in = 1, uint32_t frequency_out = 8000, uint8_t channel_nb_out = 1, uint16_t vendor_id = 0x7bb8, uint16_t product_id = 0x1111, uint16_t product_release = 0x0100);
 
+    /**
+    * Destructor
+    */
+    ~USBAudio();
+
     /**
     * Get current volume between 0.0 and 1.0
     *
@@ -136,6 +183,45 @@ public:
 	 **/
     void writeSync(uint8_t *buf, AudioSampleCorrectType jitter_nb = NoCorrection );
 
+    /**
+    * Get the oldest packet received into the stream buffers. Non blocking
+    *
+    * @param size pointer where will be stored the length of the packet in bytes
+    * @returns pointer on the packet, valid until releaseRxPacket, or NULL if no packet is buffered
+    */
+    const uint8_t * rxPacket(uint32_t * size);
+
+    /**
+    * Free the packet returned by rxPacket for a next packet to be received in
+    */
+    void releaseRxPacket();
+
+    /**
+    * Get the buffer of the next packet to send from the stream buffers. Non blocking
+    *
+    * The buffer holds the nominal packet length plus one sample per channel.
+    *
+    * @returns pointer on the buffer, or NULL if all of them are queued
+    */
+    uint8_t * txPacket();
+
+    /**
+    * Queue the buffer returned by txPacket, to be sent in a next frame
+    *
+    * @param size length of the packet in bytes, at most the nominal length plus one sample per channel
+    */
+    void queueTxPacket(uint32_t size);
+
+    /**
+    * Number of packets received while the stream buffers were full, and dropped
+    */
+    uint32_t rxOverruns() { return rx_overruns; }
+
+    /**
+    * Number of frames in which the stream buffers had no packet to send
+    */
+    uint32_t txUnderruns() { return tx_underruns; }
+
     /**
     * Write and read an audio packet at the same time (on the same frame)
     *
@@ -332,6 +418,33 @@ private:
 
     volatile float volume;
 
+    // receive a packet into the stream buffers, if there is room
+    bool streamRead(bool nb);
+
+    // send the next packet of the stream buffers, if no packet is being sent
+    void streamWrite();
+
+    // stream buffers of packets: received from the host, and to be sent to the host
+    uint8_t * rx_slots;
+    uint8_t * tx_slots;
+    uint32_t rx_slot_size;
+    uint32_t tx_slot_size;
+    volatile uint32_t rx_length[USBAUDIO_STREAM_PACKETS + 1];
+    volatile uint32_t tx_length[USBAUDIO_STREAM_PACKETS + 1];
+
+    // free running counters of the packets: produced (head) and consumed (tail)
+    volatile uint32_t rx_head;
+    volatile uint32_t rx_tail;
+    volatile uint32_t tx_head;
+    volatile uint32_t tx_tail;
+
+    // a packet of the stream buffers is being sent
+    volatile bool tx_pending;
+    // a packet of the stream buffers has been sent, so empty frames are underruns
+    volatile bool tx_streaming;
+
+    volatile uint32_t rx_overruns;
+    volatile uint32_t tx_underruns;
 };
 
 #endif
@@ -68,6 +68,8 @@ USBMSD::USBMSD(uint16_t vendor_id, uint16_t product_id, uint16_t product_release
     memset((void *)&cbw, 0, sizeof(CBW));
     memset((void *)&csw, 0, sizeof(CSW));
     page = NULL;
+    pageBlocks = 0;
+    cacheCount = 0;
 }
 
 USBMSD::~USBMSD() {
@@ -120,8 +122,17 @@ bool USBMSD::connect(bool blocking) {
     if (BlockCount > 0) {
         BlockSize = MemorySize / BlockCount;
         if (BlockSize != 0) {
+            // disk_read and disk_write take at most 255 blocks
+            pageBlocks = USBMSD_BUFFER_BLOCKS;
+            if (pageBlocks > BlockCount)
+                pageBlocks = BlockCount;
+            if (pageBlocks > 255)
+                pageBlocks = 255;
+            if (pageBlocks < 1)
+                pageBlocks = 1;
+            cacheCount = 0;
             free(page);
-            page = (uint8_t *)malloc(BlockSize * sizeof(uint8_t));
+            page = (uint8_t *)malloc(pageBlocks * BlockSize * sizeof(uint8_t));
             if (page == NULL)
                 return false;
         }
@@ -139,10 +150,12 @@ void USBMSD::disconnect() {
     //De-allocate MSD page size:
     free(page);
     page = NULL;
+    cacheCount = 0;
 }
 
 void USBMSD::reset() {
     stage = READ_CBW;
+    cacheCount = 0;
 }
 
 
@@ -151,6 +164,11 @@ bool USBMSD::EPBULK_OUT_callback() {
     uint32_t size = 0;
     uint8_t buf[MAX_PACKET_SIZE_EPBULK];
     readEP(EPBULK_OUT, buf, &size, MAX_PACKET_SIZE_EPBULK);
+
+    //reactivate readings on the OUT bulk endpoint before the packet is
+    //processed, so the next packet is received while blocks are written
+    readStart(EPBULK_OUT, MAX_PACKET_SIZE_EPBULK);
+
     switch (stage) {
             // the device has to decode the CBW received
         case READ_CBW:
@@ -177,9 +195,6 @@ bool USBMSD::EPBULK_OUT_callback() {
             sendCSW();
             break;
     }
-
-    //reactivate readings on the OUT bulk endpoint
-    readStart(EPBULK_OUT, MAX_PACKET_SIZE_EPBULK);
     return true;
 }
 
@@ -225,21 +240,22 @@ void USBMSD::memoryWrite (uint8_t * buf, uint16_t size) {
         stallEndpoint(EPBULK_OUT);
     }
 
-    // we fill an array in RAM of 1 block before writing it in memory
-    for (int i = 0; i < size; i++)
-        page[addr%BlockSize + i] = buf[i];
-
-    // if the array is filled, write it in memory
-    if (!((addr + size)%BlockSize)) {
-        if (!(disk_status() & WRITE_PROTECT)) {
-            disk_write(page, addr/BlockSize, 1);
-        }
-    }
+    // we fill an array in RAM of pageBlocks blocks before writing it in memory
+    memcpy(&page[addr - pageAddr], buf, size);
 
     addr += size;
     length -= size;
     csw.DataResidue -= size;
 
+    // if the array is filled or the transfer ends, write its whole blocks in memory
+    uint32_t filled = addr - pageAddr;
+    if ((filled == pageBlocks*BlockSize) || (!length) || (stage != PROCESS_CBW)) {
+        if ((filled >= (uint32_t)BlockSize) && !(disk_status() & WRITE_PROTECT)) {
+            disk_write(page, pageAddr/BlockSize, filled/BlockSize);
+        }
+        pageAddr = addr;
+    }
+
     if ((!length) || (stage != PROCESS_CBW)) {
         csw.Status = (stage == ERROR) ? CSW_FAILED : CSW_PASSED;
         sendCSW();
@@ -255,13 +271,12 @@ void USBMSD::memoryVerify (uint8_t * buf, uint16_t size) {
         stallEndpoint(EPBULK_OUT);
     }
 
-    // beginning of a new block -> load a whole block in RAM
-    if (!(addr%BlockSize))
-        disk_read(page, addr/BlockSize, 1);
+    // load the blocks from addr in RAM if they are not there
+    uint8_t * data = memoryPage(addr);
 
     // info are in RAM -> no need to re-read memory
     for (n = 0; n < size; n++) {
-        if (page[addr%BlockSize + n] != buf[n]) {
+        if (data[n] != buf[n]) {
             memOK = false;
             break;
         }
@@ -503,12 +518,8 @@ void USBMSD::memoryRead (void) {
         stage = ERROR;
     }
 
-    // we read an entire block
-    if (!(addr%BlockSize))
-        disk_read(page, addr/BlockSize, 1);
-
-    // write data which are in RAM
-    writeNB(EPBULK_IN, &page[addr%BlockSize], n, MAX_PACKET_SIZE_EPBULK);
+    // write data which are in RAM, reading the next blocks ahead if they are not
+    writeNB(EPBULK_IN, memoryPage(addr), n, MAX_PACKET_SIZE_EPBULK);
 
     addr += n;
     length -= n;
@@ -522,6 +533,30 @@ void USBMSD::memoryRead (void) {
 }
 
 
+uint8_t * USBMSD::memoryPage (uint32_t addr) {
+    uint64_t block = addr / BlockSize;
+
+    if ((block < cacheBlock) || (block >= cacheBlock + cacheCount)) {
+        cacheCount = 0;
+        if (block >= BlockCount) {
+            return page;
+        }
+
+        // we read blocks ahead, as many as the page holds
+        uint32_t count = pageBlocks;
+        if (count > BlockCount - block)
+            count = BlockCount - block;
+        if (disk_read(page, block, count)) {
+            return page;
+        }
+        cacheBlock = block;
+        cacheCount = count;
+    }
+
+    return &page[addr - cacheBlock*BlockSize];
+}
+
+
 bool USBMSD::infoTransfer (void) {
     uint32_t n;
 
@@ -546,6 +581,12 @@ bool USBMSD::infoTransfer (void) {
 
     length = n * BlockSize;
 
+    // a write fills the page from the first block on, and the blocks read ahead are stale
+    if ((cbw.CB[0] == WRITE10) || (cbw.CB[0] == WRITE12)) {
+        pageAddr = addr;
+        cacheCount = 0;
+    }
+
     if (!cbw.DataLength) {              // host requests no data
         csw.Status = CSW_FAILED;
         sendCSW();
@@ -27,6 +27,14 @@
 
 #include "USBDevice.h"
 
+/* Number of blocks disk_read and disk_write are called with at most. The
+ * blocks are buffered in RAM, and blocks read ahead are served from there
+ * until the host writes to the disk.
+ */
+#ifndef USBMSD_BUFFER_BLOCKS
+#define USBMSD_BUFFER_BLOCKS 4
+#endif
+
 /**
  * USBMSD class: generic class in order to use all kinds of blocks storage chip
  *
@@ -54,6 +62,11 @@
  * of USBMSD to connect your mass storage device. connect() will first call disk_status() to test the status of the disk.
  * If disk_status() returns 1 (disk not initialized), then disk_initialize() is called. After this step, connect() will collect information
  * such as the number of blocks and the memory size.
+ *
+ * Transfers are served USBMSD_BUFFER_BLOCKS blocks at a time: disk_read is asked for that many blocks ahead,
+ * and disk_write is given the blocks of a transfer once that many have been received or the transfer ends.
+ * Blocks read ahead are kept until the host writes, so a program that writes the memory itself while
+ * connected should disconnect first.
  */
 class USBMSD: public USBDevice {
 public:
@@ -224,8 +237,16 @@ private:
     // memory OK (after a memoryVerify)
     bool memOK;
 
-    // cache in RAM before writing in memory. Useful also to read a block.
+    // cache in RAM of pageBlocks blocks before writing in memory. Useful also to read blocks ahead.
     uint8_t * page;
+    uint32_t pageBlocks;
+
+    // blocks read ahead in the page
+    uint64_t cacheBlock;
+    uint32_t cacheCount;
+
+    // addr of the first byte in the page when writing
+    uint32_t pageAddr;
 
     int BlockSize;
     uint64_t MemorySize;
@@ -244,6 +265,7 @@ private:
     bool requestSense (void);
     void memoryVerify (uint8_t * buf, uint16_t size);
     void memoryWrite (uint8_t * buf, uint16_t size);
+    uint8_t * memoryPage (uint32_t addr);
     void reset();
     void fail();
 };
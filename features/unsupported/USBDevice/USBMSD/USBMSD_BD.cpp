@@ -0,0 +1,75 @@
+/* Copyright (c) 2010-2011 mbed.org, MIT License
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the "Software"), to deal in the Software without
+* restriction, including without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all copies or
+* substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+* BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "USBMSD_BD.h"
+
+#define DISK_OK         0x00
+#define NO_INIT         0x01
+
+
+USBMSD_BD::USBMSD_BD(BlockDevice *bd, uint16_t vendor_id, uint16_t product_id, uint16_t product_release):
+        USBMSD(vendor_id, product_id, product_release), _bd(bd), _initialized(false) {
+}
+
+USBMSD_BD::~USBMSD_BD() {
+    disconnect();
+    if (_initialized) {
+        _bd->deinit();
+    }
+}
+
+bd_size_t USBMSD_BD::blockSize() {
+    bd_size_t size = _bd->get_erase_size();
+    return (size < 512) ? 512 : size;
+}
+
+int USBMSD_BD::disk_initialize() {
+    if (_bd->init()) {
+        return 1;
+    }
+    _initialized = true;
+    return 0;
+}
+
+int USBMSD_BD::disk_status() {
+    return _initialized ? DISK_OK : NO_INIT;
+}
+
+uint64_t USBMSD_BD::disk_sectors() {
+    return _bd->size() / blockSize();
+}
+
+uint64_t USBMSD_BD::disk_size() {
+    return disk_sectors() * blockSize();
+}
+
+int USBMSD_BD::disk_read(uint8_t* data, uint64_t block, uint8_t count) {
+    bd_size_t size = blockSize();
+    return _bd->read(data, block * size, count * size);
+}
+
+int USBMSD_BD::disk_write(const uint8_t* data, uint64_t block, uint8_t count) {
+    bd_size_t size = blockSize();
+    if (_bd->is_erase_required()) {
+        int err = _bd->erase(block * size, count * size);
+        if (err) {
+            return err;
+        }
+    }
+    return _bd->program(data, block * size, count * size);
+}
@@ -0,0 +1,80 @@
+/* Copyright (c) 2010-2011 mbed.org, MIT License
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the "Software"), to deal in the Software without
+* restriction, including without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all copies or
+* substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+* BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef USBMSD_BD_H
+#define USBMSD_BD_H
+
+#include "USBMSD.h"
+#include "BlockDevice.h"
+
+/**
+ * USBMSD_BD class: exposes a BlockDevice over USB as a mass storage device
+ *
+ * Blocks of the disk are erase blocks of the device, at least 512 bytes, so
+ * on an SD card they are its sectors. Writes erase the blocks first where the
+ * device requires it.
+ *
+ * Example:
+ * @code
+ * #include "mbed.h"
+ * #include "HeapBlockDevice.h"
+ * #include "USBMSD_BD.h"
+ *
+ * HeapBlockDevice bd(128*512, 512);
+ * USBMSD_BD msd(&bd);
+ *
+ * int main() {
+ *     msd.connect();
+ *     while (1);
+ * }
+ * @endcode
+ */
+class USBMSD_BD: public USBMSD {
+public:
+
+    /**
+    * Constructor
+    *
+    * @param bd BlockDevice to expose, initialized on connect
+    * @param vendor_id Your vendor_id
+    * @param product_id Your product_id
+    * @param product_release Your preoduct_release
+    */
+    USBMSD_BD(BlockDevice *bd, uint16_t vendor_id = 0x0703, uint16_t product_id = 0x0104, uint16_t product_release = 0x0001);
+
+    /**
+    * Destructor, deinitializes the BlockDevice
+    */
+    ~USBMSD_BD();
+
+protected:
+    virtual int disk_read(uint8_t* data, uint64_t block, uint8_t count);
+    virtual int disk_write(const uint8_t* data, uint64_t block, uint8_t count);
+    virtual int disk_initialize();
+    virtual uint64_t disk_sectors();
+    virtual uint64_t disk_size();
+    virtual int disk_status();
+
+private:
+    bd_size_t blockSize();
+
+    BlockDevice *_bd;
+    bool _initialized;
+};
+
+#endif
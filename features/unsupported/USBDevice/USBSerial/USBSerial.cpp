@@ -17,54 +17,212 @@
 */
 
 #include "stdint.h"
+#include <errno.h>
 #include "USBSerial.h"
+#include "platform/mbed_assert.h"
+#include "platform/mbed_critical.h"
+#include "platform/mbed_poll.h"
+
+// the OUT endpoint is only armed while a whole packet fits in the receive buffer
+MBED_STATIC_ASSERT(USBSERIAL_RXBUF_SIZE >= MAX_PACKET_SIZE_EPBULK,
+        "USBSERIAL_RXBUF_SIZE must hold at least one packet");
 
 int USBSerial::_putc(int c) {
     if (!terminal_connected)
         return 0;
-    send((uint8_t *)&c, 1);
+    uint8_t data = c;
+    write(&data, 1);
     return 1;
 }
 
 int USBSerial::_getc() {
     uint8_t c = 0;
-    while (buf.isEmpty());
-    buf.dequeue(&c);
+    if (read(&c, 1) != 1)
+        return EOF;
     return c;
 }
 
 
 bool USBSerial::writeBlock(uint8_t * buf, uint16_t size) {
-    if(size > MAX_PACKET_SIZE_EPBULK) {
-        return false;
+    return write(buf, size) == size;
+}
+
+
+ssize_t USBSerial::write(const void* buffer, size_t length) {
+    const uint8_t *ptr = static_cast<const uint8_t *>(buffer);
+    size_t written = 0;
+
+    lock();
+    while (written < length) {
+        if (!terminal_connected) {
+            // nobody is listening, drop the data as the host would not read it
+            written = length;
+            break;
+        }
+
+        written += _txbuf.push(ptr + written, length - written);
+
+        core_util_critical_section_enter();
+        txStart();
+        core_util_critical_section_exit();
+
+        if (written < length && !_blocking) {
+            break;
+        }
     }
-    if(!send(buf, size)) {
-        return false;
+    unlock();
+
+    return (written || !length) ? (ssize_t)written : -EAGAIN;
+}
+
+ssize_t USBSerial::read(void* buffer, size_t length) {
+    lock();
+    while (_rxbuf.empty()) {
+        if (!_blocking) {
+            unlock();
+            return -EAGAIN;
+        }
+        // let writers in while we wait for the host
+        unlock();
+        lock();
+    }
+
+    size_t data_read = _rxbuf.pop(static_cast<uint8_t *>(buffer), length);
+    rxResume();
+    unlock();
+
+    return data_read;
+}
+
+int USBSerial::sync() {
+    lock();
+    while (terminal_connected && (!_txbuf.empty() || _tx_active || _tx_zlp));
+    unlock();
+    return 0;
+}
+
+short USBSerial::poll(short events) const {
+    short revents = 0;
+
+    if (!_rxbuf.empty()) {
+        revents |= POLLIN;
+    }
+    if (!_txbuf.full()) {
+        revents |= POLLOUT;
+    }
+
+    return revents;
+}
+
+void USBSerial::sigio(Callback<void()> func) {
+    core_util_critical_section_enter();
+    _sigio_cb = func;
+    if (_sigio_cb) {
+        short current_events = poll(0x7FFF);
+        if (current_events) {
+            _sigio_cb();
+        }
+    }
+    core_util_critical_section_exit();
+}
+
+void USBSerial::wake() {
+    if (_sigio_cb) {
+        _sigio_cb();
+    }
+    poll_change(this);
+}
+
+void USBSerial::lock() {
+    _mutex.lock();
+}
+
+void USBSerial::unlock() {
+    _mutex.unlock();
+}
+
+
+// Called in a critical section or in ISR context
+void USBSerial::txStart() {
+    if (_tx_active || !configured()) {
+        return;
+    }
+
+    // writes that came in while the previous packet was sent are batched
+    // into this one, and a transfer that ends on a full packet is closed by
+    // a zero-length packet
+    bool was_full = _txbuf.full();
+    uint32_t n = _txbuf.pop(_tx_packet, MAX_PACKET_SIZE_EPBULK);
+    if (!n && !_tx_zlp) {
+        return;
+    }
+
+    if (endpointWrite(EPBULK_IN, _tx_packet, n) == EP_PENDING) {
+        _tx_active = true;
+        _tx_zlp = (n == MAX_PACKET_SIZE_EPBULK);
+    }
+
+    if (was_full && !_txbuf.full()) {
+        wake();
     }
-    return true;
 }
 
+// Called in a critical section or in ISR context
+void USBSerial::rxResume() {
+    core_util_critical_section_enter();
+    if (_rx_throttled && _rxbuf.capacity() - _rxbuf.size() >= MAX_PACKET_SIZE_EPBULK) {
+        _rx_throttled = false;
+        readStart(EPBULK_OUT, MAX_PACKET_SIZE_EPBULK);
+    }
+    core_util_critical_section_exit();
+}
 
 
+bool USBSerial::EPBULK_IN_callback() {
+    _tx_active = false;
+    txStart();
+    return true;
+}
+
 bool USBSerial::EPBULK_OUT_callback() {
-    uint8_t c[65];
+    uint8_t c[MAX_PACKET_SIZE_EPBULK];
     uint32_t size = 0;
+    bool was_empty = _rxbuf.empty();
+
+    //we read the packet received and put it on the circular buffer, which
+    //had room for it when the endpoint was armed
+    USBDevice::readEP(EPBULK_OUT, c, &size, MAX_PACKET_SIZE_EPBULK);
+    _rxbuf.push(c, size);
 
-    //we read the packet received and put it on the circular buffer
-    readEP(c, &size);
-    for (uint32_t i = 0; i < size; i++) {
-        buf.queue(c[i]);
+    //reactivate readings if another packet fits, or leave the host NAKed
+    //until read makes room
+    if (_rxbuf.capacity() - _rxbuf.size() >= MAX_PACKET_SIZE_EPBULK) {
+        readStart(EPBULK_OUT, MAX_PACKET_SIZE_EPBULK);
+    } else {
+        _rx_throttled = true;
     }
 
     //call a potential handlenr
     if (rx)
         rx.call();
 
+    if (was_empty && !_rxbuf.empty()) {
+        wake();
+    }
+
     return true;
 }
 
-uint8_t USBSerial::available() {
-    return buf.available();
+void USBSerial::USBCallback_busReset(void) {
+    USBCDC::USBCallback_busReset();
+    // the endpoints are set up again with the configuration
+    _tx_active = false;
+    _tx_zlp = false;
+    _rx_throttled = false;
+}
+
+uint32_t USBSerial::available() {
+    return _rxbuf.size();
 }
 
 bool USBSerial::connected() {
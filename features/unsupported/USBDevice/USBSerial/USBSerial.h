@@ -23,6 +23,20 @@
 #include "Stream.h"
 #include "CircBuffer.h"
 #include "Callback.h"
+#include "PlatformMutex.h"
+#include "SPSCCircularBuffer.h"
+
+/* Sizes of the receive and transmit buffers in bytes. Writes are sent in
+ * full packets from the transmit buffer, and packets are received into the
+ * receive buffer while it has room for one.
+ */
+#ifndef USBSERIAL_RXBUF_SIZE
+#define USBSERIAL_RXBUF_SIZE 256
+#endif
+
+#ifndef USBSERIAL_TXBUF_SIZE
+#define USBSERIAL_TXBUF_SIZE 256
+#endif
 
 /**
 * USBSerial example
@@ -43,6 +57,11 @@
 *    }
 * }
 * @endcode
+*
+* USBSerial is also a FileHandle, like UARTSerial: write queues data in a
+* buffer that is sent in full packets, ended by a short or zero-length
+* packet once the buffer drains, read takes what the host sent, and poll
+* and sigio report when either can go on without blocking.
 */
 class USBSerial: public USBCDC, public Stream {
 public:
@@ -58,6 +77,10 @@ public:
     */
     USBSerial(uint16_t vendor_id = 0x1f00, uint16_t product_id = 0x2012, uint16_t product_release = 0x0001, bool connect_blocking = true): USBCDC(vendor_id, product_id, product_release, connect_blocking){
         settingsChangedCallback = 0;
+        _blocking = true;
+        _tx_active = false;
+        _tx_zlp = false;
+        _rx_throttled = false;
     };
 
 
@@ -81,7 +104,7 @@ public:
     *
     * @returns the number of bytes available
     */
-    uint8_t available();
+    uint32_t available();
 
      /**
     * Check if the terminal is connected.
@@ -109,15 +132,70 @@ public:
     /**
     * Write a block of data.
     *
-    * For more efficiency, a block of size 64 (maximum size of a bulk endpoint) has to be written.
+    * The data is queued with what was written before and sent in full packets.
     *
     * @param buf pointer on data which will be written
-    * @param size size of the buffer. The maximum size of a block is limited by the size of the endpoint (64 bytes)
+    * @param size size of the buffer
     *
     * @returns true if successfull
     */
     bool writeBlock(uint8_t * buf, uint16_t size);
 
+    /** Write the contents of a buffer
+     *
+     *  The data is queued in the transmit buffer. In blocking mode, write
+     *  waits until all of it is queued, otherwise it queues what fits and
+     *  returns -EAGAIN if nothing does. Data written while no terminal is
+     *  connected is dropped.
+     *
+     *  @param buffer   The buffer to write from
+     *  @param length   The number of bytes to write
+     *  @return         The number of bytes written, negative error on failure
+     */
+    virtual ssize_t write(const void* buffer, size_t length);
+
+    /** Read the contents of the receive buffer
+     *
+     *  Follows POSIX semantics: returns what is available, waiting for data
+     *  in blocking mode and returning -EAGAIN otherwise.
+     *
+     *  @param buffer   The buffer to read in to
+     *  @param length   The number of bytes to read
+     *  @return         The number of bytes read, negative error on failure
+     */
+    virtual ssize_t read(void* buffer, size_t length);
+
+    /** Wait until the transmit buffer has been sent
+     *
+     *  @return         0 on success, negative error code on failure
+     */
+    virtual int sync();
+
+    /** Set blocking or non-blocking mode
+     *  The default is blocking.
+     *
+     *  @param blocking true for blocking mode, false for non-blocking mode.
+     */
+    virtual int set_blocking(bool blocking) {
+        _blocking = blocking;
+        return 0;
+    }
+
+    /** Equivalent to POSIX poll(). Derived from FileHandle.
+     *
+     *  POLLIN while there is data to read, POLLOUT while there is room to write.
+     */
+    virtual short poll(short events) const;
+
+    /** Register a callback on state change of the file.
+     *
+     *  The callback is called in interrupt context when data is received
+     *  into an empty buffer and when a full transmit buffer gains room.
+     *
+     *  @param func     Function to call on state change
+     */
+    virtual void sigio(Callback<void()> func);
+
     /**
      *  Attach a member function to call when a packet is received.
      *
@@ -153,6 +231,10 @@ public:
 
 protected:
     virtual bool EPBULK_OUT_callback();
+    virtual bool EPBULK_IN_callback();
+    virtual void USBCallback_busReset(void);
+    virtual void lock();
+    virtual void unlock();
     virtual void lineCodingChanged(int baud, int bits, int parity, int stop){
         if (settingsChangedCallback) {
             settingsChangedCallback(baud, bits, parity, stop);
@@ -160,8 +242,24 @@ protected:
     }
 
 private:
+    /** Send the next packet from the transmit buffer, in a critical section */
+    void txStart();
+
+    /** Arm the OUT endpoint again once the receive buffer has room for a packet */
+    void rxResume();
+
+    void wake();
+
     Callback<void()> rx;
-    CircBuffer<uint8_t,128> buf;
+    Callback<void()> _sigio_cb;
+    SPSCCircularBuffer<uint8_t, USBSERIAL_RXBUF_SIZE> _rxbuf;
+    SPSCCircularBuffer<uint8_t, USBSERIAL_TXBUF_SIZE> _txbuf;
+    uint8_t _tx_packet[MAX_PACKET_SIZE_EPBULK];
+    PlatformMutex _mutex;
+    bool _blocking;
+    volatile bool _tx_active;       // a packet is being sent from _tx_packet
+    volatile bool _tx_zlp;          // the last packet was full, the transfer has to be ended
+    volatile bool _rx_throttled;    // the OUT endpoint waits for room in _rxbuf
     void (*settingsChangedCallback)(int baud, int bits, int parity, int stop);
 };
 
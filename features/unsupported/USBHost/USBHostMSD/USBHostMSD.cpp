@@ -28,6 +28,14 @@
 #define GET_MAX_LUN             (0xFE)
 #define BO_MASS_STORAGE_RESET   (0xFF)
 
+// VPD page of the block limits, SBC-3
+#define VPD_BLOCK_LIMITS        (0xB0)
+
+#if !defined(USBHOST_OTHER)
+// a transfer descriptor covers at most two 4KB pages of memory
+#define MAX_TD_TRANSFER(buf)    (0x2000 - ((uint32_t)(buf) & 0xFFF))
+#endif
+
 USBHostMSD::USBHostMSD()
 {
     host = USBHost::getHostInst();
@@ -45,6 +53,8 @@ void USBHostMSD::init_usb()
     dev_connected = false;
     blockSize = 0;
     blockCount = 0;
+    maxTransferBlocks = USBHOST_MSD_MAX_TRANSFER_BLOCKS;
+    scsiVersion = 0;
     msd_intf = -1;
     msd_device_found = false;
     disk_init = false;
@@ -169,6 +179,8 @@ int USBHostMSD::inquiry(uint8_t lun, uint8_t page_code)
     uint8_t result[36];
     int status = SCSITransfer(cmd, 6, DEVICE_TO_HOST, result, 36);
     if (status == 0) {
+        scsiVersion = result[2];
+
         char vid_pid[17];
         memcpy(vid_pid, &result[8], 8);
         vid_pid[8] = 0;
@@ -185,6 +197,29 @@ int USBHostMSD::inquiry(uint8_t lun, uint8_t page_code)
     return status;
 }
 
+int USBHostMSD::readBlockLimits()
+{
+    // the block limits page is only known to devices of SPC-3 and later
+    maxTransferBlocks = USBHOST_MSD_MAX_TRANSFER_BLOCKS;
+    if (scsiVersion < 5) {
+        return 0;
+    }
+
+    USB_DBG("Read block limits");
+    uint8_t cmd[6] = {0x12, 0x01, VPD_BLOCK_LIMITS, 0, 16, 0};
+    uint8_t result[16];
+    memset(result, 0, sizeof(result));
+    int status = SCSITransfer(cmd, 6, DEVICE_TO_HOST, result, 16);
+    if ((status == 0) && (result[1] == VPD_BLOCK_LIMITS)) {
+        uint32_t max = (result[8] << 24) | (result[9] << 16) | (result[10] << 8) | result[11];
+        if (max && (max < maxTransferBlocks)) {
+            maxTransferBlocks = max;
+        }
+        USB_INFO("MSD [dev: %p] - max transfer length: %u blocks", dev, max);
+    }
+    return status;
+}
+
 int USBHostMSD::checkResult(uint8_t res, USBEndpoint * ep)
 {
     // if ep stalled: send clear feature
@@ -231,17 +266,30 @@ int USBHostMSD::SCSITransfer(uint8_t * cmd, uint8_t cmd_len, int flags, uint8_t
     // data stage if needed
     if (data) {
         USB_DBG("data stage");
-        if (flags == HOST_TO_DEVICE) {
+        for (uint32_t done = 0; done < transfer_len; ) {
+            uint32_t len = transfer_len - done;
+#if !defined(USBHOST_OTHER)
+            if (len > MAX_TD_TRANSFER(data + done)) {
+                len = MAX_TD_TRANSFER(data + done);
+            }
+#endif
+            if (flags == HOST_TO_DEVICE) {
 
-            res = host->bulkWrite(dev, bulk_out, data, transfer_len);
-            if (checkResult(res, bulk_out))
-                return -1;
+                res = host->bulkWrite(dev, bulk_out, data + done, len);
+                if (checkResult(res, bulk_out))
+                    return -1;
 
-        } else if (flags == DEVICE_TO_HOST) {
+            } else if (flags == DEVICE_TO_HOST) {
 
-            res = host->bulkRead(dev, bulk_in, data, transfer_len);
-            if (checkResult(res, bulk_in))
-                return -1;
+                res = host->bulkRead(dev, bulk_in, data + done, len);
+                if (checkResult(res, bulk_in))
+                    return -1;
+            }
+
+            // a stalled endpoint ends the data stage, the CSW tells why
+            if (res == USB_TYPE_STALL_ERROR)
+                break;
+            done += len;
         }
     }
 
@@ -290,7 +338,7 @@ int USBHostMSD::SCSITransfer(uint8_t * cmd, uint8_t cmd_len, int flags, uint8_t
 }
 
 
-int USBHostMSD::dataTransfer(uint8_t * buf, uint32_t block, uint8_t nbBlock, int direction)
+int USBHostMSD::dataTransfer(uint8_t * buf, uint32_t block, uint16_t nbBlock, int direction)
 {
     uint8_t cmd[10];
     memset(cmd,0,10);
@@ -307,6 +355,30 @@ int USBHostMSD::dataTransfer(uint8_t * buf, uint32_t block, uint8_t nbBlock, int
     return SCSITransfer(cmd, 10, direction, buf, blockSize*nbBlock);
 }
 
+int USBHostMSD::blocksTransfer(uint8_t * buf, bd_addr_t addr, bd_size_t size, int direction)
+{
+    uint32_t block_number, count;
+    if (!disk_init) {
+        init();
+    }
+    if (!disk_init) {
+        return -1;
+    }
+    block_number =  addr / blockSize;
+    count = size / blockSize;
+
+    // as many blocks as the device takes in one command
+    while (count) {
+        uint16_t n = (count > maxTransferBlocks) ? maxTransferBlocks : count;
+        if (dataTransfer(buf, block_number, n, direction))
+            return -1;
+        buf += n * blockSize;
+        block_number += n;
+        count -= n;
+    }
+    return 0;
+}
+
 int USBHostMSD::getMaxLun()
 {
     uint8_t buf[1], res;
@@ -333,50 +405,19 @@ int USBHostMSD::init()
     }
 
     inquiry(0, 0);
+    readBlockLimits();
     disk_init = 1;
     return readCapacity();
 }
 
 int USBHostMSD::program(const void *buffer, bd_addr_t addr, bd_size_t size)
 {
-    uint32_t block_number, count;
-    uint8_t *buf = (uint8_t *)buffer;
-    if (!disk_init) {
-        init();
-    }
-    if (!disk_init) {
-        return -1;
-    }
-    block_number =  addr / blockSize;
-    count = size /blockSize;
-
-    for (uint32_t b = block_number; b < block_number + count; b++) {
-        if (dataTransfer(buf, b, 1, HOST_TO_DEVICE))
-            return -1;
-        buf += blockSize;
-    }
-    return 0;
+    return blocksTransfer((uint8_t *)buffer, addr, size, HOST_TO_DEVICE);
 }
 
 int USBHostMSD::read(void *buffer, bd_addr_t addr, bd_size_t size)
 {
-    uint32_t block_number, count;
-    uint8_t *buf = (uint8_t *)buffer;
-    if (!disk_init) {
-        init();
-    }
-    if (!disk_init) {
-        return -1;
-    }
-    block_number =  addr / blockSize;
-    count = size / blockSize;
-
-    for (uint32_t b = block_number; b < block_number + count; b++) {
-        if (dataTransfer(buf, b, 1, DEVICE_TO_HOST))
-            return -1;
-        buf += blockSize;
-    }
-    return 0;
+    return blocksTransfer((uint8_t *)buffer, addr, size, DEVICE_TO_HOST);
 }
 
 int USBHostMSD::erase(bd_addr_t addr, bd_size_t size)
@@ -25,6 +25,14 @@
 #include "FATFileSystem.h"
 #include "BlockDevice.h"
 
+/*
+* Maximum number of blocks read or written by one SCSI command, lowered to
+* the maximum transfer length of the device when it reports one
+*/
+#ifndef USBHOST_MSD_MAX_TRANSFER_BLOCKS
+#define USBHOST_MSD_MAX_TRANSFER_BLOCKS 64
+#endif
+
 /**
  * A class to communicate a USB flash disk
  */
@@ -107,13 +115,17 @@ private:
     int testUnitReady();
     int readCapacity();
     int inquiry(uint8_t lun, uint8_t page_code);
+    int readBlockLimits();
     int SCSIRequestSense();
-    int dataTransfer(uint8_t * buf, uint32_t block, uint8_t nbBlock, int direction);
+    int dataTransfer(uint8_t * buf, uint32_t block, uint16_t nbBlock, int direction);
+    int blocksTransfer(uint8_t * buf, bd_addr_t addr, bd_size_t size, int direction);
     int checkResult(uint8_t res, USBEndpoint * ep);
     int getMaxLun();
 
     int blockSize;
     uint32_t blockCount;
+    uint16_t maxTransferBlocks;
+    uint8_t scsiVersion;
 
     int msd_intf;
     bool msd_device_found;
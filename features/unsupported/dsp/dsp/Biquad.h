@@ -0,0 +1,118 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef BIQUAD_H
+#define BIQUAD_H
+
+#include <stdint.h>
+#include <string.h>
+#include "arm_math.h"
+#include "Stage.h"
+
+namespace dsp {
+
+template<typename T>
+struct BiquadKernel;
+
+template<>
+struct BiquadKernel<float32_t> {
+    typedef arm_biquad_cascade_df2T_instance_f32 instance_t;
+    static const uint8_t coeffs_per_stage = 5;
+    static const uint8_t state_per_stage = 2;
+
+    static void init(instance_t *iir, uint8_t num_stages, const float32_t *coeff, float32_t *state, int8_t post_shift) {
+        (void)post_shift;
+        arm_biquad_cascade_df2T_init_f32(iir, num_stages, (float32_t*)coeff, state);
+    }
+
+    static void run(const instance_t *iir, float32_t *sgn_in, float32_t *sgn_out, uint32_t block_size) {
+        arm_biquad_cascade_df2T_f32(iir, sgn_in, sgn_out, block_size);
+    }
+};
+
+template<>
+struct BiquadKernel<q31_t> {
+    typedef arm_biquad_casd_df1_inst_q31 instance_t;
+    static const uint8_t coeffs_per_stage = 5;
+    static const uint8_t state_per_stage = 4;
+
+    static void init(instance_t *iir, uint8_t num_stages, const q31_t *coeff, q31_t *state, int8_t post_shift) {
+        arm_biquad_cascade_df1_init_q31(iir, num_stages, (q31_t*)coeff, state, post_shift);
+    }
+
+    static void run(const instance_t *iir, q31_t *sgn_in, q31_t *sgn_out, uint32_t block_size) {
+        arm_biquad_cascade_df1_q31(iir, sgn_in, sgn_out, block_size);
+    }
+};
+
+template<>
+struct BiquadKernel<q15_t> {
+    typedef arm_biquad_casd_df1_inst_q15 instance_t;
+    static const uint8_t coeffs_per_stage = 6;
+    static const uint8_t state_per_stage = 4;
+
+    static void init(instance_t *iir, uint8_t num_stages, const q15_t *coeff, q15_t *state, int8_t post_shift) {
+        arm_biquad_cascade_df1_init_q15(iir, num_stages, (q15_t*)coeff, state, post_shift);
+    }
+
+    static void run(const instance_t *iir, q15_t *sgn_in, q15_t *sgn_out, uint32_t block_size) {
+        arm_biquad_cascade_df1_q15(iir, sgn_in, sgn_out, block_size);
+    }
+};
+
+/** IIR filter as a cascade of second order sections.
+ *
+ * Each section takes {b0, b1, b2, a1, a2}, with the feedback coefficients
+ * negated as expected by CMSIS-DSP, and {b0, 0, b1, b2, a1, a2} for
+ * q15_t samples. Fixed point coefficients are scaled down by 2^post_shift
+ * to fit in range. The float32_t filter uses the transposed direct form II
+ * and the fixed point ones the direct form I kernels.
+ */
+template<typename T, uint8_t num_stages, uint32_t block_size=32>
+class Biquad : public Stage<T> {
+public:
+    Biquad(const T *coeff, int8_t post_shift=0) {
+        BiquadKernel<T>::init(&iir, num_stages, coeff, iir_state, post_shift);
+    }
+
+    virtual void process(T *sgn_in, T *sgn_out) {
+        BiquadKernel<T>::run(&iir, sgn_in, sgn_out, block_size);
+    }
+
+    virtual void reset(void) {
+        memset(iir_state, 0, sizeof(iir_state));
+    }
+
+    virtual uint32_t input_length(void) const {
+        return block_size;
+    }
+
+    virtual uint32_t output_length(void) const {
+        return block_size;
+    }
+
+private:
+    typename BiquadKernel<T>::instance_t iir;
+    T iir_state[num_stages * BiquadKernel<T>::state_per_stage];
+};
+
+}
+#endif
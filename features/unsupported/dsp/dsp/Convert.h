@@ -0,0 +1,71 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef CONVERT_H
+#define CONVERT_H
+
+#include <stdint.h>
+#include "arm_math.h"
+
+namespace dsp {
+
+/** Convert AnalogInStream samples to q15_t in place.
+ *
+ * The converter codes are unsigned, centered on 0x8000: flipping the top
+ * bit makes them signed without any other change, so the buffer filled by
+ * DMA is used as is.
+ *
+ * @param samples The samples, as filled by AnalogInStream
+ * @param length  The number of samples
+ * @return The same buffer, as q15_t
+ */
+inline q15_t *adc_to_q15(const uint16_t *samples, uint32_t length) {
+    uint16_t *sgn = const_cast<uint16_t *>(samples);
+    for (uint32_t i = 0; i < length; i++) {
+        sgn[i] ^= 0x8000;
+    }
+    return (q15_t *)sgn;
+}
+
+/** Convert AnalogInStream samples to float32_t, in [-1, 1).
+ *
+ * @param samples The samples, as filled by AnalogInStream. They are
+ *                converted to q15_t in place in the process.
+ * @param sgn_out Buffer of @p length samples
+ * @param length  The number of samples
+ */
+inline void adc_to_f32(const uint16_t *samples, float32_t *sgn_out, uint32_t length) {
+    arm_q15_to_float(adc_to_q15(samples, length), sgn_out, length);
+}
+
+/** Convert AnalogInStream samples to q31_t.
+ *
+ * @param samples The samples, as filled by AnalogInStream. They are
+ *                converted to q15_t in place in the process.
+ * @param sgn_out Buffer of @p length samples
+ * @param length  The number of samples
+ */
+inline void adc_to_q31(const uint16_t *samples, q31_t *sgn_out, uint32_t length) {
+    arm_q15_to_q31(adc_to_q15(samples, length), sgn_out, length);
+}
+
+}
+#endif
@@ -0,0 +1,146 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef FIR_H
+#define FIR_H
+
+#include <stdint.h>
+#include <string.h>
+#include "arm_math.h"
+#include "platform/mbed_assert.h"
+#include "Stage.h"
+
+namespace dsp {
+
+template<typename T, bool fast=false>
+struct FIRKernel;
+
+template<>
+struct FIRKernel<float32_t, false> {
+    typedef arm_fir_instance_f32 instance_t;
+    static const uint16_t min_taps = 1;
+    static const uint16_t taps_multiple = 1;
+
+    static void init(instance_t *fir, uint16_t num_taps, const float32_t *coeff, float32_t *state, uint32_t block_size) {
+        arm_fir_init_f32(fir, num_taps, (float32_t*)coeff, state, block_size);
+    }
+
+    static void run(const instance_t *fir, float32_t *sgn_in, float32_t *sgn_out, uint32_t block_size) {
+        arm_fir_f32(fir, sgn_in, sgn_out, block_size);
+    }
+};
+
+template<>
+struct FIRKernel<float32_t, true> : FIRKernel<float32_t, false> {
+};
+
+template<>
+struct FIRKernel<q31_t, false> {
+    typedef arm_fir_instance_q31 instance_t;
+    static const uint16_t min_taps = 1;
+    static const uint16_t taps_multiple = 1;
+
+    static void init(instance_t *fir, uint16_t num_taps, const q31_t *coeff, q31_t *state, uint32_t block_size) {
+        arm_fir_init_q31(fir, num_taps, (q31_t*)coeff, state, block_size);
+    }
+
+    static void run(const instance_t *fir, q31_t *sgn_in, q31_t *sgn_out, uint32_t block_size) {
+        arm_fir_q31(fir, sgn_in, sgn_out, block_size);
+    }
+};
+
+/* Products are truncated to 2.30 before accumulation */
+template<>
+struct FIRKernel<q31_t, true> : FIRKernel<q31_t, false> {
+    static void run(const instance_t *fir, q31_t *sgn_in, q31_t *sgn_out, uint32_t block_size) {
+        arm_fir_fast_q31(fir, sgn_in, sgn_out, block_size);
+    }
+};
+
+template<>
+struct FIRKernel<q15_t, false> {
+    typedef arm_fir_instance_q15 instance_t;
+    static const uint16_t min_taps = 4;
+    static const uint16_t taps_multiple = 2;
+
+    static void init(instance_t *fir, uint16_t num_taps, const q15_t *coeff, q15_t *state, uint32_t block_size) {
+        arm_fir_init_q15(fir, num_taps, (q15_t*)coeff, state, block_size);
+    }
+
+    static void run(const instance_t *fir, q15_t *sgn_in, q15_t *sgn_out, uint32_t block_size) {
+        arm_fir_q15(fir, sgn_in, sgn_out, block_size);
+    }
+};
+
+/* The accumulator is 2.30, it wraps around without scaled down inputs */
+template<>
+struct FIRKernel<q15_t, true> : FIRKernel<q15_t, false> {
+    static void run(const instance_t *fir, q15_t *sgn_in, q15_t *sgn_out, uint32_t block_size) {
+        arm_fir_fast_q15(fir, sgn_in, sgn_out, block_size);
+    }
+};
+
+/** FIR filter of float32_t, q31_t or q15_t samples.
+ *
+ * The coefficients are in time reversed order, as expected by CMSIS-DSP,
+ * and must stay valid for the lifetime of the filter. The q15_t kernel
+ * needs an even number of taps, at least 4: pad odd filters with a zero.
+ *
+ * The fixed point kernels saturate their output. The q15_t kernel
+ * accumulates in 34.30 format and never wraps around, the q31_t one only
+ * has a guard bit: scale its input down by log2(num_taps) bits to rule out
+ * overflows. With @p fast set, the faster kernels with 32-bit accumulators
+ * are used, and the same scaling applies to q15_t filters. The flag has no
+ * effect on float32_t filters.
+ */
+template<typename T, uint16_t num_taps, uint32_t block_size=32, bool fast=false>
+class FIR : public Stage<T> {
+    MBED_STATIC_ASSERT(num_taps >= FIRKernel<T>::min_taps && (num_taps % FIRKernel<T>::taps_multiple) == 0,
+                       "Number of taps not supported by the kernel");
+
+public:
+    FIR(const T *coeff) {
+        FIRKernel<T, fast>::init(&fir, num_taps, coeff, fir_state, block_size);
+    }
+
+    virtual void process(T *sgn_in, T *sgn_out) {
+        FIRKernel<T, fast>::run(&fir, sgn_in, sgn_out, block_size);
+    }
+
+    virtual void reset(void) {
+        memset(fir_state, 0, sizeof(fir_state));
+    }
+
+    virtual uint32_t input_length(void) const {
+        return block_size;
+    }
+
+    virtual uint32_t output_length(void) const {
+        return block_size;
+    }
+
+private:
+    typename FIRKernel<T, fast>::instance_t fir;
+    T fir_state[block_size + num_taps];
+};
+
+}
+#endif
@@ -0,0 +1,112 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef FIR_DECIMATOR_H
+#define FIR_DECIMATOR_H
+
+#include <stdint.h>
+#include <string.h>
+#include "arm_math.h"
+#include "platform/mbed_assert.h"
+#include "Stage.h"
+
+namespace dsp {
+
+template<typename T>
+struct FIRDecimatorKernel;
+
+template<>
+struct FIRDecimatorKernel<float32_t> {
+    typedef arm_fir_decimate_instance_f32 instance_t;
+
+    static void init(instance_t *fir, uint16_t num_taps, uint8_t factor, const float32_t *coeff, float32_t *state, uint32_t block_size) {
+        arm_fir_decimate_init_f32(fir, num_taps, factor, (float32_t*)coeff, state, block_size);
+    }
+
+    static void run(const instance_t *fir, float32_t *sgn_in, float32_t *sgn_out, uint32_t block_size) {
+        arm_fir_decimate_f32(fir, sgn_in, sgn_out, block_size);
+    }
+};
+
+template<>
+struct FIRDecimatorKernel<q31_t> {
+    typedef arm_fir_decimate_instance_q31 instance_t;
+
+    static void init(instance_t *fir, uint16_t num_taps, uint8_t factor, const q31_t *coeff, q31_t *state, uint32_t block_size) {
+        arm_fir_decimate_init_q31(fir, num_taps, factor, (q31_t*)coeff, state, block_size);
+    }
+
+    static void run(const instance_t *fir, q31_t *sgn_in, q31_t *sgn_out, uint32_t block_size) {
+        arm_fir_decimate_q31(fir, sgn_in, sgn_out, block_size);
+    }
+};
+
+template<>
+struct FIRDecimatorKernel<q15_t> {
+    typedef arm_fir_decimate_instance_q15 instance_t;
+
+    static void init(instance_t *fir, uint16_t num_taps, uint8_t factor, const q15_t *coeff, q15_t *state, uint32_t block_size) {
+        arm_fir_decimate_init_q15(fir, num_taps, factor, (q15_t*)coeff, state, block_size);
+    }
+
+    static void run(const instance_t *fir, q15_t *sgn_in, q15_t *sgn_out, uint32_t block_size) {
+        arm_fir_decimate_q15(fir, sgn_in, sgn_out, block_size);
+    }
+};
+
+/** Anti-aliasing FIR filter keeping one sample out of @p factor.
+ *
+ * Only the kept samples are computed. The coefficients are in time
+ * reversed order, as for FIR.
+ */
+template<typename T, uint16_t num_taps, uint8_t factor, uint32_t block_size=32>
+class FIRDecimator : public Stage<T> {
+    MBED_STATIC_ASSERT(factor > 0 && (block_size % factor) == 0,
+                       "Block size must be a multiple of the decimation factor");
+
+public:
+    FIRDecimator(const T *coeff) {
+        FIRDecimatorKernel<T>::init(&fir, num_taps, factor, coeff, fir_state, block_size);
+    }
+
+    virtual void process(T *sgn_in, T *sgn_out) {
+        FIRDecimatorKernel<T>::run(&fir, sgn_in, sgn_out, block_size);
+    }
+
+    virtual void reset(void) {
+        memset(fir_state, 0, sizeof(fir_state));
+    }
+
+    virtual uint32_t input_length(void) const {
+        return block_size;
+    }
+
+    virtual uint32_t output_length(void) const {
+        return block_size / factor;
+    }
+
+private:
+    typename FIRDecimatorKernel<T>::instance_t fir;
+    T fir_state[block_size + num_taps - 1];
+};
+
+}
+#endif
@@ -24,27 +24,15 @@
 
 #include <stdint.h>
 #include "arm_math.h"
+#include "FIR.h"
 
 namespace dsp {
 
 template<uint16_t num_taps, uint32_t block_size=32>
-class FIR_f32 {
+class FIR_f32 : public FIR<float32_t, num_taps, block_size> {
 public:
-    FIR_f32(const float32_t *coeff) {
-        arm_fir_init_f32(&fir, num_taps, (float32_t*)coeff, fir_state, block_size);
+    FIR_f32(const float32_t *coeff) : FIR<float32_t, num_taps, block_size>(coeff) {
     }
-    
-    void process(float32_t *sgn_in, float32_t *sgn_out) {
-        arm_fir_f32(&fir, sgn_in, sgn_out, block_size);
-    }
-    
-    void reset(void) {
-        memset(fir_state, 0, sizeof(fir_state));
-    }
-
-private:
-    arm_fir_instance_f32 fir;
-    float32_t fir_state[block_size + num_taps - 1];
 };
 
 }
@@ -0,0 +1,105 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <stdint.h>
+#include "Stage.h"
+
+namespace dsp {
+
+/** A chain of stages run in place on one buffer.
+ *
+ * This fits the halves filled by AnalogInStream: once converted with
+ * adc_to_q15() or adc_to_f32(), a half is filtered, decimated and so on
+ * in the memory it arrived in, while DMA fills the other half.
+ *
+ * @code
+ * FIR<q15_t, 32, 256> lowpass(lowpass_coeffs);
+ * FIRDecimator<q15_t, 32, 4, 256> decimator(decimator_coeffs);
+ * Pipeline<q15_t> pipeline;
+ *
+ * pipeline.add(lowpass);
+ * pipeline.add(decimator);
+ *
+ * void filled(int event) {
+ *     q15_t *block = adc_to_q15(adc.half(event), 256);
+ *     uint32_t length = pipeline.process(block); // 64 samples
+ * }
+ * @endcode
+ */
+template<typename T, uint8_t max_stages=4>
+class Pipeline {
+public:
+    Pipeline() : _count(0) {
+    }
+
+    /** Append a stage.
+     *
+     * @param stage The stage, taking the output of the last stage added
+     * @return true, or false if the pipeline is full or the lengths do
+     *         not match
+     */
+    bool add(Stage<T> &stage) {
+        if (_count == max_stages) {
+            return false;
+        }
+        if (_count && _stages[_count - 1]->output_length() != stage.input_length()) {
+            return false;
+        }
+        _stages[_count++] = &stage;
+        return true;
+    }
+
+    /** Run a block through all the stages.
+     *
+     * @param sgn Block of input_length() samples, replaced by the output
+     * @return The number of output samples
+     */
+    uint32_t process(T *sgn) {
+        for (uint8_t i = 0; i < _count; i++) {
+            _stages[i]->process(sgn, sgn);
+        }
+        return output_length();
+    }
+
+    void reset(void) {
+        for (uint8_t i = 0; i < _count; i++) {
+            _stages[i]->reset();
+        }
+    }
+
+    uint32_t input_length(void) const {
+        return _count ? _stages[0]->input_length() : 0;
+    }
+
+    uint32_t output_length(void) const {
+        return _count ? _stages[_count - 1]->output_length() : 0;
+    }
+
+private:
+    Stage<T> *_stages[max_stages];
+    uint8_t _count;
+};
+
+}
+#endif
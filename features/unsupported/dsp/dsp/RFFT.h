@@ -0,0 +1,129 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef RFFT_H
+#define RFFT_H
+
+#include <stdint.h>
+#include <math.h>
+#include "arm_math.h"
+#include "platform/mbed_assert.h"
+
+namespace dsp {
+
+template<typename T>
+struct RFFTKernel;
+
+template<>
+struct RFFTKernel<float32_t> {
+    typedef arm_rfft_fast_instance_f32 instance_t;
+    /* The spectrum is packed: bin 0 and bin fft_len / 2 share the first pair */
+    static const uint32_t spectrum_factor = 1;
+
+    static void init(instance_t *fft, uint16_t fft_len) {
+        arm_rfft_fast_init_f32(fft, fft_len);
+    }
+
+    static void run(instance_t *fft, float32_t *sgn_in, float32_t *spectrum) {
+        arm_rfft_fast_f32(fft, sgn_in, spectrum, 0);
+    }
+
+    static void magnitude(float32_t *spectrum, float32_t *mag, uint32_t bins) {
+        mag[0] = fabsf(spectrum[0]);
+        arm_cmplx_mag_f32(spectrum + 2, mag + 1, bins - 1);
+    }
+};
+
+template<>
+struct RFFTKernel<q31_t> {
+    typedef arm_rfft_instance_q31 instance_t;
+    static const uint32_t spectrum_factor = 2;
+
+    static void init(instance_t *fft, uint16_t fft_len) {
+        arm_rfft_init_q31(fft, fft_len, 0, 1);
+    }
+
+    static void run(instance_t *fft, q31_t *sgn_in, q31_t *spectrum) {
+        arm_rfft_q31(fft, sgn_in, spectrum);
+    }
+
+    static void magnitude(q31_t *spectrum, q31_t *mag, uint32_t bins) {
+        arm_cmplx_mag_q31(spectrum, mag, bins);
+    }
+};
+
+template<>
+struct RFFTKernel<q15_t> {
+    typedef arm_rfft_instance_q15 instance_t;
+    static const uint32_t spectrum_factor = 2;
+
+    static void init(instance_t *fft, uint16_t fft_len) {
+        arm_rfft_init_q15(fft, fft_len, 0, 1);
+    }
+
+    static void run(instance_t *fft, q15_t *sgn_in, q15_t *spectrum) {
+        arm_rfft_q15(fft, sgn_in, spectrum);
+    }
+
+    static void magnitude(q15_t *spectrum, q15_t *mag, uint32_t bins) {
+        arm_cmplx_mag_q15(spectrum, mag, bins);
+    }
+};
+
+/** Forward FFT of real samples, usually the last step after a Pipeline.
+ *
+ * The transform uses the input block as scratch memory, so the spectrum
+ * goes to a separate buffer of spectrum_length samples. Fixed point
+ * spectrums are scaled down by the kernel, by a factor depending on
+ * fft_len (refer to arm_rfft_q15() and arm_rfft_q31()).
+ */
+template<typename T, uint16_t fft_len>
+class RFFT {
+    MBED_STATIC_ASSERT(fft_len >= 32 && fft_len <= 4096 && (fft_len & (fft_len - 1)) == 0,
+                       "FFT length must be a power of 2 from 32 to 4096");
+
+public:
+    /** Number of samples of the spectrum buffer. */
+    static const uint32_t spectrum_length = fft_len * RFFTKernel<T>::spectrum_factor;
+
+    /** Number of magnitude bins, from DC up to below the Nyquist frequency. */
+    static const uint32_t bins = fft_len / 2;
+
+    RFFT() {
+        RFFTKernel<T>::init(&fft, fft_len);
+    }
+
+    /** Compute the spectrum of fft_len samples, which are overwritten. */
+    void process(T *sgn_in, T *spectrum) {
+        RFFTKernel<T>::run(&fft, sgn_in, spectrum);
+    }
+
+    /** Compute the magnitude of the bins of a spectrum. */
+    void magnitude(T *spectrum, T *mag) {
+        RFFTKernel<T>::magnitude(spectrum, mag, bins);
+    }
+
+private:
+    typename RFFTKernel<T>::instance_t fft;
+};
+
+}
+#endif
@@ -0,0 +1,60 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "Sine_q15.h"
+
+/* arm_sin_q15() takes the phase in 15 bits */
+#define PHASE_SHIFT     17
+
+namespace dsp {
+
+Sine_q15::Sine_q15(uint32_t frequency, uint32_t sample_rate, q15_t amplitude, q15_t phase, uint32_t block_size) {
+    _dx = (uint32_t)(((uint64_t)frequency << 32) / sample_rate);
+    _amplitude = amplitude;
+    _x = (uint32_t)phase << PHASE_SHIFT;
+    _block_size = block_size;
+}
+
+q15_t Sine_q15::sample(void) {
+    q31_t value = ((q31_t)_amplitude * arm_sin_q15((q15_t)(_x >> PHASE_SHIFT))) >> 15;
+    _x += _dx;
+    return clip_q31_to_q15(value);
+}
+
+void Sine_q15::process(q15_t *sgn_in, q15_t *sgn_out) {
+    for (uint32_t i=0; i<_block_size; i++) {
+        *sgn_out = clip_q31_to_q15((q31_t)*sgn_in + sample());
+        sgn_in++; sgn_out++;
+    }
+}
+
+void Sine_q15::generate(q15_t *sgn) {
+    for (uint32_t i=0; i<_block_size; i++) {
+        *sgn = sample();
+        sgn++;
+    }
+}
+
+void Sine_q15::reset(void) {
+    _x = 0;
+}
+
+}
@@ -0,0 +1,56 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef SINE_Q15_H
+#define SINE_Q15_H 
+
+#include <stdint.h>
+#include "arm_math.h"
+
+namespace dsp {
+
+/** Fixed point counterpart of Sine_f32, for targets without an FPU.
+ *
+ * The phase is a fraction of a period, as taken by arm_sin_q15(), and is
+ * accumulated on 32 bits so that low frequencies do not drift. process()
+ * saturates the sum of the input and the sine.
+ */
+class Sine_q15 {
+public:
+    Sine_q15(uint32_t frequency, uint32_t sample_rate=48000, q15_t amplitude=0x7FFF, q15_t phase=0, uint32_t block_size=32);
+    
+    void process(q15_t *sgn_in, q15_t *sgn_out);
+    
+    void generate(q15_t *sgn);
+    
+    void reset(void);
+
+private:
+    q15_t sample(void);
+
+    uint32_t _dx;
+    q15_t _amplitude;
+    uint32_t _x;
+    uint32_t _block_size;
+};
+
+}
+#endif
@@ -0,0 +1,50 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef STAGE_H
+#define STAGE_H
+
+#include <stdint.h>
+#include "arm_math.h"
+
+namespace dsp {
+
+/** A block processing step of a Pipeline.
+ *
+ * Each call consumes input_length() samples and produces output_length()
+ * samples. The input and output may be the same buffer.
+ */
+template<typename T>
+class Stage {
+public:
+    virtual ~Stage() {}
+
+    virtual void process(T *sgn_in, T *sgn_out) = 0;
+
+    virtual void reset(void) = 0;
+
+    virtual uint32_t input_length(void) const = 0;
+
+    virtual uint32_t output_length(void) const = 0;
+};
+
+}
+#endif
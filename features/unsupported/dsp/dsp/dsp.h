@@ -25,8 +25,18 @@
 #include "math_helper.h"
 #include "arm_math.h"
 
+#include "Stage.h"
+#include "Pipeline.h"
+#include "Convert.h"
+#include "FIR.h"
 #include "FIR_f32.h"
+#include "FIR_q15.h"
+#include "FIR_q31.h"
+#include "Biquad.h"
+#include "FIRDecimator.h"
+#include "RFFT.h"
 #include "Sine_f32.h"
+#include "Sine_q15.h"
 
 using namespace dsp;
 
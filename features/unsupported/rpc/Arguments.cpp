@@ -25,6 +25,7 @@ Arguments::Arguments(const char* rqs) {
     obj_name = NULL;
     method_name = NULL;
     argc = 0;
+    index = -1;
 
     // This copy can be removed if we can assume the request string is
     // persistent and writable for the duration of the call
@@ -43,15 +44,31 @@ Arguments::Arguments(const char* rqs) {
     p = search_arg(&method_name, p, ' ');
     if (p == NULL) return;
 
-    // Arguments
-    while (true) {
+    parse_args(p);
+}
+
+Arguments::Arguments(const char* args, size_t size) {
+    obj_name = NULL;
+    method_name = NULL;
+    argc = 0;
+    index = -1;
+
+    if (size > RPC_MAX_STRING - 1) {
+        size = RPC_MAX_STRING - 1;
+    }
+    memcpy(request, args, size);
+    request[size] = '\0';
+
+    parse_args(request);
+}
+
+void Arguments::parse_args(char *p) {
+    while (argc < RPC_MAX_ARGS) {
         argv[argc] = NULL;
         p = search_arg(&argv[argc], p, ' ');
         if (argv[argc] != NULL) argc++;
         if (p == NULL) break;
     }
-
-    index = -1;
 }
 
 char* Arguments::search_arg(char **arg, char *p, char next_sep) {
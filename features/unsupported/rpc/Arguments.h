@@ -28,6 +28,11 @@ class Arguments {
 public:
     Arguments(const char* rqs);
 
+    /* Parse only arguments, of a binary RPC frame. obj_name and
+     * method_name are NULL.
+     */
+    Arguments(const char* args, size_t size);
+
     template<typename Arg>
     Arg   getArg(void);
 
@@ -43,6 +48,7 @@ private:
     char  request[RPC_MAX_STRING];
     int index;
     char* search_arg(char **arg, char *p, char next_sep);
+    void parse_args(char *p);
 };
 
 class Reply {
@@ -19,6 +19,44 @@ using namespace std;
 
 namespace mbed {
 
+/* Methods and class functions found by name or hash, indexed by the hash
+ * and the table they were found from. The tables are static, so an entry
+ * stays valid for as long as the program runs. */
+struct rpc_cache_entry {
+    const void *table;
+    const void *entry;
+    const char *name;
+    uint32_t hash;
+};
+
+static rpc_cache_entry rpc_cache[RPC_METHOD_CACHE_SIZE];
+
+static rpc_cache_entry *rpc_cache_slot(const void *table, uint32_t hash) {
+    return &rpc_cache[(hash ^ ((uintptr_t)table >> 2)) & (RPC_METHOD_CACHE_SIZE - 1)];
+}
+
+static bool rpc_cache_match(const rpc_cache_entry *slot, const void *table, uint32_t hash, const char *name) {
+    return slot->table == table && slot->hash == hash && (name == NULL || strcmp(slot->name, name) == 0);
+}
+
+static void rpc_cache_fill(rpc_cache_entry *slot, const void *table, uint32_t hash, const char *name, const void *entry) {
+    slot->table = table;
+    slot->entry = entry;
+    slot->name = name;
+    slot->hash = hash;
+}
+
+static bool rpc_name_match(const char *entry_name, uint32_t hash, const char *name) {
+    if (name != NULL) {
+        return strcmp(entry_name, name) == 0;
+    }
+    return RPC::hash(entry_name) == hash;
+}
+
+static uint32_t rpc_read_le32(const uint8_t *p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
 RPC::RPC(const char *name) {
     _from_construct = false;
     if (name != NULL) {
@@ -31,6 +69,12 @@ RPC::RPC(const char *name) {
     // put this object at head of the list
     _next = _head;
     _head = this;
+
+    // and at the head of its bucket
+    _hash = hash(_name);
+    RPC **bucket = &_buckets[_hash & (RPC_HASH_BUCKETS - 1)];
+    _hash_next = *bucket;
+    *bucket = this;
 }
 
 RPC::~RPC() {
@@ -44,6 +88,13 @@ RPC::~RPC() {
         }
         p->_next = _next;
     }
+
+    // and from its bucket
+    RPC **p = &_buckets[_hash & (RPC_HASH_BUCKETS - 1)];
+    while (*p != this) {
+        p = &(*p)->_hash_next;
+    }
+    *p = _hash_next;
 }
 
 const rpc_method *RPC::get_rpc_methods() {
@@ -54,17 +105,82 @@ const rpc_method *RPC::get_rpc_methods() {
     return methods;
 }
 
+uint32_t RPC::hash(const char *name) {
+    uint32_t h = 2166136261U;
+    while (*name != '\0') {
+        h = (h ^ (uint8_t)*name++) * 16777619U;
+    }
+    return h;
+}
+
 RPC *RPC::lookup(const char *name) {
-    size_t len = strlen(name);
-    for (RPC *p = _head; p != NULL; p = p->_next) {
-        /* Check that p->_name matches name and is the correct length */
-        if (strncmp(p->_name, name, len) == 0 && (strlen(p->_name) == len)) {
+    return lookup(hash(name), name);
+}
+
+/* Look an object up by its hash, and by its name too unless name is NULL */
+RPC *RPC::lookup(uint32_t hash, const char *name) {
+    for (RPC *p = _buckets[hash & (RPC_HASH_BUCKETS - 1)]; p != NULL; p = p->_hash_next) {
+        if (p->_hash == hash && (name == NULL || strcmp(p->_name, name) == 0)) {
             return p;
         }
     }
     return NULL;
 }
 
+const rpc_class *RPC::lookup_class(uint32_t hash, const char *name) {
+    for (rpc_class *c = _classes; c != NULL; c = c->next) {
+        if (c->hash == 0) {
+            c->hash = RPC::hash(c->name);
+        }
+        if (c->hash == hash && (name == NULL || strcmp(c->name, name) == 0)) {
+            return c;
+        }
+    }
+    return NULL;
+}
+
+const rpc_method *RPC::find_method(uint32_t hash, const char *name) {
+    const rpc_method *methods = get_rpc_methods();
+    rpc_cache_entry *slot = rpc_cache_slot(methods, hash);
+    if (rpc_cache_match(slot, methods, hash, name)) {
+        return static_cast<const rpc_method*>(slot->entry);
+    }
+
+    /* Look through the methods, then those of the superclasses */
+    const rpc_method *cur_method = methods;
+    while (true) {
+        for (; cur_method->name != NULL; cur_method++) {
+            if (rpc_name_match(cur_method->name, hash, name)) {
+                rpc_cache_fill(slot, methods, hash, cur_method->name, cur_method);
+                return cur_method;
+            }
+        }
+
+        if (cur_method->super != 0) {
+            cur_method = cur_method->super(this);
+        } else {
+            /* end of methods and no match */
+            return NULL;
+        }
+    }
+}
+
+const rpc_function *RPC::find_function(const rpc_class *c, uint32_t hash, const char *name) {
+    const rpc_function *funcs = c->static_functions;
+    rpc_cache_entry *slot = rpc_cache_slot(funcs, hash);
+    if (rpc_cache_match(slot, funcs, hash, name)) {
+        return static_cast<const rpc_function*>(slot->entry);
+    }
+
+    for (const rpc_function *cur_func = funcs; cur_func->name != NULL; cur_func++) {
+        if (rpc_name_match(cur_func->name, hash, name)) {
+            rpc_cache_fill(slot, funcs, hash, cur_func->name, cur_func);
+            return cur_func;
+        }
+    }
+    return NULL;
+}
+
 void RPC::delete_self() {
     delete[] _name;
     if (_from_construct) {
@@ -102,8 +218,38 @@ rpc_class RPC::_RPC_class = { "RPC", _RPC_funcs, NULL };
 
 RPC *RPC::_head = NULL;
 
+RPC *RPC::_buckets[RPC_HASH_BUCKETS];
+
 rpc_class *RPC::_classes = &_RPC_class;
 
+/* Call the method of an instance, or else the function of a class. The
+ * names in args are checked too, unless they are NULL. */
+bool RPC::dispatch(Arguments *args, Reply *result, uint32_t obj_hash, uint32_t method_hash) {
+    /* First try matching an instance */
+    RPC *p = lookup(obj_hash, args->obj_name);
+    if (p != NULL) {
+        const rpc_method *method = p->find_method(method_hash, args->method_name);
+        if (method == NULL) {
+            return false;
+        }
+        (method->method_caller)(p, args, result);
+        return true;
+    }
+
+    /* Then try a class */
+    const rpc_class *c = lookup_class(obj_hash, args->obj_name);
+    if (c != NULL) {
+        const rpc_function *func = find_function(c, method_hash, args->method_name);
+        if (func == NULL) {
+            return false;
+        }
+        (func->function_caller)(args, result);
+        return true;
+    }
+
+    return false;
+}
+
 bool RPC::call(const char *request, char *reply) {
     if (request == NULL) return false;
 
@@ -121,71 +267,48 @@ bool RPC::call(const char *request, char *reply) {
         return true;
     }
 
-    /* First try matching an instance */
-    RPC *p = lookup(args.obj_name);
+    uint32_t obj_hash = hash(args.obj_name);
+    if (args.method_name != NULL) {
+        return dispatch(&args, &r, obj_hash, hash(args.method_name));
+    }
+
+    /* When there's no method print method names to result */
+    RPC *p = lookup(obj_hash, args.obj_name);
     if (p != NULL) {
-        /* Get the list of methods we support */
         const rpc_method *cur_method = p->get_rpc_methods();
-
-        /* When there's no method print method names to result */
-        if (args.method_name == NULL) {
-            while (true) {
-                for (; cur_method->name != NULL; cur_method++) {
-                    r.putData<const char*>(cur_method->name);
-                }
-
-                /* write_name_arr's args are references, so result and cur_method will have changed */
-                if (cur_method->super != 0) {
-                    cur_method = cur_method->super(p);
-                } else {
-                    return true;
-                }
-            }
-        }
-
-        /* Look through the methods for the one whose name matches */
         while (true) {
             for (; cur_method->name != NULL; cur_method++) {
-                if (strcmp(cur_method->name, args.method_name) == 0) {
-                    (cur_method->method_caller)(p, &args, &r);
-                    return true;
-                }
+                r.putData<const char*>(cur_method->name);
             }
 
+            /* write_name_arr's args are references, so result and cur_method will have changed */
             if (cur_method->super != 0) {
                 cur_method = cur_method->super(p);
             } else {
-                /* end of methods and no match */
-                return false;
+                return true;
             }
-
         }
     }
 
-    /* Then try a class */
-    for (const rpc_class *q = _classes; q != NULL; q = q->next) {
-        if (strcmp(q->name, args.obj_name) == 0) {
-            /* Matched the class name, so get its functions */
-            const rpc_function *cur_func = q->static_functions;
-            if (args.method_name == NULL) {
-                for (; cur_func->name != NULL; cur_func++) {
-                    r.putData<const char*>(cur_func->name);
-                }
-                return true;
-            } else {
-                /* Otherwise call the appropriate function */
-                for (; cur_func->name != NULL; cur_func++) {
-                    if (strcmp(cur_func->name, args.method_name) == 0) {
-                        (cur_func->function_caller)(&args, &r);
-                        return true;
-                    }
-                }
-                return false;
-            }
+    /* or the function names of a class */
+    const rpc_class *c = lookup_class(obj_hash, args.obj_name);
+    if (c != NULL) {
+        for (const rpc_function *cur_func = c->static_functions; cur_func->name != NULL; cur_func++) {
+            r.putData<const char*>(cur_func->name);
         }
+        return true;
     }
 
     return false;
 }
 
+bool RPC::call(const uint8_t *frame, size_t size, char *reply) {
+    if (frame == NULL || size < 8) return false;
+
+    Arguments args(reinterpret_cast<const char*>(frame + 8), size - 8);
+    Reply r(reply);
+
+    return dispatch(&args, &r, rpc_read_le32(frame), rpc_read_le32(frame + 4));
+}
+
 } // namespace mbed
@@ -23,6 +23,22 @@ namespace mbed {
 
 #define RPC_MAX_STRING      128
 
+/* Macro RPC_HASH_BUCKETS
+ *  The number of buckets objects are looked up by the hash of their
+ *  name in, a power of two.
+ */
+#ifndef RPC_HASH_BUCKETS
+#define RPC_HASH_BUCKETS    16
+#endif
+
+/* Macro RPC_METHOD_CACHE_SIZE
+ *  The number of methods and class functions remembered once they are
+ *  found, so they are not searched for by name again, a power of two.
+ */
+#ifndef RPC_METHOD_CACHE_SIZE
+#define RPC_METHOD_CACHE_SIZE   32
+#endif
+
 struct rpc_function {
     const char *name;
     void (*function_caller)(Arguments*, Reply*);
@@ -32,6 +48,7 @@ struct rpc_class {
     const char *name;
     const rpc_function *static_functions;
     struct rpc_class *next;
+    uint32_t hash;      // of name, set on the first lookup
 };
 
 /* Class RPC
@@ -66,6 +83,32 @@ public:
 
     static bool call(const char *buf, char *result);
 
+    /* Function call
+     *  Call a method or class function from a binary frame, which names
+     *  them by hash instead of by name:
+     *
+     *  > object hash, 4 bytes little endian
+     *  > method hash, 4 bytes little endian
+     *  > arguments, as text separated by spaces, not null terminated
+     *
+     *  The result is written as text, as for a text request. There is no
+     *  introspection, and of objects, methods or functions with the same
+     *  hash only the first one found can be called.
+     *
+     * Variables
+     *  frame - the frame.
+     *  size - the size of the frame in bytes.
+     *  result - the result.
+     *  returns - false if the frame is too short or nothing matched.
+     */
+    static bool call(const uint8_t *frame, size_t size, char *result);
+
+    /* Function hash
+     *  Return the hash binary frames name an object, method or class
+     *  function by: the 32 bit FNV-1a hash of the name.
+     */
+    static uint32_t hash(const char *name);
+
     /* Function lookup
      *  Lookup and return the object that has the given name.
      *
@@ -82,10 +125,20 @@ protected:
 
 private:
     static rpc_class *_classes;
+    static RPC *_buckets[RPC_HASH_BUCKETS];
 
     static const rpc_function _RPC_funcs[];
     static rpc_class _RPC_class;
 
+    RPC *_hash_next;
+    uint32_t _hash;
+
+    static RPC *lookup(uint32_t hash, const char *name);
+    static const rpc_class *lookup_class(uint32_t hash, const char *name);
+    const rpc_method *find_method(uint32_t hash, const char *name);
+    static const rpc_function *find_function(const rpc_class *c, uint32_t hash, const char *name);
+    static bool dispatch(Arguments *args, Reply *result, uint32_t obj_hash, uint32_t method_hash);
+
     void delete_self();
     static void list_objs(Arguments *args, Reply *result);
     static void clear(Arguments *args, Reply *result);
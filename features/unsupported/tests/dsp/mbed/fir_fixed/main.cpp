@@ -0,0 +1,133 @@
+#include "mbed.h"
+#include "dsp.h"
+
+#define BLOCK_SIZE              (32)
+#define NUM_BLOCKS              (10)
+#define TEST_LENGTH_SAMPLES     (BLOCK_SIZE * NUM_BLOCKS)
+
+#define SAMPLE_RATE             (48000)
+
+#define SNR_THRESHOLD_Q15       (50.0f)
+#define SNR_THRESHOLD_Q31       (50.0f)
+
+/* Scales the q31_t input down by log2(NUM_TAPS) bits, to rule out overflows */
+#define Q31_SHIFT               (5)
+
+q15_t  expected_q15[TEST_LENGTH_SAMPLES];
+q15_t    output_q15[TEST_LENGTH_SAMPLES];
+q31_t    output_q31[TEST_LENGTH_SAMPLES];
+float32_t expected_output[TEST_LENGTH_SAMPLES];
+float32_t          output[TEST_LENGTH_SAMPLES];
+
+/* FIR Coefficients buffer generated using fir1() MATLAB function: fir1(28, 6/24).
+ * The q15_t kernel needs an even number of taps: a zero is added in front,
+ * where it applies to the oldest sample and leaves the delay unchanged */
+#define NUM_TAPS            30
+const float32_t firCoeffs32[NUM_TAPS] = {
+    +0.0000000000f,
+    -0.0018225230f, -0.0015879294f, +0.0000000000f, +0.0036977508f, +0.0080754303f,
+    +0.0085302217f, -0.0000000000f, -0.0173976984f, -0.0341458607f, -0.0333591565f,
+    +0.0000000000f, +0.0676308395f, +0.1522061835f, +0.2229246956f, +0.2504960933f,
+    +0.2229246956f, +0.1522061835f, +0.0676308395f, +0.0000000000f, -0.0333591565f,
+    -0.0341458607f, -0.0173976984f, -0.0000000000f, +0.0085302217f, +0.0080754303f,
+    +0.0036977508f, +0.0000000000f, -0.0015879294f, -0.0018225230f
+};
+q15_t firCoeffs15[NUM_TAPS];
+q31_t firCoeffs31[NUM_TAPS];
+#define WARMUP    (NUM_TAPS-2)    /* The leading zero tap adds no delay */
+#define DELAY     (WARMUP/2)
+
+static float snr(void) {
+    return arm_snr_f32(&expected_output[DELAY-1], &output[WARMUP-1], TEST_LENGTH_SAMPLES-WARMUP);
+}
+
+static bool test_fir_q15(void) {
+    Sine_q15 sine_1KHz(  1000, SAMPLE_RATE, 0x4000);
+    Sine_q15 sine_15KHz(15000, SAMPLE_RATE, 0x2000);
+    FIR_q15<NUM_TAPS> fir(firCoeffs15);
+
+    q15_t buffer_a[BLOCK_SIZE];
+    q15_t buffer_b[BLOCK_SIZE];
+    for (q15_t *sgn=output_q15; sgn<(output_q15+TEST_LENGTH_SAMPLES); sgn += BLOCK_SIZE) {
+        sine_1KHz.generate(buffer_a);           // Generate a 1KHz sine wave
+        sine_15KHz.process(buffer_a, buffer_b); // Add a 15KHz sine wave
+        fir.process(buffer_b, sgn);             // FIR low pass filter: 6KHz cutoff
+    }
+
+    sine_1KHz.reset();
+    for (q15_t *sgn=expected_q15; sgn<(expected_q15+TEST_LENGTH_SAMPLES); sgn += BLOCK_SIZE) {
+        sine_1KHz.generate(sgn);        // Generate a 1KHz sine wave
+    }
+
+    arm_q15_to_float(expected_q15, expected_output, TEST_LENGTH_SAMPLES);
+    arm_q15_to_float(output_q15, output, TEST_LENGTH_SAMPLES);
+    float snr_q15 = snr();
+    printf("q15 snr: %f\n\r", snr_q15);
+    return snr_q15 >= SNR_THRESHOLD_Q15;
+}
+
+static bool test_fir_q31(void) {
+    Sine_q15 sine_1KHz(  1000, SAMPLE_RATE, 0x4000);
+    Sine_q15 sine_15KHz(15000, SAMPLE_RATE, 0x2000);
+    FIR_q31<NUM_TAPS> fir(firCoeffs31);
+
+    q15_t buffer_a[BLOCK_SIZE];
+    q15_t buffer_b[BLOCK_SIZE];
+    q31_t buffer_c[BLOCK_SIZE];
+    for (q31_t *sgn=output_q31; sgn<(output_q31+TEST_LENGTH_SAMPLES); sgn += BLOCK_SIZE) {
+        sine_1KHz.generate(buffer_a);
+        sine_15KHz.process(buffer_a, buffer_b);
+        arm_q15_to_q31(buffer_b, buffer_c, BLOCK_SIZE);
+        arm_shift_q31(buffer_c, -Q31_SHIFT, buffer_c, BLOCK_SIZE);
+        fir.process(buffer_c, sgn);
+    }
+
+    // The expected signal is the one of the q15_t test
+    arm_shift_q31(output_q31, Q31_SHIFT, output_q31, TEST_LENGTH_SAMPLES);
+    arm_q31_to_float(output_q31, output, TEST_LENGTH_SAMPLES);
+    float snr_q31 = snr();
+    printf("q31 snr: %f\n\r", snr_q31);
+    return snr_q31 >= SNR_THRESHOLD_Q31;
+}
+
+static bool test_sine_q15_saturation(void) {
+    Sine_q15 sine(1000, SAMPLE_RATE, 0x7FFF);
+    Sine_q15 reference(1000, SAMPLE_RATE, 0x7FFF);
+
+    q15_t input[BLOCK_SIZE];
+    q15_t sum[BLOCK_SIZE];
+    q15_t wave[BLOCK_SIZE];
+    for (int i = 0; i < BLOCK_SIZE; i++) {
+        input[i] = (i % 2) ? 0x6000 : -0x6000;
+    }
+
+    // The sum saturates instead of wrapping around
+    for (int block = 0; block < NUM_BLOCKS; block++) {
+        sine.process(input, sum);
+        reference.generate(wave);
+        for (int i = 0; i < BLOCK_SIZE; i++) {
+            q31_t expected = (q31_t)input[i] + wave[i];
+            expected = expected > 0x7FFF ? 0x7FFF : expected < -0x8000 ? -0x8000 : expected;
+            if (sum[i] != expected) {
+                printf("sine sample %d: %d, expected %d\n\r", block * BLOCK_SIZE + i, sum[i], (int)expected);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+int main() {
+    arm_float_to_q15((float32_t *)firCoeffs32, firCoeffs15, NUM_TAPS);
+    arm_float_to_q31((float32_t *)firCoeffs32, firCoeffs31, NUM_TAPS);
+
+    bool q15_ok = test_fir_q15();
+    bool q31_ok = test_fir_q31();
+    bool saturation_ok = test_sine_q15_saturation();
+
+    if (!q15_ok || !q31_ok || !saturation_ok) {
+        printf("Failed\n\r");
+    } else {
+        printf("Success\n\r");
+    }
+}
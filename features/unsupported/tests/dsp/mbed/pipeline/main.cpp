@@ -0,0 +1,161 @@
+#include "mbed.h"
+#include "dsp.h"
+
+#define BLOCK_SIZE              (64)
+#define NUM_BLOCKS              (10)
+#define DECIMATION              (4)
+#define TEST_LENGTH_SAMPLES     (BLOCK_SIZE * NUM_BLOCKS)
+#define OUTPUT_BLOCK_SIZE       (BLOCK_SIZE / DECIMATION)
+#define OUTPUT_LENGTH_SAMPLES   (OUTPUT_BLOCK_SIZE * NUM_BLOCKS)
+
+#define SAMPLE_RATE             (48000)
+
+#define SNR_THRESHOLD_F32       (40.0f)
+#define MAX_ERROR_F32           (1e-5f)
+
+#define FFT_LENGTH              (256)
+#define FFT_BIN                 (16)    /* 3KHz at 48KHz */
+
+float32_t expected_output[TEST_LENGTH_SAMPLES];
+float32_t          output[OUTPUT_LENGTH_SAMPLES];
+float32_t decimated_expected[OUTPUT_LENGTH_SAMPLES];
+
+/* FIR Coefficients buffer generated using fir1() MATLAB function: fir1(28, 6/24) */
+#define NUM_TAPS            29
+const float32_t firCoeffs32[NUM_TAPS] = {
+    -0.0018225230f, -0.0015879294f, +0.0000000000f, +0.0036977508f, +0.0080754303f,
+    +0.0085302217f, -0.0000000000f, -0.0173976984f, -0.0341458607f, -0.0333591565f,
+    +0.0000000000f, +0.0676308395f, +0.1522061835f, +0.2229246956f, +0.2504960933f,
+    +0.2229246956f, +0.1522061835f, +0.0676308395f, +0.0000000000f, -0.0333591565f,
+    -0.0341458607f, -0.0173976984f, -0.0000000000f, +0.0085302217f, +0.0080754303f,
+    +0.0036977508f, +0.0000000000f, -0.0015879294f, -0.0018225230f
+};
+/* Both filters delay the signal by half their length */
+#define WARMUP    (2 * (NUM_TAPS-1))
+#define DELAY     (NUM_TAPS-1)
+
+/* Butterworth low pass, 6KHz cutoff: {b0, b1, b2, -a1, -a2} */
+#define NUM_STAGES          1
+const float32_t biquadCoeffs32[5 * NUM_STAGES] = {
+    0.0976310729f, 0.1952621459f, 0.0976310729f, 0.9428090416f, -0.3333333333f
+};
+
+static bool test_pipeline(void) {
+    Sine_f32 sine_1KHz(  1000, SAMPLE_RATE, 1.0, 0.0, BLOCK_SIZE);
+    Sine_f32 sine_15KHz(15000, SAMPLE_RATE, 0.5, 0.0, BLOCK_SIZE);
+    FIR<float32_t, NUM_TAPS, BLOCK_SIZE> fir(firCoeffs32);
+    FIRDecimator<float32_t, NUM_TAPS, DECIMATION, BLOCK_SIZE> decimator(firCoeffs32);
+    FIR<float32_t, NUM_TAPS, BLOCK_SIZE> mismatched(firCoeffs32);
+    Pipeline<float32_t, 3> pipeline;
+    Pipeline<float32_t, 1> full;
+
+    if (!pipeline.add(fir) || !pipeline.add(decimator)) {
+        printf("add failed\n\r");
+        return false;
+    }
+    if (pipeline.add(mismatched) || pipeline.input_length() != BLOCK_SIZE ||
+            pipeline.output_length() != OUTPUT_BLOCK_SIZE) {
+        printf("pipeline of 2 stages expected\n\r");
+        return false;
+    }
+    if (!full.add(fir) || full.add(fir)) {
+        printf("pipeline of 1 stage expected\n\r");
+        return false;
+    }
+
+    // Each block is filtered and decimated in the memory it was generated in
+    float32_t buffer[BLOCK_SIZE];
+    for (float32_t *sgn=output; sgn<(output+OUTPUT_LENGTH_SAMPLES); sgn += OUTPUT_BLOCK_SIZE) {
+        sine_1KHz.generate(buffer);             // Generate a 1KHz sine wave
+        sine_15KHz.process(buffer, buffer);     // Add a 15KHz sine wave
+        if (pipeline.process(buffer) != OUTPUT_BLOCK_SIZE) {
+            return false;
+        }
+        memcpy(sgn, buffer, sizeof(float32_t) * OUTPUT_BLOCK_SIZE);
+    }
+
+    sine_1KHz.reset();
+    for (float32_t *sgn=expected_output; sgn<(expected_output+TEST_LENGTH_SAMPLES); sgn += BLOCK_SIZE) {
+        sine_1KHz.generate(sgn);        // Generate a 1KHz sine wave
+    }
+    // The decimator keeps the first sample of every DECIMATION
+    for (int i = 0; i < OUTPUT_LENGTH_SAMPLES; i++) {
+        int n = i * DECIMATION - DELAY;
+        decimated_expected[i] = n < 0 ? 0.0f : expected_output[n];
+    }
+
+    int warmup = WARMUP / DECIMATION + 1;
+    float snr = arm_snr_f32(&decimated_expected[warmup], &output[warmup], OUTPUT_LENGTH_SAMPLES - warmup);
+    printf("pipeline snr: %f\n\r", snr);
+    return snr >= SNR_THRESHOLD_F32;
+}
+
+static bool test_biquad(void) {
+    Sine_f32 sine_1KHz(  1000, SAMPLE_RATE, 1.0, 0.0, BLOCK_SIZE);
+    Sine_f32 sine_15KHz(15000, SAMPLE_RATE, 0.5, 0.0, BLOCK_SIZE);
+    Biquad<float32_t, NUM_STAGES, BLOCK_SIZE> biquad(biquadCoeffs32);
+    const float32_t *c = biquadCoeffs32;
+    float32_t x1 = 0, x2 = 0, y1 = 0, y2 = 0;
+
+    // Compare against the difference equation, block after block
+    float32_t buffer[BLOCK_SIZE];
+    float32_t input[BLOCK_SIZE];
+    for (int block = 0; block < NUM_BLOCKS; block++) {
+        sine_1KHz.generate(buffer);
+        sine_15KHz.process(buffer, buffer);
+        memcpy(input, buffer, sizeof(input));
+        biquad.process(buffer, buffer);
+
+        for (int i = 0; i < BLOCK_SIZE; i++) {
+            float32_t y = c[0] * input[i] + c[1] * x1 + c[2] * x2 + c[3] * y1 + c[4] * y2;
+            x2 = x1; x1 = input[i];
+            y2 = y1; y1 = y;
+            if (fabsf(buffer[i] - y) > MAX_ERROR_F32) {
+                printf("biquad sample %d: %f, expected %f\n\r", block * BLOCK_SIZE + i, buffer[i], y);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+template<typename T>
+static bool test_rfft(void (*convert)(float32_t *, T *, uint32_t)) {
+    Sine_f32 sine_3KHz(3000, SAMPLE_RATE, 0.5, 0.0, FFT_LENGTH);
+    RFFT<T, FFT_LENGTH> fft;
+    float32_t wave[FFT_LENGTH];
+    T sgn[FFT_LENGTH];
+    T spectrum[RFFT<T, FFT_LENGTH>::spectrum_length];
+    T mag[RFFT<T, FFT_LENGTH>::bins];
+
+    sine_3KHz.generate(wave);
+    convert(wave, sgn, FFT_LENGTH);
+    fft.process(sgn, spectrum);
+    fft.magnitude(spectrum, mag);
+
+    uint32_t peak = 0;
+    for (uint32_t i = 1; i < RFFT<T, FFT_LENGTH>::bins; i++) {
+        if (mag[i] > mag[peak]) {
+            peak = i;
+        }
+    }
+    printf("rfft peak: %lu\n\r", (unsigned long)peak);
+    return peak == FFT_BIN;
+}
+
+static void copy_f32(float32_t *in, float32_t *out, uint32_t length) {
+    memcpy(out, in, sizeof(float32_t) * length);
+}
+
+int main() {
+    bool pipeline_ok = test_pipeline();
+    bool biquad_ok = test_biquad();
+    bool rfft_f32_ok = test_rfft<float32_t>(copy_f32);
+    bool rfft_q15_ok = test_rfft<q15_t>(arm_float_to_q15);
+
+    if (!pipeline_ok || !biquad_ok || !rfft_f32_ok || !rfft_q15_ok) {
+        printf("Failed\n\r");
+    } else {
+        printf("Success\n\r");
+    }
+}
@@ -22,7 +22,34 @@ bool rpc_test(const char *input, const char *expected) {
     return result;
 }
 
+bool rpc_frame_test(const char *obj, const char *method, const char *args, const char *expected) {
+    uint8_t frame[RPC_MAX_STRING];
+    uint32_t obj_hash = RPC::hash(obj);
+    uint32_t method_hash = RPC::hash(method);
+    for (int i = 0; i < 4; i++) {
+        frame[i] = obj_hash >> (8 * i);
+        frame[4 + i] = method_hash >> (8 * i);
+    }
+    size_t size = strlen(args);
+    memcpy(frame + 8, args, size);
+
+    char outbuf[RPC_MAX_STRING] = {0};
+    bool result = RPC::call(frame, 8 + size, outbuf);
+    printf("RPC frame: %s %s %s -> ", obj, method, args);
+
+    if (result == false) {
+        printf("Procedure call ... [FAIL]\r\n");
+    } else if (strncmp(outbuf, expected, RPC_MAX_STRING) != 0) {
+        printf("'%s' != '%s' ... [FAIL]\r\n", outbuf, expected);
+        result = false;
+    } else {
+        printf("'%s' ... [OK]\r\n", outbuf);
+    }
+    return result;
+}
+
 #define RPC_TEST(INPUT,EXPECTED) result = result && rpc_test(INPUT,EXPECTED); if (result == false) { notify_completion(result); exit(1); }
+#define RPC_FRAME_TEST(OBJ,METHOD,ARGS,EXPECTED) result = result && rpc_frame_test(OBJ,METHOD,ARGS,EXPECTED); if (result == false) { notify_completion(result); exit(1); }
 
 int main() {
     float f = 0;
@@ -58,6 +85,11 @@ int main() {
     RPC_TEST("/DigitalOut", "new");
     RPC_TEST("/led1", "write read delete");
 
+    // Binary frames
+    RPC_FRAME_TEST("f", "write", "2", "");
+    RPC_FRAME_TEST("f", "read", "", "2");
+    RPC_FRAME_TEST("led1", "read", "", "1");
+
     // Delete instance
     RPC_TEST("/led2/delete", "");
     RPC_TEST("/", "led1 foo f DigitalOut RPC");
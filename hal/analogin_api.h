@@ -21,6 +21,11 @@
 
 #include "device.h"
 
+#if DEVICE_ANALOGIN_ASYNCH
+#include <stddef.h>
+#include "hal/dma_api.h"
+#endif
+
 #if DEVICE_ANALOGIN
 
 #ifdef __cplusplus
@@ -60,6 +65,61 @@ uint16_t analogin_read_u16(analogin_t *obj);
 
 /**@}*/
 
+#if DEVICE_ANALOGIN_ASYNCH
+
+/**
+ * \defgroup hal_analogin_stream Analogin streaming hal functions
+ * @{
+ */
+
+/** The first half of the buffer has been filled */
+#define ANALOGIN_EVENT_HALF         (1 << 0)
+/** The second half of the buffer has been filled, conversion continues at the start */
+#define ANALOGIN_EVENT_COMPLETE     (1 << 1)
+/** A half was overwritten before the previous event was handled */
+#define ANALOGIN_EVENT_OVERRUN      (1 << 2)
+#define ANALOGIN_EVENT_ALL          (ANALOGIN_EVENT_HALF | ANALOGIN_EVENT_COMPLETE | ANALOGIN_EVENT_OVERRUN)
+
+/** Start continuous conversion into a circular buffer
+ *
+ * A hardware timer triggers a scan of all channels at sample_rate_hz and
+ * DMA stores the results, one sample per channel in channel order, into
+ * the buffer, wrapping around at its end until analogin_stream_stop is
+ * called. Samples are scaled like analogin_read_u16. The handler is
+ * called when each half of the buffer has been filled.
+ *
+ * All channels must belong to the same converter. This function has a WEAK
+ * implementation returning -1, for targets that only support single reads.
+ *
+ * @param channels       The analogin objects to scan, initialized with analogin_init
+ * @param count          The number of channels
+ * @param buffer         The sample buffer
+ * @param length         The number of samples in the buffer, a multiple of 2 * count
+ * @param sample_rate_hz The number of scans per second
+ * @param handler        The analogin interrupt handler
+ * @param hint           A suggestion for how to use DMA with this stream
+ * @return 0 if conversion started, -1 if the channels, rate or buffer are not supported
+ */
+int analogin_stream_start(analogin_t *const *channels, int count, uint16_t *buffer, size_t length,
+                          uint32_t sample_rate_hz, uint32_t handler, DMAUsage hint);
+
+/** The analogin stream interrupt handler
+ *
+ * @param obj The first channel passed to analogin_stream_start
+ * @return The events that occurred, ANALOGIN_EVENT_*
+ */
+int analogin_stream_irq_handler_asynch(analogin_t *obj);
+
+/** Stop continuous conversion
+ *
+ * @param obj The first channel passed to analogin_stream_start
+ */
+void analogin_stream_stop(analogin_t *obj);
+
+/**@}*/
+
+#endif
+
 #ifdef __cplusplus
 }
 #endif
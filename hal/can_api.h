@@ -75,6 +75,55 @@ unsigned char can_rderror  (can_t *obj);
 unsigned char can_tderror  (can_t *obj);
 void          can_monitor  (can_t *obj, int silent);
 
+/** Get the number of hardware filter banks
+ *
+ * Banks are numbered from 0 like the handles of can_filter. This function
+ * has a WEAK implementation returning 1.
+ *
+ * @param obj The CAN object
+ * @return The number of banks can_filter_bank accepts
+ */
+int           can_filter_banks(can_t *obj);
+
+/** Configure one hardware filter bank
+ *
+ * This function has a WEAK implementation calling can_filter with the bank
+ * as handle.
+ *
+ * @param obj    The CAN object
+ * @param bank   The bank, 0 to can_filter_banks() - 1
+ * @param id     The id to filter on
+ * @param mask   The mask applied to the id
+ * @param format The format to filter on
+ * @return 1 if the bank was configured, 0 otherwise
+ */
+int           can_filter_bank(can_t *obj, int bank, uint32_t id, uint32_t mask, CANFormat format);
+
+/** Read a message with its reception time
+ *
+ * Targets with a timestamping peripheral convert its capture to the us
+ * ticker time base. This function has a WEAK implementation calling
+ * can_read and taking the us ticker time, which is close to the reception
+ * time when called from the RX interrupt.
+ *
+ * @param obj    The CAN object
+ * @param msg    The message, including timestamp, if one was read
+ * @param handle The filter handle, 0 for any message
+ * @return 1 if a message was read, 0 otherwise
+ */
+int           can_read_timestamp(can_t *obj, CAN_Message *msg, int handle);
+
+/** Get the transmission time of the last message sent
+ *
+ * This function has a WEAK implementation returning 0, in which case the
+ * driver takes the us ticker time in the TX interrupt.
+ *
+ * @param obj       The CAN object
+ * @param timestamp The transmission time in us ticker microseconds
+ * @return 1 if the peripheral captured the time, 0 otherwise
+ */
+int           can_tx_timestamp(can_t *obj, uint32_t *timestamp);
+
 #ifdef __cplusplus
 };
 #endif
@@ -63,6 +63,7 @@ struct CAN_Message {
     unsigned char  len;                // Length of data field in bytes
     CANFormat      format;             // Format ::CANFormat
     CANType        type;               // Type ::CANType
+    unsigned int   timestamp;          // Reception time in microseconds, set by can_read_timestamp
 };
 typedef struct CAN_Message CAN_Message;
 
@@ -0,0 +1,90 @@
+/** \addtogroup hal */
+/** @{*/
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MBED_CAPTURE_API_H
+#define MBED_CAPTURE_API_H
+
+#include "device.h"
+
+#if DEVICE_CAPTURE
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Capture edges
+ */
+typedef enum {
+    CAPTURE_RISE = 1,
+    CAPTURE_FALL = 2,
+    CAPTURE_BOTH = 3
+} capture_edge;
+
+/** Capture HAL structure. capture_s is declared in the target's HAL
+ */
+typedef struct capture_s capture_t;
+
+/** Called from the capture interrupt for every captured edge
+ *
+ * The timestamp was latched by the timer when the edge occurred, so it
+ * does not depend on the interrupt latency.
+ */
+typedef void (*capture_irq_handler)(uint32_t id, uint32_t timestamp, capture_edge edge);
+
+/**
+ * \defgroup hal_capture Input capture HAL functions
+ * @{
+ */
+
+/** Initialize a timer capture channel on a pin and start capturing
+ *
+ * Timestamps count at capture_frequency and wrap at 2^32. Targets with
+ * narrower timers extend the count with the timer's overflow interrupt.
+ *
+ * @param obj     The capture object to initialize
+ * @param pin     The pin of a timer capture channel
+ * @param edges   The edges to capture
+ * @param handler The handler called for every captured edge
+ * @param id      The object ID (id != 0, 0 is reserved)
+ * @return 0 if capture started, -1 if the pin has no capture channel
+ */
+int capture_init(capture_t *obj, PinName pin, capture_edge edges, capture_irq_handler handler, uint32_t id);
+
+/** Stop capturing and release the capture channel
+ *
+ * @param obj The capture object
+ */
+void capture_free(capture_t *obj);
+
+/** Get the rate the timestamps count at
+ *
+ * @param obj The capture object
+ * @return The frequency of the timestamps in Hz
+ */
+uint32_t capture_frequency(capture_t *obj);
+
+/**@}*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+#endif
+
+/** @}*/
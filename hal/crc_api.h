@@ -0,0 +1,101 @@
+/** \addtogroup hal */
+/** @{*/
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MBED_CRC_HAL_API_H
+#define MBED_CRC_HAL_API_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "device.h"
+
+/** CRC polynomials with a software table in mbed::MbedCRC, in their normal
+ *  (most significant bit first) representation without the top bit
+ */
+typedef enum crc_polynomial {
+    POLY_OTHER       = 0,
+    POLY_8BIT_CCITT  = 0x07,        ///< x8+x2+x+1
+    POLY_7BIT_SD     = 0x9,         ///< x7+x3+1
+    POLY_16BIT_CCITT = 0x1021,      ///< x16+x12+x5+1
+    POLY_16BIT_IBM   = 0x8005,      ///< x16+x15+x2+1
+    POLY_32BIT_ANSI  = 0x04C11DB7   ///< x32+x26+x23+x22+x16+x12+x11+x10+x8+x7+x5+x4+x2+x+1
+} crc_polynomial_t;
+
+/** Parameters of a CRC computation
+ */
+typedef struct crc_mbed_config {
+    uint32_t polynomial;    ///< Generator polynomial, in normal representation without the top bit
+    uint32_t width;         ///< Width of the CRC in bits, 1 to 32
+    uint32_t initial_xor;   ///< Initial value of the remainder
+    uint32_t final_xor;     ///< Value XORed with the remainder to give the CRC
+    bool reflect_in;        ///< Process each byte of data least significant bit first
+    bool reflect_out;       ///< Reflect the remainder before the final XOR
+} crc_mbed_config_t;
+
+#if DEVICE_CRC
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \defgroup hal_crc CRC hal functions
+ *
+ * A CRC peripheral computes one CRC at a time. mbed::MbedCRC arbitrates
+ * its use, and computes the CRCs the peripheral does not support, or that
+ * are started while it is busy, in software.
+ *
+ * @{
+ */
+
+/** Check if the peripheral can compute a CRC
+ *
+ * @param config The parameters of the CRC
+ * @return true if hal_crc_compute_partial_start may be called with config
+ */
+bool hal_crc_is_supported(const crc_mbed_config_t *config);
+
+/** Reset the peripheral and set it up for a new CRC
+ *
+ * @param config The parameters of the CRC, which must be supported
+ */
+void hal_crc_compute_partial_start(const crc_mbed_config_t *config);
+
+/** Feed data to the CRC in progress
+ *
+ * @param data The data
+ * @param size The size of the data in bytes
+ */
+void hal_crc_compute_partial(const uint8_t *data, const size_t size);
+
+/** Get the CRC of the data fed since hal_crc_compute_partial_start
+ *
+ * @return The CRC, after the output reflection and final XOR
+ */
+uint32_t hal_crc_get_result(void);
+
+/**@}*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+#endif
+
+/** @}*/
@@ -1,4 +1,3 @@
-
 /** \addtogroup hal */
 /** @{*/
 /* mbed Microcontroller Library
@@ -22,6 +21,29 @@
 #include <stdint.h>
 
 #define DMA_ERROR_OUT_OF_CHANNELS (-1)
+#define DMA_ERROR_BUSY            (-2)
+#define DMA_ERROR_UNSUPPORTED     (-3)
+
+/** Portable channel capabilities for dma_channel_allocate
+ *
+ * The low 16 bits of the capabilities word are left to target specific
+ * capabilities, such as DMA_CAP_2DCOPY on EFM32.
+ */
+#define DMA_CAP_MEMCPY          (1UL << 16)     /**< Memory to memory transfers */
+#define DMA_CAP_SCATTER_GATHER  (1UL << 17)     /**< Chained descriptor lists */
+#define DMA_CAP_PERIPHERAL      (1UL << 18)     /**< Transfers to or from a peripheral register */
+
+/** Descriptor flags */
+#define DMA_DESC_SRC_FIXED      (1UL << 0)      /**< Do not increment the source address */
+#define DMA_DESC_DST_FIXED      (1UL << 1)      /**< Do not increment the destination address */
+#define DMA_DESC_WIDTH_8        (0UL << 2)      /**< Transfer in bytes */
+#define DMA_DESC_WIDTH_16       (1UL << 2)      /**< Transfer in halfwords */
+#define DMA_DESC_WIDTH_32       (2UL << 2)      /**< Transfer in words */
+#define DMA_DESC_WIDTH_MASK     (3UL << 2)
+
+/** Events passed to a dma_handler_t */
+#define DMA_EVENT_COMPLETE      (1 << 0)
+#define DMA_EVENT_ERROR         (1 << 1)
 
 typedef enum {
     DMA_USAGE_NEVER,
@@ -31,16 +53,139 @@ typedef enum {
     DMA_USAGE_ALLOCATED
 } DMAUsage;
 
+/** A single transfer in a scatter-gather list
+ *
+ * Descriptors are chained through next and the list ends with a NULL next.
+ * The list must stay valid until the transfer completes.
+ */
+typedef struct dma_descriptor_s {
+    const void *src;                    /**< Source address */
+    void *dst;                          /**< Destination address */
+    uint32_t size;                      /**< Size of the transfer in bytes */
+    uint32_t flags;                     /**< DMA_DESC_* flags */
+    struct dma_descriptor_s *next;      /**< Next descriptor or NULL */
+} dma_descriptor_t;
+
+/** Completion handler of a DMA transfer
+ *
+ * Called from interrupt context once the whole descriptor list has been
+ * transferred or the transfer failed.
+ *
+ * @param channelid The channel the transfer ran on
+ * @param event     DMA_EVENT_COMPLETE or DMA_EVENT_ERROR
+ * @param context   The context passed to dma_transfer
+ */
+typedef void (*dma_handler_t)(int channelid, int event, void *context);
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/**
+ * \defgroup hal_dma DMA HAL API
+ *
+ * Channels are handed out by a shared channel manager, so SPI, Serial, I2C
+ * and EMAC drivers never use the same channel at once. A target either
+ * describes its channels with dma_channel_count and dma_channel_capabilities
+ * and uses the default manager, or overrides dma_channel_allocate and
+ * dma_channel_free altogether.
+ *
+ * @{
+ */
+
+/** Initialize the DMA controller
+ *
+ * It is safe to call this more than once.
+ */
 void dma_init(void);
 
+/** Allocate a DMA channel
+ *
+ * This function has a WEAK implementation which hands out the first free
+ * channel whose capabilities include all requested capabilities.
+ *
+ * @param capabilities  DMA_CAP_* capabilities the channel must have
+ * @return The channel id, or DMA_ERROR_OUT_OF_CHANNELS if no channel is free
+ */
 int dma_channel_allocate(uint32_t capabilities);
 
+/** Free a DMA channel
+ *
+ * @param channelid  A channel returned by dma_channel_allocate
+ * @return 0 for success
+ */
 int dma_channel_free(int channelid);
 
+/** Get the number of DMA channels of the target
+ *
+ * This function has a WEAK implementation returning 0.
+ *
+ * @return The number of channels
+ */
+int dma_channel_count(void);
+
+/** Get the capabilities of a DMA channel
+ *
+ * This function has a WEAK implementation returning 0.
+ *
+ * @param channelid  The channel to query
+ * @return The DMA_CAP_* capabilities of the channel
+ */
+uint32_t dma_channel_capabilities(int channelid);
+
+/** Start a transfer of a descriptor list
+ *
+ * The transfer runs in the background and the handler is called once the
+ * last descriptor is done. Descriptors after the first are only accepted
+ * on channels with DMA_CAP_SCATTER_GATHER.
+ *
+ * This function has a WEAK implementation returning DMA_ERROR_UNSUPPORTED.
+ *
+ * @param channelid  An allocated channel
+ * @param list       The first descriptor of the list
+ * @param handler    Completion handler, may be NULL
+ * @param context    Argument to the handler
+ * @return 0 for success, DMA_ERROR_BUSY if the channel is already running
+ *         or DMA_ERROR_UNSUPPORTED if the list can not be transferred
+ */
+int dma_transfer(int channelid, const dma_descriptor_t *list, dma_handler_t handler, void *context);
+
+/** Check if a channel is still transferring
+ *
+ * This function has a WEAK implementation returning 0.
+ *
+ * @param channelid  The channel to query
+ * @return Non-zero while a transfer is running
+ */
+int dma_transfer_busy(int channelid);
+
+/** Abort a running transfer
+ *
+ * The handler of the aborted transfer is not called. This function has a
+ * WEAK implementation that does nothing.
+ *
+ * @param channelid  The channel to stop
+ */
+void dma_transfer_abort(int channelid);
+
+/** Copy memory, using a DMA channel when one is free
+ *
+ * With a handler the copy runs in the background on a DMA_CAP_MEMCPY
+ * channel, which is freed again before the handler is called. Without a
+ * handler, or when no channel is free, the copy is done before returning
+ * and the handler is called directly with a channel id of -1.
+ *
+ * @param dst        Destination buffer
+ * @param src        Source buffer
+ * @param size       Number of bytes to copy
+ * @param handler    Completion handler, may be NULL
+ * @param context    Argument to the handler
+ * @return 0 for success
+ */
+int dma_memcpy(void *dst, const void *src, uint32_t size, dma_handler_t handler, void *context);
+
+/**@}*/
+
 #ifdef __cplusplus
 }
 #endif
@@ -96,6 +96,10 @@ typedef void (*emac_set_hwaddr_fn)(emac_interface_t *emac, uint8_t *addr);
  *
  * That can not be called from an interrupt context.
  *
+ * The packet may be made of several memory structures, see @a emac_stack_mem_next. Instead of
+ * copying them, a driver can give them to its DMA directly, keeping a reference with
+ * @a emac_stack_mem_ref and freeing them once sent.
+ *
  * @param emac Emac interface
  * @param buf  Packet to be send
  * @return     True if the packet was send successfully, False otherwise
@@ -134,6 +138,80 @@ typedef void (*emac_set_link_input_cb_fn)(emac_interface_t *emac, emac_link_inpu
  */
 typedef void (*emac_set_link_state_cb_fn)(emac_interface_t *emac, emac_link_state_change_fn state_cb, void *data);
 
+/**
+ * Capabilities of an Emac interface, see @a get_capabilities
+ *
+ * The checksum generation capabilities mean the hardware fills in the checksums of sent packets,
+ * the checksum checking ones that it drops received packets with invalid checksums.
+ */
+#define EMAC_CAP_CHECKSUM_GEN_IP        0x00000001  /**< IPv4 header checksum */
+#define EMAC_CAP_CHECKSUM_GEN_UDP       0x00000002  /**< UDP checksum */
+#define EMAC_CAP_CHECKSUM_GEN_TCP       0x00000004  /**< TCP checksum */
+#define EMAC_CAP_CHECKSUM_GEN_ICMP      0x00000008  /**< ICMPv4 checksum */
+#define EMAC_CAP_CHECKSUM_CHECK_IP      0x00000100  /**< IPv4 header checksum */
+#define EMAC_CAP_CHECKSUM_CHECK_UDP     0x00000200  /**< UDP checksum */
+#define EMAC_CAP_CHECKSUM_CHECK_TCP     0x00000400  /**< TCP checksum */
+#define EMAC_CAP_CHECKSUM_CHECK_ICMP    0x00000800  /**< ICMPv4 checksum */
+#define EMAC_CAP_SCATTER_GATHER_TX      0x00010000  /**< @a link_out sends packets made of several buffers */
+
+/**
+ * Return the capabilities of the interface
+ *
+ * Optional, interfaces without the function have none of the capabilities, except that they are
+ * still given packets made of several buffers.
+ *
+ * @param emac Emac interface
+ * @return     Bitmask of EMAC_CAP_ capabilities
+ */
+typedef uint32_t (*emac_get_capabilities_fn)(emac_interface_t *emac);
+
+/**
+ * Set maximum transmission unit
+ *
+ * Optional, for interfaces that support jumbo frames or smaller MTUs. Called before @a power_up,
+ * the MTU in use is then read with @a get_mtu_size.
+ *
+ * @param emac Emac interface
+ * @param mtu  MTU in bytes
+ * @return     True if the MTU was set, False otherwise
+ */
+typedef bool (*emac_set_mtu_size_fn)(emac_interface_t *emac, uint32_t mtu);
+
+/**
+ * Return the number of transmit queues of the hardware
+ * Optional, interfaces without the function have a single queue. Queues are numbered from 0, the
+ * lowest priority, and the hardware sends from higher queues first.
+ * @param emac Emac interface
+ * @return     Number of transmit queues
+ */
+typedef uint8_t (*emac_get_tx_queues_fn)(emac_interface_t *emac);
+
+/**
+ * Sends the packet over the link on one of the transmit queues
+ * Optional, as @a link_out for interfaces with more than one queue, see @a get_tx_queues.
+ * @param emac  Emac interface
+ * @param buf   Packet to be send
+ * @param queue Transmit queue, below the number of queues
+ * @return      True if the packet was queued for sending, False if the queue is full
+ */
+typedef bool (*emac_link_out_queue_fn)(emac_interface_t *emac, emac_stack_mem_t *buf, uint8_t queue);
+
+/**
+ * Callback to be called when an interface has room to send again after @a link_out or
+ * @a link_out_queue failed, may be called from an interrupt
+ * @param data Arbitrary user data (IP stack)
+ */
+typedef void (*emac_tx_ready_fn)(void *data);
+
+/**
+ * Sets a callback that needs to be called when an interface has room to send again
+ * Optional, without it packets held back by the stack are sent with the next packet.
+ * @param emac        Emac interface
+ * @param tx_ready_cb Function to be register as a callback
+ * @param data        Arbitrary user data to be passed to the callback
+ */
+typedef void (*emac_set_tx_ready_cb_fn)(emac_interface_t *emac, emac_tx_ready_fn tx_ready_cb, void *data);
+
 typedef struct emac_interface_ops {
     emac_get_mtu_size_fn        get_mtu_size;
     emac_get_ifname_fn          get_ifname;
@@ -145,6 +223,11 @@ typedef struct emac_interface_ops {
     emac_power_down_fn          power_down;
     emac_set_link_input_cb_fn   set_link_input_cb;
     emac_set_link_state_cb_fn   set_link_state_cb;
+    emac_get_capabilities_fn    get_capabilities;
+    emac_set_mtu_size_fn        set_mtu_size;
+    emac_get_tx_queues_fn       get_tx_queues;
+    emac_link_out_queue_fn      link_out_queue;
+    emac_set_tx_ready_cb_fn     set_tx_ready_cb;
 } emac_interface_ops_t;
 
 typedef struct emac_interface {
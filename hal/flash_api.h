@@ -118,6 +118,76 @@ uint32_t flash_get_size(const flash_t *obj);
 
 /**@}*/
 
+#if DEVICE_FLASH_ASYNCH
+
+/**
+ * \defgroup AsynchFlash Asynchronous Flash Hardware Abstraction Layer
+ *
+ * The asynchronous functions start an erase or program operation and return
+ * straight away. The flash peripheral raises an interrupt once the operation
+ * is done, and the handler passed to the function is called from it. The
+ * handler should call flash_irq_handler_asynch to find out how the operation
+ * ended. While an operation is running, code that is not executing from the
+ * bank being written keeps running.
+ *
+ * @{
+ */
+
+/** The operation completed successfully */
+#define FLASH_EVENT_COMPLETE    (1 << 0)
+/** The operation failed */
+#define FLASH_EVENT_ERROR       (1 << 1)
+
+/** Start erasing one sector
+ *
+ * The address should be at sector boundary.
+ * @param obj The flash object
+ * @param address The sector starting address
+ * @param handler The address of the handler called from the flash interrupt
+ * @return 0 if the erase started, -1 for error
+ */
+int32_t flash_erase_sector_asynch(flash_t *obj, uint32_t address, uint32_t handler);
+
+/** Start programming one page
+ *
+ * The same alignment rules as flash_program_page apply. The data buffer must
+ * stay valid until the operation completes.
+ * @param obj The flash object
+ * @param address The page starting address
+ * @param data The data buffer to be programmed
+ * @param size The number of bytes to program
+ * @param handler The address of the handler called from the flash interrupt
+ * @return 0 if programming started, -1 for error
+ */
+int32_t flash_program_page_asynch(flash_t *obj, uint32_t address, const uint8_t *data, uint32_t size, uint32_t handler);
+
+/** The asynchronous flash interrupt handler
+ *
+ * @param obj The flash object
+ * @return FLASH_EVENT_COMPLETE, FLASH_EVENT_ERROR, or 0 if the operation
+ *         is still running
+ */
+uint32_t flash_irq_handler_asynch(flash_t *obj);
+
+/** Check if an asynchronous operation is running
+ *
+ * @param obj The flash object
+ * @return Non-zero while an erase or program operation is running
+ */
+uint8_t flash_active(flash_t *obj);
+
+/** Abort the running asynchronous operation
+ *
+ * The handler is not called for the aborted operation, and the contents of
+ * the sector or page being written are undefined.
+ * @param obj The flash object
+ */
+void flash_abort_asynch(flash_t *obj);
+
+/**@}*/
+
+#endif
+
 #ifdef __cplusplus
 }
 #endif
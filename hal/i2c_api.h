@@ -22,7 +22,7 @@
 #include "device.h"
 #include "hal/buffer.h"
 
-#if DEVICE_I2C_ASYNCH
+#if DEVICE_I2C_ASYNCH || DEVICE_I2CSLAVE_ASYNCH
 #include "hal/dma_api.h"
 #endif
 
@@ -39,6 +39,11 @@
 #define I2C_EVENT_TRANSFER_EARLY_NACK (1 << 4)
 #define I2C_EVENT_ALL                 (I2C_EVENT_ERROR |  I2C_EVENT_TRANSFER_COMPLETE | I2C_EVENT_ERROR_NO_SLAVE | I2C_EVENT_TRANSFER_EARLY_NACK)
 
+#define I2C_EVENT_SLAVE_RECEIVED      (1 << 5) /**< The master wrote to the slave */
+#define I2C_EVENT_SLAVE_TRANSMITTED   (1 << 6) /**< The master read from the slave */
+#define I2C_EVENT_SLAVE_GENERAL_CALL  (1 << 7) /**< The write was a general call, with I2C_EVENT_SLAVE_RECEIVED */
+#define I2C_EVENT_SLAVE_ALL           (I2C_EVENT_ERROR | I2C_EVENT_SLAVE_RECEIVED | I2C_EVENT_SLAVE_TRANSMITTED | I2C_EVENT_SLAVE_GENERAL_CALL)
+
 /**@}*/
 
 #if DEVICE_I2C_ASYNCH
@@ -194,6 +199,64 @@ void i2c_slave_address(i2c_t *obj, int idx, uint32_t address, uint32_t mask);
 
 #endif
 
+#if DEVICE_I2CSLAVE_ASYNCH
+
+/**
+ * \defgroup AsynchI2CSlave Asynchronous I2C Hardware Abstraction Layer for slave
+ *
+ * A slave transfer is armed before the master addresses the slave, with a
+ * buffer for what the master writes and a preloaded reply for what it
+ * reads, so bytes are moved by DMA or the I2C interrupt and clock
+ * stretching is kept short. The weak implementations in hal/mbed_i2c_api.c
+ * report that the target can not transfer as a slave in the background.
+ *
+ * @{
+ */
+
+/** Arm a slave transfer for the next transaction the master addresses to the slave
+ *
+ * The transfer ends with I2C_EVENT_SLAVE_RECEIVED at the stop condition of a
+ * write or once rx_length bytes have been received, after which further
+ * bytes are NACKed. It ends with I2C_EVENT_SLAVE_TRANSMITTED at the end of
+ * a read, with 0xFF sent once tx is exhausted.
+ *
+ * @param obj       The I2C object, in slave mode
+ * @param tx        The reply to a read, may be NULL
+ * @param tx_length The number of bytes of the reply
+ * @param rx        The buffer for a write, may be NULL
+ * @param rx_length The size of the buffer
+ * @param handler   The I2C IRQ handler to be set
+ * @param event     Event mask for the transfer, I2C_EVENT_SLAVE_*
+ * @param hint      DMA hint usage
+ * @return 0 if the transfer is armed, -1 if the target can not transfer as a slave
+ */
+int i2c_slave_transfer_asynch(i2c_t *obj, const void *tx, size_t tx_length, void *rx, size_t rx_length,
+                              uint32_t handler, uint32_t event, DMAUsage hint);
+
+/** The asynchronous slave IRQ handler
+ *
+ * @param obj The I2C object which holds the transfer information
+ * @return Event flags if the transfer ended, otherwise 0
+ */
+uint32_t i2c_slave_irq_handler_asynch(i2c_t *obj);
+
+/** Get the number of bytes moved by the last slave transfer
+ *
+ * @param obj The I2C object
+ * @return The bytes received or transmitted, as reported by the event
+ */
+size_t i2c_slave_transfer_count(i2c_t *obj);
+
+/** Disarm or abort a slave transfer
+ *
+ * @param obj The I2C object
+ */
+void i2c_slave_abort_asynch(i2c_t *obj);
+
+/**@}*/
+
+#endif
+
 /**@}*/
 
 #if DEVICE_I2C_ASYNCH
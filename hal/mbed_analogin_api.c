@@ -0,0 +1,47 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hal/analogin_api.h"
+
+#if DEVICE_ANALOGIN && DEVICE_ANALOGIN_ASYNCH
+
+#include "platform/mbed_toolchain.h"
+
+MBED_WEAK int analogin_stream_start(analogin_t *const *channels, int count, uint16_t *buffer, size_t length,
+                                    uint32_t sample_rate_hz, uint32_t handler, DMAUsage hint)
+{
+    (void)channels;
+    (void)count;
+    (void)buffer;
+    (void)length;
+    (void)sample_rate_hz;
+    (void)handler;
+    (void)hint;
+    return -1;
+}
+
+MBED_WEAK int analogin_stream_irq_handler_asynch(analogin_t *obj)
+{
+    (void)obj;
+    return 0;
+}
+
+MBED_WEAK void analogin_stream_stop(analogin_t *obj)
+{
+    (void)obj;
+}
+
+#endif
@@ -0,0 +1,58 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hal/can_api.h"
+
+#if DEVICE_CAN
+
+#include "hal/us_ticker_api.h"
+#include "platform/mbed_toolchain.h"
+
+MBED_WEAK int can_filter_banks(can_t *obj)
+{
+    (void)obj;
+    return 1;
+}
+
+MBED_WEAK int can_filter_bank(can_t *obj, int bank, uint32_t id, uint32_t mask, CANFormat format)
+{
+    if (bank < 0 || bank >= can_filter_banks(obj)) {
+        return 0;
+    }
+
+    // can_filter returns the handle on success, and 0 on failure, so a
+    // failure is only told apart from bank 0 by targets overriding this
+    int handle = can_filter(obj, id, mask, format, bank);
+    return bank == 0 || handle == bank;
+}
+
+MBED_WEAK int can_read_timestamp(can_t *obj, CAN_Message *msg, int handle)
+{
+    int ret = can_read(obj, msg, handle);
+    if (ret) {
+        msg->timestamp = us_ticker_read();
+    }
+    return ret;
+}
+
+MBED_WEAK int can_tx_timestamp(can_t *obj, uint32_t *timestamp)
+{
+    (void)obj;
+    (void)timestamp;
+    return 0;
+}
+
+#endif
@@ -0,0 +1,151 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hal/dma_api.h"
+#include "platform/mbed_critical.h"
+#include "platform/mbed_toolchain.h"
+#include <stddef.h>
+#include <string.h>
+
+// The default channel manager tracks channels in a single word
+#define DMA_MAX_CHANNELS 32
+
+static uint32_t dma_channels_used = 0;
+
+// In-flight dma_memcpy transfers, indexed by channel
+typedef struct {
+    dma_descriptor_t desc;
+    dma_handler_t handler;
+    void *context;
+} dma_memcpy_t;
+
+static dma_memcpy_t dma_memcpys[DMA_MAX_CHANNELS];
+
+static int dma_channels(void)
+{
+    int count = dma_channel_count();
+    return count < DMA_MAX_CHANNELS ? count : DMA_MAX_CHANNELS;
+}
+
+MBED_WEAK void dma_init(void)
+{
+}
+
+MBED_WEAK int dma_channel_count(void)
+{
+    return 0;
+}
+
+MBED_WEAK uint32_t dma_channel_capabilities(int channelid)
+{
+    (void)channelid;
+    return 0;
+}
+
+MBED_WEAK int dma_channel_allocate(uint32_t capabilities)
+{
+    int count = dma_channels();
+    int channelid = DMA_ERROR_OUT_OF_CHANNELS;
+
+    core_util_critical_section_enter();
+    for (int i = 0; i < count; i++) {
+        if ((dma_channels_used & (1UL << i)) == 0 &&
+                (dma_channel_capabilities(i) & capabilities) == capabilities) {
+            dma_channels_used |= 1UL << i;
+            channelid = i;
+            break;
+        }
+    }
+    core_util_critical_section_exit();
+
+    return channelid;
+}
+
+MBED_WEAK int dma_channel_free(int channelid)
+{
+    if (channelid >= 0 && channelid < DMA_MAX_CHANNELS) {
+        core_util_critical_section_enter();
+        dma_channels_used &= ~(1UL << channelid);
+        core_util_critical_section_exit();
+    }
+
+    return 0;
+}
+
+MBED_WEAK int dma_transfer(int channelid, const dma_descriptor_t *list, dma_handler_t handler, void *context)
+{
+    (void)channelid;
+    (void)list;
+    (void)handler;
+    (void)context;
+    return DMA_ERROR_UNSUPPORTED;
+}
+
+MBED_WEAK int dma_transfer_busy(int channelid)
+{
+    (void)channelid;
+    return 0;
+}
+
+MBED_WEAK void dma_transfer_abort(int channelid)
+{
+    (void)channelid;
+}
+
+static void dma_memcpy_handler(int channelid, int event, void *context)
+{
+    dma_memcpy_t *m = (dma_memcpy_t *)context;
+    dma_handler_t handler = m->handler;
+    void *handler_context = m->context;
+
+    // the channel is free again by the time the handler runs, so the
+    // handler can start the next copy
+    dma_channel_free(channelid);
+    handler(channelid, event, handler_context);
+}
+
+int dma_memcpy(void *dst, const void *src, uint32_t size, dma_handler_t handler, void *context)
+{
+    if (handler) {
+        int channelid = dma_channel_allocate(DMA_CAP_MEMCPY);
+        if (channelid >= 0 && channelid < DMA_MAX_CHANNELS) {
+            dma_memcpy_t *m = &dma_memcpys[channelid];
+            m->desc.src = src;
+            m->desc.dst = dst;
+            m->desc.size = size;
+            m->desc.flags = DMA_DESC_WIDTH_8;
+            m->desc.next = NULL;
+            m->handler = handler;
+            m->context = context;
+
+            dma_init();
+            if (dma_transfer(channelid, &m->desc, dma_memcpy_handler, m) == 0) {
+                return 0;
+            }
+        }
+
+        if (channelid >= 0) {
+            dma_channel_free(channelid);
+        }
+    }
+
+    memcpy(dst, src, size);
+    if (handler) {
+        handler(-1, DMA_EVENT_COMPLETE, context);
+    }
+
+    return 0;
+}
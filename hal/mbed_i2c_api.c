@@ -0,0 +1,54 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hal/i2c_api.h"
+
+#if DEVICE_I2CSLAVE_ASYNCH
+
+#include "platform/mbed_toolchain.h"
+
+MBED_WEAK int i2c_slave_transfer_asynch(i2c_t *obj, const void *tx, size_t tx_length, void *rx, size_t rx_length,
+                                        uint32_t handler, uint32_t event, DMAUsage hint)
+{
+    (void)obj;
+    (void)tx;
+    (void)tx_length;
+    (void)rx;
+    (void)rx_length;
+    (void)handler;
+    (void)event;
+    (void)hint;
+    return -1;
+}
+
+MBED_WEAK uint32_t i2c_slave_irq_handler_asynch(i2c_t *obj)
+{
+    (void)obj;
+    return 0;
+}
+
+MBED_WEAK size_t i2c_slave_transfer_count(i2c_t *obj)
+{
+    (void)obj;
+    return 0;
+}
+
+MBED_WEAK void i2c_slave_abort_asynch(i2c_t *obj)
+{
+    (void)obj;
+}
+
+#endif
@@ -0,0 +1,65 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hal/port_api.h"
+
+#if DEVICE_PORTIN || DEVICE_PORTOUT
+
+#include "platform/mbed_toolchain.h"
+
+MBED_WEAK int pin_port(PinName pin, PortName *port, int *pin_n)
+{
+    (void)pin;
+    (void)port;
+    (void)pin_n;
+    return 0;
+}
+
+#if DEVICE_PORTOUT_ASYNCH
+
+MBED_WEAK uint32_t port_stream_word(port_t *obj, int value)
+{
+    (void)obj;
+    return (uint32_t)value;
+}
+
+MBED_WEAK int port_stream_start(port_t *obj, const uint32_t *buffer, size_t length, uint32_t rate_hz, int circular,
+                                uint32_t handler, DMAUsage hint)
+{
+    (void)obj;
+    (void)buffer;
+    (void)length;
+    (void)rate_hz;
+    (void)circular;
+    (void)handler;
+    (void)hint;
+    return -1;
+}
+
+MBED_WEAK int port_stream_irq_handler_asynch(port_t *obj)
+{
+    (void)obj;
+    return 0;
+}
+
+MBED_WEAK void port_stream_stop(port_t *obj)
+{
+    (void)obj;
+}
+
+#endif
+
+#endif
@@ -0,0 +1,81 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hal/pwmout_api.h"
+
+#if DEVICE_PWMOUT
+
+#include "platform/mbed_toolchain.h"
+
+MBED_WEAK int pwmout_group_init(pwmout_t *objs, size_t count)
+{
+    (void)objs;
+    (void)count;
+    return -1;
+}
+
+MBED_WEAK void pwmout_group_period_us(pwmout_t *objs, size_t count, int us)
+{
+    for (size_t i = 0; i < count; i++) {
+        pwmout_period_us(&objs[i], us);
+    }
+}
+
+MBED_WEAK void pwmout_group_write(pwmout_t *objs, const float *percent, size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        pwmout_write(&objs[i], percent[i]);
+    }
+}
+
+MBED_WEAK uint32_t pwmout_group_word(pwmout_t *obj, float percent)
+{
+    (void)obj;
+    if (percent < 0.0f) {
+        percent = 0.0f;
+    } else if (percent > 1.0f) {
+        percent = 1.0f;
+    }
+    return (uint32_t)(percent * 0xFFFF);
+}
+
+MBED_WEAK int pwmout_group_stream_start(pwmout_t *objs, size_t count, const uint32_t *table, size_t periods,
+                                        int circular, uint32_t handler, DMAUsage hint)
+{
+    (void)objs;
+    (void)count;
+    (void)table;
+    (void)periods;
+    (void)circular;
+    (void)handler;
+    (void)hint;
+    return -1;
+}
+
+MBED_WEAK int pwmout_group_irq_handler_asynch(pwmout_t *objs, size_t count)
+{
+    (void)objs;
+    (void)count;
+    return 0;
+}
+
+MBED_WEAK void pwmout_group_stream_stop(pwmout_t *objs, size_t count)
+{
+    (void)objs;
+    (void)count;
+}
+
+#endif
@@ -16,9 +16,101 @@
 
 #include "mbed_sleep.h"
 #include "mbed_critical.h"
+#include "mbed_stats.h"
 #include "sleep_api.h"
 #include "mbed_error.h"
 #include <limits.h>
+#include <string.h>
+
+#if DEVICE_SLEEP && MBED_SLEEP_STATS_ENABLED
+#include "cmsis.h"
+#include "hal/lp_ticker_api.h"
+#include "hal/us_ticker_api.h"
+
+#ifndef MBED_SLEEP_STATS_MAX_LOCKS
+#define MBED_SLEEP_STATS_MAX_LOCKS 8
+#endif
+
+#ifndef MBED_SLEEP_STATS_MAX_WAKEUP_SOURCES
+#define MBED_SLEEP_STATS_MAX_WAKEUP_SOURCES 8
+#endif
+
+static mbed_stats_sleep_t sleep_stats;
+static mbed_stats_sleep_lock_t sleep_locks[MBED_SLEEP_STATS_MAX_LOCKS];
+static mbed_stats_wakeup_t wakeup_sources[MBED_SLEEP_STATS_MAX_WAKEUP_SOURCES];
+
+static us_timestamp_t sleep_time_read(void)
+{
+#if DEVICE_LOWPOWERTIMER
+    return ticker_read_us(get_lp_ticker_data());
+#else
+    return ticker_read_us(get_us_ticker_data());
+#endif
+}
+
+// called in a critical section, names are compared by content as the
+// same name may be a different string in each translation unit
+static void sleep_lock_track(const char *name, int delta)
+{
+    mbed_stats_sleep_lock_t *free_lock = NULL;
+    for (int i = 0; i < MBED_SLEEP_STATS_MAX_LOCKS; i++) {
+        if (sleep_locks[i].lock_cnt == 0) {
+            if (!free_lock) {
+                free_lock = &sleep_locks[i];
+            }
+        } else if (sleep_locks[i].name == name || strcmp(sleep_locks[i].name, name) == 0) {
+            sleep_locks[i].lock_cnt += delta;
+            return;
+        }
+    }
+
+    if (delta > 0 && free_lock) {
+        free_lock->name = name;
+        free_lock->lock_cnt = delta;
+    }
+}
+
+// called in a critical section right after waking up, while the
+// interrupt that woke the target is still pending, only Cortex-M
+// cores have the NVIC to find it in
+static void sleep_wakeup_track(void)
+{
+    int32_t irq = -2;
+#if defined(__CORTEX_M)
+    if (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) {
+        irq = SysTick_IRQn;
+    } else {
+        for (uint32_t i = 0; i < sizeof(NVIC->ISPR) / sizeof(NVIC->ISPR[0]); i++) {
+            uint32_t pending = NVIC->ISPR[i] & NVIC->ISER[i];
+            if (pending) {
+                irq = 32 * i;
+                while (!(pending & 1)) {
+                    pending >>= 1;
+                    irq++;
+                }
+                break;
+            }
+        }
+    }
+#endif
+
+    if (irq == -2) {
+        sleep_stats.unknown_wakeup_cnt++;
+        return;
+    }
+
+    for (int i = 0; i < MBED_SLEEP_STATS_MAX_WAKEUP_SOURCES; i++) {
+        if (wakeup_sources[i].wakeup_cnt == 0) {
+            wakeup_sources[i].irq = irq;
+        }
+        if (wakeup_sources[i].irq == irq) {
+            wakeup_sources[i].wakeup_cnt++;
+            return;
+        }
+    }
+    sleep_stats.unknown_wakeup_cnt++;
+}
+#endif
 
 #if DEVICE_SLEEP
 
@@ -26,6 +118,16 @@
 static uint16_t deep_sleep_lock = 0U;
 
 void sleep_manager_lock_deep_sleep(void)
+{
+    sleep_manager_lock_deep_sleep_named(NULL);
+}
+
+void sleep_manager_unlock_deep_sleep(void)
+{
+    sleep_manager_unlock_deep_sleep_named(NULL);
+}
+
+void sleep_manager_lock_deep_sleep_named(const char *name)
 {
     core_util_critical_section_enter();
     if (deep_sleep_lock == USHRT_MAX) {
@@ -33,10 +135,13 @@ void sleep_manager_lock_deep_sleep(void)
         error("Deep sleep lock would overflow (> USHRT_MAX)");
     }
     core_util_atomic_incr_u16(&deep_sleep_lock, 1);
+#if MBED_SLEEP_STATS_ENABLED
+    sleep_lock_track(name ? name : "unnamed", 1);
+#endif
     core_util_critical_section_exit();
 }
 
-void sleep_manager_unlock_deep_sleep(void)
+void sleep_manager_unlock_deep_sleep_named(const char *name)
 {
     core_util_critical_section_enter();
     if (deep_sleep_lock == 0) {
@@ -44,6 +149,9 @@ void sleep_manager_unlock_deep_sleep(void)
         error("Deep sleep lock would underflow (< 0)");
     }
     core_util_atomic_decr_u16(&deep_sleep_lock, 1);
+#if MBED_SLEEP_STATS_ENABLED
+    sleep_lock_track(name ? name : "unnamed", -1);
+#endif
     core_util_critical_section_exit();
 }
 
@@ -55,15 +163,33 @@ bool sleep_manager_can_deep_sleep(void)
 void sleep_manager_sleep_auto(void)
 {
     core_util_critical_section_enter();
+#if MBED_SLEEP_STATS_ENABLED
+    us_timestamp_t start = sleep_time_read();
+    bool deep = false;
+#endif
 // debug profile should keep debuggers attached, no deep sleep allowed
 #ifdef MBED_DEBUG
     hal_sleep();
 #else
     if (sleep_manager_can_deep_sleep()) {
+#if MBED_SLEEP_STATS_ENABLED
+        deep = true;
+#endif
         hal_deepsleep();
     } else {
         hal_sleep();
     }
+#endif
+#if MBED_SLEEP_STATS_ENABLED
+    sleep_wakeup_track();
+    us_timestamp_t elapsed = sleep_time_read() - start;
+    if (deep) {
+        sleep_stats.deep_sleep_time += elapsed;
+        sleep_stats.deep_sleep_cnt++;
+    } else {
+        sleep_stats.sleep_time += elapsed;
+        sleep_stats.sleep_cnt++;
+    }
 #endif
     core_util_critical_section_exit();
 }
@@ -83,6 +209,16 @@ void sleep_manager_unlock_deep_sleep(void)
 
 }
 
+void sleep_manager_lock_deep_sleep_named(const char *name)
+{
+
+}
+
+void sleep_manager_unlock_deep_sleep_named(const char *name)
+{
+
+}
+
 bool sleep_manager_can_deep_sleep(void)
 {
     // no sleep implemented
@@ -90,3 +226,44 @@ bool sleep_manager_can_deep_sleep(void)
 }
 
 #endif
+
+void mbed_stats_sleep_get(mbed_stats_sleep_t *stats)
+{
+#if DEVICE_SLEEP && MBED_SLEEP_STATS_ENABLED
+    core_util_critical_section_enter();
+    memcpy(stats, &sleep_stats, sizeof(mbed_stats_sleep_t));
+    core_util_critical_section_exit();
+#else
+    memset(stats, 0, sizeof(mbed_stats_sleep_t));
+#endif
+}
+
+size_t mbed_stats_sleep_locks_get_each(mbed_stats_sleep_lock_t *stats, size_t count)
+{
+    size_t n = 0;
+#if DEVICE_SLEEP && MBED_SLEEP_STATS_ENABLED
+    core_util_critical_section_enter();
+    for (int i = 0; i < MBED_SLEEP_STATS_MAX_LOCKS && n < count; i++) {
+        if (sleep_locks[i].lock_cnt != 0) {
+            stats[n++] = sleep_locks[i];
+        }
+    }
+    core_util_critical_section_exit();
+#endif
+    return n;
+}
+
+size_t mbed_stats_wakeup_get_each(mbed_stats_wakeup_t *stats, size_t count)
+{
+    size_t n = 0;
+#if DEVICE_SLEEP && MBED_SLEEP_STATS_ENABLED
+    core_util_critical_section_enter();
+    for (int i = 0; i < MBED_SLEEP_STATS_MAX_WAKEUP_SOURCES && n < count; i++) {
+        if (wakeup_sources[i].wakeup_cnt != 0) {
+            stats[n++] = wakeup_sources[i];
+        }
+    }
+    core_util_critical_section_exit();
+#endif
+    return n;
+}
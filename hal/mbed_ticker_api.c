@@ -18,8 +18,31 @@
 #include "hal/ticker_api.h"
 #include "platform/mbed_critical.h"
 
+/*
+ * Events due within this many us of the present are fired together from one
+ * interrupt, and the interrupt is reprogrammed once after all of them instead
+ * of after each event inserted or removed by their handlers. 0 disables
+ * batching.
+ */
+#ifndef MBED_CONF_PLATFORM_TICKER_BATCH_TOLERANCE_US
+#define MBED_CONF_PLATFORM_TICKER_BATCH_TOLERANCE_US 0
+#endif
+
+/*
+ * Measure how long programming the interrupt takes when the ticker is
+ * initialized, and treat events due sooner than that as due now, since the
+ * interrupt could not be set in time for them anyway.
+ */
+#ifndef MBED_CONF_PLATFORM_TICKER_LATENCY_COMPENSATION
+#define MBED_CONF_PLATFORM_TICKER_LATENCY_COMPENSATION 0
+#endif
+
+#define TICKER_LATENCY_SAMPLES 4
+
 static void schedule_interrupt(const ticker_data_t *const ticker);
 static void update_present_time(const ticker_data_t *const ticker);
+static void queue_insert(ticker_event_queue_t *queue, ticker_event_t *obj);
+static void queue_remove(ticker_event_queue_t *queue, ticker_event_t *obj);
 
 /*
  * Initialize a ticker instance.  
@@ -36,8 +59,24 @@ static void initialize(const ticker_data_t *ticker)
     
     ticker->queue->event_handler = NULL;
     ticker->queue->head = NULL;
+    ticker->queue->root = NULL;
     ticker->queue->present_time = 0;
+    ticker->queue->set_latency = 0;
+    ticker->queue->dispatching = false;
     ticker->queue->initialized = true;
+
+#if MBED_CONF_PLATFORM_TICKER_LATENCY_COMPENSATION
+    // keep the worst of a few samples, the interrupt is reprogrammed
+    // right after, so the match values used here do not matter
+    for (int i = 0; i < TICKER_LATENCY_SAMPLES; i++) {
+        timestamp_t start = ticker->interface->read();
+        ticker->interface->set_interrupt(start + MBED_TICKER_INTERRUPT_TIMESTAMP_MAX_DELTA);
+        uint32_t latency = ticker->interface->read() - start;
+        if (latency > ticker->queue->set_latency) {
+            ticker->queue->set_latency = latency;
+        }
+    }
+#endif
     
     update_present_time(ticker);
     schedule_interrupt(ticker);
@@ -108,6 +147,11 @@ static void update_present_time(const ticker_data_t *const ticker)
  */
 static void schedule_interrupt(const ticker_data_t *const ticker)
 {
+    // the irq handler reprograms the interrupt once it has fired every event
+    if (ticker->queue->dispatching) {
+        return;
+    }
+
     update_present_time(ticker);
     uint32_t relative_timeout = MBED_TICKER_INTERRUPT_TIMESTAMP_MAX_DELTA;
 
@@ -115,9 +159,9 @@ static void schedule_interrupt(const ticker_data_t *const ticker)
         us_timestamp_t present = ticker->queue->present_time;
         us_timestamp_t next_event_timestamp = ticker->queue->head->timestamp;
 
-        // if the event at the head of the queue is in the past then schedule
-        // it immediately.
-        if (next_event_timestamp <= present) {
+        // if the event at the head of the queue is in the past, or too close
+        // to program the interrupt in time, then schedule it immediately.
+        if (next_event_timestamp <= present + ticker->queue->set_latency) {
             ticker->interface->fire_interrupt();
             return;
         } else if ((next_event_timestamp - present) < MBED_TICKER_INTERRUPT_TIMESTAMP_MAX_DELTA) {
@@ -136,6 +180,160 @@ static void schedule_interrupt(const ticker_data_t *const ticker)
     }
 }
 
+/*
+ * The pending events form a treap: a binary search tree ordered by timestamp
+ * that is also a max-heap on a priority derived from each event's address.
+ * This keeps the tree balanced in expectation without storing anything but
+ * the links. Events with equal timestamps are ordered by insertion, and the
+ * in-order traversal of the tree is the sorted event list linked through next.
+ */
+static uint32_t event_priority(const ticker_event_t *obj)
+{
+    uint32_t x = (uint32_t)(uintptr_t)obj;
+    x ^= x >> 16;
+    x *= 0x45d9f3b;
+    x ^= x >> 16;
+    return x;
+}
+
+/*
+ * Rotate an event above its parent, preserving the order of the tree.
+ */
+static void rotate_up(ticker_event_queue_t *queue, ticker_event_t *obj)
+{
+    ticker_event_t *parent = obj->parent;
+    ticker_event_t *grandparent = parent->parent;
+
+    if (parent->left == obj) {
+        parent->left = obj->right;
+        if (obj->right) {
+            obj->right->parent = parent;
+        }
+        obj->right = parent;
+    } else {
+        parent->right = obj->left;
+        if (obj->left) {
+            obj->left->parent = parent;
+        }
+        obj->left = parent;
+    }
+
+    parent->parent = obj;
+    obj->parent = grandparent;
+    if (grandparent == NULL) {
+        queue->root = obj;
+    } else if (grandparent->left == parent) {
+        grandparent->left = obj;
+    } else {
+        grandparent->right = obj;
+    }
+}
+
+static void queue_insert(ticker_event_queue_t *queue, ticker_event_t *obj)
+{
+    // the list may have been emptied without going through the tree
+    if (queue->head == NULL) {
+        queue->root = NULL;
+    }
+
+    // find the leaf to attach to, and the last event not after this one
+    ticker_event_t *parent = NULL, *prev = NULL, *p = queue->root;
+    bool left = false;
+    while (p != NULL) {
+        parent = p;
+        left = obj->timestamp < p->timestamp;
+        if (left) {
+            p = p->left;
+        } else {
+            prev = p;
+            p = p->right;
+        }
+    }
+
+    obj->parent = parent;
+    obj->left = NULL;
+    obj->right = NULL;
+    if (parent == NULL) {
+        queue->root = obj;
+    } else if (left) {
+        parent->left = obj;
+    } else {
+        parent->right = obj;
+    }
+
+    // if prev is NULL we're at the head
+    if (prev == NULL) {
+        obj->next = queue->head;
+        queue->head = obj;
+    } else {
+        obj->next = prev->next;
+        prev->next = obj;
+    }
+
+    uint32_t priority = event_priority(obj);
+    while (obj->parent && event_priority(obj->parent) < priority) {
+        rotate_up(queue, obj);
+    }
+}
+
+static void queue_remove(ticker_event_queue_t *queue, ticker_event_t *obj)
+{
+    // events that are not pending have no parent and are not the root
+    if (obj != queue->root && (obj->parent == NULL ||
+            (obj->parent->left != obj && obj->parent->right != obj))) {
+        return;
+    }
+
+    // find the event before this one in the list
+    ticker_event_t *prev = NULL;
+    if (obj == queue->head) {
+        prev = NULL;
+    } else if (obj->left) {
+        prev = obj->left;
+        while (prev->right) {
+            prev = prev->right;
+        }
+    } else {
+        ticker_event_t *child = obj;
+        prev = obj->parent;
+        while (prev && prev->left == child) {
+            child = prev;
+            prev = prev->parent;
+        }
+    }
+
+    if (prev == NULL) {
+        queue->head = obj->next;
+    } else {
+        prev->next = obj->next;
+    }
+
+    // rotate the event down until it has at most one child, then unlink it
+    while (obj->left && obj->right) {
+        if (event_priority(obj->left) > event_priority(obj->right)) {
+            rotate_up(queue, obj->left);
+        } else {
+            rotate_up(queue, obj->right);
+        }
+    }
+
+    ticker_event_t *child = obj->left ? obj->left : obj->right;
+    if (child) {
+        child->parent = obj->parent;
+    }
+    if (obj->parent == NULL) {
+        queue->root = child;
+    } else if (obj->parent->left == obj) {
+        obj->parent->left = child;
+    } else {
+        obj->parent->right = child;
+    }
+
+    obj->parent = NULL;
+    obj->left = NULL;
+    obj->right = NULL;
+}
+
 void ticker_set_handler(const ticker_data_t *const ticker, ticker_event_handler handler)
 {
     initialize(ticker);
@@ -146,6 +344,23 @@ void ticker_irq_handler(const ticker_data_t *const ticker)
 {
     ticker->interface->clear_interrupt();
 
+#if MBED_CONF_PLATFORM_TICKER_BATCH_TOLERANCE_US > 0
+    /* Fire every event due within the tolerance, including the events the
+     * handlers insert, and reprogram the interrupt once at the end. */
+    update_present_time(ticker);
+    us_timestamp_t horizon = ticker->queue->present_time +
+            MBED_CONF_PLATFORM_TICKER_BATCH_TOLERANCE_US + ticker->queue->set_latency;
+
+    ticker->queue->dispatching = true;
+    while (ticker->queue->head != NULL && ticker->queue->head->timestamp <= horizon) {
+        ticker_event_t *p = ticker->queue->head;
+        queue_remove(ticker->queue, p);
+        if (ticker->queue->event_handler != NULL) {
+            (*ticker->queue->event_handler)(p->id);
+        }
+    }
+    ticker->queue->dispatching = false;
+#else
     /* Go through all the pending TimerEvents */
     while (1) {
         if (ticker->queue->head == NULL) {
@@ -155,11 +370,13 @@ void ticker_irq_handler(const ticker_data_t *const ticker)
         // update the current timestamp used by the queue 
         update_present_time(ticker);
 
-        if (ticker->queue->head->timestamp <= ticker->queue->present_time) { 
+        // events closer than the interrupt can be programmed fired this
+        // interrupt, as in schedule_interrupt, so they are run now
+        if (ticker->queue->head->timestamp <= ticker->queue->present_time + ticker->queue->set_latency) {
             // This event was in the past:
             //      point to the following one and execute its handler
             ticker_event_t *p = ticker->queue->head;
-            ticker->queue->head = ticker->queue->head->next;
+            queue_remove(ticker->queue, p);
             if (ticker->queue->event_handler != NULL) {
                 (*ticker->queue->event_handler)(p->id); // NOTE: the handler can set new events
             }
@@ -169,6 +386,7 @@ void ticker_irq_handler(const ticker_data_t *const ticker)
             break;
         } 
     }
+#endif
 
     schedule_interrupt(ticker);
 }
@@ -203,29 +421,7 @@ void ticker_insert_event_us(const ticker_data_t *const ticker, ticker_event_t *o
     obj->timestamp = timestamp;
     obj->id = id;
 
-    /* Go through the list until we either reach the end, or find
-       an element this should come before (which is possibly the
-       head). */
-    ticker_event_t *prev = NULL, *p = ticker->queue->head;
-    while (p != NULL) {
-        /* check if we come before p */
-        if (timestamp < p->timestamp) {
-            break;
-        }
-        /* go to the next element */
-        prev = p;
-        p = p->next;
-    }
-    
-    /* if we're at the end p will be NULL, which is correct */
-    obj->next = p;
-
-    /* if prev is NULL we're at the head */
-    if (prev == NULL) {
-        ticker->queue->head = obj;
-    } else {
-        prev->next = obj;
-    }
+    queue_insert(ticker->queue, obj);
 
     schedule_interrupt(ticker);
 
@@ -239,18 +435,10 @@ void ticker_remove_event(const ticker_data_t *const ticker, ticker_event_t *obj)
     // remove this object from the list
     if (ticker->queue->head == obj) {
         // first in the list, so just drop me
-        ticker->queue->head = obj->next;
+        queue_remove(ticker->queue, obj);
         schedule_interrupt(ticker);
     } else {
-        // find the object before me, then drop me
-        ticker_event_t* p = ticker->queue->head;
-        while (p != NULL) {
-            if (p->next == obj) {
-                p->next = obj->next;
-                break;
-            }
-            p = p->next;
-        }
+        queue_remove(ticker->queue, obj);
     }
 
     core_util_critical_section_exit();
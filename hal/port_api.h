@@ -21,6 +21,11 @@
 
 #include "device.h"
 
+#if DEVICE_PORTOUT_ASYNCH
+#include <stddef.h>
+#include "hal/dma_api.h"
+#endif
+
 #if DEVICE_PORTIN || DEVICE_PORTOUT
 
 #ifdef __cplusplus
@@ -44,6 +49,18 @@ typedef struct port_s port_t;
  */
 PinName port_pin(PortName port, int pin_n);
 
+/** Get the port and the port's pin number of a pin
+ *
+ * This is the inverse of port_pin. Targets that do not implement it
+ * report every pin as not belonging to a port.
+ *
+ * @param pin   The pin name
+ * @param port  Set to the port name of the pin
+ * @param pin_n Set to the pin number within the port
+ * @return Non-zero if the pin belongs to a port, zero otherwise
+ */
+int pin_port(PinName pin, PortName *port, int *pin_n);
+
 /** Initilize the port
  *
  * @param obj  The port object to initialize
@@ -83,6 +100,72 @@ int port_read(port_t *obj);
 
 /**@}*/
 
+#if DEVICE_PORTOUT_ASYNCH
+
+/**
+ * \defgroup hal_port_stream Port output streaming hal functions
+ * @{
+ */
+
+/** The first half of the buffer has been output, only reported when circular */
+#define PORT_EVENT_HALF         (1 << 0)
+/** The whole buffer has been output */
+#define PORT_EVENT_COMPLETE     (1 << 1)
+#define PORT_EVENT_ALL          (PORT_EVENT_HALF | PORT_EVENT_COMPLETE)
+
+/** Get the word a port stream outputs to write a value to the port
+ *
+ * A target keeps the buffer in the form its DMA writes to the port, for
+ * example set and reset bits, so the buffer of a stream is filled with the
+ * words of the port values rather than the values themselves. This
+ * function has a WEAK implementation returning the value.
+ *
+ * @param obj   The port object, initialized as an output
+ * @param value The value to be set, as passed to port_write
+ * @return The word to store in the buffer
+ */
+uint32_t port_stream_word(port_t *obj, int value);
+
+/** Start writing a buffer of words to the port
+ *
+ * A hardware timer paces the writes at rate_hz and DMA moves the words to
+ * the port, so the timing of the output does not depend on the core. The
+ * handler is called when the buffer has been output, and when circular
+ * also when its first half has been output, in which case output continues
+ * from the start of the buffer until port_stream_stop is called.
+ *
+ * This function has a WEAK implementation returning -1, for targets that
+ * can not pace port writes in hardware.
+ *
+ * @param obj      The port object, initialized as an output
+ * @param buffer   The words to output, from port_stream_word
+ * @param length   The number of words, a multiple of 2 when circular
+ * @param rate_hz  The number of words output per second
+ * @param circular Non-zero to output the buffer until stopped
+ * @param handler  The port interrupt handler
+ * @param hint     A suggestion for how to use DMA with this stream
+ * @return 0 if output started, -1 if the port, rate or buffer are not supported
+ */
+int port_stream_start(port_t *obj, const uint32_t *buffer, size_t length, uint32_t rate_hz, int circular,
+                      uint32_t handler, DMAUsage hint);
+
+/** The port stream interrupt handler
+ *
+ * @param obj The port object passed to port_stream_start
+ * @return The events that occurred, PORT_EVENT_*
+ */
+int port_stream_irq_handler_asynch(port_t *obj);
+
+/** Stop writing to the port, the port keeps the last word written
+ *
+ * @param obj The port object passed to port_stream_start
+ */
+void port_stream_stop(port_t *obj);
+
+/**@}*/
+
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -23,6 +23,10 @@
 
 #if DEVICE_PWMOUT
 
+#include <stddef.h>
+#include <stdint.h>
+#include "hal/dma_api.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -109,6 +113,110 @@ void pwmout_pulsewidth_us(pwmout_t *obj, int us);
 
 /**@}*/
 
+/**
+ * \defgroup hal_pwmout_group Pwmout group hal functions
+ *
+ * A group is an array of pwmout objects, the channels of one timer. A target
+ * that supports groups updates all channels of a group at the same period
+ * boundary, by preloading the compare registers, and can stream compare
+ * values to the channels with a DMA burst on each update event.
+ *
+ * @{
+ */
+
+/** The first half of the table has been output, only reported when circular */
+#define PWMOUT_EVENT_HALF       (1 << 0)
+/** The whole table has been output */
+#define PWMOUT_EVENT_COMPLETE   (1 << 1)
+#define PWMOUT_EVENT_ALL        (PWMOUT_EVENT_HALF | PWMOUT_EVENT_COMPLETE)
+
+/** Bind initialized pwmout objects into a group
+ *
+ * This function has a WEAK implementation returning -1, for targets that
+ * can not update channels together. The other group functions then fall
+ * back to updating each channel in turn.
+ *
+ * @param objs  The pwmout objects, initialized with pwmout_init
+ * @param count The number of objects
+ * @return 0 if the channels share a timer and are updated together, -1 otherwise
+ */
+int pwmout_group_init(pwmout_t *objs, size_t count);
+
+/** Set the PWM period of all channels of a group in microseconds
+ *
+ * The duty cycles are kept. This function has a WEAK implementation that
+ * calls pwmout_period_us for each channel.
+ *
+ * @param objs  The pwmout objects passed to pwmout_group_init
+ * @param count The number of objects
+ * @param us    The microsecond period
+ */
+void pwmout_group_period_us(pwmout_t *objs, size_t count, int us);
+
+/** Set the duty-cycles of all channels of a group
+ *
+ * The new duty-cycles take effect together at the next period boundary.
+ * This function has a WEAK implementation that calls pwmout_write for each
+ * channel, which keeps the skew to the time of the writes.
+ *
+ * @param objs    The pwmout objects passed to pwmout_group_init
+ * @param percent A duty-cycle in range <0.0f, 1.0f> for each object
+ * @param count   The number of objects
+ */
+void pwmout_group_write(pwmout_t *objs, const float *percent, size_t count);
+
+/** Get the word a group stream writes to a channel for a duty-cycle
+ *
+ * Words are compare values and are only valid for the period set when they
+ * were made. This function has a WEAK implementation returning the duty-cycle
+ * scaled to 16 bits.
+ *
+ * @param obj     A pwmout object of a group
+ * @param percent The duty-cycle in range <0.0f, 1.0f>
+ * @return The word to store in the table
+ */
+uint32_t pwmout_group_word(pwmout_t *obj, float percent);
+
+/** Start writing a table of duty-cycles to the channels of a group
+ *
+ * The table holds count words per period, one for each channel in the order
+ * of the objects. DMA writes one row of the table on each update event, so
+ * every row lasts one period. The handler is called when the table has been
+ * output, and when circular also when its first half has been output, in
+ * which case output continues from the start of the table until
+ * pwmout_group_stream_stop is called.
+ *
+ * This function has a WEAK implementation returning -1.
+ *
+ * @param objs     The pwmout objects passed to pwmout_group_init
+ * @param count    The number of objects
+ * @param table    The words to output, from pwmout_group_word
+ * @param periods  The number of rows of the table, a multiple of 2 when circular
+ * @param circular Non-zero to output the table until stopped
+ * @param handler  The pwmout interrupt handler
+ * @param hint     A suggestion for how to use DMA with this stream
+ * @return 0 if output started, -1 if the group or table are not supported
+ */
+int pwmout_group_stream_start(pwmout_t *objs, size_t count, const uint32_t *table, size_t periods, int circular,
+                              uint32_t handler, DMAUsage hint);
+
+/** The pwmout group stream interrupt handler
+ *
+ * @param objs  The pwmout objects passed to pwmout_group_stream_start
+ * @param count The number of objects
+ * @return The events that occurred, PWMOUT_EVENT_*
+ */
+int pwmout_group_irq_handler_asynch(pwmout_t *objs, size_t count);
+
+/** Stop writing the table, the channels keep the last duty-cycles written
+ *
+ * @param objs  The pwmout objects passed to pwmout_group_stream_start
+ * @param count The number of objects
+ */
+void pwmout_group_stream_stop(pwmout_t *objs, size_t count);
+
+/**@}*/
+
 #ifdef __cplusplus
 }
 #endif
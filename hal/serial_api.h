@@ -29,7 +29,7 @@
 #define SERIAL_EVENT_RX_SHIFT (8)
 
 #define SERIAL_EVENT_TX_MASK (0x00FC)
-#define SERIAL_EVENT_RX_MASK (0x3F00)
+#define SERIAL_EVENT_RX_MASK (0xFF00)
 
 #define SERIAL_EVENT_ERROR (1 << 1)
 
@@ -56,6 +56,11 @@
 #define SERIAL_EVENT_RX_ALL             (SERIAL_EVENT_RX_OVERFLOW | SERIAL_EVENT_RX_PARITY_ERROR | \
                                          SERIAL_EVENT_RX_FRAMING_ERROR | SERIAL_EVENT_RX_OVERRUN_ERROR | \
                                          SERIAL_EVENT_RX_COMPLETE | SERIAL_EVENT_RX_CHARACTER_MATCH)
+
+/** The line went idle after a character, circular reads only */
+#define SERIAL_EVENT_RX_IDLE            (1 << (SERIAL_EVENT_RX_SHIFT + 6))
+/** The first half of the buffer was filled, circular reads only */
+#define SERIAL_EVENT_RX_HALF            (1 << (SERIAL_EVENT_RX_SHIFT + 7))
 /**@}*/
 
 #define SERIAL_RESERVED_CHAR_MATCH (255)
@@ -292,6 +297,36 @@ void serial_tx_abort_asynch(serial_t *obj);
  */
 void serial_rx_abort_asynch(serial_t *obj);
 
+/** Begin continuous asynchronous RX into a circular buffer
+ *
+ *  Unlike serial_rx_asynch, the transfer does not end when the buffer is
+ *  full, but wraps around to its start and keeps receiving until
+ *  serial_rx_abort_asynch is called. The handler is called for each of the
+ *  registered events, SERIAL_EVENT_RX_HALF and SERIAL_EVENT_RX_COMPLETE
+ *  when the first and second half of the buffer have been filled, and
+ *  SERIAL_EVENT_RX_IDLE when the line goes idle after a character, and
+ *  serial_rx_circular_position tells how far the data has got.
+ *
+ *  This function has a WEAK implementation returning -1, for targets that
+ *  can only do single reads.
+ *
+ * @param obj        The serial object
+ * @param rx         The receive buffer
+ * @param rx_length  The size of the buffer in bytes
+ * @param handler    The serial handler
+ * @param event      The logical OR of events to be registered
+ * @param hint       A suggestion for how to use DMA with this transfer
+ * @return 0 if reception started, -1 if circular reads are not supported
+ */
+int serial_rx_circular_asynch(serial_t *obj, void *rx, size_t rx_length, uint32_t handler, uint32_t event, DMAUsage hint);
+
+/** Get the write position of a circular read
+ *
+ * @param obj The serial object
+ * @return The index in the buffer the next received byte will be written to
+ */
+size_t serial_rx_circular_position(serial_t *obj);
+
 /**@}*/
 
 #endif
@@ -29,6 +29,7 @@
 #define SPI_EVENT_COMPLETE    (1 << 2)
 #define SPI_EVENT_RX_OVERFLOW (1 << 3)
 #define SPI_EVENT_ALL         (SPI_EVENT_ERROR | SPI_EVENT_COMPLETE | SPI_EVENT_RX_OVERFLOW)
+#define SPI_EVENT_SLAVE_DESELECTED (1 << 4) // The master released SSEL before the slave transfer was complete
 
 #define SPI_EVENT_INTERNAL_TRANSFER_COMPLETE (1 << 30) // Internal flag to report that an event occurred
 
@@ -174,6 +175,63 @@ uint8_t spi_get_module(spi_t *obj);
 
 /**@}*/
 
+#if DEVICE_SPISLAVE_ASYNCH
+/**
+ * \defgroup AsynchSPISlave Asynchronous SPI Slave Hardware Abstraction Layer
+ *
+ * The whole transfer is armed before the master selects the slave, so
+ * frames are moved by DMA or the SPI interrupt however fast the master
+ * clocks them. The weak implementations in hal/mbed_spi_api.c report
+ * that the target can not transfer as a slave in the background.
+ *
+ * @{
+ */
+
+/** Arm a slave transfer for the next time the master selects the slave
+ *
+ * The transmit buffer is preloaded, so the first frame the master clocks
+ * out already carries tx[0]. Once tx is exhausted the slave sends
+ * SPI_FILL_WORD. The transfer ends with SPI_EVENT_COMPLETE when rx_length
+ * words have been received, or with SPI_EVENT_SLAVE_DESELECTED when the
+ * master releases SSEL first.
+ *
+ * @param[in] obj       The SPI object, configured as slave
+ * @param[in] tx        The transmit buffer, may be NULL
+ * @param[in] tx_length The number of words to transmit
+ * @param[in] rx        The receive buffer, may be NULL
+ * @param[in] rx_length The number of words to receive
+ * @param[in] bit_width The bit width of buffer words
+ * @param[in] handler   SPI interrupt handler
+ * @param[in] event     The logical OR of events to be registered
+ * @param[in] hint      A suggestion for how to use DMA with this transfer
+ * @return 0 if the transfer is armed, -1 if the target can not transfer as a slave
+ */
+int spi_slave_transfer_asynch(spi_t *obj, const void *tx, size_t tx_length, void *rx, size_t rx_length,
+                              uint8_t bit_width, uint32_t handler, uint32_t event, DMAUsage hint);
+
+/** The asynchronous slave IRQ handler
+ *
+ * @param[in] obj The SPI object that holds the transfer information
+ * @return Event flags if the transfer ended; otherwise 0
+ */
+uint32_t spi_slave_irq_handler_asynch(spi_t *obj);
+
+/** Get the number of words exchanged by the last slave transfer
+ *
+ * @param[in] obj The SPI object
+ * @return The number of frames the master clocked
+ */
+size_t spi_slave_transfer_count(spi_t *obj);
+
+/** Disarm or abort a slave transfer
+ *
+ * @param[in] obj The SPI object
+ */
+void spi_slave_abort_asynch(spi_t *obj);
+
+/**@}*/
+#endif
+
 #if DEVICE_SPI_ASYNCH
 /**
  * \defgroup AsynchSPI Asynchronous SPI Hardware Abstraction Layer
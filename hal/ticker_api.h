@@ -43,11 +43,18 @@ typedef uint32_t timestamp_t;
 typedef uint64_t us_timestamp_t;
 
 /** Ticker's event structure
+ *
+ * Pending events are kept in a list sorted by timestamp, linked through next,
+ * and indexed by a search tree so inserting and removing an event takes
+ * logarithmic time in the number of pending events.
  */
 typedef struct ticker_event_s {
     us_timestamp_t         timestamp; /**< Event's timestamp */
     uint32_t               id;        /**< TimerEvent object */
     struct ticker_event_s *next;      /**< Next event in the queue */
+    struct ticker_event_s *parent;    /**< Parent event in the queue's tree */
+    struct ticker_event_s *left;      /**< Earlier events in the queue's tree */
+    struct ticker_event_s *right;     /**< Later events in the queue's tree */
 } ticker_event_t;
 
 typedef void (*ticker_event_handler)(uint32_t id);
@@ -70,6 +77,9 @@ typedef struct {
     ticker_event_t *head;               /**< A pointer to head */
     us_timestamp_t present_time;        /**< Store the timestamp used for present time */
     bool initialized;                   /**< Indicate if the instance is initialized */
+    ticker_event_t *root;               /**< A pointer to the root of the event tree */
+    uint32_t set_latency;               /**< Measured time to program the interrupt, in us */
+    bool dispatching;                   /**< Indicate if the irq handler is firing events */
 } ticker_event_queue_t;
 
 /** Ticker's data structure
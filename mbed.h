@@ -58,18 +58,27 @@
 #include "drivers/PortInOut.h"
 #include "drivers/PortOut.h"
 #include "drivers/AnalogIn.h"
+#include "drivers/AnalogInStream.h"
+#include "drivers/PortOutStream.h"
+#include "drivers/InputCapture.h"
 #include "drivers/AnalogOut.h"
 #include "drivers/PwmOut.h"
+#include "drivers/PwmGroup.h"
 #include "drivers/Serial.h"
 #include "drivers/SPI.h"
+#include "drivers/SPIBus.h"
 #include "drivers/SPISlave.h"
 #include "drivers/I2C.h"
+#include "drivers/I2CBus.h"
 #include "drivers/I2CSlave.h"
 #include "drivers/Ethernet.h"
 #include "drivers/CAN.h"
 #include "drivers/RawSerial.h"
 #include "drivers/UARTSerial.h"
 #include "drivers/FlashIAP.h"
+#include "drivers/FlashIAPWriter.h"
+#include "drivers/DeltaUpdate.h"
+#include "drivers/MbedCRC.h"
 
 // mbed Internal components
 #include "drivers/Timer.h"
@@ -78,6 +87,7 @@
 #include "drivers/LowPowerTimeout.h"
 #include "drivers/LowPowerTicker.h"
 #include "drivers/LowPowerTimer.h"
+#include "drivers/ResolutionTimer.h"
 #include "platform/LocalFileSystem.h"
 #include "drivers/InterruptIn.h"
 #include "platform/mbed_wait_api.h"
@@ -85,12 +95,17 @@
 #include "platform/mbed_sleep.h"
 #include "platform/mbed_rtc_time.h"
 #include "platform/mbed_poll.h"
+#include "platform/mbed_dcache.h"
+#include "platform/mbed_heap_regions.h"
+#include "platform/mbed_irq.h"
 #include "platform/ATCmdParser.h"
 #include "platform/FileSystemHandle.h"
 #include "platform/FileHandle.h"
 #include "platform/DirHandle.h"
 #include "platform/CriticalSectionLock.h"
 #include "platform/DeepSleepLock.h"
+#include "platform/Atomic.h"
+#include "platform/CycleCounter.h"
 
 // mbed Non-hardware components
 #include "platform/Callback.h"
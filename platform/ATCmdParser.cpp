@@ -380,3 +380,249 @@ void ATCmdParser::abort()
 {
     _aborted = true;
 }
+
+// oob line registration
+void ATCmdParser::oob_line(const char *prefix, Callback<void(const char *)> cb)
+{
+    struct oob_line *oob = new struct oob_line;
+    oob->len = strlen(prefix);
+    oob->prefix = prefix;
+    oob->cb = cb;
+    oob->next = _oob_lines;
+    _oob_lines = oob;
+}
+
+
+// Asynchronous command handling
+bool ATCmdParser::vsend_async(Callback<void(int)> done, Callback<void(const char *)> lines,
+                              const char *command, va_list args)
+{
+    // Commands are limited to the buffer size, as with send()
+    char *buffer = new char[_buffer_size];
+    int size = vsnprintf(buffer, _buffer_size, command, args);
+    if (size < 0 || size >= _buffer_size) {
+        delete[] buffer;
+        return false;
+    }
+
+    async_cmd *cmd = new async_cmd;
+    cmd->command = new char[size + 1];
+    memcpy(cmd->command, buffer, size + 1);
+    delete[] buffer;
+    cmd->sent = false;
+    cmd->done = done;
+    cmd->lines = lines;
+    cmd->next = NULL;
+
+    async_cmd **tail = &_cmds;
+    while (*tail) {
+        tail = &(*tail)->next;
+    }
+    *tail = cmd;
+
+    async_start();
+    return true;
+}
+
+bool ATCmdParser::send_async(Callback<void(int)> done, Callback<void(const char *)> lines,
+                             const char *command, ...)
+{
+    va_list args;
+    va_start(args, command);
+    bool res = vsend_async(done, lines, command, args);
+    va_end(args);
+    return res;
+}
+
+bool ATCmdParser::async_send_line(const char *command)
+{
+    int size = strlen(command);
+    if (write(command, size) != size ||
+        write(_output_delimiter, _output_delim_size) != _output_delim_size) {
+        return false;
+    }
+
+    debug_if(_dbg_on, "AT> %s\n", command);
+    return true;
+}
+
+void ATCmdParser::async_start()
+{
+    // Send the first command unless it is already waiting for its response,
+    // commands that cannot be sent fail right away
+    while (_cmds && !_cmds->sent) {
+        _cmds->sent = true;
+        if (async_send_line(_cmds->command)) {
+#if MBED_CONF_EVENTS_PRESENT
+            if (_queue) {
+                _timeout_id = _queue->call_in(_timeout, this, &ATCmdParser::async_timeout);
+            }
+#endif
+            return;
+        }
+        async_complete(ASYNC_ERROR);
+    }
+}
+
+void ATCmdParser::async_complete(int result)
+{
+#if MBED_CONF_EVENTS_PRESENT
+    if (_timeout_id) {
+        _queue->cancel(_timeout_id);
+        _timeout_id = 0;
+    }
+#endif
+
+    // Unlink the command first, the callback may queue more
+    async_cmd *cmd = _cmds;
+    _cmds = cmd->next;
+    if (cmd->done) {
+        cmd->done(result);
+    }
+    delete[] cmd->command;
+    delete cmd;
+}
+
+void ATCmdParser::abort_async()
+{
+    while (_cmds) {
+        async_complete(ASYNC_ABORTED);
+    }
+}
+
+// Final result codes which end a command with an error
+static const char *const async_errors[] = {
+    "ERROR", "+CME ERROR", "+CMS ERROR", "NO CARRIER", "BUSY", "NO ANSWER", "NO DIALTONE",
+};
+
+void ATCmdParser::async_line(const char *line)
+{
+    if (!line[0]) {
+        return;
+    }
+
+    for (struct oob_line *oob = _oob_lines; oob; oob = oob->next) {
+        if (strncmp(line, oob->prefix, oob->len) == 0) {
+            debug_if(_dbg_on, "AT! %s\n", line);
+            oob->cb(line);
+            return;
+        }
+    }
+
+    if (!_cmds || !_cmds->sent) {
+        debug_if(_dbg_on, "AT< %s\n", line);
+        return;
+    }
+
+    debug_if(_dbg_on, "AT= %s\n", line);
+    if (strcmp(line, "OK") == 0) {
+        async_complete(ASYNC_OK);
+        async_start();
+        return;
+    }
+
+    if (_cmds->lines) {
+        _cmds->lines(line);
+    }
+
+    for (size_t i = 0; i < sizeof(async_errors) / sizeof(async_errors[0]); i++) {
+        if (strncmp(line, async_errors[i], strlen(async_errors[i])) == 0) {
+            async_complete(ASYNC_ERROR);
+            async_start();
+            return;
+        }
+    }
+}
+
+void ATCmdParser::process()
+{
+#if MBED_CONF_EVENTS_PRESENT
+    // Cleared before reading, so data arriving from now on posts again
+    _process_id = 0;
+#endif
+
+    while (_fh->readable()) {
+        char c;
+        if (_fh->read(&c, 1) != 1) {
+            break;
+        }
+        // Simplify newlines as in vrecv
+        if ((c == CR && _in_prev != LF) ||
+            (c == LF && _in_prev != CR)) {
+            _in_prev = c;
+            c = '\n';
+        } else if ((c == CR && _in_prev == LF) ||
+                   (c == LF && _in_prev == CR)) {
+            _in_prev = c;
+            continue;
+        } else {
+            _in_prev = c;
+        }
+
+        if (c == '\n' || _line_len + 1 >= _buffer_size) {
+            if (c != '\n') {
+                _buffer[_line_len++] = c;
+            }
+            _buffer[_line_len] = 0;
+            _line_len = 0;
+            async_line(_buffer);
+            continue;
+        }
+
+        _buffer[_line_len++] = c;
+        _buffer[_line_len] = 0;
+
+        // oob handlers read the rest of their data themselves
+        for (struct oob *oob = _oobs; oob; oob = oob->next) {
+            if ((unsigned)_line_len == oob->len &&
+                    memcmp(oob->prefix, _buffer, oob->len) == 0) {
+                debug_if(_dbg_on, "AT! %s\n", oob->prefix);
+                _line_len = 0;
+                oob->cb();
+                break;
+            }
+        }
+    }
+}
+
+#if MBED_CONF_EVENTS_PRESENT
+void ATCmdParser::async_sigio()
+{
+    // Called from interrupt context, so processing is deferred to the
+    // queue, and posted only once until it runs
+    if (!_process_id) {
+        _process_id = _queue->call(this, &ATCmdParser::process);
+    }
+}
+
+void ATCmdParser::async_timeout()
+{
+    _timeout_id = 0;
+    if (_cmds && _cmds->sent) {
+        debug_if(_dbg_on, "AT(Timeout) %s\n", _cmds->command);
+        // Drop any partial line of the abandoned response
+        _line_len = 0;
+        async_complete(ASYNC_TIMEOUT);
+        async_start();
+    }
+}
+
+void ATCmdParser::attach_async(events::EventQueue *queue)
+{
+    if (_queue) {
+        _fh->sigio(NULL);
+        abort_async();
+        if (_process_id) {
+            _queue->cancel(_process_id);
+            _process_id = 0;
+        }
+    }
+
+    _queue = queue;
+    if (_queue) {
+        _fh->sigio(callback(this, &ATCmdParser::async_sigio));
+        // Pick up data which arrived before the stream was attached
+        async_sigio();
+    }
+}
+#endif
@@ -23,6 +23,9 @@
 #include "mbed.h"
 #include <cstdarg>
 #include "Callback.h"
+#if MBED_CONF_EVENTS_PRESENT
+#include "events/EventQueue.h"
+#endif
 
 /**
  * Parser class for parsing AT commands
@@ -41,6 +44,18 @@
  * at.read(buffer, value);
  * at.recv("OK");
  * @endcode
+ *
+ * Commands can also be queued without blocking, with their responses
+ * and out-of-band data dispatched from an event queue as they arrive:
+ * @code
+ * void done(int result);
+ * void line(const char *line);
+ *
+ * at.attach_async(mbed_event_queue());
+ * at.oob_line("+CREG:", callback(line));
+ * at.send_async(callback(done), NULL, "AT+CREG=2");
+ * at.send_async(callback(done), callback(line), "AT+CSQ");
+ * @endcode
  */
 
 namespace mbed {
@@ -71,8 +86,51 @@ private:
     };
     oob *_oobs;
 
+    struct oob_line {
+        unsigned len;
+        const char *prefix;
+        mbed::Callback<void(const char *)> cb;
+        oob_line *next;
+    };
+    oob_line *_oob_lines;
+
+    // Queued asynchronous commands, the first one is awaiting its response
+    struct async_cmd {
+        char *command;
+        bool sent;
+        mbed::Callback<void(int)> done;
+        mbed::Callback<void(const char *)> lines;
+        async_cmd *next;
+    };
+    async_cmd *_cmds;
+    int _line_len;
+
+#if MBED_CONF_EVENTS_PRESENT
+    events::EventQueue *_queue;
+    int _timeout_id;
+    volatile int _process_id;
+
+    void async_sigio();
+    void async_timeout();
+#endif
+
+    bool async_send_line(const char *command);
+    void async_start();
+    void async_complete(int result);
+    void async_line(const char *line);
+
 public:
 
+    /**
+     * Results passed to the callbacks of asynchronous commands
+     */
+    enum async_result {
+        ASYNC_OK = 0,           /**< The command ended with OK */
+        ASYNC_ERROR = -1,       /**< The command ended with an error, or could not be sent */
+        ASYNC_TIMEOUT = -2,     /**< No final result arrived within the timeout */
+        ASYNC_ABORTED = -3,     /**< The command was aborted before its final result */
+    };
+
     /**
      * Constructor
      *
@@ -84,7 +142,11 @@ public:
      */
     ATCmdParser(FileHandle *fh, const char *output_delimiter = "\r",
              int buffer_size = 256, int timeout = 8000, bool debug = false)
-            : _fh(fh), _buffer_size(buffer_size), _in_prev(0), _oobs(NULL)
+            : _fh(fh), _buffer_size(buffer_size), _in_prev(0), _oobs(NULL),
+              _oob_lines(NULL), _cmds(NULL), _line_len(0)
+#if MBED_CONF_EVENTS_PRESENT
+            , _queue(NULL), _timeout_id(0), _process_id(0)
+#endif
     {
         _buffer = new char[buffer_size];
         set_timeout(timeout);
@@ -97,6 +159,20 @@ public:
      */
     ~ATCmdParser()
     {
+#if MBED_CONF_EVENTS_PRESENT
+        attach_async(NULL);
+#endif
+        while (_cmds) {
+            async_cmd *cmd = _cmds;
+            _cmds = cmd->next;
+            delete[] cmd->command;
+            delete cmd;
+        }
+        while (_oob_lines) {
+            struct oob_line *oob = _oob_lines;
+            _oob_lines = oob->next;
+            delete oob;
+        }
         while (_oobs) {
             struct oob *oob = _oobs;
             _oobs = oob->next;
@@ -288,6 +364,83 @@ public:
      * recv operation.
      */
     void abort();
+
+    /**
+     * Queue an AT command without waiting for its response
+     *
+     * Commands are sent one at a time in the order they are queued, each
+     * as soon as the one before it has its final result, so a caller can
+     * pipeline several commands without a thread blocked on each. The
+     * response lines are dispatched while process() runs, which the event
+     * queue given to attach_async() does whenever data arrives.
+     *
+     * A line of OK ends a command with ASYNC_OK, and ERROR, +CME ERROR,
+     * +CMS ERROR, NO CARRIER, BUSY, NO ANSWER or NO DIALTONE end it with
+     * ASYNC_ERROR. Commands that get no final result within the timeout
+     * of the parser end with ASYNC_TIMEOUT, when an event queue is attached.
+     *
+     * @param done     callback called with the async_result of the command
+     * @param lines    callback called with each line of the response apart
+     *                 from OK, including error lines so their codes can be
+     *                 parsed, or NULL to ignore them
+     * @param command  printf-like format string of command to send which
+     *                 is appended with a newline
+     * @param ...      all printf-like arguments to insert into command
+     * @return true if the command was queued
+     *
+     * @note The callbacks, and any other use of the parser while commands
+     *       are queued, run in the context of process(). The line passed
+     *       is only valid during the callback, which must not call recv().
+     *       Command echo should be turned off with ATE0.
+     */
+    bool send_async(mbed::Callback<void(int)> done, mbed::Callback<void(const char *)> lines,
+                    const char *command, ...) MBED_PRINTF_METHOD(3,4);
+
+    bool vsend_async(mbed::Callback<void(int)> done, mbed::Callback<void(const char *)> lines,
+                     const char *command, va_list args);
+
+    /**
+     * Attach a callback for out-of-band lines
+     *
+     * Unlike oob(), the callback gets the whole line once it has arrived,
+     * so it does not need to read the rest of it with recv(). These
+     * callbacks are only called from process().
+     *
+     * @param prefix string a line has to start with to initiate callback
+     * @param func callback to call with the line, without its newline
+     */
+    void oob_line(const char *prefix, mbed::Callback<void(const char *)> func);
+
+    /**
+     * Handle the data available on the underlying stream without blocking
+     *
+     * Reads complete lines, dispatching out-of-band data and the responses
+     * of queued commands. Lines that match neither are discarded. The oob()
+     * callbacks are also called, when the prefix they match arrives.
+     */
+    void process();
+
+#if MBED_CONF_EVENTS_PRESENT
+    /**
+     * Process incoming data from an event queue
+     *
+     * Each time the underlying stream signals that data arrived, a call
+     * to process() is posted to the queue, which also runs the timeouts of
+     * queued commands. Blocking recv() calls should not be used from other
+     * threads while the parser is attached.
+     *
+     * @param queue the event queue to dispatch from, or NULL to detach,
+     *              which aborts any queued commands
+     */
+    void attach_async(events::EventQueue *queue);
+#endif
+
+    /**
+     * Abort all queued asynchronous commands
+     *
+     * The done callback of each command is called with ASYNC_ABORTED.
+     */
+    void abort_async();
 };
 } //namespace mbed
 
@@ -0,0 +1,337 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MBED_ATOMIC_H
+#define MBED_ATOMIC_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "platform/mbed_critical.h"
+#include "platform/NonCopyable.h"
+
+namespace mbed {
+/** \addtogroup platform */
+
+namespace detail {
+
+// The core_util_atomic functions for each size of value
+template <size_t N>
+struct atomic_ops;
+
+template <>
+struct atomic_ops<1> {
+    typedef uint8_t type;
+    static type load(const type *p) { return core_util_atomic_load_u8(p); }
+    static void store(type *p, type v) { core_util_atomic_store_u8(p, v); }
+    static type exchange(type *p, type v) { return core_util_atomic_exchange_u8(p, v); }
+    static bool cas(type *p, type *expected, type v) { return core_util_atomic_cas_u8(p, expected, v); }
+    static type incr(type *p, type v) { return core_util_atomic_incr_u8(p, v); }
+    static type decr(type *p, type v) { return core_util_atomic_decr_u8(p, v); }
+    static type fetch_and(type *p, type v) { return core_util_atomic_fetch_and_u8(p, v); }
+    static type fetch_or(type *p, type v) { return core_util_atomic_fetch_or_u8(p, v); }
+    static type fetch_xor(type *p, type v) { return core_util_atomic_fetch_xor_u8(p, v); }
+};
+
+template <>
+struct atomic_ops<2> {
+    typedef uint16_t type;
+    static type load(const type *p) { return core_util_atomic_load_u16(p); }
+    static void store(type *p, type v) { core_util_atomic_store_u16(p, v); }
+    static type exchange(type *p, type v) { return core_util_atomic_exchange_u16(p, v); }
+    static bool cas(type *p, type *expected, type v) { return core_util_atomic_cas_u16(p, expected, v); }
+    static type incr(type *p, type v) { return core_util_atomic_incr_u16(p, v); }
+    static type decr(type *p, type v) { return core_util_atomic_decr_u16(p, v); }
+    static type fetch_and(type *p, type v) { return core_util_atomic_fetch_and_u16(p, v); }
+    static type fetch_or(type *p, type v) { return core_util_atomic_fetch_or_u16(p, v); }
+    static type fetch_xor(type *p, type v) { return core_util_atomic_fetch_xor_u16(p, v); }
+};
+
+template <>
+struct atomic_ops<4> {
+    typedef uint32_t type;
+    static type load(const type *p) { return core_util_atomic_load_u32(p); }
+    static void store(type *p, type v) { core_util_atomic_store_u32(p, v); }
+    static type exchange(type *p, type v) { return core_util_atomic_exchange_u32(p, v); }
+    static bool cas(type *p, type *expected, type v) { return core_util_atomic_cas_u32(p, expected, v); }
+    static type incr(type *p, type v) { return core_util_atomic_incr_u32(p, v); }
+    static type decr(type *p, type v) { return core_util_atomic_decr_u32(p, v); }
+    static type fetch_and(type *p, type v) { return core_util_atomic_fetch_and_u32(p, v); }
+    static type fetch_or(type *p, type v) { return core_util_atomic_fetch_or_u32(p, v); }
+    static type fetch_xor(type *p, type v) { return core_util_atomic_fetch_xor_u32(p, v); }
+};
+
+template <>
+struct atomic_ops<8> {
+    typedef uint64_t type;
+    static type load(const type *p) { return core_util_atomic_load_u64(p); }
+    static void store(type *p, type v) { core_util_atomic_store_u64(p, v); }
+    static type exchange(type *p, type v) { return core_util_atomic_exchange_u64(p, v); }
+    static bool cas(type *p, type *expected, type v) { return core_util_atomic_cas_u64(p, expected, v); }
+    static type incr(type *p, type v) { return core_util_atomic_incr_u64(p, v); }
+    static type decr(type *p, type v) { return core_util_atomic_decr_u64(p, v); }
+
+    // there are no 64-bit bitwise functions, a compare and set loop does the same
+    static type fetch_and(type *p, type v) {
+        type current = *p;
+        while (!cas(p, &current, current & v)) {
+        }
+        return current;
+    }
+
+    static type fetch_or(type *p, type v) {
+        type current = *p;
+        while (!cas(p, &current, current | v)) {
+        }
+        return current;
+    }
+
+    static type fetch_xor(type *p, type v) {
+        type current = *p;
+        while (!cas(p, &current, current ^ v)) {
+        }
+        return current;
+    }
+};
+
+}
+
+/** An integer, enum or bool variable accessed atomically
+ *
+ * Atomic wraps the core_util_atomic functions, so it uses exclusive
+ * accesses on cores that have them and a critical section on the others,
+ * such as Cortex-M0. Loads have acquire semantics and stores have release
+ * semantics. 64-bit values always use a critical section.
+ *
+ * @note Synchronization level: Interrupt safe
+ *
+ * Example:
+ * @code
+ * Atomic<uint32_t> events;
+ *
+ * void on_rx() {
+ *     events |= RX_EVENT;     // from an interrupt, without a critical section
+ * }
+ *
+ * void thread() {
+ *     uint32_t pending = events.exchange(0);
+ *     ...
+ * }
+ * @endcode
+ * @ingroup platform
+ */
+template <typename T>
+class Atomic : private NonCopyable<Atomic<T> > {
+    typedef detail::atomic_ops<sizeof(T)> ops;
+    typedef typename ops::type U;
+
+public:
+    /** Create an Atomic holding zero
+     */
+    Atomic() : _value(0) {}
+
+    /** Create an Atomic holding a value
+     *
+     *  @param value The initial value
+     */
+    Atomic(T value) : _value((U)value) {}
+
+    /** Read the value
+     */
+    T load() const {
+        return (T)ops::load(&_value);
+    }
+
+    /** Write the value
+     *
+     *  @param value The value to write
+     */
+    void store(T value) {
+        ops::store(&_value, (U)value);
+    }
+
+    /** Write the value and return the previous one
+     *
+     *  @param value The value to write
+     *  @return The previous value
+     */
+    T exchange(T value) {
+        return (T)ops::exchange(&_value, (U)value);
+    }
+
+    /** Write the value if it holds the expected value
+     *
+     *  @param expected The expected value, set to the current value on failure
+     *  @param desired  The value to write
+     *  @return True if the value was written, false otherwise
+     */
+    bool compare_exchange(T &expected, T desired) {
+        U current = (U)expected;
+        bool done = ops::cas(&_value, &current, (U)desired);
+        expected = (T)current;
+        return done;
+    }
+
+    /** Add to the value and return the previous one
+     */
+    T fetch_add(T arg) {
+        return (T)(ops::incr(&_value, (U)arg) - (U)arg);
+    }
+
+    /** Subtract from the value and return the previous one
+     */
+    T fetch_sub(T arg) {
+        return (T)(ops::decr(&_value, (U)arg) + (U)arg);
+    }
+
+    /** AND the value with an argument and return the previous value
+     */
+    T fetch_and(T arg) {
+        return (T)ops::fetch_and(&_value, (U)arg);
+    }
+
+    /** OR the value with an argument and return the previous value
+     */
+    T fetch_or(T arg) {
+        return (T)ops::fetch_or(&_value, (U)arg);
+    }
+
+    /** Exclusive OR the value with an argument and return the previous value
+     */
+    T fetch_xor(T arg) {
+        return (T)ops::fetch_xor(&_value, (U)arg);
+    }
+
+    /** A shorthand for load()
+     */
+    operator T() const {
+        return load();
+    }
+
+    /** A shorthand for store()
+     */
+    T operator=(T value) {
+        store(value);
+        return value;
+    }
+
+    T operator++() { return (T)ops::incr(&_value, 1); }
+    T operator--() { return (T)ops::decr(&_value, 1); }
+    T operator++(int) { return fetch_add(1); }
+    T operator--(int) { return fetch_sub(1); }
+    T operator+=(T arg) { return (T)ops::incr(&_value, (U)arg); }
+    T operator-=(T arg) { return (T)ops::decr(&_value, (U)arg); }
+    T operator&=(T arg) { return fetch_and(arg) & arg; }
+    T operator|=(T arg) { return fetch_or(arg) | arg; }
+    T operator^=(T arg) { return fetch_xor(arg) ^ arg; }
+
+private:
+    U _value;
+};
+
+/** A pointer accessed atomically
+ *
+ * Arithmetic moves the pointer by whole elements, as for a plain pointer.
+ *
+ * @note Synchronization level: Interrupt safe
+ * @ingroup platform
+ */
+template <typename T>
+class Atomic<T *> : private NonCopyable<Atomic<T *> > {
+public:
+    /** Create an Atomic holding NULL
+     */
+    Atomic() : _value(NULL) {}
+
+    /** Create an Atomic holding a pointer
+     *
+     *  @param value The initial pointer
+     */
+    Atomic(T *value) : _value(value) {}
+
+    /** Read the pointer
+     */
+    T *load() const {
+        return static_cast<T *>(core_util_atomic_load_ptr(&_value));
+    }
+
+    /** Write the pointer
+     *
+     *  @param value The pointer to write
+     */
+    void store(T *value) {
+        core_util_atomic_store_ptr(&_value, value);
+    }
+
+    /** Write the pointer and return the previous one
+     *
+     *  @param value The pointer to write
+     *  @return The previous pointer
+     */
+    T *exchange(T *value) {
+        return static_cast<T *>(core_util_atomic_exchange_ptr(&_value, value));
+    }
+
+    /** Write the pointer if it holds the expected pointer
+     *
+     *  @param expected The expected pointer, set to the current pointer on failure
+     *  @param desired  The pointer to write
+     *  @return True if the pointer was written, false otherwise
+     */
+    bool compare_exchange(T *&expected, T *desired) {
+        void *current = expected;
+        bool done = core_util_atomic_cas_ptr(&_value, &current, desired);
+        expected = static_cast<T *>(current);
+        return done;
+    }
+
+    /** Move the pointer forward and return the previous one
+     */
+    T *fetch_add(ptrdiff_t arg) {
+        return static_cast<T *>(core_util_atomic_incr_ptr(&_value, arg * sizeof(T))) - arg;
+    }
+
+    /** Move the pointer back and return the previous one
+     */
+    T *fetch_sub(ptrdiff_t arg) {
+        return static_cast<T *>(core_util_atomic_decr_ptr(&_value, arg * sizeof(T))) + arg;
+    }
+
+    /** A shorthand for load()
+     */
+    operator T *() const {
+        return load();
+    }
+
+    /** A shorthand for store()
+     */
+    T *operator=(T *value) {
+        store(value);
+        return value;
+    }
+
+    T *operator++() { return static_cast<T *>(core_util_atomic_incr_ptr(&_value, sizeof(T))); }
+    T *operator--() { return static_cast<T *>(core_util_atomic_decr_ptr(&_value, sizeof(T))); }
+    T *operator++(int) { return fetch_add(1); }
+    T *operator--(int) { return fetch_sub(1); }
+    T *operator+=(ptrdiff_t arg) { return static_cast<T *>(core_util_atomic_incr_ptr(&_value, arg * sizeof(T))); }
+    T *operator-=(ptrdiff_t arg) { return static_cast<T *>(core_util_atomic_decr_ptr(&_value, arg * sizeof(T))); }
+
+private:
+    void *_value;
+};
+
+} // namespace mbed
+
+#endif
@@ -34,6 +34,8 @@
 #ifndef __CTHUNK_H__
 #define __CTHUNK_H__
 
+#include "platform/mbed_dcache.h"
+
 #define CTHUNK_ADDRESS 1
 #define CTHUNK_VARIABLES volatile uint32_t code[2]
 
@@ -233,7 +235,7 @@ class CThunk
 #endif
 #if defined(__CORTEX_M7)
             /* Data cache clean and invalid */
-            SCB_CleanInvalidateDCache();
+            mbed_dcache_clean_invalidate(&m_thunk, sizeof(m_thunk));
 
             /* Instruction cache invalid */
             SCB_InvalidateICache();
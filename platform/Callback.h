@@ -22,6 +22,10 @@
 #include "platform/mbed_assert.h"
 #include "platform/mbed_toolchain.h"
 
+#ifndef MBED_CONF_PLATFORM_CALLBACK_EXTRA_STORAGE
+#define MBED_CONF_PLATFORM_CALLBACK_EXTRA_STORAGE 0
+#endif
+
 namespace mbed {
 /** \addtogroup platform */
 
@@ -56,12 +60,29 @@ namespace detail {
     struct is_type {
         static const bool value = true;
     };
+
+    // Storage of a Callback, one pointer to a member function and one
+    // pointer to an object, so functions, bound functions and methods
+    // fit, plus platform.callback-extra-storage words for function
+    // objects with more state
+    struct _class;
+    struct callback_storage {
+        union {
+            void (*_staticfunc)();
+            void (*_boundfunc)(_class*);
+            void (_class::*_methodfunc)();
+        } _func;
+        void *_obj;
+#if MBED_CONF_PLATFORM_CALLBACK_EXTRA_STORAGE > 0
+        uintptr_t _extra[MBED_CONF_PLATFORM_CALLBACK_EXTRA_STORAGE];
+#endif
+    };
 }
 
 #define MBED_ENABLE_IF_CALLBACK_COMPATIBLE(F, M)                            \
     typename detail::enable_if<                                             \
             detail::is_type<M, &F::operator()>::value &&                    \
-            sizeof(F) <= sizeof(uintptr_t)                                  \
+            sizeof(F) <= sizeof(detail::callback_storage)                   \
         >::type = detail::nil()
 
 /** Callback class based on template specialization
@@ -77,7 +98,7 @@ public:
      */
     Callback(R (*func)() = 0) {
         if (!func) {
-            _ops = 0;
+            memset(this, 0, sizeof(Callback));
         } else {
             generate(func);
         }
@@ -87,6 +108,7 @@ public:
      *  @param func     The Callback to attach
      */
     Callback(const Callback<R()> &func) {
+        memset(this, 0, sizeof(Callback));
         if (func._ops) {
             func._ops->move(this, &func);
         }
@@ -167,7 +189,7 @@ public:
 
     /** Create a Callback with a function object
      *  @param f Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to sizeof(detail::callback_storage) bytes, see platform.callback-extra-storage
      */
     template <typename F>
     Callback(F f, MBED_ENABLE_IF_CALLBACK_COMPATIBLE(F, R (F::*)())) {
@@ -176,7 +198,7 @@ public:
 
     /** Create a Callback with a function object
      *  @param f Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to sizeof(detail::callback_storage) bytes, see platform.callback-extra-storage
      */
     template <typename F>
     Callback(const F f, MBED_ENABLE_IF_CALLBACK_COMPATIBLE(F, R (F::*)() const)) {
@@ -185,7 +207,7 @@ public:
 
     /** Create a Callback with a function object
      *  @param f Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to sizeof(detail::callback_storage) bytes, see platform.callback-extra-storage
      */
     template <typename F>
     Callback(volatile F f, MBED_ENABLE_IF_CALLBACK_COMPATIBLE(F, R (F::*)() volatile)) {
@@ -194,7 +216,7 @@ public:
 
     /** Create a Callback with a function object
      *  @param f Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to sizeof(detail::callback_storage) bytes, see platform.callback-extra-storage
      */
     template <typename F>
     Callback(const volatile F f, MBED_ENABLE_IF_CALLBACK_COMPATIBLE(F, R (F::*)() const volatile)) {
@@ -399,7 +421,7 @@ public:
 
     /** Attach a function object
      *  @param f     Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to sizeof(detail::callback_storage) bytes, see platform.callback-extra-storage
      *  @deprecated
      *      Replaced by simple assignment 'Callback cb = func'
      */
@@ -413,7 +435,7 @@ public:
 
     /** Attach a function object
      *  @param f     Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to sizeof(detail::callback_storage) bytes, see platform.callback-extra-storage
      *  @deprecated
      *      Replaced by simple assignment 'Callback cb = func'
      */
@@ -427,7 +449,7 @@ public:
 
     /** Attach a function object
      *  @param f Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to sizeof(detail::callback_storage) bytes, see platform.callback-extra-storage
      *  @deprecated
      *      Replaced by simple assignment 'Callback cb = func'
      */
@@ -441,7 +463,7 @@ public:
 
     /** Attach a function object
      *  @param f Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to sizeof(detail::callback_storage) bytes, see platform.callback-extra-storage
      *  @deprecated
      *      Replaced by simple assignment 'Callback cb = func'
      */
@@ -561,16 +583,9 @@ public:
     }
 
 private:
-    // Stored as pointer to function and pointer to optional object
-    // Function pointer is stored as union of possible function types
-    // to garuntee proper size and alignment
-    struct _class;
-    union {
-        void (*_staticfunc)();
-        void (*_boundfunc)(_class*);
-        void (_class::*_methodfunc)();
-    } _func;
-    void *_obj;
+    // Function objects, including the wrappers generated for functions and
+    // methods, are stored in place in the storage ahead of the ops pointer
+    detail::callback_storage _storage;
 
     // Dynamically dispatched operations
     const struct ops {
@@ -590,6 +605,8 @@ private:
 
         MBED_STATIC_ASSERT(sizeof(Callback) - sizeof(_ops) >= sizeof(F),
                 "Type F must not exceed the size of the Callback class");
+        // zero the unused storage, so equal callbacks compare equal
+        memset(this, 0, sizeof(Callback));
         new (this) F(f);
         _ops = &ops;
     }
@@ -651,7 +668,7 @@ public:
      */
     Callback(R (*func)(A0) = 0) {
         if (!func) {
-            _ops = 0;
+            memset(this, 0, sizeof(Callback));
         } else {
             generate(func);
         }
@@ -661,6 +678,7 @@ public:
      *  @param func     The Callback to attach
      */
     Callback(const Callback<R(A0)> &func) {
+        memset(this, 0, sizeof(Callback));
         if (func._ops) {
             func._ops->move(this, &func);
         }
@@ -741,7 +759,7 @@ public:
 
     /** Create a Callback with a function object
      *  @param f Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to sizeof(detail::callback_storage) bytes, see platform.callback-extra-storage
      */
     template <typename F>
     Callback(F f, MBED_ENABLE_IF_CALLBACK_COMPATIBLE(F, R (F::*)(A0))) {
@@ -750,7 +768,7 @@ public:
 
     /** Create a Callback with a function object
      *  @param f Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to sizeof(detail::callback_storage) bytes, see platform.callback-extra-storage
      */
     template <typename F>
     Callback(const F f, MBED_ENABLE_IF_CALLBACK_COMPATIBLE(F, R (F::*)(A0) const)) {
@@ -759,7 +777,7 @@ public:
 
     /** Create a Callback with a function object
      *  @param f Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to sizeof(detail::callback_storage) bytes, see platform.callback-extra-storage
      */
     template <typename F>
     Callback(volatile F f, MBED_ENABLE_IF_CALLBACK_COMPATIBLE(F, R (F::*)(A0) volatile)) {
@@ -768,7 +786,7 @@ public:
 
     /** Create a Callback with a function object
      *  @param f Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to sizeof(detail::callback_storage) bytes, see platform.callback-extra-storage
      */
     template <typename F>
     Callback(const volatile F f, MBED_ENABLE_IF_CALLBACK_COMPATIBLE(F, R (F::*)(A0) const volatile)) {
@@ -973,7 +991,7 @@ public:
 
     /** Attach a function object
      *  @param f Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to sizeof(detail::callback_storage) bytes, see platform.callback-extra-storage
      *  @deprecated
      *      Replaced by simple assignment 'Callback cb = func'
      */
@@ -987,7 +1005,7 @@ public:
 
     /** Attach a function object
      *  @param f Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to sizeof(detail::callback_storage) bytes, see platform.callback-extra-storage
      *  @deprecated
      *      Replaced by simple assignment 'Callback cb = func'
      */
@@ -1001,7 +1019,7 @@ public:
 
     /** Attach a function object
      *  @param f Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to sizeof(detail::callback_storage) bytes, see platform.callback-extra-storage
      *  @deprecated
      *      Replaced by simple assignment 'Callback cb = func'
      */
@@ -1015,7 +1033,7 @@ public:
 
     /** Attach a function object
      *  @param f Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to sizeof(detail::callback_storage) bytes, see platform.callback-extra-storage
      *  @deprecated
      *      Replaced by simple assignment 'Callback cb = func'
      */
@@ -1136,16 +1154,9 @@ public:
     }
 
 private:
-    // Stored as pointer to function and pointer to optional object
-    // Function pointer is stored as union of possible function types
-    // to garuntee proper size and alignment
-    struct _class;
-    union {
-        void (*_staticfunc)(A0);
-        void (*_boundfunc)(_class*, A0);
-        void (_class::*_methodfunc)(A0);
-    } _func;
-    void *_obj;
+    // Function objects, including the wrappers generated for functions and
+    // methods, are stored in place in the storage ahead of the ops pointer
+    detail::callback_storage _storage;
 
     // Dynamically dispatched operations
     const struct ops {
@@ -1165,6 +1176,8 @@ private:
 
         MBED_STATIC_ASSERT(sizeof(Callback) - sizeof(_ops) >= sizeof(F),
                 "Type F must not exceed the size of the Callback class");
+        // zero the unused storage, so equal callbacks compare equal
+        memset(this, 0, sizeof(Callback));
         new (this) F(f);
         _ops = &ops;
     }
@@ -1226,7 +1239,7 @@ public:
      */
     Callback(R (*func)(A0, A1) = 0) {
         if (!func) {
-            _ops = 0;
+            memset(this, 0, sizeof(Callback));
         } else {
             generate(func);
         }
@@ -1236,6 +1249,7 @@ public:
      *  @param func     The Callback to attach
      */
     Callback(const Callback<R(A0, A1)> &func) {
+        memset(this, 0, sizeof(Callback));
         if (func._ops) {
             func._ops->move(this, &func);
         }
@@ -1316,7 +1330,7 @@ public:
 
     /** Create a Callback with a function object
      *  @param f Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to sizeof(detail::callback_storage) bytes, see platform.callback-extra-storage
      */
     template <typename F>
     Callback(F f, MBED_ENABLE_IF_CALLBACK_COMPATIBLE(F, R (F::*)(A0, A1))) {
@@ -1325,7 +1339,7 @@ public:
 
     /** Create a Callback with a function object
      *  @param f Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to sizeof(detail::callback_storage) bytes, see platform.callback-extra-storage
      */
     template <typename F>
     Callback(const F f, MBED_ENABLE_IF_CALLBACK_COMPATIBLE(F, R (F::*)(A0, A1) const)) {
@@ -1334,7 +1348,7 @@ public:
 
     /** Create a Callback with a function object
      *  @param f Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to sizeof(detail::callback_storage) bytes, see platform.callback-extra-storage
      */
     template <typename F>
     Callback(volatile F f, MBED_ENABLE_IF_CALLBACK_COMPATIBLE(F, R (F::*)(A0, A1) volatile)) {
@@ -1343,7 +1357,7 @@ public:
 
     /** Create a Callback with a function object
      *  @param f Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to sizeof(detail::callback_storage) bytes, see platform.callback-extra-storage
      */
     template <typename F>
     Callback(const volatile F f, MBED_ENABLE_IF_CALLBACK_COMPATIBLE(F, R (F::*)(A0, A1) const volatile)) {
@@ -1548,7 +1562,7 @@ public:
 
     /** Attach a function object
      *  @param f Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to sizeof(detail::callback_storage) bytes, see platform.callback-extra-storage
      *  @deprecated
      *      Replaced by simple assignment 'Callback cb = func'
      */
@@ -1562,7 +1576,7 @@ public:
 
     /** Attach a function object
      *  @param f Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to sizeof(detail::callback_storage) bytes, see platform.callback-extra-storage
      *  @deprecated
      *      Replaced by simple assignment 'Callback cb = func'
      */
@@ -1576,7 +1590,7 @@ public:
 
     /** Attach a function object
      *  @param f Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to sizeof(detail::callback_storage) bytes, see platform.callback-extra-storage
      *  @deprecated
      *      Replaced by simple assignment 'Callback cb = func'
      */
@@ -1590,7 +1604,7 @@ public:
 
     /** Attach a function object
      *  @param f Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to sizeof(detail::callback_storage) bytes, see platform.callback-extra-storage
      *  @deprecated
      *      Replaced by simple assignment 'Callback cb = func'
      */
@@ -1712,16 +1726,9 @@ public:
     }
 
 private:
-    // Stored as pointer to function and pointer to optional object
-    // Function pointer is stored as union of possible function types
-    // to garuntee proper size and alignment
-    struct _class;
-    union {
-        void (*_staticfunc)(A0, A1);
-        void (*_boundfunc)(_class*, A0, A1);
-        void (_class::*_methodfunc)(A0, A1);
-    } _func;
-    void *_obj;
+    // Function objects, including the wrappers generated for functions and
+    // methods, are stored in place in the storage ahead of the ops pointer
+    detail::callback_storage _storage;
 
     // Dynamically dispatched operations
     const struct ops {
@@ -1741,6 +1748,8 @@ private:
 
         MBED_STATIC_ASSERT(sizeof(Callback) - sizeof(_ops) >= sizeof(F),
                 "Type F must not exceed the size of the Callback class");
+        // zero the unused storage, so equal callbacks compare equal
+        memset(this, 0, sizeof(Callback));
         new (this) F(f);
         _ops = &ops;
     }
@@ -1802,7 +1811,7 @@ public:
      */
     Callback(R (*func)(A0, A1, A2) = 0) {
         if (!func) {
-            _ops = 0;
+            memset(this, 0, sizeof(Callback));
         } else {
             generate(func);
         }
@@ -1812,6 +1821,7 @@ public:
      *  @param func     The Callback to attach
      */
     Callback(const Callback<R(A0, A1, A2)> &func) {
+        memset(this, 0, sizeof(Callback));
         if (func._ops) {
             func._ops->move(this, &func);
         }
@@ -1892,7 +1902,7 @@ public:
 
     /** Create a Callback with a function object
      *  @param f Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to sizeof(detail::callback_storage) bytes, see platform.callback-extra-storage
      */
     template <typename F>
     Callback(F f, MBED_ENABLE_IF_CALLBACK_COMPATIBLE(F, R (F::*)(A0, A1, A2))) {
@@ -1901,7 +1911,7 @@ public:
 
     /** Create a Callback with a function object
      *  @param f Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to sizeof(detail::callback_storage) bytes, see platform.callback-extra-storage
      */
     template <typename F>
     Callback(const F f, MBED_ENABLE_IF_CALLBACK_COMPATIBLE(F, R (F::*)(A0, A1, A2) const)) {
@@ -1910,7 +1920,7 @@ public:
 
     /** Create a Callback with a function object
      *  @param f Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to sizeof(detail::callback_storage) bytes, see platform.callback-extra-storage
      */
     template <typename F>
     Callback(volatile F f, MBED_ENABLE_IF_CALLBACK_COMPATIBLE(F, R (F::*)(A0, A1, A2) volatile)) {
@@ -1919,7 +1929,7 @@ public:
 
     /** Create a Callback with a function object
      *  @param f Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to sizeof(detail::callback_storage) bytes, see platform.callback-extra-storage
      */
     template <typename F>
     Callback(const volatile F f, MBED_ENABLE_IF_CALLBACK_COMPATIBLE(F, R (F::*)(A0, A1, A2) const volatile)) {
@@ -2124,7 +2134,7 @@ public:
 
     /** Attach a function object
      *  @param f Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to sizeof(detail::callback_storage) bytes, see platform.callback-extra-storage
      *  @deprecated
      *      Replaced by simple assignment 'Callback cb = func'
      */
@@ -2138,7 +2148,7 @@ public:
 
     /** Attach a function object
      *  @param f Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to sizeof(detail::callback_storage) bytes, see platform.callback-extra-storage
      *  @deprecated
      *      Replaced by simple assignment 'Callback cb = func'
      */
@@ -2152,7 +2162,7 @@ public:
 
     /** Attach a function object
      *  @param f Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to sizeof(detail::callback_storage) bytes, see platform.callback-extra-storage
      *  @deprecated
      *      Replaced by simple assignment 'Callback cb = func'
      */
@@ -2166,7 +2176,7 @@ public:
 
     /** Attach a function object
      *  @param f Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to sizeof(detail::callback_storage) bytes, see platform.callback-extra-storage
      *  @deprecated
      *      Replaced by simple assignment 'Callback cb = func'
      */
@@ -2289,16 +2299,9 @@ public:
     }
 
 private:
-    // Stored as pointer to function and pointer to optional object
-    // Function pointer is stored as union of possible function types
-    // to garuntee proper size and alignment
-    struct _class;
-    union {
-        void (*_staticfunc)(A0, A1, A2);
-        void (*_boundfunc)(_class*, A0, A1, A2);
-        void (_class::*_methodfunc)(A0, A1, A2);
-    } _func;
-    void *_obj;
+    // Function objects, including the wrappers generated for functions and
+    // methods, are stored in place in the storage ahead of the ops pointer
+    detail::callback_storage _storage;
 
     // Dynamically dispatched operations
     const struct ops {
@@ -2318,6 +2321,8 @@ private:
 
         MBED_STATIC_ASSERT(sizeof(Callback) - sizeof(_ops) >= sizeof(F),
                 "Type F must not exceed the size of the Callback class");
+        // zero the unused storage, so equal callbacks compare equal
+        memset(this, 0, sizeof(Callback));
         new (this) F(f);
         _ops = &ops;
     }
@@ -2379,7 +2384,7 @@ public:
      */
     Callback(R (*func)(A0, A1, A2, A3) = 0) {
         if (!func) {
-            _ops = 0;
+            memset(this, 0, sizeof(Callback));
         } else {
             generate(func);
         }
@@ -2389,6 +2394,7 @@ public:
      *  @param func     The Callback to attach
      */
     Callback(const Callback<R(A0, A1, A2, A3)> &func) {
+        memset(this, 0, sizeof(Callback));
         if (func._ops) {
             func._ops->move(this, &func);
         }
@@ -2469,7 +2475,7 @@ public:
 
     /** Create a Callback with a function object
      *  @param f Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to sizeof(detail::callback_storage) bytes, see platform.callback-extra-storage
      */
     template <typename F>
     Callback(F f, MBED_ENABLE_IF_CALLBACK_COMPATIBLE(F, R (F::*)(A0, A1, A2, A3))) {
@@ -2478,7 +2484,7 @@ public:
 
     /** Create a Callback with a function object
      *  @param f Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to sizeof(detail::callback_storage) bytes, see platform.callback-extra-storage
      */
     template <typename F>
     Callback(const F f, MBED_ENABLE_IF_CALLBACK_COMPATIBLE(F, R (F::*)(A0, A1, A2, A3) const)) {
@@ -2487,7 +2493,7 @@ public:
 
     /** Create a Callback with a function object
      *  @param f Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to sizeof(detail::callback_storage) bytes, see platform.callback-extra-storage
      */
     template <typename F>
     Callback(volatile F f, MBED_ENABLE_IF_CALLBACK_COMPATIBLE(F, R (F::*)(A0, A1, A2, A3) volatile)) {
@@ -2496,7 +2502,7 @@ public:
 
     /** Create a Callback with a function object
      *  @param f Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to sizeof(detail::callback_storage) bytes, see platform.callback-extra-storage
      */
     template <typename F>
     Callback(const volatile F f, MBED_ENABLE_IF_CALLBACK_COMPATIBLE(F, R (F::*)(A0, A1, A2, A3) const volatile)) {
@@ -2701,7 +2707,7 @@ public:
 
     /** Attach a function object
      *  @param f Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to sizeof(detail::callback_storage) bytes, see platform.callback-extra-storage
      *  @deprecated
      *      Replaced by simple assignment 'Callback cb = func'
      */
@@ -2715,7 +2721,7 @@ public:
 
     /** Attach a function object
      *  @param f Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to sizeof(detail::callback_storage) bytes, see platform.callback-extra-storage
      *  @deprecated
      *      Replaced by simple assignment 'Callback cb = func'
      */
@@ -2729,7 +2735,7 @@ public:
 
     /** Attach a function object
      *  @param f Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to sizeof(detail::callback_storage) bytes, see platform.callback-extra-storage
      *  @deprecated
      *      Replaced by simple assignment 'Callback cb = func'
      */
@@ -2743,7 +2749,7 @@ public:
 
     /** Attach a function object
      *  @param f Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to sizeof(detail::callback_storage) bytes, see platform.callback-extra-storage
      *  @deprecated
      *      Replaced by simple assignment 'Callback cb = func'
      */
@@ -2867,16 +2873,9 @@ public:
     }
 
 private:
-    // Stored as pointer to function and pointer to optional object
-    // Function pointer is stored as union of possible function types
-    // to garuntee proper size and alignment
-    struct _class;
-    union {
-        void (*_staticfunc)(A0, A1, A2, A3);
-        void (*_boundfunc)(_class*, A0, A1, A2, A3);
-        void (_class::*_methodfunc)(A0, A1, A2, A3);
-    } _func;
-    void *_obj;
+    // Function objects, including the wrappers generated for functions and
+    // methods, are stored in place in the storage ahead of the ops pointer
+    detail::callback_storage _storage;
 
     // Dynamically dispatched operations
     const struct ops {
@@ -2896,6 +2895,8 @@ private:
 
         MBED_STATIC_ASSERT(sizeof(Callback) - sizeof(_ops) >= sizeof(F),
                 "Type F must not exceed the size of the Callback class");
+        // zero the unused storage, so equal callbacks compare equal
+        memset(this, 0, sizeof(Callback));
         new (this) F(f);
         _ops = &ops;
     }
@@ -2957,7 +2958,7 @@ public:
      */
     Callback(R (*func)(A0, A1, A2, A3, A4) = 0) {
         if (!func) {
-            _ops = 0;
+            memset(this, 0, sizeof(Callback));
         } else {
             generate(func);
         }
@@ -2967,6 +2968,7 @@ public:
      *  @param func     The Callback to attach
      */
     Callback(const Callback<R(A0, A1, A2, A3, A4)> &func) {
+        memset(this, 0, sizeof(Callback));
         if (func._ops) {
             func._ops->move(this, &func);
         }
@@ -3047,7 +3049,7 @@ public:
 
     /** Create a Callback with a function object
      *  @param f Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to sizeof(detail::callback_storage) bytes, see platform.callback-extra-storage
      */
     template <typename F>
     Callback(F f, MBED_ENABLE_IF_CALLBACK_COMPATIBLE(F, R (F::*)(A0, A1, A2, A3, A4))) {
@@ -3056,7 +3058,7 @@ public:
 
     /** Create a Callback with a function object
      *  @param f Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to sizeof(detail::callback_storage) bytes, see platform.callback-extra-storage
      */
     template <typename F>
     Callback(const F f, MBED_ENABLE_IF_CALLBACK_COMPATIBLE(F, R (F::*)(A0, A1, A2, A3, A4) const)) {
@@ -3065,7 +3067,7 @@ public:
 
     /** Create a Callback with a function object
      *  @param f Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to sizeof(detail::callback_storage) bytes, see platform.callback-extra-storage
      */
     template <typename F>
     Callback(volatile F f, MBED_ENABLE_IF_CALLBACK_COMPATIBLE(F, R (F::*)(A0, A1, A2, A3, A4) volatile)) {
@@ -3074,7 +3076,7 @@ public:
 
     /** Create a Callback with a function object
      *  @param f Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to sizeof(detail::callback_storage) bytes, see platform.callback-extra-storage
      */
     template <typename F>
     Callback(const volatile F f, MBED_ENABLE_IF_CALLBACK_COMPATIBLE(F, R (F::*)(A0, A1, A2, A3, A4) const volatile)) {
@@ -3279,7 +3281,7 @@ public:
 
     /** Attach a function object
      *  @param f Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to sizeof(detail::callback_storage) bytes, see platform.callback-extra-storage
      *  @deprecated
      *      Replaced by simple assignment 'Callback cb = func'
      */
@@ -3293,7 +3295,7 @@ public:
 
     /** Attach a function object
      *  @param f Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to sizeof(detail::callback_storage) bytes, see platform.callback-extra-storage
      *  @deprecated
      *      Replaced by simple assignment 'Callback cb = func'
      */
@@ -3307,7 +3309,7 @@ public:
 
     /** Attach a function object
      *  @param f Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to sizeof(detail::callback_storage) bytes, see platform.callback-extra-storage
      *  @deprecated
      *      Replaced by simple assignment 'Callback cb = func'
      */
@@ -3321,7 +3323,7 @@ public:
 
     /** Attach a function object
      *  @param f Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to sizeof(detail::callback_storage) bytes, see platform.callback-extra-storage
      *  @deprecated
      *      Replaced by simple assignment 'Callback cb = func'
      */
@@ -3446,16 +3448,9 @@ public:
     }
 
 private:
-    // Stored as pointer to function and pointer to optional object
-    // Function pointer is stored as union of possible function types
-    // to garuntee proper size and alignment
-    struct _class;
-    union {
-        void (*_staticfunc)(A0, A1, A2, A3, A4);
-        void (*_boundfunc)(_class*, A0, A1, A2, A3, A4);
-        void (_class::*_methodfunc)(A0, A1, A2, A3, A4);
-    } _func;
-    void *_obj;
+    // Function objects, including the wrappers generated for functions and
+    // methods, are stored in place in the storage ahead of the ops pointer
+    detail::callback_storage _storage;
 
     // Dynamically dispatched operations
     const struct ops {
@@ -3475,6 +3470,8 @@ private:
 
         MBED_STATIC_ASSERT(sizeof(Callback) - sizeof(_ops) >= sizeof(F),
                 "Type F must not exceed the size of the Callback class");
+        // zero the unused storage, so equal callbacks compare equal
+        memset(this, 0, sizeof(Callback));
         new (this) F(f);
         _ops = &ops;
     }
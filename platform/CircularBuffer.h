@@ -16,6 +16,7 @@
 #ifndef MBED_CIRCULARBUFFER_H
 #define MBED_CIRCULARBUFFER_H
 
+#include <string.h>
 #include "platform/mbed_critical.h"
 
 namespace mbed {
@@ -72,6 +73,80 @@ public:
         return data_popped;
     }
 
+    /** Push a number of elements to the buffer. This overwrites the oldest
+     *  elements if there is not enough space
+     *
+     *  The elements are copied with memcpy under a single critical section,
+     *  so T must be a plain data type.
+     *
+     * @param src Elements to be pushed to the buffer
+     * @param len Number of elements, only the last BufferSize are kept if there are more
+     */
+    void push(const T *src, CounterType len) {
+        if (len == 0) {
+            return;
+        }
+        if (len > BufferSize) {
+            src += len - BufferSize;
+            len = BufferSize;
+        }
+
+        core_util_critical_section_enter();
+        CounterType space = BufferSize - count();
+        CounterType first = BufferSize - _head;
+        if (first > len) {
+            first = len;
+        }
+        memcpy(&_pool[_head], src, first * sizeof(T));
+        memcpy(&_pool[0], src + first, (len - first) * sizeof(T));
+        _head = (_head + len) % BufferSize;
+        if (len >= space) {
+            _tail = _head;
+            _full = true;
+        }
+        core_util_critical_section_exit();
+    }
+
+    /** Pop a number of elements from the buffer
+     *
+     *  The elements are copied with memcpy under a single critical section,
+     *  so T must be a plain data type.
+     *
+     * @param dest Buffer for the popped elements
+     * @param len  Maximum number of elements to pop
+     * @return Number of elements popped, 0 if the buffer is empty
+     */
+    CounterType pop(T *dest, CounterType len) {
+        core_util_critical_section_enter();
+        CounterType n = count();
+        if (n > len) {
+            n = len;
+        }
+        CounterType first = BufferSize - _tail;
+        if (first > n) {
+            first = n;
+        }
+        memcpy(dest, &_pool[_tail], first * sizeof(T));
+        memcpy(dest + first, &_pool[0], (n - first) * sizeof(T));
+        _tail = (_tail + n) % BufferSize;
+        if (n) {
+            _full = false;
+        }
+        core_util_critical_section_exit();
+        return n;
+    }
+
+    /** Get the number of elements in the buffer
+     *
+     * @return Number of elements in the buffer
+     */
+    CounterType size() const {
+        core_util_critical_section_enter();
+        CounterType elements = count();
+        core_util_critical_section_exit();
+        return elements;
+    }
+
     /** Check if the buffer is empty
      *
      * @return True if the buffer is empty, false if not
@@ -106,6 +181,14 @@ public:
     }
 
 private:
+    // called in a critical section
+    CounterType count() const {
+        if (_full) {
+            return BufferSize;
+        }
+        return (_head + BufferSize - _tail) % BufferSize;
+    }
+
     T _pool[BufferSize];
     volatile CounterType _head;
     volatile CounterType _tail;
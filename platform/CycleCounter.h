@@ -0,0 +1,138 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MBED_CYCLECOUNTER_H
+#define MBED_CYCLECOUNTER_H
+
+#include <stdint.h>
+#include "platform/mbed_cycle_counter.h"
+
+namespace mbed {
+/** \addtogroup platform */
+
+/** A stopwatch on the CPU cycle counter
+ *
+ * Reading the counter costs a few cycles, so CycleCounter can time short
+ * code sections that a Timer on the us_ticker can not resolve. Without a
+ * DWT cycle counter it counts microseconds, see mbed_cycle_counter.h.
+ *
+ * Intervals must be shorter than the 32 bit wrap of the counter, about 21
+ * seconds at 200 MHz.
+ *
+ * @note Synchronization level: Interrupt safe for the static functions,
+ *       an instance must not be shared between threads.
+ *
+ * Example:
+ * @code
+ * CycleCounter cc;
+ *
+ * cc.start();
+ * process_block();
+ * cc.stop();
+ * printf("%lu cycles, %lu ns\r\n", cc.elapsed_cycles(), cc.elapsed_ns());
+ * @endcode
+ * @ingroup platform
+ */
+class CycleCounter {
+public:
+    CycleCounter() : _start(0), _elapsed(0), _running(false)
+    {
+    }
+
+    /** Read the counter
+     *
+     *  @return The counter, which wraps around at 32 bits
+     */
+    static uint32_t read()
+    {
+        return mbed_cycle_counter_read();
+    }
+
+    /** Get the frequency of the counter
+     *
+     *  @return Counts per second
+     */
+    static uint32_t frequency()
+    {
+        return mbed_cycle_counter_frequency();
+    }
+
+    /** Check if the counter counts core cycles rather than microseconds
+     */
+    static bool precise()
+    {
+        return mbed_cycle_counter_precise() != 0;
+    }
+
+    /** Busy wait for at least a number of nanoseconds
+     *
+     *  @param ns Nanoseconds to wait
+     */
+    static void wait_ns(uint32_t ns)
+    {
+        mbed_cycle_counter_wait(mbed_cycle_counter_from_ns(ns));
+    }
+
+    /** Start or resume counting
+     */
+    void start()
+    {
+        if (!_running) {
+            _start = read();
+            _running = true;
+        }
+    }
+
+    /** Stop counting, elapsed time is kept
+     */
+    void stop()
+    {
+        if (_running) {
+            _elapsed += read() - _start;
+            _running = false;
+        }
+    }
+
+    /** Clear the elapsed time, a running counter keeps running
+     */
+    void reset()
+    {
+        _start = read();
+        _elapsed = 0;
+    }
+
+    /** Get the counts elapsed while running
+     */
+    uint32_t elapsed_cycles() const
+    {
+        return _running ? _elapsed + (read() - _start) : _elapsed;
+    }
+
+    /** Get the time elapsed while running in nanoseconds
+     */
+    uint32_t elapsed_ns() const
+    {
+        return mbed_cycle_counter_to_ns(elapsed_cycles());
+    }
+
+private:
+    uint32_t _start;
+    uint32_t _elapsed;
+    bool _running;
+};
+
+} // namespace mbed
+
+#endif
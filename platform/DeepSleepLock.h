@@ -39,26 +39,26 @@ class DeepSleepLock {
 public:
     DeepSleepLock()
     {
-        sleep_manager_lock_deep_sleep();
+        sleep_manager_lock_deep_sleep_named("DeepSleepLock");
     }
 
     ~DeepSleepLock()
     {
-        sleep_manager_unlock_deep_sleep();
+        sleep_manager_unlock_deep_sleep_named("DeepSleepLock");
     }
 
     /** Mark the start of a locked deep sleep section
      */
     void lock()
     {
-        sleep_manager_lock_deep_sleep();
+        sleep_manager_lock_deep_sleep_named("DeepSleepLock");
     }
 
     /** Mark the end of a locked deep sleep section
      */
     void unlock()
     {
-        sleep_manager_unlock_deep_sleep();
+        sleep_manager_unlock_deep_sleep_named("DeepSleepLock");
     }
 };
 
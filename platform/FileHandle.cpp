@@ -33,6 +33,41 @@ off_t FileHandle::size()
     return size;
 }
 
+ssize_t FileHandle::readv(const struct iovec *iov, int iovcnt)
+{
+    ssize_t total = 0;
+    for (int i = 0; i < iovcnt; i++) {
+        if (i > 0 && !readable()) {
+            break;
+        }
+        ssize_t n = read(iov[i].iov_base, iov[i].iov_len);
+        if (n < 0) {
+            return total ? total : n;
+        }
+        total += n;
+        if ((size_t)n < iov[i].iov_len) {
+            break;
+        }
+    }
+    return total;
+}
+
+ssize_t FileHandle::writev(const struct iovec *iov, int iovcnt)
+{
+    ssize_t total = 0;
+    for (int i = 0; i < iovcnt; i++) {
+        ssize_t n = write(iov[i].iov_base, iov[i].iov_len);
+        if (n < 0) {
+            return total ? total : n;
+        }
+        total += n;
+        if ((size_t)n < iov[i].iov_len) {
+            break;
+        }
+    }
+    return total;
+}
+
 std::FILE *fdopen(FileHandle *fh, const char *mode)
 {
     return mbed_fdopen(fh, mode);
@@ -64,6 +64,33 @@ public:
      */
     virtual ssize_t write(const void *buffer, size_t size) = 0;
 
+    /** Read the contents of a file into several buffers
+     *
+     *  The buffers are filled in order, as if by one read of their total size.
+     *  The default implementation calls read for each buffer, stops at the
+     *  first short read and only moves on to the next buffer while readable()
+     *  is true, so it does not block once some data has been read.
+     *
+     *  @param iov      The buffers to read in to
+     *  @param iovcnt   The number of buffers
+     *  @return         The number of bytes read, 0 at end of file, negative error on failure
+     */
+    virtual ssize_t readv(const struct iovec *iov, int iovcnt);
+
+    /** Write the contents of several buffers to a file
+     *
+     *  The buffers are written in order, as if by one write of their total size.
+     *  The default implementation calls write for each buffer and stops at
+     *  the first short write. Subclasses with a lock override it to write all
+     *  the buffers with the lock held, so the data is not interleaved with
+     *  other writers.
+     *
+     *  @param iov      The buffers to write from
+     *  @param iovcnt   The number of buffers
+     *  @return         The number of bytes written, negative error on failure
+     */
+    virtual ssize_t writev(const struct iovec *iov, int iovcnt);
+
     /** Move the file position to a given offset from from a given location
      *
      *  @param offset   The offset from whence to move to
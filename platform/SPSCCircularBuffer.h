@@ -0,0 +1,216 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MBED_SPSCCIRCULARBUFFER_H
+#define MBED_SPSCCIRCULARBUFFER_H
+
+#include <stdint.h>
+#include <string.h>
+#include "cmsis.h"
+#include "platform/NonCopyable.h"
+
+namespace mbed {
+/** \addtogroup platform */
+
+/** Circular buffer for a single producer and a single consumer in caller
+ *  provided storage
+ *
+ *  Unlike CircularBuffer, no critical section is entered. The producer
+ *  only writes the head and the consumer only writes the tail, so one
+ *  context, such as an interrupt handler, can push while another, such as
+ *  a thread, pops. push never overwrites, it fails when the buffer is
+ *  full. One slot of the storage is kept free to tell a full buffer from
+ *  an empty one, so the buffer holds one element less than its storage.
+ *
+ *  The bulk push and pop copy elements with memcpy, so T must be a plain
+ *  data type for them.
+ *
+ *  @note Synchronization level: Interrupt safe for one producer and one consumer
+ *  @ingroup platform
+ */
+template<typename T, typename CounterType = uint32_t>
+class SPSCRingBuffer : private NonCopyable<SPSCRingBuffer<T, CounterType> > {
+public:
+    /** Create a buffer in the given storage
+     *
+     * @param storage Storage for the elements, it must outlive the buffer
+     * @param slots   Number of elements in the storage, at least 2
+     */
+    SPSCRingBuffer(T *storage, CounterType slots) : _pool(storage), _slots(slots), _head(0), _tail(0) {
+    }
+
+    ~SPSCRingBuffer() {
+    }
+
+    /** Push an element to the buffer, producer only
+     *
+     * @param data Data to be pushed to the buffer
+     * @return True if the data was pushed, false if the buffer is full
+     */
+    bool push(const T& data) {
+        CounterType head = _head;
+        CounterType next = advance(head, 1);
+        if (next == _tail) {
+            return false;
+        }
+        _pool[head] = data;
+        // publish the element before the head that makes it visible
+        __DMB();
+        _head = next;
+        return true;
+    }
+
+    /** Push a number of elements to the buffer, producer only
+     *
+     * @param src Elements to be pushed to the buffer
+     * @param len Number of elements
+     * @return Number of elements pushed, less than len if the buffer filled up
+     */
+    CounterType push(const T *src, CounterType len) {
+        CounterType head = _head;
+        CounterType n = capacity() - count(head, _tail);
+        if (n > len) {
+            n = len;
+        }
+        CounterType first = _slots - head;
+        if (first > n) {
+            first = n;
+        }
+        memcpy(&_pool[head], src, first * sizeof(T));
+        memcpy(&_pool[0], src + first, (n - first) * sizeof(T));
+        __DMB();
+        _head = advance(head, n);
+        return n;
+    }
+
+    /** Pop an element from the buffer, consumer only
+     *
+     * @param data Data popped from the buffer
+     * @return True if the buffer is not empty and data contains an element, false otherwise
+     */
+    bool pop(T& data) {
+        CounterType tail = _tail;
+        if (tail == _head) {
+            return false;
+        }
+        // read the element only after seeing the head that published it
+        __DMB();
+        data = _pool[tail];
+        // finish reading before the producer may reuse the slot
+        __DMB();
+        _tail = advance(tail, 1);
+        return true;
+    }
+
+    /** Pop a number of elements from the buffer, consumer only
+     *
+     * @param dest Buffer for the popped elements
+     * @param len  Maximum number of elements to pop
+     * @return Number of elements popped, 0 if the buffer is empty
+     */
+    CounterType pop(T *dest, CounterType len) {
+        CounterType tail = _tail;
+        CounterType n = count(_head, tail);
+        if (n > len) {
+            n = len;
+        }
+        CounterType first = _slots - tail;
+        if (first > n) {
+            first = n;
+        }
+        __DMB();
+        memcpy(dest, &_pool[tail], first * sizeof(T));
+        memcpy(dest + first, &_pool[0], (n - first) * sizeof(T));
+        __DMB();
+        _tail = advance(tail, n);
+        return n;
+    }
+
+    /** Check if the buffer is empty
+     *
+     * @return True if the buffer is empty, false if not
+     */
+    bool empty() const {
+        return _head == _tail;
+    }
+
+    /** Check if the buffer is full
+     *
+     * @return True if the buffer is full, false if not
+     */
+    bool full() const {
+        return advance(_head, 1) == _tail;
+    }
+
+    /** Get the number of elements in the buffer
+     *
+     * @return Number of elements in the buffer
+     */
+    CounterType size() const {
+        return count(_head, _tail);
+    }
+
+    /** Get the number of elements the buffer can hold
+     *
+     * @return One less than the number of slots of the storage
+     */
+    CounterType capacity() const {
+        return _slots - 1;
+    }
+
+    /** Reset the buffer
+     *
+     *  Neither the producer nor the consumer may use the buffer meanwhile.
+     */
+    void reset() {
+        _head = 0;
+        _tail = 0;
+    }
+
+private:
+    CounterType advance(CounterType index, CounterType n) const {
+        return (index + n) % _slots;
+    }
+
+    CounterType count(CounterType head, CounterType tail) const {
+        return (head + _slots - tail) % _slots;
+    }
+
+    T *const _pool;
+    const CounterType _slots;
+    volatile CounterType _head;
+    volatile CounterType _tail;
+};
+
+/** Templated circular buffer for a single producer and a single consumer
+ *
+ *  An SPSCRingBuffer holding BufferSize elements in its own storage.
+ *
+ *  @note Synchronization level: Interrupt safe for one producer and one consumer
+ *  @ingroup platform
+ */
+template<typename T, uint32_t BufferSize, typename CounterType = uint32_t>
+class SPSCCircularBuffer : public SPSCRingBuffer<T, CounterType> {
+public:
+    SPSCCircularBuffer() : SPSCRingBuffer<T, CounterType>(_storage, BufferSize + 1) {
+    }
+
+private:
+    T _storage[BufferSize + 1];
+};
+
+}
+
+#endif
@@ -15,6 +15,7 @@
  */
 #include "platform/Stream.h"
 #include "platform/mbed_error.h"
+#include "platform/mbed_printf.h"
 #include <errno.h>
 
 namespace mbed {
@@ -125,13 +126,10 @@ off_t Stream::size() {
 }
 
 int Stream::printf(const char* format, ...) {
-    lock();
     std::va_list arg;
     va_start(arg, format);
-    fflush(_file);
-    int r = vfprintf(_file, format, arg);
+    int r = vprintf(format, arg);
     va_end(arg);
-    unlock();
     return r;
 }
 
@@ -146,10 +144,21 @@ int Stream::scanf(const char* format, ...) {
     return r;
 }
 
+#if MBED_CONF_PLATFORM_MINIMAL_PRINTF
+void Stream::printf_write(void *stream, const char *data, size_t size) {
+    static_cast<Stream *>(stream)->write(data, size);
+}
+#endif
+
 int Stream::vprintf(const char* format, std::va_list args) {
     lock();
+#if MBED_CONF_PLATFORM_MINIMAL_PRINTF
+    // Formatted on the stack and written in chunks, _file is unbuffered
+    int r = mbed_vxprintf(printf_write, this, format, args);
+#else
     fflush(_file);
     int r = vfprintf(_file, format, args);
+#endif
     unlock();
     return r;
 }
@@ -81,6 +81,11 @@ protected:
     virtual void unlock() {
         // Stub
     }
+
+private:
+#if MBED_CONF_PLATFORM_MINIMAL_PRINTF
+    static void printf_write(void *stream, const char *data, size_t size);
+#endif
 };
 
 } // namespace mbed
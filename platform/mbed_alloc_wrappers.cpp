@@ -14,15 +14,33 @@
  * limitations under the License.
  */
 
+#include "platform/mbed_heap_regions.h"
 #include "platform/mbed_mem_trace.h"
 #include "platform/mbed_stats.h"
+#include "platform/mbed_tlsf.h"
 #include "platform/mbed_toolchain.h"
 #include "platform/SingletonPtr.h"
 #include "platform/PlatformMutex.h"
+#include <stdarg.h>
 #include <stddef.h>
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#if defined(TOOLCHAIN_GCC)
+#include <malloc.h>
+#endif
+
+#ifndef MBED_CONF_PLATFORM_TLSF_HEAP_GROW_SIZE
+#define MBED_CONF_PLATFORM_TLSF_HEAP_GROW_SIZE  4096
+#endif
+
+#ifndef MBED_CONF_PLATFORM_HEAP_REGIONS
+#define MBED_CONF_PLATFORM_HEAP_REGIONS         0
+#endif
+
+#ifndef MBED_CONF_PLATFORM_HEAP_ATTRIBUTES
+#define MBED_CONF_PLATFORM_HEAP_ATTRIBUTES      0
+#endif
 
 /* There are two memory tracers in mbed OS:
 
@@ -54,6 +72,21 @@ static SingletonPtr<PlatformMutex> malloc_stats_mutex;
 static mbed_stats_heap_t heap_stats = {0, 0, 0, 0, 0};
 #endif
 
+#ifdef MBED_HEAP_STATS_ENABLED
+static uint32_t heap_hist_bucket(size_t size)
+{
+    uint32_t bucket = 0;
+    while (bucket < MBED_STATS_HEAP_HIST_BUCKETS - 1 && size > (16U << bucket)) {
+        bucket++;
+    }
+    return bucket;
+}
+#endif
+
+#if MBED_CONF_PLATFORM_HEAP_STATS_FRAGMENTATION
+static void heap_free_blocks_get(mbed_stats_heap_t *stats);
+#endif
+
 void mbed_stats_heap_get(mbed_stats_heap_t *stats)
 {
 #ifdef MBED_HEAP_STATS_ENABLED
@@ -66,6 +99,175 @@ void mbed_stats_heap_get(mbed_stats_heap_t *stats)
 #else
     memset(stats, 0, sizeof(mbed_stats_heap_t));
 #endif
+#if MBED_CONF_PLATFORM_HEAP_STATS_FRAGMENTATION
+    heap_free_blocks_get(stats);
+#endif
+}
+
+/******************************************************************************/
+/* Heap regions                                                               */
+/******************************************************************************/
+
+#if MBED_CONF_PLATFORM_HEAP_REGIONS > 0
+
+typedef struct {
+    char *start;
+    char *end;
+    uint32_t attributes;
+    mbed_tlsf_t tlsf;
+} heap_region_t;
+
+static heap_region_t heap_regions[MBED_CONF_PLATFORM_HEAP_REGIONS];
+static volatile int heap_region_count;
+static SingletonPtr<PlatformMutex> heap_region_mutex;
+
+// Regions are set up before they are counted and never removed,
+// so they can be looked up without the lock
+static heap_region_t *heap_region_find(void *ptr)
+{
+    for (int i = 0; i < heap_region_count; i++) {
+        if ((char *)ptr >= heap_regions[i].start && (char *)ptr < heap_regions[i].end) {
+            return &heap_regions[i];
+        }
+    }
+    return NULL;
+}
+
+// Allocate from the first region with all the attributes that has room
+static void *heap_region_alloc(size_t alignment, size_t size, uint32_t attributes)
+{
+    void *ptr = NULL;
+    heap_region_mutex->lock();
+    for (int i = 0; i < heap_region_count && ptr == NULL; i++) {
+        if ((heap_regions[i].attributes & attributes) == attributes) {
+            ptr = mbed_tlsf_memalign(&heap_regions[i].tlsf, alignment, size);
+        }
+    }
+    heap_region_mutex->unlock();
+    return ptr;
+}
+
+// Free memory if it is in a region
+static bool heap_region_free(void *ptr)
+{
+    heap_region_t *region = heap_region_find(ptr);
+    if (region == NULL) {
+        return false;
+    }
+    heap_region_mutex->lock();
+    mbed_tlsf_free(&region->tlsf, ptr);
+    heap_region_mutex->unlock();
+    return true;
+}
+
+// Resize memory of a region, moving it to another region with the
+// same attributes if its own has no room
+static void *heap_region_realloc(heap_region_t *region, void *ptr, size_t size)
+{
+    heap_region_mutex->lock();
+    size_t old_size = mbed_tlsf_block_size(ptr);
+    void *new_ptr = mbed_tlsf_realloc(&region->tlsf, ptr, size);
+    heap_region_mutex->unlock();
+    if (new_ptr == NULL && size != 0) {
+        new_ptr = heap_region_alloc(0, size, region->attributes);
+        if (new_ptr != NULL) {
+            memcpy(new_ptr, ptr, old_size < size ? old_size : size);
+            heap_region_free(ptr);
+        }
+    }
+    return new_ptr;
+}
+
+// malloc carries on in the regions with the attributes of the main heap
+static void *heap_region_spill(size_t size)
+{
+    return heap_region_alloc(0, size, MBED_CONF_PLATFORM_HEAP_ATTRIBUTES);
+}
+
+#endif // #if MBED_CONF_PLATFORM_HEAP_REGIONS > 0
+
+int mbed_heap_region_add(void *start, size_t size, uint32_t attributes)
+{
+#if MBED_CONF_PLATFORM_HEAP_REGIONS > 0
+    int index = -1;
+    heap_region_mutex->lock();
+    if (heap_region_count < MBED_CONF_PLATFORM_HEAP_REGIONS) {
+        heap_region_t *region = &heap_regions[heap_region_count];
+        mbed_tlsf_init(&region->tlsf);
+        if (mbed_tlsf_add_pool(&region->tlsf, start, size) == 0) {
+            region->start = (char *)start;
+            region->end = (char *)start + size;
+            region->attributes = attributes;
+            index = heap_region_count;
+            heap_region_count = index + 1;
+        }
+    }
+    heap_region_mutex->unlock();
+    return index;
+#else
+    (void)start;
+    (void)size;
+    (void)attributes;
+    return -1;
+#endif
+}
+
+void *mbed_heap_memalign(size_t alignment, size_t size, uint32_t attributes)
+{
+    void *ptr = NULL;
+    if ((MBED_CONF_PLATFORM_HEAP_ATTRIBUTES & attributes) == attributes) {
+        if (alignment <= 8) {
+            ptr = malloc(size);
+        } else {
+            // the heap statistics header is only kept for malloc
+#if defined(TOOLCHAIN_GCC) && !defined(MBED_HEAP_STATS_ENABLED)
+            ptr = memalign(alignment, size);
+#endif
+        }
+    }
+#if MBED_CONF_PLATFORM_HEAP_REGIONS > 0
+    if (ptr == NULL) {
+        ptr = heap_region_alloc(alignment, size, attributes);
+    }
+#endif
+    return ptr;
+}
+
+void *mbed_heap_alloc(size_t size, uint32_t attributes)
+{
+    return mbed_heap_memalign(0, size, attributes);
+}
+
+void mbed_heap_free(void *ptr)
+{
+#if MBED_CONF_PLATFORM_HEAP_REGIONS > 0
+    if (heap_region_free(ptr)) {
+        return;
+    }
+#endif
+    free(ptr);
+}
+
+int mbed_heap_region_info(int index, mbed_heap_region_info_t *info)
+{
+#if MBED_CONF_PLATFORM_HEAP_REGIONS > 0
+    if (index < 0 || index >= heap_region_count) {
+        return -1;
+    }
+    heap_region_t *region = &heap_regions[index];
+    uint32_t free_block_cnt;
+    info->start = region->start;
+    info->size = region->end - region->start;
+    info->attributes = region->attributes;
+    heap_region_mutex->lock();
+    mbed_tlsf_stats(&region->tlsf, &info->free_size, &free_block_cnt, &info->largest_free_size);
+    heap_region_mutex->unlock();
+    return 0;
+#else
+    (void)index;
+    (void)info;
+    return -1;
+#endif
 }
 
 /******************************************************************************/
@@ -89,17 +291,107 @@ extern "C" {
 // TODO: memory tracing doesn't work with uVisor enabled.
 #if !defined(FEATURE_UVISOR)
 
+#if MBED_CONF_PLATFORM_TLSF_HEAP
+
+/* The heap is a TLSF allocator, given memory from sbrk as it needs it and
+ * locked with the newlib malloc lock. newlib's own allocator is not used. */
+
+#include <sys/types.h>
+
+extern "C" {
+    void __malloc_lock(struct _reent *r);
+    void __malloc_unlock(struct _reent *r);
+    caddr_t _sbrk(int incr);
+}
+
+static mbed_tlsf_t heap_tlsf;
+
+// Add a pool for an allocation of size bytes with the alignment
+static bool heap_tlsf_grow(size_t size, size_t alignment)
+{
+    size_t needed = mbed_tlsf_pool_size(alignment, size);
+    if (needed == 0) {
+        return false;
+    }
+    size_t incr = needed > MBED_CONF_PLATFORM_TLSF_HEAP_GROW_SIZE ? needed : MBED_CONF_PLATFORM_TLSF_HEAP_GROW_SIZE;
+    incr = (incr + 7) & ~7;
+
+    void *mem = _sbrk(incr);
+    if (mem == (void *)-1 && incr > needed) {
+        incr = (needed + 7) & ~7;
+        mem = _sbrk(incr);
+    }
+    return mem != (void *)-1 && mbed_tlsf_add_pool(&heap_tlsf, mem, incr) == 0;
+}
+
+static void *heap_memalign(struct _reent *r, size_t alignment, size_t size)
+{
+    __malloc_lock(r);
+    void *ptr = mbed_tlsf_memalign(&heap_tlsf, alignment, size);
+    while (ptr == NULL && heap_tlsf_grow(size, alignment)) {
+        ptr = mbed_tlsf_memalign(&heap_tlsf, alignment, size);
+    }
+    __malloc_unlock(r);
+    return ptr;
+}
+
+static void *heap_malloc(struct _reent *r, size_t size)
+{
+    return heap_memalign(r, 0, size);
+}
+
+static void *heap_realloc(struct _reent *r, void *ptr, size_t size)
+{
+    __malloc_lock(r);
+    void *new_ptr = mbed_tlsf_realloc(&heap_tlsf, ptr, size);
+    while (new_ptr == NULL && size != 0 && heap_tlsf_grow(size, 0)) {
+        new_ptr = mbed_tlsf_realloc(&heap_tlsf, ptr, size);
+    }
+    __malloc_unlock(r);
+    return new_ptr;
+}
+
+static void heap_free(struct _reent *r, void *ptr)
+{
+    __malloc_lock(r);
+    mbed_tlsf_free(&heap_tlsf, ptr);
+    __malloc_unlock(r);
+}
+
+static void *heap_calloc(struct _reent *r, size_t nmemb, size_t size)
+{
+    if (size && nmemb > (size_t)-1 / size) {
+        return NULL;
+    }
+    void *ptr = heap_malloc(r, nmemb * size);
+    if (ptr != NULL) {
+        memset(ptr, 0, nmemb * size);
+    }
+    return ptr;
+}
+
+#else // #if MBED_CONF_PLATFORM_TLSF_HEAP
+
+#define heap_malloc     __real__malloc_r
+#define heap_memalign   __real__memalign_r
+#define heap_realloc    __real__realloc_r
+#define heap_free       __real__free_r
+#define heap_calloc     __real__calloc_r
+
+#endif // #if MBED_CONF_PLATFORM_TLSF_HEAP
+
 extern "C" void * __wrap__malloc_r(struct _reent * r, size_t size) {
     void *ptr = NULL;
 #ifdef MBED_HEAP_STATS_ENABLED
     malloc_stats_mutex->lock();
-    alloc_info_t *alloc_info = (alloc_info_t*)__real__malloc_r(r, size + sizeof(alloc_info_t));
+    alloc_info_t *alloc_info = (alloc_info_t*)heap_malloc(r, size + sizeof(alloc_info_t));
     if (alloc_info != NULL) {
         alloc_info->size = size;
         ptr = (void*)(alloc_info + 1);
         heap_stats.current_size += size;
         heap_stats.total_size += size;
         heap_stats.alloc_cnt += 1;
+        heap_stats.alloc_size_hist[heap_hist_bucket(size)] += 1;
         if (heap_stats.current_size > heap_stats.max_size) {
             heap_stats.max_size = heap_stats.current_size;
         }
@@ -108,8 +400,13 @@ extern "C" void * __wrap__malloc_r(struct _reent * r, size_t size) {
     }
     malloc_stats_mutex->unlock();
 #else // #ifdef MBED_HEAP_STATS_ENABLED
-    ptr = __real__malloc_r(r, size);
+    ptr = heap_malloc(r, size);
 #endif // #ifdef MBED_HEAP_STATS_ENABLED
+#if MBED_CONF_PLATFORM_HEAP_REGIONS > 0
+    if (ptr == NULL) {
+        ptr = heap_region_spill(size);
+    }
+#endif
 #ifdef MBED_MEM_TRACING_ENABLED
     mem_trace_mutex->lock();
     mbed_mem_trace_malloc(ptr, size, MBED_CALLER_ADDR());
@@ -120,6 +417,12 @@ extern "C" void * __wrap__malloc_r(struct _reent * r, size_t size) {
 
 extern "C" void * __wrap__realloc_r(struct _reent * r, void * ptr, size_t size) {
     void *new_ptr = NULL;
+#if MBED_CONF_PLATFORM_HEAP_REGIONS > 0
+    heap_region_t *region = heap_region_find(ptr);
+    if (region != NULL) {
+        new_ptr = heap_region_realloc(region, ptr, size);
+    } else {
+#endif
 #ifdef MBED_HEAP_STATS_ENABLED
     // Implement realloc_r with malloc and free.
     // The function realloc_r can't be used here directly since
@@ -148,8 +451,11 @@ extern "C" void * __wrap__realloc_r(struct _reent * r, void * ptr, size_t size)
         free(ptr);
     }
 #else // #ifdef MBED_HEAP_STATS_ENABLED
-    new_ptr = __real__realloc_r(r, ptr, size);
+    new_ptr = heap_realloc(r, ptr, size);
 #endif // #ifdef MBED_HEAP_STATS_ENABLED
+#if MBED_CONF_PLATFORM_HEAP_REGIONS > 0
+    }
+#endif
 #ifdef MBED_MEM_TRACING_ENABLED
     mem_trace_mutex->lock();
     mbed_mem_trace_realloc(new_ptr, ptr, size, MBED_CALLER_ADDR());
@@ -159,6 +465,16 @@ extern "C" void * __wrap__realloc_r(struct _reent * r, void * ptr, size_t size)
 }
 
 extern "C" void __wrap__free_r(struct _reent * r, void * ptr) {
+#if MBED_CONF_PLATFORM_HEAP_REGIONS > 0
+    if (heap_region_free(ptr)) {
+#ifdef MBED_MEM_TRACING_ENABLED
+        mem_trace_mutex->lock();
+        mbed_mem_trace_free(ptr, MBED_CALLER_ADDR());
+        mem_trace_mutex->unlock();
+#endif // #ifdef MBED_MEM_TRACING_ENABLED
+        return;
+    }
+#endif
 #ifdef MBED_HEAP_STATS_ENABLED
     malloc_stats_mutex->lock();
     alloc_info_t *alloc_info = NULL;
@@ -167,10 +483,10 @@ extern "C" void __wrap__free_r(struct _reent * r, void * ptr) {
         heap_stats.current_size -= alloc_info->size;
         heap_stats.alloc_cnt -= 1;
     }
-    __real__free_r(r, (void*)alloc_info);
+    heap_free(r, (void*)alloc_info);
     malloc_stats_mutex->unlock();
 #else // #ifdef MBED_HEAP_STATS_ENABLED
-    __real__free_r(r, ptr);
+    heap_free(r, ptr);
 #endif // #ifdef MBED_HEAP_STATS_ENABLED
 #ifdef MBED_MEM_TRACING_ENABLED
     mem_trace_mutex->lock();
@@ -189,7 +505,15 @@ extern "C" void * __wrap__calloc_r(struct _reent * r, size_t nmemb, size_t size)
         memset(ptr, 0, nmemb * size);
     }
 #else // #ifdef MBED_HEAP_STATS_ENABLED
-    ptr = __real__calloc_r(r, nmemb, size);
+    ptr = heap_calloc(r, nmemb, size);
+#if MBED_CONF_PLATFORM_HEAP_REGIONS > 0
+    if (ptr == NULL && !(size && nmemb > (size_t)-1 / size)) {
+        ptr = heap_region_spill(nmemb * size);
+        if (ptr != NULL) {
+            memset(ptr, 0, nmemb * size);
+        }
+    }
+#endif
 #endif // #ifdef MBED_HEAP_STATS_ENABLED
 #ifdef MBED_MEM_TRACING_ENABLED
     mem_trace_mutex->lock();
@@ -200,9 +524,11 @@ extern "C" void * __wrap__calloc_r(struct _reent * r, size_t nmemb, size_t size)
 }
 
 extern "C" void * __wrap__memalign_r(struct _reent * r, size_t alignment, size_t bytes) {
-    return __real__memalign_r(r, alignment, bytes);
+    return heap_memalign(r, alignment, bytes);
 }
 
+#elif MBED_CONF_PLATFORM_TLSF_HEAP // if !defined(FEATURE_UVISOR)
+#error The TLSF heap is not supported with uVisor.
 #endif // if !defined(FEATURE_UVISOR)
 
 
@@ -212,8 +538,12 @@ extern "C" void * __wrap__memalign_r(struct _reent * r, size_t alignment, size_t
 
 #elif defined(TOOLCHAIN_ARM) // #if defined(TOOLCHAIN_GCC)
 
-/* Enable hooking of memory function only if tracing is also enabled */
-#if defined(MBED_MEM_TRACING_ENABLED) || defined(MBED_HEAP_STATS_ENABLED)
+#if MBED_CONF_PLATFORM_TLSF_HEAP
+#error The TLSF heap is only supported with GCC.
+#endif
+
+/* Enable hooking of memory function only if tracing or heap regions are also enabled */
+#if defined(MBED_MEM_TRACING_ENABLED) || defined(MBED_HEAP_STATS_ENABLED) || MBED_CONF_PLATFORM_HEAP_REGIONS > 0
 
 extern "C" {
     void *$Super$$malloc(size_t size);
@@ -233,6 +563,7 @@ extern "C" void* $Sub$$malloc(size_t size) {
         heap_stats.current_size += size;
         heap_stats.total_size += size;
         heap_stats.alloc_cnt += 1;
+        heap_stats.alloc_size_hist[heap_hist_bucket(size)] += 1;
         if (heap_stats.current_size > heap_stats.max_size) {
             heap_stats.max_size = heap_stats.current_size;
         }
@@ -243,6 +574,11 @@ extern "C" void* $Sub$$malloc(size_t size) {
 #else // #ifdef MBED_HEAP_STATS_ENABLED
     ptr = $Super$$malloc(size);
 #endif // #ifdef MBED_HEAP_STATS_ENABLED
+#if MBED_CONF_PLATFORM_HEAP_REGIONS > 0
+    if (ptr == NULL) {
+        ptr = heap_region_spill(size);
+    }
+#endif
 #ifdef MBED_MEM_TRACING_ENABLED
     mem_trace_mutex->lock();
     mbed_mem_trace_malloc(ptr, size, MBED_CALLER_ADDR());
@@ -253,6 +589,12 @@ extern "C" void* $Sub$$malloc(size_t size) {
 
 extern "C" void* $Sub$$realloc(void *ptr, size_t size) {
     void *new_ptr = NULL;
+#if MBED_CONF_PLATFORM_HEAP_REGIONS > 0
+    heap_region_t *region = heap_region_find(ptr);
+    if (region != NULL) {
+        new_ptr = heap_region_realloc(region, ptr, size);
+    } else {
+#endif
 #ifdef MBED_HEAP_STATS_ENABLED
     // Note - no lock needed since malloc and free are thread safe
 
@@ -278,6 +620,9 @@ extern "C" void* $Sub$$realloc(void *ptr, size_t size) {
 #else // #ifdef MBED_HEAP_STATS_ENABLED
     new_ptr = $Super$$realloc(ptr, size);
 #endif // #ifdef MBED_HEAP_STATS_ENABLED
+#if MBED_CONF_PLATFORM_HEAP_REGIONS > 0
+    }
+#endif
 #ifdef MBED_MEM_TRACING_ENABLED
     mem_trace_mutex->lock();
     mbed_mem_trace_realloc(new_ptr, ptr, size, MBED_CALLER_ADDR());
@@ -296,6 +641,14 @@ extern "C" void *$Sub$$calloc(size_t nmemb, size_t size) {
     }
 #else // #ifdef MBED_HEAP_STATS_ENABLED
     ptr = $Super$$calloc(nmemb, size);
+#if MBED_CONF_PLATFORM_HEAP_REGIONS > 0
+    if (ptr == NULL && !(size && nmemb > (size_t)-1 / size)) {
+        ptr = heap_region_spill(nmemb * size);
+        if (ptr != NULL) {
+            memset(ptr, 0, nmemb * size);
+        }
+    }
+#endif
 #endif // #ifdef MBED_HEAP_STATS_ENABLED
 #ifdef MBED_MEM_TRACING_ENABLED
     mem_trace_mutex->lock();
@@ -306,6 +659,16 @@ extern "C" void *$Sub$$calloc(size_t nmemb, size_t size) {
 }
 
 extern "C" void $Sub$$free(void *ptr) {
+#if MBED_CONF_PLATFORM_HEAP_REGIONS > 0
+    if (heap_region_free(ptr)) {
+#ifdef MBED_MEM_TRACING_ENABLED
+        mem_trace_mutex->lock();
+        mbed_mem_trace_free(ptr, MBED_CALLER_ADDR());
+        mem_trace_mutex->unlock();
+#endif // #ifdef MBED_MEM_TRACING_ENABLED
+        return;
+    }
+#endif
 #ifdef MBED_HEAP_STATS_ENABLED
     malloc_stats_mutex->lock();
     alloc_info_t *alloc_info = NULL;
@@ -326,7 +689,7 @@ extern "C" void $Sub$$free(void *ptr) {
 #endif // #ifdef MBED_MEM_TRACING_ENABLED
 }
 
-#endif // #if defined(MBED_MEM_TRACING_ENABLED) || defined(MBED_HEAP_STATS_ENABLED)
+#endif // #if defined(MBED_MEM_TRACING_ENABLED) || defined(MBED_HEAP_STATS_ENABLED) || MBED_CONF_PLATFORM_HEAP_REGIONS > 0
 
 /******************************************************************************/
 /* Allocation wrappers for other toolchains are not supported yet             */
@@ -334,6 +697,10 @@ extern "C" void $Sub$$free(void *ptr) {
 
 #else // #if defined(TOOLCHAIN_GCC)
 
+#if MBED_CONF_PLATFORM_TLSF_HEAP
+#error The TLSF heap is only supported with GCC.
+#endif
+
 #ifdef MBED_MEM_TRACING_ENABLED
 #warning Memory tracing is not supported with the current toolchain.
 #endif
@@ -344,3 +711,165 @@ extern "C" void $Sub$$free(void *ptr) {
 
 #endif // #if defined(TOOLCHAIN_GCC)
 
+
+/******************************************************************************/
+/* Free block statistics                                                      */
+/******************************************************************************/
+
+#if MBED_CONF_PLATFORM_HEAP_STATS_FRAGMENTATION
+
+static void heap_free_block_add(mbed_stats_heap_t *stats, uint32_t size)
+{
+    if (size == 0) {
+        return;
+    }
+    stats->free_size += size;
+    stats->free_block_cnt += 1;
+    if (size > stats->largest_free_size) {
+        stats->largest_free_size = size;
+    }
+}
+
+#if defined(TOOLCHAIN_GCC)
+
+#include <sys/types.h>
+
+extern "C" {
+    void __malloc_lock(struct _reent *r);
+    void __malloc_unlock(struct _reent *r);
+    caddr_t _sbrk(int incr);
+}
+
+#if MBED_CONF_PLATFORM_TLSF_HEAP
+// the free blocks are those of the TLSF heap
+#elif defined(_NANO_MALLOC)
+// newlib-nano keeps a single list of free chunks, sorted by address
+struct heap_chunk {
+    long size;
+    heap_chunk *next;
+};
+
+extern "C" heap_chunk *__malloc_free_list;
+#else
+// newlib keeps its free chunks in bins of doubly linked lists, with the
+// chunk at the end of the heap, which can still grow, outside of them
+struct heap_chunk {
+    size_t prev_size;
+    size_t size;
+    heap_chunk *fd;
+    heap_chunk *bk;
+};
+
+#define HEAP_BINS           128
+#define HEAP_CHUNK_SIZE(p)  ((p)->size & ~(size_t)3)
+#define HEAP_BIN(i)         ((heap_chunk *)((char *)&__malloc_av_[2 * (i) + 2] - 2 * sizeof(size_t)))
+
+extern "C" heap_chunk *__malloc_av_[];
+#endif
+
+static void heap_free_blocks_get(mbed_stats_heap_t *stats)
+{
+    extern unsigned char *mbed_heap_start;
+    extern uint32_t mbed_heap_size;
+
+    stats->free_size = 0;
+    stats->free_block_cnt = 0;
+    stats->largest_free_size = 0;
+
+    __malloc_lock(_REENT);
+
+    // the heap not yet claimed with sbrk is free too
+    uint32_t unclaimed = 0;
+    unsigned char *heap_end = (unsigned char *)_sbrk(0);
+    if (mbed_heap_size && heap_end < mbed_heap_start + mbed_heap_size) {
+        unclaimed = mbed_heap_start + mbed_heap_size - heap_end;
+    }
+
+#if MBED_CONF_PLATFORM_TLSF_HEAP
+    mbed_tlsf_stats(&heap_tlsf, &stats->free_size, &stats->free_block_cnt, &stats->largest_free_size);
+    heap_free_block_add(stats, unclaimed);
+#elif defined(_NANO_MALLOC)
+    for (heap_chunk *p = __malloc_free_list; p != NULL; p = p->next) {
+        heap_free_block_add(stats, p->size);
+    }
+    heap_free_block_add(stats, unclaimed);
+#else
+    heap_free_block_add(stats, HEAP_CHUNK_SIZE(HEAP_BIN(0)->fd) + unclaimed);
+    for (int i = 1; i < HEAP_BINS; i++) {
+        heap_chunk *bin = HEAP_BIN(i);
+        for (heap_chunk *p = bin->bk; p != bin; p = p->bk) {
+            heap_free_block_add(stats, HEAP_CHUNK_SIZE(p));
+        }
+    }
+#endif
+
+    __malloc_unlock(_REENT);
+}
+
+#else // #if defined(TOOLCHAIN_GCC)
+
+#if defined(TOOLCHAIN_ARM) && (defined(MBED_MEM_TRACING_ENABLED) || defined(MBED_HEAP_STATS_ENABLED) || MBED_CONF_PLATFORM_HEAP_REGIONS > 0)
+#define heap_probe_alloc    $Super$$malloc
+#define heap_probe_free     $Super$$free
+#else
+#define heap_probe_alloc    malloc
+#define heap_probe_free     free
+#endif
+
+// Find the largest block the allocator can return, by bisection
+static uint32_t heap_largest_free_probe(uint32_t limit)
+{
+    uint32_t low = 0;
+    uint32_t high = limit + 1;
+    while (high - low > 1) {
+        uint32_t size = low + (high - low) / 2;
+        void *ptr = heap_probe_alloc(size);
+        if (ptr != NULL) {
+            heap_probe_free(ptr);
+            low = size;
+        } else {
+            high = size;
+        }
+    }
+    return low;
+}
+
+#if defined(TOOLCHAIN_ARM) && !defined(__MICROLIB)
+struct heap_print_state {
+    mbed_stats_heap_t *stats;
+    bool totals;
+};
+
+// __heapstats prints the totals first: "<bytes> bytes in <blocks> free blocks ..."
+static int heap_stats_print(void *param, char const *format, ...)
+{
+    heap_print_state *state = static_cast<heap_print_state *>(param);
+    if (!state->totals) {
+        va_list args;
+        va_start(args, format);
+        state->stats->free_size = va_arg(args, int);
+        state->stats->free_block_cnt = va_arg(args, int);
+        va_end(args);
+        state->totals = true;
+    }
+    return 0;
+}
+#endif
+
+static void heap_free_blocks_get(mbed_stats_heap_t *stats)
+{
+    extern uint32_t mbed_heap_size;
+
+    stats->free_size = 0;
+    stats->free_block_cnt = 0;
+#if defined(TOOLCHAIN_ARM) && !defined(__MICROLIB)
+    heap_print_state state = { stats, false };
+    __heapstats(heap_stats_print, &state);
+#endif
+    uint32_t limit = stats->free_size ? stats->free_size : mbed_heap_size ? mbed_heap_size : 0x100000;
+    stats->largest_free_size = heap_largest_free_probe(limit);
+}
+
+#endif // #if defined(TOOLCHAIN_GCC)
+
+#endif // #if MBED_CONF_PLATFORM_HEAP_STATS_FRAGMENTATION
@@ -0,0 +1,128 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "platform/mbed_bin_trace.h"
+#include "platform/mbed_assert.h"
+#include "platform/mbed_critical.h"
+#include "hal/us_ticker_api.h"
+#include "cmsis.h"
+
+#define TRACE_WORDS         (MBED_CONF_PLATFORM_BIN_TRACE_BUFFER_SIZE / 4)
+#define TRACE_HEADER_WORDS  3
+#define TRACE_DRAIN_CHUNK   64
+
+MBED_STATIC_ASSERT(TRACE_WORDS >= TRACE_HEADER_WORDS + MBED_BIN_TRACE_MAX_ARGS &&
+                   (TRACE_WORDS & (TRACE_WORDS - 1)) == 0,
+                   "platform.bin-trace-buffer-size must be a power of two of at least 64 bytes");
+
+/* The ring of records, head and tail are free running word counts */
+static uint32_t trace_buffer[TRACE_WORDS];
+static uint32_t trace_head;
+static uint32_t trace_tail;
+static uint16_t trace_sequence;
+static uint32_t trace_dropped;
+
+void mbed_bin_trace_write(const char *fmt, const uint32_t *args, unsigned nargs)
+{
+    MBED_ASSERT(nargs <= MBED_BIN_TRACE_MAX_ARGS);
+    uint32_t timestamp = us_ticker_read();
+    uint32_t words = TRACE_HEADER_WORDS + nargs;
+
+    core_util_critical_section_enter();
+    uint16_t sequence = trace_sequence++;
+    if (TRACE_WORDS - (trace_head - trace_tail) < words) {
+        trace_dropped++;
+        core_util_critical_section_exit();
+        return;
+    }
+
+    uint32_t head = trace_head;
+    trace_buffer[head++ % TRACE_WORDS] = (MBED_BIN_TRACE_MAGIC << 24) | (nargs << 16) | sequence;
+    trace_buffer[head++ % TRACE_WORDS] = (uint32_t)(uintptr_t)fmt;
+    trace_buffer[head++ % TRACE_WORDS] = timestamp;
+    for (unsigned i = 0; i < nargs; i++) {
+        trace_buffer[head++ % TRACE_WORDS] = args[i];
+    }
+    trace_head = head;
+    core_util_critical_section_exit();
+}
+
+size_t mbed_bin_trace_read(void *buffer, size_t size)
+{
+    uint32_t *out = (uint32_t *)buffer;
+    size_t copied = 0;
+
+    // one record per critical section, to keep the interrupt latency short
+    while (true) {
+        core_util_critical_section_enter();
+        if (trace_tail == trace_head) {
+            core_util_critical_section_exit();
+            break;
+        }
+        uint32_t tail = trace_tail;
+        uint32_t words = TRACE_HEADER_WORDS + ((trace_buffer[tail % TRACE_WORDS] >> 16) & 0xFF);
+        if ((copied / 4 + words) * 4 > size) {
+            core_util_critical_section_exit();
+            break;
+        }
+        for (uint32_t i = 0; i < words; i++) {
+            out[copied / 4 + i] = trace_buffer[tail++ % TRACE_WORDS];
+        }
+        trace_tail = tail;
+        core_util_critical_section_exit();
+        copied += words * 4;
+    }
+
+    return copied;
+}
+
+void mbed_bin_trace_drain(void (*write)(const void *data, size_t size))
+{
+    uint32_t chunk[TRACE_DRAIN_CHUNK / 4];
+    size_t size;
+    while ((size = mbed_bin_trace_read(chunk, sizeof(chunk))) > 0) {
+        write(chunk, size);
+    }
+}
+
+void mbed_bin_trace_itm_write(const void *data, size_t size)
+{
+#if defined(ITM)
+    const uint32_t *words = (const uint32_t *)data;
+    if (!(ITM->TCR & ITM_TCR_ITMENA_Msk) || !(ITM->TER & 1UL)) {
+        return;
+    }
+    for (size_t i = 0; i < size / 4; i++) {
+        while (ITM->PORT[0U].u32 == 0UL);
+        ITM->PORT[0U].u32 = words[i];
+    }
+#else
+    (void)data;
+    (void)size;
+#endif
+}
+
+uint32_t mbed_bin_trace_dropped(void)
+{
+    return trace_dropped;
+}
+
+void mbed_bin_trace_clear(void)
+{
+    core_util_critical_section_enter();
+    trace_tail = trace_head;
+    trace_dropped = 0;
+    core_util_critical_section_exit();
+}
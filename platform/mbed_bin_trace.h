@@ -0,0 +1,205 @@
+/** \addtogroup platform */
+/** @{*/
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MBED_BIN_TRACE_H
+#define MBED_BIN_TRACE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef MBED_CONF_PLATFORM_BIN_TRACE_ENABLED
+#define MBED_CONF_PLATFORM_BIN_TRACE_ENABLED        0
+#endif
+
+#ifndef MBED_CONF_PLATFORM_BIN_TRACE_BUFFER_SIZE
+#define MBED_CONF_PLATFORM_BIN_TRACE_BUFFER_SIZE    1024
+#endif
+
+/* Top byte of the first word of every record */
+#define MBED_BIN_TRACE_MAGIC    0xB7
+
+/* Most arguments a record can hold */
+#define MBED_BIN_TRACE_MAX_ARGS 6
+
+/**
+ * Binary tracing
+ *
+ * A trace point records the address of its format string, a microsecond
+ * timestamp and up to MBED_BIN_TRACE_MAX_ARGS arguments as 32-bit words
+ * into a RAM ring buffer. Nothing is formatted on the target: the buffer
+ * is drained as raw bytes, over a serial port or SWO, and
+ * tools/bin_trace.py looks the format strings up in the ELF image of the
+ * application to print the messages. A trace point takes a critical section
+ * of a few word copies, so it can be used from interrupt handlers and left
+ * enabled in production firmware.
+ *
+ * Arguments are integers or pointers, a '%s' argument has to point to a
+ * string in flash to be printed by the decoder. Floating point and 64-bit
+ * arguments are not supported.
+ *
+ * A record is the little-endian words:
+ *
+ * - MBED_BIN_TRACE_MAGIC << 24 | number of arguments << 16 | sequence number
+ * - address of the format string
+ * - us_ticker_read() at the trace point
+ * - the arguments
+ *
+ * Records that do not fit in the buffer are dropped and counted, the
+ * sequence number counts them too so the decoder can tell where they were.
+ *
+ * The MBED_BIN_TRACE macro compiles to nothing unless the
+ * platform.bin-trace-enabled configuration option is set.
+ *
+ * Example:
+ * @code
+ * #include "mbed.h"
+ * #include "platform/mbed_bin_trace.h"
+ *
+ * RawSerial trace_port(PA_9, PA_10, 921600);
+ *
+ * static void trace_write(const void *data, size_t size)
+ * {
+ *     const char *bytes = static_cast<const char *>(data);
+ *     for (size_t i = 0; i < size; i++) {
+ *         trace_port.putc(bytes[i]);
+ *     }
+ * }
+ *
+ * void rx_irq()
+ * {
+ *     MBED_BIN_TRACE("rx %u bytes, status 0x%x", count, status);
+ * }
+ *
+ * int main()
+ * {
+ *     while (true) {
+ *         mbed_bin_trace_drain(trace_write);
+ *         wait_ms(100);
+ *     }
+ * }
+ * @endcode
+ */
+
+/**
+ * Record a trace point
+ *
+ * @param fmt   The printf format string, it must be a literal in flash
+ * @param args  The arguments as 32-bit words
+ * @param nargs The number of arguments, at most MBED_BIN_TRACE_MAX_ARGS
+ *
+ * @note Use MBED_BIN_TRACE rather than calling this directly.
+ * @note This function is interrupt safe.
+ */
+void mbed_bin_trace_write(const char *fmt, const uint32_t *args, unsigned nargs);
+
+/**
+ * Move complete records out of the trace buffer
+ *
+ * @param buffer The buffer to copy the records to
+ * @param size   The size of the buffer in bytes
+ * @return The number of bytes copied, a multiple of 4
+ *
+ * @note This function is interrupt safe.
+ */
+size_t mbed_bin_trace_read(void *buffer, size_t size);
+
+/**
+ * Empty the trace buffer into an output
+ *
+ * The records are read in chunks from a small buffer on the stack, and
+ * written out one chunk at a time.
+ *
+ * @param write The function writing the bytes to the output
+ */
+void mbed_bin_trace_drain(void (*write)(const void *data, size_t size));
+
+/**
+ * Write bytes to ITM stimulus port 0, for draining the trace over SWO
+ *
+ * Nothing is written unless a debugger has enabled the ITM and the port.
+ * Without an ITM on the core this does nothing.
+ *
+ * @param data The bytes to write
+ * @param size The number of bytes, a multiple of 4
+ */
+void mbed_bin_trace_itm_write(const void *data, size_t size);
+
+/**
+ * Get the number of records dropped because the buffer was full
+ */
+uint32_t mbed_bin_trace_dropped(void);
+
+/**
+ * Drop all records in the trace buffer and clear the dropped count
+ */
+void mbed_bin_trace_clear(void);
+
+#define MBED_BIN_TRACE_ARG(a) ((uint32_t)(uintptr_t)(a))
+
+#define MBED_BIN_TRACE_ARGS_0(fmt) \
+    mbed_bin_trace_write(fmt, NULL, 0)
+#define MBED_BIN_TRACE_ARGS_N(fmt, n, ...) \
+    do { \
+        const uint32_t mbed_bin_trace_args_[n] = { __VA_ARGS__ }; \
+        mbed_bin_trace_write(fmt, mbed_bin_trace_args_, n); \
+    } while (0)
+#define MBED_BIN_TRACE_ARGS_1(fmt, a) \
+    MBED_BIN_TRACE_ARGS_N(fmt, 1, MBED_BIN_TRACE_ARG(a))
+#define MBED_BIN_TRACE_ARGS_2(fmt, a, b) \
+    MBED_BIN_TRACE_ARGS_N(fmt, 2, MBED_BIN_TRACE_ARG(a), MBED_BIN_TRACE_ARG(b))
+#define MBED_BIN_TRACE_ARGS_3(fmt, a, b, c) \
+    MBED_BIN_TRACE_ARGS_N(fmt, 3, MBED_BIN_TRACE_ARG(a), MBED_BIN_TRACE_ARG(b), MBED_BIN_TRACE_ARG(c))
+#define MBED_BIN_TRACE_ARGS_4(fmt, a, b, c, d) \
+    MBED_BIN_TRACE_ARGS_N(fmt, 4, MBED_BIN_TRACE_ARG(a), MBED_BIN_TRACE_ARG(b), MBED_BIN_TRACE_ARG(c), \
+                          MBED_BIN_TRACE_ARG(d))
+#define MBED_BIN_TRACE_ARGS_5(fmt, a, b, c, d, e) \
+    MBED_BIN_TRACE_ARGS_N(fmt, 5, MBED_BIN_TRACE_ARG(a), MBED_BIN_TRACE_ARG(b), MBED_BIN_TRACE_ARG(c), \
+                          MBED_BIN_TRACE_ARG(d), MBED_BIN_TRACE_ARG(e))
+#define MBED_BIN_TRACE_ARGS_6(fmt, a, b, c, d, e, f) \
+    MBED_BIN_TRACE_ARGS_N(fmt, 6, MBED_BIN_TRACE_ARG(a), MBED_BIN_TRACE_ARG(b), MBED_BIN_TRACE_ARG(c), \
+                          MBED_BIN_TRACE_ARG(d), MBED_BIN_TRACE_ARG(e), MBED_BIN_TRACE_ARG(f))
+
+#define MBED_BIN_TRACE_COUNT_(fmt, a, b, c, d, e, f, n, ...) n
+#define MBED_BIN_TRACE_COUNT(...) MBED_BIN_TRACE_COUNT_(__VA_ARGS__, 6, 5, 4, 3, 2, 1, 0, 0)
+#define MBED_BIN_TRACE_SELECT_(n) MBED_BIN_TRACE_ARGS_ ## n
+#define MBED_BIN_TRACE_SELECT(n) MBED_BIN_TRACE_SELECT_(n)
+
+/**
+ * Trace a format string literal and up to MBED_BIN_TRACE_MAX_ARGS arguments
+ *
+ * @code
+ * MBED_BIN_TRACE("connected");
+ * MBED_BIN_TRACE("sent %d of %d bytes to %s", sent, size, host_name);
+ * @endcode
+ */
+#if MBED_CONF_PLATFORM_BIN_TRACE_ENABLED
+#define MBED_BIN_TRACE(...) MBED_BIN_TRACE_SELECT(MBED_BIN_TRACE_COUNT(__VA_ARGS__))(__VA_ARGS__)
+#else
+#define MBED_BIN_TRACE(...) do { } while (0)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+/** @}*/
@@ -0,0 +1,85 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "platform/mbed_boot_time.h"
+#include "cmsis.h"
+#include <stdio.h>
+
+static const char *const boot_phase_names[MBED_BOOT_PHASE_COUNT] = {
+    "entry",
+    "sdk init",
+    "kernel init",
+    "main thread",
+    "static init",
+    "main",
+};
+
+#if MBED_CONF_PLATFORM_BOOT_TIME_ENABLED && defined(DWT_CTRL_CYCCNTENA_Msk)
+
+static uint32_t boot_times[MBED_BOOT_PHASE_COUNT];
+
+void mbed_boot_time_record(mbed_boot_phase_t phase)
+{
+    if (phase == MBED_BOOT_PHASE_ENTRY) {
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CYCCNT = 0;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    }
+    if (phase < MBED_BOOT_PHASE_COUNT) {
+        boot_times[phase] = DWT->CYCCNT;
+    }
+}
+
+uint32_t mbed_boot_time_get(mbed_boot_phase_t phase)
+{
+    return (phase < MBED_BOOT_PHASE_COUNT) ? boot_times[phase] : 0;
+}
+
+#else
+
+#if MBED_CONF_PLATFORM_BOOT_TIME_ENABLED
+void mbed_boot_time_record(mbed_boot_phase_t phase)
+{
+    (void)phase;
+}
+#endif
+
+uint32_t mbed_boot_time_get(mbed_boot_phase_t phase)
+{
+    (void)phase;
+    return 0;
+}
+
+#endif
+
+void mbed_boot_time_print(void)
+{
+    uint32_t cycles_per_us = SystemCoreClock / 1000000;
+    uint32_t previous = 0;
+
+    if (cycles_per_us == 0) {
+        cycles_per_us = 1;
+    }
+    printf("boot phase      cycles        us\r\n");
+    for (int phase = MBED_BOOT_PHASE_SDK_INIT; phase < MBED_BOOT_PHASE_COUNT; phase++) {
+        uint32_t time = mbed_boot_time_get((mbed_boot_phase_t)phase);
+        uint32_t duration = (time > previous) ? (time - previous) : 0;
+        printf("%-12s %9lu %9lu\r\n", boot_phase_names[phase],
+               (unsigned long)duration, (unsigned long)(duration / cycles_per_us));
+        previous = time;
+    }
+    printf("%-12s %9lu %9lu\r\n", "total", (unsigned long)previous,
+           (unsigned long)(previous / cycles_per_us));
+}
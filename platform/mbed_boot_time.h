@@ -0,0 +1,111 @@
+/** \addtogroup platform */
+/** @{*/
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MBED_BOOT_TIME_H
+#define MBED_BOOT_TIME_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef MBED_CONF_PLATFORM_BOOT_TIME_ENABLED
+#define MBED_CONF_PLATFORM_BOOT_TIME_ENABLED    0
+#endif
+
+/**
+ * Boot time instrumentation
+ *
+ * The boot code records a timestamp at the end of each phase of the boot
+ * sequence, so the time spent before main() can be measured and attributed.
+ * Timestamps are CPU cycles counted by the DWT cycle counter from the moment
+ * the C library hands control to mbed OS; the time spent in the reset
+ * handler, SystemInit and the copy of the data sections is not included.
+ *
+ * Nothing is recorded unless the platform.boot-time-enabled configuration
+ * option is set, and on cores without a DWT cycle counter all the
+ * timestamps read 0.
+ *
+ * Static C++ constructors run in the MBED_BOOT_PHASE_STATIC_INIT phase. When
+ * that phase is long, the objects whose constructors are costly can be
+ * turned into SingletonPtr, which constructs them on their first use.
+ *
+ * Example:
+ * @code
+ * #include "mbed.h"
+ * #include "platform/mbed_boot_time.h"
+ *
+ * int main()
+ * {
+ *     mbed_boot_time_print();
+ * }
+ * @endcode
+ */
+
+/** Phases of the boot sequence, in order */
+typedef enum {
+    MBED_BOOT_PHASE_ENTRY = 0,      /**< mbed OS boot code entered */
+    MBED_BOOT_PHASE_SDK_INIT,       /**< mbed_sdk_init(), the target initialization, returned */
+    MBED_BOOT_PHASE_KERNEL_INIT,    /**< RTOS kernel initialized */
+    MBED_BOOT_PHASE_MAIN_THREAD,    /**< Main thread started */
+    MBED_BOOT_PHASE_STATIC_INIT,    /**< C library and static C++ constructors initialized */
+    MBED_BOOT_PHASE_MAIN,           /**< mbed_main() and main() about to be called */
+    MBED_BOOT_PHASE_COUNT
+} mbed_boot_phase_t;
+
+#if MBED_CONF_PLATFORM_BOOT_TIME_ENABLED
+
+/**
+ * Record the end of a boot phase
+ *
+ * @param phase The phase that completed
+ *
+ * @note Called by the boot code, MBED_BOOT_PHASE_ENTRY starting the cycle
+ *       counter.
+ */
+void mbed_boot_time_record(mbed_boot_phase_t phase);
+
+#else
+
+#define mbed_boot_time_record(phase)    ((void)0)
+
+#endif
+
+/**
+ * Get the timestamp of a boot phase
+ *
+ * @param phase The phase to get the end of
+ * @return The cycles from MBED_BOOT_PHASE_ENTRY to the end of the phase,
+ *         0 if it was not recorded
+ */
+uint32_t mbed_boot_time_get(mbed_boot_phase_t phase);
+
+/**
+ * Print the time spent in each boot phase with printf
+ *
+ * @note Printing initializes stdio, call it from main() or later.
+ */
+void mbed_boot_time_print(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+/** @}*/
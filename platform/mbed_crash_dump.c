@@ -0,0 +1,381 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "platform/mbed_crash_dump.h"
+#include "platform/mbed_toolchain.h"
+#include "platform/mbed_printf.h"
+#include "platform/mbed_bin_trace.h"
+#include "cmsis.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#if MBED_CONF_RTOS_PRESENT
+#include "mbed_rtos_storage.h"
+#endif
+
+#ifndef MBED_CONF_PLATFORM_CRASH_DUMP_FAULT_HANDLERS
+#define MBED_CONF_PLATFORM_CRASH_DUMP_FAULT_HANDLERS    1
+#endif
+
+static const mbed_crash_dump_t *crash_dump_reported;
+
+#if MBED_CONF_PLATFORM_CRASH_DUMP_ENABLED
+
+/* The boot code must leave the dump as it is: it is either at an address
+ * outside of the image, or in a section that is neither loaded nor zeroed. */
+#if defined(MBED_CONF_PLATFORM_CRASH_DUMP_ADDRESS)
+#define crash_dump (*(mbed_crash_dump_t *)(MBED_CONF_PLATFORM_CRASH_DUMP_ADDRESS))
+#elif defined(__ICCARM__)
+static __no_init mbed_crash_dump_t crash_dump;
+#elif defined(__ARMCC_VERSION)
+static mbed_crash_dump_t crash_dump __attribute__((section(".bss.noinit"), zero_init));
+#else
+// The @ comments out the section flags GCC appends, so the section is NOBITS
+static mbed_crash_dump_t crash_dump __attribute__((section(".noinit,\"aw\",%nobits@")));
+#endif
+
+static uint32_t dump_checksum(const mbed_crash_dump_t *dump)
+{
+    const uint32_t *words = (const uint32_t *)dump;
+    const size_t checksum_word = offsetof(mbed_crash_dump_t, checksum) / sizeof(uint32_t);
+    uint32_t sum = 0x811C9DC5;
+
+    for (size_t i = 0; i < sizeof(*dump) / sizeof(uint32_t); i++) {
+        uint32_t word = i == checksum_word ? 0 : words[i];
+        sum = ((sum << 5) | (sum >> 27)) ^ word;
+    }
+    return sum;
+}
+
+static void dump_begin(mbed_crash_dump_t *dump, mbed_crash_dump_reason_t reason)
+{
+    memset(dump, 0, sizeof(*dump));
+    dump->reason = reason;
+}
+
+/* Makes what was captured so far valid. The capture goes on from the
+ * safest state to the least safe, so that a fault while reading a
+ * corrupted thread list or stack still leaves the registers. */
+static void dump_commit(mbed_crash_dump_t *dump)
+{
+    dump->magic = MBED_CRASH_DUMP_MAGIC;
+    dump->size = sizeof(*dump);
+    dump->checksum = dump_checksum(dump);
+}
+
+// The end of the stack sp is on, 0 when unknown
+static uint32_t stack_top(int process_stack)
+{
+#if MBED_CONF_RTOS_PRESENT && defined(MBED_OS_BACKEND_RTX5)
+    if (process_stack) {
+        const osRtxThread_t *thread = osRtxInfo.thread.run.curr;
+        return thread ? (uint32_t)thread->stack_mem + thread->stack_size : 0;
+    }
+#endif
+    // The initial main stack pointer is the first entry of the vector table
+#if defined(SCB_VTOR_TBLOFF_Msk)
+    const volatile uint32_t *vectors = (const volatile uint32_t *)SCB->VTOR;
+#else
+    const volatile uint32_t *vectors = (const volatile uint32_t *)0;
+#endif
+    return vectors[0];
+}
+
+static int stack_contains(uint32_t top, uint32_t sp, uint32_t size)
+{
+    return !(sp & 3) && top && sp < top && top - sp >= size;
+}
+
+static void dump_stack(mbed_crash_dump_t *dump, uint32_t top)
+{
+    if (!stack_contains(top, dump->sp, sizeof(uint32_t))) {
+        return;
+    }
+    uint32_t count = (top - dump->sp) / sizeof(uint32_t);
+    if (count > MBED_CONF_PLATFORM_CRASH_DUMP_STACK_WORDS) {
+        count = MBED_CONF_PLATFORM_CRASH_DUMP_STACK_WORDS;
+    }
+    memcpy(dump->stack, (const void *)dump->sp, count * sizeof(uint32_t));
+    dump->stack_count = count;
+}
+
+#if MBED_CONF_RTOS_PRESENT && defined(MBED_OS_BACKEND_RTX5)
+
+static void dump_thread(mbed_crash_dump_t *dump, const osRtxThread_t *thread)
+{
+    mbed_crash_dump_thread_t *entry = &dump->threads[dump->thread_count++];
+    entry->id = (uint32_t)thread;
+    entry->sp = thread->sp;
+    entry->stack_mem = (uint32_t)thread->stack_mem;
+    entry->stack_size = thread->stack_size;
+    entry->state = thread->state;
+    entry->priority = thread->priority;
+    if (thread->name) {
+        for (int i = 0; i < MBED_CRASH_DUMP_NAME_SIZE - 1 && thread->name[i]; i++) {
+            entry->name[i] = thread->name[i];
+        }
+    }
+}
+
+// The lists are linked through thread_next (ready) or delay_next (others)
+static void dump_thread_list(mbed_crash_dump_t *dump, const osRtxThread_t *thread, int delay_link)
+{
+    while (thread && dump->thread_count < MBED_CONF_PLATFORM_CRASH_DUMP_THREADS) {
+        if (((uint32_t)thread & 3) || thread->id != osRtxIdThread) {
+            return;
+        }
+        dump_thread(dump, thread);
+        thread = delay_link ? thread->delay_next : thread->thread_next;
+    }
+}
+
+static void dump_threads(mbed_crash_dump_t *dump)
+{
+    // The running thread is on none of the lists
+    const osRtxThread_t *current = osRtxInfo.thread.run.curr;
+    dump->current_thread = (uint32_t)current;
+    if (current && !((uint32_t)current & 3) && current->id == osRtxIdThread) {
+        dump_thread(dump, current);
+    }
+    dump_thread_list(dump, osRtxInfo.thread.ready.thread_list, 0);
+    dump_thread_list(dump, osRtxInfo.thread.delay_list, 1);
+    dump_thread_list(dump, osRtxInfo.thread.wait_list, 1);
+}
+
+#else
+
+static void dump_threads(mbed_crash_dump_t *dump)
+{
+}
+
+#endif
+
+static void dump_trace(mbed_crash_dump_t *dump)
+{
+#if MBED_CONF_PLATFORM_BIN_TRACE_ENABLED
+    dump->trace_size = mbed_bin_trace_read(dump->trace, sizeof(dump->trace));
+#endif
+}
+
+static void dump_rest(mbed_crash_dump_t *dump)
+{
+    dump_commit(dump);
+    dump_threads(dump);
+    dump_commit(dump);
+    dump_trace(dump);
+    dump_commit(dump);
+}
+
+void mbed_crash_dump_error(void *caller, const char *format, va_list args)
+{
+    mbed_crash_dump_t *dump = &crash_dump;
+    const int process_stack = __get_IPSR() == 0 && (__get_CONTROL() & CONTROL_SPSEL_Msk);
+
+    dump_begin(dump, MBED_CRASH_DUMP_ERROR);
+    dump->sp = process_stack ? __get_PSP() : __get_MSP();
+    dump->pc = (uint32_t)caller;
+    dump->xpsr = __get_xPSR();
+    mbed_vsnprintf(dump->message, sizeof(dump->message), format, args);
+    dump_commit(dump);
+
+    dump_stack(dump, stack_top(process_stack));
+    dump_rest(dump);
+}
+
+void mbed_crash_dump_boot(void)
+{
+    mbed_crash_dump_t *dump = &crash_dump;
+    if (dump->magic != MBED_CRASH_DUMP_MAGIC || dump->size != sizeof(*dump) ||
+            dump->checksum != dump_checksum(dump)) {
+        return;
+    }
+
+    // Only reported once, the next reset without a crash finds no dump
+    dump->magic = 0;
+    crash_dump_reported = dump;
+    mbed_crash_dump_report(dump);
+}
+
+#if MBED_CONF_PLATFORM_CRASH_DUMP_FAULT_HANDLERS && !defined(FEATURE_UVISOR) && !defined(__ICCARM__)
+
+/* Called by the fault handlers below, with the stack pointers and the
+ * EXC_RETURN value at the exception entry. r4 to r7 then r8 to r11 are
+ * pushed below msp. */
+__attribute__((used)) void mbed_crash_dump_fault(uint32_t msp, uint32_t psp, uint32_t exc_return)
+{
+    mbed_crash_dump_t *dump = &crash_dump;
+    const int process_stack = (exc_return & 4) != 0;
+    const uint32_t frame_addr = process_stack ? psp : msp;
+    const uint32_t *callee = (const uint32_t *)msp - 8;
+    const uint32_t top = stack_top(process_stack);
+
+    mbed_crash_dump_reason_t reason = MBED_CRASH_DUMP_HARD_FAULT;
+    switch (__get_IPSR() & 0x1FF) {
+        case 4: reason = MBED_CRASH_DUMP_MEM_MANAGE_FAULT; break;
+        case 5: reason = MBED_CRASH_DUMP_BUS_FAULT; break;
+        case 6: reason = MBED_CRASH_DUMP_USAGE_FAULT; break;
+    }
+
+    dump_begin(dump, reason);
+    dump->exc_return = exc_return;
+    for (int i = 0; i < 4; i++) {
+        dump->r[4 + i] = callee[4 + i];
+        dump->r[8 + i] = callee[i];
+    }
+#if defined(SCB_CFSR_MEMFAULTSR_Pos)
+    dump->cfsr = SCB->CFSR;
+    dump->hfsr = SCB->HFSR;
+    dump->mmfar = SCB->MMFAR;
+    dump->bfar = SCB->BFAR;
+#endif
+
+    // The exception frame is only read if it is on the stack it should be on
+    dump->sp = frame_addr;
+    if (stack_contains(top, frame_addr, 8 * sizeof(uint32_t))) {
+        const uint32_t *frame = (const uint32_t *)frame_addr;
+        for (int i = 0; i < 4; i++) {
+            dump->r[i] = frame[i];
+        }
+        dump->r[12] = frame[4];
+        dump->lr = frame[5];
+        dump->pc = frame[6];
+        dump->xpsr = frame[7];
+        // Past the basic or the floating point frame, and the alignment word
+        dump->sp += (exc_return & 0x10) ? 8 * sizeof(uint32_t) : 26 * sizeof(uint32_t);
+        if (dump->xpsr & (1 << 9)) {
+            dump->sp += sizeof(uint32_t);
+        }
+    }
+    dump_commit(dump);
+
+    dump_stack(dump, top);
+    dump_rest(dump);
+    mbed_crash_dump_fault_exit(dump);
+}
+
+#if defined(__CC_ARM)
+
+#define CRASH_DUMP_FAULT_HANDLER(name)  \
+__asm void name(void) {                 \
+    IMPORT  mbed_crash_dump_fault;      \
+    MRS     r0, MSP;                    \
+    MRS     r1, PSP;                    \
+    MOV     r2, LR;                     \
+    PUSH    {r4-r7};                    \
+    MOV     r4, r8;                     \
+    MOV     r5, r9;                     \
+    MOV     r6, r10;                    \
+    MOV     r7, r11;                    \
+    PUSH    {r4-r7};                    \
+    BL      mbed_crash_dump_fault;      \
+}
+
+#else
+
+#define CRASH_DUMP_FAULT_HANDLER(name)          \
+__attribute__((naked)) void name(void)          \
+{                                               \
+    __asm volatile(                             \
+        "mrs    r0, msp                 \n"     \
+        "mrs    r1, psp                 \n"     \
+        "mov    r2, lr                  \n"     \
+        "push   {r4-r7}                 \n"     \
+        "mov    r4, r8                  \n"     \
+        "mov    r5, r9                  \n"     \
+        "mov    r6, r10                 \n"     \
+        "mov    r7, r11                 \n"     \
+        "push   {r4-r7}                 \n"     \
+        "bl     mbed_crash_dump_fault   \n"     \
+    );                                          \
+}
+
+#endif
+
+CRASH_DUMP_FAULT_HANDLER(HardFault_Handler)
+#if defined(SCB_CFSR_MEMFAULTSR_Pos)
+CRASH_DUMP_FAULT_HANDLER(MemManage_Handler)
+CRASH_DUMP_FAULT_HANDLER(BusFault_Handler)
+CRASH_DUMP_FAULT_HANDLER(UsageFault_Handler)
+#endif
+
+#endif
+
+#endif // MBED_CONF_PLATFORM_CRASH_DUMP_ENABLED
+
+const mbed_crash_dump_t *mbed_crash_dump_get(void)
+{
+    return crash_dump_reported;
+}
+
+MBED_WEAK void mbed_crash_dump_report(const mbed_crash_dump_t *dump)
+{
+    mbed_crash_dump_print(dump);
+}
+
+MBED_WEAK void mbed_crash_dump_fault_exit(const mbed_crash_dump_t *dump)
+{
+    NVIC_SystemReset();
+}
+
+static const char *const reason_names[] = {
+    "unknown", "error", "HardFault", "MemManage fault", "BusFault", "UsageFault"
+};
+
+void mbed_crash_dump_print(const mbed_crash_dump_t *dump)
+{
+    uint32_t reason = dump->reason < sizeof(reason_names) / sizeof(reason_names[0]) ? dump->reason : 0;
+    printf("crash dump: %s\r\n", reason_names[reason]);
+    if (dump->message[0]) {
+        printf("message: %.*s\r\n", (int)sizeof(dump->message), dump->message);
+    }
+
+    for (int i = 0; i < 13; i++) {
+        printf("r%-2d %08lx%s", i, (unsigned long)dump->r[i], (i % 4 == 3 || i == 12) ? "\r\n" : "  ");
+    }
+    printf("sp  %08lx  lr  %08lx  pc  %08lx  xpsr %08lx\r\n", (unsigned long)dump->sp,
+           (unsigned long)dump->lr, (unsigned long)dump->pc, (unsigned long)dump->xpsr);
+    if (dump->exc_return) {
+        printf("exc_return %08lx  cfsr %08lx  hfsr %08lx  mmfar %08lx  bfar %08lx\r\n",
+               (unsigned long)dump->exc_return, (unsigned long)dump->cfsr, (unsigned long)dump->hfsr,
+               (unsigned long)dump->mmfar, (unsigned long)dump->bfar);
+    }
+
+    for (uint32_t i = 0; i < dump->thread_count && i < MBED_CONF_PLATFORM_CRASH_DUMP_THREADS; i++) {
+        const mbed_crash_dump_thread_t *thread = &dump->threads[i];
+        printf("thread %08lx %-*.*s state %u prio %d sp %08lx stack %08lx+%lu%s\r\n",
+               (unsigned long)thread->id, MBED_CRASH_DUMP_NAME_SIZE - 1, MBED_CRASH_DUMP_NAME_SIZE - 1,
+               thread->name, thread->state, thread->priority, (unsigned long)thread->sp,
+               (unsigned long)thread->stack_mem, (unsigned long)thread->stack_size,
+               thread->id == dump->current_thread ? " current" : "");
+    }
+
+    if (dump->stack_count) {
+        printf("stack:");
+        for (uint32_t i = 0; i < dump->stack_count && i < MBED_CONF_PLATFORM_CRASH_DUMP_STACK_WORDS; i++) {
+            printf("%s %08lx", i % 8 ? "" : "\r\n ", (unsigned long)dump->stack[i]);
+        }
+        printf("\r\n");
+    }
+
+    if (dump->trace_size) {
+        const uint8_t *trace = (const uint8_t *)dump->trace;
+        printf("trace:");
+        for (uint32_t i = 0; i < dump->trace_size && i < sizeof(dump->trace); i++) {
+            printf("%s%02x", i % 32 ? "" : "\r\n", trace[i]);
+        }
+        printf("\r\n");
+    }
+}
@@ -0,0 +1,198 @@
+/** \addtogroup platform */
+/** @{*/
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MBED_CRASH_DUMP_H
+#define MBED_CRASH_DUMP_H
+
+#include <stdint.h>
+#include <stdarg.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef MBED_CONF_PLATFORM_CRASH_DUMP_ENABLED
+#define MBED_CONF_PLATFORM_CRASH_DUMP_ENABLED       0
+#endif
+
+#ifndef MBED_CONF_PLATFORM_CRASH_DUMP_STACK_WORDS
+#define MBED_CONF_PLATFORM_CRASH_DUMP_STACK_WORDS   32
+#endif
+
+#ifndef MBED_CONF_PLATFORM_CRASH_DUMP_THREADS
+#define MBED_CONF_PLATFORM_CRASH_DUMP_THREADS       8
+#endif
+
+#ifndef MBED_CONF_PLATFORM_CRASH_DUMP_TRACE_SIZE
+#define MBED_CONF_PLATFORM_CRASH_DUMP_TRACE_SIZE    256
+#endif
+
+#define MBED_CRASH_DUMP_MAGIC           0x43524153
+#define MBED_CRASH_DUMP_MESSAGE_SIZE    64
+#define MBED_CRASH_DUMP_NAME_SIZE       12
+
+/**
+ * Crash dumps
+ *
+ * When error() is called or a fault exception is taken, the state of the
+ * system is written to RAM that the boot code does not initialize, so it
+ * survives the reset that follows:
+ *
+ * - the registers, and the fault status registers of the cores that have them
+ * - the words at the top of the stack in use
+ * - the RTOS threads
+ * - the records of the binary trace buffer (see platform/mbed_bin_trace.h)
+ *   that were not drained yet
+ *
+ * On the next boot, before mbed_main() and main(), a valid dump is handed to
+ * mbed_crash_dump_report, which prints it and can be overridden to store or
+ * send it instead. It is then marked as reported, and stays readable with
+ * mbed_crash_dump_get until the next crash.
+ *
+ * Nothing is captured unless the platform.crash-dump-enabled configuration
+ * option is set. The capture takes place on the error path only.
+ *
+ * The dump is kept in the .noinit section, which GCC linker scripts place
+ * after .bss when they do not list it. For the ARM toolchains, whose scatter
+ * files zero all RAM sections, and for linker scripts that place .noinit
+ * where the boot code initializes it, platform.crash-dump-address has to
+ * give the address of RAM excluded from the image, big enough for
+ * sizeof(mbed_crash_dump_t).
+ *
+ * With platform.crash-dump-fault-handlers set, the HardFault, MemManage,
+ * BusFault and UsageFault handlers are replaced with ones capturing a dump,
+ * then calling mbed_crash_dump_fault_exit. They are not built for IAR, nor
+ * with uVisor, which owns the fault handlers.
+ */
+
+/** What caused a crash dump */
+typedef enum {
+    MBED_CRASH_DUMP_ERROR = 1,          /**< error() was called */
+    MBED_CRASH_DUMP_HARD_FAULT,         /**< HardFault exception */
+    MBED_CRASH_DUMP_MEM_MANAGE_FAULT,   /**< MemManage exception */
+    MBED_CRASH_DUMP_BUS_FAULT,          /**< BusFault exception */
+    MBED_CRASH_DUMP_USAGE_FAULT         /**< UsageFault exception */
+} mbed_crash_dump_reason_t;
+
+/** A thread at the time of a crash */
+typedef struct {
+    uint32_t id;                        /**< Thread ID */
+    uint32_t sp;                        /**< Stack pointer saved at its last context switch */
+    uint32_t stack_mem;                 /**< Bottom of its stack */
+    uint32_t stack_size;                /**< Size of its stack in bytes */
+    uint8_t state;                      /**< RTOS thread state */
+    int8_t priority;                    /**< Priority */
+    char name[MBED_CRASH_DUMP_NAME_SIZE];   /**< Start of its name, null terminated */
+} mbed_crash_dump_thread_t;
+
+/** State of the system at the time of a crash */
+typedef struct {
+    uint32_t magic;                     /**< MBED_CRASH_DUMP_MAGIC while not reported */
+    uint32_t size;                      /**< sizeof(mbed_crash_dump_t) */
+    uint32_t checksum;                  /**< Of the whole dump, with this field at 0 */
+    uint32_t reason;                    /**< A mbed_crash_dump_reason_t */
+    uint32_t r[13];                     /**< r0 to r12, 0 for error() */
+    uint32_t sp;                        /**< Stack pointer */
+    uint32_t lr;                        /**< Link register */
+    uint32_t pc;                        /**< Faulting instruction, or the caller of error() */
+    uint32_t xpsr;                      /**< Program status register */
+    uint32_t exc_return;                /**< EXC_RETURN of a fault, 0 for error() */
+    uint32_t cfsr;                      /**< Configurable fault status register, 0 without */
+    uint32_t hfsr;                      /**< HardFault status register, 0 without */
+    uint32_t mmfar;                     /**< MemManage fault address register, 0 without */
+    uint32_t bfar;                      /**< BusFault address register, 0 without */
+    uint32_t current_thread;            /**< ID of the running thread, 0 without RTOS */
+    uint32_t thread_count;              /**< Entries used in threads */
+    mbed_crash_dump_thread_t threads[MBED_CONF_PLATFORM_CRASH_DUMP_THREADS];
+    uint32_t stack_count;               /**< Entries used in stack */
+    uint32_t stack[MBED_CONF_PLATFORM_CRASH_DUMP_STACK_WORDS];  /**< Words from sp up */
+    uint32_t trace_size;                /**< Bytes used in trace */
+    uint32_t trace[MBED_CONF_PLATFORM_CRASH_DUMP_TRACE_SIZE / 4];   /**< Binary trace records */
+    char message[MBED_CRASH_DUMP_MESSAGE_SIZE];   /**< Start of the error() message */
+} mbed_crash_dump_t;
+
+#if MBED_CONF_PLATFORM_CRASH_DUMP_ENABLED
+
+/**
+ * Capture a crash dump for error()
+ *
+ * @param caller The return address of error()
+ * @param format The message format
+ * @param args   The arguments of the format
+ *
+ * @note Called by error(), the message is formatted with mbed_vsnprintf.
+ */
+void mbed_crash_dump_error(void *caller, const char *format, va_list args);
+
+/**
+ * Report a dump left from before the reset, if there is one
+ *
+ * @note Called by the boot code before mbed_main()
+ */
+void mbed_crash_dump_boot(void);
+
+#else
+
+#define mbed_crash_dump_error(caller, format, args) ((void)0)
+#define mbed_crash_dump_boot()                      ((void)0)
+
+#endif
+
+/**
+ * Get the dump from before the reset
+ *
+ * @return The dump, or NULL if there was no crash dump to report at boot
+ */
+const mbed_crash_dump_t *mbed_crash_dump_get(void);
+
+/**
+ * Report a crash dump at boot
+ *
+ * Prints the dump with mbed_crash_dump_print by default. Being weak, it can
+ * be overridden to store the dump or send it to a server for example.
+ *
+ * @param dump The dump from before the reset
+ */
+void mbed_crash_dump_report(const mbed_crash_dump_t *dump);
+
+/**
+ * Print a crash dump with printf
+ *
+ * The trace records are printed as hex bytes, which `xxd -r -p` turns back
+ * into the input of tools/bin_trace.py.
+ *
+ * @param dump The dump to print
+ */
+void mbed_crash_dump_print(const mbed_crash_dump_t *dump);
+
+/**
+ * Called when a dump of a fault was captured
+ *
+ * Resets the system by default, and can be overridden to stop in a
+ * debugger for example. It must not return.
+ *
+ * @param dump The dump just captured
+ */
+void mbed_crash_dump_fault_exit(const mbed_crash_dump_t *dump);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+/** @}*/
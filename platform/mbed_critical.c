@@ -200,6 +200,114 @@ uint32_t core_util_atomic_decr_u32(uint32_t *valuePtr, uint32_t delta)
     return newValue;
 }
 
+uint8_t core_util_atomic_exchange_u8(uint8_t *valuePtr, uint8_t desiredValue)
+{
+    uint8_t currentValue;
+    do {
+        currentValue = __LDREXB((volatile uint8_t*)valuePtr);
+    } while (__STREXB(desiredValue, (volatile uint8_t*)valuePtr));
+    return currentValue;
+}
+
+uint16_t core_util_atomic_exchange_u16(uint16_t *valuePtr, uint16_t desiredValue)
+{
+    uint16_t currentValue;
+    do {
+        currentValue = __LDREXH((volatile uint16_t*)valuePtr);
+    } while (__STREXH(desiredValue, (volatile uint16_t*)valuePtr));
+    return currentValue;
+}
+
+uint32_t core_util_atomic_exchange_u32(uint32_t *valuePtr, uint32_t desiredValue)
+{
+    uint32_t currentValue;
+    do {
+        currentValue = __LDREXW((volatile uint32_t*)valuePtr);
+    } while (__STREXW(desiredValue, (volatile uint32_t*)valuePtr));
+    return currentValue;
+}
+
+uint8_t core_util_atomic_fetch_and_u8(uint8_t *valuePtr, uint8_t arg)
+{
+    uint8_t currentValue;
+    do {
+        currentValue = __LDREXB((volatile uint8_t*)valuePtr);
+    } while (__STREXB(currentValue & arg, (volatile uint8_t*)valuePtr));
+    return currentValue;
+}
+
+uint8_t core_util_atomic_fetch_or_u8(uint8_t *valuePtr, uint8_t arg)
+{
+    uint8_t currentValue;
+    do {
+        currentValue = __LDREXB((volatile uint8_t*)valuePtr);
+    } while (__STREXB(currentValue | arg, (volatile uint8_t*)valuePtr));
+    return currentValue;
+}
+
+uint8_t core_util_atomic_fetch_xor_u8(uint8_t *valuePtr, uint8_t arg)
+{
+    uint8_t currentValue;
+    do {
+        currentValue = __LDREXB((volatile uint8_t*)valuePtr);
+    } while (__STREXB(currentValue ^ arg, (volatile uint8_t*)valuePtr));
+    return currentValue;
+}
+
+uint16_t core_util_atomic_fetch_and_u16(uint16_t *valuePtr, uint16_t arg)
+{
+    uint16_t currentValue;
+    do {
+        currentValue = __LDREXH((volatile uint16_t*)valuePtr);
+    } while (__STREXH(currentValue & arg, (volatile uint16_t*)valuePtr));
+    return currentValue;
+}
+
+uint16_t core_util_atomic_fetch_or_u16(uint16_t *valuePtr, uint16_t arg)
+{
+    uint16_t currentValue;
+    do {
+        currentValue = __LDREXH((volatile uint16_t*)valuePtr);
+    } while (__STREXH(currentValue | arg, (volatile uint16_t*)valuePtr));
+    return currentValue;
+}
+
+uint16_t core_util_atomic_fetch_xor_u16(uint16_t *valuePtr, uint16_t arg)
+{
+    uint16_t currentValue;
+    do {
+        currentValue = __LDREXH((volatile uint16_t*)valuePtr);
+    } while (__STREXH(currentValue ^ arg, (volatile uint16_t*)valuePtr));
+    return currentValue;
+}
+
+uint32_t core_util_atomic_fetch_and_u32(uint32_t *valuePtr, uint32_t arg)
+{
+    uint32_t currentValue;
+    do {
+        currentValue = __LDREXW((volatile uint32_t*)valuePtr);
+    } while (__STREXW(currentValue & arg, (volatile uint32_t*)valuePtr));
+    return currentValue;
+}
+
+uint32_t core_util_atomic_fetch_or_u32(uint32_t *valuePtr, uint32_t arg)
+{
+    uint32_t currentValue;
+    do {
+        currentValue = __LDREXW((volatile uint32_t*)valuePtr);
+    } while (__STREXW(currentValue | arg, (volatile uint32_t*)valuePtr));
+    return currentValue;
+}
+
+uint32_t core_util_atomic_fetch_xor_u32(uint32_t *valuePtr, uint32_t arg)
+{
+    uint32_t currentValue;
+    do {
+        currentValue = __LDREXW((volatile uint32_t*)valuePtr);
+    } while (__STREXW(currentValue ^ arg, (volatile uint32_t*)valuePtr));
+    return currentValue;
+}
+
 #else
 
 bool core_util_atomic_cas_u8(uint8_t *ptr, uint8_t *expectedCurrentValue, uint8_t desiredValue)
@@ -316,6 +424,126 @@ uint32_t core_util_atomic_decr_u32(uint32_t *valuePtr, uint32_t delta)
     return newValue;
 }
 
+uint8_t core_util_atomic_exchange_u8(uint8_t *valuePtr, uint8_t desiredValue)
+{
+    uint8_t currentValue;
+    core_util_critical_section_enter();
+    currentValue = *valuePtr;
+    *valuePtr = desiredValue;
+    core_util_critical_section_exit();
+    return currentValue;
+}
+
+uint16_t core_util_atomic_exchange_u16(uint16_t *valuePtr, uint16_t desiredValue)
+{
+    uint16_t currentValue;
+    core_util_critical_section_enter();
+    currentValue = *valuePtr;
+    *valuePtr = desiredValue;
+    core_util_critical_section_exit();
+    return currentValue;
+}
+
+uint32_t core_util_atomic_exchange_u32(uint32_t *valuePtr, uint32_t desiredValue)
+{
+    uint32_t currentValue;
+    core_util_critical_section_enter();
+    currentValue = *valuePtr;
+    *valuePtr = desiredValue;
+    core_util_critical_section_exit();
+    return currentValue;
+}
+
+uint8_t core_util_atomic_fetch_and_u8(uint8_t *valuePtr, uint8_t arg)
+{
+    uint8_t currentValue;
+    core_util_critical_section_enter();
+    currentValue = *valuePtr;
+    *valuePtr = currentValue & arg;
+    core_util_critical_section_exit();
+    return currentValue;
+}
+
+uint8_t core_util_atomic_fetch_or_u8(uint8_t *valuePtr, uint8_t arg)
+{
+    uint8_t currentValue;
+    core_util_critical_section_enter();
+    currentValue = *valuePtr;
+    *valuePtr = currentValue | arg;
+    core_util_critical_section_exit();
+    return currentValue;
+}
+
+uint8_t core_util_atomic_fetch_xor_u8(uint8_t *valuePtr, uint8_t arg)
+{
+    uint8_t currentValue;
+    core_util_critical_section_enter();
+    currentValue = *valuePtr;
+    *valuePtr = currentValue ^ arg;
+    core_util_critical_section_exit();
+    return currentValue;
+}
+
+uint16_t core_util_atomic_fetch_and_u16(uint16_t *valuePtr, uint16_t arg)
+{
+    uint16_t currentValue;
+    core_util_critical_section_enter();
+    currentValue = *valuePtr;
+    *valuePtr = currentValue & arg;
+    core_util_critical_section_exit();
+    return currentValue;
+}
+
+uint16_t core_util_atomic_fetch_or_u16(uint16_t *valuePtr, uint16_t arg)
+{
+    uint16_t currentValue;
+    core_util_critical_section_enter();
+    currentValue = *valuePtr;
+    *valuePtr = currentValue | arg;
+    core_util_critical_section_exit();
+    return currentValue;
+}
+
+uint16_t core_util_atomic_fetch_xor_u16(uint16_t *valuePtr, uint16_t arg)
+{
+    uint16_t currentValue;
+    core_util_critical_section_enter();
+    currentValue = *valuePtr;
+    *valuePtr = currentValue ^ arg;
+    core_util_critical_section_exit();
+    return currentValue;
+}
+
+uint32_t core_util_atomic_fetch_and_u32(uint32_t *valuePtr, uint32_t arg)
+{
+    uint32_t currentValue;
+    core_util_critical_section_enter();
+    currentValue = *valuePtr;
+    *valuePtr = currentValue & arg;
+    core_util_critical_section_exit();
+    return currentValue;
+}
+
+uint32_t core_util_atomic_fetch_or_u32(uint32_t *valuePtr, uint32_t arg)
+{
+    uint32_t currentValue;
+    core_util_critical_section_enter();
+    currentValue = *valuePtr;
+    *valuePtr = currentValue | arg;
+    core_util_critical_section_exit();
+    return currentValue;
+}
+
+uint32_t core_util_atomic_fetch_xor_u32(uint32_t *valuePtr, uint32_t arg)
+{
+    uint32_t currentValue;
+    core_util_critical_section_enter();
+    currentValue = *valuePtr;
+    *valuePtr = currentValue ^ arg;
+    core_util_critical_section_exit();
+    return currentValue;
+}
+
 #endif
 
 
@@ -334,3 +562,121 @@ void *core_util_atomic_decr_ptr(void **valuePtr, ptrdiff_t delta) {
     return (void *)core_util_atomic_decr_u32((uint32_t *)valuePtr, (uint32_t)delta);
 }
 
+uint8_t core_util_atomic_load_u8(const uint8_t *valuePtr)
+{
+    uint8_t value = *(const volatile uint8_t*)valuePtr;
+    __DMB();
+    return value;
+}
+
+void core_util_atomic_store_u8(uint8_t *valuePtr, uint8_t desiredValue)
+{
+    __DMB();
+    *(volatile uint8_t*)valuePtr = desiredValue;
+    __DMB();
+}
+
+uint16_t core_util_atomic_load_u16(const uint16_t *valuePtr)
+{
+    uint16_t value = *(const volatile uint16_t*)valuePtr;
+    __DMB();
+    return value;
+}
+
+void core_util_atomic_store_u16(uint16_t *valuePtr, uint16_t desiredValue)
+{
+    __DMB();
+    *(volatile uint16_t*)valuePtr = desiredValue;
+    __DMB();
+}
+
+uint32_t core_util_atomic_load_u32(const uint32_t *valuePtr)
+{
+    uint32_t value = *(const volatile uint32_t*)valuePtr;
+    __DMB();
+    return value;
+}
+
+void core_util_atomic_store_u32(uint32_t *valuePtr, uint32_t desiredValue)
+{
+    __DMB();
+    *(volatile uint32_t*)valuePtr = desiredValue;
+    __DMB();
+}
+
+/* Cortex-M has no 64-bit exclusive accesses, and a 64-bit access may be
+ * split in two, so all the 64-bit operations take a critical section */
+bool core_util_atomic_cas_u64(uint64_t *ptr, uint64_t *expectedCurrentValue, uint64_t desiredValue)
+{
+    bool success;
+    uint64_t currentValue;
+    core_util_critical_section_enter();
+    currentValue = *ptr;
+    if (currentValue == *expectedCurrentValue) {
+        *ptr = desiredValue;
+        success = true;
+    } else {
+        *expectedCurrentValue = currentValue;
+        success = false;
+    }
+    core_util_critical_section_exit();
+    return success;
+}
+
+uint64_t core_util_atomic_load_u64(const uint64_t *valuePtr)
+{
+    uint64_t value;
+    core_util_critical_section_enter();
+    value = *valuePtr;
+    core_util_critical_section_exit();
+    return value;
+}
+
+void core_util_atomic_store_u64(uint64_t *valuePtr, uint64_t desiredValue)
+{
+    core_util_critical_section_enter();
+    *valuePtr = desiredValue;
+    core_util_critical_section_exit();
+}
+
+uint64_t core_util_atomic_exchange_u64(uint64_t *valuePtr, uint64_t desiredValue)
+{
+    uint64_t currentValue;
+    core_util_critical_section_enter();
+    currentValue = *valuePtr;
+    *valuePtr = desiredValue;
+    core_util_critical_section_exit();
+    return currentValue;
+}
+
+uint64_t core_util_atomic_incr_u64(uint64_t *valuePtr, uint64_t delta)
+{
+    uint64_t newValue;
+    core_util_critical_section_enter();
+    newValue = *valuePtr + delta;
+    *valuePtr = newValue;
+    core_util_critical_section_exit();
+    return newValue;
+}
+
+uint64_t core_util_atomic_decr_u64(uint64_t *valuePtr, uint64_t delta)
+{
+    uint64_t newValue;
+    core_util_critical_section_enter();
+    newValue = *valuePtr - delta;
+    *valuePtr = newValue;
+    core_util_critical_section_exit();
+    return newValue;
+}
+
+void *core_util_atomic_load_ptr(void *const *valuePtr) {
+    return (void *)core_util_atomic_load_u32((const uint32_t *)valuePtr);
+}
+
+void core_util_atomic_store_ptr(void **valuePtr, void *desiredValue) {
+    core_util_atomic_store_u32((uint32_t *)valuePtr, (uint32_t)desiredValue);
+}
+
+void *core_util_atomic_exchange_ptr(void **valuePtr, void *desiredValue) {
+    return (void *)core_util_atomic_exchange_u32((uint32_t *)valuePtr, (uint32_t)desiredValue);
+}
@@ -360,6 +360,222 @@ uint32_t core_util_atomic_decr_u32(uint32_t *valuePtr, uint32_t delta);
  */
 void *core_util_atomic_decr_ptr(void **valuePtr, ptrdiff_t delta);
 
+/**
+ * Atomic compare and set, as core_util_atomic_cas_u32 for a 64-bit value.
+ *
+ * @note Cortex-M has no 64-bit exclusive accesses, so this and the other
+ *       64-bit operations run in a critical section.
+ */
+bool core_util_atomic_cas_u64(uint64_t *ptr, uint64_t *expectedCurrentValue, uint64_t desiredValue);
+
+/**
+ * Atomic load with acquire semantics: memory accesses after the load are
+ * not made ahead of it.
+ * @param  valuePtr Target memory location.
+ * @return          The loaded value.
+ */
+uint8_t core_util_atomic_load_u8(const uint8_t *valuePtr);
+
+/**
+ * Atomic store with release semantics: memory accesses before the store
+ * are made ahead of it.
+ * @param  valuePtr     Target memory location.
+ * @param  desiredValue The value to store.
+ */
+void core_util_atomic_store_u8(uint8_t *valuePtr, uint8_t desiredValue);
+
+/**
+ * Atomic exchange.
+ * @param  valuePtr     Target memory location.
+ * @param  desiredValue The value to store.
+ * @return              The previous value.
+ */
+uint8_t core_util_atomic_exchange_u8(uint8_t *valuePtr, uint8_t desiredValue);
+
+/**
+ * Atomic load with acquire semantics: memory accesses after the load are
+ * not made ahead of it.
+ * @param  valuePtr Target memory location.
+ * @return          The loaded value.
+ */
+uint16_t core_util_atomic_load_u16(const uint16_t *valuePtr);
+
+/**
+ * Atomic store with release semantics: memory accesses before the store
+ * are made ahead of it.
+ * @param  valuePtr     Target memory location.
+ * @param  desiredValue The value to store.
+ */
+void core_util_atomic_store_u16(uint16_t *valuePtr, uint16_t desiredValue);
+
+/**
+ * Atomic exchange.
+ * @param  valuePtr     Target memory location.
+ * @param  desiredValue The value to store.
+ * @return              The previous value.
+ */
+uint16_t core_util_atomic_exchange_u16(uint16_t *valuePtr, uint16_t desiredValue);
+
+/**
+ * Atomic load with acquire semantics: memory accesses after the load are
+ * not made ahead of it.
+ * @param  valuePtr Target memory location.
+ * @return          The loaded value.
+ */
+uint32_t core_util_atomic_load_u32(const uint32_t *valuePtr);
+
+/**
+ * Atomic store with release semantics: memory accesses before the store
+ * are made ahead of it.
+ * @param  valuePtr     Target memory location.
+ * @param  desiredValue The value to store.
+ */
+void core_util_atomic_store_u32(uint32_t *valuePtr, uint32_t desiredValue);
+
+/**
+ * Atomic exchange.
+ * @param  valuePtr     Target memory location.
+ * @param  desiredValue The value to store.
+ * @return              The previous value.
+ */
+uint32_t core_util_atomic_exchange_u32(uint32_t *valuePtr, uint32_t desiredValue);
+
+/**
+ * Atomic load with acquire semantics: memory accesses after the load are
+ * not made ahead of it.
+ * @param  valuePtr Target memory location.
+ * @return          The loaded value.
+ */
+uint64_t core_util_atomic_load_u64(const uint64_t *valuePtr);
+
+/**
+ * Atomic store with release semantics: memory accesses before the store
+ * are made ahead of it.
+ * @param  valuePtr     Target memory location.
+ * @param  desiredValue The value to store.
+ */
+void core_util_atomic_store_u64(uint64_t *valuePtr, uint64_t desiredValue);
+
+/**
+ * Atomic exchange.
+ * @param  valuePtr     Target memory location.
+ * @param  desiredValue The value to store.
+ * @return              The previous value.
+ */
+uint64_t core_util_atomic_exchange_u64(uint64_t *valuePtr, uint64_t desiredValue);
+
+/**
+ * Atomic load with acquire semantics: memory accesses after the load are
+ * not made ahead of it.
+ * @param  valuePtr Target memory location.
+ * @return          The loaded value.
+ */
+void *core_util_atomic_load_ptr(void *const *valuePtr);
+
+/**
+ * Atomic store with release semantics: memory accesses before the store
+ * are made ahead of it.
+ * @param  valuePtr     Target memory location.
+ * @param  desiredValue The value to store.
+ */
+void core_util_atomic_store_ptr(void **valuePtr, void *desiredValue);
+
+/**
+ * Atomic exchange.
+ * @param  valuePtr     Target memory location.
+ * @param  desiredValue The value to store.
+ * @return              The previous value.
+ */
+void *core_util_atomic_exchange_ptr(void **valuePtr, void *desiredValue);
+
+/**
+ * Atomic bitwise AND.
+ * @param  valuePtr Target memory location.
+ * @param  arg      The value to combine with.
+ * @return          The previous value.
+ */
+uint8_t core_util_atomic_fetch_and_u8(uint8_t *valuePtr, uint8_t arg);
+
+/**
+ * Atomic bitwise OR.
+ * @param  valuePtr Target memory location.
+ * @param  arg      The value to combine with.
+ * @return          The previous value.
+ */
+uint8_t core_util_atomic_fetch_or_u8(uint8_t *valuePtr, uint8_t arg);
+
+/**
+ * Atomic bitwise exclusive OR.
+ * @param  valuePtr Target memory location.
+ * @param  arg      The value to combine with.
+ * @return          The previous value.
+ */
+uint8_t core_util_atomic_fetch_xor_u8(uint8_t *valuePtr, uint8_t arg);
+
+/**
+ * Atomic bitwise AND.
+ * @param  valuePtr Target memory location.
+ * @param  arg      The value to combine with.
+ * @return          The previous value.
+ */
+uint16_t core_util_atomic_fetch_and_u16(uint16_t *valuePtr, uint16_t arg);
+
+/**
+ * Atomic bitwise OR.
+ * @param  valuePtr Target memory location.
+ * @param  arg      The value to combine with.
+ * @return          The previous value.
+ */
+uint16_t core_util_atomic_fetch_or_u16(uint16_t *valuePtr, uint16_t arg);
+
+/**
+ * Atomic bitwise exclusive OR.
+ * @param  valuePtr Target memory location.
+ * @param  arg      The value to combine with.
+ * @return          The previous value.
+ */
+uint16_t core_util_atomic_fetch_xor_u16(uint16_t *valuePtr, uint16_t arg);
+
+/**
+ * Atomic bitwise AND.
+ * @param  valuePtr Target memory location.
+ * @param  arg      The value to combine with.
+ * @return          The previous value.
+ */
+uint32_t core_util_atomic_fetch_and_u32(uint32_t *valuePtr, uint32_t arg);
+
+/**
+ * Atomic bitwise OR.
+ * @param  valuePtr Target memory location.
+ * @param  arg      The value to combine with.
+ * @return          The previous value.
+ */
+uint32_t core_util_atomic_fetch_or_u32(uint32_t *valuePtr, uint32_t arg);
+
+/**
+ * Atomic bitwise exclusive OR.
+ * @param  valuePtr Target memory location.
+ * @param  arg      The value to combine with.
+ * @return          The previous value.
+ */
+uint32_t core_util_atomic_fetch_xor_u32(uint32_t *valuePtr, uint32_t arg);
+
+/**
+ * Atomic increment, as core_util_atomic_incr_u32 for a 64-bit value.
+ * @param  valuePtr Target memory location being incremented.
+ * @param  delta    The amount being incremented.
+ * @return          The new incremented value.
+ */
+uint64_t core_util_atomic_incr_u64(uint64_t *valuePtr, uint64_t delta);
+
+/**
+ * Atomic decrement, as core_util_atomic_decr_u32 for a 64-bit value.
+ * @param  valuePtr Target memory location being decremented.
+ * @param  delta    The amount being decremented.
+ * @return          The new decremented value.
+ */
+uint64_t core_util_atomic_decr_u64(uint64_t *valuePtr, uint64_t delta);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
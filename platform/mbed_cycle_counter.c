@@ -0,0 +1,105 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "platform/mbed_cycle_counter.h"
+#include "hal/us_ticker_api.h"
+#include "cmsis.h"
+
+#define US_TICKER_FREQUENCY     1000000
+
+static uint32_t cycle_frequency = US_TICKER_FREQUENCY;
+// counts per nanosecond as a 0.32 fixed point fraction
+static uint32_t cycles_per_ns_q32 = (uint32_t)(((uint64_t)US_TICKER_FREQUENCY << 32) / 1000000000);
+static uint8_t cycle_precise;
+
+static void cycle_counter_set_frequency(uint32_t frequency)
+{
+    cycle_frequency = frequency;
+    cycles_per_ns_q32 = (frequency >= 1000000000) ? UINT32_MAX :
+                        (uint32_t)(((uint64_t)frequency << 32) / 1000000000);
+}
+
+void mbed_cycle_counter_init(void)
+{
+#if defined(DWT_CTRL_CYCCNTENA_Msk)
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+#if defined(DWT_CTRL_NOCYCCNT_Msk)
+    if (DWT->CTRL & DWT_CTRL_NOCYCCNT_Msk) {
+        return;
+    }
+#endif
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    // some cores only implement the register, check the counter runs
+    uint32_t start = DWT->CYCCNT;
+    __NOP();
+    __NOP();
+    if (DWT->CYCCNT == start) {
+        return;
+    }
+
+    uint32_t frequency = SystemCoreClock;
+#if MBED_CONF_PLATFORM_CYCLE_COUNTER_CALIBRATE_US
+    // start on a tick edge so the measurement is not short by part of a tick
+    uint32_t tick = us_ticker_read();
+    while (us_ticker_read() == tick);
+    tick = us_ticker_read();
+    uint32_t cycles = DWT->CYCCNT;
+    uint32_t elapsed;
+    while ((elapsed = us_ticker_read() - tick) < MBED_CONF_PLATFORM_CYCLE_COUNTER_CALIBRATE_US);
+    cycles = DWT->CYCCNT - cycles;
+    frequency = (uint32_t)((uint64_t)cycles * US_TICKER_FREQUENCY / elapsed);
+#endif
+    cycle_counter_set_frequency(frequency);
+    cycle_precise = 1;
+#endif
+}
+
+uint32_t mbed_cycle_counter_read(void)
+{
+#if defined(DWT_CTRL_CYCCNTENA_Msk)
+    if (cycle_precise) {
+        return DWT->CYCCNT;
+    }
+#endif
+    return us_ticker_read();
+}
+
+uint32_t mbed_cycle_counter_frequency(void)
+{
+    return cycle_frequency;
+}
+
+int mbed_cycle_counter_precise(void)
+{
+    return cycle_precise;
+}
+
+uint32_t mbed_cycle_counter_from_ns(uint32_t ns)
+{
+    return (uint32_t)(((uint64_t)ns * cycles_per_ns_q32 + UINT32_MAX) >> 32);
+}
+
+uint32_t mbed_cycle_counter_to_ns(uint32_t cycles)
+{
+    uint64_t ns = (uint64_t)cycles * 1000000000 / cycle_frequency;
+    return (ns > UINT32_MAX) ? UINT32_MAX : (uint32_t)ns;
+}
+
+void mbed_cycle_counter_wait(uint32_t cycles)
+{
+    uint32_t start = mbed_cycle_counter_read();
+    while ((mbed_cycle_counter_read() - start) < cycles);
+}
@@ -0,0 +1,110 @@
+/** \addtogroup platform */
+/** @{*/
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MBED_CYCLE_COUNTER_H
+#define MBED_CYCLE_COUNTER_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef MBED_CONF_PLATFORM_CYCLE_COUNTER_CALIBRATE_US
+#define MBED_CONF_PLATFORM_CYCLE_COUNTER_CALIBRATE_US   0
+#endif
+
+/**
+ * CPU cycle counter
+ *
+ * On cores with a DWT cycle counter, reading the time is a single load
+ * from the core, where reading the us_ticker can take several microseconds
+ * on targets whose ticker sits behind a slow bus. The counter makes
+ * busy waits below a microsecond and profiling of short code sections
+ * possible.
+ *
+ * On cores without a DWT cycle counter, such as Cortex-M0, the counter
+ * falls back to the us_ticker and counts microseconds, which
+ * mbed_cycle_counter_precise reports.
+ *
+ * The frequency is SystemCoreClock, or is measured against the us_ticker
+ * once at boot when platform.cycle-counter-calibrate-us is set, for targets
+ * whose SystemCoreClock is not exact.
+ *
+ * @note The DWT counter stops while the core sleeps, so it does not measure
+ *       time across a sleep.
+ */
+
+/**
+ * Start the cycle counter and find its frequency
+ *
+ * @note Called by the boot code before main(), until then the counter reads
+ *       the us_ticker.
+ */
+void mbed_cycle_counter_init(void);
+
+/**
+ * Read the cycle counter
+ *
+ * @return The counter, which wraps around at 32 bits
+ */
+uint32_t mbed_cycle_counter_read(void);
+
+/**
+ * Get the frequency of the cycle counter
+ *
+ * @return Counts per second
+ */
+uint32_t mbed_cycle_counter_frequency(void);
+
+/**
+ * Check if the counter counts core cycles
+ *
+ * @return Non-zero with a DWT cycle counter, 0 when the counter reads the us_ticker
+ */
+int mbed_cycle_counter_precise(void);
+
+/**
+ * Convert nanoseconds to counts, rounding up
+ *
+ * @param ns Nanoseconds
+ * @return Counts lasting at least ns
+ */
+uint32_t mbed_cycle_counter_from_ns(uint32_t ns);
+
+/**
+ * Convert counts to nanoseconds
+ *
+ * @param cycles Counts, from the difference of two reads
+ * @return Nanoseconds, saturated at UINT32_MAX
+ */
+uint32_t mbed_cycle_counter_to_ns(uint32_t cycles);
+
+/**
+ * Busy wait for a number of counts
+ *
+ * @param cycles Counts to wait, at most half the range of the counter
+ */
+void mbed_cycle_counter_wait(uint32_t cycles);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+/** @}*/
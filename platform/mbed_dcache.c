@@ -0,0 +1,55 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "platform/mbed_dcache.h"
+#include <stdlib.h>
+
+#if MBED_DCACHE_PRESENT
+
+void *mbed_dma_alloc(size_t size)
+{
+    // room for the aligned buffer plus the pointer malloc returned, which
+    // is stored in the word just before the aligned buffer
+    uint8_t *raw = (uint8_t *)malloc(MBED_DCACHE_ROUND_UP(size) +
+            MBED_DCACHE_LINE_SIZE + sizeof(void *));
+    if (!raw) {
+        return NULL;
+    }
+
+    uintptr_t aligned = MBED_DCACHE_ROUND_UP((uintptr_t)(raw + sizeof(void *)));
+    ((void **)aligned)[-1] = raw;
+    return (void *)aligned;
+}
+
+void mbed_dma_free(void *ptr)
+{
+    if (ptr) {
+        free(((void **)ptr)[-1]);
+    }
+}
+
+#else
+
+void *mbed_dma_alloc(size_t size)
+{
+    return malloc(size);
+}
+
+void mbed_dma_free(void *ptr)
+{
+    free(ptr);
+}
+
+#endif
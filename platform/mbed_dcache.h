@@ -0,0 +1,195 @@
+/** \addtogroup platform */
+/** @{*/
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MBED_DCACHE_H
+#define MBED_DCACHE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "cmsis.h"
+#include "platform/mbed_toolchain.h"
+
+/** Data cache maintenance for DMA buffers
+ *
+ * On cores with a data cache, such as the Cortex-M7, memory written by the
+ * CPU may still sit in the cache when a DMA transfer reads it, and lines
+ * in the cache may hide data a DMA transfer has written. Drivers keep DMA
+ * buffers coherent by cleaning them before a transfer reads them and
+ * invalidating them after a transfer has written them.
+ *
+ * Writing back a line that a DMA transfer has written in memory overwrites
+ * the transfer's data with what the cache held. A buffer written by DMA
+ * must therefore not share a cache line with data the CPU writes during
+ * the transfer: declare it with MBED_DCACHE_ALIGNED and a size rounded
+ * with MBED_DCACHE_ROUND_UP, or allocate it with mbed_dma_alloc, and check
+ * buffers supplied by callers with mbed_dcache_is_aligned.
+ *
+ * On cores without a data cache all of these functions do nothing.
+ *
+ * Example:
+ * @code
+ * MBED_DCACHE_ALIGNED static uint8_t rx[MBED_DCACHE_ROUND_UP(64)];
+ *
+ * mbed_dcache_clean(tx, sizeof(tx));
+ * mbed_dcache_invalidate(rx, sizeof(rx));
+ * start_dma(tx, rx);
+ * wait_for_dma();
+ * mbed_dcache_invalidate(rx, sizeof(rx));
+ * @endcode
+ */
+
+#if defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U)
+#define MBED_DCACHE_PRESENT     1
+#define MBED_DCACHE_LINE_SIZE   32
+#else
+#define MBED_DCACHE_PRESENT     0
+#define MBED_DCACHE_LINE_SIZE   4
+#endif
+
+/** Align a buffer to the start of a data cache line */
+#define MBED_DCACHE_ALIGNED     MBED_ALIGN(MBED_DCACHE_LINE_SIZE)
+
+/** Round a size up to a whole number of data cache lines */
+#define MBED_DCACHE_ROUND_UP(size) \
+    (((size) + MBED_DCACHE_LINE_SIZE - 1) & ~(MBED_DCACHE_LINE_SIZE - 1))
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Check whether a range covers whole data cache lines only
+ *
+ * A range for which this holds can be written by DMA without sharing a
+ * line with anything else.
+ *
+ * @param addr  Start of the range
+ * @param size  Size of the range in bytes
+ * @return True if the range starts and ends on a cache line boundary
+ */
+static inline bool mbed_dcache_is_aligned(const void *addr, size_t size)
+{
+    return (((uintptr_t)addr | size) & (MBED_DCACHE_LINE_SIZE - 1)) == 0;
+}
+
+/** Write back a range of memory from the data cache
+ *
+ * Call before a DMA transfer reads the range.
+ *
+ * @param addr  Start of the range
+ * @param size  Size of the range in bytes
+ */
+static inline void mbed_dcache_clean(const void *addr, size_t size)
+{
+#if MBED_DCACHE_PRESENT
+    if (size) {
+        uintptr_t start = (uintptr_t)addr & ~(uintptr_t)(MBED_DCACHE_LINE_SIZE - 1);
+        SCB_CleanDCache_by_Addr((uint32_t *)start, (int32_t)((uintptr_t)addr + size - start));
+    }
+#else
+    (void)addr;
+    (void)size;
+#endif
+}
+
+/** Write back and discard a range of memory from the data cache
+ *
+ * Call before a DMA transfer that reads the range and then writes it, such
+ * as a descriptor ring. The whole range is written back, so never call it
+ * once a DMA transfer has written the range: use mbed_dcache_invalidate.
+ *
+ * @param addr  Start of the range
+ * @param size  Size of the range in bytes
+ */
+static inline void mbed_dcache_clean_invalidate(void *addr, size_t size)
+{
+#if MBED_DCACHE_PRESENT
+    if (size) {
+        uintptr_t start = (uintptr_t)addr & ~(uintptr_t)(MBED_DCACHE_LINE_SIZE - 1);
+        SCB_CleanInvalidateDCache_by_Addr((uint32_t *)start, (int32_t)((uintptr_t)addr + size - start));
+    }
+#else
+    (void)addr;
+    (void)size;
+#endif
+}
+
+/** Discard a range of memory from the data cache
+ *
+ * Call before and after a DMA transfer writes the range. Lines only
+ * partly covered by the range are written back first, so data next to an
+ * unaligned buffer is never lost. That write back also overwrites what DMA
+ * wrote to the rest of those lines if the CPU wrote next to the buffer
+ * during the transfer, so the range should satisfy mbed_dcache_is_aligned
+ * unless the lines around it belong to memory the CPU does not write.
+ *
+ * @param addr  Start of the range
+ * @param size  Size of the range in bytes
+ */
+static inline void mbed_dcache_invalidate(void *addr, size_t size)
+{
+#if MBED_DCACHE_PRESENT
+    const uintptr_t mask = MBED_DCACHE_LINE_SIZE - 1;
+    uintptr_t start = (uintptr_t)addr;
+    uintptr_t end = start + size;
+
+    if (size == 0) {
+        return;
+    }
+
+    if (start & mask) {
+        SCB_CleanInvalidateDCache_by_Addr((uint32_t *)(start & ~mask), MBED_DCACHE_LINE_SIZE);
+        start = (start | mask) + 1;
+    }
+
+    if ((end & mask) && end > start) {
+        SCB_CleanInvalidateDCache_by_Addr((uint32_t *)(end & ~mask), MBED_DCACHE_LINE_SIZE);
+        end &= ~mask;
+    }
+
+    if (end > start) {
+        SCB_InvalidateDCache_by_Addr((uint32_t *)start, (int32_t)(end - start));
+    }
+#else
+    (void)addr;
+    (void)size;
+#endif
+}
+
+/** Allocate a buffer for DMA
+ *
+ * The buffer starts on a data cache line and is rounded up to a whole
+ * number of lines, so it never shares a line with other data.
+ *
+ * @param size  Size of the buffer in bytes
+ * @return The buffer, or NULL if out of memory
+ */
+void *mbed_dma_alloc(size_t size);
+
+/** Free a buffer allocated with mbed_dma_alloc
+ *
+ * @param ptr   The buffer, may be NULL
+ */
+void mbed_dma_free(void *ptr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+/** @}*/
@@ -19,6 +19,7 @@
 #include "platform/mbed_toolchain.h"
 #include "platform/mbed_error.h"
 #include "platform/mbed_interface.h"
+#include "platform/mbed_crash_dump.h"
 #if DEVICE_STDIO_MESSAGES
 #include <stdio.h>
 #endif
@@ -33,6 +34,13 @@ WEAK void error(const char* format, ...) {
     }
     error_in_progress = 1;
 
+#if MBED_CONF_PLATFORM_CRASH_DUMP_ENABLED
+    va_list dump_arg;
+    va_start(dump_arg, format);
+    mbed_crash_dump_error(MBED_CALLER_ADDR(), format, dump_arg);
+    va_end(dump_arg);
+#endif
+
 #ifndef NDEBUG
     va_list arg;
     va_start(arg, format);
@@ -0,0 +1,122 @@
+/** \addtogroup platform */
+/** @{*/
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MBED_HEAP_REGIONS_H
+#define MBED_HEAP_REGIONS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Heap regions
+ *
+ * RAM outside of the main heap, such as SRAM2, CCM or external SDRAM, can
+ * be given to the allocator as regions of up to platform.heap-regions.
+ * Each region has attributes, and memory with given attributes, such as a
+ * DMA buffer, is allocated with mbed_heap_alloc. The main heap has the
+ * attributes of platform.heap-attributes and is used first if it has
+ * them.
+ *
+ * When the main heap runs out, malloc carries on in the regions that
+ * have all the attributes of the main heap. With GCC and ARMCC free and
+ * realloc take memory of any region. With other toolchains, memory of
+ * regions must be freed with mbed_heap_free.
+ *
+ * Targets add their regions from mbed_sdk_init, applications before they
+ * use them. Regions are never removed. Each region is managed by its own
+ * TLSF allocator, see mbed_tlsf.h, and its allocations are not counted in
+ * mbed_stats_heap_get.
+ */
+
+/** Memory that DMA controllers can reach */
+#define MBED_HEAP_DMA       (1 << 0)
+/** Memory without wait states, such as CCM or tightly coupled RAM */
+#define MBED_HEAP_FAST      (1 << 1)
+/** Large memory for bulk data, possibly slower, such as external SDRAM */
+#define MBED_HEAP_LARGE     (1 << 2)
+
+/** Information on a heap region */
+typedef struct {
+    void *start;                /**< Start of the region */
+    uint32_t size;              /**< Size of the region in bytes */
+    uint32_t attributes;        /**< Logical OR of the MBED_HEAP_ attributes */
+    uint32_t free_size;         /**< Bytes in free blocks */
+    uint32_t largest_free_size; /**< Size of the largest free block */
+} mbed_heap_region_info_t;
+
+/**
+ * Give memory to the allocator as a heap region
+ *
+ * @param start      The start of the memory
+ * @param size       The size of the memory in bytes
+ * @param attributes Logical OR of the MBED_HEAP_ attributes of the memory
+ * @return The index of the region, or -1 if there are platform.heap-regions
+ *         regions already or the memory is too small
+ */
+int mbed_heap_region_add(void *start, size_t size, uint32_t attributes);
+
+/**
+ * Allocate memory with attributes
+ *
+ * Tries the main heap if it has the attributes, then the regions with
+ * them in the order they were added.
+ *
+ * @param size       The size in bytes
+ * @param attributes Logical OR of the MBED_HEAP_ attributes the memory
+ *                   must have, 0 for any memory
+ * @return The memory, or NULL if no heap with the attributes has room
+ */
+void *mbed_heap_alloc(size_t size, uint32_t attributes);
+
+/**
+ * Allocate aligned memory with attributes
+ *
+ * @param alignment  The alignment, a power of two
+ * @param size       The size in bytes
+ * @param attributes Logical OR of the MBED_HEAP_ attributes the memory
+ *                   must have, 0 for any memory
+ * @return The memory, or NULL if no heap with the attributes has room
+ */
+void *mbed_heap_memalign(size_t alignment, size_t size, uint32_t attributes);
+
+/**
+ * Free memory of the main heap or of a region
+ *
+ * @param ptr The memory, or NULL to do nothing
+ */
+void mbed_heap_free(void *ptr);
+
+/**
+ * Get information on a heap region
+ *
+ * @param index The index of the region
+ * @param info  Filled in with the information
+ * @return 0 on success, or -1 if there is no region with the index
+ */
+int mbed_heap_region_info(int index, mbed_heap_region_info_t *info);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+/** @}*/
@@ -0,0 +1,130 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "platform/mbed_irq.h"
+#include "platform/mbed_critical.h"
+#include <stdbool.h>
+
+#if defined(NVIC_RAM_VECTOR_ADDRESS) && !defined(__CORTEX_A9)
+
+// Interrupts bound with mbed_irq_bind, and what they were before
+typedef struct {
+    bool used;
+    IRQn_Type irq;
+    uint32_t vector;
+    uint32_t priority;
+    bool enabled;
+} direct_irq_t;
+
+static direct_irq_t direct_irqs[MBED_CONF_PLATFORM_DIRECT_IRQ_MAX];
+
+static bool vectors_in_ram(void)
+{
+#if defined(__CORTEX_M0)
+    // no VTOR, the target's NVIC_SetVector is responsible for the table
+    return true;
+#else
+    return SCB->VTOR == (uint32_t)NVIC_RAM_VECTOR_ADDRESS;
+#endif
+}
+
+static direct_irq_t *find(IRQn_Type irq)
+{
+    for (int i = 0; i < MBED_CONF_PLATFORM_DIRECT_IRQ_MAX; i++) {
+        if (direct_irqs[i].used && direct_irqs[i].irq == irq) {
+            return &direct_irqs[i];
+        }
+    }
+    return NULL;
+}
+
+static void set_vector(IRQn_Type irq, uint32_t vector)
+{
+    NVIC_SetVector(irq, vector);
+    __DSB();
+    __ISB();
+}
+
+int mbed_irq_bind(IRQn_Type irq, void (*handler)(void), uint32_t priority)
+{
+    int ret = -1;
+
+    if (irq < 0 || !vectors_in_ram()) {
+        return -1;
+    }
+
+    core_util_critical_section_enter();
+    if (!find(irq)) {
+        for (int i = 0; i < MBED_CONF_PLATFORM_DIRECT_IRQ_MAX; i++) {
+            direct_irq_t *d = &direct_irqs[i];
+            if (!d->used) {
+                d->used = true;
+                d->irq = irq;
+                d->vector = NVIC_GetVector(irq);
+                d->priority = NVIC_GetPriority(irq);
+                d->enabled = NVIC_GetEnableIRQ(irq);
+
+                NVIC_DisableIRQ(irq);
+                set_vector(irq, (uint32_t)handler);
+                NVIC_SetPriority(irq, priority);
+                NVIC_EnableIRQ(irq);
+                ret = 0;
+                break;
+            }
+        }
+    }
+    core_util_critical_section_exit();
+
+    return ret;
+}
+
+int mbed_irq_unbind(IRQn_Type irq)
+{
+    int ret = -1;
+
+    core_util_critical_section_enter();
+    direct_irq_t *d = find(irq);
+    if (d) {
+        NVIC_DisableIRQ(irq);
+        set_vector(irq, d->vector);
+        NVIC_SetPriority(irq, d->priority);
+        if (d->enabled) {
+            NVIC_EnableIRQ(irq);
+        }
+        d->used = false;
+        ret = 0;
+    }
+    core_util_critical_section_exit();
+
+    return ret;
+}
+
+#else
+
+int mbed_irq_bind(IRQn_Type irq, void (*handler)(void), uint32_t priority)
+{
+    (void)irq;
+    (void)handler;
+    (void)priority;
+    return -1;
+}
+
+int mbed_irq_unbind(IRQn_Type irq)
+{
+    (void)irq;
+    return -1;
+}
+
+#endif
@@ -0,0 +1,81 @@
+/** \addtogroup platform */
+/** @{*/
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MBED_IRQ_H
+#define MBED_IRQ_H
+
+#include <stdint.h>
+#include "cmsis.h"
+
+#ifndef MBED_CONF_PLATFORM_DIRECT_IRQ_MAX
+#define MBED_CONF_PLATFORM_DIRECT_IRQ_MAX 4
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Bind a handler directly to a peripheral interrupt
+ *
+ *  The handler is written straight into the RAM vector table, so the
+ *  interrupt no longer goes through the HAL's irq id tables and the
+ *  driver's Callback. This trades the convenience of the drivers for the
+ *  shortest possible path to the handler, for interrupts that fire tens of
+ *  thousands of times a second.
+ *
+ *  The handler runs in place of the HAL's own handler for the interrupt,
+ *  and must clear the peripheral's interrupt flags itself. Any driver
+ *  sharing the interrupt stops getting events until mbed_irq_unbind.
+ *
+ *  Only targets that move the vector table to RAM at boot, by defining
+ *  NVIC_RAM_VECTOR_ADDRESS, support this.
+ *
+ *  Example:
+ *  @code
+ *  void encoder_irq(void) {
+ *      EXTI->PR = EXTI_PR_PR0;
+ *      position += (GPIOA->IDR & 2) ? 1 : -1;
+ *  }
+ *
+ *  mbed_irq_bind(EXTI0_IRQn, encoder_irq, 0);
+ *  @endcode
+ *
+ *  @param irq      The interrupt to bind
+ *  @param handler  The handler to run when the interrupt fires
+ *  @param priority The NVIC priority to give the interrupt
+ *  @return 0 on success, -1 if the vector table is not in RAM, the
+ *          interrupt is already bound, or platform.direct-irq-max
+ *          interrupts are bound already
+ */
+int mbed_irq_bind(IRQn_Type irq, void (*handler)(void), uint32_t priority);
+
+/** Restore the handler an interrupt had before mbed_irq_bind
+ *
+ *  The interrupt's priority and whether it is enabled are restored too.
+ *
+ *  @param irq      The interrupt to unbind
+ *  @return 0 on success, -1 if the interrupt is not bound
+ */
+int mbed_irq_unbind(IRQn_Type irq);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+/** @}*/
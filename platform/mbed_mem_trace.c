@@ -17,6 +17,7 @@
 #include <stdlib.h>
 #include <stdarg.h>
 #include <stdio.h>
+#include <string.h>
 #include "platform/mbed_mem_trace.h"
 #include "platform/mbed_critical.h"
 
@@ -113,3 +114,202 @@ void mbed_mem_trace_default_callback(uint8_t op, void *res, void *caller, ...) {
     va_end(va);
 }
 
+
+/******************************************************************************
+ * Aggregating tracer
+ *****************************************************************************/
+
+typedef struct {
+    void *ptr;
+    uint32_t size;
+    uint16_t site;
+} live_block_t;
+
+/* The sites that did not fit in the table share the last entry */
+#define OTHER_SITE  MBED_CONF_PLATFORM_MEM_TRACE_SITES
+
+static mbed_mem_trace_site_t sites[MBED_CONF_PLATFORM_MEM_TRACE_SITES + 1];
+static live_block_t live_blocks[MBED_CONF_PLATFORM_MEM_TRACE_LIVE_BLOCKS];
+
+static uint32_t live_hash(void *ptr) {
+    return ((uintptr_t)ptr >> 3) % MBED_CONF_PLATFORM_MEM_TRACE_LIVE_BLOCKS;
+}
+
+/* Find or add the table entry of a caller, with open addressing */
+static uint16_t site_lookup(void *caller) {
+    if (caller == NULL) {
+        return OTHER_SITE;
+    }
+    uint32_t i = ((uintptr_t)caller >> 1) % MBED_CONF_PLATFORM_MEM_TRACE_SITES;
+    for (uint32_t n = 0; n < MBED_CONF_PLATFORM_MEM_TRACE_SITES; n++) {
+        if (sites[i].caller == caller) {
+            return i;
+        }
+        if (sites[i].caller == NULL) {
+            sites[i].caller = caller;
+            return i;
+        }
+        i = (i + 1) % MBED_CONF_PLATFORM_MEM_TRACE_SITES;
+    }
+    return OTHER_SITE;
+}
+
+static live_block_t *live_find(void *ptr) {
+    uint32_t i = live_hash(ptr);
+    for (uint32_t n = 0; n < MBED_CONF_PLATFORM_MEM_TRACE_LIVE_BLOCKS; n++) {
+        if (live_blocks[i].ptr == ptr) {
+            return &live_blocks[i];
+        }
+        if (live_blocks[i].ptr == NULL) {
+            return NULL;
+        }
+        i = (i + 1) % MBED_CONF_PLATFORM_MEM_TRACE_LIVE_BLOCKS;
+    }
+    return NULL;
+}
+
+/* Remove a block, shifting back the blocks after it so lookups need no tombstones */
+static void live_remove(live_block_t *block) {
+    uint32_t i = block - live_blocks;
+    uint32_t j = i;
+    for (uint32_t n = 1; n < MBED_CONF_PLATFORM_MEM_TRACE_LIVE_BLOCKS; n++) {
+        j = (j + 1) % MBED_CONF_PLATFORM_MEM_TRACE_LIVE_BLOCKS;
+        if (live_blocks[j].ptr == NULL) {
+            break;
+        }
+        uint32_t k = live_hash(live_blocks[j].ptr);
+        if (i <= j ? (i < k && k <= j) : (i < k || k <= j)) {
+            continue;
+        }
+        live_blocks[i] = live_blocks[j];
+        i = j;
+    }
+    live_blocks[i].ptr = NULL;
+}
+
+static void aggregate_alloc(void *res, size_t size, void *caller) {
+    mbed_mem_trace_site_t *site = &sites[site_lookup(caller)];
+    if (res == NULL) {
+        site->alloc_fail_cnt++;
+        return;
+    }
+    site->alloc_cnt++;
+    site->total_size += size;
+
+    uint32_t i = live_hash(res);
+    for (uint32_t n = 0; n < MBED_CONF_PLATFORM_MEM_TRACE_LIVE_BLOCKS; n++) {
+        if (live_blocks[i].ptr == NULL) {
+            live_blocks[i].ptr = res;
+            live_blocks[i].size = size;
+            live_blocks[i].site = site - sites;
+            site->current_size += size;
+            if (site->current_size > site->max_size) {
+                site->max_size = site->current_size;
+            }
+            return;
+        }
+        i = (i + 1) % MBED_CONF_PLATFORM_MEM_TRACE_LIVE_BLOCKS;
+    }
+}
+
+static void aggregate_free(void *ptr, bool undo) {
+    live_block_t *block = live_find(ptr);
+    if (block == NULL) {
+        return;
+    }
+    mbed_mem_trace_site_t *site = &sites[block->site];
+    site->current_size -= block->size;
+    if (undo) {
+        site->alloc_cnt--;
+        site->total_size -= block->size;
+    } else {
+        site->free_cnt++;
+    }
+    live_remove(block);
+}
+
+void mbed_mem_trace_aggregate_callback(uint8_t op, void *res, void *caller, ...) {
+    va_list va;
+    size_t temp_s1, temp_s2;
+    void *temp_ptr;
+
+    va_start(va, caller);
+    core_util_critical_section_enter();
+    switch(op) {
+        case MBED_MEM_TRACE_MALLOC:
+            temp_s1 = va_arg(va, size_t);
+            aggregate_alloc(res, temp_s1, caller);
+            break;
+
+        case MBED_MEM_TRACE_REALLOC:
+            temp_ptr = va_arg(va, void*);
+            temp_s1 = va_arg(va, size_t);
+            if (res == NULL && temp_s1 == 0) {
+                aggregate_free(temp_ptr, false);
+            } else if (res != NULL) {
+                aggregate_free(temp_ptr, false);
+                // the library may have implemented realloc with a traced malloc
+                aggregate_free(res, true);
+                aggregate_alloc(res, temp_s1, caller);
+            } else {
+                aggregate_alloc(NULL, temp_s1, caller);
+            }
+            break;
+
+        case MBED_MEM_TRACE_CALLOC:
+            temp_s1 = va_arg(va, size_t);
+            temp_s2 = va_arg(va, size_t);
+            // calloc calls malloc, count the block for the caller of calloc
+            aggregate_free(res, true);
+            aggregate_alloc(res, temp_s1 * temp_s2, caller);
+            break;
+
+        case MBED_MEM_TRACE_FREE:
+            temp_ptr = va_arg(va, void*);
+            aggregate_free(temp_ptr, false);
+            break;
+    }
+    core_util_critical_section_exit();
+    va_end(va);
+}
+
+/* Copy a site if it is in use */
+static bool site_copy(uint32_t i, mbed_mem_trace_site_t *site) {
+    bool used;
+    core_util_critical_section_enter();
+    used = sites[i].caller != NULL || sites[i].alloc_cnt || sites[i].alloc_fail_cnt;
+    if (used) {
+        *site = sites[i];
+    }
+    core_util_critical_section_exit();
+    return used;
+}
+
+size_t mbed_mem_trace_aggregate_get(mbed_mem_trace_site_t *stats, size_t count) {
+    size_t filled = 0;
+    for (uint32_t i = 0; i <= OTHER_SITE && filled < count; i++) {
+        if (site_copy(i, &stats[filled])) {
+            filled++;
+        }
+    }
+    return filled;
+}
+
+void mbed_mem_trace_aggregate_dump(void) {
+    for (uint32_t i = 0; i <= OTHER_SITE; i++) {
+        // work on a copy, printf may allocate and update the site
+        mbed_mem_trace_site_t site;
+        if (site_copy(i, &site)) {
+            printf(MBED_MEM_DEFAULT_TRACER_PREFIX "s:%p-%u;%u;%u;%u;%u;%u\n", site.caller,
+                   site.alloc_cnt, site.free_cnt, site.alloc_fail_cnt,
+                   site.total_size, site.current_size, site.max_size);
+        }
+    }
+}
+
+void mbed_mem_trace_aggregate_reset(void) {
+    core_util_critical_section_enter();
+    memset(sites, 0, sizeof(sites));
+    memset(live_blocks, 0, sizeof(live_blocks));
+    core_util_critical_section_exit();
+}
@@ -38,6 +38,25 @@ enum {
 /* Prefix for the output of the default tracer */
 #define MBED_MEM_DEFAULT_TRACER_PREFIX  "#"
 
+#ifndef MBED_CONF_PLATFORM_MEM_TRACE_SITES
+#define MBED_CONF_PLATFORM_MEM_TRACE_SITES          64
+#endif
+
+#ifndef MBED_CONF_PLATFORM_MEM_TRACE_LIVE_BLOCKS
+#define MBED_CONF_PLATFORM_MEM_TRACE_LIVE_BLOCKS    256
+#endif
+
+/* Allocation statistics of a call site, collected by the aggregating tracer */
+typedef struct {
+    void *caller;               /**< Caller of the allocations, NULL for the sites that did not fit in the table. */
+    uint32_t alloc_cnt;         /**< Number of allocations. */
+    uint32_t free_cnt;          /**< Number of allocations freed again. */
+    uint32_t alloc_fail_cnt;    /**< Number of failed allocations. */
+    uint32_t total_size;        /**< Cumulative sum of bytes allocated. */
+    uint32_t current_size;      /**< Bytes allocated currently. */
+    uint32_t max_size;          /**< Max bytes allocated at a given time. */
+} mbed_mem_trace_site_t;
+
 /**
  * Type of the callback used by the memory tracer. This callback is called when a memory
  * allocation operation (malloc, realloc, calloc, free) is called and tracing is enabled
@@ -133,6 +152,43 @@ void mbed_mem_trace_free(void *ptr, void *caller);
  */
 void mbed_mem_trace_default_callback(uint8_t op, void *res, void *caller, ...);
 
+/**
+ * Aggregating memory trace callback. DO NOT CALL DIRECTLY. It is meant to be used
+ * as the argument of 'mbed_mem_trace_set_callback'.
+ *
+ * Instead of printing each operation, this callback keeps allocation statistics per
+ * caller in RAM, so it can stay enabled through a real workload without changing its
+ * timing. Up to MBED_CONF_PLATFORM_MEM_TRACE_SITES callers are kept, the allocations
+ * of any others are added to a single site with a NULL caller.
+ *
+ * Frees are matched to the allocating caller through a table of up to
+ * MBED_CONF_PLATFORM_MEM_TRACE_LIVE_BLOCKS live blocks. Blocks allocated while that
+ * table is full are counted, but not in the current and max sizes of their site.
+ */
+void mbed_mem_trace_aggregate_callback(uint8_t op, void *res, void *caller, ...);
+
+/**
+ * Get the allocation statistics collected by 'mbed_mem_trace_aggregate_callback'.
+ *
+ * @param sites an array to fill with the statistics of each call site.
+ * @param count the number of elements in the array.
+ * @return the number of call sites filled in.
+ */
+size_t mbed_mem_trace_aggregate_get(mbed_mem_trace_site_t *sites, size_t count);
+
+/**
+ * Print the allocation statistics collected by 'mbed_mem_trace_aggregate_callback'.
+ *
+ * Each call site is printed on a line, in a format that's easily parsable by an
+ * external tool: "#s:<0xcaller>-alloc_cnt;free_cnt;alloc_fail_cnt;total_size;current_size;max_size".
+ */
+void mbed_mem_trace_aggregate_dump(void);
+
+/**
+ * Clear the allocation statistics and the table of live blocks.
+ */
+void mbed_mem_trace_aggregate_reset(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,233 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "platform/mbed_memcpy.h"
+#include "platform/mbed_toolchain.h"
+#include <stdint.h>
+#include <string.h>
+
+#ifndef MBED_MEMCPY_OVERRIDE
+#define MBED_MEMCPY_OVERRIDE MBED_CONF_PLATFORM_MEMCPY_OVERRIDE
+#endif
+
+#if defined(__GNUC__) && !defined(__CC_ARM) && !defined(__clang__)
+/* Keep GCC from turning the loops below back into calls to memcpy and
+ * memset, which are these functions when they override the C library */
+#pragma GCC optimize ("no-tree-loop-distribute-patterns")
+#endif
+
+#if defined(__GNUC__)
+typedef uint32_t __attribute__((__may_alias__)) word_t;
+#else
+typedef uint32_t word_t;
+#endif
+
+typedef MBED_PACKED(struct) {
+    word_t w;
+} unaligned_word_t;
+
+#define WORD_SIZE   sizeof(word_t)
+#define WORD_MASK   (WORD_SIZE - 1)
+#define BLOCK_SIZE  (4 * WORD_SIZE)
+
+/* A block of four words is loaded before it is stored, which lets the
+ * compiler use LDM and STM, and keeps a forward copy correct when the
+ * destination overlaps the source from below. */
+static void copy_words(word_t *d, const word_t *s, size_t words)
+{
+    for (; words >= 4; words -= 4) {
+        word_t w0 = s[0], w1 = s[1], w2 = s[2], w3 = s[3];
+        d[0] = w0;
+        d[1] = w1;
+        d[2] = w2;
+        d[3] = w3;
+        s += 4;
+        d += 4;
+    }
+    while (words--) {
+        *d++ = *s++;
+    }
+}
+
+#if defined(__ARM_FEATURE_UNALIGNED)
+
+static void copy_words_unaligned(word_t *d, const uint8_t *s, size_t words)
+{
+    const unaligned_word_t *u = (const unaligned_word_t *)s;
+    for (; words >= 4; words -= 4) {
+        word_t w0 = u[0].w, w1 = u[1].w, w2 = u[2].w, w3 = u[3].w;
+        d[0] = w0;
+        d[1] = w1;
+        d[2] = w2;
+        d[3] = w3;
+        u += 4;
+        d += 4;
+    }
+    while (words--) {
+        *d++ = (u++)->w;
+    }
+}
+
+#else
+
+/* Without unaligned loads (Cortex-M0, M0+ and M23), each destination word
+ * is made of the upper bytes of an aligned source word and the lower bytes
+ * of the next one, little endian. Only the words holding source bytes are
+ * read. */
+static void copy_words_unaligned(word_t *d, const uint8_t *s, size_t words)
+{
+    const unsigned offset = (uintptr_t)s & WORD_MASK;
+    const unsigned lo = 8 * offset;
+    const unsigned hi = 8 * (WORD_SIZE - offset);
+    const word_t *w = (const word_t *)(s - offset);
+    word_t prev = *w++;
+
+    for (; words >= 4; words -= 4) {
+        word_t w0 = w[0], w1 = w[1], w2 = w[2], w3 = w[3];
+        d[0] = (prev >> lo) | (w0 << hi);
+        d[1] = (w0 >> lo) | (w1 << hi);
+        d[2] = (w1 >> lo) | (w2 << hi);
+        d[3] = (w2 >> lo) | (w3 << hi);
+        prev = w3;
+        w += 4;
+        d += 4;
+    }
+    while (words--) {
+        word_t next = *w++;
+        *d++ = (prev >> lo) | (next << hi);
+        prev = next;
+    }
+}
+
+#endif
+
+void *mbed_memcpy(void *dst, const void *src, size_t n)
+{
+    uint8_t *d = (uint8_t *)dst;
+    const uint8_t *s = (const uint8_t *)src;
+
+    if (n >= BLOCK_SIZE) {
+        while ((uintptr_t)d & WORD_MASK) {
+            *d++ = *s++;
+            n--;
+        }
+        size_t words = n / WORD_SIZE;
+        if (((uintptr_t)s & WORD_MASK) == 0) {
+            copy_words((word_t *)d, (const word_t *)s, words);
+        } else {
+            copy_words_unaligned((word_t *)d, s, words);
+        }
+        d += words * WORD_SIZE;
+        s += words * WORD_SIZE;
+        n -= words * WORD_SIZE;
+    }
+    while (n--) {
+        *d++ = *s++;
+    }
+    return dst;
+}
+
+void *mbed_memmove(void *dst, const void *src, size_t n)
+{
+    uint8_t *d = (uint8_t *)dst;
+    const uint8_t *s = (const uint8_t *)src;
+
+    // Copying forward is safe unless the destination starts inside the source
+    if (d <= s || d >= s + n) {
+        return mbed_memcpy(dst, src, n);
+    }
+
+    d += n;
+    s += n;
+    if (n >= BLOCK_SIZE && (((uintptr_t)d ^ (uintptr_t)s) & WORD_MASK) == 0) {
+        while ((uintptr_t)d & WORD_MASK) {
+            *--d = *--s;
+            n--;
+        }
+        word_t *dw = (word_t *)d;
+        const word_t *sw = (const word_t *)s;
+        for (; n >= BLOCK_SIZE; n -= BLOCK_SIZE) {
+            word_t w3 = sw[-1], w2 = sw[-2], w1 = sw[-3], w0 = sw[-4];
+            dw[-1] = w3;
+            dw[-2] = w2;
+            dw[-3] = w1;
+            dw[-4] = w0;
+            sw -= 4;
+            dw -= 4;
+        }
+        for (; n >= WORD_SIZE; n -= WORD_SIZE) {
+            *--dw = *--sw;
+        }
+        d = (uint8_t *)dw;
+        s = (const uint8_t *)sw;
+    }
+    while (n--) {
+        *--d = *--s;
+    }
+    return dst;
+}
+
+void *mbed_memset(void *dst, int value, size_t n)
+{
+    uint8_t *d = (uint8_t *)dst;
+    const uint8_t byte = (uint8_t)value;
+
+    if (n >= BLOCK_SIZE) {
+        while ((uintptr_t)d & WORD_MASK) {
+            *d++ = byte;
+            n--;
+        }
+        const word_t pattern = byte * (word_t)0x01010101;
+        word_t *w = (word_t *)d;
+        for (; n >= BLOCK_SIZE; n -= BLOCK_SIZE) {
+            w[0] = pattern;
+            w[1] = pattern;
+            w[2] = pattern;
+            w[3] = pattern;
+            w += 4;
+        }
+        for (; n >= WORD_SIZE; n -= WORD_SIZE) {
+            *w++ = pattern;
+        }
+        d = (uint8_t *)w;
+    }
+    while (n--) {
+        *d++ = byte;
+    }
+    return dst;
+}
+
+#if MBED_MEMCPY_OVERRIDE && defined(TOOLCHAIN_GCC)
+
+/* Defined here, these take the place of the newlib-nano ones at link time.
+ * They are marked used so that link time optimization keeps them for the
+ * calls the compiler itself generates. */
+
+__attribute__((used)) void *memcpy(void *dst, const void *src, size_t n)
+{
+    return mbed_memcpy(dst, src, n);
+}
+
+__attribute__((used)) void *memmove(void *dst, const void *src, size_t n)
+{
+    return mbed_memmove(dst, src, n);
+}
+
+__attribute__((used)) void *memset(void *dst, int value, size_t n)
+{
+    return mbed_memset(dst, value, n);
+}
+
+#endif
@@ -0,0 +1,81 @@
+/** \addtogroup platform */
+/** @{*/
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MBED_MEMCPY_H
+#define MBED_MEMCPY_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Word based memory copy and fill
+ *
+ * These behave as the C library functions of the same name, but move
+ * memory a word at a time, four words per loop iteration, whatever the
+ * toolchain. Only the bytes up to the first word boundary of the
+ * destination and the bytes after the last one are moved one at a time.
+ *
+ * A source at a different offset in its word than the destination is read
+ * with unaligned loads on cores that have them (Cortex-M3 and up), and as
+ * aligned words shifted into place on the others (Cortex-M0 and M0+).
+ *
+ * The platform.memcpy-override configuration option, or MBED_MEMCPY_OVERRIDE
+ * set by the build profile, makes them the memcpy, memmove and memset of
+ * the whole program with GCC, whose newlib-nano versions copy a byte at a
+ * time. The ARM and IAR libraries already move words and are left in place.
+ */
+
+/**
+ * Copy memory, the areas must not overlap
+ *
+ * @param dst Destination
+ * @param src Source
+ * @param n   Number of bytes to copy
+ * @return dst
+ */
+void *mbed_memcpy(void *dst, const void *src, size_t n);
+
+/**
+ * Copy memory, the areas may overlap
+ *
+ * @param dst Destination
+ * @param src Source
+ * @param n   Number of bytes to copy
+ * @return dst
+ */
+void *mbed_memmove(void *dst, const void *src, size_t n);
+
+/**
+ * Fill memory with a byte
+ *
+ * @param dst   Destination
+ * @param value Byte to fill with, converted to an unsigned char
+ * @param n     Number of bytes to fill
+ * @return dst
+ */
+void *mbed_memset(void *dst, int value, size_t n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+/** @}*/
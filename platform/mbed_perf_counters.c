@@ -0,0 +1,276 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "platform/mbed_perf_counters.h"
+#include "platform/mbed_critical.h"
+#include "platform/mbed_assert.h"
+#include "platform/mbed_stats.h"
+#include <string.h>
+
+// Export being written, len keeps counting past the end of the buffer
+typedef struct {
+    uint8_t *buf;
+    size_t size;
+    size_t len;
+} perf_writer_t;
+
+static void put(perf_writer_t *w, const void *data, size_t size)
+{
+    if (w->len < w->size) {
+        size_t n = w->size - w->len < size ? w->size - w->len : size;
+        memcpy(w->buf + w->len, data, n);
+    }
+    w->len += size;
+}
+
+static void put_str(perf_writer_t *w, const char *s)
+{
+    put(w, s, strlen(s));
+}
+
+static void put_u8(perf_writer_t *w, uint8_t value)
+{
+    put(w, &value, 1);
+}
+
+#if MBED_CONF_PLATFORM_PERF_COUNTERS_ENABLED
+
+static void put_uint(perf_writer_t *w, uint32_t value)
+{
+    char digits[10];
+    int n = 0;
+    do {
+        digits[sizeof digits - ++n] = '0' + value % 10;
+        value /= 10;
+    } while (value);
+    put(w, &digits[sizeof digits - n], n);
+}
+
+static void put_u32(perf_writer_t *w, uint32_t value)
+{
+    uint8_t bytes[4] = { value, value >> 8, value >> 16, value >> 24 };
+    put(w, bytes, 4);
+}
+
+static void put_name(perf_writer_t *w, const char *name)
+{
+    size_t len = strlen(name);
+    if (len > 255) {
+        len = 255;
+    }
+    put_u8(w, len);
+    put(w, name, len);
+}
+
+static mbed_perf_counter_t *perf_counters;
+static mbed_perf_histogram_t *perf_histograms;
+static mbed_perf_hook_t *perf_hooks;
+
+#if MBED_HEAP_STATS_ENABLED
+static MBED_PERF_COUNTER(heap_current_size, "heap.current_size");
+static MBED_PERF_COUNTER(heap_max_size, "heap.max_size");
+static MBED_PERF_COUNTER(heap_alloc_cnt, "heap.alloc_cnt");
+static MBED_PERF_COUNTER(heap_alloc_fail_cnt, "heap.alloc_fail_cnt");
+
+static void heap_update(void)
+{
+    mbed_stats_heap_t stats;
+    mbed_stats_heap_get(&stats);
+    mbed_perf_counter_set(&heap_current_size, stats.current_size);
+    mbed_perf_counter_set(&heap_max_size, stats.max_size);
+    mbed_perf_counter_set(&heap_alloc_cnt, stats.alloc_cnt);
+    mbed_perf_counter_set(&heap_alloc_fail_cnt, stats.alloc_fail_cnt);
+}
+
+static MBED_PERF_HOOK(heap_hook, heap_update);
+#endif
+
+// Entries are only ever pushed at the head, so the lists can be walked
+// without a lock while entries are added
+void mbed_perf_counter_register(mbed_perf_counter_t *counter)
+{
+    core_util_critical_section_enter();
+    if (!counter->registered) {
+        counter->next = perf_counters;
+        perf_counters = counter;
+        counter->registered = true;
+    }
+    core_util_critical_section_exit();
+}
+
+void mbed_perf_counter_add(mbed_perf_counter_t *counter, uint32_t n)
+{
+    if (!counter->registered) {
+        mbed_perf_counter_register(counter);
+    }
+    core_util_atomic_incr_u32(&counter->value, n);
+}
+
+void mbed_perf_counter_set(mbed_perf_counter_t *counter, uint32_t value)
+{
+    if (!counter->registered) {
+        mbed_perf_counter_register(counter);
+    }
+    counter->value = value;
+}
+
+void mbed_perf_histogram_register(mbed_perf_histogram_t *histogram)
+{
+    MBED_ASSERT(histogram->bound_cnt < MBED_PERF_HISTOGRAM_BUCKETS);
+    core_util_critical_section_enter();
+    if (!histogram->registered) {
+        histogram->next = perf_histograms;
+        perf_histograms = histogram;
+        histogram->registered = true;
+    }
+    core_util_critical_section_exit();
+}
+
+void mbed_perf_histogram_add(mbed_perf_histogram_t *histogram, uint32_t value)
+{
+    if (!histogram->registered) {
+        mbed_perf_histogram_register(histogram);
+    }
+
+    uint8_t i = 0;
+    while (i < histogram->bound_cnt && value > histogram->bounds[i]) {
+        i++;
+    }
+    core_util_atomic_incr_u32(&histogram->buckets[i], 1);
+}
+
+void mbed_perf_hook_register(mbed_perf_hook_t *hook)
+{
+    core_util_critical_section_enter();
+    if (!hook->registered) {
+        hook->next = perf_hooks;
+        perf_hooks = hook;
+        hook->registered = true;
+    }
+    core_util_critical_section_exit();
+}
+
+static void perf_update(void)
+{
+#if MBED_HEAP_STATS_ENABLED
+    mbed_perf_hook_register(&heap_hook);
+#endif
+    for (mbed_perf_hook_t *hook = perf_hooks; hook; hook = hook->next) {
+        hook->update();
+    }
+}
+
+// Copies the buckets, so a histogram is exported as one consistent snapshot
+static void histogram_snapshot(const mbed_perf_histogram_t *histogram, uint32_t *buckets)
+{
+    core_util_critical_section_enter();
+    memcpy(buckets, histogram->buckets, (histogram->bound_cnt + 1) * sizeof(uint32_t));
+    core_util_critical_section_exit();
+}
+
+#endif
+
+int mbed_perf_export_json(char *buffer, size_t size)
+{
+    perf_writer_t w = { (uint8_t *)buffer, size, 0 };
+
+    put_str(&w, "{");
+#if MBED_CONF_PLATFORM_PERF_COUNTERS_ENABLED
+    bool first = true;
+    perf_update();
+    for (mbed_perf_counter_t *c = perf_counters; c; c = c->next) {
+        put_str(&w, first ? "\"" : ",\"");
+        put_str(&w, c->name);
+        put_str(&w, "\":");
+        put_uint(&w, c->value);
+        first = false;
+    }
+
+    for (mbed_perf_histogram_t *h = perf_histograms; h; h = h->next) {
+        uint32_t buckets[MBED_PERF_HISTOGRAM_BUCKETS];
+        histogram_snapshot(h, buckets);
+
+        put_str(&w, first ? "\"" : ",\"");
+        put_str(&w, h->name);
+        put_str(&w, "\":{\"bounds\":[");
+        for (uint8_t i = 0; i < h->bound_cnt; i++) {
+            if (i) {
+                put_str(&w, ",");
+            }
+            put_uint(&w, h->bounds[i]);
+        }
+        put_str(&w, "],\"buckets\":[");
+        for (uint8_t i = 0; i <= h->bound_cnt; i++) {
+            if (i) {
+                put_str(&w, ",");
+            }
+            put_uint(&w, buckets[i]);
+        }
+        put_str(&w, "]}");
+        first = false;
+    }
+#endif
+    put_str(&w, "}");
+
+    // null-terminate, cutting the export if it did not fit
+    if (size) {
+        buffer[w.len < size ? w.len : size - 1] = '\0';
+    }
+    return w.len;
+}
+
+int mbed_perf_export_binary(uint8_t *buffer, size_t size)
+{
+    perf_writer_t w = { buffer, size, 0 };
+    uint16_t count = 0;
+
+    put_str(&w, "PC");
+    put_u8(&w, 1);
+    // entry count, filled in at the end
+    put_u8(&w, 0);
+    put_u8(&w, 0);
+
+#if MBED_CONF_PLATFORM_PERF_COUNTERS_ENABLED
+    perf_update();
+    for (mbed_perf_counter_t *c = perf_counters; c; c = c->next) {
+        put_u8(&w, 0);
+        put_name(&w, c->name);
+        put_u32(&w, c->value);
+        count++;
+    }
+
+    for (mbed_perf_histogram_t *h = perf_histograms; h; h = h->next) {
+        uint32_t buckets[MBED_PERF_HISTOGRAM_BUCKETS];
+        histogram_snapshot(h, buckets);
+
+        put_u8(&w, 1);
+        put_name(&w, h->name);
+        put_u8(&w, h->bound_cnt + 1);
+        for (uint8_t i = 0; i < h->bound_cnt; i++) {
+            put_u32(&w, h->bounds[i]);
+        }
+        for (uint8_t i = 0; i <= h->bound_cnt; i++) {
+            put_u32(&w, buckets[i]);
+        }
+        count++;
+    }
+#endif
+
+    if (size >= 5) {
+        buffer[3] = count;
+        buffer[4] = count >> 8;
+    }
+    return w.len;
+}
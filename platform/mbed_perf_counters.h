@@ -0,0 +1,229 @@
+/** \addtogroup platform */
+/** @{*/
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MBED_PERF_COUNTERS_H
+#define MBED_PERF_COUNTERS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef MBED_CONF_PLATFORM_PERF_COUNTERS_ENABLED
+#define MBED_CONF_PLATFORM_PERF_COUNTERS_ENABLED    0
+#endif
+
+/**
+ * Performance counter registry
+ *
+ * Modules define named counters and histograms as static variables, which
+ * join the registry the first time they are updated, or when registered
+ * with mbed_perf_counter_register. Nothing is allocated: the registry is a
+ * list linked through the variables themselves, so counters can't be
+ * removed and must have static storage duration.
+ *
+ * Statistics kept in other shapes, such as mbed_stats_heap_get or the
+ * memory statistics of a network stack, are published by an update hook
+ * that copies them into counters just before each export. The heap
+ * statistics are published as heap.* when MBED_HEAP_STATS_ENABLED is set.
+ *
+ * All the counters are exported at once as JSON, for people and scripts,
+ * or in a compact binary format, for telemetry. The exports fill a buffer
+ * that can be written to a serial port or returned as a CoAP payload.
+ *
+ * Counters are only kept if the platform.perf-counters-enabled
+ * configuration option is set, otherwise updates do nothing and exports
+ * are empty.
+ *
+ * Example:
+ * @code
+ * static MBED_PERF_COUNTER(rx_packets, "net.rx_packets");
+ *
+ * static const uint32_t latency_bounds[] = { 100, 1000, 10000 };
+ * static MBED_PERF_HISTOGRAM(latency, "net.latency_us", latency_bounds);
+ *
+ * void on_packet(uint32_t latency_us)
+ * {
+ *     mbed_perf_counter_add(&rx_packets, 1);
+ *     mbed_perf_histogram_add(&latency, latency_us);
+ * }
+ * @endcode
+ */
+
+/** Maximum number of buckets of a histogram, one more than its bounds */
+#define MBED_PERF_HISTOGRAM_BUCKETS     8
+
+/** Named counter, define with MBED_PERF_COUNTER */
+typedef struct mbed_perf_counter {
+    const char *name;
+    uint32_t value;
+    bool registered;
+    struct mbed_perf_counter *next;
+} mbed_perf_counter_t;
+
+/** Named histogram, define with MBED_PERF_HISTOGRAM */
+typedef struct mbed_perf_histogram {
+    const char *name;
+    const uint32_t *bounds;         /**< Ascending upper bounds of all but the last bucket */
+    uint8_t bound_cnt;
+    bool registered;
+    uint32_t buckets[MBED_PERF_HISTOGRAM_BUCKETS];
+    struct mbed_perf_histogram *next;
+} mbed_perf_histogram_t;
+
+/** Hook called before each export, define with MBED_PERF_HOOK */
+typedef struct mbed_perf_hook {
+    void (*update)(void);
+    bool registered;
+    struct mbed_perf_hook *next;
+} mbed_perf_hook_t;
+
+/**
+ * Define a counter
+ *
+ * @param var   Name of the variable
+ * @param name  Name of the counter in the exports, such as "net.rx_packets",
+ *              which is not escaped in JSON
+ */
+#define MBED_PERF_COUNTER(var, name) \
+    mbed_perf_counter_t var = { name, 0, false, NULL }
+
+/**
+ * Define a histogram
+ *
+ * Values up to and including bounds[i] are counted in bucket i, larger
+ * values in the last bucket.
+ *
+ * @param var       Name of the variable
+ * @param name      Name of the histogram in the exports
+ * @param bounds    Array of up to MBED_PERF_HISTOGRAM_BUCKETS-1 ascending bounds
+ */
+#define MBED_PERF_HISTOGRAM(var, name, bounds) \
+    mbed_perf_histogram_t var = { name, bounds, sizeof(bounds) / sizeof((bounds)[0]), false, {0}, NULL }
+
+/**
+ * Define an update hook
+ *
+ * @param var       Name of the variable
+ * @param update    Function that updates counters from other statistics
+ */
+#define MBED_PERF_HOOK(var, update) \
+    mbed_perf_hook_t var = { update, false, NULL }
+
+#if MBED_CONF_PLATFORM_PERF_COUNTERS_ENABLED
+
+/**
+ * Add a counter to the registry before it is first updated
+ *
+ * @param counter   The counter, registering it again does nothing
+ */
+void mbed_perf_counter_register(mbed_perf_counter_t *counter);
+
+/**
+ * Add to a counter
+ *
+ * @param counter   The counter
+ * @param n         Amount to add
+ *
+ * @note Interrupt safe
+ */
+void mbed_perf_counter_add(mbed_perf_counter_t *counter, uint32_t n);
+
+/**
+ * Set a counter, for gauges such as a current size
+ *
+ * @param counter   The counter
+ * @param value     New value
+ *
+ * @note Interrupt safe
+ */
+void mbed_perf_counter_set(mbed_perf_counter_t *counter, uint32_t value);
+
+/**
+ * Add a histogram to the registry before it is first updated
+ *
+ * @param histogram The histogram, registering it again does nothing
+ */
+void mbed_perf_histogram_register(mbed_perf_histogram_t *histogram);
+
+/**
+ * Count a value in its bucket of a histogram
+ *
+ * @param histogram The histogram
+ * @param value     The value
+ *
+ * @note Interrupt safe
+ */
+void mbed_perf_histogram_add(mbed_perf_histogram_t *histogram, uint32_t value);
+
+/**
+ * Add an update hook to the registry
+ *
+ * @param hook      The hook, registering it again does nothing
+ */
+void mbed_perf_hook_register(mbed_perf_hook_t *hook);
+
+#else
+
+#define mbed_perf_counter_register(counter)         ((void)(counter))
+#define mbed_perf_counter_add(counter, n)           ((void)(counter), (void)(n))
+#define mbed_perf_counter_set(counter, value)       ((void)(counter), (void)(value))
+#define mbed_perf_histogram_register(histogram)     ((void)(histogram))
+#define mbed_perf_histogram_add(histogram, value)   ((void)(histogram), (void)(value))
+#define mbed_perf_hook_register(hook)               ((void)(hook))
+
+#endif
+
+/**
+ * Export all the counters and histograms as a JSON object
+ *
+ * Counters are numbers and histograms objects with their bounds and bucket
+ * counts, named by their names:
+ * {"net.rx_packets":42,"net.latency_us":{"bounds":[100,1000],"buckets":[3,1,0]}}
+ *
+ * @param buffer    Buffer for the JSON, which is always null-terminated
+ * @param size      Size of the buffer
+ * @return          Length of the full export, which was cut if size or more
+ */
+int mbed_perf_export_json(char *buffer, size_t size);
+
+/**
+ * Export all the counters and histograms in binary
+ *
+ * Little-endian: the bytes 'P' 'C', a version byte of 1 and a 16-bit entry
+ * count, then for each entry a type byte, 0 for a counter or 1 for a
+ * histogram, the length of the name in a byte and the name without a null
+ * terminator. A counter follows with its 32-bit value, a histogram with
+ * its number of buckets n in a byte, its n-1 32-bit bounds and n 32-bit
+ * bucket counts.
+ *
+ * @param buffer    Buffer for the export
+ * @param size      Size of the buffer
+ * @return          Length of the full export, which was cut if more than size
+ */
+int mbed_perf_export_binary(uint8_t *buffer, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+/** @}*/
@@ -16,60 +16,117 @@
 #include "mbed_poll.h"
 #include "FileHandle.h"
 #include "Timer.h"
+#include "mbed_critical.h"
 #ifdef MBED_CONF_RTOS_PRESENT
-#include "rtos/Thread.h"
+#include "rtos/Semaphore.h"
 #endif
 
 namespace mbed {
 
+#ifdef MBED_CONF_RTOS_PRESENT
+// A thread blocked in poll(), linked from its stack while it waits
+struct poll_waiter {
+    poll_waiter *next;
+    const pollfh *fhs;
+    unsigned nfhs;
+    rtos::Semaphore wakeup;
+
+    poll_waiter() : wakeup(0, 1) {}
+};
+
+static poll_waiter *waiters;
+#endif
+
+static int scan(pollfh fhs[], unsigned nfhs)
+{
+    int count = 0;
+    for (unsigned n = 0; n < nfhs; n++) {
+        FileHandle *fh = fhs[n].fh;
+        short mask = fhs[n].events | POLLERR | POLLHUP | POLLNVAL;
+        if (fh) {
+            fhs[n].revents = fh->poll(mask) & mask;
+        } else {
+            fhs[n].revents = POLLNVAL;
+        }
+        if (fhs[n].revents) {
+            count++;
+        }
+    }
+    return count;
+}
+
 // timeout -1 forever, or milliseconds
 int poll(pollfh fhs[], unsigned nfhs, int timeout)
 {
-    /**
-     * TODO Proper wake-up mechanism.
-     * In order to correctly detect availability of read/write a FileHandle, we needed
-     * a select or poll mechanisms. We opted for poll as POSIX defines in
-     * http://pubs.opengroup.org/onlinepubs/009695399/functions/poll.html Currently,
-     * mbed::poll() just spins and scans filehandles looking for any events we are
-     * interested in. In future, his spinning behaviour will be replaced with
-     * condition variables.
-     */
     Timer timer;
     if (timeout > 0) {
         timer.start();
     }
 
-    int count = 0;
-    for (;;) {
-        /* Scan the file handles */
-        for (unsigned n = 0; n < nfhs; n++) {
-            FileHandle *fh = fhs[n].fh;
-            short mask = fhs[n].events | POLLERR | POLLHUP | POLLNVAL;
-            if (fh) {
-                fhs[n].revents = fh->poll(mask) & mask;
-            } else {
-                fhs[n].revents = POLLNVAL;
-            }
-            if (fhs[n].revents) {
-                count++;
-            }
-        }
+#ifdef MBED_CONF_RTOS_PRESENT
+    // Join the waiters before the first scan, so a change between a scan
+    // and the wait releases the semaphore rather than being missed
+    poll_waiter self;
+    self.fhs = fhs;
+    self.nfhs = nfhs;
+    if (timeout != 0) {
+        core_util_critical_section_enter();
+        self.next = waiters;
+        waiters = &self;
+        core_util_critical_section_exit();
+    }
+#endif
 
-        if (count) {
+    int count;
+    for (;;) {
+        count = scan(fhs, nfhs);
+        if (count || timeout == 0) {
             break;
         }
 
-        /* Nothing selected - this is where timeout handling would be needed */
-        if (timeout == 0 || (timeout > 0 && timer.read_ms() > timeout)) {
-            break;
+        int remaining = -1;
+        if (timeout > 0) {
+            remaining = timeout - timer.read_ms();
+            if (remaining <= 0) {
+                break;
+            }
         }
 #ifdef MBED_CONF_RTOS_PRESENT
-        // TODO - proper blocking
-        // wait for condition variable, wait queue whatever here
-        rtos::Thread::yield();
+        self.wakeup.wait(remaining < 0 ? osWaitForever : remaining);
 #endif
     }
+
+#ifdef MBED_CONF_RTOS_PRESENT
+    if (timeout != 0) {
+        core_util_critical_section_enter();
+        for (poll_waiter **w = &waiters; *w; w = &(*w)->next) {
+            if (*w == &self) {
+                *w = self.next;
+                break;
+            }
+        }
+        core_util_critical_section_exit();
+    }
+#endif
     return count;
 }
 
+void poll_change(FileHandle *fh)
+{
+#ifdef MBED_CONF_RTOS_PRESENT
+    core_util_critical_section_enter();
+    for (poll_waiter *w = waiters; w; w = w->next) {
+        for (unsigned n = 0; n < w->nfhs; n++) {
+            if (w->fhs[n].fh == fh) {
+                w->wakeup.release();
+                break;
+            }
+        }
+    }
+    core_util_critical_section_exit();
+#else
+    (void)fh;
+#endif
+}
+
 } // namespace mbed
@@ -47,6 +47,19 @@ struct pollfh {
  */
 int poll(pollfh fhs[], unsigned nfhs, int timeout);
 
+/** Wake the threads blocked in poll() on a file handle
+ *
+ * poll() blocks until this is called for one of its file handles, then
+ * scans them again, so a FileHandle calls this wherever its events may
+ * have changed, alongside its sigio() callback. A FileHandle that does
+ * not call it is still seen by poll(), but only once its timeout expires.
+ *
+ * @param fh The file handle whose events may have changed
+ *
+ * @note This function may be called from ISR context.
+ */
+void poll_change(FileHandle *fh);
+
 } // namespace mbed
 
 #endif //MBED_POLL_H
@@ -0,0 +1,807 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "platform/mbed_printf.h"
+#include "platform/mbed_toolchain.h"
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifndef MBED_CONF_PLATFORM_MINIMAL_PRINTF
+#define MBED_CONF_PLATFORM_MINIMAL_PRINTF               0
+#endif
+
+#ifndef MBED_CONF_PLATFORM_MINIMAL_PRINTF_BUFFER_SIZE
+#define MBED_CONF_PLATFORM_MINIMAL_PRINTF_BUFFER_SIZE   32
+#endif
+
+#ifndef MBED_CONF_PLATFORM_MINIMAL_PRINTF_FLOATING_POINT
+#define MBED_CONF_PLATFORM_MINIMAL_PRINTF_FLOATING_POINT 0
+#endif
+
+#define FLAG_LEFT   0x01
+#define FLAG_PLUS   0x02
+#define FLAG_SPACE  0x04
+#define FLAG_ALT    0x08
+#define FLAG_ZERO   0x10
+#define FLAG_UPPER  0x20
+
+typedef enum {
+    LENGTH_DEFAULT,
+    LENGTH_CHAR,
+    LENGTH_SHORT,
+    LENGTH_LONG,
+    LENGTH_LONG_LONG,
+    LENGTH_INTMAX,
+    LENGTH_SIZE,
+    LENGTH_PTRDIFF,
+    LENGTH_LONG_DOUBLE
+} length_t;
+
+typedef struct {
+    mbed_printf_write_t write;
+    void *context;
+    int count;
+    size_t used;
+    char buffer[MBED_CONF_PLATFORM_MINIMAL_PRINTF_BUFFER_SIZE];
+} output_t;
+
+static void output_flush(output_t *out)
+{
+    if (out->used) {
+        out->write(out->context, out->buffer, out->used);
+        out->used = 0;
+    }
+}
+
+static void output_string(output_t *out, const char *s, size_t len)
+{
+    out->count += len;
+    while (len) {
+        size_t chunk = sizeof(out->buffer) - out->used;
+        if (chunk > len) {
+            chunk = len;
+        }
+        memcpy(out->buffer + out->used, s, chunk);
+        out->used += chunk;
+        s += chunk;
+        len -= chunk;
+        if (out->used == sizeof(out->buffer)) {
+            output_flush(out);
+        }
+    }
+}
+
+static void output_repeat(output_t *out, char c, int n)
+{
+    out->count += n > 0 ? n : 0;
+    while (n-- > 0) {
+        out->buffer[out->used++] = c;
+        if (out->used == sizeof(out->buffer)) {
+            output_flush(out);
+        }
+    }
+}
+
+/* Outputs a converted field padded to its width: the prefix (sign, 0x),
+ * then zeros up to the precision, then the digits */
+static void output_field(output_t *out, int flags, int width,
+                         const char *prefix, int zeros, const char *digits, size_t len)
+{
+    size_t prefix_len = strlen(prefix);
+    int pad = width - (int)(prefix_len + zeros + len);
+
+    if (pad > 0 && !(flags & FLAG_LEFT)) {
+        if (flags & FLAG_ZERO) {
+            zeros += pad;
+        } else {
+            output_repeat(out, ' ', pad);
+        }
+        pad = 0;
+    }
+    output_string(out, prefix, prefix_len);
+    output_repeat(out, '0', zeros);
+    output_string(out, digits, len);
+    output_repeat(out, ' ', pad);
+}
+
+/* Writes the digits of value backwards from end, returns their number.
+ * 64 bit divisions are only used for the digits that need them. */
+static size_t format_unsigned(char *end, uintmax_t value, unsigned base, int upper)
+{
+    const char *digits = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+    char *p = end;
+
+    while (value > UINT32_MAX) {
+        *--p = digits[value % base];
+        value /= base;
+    }
+    uint32_t value32 = (uint32_t)value;
+    while (value32) {
+        *--p = digits[value32 % base];
+        value32 /= base;
+    }
+    return end - p;
+}
+
+static void output_integer(output_t *out, int flags, int width, int precision,
+                           const char *prefix, uintmax_t value, unsigned base)
+{
+    char digits[24];
+    char *end = digits + sizeof(digits);
+    size_t len;
+
+    if (value == 0) {
+        // No digit at all for a zero precision
+        len = precision ? 1 : 0;
+        digits[sizeof(digits) - 1] = '0';
+    } else {
+        len = format_unsigned(end, value, base, flags & FLAG_UPPER);
+    }
+
+    int zeros = precision > (int)len ? precision - (int)len : 0;
+    if ((flags & FLAG_ALT) && base == 8 && zeros == 0 && (len == 0 || end[-(int)len] != '0')) {
+        zeros = 1;
+    }
+    if (precision >= 0) {
+        flags &= ~FLAG_ZERO;
+    }
+    output_field(out, flags, width, prefix, zeros, end - len, len);
+}
+
+#if MBED_CONF_PLATFORM_MINIMAL_PRINTF_FLOATING_POINT
+
+#define FLOAT_FRACTION_DIGITS   9
+#define FLOAT_PRECISION_MAX     40
+#define FLOAT_INTEGER_DIGITS    309
+
+/* Returns the product of a and b rounded, with its rounding error in err.
+ * The halves of a and b have products that are exact (Dekker). */
+static double exact_product(double a, double b, double *err)
+{
+    const double split = 134217729.0;
+    double p = a * b;
+    double t = split * a;
+    double a_hi = t - (t - a);
+    double a_lo = a - a_hi;
+    t = split * b;
+    double b_hi = t - (t - b);
+    double b_lo = b - b_hi;
+    *err = ((a_hi * b_hi - p) + a_hi * b_lo + a_lo * b_hi) + a_lo * b_lo;
+    return p;
+}
+
+/* Writes a non-negative value below 2^64 in fixed point to buf, returns
+ * the number of characters. Digits past FLOAT_FRACTION_DIGITS are zeros. */
+static size_t format_fixed(char *buf, double value, int precision, int alt, int *int_digits)
+{
+    int exact = precision < FLOAT_FRACTION_DIGITS ? precision : FLOAT_FRACTION_DIGITS;
+    uint32_t scale = 1;
+    for (int i = 0; i < exact; i++) {
+        scale *= 10;
+    }
+
+    // The fraction is exact, and so is what is left of its scaled value
+    // with the rounding error of the scaling, so only true ties are found
+    uint64_t int_part = (uint64_t)value;
+    double err;
+    double scaled = exact_product(value - (double)int_part, scale, &err);
+    uint32_t frac_part = (uint32_t)scaled;
+    double above = (scaled - frac_part) - 0.5;
+    // Ties go to even, as in the C library
+    uint32_t last = exact ? frac_part : (uint32_t)int_part;
+    if (above > -err || (above == -err && (last & 1))) {
+        frac_part++;
+    }
+    if (frac_part >= scale) {
+        frac_part -= scale;
+        int_part++;
+    }
+
+    char digits[24];
+    size_t len = int_part ? format_unsigned(digits + sizeof(digits), int_part, 10, 0) : 0;
+    if (len == 0) {
+        digits[sizeof(digits) - 1] = '0';
+        len = 1;
+    }
+    memcpy(buf, digits + sizeof(digits) - len, len);
+    *int_digits = (int)len;
+
+    if (precision > 0 || alt) {
+        buf[len++] = '.';
+    }
+    for (int i = exact - 1; i >= 0; i--) {
+        buf[len + i] = '0' + frac_part % 10;
+        frac_part /= 10;
+    }
+    len += exact;
+    for (int i = exact; i < precision; i++) {
+        buf[len++] = '0';
+    }
+    return len;
+}
+
+/* Outputs a value of 2^64 or more in fixed point. It is an integer, its
+ * digits are divided out of it 9 at a time in words of 32 bits. They do
+ * not fit in the buffer of the other conversions, so this has its own. */
+static MBED_NOINLINE void output_large(output_t *out, int flags, int width, int precision,
+                                       const char *sign, double value)
+{
+    char buf[FLOAT_INTEGER_DIGITS + 1 + FLOAT_PRECISION_MAX];
+    uint32_t words[1024 / 32 + 1];
+    memset(words, 0, sizeof(words));
+
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    int shift = (int)((bits >> 52) & 0x7ff) - 1075;
+    uint64_t mantissa = (bits & 0xfffffffffffffULL) | (1ULL << 52);
+    int top = shift / 32;
+    int offset = shift % 32;
+    uint32_t lo = (uint32_t)mantissa;
+    uint32_t hi = (uint32_t)(mantissa >> 32);
+    words[top] = lo << offset;
+    words[top + 1] = offset ? (lo >> (32 - offset)) | (hi << offset) : hi;
+    words[top + 2] = offset ? hi >> (32 - offset) : 0;
+    top += 2;
+
+    char *end = buf + FLOAT_INTEGER_DIGITS;
+    char *p = end;
+    while (top >= 0) {
+        uint32_t rem = 0;
+        for (int i = top; i >= 0; i--) {
+            uint64_t word = ((uint64_t)rem << 32) | words[i];
+            words[i] = (uint32_t)(word / 1000000000);
+            rem = (uint32_t)(word % 1000000000);
+        }
+        while (top >= 0 && words[top] == 0) {
+            top--;
+        }
+        // The leading zeros of the most significant digits are dropped
+        for (int i = 0; i < 9 && (rem || top >= 0); i++) {
+            *--p = '0' + rem % 10;
+            rem /= 10;
+        }
+    }
+
+    size_t len = end - p;
+    if (precision > 0 || (flags & FLAG_ALT)) {
+        *end = '.';
+        memset(end + 1, '0', precision);
+        len += 1 + precision;
+    }
+    output_field(out, flags, width, sign, 0, p, len);
+}
+
+/* Returns 10^n, which is exact up to 10^22 */
+static double power_of_ten(int n)
+{
+    double result = 1;
+    double base = 10;
+    for (; n; n >>= 1) {
+        if (n & 1) {
+            result *= base;
+        }
+        base *= base;
+    }
+    return result;
+}
+
+/* Returns a non-negative value times 10^shift rounded to an integer, ties
+ * to even. The value is scaled once, with the rounding error of the scaling
+ * kept while the power of ten is exact or the product of two exact ones. */
+static uint64_t scale_round(double value, int shift)
+{
+    double err = 0;
+    double scaled;
+    if (shift >= 0 && shift <= 44) {
+        double power = power_of_ten(shift > 22 ? 22 : shift);
+        double power_err = 0;
+        if (shift > 22) {
+            power = exact_product(power, power_of_ten(shift - 22), &power_err);
+        }
+        scaled = exact_product(value, power, &err);
+        err += value * power_err;
+    } else if (shift >= 0) {
+        scaled = value * power_of_ten(shift);
+    } else if (shift >= -19 && value < 18446744073709551616.0) {
+        // The integer part is divided exactly, the fraction breaks ties
+        uint64_t int_part = (uint64_t)value;
+        double frac = value - (double)int_part;
+        uint64_t divisor = (uint64_t)power_of_ten(-shift);
+        uint64_t result = int_part / divisor;
+        uint64_t rem = int_part % divisor;
+        uint64_t half = divisor / 2;
+        if (rem > half || (rem == half && (frac > 0 || (result & 1)))) {
+            result++;
+        }
+        return result;
+    } else if (shift >= -22) {
+        double power = power_of_ten(-shift);
+        scaled = value / power;
+        double product = exact_product(scaled, power, &err);
+        err = ((value - product) - err) / power;
+    } else {
+        scaled = value / power_of_ten(-shift);
+    }
+
+    uint64_t result = (uint64_t)scaled;
+    double above = (scaled - (double)result) - 0.5;
+    if (above > -err || (above == -err && (result & 1))) {
+        result++;
+    }
+    return result;
+}
+
+/* Writes value as d.ddde+xx to buf, returns the number of characters */
+static size_t format_exponent(char *buf, double value, int precision, int alt, int upper, int *exponent)
+{
+    int exact = precision < FLOAT_FRACTION_DIGITS ? precision : FLOAT_FRACTION_DIGITS;
+    uint64_t lowest = (uint64_t)power_of_ten(exact);
+    uint64_t mantissa = 0;
+    int exp10 = 0;
+    if (value != 0) {
+        // Subnormals are brought in range of the powers of ten first
+        int shift = 0;
+        if (value < 1e-290) {
+            value *= 1e30;
+            shift = 30;
+        }
+
+        // The estimate from the binary exponent is at most two too low,
+        // the fractions are just below and above log10(2)
+        uint64_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        int exp2 = (int)((bits >> 52) & 0x7ff) - 1023;
+        exp10 = exp2 >= 0 ? exp2 * 78913 / 262144 : -((-exp2 * 78914 + 262143) / 262144);
+        for (;;) {
+            mantissa = scale_round(value, exact - exp10);
+            if (mantissa < 10 * lowest) {
+                break;
+            }
+            exp10++;
+            if (mantissa == 10 * lowest) {
+                // Rounded up to 10
+                mantissa = lowest;
+                break;
+            }
+        }
+        exp10 -= shift;
+    }
+
+    for (int i = exact; i > 0; i--) {
+        buf[i + 1] = '0' + mantissa % 10;
+        mantissa /= 10;
+    }
+    buf[0] = '0' + (char)mantissa;
+    buf[1] = '.';
+    size_t len = precision > 0 || alt ? (size_t)exact + 2 : 1;
+    for (int i = exact; i < precision; i++) {
+        buf[len++] = '0';
+    }
+
+    buf[len++] = upper ? 'E' : 'e';
+    buf[len++] = exp10 < 0 ? '-' : '+';
+    unsigned magnitude = exp10 < 0 ? -exp10 : exp10;
+    if (magnitude < 10) {
+        buf[len++] = '0';
+    }
+    char digits[4];
+    size_t exp_len = format_unsigned(digits + sizeof(digits), magnitude, 10, 0);
+    if (exp_len == 0) {
+        buf[len++] = '0';
+    }
+    memcpy(buf + len, digits + sizeof(digits) - exp_len, exp_len);
+    *exponent = exp10;
+    return len + exp_len;
+}
+
+/* Removes the zeros at the end of the fraction, and the point if nothing is
+ * left of it, for %g without the # flag */
+static size_t strip_fraction(char *buf, size_t len, size_t fraction_end)
+{
+    char *point = memchr(buf, '.', fraction_end);
+    if (point == NULL) {
+        return len;
+    }
+    size_t end = fraction_end;
+    while (end > (size_t)(point - buf) + 1 && buf[end - 1] == '0') {
+        end--;
+    }
+    if (end == (size_t)(point - buf) + 1) {
+        end--;
+    }
+    memmove(buf + end, buf + fraction_end, len - fraction_end);
+    return len - (fraction_end - end);
+}
+
+static void output_double(output_t *out, int flags, int width, int precision, char conv, double value)
+{
+    char buf[FLOAT_PRECISION_MAX + 32];
+    const int upper = conv >= 'A' && conv <= 'Z';
+    const int alt = flags & FLAG_ALT;
+    const char *sign = "";
+    size_t len;
+
+    if (signbit(value)) {
+        sign = "-";
+        value = -value;
+    } else if (flags & FLAG_PLUS) {
+        sign = "+";
+    } else if (flags & FLAG_SPACE) {
+        sign = " ";
+    }
+
+    if (value != value || value > 1.7976931348623157e308) {
+        flags &= ~FLAG_ZERO;
+        output_field(out, flags, width, sign, 0, value != value ? (upper ? "NAN" : "nan") : (upper ? "INF" : "inf"), 3);
+        return;
+    }
+
+    if (precision < 0) {
+        precision = 6;
+    } else if (precision > FLOAT_PRECISION_MAX) {
+        precision = FLOAT_PRECISION_MAX;
+    }
+
+    int int_digits;
+    int exponent;
+    switch (conv | 0x20) {
+        case 'f':
+            if (value >= 18446744073709551616.0) {
+                output_large(out, flags, width, precision, sign, value);
+                return;
+            }
+            len = format_fixed(buf, value, precision, alt, &int_digits);
+            break;
+        case 'e':
+            len = format_exponent(buf, value, precision, alt, upper, &exponent);
+            break;
+        default: {
+            // %g is %e or %f with precision significant digits
+            int significant = precision ? precision : 1;
+            len = format_exponent(buf, value, significant - 1, alt, upper, &exponent);
+            if (exponent < significant && exponent >= 19) {
+                // Fixed point of an integer that may not fit 64 bits
+                output_large(out, flags, width, alt ? significant - 1 - exponent : 0, sign, value);
+                return;
+            } else if (exponent < significant && exponent >= -4) {
+                len = format_fixed(buf, value, significant - 1 - exponent, alt, &int_digits);
+                if (!alt) {
+                    len = strip_fraction(buf, len, len);
+                }
+            } else if (!alt) {
+                char *e = memchr(buf, upper ? 'E' : 'e', len);
+                len = strip_fraction(buf, len, e - buf);
+            }
+            break;
+        }
+    }
+    output_field(out, flags, width, sign, 0, buf, len);
+}
+
+#endif
+
+int mbed_vxprintf(mbed_printf_write_t write, void *context, const char *format, va_list args)
+{
+    output_t out;
+    out.write = write;
+    out.context = context;
+    out.count = 0;
+    out.used = 0;
+
+    const char *p = format;
+    while (*p) {
+        const char *literal = p;
+        while (*p && *p != '%') {
+            p++;
+        }
+        output_string(&out, literal, p - literal);
+        if (*p == '\0') {
+            break;
+        }
+
+        const char *spec = p++;
+        int flags = 0;
+        int width = 0;
+        int precision = -1;
+        length_t length = LENGTH_DEFAULT;
+
+        for (;; p++) {
+            int flag = 0;
+            switch (*p) {
+                case '-': flag = FLAG_LEFT; break;
+                case '+': flag = FLAG_PLUS; break;
+                case ' ': flag = FLAG_SPACE; break;
+                case '#': flag = FLAG_ALT; break;
+                case '0': flag = FLAG_ZERO; break;
+            }
+            if (!flag) {
+                break;
+            }
+            flags |= flag;
+        }
+
+        if (*p == '*') {
+            width = va_arg(args, int);
+            if (width < 0) {
+                flags |= FLAG_LEFT;
+                width = -width;
+            }
+            p++;
+        } else {
+            while (*p >= '0' && *p <= '9') {
+                width = width * 10 + (*p++ - '0');
+            }
+        }
+
+        if (*p == '.') {
+            p++;
+            if (*p == '*') {
+                precision = va_arg(args, int);
+                if (precision < 0) {
+                    precision = -1;
+                }
+                p++;
+            } else {
+                precision = 0;
+                while (*p >= '0' && *p <= '9') {
+                    precision = precision * 10 + (*p++ - '0');
+                }
+            }
+        }
+
+        switch (*p) {
+            case 'h':
+                length = LENGTH_SHORT;
+                if (*++p == 'h') {
+                    length = LENGTH_CHAR;
+                    p++;
+                }
+                break;
+            case 'l':
+                length = LENGTH_LONG;
+                if (*++p == 'l') {
+                    length = LENGTH_LONG_LONG;
+                    p++;
+                }
+                break;
+            case 'j': length = LENGTH_INTMAX; p++; break;
+            case 'z': length = LENGTH_SIZE; p++; break;
+            case 't': length = LENGTH_PTRDIFF; p++; break;
+            case 'L': length = LENGTH_LONG_DOUBLE; p++; break;
+        }
+
+        const char conv = *p;
+        if (conv == '\0') {
+            // Incomplete conversion at the end of the format
+            output_string(&out, spec, p - spec);
+            break;
+        }
+        p++;
+
+        switch (conv) {
+            case 'd':
+            case 'i': {
+                intmax_t value;
+                switch (length) {
+                    case LENGTH_CHAR:       value = (signed char)va_arg(args, int); break;
+                    case LENGTH_SHORT:      value = (short)va_arg(args, int); break;
+                    case LENGTH_LONG:       value = va_arg(args, long); break;
+                    case LENGTH_LONG_LONG:  value = va_arg(args, long long); break;
+                    case LENGTH_INTMAX:     value = va_arg(args, intmax_t); break;
+                    case LENGTH_SIZE:
+                    case LENGTH_PTRDIFF:    value = va_arg(args, ptrdiff_t); break;
+                    default:                value = va_arg(args, int); break;
+                }
+                const char *sign = value < 0 ? "-" : (flags & FLAG_PLUS) ? "+" : (flags & FLAG_SPACE) ? " " : "";
+                uintmax_t magnitude = value < 0 ? -(uintmax_t)value : (uintmax_t)value;
+                output_integer(&out, flags, width, precision, sign, magnitude, 10);
+                break;
+            }
+
+            case 'u':
+            case 'o':
+            case 'x':
+            case 'X': {
+                uintmax_t value;
+                switch (length) {
+                    case LENGTH_CHAR:       value = (unsigned char)va_arg(args, unsigned); break;
+                    case LENGTH_SHORT:      value = (unsigned short)va_arg(args, unsigned); break;
+                    case LENGTH_LONG:       value = va_arg(args, unsigned long); break;
+                    case LENGTH_LONG_LONG:  value = va_arg(args, unsigned long long); break;
+                    case LENGTH_INTMAX:     value = va_arg(args, uintmax_t); break;
+                    case LENGTH_SIZE:       value = va_arg(args, size_t); break;
+                    case LENGTH_PTRDIFF:    value = (size_t)va_arg(args, ptrdiff_t); break;
+                    default:                value = va_arg(args, unsigned); break;
+                }
+                const char *prefix = "";
+                unsigned base = 10;
+                if (conv == 'o') {
+                    base = 8;
+                } else if (conv != 'u') {
+                    base = 16;
+                    if (conv == 'X') {
+                        flags |= FLAG_UPPER;
+                    }
+                    if ((flags & FLAG_ALT) && value != 0) {
+                        prefix = conv == 'X' ? "0X" : "0x";
+                    }
+                }
+                output_integer(&out, flags, width, precision, prefix, value, base);
+                break;
+            }
+
+            case 'p': {
+                uintptr_t value = (uintptr_t)va_arg(args, void *);
+                output_integer(&out, flags & ~FLAG_ALT, width, precision, "0x", value, 16);
+                break;
+            }
+
+            case 'c': {
+                char c = (char)va_arg(args, int);
+                output_field(&out, flags & ~FLAG_ZERO, width, "", 0, &c, 1);
+                break;
+            }
+
+            case 's': {
+                const char *s = va_arg(args, const char *);
+                if (s == NULL) {
+                    s = "(null)";
+                }
+                size_t len = 0;
+                while (s[len] && (precision < 0 || len < (size_t)precision)) {
+                    len++;
+                }
+                output_field(&out, flags & ~FLAG_ZERO, width, "", 0, s, len);
+                break;
+            }
+
+            case '%':
+                output_string(&out, "%", 1);
+                break;
+
+            case 'f':
+            case 'F':
+            case 'e':
+            case 'E':
+            case 'g':
+            case 'G':
+            case 'a':
+            case 'A': {
+                double value = length == LENGTH_LONG_DOUBLE ? (double)va_arg(args, long double) : va_arg(args, double);
+#if MBED_CONF_PLATFORM_MINIMAL_PRINTF_FLOATING_POINT
+                if (conv != 'a' && conv != 'A') {
+                    output_double(&out, flags, width, precision, conv, value);
+                    break;
+                }
+#else
+                (void)value;
+#endif
+                output_string(&out, spec, p - spec);
+                break;
+            }
+
+            case 'n':
+                (void)va_arg(args, void *);
+                output_string(&out, spec, p - spec);
+                break;
+
+            default:
+                output_string(&out, spec, p - spec);
+                break;
+        }
+    }
+
+    output_flush(&out);
+    return out.count;
+}
+
+typedef struct {
+    char *buffer;
+    size_t size;
+    size_t used;
+} string_output_t;
+
+static void string_write(void *context, const char *data, size_t size)
+{
+    string_output_t *string = (string_output_t *)context;
+    if (string->used + 1 >= string->size) {
+        return;
+    }
+    size_t room = string->size - 1 - string->used;
+    if (size > room) {
+        size = room;
+    }
+    memcpy(string->buffer + string->used, data, size);
+    string->used += size;
+}
+
+int mbed_vsnprintf(char *buffer, size_t size, const char *format, va_list args)
+{
+    string_output_t string = { buffer, size, 0 };
+    int count = mbed_vxprintf(string_write, &string, format, args);
+    if (size) {
+        buffer[string.used] = '\0';
+    }
+    return count;
+}
+
+int mbed_snprintf(char *buffer, size_t size, const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    int count = mbed_vsnprintf(buffer, size, format, args);
+    va_end(args);
+    return count;
+}
+
+/* mbed_vprintf is in mbed_retarget.cpp, with the stdio serial port */
+int mbed_printf(const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    int count = mbed_vprintf(format, args);
+    va_end(args);
+    return count;
+}
+
+#if MBED_CONF_PLATFORM_MINIMAL_PRINTF && defined(TOOLCHAIN_GCC)
+
+/* Defined here, these take the place of the newlib ones at link time */
+
+__attribute__((used)) int printf(const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    int count = mbed_vprintf(format, args);
+    va_end(args);
+    return count;
+}
+
+__attribute__((used)) int vprintf(const char *format, va_list args)
+{
+    return mbed_vprintf(format, args);
+}
+
+__attribute__((used)) int sprintf(char *buffer, const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    int count = mbed_vsnprintf(buffer, SIZE_MAX, format, args);
+    va_end(args);
+    return count;
+}
+
+__attribute__((used)) int vsprintf(char *buffer, const char *format, va_list args)
+{
+    return mbed_vsnprintf(buffer, SIZE_MAX, format, args);
+}
+
+__attribute__((used)) int snprintf(char *buffer, size_t size, const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    int count = mbed_vsnprintf(buffer, size, format, args);
+    va_end(args);
+    return count;
+}
+
+__attribute__((used)) int vsnprintf(char *buffer, size_t size, const char *format, va_list args)
+{
+    return mbed_vsnprintf(buffer, size, format, args);
+}
+
+#endif
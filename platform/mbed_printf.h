@@ -0,0 +1,105 @@
+/** \addtogroup platform */
+/** @{*/
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MBED_PRINTF_H
+#define MBED_PRINTF_H
+
+#include <stddef.h>
+#include <stdarg.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Minimal printf family
+ *
+ * The formatting needs no heap and no lock: its state is on the stack of
+ * the caller, and the output is handed on in chunks of
+ * platform.minimal-printf-buffer-size characters as they fill up. Output
+ * from several threads only interleaves at chunk boundaries.
+ *
+ * The flags, field width and precision of C99 are supported, with the
+ * d, i, u, o, x, X, c, s, p and % conversions and all their length
+ * modifiers. The f, F, e, E, g and G conversions are only formatted if
+ * platform.minimal-printf-floating-point is set, with at most 9 significant
+ * fractional digits rounded as the C library does them; otherwise, as for
+ * the a and A conversions and %n, their argument is skipped and the
+ * conversion is printed as it is.
+ *
+ * With platform.minimal-printf set, Stream::printf uses it, and for GCC it
+ * replaces printf, vprintf, sprintf, vsprintf, snprintf and vsnprintf of
+ * the C library, whose newlib versions allocate and lock stdout. Output
+ * the C library still holds in the stdout buffer, from putchar for
+ * example, is not flushed before a printf.
+ */
+
+/**
+ * Receives the formatted output
+ *
+ * @param context The context given to mbed_vxprintf
+ * @param data    Characters to output, not null terminated
+ * @param size    Number of characters
+ */
+typedef void (*mbed_printf_write_t)(void *context, const char *data, size_t size);
+
+/**
+ * Format to a write function
+ *
+ * @param write   Function called with each chunk of the output
+ * @param context Passed on to write
+ * @param format  printf format string
+ * @param args    Arguments of the format
+ * @return Number of characters output
+ */
+int mbed_vxprintf(mbed_printf_write_t write, void *context, const char *format, va_list args);
+
+/**
+ * Format to a string
+ *
+ * @param buffer Destination, null terminated if size is not 0
+ * @param size   Size of the destination, including the null terminator
+ * @param format printf format string
+ * @return Number of characters the whole output has, without the null
+ *         terminator, even if the destination was too small for them
+ */
+int mbed_snprintf(char *buffer, size_t size, const char *format, ...);
+
+/** As mbed_snprintf, with a va_list */
+int mbed_vsnprintf(char *buffer, size_t size, const char *format, va_list args);
+
+/**
+ * Format to stdout
+ *
+ * The output is written straight to the stdio serial port, as the C
+ * library write of stdout does.
+ *
+ * @param format printf format string
+ * @return Number of characters output
+ */
+int mbed_printf(const char *format, ...);
+
+/** As mbed_printf, with a va_list */
+int mbed_vprintf(const char *format, va_list args);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+/** @}*/
@@ -24,6 +24,7 @@
 #include "platform/mbed_error.h"
 #include "platform/mbed_stats.h"
 #include "platform/mbed_critical.h"
+#include "platform/mbed_printf.h"
 #include <stdlib.h>
 #include <string.h>
 #include <limits.h>
@@ -61,8 +62,6 @@
 #   define PREFIX(x)    x
 #endif
 
-#define FILE_HANDLE_RESERVED    0xFFFFFFFF
-
 using namespace mbed;
 
 #if defined(__MICROLIB) && (__ARMCC_VERSION>5030000)
@@ -82,19 +81,92 @@ uint32_t mbed_heap_size = 0;
 
 /* newlib has the filehandle field in the FILE struct as a short, so
  * we can't just return a Filehandle* from _open and instead have to
- * put it in a filehandles array and return the index into that array
+ * put it in a filehandles table and return the index into that table
  * (or rather index+3, as filehandles 0-2 are stdin/out/err).
+ *
+ * The table is allocated in chunks as more files are opened, up to
+ * platform.file-handle-max entries. Chunks are never moved or freed, so
+ * looking up a filehandle needs no lock. Free entries hold the index of
+ * the next free entry, tagged with the low bit that a FileHandle pointer
+ * never has, so opening and closing just pop and push the free list.
  */
-static FileHandle *filehandles[OPEN_MAX];
+#ifndef MBED_CONF_PLATFORM_FILE_HANDLE_MAX
+#define MBED_CONF_PLATFORM_FILE_HANDLE_MAX  OPEN_MAX
+#endif
+
+#define FILE_HANDLE_CHUNK       8
+#define FILE_HANDLE_CHUNKS      ((MBED_CONF_PLATFORM_FILE_HANDLE_MAX + FILE_HANDLE_CHUNK - 1) / FILE_HANDLE_CHUNK)
+#define FILE_HANDLE_FREE(next)  (((uintptr_t)(next) << 1) | 1)
+#define FILE_HANDLE_NONE        ((unsigned)INT_MAX)
+
+static uintptr_t *filehandles[FILE_HANDLE_CHUNKS];
+static unsigned filehandle_count;
+static unsigned filehandle_free = FILE_HANDLE_NONE;
 static SingletonPtr<PlatformMutex> filehandle_mutex;
 
+static inline uintptr_t *filehandle_entry(unsigned fh_i) {
+    return &filehandles[fh_i / FILE_HANDLE_CHUNK][fh_i % FILE_HANDLE_CHUNK];
+}
+
+/* Returns the FileHandle of a FILEHANDLE from 3 on, or NULL if it is not open */
+static FileHandle *get_filehandle(FILEHANDLE fh) {
+    unsigned fh_i = fh - 3;
+    if (fh_i >= filehandle_count) {
+        return NULL;
+    }
+    uintptr_t entry = *filehandle_entry(fh_i);
+    return (entry & 1) ? NULL : (FileHandle*)entry;
+}
+
+/* Takes a free filehandle slot, or returns FILE_HANDLE_NONE if there are
+ * none left. Must be called with filehandle_mutex locked.
+ */
+static unsigned reserve_filehandle() {
+    if (filehandle_free == FILE_HANDLE_NONE) {
+        if (filehandle_count >= MBED_CONF_PLATFORM_FILE_HANDLE_MAX) {
+            return FILE_HANDLE_NONE;
+        }
+        uintptr_t *chunk = (uintptr_t*)malloc(FILE_HANDLE_CHUNK * sizeof(uintptr_t));
+        if (chunk == NULL) {
+            return FILE_HANDLE_NONE;
+        }
+        // Thread the new entries onto the free list, lowest first
+        unsigned first = filehandle_count;
+        unsigned end = first + FILE_HANDLE_CHUNK;
+        if (end > MBED_CONF_PLATFORM_FILE_HANDLE_MAX) {
+            end = MBED_CONF_PLATFORM_FILE_HANDLE_MAX;
+        }
+        for (unsigned i = first; i < end; i++) {
+            chunk[i - first] = FILE_HANDLE_FREE(i + 1 < end ? i + 1 : FILE_HANDLE_NONE);
+        }
+        filehandles[first / FILE_HANDLE_CHUNK] = chunk;
+        filehandle_count = end;
+        filehandle_free = first;
+    }
+
+    unsigned fh_i = filehandle_free;
+    uintptr_t *entry = filehandle_entry(fh_i);
+    filehandle_free = (unsigned)(*entry >> 1);
+    // Reads as not open until the FileHandle is stored
+    *entry = FILE_HANDLE_FREE(FILE_HANDLE_NONE);
+    return fh_i;
+}
+
+/* Returns a filehandle slot to the free list.
+ * Must be called with filehandle_mutex locked.
+ */
+static void release_filehandle(unsigned fh_i) {
+    *filehandle_entry(fh_i) = FILE_HANDLE_FREE(filehandle_free);
+    filehandle_free = fh_i;
+}
+
 namespace mbed {
 void remove_filehandle(FileHandle *file) {
     filehandle_mutex->lock();
     /* Remove all open filehandles for this */
-    for (unsigned int fh_i = 0; fh_i < sizeof(filehandles)/sizeof(*filehandles); fh_i++) {
-        if (filehandles[fh_i] == file) {
-            filehandles[fh_i] = NULL;
+    for (unsigned int fh_i = 0; fh_i < filehandle_count; fh_i++) {
+        if (*filehandle_entry(fh_i) == (uintptr_t)file) {
+            release_filehandle(fh_i);
         }
     }
     filehandle_mutex->unlock();
@@ -120,6 +192,15 @@ static void init_serial() {
 #endif
 }
 
+/* The C library opens stdin, stdout and stderr at boot, the serial port is
+ * otherwise initialized on the first read or write of them.
+ */
+static inline void init_stdio_serial() {
+#if !MBED_CONF_PLATFORM_STDIO_DEFERRED_INIT
+    init_serial();
+#endif
+}
+
 /**
  * Sets errno when file opening fails.
  * Wipes out the filehandle too.
@@ -130,7 +211,9 @@ static void init_serial() {
 static int handle_open_errors(int error, unsigned filehandle_idx) {
     errno = -error;
     // Free file handle
-    filehandles[filehandle_idx] = NULL;
+    filehandle_mutex->lock();
+    release_filehandle(filehandle_idx);
+    filehandle_mutex->unlock();
     return -1;
 }
 
@@ -204,32 +287,26 @@ extern "C" FILEHANDLE PREFIX(_open)(const char* name, int openmode) {
     /* Use the posix convention that stdin,out,err are filehandles 0,1,2.
      */
     if (std::strcmp(name, __stdin_name) == 0) {
-        init_serial();
+        init_stdio_serial();
         return 0;
     } else if (std::strcmp(name, __stdout_name) == 0) {
-        init_serial();
+        init_stdio_serial();
         return 1;
     } else if (std::strcmp(name, __stderr_name) == 0) {
-        init_serial();
+        init_stdio_serial();
         return 2;
     }
     #endif
 
-    // find the first empty slot in filehandles
+    // take a free slot in filehandles
     filehandle_mutex->lock();
-    unsigned int fh_i;
-    for (fh_i = 0; fh_i < sizeof(filehandles)/sizeof(*filehandles); fh_i++) {
-    	/* Take a next free filehandle slot available. */
-        if (filehandles[fh_i] == NULL) break;
-    }
-    if (fh_i >= sizeof(filehandles)/sizeof(*filehandles)) {
+    unsigned int fh_i = reserve_filehandle();
+    filehandle_mutex->unlock();
+    if (fh_i == FILE_HANDLE_NONE) {
         /* Too many file handles have been opened */
         errno = EMFILE;
-        filehandle_mutex->unlock();
         return -1;
     }
-    filehandles[fh_i] = (FileHandle*)FILE_HANDLE_RESERVED;
-    filehandle_mutex->unlock();
 
     FileHandle *res = NULL;
 
@@ -265,7 +342,7 @@ extern "C" FILEHANDLE PREFIX(_open)(const char* name, int openmode) {
         }
     }
 
-    filehandles[fh_i] = res;
+    *filehandle_entry(fh_i) = (uintptr_t)res;
 
     return fh_i + 3; // +3 as filehandles 0-2 are stdin/out/err
 }
@@ -273,12 +350,15 @@ extern "C" FILEHANDLE PREFIX(_open)(const char* name, int openmode) {
 extern "C" int PREFIX(_close)(FILEHANDLE fh) {
     if (fh < 3) return 0;
 
-    FileHandle* fhc = filehandles[fh-3];
-    filehandles[fh-3] = NULL;
+    filehandle_mutex->lock();
+    FileHandle* fhc = get_filehandle(fh);
     if (fhc == NULL) {
+        filehandle_mutex->unlock();
         errno = EBADF;
         return -1;
     }
+    release_filehandle(fh-3);
+    filehandle_mutex->unlock();
 
     int err = fhc->close();
     if (err < 0) {
@@ -289,6 +369,34 @@ extern "C" int PREFIX(_close)(FILEHANDLE fh) {
     }
 }
 
+/* Writes to the stdio serial port, which stdin, stdout and stderr share */
+static void stdio_write(const unsigned char *buffer, size_t length) {
+#if DEVICE_SERIAL
+    if (!stdio_uart_inited) init_serial();
+#if MBED_CONF_PLATFORM_STDIO_CONVERT_NEWLINES
+    for (size_t i = 0; i < length; i++) {
+        if (buffer[i] == '\n' && stdio_out_prev != '\r') {
+             serial_putc(&stdio_uart, '\r');
+        }
+        serial_putc(&stdio_uart, buffer[i]);
+        stdio_out_prev = buffer[i];
+    }
+#else
+    for (size_t i = 0; i < length; i++) {
+        serial_putc(&stdio_uart, buffer[i]);
+    }
+#endif
+#endif
+}
+
+static void stdio_printf_write(void *context, const char *data, size_t size) {
+    stdio_write((const unsigned char *)data, size);
+}
+
+extern "C" int mbed_vprintf(const char *format, va_list args) {
+    return mbed_vxprintf(stdio_printf_write, NULL, format, args);
+}
+
 #if defined(__ICCARM__)
 extern "C" size_t    __write (int        fh, const unsigned char *buffer, size_t length) {
 #else
@@ -303,25 +411,10 @@ extern "C" int PREFIX(_write)(FILEHANDLE fh, const unsigned char *buffer, unsign
 #endif
 
     if (fh < 3) {
-#if DEVICE_SERIAL
-        if (!stdio_uart_inited) init_serial();
-#if MBED_CONF_PLATFORM_STDIO_CONVERT_NEWLINES
-        for (unsigned int i = 0; i < length; i++) {
-            if (buffer[i] == '\n' && stdio_out_prev != '\r') {
-                 serial_putc(&stdio_uart, '\r');
-            }
-            serial_putc(&stdio_uart, buffer[i]);
-            stdio_out_prev = buffer[i];
-        }
-#else
-        for (unsigned int i = 0; i < length; i++) {
-            serial_putc(&stdio_uart, buffer[i]);
-        }
-#endif
-#endif
+        stdio_write(buffer, length);
         n = length;
     } else {
-        FileHandle* fhc = filehandles[fh-3];
+        FileHandle* fhc = get_filehandle(fh);
         if (fhc == NULL) {
             errno = EBADF;
             return -1;
@@ -345,6 +438,7 @@ extern "C" void PREFIX(_exit)(int return_code) {
 }
 
 extern "C" void _ttywrch(int ch) {
+    if (!stdio_uart_inited) init_serial();
     serial_putc(&stdio_uart, ch);
 }
 #endif
@@ -391,7 +485,7 @@ extern "C" int PREFIX(_read)(FILEHANDLE fh, unsigned char *buffer, unsigned int
 #endif
         n = 1;
     } else {
-        FileHandle* fhc = filehandles[fh-3];
+        FileHandle* fhc = get_filehandle(fh);
         if (fhc == NULL) {
             errno = EBADF;
             return -1;
@@ -419,7 +513,7 @@ extern "C" int _isatty(FILEHANDLE fh)
     /* stdin, stdout and stderr should be tty */
     if (fh < 3) return 1;
 
-    FileHandle* fhc = filehandles[fh-3];
+    FileHandle* fhc = get_filehandle(fh);
     if (fhc == NULL) {
         errno = EBADF;
         return 0;
@@ -451,7 +545,7 @@ int _lseek(FILEHANDLE fh, int offset, int whence)
         return -1;
     }
 
-    FileHandle* fhc = filehandles[fh-3];
+    FileHandle* fhc = get_filehandle(fh);
     if (fhc == NULL) {
         errno = EBADF;
         return -1;
@@ -474,7 +568,7 @@ int _lseek(FILEHANDLE fh, int offset, int whence)
 extern "C" int PREFIX(_ensure)(FILEHANDLE fh) {
     if (fh < 3) return 0;
 
-    FileHandle* fhc = filehandles[fh-3];
+    FileHandle* fhc = get_filehandle(fh);
     if (fhc == NULL) {
         errno = EBADF;
         return -1;
@@ -495,7 +589,7 @@ extern "C" long PREFIX(_flen)(FILEHANDLE fh) {
         return -1;
     }
 
-    FileHandle* fhc = filehandles[fh-3];
+    FileHandle* fhc = get_filehandle(fh);
     if (fhc == NULL) {
         errno = EBADF;
         return -1;
@@ -39,6 +39,7 @@ typedef int mode_t;     ///< Mode for opening files
 #define O_CREAT  0x0200
 #define O_TRUNC  0x0400
 #define O_APPEND 0x0008
+#define O_EXCL   0x0800
 
 #define NAME_MAX 255    ///< Maximum size of a name in a file path
 
@@ -49,6 +50,17 @@ typedef int mode_t;     ///< Mode for opening files
 #endif
 
 
+/* The embedded C libraries do not declare iovec, hosted ones do */
+#if defined(__GLIBC__)
+#include <sys/uio.h>
+#else
+/** A buffer of a scatter-gather read or write, as in POSIX readv and writev */
+struct iovec {
+    void *iov_base;     ///< Start of the buffer
+    size_t iov_len;     ///< Number of bytes in the buffer
+};
+#endif
+
 /* DIR declarations must also be here */
 #if __cplusplus
 namespace mbed {
@@ -123,6 +135,12 @@ extern "C" {
 #undef ENODEV
 #define ENODEV      19
 
+#undef ENOTDIR
+#define ENOTDIR     20      /* Not a directory */
+
+#undef EISDIR
+#define EISDIR      21      /* Is a directory */
+
 #undef EINVAL
 #define EINVAL      22      /* Invalid argument */
 
@@ -132,15 +150,27 @@ extern "C" {
 #undef EMFILE
 #define EMFILE      24      /* File descriptor value too large */
 
+#undef ENOSPC
+#define ENOSPC      28      /* No space left on device */
+
 #undef ESPIPE
 #define ESPIPE      29      /* Invalid seek */
 
+#undef ENAMETOOLONG
+#define ENAMETOOLONG 36     /* File or path name too long */
+
 #undef ENOSYS
 #define ENOSYS      38      /* Function not implemented */
 
+#undef ENOTEMPTY
+#define ENOTEMPTY   39      /* Directory not empty */
+
 #undef EOVERFLOW
 #define EOVERFLOW   75      /* Value too large to be stored in data type */
 
+#undef EILSEQ
+#define EILSEQ      84      /* Illegal byte sequence */
+
 /* Missing stat.h defines.
  * The following are sys/stat.h definitions not currently present in the ARMCC
  * errno.h. Note, ARMCC errno.h defines some symbol values differing from
@@ -16,9 +16,13 @@
 #include "hal/rtc_api.h"
 
 #include <time.h>
+#if defined(TOOLCHAIN_GCC)
+#include <sys/time.h>
+#endif
 #include "platform/mbed_critical.h"
 #include "platform/mbed_rtc_time.h"
 #include "hal/us_ticker_api.h"
+#include "hal/lp_ticker_api.h"
 #include "platform/SingletonPtr.h"
 #include "platform/PlatformMutex.h"
 
@@ -36,27 +40,99 @@ static time_t (*_rtc_read)(void) = NULL;
 static void (*_rtc_write)(time_t t) = NULL;
 #endif
 
-#ifdef __cplusplus
-extern "C" {
+// Reading the RTC can be slow, so with a resync interval the RTC is only read
+// every few seconds and the time in between is extrapolated from the low
+// power ticker, which keeps running in deep sleep.
+#ifndef MBED_CONF_PLATFORM_RTC_RESYNC_INTERVAL
+#define MBED_CONF_PLATFORM_RTC_RESYNC_INTERVAL 0
 #endif
-#if defined (__ICCARM__)
-time_t __time32(time_t *timer)
-#else
-time_t time(time_t *timer)
+
+#if DEVICE_LOWPOWERTIMER && MBED_CONF_PLATFORM_RTC_RESYNC_INTERVAL > 0
+#define RTC_TIMEBASE 1
+static time_t _base_time;           // RTC time at the last resync
+static us_timestamp_t _base_ticks;  // low power ticker time at the last resync
+static bool _base_valid = false;
+static time_t _last_time;           // latest time returned, which time never goes below
+static uint32_t _last_usec;
 #endif
 
-{
-    _mutex->lock();
+static time_t rtc_time_read(void) {
     if (_rtc_isenabled != NULL) {
         if (!(_rtc_isenabled())) {
             set_time(0);
         }
     }
-    
+
     time_t t = (time_t)-1;
     if (_rtc_read != NULL) {
         t = _rtc_read();
     }
+    return t;
+}
+
+// Read the time, with the microseconds into the current second. Called
+// with the mutex held.
+static time_t time_read(uint32_t *usec) {
+#ifdef RTC_TIMEBASE
+    if (_rtc_read != NULL) {
+        us_timestamp_t now = ticker_read_us(get_lp_ticker_data());
+        us_timestamp_t elapsed = now - _base_ticks;
+
+        if (!_base_valid || elapsed >= MBED_CONF_PLATFORM_RTC_RESYNC_INTERVAL * 1000000ULL) {
+            time_t t = rtc_time_read();
+            // keep the sub-second phase while the RTC agrees with the ticker,
+            // otherwise restart from the beginning of the RTC's second, either
+            // way the base moves up so the next resync is an interval away
+            time_t seconds = (time_t)(elapsed / 1000000);
+            if (_base_valid && t == _base_time + seconds) {
+                _base_time += seconds;
+                _base_ticks += seconds * 1000000ULL;
+            } else {
+                if (!_base_valid) {
+                    _last_time = t;
+                    _last_usec = 0;
+                }
+                _base_time = t;
+                _base_ticks = now;
+                _base_valid = true;
+            }
+            elapsed = now - _base_ticks;
+        }
+
+        // a resync can move the time base back when the ticker runs fast,
+        // so hold the time still until the RTC catches up
+        time_t t = _base_time + (time_t)(elapsed / 1000000);
+        uint32_t us = elapsed % 1000000;
+        if (t > _last_time || (t == _last_time && us > _last_usec)) {
+            _last_time = t;
+            _last_usec = us;
+        }
+
+        if (usec != NULL) {
+            *usec = _last_usec;
+        }
+        return _last_time;
+    }
+#endif
+
+    if (usec != NULL) {
+        *usec = 0;
+    }
+    return rtc_time_read();
+}
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#if defined (__ICCARM__)
+time_t __time32(time_t *timer)
+#else
+time_t time(time_t *timer)
+#endif
+
+{
+    _mutex->lock();
+    time_t t = time_read(NULL);
 
     if (timer != NULL) {
         *timer = t;
@@ -65,6 +141,21 @@ time_t time(time_t *timer)
     return t;
 }
 
+#if defined(TOOLCHAIN_GCC)
+// used by newlib's gettimeofday
+int _gettimeofday(struct timeval *tv, void *tz) {
+    (void)tz;
+    if (tv != NULL) {
+        _mutex->lock();
+        uint32_t usec;
+        tv->tv_sec = time_read(&usec);
+        tv->tv_usec = usec;
+        _mutex->unlock();
+    }
+    return 0;
+}
+#endif
+
 void set_time(time_t t) {
     _mutex->lock();
     if (_rtc_init != NULL) {
@@ -73,6 +164,13 @@ void set_time(time_t t) {
     if (_rtc_write != NULL) {
         _rtc_write(t);
     }
+#ifdef RTC_TIMEBASE
+    _base_time = t;
+    _base_ticks = ticker_read_us(get_lp_ticker_data());
+    _base_valid = true;
+    _last_time = t;
+    _last_usec = 0;
+#endif
     _mutex->unlock();
 }
 
@@ -90,6 +188,9 @@ void attach_rtc(time_t (*read_rtc)(void), void (*write_rtc)(time_t), void (*init
     _rtc_write = write_rtc;
     _rtc_init = init_rtc;
     _rtc_isenabled = isenabled_rtc;
+#ifdef RTC_TIMEBASE
+    _base_valid = false;
+#endif
     _mutex->unlock();
 }
 
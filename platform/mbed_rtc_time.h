@@ -51,6 +51,13 @@ extern "C" {
  *     }
  * }
  * @endcode
+ *
+ * With platform.rtc-resync-interval set on a target with a low power ticker,
+ * the RTC is only read once per interval, and time() and gettimeofday()
+ * extrapolate from the low power ticker in between, which is much cheaper
+ * than reading the RTC on most targets. The time they return only goes back
+ * on set_time(): if the ticker runs ahead of the RTC, the time holds still
+ * after a resync until the RTC catches up.
  */
 
 /** Set the current time
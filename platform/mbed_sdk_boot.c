@@ -15,6 +15,8 @@
  */
 
 #include "mbed_toolchain.h"
+#include "mbed_crash_dump.h"
+#include "mbed_cycle_counter.h"
 #include <stdlib.h>
 #include <stdint.h>
 #include "cmsis.h"
@@ -73,6 +75,8 @@ int $Super$$main(void);
 
 int $Sub$$main(void) 
 {
+    mbed_cycle_counter_init();
+    mbed_crash_dump_boot();
     mbed_main();
     return $Super$$main();
 }
@@ -97,6 +101,8 @@ void software_init_hook(void)
 
 int __wrap_main(void) 
 {
+    mbed_cycle_counter_init();
+    mbed_crash_dump_boot();
     mbed_main();
     return __real_main();
 }
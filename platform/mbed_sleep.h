@@ -83,6 +83,26 @@ void sleep_manager_lock_deep_sleep(void);
  */
 void sleep_manager_unlock_deep_sleep(void);
 
+/** Lock the deep sleep mode on behalf of a named owner
+ *
+ * Same as sleep_manager_lock_deep_sleep(), but with MBED_SLEEP_STATS_ENABLED
+ * the lock is also counted against the given name, so the owners that keep
+ * the target out of deep sleep can be listed with
+ * mbed_stats_sleep_locks_get_each(). Names are compared by content, and locks
+ * taken with sleep_manager_lock_deep_sleep() are all counted under "unnamed".
+ *
+ * @param name Name of the lock owner, it has to stay allocated while locked
+ */
+void sleep_manager_lock_deep_sleep_named(const char *name);
+
+/** Unlock the deep sleep mode on behalf of a named owner
+ *
+ * Use unlocking in pair with sleep_manager_lock_deep_sleep_named() with the same name.
+ *
+ * @param name Name of the lock owner
+ */
+void sleep_manager_unlock_deep_sleep_named(const char *name);
+
 /** Get the status of deep sleep allowance for a target
  *
  * @return true if a target can go to deepsleep, false otherwise
@@ -5,6 +5,127 @@
 
 #if MBED_CONF_RTOS_PRESENT
 #include "cmsis_os2.h"
+#include "mbed_rtos_storage.h"
+#endif
+
+#if MBED_STACK_STATS_ENABLED && MBED_CONF_RTOS_PRESENT
+#ifndef MBED_STACK_STATS_SCAN_STRIDE
+#define MBED_STACK_STATS_SCAN_STRIDE 8
+#endif
+
+// Finds the unused space at the bottom of a thread's stack with the kernel
+// locked. Instead of checking every word for the fill pattern in an SVC, as
+// osThreadGetStackSpace does, this runs in thread context and checks every
+// MBED_STACK_STATS_SCAN_STRIDE'th word, then the words below the first one
+// that is used. Usage that touches none of the checked words can be missed,
+// so the result can be up to 4*(MBED_STACK_STATS_SCAN_STRIDE-1) bytes too
+// large. A stride of 1 gives an exact scan.
+static uint32_t stack_space(osThreadId_t thread_id)
+{
+#if defined(MBED_OS_BACKEND_RTX5)
+    osRtxThread_t *thread = (osRtxThread_t *)thread_id;
+    uint32_t *stack = (uint32_t *)thread->stack_mem;
+    uint32_t words = thread->stack_size / sizeof(uint32_t);
+
+    if (!(osRtxConfig.flags & osRtxConfigStackWatermark) ||
+            stack[0] != osRtxStackMagicWord) {
+        return 0;
+    }
+
+    uint32_t i = MBED_STACK_STATS_SCAN_STRIDE;
+    while (i < words && stack[i] == osRtxStackFillPattern) {
+        i += MBED_STACK_STATS_SCAN_STRIDE;
+    }
+    if (i > words) {
+        i = words;
+    }
+
+    uint32_t j = i > MBED_STACK_STATS_SCAN_STRIDE ? i - MBED_STACK_STATS_SCAN_STRIDE + 1 : 1;
+    while (j < i && stack[j] == osRtxStackFillPattern) {
+        j++;
+    }
+
+    return j * sizeof(uint32_t);
+#else
+    return osThreadGetStackSpace(thread_id);
+#endif
+}
+#endif
+
+#if MBED_CPU_STATS_ENABLED && MBED_CONF_RTOS_PRESENT
+#include <stdbool.h>
+#include "rtx_os.h"
+#include "rtx_evr.h"
+#include "hal/us_ticker_api.h"
+
+#ifndef MBED_CPU_STATS_MAX_THREADS
+#define MBED_CPU_STATS_MAX_THREADS 16
+#endif
+
+// runtime of each tracked thread, updated on every thread switch
+static struct {
+    osThreadId_t thread_id;
+    uint64_t runtime;
+} cpu_threads[MBED_CPU_STATS_MAX_THREADS];
+
+static osThreadId_t cpu_current;
+static uint64_t cpu_start;
+static uint64_t cpu_last;
+
+static uint64_t *cpu_runtime(osThreadId_t thread_id, bool alloc)
+{
+    int free_slot = -1;
+    for (int i = 0; i < MBED_CPU_STATS_MAX_THREADS; i++) {
+        if (cpu_threads[i].thread_id == thread_id) {
+            return &cpu_threads[i].runtime;
+        } else if (free_slot < 0 && !cpu_threads[i].thread_id) {
+            free_slot = i;
+        }
+    }
+
+    if (!alloc || free_slot < 0) {
+        return NULL;
+    }
+
+    cpu_threads[free_slot].thread_id = thread_id;
+    cpu_threads[free_slot].runtime = 0;
+    return &cpu_threads[free_slot].runtime;
+}
+
+// charges the time since the last switch to the running thread,
+// called with thread switches disabled
+static uint64_t cpu_update(void)
+{
+    uint64_t now = ticker_read_us(get_us_ticker_data());
+    if (cpu_current) {
+        uint64_t *runtime = cpu_runtime(cpu_current, true);
+        if (runtime) {
+            *runtime += now - cpu_last;
+        }
+    } else {
+        cpu_start = now;
+    }
+
+    cpu_last = now;
+    return now;
+}
+
+// overrides the weak rtx event recorder hooks, called from the kernel
+// with the new thread that is about to run
+void EvrRtxThreadSwitch(osThreadId_t thread_id)
+{
+    cpu_update();
+    cpu_current = thread_id;
+}
+
+void EvrRtxThreadDestroyed(osThreadId_t thread_id)
+{
+    for (int i = 0; i < MBED_CPU_STATS_MAX_THREADS; i++) {
+        if (cpu_threads[i].thread_id == thread_id) {
+            cpu_threads[i].thread_id = 0;
+        }
+    }
+}
 #endif
 
 // note: mbed_stats_heap_get defined in mbed_alloc_wrappers.cpp
@@ -26,7 +147,7 @@ void mbed_stats_stack_get(mbed_stats_stack_t *stats)
 
     for(i = 0; i < thread_n; i++) {
         uint32_t stack_size = osThreadGetStackSize(threads[i]);
-        stats->max_size += stack_size - osThreadGetStackSpace(threads[i]);
+        stats->max_size += stack_size - stack_space(threads[i]);
         stats->reserved_size += stack_size;
         stats->stack_cnt++;
     }
@@ -52,7 +173,7 @@ size_t mbed_stats_stack_get_each(mbed_stats_stack_t *stats, size_t count)
 
     for(i = 0; i < count; i++) {
         uint32_t stack_size = osThreadGetStackSize(threads[i]);
-        stats[i].max_size = stack_size - osThreadGetStackSpace(threads[i]);
+        stats[i].max_size = stack_size - stack_space(threads[i]);
         stats[i].reserved_size = stack_size;
         stats[i].thread_id = (uint32_t)threads[i];
         stats[i].stack_cnt = 1;
@@ -65,6 +186,55 @@ size_t mbed_stats_stack_get_each(mbed_stats_stack_t *stats, size_t count)
     return i;
 }
 
+void mbed_stats_cpu_get(mbed_stats_cpu_t *stats)
+{
+    memset(stats, 0, sizeof(mbed_stats_cpu_t));
+
+#if MBED_CPU_STATS_ENABLED && MBED_CONF_RTOS_PRESENT
+    osKernelLock();
+    if (cpu_current) {
+        stats->uptime = cpu_update() - cpu_start;
+        uint64_t *idle = cpu_runtime(osRtxInfo.thread.idle, false);
+        if (idle) {
+            stats->idle_time = *idle;
+        }
+    }
+    osKernelUnlock();
+#endif
+}
+
+size_t mbed_stats_thread_cpu_get_each(mbed_stats_thread_cpu_t *stats, size_t count)
+{
+    memset(stats, 0, count*sizeof(mbed_stats_thread_cpu_t));
+    size_t i = 0;
+
+#if MBED_CPU_STATS_ENABLED && MBED_CONF_RTOS_PRESENT
+    osThreadId_t *threads;
+
+    threads = malloc(sizeof(osThreadId_t) * count);
+    MBED_ASSERT(threads != NULL);
+
+    osKernelLock();
+    cpu_update();
+    count = osThreadEnumerate(threads, count);
+
+    for(i = 0; i < count; i++) {
+        uint64_t *runtime = cpu_runtime(threads[i], false);
+        stats[i].thread_id = (uint32_t)threads[i];
+        stats[i].runtime = runtime ? *runtime : 0;
+    }
+    osKernelUnlock();
+
+    free(threads);
+#endif
+
+    return i;
+}
+
 #if MBED_STACK_STATS_ENABLED && !MBED_CONF_RTOS_PRESENT
 #warning Stack statistics are currently not supported without the rtos.
 #endif
+
+#if MBED_CPU_STATS_ENABLED && !MBED_CONF_RTOS_PRESENT
+#warning Cpu statistics are currently not supported without the rtos.
+#endif
@@ -25,6 +25,13 @@
 extern "C" {
 #endif
 
+/** Number of buckets in the allocation size histogram of the heap stats
+ *
+ *  Bucket 0 counts allocations of up to 16 bytes, each following bucket
+ *  sizes of up to twice as many and the last bucket all larger sizes.
+ */
+#define MBED_STATS_HEAP_HIST_BUCKETS    8
+
 typedef struct {
     uint32_t current_size;      /**< Bytes allocated currently. */
     uint32_t max_size;          /**< Max bytes allocated at a given time. */
@@ -32,18 +39,28 @@ typedef struct {
     uint32_t reserved_size;     /**< Current number of bytes allocated for the heap. */
     uint32_t alloc_cnt;         /**< Current number of allocations. */
     uint32_t alloc_fail_cnt;    /**< Number of failed allocations. */
+    uint32_t alloc_size_hist[MBED_STATS_HEAP_HIST_BUCKETS]; /**< Cumulative number of allocations by size, see MBED_STATS_HEAP_HIST_BUCKETS. */
+    uint32_t free_size;         /**< Bytes free in the heap, see platform.heap-stats-fragmentation. */
+    uint32_t free_block_cnt;    /**< Number of free blocks the free bytes are split in, see platform.heap-stats-fragmentation. */
+    uint32_t largest_free_size; /**< Size of the largest free block, see platform.heap-stats-fragmentation. */
 } mbed_stats_heap_t;
 
 /**
  *  Fill the passed in heap stat structure with heap stats.
  *
+ *  The free block fields are only filled in if the platform.heap-stats-fragmentation
+ *  configuration option is set, as the free blocks are walked with the allocator locked.
+ *  With the newlib allocator of GCC all three are exact. With the ARM standard library
+ *  the free bytes and blocks come from __heapstats and the largest free block is found
+ *  by trying allocations, with microlib and IAR only the largest free block is known.
+ *
  *  @param stats    A pointer to the mbed_stats_heap_t structure to fill
  */
 void mbed_stats_heap_get(mbed_stats_heap_t *stats);
 
 typedef struct {
     uint32_t thread_id;         /**< Identifier for thread that owns the stack or 0 if multiple threads. */
-    uint32_t max_size;          /**< Maximum number of bytes used on the stack. */
+    uint32_t max_size;          /**< Maximum number of bytes used on the stack, see MBED_STACK_STATS_SCAN_STRIDE. */
     uint32_t reserved_size;     /**< Current number of bytes allocated for the stack. */
     uint32_t stack_cnt;         /**< Number of stacks stats accumulated in the structure. */
 } mbed_stats_stack_t;
@@ -66,6 +83,91 @@ void mbed_stats_stack_get(mbed_stats_stack_t *stats);
  */
 size_t mbed_stats_stack_get_each(mbed_stats_stack_t *stats, size_t count);
 
+typedef struct {
+    uint64_t uptime;            /**< Microseconds since the rtos kernel was started. */
+    uint64_t idle_time;         /**< Microseconds spent in the idle thread. */
+} mbed_stats_cpu_t;
+
+/**
+ *  Fill the passed in structure with the time spent in the idle thread since the kernel was
+ *  started, the idle share of the cpu is idle_time / uptime.
+ *
+ *  @param stats    A pointer to the mbed_stats_cpu_t structure to fill
+ */
+void mbed_stats_cpu_get(mbed_stats_cpu_t *stats);
+
+typedef struct {
+    uint32_t thread_id;         /**< Identifier for the thread. */
+    uint64_t runtime;           /**< Microseconds the thread has been running. */
+} mbed_stats_thread_cpu_t;
+
+/**
+ *  Fill the passed array of stat structures with the cpu time used by each available thread,
+ *  including the idle thread.
+ *
+ *  @param stats    A pointer to an array of mbed_stats_thread_cpu_t structures to fill
+ *  @param count    The number of mbed_stats_thread_cpu_t structures in the provided array
+ *  @return         The number of mbed_stats_thread_cpu_t structures that have been filled,
+ *                  this is equal to the number of threads on the system.
+ *
+ *  @note Only the first MBED_CPU_STATS_MAX_THREADS threads alive at once are tracked, the
+ *        runtime of any other thread is reported as 0.
+ */
+size_t mbed_stats_thread_cpu_get_each(mbed_stats_thread_cpu_t *stats, size_t count);
+
+typedef struct {
+    uint64_t sleep_time;        /**< Microseconds spent in sleep. */
+    uint64_t deep_sleep_time;   /**< Microseconds spent in deep sleep. */
+    uint32_t sleep_cnt;         /**< Number of times the target entered sleep. */
+    uint32_t deep_sleep_cnt;    /**< Number of times the target entered deep sleep. */
+    uint32_t unknown_wakeup_cnt;/**< Number of wakeups with no interrupt pending, or on cores other than Cortex-M. */
+} mbed_stats_sleep_t;
+
+/**
+ *  Fill the passed in structure with the time spent in each sleep mode since boot.
+ *
+ *  @param stats    A pointer to the mbed_stats_sleep_t structure to fill
+ *
+ *  @note Time is measured with the low power ticker when the target has one, otherwise deep sleep
+ *        time is not accurate as the us ticker may stop in deep sleep.
+ */
+void mbed_stats_sleep_get(mbed_stats_sleep_t *stats);
+
+typedef struct {
+    const char *name;           /**< Name of the lock owner. */
+    uint32_t lock_cnt;          /**< Number of deep sleep locks currently held by the owner. */
+} mbed_stats_sleep_lock_t;
+
+/**
+ *  Fill the passed array of stat structures with the owners currently holding deep sleep locks.
+ *
+ *  @param stats    A pointer to an array of mbed_stats_sleep_lock_t structures to fill
+ *  @param count    The number of mbed_stats_sleep_lock_t structures in the provided array
+ *  @return         The number of mbed_stats_sleep_lock_t structures that have been filled.
+ *
+ *  @note Only the first MBED_SLEEP_STATS_MAX_LOCKS owners holding locks at once are tracked.
+ */
+size_t mbed_stats_sleep_locks_get_each(mbed_stats_sleep_lock_t *stats, size_t count);
+
+typedef struct {
+    int32_t irq;                /**< Interrupt that was pending on wakeup, -1 for SysTick. */
+    uint32_t wakeup_cnt;        /**< Number of wakeups attributed to the interrupt. */
+} mbed_stats_wakeup_t;
+
+/**
+ *  Fill the passed array of stat structures with the interrupts that woke the target up.
+ *
+ *  @param stats    A pointer to an array of mbed_stats_wakeup_t structures to fill
+ *  @param count    The number of mbed_stats_wakeup_t structures in the provided array
+ *  @return         The number of mbed_stats_wakeup_t structures that have been filled.
+ *
+ *  @note Only the first MBED_SLEEP_STATS_MAX_WAKEUP_SOURCES interrupts are tracked. A wakeup is
+ *        attributed to the lowest numbered interrupt pending when the target wakes up. Wakeup
+ *        sources are only identified on Cortex-M cores, other cores count every wakeup in
+ *        mbed_stats_sleep_t::unknown_wakeup_cnt.
+ */
+size_t mbed_stats_wakeup_get_each(mbed_stats_wakeup_t *stats, size_t count);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,390 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "platform/mbed_tlsf.h"
+#include <string.h>
+
+/* A block is its header followed by its data. The free list links overlay
+ * the data, so they only exist while the block is free. Every pool ends
+ * with a zero size used block, so the last block has a neighbour too. */
+typedef struct mbed_tlsf_block {
+    struct mbed_tlsf_block *prev_phys;
+    size_t size;
+    struct mbed_tlsf_block *next_free;
+    struct mbed_tlsf_block *prev_free;
+} block_t;
+
+#define ALIGN           8
+#define BLOCK_FREE      1
+#define BLOCK_HEADER    offsetof(block_t, next_free)
+#define BLOCK_MIN       (sizeof(block_t) - BLOCK_HEADER)
+#define BLOCK_MAX       (((size_t)1 << MBED_TLSF_FL_MAX) - ALIGN)
+#define SMALL_BLOCK     ((size_t)1 << MBED_TLSF_FL_SHIFT)
+
+static int fls_u32(uint32_t word)
+{
+#if defined(__GNUC__)
+    return word ? 31 - __builtin_clz(word) : -1;
+#elif defined(__CC_ARM)
+    return word ? 31 - __clz(word) : -1;
+#else
+    int bit = -1;
+    while (word) {
+        word >>= 1;
+        bit++;
+    }
+    return bit;
+#endif
+}
+
+static int ffs_u32(uint32_t word)
+{
+    return fls_u32(word & (~word + 1));
+}
+
+static size_t block_size(const block_t *block)
+{
+    return block->size & ~(size_t)(ALIGN - 1);
+}
+
+static int block_is_free(const block_t *block)
+{
+    return block->size & BLOCK_FREE;
+}
+
+static void *block_to_ptr(block_t *block)
+{
+    return (char *)block + BLOCK_HEADER;
+}
+
+static block_t *block_from_ptr(void *ptr)
+{
+    return (block_t *)((char *)ptr - BLOCK_HEADER);
+}
+
+static block_t *block_next(block_t *block)
+{
+    return (block_t *)((char *)block_to_ptr(block) + block_size(block));
+}
+
+static size_t align_up(size_t x, size_t align)
+{
+    return (x + align - 1) & ~(align - 1);
+}
+
+/* The size of the block an allocation of size bytes takes, or 0 if too large */
+static size_t adjust_size(size_t size)
+{
+    if (size > BLOCK_MAX) {
+        return 0;
+    }
+    size = align_up(size, ALIGN);
+    return size < BLOCK_MIN ? BLOCK_MIN : size;
+}
+
+/* The list a free block of the size belongs in */
+static void mapping_insert(size_t size, int *fl, int *sl)
+{
+    if (size < SMALL_BLOCK) {
+        *fl = 0;
+        *sl = size / (SMALL_BLOCK / MBED_TLSF_SL_COUNT);
+    } else {
+        int bit = fls_u32(size);
+        *sl = (size >> (bit - MBED_TLSF_SL_LOG2)) ^ MBED_TLSF_SL_COUNT;
+        *fl = bit - (MBED_TLSF_FL_SHIFT - 1);
+    }
+}
+
+/* The first list all of whose blocks are large enough for the size */
+static int mapping_search(size_t size, int *fl, int *sl)
+{
+    if (size >= SMALL_BLOCK) {
+        size += ((size_t)1 << (fls_u32(size) - MBED_TLSF_SL_LOG2)) - 1;
+    }
+    mapping_insert(size, fl, sl);
+    return *fl < MBED_TLSF_FL_COUNT;
+}
+
+static void block_insert(mbed_tlsf_t *tlsf, block_t *block)
+{
+    int fl, sl;
+    mapping_insert(block_size(block), &fl, &sl);
+    block_t *head = tlsf->blocks[fl][sl];
+    block->next_free = head;
+    block->prev_free = NULL;
+    if (head) {
+        head->prev_free = block;
+    }
+    tlsf->blocks[fl][sl] = block;
+    tlsf->fl_bitmap |= 1UL << fl;
+    tlsf->sl_bitmap[fl] |= 1UL << sl;
+}
+
+static void block_remove(mbed_tlsf_t *tlsf, block_t *block)
+{
+    int fl, sl;
+    mapping_insert(block_size(block), &fl, &sl);
+    if (block->next_free) {
+        block->next_free->prev_free = block->prev_free;
+    }
+    if (block->prev_free) {
+        block->prev_free->next_free = block->next_free;
+    } else {
+        tlsf->blocks[fl][sl] = block->next_free;
+        if (!block->next_free) {
+            tlsf->sl_bitmap[fl] &= ~(1UL << sl);
+            if (!tlsf->sl_bitmap[fl]) {
+                tlsf->fl_bitmap &= ~(1UL << fl);
+            }
+        }
+    }
+}
+
+/* Take a free block of at least size bytes off its list */
+static block_t *block_locate(mbed_tlsf_t *tlsf, size_t size)
+{
+    int fl, sl;
+    if (!mapping_search(size, &fl, &sl)) {
+        return NULL;
+    }
+
+    uint32_t sl_map = tlsf->sl_bitmap[fl] & (~0UL << sl);
+    if (!sl_map) {
+        uint32_t fl_map = fl + 1 < 32 ? tlsf->fl_bitmap & (~0UL << (fl + 1)) : 0;
+        if (!fl_map) {
+            return NULL;
+        }
+        fl = ffs_u32(fl_map);
+        sl_map = tlsf->sl_bitmap[fl];
+    }
+    block_t *block = tlsf->blocks[fl][ffs_u32(sl_map)];
+    block_remove(tlsf, block);
+    return block;
+}
+
+/* Merge a free block with the block after it if that is free */
+static block_t *block_merge_next(mbed_tlsf_t *tlsf, block_t *block)
+{
+    block_t *next = block_next(block);
+    if (block_is_free(next) && block_size(block) + BLOCK_HEADER + block_size(next) <= BLOCK_MAX) {
+        block_remove(tlsf, next);
+        block->size = (block_size(block) + BLOCK_HEADER + block_size(next)) | BLOCK_FREE;
+        block_next(block)->prev_phys = block;
+    }
+    return block;
+}
+
+/* Give the end of a used block beyond size bytes back to the free lists */
+static void block_trim(mbed_tlsf_t *tlsf, block_t *block, size_t size)
+{
+    if (block_size(block) < size + BLOCK_HEADER + BLOCK_MIN) {
+        return;
+    }
+    block_t *rest = (block_t *)((char *)block_to_ptr(block) + size);
+    rest->prev_phys = block;
+    rest->size = (block_size(block) - size - BLOCK_HEADER) | BLOCK_FREE;
+    block->size = size | (block->size & BLOCK_FREE);
+    block_next(rest)->prev_phys = rest;
+    block_insert(tlsf, block_merge_next(tlsf, rest));
+}
+
+void mbed_tlsf_init(mbed_tlsf_t *tlsf)
+{
+    memset(tlsf, 0, sizeof(*tlsf));
+}
+
+int mbed_tlsf_add_pool(mbed_tlsf_t *tlsf, void *mem, size_t size)
+{
+    char *start = (char *)align_up((uintptr_t)mem, ALIGN);
+    char *end = (char *)((uintptr_t)((char *)mem + size) & ~(uintptr_t)(ALIGN - 1));
+    block_t *block;
+
+    if (tlsf->pool_end && start == tlsf->pool_end) {
+        // the sentinel of the last pool becomes the first new block
+        block = (block_t *)(start - BLOCK_HEADER);
+    } else {
+        if (end < start || (size_t)(end - start) < 2 * BLOCK_HEADER + BLOCK_MIN) {
+            return -1;
+        }
+        block = (block_t *)start;
+        block->prev_phys = NULL;
+    }
+    if ((size_t)(end - (char *)block) < 2 * BLOCK_HEADER + BLOCK_MIN) {
+        return -1;
+    }
+
+    // cover the memory with blocks below the largest size, then the sentinel
+    for (;;) {
+        size_t avail = end - (char *)block - 2 * BLOCK_HEADER;
+        size_t block_bytes = avail <= BLOCK_MAX ? avail : (BLOCK_MAX / 2) & ~(size_t)(ALIGN - 1);
+        block->size = block_bytes;
+        block_t *next = block_next(block);
+        next->prev_phys = block;
+        next->size = 0;
+        mbed_tlsf_free(tlsf, block_to_ptr(block));
+        if (block_bytes == avail) {
+            break;
+        }
+        block = next;
+    }
+
+    tlsf->pool_end = end;
+    return 0;
+}
+
+void *mbed_tlsf_malloc(mbed_tlsf_t *tlsf, size_t size)
+{
+    size_t adjust = adjust_size(size);
+    block_t *block = adjust ? block_locate(tlsf, adjust) : NULL;
+    if (!block) {
+        return NULL;
+    }
+    block->size &= ~(size_t)BLOCK_FREE;
+    block_trim(tlsf, block, adjust);
+    return block_to_ptr(block);
+}
+
+void *mbed_tlsf_memalign(mbed_tlsf_t *tlsf, size_t align, size_t size)
+{
+    if (align <= ALIGN) {
+        return mbed_tlsf_malloc(tlsf, size);
+    }
+
+    // a leading gap is split off as a free block, so needs room for one
+    size_t adjust = adjust_size(size);
+    size_t gap_min = BLOCK_HEADER + BLOCK_MIN;
+    if (!adjust || adjust + align + gap_min > BLOCK_MAX) {
+        return NULL;
+    }
+    block_t *block = block_locate(tlsf, adjust + align + gap_min);
+    if (!block) {
+        return NULL;
+    }
+
+    uintptr_t ptr = (uintptr_t)block_to_ptr(block);
+    uintptr_t aligned = align_up(ptr, align);
+    if (aligned != ptr && aligned - ptr < gap_min) {
+        aligned = align_up(ptr + gap_min, align);
+    }
+    if (aligned != ptr) {
+        size_t gap = aligned - ptr;
+        block_t *used = block_from_ptr((void *)aligned);
+        used->prev_phys = block;
+        used->size = block_size(block) - gap;
+        block_next(used)->prev_phys = used;
+        block->size = (gap - BLOCK_HEADER) | BLOCK_FREE;
+        block_insert(tlsf, block);
+        block = used;
+    }
+
+    block->size &= ~(size_t)BLOCK_FREE;
+    block_trim(tlsf, block, adjust);
+    return block_to_ptr(block);
+}
+
+void *mbed_tlsf_realloc(mbed_tlsf_t *tlsf, void *ptr, size_t size)
+{
+    if (!ptr) {
+        return mbed_tlsf_malloc(tlsf, size);
+    }
+    if (size == 0) {
+        mbed_tlsf_free(tlsf, ptr);
+        return NULL;
+    }
+
+    block_t *block = block_from_ptr(ptr);
+    size_t current = block_size(block);
+    size_t adjust = adjust_size(size);
+    if (!adjust) {
+        return NULL;
+    }
+
+    if (adjust > current) {
+        block_t *next = block_next(block);
+        size_t combined = current + BLOCK_HEADER + block_size(next);
+        if (!block_is_free(next) || combined < adjust || combined > BLOCK_MAX) {
+            void *moved = mbed_tlsf_malloc(tlsf, size);
+            if (moved) {
+                memcpy(moved, ptr, current);
+                mbed_tlsf_free(tlsf, ptr);
+            }
+            return moved;
+        }
+        // grow into the free block after it
+        block_remove(tlsf, next);
+        block->size = combined;
+        block_next(block)->prev_phys = block;
+    }
+
+    block_trim(tlsf, block, adjust);
+    return ptr;
+}
+
+void mbed_tlsf_free(mbed_tlsf_t *tlsf, void *ptr)
+{
+    if (!ptr) {
+        return;
+    }
+    block_t *block = block_from_ptr(ptr);
+    block->size |= BLOCK_FREE;
+
+    block_t *prev = block->prev_phys;
+    if (prev && block_is_free(prev) && block_size(prev) + BLOCK_HEADER + block_size(block) <= BLOCK_MAX) {
+        block_remove(tlsf, prev);
+        prev->size = (block_size(prev) + BLOCK_HEADER + block_size(block)) | BLOCK_FREE;
+        block = prev;
+        block_next(block)->prev_phys = block;
+    }
+    block_insert(tlsf, block_merge_next(tlsf, block));
+}
+
+size_t mbed_tlsf_pool_size(size_t align, size_t size)
+{
+    // the same search mbed_tlsf_memalign does
+    size_t search = adjust_size(size);
+    if (search && align > ALIGN) {
+        search = align < BLOCK_MAX ? search + align + BLOCK_HEADER + BLOCK_MIN : 0;
+    }
+    if (search >= SMALL_BLOCK) {
+        search += ((size_t)1 << (fls_u32(search) - MBED_TLSF_SL_LOG2)) - 1;
+    }
+    if (!search || search > BLOCK_MAX) {
+        return 0;
+    }
+    return align_up(search, ALIGN) + MBED_TLSF_POOL_OVERHEAD;
+}
+
+size_t mbed_tlsf_block_size(void *ptr)
+{
+    return block_size(block_from_ptr(ptr));
+}
+
+void mbed_tlsf_stats(mbed_tlsf_t *tlsf, uint32_t *free_size, uint32_t *free_block_cnt, uint32_t *largest_size)
+{
+    *free_size = 0;
+    *free_block_cnt = 0;
+    *largest_size = 0;
+    for (int fl = 0; fl < MBED_TLSF_FL_COUNT; fl++) {
+        for (int sl = 0; sl < MBED_TLSF_SL_COUNT; sl++) {
+            for (block_t *block = tlsf->blocks[fl][sl]; block; block = block->next_free) {
+                *free_size += block_size(block);
+                *free_block_cnt += 1;
+                if (block_size(block) > *largest_size) {
+                    *largest_size = block_size(block);
+                }
+            }
+        }
+    }
+}
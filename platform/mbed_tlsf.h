@@ -0,0 +1,158 @@
+/** \addtogroup platform */
+/** @{*/
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MBED_TLSF_H
+#define MBED_TLSF_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Two-level segregated fit allocator
+ *
+ * Free blocks are kept in lists by size class: a first level of power of
+ * two ranges, each split into MBED_TLSF_SL_COUNT linear second level
+ * classes, with a bitmap of the non-empty lists at each level. Finding a
+ * block takes two find-first-set operations and freeing one merges it with
+ * its neighbours in memory right away, so both take bounded time whatever
+ * the state of the heap, and fragmentation stays low.
+ *
+ * Blocks are 8 byte aligned, each has 8 bytes of overhead and is smaller
+ * than 2^MBED_TLSF_FL_MAX bytes. An allocator is not thread safe, the
+ * caller has to lock around it.
+ *
+ * The mbed_alloc_wrappers use it for malloc when the platform.tlsf-heap
+ * configuration option is set.
+ */
+
+#define MBED_TLSF_SL_LOG2       3
+#define MBED_TLSF_SL_COUNT      (1 << MBED_TLSF_SL_LOG2)
+#define MBED_TLSF_FL_SHIFT      (MBED_TLSF_SL_LOG2 + 3)
+#define MBED_TLSF_FL_MAX        24
+#define MBED_TLSF_FL_COUNT      (MBED_TLSF_FL_MAX - MBED_TLSF_FL_SHIFT + 1)
+
+/* Bytes of a pool not available to allocations */
+#define MBED_TLSF_POOL_OVERHEAD (4 * sizeof(void *) + 8)
+
+struct mbed_tlsf_block;
+
+/** Allocator state, all zero is a valid allocator without pools */
+typedef struct {
+    uint32_t fl_bitmap;
+    uint32_t sl_bitmap[MBED_TLSF_FL_COUNT];
+    struct mbed_tlsf_block *blocks[MBED_TLSF_FL_COUNT][MBED_TLSF_SL_COUNT];
+    char *pool_end;
+} mbed_tlsf_t;
+
+/**
+ * Initialize an allocator without pools
+ *
+ * @param tlsf The allocator
+ */
+void mbed_tlsf_init(mbed_tlsf_t *tlsf);
+
+/**
+ * Give memory to an allocator
+ *
+ * Memory starting where the last pool added ends is merged with it.
+ *
+ * @param tlsf The allocator
+ * @param mem  The start of the memory
+ * @param size The size of the memory in bytes
+ * @return 0 on success, or -1 if the memory is too small to hold a block
+ */
+int mbed_tlsf_add_pool(mbed_tlsf_t *tlsf, void *mem, size_t size);
+
+/**
+ * Allocate a block
+ *
+ * As with malloc, a size of zero still returns a unique block.
+ *
+ * @param tlsf The allocator
+ * @param size The size in bytes
+ * @return The block, or NULL if no free block is large enough
+ */
+void *mbed_tlsf_malloc(mbed_tlsf_t *tlsf, size_t size);
+
+/**
+ * Allocate an aligned block
+ *
+ * @param tlsf  The allocator
+ * @param align The alignment, a power of two
+ * @param size  The size in bytes
+ * @return The block, or NULL if no free block is large enough
+ */
+void *mbed_tlsf_memalign(mbed_tlsf_t *tlsf, size_t align, size_t size);
+
+/**
+ * Resize a block, in place if the block or a free neighbour is large enough
+ *
+ * @param tlsf The allocator
+ * @param ptr  The block, or NULL to allocate a new one
+ * @param size The new size in bytes, or zero to free the block
+ * @return The resized block, or NULL if it could not be resized and is unchanged
+ */
+void *mbed_tlsf_realloc(mbed_tlsf_t *tlsf, void *ptr, size_t size);
+
+/**
+ * Free a block
+ *
+ * @param tlsf The allocator
+ * @param ptr  The block, or NULL to do nothing
+ */
+void mbed_tlsf_free(mbed_tlsf_t *tlsf, void *ptr);
+
+/**
+ * Get the usable size of a block, at least the size it was allocated with
+ *
+ * @param ptr The block
+ */
+size_t mbed_tlsf_block_size(void *ptr);
+
+/**
+ * Get the size of a pool that can always hold an allocation
+ *
+ * Allocations are only taken from size classes all of whose blocks are
+ * large enough, so this is rounded up to the next size class.
+ *
+ * @param align The alignment, a power of two, or 0 for the default
+ * @param size  The size in bytes
+ * @return The pool size in bytes, or 0 if the allocation is too large
+ */
+size_t mbed_tlsf_pool_size(size_t align, size_t size);
+
+/**
+ * Get statistics of the free blocks of an allocator
+ *
+ * @param tlsf           The allocator
+ * @param free_size      Filled in with the bytes in free blocks
+ * @param free_block_cnt Filled in with the number of free blocks
+ * @param largest_size   Filled in with the size of the largest free block
+ */
+void mbed_tlsf_stats(mbed_tlsf_t *tlsf, uint32_t *free_size, uint32_t *free_block_cnt, uint32_t *largest_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+/** @}*/
@@ -305,6 +305,52 @@
 #endif
 #endif
 
+/** MBED_RAMFUNC
+ *  Declare a function that runs from RAM, without the wait states of
+ *  flash, such as an interrupt handler or a checksum loop on a hot path.
+ *
+ *  With GCC and the ARM compilers the function is placed in section
+ *  ".ramfunc", which the target linker script assigns to RAM or ITCM and
+ *  lists in the boot copy table. On targets whose linker script does not
+ *  mention the section, the function stays in flash. IAR uses __ramfunc,
+ *  which the startup code copies like other initialised data.
+ *
+ *  @note The function must not be called before the C library initialisation,
+ *  for instance from SystemInit.
+ *
+ *  @code
+ *  #include "mbed_toolchain.h"
+ *
+ *  MBED_RAMFUNC void foo() {
+ *
+ *  }
+ *  @endcode
+ */
+#ifndef MBED_RAMFUNC
+#if defined(__ICCARM__)
+#define MBED_RAMFUNC __ramfunc
+#elif defined(__GNUC__) || defined(__clang__) || defined(__CC_ARM)
+#define MBED_RAMFUNC __attribute__((section(".ramfunc"), noinline))
+#else
+#define MBED_RAMFUNC
+#endif
+#endif
+
+/** MBED_TCM_DATA
+ *  Declare a variable that is placed in tightly coupled data memory (DTCM
+ *  or CCM) when the target has some, and in RAM otherwise. The variable is
+ *  initialised as if it were in .data.
+ *
+ *  @code
+ *  #include "mbed_toolchain.h"
+ *
+ *  MBED_TCM_DATA static uint32_t table[64];
+ *  @endcode
+ */
+#ifndef MBED_TCM_DATA
+#define MBED_TCM_DATA MBED_SECTION(".data.tcm")
+#endif
+
 #ifndef MBED_PRINTF
 #if defined(__GNUC__) || defined(__CC_ARM)
 #define MBED_PRINTF(format_idx, first_param_idx) __attribute__ ((__format__(__printf__, format_idx, first_param_idx)))
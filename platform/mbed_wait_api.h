@@ -63,6 +63,16 @@ void wait_ms(int ms);
  */
 void wait_us(int us);
 
+/** Waits at least a number of nanoseconds.
+ *
+ *  Waits on the CPU cycle counter, so the wait is accurate to a few cycles
+ *  on cores with a DWT cycle counter. Elsewhere the wait is rounded up to
+ *  a whole number of microseconds.
+ *
+ *  @param ns the whole number of nanoseconds to wait
+ */
+void wait_ns(unsigned int ns);
+
 #ifdef __cplusplus
 }
 #endif
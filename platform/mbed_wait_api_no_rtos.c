@@ -20,6 +20,7 @@
 
 #include "platform/mbed_wait_api.h"
 #include "hal/us_ticker_api.h"
+#include "platform/mbed_cycle_counter.h"
 
 void wait(float s) {
     wait_us(s * 1000000.0f);
@@ -30,9 +31,18 @@ void wait_ms(int ms) {
 }
 
 void wait_us(int us) {
+    // The cycle counter is cheaper to read than the us_ticker
+    if (mbed_cycle_counter_precise() && us >= 0 && us < 1000) {
+        mbed_cycle_counter_wait(mbed_cycle_counter_from_ns(us * 1000));
+        return;
+    }
     uint32_t start = us_ticker_read();
     while ((us_ticker_read() - start) < (uint32_t)us);
 }
 
+void wait_ns(unsigned int ns) {
+    mbed_cycle_counter_wait(mbed_cycle_counter_from_ns(ns));
+}
+
 #endif // #ifndef MBED_CONF_RTOS_PRESENT
 
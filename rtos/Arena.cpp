@@ -0,0 +1,93 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2006-2012 ARM Limited
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "rtos/Arena.h"
+
+#include <string.h>
+
+#define ARENA_ALIGN 8
+
+namespace rtos {
+
+Arena::Arena(void *buffer, size_t size)
+    : _used(0), _max_used(0), _fail_count(0) {
+    uintptr_t start = ((uintptr_t)buffer + ARENA_ALIGN-1) & ~(uintptr_t)(ARENA_ALIGN-1);
+    size_t skip = start - (uintptr_t)buffer;
+
+    _buffer = (uint8_t*)start;
+    _size = size > skip ? size - skip : 0;
+}
+
+void *Arena::alloc(size_t size) {
+    size_t padded = (size + ARENA_ALIGN-1) & ~(size_t)(ARENA_ALIGN-1);
+    if (padded < size || padded > _size - _used) {
+        _fail_count++;
+        return NULL;
+    }
+
+    void *p = &_buffer[_used];
+    _used += padded;
+    if (_used > _max_used) {
+        _max_used = _used;
+    }
+
+    return p;
+}
+
+void *Arena::calloc(size_t size) {
+    void *p = alloc(size);
+    if (p != NULL) {
+        memset(p, 0, size);
+    }
+    return p;
+}
+
+void Arena::reset() {
+    _used = 0;
+}
+
+size_t Arena::used() const {
+    return _used;
+}
+
+size_t Arena::max_used() const {
+    return _max_used;
+}
+
+size_t Arena::size() const {
+    return _size;
+}
+
+uint32_t Arena::fail_count() const {
+    return _fail_count;
+}
+
+Arena::Scope::Scope(Arena *arena)
+    : _arena(arena), _mark(arena ? arena->_used : 0) {
+}
+
+Arena::Scope::~Scope() {
+    if (_arena) {
+        _arena->_used = _mark;
+    }
+}
+
+}
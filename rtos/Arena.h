@@ -0,0 +1,136 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2006-2012 ARM Limited
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "platform/NonCopyable.h"
+
+namespace rtos {
+/** \addtogroup rtos */
+/** @{*/
+
+/** The Arena class is a bump allocator for short-lived allocations.
+
+ An Arena hands out memory from a buffer by moving a pointer forward, and releases all of it at
+ once with reset, or everything allocated within a Scope when the Scope ends. There is no per
+ allocation free, no locking and no fragmentation.
+
+ An Arena is not thread safe and is meant to be used by a single thread. Attaching it to its thread
+ with Thread::set_arena lets code running in that thread find it with Thread::arena.
+
+ Example:
+ @code
+ static uint8_t scratch[1024];
+ Arena arena(scratch, sizeof(scratch));
+ Thread worker;
+
+ // handle_message allocates with Thread::arena()->alloc(size)
+ void worker_loop() {
+     while (true) {
+         Arena::Scope scope(Thread::arena());
+         handle_message();
+     }
+ }
+
+ int main() {
+     worker.set_arena(&arena);
+     worker.start(worker_loop);
+ }
+ @endcode
+*/
+class Arena : private mbed::NonCopyable<Arena> {
+public:
+    /** Create an Arena on a buffer
+      @param   buffer  memory to allocate from, it has to stay allocated for the lifetime of the Arena.
+      @param   size    size of the buffer in bytes.
+    */
+    Arena(void *buffer, size_t size);
+
+    /** Allocate memory from the Arena, aligned to 8 bytes
+      @param   size  number of bytes to allocate.
+      @return  pointer to the allocated memory or NULL if the Arena is exhausted.
+    */
+    void *alloc(size_t size);
+
+    /** Allocate memory from the Arena and set it to zero
+      @param   size  number of bytes to allocate.
+      @return  pointer to the allocated memory or NULL if the Arena is exhausted.
+    */
+    void *calloc(size_t size);
+
+    /** Release all memory allocated from the Arena */
+    void reset();
+
+    /** Get the number of bytes currently allocated
+      @return  bytes allocated, including alignment padding.
+    */
+    size_t used() const;
+
+    /** Get the maximum number of bytes allocated at a given time
+      @return  high-water mark of used().
+    */
+    size_t max_used() const;
+
+    /** Get the size of the Arena
+      @return  size of the buffer in bytes, less any bytes lost aligning its start.
+    */
+    size_t size() const;
+
+    /** Get the number of failed allocations
+      @return  number of allocations that did not fit in the Arena.
+    */
+    uint32_t fail_count() const;
+
+    /** The Scope class releases everything allocated from an Arena during its lifetime.
+
+     Scopes can be nested, an inner scope only releases what was allocated since it was created.
+    */
+    class Scope : private mbed::NonCopyable<Scope> {
+    public:
+        /** Start a scope
+          @param   arena  Arena to release allocations from when the scope ends. (can be NULL).
+        */
+        Scope(Arena *arena);
+
+        /** End the scope, releasing allocations made since it started */
+        ~Scope();
+
+    private:
+        Arena *_arena;
+        size_t _mark;
+    };
+
+private:
+    uint8_t *_buffer;
+    size_t _size;
+    size_t _used;
+    size_t _max_used;
+    uint32_t _fail_count;
+};
+
+}
+#endif
+
+/** @}*/
@@ -45,11 +45,20 @@ void EventFlags::constructor(const char *name)
     _attr.cb_size = sizeof(_obj_mem);
     _id = osEventFlagsNew(&_attr);
     MBED_ASSERT(_id);
+    _wait_set = NULL;
+    _wait_set_flag = 0;
 }
 
 uint32_t EventFlags::set(uint32_t flags)
 {
-    return osEventFlagsSet(_id, flags);
+    uint32_t res = osEventFlagsSet(_id, flags);
+
+    EventFlags *wait_set = _wait_set;
+    if (!(res & osFlagsError) && wait_set != NULL) {
+        wait_set->set(_wait_set_flag);
+    }
+
+    return res;
 }
 
 uint32_t EventFlags::clear(uint32_t flags)
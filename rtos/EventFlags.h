@@ -33,6 +33,8 @@ namespace rtos {
 /** \addtogroup rtos */
 /** @{*/
 
+class WaitSet;
+
 /** The EventFlags class is used to signal or wait for an arbitrary event or events.
  @note 
  EventFlags support 31 flags so the MSB flag is ignored, it is used to return an error code (@a osFlagsError)
@@ -87,11 +89,15 @@ public:
     ~EventFlags();
 
 private:
+    friend class WaitSet;
+
     void constructor(const char *name = NULL);
     uint32_t wait(uint32_t flags, uint32_t opt, uint32_t timeout, bool clear);
     osEventFlagsId_t                _id;
     osEventFlagsAttr_t              _attr;
     mbed_rtos_storage_event_flags_t _obj_mem;
+    EventFlags * volatile           _wait_set;
+    uint32_t                        _wait_set_flag;
 };
 
 }
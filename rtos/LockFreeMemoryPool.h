@@ -0,0 +1,156 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2006-2012 ARM Limited
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef LOCKFREEMEMORYPOOL_H
+#define LOCKFREEMEMORYPOOL_H
+
+#include <stdint.h>
+#include <string.h>
+
+#include "cmsis_os2.h"
+#include "mbed_rtos1_types.h"
+#include "platform/mbed_assert.h"
+#include "platform/mbed_critical.h"
+#include "platform/NonCopyable.h"
+
+namespace rtos {
+/** \addtogroup rtos */
+/** @{*/
+
+/** Define and manage fixed-size memory pools of objects of a given type without entering the kernel.
+
+ LockFreeMemoryPool has the same interface as MemoryPool, but the free blocks are kept on a lock-free
+ stack updated with atomic compare-and-swap, so alloc and free are constant-time and neither makes an
+ SVC call. They can be called from thread and interrupt context alike.
+
+ free always rejects blocks that do not belong to the pool. Enabling rtos.lock-free-pool-debug also tracks
+ which blocks are allocated, so free rejects blocks that are already free.
+
+  @tparam  T         data type of a single object (element).
+  @tparam  pool_sz   maximum number of objects (elements) in the memory pool.
+
+ @note
+ Memory considerations: The memory pool data store and control structures will be created on current thread's stack,
+ both for the mbed OS and underlying RTOS objects (static or dynamic RTOS memory pools are not being used).
+*/
+template<typename T, uint32_t pool_sz>
+class LockFreeMemoryPool : private mbed::NonCopyable<LockFreeMemoryPool<T, pool_sz> > {
+    MBED_STATIC_ASSERT(pool_sz > 0, "Invalid memory pool size. Must be greater than 0.");
+    MBED_STATIC_ASSERT(pool_sz < 0xffff, "Invalid memory pool size. Must be less than 65535.");
+public:
+    /** Create and Initialize a memory pool. */
+    LockFreeMemoryPool() {
+        memset(_pool_mem, 0, sizeof(_pool_mem));
+        for (uint32_t i = 0; i < pool_sz; i++) {
+            _next[i] = i + 1 < pool_sz ? i + 1 : NONE;
+        }
+#if MBED_CONF_RTOS_LOCK_FREE_POOL_DEBUG
+        memset(_allocated, 0, sizeof(_allocated));
+#endif
+        _head = 0;
+    }
+
+    /** Allocate a memory block of type T from a memory pool.
+      @return  address of the allocated memory block or NULL in case of no memory available.
+    */
+    T* alloc(void) {
+        uint32_t head = _head;
+        uint32_t i;
+
+        do {
+            i = head & NONE;
+            if (i == NONE) {
+                return NULL;
+            }
+        } while (!core_util_atomic_cas_u32(&_head, &head, retag(head, _next[i])));
+
+#if MBED_CONF_RTOS_LOCK_FREE_POOL_DEBUG
+        _allocated[i] = 1;
+#endif
+        return block(i);
+    }
+
+    /** Allocate a memory block of type T from a memory pool and set memory block to zero.
+      @return  address of the allocated memory block or NULL in case of no memory available.
+    */
+    T* calloc(void) {
+        T *item = alloc();
+        if (item != NULL) {
+            memset(item, 0, sizeof(T));
+        }
+        return item;
+    }
+
+    /** Free a memory block.
+      @param   block  address of the allocated memory block to be freed.
+      @return         osOK on successful deallocation, osErrorParameter if given memory block id
+                      is NULL or invalid, or osErrorResource if given memory block is already
+                      free (only detected with rtos.lock-free-pool-debug).
+    */
+    osStatus free(T *block) {
+        uintptr_t offset = (uintptr_t)block - (uintptr_t)_pool_mem;
+        if (block == NULL || offset >= sizeof(_pool_mem) || offset % sizeof(_pool_mem[0])) {
+            return osErrorParameter;
+        }
+        uint32_t i = offset / sizeof(_pool_mem[0]);
+
+#if MBED_CONF_RTOS_LOCK_FREE_POOL_DEBUG
+        uint8_t allocated = 1;
+        if (!core_util_atomic_cas_u8(&_allocated[i], &allocated, 0)) {
+            return osErrorResource;
+        }
+#endif
+
+        uint32_t head = _head;
+        do {
+            _next[i] = head & NONE;
+        } while (!core_util_atomic_cas_u32(&_head, &head, retag(head, i)));
+
+        return osOK;
+    }
+
+private:
+    static const uint32_t NONE = 0xffff;
+
+    // the head holds the index of the first free block in the low half and
+    // a tag in the high half, the tag changes on every update so a compare
+    // and swap can not succeed on a head that was popped and pushed back
+    static uint32_t retag(uint32_t head, uint32_t i) {
+        return ((head + 0x10000) & ~NONE) | i;
+    }
+
+    T *block(uint32_t i) {
+        return (T*)&_pool_mem[i];
+    }
+
+    uint32_t _head;
+    uint16_t _next[pool_sz];
+#if MBED_CONF_RTOS_LOCK_FREE_POOL_DEBUG
+    uint8_t _allocated[pool_sz];
+#endif
+    /* blocks are rounded up to a multiple of 4 bytes like in MemoryPool */
+    uint32_t _pool_mem[pool_sz][(sizeof(T) + 3) / 4];
+};
+
+}
+#endif
+
+/** @}*/
@@ -0,0 +1,248 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2006-2017 ARM Limited
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef MAIL_RING_H
+#define MAIL_RING_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "EventFlags.h"
+#include "cmsis_os2.h"
+#include "mbed_rtos1_types.h"
+
+#include "platform/mbed_critical.h"
+#include "platform/NonCopyable.h"
+
+namespace rtos {
+/** \addtogroup rtos */
+/** @{*/
+
+/** The MailRing class is a Mail variant that passes messages through a ring buffer of
+ in-place slots. Producers fill a slot returned by alloc and publish it with put, consumers
+ read it in place after get and release it with free.
+
+ Unlike Mail, which makes a kernel call for each of alloc, put, get and free, a MailRing only
+ enters the kernel to wake up the consumer when the ring becomes non-empty, and when the
+ consumer has to block. Slots are handed out and returned with a short critical section, and
+ a batched get drains several messages per wakeup.
+
+ Messages are delivered in the order their slots were allocated. A message whose slot was
+ allocated earlier but not yet put holds back the messages behind it.
+
+  @tparam  T         data type of a single message element.
+  @tparam  queue_sz  maximum number of messages in the ring.
+
+ @note
+ alloc, calloc and put are interrupt safe, get must be called from a thread. free may be
+ called from any context.
+ @note
+ Memory considerations: The ring buffer and control structures will be created on current thread's stack,
+ both for the mbed OS and underlying RTOS objects (static or dynamic RTOS memory pools are not being used).
+*/
+template<typename T, uint32_t queue_sz>
+class MailRing : private mbed::NonCopyable<MailRing<T, queue_sz> > {
+public:
+    /** Create and Initialise a MailRing. */
+    MailRing() : _alloc(0), _put(0), _get(0), _free(0) {
+        memset(_state, 0, sizeof(_state));
+    }
+
+    /** Allocate a slot of type T at the back of the ring
+      @return  pointer to a slot that can be filled with mail or NULL if the ring is full.
+    */
+    T* alloc() {
+        T *mptr = NULL;
+
+        core_util_critical_section_enter();
+        if (distance(_alloc, _free) < queue_sz) {
+            uint32_t i = index(_alloc);
+            _state[i] = STATE_ALLOCATED;
+            mptr = &_ring[i];
+            _alloc = next(_alloc);
+        }
+        core_util_critical_section_exit();
+
+        return mptr;
+    }
+
+    /** Allocate a slot of type T at the back of the ring and set it to zero.
+      @return  pointer to a slot that can be filled with mail or NULL if the ring is full.
+    */
+    T* calloc() {
+        T *mptr = alloc();
+        if (mptr) {
+            memset(mptr, 0, sizeof(T));
+        }
+        return mptr;
+    }
+
+    /** Put a mail in the ring.
+      @param   mptr  slot previously allocated with MailRing::alloc or MailRing::calloc.
+      @return  status code that indicates the execution status of the function.
+    */
+    osStatus put(T *mptr) {
+        uint32_t i = mptr - _ring;
+        if (i >= queue_sz) {
+            return osErrorParameter;
+        }
+
+        core_util_critical_section_enter();
+        bool empty = _put == _get;
+        _state[i] = STATE_READY;
+        while (_put != _alloc && _state[index(_put)] == STATE_READY) {
+            _put = next(_put);
+        }
+        bool wakeup = empty && _put != _get;
+        core_util_critical_section_exit();
+
+        // only the transition out of empty needs to wake up the consumer
+        if (wakeup) {
+            _flags.set(FLAG_READY);
+        }
+
+        return osOK;
+    }
+
+    /** Get a mail from the ring.
+      @param   millisec  timeout value or 0 in case of no time-out. (default: osWaitForever).
+      @return  event that contains mail information or error code.
+    */
+    osEvent get(uint32_t millisec=osWaitForever) {
+        osEvent evt;
+        T *mptr;
+
+        if (get(&mptr, 1, millisec)) {
+            evt.status = osEventMail;
+            evt.value.p = mptr;
+        } else {
+            evt.status = millisec ? osEventTimeout : osOK;
+            evt.value.p = NULL;
+        }
+
+        return evt;
+    }
+
+    /** Get up to count mails from the ring.
+
+      Blocks until at least one mail is available, then takes every available mail up to count
+      without blocking again.
+
+      @param   mptrs     array to store the pointers to the mails in.
+      @param   count     maximum number of mails to get.
+      @param   millisec  timeout value or 0 in case of no time-out. (default: osWaitForever).
+      @return  number of mails stored in mptrs, 0 in case of time-out.
+    */
+    size_t get(T **mptrs, size_t count, uint32_t millisec=osWaitForever) {
+        uint32_t start = osKernelGetTickCount();
+
+        while (true) {
+            size_t n = 0;
+
+            core_util_critical_section_enter();
+            while (n < count && _get != _put) {
+                uint32_t i = index(_get);
+                _state[i] = STATE_TAKEN;
+                mptrs[n++] = &_ring[i];
+                _get = next(_get);
+            }
+            core_util_critical_section_exit();
+
+            if (n > 0 || count == 0) {
+                return n;
+            }
+
+            // the flag may be left over from mails that were already taken,
+            // so the ring is checked again after every wakeup
+            uint32_t timeout = millisec;
+            if (millisec != osWaitForever) {
+                uint32_t elapsed = osKernelGetTickCount() - start;
+                if (elapsed >= millisec) {
+                    return 0;
+                }
+                timeout = millisec - elapsed;
+            }
+
+            uint32_t flags = _flags.wait_any(FLAG_READY, timeout);
+            if (flags & osFlagsError) {
+                return 0;
+            }
+        }
+    }
+
+    /** Free a slot from a mail.
+      @param   mptr  pointer to the slot that was obtained with MailRing::get.
+      @return  status code that indicates the execution status of the function.
+    */
+    osStatus free(T *mptr) {
+        uint32_t i = mptr - _ring;
+        if (i >= queue_sz || _state[i] != STATE_TAKEN) {
+            return osErrorParameter;
+        }
+
+        core_util_critical_section_enter();
+        _state[i] = STATE_FREE;
+        while (_free != _get && _state[index(_free)] == STATE_FREE) {
+            _free = next(_free);
+        }
+        core_util_critical_section_exit();
+
+        return osOK;
+    }
+
+private:
+    enum {
+        STATE_FREE,
+        STATE_ALLOCATED,
+        STATE_READY,
+        STATE_TAKEN,
+    };
+
+    static const uint32_t FLAG_READY = 0x1;
+
+    // positions run over twice the ring size, so a full ring can be told
+    // apart from an empty one
+    static uint32_t next(uint32_t pos) {
+        return pos + 1 == 2*queue_sz ? 0 : pos + 1;
+    }
+
+    static uint32_t index(uint32_t pos) {
+        return pos < queue_sz ? pos : pos - queue_sz;
+    }
+
+    static uint32_t distance(uint32_t a, uint32_t b) {
+        return a >= b ? a - b : a + 2*queue_sz - b;
+    }
+
+    T _ring[queue_sz];
+    uint8_t _state[queue_sz];
+    uint32_t _alloc;
+    uint32_t _put;
+    uint32_t _get;
+    uint32_t _free;
+    EventFlags _flags;
+};
+
+}
+#endif
+
+/** @}*/
@@ -25,6 +25,15 @@
 #include "mbed_error.h"
 #include "mbed_assert.h"
 
+#if MBED_CONF_RTOS_MUTEX_FAST_PATH && defined(MBED_OS_BACKEND_RTX5) && \
+    !(defined(FEATURE_UVISOR) && defined(TARGET_UVISOR_SUPPORTED))
+#define MUTEX_FAST_PATH 1
+#include "mbed_critical.h"
+extern "C" {
+#include "rtx_lib.h"
+}
+#endif
+
 namespace rtos {
 
 Mutex::Mutex()
@@ -49,15 +58,78 @@ void Mutex::constructor(const char *name)
     MBED_ASSERT(_id);
 }
 
+#ifdef MUTEX_FAST_PATH
+// Acquiring a free mutex, or one already held by the running thread, never
+// blocks, so the kernel's handler can run with interrupts masked instead of
+// trapping into it with an SVC. The kernel still does all of the bookkeeping,
+// so priority inheritance and recursion behave as with osMutexAcquire.
+static bool fast_acquire(osMutexId_t id, os_mutex_t *mutex, osStatus_t *status) {
+    if (core_util_is_isr_active() || !core_util_are_interrupts_enabled()) {
+        return false;
+    }
+
+    bool done = false;
+    core_util_critical_section_enter();
+    os_thread_t *running = osRtxThreadGetRunning();
+    if (running != NULL && (mutex->lock == 0U || mutex->owner_thread == running)) {
+        *status = svcRtxMutexAcquire(id, 0);
+        done = true;
+    }
+    core_util_critical_section_exit();
+
+    return done;
+}
+
+// Releasing a mutex without waiters does not wake any thread, and can not
+// change the running thread's priority while it runs at its base priority,
+// so no reschedule is needed and the same shortcut applies.
+static bool fast_release(osMutexId_t id, os_mutex_t *mutex, osStatus_t *status) {
+    if (core_util_is_isr_active() || !core_util_are_interrupts_enabled()) {
+        return false;
+    }
+
+    bool done = false;
+    core_util_critical_section_enter();
+    os_thread_t *running = osRtxThreadGetRunning();
+    if (running != NULL && mutex->owner_thread == running &&
+            (mutex->lock > 1U || (mutex->thread_list == NULL &&
+            running->priority == running->priority_base))) {
+        *status = svcRtxMutexRelease(id);
+        done = true;
+    }
+    core_util_critical_section_exit();
+
+    return done;
+}
+#endif
+
 osStatus Mutex::lock(uint32_t millisec) {
+#ifdef MUTEX_FAST_PATH
+    osStatus_t status;
+    if (fast_acquire(_id, &_obj_mem, &status)) {
+        return status;
+    }
+#endif
     return osMutexAcquire(_id, millisec);
 }
 
 bool Mutex::trylock() {
+#ifdef MUTEX_FAST_PATH
+    osStatus_t status;
+    if (fast_acquire(_id, &_obj_mem, &status)) {
+        return status == osOK;
+    }
+#endif
     return (osMutexAcquire(_id, 0) == osOK);
 }
 
 osStatus Mutex::unlock() {
+#ifdef MUTEX_FAST_PATH
+    osStatus_t status;
+    if (fast_release(_id, &_obj_mem, &status)) {
+        return status;
+    }
+#endif
     return osMutexRelease(_id);
 }
 
@@ -30,11 +30,14 @@
 #include "platform/mbed_error.h"
 #include "platform/NonCopyable.h"
 #include "mbed_rtos1_types.h"
+#include "rtos/EventFlags.h"
 
 namespace rtos {
 /** \addtogroup rtos */
 /** @{*/
 
+class WaitSet;
+
 /** The Queue class allow to control, send, receive, or wait for messages.
  A message can be a integer or pointer value  to a certain type T that is send
  to a thread or interrupt service routine.
@@ -58,6 +61,10 @@ public:
         _attr.cb_size = sizeof(_obj_mem);
         _id = osMessageQueueNew(queue_sz, sizeof(T*), &_attr);
         MBED_ASSERT(_id);
+        _waiter = NULL;
+        _waiter_count = 0;
+        _wait_set = NULL;
+        _wait_set_flag = 0;
     }
 
     ~Queue() {
@@ -75,7 +82,38 @@ public:
                @a osErrorParameter internal error or non-zero timeout specified in an ISR.
     */
     osStatus put(T* data, uint32_t millisec=0, uint8_t prio=0) {
-        return osMessageQueuePut(_id, &data, prio, millisec);
+        osStatus_t res = osMessageQueuePut(_id, &data, prio, millisec);
+        if (res == osOK) {
+            notify_waiter();
+        }
+        return res;
+    }
+
+    /** Put several messages in a Queue.
+      @param   data      array of message pointers.
+      @param   count     number of messages in data.
+      @param   millisec  total timeout for waiting for space in the queue or 0 in case of no time-out. (default: 0)
+      @param   prio      priority value or 0 in case of default. (default: 0)
+      @return  number of messages put into the queue, from the start of data.
+
+      @note A thread waiting in get_many for a minimum number of messages is woken at most once per call.
+    */
+    uint32_t put_many(T **data, uint32_t count, uint32_t millisec=0, uint8_t prio=0) {
+        uint32_t start = osKernelGetTickCount();
+        uint32_t n = 0;
+
+        while (n < count) {
+            uint32_t timeout = remaining(start, millisec);
+            if (osMessageQueuePut(_id, &data[n], prio, timeout) != osOK) {
+                break;
+            }
+            n++;
+        }
+
+        if (n > 0) {
+            notify_waiter();
+        }
+        return n;
     }
 
     /** Get a message or Wait for a message from a Queue. Messages are retrieved in a descending priority order or
@@ -113,7 +151,94 @@ public:
         return event;
     }
 
+    /** Get several messages from a Queue in one wakeup.
+
+      Waits until at least min_count messages are queued or the timeout expires, then takes every
+      queued message up to max. While waiting for more than one message, the thread is woken once
+      the queue holds min_count messages instead of once per message.
+
+      @param   data       array to store the message pointers in.
+      @param   max        maximum number of messages to get.
+      @param   millisec   timeout value or 0 in case of no time-out. (default: osWaitForever).
+      @param   min_count  number of messages to wait for. (default: 1).
+      @return  number of messages stored in data, less than min_count if the timeout expired.
+
+      @note While waiting for more than one message, thread flag 0x40000000 of the calling thread
+            is used for wakeups, and may be left set once get_many returns.
+      @note Only one thread at a time may wait for more than one message.
+      @note This function cannot be called from an interrupt service routine with a timeout.
+    */
+    uint32_t get_many(T **data, uint32_t max, uint32_t millisec=osWaitForever, uint32_t min_count=1) {
+        uint32_t start = osKernelGetTickCount();
+        if (min_count > max) {
+            min_count = max;
+        }
+
+        uint32_t n = drain(data, 0, max);
+        if (n >= min_count || millisec == 0) {
+            return n;
+        }
+
+        if (min_count - n == 1) {
+            // a single blocking get wakes us for the first message
+            if (osMessageQueueGet(_id, &data[n], NULL, millisec) == osOK) {
+                n = drain(data, n + 1, max);
+            }
+            return n;
+        }
+
+        osThreadFlagsClear(WAITER_FLAG);
+        _waiter_count = min_count - n;
+        _waiter = osThreadGetId();
+
+        // messages put before the waiter was visible did not notify us
+        if (osMessageQueueGetCount(_id) < _waiter_count) {
+            osThreadFlagsWait(WAITER_FLAG, osFlagsWaitAny, remaining(start, millisec));
+        }
+
+        _waiter = NULL;
+        osThreadFlagsClear(WAITER_FLAG);
+
+        return drain(data, n, max);
+    }
+
 private:
+    friend class WaitSet;
+
+    static const uint32_t WAITER_FLAG = 0x40000000;
+
+    static uint32_t remaining(uint32_t start, uint32_t millisec) {
+        if (millisec == 0 || millisec == osWaitForever) {
+            return millisec;
+        }
+
+        uint32_t elapsed = osKernelGetTickCount() - start;
+        return elapsed < millisec ? millisec - elapsed : 0;
+    }
+
+    uint32_t drain(T **data, uint32_t n, uint32_t max) {
+        while (n < max && osMessageQueueGet(_id, &data[n], NULL, 0) == osOK) {
+            n++;
+        }
+        return n;
+    }
+
+    void notify_waiter() {
+        osThreadId_t waiter = _waiter;
+        if (waiter != NULL && osMessageQueueGetCount(_id) >= _waiter_count) {
+            osThreadFlagsSet(waiter, WAITER_FLAG);
+        }
+
+        EventFlags *wait_set = _wait_set;
+        if (wait_set != NULL) {
+            wait_set->set(_wait_set_flag);
+        }
+    }
+
+    osThreadId_t volatile         _waiter;
+    uint32_t volatile             _waiter_count;
+    EventFlags * volatile         _wait_set;
+    uint32_t                      _wait_set_flag;
     osMessageQueueId_t            _id;
     osMessageQueueAttr_t          _attr;
     char                          _queue_mem[queue_sz * (sizeof(T*) + sizeof(mbed_rtos_storage_message_t))];
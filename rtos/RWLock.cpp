@@ -0,0 +1,109 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2006-2012 ARM Limited
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "rtos/RWLock.h"
+
+#include "platform/mbed_critical.h"
+
+#define RWLOCK_DRAINED 0x1
+
+namespace rtos {
+
+RWLock::RWLock()
+    : _readers(0), _writer(false) {
+}
+
+RWLock::RWLock(const char *name)
+    : _readers(0), _writer(false), _mutex(name), _drained(name) {
+}
+
+bool RWLock::read_fastpath() {
+    if (_writer) {
+        return false;
+    }
+
+    core_util_atomic_incr_u32((uint32_t*)&_readers, 1);
+
+    // a writer may have arrived between the check and the increment,
+    // in which case it is waiting for us to back off
+    if (_writer) {
+        read_unlock();
+        return false;
+    }
+
+    return true;
+}
+
+void RWLock::read_lock() {
+    if (read_fastpath()) {
+        return;
+    }
+
+    // writers hold the mutex until they are done, so blocking on it
+    // lends our priority to the writer
+    _mutex.lock();
+    core_util_atomic_incr_u32((uint32_t*)&_readers, 1);
+    _mutex.unlock();
+}
+
+bool RWLock::read_trylock() {
+    return read_fastpath();
+}
+
+void RWLock::read_unlock() {
+    if (core_util_atomic_decr_u32((uint32_t*)&_readers, 1) == 0 && _writer) {
+        _drained.set(RWLOCK_DRAINED);
+    }
+}
+
+void RWLock::write_lock() {
+    _mutex.lock();
+    _writer = true;
+
+    // clearing after raising _writer means any flag seen below was
+    // set by a reader that finished after we arrived
+    _drained.clear(RWLOCK_DRAINED);
+    while (_readers != 0) {
+        _drained.wait_any(RWLOCK_DRAINED);
+    }
+}
+
+bool RWLock::write_trylock() {
+    if (!_mutex.trylock()) {
+        return false;
+    }
+
+    _writer = true;
+    if (_readers != 0) {
+        _writer = false;
+        _mutex.unlock();
+        return false;
+    }
+
+    return true;
+}
+
+void RWLock::write_unlock() {
+    _writer = false;
+    _mutex.unlock();
+}
+
+}
@@ -0,0 +1,99 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2006-2012 ARM Limited
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef RWLOCK_H
+#define RWLOCK_H
+
+#include <stdint.h>
+#include "cmsis_os2.h"
+#include "mbed_rtos1_types.h"
+
+#include "rtos/Mutex.h"
+#include "rtos/EventFlags.h"
+#include "platform/NonCopyable.h"
+
+namespace rtos {
+/** \addtogroup rtos */
+/** @{*/
+
+/** The RWLock class is a reader/writer lock, used to protect a shared resource that is read by
+ several threads at once and written rarely.
+
+ Taking an uncontended read lock is a single atomic increment, no kernel call is made. A writer
+ holds an internal Mutex for the duration of the write, so readers and writers that block on a
+ writer raise its priority through the Mutex's priority inheritance. A writer waiting for active
+ readers to finish does not raise their priority.
+
+ Writers are preferred: once a writer is waiting, new readers block until it is done.
+
+ @note
+ Neither read nor write locks are recursive. Taking a read lock again in a thread that already
+ holds one can deadlock if a writer is waiting in between.
+ @note
+ Memory considerations: The lock control structures will be created on current thread's stack, both for the mbed OS
+ and underlying RTOS objects (static or dynamic RTOS memory pools are not being used).
+*/
+class RWLock : private mbed::NonCopyable<RWLock> {
+public:
+    /** Create and Initialize a RWLock object */
+    RWLock();
+
+    /** Create and Initialize a RWLock object
+
+     @param name name to be used for this lock. It has to stay allocated for the lifetime of the thread.
+    */
+    RWLock(const char *name);
+
+    /** Wait until the lock can be taken for reading */
+    void read_lock();
+
+    /** Try to lock for reading, and return immediately
+      @return true if the lock was taken, false if a writer holds or is waiting for it.
+     */
+    bool read_trylock();
+
+    /** Release a read lock previously taken by the same thread */
+    void read_unlock();
+
+    /** Wait until the lock can be taken for writing, with no other readers or writers */
+    void write_lock();
+
+    /** Try to lock for writing, and return immediately
+      @return true if the lock was taken, false if it is held by a reader or writer.
+     */
+    bool write_trylock();
+
+    /** Release a write lock previously taken by the same thread */
+    void write_unlock();
+
+private:
+    bool read_fastpath();
+
+    volatile uint32_t _readers;
+    volatile bool _writer;
+    Mutex _mutex;
+    EventFlags _drained;
+};
+
+}
+#endif
+
+/** @}*/
@@ -41,6 +41,8 @@ void Semaphore::constructor(int32_t count, uint16_t max_count) {
     _attr.cb_size = sizeof(_obj_mem);
     _id = osSemaphoreNew(max_count, count, &_attr);
     MBED_ASSERT(_id != NULL);
+    _wait_set = NULL;
+    _wait_set_flag = 0;
 }
 
 int32_t Semaphore::wait(uint32_t millisec) {
@@ -58,7 +60,14 @@ int32_t Semaphore::wait(uint32_t millisec) {
 }
 
 osStatus Semaphore::release(void) {
-    return osSemaphoreRelease(_id);
+    osStatus_t res = osSemaphoreRelease(_id);
+
+    EventFlags *wait_set = _wait_set;
+    if (res == osOK && wait_set != NULL) {
+        wait_set->set(_wait_set_flag);
+    }
+
+    return res;
 }
 
 Semaphore::~Semaphore() {
@@ -27,11 +27,14 @@
 #include "mbed_rtos1_types.h"
 #include "mbed_rtos_storage.h"
 #include "platform/NonCopyable.h"
+#include "rtos/EventFlags.h"
 
 namespace rtos {
 /** \addtogroup rtos */
 /** @{*/
 
+class WaitSet;
+
 /** The Semaphore class is used to manage and protect access to a set of shared resources.
  *
  * @note
@@ -68,11 +71,15 @@ public:
     ~Semaphore();
 
 private:
+    friend class WaitSet;
+
     void constructor(int32_t count, uint16_t max_count);
 
     osSemaphoreId_t               _id;
     osSemaphoreAttr_t             _attr;
     mbed_rtos_storage_semaphore_t _obj_mem;
+    EventFlags * volatile         _wait_set;
+    uint32_t                      _wait_set_flag;
 };
 
 }
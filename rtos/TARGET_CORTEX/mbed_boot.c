@@ -83,6 +83,7 @@
  *     -> SystemInit (TARGET)
  *     -> __main (LIBC)
  *         -> software_init_hook (MBED: rtos/mbed_boot.c)
+ *             -> mbed_copy_ram_sections (MBED: rtos/mbed_boot.c)
  *             -> mbed_set_stack_heap (MBED: rtos/mbed_boot.c)
  *             -> mbed_cpy_nvic (MBED: rtos/mbed_boot.c)
  *             -> mbed_sdk_init (TARGET)
@@ -168,6 +169,9 @@
 #include "cmsis_os2.h"
 #include "mbed_toolchain.h"
 #include "mbed_error.h"
+#include "mbed_boot_time.h"
+#include "mbed_crash_dump.h"
+#include "mbed_cycle_counter.h"
 #if defined(__IAR_SYSTEMS_ICC__ ) && (__VER__ >= 8000000)
 #include <DLib_Threads.h>
 #endif
@@ -300,6 +304,10 @@ static void mbed_cpy_nvic(void)
  * mbed_sdk_init() is also a function that is called before main(), but unlike
  * mbed_main(), it is not meant for user code, but for the SDK itself to perform
  * initializations before main() is called.
+ *
+ * With the platform.boot-time-enabled option set, the boot code records the end of each phase of the above with
+ * mbed_boot_time_record (see platform/mbed_boot_time.h): entry into the mbed OS code, mbed_sdk_init, the kernel
+ * initialization, the start of the main thread, the C library and C++ static initialization, and main.
  */
 WEAK void mbed_main(void) {
 
@@ -335,6 +343,8 @@ void mbed_start_main(void)
 /* Common for both ARMC and MICROLIB */
 int $Super$$main(void);
 int $Sub$$main(void) {
+    mbed_cycle_counter_init();
+    mbed_crash_dump_boot();
     mbed_main();
     return $Super$$main();
 }
@@ -346,13 +356,16 @@ void _main_init (void) __attribute__((section(".ARM.Collect$$$$000000FF")));
 void $Super$$__cpp_initialize__aeabi_(void);
 
 void _main_init (void) {
+    mbed_boot_time_record(MBED_BOOT_PHASE_ENTRY);
     mbed_set_stack_heap();
     /* Copy the vector table to RAM only if uVisor is not in use. */
 #if !(defined(FEATURE_UVISOR) && defined(TARGET_UVISOR_SUPPORTED))
     mbed_cpy_nvic();
 #endif
     mbed_sdk_init();
+    mbed_boot_time_record(MBED_BOOT_PHASE_SDK_INIT);
     osKernelInitialize();
+    mbed_boot_time_record(MBED_BOOT_PHASE_KERNEL_INIT);
     mbed_start_main();
     for (;;);
 }
@@ -366,6 +379,7 @@ void $Sub$$__cpp_initialize__aeabi_(void)
 
 void pre_main()
 {
+    mbed_boot_time_record(MBED_BOOT_PHASE_MAIN_THREAD);
     singleton_mutex_attr.name = "singleton_mutex";
     singleton_mutex_attr.attr_bits = osMutexRecursive | osMutexPrioInherit | osMutexRobust;
     singleton_mutex_attr.cb_size = sizeof(singleton_mutex_obj);
@@ -373,6 +387,8 @@ void pre_main()
     singleton_mutex_id = osMutexNew(&singleton_mutex_attr);
 
     $Super$$__cpp_initialize__aeabi_();
+    mbed_boot_time_record(MBED_BOOT_PHASE_STATIC_INIT);
+    mbed_boot_time_record(MBED_BOOT_PHASE_MAIN);
     main();
 }
 
@@ -386,6 +402,7 @@ extern int main(int argc, char* argv[]);
 
 void pre_main (void)
 {
+    mbed_boot_time_record(MBED_BOOT_PHASE_MAIN_THREAD);
     singleton_mutex_attr.name = "singleton_mutex";
     singleton_mutex_attr.attr_bits = osMutexRecursive | osMutexPrioInherit | osMutexRobust;
     singleton_mutex_attr.cb_size = sizeof(singleton_mutex_obj);
@@ -393,7 +410,9 @@ void pre_main (void)
     singleton_mutex_id = osMutexNew(&singleton_mutex_attr);
 
     __rt_lib_init((unsigned)mbed_heap_start, (unsigned)(mbed_heap_start + mbed_heap_size));
+    mbed_boot_time_record(MBED_BOOT_PHASE_STATIC_INIT);
 
+    mbed_boot_time_record(MBED_BOOT_PHASE_MAIN);
     main(0, NULL);
 }
 
@@ -411,6 +430,7 @@ __asm(".global __use_no_semihosting\n\t");
 
 /* Called by the C library */
 void __rt_entry (void) {
+    mbed_boot_time_record(MBED_BOOT_PHASE_ENTRY);
     __user_setup_stackheap();
     mbed_set_stack_heap();
     /* Copy the vector table to RAM only if uVisor is not in use. */
@@ -418,7 +438,9 @@ void __rt_entry (void) {
     mbed_cpy_nvic();
 #endif
     mbed_sdk_init();
+    mbed_boot_time_record(MBED_BOOT_PHASE_SDK_INIT);
     _platform_post_stackheap_init();
+    mbed_boot_time_record(MBED_BOOT_PHASE_KERNEL_INIT);
     mbed_start_main();
 }
 
@@ -483,12 +505,15 @@ osMutexAttr_t             env_mutex_attr;
 #endif/* FEATURE_UVISOR */
 
 int __wrap_main(void) {
+    mbed_cycle_counter_init();
+    mbed_crash_dump_boot();
     mbed_main();
     return __real_main();
 }
 
 void pre_main(void)
 {
+    mbed_boot_time_record(MBED_BOOT_PHASE_MAIN_THREAD);
     singleton_mutex_attr.name = "singleton_mutex";
     singleton_mutex_attr.attr_bits = osMutexRecursive | osMutexPrioInherit | osMutexRobust;
     singleton_mutex_attr.cb_size = sizeof(singleton_mutex_obj);
@@ -508,19 +533,50 @@ void pre_main(void)
     env_mutex_id = osMutexNew(&env_mutex_attr);
 
     __libc_init_array();
+    mbed_boot_time_record(MBED_BOOT_PHASE_STATIC_INIT);
 
+    mbed_boot_time_record(MBED_BOOT_PHASE_MAIN);
     main(0, NULL);
 }
 
+/* Sections the startup code does not copy, such as functions placed in ITCM.
+ * Linker scripts describe them with a table of (load address, start, end)
+ * words between these symbols; targets without such sections leave the
+ * symbols undefined.
+ */
+extern const uint32_t __mbed_copy_table_start__[] __attribute__((weak));
+extern const uint32_t __mbed_copy_table_end__[] __attribute__((weak));
+
+static void mbed_copy_ram_sections(void)
+{
+    const uint32_t *entry;
+
+    for (entry = __mbed_copy_table_start__; entry < __mbed_copy_table_end__; entry += 3) {
+        const uint32_t *src = (const uint32_t *)entry[0];
+        uint32_t *dst = (uint32_t *)entry[1];
+        uint32_t *end = (uint32_t *)entry[2];
+        while (dst < end) {
+            *dst++ = *src++;
+        }
+    }
+    /* The copied code may be executed right away */
+    __DSB();
+    __ISB();
+}
+
 void software_init_hook(void)
 {
+    mbed_boot_time_record(MBED_BOOT_PHASE_ENTRY);
+    mbed_copy_ram_sections();
     mbed_set_stack_heap();
     /* Copy the vector table to RAM only if uVisor is not in use. */
 #if !(defined(FEATURE_UVISOR) && defined(TARGET_UVISOR_SUPPORTED))
     mbed_cpy_nvic();
 #endif
     mbed_sdk_init();
+    mbed_boot_time_record(MBED_BOOT_PHASE_SDK_INIT);
     osKernelInitialize();
+    mbed_boot_time_record(MBED_BOOT_PHASE_KERNEL_INIT);
     /* uvisor_lib_init calls RTOS functions, so must be called after the RTOS has
      * been initialized. */
 #ifdef   FEATURE_UVISOR
@@ -575,6 +631,7 @@ static uint8_t low_level_init_needed;
 
 void pre_main(void)
 {
+    mbed_boot_time_record(MBED_BOOT_PHASE_MAIN_THREAD);
     singleton_mutex_attr.name = "singleton_mutex";
     singleton_mutex_attr.attr_bits = osMutexRecursive | osMutexPrioInherit | osMutexRobust;
     singleton_mutex_attr.cb_size = sizeof(singleton_mutex_obj);
@@ -588,7 +645,11 @@ void pre_main(void)
     if (low_level_init_needed) {
         __iar_dynamic_initialization();
     }
+    mbed_boot_time_record(MBED_BOOT_PHASE_STATIC_INIT);
 
+    mbed_boot_time_record(MBED_BOOT_PHASE_MAIN);
+    mbed_cycle_counter_init();
+    mbed_crash_dump_boot();
     mbed_main();
     main();
 }
@@ -604,12 +665,14 @@ void __iar_program_start( void )
     low_level_init_needed_local = __low_level_init();
     if (low_level_init_needed_local) {
         __iar_data_init3();
+        mbed_boot_time_record(MBED_BOOT_PHASE_ENTRY);
 
     /* Copy the vector table to RAM only if uVisor is not in use. */
 #if !(defined(FEATURE_UVISOR) && defined(TARGET_UVISOR_SUPPORTED))
     mbed_cpy_nvic();
 #endif
     mbed_sdk_init();
+    mbed_boot_time_record(MBED_BOOT_PHASE_SDK_INIT);
   }
 
   mbed_set_stack_heap();
@@ -618,6 +681,7 @@ void __iar_program_start( void )
   low_level_init_needed = low_level_init_needed_local;
 
   osKernelInitialize();
+  mbed_boot_time_record(MBED_BOOT_PHASE_KERNEL_INIT);
 
   mbed_start_main();
 }
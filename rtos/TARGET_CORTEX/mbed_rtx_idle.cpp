@@ -48,8 +48,8 @@ extern "C" IRQn_Type mbed_get_m0_tick_irqn(void);
 
 class RtosTimer : private TimerEvent {
 public:
-    RtosTimer(): TimerEvent(get_lp_ticker_data()), _start_time(0), _tick(0) {
-        _start_time = ticker_read_us(_ticker_data);
+    RtosTimer(): TimerEvent(get_lp_ticker_data()), _tick_time(0), _tick_frac(0), _tick(0) {
+        _tick_time = ticker_read_us(_ticker_data);
 #if (defined(NO_SYSTICK))
         NVIC_SetVector(mbed_get_m0_tick_irqn(), (uint32_t)SysTick_Handler);
         NVIC_SetPriority(mbed_get_m0_tick_irqn(), 0xFF); /* RTOS requires lowest priority */
@@ -68,7 +68,7 @@ public:
      * @param delta Tick to fire at relative to current tick
      */
     void schedule_tick(uint32_t delta=1) {
-        insert_absolute(_start_time + (_tick + delta) * 1000000 /  OS_TICK_FREQ);
+        insert_absolute(tick_time(delta));
     }
 
 
@@ -94,16 +94,30 @@ public:
      * @return The number of ticks incremented
      */
     uint32_t update_tick() {
-        uint64_t new_tick = ticker_read_us(_ticker_data) * OS_TICK_FREQ / 1000000;
-        if (new_tick > _tick) {
+        us_timestamp_t now = ticker_read_us(_ticker_data);
+        if (now <= _tick_time) {
+            return 0;
+        }
+
+        // this only runs once per sleep, when the tick length is a whole
+        // number of microseconds and the sleep shorter than 2^32 us a
+        // 32-bit divide is enough
+        us_timestamp_t elapsed_us = now - _tick_time;
+        uint32_t elapsed_ticks;
+        if (!TICK_REM && elapsed_us <= 0xFFFFFFFF) {
+            elapsed_ticks = (uint32_t)elapsed_us / TICK_US;
+        } else {
+            elapsed_ticks = ((elapsed_us + 1) * OS_TICK_FREQ - _tick_frac - 1) / 1000000;
+        }
+
+        if (elapsed_ticks > 0) {
             // Don't update to the current tick. Instead, update to the
             // previous tick and let the SysTick handler increment it
             // to the current value. This allows scheduling restart
             // successfully after the OS is resumed.
-            new_tick--;
+            elapsed_ticks--;
         }
-        uint32_t elapsed_ticks = new_tick - _tick;
-        _tick = new_tick;
+        advance(elapsed_ticks);
         return elapsed_ticks;
     }
 
@@ -128,10 +142,48 @@ protected:
 #else
         SCB->ICSR = SCB_ICSR_PENDSTSET_Msk;
 #endif
-        _tick++;
+        advance(1);
+    }
+
+    // The time of each tick is tracked incrementally, with the fraction of
+    // a microsecond kept in _tick_frac, so the per-tick path only adds.
+    // The fraction is constant-folded away when OS_TICK_FREQ divides 1MHz.
+    static const uint32_t TICK_US = 1000000 / OS_TICK_FREQ;
+    static const uint32_t TICK_REM = 1000000 % OS_TICK_FREQ;
+
+    us_timestamp_t tick_time(uint32_t delta) {
+        us_timestamp_t time = _tick_time + (us_timestamp_t)delta * TICK_US;
+        if (TICK_REM && delta == 1) {
+            time += _tick_frac + TICK_REM >= OS_TICK_FREQ;
+        } else if (TICK_REM) {
+            time += (_tick_frac + (uint64_t)delta * TICK_REM) / OS_TICK_FREQ;
+        }
+        return time;
+    }
+
+    void advance(uint32_t delta) {
+        _tick += delta;
+        if (delta == 1) {
+            _tick_time += TICK_US;
+            if (TICK_REM) {
+                _tick_frac += TICK_REM;
+                if (_tick_frac >= OS_TICK_FREQ) {
+                    _tick_frac -= OS_TICK_FREQ;
+                    _tick_time += 1;
+                }
+            }
+        } else {
+            _tick_time += (us_timestamp_t)delta * TICK_US;
+            if (TICK_REM) {
+                uint64_t frac = _tick_frac + (uint64_t)delta * TICK_REM;
+                _tick_time += frac / OS_TICK_FREQ;
+                _tick_frac = frac % OS_TICK_FREQ;
+            }
+        }
     }
 
-    us_timestamp_t _start_time;
+    us_timestamp_t _tick_time;
+    uint32_t _tick_frac;
     uint64_t _tick;
 };
 
@@ -183,9 +235,9 @@ static void default_idle_hook(void)
     if (ticks_to_sleep) {
         os_timer->schedule_tick(ticks_to_sleep);
 
-        sleep_manager_lock_deep_sleep();
+        sleep_manager_lock_deep_sleep_named("Idle");
         sleep();
-        sleep_manager_unlock_deep_sleep();
+        sleep_manager_unlock_deep_sleep_named("Idle");
 
         os_timer->cancel_tick();
         // calculate how long we slept
@@ -209,9 +261,9 @@ static void default_idle_hook(void)
 {
     // critical section to complete sleep with locked deepsleep
     core_util_critical_section_enter();
-    sleep_manager_lock_deep_sleep();
+    sleep_manager_lock_deep_sleep_named("Idle");
     sleep();
-    sleep_manager_unlock_deep_sleep();
+    sleep_manager_unlock_deep_sleep_named("Idle");
     core_util_critical_section_exit();
 }
 
@@ -23,6 +23,7 @@
 
 #include "mbed.h"
 #include "rtos/rtos_idle.h"
+#include "platform/mbed_heap_regions.h"
 
 static void (*terminate_hook)(osThreadId_t id) = 0;
 extern "C" void thread_terminate_hook(osThreadId_t id)
@@ -34,11 +35,58 @@ extern "C" void thread_terminate_hook(osThreadId_t id)
 
 namespace rtos {
 
+// threads with an attached arena, searched by Thread::arena
+static Thread *arena_threads = NULL;
+
+#if MBED_CONF_RTOS_THREAD_STACK_POOL_SIZE > 0
+// Preallocated stacks for threads started without a stack of their own,
+// free stacks are linked through their first word
+static uint64_t stack_pool[MBED_CONF_RTOS_THREAD_STACK_POOL_SIZE]
+        [MBED_CONF_RTOS_THREAD_STACK_POOL_STACK_SIZE / sizeof(uint64_t)];
+static void *stack_pool_free = NULL;
+static bool stack_pool_ready = false;
+
+static void *stack_pool_alloc(uint32_t size)
+{
+    if (size > sizeof(stack_pool[0])) {
+        return NULL;
+    }
+
+    core_util_critical_section_enter();
+    if (!stack_pool_ready) {
+        for (int i = MBED_CONF_RTOS_THREAD_STACK_POOL_SIZE-1; i >= 0; i--) {
+            *(void**)stack_pool[i] = stack_pool_free;
+            stack_pool_free = stack_pool[i];
+        }
+        stack_pool_ready = true;
+    }
+
+    void *stack = stack_pool_free;
+    if (stack) {
+        stack_pool_free = *(void**)stack;
+    }
+    core_util_critical_section_exit();
+
+    return stack;
+}
+
+static void stack_pool_dealloc(void *stack)
+{
+    core_util_critical_section_enter();
+    *(void**)stack = stack_pool_free;
+    stack_pool_free = stack;
+    core_util_critical_section_exit();
+}
+#endif
+
 void Thread::constructor(osPriority priority,
         uint32_t stack_size, unsigned char *stack_mem, const char *name) {
     _tid = 0;
     _dynamic_stack = (stack_mem == NULL);
+    _pooled_stack = false;
     _finished = false;
+    _arena = NULL;
+    _arena_next = NULL;
     memset(&_obj_mem, 0, sizeof(_obj_mem));
     memset(&_attr, 0, sizeof(_attr));
     _attr.priority = priority;
@@ -74,7 +122,22 @@ osStatus Thread::start(Callback<void()> task) {
     }
 
     if (_attr.stack_mem == NULL) {
-        _attr.stack_mem = new uint32_t[_attr.stack_size/sizeof(uint32_t)];
+#if MBED_CONF_RTOS_THREAD_STACK_POOL_SIZE > 0
+        _attr.stack_mem = stack_pool_alloc(_attr.stack_size);
+        _pooled_stack = (_attr.stack_mem != NULL);
+#endif
+#if MBED_CONF_RTOS_THREAD_STACK_ATTRIBUTES
+        if (_attr.stack_mem == NULL) {
+            _attr.stack_mem = mbed_heap_alloc(_attr.stack_size, MBED_CONF_RTOS_THREAD_STACK_ATTRIBUTES);
+        }
+        if (_attr.stack_mem == NULL) {
+            _attr.stack_mem = mbed_heap_alloc(_attr.stack_size, 0);
+        }
+#else
+        if (_attr.stack_mem == NULL) {
+            _attr.stack_mem = new uint32_t[_attr.stack_size/sizeof(uint32_t)];
+        }
+#endif
         MBED_ASSERT(_attr.stack_mem != NULL);
     }
 
@@ -89,10 +152,7 @@ osStatus Thread::start(Callback<void()> task) {
     _task = task;
     _tid = osThreadNew(Thread::_thunk, this, &_attr);
     if (_tid == NULL) {
-        if (_dynamic_stack) {
-            delete[] (uint32_t *)(_attr.stack_mem);
-            _attr.stack_mem = (uint32_t*)NULL;
-        }
+        free_stack_mem();
         _mutex.unlock();
         _join_sem.release();
         return osErrorResource;
@@ -131,6 +191,10 @@ osStatus Thread::join() {
     // been locked it is ensured that the thread is deleted.
     _mutex.lock();
     MBED_ASSERT(NULL == _tid);
+    // the thread is gone, so a pooled stack can be reused right away
+    if (_pooled_stack) {
+        free_stack_mem();
+    }
     _mutex.unlock();
 
     // Release sem so any other threads joining this thread wake up
@@ -293,6 +357,29 @@ const char *Thread::get_name() {
     return _attr.name;
 }
 
+void Thread::set_arena(Arena *arena) {
+    core_util_critical_section_enter();
+
+    for (Thread **t = &arena_threads; *t; t = &(*t)->_arena_next) {
+        if (*t == this) {
+            *t = _arena_next;
+            break;
+        }
+    }
+
+    _arena = arena;
+    if (_arena) {
+        _arena_next = arena_threads;
+        arena_threads = this;
+    }
+
+    core_util_critical_section_exit();
+}
+
+Arena *Thread::get_arena() {
+    return _arena;
+}
+
 int32_t Thread::signal_clr(int32_t flags) {
     return osThreadFlagsClear(flags);
 }
@@ -342,6 +429,25 @@ osThreadId Thread::gettid() {
     return osThreadGetId();
 }
 
+Arena *Thread::arena() {
+    Arena *arena = NULL;
+    osThreadId_t tid = osThreadGetId();
+
+    core_util_critical_section_enter();
+
+    // the thread's control block is _obj_mem, so this also matches
+    // threads that are running before start has stored their _tid
+    for (Thread *t = arena_threads; t; t = t->_arena_next) {
+        if ((osThreadId_t)&t->_obj_mem == tid) {
+            arena = t->_arena;
+            break;
+        }
+    }
+
+    core_util_critical_section_exit();
+    return arena;
+}
+
 void Thread::attach_idle_hook(void (*fptr)(void)) {
     rtos_attach_idle_hook(fptr);
 }
@@ -353,10 +459,30 @@ void Thread::attach_terminate_hook(void (*fptr)(osThreadId_t id)) {
 Thread::~Thread() {
     // terminate is thread safe
     terminate();
-    if (_dynamic_stack) {
-        delete[] (uint32_t*)(_attr.stack_mem);
+    set_arena(NULL);
+    free_stack_mem();
+}
+
+void Thread::free_stack_mem() {
+    if (!_dynamic_stack || _attr.stack_mem == NULL) {
+        return;
+    }
+
+#if MBED_CONF_RTOS_THREAD_STACK_POOL_SIZE > 0
+    if (_pooled_stack) {
+        stack_pool_dealloc(_attr.stack_mem);
+        _pooled_stack = false;
         _attr.stack_mem = (uint32_t*)NULL;
+        return;
     }
+#endif
+
+#if MBED_CONF_RTOS_THREAD_STACK_ATTRIBUTES
+    mbed_heap_free(_attr.stack_mem);
+#else
+    delete[] (uint32_t*)(_attr.stack_mem);
+#endif
+    _attr.stack_mem = (uint32_t*)NULL;
 }
 
 void Thread::_thunk(void * thread_ptr)
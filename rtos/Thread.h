@@ -31,6 +31,7 @@
 #include "platform/NonCopyable.h"
 #include "rtos/Semaphore.h"
 #include "rtos/Mutex.h"
+#include "rtos/Arena.h"
 
 namespace rtos {
 /** \addtogroup rtos */
@@ -303,6 +304,17 @@ public:
      */
     const char *get_name();
 
+    /** Attach a scratch arena to this thread
+      @param   arena  Arena used for short-lived allocations of this thread or NULL to detach it.
+      @note The Arena is not released when it is detached or the thread finishes.
+    */
+    void set_arena(Arena *arena);
+
+    /** Get the scratch arena attached to this thread
+      @return  Arena attached with Thread::set_arena or NULL.
+    */
+    Arena *get_arena();
+
     /** Clears the specified Thread Flags of the currently running thread.
       @param   signals  specifies the signal flags of the thread that should be cleared.
       @return  resultant signal flags of the specified thread or osFlagsError in case of incorrect parameters.
@@ -335,6 +347,12 @@ public:
     */
     static osThreadId gettid();
 
+    /** Get the scratch arena attached to the current running thread.
+      @return  Arena attached with Thread::set_arena or NULL, also if the current thread was not
+               created with a Thread object.
+    */
+    static Arena *arena();
+
     /** Attach a function to be called by the RTOS idle task
       @param   fptr  pointer to the function to be called
     */
@@ -360,15 +378,19 @@ private:
                      unsigned char *stack_mem=NULL,
                      const char *name=NULL);
     static void _thunk(void * thread_ptr);
+    void free_stack_mem();
 
     mbed::Callback<void()>     _task;
     osThreadId_t               _tid;
     osThreadAttr_t             _attr;
     bool                       _dynamic_stack;
+    bool                       _pooled_stack;
     Semaphore                  _join_sem;
     Mutex                      _mutex;
     mbed_rtos_storage_thread_t _obj_mem;
     bool                       _finished;
+    Arena                     *_arena;
+    Thread                    *_arena_next;
 };
 
 }
@@ -0,0 +1,257 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2006-2012 ARM Limited
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <stdint.h>
+#include "cmsis_os2.h"
+#include "mbed_rtos1_types.h"
+
+#include "rtos/Thread.h"
+#include "rtos/Semaphore.h"
+#include "rtos/EventFlags.h"
+#include "platform/Callback.h"
+#include "platform/mbed_assert.h"
+#include "platform/mbed_critical.h"
+#include "platform/NonCopyable.h"
+
+namespace rtos {
+/** \addtogroup rtos */
+/** @{*/
+
+/** The ThreadPool class runs Callback work items on a fixed set of worker threads.
+
+ Each worker has its own deque of work items. Work is spread over the deques as it is submitted,
+ a worker runs the most recently queued item of its own deque first, and a worker whose deque is
+ empty steals the oldest item from the other workers, so no worker idles while work is waiting.
+
+ Timed work can be forwarded into the pool from an EventQueue:
+ @code
+ ThreadPool<4> pool;
+ EventQueue queue;
+
+ queue.call_in(100, &pool, &ThreadPool<4>::call, callback(process_sample));
+ @endcode
+
+  @tparam  workers   number of worker threads.
+  @tparam  queue_sz  maximum number of queued work items per worker. (default: 8)
+
+ @note
+ call is interrupt safe, drain and join must be called from a thread outside of the pool.
+ @note
+ Memory considerations: The worker threads are allocated on the heap when the pool is created, along with
+ their stacks.
+*/
+template<uint32_t workers, uint32_t queue_sz = 8>
+class ThreadPool : private mbed::NonCopyable<ThreadPool<workers, queue_sz> > {
+    MBED_STATIC_ASSERT(workers > 0, "Invalid thread pool size. Must be greater than 0.");
+    MBED_STATIC_ASSERT(queue_sz > 0, "Invalid thread pool queue size. Must be greater than 0.");
+public:
+    /** Create a ThreadPool and start its workers
+      @param   priority       priority of the worker threads. (default: osPriorityNormal).
+      @param   stack_size     stack size (in bytes) of each worker thread. (default: OS_STACK_SIZE).
+      @param   name           name to be used for the worker threads. It has to stay allocated for the lifetime of the pool (default: NULL)
+    */
+    ThreadPool(osPriority priority=osPriorityNormal,
+               uint32_t stack_size=OS_STACK_SIZE, const char *name=NULL)
+        : _work(0), _next(0), _pending(0), _stopping(false) {
+        for (uint32_t i = 0; i < workers; i++) {
+            _deques[i].head = 0;
+            _deques[i].count = 0;
+            _workers[i].pool = this;
+            _workers[i].index = i;
+            _workers[i].thread = new Thread(priority, stack_size, NULL, name);
+            MBED_ASSERT(_workers[i].thread != NULL);
+            _workers[i].thread->start(mbed::callback(&_workers[i], &worker::run));
+        }
+    }
+
+    /** Stop the pool, running any work that is still queued first */
+    ~ThreadPool() {
+        join();
+        for (uint32_t i = 0; i < workers; i++) {
+            delete _workers[i].thread;
+        }
+    }
+
+    /** Queue a work item to be run by one of the workers
+      @param   work  function to run.
+      @return  true if the work was queued, false if every deque is full or the pool has been joined.
+    */
+    bool call(mbed::Callback<void()> work) {
+        bool queued = false;
+
+        core_util_critical_section_enter();
+        if (!_stopping) {
+            for (uint32_t n = 0; n < workers && !queued; n++) {
+                uint32_t i = _next;
+                _next = (_next + 1) % workers;
+                queued = push(&_deques[i], work);
+            }
+            if (queued) {
+                _pending++;
+            }
+        }
+        core_util_critical_section_exit();
+
+        if (queued) {
+            _work.release();
+        }
+        return queued;
+    }
+
+    /** Wait until every queued work item has completed
+      @note Work queued while waiting is waited for too.
+    */
+    void drain() {
+        while (pending()) {
+            _idle.wait_any(FLAG_IDLE);
+        }
+    }
+
+    /** Run the queued work, then stop the workers and wait for them to exit
+      @note Work can not be queued once join has been called.
+    */
+    void join() {
+        drain();
+
+        core_util_critical_section_enter();
+        bool stopping = _stopping;
+        _stopping = true;
+        core_util_critical_section_exit();
+
+        if (!stopping) {
+            for (uint32_t i = 0; i < workers; i++) {
+                _work.release();
+            }
+        }
+
+        for (uint32_t i = 0; i < workers; i++) {
+            _workers[i].thread->join();
+        }
+    }
+
+private:
+    static const uint32_t FLAG_IDLE = 0x1;
+
+    struct deque {
+        mbed::Callback<void()> items[queue_sz];
+        uint32_t head;
+        uint32_t count;
+    };
+
+    struct worker {
+        ThreadPool *pool;
+        uint32_t index;
+        Thread *thread;
+
+        void run() {
+            pool->worker_loop(index);
+        }
+    };
+
+    // deques are only accessed in critical sections
+    static bool push(deque *d, mbed::Callback<void()> work) {
+        if (d->count == queue_sz) {
+            return false;
+        }
+
+        d->items[(d->head + d->count) % queue_sz] = work;
+        d->count++;
+        return true;
+    }
+
+    static bool pop_back(deque *d, mbed::Callback<void()> *work) {
+        if (d->count == 0) {
+            return false;
+        }
+
+        d->count--;
+        *work = d->items[(d->head + d->count) % queue_sz];
+        return true;
+    }
+
+    static bool pop_front(deque *d, mbed::Callback<void()> *work) {
+        if (d->count == 0) {
+            return false;
+        }
+
+        *work = d->items[d->head];
+        d->head = (d->head + 1) % queue_sz;
+        d->count--;
+        return true;
+    }
+
+    bool pending() {
+        core_util_critical_section_enter();
+        bool pending = _pending > 0;
+        core_util_critical_section_exit();
+        return pending;
+    }
+
+    bool take(uint32_t index, mbed::Callback<void()> *work) {
+        core_util_critical_section_enter();
+        bool found = pop_back(&_deques[index], work);
+        for (uint32_t n = 1; n < workers && !found; n++) {
+            found = pop_front(&_deques[(index + n) % workers], work);
+        }
+        core_util_critical_section_exit();
+        return found;
+    }
+
+    void worker_loop(uint32_t index) {
+        while (true) {
+            // every queued item releases one token, so holding a token
+            // guarantees an item is left in one of the deques
+            _work.wait();
+
+            mbed::Callback<void()> work;
+            if (!take(index, &work)) {
+                // only the tokens released by join have no item
+                return;
+            }
+
+            work();
+
+            core_util_critical_section_enter();
+            bool idle = --_pending == 0;
+            core_util_critical_section_exit();
+
+            if (idle) {
+                _idle.set(FLAG_IDLE);
+            }
+        }
+    }
+
+    deque _deques[workers];
+    worker _workers[workers];
+    Semaphore _work;
+    EventFlags _idle;
+    uint32_t _next;
+    uint32_t _pending;
+    bool _stopping;
+};
+
+}
+#endif
+
+/** @}*/
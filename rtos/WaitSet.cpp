@@ -0,0 +1,179 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2006-2012 ARM Limited
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "rtos/WaitSet.h"
+
+#include <string.h>
+#include "platform/mbed_critical.h"
+#include "platform/mbed_assert.h"
+
+MBED_STATIC_ASSERT(MBED_CONF_RTOS_WAIT_SET_MAX_SOURCES <= 31,
+        "A WaitSet can hold at most 31 sources, one per event flag");
+
+namespace rtos {
+
+static uint32_t remaining(uint32_t start, uint32_t millisec) {
+    if (millisec == 0 || millisec == osWaitForever) {
+        return millisec;
+    }
+
+    uint32_t elapsed = osKernelGetTickCount() - start;
+    return elapsed < millisec ? millisec - elapsed : 0;
+}
+
+WaitSet::WaitSet()
+    : _used(0), _signals(0), _next(0) {
+    memset(_sources, 0, sizeof(_sources));
+}
+
+WaitSet::~WaitSet() {
+    for (int i = 0; i < MBED_CONF_RTOS_WAIT_SET_MAX_SOURCES; i++) {
+        remove(i);
+    }
+}
+
+int WaitSet::attach(void *obj, bool (*ready)(WaitSet *, source *), void (*detach)(void *),
+        uint32_t arg, EventFlags **wait_set, uint32_t *wait_set_flag) {
+    for (int i = 0; i < MBED_CONF_RTOS_WAIT_SET_MAX_SOURCES; i++) {
+        if (_used & (1UL << i)) {
+            continue;
+        }
+
+        if (wait_set) {
+            core_util_critical_section_enter();
+            if (*wait_set != NULL) {
+                core_util_critical_section_exit();
+                return -1;
+            }
+            // the flag must be visible before the object starts notifying us
+            *wait_set_flag = 1UL << i;
+            *wait_set = &_flags;
+            core_util_critical_section_exit();
+        }
+
+        _sources[i].ready = ready;
+        _sources[i].detach = detach;
+        _sources[i].obj = obj;
+        _sources[i].arg = arg;
+        _used |= 1UL << i;
+        return i;
+    }
+
+    return -1;
+}
+
+int WaitSet::add(Semaphore &sem) {
+    return attach(&sem, &WaitSet::semaphore_ready, &WaitSet::detach_source<Semaphore>, 0,
+            const_cast<EventFlags **>(&sem._wait_set), &sem._wait_set_flag);
+}
+
+int WaitSet::add(EventFlags &flags, uint32_t mask) {
+    return attach(&flags, &WaitSet::flags_ready, &WaitSet::detach_source<EventFlags>, mask,
+            const_cast<EventFlags **>(&flags._wait_set), &flags._wait_set_flag);
+}
+
+int WaitSet::add() {
+    int id = attach(this, &WaitSet::signal_ready, &WaitSet::signal_detach, 0, NULL, NULL);
+    if (id >= 0) {
+        _signals |= 1UL << id;
+    }
+    return id;
+}
+
+void WaitSet::signal(int id) {
+    MBED_ASSERT(id >= 0 && id < MBED_CONF_RTOS_WAIT_SET_MAX_SOURCES);
+    _flags.set(1UL << id);
+}
+
+mbed::Callback<void()> WaitSet::signal_callback(int id) {
+    MBED_ASSERT(id >= 0 && id < MBED_CONF_RTOS_WAIT_SET_MAX_SOURCES);
+    return mbed::callback(&WaitSet::signal_thunk, &_sources[id]);
+}
+
+void WaitSet::remove(int id) {
+    if (id < 0 || id >= MBED_CONF_RTOS_WAIT_SET_MAX_SOURCES || !(_used & (1UL << id))) {
+        return;
+    }
+
+    core_util_critical_section_enter();
+    _sources[id].detach(_sources[id].obj);
+    core_util_critical_section_exit();
+
+    _used &= ~(1UL << id);
+    _signals &= ~(1UL << id);
+    _flags.clear(1UL << id);
+    memset(&_sources[id], 0, sizeof(_sources[id]));
+}
+
+int WaitSet::wait_any(uint32_t millisec) {
+    uint32_t start = osKernelGetTickCount();
+
+    while (_used) {
+        // clear before checking, so a source becoming ready after its
+        // check wakes us up, signal flags are cleared when they are reported
+        _flags.clear(_used & ~_signals);
+
+        for (int i = 0; i < MBED_CONF_RTOS_WAIT_SET_MAX_SOURCES; i++) {
+            uint32_t id = (_next + i) % MBED_CONF_RTOS_WAIT_SET_MAX_SOURCES;
+            source *s = &_sources[id];
+            if ((_used & (1UL << id)) && s->ready(this, s)) {
+                _next = id + 1;
+                return id;
+            }
+        }
+
+        uint32_t timeout = remaining(start, millisec);
+        if (timeout == 0) {
+            break;
+        }
+
+        _flags.wait_any(_used, timeout, false);
+    }
+
+    return -1;
+}
+
+bool WaitSet::semaphore_ready(WaitSet *set, source *s) {
+    return osSemaphoreGetCount(static_cast<Semaphore *>(s->obj)->_id) > 0;
+}
+
+bool WaitSet::flags_ready(WaitSet *set, source *s) {
+    return (static_cast<EventFlags *>(s->obj)->get() & s->arg) != 0;
+}
+
+bool WaitSet::signal_ready(WaitSet *set, source *s) {
+    uint32_t flag = 1UL << (s - set->_sources);
+    return (set->_flags.clear(flag) & flag) != 0;
+}
+
+void WaitSet::signal_detach(void *obj) {
+}
+
+void WaitSet::signal_thunk(source *s) {
+    // the source may have been removed already
+    WaitSet *set = static_cast<WaitSet *>(s->obj);
+    if (set == NULL) {
+        return;
+    }
+    set->_flags.set(1UL << (s - set->_sources));
+}
+
+}
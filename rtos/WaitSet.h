@@ -0,0 +1,176 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2006-2012 ARM Limited
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef WAITSET_H
+#define WAITSET_H
+
+#include <stdint.h>
+#include "cmsis_os2.h"
+#include "mbed_rtos1_types.h"
+
+#include "rtos/EventFlags.h"
+#include "rtos/Semaphore.h"
+#include "rtos/Queue.h"
+#include "platform/Callback.h"
+#include "platform/NonCopyable.h"
+
+#ifndef MBED_CONF_RTOS_WAIT_SET_MAX_SOURCES
+#define MBED_CONF_RTOS_WAIT_SET_MAX_SOURCES 8
+#endif
+
+namespace rtos {
+/** \addtogroup rtos */
+/** @{*/
+
+/** The WaitSet class lets a single thread block on several Queues, Semaphores, EventFlags and
+ signal sources, such as socket sigio callbacks, at once.
+
+ Each source added to the WaitSet is given an id. wait_any() returns the id of a source that is
+ ready, without consuming anything from it, and the caller then reads the source without blocking.
+ Sources are checked in a round robin order, so a busy source does not starve the others.
+
+ Example:
+ @code
+ WaitSet set;
+ int rx_id = set.add(rx_queue);
+ int sock_id = set.add();
+ socket.sigio(set.signal_callback(sock_id));
+
+ while (true) {
+     int id = set.wait_any(1000);
+     if (id == rx_id) {
+         osEvent evt = rx_queue.get(0);
+         ...
+     } else if (id == sock_id) {
+         socket.recv(buffer, sizeof(buffer));
+     } else {
+         // timeout
+     }
+ }
+ @endcode
+
+ @note
+ Only one thread may wait on a WaitSet, and sources should be added and removed by that thread.
+ A source can be part of only one WaitSet at a time, and must be removed from it before it is destroyed.
+ @note
+ Memory considerations: The WaitSet control structures will be created on current thread's stack, both for the mbed OS
+ and underlying RTOS objects (static or dynamic RTOS memory pools are not being used).
+*/
+class WaitSet : private mbed::NonCopyable<WaitSet> {
+public:
+    /** Create and Initialize an empty WaitSet object */
+    WaitSet();
+
+    /** Add a Semaphore, ready while it has tokens available
+      @param   sem  Semaphore to wait on.
+      @return  id of the source or -1 if the WaitSet is full or the Semaphore is in another WaitSet.
+     */
+    int add(Semaphore &sem);
+
+    /** Add an EventFlags object, ready while any of the flags in mask are set
+      @param   flags  EventFlags to wait on.
+      @param   mask   flags to wait for.
+      @return  id of the source or -1 if the WaitSet is full or the EventFlags is in another WaitSet.
+     */
+    int add(EventFlags &flags, uint32_t mask);
+
+    /** Add a Queue, ready while it holds messages
+      @param   queue  Queue to wait on.
+      @return  id of the source or -1 if the WaitSet is full or the Queue is in another WaitSet.
+     */
+    template <typename T, uint32_t queue_sz>
+    int add(Queue<T, queue_sz> &queue) {
+        return attach(&queue, &WaitSet::queue_ready<T, queue_sz>,
+                &WaitSet::detach_source<Queue<T, queue_sz> >, 0,
+                const_cast<EventFlags **>(&queue._wait_set), &queue._wait_set_flag);
+    }
+
+    /** Add a signal source, ready once after each call to signal()
+      @return  id of the source or -1 if the WaitSet is full.
+     */
+    int add();
+
+    /** Signal a source added with add()
+
+      @param   id  id of the signal source.
+
+      @note This function may be called from ISR context.
+     */
+    void signal(int id);
+
+    /** Get a callback that signals a source added with add(), for example as a socket's sigio handler
+      @param   id  id of the signal source.
+      @return  callback that calls signal(id).
+     */
+    mbed::Callback<void()> signal_callback(int id);
+
+    /** Remove a source from the WaitSet
+      @param   id  id of the source to remove.
+     */
+    void remove(int id);
+
+    /** Wait until any of the sources is ready
+      @param   millisec  timeout value or 0 in case of no time-out. (default: osWaitForever)
+      @return  id of a ready source or -1 if none became ready in the given time or the WaitSet is empty.
+     */
+    int wait_any(uint32_t millisec = osWaitForever);
+
+    /** Removes all the sources from the WaitSet */
+    ~WaitSet();
+
+private:
+    struct source {
+        bool (*ready)(WaitSet *set, source *s);
+        void (*detach)(void *obj);
+        void *obj;
+        uint32_t arg;
+    };
+
+    int attach(void *obj, bool (*ready)(WaitSet *, source *), void (*detach)(void *),
+            uint32_t arg, EventFlags **wait_set, uint32_t *wait_set_flag);
+
+    template <typename T, uint32_t queue_sz>
+    static bool queue_ready(WaitSet *set, source *s) {
+        return osMessageQueueGetCount(static_cast<Queue<T, queue_sz> *>(s->obj)->_id) > 0;
+    }
+
+    template <typename S>
+    static void detach_source(void *obj) {
+        static_cast<S *>(obj)->_wait_set = NULL;
+    }
+
+    static bool semaphore_ready(WaitSet *set, source *s);
+    static bool flags_ready(WaitSet *set, source *s);
+    static bool signal_ready(WaitSet *set, source *s);
+    static void signal_detach(void *obj);
+    static void signal_thunk(source *s);
+
+    EventFlags _flags;
+    uint32_t _used;
+    uint32_t _signals;
+    uint32_t _next;
+    source _sources[MBED_CONF_RTOS_WAIT_SET_MAX_SOURCES];
+};
+
+}
+#endif
+
+/** @}*/
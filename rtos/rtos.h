@@ -28,12 +28,18 @@
 #include "mbed_rtos_storage.h"
 #include "rtos/Thread.h"
 #include "rtos/Mutex.h"
+#include "rtos/RWLock.h"
 #include "rtos/RtosTimer.h"
 #include "rtos/Semaphore.h"
 #include "rtos/Mail.h"
+#include "rtos/MailRing.h"
 #include "rtos/MemoryPool.h"
+#include "rtos/LockFreeMemoryPool.h"
 #include "rtos/Queue.h"
 #include "rtos/EventFlags.h"
+#include "rtos/WaitSet.h"
+#include "rtos/ThreadPool.h"
+#include "rtos/Arena.h"
 
 using namespace rtos;
 
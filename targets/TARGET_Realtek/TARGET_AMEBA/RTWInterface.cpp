@@ -32,50 +32,67 @@ typedef struct _wifi_scan_hdl {
     nsapi_size_t ap_num;
     nsapi_size_t scan_num;
     WiFiAccessPoint *ap_details;
+    WiFiScanCache *cache;
+    WiFiInterface::scan_cb_t callback;
+    volatile bool busy;
 } wifi_scan_hdl;
 
 #define MAX_SCAN_TIMEOUT (15000)
 
+// One scan at a time, blocking or in the background
+static wifi_scan_hdl scan_handler;
+
+static nsapi_security_t scan_security(rtw_security_t security)
+{
+    switch (security){
+        case RTW_SECURITY_OPEN:
+            return NSAPI_SECURITY_NONE;
+        case RTW_SECURITY_WEP_PSK:
+        case RTW_SECURITY_WEP_SHARED:
+            return NSAPI_SECURITY_WEP;
+        case RTW_SECURITY_WPA_TKIP_PSK:
+        case RTW_SECURITY_WPA_AES_PSK:
+            return NSAPI_SECURITY_WPA;
+        case RTW_SECURITY_WPA2_AES_PSK:
+        case RTW_SECURITY_WPA2_TKIP_PSK:
+        case RTW_SECURITY_WPA2_MIXED_PSK:
+            return NSAPI_SECURITY_WPA2;
+        case RTW_SECURITY_WPA_WPA2_MIXED:
+            return NSAPI_SECURITY_WPA_WPA2;
+        default:
+            return NSAPI_SECURITY_UNKNOWN;
+    }
+}
+
 static rtw_result_t scan_result_handler( rtw_scan_handler_result_t* malloced_scan_result )
 {
     wifi_scan_hdl *scan_handler = (wifi_scan_hdl *)malloced_scan_result->user_data;
     if (malloced_scan_result->scan_complete != RTW_TRUE) {
+        nsapi_wifi_ap_t ap;
+        rtw_scan_result_t* record = &malloced_scan_result->ap_details;
+        record->SSID.val[record->SSID.len] = 0; /* Ensure the SSID is null terminated */
+        memset((void*)&ap, 0x00, sizeof(nsapi_wifi_ap_t));
+        memcpy(ap.ssid, record->SSID.val, record->SSID.len);
+        memcpy(ap.bssid, record->BSSID.octet, 6);
+        ap.security = scan_security(record->security);
+        ap.rssi = record->signal_strength;
+        ap.channel = record->channel;
+
+        WiFiAccessPoint access_point(ap);
+        scan_handler->cache->add(access_point);
         if(scan_handler->ap_details && scan_handler->scan_num > scan_handler->ap_num){
-            nsapi_wifi_ap_t ap;    
-            rtw_scan_result_t* record = &malloced_scan_result->ap_details;
-            record->SSID.val[record->SSID.len] = 0; /* Ensure the SSID is null terminated */    
-            memset((void*)&ap, 0x00, sizeof(nsapi_wifi_ap_t));
-            memcpy(ap.ssid, record->SSID.val, record->SSID.len);
-            memcpy(ap.bssid, record->BSSID.octet, 6);
-            switch (record->security){
-                case RTW_SECURITY_OPEN:
-                    ap.security = NSAPI_SECURITY_NONE;
-                    break;
-                case RTW_SECURITY_WEP_PSK:
-                case RTW_SECURITY_WEP_SHARED:
-                    ap.security = NSAPI_SECURITY_WEP;
-                    break;
-                case RTW_SECURITY_WPA_TKIP_PSK:
-                case RTW_SECURITY_WPA_AES_PSK:
-                    ap.security = NSAPI_SECURITY_WPA;
-                    break;
-                case RTW_SECURITY_WPA2_AES_PSK:
-                case RTW_SECURITY_WPA2_TKIP_PSK:
-                case RTW_SECURITY_WPA2_MIXED_PSK:
-                    ap.security = NSAPI_SECURITY_WPA2;
-                    break;
-                case RTW_SECURITY_WPA_WPA2_MIXED:
-                    ap.security = NSAPI_SECURITY_WPA_WPA2;
-                    break;
-                default:
-                    ap.security = NSAPI_SECURITY_UNKNOWN;
-                    break;
-            }
-            ap.rssi = record->signal_strength;
-            ap.channel = record->channel;
-            scan_handler->ap_details[scan_handler->ap_num] = WiFiAccessPoint(ap);
+            scan_handler->ap_details[scan_handler->ap_num] = access_point;
+        }
+        if (scan_handler->callback) {
+            scan_handler->callback(&access_point);
         }
         scan_handler->ap_num++;
+    } else if (scan_handler->callback) {
+        // background scan done
+        WiFiInterface::scan_cb_t callback = scan_handler->callback;
+        scan_handler->callback = NULL;
+        scan_handler->busy = false;
+        callback(NULL);
     } else{
         // scan done
         rtw_up_sema(&scan_handler->scan_sema);
@@ -83,6 +100,26 @@ static rtw_result_t scan_result_handler( rtw_scan_handler_result_t* malloced_sca
     return RTW_SUCCESS;
 }
 
+// Claim the scan handler for a scan
+static bool scan_claim(WiFiScanCache *cache)
+{
+    bool claimed = false;
+    core_util_critical_section_enter();
+    if (!scan_handler.busy) {
+        scan_handler.busy = true;
+        claimed = true;
+    }
+    core_util_critical_section_exit();
+    if (claimed) {
+        scan_handler.cache = cache;
+        scan_handler.ap_num = 0;
+        scan_handler.scan_num = 0;
+        scan_handler.ap_details = NULL;
+        scan_handler.callback = NULL;
+    }
+    return claimed;
+}
+
 RTWInterface::RTWInterface(bool debug)
     : _dhcp(true), _ip_address(), _netmask(), _gateway()
 {
@@ -163,12 +200,26 @@ nsapi_error_t RTWInterface::connect()
             return NSAPI_ERROR_PARAMETER;
     }
 
-    if(_channel > 0 && _channel < 14){
+    // an access point of the network found by a recent scan is joined
+    // directly, without scanning all the channels for it
+    WiFiAccessPoint ap;
+    ret = RTW_ERROR;
+    if (_channel == 0 && _scan_cache.find(_ssid, &ap)) {
+        uint8_t channel = ap.get_channel();
         uint8_t pscan_config = PSCAN_ENABLE;
-        wifi_set_pscan_chan(&_channel, &pscan_config, 1);
+        wifi_set_pscan_chan(&channel, &pscan_config, 1);
+        ret = wifi_connect_bssid((unsigned char *)ap.get_bssid(), _ssid, sec, _pass,
+                                 6, strlen(_ssid), strlen(_pass), 0, (void *)NULL);
+    }
+
+    if (ret != RTW_SUCCESS) {
+        if(_channel > 0 && _channel < 14){
+            uint8_t pscan_config = PSCAN_ENABLE;
+            wifi_set_pscan_chan(&_channel, &pscan_config, 1);
+        }
+
+        ret = wifi_connect(_ssid, sec, _pass, strlen(_ssid), strlen(_pass), 0, (void *)NULL);
     }
-    
-    ret = wifi_connect(_ssid, sec, _pass, strlen(_ssid), strlen(_pass), 0, (void *)NULL);
     if (ret != RTW_SUCCESS) {
         printf("failed: %d\r\n", ret);
         return NSAPI_ERROR_NO_CONNECTION;
@@ -183,26 +234,57 @@ nsapi_error_t RTWInterface::connect()
 
 nsapi_error_t RTWInterface::scan(WiFiAccessPoint *res, unsigned count)
 {
-    static wifi_scan_hdl scan_handler;
-    scan_handler.ap_num = 0;
+    if (!scan_claim(&_scan_cache)) {
+        return NSAPI_ERROR_IN_PROGRESS;
+    }
     if(!scan_handler.scan_sema)
         rtw_init_sema(&scan_handler.scan_sema, 0);
     scan_handler.scan_num = count;
     scan_handler.ap_details = res;
     if(wifi_scan_networks(scan_result_handler, (void *)&scan_handler) != RTW_SUCCESS){
         printf("wifi scan failed\n\r");
+        scan_handler.busy = false;
         return NSAPI_ERROR_DEVICE_ERROR;
     }
     if(rtw_down_timeout_sema( &scan_handler.scan_sema, MAX_SCAN_TIMEOUT ) == RTW_FALSE) {
         printf("wifi scan timeout\r\n");
+        scan_handler.busy = false;
         return NSAPI_ERROR_DEVICE_ERROR;
     }
+    scan_handler.busy = false;
     if(count <= 0 || count > scan_handler.ap_num)
         count = scan_handler.ap_num;
 
     return count;
 }
 
+nsapi_error_t RTWInterface::scan_async(scan_cb_t callback)
+{
+    if (!callback) {
+        return NSAPI_ERROR_PARAMETER;
+    }
+    if (!scan_claim(&_scan_cache)) {
+        return NSAPI_ERROR_IN_PROGRESS;
+    }
+    scan_handler.callback = callback;
+    if(wifi_scan_networks(scan_result_handler, (void *)&scan_handler) != RTW_SUCCESS){
+        printf("wifi scan failed\n\r");
+        scan_handler.callback = NULL;
+        scan_handler.busy = false;
+        return NSAPI_ERROR_DEVICE_ERROR;
+    }
+    return NSAPI_ERROR_OK;
+}
+
+nsapi_size_or_error_t RTWInterface::scan_cached(WiFiAccessPoint *res, unsigned count, uint32_t max_age)
+{
+    nsapi_size_t cached = _scan_cache.get(res, count, max_age);
+    if (cached > 0) {
+        return cached;
+    }
+    return scan(res, count);
+}
+
 nsapi_error_t RTWInterface::set_channel(uint8_t channel)
 {
     _channel = channel;
@@ -19,6 +19,7 @@
 
 #include "netsocket/NetworkInterface.h"
 #include "netsocket/WiFiInterface.h"
+#include "netsocket/WiFiScanCache.h"
 #include "nsapi.h"
 #include "rtos.h"
 #include "lwip/netif.h"
@@ -108,6 +109,25 @@ public:
      */
      virtual nsapi_size_or_error_t scan(WiFiAccessPoint *res, unsigned count);
 
+    /** Scan for available networks in the background
+     *
+     *  The callback is called from the RTW thread with each access point
+     *  found, then with NULL when the scan completes.
+     *  @param  callback Callback for the access points found
+     *  @return          0 on success, NSAPI_ERROR_IN_PROGRESS if a scan is running,
+     *                   negative on other errors
+     */
+     virtual nsapi_error_t scan_async(scan_cb_t callback);
+
+    /** Get the networks found by recent scans, or scan if there are none
+     *
+     *  @param  res      Pointer to allocated array to store discovered AP
+     *  @param  count    Size of allocated @a res array, or 0 to only count available AP
+     *  @param  max_age  Maximum time in milliseconds since the access points were found
+     *  @return          Number of entries in @a res, or if @a count was 0 number of available networks, negative on error
+     */
+     virtual nsapi_size_or_error_t scan_cached(WiFiAccessPoint *res, unsigned count, uint32_t max_age);
+
      virtual nsapi_error_t set_channel(uint8_t channel);
      virtual int8_t get_rssi();
 
@@ -158,6 +178,7 @@ protected:
     char _ip_address[IPADDR_STRLEN_MAX];
     char _netmask[NSAPI_IPv4_SIZE];
     char _gateway[NSAPI_IPv4_SIZE];
+    WiFiScanCache _scan_cache;
 };
 
 #endif
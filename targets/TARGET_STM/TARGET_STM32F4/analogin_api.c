@@ -35,6 +35,9 @@
 #include "pinmap.h"
 #include "mbed_error.h"
 #include "PeripheralPins.h"
+#if DEVICE_ANALOGIN_ASYNCH
+#include "timer_device.h"
+#endif
 
 void analogin_init(analogin_t *obj, PinName pin)
 {
@@ -117,79 +120,88 @@ void analogin_init(analogin_t *obj, PinName pin)
     }
 }
 
-static inline uint16_t adc_read(analogin_t *obj)
+// Selects the ADC channel and its sampling time
+static int adc_config_channel(uint8_t channel, ADC_ChannelConfTypeDef *sConfig)
 {
-    ADC_ChannelConfTypeDef sConfig = {0};
+    sConfig->SamplingTime = ADC_SAMPLETIME_15CYCLES;
 
-    // Configure ADC channel
-    sConfig.Rank         = 1;
-    sConfig.SamplingTime = ADC_SAMPLETIME_15CYCLES;
-    sConfig.Offset       = 0;
-
-    switch (obj->channel) {
+    switch (channel) {
         case 0:
-            sConfig.Channel = ADC_CHANNEL_0;
+            sConfig->Channel = ADC_CHANNEL_0;
             break;
         case 1:
-            sConfig.Channel = ADC_CHANNEL_1;
+            sConfig->Channel = ADC_CHANNEL_1;
             break;
         case 2:
-            sConfig.Channel = ADC_CHANNEL_2;
+            sConfig->Channel = ADC_CHANNEL_2;
             break;
         case 3:
-            sConfig.Channel = ADC_CHANNEL_3;
+            sConfig->Channel = ADC_CHANNEL_3;
             break;
         case 4:
-            sConfig.Channel = ADC_CHANNEL_4;
+            sConfig->Channel = ADC_CHANNEL_4;
             break;
         case 5:
-            sConfig.Channel = ADC_CHANNEL_5;
+            sConfig->Channel = ADC_CHANNEL_5;
             break;
         case 6:
-            sConfig.Channel = ADC_CHANNEL_6;
+            sConfig->Channel = ADC_CHANNEL_6;
             break;
         case 7:
-            sConfig.Channel = ADC_CHANNEL_7;
+            sConfig->Channel = ADC_CHANNEL_7;
             break;
         case 8:
-            sConfig.Channel = ADC_CHANNEL_8;
+            sConfig->Channel = ADC_CHANNEL_8;
             break;
         case 9:
-            sConfig.Channel = ADC_CHANNEL_9;
+            sConfig->Channel = ADC_CHANNEL_9;
             break;
         case 10:
-            sConfig.Channel = ADC_CHANNEL_10;
+            sConfig->Channel = ADC_CHANNEL_10;
             break;
         case 11:
-            sConfig.Channel = ADC_CHANNEL_11;
+            sConfig->Channel = ADC_CHANNEL_11;
             break;
         case 12:
-            sConfig.Channel = ADC_CHANNEL_12;
+            sConfig->Channel = ADC_CHANNEL_12;
             break;
         case 13:
-            sConfig.Channel = ADC_CHANNEL_13;
+            sConfig->Channel = ADC_CHANNEL_13;
             break;
         case 14:
-            sConfig.Channel = ADC_CHANNEL_14;
+            sConfig->Channel = ADC_CHANNEL_14;
             break;
         case 15:
-            sConfig.Channel = ADC_CHANNEL_15;
+            sConfig->Channel = ADC_CHANNEL_15;
             break;
         case 16:
-            sConfig.Channel = ADC_CHANNEL_TEMPSENSOR;
+            sConfig->Channel = ADC_CHANNEL_TEMPSENSOR;
             break;
         case 17:
-            sConfig.Channel = ADC_CHANNEL_VREFINT;
+            sConfig->Channel = ADC_CHANNEL_VREFINT;
             /*  From experiment, measurement needs max sampling time to be valid */
-            sConfig.SamplingTime = ADC_SAMPLETIME_480CYCLES;
+            sConfig->SamplingTime = ADC_SAMPLETIME_480CYCLES;
             break;
         case 18:
-            sConfig.Channel = ADC_CHANNEL_VBAT;
+            sConfig->Channel = ADC_CHANNEL_VBAT;
             /*  From experiment, measurement needs max sampling time to be valid */
-            sConfig.SamplingTime = ADC_SAMPLETIME_480CYCLES;
+            sConfig->SamplingTime = ADC_SAMPLETIME_480CYCLES;
             break;
         default:
-            return 0;
+            return -1;
+    }
+    return 0;
+}
+
+static inline uint16_t adc_read(analogin_t *obj)
+{
+    ADC_ChannelConfTypeDef sConfig = {0};
+
+    // Configure ADC channel
+    sConfig.Rank         = 1;
+    sConfig.Offset       = 0;
+    if (adc_config_channel(obj->channel, &sConfig) != 0) {
+        return 0;
     }
 
     // Measuring VBAT sets the ADC_CCR_VBATE bit in ADC->CCR, and there is not
@@ -224,4 +236,226 @@ float analogin_read(analogin_t *obj)
     return (float)value * (1.0f / (float)0xFFF); // 12 bits range
 }
 
+#if DEVICE_ANALOGIN_ASYNCH
+
+/*  A stream scans its channels on each update of TIM8, and DMA2 stores the
+ *  results in the circular buffer. Only one stream runs at a time, and
+ *  TIM8 can not be used for PWM while it does.
+ */
+#define ADC_STREAM_TIM_CLK_ENABLE()     __HAL_RCC_TIM8_CLK_ENABLE()
+#define ADC_STREAM_TIM_FORCE_RESET()    __HAL_RCC_TIM8_FORCE_RESET()
+#define ADC_STREAM_TIM_RELEASE_RESET()  __HAL_RCC_TIM8_RELEASE_RESET()
+
+// Conversion of a 12-bit sample: sampling time plus 12 cycles
+#define ADC_CONVERSION_CYCLES(sampling) ((sampling) == ADC_SAMPLETIME_480CYCLES ? 492 : 27)
+
+static struct {
+    analogin_t *obj;
+    ADC_HandleTypeDef adc;
+    DMA_HandleTypeDef dma;
+    TIM_HandleTypeDef tim;
+    IRQn_Type irq;
+    uint16_t *buffer;
+    size_t length;
+    int events;
+} adc_stream;
+
+static void adc_stream_half(DMA_HandleTypeDef *hdma)
+{
+    adc_stream.events |= ANALOGIN_EVENT_HALF;
+}
+
+static void adc_stream_complete(DMA_HandleTypeDef *hdma)
+{
+    adc_stream.events |= ANALOGIN_EVENT_COMPLETE;
+}
+
+// 12-bit to 16-bit conversion, as in analogin_read_u16
+static void adc_stream_scale(uint16_t *samples, size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        uint16_t value = samples[i];
+        samples[i] = ((value << 4) & (uint16_t)0xFFF0) | ((value >> 8) & (uint16_t)0x000F);
+    }
+}
+
+int analogin_stream_start(analogin_t *const *channels, int count, uint16_t *buffer, size_t length,
+                          uint32_t sample_rate_hz, uint32_t handler, DMAUsage hint)
+{
+    ADC_ChannelConfTypeDef sConfig = {0};
+    TIM_MasterConfigTypeDef sMasterConfig = {0};
+    uint32_t scan_cycles = 0;
+
+    if (adc_stream.obj || count < 1 || count > 16 || length == 0 || length > 0xFFFF ||
+        (length % (2 * count)) != 0 || hint == DMA_USAGE_NEVER) {
+        return -1;
+    }
+
+    adc_stream.adc.Instance = channels[0]->handle.Instance;
+    for (int i = 0; i < count; i++) {
+        if (channels[i]->handle.Instance != adc_stream.adc.Instance ||
+            adc_config_channel(channels[i]->channel, &sConfig) != 0) {
+            return -1;
+        }
+        scan_cycles += ADC_CONVERSION_CYCLES(sConfig.SamplingTime);
+    }
+
+    // The ADC runs at PCLK2 / 2, each scan has to end before the next trigger
+    if (sample_rate_hz == 0 || sample_rate_hz > HAL_RCC_GetPCLK2Freq() / 2 / scan_cycles) {
+        return -1;
+    }
+
+    adc_stream.tim.Instance = TIM8;
+    if (timer_device_rate(&adc_stream.tim, sample_rate_hz) != 0) {
+        return -1;
+    }
+
+    if (adc_stream.adc.Instance == ADC1) {
+        adc_stream.dma.Instance = DMA2_Stream4;
+        adc_stream.dma.Init.Channel = DMA_CHANNEL_0;
+        adc_stream.irq = DMA2_Stream4_IRQn;
+    } else if (adc_stream.adc.Instance == ADC2) {
+        adc_stream.dma.Instance = DMA2_Stream2;
+        adc_stream.dma.Init.Channel = DMA_CHANNEL_1;
+        adc_stream.irq = DMA2_Stream2_IRQn;
+    } else {
+        adc_stream.dma.Instance = DMA2_Stream1;
+        adc_stream.dma.Init.Channel = DMA_CHANNEL_2;
+        adc_stream.irq = DMA2_Stream1_IRQn;
+    }
+
+    adc_stream.obj = channels[0];
+    adc_stream.buffer = buffer;
+    adc_stream.length = length;
+    adc_stream.events = 0;
+
+    // Scan the channels in order on each rising edge of TIM8 TRGO
+    adc_stream.adc.State = HAL_ADC_STATE_RESET;
+    adc_stream.adc.Init.ClockPrescaler        = ADC_CLOCK_SYNC_PCLK_DIV2;
+    adc_stream.adc.Init.Resolution            = ADC_RESOLUTION_12B;
+    adc_stream.adc.Init.ScanConvMode          = (count > 1) ? ENABLE : DISABLE;
+    adc_stream.adc.Init.ContinuousConvMode    = DISABLE;
+    adc_stream.adc.Init.DiscontinuousConvMode = DISABLE;
+    adc_stream.adc.Init.NbrOfDiscConversion   = 0;
+    adc_stream.adc.Init.ExternalTrigConvEdge  = ADC_EXTERNALTRIGCONVEDGE_RISING;
+    adc_stream.adc.Init.ExternalTrigConv      = ADC_EXTERNALTRIGCONV_T8_TRGO;
+    adc_stream.adc.Init.NbrOfConversion       = count;
+    adc_stream.adc.Init.DMAContinuousRequests = ENABLE;
+    adc_stream.adc.Init.DataAlign             = ADC_DATAALIGN_RIGHT;
+    adc_stream.adc.Init.EOCSelection          = ADC_EOC_SEQ_CONV;
+    if (HAL_ADC_Init(&adc_stream.adc) != HAL_OK) {
+        adc_stream.obj = NULL;
+        return -1;
+    }
+
+    ADC->CCR &= ~(ADC_CCR_VBATE | ADC_CCR_TSVREFE);
+    for (int i = 0; i < count; i++) {
+        adc_config_channel(channels[i]->channel, &sConfig);
+        sConfig.Rank = i + 1;
+        sConfig.Offset = 0;
+        HAL_ADC_ConfigChannel(&adc_stream.adc, &sConfig);
+    }
+
+    __HAL_RCC_DMA2_CLK_ENABLE();
+    adc_stream.dma.Init.Direction           = DMA_PERIPH_TO_MEMORY;
+    adc_stream.dma.Init.PeriphInc           = DMA_PINC_DISABLE;
+    adc_stream.dma.Init.MemInc              = DMA_MINC_ENABLE;
+    adc_stream.dma.Init.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
+    adc_stream.dma.Init.MemDataAlignment    = DMA_MDATAALIGN_HALFWORD;
+    adc_stream.dma.Init.Mode                = DMA_CIRCULAR;
+    adc_stream.dma.Init.Priority            = DMA_PRIORITY_HIGH;
+    adc_stream.dma.Init.FIFOMode            = DMA_FIFOMODE_DISABLE;
+    adc_stream.dma.State = HAL_DMA_STATE_RESET;
+    if (HAL_DMA_Init(&adc_stream.dma) != HAL_OK) {
+        analogin_stream_stop(channels[0]);
+        return -1;
+    }
+    adc_stream.dma.XferHalfCpltCallback = adc_stream_half;
+    adc_stream.dma.XferCpltCallback = adc_stream_complete;
+
+    NVIC_SetVector(adc_stream.irq, handler);
+    NVIC_ClearPendingIRQ(adc_stream.irq);
+    NVIC_EnableIRQ(adc_stream.irq);
+
+    if (HAL_DMA_Start_IT(&adc_stream.dma, (uint32_t)&adc_stream.adc.Instance->DR,
+                         (uint32_t)buffer, length) != HAL_OK) {
+        analogin_stream_stop(channels[0]);
+        return -1;
+    }
+    __HAL_ADC_CLEAR_FLAG(&adc_stream.adc, ADC_FLAG_OVR);
+    adc_stream.adc.Instance->CR2 |= ADC_CR2_DMA;
+    __HAL_ADC_ENABLE(&adc_stream.adc);
+
+    ADC_STREAM_TIM_CLK_ENABLE();
+    ADC_STREAM_TIM_FORCE_RESET();
+    ADC_STREAM_TIM_RELEASE_RESET();
+    adc_stream.tim.State = HAL_TIM_STATE_RESET;
+    HAL_TIM_Base_Init(&adc_stream.tim);
+    sMasterConfig.MasterOutputTrigger = TIM_TRGO_UPDATE;
+    sMasterConfig.MasterSlaveMode = TIM_MASTERSLAVEMODE_DISABLE;
+    HAL_TIMEx_MasterConfigSynchronization(&adc_stream.tim, &sMasterConfig);
+    HAL_TIM_Base_Start(&adc_stream.tim);
+    return 0;
+}
+
+int analogin_stream_irq_handler_asynch(analogin_t *obj)
+{
+    int events;
+    size_t half;
+
+    if (obj != adc_stream.obj) {
+        return 0;
+    }
+
+    HAL_DMA_IRQHandler(&adc_stream.dma);
+    events = adc_stream.events;
+    adc_stream.events = 0;
+
+    // Both halves filled since the last interrupt: the first one is being
+    // overwritten already
+    if ((events & ANALOGIN_EVENT_HALF) && (events & ANALOGIN_EVENT_COMPLETE)) {
+        events = ANALOGIN_EVENT_COMPLETE | ANALOGIN_EVENT_OVERRUN;
+    }
+    // The converter lost samples when DMA did not keep up
+    if (__HAL_ADC_GET_FLAG(&adc_stream.adc, ADC_FLAG_OVR)) {
+        __HAL_ADC_CLEAR_FLAG(&adc_stream.adc, ADC_FLAG_OVR);
+        events |= ANALOGIN_EVENT_OVERRUN;
+    }
+
+    half = adc_stream.length / 2;
+    if (events & ANALOGIN_EVENT_HALF) {
+        adc_stream_scale(adc_stream.buffer, half);
+    }
+    if (events & ANALOGIN_EVENT_COMPLETE) {
+        adc_stream_scale(adc_stream.buffer + half, half);
+    }
+    return events;
+}
+
+void analogin_stream_stop(analogin_t *obj)
+{
+    if (obj != adc_stream.obj) {
+        return;
+    }
+
+    HAL_TIM_Base_Stop(&adc_stream.tim);
+    NVIC_DisableIRQ(adc_stream.irq);
+    HAL_DMA_Abort(&adc_stream.dma);
+    __HAL_ADC_DISABLE(&adc_stream.adc);
+    adc_stream.adc.Instance->CR2 &= ~ADC_CR2_DMA;
+    __HAL_ADC_CLEAR_FLAG(&adc_stream.adc, ADC_FLAG_OVR);
+
+    // Back to the configuration of single reads, as in analogin_init
+    adc_stream.adc.Init.ScanConvMode          = DISABLE;
+    adc_stream.adc.Init.ExternalTrigConvEdge  = ADC_EXTERNALTRIGCONVEDGE_NONE;
+    adc_stream.adc.Init.ExternalTrigConv      = ADC_EXTERNALTRIGCONV_T1_CC1;
+    adc_stream.adc.Init.NbrOfConversion       = 1;
+    adc_stream.adc.Init.DMAContinuousRequests = DISABLE;
+    adc_stream.adc.Init.EOCSelection          = DISABLE;
+    HAL_ADC_Init(&adc_stream.adc);
+    adc_stream.obj = NULL;
+}
+
+#endif
+
 #endif
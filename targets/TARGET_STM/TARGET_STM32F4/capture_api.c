@@ -0,0 +1,260 @@
+/* mbed Microcontroller Library
+ *******************************************************************************
+ * Copyright (c) 2017, STMicroelectronics
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of STMicroelectronics nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************
+ */
+#include "capture_api.h"
+
+#if DEVICE_CAPTURE
+
+#include "cmsis.h"
+#include "pinmap.h"
+#include "PeripheralPins.h"
+#include "timer_device.h"
+
+/*  Capture runs on the channels of TIM2, TIM3 and TIM4, one capture object
+ *  per timer, which can not be used for PWM at the same time. TIM5 is the
+ *  us ticker and TIM1 and TIM8 pace the streams.
+ *
+ *  Rising and falling edges are captured by the channel of the pin and the
+ *  other channel of its pair (1 and 2, 3 and 4) connected to the same
+ *  input, so both are timestamped by the timer. The 16-bit TIM3 and TIM4
+ *  are extended to 32 bits with their update interrupt.
+ */
+#define CAPTURE_TIMERS  3
+
+static void capture_irq_tim2(void);
+static void capture_irq_tim3(void);
+static void capture_irq_tim4(void);
+
+static const struct {
+    TIM_TypeDef *tim;
+    IRQn_Type irq;
+    void (*vector)(void);
+} capture_timers[CAPTURE_TIMERS] = {
+    {TIM2, TIM2_IRQn, capture_irq_tim2},
+    {TIM3, TIM3_IRQn, capture_irq_tim3},
+    {TIM4, TIM4_IRQn, capture_irq_tim4},
+};
+
+static capture_t *capture_objs[CAPTURE_TIMERS];
+static capture_irq_handler capture_handlers[CAPTURE_TIMERS];
+
+static uint32_t capture_pair(uint32_t channel)
+{
+    return ((channel - 1) ^ 1) + 1;
+}
+
+static uint32_t capture_tim_channel(uint32_t channel)
+{
+    return (channel - 1) * 4;
+}
+
+static int capture_wide(capture_t *obj)
+{
+    return obj->handle.Instance == TIM2;
+}
+
+static void capture_irq(int index)
+{
+    capture_t *obj = capture_objs[index];
+    TIM_TypeDef *tim;
+    uint32_t sr;
+    uint32_t timestamps[2];
+    capture_edge edges[2];
+    int count = 0;
+
+    if (obj == NULL) {
+        return;
+    }
+    tim = obj->handle.Instance;
+
+    // Reading a capture register clears its flag
+    sr = tim->SR;
+    if (sr & (TIM_SR_CC1IF << (obj->channel - 1))) {
+        timestamps[count] = (&tim->CCR1)[obj->channel - 1];
+        edges[count++] = (obj->edges == CAPTURE_FALL) ? CAPTURE_FALL : CAPTURE_RISE;
+    }
+    if ((obj->edges == CAPTURE_BOTH) && (sr & (TIM_SR_CC1IF << (capture_pair(obj->channel) - 1)))) {
+        timestamps[count] = (&tim->CCR1)[capture_pair(obj->channel) - 1];
+        edges[count++] = CAPTURE_FALL;
+    }
+    tim->SR = ~(sr & (TIM_SR_UIF | TIM_SR_CC1OF | TIM_SR_CC2OF | TIM_SR_CC3OF | TIM_SR_CC4OF));
+
+    if (!capture_wide(obj)) {
+        // A capture in the first half of the count with the overflow still
+        // pending happened after the overflow
+        for (int i = 0; i < count; i++) {
+            uint32_t high = obj->high;
+            if ((sr & TIM_SR_UIF) && (timestamps[i] < 0x8000)) {
+                high++;
+            }
+            timestamps[i] |= high << 16;
+        }
+        if (sr & TIM_SR_UIF) {
+            obj->high++;
+        }
+    }
+
+    // Report both edges in the order they occurred
+    if ((count == 2) && ((timestamps[1] - obj->last) < (timestamps[0] - obj->last))) {
+        uint32_t timestamp = timestamps[0];
+        capture_edge edge = edges[0];
+        timestamps[0] = timestamps[1];
+        edges[0] = edges[1];
+        timestamps[1] = timestamp;
+        edges[1] = edge;
+    }
+    for (int i = 0; i < count; i++) {
+        obj->last = timestamps[i];
+        capture_handlers[index](obj->id, timestamps[i], edges[i]);
+    }
+}
+
+static void capture_irq_tim2(void)
+{
+    capture_irq(0);
+}
+
+static void capture_irq_tim3(void)
+{
+    capture_irq(1);
+}
+
+static void capture_irq_tim4(void)
+{
+    capture_irq(2);
+}
+
+static void capture_config_channel(capture_t *obj, uint32_t channel, uint32_t polarity, uint32_t selection)
+{
+    TIM_IC_InitTypeDef sConfig = {0};
+
+    sConfig.ICPolarity  = polarity;
+    sConfig.ICSelection = selection;
+    sConfig.ICPrescaler = TIM_ICPSC_DIV1;
+    sConfig.ICFilter    = 0;
+    HAL_TIM_IC_ConfigChannel(&obj->handle, &sConfig, capture_tim_channel(channel));
+}
+
+int capture_init(capture_t *obj, PinName pin, capture_edge edges, capture_irq_handler handler, uint32_t id)
+{
+    TIM_TypeDef *tim = (TIM_TypeDef *)pinmap_find_peripheral(pin, PinMap_PWM);
+    uint32_t function = pinmap_find_function(pin, PinMap_PWM);
+    int index;
+
+    for (index = 0; index < CAPTURE_TIMERS; index++) {
+        if (capture_timers[index].tim == tim) {
+            break;
+        }
+    }
+    // Complementary outputs have no capture input
+    if ((index == CAPTURE_TIMERS) || (function == (uint32_t)NC) || STM_PIN_INVERTED(function) ||
+        (capture_objs[index] != NULL)) {
+        return -1;
+    }
+
+    if (tim == TIM2) {
+        __HAL_RCC_TIM2_CLK_ENABLE();
+        __HAL_RCC_TIM2_FORCE_RESET();
+        __HAL_RCC_TIM2_RELEASE_RESET();
+    } else if (tim == TIM3) {
+        __HAL_RCC_TIM3_CLK_ENABLE();
+        __HAL_RCC_TIM3_FORCE_RESET();
+        __HAL_RCC_TIM3_RELEASE_RESET();
+    } else {
+        __HAL_RCC_TIM4_CLK_ENABLE();
+        __HAL_RCC_TIM4_FORCE_RESET();
+        __HAL_RCC_TIM4_RELEASE_RESET();
+    }
+
+    obj->pin = pin;
+    obj->id = id;
+    obj->high = 0;
+    obj->last = 0;
+    obj->index = index;
+    obj->channel = STM_PIN_CHANNEL(function);
+    obj->edges = edges;
+
+    obj->handle.Instance = tim;
+    obj->handle.State = HAL_TIM_STATE_RESET;
+    obj->handle.Init.Prescaler = 0;
+    obj->handle.Init.Period = (tim == TIM2) ? 0xFFFFFFFF : 0xFFFF;
+    obj->handle.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+    obj->handle.Init.CounterMode = TIM_COUNTERMODE_UP;
+    obj->handle.Init.RepetitionCounter = 0;
+    if (HAL_TIM_IC_Init(&obj->handle) != HAL_OK) {
+        return -1;
+    }
+
+    capture_config_channel(obj, obj->channel,
+                           (edges == CAPTURE_FALL) ? TIM_ICPOLARITY_FALLING : TIM_ICPOLARITY_RISING,
+                           TIM_ICSELECTION_DIRECTTI);
+    if (edges == CAPTURE_BOTH) {
+        capture_config_channel(obj, capture_pair(obj->channel), TIM_ICPOLARITY_FALLING,
+                               TIM_ICSELECTION_INDIRECTTI);
+    }
+
+    pinmap_pinout(pin, PinMap_PWM);
+    pin_mode(pin, PullNone);
+
+    capture_objs[index] = obj;
+    capture_handlers[index] = handler;
+    NVIC_SetVector(capture_timers[index].irq, (uint32_t)capture_timers[index].vector);
+    NVIC_ClearPendingIRQ(capture_timers[index].irq);
+    NVIC_EnableIRQ(capture_timers[index].irq);
+
+    __HAL_TIM_CLEAR_FLAG(&obj->handle, TIM_FLAG_UPDATE);
+    if (tim != TIM2) {
+        __HAL_TIM_ENABLE_IT(&obj->handle, TIM_IT_UPDATE);
+    }
+    if (edges == CAPTURE_BOTH) {
+        HAL_TIM_IC_Start_IT(&obj->handle, capture_tim_channel(capture_pair(obj->channel)));
+    }
+    HAL_TIM_IC_Start_IT(&obj->handle, capture_tim_channel(obj->channel));
+    return 0;
+}
+
+void capture_free(capture_t *obj)
+{
+    NVIC_DisableIRQ(capture_timers[obj->index].irq);
+    __HAL_TIM_DISABLE_IT(&obj->handle, TIM_IT_UPDATE);
+    HAL_TIM_IC_Stop_IT(&obj->handle, capture_tim_channel(obj->channel));
+    if (obj->edges == CAPTURE_BOTH) {
+        HAL_TIM_IC_Stop_IT(&obj->handle, capture_tim_channel(capture_pair(obj->channel)));
+    }
+    HAL_TIM_IC_DeInit(&obj->handle);
+    capture_objs[obj->index] = NULL;
+}
+
+uint32_t capture_frequency(capture_t *obj)
+{
+    // The prescaler is 0, the timer counts at its input clock
+    return timer_device_clock(obj->handle.Instance);
+}
+
+#endif
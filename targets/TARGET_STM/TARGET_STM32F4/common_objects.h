@@ -110,9 +110,29 @@ struct i2c_s {
 #endif
 };
 
+#if DEVICE_CAPTURE
+struct capture_s {
+    TIM_HandleTypeDef handle;
+    PinName pin;
+    uint32_t id;
+    uint32_t high;
+    uint32_t last;
+    uint8_t index;
+    uint8_t channel;
+    uint8_t edges;
+};
+#endif
+
 #if DEVICE_FLASH
 struct flash_s {
+#if DEVICE_FLASH_ASYNCH
+    const uint8_t *data;
+    uint32_t address;
+    uint32_t remaining;
+    uint8_t active;
+#else
     uint32_t dummy;
+#endif
 };
 #endif
 
@@ -41,6 +41,9 @@ static uint32_t GetSectorSize(uint32_t Sector);
 
 int32_t flash_init(flash_t *obj)
 {
+#if DEVICE_FLASH_ASYNCH
+    obj->active = 0;
+#endif
     /* Allow Access to Flash control registers and user Falsh */
     if (HAL_FLASH_Unlock()) {
         return -1;
@@ -142,6 +145,134 @@ uint32_t flash_get_size(const flash_t *obj)
     return FLASH_SIZE;    
 }
 
+#if DEVICE_FLASH_ASYNCH
+
+#define FLASH_FLAG_ALL_ERRORS   (FLASH_FLAG_OPERR | FLASH_FLAG_WRPERR | FLASH_FLAG_PGAERR | \
+                                 FLASH_FLAG_PGPERR | FLASH_FLAG_PGSERR)
+
+static void flash_asynch_begin(flash_t *obj, uint32_t handler)
+{
+    obj->active = 1;
+    __HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_EOP | FLASH_FLAG_ALL_ERRORS);
+    __HAL_FLASH_ENABLE_IT(FLASH_IT_EOP | FLASH_IT_ERR);
+    NVIC_SetVector(FLASH_IRQn, handler);
+    NVIC_ClearPendingIRQ(FLASH_IRQn);
+    NVIC_EnableIRQ(FLASH_IRQn);
+}
+
+static void flash_asynch_end(flash_t *obj)
+{
+    NVIC_DisableIRQ(FLASH_IRQn);
+    __HAL_FLASH_DISABLE_IT(FLASH_IT_EOP | FLASH_IT_ERR);
+    CLEAR_BIT(FLASH->CR, (FLASH_CR_PG | FLASH_CR_SER | FLASH_CR_SNB));
+    __HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_EOP | FLASH_FLAG_ALL_ERRORS);
+
+    /* The caches may hold the previous contents of what was written */
+    FLASH_FlushCaches();
+    obj->active = 0;
+}
+
+/* Starts programming the next word, or byte if the rest is not word aligned.
+ * The end of operation interrupt follows each of them.
+ */
+static void flash_asynch_program_next(flash_t *obj)
+{
+    CLEAR_BIT(FLASH->CR, FLASH_CR_PSIZE);
+    if (((obj->address & 3) == 0) && (obj->remaining >= 4)) {
+        uint32_t word = obj->data[0] | (obj->data[1] << 8) | (obj->data[2] << 16) | ((uint32_t)obj->data[3] << 24);
+        FLASH->CR |= FLASH_PSIZE_WORD | FLASH_CR_PG;
+        *(__IO uint32_t *)obj->address = word;
+        obj->address += 4;
+        obj->data += 4;
+        obj->remaining -= 4;
+    } else {
+        FLASH->CR |= FLASH_PSIZE_BYTE | FLASH_CR_PG;
+        *(__IO uint8_t *)obj->address = *obj->data;
+        obj->address++;
+        obj->data++;
+        obj->remaining--;
+    }
+}
+
+int32_t flash_erase_sector_asynch(flash_t *obj, uint32_t address, uint32_t handler)
+{
+    if ((address >= (FLASH_BASE + FLASH_SIZE)) || (address < FLASH_BASE)) {
+        return -1;
+    }
+    if (obj->active || __HAL_FLASH_GET_FLAG(FLASH_FLAG_BSY)) {
+        return -1;
+    }
+
+    obj->remaining = 0;
+    flash_asynch_begin(obj, handler);
+    FLASH_Erase_Sector(GetSector(address), FLASH_VOLTAGE_RANGE_3);
+    return 0;
+}
+
+int32_t flash_program_page_asynch(flash_t *obj, uint32_t address, const uint8_t *data, uint32_t size, uint32_t handler)
+{
+    if ((address >= (FLASH_BASE + FLASH_SIZE)) || (address < FLASH_BASE) ||
+        (size > FLASH_BASE + FLASH_SIZE - address) || (size == 0)) {
+        return -1;
+    }
+    if (obj->active || __HAL_FLASH_GET_FLAG(FLASH_FLAG_BSY)) {
+        return -1;
+    }
+
+    obj->data = data;
+    obj->address = address;
+    obj->remaining = size;
+    flash_asynch_begin(obj, handler);
+    flash_asynch_program_next(obj);
+    return 0;
+}
+
+uint32_t flash_irq_handler_asynch(flash_t *obj)
+{
+    if (!obj->active) {
+        return 0;
+    }
+
+    if (FLASH->SR & FLASH_FLAG_ALL_ERRORS) {
+        flash_asynch_end(obj);
+        return FLASH_EVENT_ERROR;
+    }
+
+    if (!__HAL_FLASH_GET_FLAG(FLASH_FLAG_EOP)) {
+        return 0;
+    }
+    __HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_EOP);
+
+    if (obj->remaining > 0) {
+        flash_asynch_program_next(obj);
+        return 0;
+    }
+
+    flash_asynch_end(obj);
+    return FLASH_EVENT_COMPLETE;
+}
+
+uint8_t flash_active(flash_t *obj)
+{
+    return obj->active;
+}
+
+void flash_abort_asynch(flash_t *obj)
+{
+    if (!obj->active) {
+        return;
+    }
+
+    /* A started erase or program can not be stopped, only the rest of the
+     * page is skipped
+     */
+    __HAL_FLASH_DISABLE_IT(FLASH_IT_EOP | FLASH_IT_ERR);
+    while (__HAL_FLASH_GET_FLAG(FLASH_FLAG_BSY));
+    flash_asynch_end(obj);
+}
+
+#endif
+
 /**
   * @brief  Gets the sector of a given address
   * @param  None
@@ -0,0 +1,149 @@
+/* mbed Microcontroller Library
+ *******************************************************************************
+ * Copyright (c) 2017, STMicroelectronics
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of STMicroelectronics nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************
+ */
+#include "port_api.h"
+
+#if DEVICE_PORTOUT_ASYNCH
+
+#include "cmsis.h"
+#include "timer_device.h"
+
+/*  Each update of TIM1 requests a DMA2 transfer of the next word to the
+ *  BSRR register of the port, which sets and resets the masked pins at
+ *  once. Only one stream runs at a time, and TIM1 can not be used for PWM
+ *  while it does.
+ */
+static struct {
+    port_t *obj;
+    DMA_HandleTypeDef dma;
+    TIM_HandleTypeDef tim;
+    int events;
+} port_stream;
+
+static void port_stream_half(DMA_HandleTypeDef *hdma)
+{
+    port_stream.events |= PORT_EVENT_HALF;
+}
+
+static void port_stream_complete(DMA_HandleTypeDef *hdma)
+{
+    port_stream.events |= PORT_EVENT_COMPLETE;
+}
+
+uint32_t port_stream_word(port_t *obj, int value)
+{
+    return (value & obj->mask) | ((~value & obj->mask) << 16);
+}
+
+int port_stream_start(port_t *obj, const uint32_t *buffer, size_t length, uint32_t rate_hz, int circular,
+                      uint32_t handler, DMAUsage hint)
+{
+    if (port_stream.obj || obj->direction != PIN_OUTPUT || length == 0 || length > 0xFFFF ||
+        (circular && (length % 2) != 0) || hint == DMA_USAGE_NEVER) {
+        return -1;
+    }
+
+    port_stream.tim.Instance = TIM1;
+    if (timer_device_rate(&port_stream.tim, rate_hz) != 0) {
+        return -1;
+    }
+
+    port_stream.obj = obj;
+    port_stream.events = 0;
+
+    __HAL_RCC_DMA2_CLK_ENABLE();
+    port_stream.dma.Instance                 = DMA2_Stream5;
+    port_stream.dma.Init.Channel             = DMA_CHANNEL_6;
+    port_stream.dma.Init.Direction           = DMA_MEMORY_TO_PERIPH;
+    port_stream.dma.Init.PeriphInc           = DMA_PINC_DISABLE;
+    port_stream.dma.Init.MemInc              = DMA_MINC_ENABLE;
+    port_stream.dma.Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
+    port_stream.dma.Init.MemDataAlignment    = DMA_MDATAALIGN_WORD;
+    port_stream.dma.Init.Mode                = circular ? DMA_CIRCULAR : DMA_NORMAL;
+    port_stream.dma.Init.Priority            = DMA_PRIORITY_HIGH;
+    port_stream.dma.Init.FIFOMode            = DMA_FIFOMODE_DISABLE;
+    port_stream.dma.State = HAL_DMA_STATE_RESET;
+    if (HAL_DMA_Init(&port_stream.dma) != HAL_OK) {
+        port_stream.obj = NULL;
+        return -1;
+    }
+    // The half transfer interrupt is only enabled with its callback
+    port_stream.dma.XferHalfCpltCallback = circular ? port_stream_half : NULL;
+    port_stream.dma.XferCpltCallback = port_stream_complete;
+
+    NVIC_SetVector(DMA2_Stream5_IRQn, handler);
+    NVIC_ClearPendingIRQ(DMA2_Stream5_IRQn);
+    NVIC_EnableIRQ(DMA2_Stream5_IRQn);
+
+    // BSRR is the word after ODR
+    if (HAL_DMA_Start_IT(&port_stream.dma, (uint32_t)buffer, (uint32_t)(obj->reg_out + 1), length) != HAL_OK) {
+        NVIC_DisableIRQ(DMA2_Stream5_IRQn);
+        port_stream.obj = NULL;
+        return -1;
+    }
+
+    __HAL_RCC_TIM1_CLK_ENABLE();
+    __HAL_RCC_TIM1_FORCE_RESET();
+    __HAL_RCC_TIM1_RELEASE_RESET();
+    port_stream.tim.State = HAL_TIM_STATE_RESET;
+    HAL_TIM_Base_Init(&port_stream.tim);
+    __HAL_TIM_CLEAR_FLAG(&port_stream.tim, TIM_FLAG_UPDATE);
+    __HAL_TIM_ENABLE_DMA(&port_stream.tim, TIM_DMA_UPDATE);
+    HAL_TIM_Base_Start(&port_stream.tim);
+    return 0;
+}
+
+int port_stream_irq_handler_asynch(port_t *obj)
+{
+    int events;
+
+    if (obj != port_stream.obj) {
+        return 0;
+    }
+
+    HAL_DMA_IRQHandler(&port_stream.dma);
+    events = port_stream.events;
+    port_stream.events = 0;
+    return events;
+}
+
+void port_stream_stop(port_t *obj)
+{
+    if (obj != port_stream.obj) {
+        return;
+    }
+
+    HAL_TIM_Base_Stop(&port_stream.tim);
+    __HAL_TIM_DISABLE_DMA(&port_stream.tim, TIM_DMA_UPDATE);
+    NVIC_DisableIRQ(DMA2_Stream5_IRQn);
+    HAL_DMA_Abort(&port_stream.dma);
+    port_stream.obj = NULL;
+}
+
+#endif
@@ -435,6 +435,13 @@ int can_filter(can_t *obj, uint32_t id, uint32_t mask, CANFormat format, int32_t
     return retval;
 }
 
+int can_filter_banks(can_t *obj)
+{
+    // single CAN devices have 14 banks, and can_filter starts the banks of
+    // the second CAN of dual CAN devices at 14 or above
+    return 14;
+}
+
 static void can_irq(CANName name, int id)
 {
     uint32_t tmp1 = 0, tmp2 = 0, tmp3 = 0;
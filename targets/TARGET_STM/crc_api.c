@@ -0,0 +1,98 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* CRC unit of the STM32 families with a programmable polynomial, enabled for
+ * the STM32F7 and L4 targets. The data is fed byte by byte, the input and
+ * output bit reversals of the unit do the reflections.
+ */
+
+#if DEVICE_CRC
+
+#include "cmsis.h"
+#include "crc_api.h"
+#include "mbed_error.h"
+
+static CRC_HandleTypeDef current_state;
+static uint32_t final_xor;
+static uint32_t crc_mask;
+
+bool hal_crc_is_supported(const crc_mbed_config_t *config)
+{
+    if (config == NULL) {
+        return false;
+    }
+    switch (config->width) {
+        case 32:
+        case 16:
+        case 8:
+        case 7:
+            return true;
+        default:
+            return false;
+    }
+}
+
+void hal_crc_compute_partial_start(const crc_mbed_config_t *config)
+{
+    __HAL_RCC_CRC_CLK_ENABLE();
+
+    final_xor = config->final_xor;
+    crc_mask = (config->width == 32) ? 0xFFFFFFFF : ((1UL << config->width) - 1);
+
+    current_state.Instance = CRC;
+    current_state.InputDataFormat = CRC_INPUTDATA_FORMAT_BYTES;
+    current_state.Init.DefaultPolynomialUse = DEFAULT_POLYNOMIAL_DISABLE;
+    current_state.Init.GeneratingPolynomial = config->polynomial;
+    switch (config->width) {
+        case 32:
+            current_state.Init.CRCLength = CRC_POLYLENGTH_32B;
+            break;
+        case 16:
+            current_state.Init.CRCLength = CRC_POLYLENGTH_16B;
+            break;
+        case 8:
+            current_state.Init.CRCLength = CRC_POLYLENGTH_8B;
+            break;
+        default:
+            current_state.Init.CRCLength = CRC_POLYLENGTH_7B;
+            break;
+    }
+    current_state.Init.DefaultInitValueUse = DEFAULT_INIT_VALUE_DISABLE;
+    current_state.Init.InitValue = config->initial_xor;
+    current_state.Init.InputDataInversionMode =
+        config->reflect_in ? CRC_INPUTDATA_INVERSION_BYTE : CRC_INPUTDATA_INVERSION_NONE;
+    current_state.Init.OutputDataInversionMode =
+        config->reflect_out ? CRC_OUTPUTDATA_INVERSION_ENABLE : CRC_OUTPUTDATA_INVERSION_DISABLE;
+
+    if (HAL_CRC_Init(&current_state) != HAL_OK) {
+        error("CRC initialization failed");
+    }
+    __HAL_CRC_DR_RESET(&current_state);
+}
+
+void hal_crc_compute_partial(const uint8_t *data, const size_t size)
+{
+    if (data && size) {
+        HAL_CRC_Accumulate(&current_state, (uint32_t *)data, size);
+    }
+}
+
+uint32_t hal_crc_get_result(void)
+{
+    return (current_state.Instance->DR ^ final_xor) & crc_mask;
+}
+
+#endif // DEVICE_CRC
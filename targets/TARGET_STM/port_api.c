@@ -43,6 +43,16 @@ PinName port_pin(PortName port, int pin_n)
     return (PinName)(pin_n + (port << 4));
 }
 
+int pin_port(PinName pin, PortName *port, int *pin_n)
+{
+    if (pin == (PinName)NC) {
+        return 0;
+    }
+    *port = (PortName)STM_PORT(pin);
+    *pin_n = STM_PIN(pin);
+    return 1;
+}
+
 void port_init(port_t *obj, PortName port, int mask, PinDirection dir)
 {
     uint32_t port_index = (uint32_t)port;
@@ -87,7 +97,10 @@ void port_mode(port_t *obj, PinMode mode)
 
 void port_write(port_t *obj, int value)
 {
-    *obj->reg_out = (*obj->reg_out & ~obj->mask) | (value & obj->mask);
+    // BSRR is the word after ODR on all families, writing it sets and
+    // resets the masked pins at once without touching the others
+    __IO uint32_t *reg_set = obj->reg_out + 1;
+    *reg_set = (value & obj->mask) | ((~value & obj->mask) << 16);
 }
 
 int port_read(port_t *obj)
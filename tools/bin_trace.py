@@ -0,0 +1,161 @@
+#!/usr/bin/env python
+"""
+mbed SDK
+Copyright (c) 2017 ARM Limited
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+Decoder for the records of platform/mbed_bin_trace.h
+
+The format strings are read from the ELF image the firmware was built
+from, the records from a file, or a serial port the target drains its
+trace buffer to.
+"""
+
+import re
+import sys
+import struct
+import argparse
+
+MAGIC = 0xB7
+HEADER_WORDS = 3
+MAX_ARGS = 6
+
+PT_LOAD = 1
+
+RE_SPEC = re.compile(r'%([-+ #0]*)(\d*|\*)(?:\.(\d*))?(hh|h|ll|l|z|j|t)?([diouxXcsp%])')
+
+
+class ElfImage(object):
+    """Reads the loadable contents of a 32-bit little-endian ELF file"""
+
+    def __init__(self, path):
+        with open(path, 'rb') as elf:
+            data = elf.read()
+        if data[:4] != b'\x7fELF' or data[4:5] != b'\x01' or data[5:6] != b'\x01':
+            raise ValueError("%s is not a 32-bit little-endian ELF file" % path)
+        phoff, = struct.unpack_from('<I', data, 28)
+        phentsize, phnum = struct.unpack_from('<HH', data, 42)
+        self.segments = []
+        for i in range(phnum):
+            p_type, p_offset, p_vaddr, _, p_filesz = struct.unpack_from(
+                '<IIIII', data, phoff + i * phentsize)
+            if p_type == PT_LOAD and p_filesz:
+                self.segments.append((p_vaddr, data[p_offset:p_offset + p_filesz]))
+
+    def string(self, address):
+        """Return the NUL-terminated string at address, or None"""
+        for base, contents in self.segments:
+            if base <= address < base + len(contents):
+                end = contents.find(b'\0', address - base)
+                if end < 0:
+                    end = len(contents)
+                return contents[address - base:end].decode('latin-1')
+        return None
+
+
+def format_message(image, fmt, args):
+    """printf fmt with the 32-bit words args"""
+    args = list(args)
+
+    def convert(match):
+        flags, width, precision, _, conv = match.groups()
+        if conv == '%':
+            return '%'
+        if width == '*':
+            width = str(struct.unpack('<i', struct.pack('<I', args.pop(0)))[0]) if args else ''
+        if not args:
+            return match.group(0)
+        value = args.pop(0)
+        spec = '%' + flags + width + ('.' + precision if precision is not None else '')
+        if conv in 'di':
+            return (spec + 'd') % struct.unpack('<i', struct.pack('<I', value))[0]
+        if conv == 'u':
+            return (spec + 'd') % value
+        if conv == 's':
+            string = image.string(value)
+            return (spec + 's') % (string if string is not None else '<0x%08x>' % value)
+        if conv == 'c':
+            return (spec + 'c') % chr(value & 0xFF)
+        if conv == 'p':
+            return (spec + 's') % ('0x%08x' % value)
+        return (spec + conv) % value
+
+    return RE_SPEC.sub(convert, fmt)
+
+
+def records(read):
+    """Yield (sequence, format address, timestamp, args) from a byte stream
+
+    read returns the next bytes of the stream, or no bytes at its end. Bytes
+    that do not start a record are skipped, so decoding can start in the
+    middle of a stream.
+    """
+    data = b''
+    while True:
+        chunk = read()
+        if not chunk:
+            return
+        data += chunk
+        while len(data) >= HEADER_WORDS * 4:
+            header, = struct.unpack_from('<I', data)
+            nargs = (header >> 16) & 0xFF
+            if header >> 24 != MAGIC or nargs > MAX_ARGS:
+                data = data[1:]
+                continue
+            size = (HEADER_WORDS + nargs) * 4
+            if len(data) < size:
+                break
+            words = struct.unpack_from('<%dI' % (HEADER_WORDS + nargs), data)
+            data = data[size:]
+            yield header & 0xFFFF, words[1], words[2], words[3:]
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode binary trace records")
+    parser.add_argument('elf', help="ELF file of the traced application")
+    parser.add_argument('input', nargs='?', default='-',
+                        help="file of records, - for stdin (default)")
+    parser.add_argument('-p', '--port', help="read the records from this serial port")
+    parser.add_argument('-b', '--baudrate', type=int, default=115200,
+                        help="baud rate of the serial port")
+    options = parser.parse_args()
+
+    image = ElfImage(options.elf)
+    if options.port:
+        import serial
+        port = serial.Serial(options.port, options.baudrate)
+        read = lambda: port.read(max(1, port.inWaiting()))
+    else:
+        if options.input == '-':
+            stream = getattr(sys.stdin, 'buffer', sys.stdin)
+        else:
+            stream = open(options.input, 'rb')
+        read = lambda: stream.read(4096)
+
+    expected = None
+    for sequence, address, timestamp, args in records(read):
+        if expected is not None and sequence != expected:
+            print("-- %d records dropped" % ((sequence - expected) & 0xFFFF))
+        expected = (sequence + 1) & 0xFFFF
+        fmt = image.string(address)
+        if fmt is None:
+            message = "<unknown format 0x%08x> %s" % (address, " ".join("0x%x" % a for a in args))
+        else:
+            message = format_message(image, fmt, args)
+        print("%10d.%06d %s" % (timestamp // 1000000, timestamp % 1000000, message))
+        sys.stdout.flush()
+
+
+if __name__ == '__main__':
+    main()
@@ -356,12 +356,17 @@ class Config(object):
     # to them)
     __allowed_keys = {
         "library": {"name": str, "config": dict, "target_overrides": dict,
-                    "macros": list, "__config_path": str},
+                    "macros": list, "__config_path": str, "optimize": str},
         "application": {"config": dict, "target_overrides": dict,
                         "macros": list, "__config_path": str,
-                        "artifact_name": str}
+                        "artifact_name": str, "optimize": dict}
     }
 
+    # Optimizations a library may ask for, in place of the one of the build
+    # profile ("default" cancels the request of a library from the
+    # application)
+    __optimization_levels = ["speed", "size", "default"]
+
     __unused_overrides = set(["target.bootloader_img", "target.restrict_size",
                               "target.mbed_app_start", "target.mbed_app_size"])
 
@@ -742,6 +747,34 @@ class Config(object):
                             "library")
         return all_params, macros
 
+    def get_optimizations(self):
+        """ Read the optimizations asked for by libraries with an "optimize"
+        key, as overridden by the "optimize" dictionary of the application
+        (indexed by library name). Libraries the application names but which
+        are not part of the build are ignored.
+
+        Arguments: None
+
+        Returns: a dictionary mapping the directory of every library with an
+        optimization to a tuple of the optimization ("speed" or "size") and
+        of the configuration file of the library
+        """
+        app_optimizations = self.app_config_data.get("optimize", {})
+        optimizations = {}
+        for lib_name, lib_data in self.lib_config_data.items():
+            level = app_optimizations.get(lib_name,
+                                          lib_data.get("optimize", "default"))
+            if level not in self.__optimization_levels:
+                raise ConfigException(
+                    "Invalid optimization '%s' for library '%s', expected "
+                    "one of %s" % (level, lib_name,
+                                   ", ".join(self.__optimization_levels)))
+            if level == "default":
+                continue
+            config_path = lib_data["__config_path"]
+            optimizations[os.path.dirname(config_path)] = (level, config_path)
+        return optimizations
+
     def get_app_config_data(self, params, macros):
         """ Read and interpret the configuration data defined by the target. The
         target can override any configuration parameter, as well as define its
@@ -0,0 +1,225 @@
+#!/usr/bin/env python
+"""
+mbed SDK
+Copyright (c) 2017 ARM Limited
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+Maker of the delta patches applied by drivers/DeltaUpdate.h
+
+A patch is a header followed by records, all words little-endian:
+
+    header: "MDP1", old size, old CRC-32, new size, new CRC-32
+    record: diff length, extra length, seek (signed)
+            diff tokens, extra bytes
+
+Each record adds diff length bytes of differences to the old image from
+the current position, copies extra length bytes to the new image, then
+moves the old position by seek. The differences are varints, even for a
+run of zeros and odd for a run of difference bytes that follow, so code
+that moved with few changes costs a few bytes. Compress the patch for
+transport if the link allows, the target applies it as it is.
+"""
+
+import sys
+import struct
+import zlib
+import argparse
+
+MAGIC = b'MDP1'
+HEADER = struct.Struct('<4sIIII')
+RECORD = struct.Struct('<IIi')
+
+GRAM = 8          # bytes a match is seeded from
+MIN_MATCH = 24    # shortest match worth a record
+CANDIDATES = 8    # old positions kept for each seed
+LOOKAHEAD = 32    # bytes a match is extended past its last improvement
+MIN_ZEROS = 4     # shortest run of zeros given its own token
+
+
+def crc32(data):
+    return zlib.crc32(bytes(data)) & 0xFFFFFFFF
+
+
+def index(old):
+    """Map each GRAM bytes of old to the first positions they are at"""
+    seeds = {}
+    for j in range(len(old) - GRAM + 1):
+        positions = seeds.setdefault(bytes(old[j:j + GRAM]), [])
+        if len(positions) < CANDIDATES:
+            positions.append(j)
+    return seeds
+
+
+def extend(old, new, j, k):
+    """Length from old[j] and new[k] over which at least half the bytes match"""
+    score = best = length = i = 0
+    limit = min(len(old) - j, len(new) - k)
+    while i < limit and i - length <= LOOKAHEAD:
+        if old[j + i] == new[k + i]:
+            score += 1
+        i += 1
+        if score * 2 - i > best * 2 - length:
+            best, length = score, i
+    return length
+
+
+def matches(old, new):
+    """Yield (new position, old position, length) of the approximate matches"""
+    seeds = index(old)
+    k = 0
+    old_end = new_end = 0
+    while k + GRAM <= len(new):
+        candidates = list(seeds.get(bytes(new[k:k + GRAM]), ()))
+        # code that is the same except for a few changed bytes continues
+        # the previous match
+        following = old_end + (k - new_end)
+        if following < len(old) and old[following] == new[k]:
+            candidates.append(following)
+
+        best_j, best_len = 0, 0
+        for j in candidates:
+            length = extend(old, new, j, k)
+            if length > best_len:
+                best_j, best_len = j, length
+
+        if best_len >= MIN_MATCH:
+            yield k, best_j, best_len
+            k += best_len
+            old_end, new_end = best_j + best_len, k
+        else:
+            k += 1
+
+
+def varint(value):
+    out = bytearray()
+    while value >= 0x80:
+        out.append((value & 0x7F) | 0x80)
+        value >>= 7
+    out.append(value)
+    return out
+
+
+def encode_diff(old, new, j, k, length):
+    """Tokens of the differences of new[k:] from old[j:] over length bytes"""
+    diff = bytearray((new[k + i] - old[j + i]) & 0xFF for i in range(length))
+    out = bytearray()
+    i = 0
+    while i < length:
+        zeros = 0
+        while i + zeros < length and diff[i + zeros] == 0:
+            zeros += 1
+        if zeros >= MIN_ZEROS or i + zeros == length:
+            out += varint(zeros << 1)
+            i += zeros
+            continue
+
+        # differences up to the next run of zeros worth a token
+        end = i
+        while end < length:
+            run = 0
+            while end + run < length and diff[end + run] == 0:
+                run += 1
+            if run >= MIN_ZEROS or end + run == length:
+                break
+            end += max(run, 1)
+        out += varint(((end - i) << 1) | 1)
+        out += diff[i:end]
+        i = end
+    return out
+
+
+def make(old, new):
+    """Patch turning old into new"""
+    found = list(matches(old, new))
+    patch = bytearray(HEADER.pack(MAGIC, len(old), crc32(old), len(new), crc32(new)))
+
+    # bytes before the first match
+    first_k, first_j = (found[0][0], found[0][1]) if found else (len(new), 0)
+    if first_k or not found:
+        patch += RECORD.pack(0, first_k, first_j)
+        patch += new[:first_k]
+
+    for n, (k, j, length) in enumerate(found):
+        if n + 1 < len(found):
+            next_k, next_j = found[n + 1][0], found[n + 1][1]
+        else:
+            next_k, next_j = len(new), j + length
+        patch += RECORD.pack(length, next_k - k - length, next_j - (j + length))
+        patch += encode_diff(old, new, j, k, length)
+        patch += new[k + length:next_k]
+
+    return patch
+
+
+def apply(old, patch):
+    """New image of a patch, as the target builds it"""
+    magic, old_size, old_crc, new_size, new_crc = HEADER.unpack_from(patch, 0)
+    if magic != MAGIC or old_size != len(old) or old_crc != crc32(old):
+        raise ValueError("patch is not for this image")
+
+    new = bytearray()
+    pos = 0
+    at = HEADER.size
+    while len(new) < new_size:
+        diff_len, extra_len, seek = RECORD.unpack_from(patch, at)
+        at += RECORD.size
+        end = len(new) + diff_len
+        while len(new) < end:
+            value, shift = 0, 0
+            while True:
+                byte = patch[at]
+                at += 1
+                value |= (byte & 0x7F) << shift
+                shift += 7
+                if not byte & 0x80:
+                    break
+            run = value >> 1
+            if value & 1:
+                new += bytearray((old[pos + i] + patch[at + i]) & 0xFF for i in range(run))
+                at += run
+            else:
+                new += old[pos:pos + run]
+            pos += run
+        new += patch[at:at + extra_len]
+        at += extra_len
+        pos += seek
+
+    if at != len(patch) or crc32(new) != new_crc:
+        raise ValueError("patch is corrupt")
+    return new
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Make delta patches of firmware images")
+    parser.add_argument("old", help="binary image on the target")
+    parser.add_argument("new", help="binary image to update the target to")
+    parser.add_argument("-o", "--output", required=True, help="patch file to write")
+    options = parser.parse_args()
+
+    with open(options.old, 'rb') as f:
+        old = bytearray(f.read())
+    with open(options.new, 'rb') as f:
+        new = bytearray(f.read())
+
+    patch = make(old, new)
+    if apply(old, patch) != new:
+        sys.exit("patch does not rebuild the new image")
+
+    with open(options.output, 'wb') as f:
+        f.write(patch)
+    print("%d byte patch for a %d byte image" % (len(patch), len(new)))
+
+
+if __name__ == '__main__':
+    main()
@@ -19,6 +19,8 @@ RE_ARMCC = re.compile(
 RE_IAR = re.compile(
     r'^\s+(.+)\s+(zero|const|ro code|inited|uninit)\s'
     r'+0x(\w{8})\s+0x(\w+)\s+(.+)\s.+$')
+RE_RESERVED_GCC = re.compile(
+    r'^(\.heap|\.stack)\w*\s+0x(\w{8,16})\s+0x(\w+)\s*$')
 
 class MemapParser(object):
     """An object that represents parsed results, parses the memory map files,
@@ -59,6 +61,14 @@ class MemapParser(object):
 
         self.misc_flash_mem = 0
 
+        # Size of the heap and stack output sections, when the map file has
+        # them without any object (reservations made by the linker script)
+        self.reserved = {'.heap': 0, '.stack': 0}
+
+        # Changes against a baseline report
+        self.mem_diff = []
+        self.diff_summary = dict()
+
 
     def remove_unused_modules(self):
         """ Removes modules/objects that were compiled but are not used
@@ -67,7 +77,7 @@ class MemapParser(object):
         # Using keys to be able to remove entry
         for i in self.modules.keys():
             size = 0
-            for k in self.print_sections:
+            for k in self.sections:
                 size += self.modules[i][k]
             if size == 0:
                 del self.modules[i]
@@ -248,6 +258,12 @@ class MemapParser(object):
                 elif change_section != False:
                     current_section = change_section
 
+                test_reserved = re.match(RE_RESERVED_GCC, line)
+                if test_reserved:
+                    section = test_reserved.group(1)
+                    self.reserved[section] = max(self.reserved[section],
+                        int(test_reserved.group(3), 16))
+
                 [object_name, object_size] = self.parse_section_gcc(line)
 
                 if object_size == 0 or object_name == "":
@@ -307,7 +323,15 @@ class MemapParser(object):
                 if test_re_armcc.group(3) == 'Data':
                     section = '.data'
                 elif test_re_armcc.group(3) == 'Zero':
-                    section = '.bss'
+                    # heap and stack come from the HEAP and STACK sections
+                    # of the startup file
+                    section_name = line.split()[-2]
+                    if section_name == 'HEAP':
+                        section = '.heap'
+                    elif section_name == 'STACK':
+                        section = '.stack'
+                    else:
+                        section = '.bss'
                 else:
                     print "Malformed input found when parsing armcc map: %s" %\
                           line
@@ -609,7 +633,8 @@ class MemapParser(object):
 
     export_formats = ["json", "csv-ci", "table"]
 
-    def generate_output(self, export_format, depth, file_output=None):
+    def generate_output(self, export_format, depth, file_output=None,
+                        baseline=None, threshold=0):
         """ Generates summary of memory map data
 
         Positional arguments:
@@ -618,12 +643,18 @@ class MemapParser(object):
         Keyword arguments:
         file_desc - descriptor (either stdout or file)
         depth - directory depth on report
+        baseline - report exported in json format to compare with, the
+                   output is then the change of every module
+        threshold - growth of a section of a module, in bytes, above which
+                    the module is flagged in the comparison
 
         Returns: generated string for the 'table' format, otherwise None
         """
 
         self.reduce_depth(depth)
         self.compute_report()
+        if baseline:
+            self.compute_diff(baseline, threshold)
 
         try:
             if file_output:
@@ -634,9 +665,14 @@ class MemapParser(object):
             print "I/O error({0}): {1}".format(error.errno, error.strerror)
             return False
 
-        to_call = {'json': self.generate_json,
-                   'csv-ci': self.generate_csv,
-                   'table': self.generate_table}[export_format]
+        if baseline:
+            to_call = {'json': self.generate_diff_json,
+                       'csv-ci': self.generate_diff_csv,
+                       'table': self.generate_diff_table}[export_format]
+        else:
+            to_call = {'json': self.generate_json,
+                       'csv-ci': self.generate_csv,
+                       'table': self.generate_table}[export_format]
         output = to_call(file_desc)
 
         if file_desc is not sys.stdout:
@@ -650,7 +686,8 @@ class MemapParser(object):
         Positional arguments:
         file_desc - the file to write out the final report to
         """
-        file_desc.write(json.dumps(self.mem_report, indent=4))
+        file_desc.write(json.dumps(self.mem_report, indent=4,
+                                   separators=(',', ': '), sort_keys=True))
         file_desc.write('\n')
 
         return None
@@ -723,6 +760,153 @@ class MemapParser(object):
 
         return output
 
+    def generate_diff_json(self, file_desc):
+        """Generate a json file from the comparison with a baseline
+
+        Positional arguments:
+        file_desc - the file to write out the comparison to
+        """
+        report = self.mem_diff + [{'summary': self.diff_summary}]
+        file_desc.write(json.dumps(report, indent=4,
+                                   separators=(',', ': '), sort_keys=True))
+        file_desc.write('\n')
+
+        return None
+
+    def generate_diff_csv(self, file_desc):
+        """Generate a CSV file from the comparison with a baseline
+
+        Positional arguments:
+        file_desc - the file to write out the comparison to
+        """
+        csv_writer = csv.writer(file_desc, delimiter=',',
+                                quoting=csv.QUOTE_MINIMAL)
+
+        csv_module_section = []
+        csv_sizes = []
+        for entry in self.mem_diff:
+            for k in self.print_sections:
+                csv_module_section += [entry['module']+k]
+                csv_sizes += [entry['delta'][k]]
+
+        for k in sorted(self.diff_summary):
+            csv_module_section += [k]
+            csv_sizes += [self.diff_summary[k]]
+
+        csv_writer.writerow(csv_module_section)
+        csv_writer.writerow(csv_sizes)
+
+        return None
+
+    def generate_diff_table(self, file_desc):
+        """Generate a table from the comparison with a baseline
+
+        Returns: string of the generated table
+        """
+        columns = ['Module']
+        columns.extend(self.print_sections)
+        columns.append('')
+
+        table = PrettyTable(columns)
+        table.align["Module"] = "l"
+        for col in self.print_sections:
+            table.align[col] = 'r'
+
+        for entry in self.mem_diff:
+            row = [entry['module']]
+
+            for k in self.print_sections:
+                row.append("%+d" % entry['delta'][k])
+
+            row.append('!' if entry['flagged'] else '')
+            table.add_row(row)
+
+        output = table.get_string()
+        output += '\n'
+
+        output += "Static RAM memory (data + bss): %+d bytes\n" % \
+                        self.diff_summary['static_ram']
+        output += "Flash memory (text + data): %+d bytes\n" % \
+                        self.diff_summary['total_flash']
+        output += "Heap reservation: %+d bytes\n" % \
+                        self.diff_summary['heap']
+        output += "Stack reservation: %+d bytes\n" % \
+                        self.diff_summary['stack']
+
+        flagged = len(self.flagged_modules())
+        if flagged:
+            output += "%d module(s) grew by more than the threshold (!)\n" % \
+                        flagged
+
+        return output
+
+    @staticmethod
+    def load_report(report_file):
+        """ Load a report exported in json format
+
+        Positional arguments:
+        report_file - the file name of the report
+
+        Returns: the sizes of every module, and the summary of the report
+        """
+
+        with open(report_file, 'r') as file_input:
+            report = json.load(file_input)
+
+        modules = dict()
+        summary = dict()
+        for entry in report:
+            if 'module' in entry:
+                modules[entry['module']] = entry['size']
+            elif 'summary' in entry:
+                summary = entry['summary']
+
+        return modules, summary
+
+    def compute_diff(self, baseline, threshold=0):
+        """ Compute the change of every module since a baseline report. The
+        baseline must have been exported with the same depth.
+
+        Positional arguments:
+        baseline - the file name of the baseline report, in json format
+
+        Keyword arguments:
+        threshold - growth of a section of a module, in bytes, above which
+                    the module is flagged
+        """
+
+        old_modules, old_summary = self.load_report(baseline)
+
+        self.mem_diff = []
+        for i in sorted(set(old_modules) | set(self.short_modules)):
+            old_sizes = old_modules.get(i, {})
+            new_sizes = self.short_modules.get(i, {})
+
+            delta = {
+                k:new_sizes.get(k, 0) - old_sizes.get(k, 0)
+                for k in self.print_sections
+            }
+            if not any(delta.values()):
+                continue
+
+            self.mem_diff.append({
+                "module":i,
+                "delta":delta,
+                "flagged":any(v > threshold for v in delta.values())
+            })
+
+        self.diff_summary = {
+            k:self.mem_summary[k] - old_summary.get(k, 0)
+            for k in self.mem_summary
+        }
+
+    def flagged_modules(self):
+        """ List the modules which grew beyond the threshold in the last
+        comparison
+        """
+
+        return [entry['module'] for entry in self.mem_diff if entry['flagged']]
+
     toolchains = ["ARM", "ARM_STD", "ARM_MICRO", "GCC_ARM", "GCC_CR", "IAR"]
 
     def compute_report(self):
@@ -739,6 +923,8 @@ class MemapParser(object):
         self.mem_summary = {
             'static_ram': (self.subtotal['.data'] + self.subtotal['.bss']),
             'total_flash': (self.subtotal['.text'] + self.subtotal['.data']),
+            'heap': max(self.subtotal['.heap'], self.reserved['.heap']),
+            'stack': max(self.subtotal['.stack'], self.reserved['.stack']),
         }
 
         self.mem_report = []
@@ -788,7 +974,7 @@ class MemapParser(object):
 def main():
     """Entry Point"""
 
-    version = '0.4.0'
+    version = '0.5.0'
 
     # Parser handling
     parser = argparse.ArgumentParser(
@@ -819,6 +1005,17 @@ def main():
         help="export format (examples: %s: default)" %
         ", ".join(MemapParser.export_formats))
 
+    parser.add_argument(
+        '--diff', dest='baseline', type=argparse_filestring_type,
+        required=False,
+        help='report exported with "-e json" to compare with, at the same '
+        'depth; exits with 1 when a module grew beyond the threshold')
+
+    parser.add_argument(
+        '--threshold', dest='threshold', type=int, default=0, required=False,
+        help='growth of a section of a module, in bytes, above which the '
+        'module is flagged in the comparison (default: 0)')
+
     parser.add_argument('-v', '--version', action='version', version=version)
 
     # Parse/run command
@@ -845,13 +1042,17 @@ def main():
     # Write output in file
     if args.output != None:
         returned_string = memap.generate_output(args.export, \
-            depth, args.output)
+            depth, args.output, args.baseline, args.threshold)
     else: # Write output in screen
-        returned_string = memap.generate_output(args.export, depth)
+        returned_string = memap.generate_output(args.export, depth, \
+            baseline=args.baseline, threshold=args.threshold)
 
     if args.export == 'table' and returned_string:
         print returned_string
 
+    if args.baseline and memap.flagged_modules():
+        sys.exit(1)
+
     sys.exit(0)
 
 if __name__ == "__main__":
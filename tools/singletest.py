@@ -228,6 +228,8 @@ if __name__ == '__main__':
                                    _parser=parser,
                                    _opts=opts,
                                    _opts_db_url=opts.db_url,
+                                   _opts_metrics_db_file=opts.metrics_db_file,
+                                   _opts_metrics_threshold=opts.metrics_threshold,
                                    _opts_log_file_name=opts.log_file_name,
                                    _opts_report_html_file_name=opts.report_html_file_name,
                                    _opts_report_junit_file_name=opts.report_junit_file_name,
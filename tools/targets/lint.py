@@ -77,12 +77,13 @@ def check_inherits(dict):
     if  ("inherits" in dict and len(dict["inherits"]) > 1):
         yield "multiple inheritance is forbidden"
 
-DEVICE_HAS_ALLOWED = ["ANALOGIN", "ANALOGOUT", "CAN", "ETHERNET", "EMAC",
-                      "FLASH", "I2C", "I2CSLAVE", "I2C_ASYNCH", "INTERRUPTIN",
-                      "LOWPOWERTIMER", "PORTIN", "PORTINOUT", "PORTOUT",
-                      "PWMOUT", "RTC", "TRNG","SERIAL", "SERIAL_ASYNCH",
-                      "SERIAL_FC", "SLEEP", "SPI", "SPI_ASYNCH", "SPISLAVE",
-                      "STORAGE"]
+DEVICE_HAS_ALLOWED = ["ANALOGIN", "ANALOGIN_ASYNCH", "ANALOGOUT", "CAN",
+                      "CAPTURE", "CRC", "ETHERNET", "EMAC", "FLASH",
+                      "FLASH_ASYNCH", "I2C", "I2CSLAVE", "I2C_ASYNCH",
+                      "INTERRUPTIN", "LOWPOWERTIMER", "PORTIN", "PORTINOUT",
+                      "PORTOUT", "PORTOUT_ASYNCH", "PWMOUT", "RTC", "TRNG",
+                      "SERIAL", "SERIAL_ASYNCH", "SERIAL_FC", "SLEEP", "SPI",
+                      "SPI_ASYNCH", "SPISLAVE", "STORAGE"]
 def check_device_has(dict):
     for name in dict.get("device_has", []):
         if name not in DEVICE_HAS_ALLOWED:
@@ -173,3 +173,37 @@ def test_init_override_app_config(target):
 
         mock_json_file_to_dict.assert_called_once_with(app_config)
         assert config.app_config_data == mock_return
+
+
+@pytest.mark.parametrize("target", ["K64F"])
+def test_get_optimizations(target):
+    """
+    Test that the optimizations of libraries are reported by directory, and
+    that the application overrides them
+
+    :param target: The target to use
+    """
+    set_targets_json_location()
+    with patch.object(Config, '_process_config_and_overrides'),\
+         patch('tools.config.json_file_to_dict') as mock_json_file_to_dict:
+        mock_json_file_to_dict.return_value = {
+            'optimize': {'lib2': 'default', 'lib3': 'size', 'lib5': 'speed'}}
+
+        config = Config(target, app_config="app_config")
+        config.lib_config_data = {
+            'lib1': {'optimize': 'speed',
+                     '__config_path': join('a', 'lib1', 'mbed_lib.json')},
+            'lib2': {'optimize': 'speed',
+                     '__config_path': join('a', 'lib2', 'mbed_lib.json')},
+            'lib3': {'__config_path': join('a', 'lib3', 'mbed_lib.json')},
+            'lib4': {'__config_path': join('a', 'lib4', 'mbed_lib.json')},
+        }
+
+        assert config.get_optimizations() == {
+            join('a', 'lib1'): ('speed', join('a', 'lib1', 'mbed_lib.json')),
+            join('a', 'lib3'): ('size', join('a', 'lib3', 'mbed_lib.json')),
+        }
+
+        config.lib_config_data['lib4']['optimize'] = 'fast'
+        with pytest.raises(ConfigException):
+            config.get_optimizations()
@@ -208,3 +208,61 @@ def test_generate_output_csv_ci(memap_parser, tmpdir, depth):
     file_name = str(tmpdir.join('output.csv').realpath())
     generate_test_helper(memap_parser, 'csv-ci', depth, file_name)
     assert isfile(file_name), "Failed to create csv-ci file"
+
+
+def test_json_report_stable(memap_parser, tmpdir):
+    """
+    Test that the json report does not depend on the order of the modules,
+    and that it carries the heap and stack reservations
+
+    :param memap_parser: Mocked parser
+    :param tmpdir: a unique location to place an output file
+    """
+    file_name = str(tmpdir.join('output.json').realpath())
+    memap_parser.modules["main.o"][".stack"] = 1024
+    memap_parser.reserved[".heap"] = 4096
+    memap_parser.generate_output('json', 2, file_name)
+    first = open(file_name).read()
+
+    memap_parser.modules = dict(reversed(list(memap_parser.modules.items())))
+    memap_parser.generate_output('json', 2, file_name)
+    assert open(file_name).read() == first
+
+    summary = json.loads(first)[-1]['summary']
+    assert summary['stack'] == 1024
+    assert summary['heap'] == 4096
+
+
+@pytest.mark.parametrize("threshold, flagged", [(0, ["main.o"]), (16, [])])
+def test_generate_output_diff(memap_parser, tmpdir, threshold, flagged):
+    """
+    Test that a comparison with a baseline reports the changes of the
+    modules and flags those which grew beyond the threshold
+
+    :param memap_parser: Mocked parser
+    :param tmpdir: a unique location to place an output file
+    :param threshold: the growth allowed for a section of a module
+    :param flagged: the modules expected to be flagged
+    """
+    baseline = str(tmpdir.join('baseline.json').realpath())
+    memap_parser.generate_output('json', 2, baseline)
+
+    memap_parser.modules["main.o"][".text"] += 16
+    memap_parser.modules["main.o"][".stack"] += 256
+    memap_parser.modules["[lib]/libc.a/lib_a-printf.o"][".bss"] -= 6
+
+    memap_parser.generate_output('table', 2, baseline=baseline,
+                                 threshold=threshold)
+    assert memap_parser.flagged_modules() == flagged
+
+    changes = dict((entry['module'], entry['delta'])
+                   for entry in memap_parser.mem_diff)
+    assert sorted(changes) == ["[lib]/libc.a", "main.o"]
+    assert changes["main.o"][".text"] == 16
+    assert changes["[lib]/libc.a"][".bss"] == -6
+    assert memap_parser.diff_summary['stack'] == 256
+    assert memap_parser.diff_summary['static_ram'] == -6
+
+    file_name = str(tmpdir.join('diff.json').realpath())
+    generate_test_helper(memap_parser, 'json', 2, file_name)
+    json.load(open(file_name))
@@ -0,0 +1,105 @@
+"""
+mbed SDK
+Copyright (c) 2017 ARM Limited
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+"""
+import sys
+from os.path import isfile, join
+
+ROOT = join(__file__, '..', '..', '..', '..')
+sys.path.insert(0, ROOT)
+
+from tools.test_metrics import MetricsDatabase, parse_benchmarks
+
+OUTPUT = """
+{{__testcase_start;memcpy 1KB}}
+>>> Benchmark 'memcpy 1KB': 50 iterations, min 310, median 312, p99 400, max 410, mean 315 cycles, 2 outliers
+{{benchmark;memcpy 1KB;cycles;50;310;312;400;410;315;2}}
+{{__testcase_finish;memcpy 1KB;1;0}}
+{{benchmark;crc32 256B;us;20;11;12;14;15;12;0}}
+"""
+
+
+def make_benchmark(name, median):
+    return {'name': name, 'unit': 'cycles', 'iterations': 10, 'min': median,
+            'median': median, 'p99': median, 'max': median, 'mean': median,
+            'outliers': 0}
+
+
+def test_parse_benchmarks():
+    """
+    Benchmark key-value messages are extracted from the output of a test
+    """
+    benchmarks = parse_benchmarks(OUTPUT)
+    assert len(benchmarks) == 2
+    assert benchmarks[0] == {'name': 'memcpy 1KB', 'unit': 'cycles',
+                             'iterations': 50, 'min': 310, 'median': 312,
+                             'p99': 400, 'max': 410, 'mean': 315,
+                             'outliers': 2}
+    assert benchmarks[1]['name'] == 'crc32 256B'
+    assert benchmarks[1]['unit'] == 'us'
+    assert parse_benchmarks("{{__testcase_start;memcpy}}") == []
+
+
+def test_compare_previous_commit():
+    """
+    A commit is compared with the previous commit each benchmark ran for,
+    and slowdowns above the threshold are regressions
+    """
+    database = MetricsDatabase()
+    database.add('aaaa', 'K64F', 'GCC_ARM', 'tests-a', [make_benchmark('fast', 100), make_benchmark('slow', 100)])
+    database.add('bbbb', 'K64F', 'GCC_ARM', 'tests-a', [make_benchmark('fast', 104), make_benchmark('slow', 120)])
+    # Best of several runs for the same commit
+    database.add('bbbb', 'K64F', 'GCC_ARM', 'tests-a', [make_benchmark('slow', 110)])
+    database.add('bbbb', 'K64F', 'ARM', 'tests-a', [make_benchmark('fast', 500)])
+
+    assert database.commits() == ['aaaa', 'bbbb']
+    rows = database.compare(threshold=5.0)
+    assert len(rows) == 3
+    by_key = dict(((row['toolchain'], row['name']), row) for row in rows)
+
+    assert by_key[('GCC_ARM', 'fast')]['baseline'] == 100
+    assert not by_key[('GCC_ARM', 'fast')]['regression']
+    assert by_key[('GCC_ARM', 'slow')]['current'] == 110
+    assert by_key[('GCC_ARM', 'slow')]['regression']
+    # Nothing to compare with
+    assert by_key[('ARM', 'fast')]['baseline'] is None
+    assert not by_key[('ARM', 'fast')]['regression']
+
+    regressions = MetricsDatabase.regressions(rows)
+    assert [row['name'] for row in regressions] == ['slow']
+    assert 'REGRESSION' in MetricsDatabase.generate_table(rows)
+
+    # Explicit commits
+    rows = database.compare('aaaa')
+    assert all(row['baseline'] is None for row in rows)
+    rows = database.compare('bbbb', baseline='aaaa', threshold=15.0)
+    assert not MetricsDatabase.regressions(rows)
+
+
+def test_database_round_trip(tmpdir):
+    """
+    The database is stored as JSON and read back identically
+    """
+    path = tmpdir.join('metrics.json').realpath()
+    database = MetricsDatabase(path)
+    database.add('aaaa', 'K64F', 'GCC_ARM', 'tests-a', parse_benchmarks(OUTPUT), timestamp=1)
+    database.save()
+    assert isfile(path)
+
+    loaded = MetricsDatabase(path)
+    assert loaded.records == database.records
+    assert loaded.records[0]['commit'] == 'aaaa'
+    assert loaded.records[0]['timestamp'] == 1
+    assert 'aaaa' in loaded.generate_trend()
@@ -145,3 +145,31 @@ def test_path_specified_gcc(gcc_loc, exists_at_loc, exists_in_path):
                 assert TOOLCHAIN_PATHS['GCC_ARM'] == gcc_loc
             elif exists_in_path:
                 assert TOOLCHAIN_PATHS['GCC_ARM'] == ''
+
+def test_toolchain_optimization():
+    """Test that the sources of a library asking for an optimization are
+    compiled with the optimization flags of the toolchain, unless the
+    profile does not optimize"""
+    lib_dir = os.path.join(ROOT, "lib")
+    source = os.path.join(lib_dir, "src", "hot.c")
+    for _, tc_class in TOOLCHAIN_CLASSES.items():
+        for level in ["speed", "size"]:
+            toolchain = tc_class(TARGET_MAP["K64F"],
+                                 build_profile={'common': ["-Ofast"], 'c': [],
+                                                'cxx': [], 'asm': [], 'ld': []})
+            toolchain.optimizations = {
+                lib_dir: (level, os.path.join(lib_dir, "mbed_lib.json"))}
+            assert toolchain.get_optimization(source) == \
+                (level, os.path.join(lib_dir, "mbed_lib.json"))
+            assert toolchain.get_optimization(lib_dir + "2.c") == (None, None)
+
+            commands = toolchain.apply_optimization([toolchain.cc + [source]],
+                                                    level)
+            for flag in toolchain.OPTIMIZATION_FLAGS[level]:
+                assert flag in commands[0]
+            assert "-Ofast" not in commands[0]
+
+            unoptimized = [toolchain.cc + toolchain.NO_OPTIMIZATION_FLAGS +
+                           [source]]
+            assert toolchain.apply_optimization(unoptimized, level) == \
+                unoptimized
@@ -43,6 +43,7 @@ class BaseDBAccess():
         self.TABLE_TEST_RESULT = 'mtest_test_result'
         self.TABLE_TEST_TYPE = 'mtest_test_type'
         self.TABLE_TOOLCHAIN = 'mtest_toolchain'
+        self.TABLE_METRIC_ENTRY = 'mtest_metric_entry'
         # Build ID status PKs
         self.BUILD_ID_STATUS_STARTED = 1 # Started
         self.BUILD_ID_STATUS_IN_PROGRESS = 2 # In Progress
@@ -163,3 +164,12 @@ class BaseDBAccess():
             If some data is missing DB will be updated
         """
         pass
+
+    def insert_metric_entry(self, build_id, target, toolchain, test_id, commit, benchmark):
+        """ Inserts the result of a benchmark reported by a test, as returned by
+            tools.test_metrics.parse_benchmarks(), to database. Metric entries
+            reference the same build_id, target, toolchain and test_id tables as
+            test entries, and add the commit, the benchmark name, its unit and
+            its statistics (iterations, min, median, p99, max, mean, outliers)
+        """
+        pass
@@ -0,0 +1,317 @@
+#!/usr/bin/env python
+
+"""
+mbed SDK
+Copyright (c) 2017 ARM Limited
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+Performance metrics reported by tests, and their trend across commits
+"""
+
+import sys
+import re
+import json
+import argparse
+from time import time
+from subprocess import Popen, PIPE
+from os.path import dirname, abspath, exists
+
+ROOT = abspath(dirname(dirname(__file__)))
+sys.path.insert(0, ROOT)
+
+from prettytable import PrettyTable
+
+from tools.utils import argparse_filestring_type
+
+# {{benchmark;<description>;<unit>;<iterations>;<min>;<median>;<p99>;<max>;<mean>;<outliers>}}
+# as sent by utest::v1::Benchmark
+RE_BENCHMARK_KV = re.compile(r'\{\{benchmark;([^;}]*);(\w+);(\d+);(\d+);(\d+);(\d+);(\d+);(\d+);(\d+)\}\}')
+
+BENCHMARK_FIELDS = ('iterations', 'min', 'median', 'p99', 'max', 'mean', 'outliers')
+METRICS = ('min', 'median', 'p99', 'max', 'mean')
+
+
+def parse_benchmarks(output):
+    """Extract the benchmark results from the serial output of a test
+
+    Positional arguments:
+    output - the output of the test, as a string
+
+    Returns a list of dictionaries, one per benchmark message, in order
+    """
+    results = []
+    for match in RE_BENCHMARK_KV.finditer(output):
+        groups = match.groups()
+        result = {'name': groups[0].strip(), 'unit': groups[1]}
+        for field, value in zip(BENCHMARK_FIELDS, groups[2:]):
+            result[field] = int(value)
+        results.append(result)
+    return results
+
+
+def get_commit(path=ROOT):
+    """Get the commit checked out in a git work tree, or None outside of one
+    """
+    try:
+        proc = Popen(['git', 'rev-parse', 'HEAD'], stdout=PIPE, stderr=PIPE,
+                     cwd=path)
+        out, _ = proc.communicate()
+    except OSError:
+        return None
+    if proc.returncode != 0:
+        return None
+    return out.strip() or None
+
+
+class MetricsDatabase(object):
+    """Benchmark results recorded per commit, target, toolchain and test,
+    stored as a JSON file. Records are kept in the order they were added,
+    which is the order of the commits in the trend reports.
+    """
+
+    version = 1
+
+    def __init__(self, path=None):
+        self.path = path
+        self.records = []
+        if path and exists(path):
+            with open(path) as db_file:
+                data = json.load(db_file)
+            self.records = data.get('records', [])
+
+    def save(self, path=None):
+        """Write the database back to its file, or to path if given
+        """
+        path = path or self.path
+        with open(path, 'w') as db_file:
+            json.dump({'version': self.version, 'records': self.records},
+                      db_file, indent=4, sort_keys=True,
+                      separators=(',', ': '))
+
+    def add(self, commit, target, toolchain, test_id, benchmarks,
+            timestamp=None):
+        """Record the benchmark results of a test run
+
+        Positional arguments:
+        commit - the commit the test was built from
+        target - name of the target
+        toolchain - name of the toolchain
+        test_id - identifier of the test
+        benchmarks - results, as returned by parse_benchmarks
+        """
+        timestamp = int(timestamp if timestamp is not None else time())
+        for benchmark in benchmarks:
+            record = dict(benchmark)
+            record.update({
+                'commit': commit,
+                'target': target,
+                'toolchain': toolchain,
+                'test_id': test_id,
+                'timestamp': timestamp,
+            })
+            self.records.append(record)
+
+    @staticmethod
+    def _key(record):
+        return (record['target'], record['toolchain'], record['test_id'],
+                record['name'], record['unit'])
+
+    def commits(self):
+        """List the commits in the database, oldest first
+        """
+        commits = []
+        for record in self.records:
+            if record['commit'] not in commits:
+                commits.append(record['commit'])
+        return commits
+
+    def series(self, metric='median'):
+        """Values of a metric per benchmark and commit
+
+        Returns a dictionary mapping each (target, toolchain, test_id, name,
+        unit) to a list of (commit, value) pairs, oldest commit first. When a
+        benchmark ran several times for the same commit, the best (lowest)
+        value is kept, as noise only ever makes a run slower.
+        """
+        series = {}
+        for record in self.records:
+            points = series.setdefault(self._key(record), [])
+            value = record[metric]
+            for index, (commit, best) in enumerate(points):
+                if commit == record['commit']:
+                    points[index] = (commit, min(best, value))
+                    break
+            else:
+                points.append((record['commit'], value))
+        return series
+
+    def compare(self, commit=None, baseline=None, metric='median',
+                threshold=5.0):
+        """Compare the benchmarks of a commit with a baseline
+
+        Keyword arguments:
+        commit - the commit to check, the latest one by default
+        baseline - the commit to compare with, by default the previous commit
+                   each benchmark ran for
+        metric - the statistic compared
+        threshold - slowdown, in percent, above which a benchmark regressed
+
+        Returns a list of dictionaries, one per benchmark of the commit
+        """
+        commits = self.commits()
+        if not commits:
+            return []
+        commit = commit or commits[-1]
+        rows = []
+        for key, points in sorted(self.series(metric).items()):
+            values = dict(points)
+            if commit not in values:
+                continue
+            reference = None
+            if baseline is not None:
+                reference = values.get(baseline)
+            else:
+                previous = [value for point_commit, value in points
+                            if commits.index(point_commit) < commits.index(commit)]
+                if previous:
+                    reference = previous[-1]
+            current = values[commit]
+            change = None
+            if reference:
+                change = 100.0 * (current - reference) / reference
+            target, toolchain, test_id, name, unit = key
+            rows.append({
+                'target': target,
+                'toolchain': toolchain,
+                'test_id': test_id,
+                'name': name,
+                'unit': unit,
+                'metric': metric,
+                'baseline': reference,
+                'current': current,
+                'change': change,
+                'regression': change is not None and change > threshold,
+            })
+        return rows
+
+    @staticmethod
+    def regressions(rows):
+        """The rows of a comparison that regressed
+        """
+        return [row for row in rows if row['regression']]
+
+    @staticmethod
+    def generate_table(rows):
+        """Format a comparison as a text table
+        """
+        columns = ['Target', 'Toolchain', 'Test', 'Benchmark', 'Unit',
+                   'Baseline', 'Current', 'Change', '']
+        table = PrettyTable(columns)
+        for column in columns:
+            table.align[column] = 'l'
+        for column in ['Baseline', 'Current', 'Change']:
+            table.align[column] = 'r'
+        for row in rows:
+            table.add_row([
+                row['target'], row['toolchain'], row['test_id'], row['name'],
+                row['unit'],
+                '-' if row['baseline'] is None else row['baseline'],
+                row['current'],
+                '-' if row['change'] is None else '%+.1f%%' % row['change'],
+                'REGRESSION' if row['regression'] else '',
+            ])
+        return table.get_string()
+
+    def generate_trend(self, metric='median'):
+        """Format the values of a metric across all commits as a text table,
+        one row per benchmark and one column per commit
+        """
+        commits = self.commits()
+        columns = ['Target', 'Toolchain', 'Test', 'Benchmark', 'Unit'] + \
+                  [commit[:8] for commit in commits]
+        table = PrettyTable(columns)
+        for column in columns:
+            table.align[column] = 'l'
+        for key, points in sorted(self.series(metric).items()):
+            values = dict(points)
+            table.add_row(list(key) + [values.get(commit, '-')
+                                       for commit in commits])
+        return table.get_string()
+
+
+def main():
+    """Entry Point"""
+    parser = argparse.ArgumentParser(
+        description='Record the benchmark results of tests and report their '
+        'trend across commits')
+
+    parser.add_argument(
+        'db', help='metrics database, a JSON file created if missing')
+
+    parser.add_argument(
+        '--add', dest='log', type=argparse_filestring_type,
+        help='serial output of a test run to record the benchmarks of; '
+        'requires --target, --toolchain and --test-id')
+    parser.add_argument('--target', help='target the test ran on')
+    parser.add_argument('--toolchain', help='toolchain the test was built with')
+    parser.add_argument('--test-id', dest='test_id', help='identifier of the test')
+    parser.add_argument(
+        '--commit', help='commit the results belong to (default: the commit '
+        'checked out when adding, the latest one when comparing)')
+
+    parser.add_argument(
+        '--baseline', help='commit to compare with (default: the previous '
+        'commit of each benchmark)')
+    parser.add_argument(
+        '--metric', default='median', choices=METRICS,
+        help='statistic compared (default: median)')
+    parser.add_argument(
+        '--threshold', type=float, default=5.0,
+        help='slowdown, in percent, above which a benchmark regressed; '
+        'exits with 1 if any did (default: 5)')
+    parser.add_argument(
+        '--trend', action='store_true',
+        help='print the metric across all commits instead of a comparison')
+    parser.add_argument(
+        '--json', action='store_true', help='print the comparison as JSON')
+
+    args = parser.parse_args()
+    database = MetricsDatabase(args.db)
+
+    commit = args.commit
+    if args.log:
+        if not (args.target and args.toolchain and args.test_id):
+            parser.error('--add requires --target, --toolchain and --test-id')
+        commit = commit or get_commit() or 'unknown'
+        with open(args.log) as log_file:
+            benchmarks = parse_benchmarks(log_file.read())
+        database.add(commit, args.target, args.toolchain, args.test_id,
+                     benchmarks)
+        database.save()
+
+    if args.trend:
+        print(database.generate_trend(args.metric))
+        return 0
+
+    rows = database.compare(commit, args.baseline, args.metric, args.threshold)
+    if args.json:
+        print(json.dumps(rows, indent=4, sort_keys=True,
+                         separators=(',', ': ')))
+    else:
+        print(database.generate_table(rows))
+    return 1 if MetricsDatabase.regressions(rows) else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -269,3 +269,47 @@ class MySQLDBAccess(BaseDBAccess):
                                                                                           self.escape_string(test_extra))
         cur.execute(query)
         con.commit()
+
+    def insert_metric_entry(self, build_id, target, toolchain, test_id, commit, benchmark):
+        """ Inserts the result of a benchmark reported by a test to database.
+            All checks regarding existing target, toolchain and test names in
+            DB are performed
+        """
+        target_fk = self.get_table_entry_pk(self.TABLE_TARGET, self.TABLE_TARGET + '_name', target)
+        toolchain_fk = self.get_table_entry_pk(self.TABLE_TOOLCHAIN, self.TABLE_TOOLCHAIN + '_name', toolchain)
+        test_id_fk = self.get_table_entry_pk(self.TABLE_TEST_ID, self.TABLE_TEST_ID + '_name', test_id)
+
+        con = self.db_object
+        cur = con.cursor()
+
+        query = """ INSERT INTO `%s` (`mtest_build_id_fk`,
+                                      `mtest_target_fk`,
+                                      `mtest_toolchain_fk`,
+                                      `mtest_test_id_fk`,
+                                      `mtest_metric_commit`,
+                                      `mtest_metric_name`,
+                                      `mtest_metric_unit`,
+                                      `mtest_metric_iterations`,
+                                      `mtest_metric_min`,
+                                      `mtest_metric_median`,
+                                      `mtest_metric_p99`,
+                                      `mtest_metric_max`,
+                                      `mtest_metric_mean`,
+                                      `mtest_metric_outliers`)
+                         VALUES (%d, %d, %d, %d, '%s', '%s', '%s', %d, %d, %d, %d, %d, %d, %d)"""% (self.TABLE_METRIC_ENTRY,
+                                                                                                  build_id,
+                                                                                                  target_fk,
+                                                                                                  toolchain_fk,
+                                                                                                  test_id_fk,
+                                                                                                  self.escape_string(commit),
+                                                                                                  self.escape_string(benchmark['name']),
+                                                                                                  self.escape_string(benchmark['unit']),
+                                                                                                  benchmark['iterations'],
+                                                                                                  benchmark['min'],
+                                                                                                  benchmark['median'],
+                                                                                                  benchmark['p99'],
+                                                                                                  benchmark['max'],
+                                                                                                  benchmark['mean'],
+                                                                                                  benchmark['outliers'])
+        cur.execute(query)
+        con.commit()
@@ -344,6 +344,17 @@ class mbedToolchain:
 
     PROFILE_FILE_NAME = ".profile"
 
+    # Flags replacing the optimization flags of the build profile for the
+    # libraries which ask for "speed" or "size" in their mbed_lib.json
+    OPTIMIZATION_FLAGS = {}
+
+    # Optimization flags of the build profile
+    OPTIMIZATION_FLAG_RE = re.compile(r'^-O\w*$')
+
+    # Flags of the profiles that do not optimize: those keep their flags, so
+    # that debug builds can be stepped through
+    NO_OPTIMIZATION_FLAGS = ["-O0"]
+
     __metaclass__ = ABCMeta
 
     profile_template = {'common':[], 'c':[], 'cxx':[], 'asm':[], 'ld':[]}
@@ -381,6 +392,9 @@ class mbedToolchain:
         # This will hold the location of the configuration file or None if there's no configuration available
         self.config_file = None
 
+        # Optimizations asked for by libraries (as returned by Config.get_optimizations())
+        self.optimizations = {}
+
         # Call guard for "get_config_data" (see the comments of get_config_data for details)
         self.config_processed = False
 
@@ -902,6 +916,10 @@ class mbedToolchain:
         self.get_config_header()
         self.dump_build_profile()
 
+        # Libraries optimized for speed or size, by directory
+        if self.config:
+            self.optimizations = self.config.get_optimizations()
+
         # Sort compile queue for consistency
         files_to_compile.sort()
         for source in files_to_compile:
@@ -1019,11 +1037,15 @@ class mbedToolchain:
                 deps.append(join(self.build_dir, self.PROFILE_FILE_NAME + "-cxx"))
             else:
                 deps.append(join(self.build_dir, self.PROFILE_FILE_NAME + "-c"))
+            optimization, lib_config = self.get_optimization(source)
+            if lib_config:
+                deps.append(lib_config)
             if len(deps) == 0 or self.need_update(object, deps):
                 if ext == '.cpp' or self.COMPILE_C_AS_CPP:
-                    return self.compile_cpp(source, object, includes)
+                    commands = self.compile_cpp(source, object, includes)
                 else:
-                    return self.compile_c(source, object, includes)
+                    commands = self.compile_c(source, object, includes)
+                return self.apply_optimization(commands, optimization)
         elif ext == '.s':
             deps = [source]
             deps.append(join(self.build_dir, self.PROFILE_FILE_NAME + "-asm"))
@@ -1034,6 +1056,49 @@ class mbedToolchain:
 
         return None
 
+    def get_optimization(self, source):
+        """Find the optimization asked for by the library of a source file
+
+        Positional arguments:
+        source -- the source file
+
+        Return:
+        A tuple of the optimization ("speed", "size" or None) and of the
+        configuration file of the library that asked for it. With nested
+        libraries, the innermost one wins.
+        """
+        if not self.optimizations:
+            return None, None
+        path = abspath(source)
+        found = None
+        for lib_dir in self.optimizations:
+            if path.startswith(join(lib_dir, "")) and \
+               (found is None or len(lib_dir) > len(found)):
+                found = lib_dir
+        return self.optimizations[found] if found else (None, None)
+
+    def apply_optimization(self, commands, optimization):
+        """Replace the optimization flags of compile commands
+
+        Positional arguments:
+        commands -- the compile commands, as returned by compile_c or compile_cpp
+        optimization -- "speed", "size" or None to leave the commands alone
+
+        Return:
+        The compile commands
+        """
+        flags = self.OPTIMIZATION_FLAGS.get(optimization)
+        if not commands or not flags:
+            return commands
+        result = []
+        for cmd in commands:
+            if any(flag in self.NO_OPTIMIZATION_FLAGS for flag in cmd):
+                # Not optimizing at all: keep it that way
+                return commands
+            cmd = [flag for flag in cmd if not self.OPTIMIZATION_FLAG_RE.match(flag)]
+            result.append(cmd[:1] + flags + cmd[1:])
+        return result
+
     def parse_dependencies(self, dep_path):
         """Parse the dependency information generated by the compiler.
 
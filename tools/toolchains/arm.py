@@ -34,6 +34,8 @@ class ARM(mbedToolchain):
     DEP_PATTERN = re.compile('\S+:\s(?P<file>.+)\n')
     SHEBANG = "#! armcc -E"
 
+    OPTIMIZATION_FLAGS = {"speed": ["-Otime", "-O3"], "size": ["-Ospace", "-O3"]}
+
     @staticmethod
     def check_executable():
         """Returns True if the executable (armcc) location specified by the
@@ -269,6 +271,8 @@ class ARM_MICRO(ARM):
 
 class ARMC6(ARM_STD):
     SHEBANG = "#! armclang -E --target=arm-arm-none-eabi -x c"
+
+    OPTIMIZATION_FLAGS = {"speed": ["-O2"], "size": ["-Oz"]}
     @staticmethod
     def check_executable():
         return mbedToolchain.generic_check_executable("ARMC6", "armclang", 1)
@@ -29,6 +29,8 @@ class GCC(mbedToolchain):
     DIAGNOSTIC_PATTERN = re.compile('((?P<file>[^:]+):(?P<line>\d+):)(\d+:)? (?P<severity>warning|[eE]rror|fatal error): (?P<message>.+)')
     INDEX_PATTERN  = re.compile('(?P<col>\s*)\^')
 
+    OPTIMIZATION_FLAGS = {"speed": ["-O2"], "size": ["-Os"]}
+
     def __init__(self, target,  notify=None, macros=None,
                  silent=False, extra_verbose=False, build_profile=None,
                  build_dir=None):
@@ -109,7 +111,11 @@ class GCC(mbedToolchain):
         self.sys_libs = ["stdc++", "supc++", "m", "c", "gcc", "nosys"]
         self.preproc = [join(tool_path, "arm-none-eabi-cpp"), "-E", "-P"]
 
-        self.ar = join(tool_path, "arm-none-eabi-ar")
+        if "-flto" in self.flags['common']:
+            # Archives of LTO objects need the symbol index of the plugin
+            self.ar = join(tool_path, "arm-none-eabi-gcc-ar")
+        else:
+            self.ar = join(tool_path, "arm-none-eabi-ar")
         self.elf2bin = join(tool_path, "arm-none-eabi-objcopy")
 
     def is_not_supported_error(self, output):
@@ -29,6 +29,10 @@ class IAR(mbedToolchain):
     DIAGNOSTIC_PATTERN = re.compile('"(?P<file>[^"]+)",(?P<line>[\d]+)\s+(?P<severity>Warning|Error|Fatal error)(?P<message>.+)')
     INDEX_PATTERN  = re.compile('(?P<col>\s*)\^')
 
+    OPTIMIZATION_FLAGS = {"speed": ["-Ohs"], "size": ["-Ohz"]}
+
+    NO_OPTIMIZATION_FLAGS = ["-On"]
+
     @staticmethod
     def check_executable():
         """Returns True if the executable (arm-none-eabi-gcc) location